@@ -0,0 +1,66 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dpi_profile.h"
+
+#include <stddef.h>
+#include <time.h>
+
+static bool enabled;
+
+// Singly linked list of the counters that have been hit, newest first
+static struct dpi_profile_counter *first_counter;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// Add counter to the list if another thread hasn't already done so
+static void register_counter(struct dpi_profile_counter *counter) {
+  bool expected = false;
+  if (!__atomic_compare_exchange_n(&counter->registered, &expected, true,
+                                   false, __ATOMIC_ACQ_REL,
+                                   __ATOMIC_ACQUIRE)) {
+    return;
+  }
+
+  struct dpi_profile_counter *head =
+      __atomic_load_n(&first_counter, __ATOMIC_ACQUIRE);
+  do {
+    counter->next = head;
+  } while (!__atomic_compare_exchange_n(&first_counter, &head, counter, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+}
+
+void dpi_profile_set_enabled(bool enable) {
+  __atomic_store_n(&enabled, enable, __ATOMIC_RELAXED);
+}
+
+const struct dpi_profile_counter *dpi_profile_first(void) {
+  return __atomic_load_n(&first_counter, __ATOMIC_ACQUIRE);
+}
+
+struct dpi_profile_scope dpi_profile_scope_begin(
+    struct dpi_profile_counter *counter) {
+  struct dpi_profile_scope scope = {NULL, 0};
+  if (__atomic_load_n(&enabled, __ATOMIC_RELAXED)) {
+    scope.counter = counter;
+    scope.start_ns = now_ns();
+  }
+  return scope;
+}
+
+void dpi_profile_scope_end(struct dpi_profile_scope *scope) {
+  struct dpi_profile_counter *counter = scope->counter;
+  if (!counter) {
+    return;
+  }
+
+  uint64_t elapsed_ns = now_ns() - scope->start_ns;
+  register_counter(counter);
+  __atomic_fetch_add(&counter->num_calls, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&counter->time_ns, elapsed_ns, __ATOMIC_RELAXED);
+}
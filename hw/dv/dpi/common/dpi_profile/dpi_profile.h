@@ -0,0 +1,93 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_DPI_COMMON_DPI_PROFILE_DPI_PROFILE_H_
+#define OPENTITAN_HW_DV_DPI_COMMON_DPI_PROFILE_DPI_PROFILE_H_
+
+/**
+ * Lightweight profiling of the time spent in DPI calls
+ *
+ * Each DPI module defines a counter with DPI_PROFILE_COUNTER and starts each
+ * function that is called from SystemVerilog with DPI_PROFILE_SCOPE. While
+ * profiling is disabled (the default), a scope costs a single load and
+ * branch. Once a simulation driver has enabled profiling with
+ * dpi_profile_set_enabled(), it can walk the counters that have been hit with
+ * dpi_profile_first() and read out the number of calls and the time spent in
+ * each module.
+ *
+ * Counters may be updated from several simulation threads at once.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct dpi_profile_counter {
+  const char *name;
+  uint64_t num_calls;
+  uint64_t time_ns;
+  bool registered;
+  struct dpi_profile_counter *next;
+};
+
+struct dpi_profile_scope {
+  struct dpi_profile_counter *counter;
+  uint64_t start_ns;
+};
+
+/**
+ * Enable or disable profiling
+ *
+ * Counters keep their values when profiling is disabled.
+ */
+void dpi_profile_set_enabled(bool enabled);
+
+/**
+ * Get the first counter that has been hit while profiling was enabled
+ *
+ * @return A counter, or NULL if no counter has been hit. Use the counter's
+ *         next field to get the next one.
+ */
+const struct dpi_profile_counter *dpi_profile_first(void);
+
+/**
+ * Start timing a scope for counter
+ *
+ * Use DPI_PROFILE_SCOPE rather than calling this directly.
+ */
+struct dpi_profile_scope dpi_profile_scope_begin(
+    struct dpi_profile_counter *counter);
+
+/**
+ * Finish timing a scope, adding the elapsed time to its counter
+ *
+ * Use DPI_PROFILE_SCOPE rather than calling this directly.
+ */
+void dpi_profile_scope_end(struct dpi_profile_scope *scope);
+
+/**
+ * Define a counter for a DPI module at file scope
+ */
+#define DPI_PROFILE_COUNTER(module)                                  \
+  static struct dpi_profile_counter dpi_profile_counter_##module = { \
+      .name = #module}
+
+/**
+ * Time the rest of the enclosing block against the counter for module
+ *
+ * This uses the cleanup attribute (supported by GCC and Clang), so the time is
+ * recorded however the block is left.
+ */
+#define DPI_PROFILE_SCOPE(module)                       \
+  struct dpi_profile_scope dpi_profile_scope_           \
+      __attribute__((cleanup(dpi_profile_scope_end))) = \
+          dpi_profile_scope_begin(&dpi_profile_counter_##module)
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+#endif  // OPENTITAN_HW_DV_DPI_COMMON_DPI_PROFILE_DPI_PROFILE_H_
@@ -23,19 +23,60 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#elif __APPLE__
+#include <sys/event.h>
+#else
+#error "tcp_server needs either epoll (Linux) or kqueue (macOS)"
+#endif
+
 /**
- * Simple buffer for passing data between TCP sockets and DPI modules
+ * Lock-free single-producer, single-consumer ring buffer for passing data
+ * between TCP sockets and DPI modules
+ *
+ * The read and write indices count bytes and run freely, wrapping around at
+ * SIZE_MAX + 1. Since the capacity is a power of two, an index is turned into
+ * a position in buf by masking, and the number of bytes in the buffer is always
+ * wptr - rptr.
+ *
+ * Only the producer writes wptr and only the consumer writes rptr. Each side
+ * publishes its own index with a release store and loads the other side's index
+ * with an acquire load. This makes sure that the consumer sees data before the
+ * index that makes it available, and that the producer doesn't overwrite data
+ * until the consumer has finished with it.
  */
-#define BUFSIZE_BYTE 256
-
 struct tcp_buf {
-  unsigned int rptr;
-  unsigned int wptr;
-  char buf[BUFSIZE_BYTE];
+  size_t capacity;
+  char *buf;
+  // Keep the two indices on separate cache lines so that the producer and
+  // consumer threads don't keep stealing a line from each other.
+  char pad0[64];
+  size_t rptr;
+  char pad1[64 - sizeof(size_t)];
+  size_t wptr;
+  char pad2[64 - sizeof(size_t)];
 };
 
+/**
+ * The events that the server thread is waiting for on a file descriptor
+ */
+struct poll_reg {
+  int fd;  // 0 if nothing is registered
+  bool read;
+  bool write;
+};
+
+struct tcp_mux;
+
 /**
  * TCP Server thread context structure
+ *
+ * This is also used for the channels of the multiplexed server, in which case
+ * mux is set and only display_name, listen_port and buf_in are used. Incoming
+ * data for the channel is put in buf_in, and outgoing data goes straight to
+ * the buffer of the shared server.
  */
 struct tcp_server_ctx {
   // Writeable by the host thread
@@ -48,53 +89,411 @@ struct tcp_server_ctx {
   int sfd;  // socket fd
   int cfd;  // client fd
   pthread_t sock_thread;
+  // Event notification for the server thread. This is an epoll or kqueue
+  // instance, together with (on Linux) an eventfd that is used to wake the
+  // thread up.
+  int poll_fd;
+#ifdef __linux__
+  int wake_fd;
+#endif
+  struct poll_reg poll_sfd;
+  struct poll_reg poll_cfd;
+  // True if the last send to the client couldn't take all of the data. The
+  // server thread then waits for the client socket to become writable.
+  bool out_blocked;
+  // Set by the server thread when it is about to sleep. The host thread uses
+  // this to decide whether it needs to wake the server thread after changing
+  // one of the buffers.
+  bool sleeping;
+  // For a channel of the multiplexed server, the server and the channel number
+  struct tcp_mux *mux;
+  uint8_t channel;
 };
 
-static bool tcp_buffer_is_full(struct tcp_buf *buf) {
-  if (buf->wptr >= buf->rptr) {
-    return (buf->wptr - buf->rptr) == (BUFSIZE_BYTE - 1);
-  } else {
-    return (buf->rptr - buf->wptr) == 1;
-  }
+/**
+ * The multiplexed server shared by all channels
+ *
+ * This is an ordinary server, whose data is split into frames. All of the
+ * framing is done by the host thread: writes to a channel add frames to the
+ * output buffer of the server, and reads from any channel sort the frames that
+ * have arrived into the input buffers of the channels.
+ */
+struct tcp_mux {
+  struct tcp_server_ctx *server;
+  // Held while framing or unframing data, and while adding or removing
+  // channels, in case DPI functions are called from more than one thread.
+  pthread_mutex_t lock;
+  struct tcp_server_ctx *channels[TCP_SERVER_MUX_CONTROL];
+  unsigned num_channels;
+  // The frame that is currently being received
+  uint8_t rx_hdr[TCP_SERVER_MUX_HDR_SIZE];
+  size_t rx_hdr_len;
+  size_t rx_remaining;
+};
+
+// The multiplexed server, if DPI_MUX_PORT is set and any channels are open
+static struct tcp_mux *tcp_mux;
+static pthread_mutex_t tcp_mux_init_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Find the contiguous free space at the write pointer (producer side)
+ *
+ * @param buf ring buffer
+ * @param region set to point at the start of the free space
+ * @return the number of bytes that can be written at *region
+ */
+static size_t tcp_buffer_write_region(struct tcp_buf *buf, char **region) {
+  size_t wptr = __atomic_load_n(&buf->wptr, __ATOMIC_RELAXED);
+  size_t rptr = __atomic_load_n(&buf->rptr, __ATOMIC_ACQUIRE);
+  size_t offset = wptr & (buf->capacity - 1);
+  size_t space = buf->capacity - (wptr - rptr);
+  size_t to_end = buf->capacity - offset;
+
+  *region = &buf->buf[offset];
+  return space < to_end ? space : to_end;
+}
+
+/**
+ * Get the total free space in the buffer (producer side)
+ */
+static size_t tcp_buffer_space(struct tcp_buf *buf) {
+  size_t wptr = __atomic_load_n(&buf->wptr, __ATOMIC_RELAXED);
+  size_t rptr = __atomic_load_n(&buf->rptr, __ATOMIC_ACQUIRE);
+  return buf->capacity - (wptr - rptr);
+}
+
+/**
+ * Make len bytes that have been written at the write pointer available to the
+ * consumer (producer side)
+ */
+static void tcp_buffer_commit_write(struct tcp_buf *buf, size_t len) {
+  size_t wptr = __atomic_load_n(&buf->wptr, __ATOMIC_RELAXED);
+  __atomic_store_n(&buf->wptr, wptr + len, __ATOMIC_RELEASE);
+}
+
+/**
+ * Find the contiguous data at the read pointer (consumer side)
+ *
+ * @param buf ring buffer
+ * @param region set to point at the start of the data
+ * @return the number of bytes that can be read at *region
+ */
+static size_t tcp_buffer_read_region(struct tcp_buf *buf, const char **region) {
+  size_t rptr = __atomic_load_n(&buf->rptr, __ATOMIC_RELAXED);
+  size_t wptr = __atomic_load_n(&buf->wptr, __ATOMIC_ACQUIRE);
+  size_t offset = rptr & (buf->capacity - 1);
+  size_t used = wptr - rptr;
+  size_t to_end = buf->capacity - offset;
+
+  *region = &buf->buf[offset];
+  return used < to_end ? used : to_end;
 }
 
-static bool tcp_buffer_is_empty(struct tcp_buf *buf) {
-  return (buf->wptr == buf->rptr);
+/**
+ * Give len bytes at the read pointer back to the producer (consumer side)
+ */
+static void tcp_buffer_commit_read(struct tcp_buf *buf, size_t len) {
+  size_t rptr = __atomic_load_n(&buf->rptr, __ATOMIC_RELAXED);
+  __atomic_store_n(&buf->rptr, rptr + len, __ATOMIC_RELEASE);
 }
 
-static void tcp_buffer_put_byte(struct tcp_buf *buf, char dat) {
-  bool done = false;
-  while (!done) {
-    if (!tcp_buffer_is_full(buf)) {
-      buf->buf[buf->wptr++] = dat;
-      buf->wptr %= BUFSIZE_BYTE;
-      done = true;
+/**
+ * Copy up to len bytes into the buffer without blocking (producer side)
+ *
+ * @return the number of bytes copied
+ */
+static size_t tcp_buffer_write(struct tcp_buf *buf, const char *dat,
+                               size_t len) {
+  size_t done = 0;
+  // The free space may wrap around the end of the buffer, in which case it is
+  // split into two regions.
+  for (int i = 0; i < 2 && done < len; ++i) {
+    char *region;
+    size_t space = tcp_buffer_write_region(buf, &region);
+    if (!space) {
+      break;
     }
+    size_t n = (len - done) < space ? (len - done) : space;
+    memcpy(region, &dat[done], n);
+    tcp_buffer_commit_write(buf, n);
+    done += n;
   }
+  return done;
 }
 
-static bool tcp_buffer_get_byte(struct tcp_buf *buf, char *dat) {
-  if (tcp_buffer_is_empty(buf)) {
-    return false;
+/**
+ * Copy up to len bytes out of the buffer without blocking (consumer side)
+ *
+ * @return the number of bytes copied
+ */
+static size_t tcp_buffer_read(struct tcp_buf *buf, char *dat, size_t len) {
+  size_t done = 0;
+  for (int i = 0; i < 2 && done < len; ++i) {
+    const char *region;
+    size_t avail = tcp_buffer_read_region(buf, &region);
+    if (!avail) {
+      break;
+    }
+    size_t n = (len - done) < avail ? (len - done) : avail;
+    memcpy(&dat[done], region, n);
+    tcp_buffer_commit_read(buf, n);
+    done += n;
   }
-  *dat = buf->buf[buf->rptr++];
-  buf->rptr %= BUFSIZE_BYTE;
-  return true;
+  return done;
 }
 
-static struct tcp_buf *tcp_buffer_new(void) {
-  struct tcp_buf *buf_new;
-  buf_new = (struct tcp_buf *)malloc(sizeof(struct tcp_buf));
-  buf_new->rptr = 0;
-  buf_new->wptr = 0;
+static struct tcp_buf *tcp_buffer_new(size_t capacity) {
+  // Round the capacity up to a power of two so that indices can be masked
+  size_t rounded = 16;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+
+  struct tcp_buf *buf_new =
+      (struct tcp_buf *)calloc(1, sizeof(struct tcp_buf));
+  if (!buf_new) {
+    return NULL;
+  }
+  buf_new->buf = (char *)malloc(rounded);
+  if (!buf_new->buf) {
+    free(buf_new);
+    return NULL;
+  }
+  buf_new->capacity = rounded;
   return buf_new;
 }
 
 static void tcp_buffer_free(struct tcp_buf **buf) {
+  if (*buf) {
+    free((*buf)->buf);
+  }
   free(*buf);
   *buf = NULL;
 }
 
+/**
+ * Create the epoll / kqueue instance used by the server thread
+ *
+ * @param ctx context object
+ * @return 0 on success, -1 in case of an error
+ */
+static int poller_init(struct tcp_server_ctx *ctx) {
+#ifdef __linux__
+  ctx->poll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (ctx->poll_fd < 0) {
+    return -1;
+  }
+  ctx->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (ctx->wake_fd < 0) {
+    return -1;
+  }
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = ctx->wake_fd;
+  return epoll_ctl(ctx->poll_fd, EPOLL_CTL_ADD, ctx->wake_fd, &ev);
+#else
+  ctx->poll_fd = kqueue();
+  if (ctx->poll_fd < 0) {
+    return -1;
+  }
+  struct kevent kev;
+  EV_SET(&kev, 0, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, NULL);
+  return kevent(ctx->poll_fd, &kev, 1, NULL, 0, NULL);
+#endif
+}
+
+static void poller_free(struct tcp_server_ctx *ctx) {
+  if (ctx->poll_fd > 0) {
+    close(ctx->poll_fd);
+  }
+#ifdef __linux__
+  if (ctx->wake_fd > 0) {
+    close(ctx->wake_fd);
+  }
+#endif
+}
+
+/**
+ * Wake the server thread, if it is waiting for events
+ */
+static void poller_wake(struct tcp_server_ctx *ctx) {
+#ifdef __linux__
+  uint64_t one = 1;
+  ssize_t rv = write(ctx->wake_fd, &one, sizeof(one));
+  (void)rv;
+#else
+  struct kevent kev;
+  EV_SET(&kev, 0, EVFILT_USER, 0, NOTE_TRIGGER, 0, NULL);
+  kevent(ctx->poll_fd, &kev, 1, NULL, 0, NULL);
+#endif
+}
+
+/**
+ * Change the events that the server thread waits for on a file descriptor
+ *
+ * Registering fd 0, or no events, removes any existing registration. If reg
+ * was for a different fd, that registration is dropped first. Errors from
+ * dropping a registration are ignored, since the old fd may already have been
+ * closed (which drops it for us).
+ */
+static void poller_update(struct tcp_server_ctx *ctx, struct poll_reg *reg,
+                          int fd, bool read, bool write) {
+  if (!fd) {
+    read = write = false;
+  }
+  if (reg->fd == fd && reg->read == read && reg->write == write) {
+    return;
+  }
+
+  bool was_registered = reg->fd && (reg->read || reg->write);
+  bool same_fd = was_registered && reg->fd == fd;
+
+#ifdef __linux__
+  if (was_registered && (!same_fd || !(read || write))) {
+    epoll_ctl(ctx->poll_fd, EPOLL_CTL_DEL, reg->fd, NULL);
+    same_fd = false;
+  }
+  if (read || write) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = (read ? EPOLLIN : 0) | (write ? EPOLLOUT : 0);
+    ev.data.fd = fd;
+    int op = same_fd ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(ctx->poll_fd, op, fd, &ev) != 0 && op == EPOLL_CTL_MOD &&
+        errno == ENOENT) {
+      // The old fd was closed and this one was given the same number
+      epoll_ctl(ctx->poll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+  }
+#else
+  struct kevent kev;
+  if (was_registered && !same_fd) {
+    EV_SET(&kev, reg->fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+    kevent(ctx->poll_fd, &kev, 1, NULL, 0, NULL);
+    EV_SET(&kev, reg->fd, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+    kevent(ctx->poll_fd, &kev, 1, NULL, 0, NULL);
+  }
+  if (fd) {
+    EV_SET(&kev, fd, EVFILT_READ, EV_ADD | (read ? EV_ENABLE : EV_DISABLE), 0,
+           0, NULL);
+    kevent(ctx->poll_fd, &kev, 1, NULL, 0, NULL);
+    EV_SET(&kev, fd, EVFILT_WRITE, EV_ADD | (write ? EV_ENABLE : EV_DISABLE),
+           0, 0, NULL);
+    kevent(ctx->poll_fd, &kev, 1, NULL, 0, NULL);
+  }
+#endif
+
+  reg->fd = fd;
+  reg->read = read;
+  reg->write = write;
+}
+
+/**
+ * File descriptors that became ready while waiting in poller_wait
+ */
+struct poll_ready {
+  bool sfd_read;
+  bool cfd_read;
+  bool cfd_write;
+};
+
+/**
+ * Wait for registered events or a call to poller_wake
+ *
+ * @param ctx context object
+ * @param block if false, just collect events that are already pending
+ * @param ready set to show which file descriptors are ready
+ */
+static void poller_wait(struct tcp_server_ctx *ctx, bool block,
+                        struct poll_ready *ready) {
+  memset(ready, 0, sizeof(*ready));
+
+#ifdef __linux__
+  struct epoll_event evs[4];
+  int n = epoll_wait(ctx->poll_fd, evs, 4, block ? -1 : 0);
+  for (int i = 0; i < n; ++i) {
+    int fd = evs[i].data.fd;
+    // Treat errors and hang-ups as readable: the read will report them.
+    bool readable = evs[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP);
+    if (fd == ctx->wake_fd) {
+      uint64_t count;
+      ssize_t rv = read(ctx->wake_fd, &count, sizeof(count));
+      (void)rv;
+    } else if (fd == ctx->sfd) {
+      ready->sfd_read |= readable;
+    } else if (fd == ctx->cfd) {
+      ready->cfd_read |= readable;
+      ready->cfd_write |= (evs[i].events & EPOLLOUT) != 0;
+    }
+  }
+#else
+  struct kevent evs[4];
+  struct timespec zero = {0, 0};
+  int n = kevent(ctx->poll_fd, NULL, 0, evs, 4, block ? NULL : &zero);
+  for (int i = 0; i < n; ++i) {
+    int fd = (int)evs[i].ident;
+    if (evs[i].filter == EVFILT_USER) {
+      continue;
+    } else if (fd == ctx->sfd) {
+      ready->sfd_read |= evs[i].filter == EVFILT_READ;
+    } else if (fd == ctx->cfd) {
+      ready->cfd_read |= evs[i].filter == EVFILT_READ;
+      ready->cfd_write |= evs[i].filter == EVFILT_WRITE;
+    }
+  }
+#endif
+}
+
+/**
+ * Wake the server thread if it is sleeping (called by the host thread)
+ *
+ * This must be called after any change to a buffer that might give the server
+ * thread something to do. The fence pairs with the one in server_should_sleep:
+ * either the server thread sees the change before it sleeps, or we see that it
+ * is sleeping and wake it up.
+ */
+static void server_notify(struct tcp_server_ctx *ctx) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&ctx->sleeping, __ATOMIC_RELAXED) &&
+      __atomic_exchange_n(&ctx->sleeping, false, __ATOMIC_SEQ_CST)) {
+    poller_wake(ctx);
+  }
+}
+
+/**
+ * Decide whether the server thread can sleep until it gets an event
+ *
+ * This sets ctx->sleeping and then checks for work that was queued by the host
+ * thread in the meantime. If there is some, it clears ctx->sleeping again and
+ * returns false.
+ */
+static bool server_should_sleep(struct tcp_server_ctx *ctx) {
+  __atomic_store_n(&ctx->sleeping, true, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  bool have_work = false;
+  if (!ctx->socket_run || ctx->poll_cfd.fd != ctx->cfd) {
+    // Either we're shutting down or the client was closed by the host thread
+    // (so the registered events are out of date).
+    have_work = true;
+  } else if (ctx->cfd) {
+    char *in_region;
+    const char *out_region;
+    // Data to send that we aren't already waiting on the socket for
+    have_work |= !ctx->out_blocked &&
+                 tcp_buffer_read_region(ctx->buf_out, &out_region);
+    // Space that appeared in the input buffer after we stopped reading
+    have_work |= !ctx->poll_cfd.read &&
+                 tcp_buffer_write_region(ctx->buf_in, &in_region);
+  }
+
+  if (have_work) {
+    __atomic_store_n(&ctx->sleeping, false, __ATOMIC_RELAXED);
+  }
+  return !have_work;
+}
+
 /**
  * Start a TCP server
  *
@@ -227,63 +626,93 @@ static void stop(struct tcp_server_ctx *ctx) {
 }
 
 /**
- * Receive a byte from a connected client
+ * Receive data from a connected client into buf_in
+ *
+ * Each call to read fills as much of the contiguous free space in the buffer
+ * as the socket has data for. This stops when the socket has no more data or
+ * the buffer is full.
  *
  * @param ctx context object
- * @param cmd byte received
- * @return true if a byte was read
  */
-static bool get_byte(struct tcp_server_ctx *ctx, char *cmd) {
+static void client_recv(struct tcp_server_ctx *ctx) {
   assert(ctx);
 
-  ssize_t num_read = read(ctx->cfd, cmd, 1);
+  while (ctx->cfd) {
+    char *region;
+    size_t space = tcp_buffer_write_region(ctx->buf_in, &region);
+    if (!space) {
+      return;
+    }
 
-  if (num_read == 0) {
-    return false;
-  }
-  if (num_read == -1) {
-    if (errno == EAGAIN || errno == EWOULDBLOCK) {
-      return false;
-    } else if (errno == EBADF) {
-      // Possibly client went away? Accept a new connection.
-      fprintf(stderr, "%s: Client disappeared.\n", ctx->display_name);
+    ssize_t num_read = read(ctx->cfd, region, space);
+
+    if (num_read == 0) {
+      // The client has closed its end of the connection. Close ours too,
+      // rather than being told that the socket is readable forever.
+      printf("%s: Remote disconnected.\n", ctx->display_name);
       tcp_server_client_close(ctx);
-      return false;
-    } else {
-      fprintf(stderr, "%s: Error while reading from client: %s (%d)\n",
-              ctx->display_name, strerror(errno), errno);
-      assert(0 && "Error reading from client");
+      return;
+    }
+    if (num_read == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return;
+      } else if (errno == EBADF) {
+        // Possibly client went away? Accept a new connection.
+        fprintf(stderr, "%s: Client disappeared.\n", ctx->display_name);
+        tcp_server_client_close(ctx);
+        return;
+      } else {
+        fprintf(stderr, "%s: Error while reading from client: %s (%d)\n",
+                ctx->display_name, strerror(errno), errno);
+        assert(0 && "Error reading from client");
+      }
+    }
+
+    tcp_buffer_commit_write(ctx->buf_in, num_read);
+
+    // A short read means that the socket has been drained for now.
+    if ((size_t)num_read < space) {
+      return;
     }
   }
-  assert(num_read == 1);
-  return true;
 }
 
 /**
- * Send a byte to a connected client
+ * Send data from buf_out to a connected client
+ *
+ * Each call to send passes all of the contiguous data in the buffer. If the
+ * socket can't take any more data, this sets ctx->out_blocked and returns. The
+ * rest is sent once the socket becomes writable again.
  *
  * @param ctx context object
- * @param cmd byte to send
  */
-static void put_byte(struct tcp_server_ctx *ctx, char cmd) {
-  while (1) {
-    ssize_t num_written = send(ctx->cfd, &cmd, sizeof(cmd), MSG_NOSIGNAL);
+static void client_send(struct tcp_server_ctx *ctx) {
+  assert(ctx);
+
+  while (ctx->cfd) {
+    const char *region;
+    size_t avail = tcp_buffer_read_region(ctx->buf_out, &region);
+    if (!avail) {
+      return;
+    }
+
+    ssize_t num_written = send(ctx->cfd, region, avail, MSG_NOSIGNAL);
     if (num_written == -1) {
       if (errno == EAGAIN || errno == EWOULDBLOCK) {
-        continue;
+        ctx->out_blocked = true;
+        return;
       } else if (errno == EPIPE) {
         printf("%s: Remote disconnected.\n", ctx->display_name);
         tcp_server_client_close(ctx);
-        break;
+        return;
       } else {
         fprintf(stderr, "%s: Error while writing to client: %s (%d)\n",
                 ctx->display_name, strerror(errno), errno);
         assert(0 && "Error writing to client.");
       }
     }
-    if (num_written >= 1) {
-      break;
-    }
+
+    tcp_buffer_commit_read(ctx->buf_out, num_written);
   }
 }
 
@@ -293,6 +722,7 @@ static void put_byte(struct tcp_server_ctx *ctx, char cmd) {
  * @param ctx context object
  */
 static void ctx_free(struct tcp_server_ctx *ctx) {
+  poller_free(ctx);
   // Free the buffers
   tcp_buffer_free(&ctx->buf_in);
   tcp_buffer_free(&ctx->buf_out);
@@ -312,7 +742,6 @@ static void ctx_free(struct tcp_server_ctx *ctx) {
 static void *server_create(void *ctx_void) {
   // Cast to a server struct
   struct tcp_server_ctx *ctx = (struct tcp_server_ctx *)ctx_void;
-  struct timeval timeout;
 
   // Start the server
   int rv = start(ctx);
@@ -322,54 +751,42 @@ static void *server_create(void *ctx_void) {
     goto err_cleanup_return;
   }
 
-  // Initialise timeout
-  timeout.tv_sec = 0;
-
-  // Initialise fd_set
-
   // Start waiting for connection / data
-  char xfer_data;
   while (ctx->socket_run) {
-    // Initialise structure of fds
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    if (ctx->sfd) {
-      FD_SET(ctx->sfd, &read_fds);
+    // Only listen for new connections when there is no client (we can only
+    // serve one at a time). Only wait for client data if there is somewhere to
+    // put it, and only wait for the client to become writable if a send
+    // couldn't complete.
+    char *in_region;
+    if (!ctx->cfd) {
+      ctx->out_blocked = false;
     }
-    if (ctx->cfd) {
-      FD_SET(ctx->cfd, &read_fds);
-    }
-    // max fd num
-    int mfd = (ctx->cfd > ctx->sfd) ? ctx->cfd : ctx->sfd;
-
-    // Set timeout - 50us gives good performance
-    timeout.tv_usec = 50;
+    poller_update(ctx, &ctx->poll_sfd, ctx->sfd, !ctx->cfd, false);
+    poller_update(ctx, &ctx->poll_cfd, ctx->cfd,
+                  tcp_buffer_write_region(ctx->buf_in, &in_region) != 0,
+                  ctx->out_blocked);
 
-    // Wait for socket activity or timeout
-    rv = select(mfd + 1, &read_fds, NULL, NULL, &timeout);
-
-    if (rv < 0) {
-      printf("%s: Socket read failed, port: %d\n", ctx->display_name,
-             ctx->listen_port);
-      tcp_server_client_close(ctx);
-    }
+    struct poll_ready ready;
+    poller_wait(ctx, server_should_sleep(ctx), &ready);
+    __atomic_store_n(&ctx->sleeping, false, __ATOMIC_RELAXED);
 
     // New connection
-    if (FD_ISSET(ctx->sfd, &read_fds)) {
+    if (ready.sfd_read && !ctx->cfd) {
       client_tryaccept(ctx);
     }
 
     // New client data
-    if (FD_ISSET(ctx->cfd, &read_fds)) {
-      while (get_byte(ctx, &xfer_data)) {
-        tcp_buffer_put_byte(ctx->buf_in, xfer_data);
-      }
+    if (ctx->cfd && ready.cfd_read) {
+      client_recv(ctx);
     }
 
-    if (ctx->cfd != 0) {
-      while (tcp_buffer_get_byte(ctx->buf_out, &xfer_data)) {
-        put_byte(ctx, xfer_data);
-      }
+    // Data to send. There might be some that was queued while we were
+    // waiting, so try this even if we weren't woken by the socket.
+    if (ready.cfd_write) {
+      ctx->out_blocked = false;
+    }
+    if (ctx->cfd && !ctx->out_blocked) {
+      client_send(ctx);
     }
   }
 
@@ -385,13 +802,38 @@ err_cleanup_return:
 // Abstract interface functions
 struct tcp_server_ctx *tcp_server_create(const char *display_name,
                                          int listen_port) {
+  return tcp_server_create_buffered(display_name, listen_port,
+                                    TCP_SERVER_DEFAULT_BUF_SIZE);
+}
+
+static struct tcp_server_ctx *mux_channel_create(const char *display_name,
+                                                 int listen_port,
+                                                 size_t buf_size,
+                                                 int mux_port);
+static struct tcp_server_ctx *tcp_server_create_buffered_direct(
+    const char *display_name, int listen_port, size_t buf_size);
+
+struct tcp_server_ctx *tcp_server_create_buffered(const char *display_name,
+                                                  int listen_port,
+                                                  size_t buf_size) {
+  const char *mux_port = getenv("DPI_MUX_PORT");
+  if (mux_port && *mux_port) {
+    return mux_channel_create(display_name, listen_port, buf_size,
+                              atoi(mux_port));
+  }
+  return tcp_server_create_buffered_direct(display_name, listen_port,
+                                           buf_size);
+}
+
+static struct tcp_server_ctx *tcp_server_create_buffered_direct(
+    const char *display_name, int listen_port, size_t buf_size) {
   struct tcp_server_ctx *ctx =
       (struct tcp_server_ctx *)calloc(1, sizeof(struct tcp_server_ctx));
   assert(ctx);
 
   // Create the buffers
-  struct tcp_buf *buf_in = tcp_buffer_new();
-  struct tcp_buf *buf_out = tcp_buffer_new();
+  struct tcp_buf *buf_in = tcp_buffer_new(buf_size);
+  struct tcp_buf *buf_out = tcp_buffer_new(buf_size);
   assert(buf_in);
   assert(buf_out);
 
@@ -405,28 +847,93 @@ struct tcp_server_ctx *tcp_server_create(const char *display_name,
   ctx->display_name = strdup(display_name);
   assert(ctx->display_name);
 
+  if (poller_init(ctx) != 0) {
+    fprintf(stderr, "%s: Unable to set up event notification: %s (%d)\n",
+            ctx->display_name, strerror(errno), errno);
+    ctx_free(ctx);
+    return NULL;
+  }
+
   if (pthread_create(&ctx->sock_thread, NULL, server_create, (void *)ctx) !=
       0) {
     fprintf(stderr, "%s: Unable to create TCP socket thread\n",
             ctx->display_name);
     ctx_free(ctx);
-    free(ctx);
     return NULL;
   }
   return ctx;
 }
 
 bool tcp_server_read(struct tcp_server_ctx *ctx, char *dat) {
-  return tcp_buffer_get_byte(ctx->buf_in, dat);
+  return tcp_server_read_buf(ctx, dat, 1) == 1;
 }
 
 void tcp_server_write(struct tcp_server_ctx *ctx, char dat) {
-  tcp_buffer_put_byte(ctx->buf_out, dat);
+  tcp_server_write_buf(ctx, &dat, 1);
+}
+
+static void mux_pump(struct tcp_mux *mux);
+static size_t mux_send(struct tcp_mux *mux, uint8_t channel, const char *dat,
+                       size_t len, bool block);
+
+size_t tcp_server_read_buf(struct tcp_server_ctx *ctx, char *dat, size_t len) {
+  if (ctx->mux) {
+    mux_pump(ctx->mux);
+    return tcp_buffer_read(ctx->buf_in, dat, len);
+  }
+
+  size_t n = tcp_buffer_read(ctx->buf_in, dat, len);
+  if (n) {
+    // The server thread might have stopped reading because the buffer was full
+    server_notify(ctx);
+  }
+  return n;
 }
 
+void tcp_server_write_buf(struct tcp_server_ctx *ctx, const char *dat,
+                          size_t len) {
+  if (ctx->mux) {
+    mux_send(ctx->mux, ctx->channel, dat, len, true);
+    return;
+  }
+
+  // Block until everything has been buffered. The server thread drains the
+  // buffer concurrently.
+  while (len) {
+    size_t n = tcp_buffer_write(ctx->buf_out, dat, len);
+    if (n) {
+      server_notify(ctx);
+    }
+    dat += n;
+    len -= n;
+  }
+}
+
+size_t tcp_server_try_write_buf(struct tcp_server_ctx *ctx, const char *dat,
+                                size_t len) {
+  if (ctx->mux) {
+    return mux_send(ctx->mux, ctx->channel, dat, len, false);
+  }
+
+  size_t n = tcp_buffer_write(ctx->buf_out, dat, len);
+  if (n) {
+    server_notify(ctx);
+  }
+  return n;
+}
+
+static void mux_channel_close(struct tcp_server_ctx *ctx);
+static void mux_channel_client_close(struct tcp_server_ctx *ctx);
+
 void tcp_server_close(struct tcp_server_ctx *ctx) {
+  if (ctx->mux) {
+    mux_channel_close(ctx);
+    return;
+  }
+
   // Shut down the socket thread
   ctx->socket_run = false;
+  server_notify(ctx);
   pthread_join(ctx->sock_thread, NULL);
   ctx_free(ctx);
 }
@@ -434,10 +941,251 @@ void tcp_server_close(struct tcp_server_ctx *ctx) {
 void tcp_server_client_close(struct tcp_server_ctx *ctx) {
   assert(ctx);
 
+  if (ctx->mux) {
+    mux_channel_client_close(ctx);
+    return;
+  }
+
   if (!ctx->cfd) {
     return;
   }
 
   close(ctx->cfd);
   ctx->cfd = 0;
+
+  // If this was called by the host thread, the server thread needs to start
+  // listening for new connections again.
+  server_notify(ctx);
+}
+
+/**
+ * Send len bytes on a channel of the multiplexed server
+ *
+ * The data is split into frames of at most TCP_SERVER_MUX_MAX_FRAME bytes. A
+ * frame is only queued once there is space for all of it, so frames from
+ * different channels are never interleaved. The caller must hold mux->lock.
+ *
+ * @param block if true, wait until all of the data has been queued
+ * @return the number of bytes queued
+ */
+static size_t mux_send_locked(struct tcp_mux *mux, uint8_t channel,
+                              const char *dat, size_t len, bool block) {
+  struct tcp_server_ctx *server = mux->server;
+  size_t done = 0;
+  while (done < len) {
+    size_t space = tcp_buffer_space(server->buf_out);
+    if (space <= TCP_SERVER_MUX_HDR_SIZE) {
+      if (!block) {
+        break;
+      }
+      // The server thread drains the buffer concurrently. Let other threads
+      // use the mux while we wait for it.
+      pthread_mutex_unlock(&mux->lock);
+      pthread_mutex_lock(&mux->lock);
+      continue;
+    }
+
+    size_t n = len - done;
+    if (n > TCP_SERVER_MUX_MAX_FRAME) {
+      n = TCP_SERVER_MUX_MAX_FRAME;
+    }
+    if (n > space - TCP_SERVER_MUX_HDR_SIZE) {
+      n = space - TCP_SERVER_MUX_HDR_SIZE;
+    }
+
+    uint8_t hdr[TCP_SERVER_MUX_HDR_SIZE] = {channel, n & 0xff, n >> 8};
+    tcp_buffer_write(server->buf_out, (const char *)hdr, sizeof(hdr));
+    tcp_buffer_write(server->buf_out, &dat[done], n);
+    done += n;
+  }
+
+  if (done) {
+    server_notify(server);
+  }
+  return done;
+}
+
+static size_t mux_send(struct tcp_mux *mux, uint8_t channel, const char *dat,
+                       size_t len, bool block) {
+  pthread_mutex_lock(&mux->lock);
+  size_t n = mux_send_locked(mux, channel, dat, len, block);
+  pthread_mutex_unlock(&mux->lock);
+  return n;
+}
+
+/**
+ * Send a line of text on the control channel. The caller must hold mux->lock.
+ */
+static void mux_send_control(struct tcp_mux *mux, const char *line) {
+  mux_send_locked(mux, TCP_SERVER_MUX_CONTROL, line, strlen(line), true);
+}
+
+/**
+ * Reply to a control request by listing the open channels
+ */
+static void mux_list_channels(struct tcp_mux *mux) {
+  for (unsigned i = 0; i < mux->num_channels; ++i) {
+    struct tcp_server_ctx *channel = mux->channels[i];
+    if (!channel) {
+      continue;
+    }
+    char line[256];
+    snprintf(line, sizeof(line), "channel %u %u %s\n", i, channel->listen_port,
+             channel->display_name);
+    mux_send_control(mux, line);
+  }
+}
+
+/**
+ * Move received frames from the server into the input buffers of their
+ * channels
+ *
+ * This stops early if a channel's input buffer is full. Frames for later
+ * channels then wait until that channel has been read.
+ */
+static void mux_pump(struct tcp_mux *mux) {
+  pthread_mutex_lock(&mux->lock);
+  struct tcp_server_ctx *server = mux->server;
+
+  while (true) {
+    if (mux->rx_hdr_len < TCP_SERVER_MUX_HDR_SIZE) {
+      mux->rx_hdr_len += tcp_server_read_buf(
+          server, (char *)&mux->rx_hdr[mux->rx_hdr_len],
+          TCP_SERVER_MUX_HDR_SIZE - mux->rx_hdr_len);
+      if (mux->rx_hdr_len < TCP_SERVER_MUX_HDR_SIZE) {
+        break;
+      }
+      mux->rx_remaining = mux->rx_hdr[1] | (mux->rx_hdr[2] << 8);
+      if (mux->rx_hdr[0] == TCP_SERVER_MUX_CONTROL) {
+        // The only request is for the list of channels, so the payload (if
+        // any) is ignored.
+        mux_list_channels(mux);
+      }
+    }
+
+    uint8_t id = mux->rx_hdr[0];
+    struct tcp_server_ctx *channel =
+        id < mux->num_channels ? mux->channels[id] : NULL;
+
+    char chunk[TCP_SERVER_MUX_MAX_FRAME];
+    size_t n = mux->rx_remaining;
+    if (channel) {
+      size_t space = tcp_buffer_space(channel->buf_in);
+      n = n < space ? n : space;
+    } else if (n > sizeof(chunk)) {
+      n = sizeof(chunk);
+    }
+    if (n) {
+      n = tcp_server_read_buf(server, chunk, n);
+      if (!n) {
+        break;
+      }
+      if (channel) {
+        tcp_buffer_write(channel->buf_in, chunk, n);
+      } else if (id != TCP_SERVER_MUX_CONTROL) {
+        fprintf(stderr, "DPI mux: Dropping %zu bytes for unknown channel %u\n",
+                n, id);
+      }
+      mux->rx_remaining -= n;
+    }
+
+    if (mux->rx_remaining) {
+      // Either the channel's buffer is full or more data is yet to come
+      break;
+    }
+    mux->rx_hdr_len = 0;
+  }
+
+  pthread_mutex_unlock(&mux->lock);
+}
+
+static struct tcp_server_ctx *mux_channel_create(const char *display_name,
+                                                 int listen_port,
+                                                 size_t buf_size,
+                                                 int mux_port) {
+  pthread_mutex_lock(&tcp_mux_init_lock);
+
+  if (!tcp_mux) {
+    struct tcp_mux *mux = (struct tcp_mux *)calloc(1, sizeof(struct tcp_mux));
+    assert(mux);
+    mux->server = tcp_server_create_buffered_direct("DPI mux", mux_port,
+                                                    buf_size);
+    if (!mux->server) {
+      free(mux);
+      pthread_mutex_unlock(&tcp_mux_init_lock);
+      return NULL;
+    }
+    pthread_mutex_init(&mux->lock, NULL);
+    tcp_mux = mux;
+    printf("DPI mux: Listening on port %d for all DPI sockets\n", mux_port);
+  }
+  struct tcp_mux *mux = tcp_mux;
+
+  pthread_mutex_lock(&mux->lock);
+  if (mux->num_channels == TCP_SERVER_MUX_CONTROL) {
+    fprintf(stderr, "%s: Too many DPI mux channels\n", display_name);
+    pthread_mutex_unlock(&mux->lock);
+    pthread_mutex_unlock(&tcp_mux_init_lock);
+    return NULL;
+  }
+
+  struct tcp_server_ctx *ctx =
+      (struct tcp_server_ctx *)calloc(1, sizeof(struct tcp_server_ctx));
+  assert(ctx);
+  ctx->buf_in = tcp_buffer_new(buf_size);
+  assert(ctx->buf_in);
+  ctx->listen_port = listen_port;
+  ctx->display_name = strdup(display_name);
+  assert(ctx->display_name);
+  ctx->mux = mux;
+  ctx->channel = mux->num_channels;
+  mux->channels[mux->num_channels++] = ctx;
+
+  printf("%s: Using DPI mux channel %u instead of port %d\n", display_name,
+         ctx->channel, listen_port);
+
+  pthread_mutex_unlock(&mux->lock);
+  pthread_mutex_unlock(&tcp_mux_init_lock);
+  return ctx;
+}
+
+static void mux_channel_client_close(struct tcp_server_ctx *ctx) {
+  // The connection is shared, so just tell the client that this channel has
+  // been closed. Drop anything it had sent to the channel.
+  struct tcp_mux *mux = ctx->mux;
+  pthread_mutex_lock(&mux->lock);
+  const char *region;
+  size_t n;
+  while ((n = tcp_buffer_read_region(ctx->buf_in, &region))) {
+    tcp_buffer_commit_read(ctx->buf_in, n);
+  }
+  char line[32];
+  snprintf(line, sizeof(line), "closed %u\n", ctx->channel);
+  mux_send_control(mux, line);
+  pthread_mutex_unlock(&mux->lock);
+}
+
+static void mux_channel_close(struct tcp_server_ctx *ctx) {
+  struct tcp_mux *mux = ctx->mux;
+  pthread_mutex_lock(&tcp_mux_init_lock);
+
+  pthread_mutex_lock(&mux->lock);
+  mux->channels[ctx->channel] = NULL;
+  bool last = true;
+  for (unsigned i = 0; i < mux->num_channels; ++i) {
+    last &= mux->channels[i] == NULL;
+  }
+  pthread_mutex_unlock(&mux->lock);
+
+  if (last) {
+    tcp_server_close(mux->server);
+    pthread_mutex_destroy(&mux->lock);
+    free(mux);
+    tcp_mux = NULL;
+  }
+  pthread_mutex_unlock(&tcp_mux_init_lock);
+
+  tcp_buffer_free(&ctx->buf_in);
+  free(ctx->display_name);
+  free(ctx);
 }
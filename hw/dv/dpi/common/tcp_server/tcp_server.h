@@ -10,6 +10,26 @@
  *
  * This is intended to be used by simulation add-on DPI modules to provide
  * basic TCP socket communication between a host and simulated peripherals.
+ *
+ * Normally, each server listens on its own port and has its own thread. If the
+ * DPI_MUX_PORT environment variable is set, all of the servers in the
+ * simulation instead share a single server on that port, with one thread and
+ * one client connection. Each server becomes a channel, numbered in the order
+ * in which they were created, and its listen_port is just used to identify it.
+ *
+ * On the shared connection, all data in both directions is sent in frames:
+ *
+ *   - 1 byte: channel number
+ *   - 2 bytes: payload length (little-endian, at most TCP_SERVER_MUX_MAX_FRAME)
+ *   - the payload
+ *
+ * Frames sent to the client are in the order in which the simulation wrote
+ * them, across all channels. Channel TCP_SERVER_MUX_CONTROL is for control
+ * messages, which are lines of text. Any frame the client sends on it is a
+ * request for the list of channels, to which the reply is a line
+ * "channel <number> <listen_port> <name>" for each channel. The server sends
+ * "closed <number>" when the DPI module closes its client connection (for
+ * example, when OpenOCD asks jtagdpi to quit).
  */
 
 #ifdef __cplusplus
@@ -17,8 +37,30 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+/**
+ * Default capacity (in bytes) of each of the two buffers between the DPI
+ * module and the socket thread.
+ */
+#define TCP_SERVER_DEFAULT_BUF_SIZE (64 * 1024)
+
+/**
+ * Size of the header of a frame on the multiplexed server
+ */
+#define TCP_SERVER_MUX_HDR_SIZE 3
+
+/**
+ * Maximum payload of a frame on the multiplexed server
+ */
+#define TCP_SERVER_MUX_MAX_FRAME 4096
+
+/**
+ * Channel number for control messages on the multiplexed server
+ */
+#define TCP_SERVER_MUX_CONTROL 0xff
+
 struct tcp_server_ctx;
 
 /**
@@ -41,9 +83,47 @@ bool tcp_server_read(struct tcp_server_ctx *ctx, char *dat);
  */
 void tcp_server_write(struct tcp_server_ctx *ctx, char dat);
 
+/**
+ * Non-blocking read of up to len bytes from a connected client
+ *
+ * @param ctx tcp server context object
+ * @param dat buffer to hold the bytes received
+ * @param len size of dat
+ * @return the number of bytes read (possibly zero)
+ */
+size_t tcp_server_read_buf(struct tcp_server_ctx *ctx, char *dat, size_t len);
+
+/**
+ * Write len bytes to a connected client
+ *
+ * This is the bulk equivalent of tcp_server_write. It blocks until all of the
+ * data has been copied into the internal buffer.
+ *
+ * @param ctx tcp server context object
+ * @param dat bytes to send
+ * @param len number of bytes to send
+ */
+void tcp_server_write_buf(struct tcp_server_ctx *ctx, const char *dat,
+                          size_t len);
+
+/**
+ * Write up to len bytes to a connected client without blocking
+ *
+ * @param ctx tcp server context object
+ * @param dat bytes to send
+ * @param len number of bytes to send
+ * @return the number of bytes copied into the internal buffer. This is less
+ *         than len if the buffer is full.
+ */
+size_t tcp_server_try_write_buf(struct tcp_server_ctx *ctx, const char *dat,
+                                size_t len);
+
 /**
  * Create a new TCP server instance
  *
+ * This is equivalent to calling tcp_server_create_buffered with a buffer size
+ * of TCP_SERVER_DEFAULT_BUF_SIZE.
+ *
  * @param display_name C string description of server
  * @param listen_port On which port the server should listen
  * @return A pointer to the created context struct
@@ -51,6 +131,19 @@ void tcp_server_write(struct tcp_server_ctx *ctx, char dat);
 struct tcp_server_ctx *tcp_server_create(const char *display_name,
                                          int listen_port);
 
+/**
+ * Create a new TCP server instance with a given buffer capacity
+ *
+ * @param display_name C string description of server
+ * @param listen_port On which port the server should listen
+ * @param buf_size Capacity in bytes of the receive and transmit buffers. This
+ *                 is rounded up to a power of two.
+ * @return A pointer to the created context struct
+ */
+struct tcp_server_ctx *tcp_server_create_buffered(const char *display_name,
+                                                  int listen_port,
+                                                  size_t buf_size);
+
 /**
  * Shut down the server and free all reserved memory
  *
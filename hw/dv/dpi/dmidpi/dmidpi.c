@@ -11,8 +11,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "dpi_profile.h"
 #include "tcp_server.h"
 
+DPI_PROFILE_COUNTER(dmidpi);
+
 // IDCODE register
 // [31:28] 0x0,    - Version
 // [27:12] 0x4F54, - Part Number: "OT"
@@ -82,10 +85,39 @@ struct dmi_sig_values {
   uint8_t dmi_rst_n;
 };
 
+// The number of bytes in a transaction-level request: the 'D' command byte,
+// followed by the address, the operation and 4 bytes of data.
+#define DMI_TXN_REQ_BYTES 7
+
+// The number of bytes in a transaction-level response: 4 bytes of data,
+// followed by the response code.
+#define DMI_TXN_RSP_BYTES 5
+
+// The maximum number of transaction-level requests that can be waiting for a
+// response at once.
+#define DMI_TXN_MAX_OUTSTANDING 16
+
+/**
+ * State for the transaction-level protocol (see README.md)
+ */
+struct dmi_txn_ctx {
+  // The request being received. req_len is the number of bytes so far (zero
+  // if we aren't in the middle of a request).
+  uint8_t req[DMI_TXN_REQ_BYTES];
+  uint8_t req_len;
+  // The number of requests that have been issued but not responded to
+  uint32_t num_outstanding;
+  // A bit-level command byte that we read, but that must wait until all
+  // transaction-level requests have completed.
+  bool held;
+  char held_cmd;
+};
+
 struct dmidpi_ctx {
   struct tcp_server_ctx *sock;
   struct jtag_ctx jtag;
   struct dmi_sig_values sig;
+  struct dmi_txn_ctx txn;
 };
 
 /**
@@ -127,6 +159,48 @@ static void issue_dmi_req(struct dmidpi_ctx *ctx) {
   ctx->sig.dmi_req_data = (ctx->jtag.dr_captured >> 2) & 0xFFFFFFFF;
 }
 
+/**
+ * Receive the rest of a transaction-level request and issue it
+ *
+ * This is called once the 'D' command byte has been read. It reads as much of
+ * the request as is available and, once the whole request has arrived, drives
+ * it onto the DMI interface as soon as the previous request has been accepted.
+ *
+ * @param ctx dmidpi context object
+ */
+static void txn_request_step(struct dmidpi_ctx *ctx) {
+  struct dmi_txn_ctx *txn = &ctx->txn;
+
+  while (txn->req_len < DMI_TXN_REQ_BYTES) {
+    char byte;
+    if (!tcp_server_read(ctx->sock, &byte)) {
+      return;
+    }
+    txn->req[txn->req_len++] = (uint8_t)byte;
+  }
+
+  if (ctx->sig.dmi_req_valid ||
+      txn->num_outstanding >= DMI_TXN_MAX_OUTSTANDING) {
+    return;
+  }
+
+  // A client that only uses the transaction-level protocol never takes the
+  // debug module out of reset through the TAP state machine, so do it here.
+  if (!ctx->sig.dmi_rst_n) {
+    ctx->sig.dmi_rst_n = 1;
+    return;
+  }
+
+  ctx->sig.dmi_req_valid = 1;
+  ctx->sig.dmi_req_addr = txn->req[1] & 0x7F;
+  ctx->sig.dmi_req_op = txn->req[2] & 0x3;
+  ctx->sig.dmi_req_data = (uint32_t)txn->req[3] | (uint32_t)txn->req[4] << 8 |
+                          (uint32_t)txn->req[5] << 16 |
+                          (uint32_t)txn->req[6] << 24;
+  ++txn->num_outstanding;
+  txn->req_len = 0;
+}
+
 /**
  * Advance internal JTAG state
  *
@@ -337,7 +411,18 @@ static void process_dmi_inputs(struct dmidpi_ctx *ctx) {
   }
   // Always ready for a resp
   ctx->sig.dmi_rsp_ready = 1;
-  if (ctx->sig.dmi_rsp_valid) {
+  if (ctx->sig.dmi_rsp_valid && ctx->txn.num_outstanding) {
+    // Responses come back in order. Bit-level requests are never issued while
+    // transaction-level ones are outstanding, so this must be a response to
+    // the oldest transaction-level request.
+    char rsp[DMI_TXN_RSP_BYTES];
+    for (int i = 0; i < 4; ++i) {
+      rsp[i] = (char)(ctx->sig.dmi_rsp_data >> (8 * i));
+    }
+    rsp[4] = (char)(ctx->sig.dmi_rsp_resp & 0x3);
+    tcp_server_write_buf(ctx->sock, rsp, sizeof(rsp));
+    --ctx->txn.num_outstanding;
+  } else if (ctx->sig.dmi_rsp_valid) {
     ctx->jtag.dr_captured = (uint64_t)ctx->sig.dmi_rsp_data << 2;
     ctx->jtag.dr_captured |= (uint64_t)ctx->sig.dmi_rsp_resp & 0x3;
     // Clear req outstanding flag
@@ -364,11 +449,37 @@ static void update_dmi_state(struct dmidpi_ctx *ctx) {
 
   char done = 0;
   while (!done) {
-    // read a command byte
+    // If we're part way through a transaction-level request, carry on with
+    // it. At most one request can be issued per tick, so stop there.
+    if (ctx->txn.req_len) {
+      txn_request_step(ctx);
+      return;
+    }
+
+    // read a command byte (or take the one that we held back last time)
     char cmd;
-    if (!tcp_server_read(ctx->sock, &cmd)) {
+    if (ctx->txn.held) {
+      cmd = ctx->txn.held_cmd;
+    } else if (!tcp_server_read(ctx->sock, &cmd)) {
       return;
     }
+
+    if (cmd == 'D') {
+      ctx->txn.held = false;
+      ctx->txn.req[0] = (uint8_t)cmd;
+      ctx->txn.req_len = 1;
+      continue;
+    }
+
+    // Bit-level commands wait until all transaction-level requests have
+    // completed, so that the two never have requests in flight at once.
+    if (ctx->txn.num_outstanding || ctx->sig.dmi_req_valid) {
+      ctx->txn.held = true;
+      ctx->txn.held_cmd = cmd;
+      return;
+    }
+    ctx->txn.held = false;
+
     // Process command bytes until a command completes
     done = process_cmd_byte(ctx, cmd);
   }
@@ -413,6 +524,7 @@ void dmidpi_tick(void *ctx_void, svBit *dmi_req_valid,
                  const svBit dmi_rsp_valid, svBit *dmi_rsp_ready,
                  const svBitVecVal *dmi_rsp_data,
                  const svBitVecVal *dmi_rsp_resp, svBit *dmi_rst_n) {
+  DPI_PROFILE_SCOPE(dmidpi);
   struct dmidpi_ctx *ctx = (struct dmidpi_ctx *)ctx_void;
 
   if (!ctx) {
@@ -23,9 +23,20 @@
 #include <sys/types.h>
 #include <unistd.h>
 
-// The number of ticks of host_to_device_tick between making syscalls.
+#include "dpi_profile.h"
+
+DPI_PROFILE_COUNTER(gpiodpi);
+
+// The number of clock cycles between reads of the host-to-device FIFO.
 #define TICKS_PER_SYSCALL 2048
 
+// The size of the buffer for commands from the host. Commands may be split
+// across reads, so this holds any incomplete command until the rest arrives.
+#define CMD_BUF_SIZE 4096
+
+// The initial capacity of the queue of scheduled pin updates.
+#define INITIAL_QUEUE_SIZE 16
+
 // This module currently is capable of implementing 32 GPIOs.
 #define NUM_GPIO 32
 
@@ -35,6 +46,16 @@
 #define SET_BIT(word, bit_idx) ((word) |= (1 << (bit_idx)))
 #define CLR_BIT(word, bit_idx) ((word) &= ~(1 << (bit_idx)))
 
+/**
+ * A pin update from the host, to be applied at a given cycle.
+ */
+struct pin_update {
+  uint64_t cycle;
+  uint8_t idx;
+  bool high;
+  bool weak;
+};
+
 struct gpiodpi_ctx {
   // The number of pins we're driving.
   int n_bits;
@@ -43,9 +64,25 @@ struct gpiodpi_ctx {
   uint32_t driven_pin_values;
   // Whether or not the pin is being driven weakly or strongly.
   uint32_t weak_pins;
-  // A counter of calls into the host_to_device_tick function; used to
-  // avoid excessive `read` syscalls to the pipe fd.
-  uint32_t counter;
+  // The cycle at which to next read the host-to-device FIFO; used to avoid
+  // excessive `read` syscalls to the pipe fd.
+  uint64_t next_read;
+
+  // The last pin state reported to the host, so that it is only reported when
+  // it changes.
+  bool reported;
+  uint32_t reported_data;
+  uint32_t reported_oe;
+
+  // Commands from the host that have been read but not yet parsed, because the
+  // end of the command hasn't arrived yet.
+  char cmd_buf[CMD_BUF_SIZE];
+  size_t cmd_len;
+
+  // Pin updates waiting for their cycle, kept in order of cycle.
+  struct pin_update *queue;
+  size_t queue_len;
+  size_t queue_cap;
 
   // File descriptors and paths for the device-to-host and host-to-device
   // FIFOs.
@@ -105,6 +142,10 @@ static void print_usage(char *rfifo, char *wfifo, int n_bits) {
          wfifo);
   printf("$ echo 'wh10' > %s  # Pull pin 10 high through a weak pull-up.\n",
          wfifo);
+  printf(
+      "$ echo '@1000 h3 +50 l3' > %s  # Pulse pin 3 high at cycle 1000, for "
+      "50 cycles.\n",
+      wfifo);
 }
 
 void *gpiodpi_create(const char *name, int n_bits) {
@@ -119,7 +160,15 @@ void *gpiodpi_create(const char *name, int n_bits) {
 
   ctx->driven_pin_values = 0;
   ctx->weak_pins = 0;
-  ctx->counter = 0;
+  ctx->next_read = 0;
+  ctx->reported = false;
+  ctx->cmd_len = 0;
+
+  ctx->queue_len = 0;
+  ctx->queue_cap = INITIAL_QUEUE_SIZE;
+  ctx->queue =
+      (struct pin_update *)malloc(ctx->queue_cap * sizeof(struct pin_update));
+  assert(ctx->queue);
 
   char cwd_buf[PATH_MAX];
   char *cwd = getcwd(cwd_buf, sizeof(cwd_buf));
@@ -152,9 +201,21 @@ void *gpiodpi_create(const char *name, int n_bits) {
 
 void gpiodpi_device_to_host(void *ctx_void, svBitVecVal *gpio_data,
                             svBitVecVal *gpio_oe) {
+  DPI_PROFILE_SCOPE(gpiodpi);
   struct gpiodpi_ctx *ctx = (struct gpiodpi_ctx *)ctx_void;
   assert(ctx);
 
+  // Only report edges
+  uint32_t mask = ctx->n_bits < 32 ? (1u << ctx->n_bits) - 1 : ~0u;
+  uint32_t data = gpio_data[0] & mask;
+  uint32_t oe = gpio_oe[0] & mask;
+  if (ctx->reported && data == ctx->reported_data && oe == ctx->reported_oe) {
+    return;
+  }
+  ctx->reported = true;
+  ctx->reported_data = data;
+  ctx->reported_oe = oe;
+
   // Write 0, 1, or X (when oe is not set) for each GPIO pin, in big endian
   // order (i.e., pin 0 is the last character written). Finish it with a
   // newline.
@@ -181,15 +242,15 @@ void gpiodpi_device_to_host(void *ctx_void, svBitVecVal *gpio_data,
  *
  * Returns upon encountering any non-decimal digit.
  */
-static uint32_t parse_dec(char **text) {
+static uint64_t parse_dec(char **text) {
   if (text == NULL || *text == NULL) {
     return 0;
   }
 
-  uint32_t value = 0;
+  uint64_t value = 0;
   for (; **text != '\0'; ++*text) {
     char c = **text;
-    uint32_t digit;
+    uint64_t digit;
     if (c >= '0' && c <= '9') {
       digit = (c - '0');
     } else {
@@ -211,79 +272,165 @@ static void set_bit_val(uint32_t *word, uint32_t idx, bool val) {
   }
 }
 
-uint32_t gpiodpi_host_to_device_tick(void *ctx_void, svBitVecVal *gpio_oe,
+/**
+ * Apply a pin update from the host.
+ */
+static void apply_update(struct gpiodpi_ctx *ctx, const struct pin_update *upd,
+                         uint32_t gpio_oe) {
+  if (!GET_BIT(gpio_oe, upd->idx)) {
+    fprintf(stderr, "GPIO: Host tried to pull disabled pin %s: pin %2d\n",
+            upd->high ? "high" : "low", upd->idx);
+  }
+  set_bit_val(&ctx->driven_pin_values, upd->idx, upd->high);
+  set_bit_val(&ctx->weak_pins, upd->idx, upd->weak);
+}
+
+/**
+ * Queue a pin update for a later cycle.
+ *
+ * Updates for the same cycle are applied in the order they were given.
+ */
+static void queue_update(struct gpiodpi_ctx *ctx,
+                         const struct pin_update *upd) {
+  if (ctx->queue_len == ctx->queue_cap) {
+    ctx->queue_cap *= 2;
+    ctx->queue = (struct pin_update *)realloc(
+        ctx->queue, ctx->queue_cap * sizeof(struct pin_update));
+    assert(ctx->queue);
+  }
+
+  // Hosts normally send updates in order, so search from the back.
+  size_t pos = ctx->queue_len;
+  while (pos > 0 && ctx->queue[pos - 1].cycle > upd->cycle) {
+    --pos;
+  }
+  memmove(&ctx->queue[pos + 1], &ctx->queue[pos],
+          (ctx->queue_len - pos) * sizeof(struct pin_update));
+  ctx->queue[pos] = *upd;
+  ++ctx->queue_len;
+}
+
+static bool is_separator(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Parse the complete commands in |ctx->cmd_buf|, applying or queueing the pin
+ * updates that they describe.
+ *
+ * Anything after the last separator is kept, since the rest of that command
+ * may not have been read yet.
+ */
+static void parse_commands(struct gpiodpi_ctx *ctx, uint64_t cycle,
+                           uint32_t gpio_oe) {
+  size_t end = ctx->cmd_len;
+  while (end > 0 && !is_separator(ctx->cmd_buf[end - 1])) {
+    --end;
+  }
+  if (end == 0 && ctx->cmd_len < CMD_BUF_SIZE - 1) {
+    return;
+  }
+  if (end == 0) {
+    // A single "command" fills the buffer; it can't be valid, so drop it.
+    end = ctx->cmd_len;
+  }
+
+  char saved = ctx->cmd_buf[end];
+  ctx->cmd_buf[end] = '\0';
+
+  // Updates are applied now unless a time has been given with |@N| (at cycle
+  // N) or |+N| (N cycles after the last time given, or after now).
+  uint64_t at = cycle;
+  bool weak = false;
+  char *gpio_text = ctx->cmd_buf;
+  while (*gpio_text != '\0') {
+    switch (*gpio_text) {
+      case '@':
+        ++gpio_text;
+        at = parse_dec(&gpio_text);
+        break;
+      case '+':
+        ++gpio_text;
+        at += parse_dec(&gpio_text);
+        break;
+      case 'w':
+      case 'W':
+        weak = true;
+        ++gpio_text;
+        break;
+      case 'l':
+      case 'L':
+      case 'h':
+      case 'H': {
+        bool high = (*gpio_text == 'h' || *gpio_text == 'H');
+        ++gpio_text;
+        uint64_t idx = parse_dec(&gpio_text);
+        if (idx < NUM_GPIO) {
+          struct pin_update upd = {at, (uint8_t)idx, high, weak};
+          if (at <= cycle) {
+            apply_update(ctx, &upd, gpio_oe);
+          } else {
+            queue_update(ctx, &upd);
+          }
+        } else {
+          fprintf(stderr,
+                  "GPIO: Host tried to pull invalid pin %s: pin %2llu\n",
+                  high ? "high" : "low", (unsigned long long)idx);
+        }
+        weak = false;
+        break;
+      }
+      default:
+        ++gpio_text;
+        break;
+    }
+  }
+
+  ctx->cmd_buf[end] = saved;
+  memmove(ctx->cmd_buf, &ctx->cmd_buf[end], ctx->cmd_len - end);
+  ctx->cmd_len -= end;
+}
+
+uint32_t gpiodpi_host_to_device_tick(void *ctx_void, long long cycle,
+                                     svBitVecVal *gpio_oe,
                                      svBitVecVal *gpio_pull_en,
-                                     svBitVecVal *gpio_pull_sel) {
+                                     svBitVecVal *gpio_pull_sel,
+                                     long long *next_cycle) {
+  DPI_PROFILE_SCOPE(gpiodpi);
   struct gpiodpi_ctx *ctx = (struct gpiodpi_ctx *)ctx_void;
   assert(ctx);
+  uint64_t now = (uint64_t)cycle;
 
-  if (ctx->counter % TICKS_PER_SYSCALL == 0) {
-    char gpio_str[256];
-    ssize_t read_len =
-        read(ctx->host_to_dev_fifo, gpio_str, sizeof(gpio_str) - 1);
+  if (now >= ctx->next_read) {
+    ctx->next_read = now + TICKS_PER_SYSCALL;
+    ssize_t read_len = read(ctx->host_to_dev_fifo, &ctx->cmd_buf[ctx->cmd_len],
+                            CMD_BUF_SIZE - 1 - ctx->cmd_len);
     if (read_len > 0) {
-      gpio_str[read_len] = '\0';
-
-      bool weak = false;
-      char *gpio_text = gpio_str;
-      for (; *gpio_text != '\0'; ++gpio_text) {
-        switch (*gpio_text) {
-          case '\0':
-            goto parse_loop_end;
-          case 'w':
-          case 'W': {
-            weak = true;
-            break;
-          }
-          case 'l':
-          case 'L': {
-            ++gpio_text;
-            int idx = parse_dec(&gpio_text);
-            if (idx < NUM_GPIO) {
-              if (!GET_BIT(gpio_oe[0], idx)) {
-                fprintf(stderr,
-                        "GPIO: Host tried to pull disabled pin low: pin %2d\n",
-                        idx);
-              }
-              CLR_BIT(ctx->driven_pin_values, idx);
-              set_bit_val(&ctx->weak_pins, idx, weak);
-            } else {
-              fprintf(stderr,
-                      "GPIO: Host tried to pull invalid pin low: pin %2d\n",
-                      idx);
-            }
-            weak = false;
-            break;
-          }
-          case 'h':
-          case 'H': {
-            ++gpio_text;
-            int idx = parse_dec(&gpio_text);
-            if (idx < NUM_GPIO) {
-              if (!GET_BIT(gpio_oe[0], idx)) {
-                fprintf(stderr,
-                        "GPIO: Host tried to pull disabled pin high: pin %2d\n",
-                        idx);
-              }
-              SET_BIT(ctx->driven_pin_values, idx);
-              set_bit_val(&ctx->weak_pins, idx, weak);
-            } else {
-              fprintf(stderr,
-                      "GPIO: Host tried to pull invalid pin high: pin %2d\n",
-                      idx);
-            }
-            weak = false;
-            break;
-          }
-          default:
-            break;
-        }
-      }
+      ctx->cmd_len += read_len;
+      parse_commands(ctx, now, gpio_oe[0]);
     }
   }
 
-parse_loop_end:
-  ctx->counter += 1;
+  // Apply any queued updates that are now due.
+  size_t n_due = 0;
+  while (n_due < ctx->queue_len && ctx->queue[n_due].cycle <= now) {
+    apply_update(ctx, &ctx->queue[n_due], gpio_oe[0]);
+    ++n_due;
+  }
+  if (n_due) {
+    memmove(ctx->queue, &ctx->queue[n_due],
+            (ctx->queue_len - n_due) * sizeof(struct pin_update));
+    ctx->queue_len -= n_due;
+  }
+
+  // Nothing changes until the next FIFO read or queued update, unless the
+  // pull configuration does (in which case we are called again anyway).
+  uint64_t next = ctx->next_read;
+  if (ctx->queue_len && ctx->queue[0].cycle < next) {
+    next = ctx->queue[0].cycle;
+  }
+  *next_cycle = (long long)next;
+
   // The verilated module simulates logic, but the weak/strong inputs result
   // from the properties of the IO pads and the selection of external pull
   // resistors. Since the verilated model doesn't model the analog properties
@@ -323,5 +470,6 @@ void gpiodpi_close(void *ctx_void) {
            ctx->host_to_dev_path, strerror(errno));
   }
 
+  free(ctx->queue);
   free(ctx);
 }
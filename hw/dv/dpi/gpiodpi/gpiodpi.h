@@ -23,26 +23,46 @@ void *gpiodpi_create(const char *name, int n_bits);
 /**
  * Attempt to post the current GPIO state to the outside world.
  *
+ * The state is only written if it differs from the last state written, so this
+ * may be called whenever either input might have changed.
+ *
  * Intended to be called from SystemVerilog.
  */
 void gpiodpi_device_to_host(void *ctx_void, svBitVecVal *gpio_data,
                             svBitVecVal *gpio_oe);
 
 /**
- * Attempt to read a GPIO command from the outside world.
+ * Attempt to read GPIO commands from the outside world, and apply any that are
+ * due.
+ *
+ * The commands from the host should be a whitespace-separated sequence of high
+ * and low commands, terminated by a newline. A high command is of the form
+ * |hN|, where N is a decimal pin number, and pulls the Nth GPIO pin high; a low
+ * command, |lN|, does the opposite. Prefixing either with |w| drives the pin
+ * weakly, so that an enabled pull-up or pull-down wins. All other pins are left
+ * in their previous state. Invalid commands are ignored.
+ *
+ * Commands are applied as soon as they are read, unless they follow a time:
+ * |@N| applies the following commands at cycle N, and |+N| applies them N
+ * cycles after the previous time (or after now, if there was none). This lets
+ * the host send a batch of pin changes that land on exact cycles, e.g.
+ * |@1000 h3 +50 l3| for a 50-cycle pulse at cycle 1000. Commands for the same
+ * cycle are applied in order.
  *
- * The commands from the host should be a space-separated sequence of high and
- * low commands, terminated by a newline. A high command is of the form |hXX|,
- * where XX are hex digits, pulls the XXth GPIO pin high; a low command, |lXX|,
- * does the opposite. All other pins at left in an unspecified state. Invalid
- * commands are ignored.
+ * The FIFO is only read every few thousand cycles, so this does nothing new
+ * until |next_cycle|, unless the pin configuration changes. The caller can skip
+ * calls (and hold the returned pin values) until then.
  *
  * Intended to be called from SystemVerilog.
+ * @param cycle the current clock cycle, which must not decrease between calls.
+ * @param[out] next_cycle the next cycle at which this must be called.
  * @return the values to pull the GPIO pins to.
  */
-uint32_t gpiodpi_host_to_device_tick(void *ctx_void, svBitVecVal *gpio_oe,
+uint32_t gpiodpi_host_to_device_tick(void *ctx_void, long long cycle,
+                                     svBitVecVal *gpio_oe,
                                      svBitVecVal *gpio_pull_en,
-                                     svBitVecVal *gpio_pull_sel);
+                                     svBitVecVal *gpio_pull_sel,
+                                     long long *next_cycle);
 
 /**
  * Relinquish resources held by a GPIO DPI interface.
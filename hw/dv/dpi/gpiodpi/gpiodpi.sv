@@ -29,9 +29,11 @@ module gpiodpi
 
    import "DPI-C" function
      int gpiodpi_host_to_device_tick(input chandle ctx,
+                                     input longint cycle,
                                      input logic [N_GPIO-1:0] gpio_en_d2p,
                                      input logic [N_GPIO-1:0] gpio_pull_en,
-                                     input logic [N_GPIO-1:0] gpio_pull_sel);
+                                     input logic [N_GPIO-1:0] gpio_pull_sel,
+                                     output longint next_cycle);
 
    chandle ctx;
 
@@ -55,21 +57,45 @@ module gpiodpi
 
    logic eff_clk = clk_i && active;
 
+   // Only report the pins to the host when they change. The C side also drops
+   // updates that don't change what the host sees.
    logic [N_GPIO-1:0] gpio_d2p_r;
+   logic [N_GPIO-1:0] gpio_en_d2p_r;
    always_ff @(posedge eff_clk) begin
      gpio_d2p_r <= gpio_d2p;
-     if (gpio_d2p_r != gpio_d2p) begin
+     gpio_en_d2p_r <= gpio_en_d2p;
+     if (gpio_d2p_r != gpio_d2p || gpio_en_d2p_r != gpio_en_d2p) begin
        gpiodpi_device_to_host(ctx, gpio_d2p, gpio_en_d2p);
      end
    end
 
-   logic gpio_write_pulse;
+   // Only call into C when it might have new pin values for us: at the cycle it
+   // asked for, or when the pad configuration that decides the pulls changes.
+   // gpio_p2d holds its value in between, and is refreshed straight after reset.
+   longint cycle = 0;
+   longint next_cycle = 0;
+   logic gpio_p2d_valid;
+   logic [N_GPIO-1:0] gpio_en_p2d_r;
+   logic [N_GPIO-1:0] gpio_pull_en_r;
+   logic [N_GPIO-1:0] gpio_pull_sel_r;
+
+   always_ff @(posedge eff_clk) begin
+     cycle <= cycle + 1;
+   end
 
    always_ff @(posedge eff_clk or negedge rst_ni) begin
      if (!rst_ni) begin
        gpio_p2d <= '0; // default value
-     end else begin
-       gpio_p2d <= gpiodpi_host_to_device_tick(ctx, gpio_en_d2p, gpio_pull_en, gpio_pull_sel);
+       gpio_p2d_valid <= 1'b0;
+     end else if (!gpio_p2d_valid || cycle >= next_cycle ||
+                  gpio_en_d2p != gpio_en_p2d_r || gpio_pull_en != gpio_pull_en_r ||
+                  gpio_pull_sel != gpio_pull_sel_r) begin
+       gpio_p2d <= gpiodpi_host_to_device_tick(ctx, cycle, gpio_en_d2p, gpio_pull_en,
+                                               gpio_pull_sel, next_cycle);
+       gpio_p2d_valid <= 1'b1;
+       gpio_en_p2d_r <= gpio_en_d2p;
+       gpio_pull_en_r <= gpio_pull_en;
+       gpio_pull_sel_r <= gpio_pull_sel;
      end
    end
 
@@ -10,8 +10,38 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "dpi_profile.h"
 #include "tcp_server.h"
 
+DPI_PROFILE_COUNTER(jtagdpi);
+
+/**
+ * The maximum number of bits in a single vectored scan. The bit count is sent
+ * as a 16-bit number.
+ */
+#define JTAG_VEC_MAX_BITS 0xffff
+
+/**
+ * State of a vectored scan (the 'V' and 'W' extension commands, see README.md)
+ */
+struct jtag_vec {
+  // True while a vectored scan is being received or driven
+  bool active;
+  // True if TDO should be sent back when the scan is done ('V' command)
+  bool capture;
+  // The number of bytes of the bit count that have been received so far
+  uint8_t hdr_len;
+  // The number of bits in the scan and the index of the next bit to drive
+  uint32_t num_bits;
+  uint32_t bit;
+  // True if the next tick should raise TCK (finishing the current bit)
+  bool tck_rise_next;
+  // The byte of packed TMS/TDI pairs holding the current bit
+  uint8_t pairs;
+  // Captured TDO bits, LSB first
+  char tdo[(JTAG_VEC_MAX_BITS + 7) / 8];
+};
+
 struct jtagdpi_ctx {
   // Server context
   struct tcp_server_ctx *sock;
@@ -22,6 +52,8 @@ struct jtagdpi_ctx {
   uint8_t tdo;
   uint8_t trst_n;
   uint8_t srst_n;
+  // Vectored scan in progress
+  struct jtag_vec vec;
 };
 
 /**
@@ -41,12 +73,92 @@ static void reset_jtag_signals(struct jtagdpi_ctx *ctx) {
   ctx->srst_n = 1;
 }
 
+/**
+ * Drive the next half TCK cycle of a vectored scan
+ *
+ * Each bit takes two ticks. The first drops TCK and drives TMS and TDI. The
+ * second samples TDO (which the TAP updates on the falling edge of TCK) and
+ * raises TCK. This is the same sequence that OpenOCD's bitbang driver uses, but
+ * without a command byte (and possibly a round trip) for each step.
+ */
+static void vec_tick(struct jtagdpi_ctx *ctx) {
+  struct jtag_vec *vec = &ctx->vec;
+  char byte;
+
+  // Collect the 16-bit (little-endian) bit count. This doesn't touch the pins,
+  // so it doesn't need a tick to itself.
+  while (vec->hdr_len < 2) {
+    if (!tcp_server_read(ctx->sock, &byte)) {
+      return;
+    }
+    vec->num_bits |= (uint32_t)(uint8_t)byte << (8 * vec->hdr_len);
+    ++vec->hdr_len;
+  }
+
+  if (vec->bit < vec->num_bits) {
+    if (!vec->tck_rise_next) {
+      // Fetch the next 4 TMS/TDI pairs if we need them, then drop TCK
+      if (vec->bit % 4 == 0) {
+        if (!tcp_server_read(ctx->sock, &byte)) {
+          return;
+        }
+        vec->pairs = (uint8_t)byte;
+      }
+      unsigned shift = 2 * (vec->bit % 4);
+      ctx->tdi = (vec->pairs >> shift) & 0x1;
+      ctx->tms = (vec->pairs >> (shift + 1)) & 0x1;
+      ctx->tck = 0;
+      vec->tck_rise_next = true;
+      return;
+    }
+
+    if (vec->capture) {
+      char *tdo_byte = &vec->tdo[vec->bit / 8];
+      if (vec->bit % 8 == 0) {
+        *tdo_byte = 0;
+      }
+      *tdo_byte |= (char)(ctx->tdo << (vec->bit % 8));
+    }
+    ctx->tck = 1;
+    vec->tck_rise_next = false;
+    ++vec->bit;
+  }
+
+  if (vec->bit == vec->num_bits) {
+    if (vec->capture) {
+      tcp_server_write_buf(ctx->sock, vec->tdo, (vec->num_bits + 7) / 8);
+    }
+    vec->active = false;
+  }
+}
+
+/**
+ * Start a vectored scan
+ *
+ * @param capture true if the TDO bits should be sent back to the client
+ */
+static void vec_start(struct jtagdpi_ctx *ctx, bool capture) {
+  struct jtag_vec *vec = &ctx->vec;
+  vec->active = true;
+  vec->capture = capture;
+  vec->hdr_len = 0;
+  vec->num_bits = 0;
+  vec->bit = 0;
+  vec->tck_rise_next = false;
+  vec_tick(ctx);
+}
+
 /**
  * Update the JTAG signals in the context structure
  */
 static void update_jtag_signals(struct jtagdpi_ctx *ctx) {
   assert(ctx);
 
+  if (ctx->vec.active) {
+    vec_tick(ctx);
+    return;
+  }
+
   /*
    * Documentation pointer:
    * The remote_bitbang protocol implemented below is documented in the OpenOCD
@@ -85,6 +197,9 @@ static void update_jtag_signals(struct jtagdpi_ctx *ctx) {
   } else if (cmd == 'Q') {
     // quit (client disconnect)
     act_quit = true;
+  } else if (cmd == 'V' || cmd == 'W') {
+    // vectored scan (extension to remote_bitbang), with or without TDO
+    vec_start(ctx, cmd == 'V');
   } else {
     fprintf(stderr,
             "JTAG DPI Protocol violation detected: unsupported command %c\n",
@@ -137,6 +252,7 @@ void jtagdpi_close(void *ctx_void) {
 
 void jtagdpi_tick(void *ctx_void, svBit *tck, svBit *tms, svBit *tdi,
                   svBit *trst_n, svBit *srst_n, const svBit tdo) {
+  DPI_PROFILE_SCOPE(jtagdpi);
   struct jtagdpi_ctx *ctx = (struct jtagdpi_ctx *)ctx_void;
 
   ctx->tdo = tdo;
@@ -9,6 +9,8 @@
 
 #include "spidpi.h"
 
+#if SPIDPI_MONITOR
+
 #define MON_BUFLEN 65
 
 struct mon_ctx {
@@ -214,3 +216,5 @@ void monitor_spi(void *mon_void, FILE *mon_file, int loglevel, int tick,
   mon->prev_p2d = p2d;
   mon->prev_d2p = d2p;
 }
+
+#endif  // SPIDPI_MONITOR
@@ -21,11 +21,69 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "dpi_profile.h"
 #include "spidpi.h"
+#include "tcp_server.h"
 #ifdef VERILATOR
 #include "verilator_sim_ctrl.h"
 #endif
 
+DPI_PROFILE_COUNTER(spidpi);
+
+// The size of a transaction-level request header (see README.md), including
+// the 'T' command byte.
+#define SPI_TXN_HDR_BYTES 14
+
+// The maximum amount of data in a single transaction-level request
+#define SPI_TXN_MAX_DATA (1 << 20)
+
+// Bits in the flags byte of a transaction-level request
+#define SPI_TXN_ADDR_LANES_MASK 0x3
+#define SPI_TXN_DATA_LANES_SHIFT 2
+#define SPI_TXN_READ 0x10
+#define SPI_TXN_NO_OPCODE 0x20
+
+// Transactions have (up to) four phases: opcode, address, dummy and data
+#define SPI_TXN_NUM_PHASES 4
+
+/**
+ * One phase of a transaction-level request
+ */
+struct spi_phase {
+  // The number of SCK cycles in the phase
+  uint32_t cycles;
+  // The number of data lanes used (1, 2 or 4)
+  int lanes;
+  // Data to drive (MSB first), or NULL if the host doesn't drive the lanes
+  const uint8_t *out;
+  // Where to capture data (MSB first), or NULL if nothing should be captured
+  uint8_t *in;
+};
+
+/**
+ * State for the transaction-level protocol
+ */
+struct spi_txn {
+  // The request header received so far
+  uint8_t hdr[SPI_TXN_HDR_BYTES];
+  size_t hdr_len;
+  // The decoded request. For writes, data_rx is the number of bytes of write
+  // data received so far.
+  uint32_t data_len;
+  uint32_t data_rx;
+  int clk_div;
+  // True while the transaction is being driven on the pins
+  bool active;
+  uint8_t cmd[5];
+  uint8_t *tx;
+  uint8_t *rx;
+  struct spi_phase phases[SPI_TXN_NUM_PHASES];
+  uint32_t total_cycles;
+  // Progress through the transaction
+  int div_count;
+  uint32_t half_cycle;
+};
+
 // This holds the necessary SPI state.
 #define MAX_TRANSACTION 4
 struct spidpi_ctx {
@@ -49,6 +107,10 @@ struct spidpi_ctx {
   char driving;
   int state;
   char buf[MAX_TRANSACTION];
+  // Transaction-level requests (if a listen port was given)
+  struct tcp_server_ctx *sock;
+  struct spi_txn txn;
+  int txn_driving;
 };
 
 // SPI Host States
@@ -63,14 +125,18 @@ struct spidpi_ctx {
 // and resume at the first SPI packet
 // #define CONTROL_TRACE
 
-void *spidpi_create(const char *name, int mode, int loglevel) {
-  int i;
+void *spidpi_create(const char *name, int mode, int loglevel,
+                    int listen_port) {
   struct spidpi_ctx *ctx =
       (struct spidpi_ctx *)calloc(1, sizeof(struct spidpi_ctx));
   assert(ctx);
 
   ctx->loglevel = loglevel;
-  ctx->mon = monitor_spi_init(mode);
+#if SPIDPI_MONITOR
+  if (loglevel) {
+    ctx->mon = monitor_spi_init(mode);
+  }
+#endif
   ctx->tick = 0;
   ctx->msbfirst = 1;
   ctx->nmax = MAX_TRANSACTION;
@@ -113,6 +179,17 @@ void *spidpi_create(const char *name, int mode, int loglevel) {
       "NOTE: a SPI transaction is run for every 4 characters entered.\n",
       ctx->ptyname, name, ctx->ptyname);
 
+  if (listen_port) {
+    ctx->sock = tcp_server_create(name, listen_port);
+    printf(
+        "SPI: Transaction-level requests for %s are accepted on port %d.\n",
+        name, listen_port);
+  }
+
+  if (!ctx->mon) {
+    return (void *)ctx;
+  }
+
   rv = snprintf(ctx->mon_pathname, PATH_MAX, "%s/%s.log", cwd, name);
   assert(rv <= PATH_MAX && rv > 0);
   ctx->mon_file = fopen(ctx->mon_pathname, "w");
@@ -131,25 +208,243 @@ void *spidpi_create(const char *name, int mode, int loglevel) {
   return (void *)ctx;
 }
 
-char spidpi_tick(void *ctx_void, const svLogicVecVal *d2p_data) {
-  struct spidpi_ctx *ctx = (struct spidpi_ctx *)ctx_void;
-  assert(ctx);
-  int d2p = d2p_data->aval;
+/**
+ * Set up the phases of a transaction-level request whose header (and, for a
+ * write, data) has been received, and start driving it.
+ */
+static void txn_start(struct spidpi_ctx *ctx) {
+  struct spi_txn *txn = &ctx->txn;
+  const uint8_t *hdr = txn->hdr;
+  uint8_t opcode = hdr[1];
+  uint8_t flags = hdr[2];
+  uint8_t addr_bytes = hdr[3];
+  uint8_t dummy_cycles = hdr[4];
+  uint32_t addr = (uint32_t)hdr[6] | (uint32_t)hdr[7] << 8 |
+                  (uint32_t)hdr[8] << 16 | (uint32_t)hdr[9] << 24;
+  int addr_lanes = 1 << (flags & SPI_TXN_ADDR_LANES_MASK);
+  int data_lanes = 1 << ((flags >> SPI_TXN_DATA_LANES_SHIFT) & 0x3);
+  bool read = flags & SPI_TXN_READ;
 
-  // Will tick at the host clock
-  ctx->tick++;
+  txn->cmd[0] = opcode;
+  for (int i = 0; i < addr_bytes; ++i) {
+    txn->cmd[1 + i] = addr >> (8 * (addr_bytes - 1 - i));
+  }
 
-#ifdef VERILATOR
-#ifdef CONTROL_TRACE
-  if (ctx->tick == 4) {
-    VerilatorSimCtrl::GetInstance().TraceOff();
+  // Opcode: always on a single lane
+  struct spi_phase *ph = txn->phases;
+  ph[0].cycles = (flags & SPI_TXN_NO_OPCODE) ? 0 : 8;
+  ph[0].lanes = 1;
+  ph[0].out = &txn->cmd[0];
+  ph[0].in = NULL;
+  // Address
+  ph[1].cycles = 8 * addr_bytes / addr_lanes;
+  ph[1].lanes = addr_lanes;
+  ph[1].out = &txn->cmd[1];
+  ph[1].in = NULL;
+  // Dummy cycles. The host lets go of the lanes unless this is a single-lane
+  // transfer, where it just holds SDI low.
+  ph[2].cycles = dummy_cycles;
+  ph[2].lanes = data_lanes;
+  ph[2].out = NULL;
+  ph[2].in = NULL;
+  // Data. Single-lane transfers are full duplex, so we capture SDO even when
+  // writing.
+  ph[3].cycles = 8 * txn->data_len / data_lanes;
+  ph[3].lanes = data_lanes;
+  ph[3].out = read ? NULL : txn->tx;
+  ph[3].in = (read || data_lanes == 1) ? txn->rx : NULL;
+
+  memset(txn->rx, 0, txn->data_len);
+  txn->total_cycles = 0;
+  for (int i = 0; i < SPI_TXN_NUM_PHASES; ++i) {
+    txn->total_cycles += ph[i].cycles;
   }
-#endif
-#endif
 
-  monitor_spi(ctx->mon, ctx->mon_file, ctx->loglevel, ctx->tick, ctx->driving,
-              d2p);
+  txn->clk_div = hdr[5] ? hdr[5] : 4;
+  txn->div_count = 0;
+  txn->half_cycle = 0;
+  txn->active = true;
+}
+
+/**
+ * Find the phase for SCK cycle idx of the current transaction
+ *
+ * @param idx  on entry, the index of the cycle in the transaction. On exit,
+ *             the index of the cycle within the phase.
+ * @return the phase, or NULL if the transaction has no such cycle
+ */
+static const struct spi_phase *txn_phase(const struct spi_txn *txn,
+                                         uint32_t *idx) {
+  for (int i = 0; i < SPI_TXN_NUM_PHASES; ++i) {
+    if (*idx < txn->phases[i].cycles) {
+      return &txn->phases[i];
+    }
+    *idx -= txn->phases[i].cycles;
+  }
+  return NULL;
+}
+
+/**
+ * Drive the data lanes for SCK cycle idx of the current transaction
+ */
+static void txn_drive(struct spidpi_ctx *ctx, uint32_t idx) {
+  const struct spi_phase *ph = txn_phase(&ctx->txn, &idx);
+  int sd = 0, sd_en = 0;
+
+  if (ph && ph->out) {
+    // This cycle carries bits [bit, bit + lanes) of the data, MSB first. The
+    // most significant of them goes on the highest lane.
+    uint32_t bit = idx * ph->lanes;
+    unsigned shift = 8 - bit % 8 - ph->lanes;
+    sd = (ph->out[bit / 8] >> shift) & ((1 << ph->lanes) - 1);
+    sd_en = (1 << ph->lanes) - 1;
+  } else if (!ph || ph->lanes == 1) {
+    // Hold SDI low when there's nothing to send on a single lane
+    sd_en = 1;
+  }
+
+  int driving = ctx->txn_driving & (P2D_SCK | P2D_CSB);
+  for (int lane = 0; lane < 4; ++lane) {
+    driving |= ((sd >> lane) & 1) ? P2D_SD(lane) : 0;
+    driving |= ((sd_en >> lane) & 1) ? P2D_SD_EN(lane) : 0;
+  }
+  ctx->txn_driving = driving;
+}
+
+/**
+ * Sample the data lanes for SCK cycle idx of the current transaction
+ */
+static void txn_sample(struct spidpi_ctx *ctx, uint32_t idx, int d2p) {
+  const struct spi_phase *ph = txn_phase(&ctx->txn, &idx);
+  if (!ph || !ph->in) {
+    return;
+  }
+
+  int val;
+  if (ph->lanes == 1) {
+    val = (d2p & D2P_SDO) ? 1 : 0;
+  } else {
+    val = d2p & ((1 << ph->lanes) - 1);
+  }
+  uint32_t bit = idx * ph->lanes;
+  unsigned shift = 8 - bit % 8 - ph->lanes;
+  ph->in[bit / 8] |= val << shift;
+}
+
+/**
+ * Receive a transaction-level request over the socket
+ *
+ * @return true once a complete request has been received and started
+ */
+static bool txn_receive(struct spidpi_ctx *ctx) {
+  struct spi_txn *txn = &ctx->txn;
+
+  if (txn->hdr_len < SPI_TXN_HDR_BYTES) {
+    txn->hdr_len +=
+        tcp_server_read_buf(ctx->sock, (char *)&txn->hdr[txn->hdr_len],
+                            SPI_TXN_HDR_BYTES - txn->hdr_len);
+    if (txn->hdr_len && txn->hdr[0] != 'T') {
+      fprintf(stderr,
+              "SPI DPI: Protocol violation detected: unsupported command %c\n",
+              txn->hdr[0]);
+      exit(1);
+    }
+    if (txn->hdr_len < SPI_TXN_HDR_BYTES) {
+      return false;
+    }
+
+    uint8_t flags = txn->hdr[2];
+    int addr_lanes = 1 << (flags & SPI_TXN_ADDR_LANES_MASK);
+    int data_lanes = 1 << ((flags >> SPI_TXN_DATA_LANES_SHIFT) & 0x3);
+    txn->data_len = (uint32_t)txn->hdr[10] | (uint32_t)txn->hdr[11] << 8 |
+                    (uint32_t)txn->hdr[12] << 16 |
+                    (uint32_t)txn->hdr[13] << 24;
+    if (addr_lanes > 4 || data_lanes > 4 || txn->hdr[3] > 4 ||
+        (8 * txn->hdr[3]) % addr_lanes || txn->data_len > SPI_TXN_MAX_DATA) {
+      fprintf(stderr, "SPI DPI: Invalid transaction-level request header\n");
+      exit(1);
+    }
+
+    txn->tx = (uint8_t *)realloc(txn->tx, txn->data_len ? txn->data_len : 1);
+    txn->rx = (uint8_t *)realloc(txn->rx, txn->data_len ? txn->data_len : 1);
+    assert(txn->tx && txn->rx);
+    txn->data_rx = (flags & SPI_TXN_READ) ? txn->data_len : 0;
+  }
+
+  if (txn->data_rx < txn->data_len) {
+    txn->data_rx +=
+        tcp_server_read_buf(ctx->sock, (char *)&txn->tx[txn->data_rx],
+                            txn->data_len - txn->data_rx);
+    if (txn->data_rx < txn->data_len) {
+      return false;
+    }
+  }
+
+  txn->hdr_len = 0;
+  txn_start(ctx);
+  return true;
+}
+
+/**
+ * Advance the transaction-level request that is being driven
+ *
+ * Each SCK edge is clk_div ticks after the previous one. Half cycle 0 drops
+ * CSB, then each SCK cycle has a leading and a trailing edge, and the final
+ * half cycle raises CSB again and sends the captured data back to the client.
+ */
+static int txn_tick(struct spidpi_ctx *ctx, int d2p) {
+  struct spi_txn *txn = &ctx->txn;
+
+  if (txn->div_count) {
+    --txn->div_count;
+    return ctx->txn_driving;
+  }
+  txn->div_count = txn->clk_div - 1;
+
+  int sck_idle = ctx->cpol ? P2D_SCK : 0;
+  uint32_t h = txn->half_cycle++;
+
+  if (h == 0) {
+    // CSB low, SCK idle. In CPHA 0, the first bit must be set up now.
+    ctx->txn_driving = sck_idle;
+    if (!ctx->cpha && txn->total_cycles) {
+      txn_drive(ctx, 0);
+    }
+    return ctx->txn_driving;
+  }
+
+  if (h == 2 * txn->total_cycles + 1) {
+    // CSB high, clock stopped
+    ctx->txn_driving = P2D_CSB | sck_idle | P2D_SD_EN(0);
+    txn->active = false;
+    if (txn->data_len) {
+      tcp_server_write_buf(ctx->sock, (const char *)txn->rx, txn->data_len);
+    }
+    return ctx->txn_driving;
+  }
+
+  uint32_t cycle = (h - 1) / 2;
+  bool leading = (h % 2) == 1;
+  ctx->txn_driving ^= P2D_SCK;
+
+  if (leading == !ctx->cpha) {
+    // Sample at the leading edge in CPHA 0 and the trailing edge in CPHA 1
+    txn_sample(ctx, cycle, d2p);
+  }
+  // Drive at the leading edge in CPHA 1. In CPHA 0, the next bit is set up at
+  // the trailing edge.
+  if (ctx->cpha && leading) {
+    txn_drive(ctx, cycle);
+  } else if (!ctx->cpha && !leading && cycle + 1 < txn->total_cycles) {
+    txn_drive(ctx, cycle + 1);
+  }
+  return ctx->txn_driving;
+}
 
+/**
+ * Advance the host for requests typed into the pty
+ */
+static char pty_tick(struct spidpi_ctx *ctx, int d2p) {
   if (ctx->state == SP_IDLE) {
     int n = read(ctx->host, &(ctx->buf[ctx->nin]), ctx->nmax - ctx->nin);
     if (n == -1) {
@@ -249,11 +544,54 @@ char spidpi_tick(void *ctx_void, const svLogicVecVal *d2p_data) {
   return ctx->driving;
 }
 
+int spidpi_tick(void *ctx_void, const svLogicVecVal *d2p_data) {
+  DPI_PROFILE_SCOPE(spidpi);
+  struct spidpi_ctx *ctx = (struct spidpi_ctx *)ctx_void;
+  assert(ctx);
+  int d2p = d2p_data->aval;
+
+  // Will tick at the host clock
+  ctx->tick++;
+
+#ifdef VERILATOR
+#ifdef CONTROL_TRACE
+  if (ctx->tick == 4) {
+    VerilatorSimCtrl::GetInstance().TraceOff();
+  }
+#endif
+#endif
+
+#if SPIDPI_MONITOR
+  if (ctx->mon) {
+    int p2d = ctx->txn.active ? ctx->txn_driving
+                              : (ctx->driving | P2D_SD_EN(0));
+    monitor_spi(ctx->mon, ctx->mon_file, ctx->loglevel, ctx->tick, p2d, d2p);
+  }
+#endif
+
+  // Transaction-level requests take over the pins while they are driven, and
+  // are only started when the pty host is idle.
+  if (ctx->sock && !ctx->txn.active && ctx->state == SP_IDLE) {
+    txn_receive(ctx);
+  }
+  if (ctx->txn.active) {
+    return txn_tick(ctx, d2p);
+  }
+  return pty_tick(ctx, d2p) | P2D_SD_EN(0);
+}
+
 void spidpi_close(void *ctx_void) {
   struct spidpi_ctx *ctx = (struct spidpi_ctx *)ctx_void;
   if (!ctx) {
     return;
   }
-  fclose(ctx->mon_file);
+  if (ctx->sock) {
+    tcp_server_close(ctx->sock);
+  }
+  if (ctx->mon_file) {
+    fclose(ctx->mon_file);
+  }
+  free(ctx->txn.tx);
+  free(ctx->txn.rx);
   free(ctx);
 }
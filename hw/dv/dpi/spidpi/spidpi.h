@@ -5,25 +5,66 @@
 #ifndef OPENTITAN_HW_DV_DPI_SPIDPI_SPIDPI_H_
 #define OPENTITAN_HW_DV_DPI_SPIDPI_SPIDPI_H_
 
+#include <stdio.h>
 #include <svdpi.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// Bits in data to C
-#define D2P_SDO 0x2
-#define D2P_SDO_EN 0x1
+// Set SPIDPI_MONITOR to 0 to compile out the SPI monitor (monitor_spi.c), so
+// that spidpi_tick doesn't decode every edge.
+#ifndef SPIDPI_MONITOR
+#define SPIDPI_MONITOR 1
+#endif
+
+// Bits in data to C: the values of the four data lanes in the bottom nibble
+// and their output enables (from the device) in the top nibble. In single-lane
+// SPI, SD1 is SDO.
+#define D2P_SD(lane) (0x1 << (lane))
+#define D2P_SD_EN(lane) (0x10 << (lane))
+#define D2P_SDO D2P_SD(1)
+#define D2P_SDO_EN D2P_SD_EN(1)
 
-// Bits in char from C
+// Bits in int from C: clock, chip select, the values of the four data lanes
+// and the host's output enables for them. In single-lane SPI, SD0 is SDI.
 #define P2D_SCK 0x1
 #define P2D_CSB 0x2
-#define P2D_SDI 0x4
+#define P2D_SD(lane) (0x4 << (lane))
+#define P2D_SD_EN(lane) (0x40 << (lane))
+#define P2D_SDI P2D_SD(0)
+
+// Bits in int to the flash model (spidpi_flash): the clock, chip select and
+// four data lanes driven by the SPI host in the chip.
+#define FLASH_IN_SCK 0x1
+#define FLASH_IN_CSB 0x2
+#define FLASH_IN_SD(lane) (0x4 << (lane))
 
-void *spidpi_create(const char *name, int mode, int loglevel);
-char spidpi_tick(void *ctx_void, const svLogicVecVal *d2p_data);
+// Bits in int from the flash model: the values of the four data lanes and its
+// output enables for them. Single-lane output is on SD1.
+#define FLASH_OUT_SD(lane) (0x1 << (lane))
+#define FLASH_OUT_SD_EN(lane) (0x10 << (lane))
+
+void *spidpi_create(const char *name, int mode, int loglevel, int listen_port);
+int spidpi_tick(void *ctx_void, const svLogicVecVal *d2p_data);
 void spidpi_close(void *ctx_void);
 
+/**
+ * Create a SPI NOR flash model
+ *
+ * @param name display name of the flash
+ * @param image_path file holding the contents of the flash. It is created (or
+ *                   extended) with erased bytes if needed and mapped, so
+ *                   programs and erases persist. "" means the flash starts
+ *                   erased and nothing is saved.
+ * @param size_bytes size of the flash: a power of two of at least 64 KiB
+ * @return the model, or NULL on error
+ */
+void *spidpi_flash_create(const char *name, const char *image_path,
+                          int size_bytes);
+int spidpi_flash_tick(void *ctx_void, int pins);
+void spidpi_flash_close(void *ctx_void);
+
 // monitor
 void monitor_spi(void *mon_void, FILE *mon_file, int loglevel, int tick,
                  int p2d, int d2p);
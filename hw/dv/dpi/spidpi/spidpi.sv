@@ -7,35 +7,42 @@
 // Bits in LOG_LEVEL sets what is output on info socket
 // 0x01 -- monitor packets
 // 0x08 -- bit level
+// If LOG_LEVEL is 0, the monitor is disabled (and no log file is created).
+//
+// If LISTEN_PORT is nonzero, the host also accepts whole SPI transactions
+// (including dual and quad transfers) over TCP on that port. See README.md.
 
 module spidpi
   #(
   parameter string NAME = "spi0",
   parameter int MODE = 0,
-  parameter int LOG_LEVEL = 9
+  parameter int LOG_LEVEL = 9,
+  parameter int LISTEN_PORT = 0
   )(
-  input  logic clk_i,
-  input  logic rst_ni,
-  output logic spi_device_sck_o,
-  output logic spi_device_csb_o,
-  output logic spi_device_sdi_o,
-  input  logic spi_device_sdo_i,
-  input  logic spi_device_sdo_en_i
-
+  input  logic       clk_i,
+  input  logic       rst_ni,
+  output logic       spi_device_sck_o,
+  output logic       spi_device_csb_o,
+  // Data lanes. In single-lane SPI, lane 0 is SDI and lane 1 is SDO.
+  output logic [3:0] spi_device_sd_o,
+  output logic [3:0] spi_device_sd_en_o,
+  input  logic [3:0] spi_device_sd_i,
+  input  logic [3:0] spi_device_sd_en_i
 );
   import "DPI-C" function
-    chandle spidpi_create(input string name, input int mode, input int loglevel);
+    chandle spidpi_create(input string name, input int mode, input int loglevel,
+                          input int listen_port);
 
   import "DPI-C" function
     void spidpi_close(input chandle ctx);
 
   import "DPI-C" function
-    byte spidpi_tick(input chandle ctx_void, input logic [1:0] d2p_data);
+    int spidpi_tick(input chandle ctx_void, input logic [7:0] d2p_data);
 
   chandle ctx;
 
   initial begin
-    ctx = spidpi_create(NAME, MODE, LOG_LEVEL);
+    ctx = spidpi_create(NAME, MODE, LOG_LEVEL, LISTEN_PORT);
   end
 
   final begin
@@ -43,16 +50,17 @@ module spidpi
   end
 
   logic       unused_rst = rst_ni;
-  logic [1:0] d2p;
+  logic [7:0] d2p;
   logic       unused_dummy;
 
-  assign d2p = { spi_device_sdo_i, spi_device_sdo_en_i};
+  assign d2p = {spi_device_sd_en_i, spi_device_sd_i};
   always_ff @(posedge clk_i) begin
-    automatic byte p2d = spidpi_tick(ctx, d2p);
-    spi_device_sck_o <= p2d[0];
-    spi_device_csb_o <= p2d[1];
-    spi_device_sdi_o <= p2d[2];
+    automatic int p2d = spidpi_tick(ctx, d2p);
+    spi_device_sck_o   <= p2d[0];
+    spi_device_csb_o   <= p2d[1];
+    spi_device_sd_o    <= p2d[5:2];
+    spi_device_sd_en_o <= p2d[9:6];
     // stop verilator warning
-    unused_dummy <= |p2d[7:3];
+    unused_dummy <= |p2d[31:10];
   end
 endmodule
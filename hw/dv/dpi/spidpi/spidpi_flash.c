@@ -0,0 +1,556 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "dpi_profile.h"
+#include "spidpi.h"
+
+DPI_PROFILE_COUNTER(spidpi_flash);
+
+// Opcodes
+#define FLASH_OP_WRSR 0x01
+#define FLASH_OP_PP 0x02
+#define FLASH_OP_READ 0x03
+#define FLASH_OP_WRDI 0x04
+#define FLASH_OP_RDSR 0x05
+#define FLASH_OP_WREN 0x06
+#define FLASH_OP_FAST_READ 0x0b
+#define FLASH_OP_SE 0x20
+#define FLASH_OP_WRSR2 0x31
+#define FLASH_OP_QPP 0x32
+#define FLASH_OP_RDSR2 0x35
+#define FLASH_OP_DOR 0x3b
+#define FLASH_OP_SFDP 0x5a
+#define FLASH_OP_CE_60 0x60
+#define FLASH_OP_QOR 0x6b
+#define FLASH_OP_JEDEC_ID 0x9f
+#define FLASH_OP_EN4B 0xb7
+#define FLASH_OP_CE 0xc7
+#define FLASH_OP_BE 0xd8
+#define FLASH_OP_EX4B 0xe9
+
+// Status register 1: write in progress and write enable latch
+#define FLASH_SR1_WIP 0x01
+#define FLASH_SR1_WEL 0x02
+
+#define FLASH_PAGE_BYTES 256
+#define FLASH_SECTOR_BYTES (4 * 1024)
+#define FLASH_BLOCK_BYTES (64 * 1024)
+
+// JEDEC manufacturer and memory type reported by the JEDEC ID command. The
+// third byte is log2 of the size.
+#define FLASH_JEDEC_MANUFACTURER 0xef
+#define FLASH_JEDEC_MEMORY_TYPE 0x40
+
+#define FLASH_SFDP_BYTES 0x34
+
+/**
+ * The phases of a transaction, from the point of view of the flash
+ */
+enum flash_phase {
+  kFlashPhaseOpcode,
+  kFlashPhaseAddr,
+  kFlashPhaseDummy,
+  // Bytes from the host, such as page program data
+  kFlashPhaseDataIn,
+  // Bytes to the host, such as read data
+  kFlashPhaseDataOut,
+  // Nothing more to do until CSB goes high
+  kFlashPhaseIgnore,
+};
+
+struct spidpi_flash_ctx {
+  // The contents of the flash, mapped from the image file (or anonymous
+  // memory if there is none)
+  uint8_t *mem;
+  uint32_t size;
+  int fd;
+  uint8_t sfdp[FLASH_SFDP_BYTES];
+
+  uint8_t status1;
+  uint8_t status2;
+  bool addr4;
+  // Pins sampled at the previous call
+  int pins_q;
+  int driving;
+
+  // The current transaction
+  enum flash_phase phase;
+  uint8_t opcode;
+  uint32_t addr;
+  int addr_bytes;
+  int dummy_cycles;
+  // Lanes used for the data phase (1, 2 or 4)
+  int data_lanes;
+  // The byte being shifted in or out and the number of bits shifted so far
+  uint8_t shift;
+  int bits;
+  uint32_t bytes;
+  // Page program data, applied when CSB goes high
+  uint8_t prog_buf[FLASH_PAGE_BYTES];
+  bool prog_valid[FLASH_PAGE_BYTES];
+};
+
+static void put_le32(uint8_t *buf, uint32_t val) {
+  for (int i = 0; i < 4; ++i) {
+    buf[i] = val >> (8 * i);
+  }
+}
+
+/**
+ * Fill in the SFDP table: the header, a single parameter header and the JEDEC
+ * basic flash parameter table (JESD216, 9 DWORDs).
+ */
+static void sfdp_init(struct spidpi_flash_ctx *ctx) {
+  uint8_t *sfdp = ctx->sfdp;
+  memset(sfdp, 0xff, sizeof(ctx->sfdp));
+
+  // SFDP header: signature, revision 1.0, one parameter header
+  memcpy(sfdp, "SFDP", 4);
+  sfdp[4] = 0x00;
+  sfdp[5] = 0x01;
+  sfdp[6] = 0x00;
+  sfdp[7] = 0xff;
+
+  // Parameter header: basic flash parameter table, revision 1.0, 9 DWORDs
+  // long, at 0x10
+  sfdp[8] = 0x00;
+  sfdp[9] = 0x00;
+  sfdp[10] = 0x01;
+  sfdp[11] = 9;
+  sfdp[12] = 0x10;
+  sfdp[13] = 0x00;
+  sfdp[14] = 0x00;
+  sfdp[15] = 0xff;
+
+  uint8_t *bfpt = &sfdp[0x10];
+  // 1st DWORD: 4 KiB erase with opcode 0x20, 1-1-2 and 1-1-4 fast reads, and
+  // 3-byte addresses (or 3- and 4-byte addresses if the flash needs them).
+  uint32_t addr_bytes = ctx->size > (1u << 24) ? 0x1 : 0x0;
+  put_le32(&bfpt[0], 0xff800000 | 1 << 22 | addr_bytes << 17 | 1 << 16 |
+                         FLASH_OP_SE << 8 | 1 << 2 | 0x1);
+  // 2nd DWORD: the density in bits, minus one
+  put_le32(&bfpt[4], ctx->size * 8 - 1);
+  // 3rd DWORD: 1-1-4 fast read with 8 dummy cycles, no 1-4-4
+  put_le32(&bfpt[8], FLASH_OP_QOR << 24 | 8 << 16);
+  // 4th DWORD: 1-1-2 fast read with 8 dummy cycles, no 1-2-2
+  put_le32(&bfpt[12], FLASH_OP_DOR << 8 | 8);
+  // 5th to 7th DWORDs: no 2-2-2 or 4-4-4 fast reads
+  put_le32(&bfpt[16], 0xffffffee);
+  put_le32(&bfpt[20], 0x0000ffff);
+  put_le32(&bfpt[24], 0x0000ffff);
+  // 8th and 9th DWORDs: 4 KiB and 64 KiB erase types
+  put_le32(&bfpt[28], FLASH_OP_BE << 24 | 16 << 16 | FLASH_OP_SE << 8 | 12);
+  put_le32(&bfpt[32], 0);
+}
+
+/**
+ * Map the flash image at path, creating or extending it with erased bytes as
+ * needed. Returns false (having printed a message) on error.
+ */
+static bool image_map(struct spidpi_flash_ctx *ctx, const char *path) {
+  ctx->fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (ctx->fd < 0) {
+    fprintf(stderr, "SPI flash: Unable to open %s: %s\n", path,
+            strerror(errno));
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(ctx->fd, &st) != 0) {
+    fprintf(stderr, "SPI flash: Unable to stat %s: %s\n", path,
+            strerror(errno));
+    return false;
+  }
+  if ((uint64_t)st.st_size > ctx->size) {
+    fprintf(stderr,
+            "SPI flash: %s is %lld bytes, which is larger than the %u byte "
+            "flash.\n",
+            path, (long long)st.st_size, ctx->size);
+    return false;
+  }
+  if ((uint64_t)st.st_size < ctx->size && ftruncate(ctx->fd, ctx->size) != 0) {
+    fprintf(stderr, "SPI flash: Unable to extend %s: %s\n", path,
+            strerror(errno));
+    return false;
+  }
+
+  ctx->mem = (uint8_t *)mmap(NULL, ctx->size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, ctx->fd, 0);
+  if (ctx->mem == MAP_FAILED) {
+    ctx->mem = NULL;
+    fprintf(stderr, "SPI flash: Unable to map %s: %s\n", path,
+            strerror(errno));
+    return false;
+  }
+
+  // The extension reads as zeros, but erased flash reads as all ones
+  if ((uint64_t)st.st_size < ctx->size) {
+    memset(ctx->mem + st.st_size, 0xff, ctx->size - st.st_size);
+  }
+  return true;
+}
+
+void *spidpi_flash_create(const char *name, const char *image_path,
+                          int size_bytes) {
+  uint32_t size = (uint32_t)size_bytes;
+  if (size < FLASH_BLOCK_BYTES || (size & (size - 1)) != 0) {
+    fprintf(stderr,
+            "SPI flash: The size of %s must be a power of two of at least "
+            "64 KiB, not %u bytes.\n",
+            name, size);
+    return NULL;
+  }
+
+  struct spidpi_flash_ctx *ctx =
+      (struct spidpi_flash_ctx *)calloc(1, sizeof(struct spidpi_flash_ctx));
+  assert(ctx);
+
+  ctx->size = size;
+  ctx->fd = -1;
+  ctx->pins_q = FLASH_IN_CSB;
+  ctx->phase = kFlashPhaseIgnore;
+  sfdp_init(ctx);
+
+  if (image_path && image_path[0]) {
+    if (!image_map(ctx, image_path)) {
+      spidpi_flash_close(ctx);
+      return NULL;
+    }
+    printf("SPI flash: %s is backed by %s (%u bytes).\n", name, image_path,
+           size);
+  } else {
+    ctx->mem = (uint8_t *)mmap(NULL, size, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(ctx->mem != MAP_FAILED);
+    memset(ctx->mem, 0xff, size);
+    printf("SPI flash: %s starts erased (%u bytes) and isn't saved.\n", name,
+           size);
+  }
+
+  return (void *)ctx;
+}
+
+void spidpi_flash_close(void *ctx_void) {
+  struct spidpi_flash_ctx *ctx = (struct spidpi_flash_ctx *)ctx_void;
+  if (!ctx) {
+    return;
+  }
+  if (ctx->mem) {
+    munmap(ctx->mem, ctx->size);
+  }
+  if (ctx->fd >= 0) {
+    close(ctx->fd);
+  }
+  free(ctx);
+}
+
+/**
+ * Decide what follows the opcode
+ */
+static void opcode_done(struct spidpi_flash_ctx *ctx) {
+  int addr_bytes = ctx->addr4 ? 4 : 3;
+
+  ctx->phase = kFlashPhaseAddr;
+  ctx->addr_bytes = addr_bytes;
+  ctx->dummy_cycles = 0;
+  ctx->data_lanes = 1;
+
+  switch (ctx->opcode) {
+    case FLASH_OP_READ:
+      break;
+    case FLASH_OP_FAST_READ:
+      ctx->dummy_cycles = 8;
+      break;
+    case FLASH_OP_DOR:
+      ctx->dummy_cycles = 8;
+      ctx->data_lanes = 2;
+      break;
+    case FLASH_OP_QOR:
+      ctx->dummy_cycles = 8;
+      ctx->data_lanes = 4;
+      break;
+    case FLASH_OP_SFDP:
+      ctx->addr_bytes = 3;
+      ctx->dummy_cycles = 8;
+      break;
+    case FLASH_OP_QPP:
+      ctx->data_lanes = 4;
+      // fallthrough
+    case FLASH_OP_PP:
+      memset(ctx->prog_valid, 0, sizeof(ctx->prog_valid));
+      break;
+    case FLASH_OP_SE:
+    case FLASH_OP_BE:
+      break;
+    case FLASH_OP_RDSR:
+    case FLASH_OP_RDSR2:
+    case FLASH_OP_JEDEC_ID:
+      ctx->phase = kFlashPhaseDataOut;
+      break;
+    case FLASH_OP_WRSR:
+    case FLASH_OP_WRSR2:
+      ctx->phase = kFlashPhaseDataIn;
+      break;
+    default:
+      // Single-byte commands take effect when CSB goes high
+      ctx->phase = kFlashPhaseIgnore;
+      break;
+  }
+}
+
+/**
+ * Return the byte at index ctx->bytes of the data phase of a read command
+ */
+static uint8_t data_out_byte(struct spidpi_flash_ctx *ctx) {
+  uint32_t idx = ctx->bytes;
+  switch (ctx->opcode) {
+    case FLASH_OP_RDSR:
+      return ctx->status1;
+    case FLASH_OP_RDSR2:
+      return ctx->status2;
+    case FLASH_OP_JEDEC_ID: {
+      int log2_size = __builtin_ctz(ctx->size);
+      const uint8_t id[3] = {FLASH_JEDEC_MANUFACTURER, FLASH_JEDEC_MEMORY_TYPE,
+                             (uint8_t)log2_size};
+      return idx < 3 ? id[idx] : 0;
+    }
+    case FLASH_OP_SFDP: {
+      uint32_t addr = ctx->addr + idx;
+      return addr < FLASH_SFDP_BYTES ? ctx->sfdp[addr] : 0xff;
+    }
+    default:
+      // Reads wrap around at the end of the flash
+      return ctx->mem[(ctx->addr + idx) & (ctx->size - 1)];
+  }
+}
+
+/**
+ * Handle a byte from the host in the data phase
+ */
+static void data_in_byte(struct spidpi_flash_ctx *ctx, uint8_t byte) {
+  switch (ctx->opcode) {
+    case FLASH_OP_PP:
+    case FLASH_OP_QPP: {
+      // Programming wraps around within the page
+      uint32_t offset = (ctx->addr + ctx->bytes) % FLASH_PAGE_BYTES;
+      ctx->prog_buf[offset] = byte;
+      ctx->prog_valid[offset] = true;
+      break;
+    }
+    case FLASH_OP_WRSR:
+      if (ctx->bytes == 0) {
+        ctx->status1 = (ctx->status1 & (FLASH_SR1_WIP | FLASH_SR1_WEL)) |
+                       (byte & ~(FLASH_SR1_WIP | FLASH_SR1_WEL));
+      } else if (ctx->bytes == 1) {
+        ctx->status2 = byte;
+      }
+      break;
+    case FLASH_OP_WRSR2:
+      if (ctx->bytes == 0) {
+        ctx->status2 = byte;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * Apply a command when CSB goes high
+ *
+ * Programming and erasing take no time, so the write in progress bit never
+ * reads as set.
+ */
+static void command_end(struct spidpi_flash_ctx *ctx) {
+  bool wel = ctx->status1 & FLASH_SR1_WEL;
+  bool addressed = ctx->phase != kFlashPhaseOpcode &&
+                   ctx->phase != kFlashPhaseAddr;
+  uint32_t addr = ctx->addr & (ctx->size - 1);
+
+  switch (ctx->opcode) {
+    case FLASH_OP_WREN:
+      ctx->status1 |= FLASH_SR1_WEL;
+      return;
+    case FLASH_OP_WRDI:
+      break;
+    case FLASH_OP_EN4B:
+      ctx->addr4 = true;
+      return;
+    case FLASH_OP_EX4B:
+      ctx->addr4 = false;
+      return;
+    case FLASH_OP_PP:
+    case FLASH_OP_QPP:
+      if (!wel || !addressed) {
+        return;
+      }
+      addr &= ~(uint32_t)(FLASH_PAGE_BYTES - 1);
+      for (int i = 0; i < FLASH_PAGE_BYTES; ++i) {
+        if (ctx->prog_valid[i]) {
+          ctx->mem[addr + i] &= ctx->prog_buf[i];
+        }
+      }
+      break;
+    case FLASH_OP_SE:
+    case FLASH_OP_BE: {
+      if (!wel || !addressed) {
+        return;
+      }
+      uint32_t len = ctx->opcode == FLASH_OP_SE ? FLASH_SECTOR_BYTES
+                                                : FLASH_BLOCK_BYTES;
+      memset(ctx->mem + (addr & ~(len - 1)), 0xff, len);
+      break;
+    }
+    case FLASH_OP_CE:
+    case FLASH_OP_CE_60:
+      if (!wel) {
+        return;
+      }
+      memset(ctx->mem, 0xff, ctx->size);
+      break;
+    case FLASH_OP_WRSR:
+    case FLASH_OP_WRSR2:
+      if (ctx->bytes == 0) {
+        return;
+      }
+      break;
+    default:
+      return;
+  }
+  // Commands that write clear the write enable latch
+  ctx->status1 &= ~FLASH_SR1_WEL;
+}
+
+/**
+ * Shift in the data lanes at a rising edge of SCK
+ */
+static void sck_rise(struct spidpi_flash_ctx *ctx, int pins) {
+  int lanes = ctx->phase == kFlashPhaseDataIn ? ctx->data_lanes : 1;
+
+  switch (ctx->phase) {
+    case kFlashPhaseDummy:
+      if (--ctx->dummy_cycles == 0) {
+        ctx->phase = kFlashPhaseDataOut;
+      }
+      return;
+    case kFlashPhaseDataOut:
+    case kFlashPhaseIgnore:
+      return;
+    default:
+      break;
+  }
+
+  // The most significant bit of each group is on the highest lane. Single-lane
+  // input comes on SD0.
+  int val = (pins >> 2) & ((1 << lanes) - 1);
+  ctx->shift = ctx->shift << lanes | val;
+  ctx->bits += lanes;
+  if (ctx->bits < 8) {
+    return;
+  }
+  ctx->bits = 0;
+
+  switch (ctx->phase) {
+    case kFlashPhaseOpcode:
+      ctx->opcode = ctx->shift;
+      opcode_done(ctx);
+      break;
+    case kFlashPhaseAddr:
+      ctx->addr = ctx->addr << 8 | ctx->shift;
+      if (--ctx->addr_bytes == 0) {
+        if (ctx->opcode == FLASH_OP_PP || ctx->opcode == FLASH_OP_QPP) {
+          ctx->phase = kFlashPhaseDataIn;
+        } else if (ctx->opcode == FLASH_OP_SE || ctx->opcode == FLASH_OP_BE) {
+          ctx->phase = kFlashPhaseIgnore;
+        } else if (ctx->dummy_cycles) {
+          ctx->phase = kFlashPhaseDummy;
+        } else {
+          ctx->phase = kFlashPhaseDataOut;
+        }
+      }
+      break;
+    case kFlashPhaseDataIn:
+      data_in_byte(ctx, ctx->shift);
+      ++ctx->bytes;
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * Drive the next data bits at a falling edge of SCK
+ */
+static void sck_fall(struct spidpi_flash_ctx *ctx) {
+  if (ctx->phase != kFlashPhaseDataOut) {
+    ctx->driving = 0;
+    return;
+  }
+
+  int lanes = ctx->data_lanes;
+  if (ctx->bits == 0) {
+    ctx->shift = data_out_byte(ctx);
+    ++ctx->bytes;
+  }
+  int val = (ctx->shift >> (8 - lanes - ctx->bits)) & ((1 << lanes) - 1);
+  ctx->bits = (ctx->bits + lanes) % 8;
+
+  if (lanes == 1) {
+    // Single-lane output goes on SD1
+    ctx->driving = FLASH_OUT_SD_EN(1) | (val ? FLASH_OUT_SD(1) : 0);
+  } else {
+    ctx->driving = ((1 << lanes) - 1) * FLASH_OUT_SD_EN(0) | val;
+  }
+}
+
+int spidpi_flash_tick(void *ctx_void, int pins) {
+  DPI_PROFILE_SCOPE(spidpi_flash);
+  struct spidpi_flash_ctx *ctx = (struct spidpi_flash_ctx *)ctx_void;
+  if (!ctx) {
+    return 0;
+  }
+
+  int pins_q = ctx->pins_q;
+  ctx->pins_q = pins;
+
+  if (pins & FLASH_IN_CSB) {
+    if (!(pins_q & FLASH_IN_CSB)) {
+      command_end(ctx);
+    }
+    ctx->phase = kFlashPhaseIgnore;
+    ctx->driving = 0;
+    return 0;
+  }
+
+  if (pins_q & FLASH_IN_CSB) {
+    // CSB has just gone low
+    ctx->phase = kFlashPhaseOpcode;
+    ctx->opcode = 0;
+    ctx->addr = 0;
+    ctx->shift = 0;
+    ctx->bits = 0;
+    ctx->bytes = 0;
+    ctx->driving = 0;
+  }
+
+  if ((pins & FLASH_IN_SCK) && !(pins_q & FLASH_IN_SCK)) {
+    sck_rise(ctx, pins);
+  } else if (!(pins & FLASH_IN_SCK) && (pins_q & FLASH_IN_SCK)) {
+    sck_fall(ctx);
+  }
+  return ctx->driving;
+}
@@ -0,0 +1,61 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// SPIDPI flash -- act as a SPI NOR flash for a SPI host
+//
+// The contents are kept in the file given by the `SPIDPI_FLASH_<name>` plusarg, which is mapped
+// into memory rather than loaded, so programs and erases persist across runs. Without the
+// plusarg, the flash starts erased and nothing is saved. See README.md.
+
+module spidpi_flash
+  #(
+  parameter string NAME = "spi_flash0",
+  // Size of the flash in bytes: a power of two of at least 64 KiB
+  parameter int SIZE_BYTES = 16 * 1024 * 1024
+  )(
+  input  logic       clk_i,
+  input  logic       rst_ni,
+  input  logic       sck_i,
+  input  logic       csb_i,
+  // Data lanes. In single-lane SPI, lane 0 is SDI and lane 1 is SDO.
+  input  logic [3:0] sd_i,
+  output logic [3:0] sd_o,
+  output logic [3:0] sd_en_o
+);
+  import "DPI-C" function
+    chandle spidpi_flash_create(input string name, input string image_path,
+                                input int size_bytes);
+
+  import "DPI-C" function
+    void spidpi_flash_close(input chandle ctx);
+
+  import "DPI-C" function
+    int spidpi_flash_tick(input chandle ctx, input int pins);
+
+  chandle ctx;
+  string  image_path = "";
+
+  initial begin
+    $value$plusargs({"SPIDPI_FLASH_", NAME, "=%s"}, image_path);
+    ctx = spidpi_flash_create(NAME, image_path, SIZE_BYTES);
+  end
+
+  final begin
+    spidpi_flash_close(ctx);
+  end
+
+  logic unused_rst = rst_ni;
+  logic csb_q;
+
+  // The flash only has anything to do while it is selected (and on the cycle after, to finish the
+  // command).
+  always_ff @(posedge clk_i) begin
+    csb_q <= csb_i;
+    if (!csb_i || !csb_q) begin
+      automatic int out = spidpi_flash_tick(ctx, {26'b0, sd_i, csb_i, sck_i});
+      sd_o    <= out[3:0];
+      sd_en_o <= out[7:4];
+    end
+  end
+endmodule
@@ -19,42 +19,84 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "dpi_profile.h"
+#include "tcp_server.h"
+
+DPI_PROFILE_COUNTER(uartdpi);
+
 // This keeps the necessary uart state.
 struct uartdpi_ctx {
   char ptyname[64];
   int host;
   int device;
-  char tmp_read;
+  // If the UART is exported over TCP, this is the server and there is no pty
+  struct tcp_server_ctx *sock;
   FILE *log_file;
+
+  // Characters received from the host, waiting to be sent to the device. The
+  // FIFO is refilled with a single read once it has been drained, but at most
+  // once every UARTDPI_READ_POLL_INTERVAL polls.
+  char *rx_fifo;
+  size_t rx_size;
+  size_t rx_head;
+  size_t rx_tail;
+  unsigned rx_polls;
+
+  // Characters from the device, waiting to be sent to the host and the log.
+  // These are flushed on a newline, when the FIFO is full, or once the UART
+  // has been polled UARTDPI_FLUSH_POLLS times since the last character.
+  char *tx_fifo;
+  size_t tx_size;
+  size_t tx_len;
+  unsigned tx_idle_polls;
+  bool tx_dropped;
 };
 
-void *uartdpi_create(const char *name, const char *log_file_path) {
+void *uartdpi_create(const char *name, const char *log_file_path,
+                     int listen_port, int fifo_size) {
   struct uartdpi_ctx *ctx =
-      (struct uartdpi_ctx *)malloc(sizeof(struct uartdpi_ctx));
+      (struct uartdpi_ctx *)calloc(1, sizeof(struct uartdpi_ctx));
   assert(ctx);
 
   int rv;
 
-  // Initialize UART pseudo-terminal
-  struct termios tty;
-  cfmakeraw(&tty);
+  ctx->rx_size = fifo_size > 0 ? fifo_size : 1;
+  ctx->tx_size = ctx->rx_size;
+  ctx->rx_fifo = (char *)malloc(ctx->rx_size);
+  ctx->tx_fifo = (char *)malloc(ctx->tx_size);
+  assert(ctx->rx_fifo && ctx->tx_fifo);
 
-  rv = openpty(&ctx->host, &ctx->device, 0, &tty, 0);
-  assert(rv != -1);
+  if (listen_port) {
+    // Export the UART over TCP instead of creating a pseudo-terminal
+    ctx->sock = tcp_server_create(name, listen_port);
+    printf(
+        "\n"
+        "UART: Listening for %s on port %d. Connect to it with e.g.\n"
+        "$ nc localhost %d\n",
+        name, listen_port, listen_port);
+  } else {
+    // Initialize UART pseudo-terminal
+    struct termios tty;
+    cfmakeraw(&tty);
 
-  rv = ttyname_r(ctx->device, ctx->ptyname, 64);
-  assert(rv == 0 && "ttyname_r failed");
+    rv = openpty(&ctx->host, &ctx->device, 0, &tty, 0);
+    assert(rv != -1);
 
-  int cur_flags = fcntl(ctx->host, F_GETFL, 0);
-  assert(cur_flags != -1 && "Unable to read current flags.");
-  int new_flags = fcntl(ctx->host, F_SETFL, cur_flags | O_NONBLOCK);
-  assert(new_flags != -1 && "Unable to set FD flags");
+    rv = ttyname_r(ctx->device, ctx->ptyname, 64);
+    assert(rv == 0 && "ttyname_r failed");
 
-  printf(
-      "\n"
-      "UART: Created %s for %s. Connect to it with any terminal program, e.g.\n"
-      "$ screen %s\n",
-      ctx->ptyname, name, ctx->ptyname);
+    int cur_flags = fcntl(ctx->host, F_GETFL, 0);
+    assert(cur_flags != -1 && "Unable to read current flags.");
+    int new_flags = fcntl(ctx->host, F_SETFL, cur_flags | O_NONBLOCK);
+    assert(new_flags != -1 && "Unable to set FD flags");
+
+    printf(
+        "\n"
+        "UART: Created %s for %s. Connect to it with any terminal program, "
+        "e.g.\n"
+        "$ screen %s\n",
+        ctx->ptyname, name, ctx->ptyname);
+  }
 
   // Open log file (if requested)
   ctx->log_file = NULL;
@@ -71,10 +113,10 @@ void *uartdpi_create(const char *name, const char *log_file_path) {
         fprintf(stderr, "UART: Unable to open log file at %s: %s\n",
                 log_file_path, strerror(errno));
       } else {
-        // Switch log file output to line buffering to ensure lines written to
-        // the UART device show up in the log file as soon as a newline
-        // character is written.
-        rv = setvbuf(log_file, NULL, _IOLBF, 0);
+        // Output is written to the log file in batches, each of which is
+        // flushed as soon as it has been written. Lines written to the UART
+        // device therefore still show up in the log file promptly.
+        rv = setvbuf(log_file, NULL, _IOFBF, 0);
         assert(rv == 0);
 
         ctx->log_file = log_file;
@@ -87,14 +129,62 @@ void *uartdpi_create(const char *name, const char *log_file_path) {
   return (void *)ctx;
 }
 
+/**
+ * Send any characters in the TX FIFO to the host and the log file
+ */
+static void uartdpi_flush(struct uartdpi_ctx *ctx) {
+  ctx->tx_idle_polls = 0;
+  if (!ctx->tx_len) {
+    return;
+  }
+
+  if (ctx->sock) {
+    // Don't stall the simulation if nobody is listening: anything that doesn't
+    // fit in the socket buffer is dropped (but still logged).
+    size_t n = tcp_server_try_write_buf(ctx->sock, ctx->tx_fifo, ctx->tx_len);
+    if (n < ctx->tx_len && !ctx->tx_dropped) {
+      fprintf(stderr,
+              "UART: Socket buffer full, dropping output. Is a client "
+              "connected?\n");
+      ctx->tx_dropped = true;
+    }
+  } else {
+    size_t done = 0;
+    while (done < ctx->tx_len) {
+      ssize_t rv = write(ctx->host, &ctx->tx_fifo[done], ctx->tx_len - done);
+      if (rv < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        // The pty is full because the other end isn't reading. Drop the rest,
+        // rather than waiting for it.
+        break;
+      }
+      assert(rv > 0 && "Write to pseudo-terminal failed.");
+      done += rv;
+    }
+  }
+
+  if (ctx->log_file) {
+    size_t rv = fwrite(ctx->tx_fifo, sizeof(char), ctx->tx_len, ctx->log_file);
+    assert(rv == ctx->tx_len && "Write to log file failed.");
+    fflush(ctx->log_file);
+  }
+
+  ctx->tx_len = 0;
+}
+
 void uartdpi_close(void *ctx_void) {
   struct uartdpi_ctx *ctx = (struct uartdpi_ctx *)ctx_void;
   if (!ctx) {
     return;
   }
 
-  close(ctx->host);
-  close(ctx->device);
+  uartdpi_flush(ctx);
+
+  if (ctx->sock) {
+    tcp_server_close(ctx->sock);
+  } else {
+    close(ctx->host);
+    close(ctx->device);
+  }
 
   if (ctx->log_file) {
     // Always ensure the log file is flushed (most important when writing
@@ -105,36 +195,62 @@ void uartdpi_close(void *ctx_void) {
     }
   }
 
+  free(ctx->rx_fifo);
+  free(ctx->tx_fifo);
   free(ctx);
 }
 
 int uartdpi_can_read(void *ctx_void) {
+  DPI_PROFILE_SCOPE(uartdpi);
   struct uartdpi_ctx *ctx = (struct uartdpi_ctx *)ctx_void;
   if (ctx == NULL) {
     return 0;
   }
-  int rv = read(ctx->host, &ctx->tmp_read, 1);
-  return (rv == 1);
+
+  // This is polled continuously while the UART isn't transmitting, so it also
+  // serves as the clock for the TX flush timeout.
+  if (ctx->tx_len && ++ctx->tx_idle_polls >= UARTDPI_FLUSH_POLLS) {
+    uartdpi_flush(ctx);
+  }
+
+  if (ctx->rx_head != ctx->rx_tail) {
+    return 1;
+  }
+
+  if (++ctx->rx_polls < UARTDPI_READ_POLL_INTERVAL) {
+    return 0;
+  }
+  ctx->rx_polls = 0;
+
+  ssize_t rv;
+  if (ctx->sock) {
+    rv = tcp_server_read_buf(ctx->sock, ctx->rx_fifo, ctx->rx_size);
+  } else {
+    rv = read(ctx->host, ctx->rx_fifo, ctx->rx_size);
+  }
+  ctx->rx_head = 0;
+  ctx->rx_tail = rv > 0 ? rv : 0;
+  return ctx->rx_tail != 0;
 }
 
 char uartdpi_read(void *ctx_void) {
+  DPI_PROFILE_SCOPE(uartdpi);
   struct uartdpi_ctx *ctx = (struct uartdpi_ctx *)ctx_void;
+  assert(ctx->rx_head != ctx->rx_tail && "uartdpi_read with nothing to read");
 
-  return ctx->tmp_read;
+  return ctx->rx_fifo[ctx->rx_head++];
 }
 
 void uartdpi_write(void *ctx_void, char c) {
-  int rv;
+  DPI_PROFILE_SCOPE(uartdpi);
   struct uartdpi_ctx *ctx = (struct uartdpi_ctx *)ctx_void;
   if (ctx == NULL) {
     return;
   }
 
-  rv = write(ctx->host, &c, 1);
-  assert(rv == 1 && "Write to pseudo-terminal failed.");
-
-  if (ctx->log_file) {
-    rv = fwrite(&c, sizeof(char), 1, ctx->log_file);
-    assert(rv == 1 && "Write to log file failed.");
+  ctx->tx_fifo[ctx->tx_len++] = c;
+  ctx->tx_idle_polls = 0;
+  if (c == '\n' || ctx->tx_len == ctx->tx_size) {
+    uartdpi_flush(ctx);
   }
 }
@@ -9,7 +9,31 @@
 extern "C" {
 #endif
 
-void *uartdpi_create(const char *name, const char *log_file_path);
+// While the FIFO of characters from the host is empty, only try to refill it
+// once every UARTDPI_READ_POLL_INTERVAL calls to uartdpi_can_read.
+#ifndef UARTDPI_READ_POLL_INTERVAL
+#define UARTDPI_READ_POLL_INTERVAL 64
+#endif
+
+// Characters from the device are flushed on a newline, or once
+// uartdpi_can_read has been called UARTDPI_FLUSH_POLLS times without any more
+// arriving.
+#ifndef UARTDPI_FLUSH_POLLS
+#define UARTDPI_FLUSH_POLLS 10000
+#endif
+
+/**
+ * Create a UART
+ *
+ * @param name display name of the UART
+ * @param log_file_path file to copy the device's output to. "-" means stdout
+ *                      and "" means no log file.
+ * @param listen_port if nonzero, export the UART on this TCP port instead of
+ *                    creating a pseudo-terminal
+ * @param fifo_size size in bytes of the FIFO in each direction
+ */
+void *uartdpi_create(const char *name, const char *log_file_path,
+                     int listen_port, int fifo_size);
 void uartdpi_close(void *ctx_void);
 int uartdpi_can_read(void *ctx_void);
 char uartdpi_read(void *ctx_void);
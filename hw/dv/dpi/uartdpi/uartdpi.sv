@@ -5,7 +5,16 @@
 module uartdpi #(
   parameter integer BAUD = 'x,
   parameter integer FREQ = 'x,
-  parameter string NAME = "uart0"
+  parameter string NAME = "uart0",
+  // If nonzero, the UART is exported on this TCP port instead of a pseudo-terminal. This can be
+  // overridden with the `UARTDPI_PORT_<name>` plusarg.
+  parameter int LISTEN_PORT = 0,
+  // Size in bytes of the buffers between the simulation and the host in each direction
+  parameter int FIFO_SIZE = 4096,
+  // Set if the testbench can exchange characters with the UART's FIFOs through the backdoor_*
+  // functions below. The `UARTDPI_BACKDOOR` plusarg then switches to doing so instead of using
+  // tx_o and rx_i, which skips the serialization of each character.
+  parameter bit BACKDOOR = 1'b0
 )(
   input  logic clk_i,
   input  logic rst_ni,
@@ -21,7 +30,8 @@ module uartdpi #(
   localparam int CYCLES_PER_SYMBOL = FREQ / BAUD;
 
   import "DPI-C" function
-    chandle uartdpi_create(input string name, input string log_file_path);
+    chandle uartdpi_create(input string name, input string log_file_path, input int listen_port,
+                           input int fifo_size);
 
   import "DPI-C" function
     void uartdpi_close(input chandle ctx);
@@ -37,10 +47,29 @@ module uartdpi #(
 
   chandle ctx;
   string log_file_path = DEFAULT_LOG_FILE;
+  int listen_port = LISTEN_PORT;
+  bit backdoor = 1'b0;
 
   function automatic void initialize();
     $value$plusargs({"UARTDPI_LOG_", NAME, "=%s"}, log_file_path);
-    ctx = uartdpi_create(NAME, log_file_path);
+    $value$plusargs({"UARTDPI_PORT_", NAME, "=%d"}, listen_port);
+    backdoor = BACKDOOR && $test$plusargs("UARTDPI_BACKDOOR");
+    ctx = uartdpi_create(NAME, log_file_path, listen_port, FIFO_SIZE);
+  endfunction
+
+  // Backdoor access for the testbench, used in place of tx_o and rx_i when backdoor is set.
+  // backdoor_can_read() returns nonzero if there is a character from the host for the device, which
+  // backdoor_read() then returns. backdoor_write() passes a character from the device to the host.
+  function automatic bit backdoor_can_read();
+    return ctx != null && uartdpi_can_read(ctx) != 0;
+  endfunction
+
+  function automatic byte backdoor_read();
+    return uartdpi_read(ctx);
+  endfunction
+
+  function automatic void backdoor_write(byte c);
+    if (ctx != null) uartdpi_write(ctx, c);
   endfunction
 
   initial begin
@@ -73,7 +102,7 @@ module uartdpi #(
     end else begin
       if (!txactive) begin
         tx_o <= 1;
-        if (uartdpi_can_read(ctx)) begin
+        if (!backdoor && uartdpi_can_read(ctx)) begin
           automatic int c = uartdpi_read(ctx);
           txsymbol <= {1'b1, c[7:0], 1'b0};
           txactive <= 1;
@@ -108,7 +137,7 @@ module uartdpi #(
       seen_reset <= 1;
     end else begin
       if (!rxactive) begin
-        if (!rx_i && seen_reset) begin
+        if (!rx_i && seen_reset && !backdoor) begin
           rxactive <= 1;
           rxcount <= 0;
           rxcyccount <= 0;
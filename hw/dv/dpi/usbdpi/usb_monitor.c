@@ -26,14 +26,39 @@ typedef enum { M_NONE = 0, M_HOST, M_DEVICE } usbmon_driver_t;
 // Number of bytes in max output buffer line
 #define MAX_OBUF 80
 
+// Does this monitor produce a text log? This is constant false if the text
+// formatting has been compiled out, so that the formatting code drops out.
+#if USB_MONITOR_TEXT
+#define MON_TEXT(mon) ((mon)->file != NULL)
+#else
+#define MON_TEXT(mon) false
+#endif
+
+// pcap capture format (https://www.tcpdump.org/linktypes.html), with
+// nanosecond timestamps; each packet runs from the PID to the CRC, inclusive
+#define PCAP_MAGIC_NSEC 0xA1B23C4DU
+#define PCAP_LINKTYPE_USB_2_0 288U
+#define PCAP_SNAPLEN 0xFFFFU
+#define PCAP_FILE_HDR_SIZE 24U
+#define PCAP_REC_HDR_SIZE 16U
+
+// Size of the buffer in which pcap records are collected before writing
+#define PCAP_BUF_SIZE 0x10000U
+
 /**
  * USB monitor context
  */
 struct usb_monitor_ctx {
   /**
-   * Log file
+   * Text log file (NULL iff none)
    */
   FILE *file;
+  /**
+   * pcap capture file (NULL iff none), and the records waiting to be written
+   */
+  FILE *pcap;
+  uint8_t *pcap_buf;
+  size_t pcap_len;
   /**
    * Monitor state, reflecting the current state of the USB
    */
@@ -49,6 +74,10 @@ struct usb_monitor_ctx {
   int needbits;
   int sopAt;
   uint8_t lastpid;
+  /**
+   * PID byte of the current packet, as received (even if invalid)
+   */
+  uint8_t pid_raw;
   /**
    * USB data callback
    */
@@ -75,10 +104,43 @@ static inline void data_callback(usb_monitor_ctx_t *mon,
   }
 }
 
+/**
+ * Write out the pcap records that have been collected
+ */
+static void pcap_flush(usb_monitor_ctx_t *mon) {
+  if (mon->pcap_len) {
+    size_t written = fwrite(mon->pcap_buf, 1, mon->pcap_len, mon->pcap);
+    assert(written == mon->pcap_len);
+    mon->pcap_len = 0U;
+  }
+}
+
+/**
+ * Append a pcap record for the packet that has just ended
+ */
+static void pcap_packet(usb_monitor_ctx_t *mon) {
+  size_t len = 1U + mon->byte;
+  if (mon->pcap_len + PCAP_REC_HDR_SIZE + len > PCAP_BUF_SIZE) {
+    pcap_flush(mon);
+  }
+
+  // Timestamp of the start of the packet; bit intervals are 1/12 us
+  uint64_t ns = (uint64_t)(uint32_t)mon->sopAt * 1000U / 12U;
+  uint8_t *dp = &mon->pcap_buf[mon->pcap_len];
+  dp = set_le32(dp, (uint32_t)(ns / 1000000000U));
+  dp = set_le32(dp, (uint32_t)(ns % 1000000000U));
+  dp = set_le32(dp, (uint32_t)len);
+  dp = set_le32(dp, (uint32_t)len);
+  *dp++ = mon->pid_raw;
+  memcpy(dp, mon->bytes, mon->byte);
+  mon->pcap_len += PCAP_REC_HDR_SIZE + len;
+}
+
 /**
  * Create and initialize a USB monitor instance
  */
 usb_monitor_ctx_t *usb_monitor_init(const char *filename,
+                                    const char *pcap_filename,
                                     usb_monitor_data_callback_t data_cb,
                                     void *data_ctx) {
   usb_monitor_ctx_t *mon =
@@ -94,20 +156,53 @@ usb_monitor_ctx_t *usb_monitor_init(const char *filename,
   mon->data_callback = data_cb;
   mon->data_ctx = data_ctx;
 
-  mon->file = fopen(filename, "w");
-  if (!mon->file) {
-    fprintf(stderr, "USBDPI: Unable to open monitor file at %s: %s\n", filename,
-            strerror(errno));
-    free(mon);
-    return NULL;
-  }
+#if USB_MONITOR_TEXT
+  if (filename) {
+    mon->file = fopen(filename, "w");
+    if (!mon->file) {
+      fprintf(stderr, "USBDPI: Unable to open monitor file at %s: %s\n",
+              filename, strerror(errno));
+      free(mon);
+      return NULL;
+    }
 
-  // more useful for tail -f
-  setlinebuf(mon->file);
-  printf(
-      "\nUSBDPI: Monitor output file created at %s. Works well with tail:\n"
-      "$ tail -f %s\n",
-      filename, filename);
+    // more useful for tail -f
+    setlinebuf(mon->file);
+    printf(
+        "\nUSBDPI: Monitor output file created at %s. Works well with tail:\n"
+        "$ tail -f %s\n",
+        filename, filename);
+  }
+#endif
+
+  if (pcap_filename) {
+    mon->pcap = fopen(pcap_filename, "wb");
+    if (!mon->pcap) {
+      fprintf(stderr, "USBDPI: Unable to open capture file at %s: %s\n",
+              pcap_filename, strerror(errno));
+      if (mon->file) {
+        fclose(mon->file);
+      }
+      free(mon);
+      return NULL;
+    }
+    mon->pcap_buf = (uint8_t *)malloc(PCAP_BUF_SIZE);
+    assert(mon->pcap_buf);
+
+    uint8_t *dp = mon->pcap_buf;
+    dp = set_le32(dp, PCAP_MAGIC_NSEC);
+    dp = set_le16(dp, 2U);  // Version 2.4
+    dp = set_le16(dp, 4U);
+    dp = set_le32(dp, 0U);  // Reserved
+    dp = set_le32(dp, 0U);
+    dp = set_le32(dp, PCAP_SNAPLEN);
+    dp = set_le32(dp, PCAP_LINKTYPE_USB_2_0);
+    mon->pcap_len = dp - mon->pcap_buf;
+    assert(mon->pcap_len == PCAP_FILE_HDR_SIZE);
+
+    printf("\nUSBDPI: Capturing USB packets to %s (pcap format)\n",
+           pcap_filename);
+  }
 
   return mon;
 }
@@ -116,7 +211,14 @@ usb_monitor_ctx_t *usb_monitor_init(const char *filename,
  * Finalize a USB monitor
  */
 void usb_monitor_fin(usb_monitor_ctx_t *mon) {
-  fclose(mon->file);
+  if (mon->file) {
+    fclose(mon->file);
+  }
+  if (mon->pcap) {
+    pcap_flush(mon);
+    fclose(mon->pcap);
+    free(mon->pcap_buf);
+  }
   free(mon);
 }
 
@@ -124,6 +226,9 @@ void usb_monitor_fin(usb_monitor_ctx_t *mon) {
  * Append a formatted message to the USB monitor log file
  */
 void usb_monitor_log(usb_monitor_ctx_t *ctx, const char *fmt, ...) {
+  if (!MON_TEXT(ctx)) {
+    return;
+  }
   char obuf[MAX_OBUF];
   va_list ap;
   va_start(ap, fmt);
@@ -177,8 +282,8 @@ char *pid_2data(int pid, unsigned char d0, unsigned char d1) {
  */
 void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
                  bool hdrive, uint32_t p2d, uint32_t d2p, uint8_t *lastpid) {
-  bool log = ((loglevel & 0x2) != 0);
-  bool compact = ((loglevel & 0x1) != 0);
+  bool log = MON_TEXT(mon) && ((loglevel & 0x2) != 0);
+  bool compact = MON_TEXT(mon) && ((loglevel & 0x1) != 0);
 
   assert(mon);
 
@@ -187,7 +292,7 @@ void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
   // The DUT is a full speed device so the pull up should be on D+
   int dp, dn;
   if ((d2p & D2P_DP_EN) || (d2p & D2P_DN_EN) || (d2p & D2P_D_EN)) {
-    if (hdrive) {
+    if (hdrive && MON_TEXT(mon)) {
       fprintf(mon->file, "mon: %8d: Bus clash\n", tick_bits);
     }
     if (d2p & D2P_TX_USE_D_SE0) {
@@ -310,6 +415,9 @@ void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
       fprintf(mon->file, "mon: %8d: (%c) EOP\n", tick_bits,
               mon->driver == M_HOST ? 'H' : 'D');
     }
+    if (mon->pcap && mon->state == MS_GET_BYTES) {
+      pcap_packet(mon);
+    }
     mon->state = MS_IDLE;
     data_callback(mon, UsbMon_DataType_EOP, 0U);
     return;
@@ -318,7 +426,7 @@ void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
   int newbit = (((mon->line & 0xc) >> 2) == (mon->line & 0x3)) ? 1 : 0;
   mon->rawbits = (mon->rawbits << 1) | newbit;
   if ((mon->rawbits & 0x7e) == 0x7e) {
-    if (newbit == 1) {
+    if (newbit == 1 && MON_TEXT(mon)) {
       fprintf(mon->file, "mon: %8d: (%c) Bitstuff error, got 1 after 0x%x\n",
               tick_bits, mon->driver == M_HOST ? 'H' : 'D', mon->rawbits);
     }
@@ -337,6 +445,7 @@ void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
       // Any byte for which the upper nibble is not the exact complement
       // of the lower nibble is invalid
       uint8_t pid = (uint8_t)mon->bits;
+      mon->pid_raw = pid;
       if (((pid ^ 0xf0) >> 4) ^ (pid & 0x0f)) {
         if (log) {
           fprintf(mon->file, "mon: %8d: (%c) BAD PID 0x%x\n", tick_bits,
@@ -7,6 +7,11 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// Set USB_MONITOR_TEXT to 0 to compile out the formatting of the text log
+#ifndef USB_MONITOR_TEXT
+#define USB_MONITOR_TEXT 1
+#endif
+
 /**
  * USB monitor context
  */
@@ -29,12 +34,14 @@ typedef void (*usb_monitor_data_callback_t)(void *ctx_v,
 /**
  * Create and initialize a USB monitor instance
  *
- * @param  filename  Filename to be used for log file
- * @param  data_cb   USB data callback function
- * @param  data_ctx  Context for data callback
- * @return           USB monitor context
+ * @param  filename       Filename to be used for text log file (or NULL)
+ * @param  pcap_filename  Filename to be used for pcap capture file (or NULL)
+ * @param  data_cb        USB data callback function
+ * @param  data_ctx       Context for data callback
+ * @return                USB monitor context
  */
 usb_monitor_ctx_t *usb_monitor_init(const char *filename,
+                                    const char *pcap_filename,
                                     usb_monitor_data_callback_t data_cb,
                                     void *data_ctx);
 
@@ -16,9 +16,12 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "dpi_profile.h"
 #include "usb_utils.h"
 #include "usbdpi_test.h"
 
+DPI_PROFILE_COUNTER(usbdpi);
+
 // Indexed directly by ctx->state (ST_)
 static const char *st_states[] = {"ST_IDLE 0", "ST_SEND 1", "ST_GET 2",
                                   "ST_SYNC 3", "ST_EOP 4",  "ST_EOP0 5"};
@@ -128,11 +131,19 @@ void *usbdpi_create(const char *name, int loglevel) {
   cwd_rv = getcwd(cwd, sizeof(cwd));
   assert(cwd_rv != NULL);
 
-  // Monitor log file
+  // Monitor log file; this is only created if some text logging is enabled
   int rv = snprintf(ctx->mon_pathname, FILENAME_MAX, "%s/%s.log", cwd, name);
   assert(rv <= FILENAME_MAX && rv > 0);
+  bool text_log = (loglevel & (LOG_MON | LOG_MON_VERBOSE | LOG_BIT)) != 0;
+
+  // Packet capture file, for viewing in eg. Wireshark
+  rv = snprintf(ctx->pcap_pathname, FILENAME_MAX, "%s/%s.pcap", cwd, name);
+  assert(rv <= FILENAME_MAX && rv > 0);
+  bool pcap = (loglevel & LOG_PCAP) != 0;
 
-  ctx->mon = usb_monitor_init(ctx->mon_pathname, usbdpi_data_callback, ctx);
+  ctx->mon = usb_monitor_init(text_log ? ctx->mon_pathname : NULL,
+                              pcap ? ctx->pcap_pathname : NULL,
+                              usbdpi_data_callback, ctx);
 
   // Prepare the transfer descriptors for use
   usb_transfer_setup(ctx);
@@ -141,6 +152,7 @@ void *usbdpi_create(const char *name, int loglevel) {
 }
 
 void usbdpi_device_to_host(void *ctx_void, const svBitVecVal *usb_d2p) {
+  DPI_PROFILE_SCOPE(usbdpi);
   usbdpi_ctx_t *ctx = (usbdpi_ctx_t *)ctx_void;
   assert(ctx);
 
@@ -1113,6 +1125,7 @@ uint32_t inv_driving(usbdpi_ctx_t *ctx, uint32_t d2p) {
 }
 
 uint8_t usbdpi_host_to_device(void *ctx_void, const svBitVecVal *usb_d2p) {
+  DPI_PROFILE_SCOPE(usbdpi);
   usbdpi_ctx_t *ctx = (usbdpi_ctx_t *)ctx_void;
   assert(ctx);
   int d2p = usb_d2p[0];
@@ -1452,6 +1465,7 @@ uint8_t usbdpi_host_to_device(void *ctx_void, const svBitVecVal *usb_d2p) {
 
 // Export some internal diagnostic state for visibility in waveforms
 void usbdpi_diags(void *ctx_void, svBitVecVal *diags) {
+  DPI_PROFILE_SCOPE(usbdpi);
   usbdpi_ctx_t *ctx = (usbdpi_ctx_t *)ctx_void;
 
   // Check for overflow, which would cause confusion in waveform interpretation.
@@ -1473,6 +1487,9 @@ void usbdpi_close(void *ctx_void) {
   if (!ctx) {
     return;
   }
+  if (ctx->nstreams) {
+    streams_report(ctx);
+  }
   usb_monitor_fin(ctx->mon);
   free(ctx);
 }
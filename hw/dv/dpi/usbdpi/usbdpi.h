@@ -47,8 +47,11 @@ typedef uint32_t svBitVecVal;
 #define SENSE_AT 20 * 8
 
 // Logging level (parameter to module)
-#define LOG_MON 0x01  // USB monitor logging (packet level)
-#define LOG_BIT 0x08  // bit level
+#define LOG_MON 0x01          // USB monitor logging (packet level)
+#define LOG_MON_VERBOSE 0x02  // more verbose monitor
+#define LOG_STREAM 0x04       // per-packet stream test diagnostics
+#define LOG_BIT 0x08          // bit level
+#define LOG_PCAP 0x10         // pcap capture of all packets
 
 // Error insertion
 #define INSERT_ERR_CRC 0
@@ -306,6 +309,7 @@ struct usbdpi_ctx {
   // Diagnostic logging and bus monitoring
   int loglevel;
   char mon_pathname[FILENAME_MAX];
+  char pcap_pathname[FILENAME_MAX];
 
   /**
    * USB monitor instance
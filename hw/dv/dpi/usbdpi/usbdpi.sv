@@ -7,7 +7,11 @@
 // Bits in LOG_LEVEL sets what is output on socket
 // 0x01 -- monitor_usb (packet level)
 // 0x02 -- more verbose monitor
+// 0x04 -- per-packet stream test diagnostics (otherwise only a summary of each
+//         stream is reported at the end of the simulation)
 // 0x08 -- bit level
+// 0x10 -- capture all packets to <NAME>.pcap (LINKTYPE_USB_2_0, for Wireshark)
+// No text log file is created unless one of 0x01, 0x02 or 0x08 is set.
 
 module usbdpi #(
   parameter string NAME = "usb0",
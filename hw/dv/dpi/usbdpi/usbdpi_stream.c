@@ -29,18 +29,27 @@
 // Size of stream signature
 #define SIZEOF_STREAM_SIGNATURE 0x10U
 
+// The streams are checked and generated a 32-bit word at a time, using
+// tables of the next four LFSR output bytes (first byte in the LSBs) and the
+// LFSR state after four advances, for each LFSR state
+static uint32_t lfsr_word[0x100U];
+static uint8_t lfsr_skip4[0x100U];
+
 // Verbose logging/diagnostic reporting
-// TODO: consider folding this into the existing log level
-static const bool verbose = false;
+static inline bool verbose(const usbdpi_ctx_t *ctx) {
+  return (ctx->loglevel & LOG_STREAM) != 0;
+}
 
 // Single letter prefix indicating the transfer type
 static const char xfr_sym[] = {'C', 'X', 'B', 'I'};
 
 // Determine the next stream for which IN data packets shall be requested
-static inline unsigned in_stream_next(usbdpi_ctx_t *ctx);
+// (-1 iff there is none in this frame)
+static int in_stream_next(usbdpi_ctx_t *ctx);
 
-// Determine the next stream for which OUT data shall be sent
-static inline unsigned out_stream_next(usbdpi_ctx_t *ctx);
+// Determine the next stream for which OUT data shall be sent (-1 iff there is
+// none in this frame)
+static int out_stream_next(usbdpi_ctx_t *ctx);
 
 // Check a data packet received from the test software (usbdev_stream_test)
 static bool stream_data_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
@@ -62,24 +71,112 @@ static usbdpi_transfer_t *stream_data_process(usbdpi_ctx_t *ctx,
 static bool stream_sig_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
                              usbdpi_transfer_t *rx);
 
-// Determine the next stream for which IN data packets shall be requested
-inline unsigned in_stream_next(usbdpi_ctx_t *ctx) {
-  uint8_t id = ctx->stream_in;
-  if (++id >= ctx->nstreams) {
-    id = 0U;
+// Is this stream's endpoint polled periodically rather than in the time left
+// over in each frame?
+static inline bool stream_periodic(const usbdpi_stream_t *s) {
+  return s->xfr_type == USB_TRANSFER_TYPE_ISOCHRONOUS ||
+         s->xfr_type == USB_TRANSFER_TYPE_INTERRUPT;
+}
+
+// Does this stream want an IN transaction now?
+static bool in_stream_ready(const usbdpi_ctx_t *ctx, const usbdpi_stream_t *s,
+                            bool allow_nak) {
+  if (!s->retrieve) {
+    // Nothing is sent on the bus, but we may still need to fake some data
+    return s->send && !s->received;
+  }
+  if (stream_periodic(s)) {
+    return s->in_frame != ctx->frame;
+  }
+  return allow_nak || !s->in_nak;
+}
+
+// Does this stream want an OUT transaction now?
+static bool out_stream_ready(const usbdpi_ctx_t *ctx, const usbdpi_stream_t *s,
+                             bool allow_nak) {
+  if (!s->received) {
+    return false;
+  }
+  if (!s->send) {
+    // Received data is just discarded, without using the bus
+    return true;
+  }
+  if (stream_periodic(s)) {
+    return s->out_frame != ctx->frame;
+  }
+  return allow_nak || !s->out_nak;
+}
+
+// Pick the next ready stream in round-robin order after *last, preferring
+// those that were not NAKed last time; returns -1 iff none is ready
+static int stream_pick(usbdpi_ctx_t *ctx, uint8_t *last,
+                       bool (*ready)(const usbdpi_ctx_t *,
+                                     const usbdpi_stream_t *, bool)) {
+  for (int allow_nak = 0; allow_nak < 2; allow_nak++) {
+    uint8_t id = *last;
+    for (unsigned n = 0U; n < ctx->nstreams; n++) {
+      if (++id >= ctx->nstreams) {
+        id = 0U;
+      }
+      if (ready(ctx, &ctx->stream[id], allow_nak)) {
+        *last = id;
+        return id;
+      }
+    }
   }
-  ctx->stream_in = id;
-  return id;
+  return -1;
+}
+
+// Determine the next stream for which IN data packets shall be requested
+int in_stream_next(usbdpi_ctx_t *ctx) {
+  return stream_pick(ctx, &ctx->stream_in, in_stream_ready);
 }
 
 // Determine the next stream for which OUT data shall be sent
-inline unsigned out_stream_next(usbdpi_ctx_t *ctx) {
-  uint8_t id = ctx->stream_out;
-  if (++id >= ctx->nstreams) {
-    id = 0U;
+int out_stream_next(usbdpi_ctx_t *ctx) {
+  return stream_pick(ctx, &ctx->stream_out, out_stream_ready);
+}
+
+// Is there any stream that wants an IN transaction in this frame?
+static bool in_stream_pending(usbdpi_ctx_t *ctx) {
+  for (unsigned id = 0U; id < ctx->nstreams; id++) {
+    if (in_stream_ready(ctx, &ctx->stream[id], true)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Is there any stream that wants an OUT transaction in this frame?
+static bool out_stream_pending(usbdpi_ctx_t *ctx) {
+  for (unsigned id = 0U; id < ctx->nstreams; id++) {
+    if (out_stream_ready(ctx, &ctx->stream[id], true)) {
+      return true;
+    }
   }
-  ctx->stream_out = id;
-  return id;
+  return false;
+}
+
+// Populate the LFSR tables
+static void lfsr_tables_init(void) {
+  for (unsigned lfsr = 0U; lfsr < 0x100U; lfsr++) {
+    uint8_t state = (uint8_t)lfsr;
+    uint32_t word = 0U;
+    for (unsigned b = 0U; b < 4U; b++) {
+      word |= (uint32_t)state << (b * 8U);
+      state = LFSR_ADVANCE(state);
+    }
+    lfsr_word[lfsr] = word;
+    lfsr_skip4[lfsr] = state;
+  }
+}
+
+// Note that a data packet has been accepted in either direction
+static void stream_data_accepted(const usbdpi_ctx_t *ctx, usbdpi_stream_t *s) {
+  if (!s->stats.in_pkts && !s->stats.out_pkts) {
+    s->stats.first_bits = ctx->tick_bits;
+  }
+  s->stats.last_bits = ctx->tick_bits;
 }
 
 // Initialize streaming state for the given number of streams
@@ -93,12 +190,17 @@ bool streams_init(usbdpi_ctx_t *ctx, unsigned nstreams,
     return false;
   }
 
-  if (verbose) {
+  if (verbose(ctx)) {
     printf("[usbdpi] Stream test running with %u streams(s)\n", nstreams);
     printf("[usbdpi] - retrieve %c checking %c retrying %c send %c\n",
            retrieve ? 'Y' : 'N', checking ? 'Y' : 'N', retrying ? 'Y' : 'N',
            send ? 'Y' : 'N');
   }
+  if (!checking) {
+    printf("[usbdpi] Warning: Stream data checking disabled\n");
+  }
+
+  lfsr_tables_init();
 
   // Remember the number of streams and initialize the arbitration of
   // IN and OUT traffic
@@ -135,6 +237,12 @@ bool streams_init(usbdpi_ctx_t *ctx, unsigned nstreams,
     ctx->stream[id].nretries = 0U;
     // No received packets
     ctx->stream[id].received = NULL;
+    // Not yet scheduled in any frame
+    ctx->stream[id].in_frame = (uint16_t)(ctx->frame - 1U);
+    ctx->stream[id].out_frame = (uint16_t)(ctx->frame - 1U);
+    ctx->stream[id].in_nak = false;
+    ctx->stream[id].out_nak = false;
+    memset(&ctx->stream[id].stats, 0, sizeof(ctx->stream[id].stats));
   }
   return true;
 }
@@ -197,13 +305,23 @@ bool stream_data_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
         // Note: use a local copy of the LFSR so that we can check the data
         //       field even on those packets that we choose to reject
         uint8_t tst_lfsr = s->tst_lfsr;
-        while (num_bytes-- > 0U) {
+        while (num_bytes > 0U) {
+          // Check whole words where possible, falling back to individual
+          // bytes at the end of the packet and to report mismatches
+          if (num_bytes >= 4U && get_le32(sp) == lfsr_word[tst_lfsr]) {
+            tst_lfsr = lfsr_skip4[tst_lfsr];
+            sp += 4U;
+            num_bytes -= 4U;
+            continue;
+          }
           uint8_t recvd = *sp++;
+          num_bytes--;
           if (recvd != tst_lfsr) {
             printf(
                 "[usbdpi] %c%u: Mismatched data from device 0x%02x, "
                 "expected 0x%02x\n",
                 xfr_sym[s->xfr_type], s->id, recvd, tst_lfsr);
+            s->stats.mismatches++;
             ok = false;
           }
           // Advance our local LFSR
@@ -215,8 +333,6 @@ bool stream_data_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
         if (accept && ok) {
           s->tst_lfsr = tst_lfsr;
         }
-      } else {
-        printf("[usbdpi] Warning: Stream data checking disabled\n");
       }
     }
   }
@@ -236,7 +352,12 @@ usbdpi_transfer_t *stream_data_gen(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
     ctx->ep_in[s->ep_in].next_data = DATA_TOGGLE_ADVANCE(data);
     // ...and that the data is as expected
     uint8_t *dp = transfer_data_start(tr, data, len);
-    for (unsigned idx = 0U; idx < len; idx++) {
+    unsigned idx = 0U;
+    for (; idx + 4U <= len; idx += 4U) {
+      set_le32(&dp[idx], lfsr_word[s->tst_lfsr]);
+      s->tst_lfsr = lfsr_skip4[s->tst_lfsr];
+    }
+    for (; idx < len; idx++) {
       dp[idx] = s->tst_lfsr;
       s->tst_lfsr = LFSR_ADVANCE(s->tst_lfsr);
     }
@@ -301,12 +422,23 @@ usbdpi_transfer_t *stream_data_process(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
   // failure
   s->dpi_rewind_lfsr = s->dpi_lfsr;
 
+  // Simply XOR the two LFSR-generated streams together, a word at a time
+  // unless we are reporting every byte
+  if (!verbose(ctx)) {
+    for (; num_bytes >= 4U; num_bytes -= 4U) {
+      set_le32(dp, get_le32(sp) ^ lfsr_word[s->dpi_lfsr]);
+      s->dpi_lfsr = lfsr_skip4[s->dpi_lfsr];
+      dp += 4U;
+      sp += 4U;
+    }
+  }
+
   while (num_bytes-- > 0U) {
     uint8_t recvd = *sp++;
 
     // Simply XOR the two LFSR-generated streams together
     *dp++ = recvd ^ s->dpi_lfsr;
-    if (verbose) {
+    if (verbose(ctx)) {
       printf("[usbdpi] 0x%02x <- 0x%02x ^ 0x%02x\n", *(dp - 1), recvd,
              s->dpi_lfsr);
     }
@@ -346,7 +478,7 @@ bool stream_sig_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
       // Note: all 32-bit quantities are in little endian order
 
       uint32_t num_bytes = get_le32(&sig[8]);
-      if (verbose) {
+      if (verbose(ctx)) {
         printf("[usbdpi] Stream signature at %p head 0x%x tail 0x%x\n", sig,
                get_le32(&sig[0]), get_le32(&sig[12]));
       }
@@ -363,7 +495,7 @@ bool stream_sig_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
         // packet.
         uint16_t seq = get_le16(&sig[6]);
         if (s->xfr_type == USB_TRANSFER_TYPE_ISOCHRONOUS) {
-          if (verbose) {
+          if (verbose(ctx)) {
             printf("[usbdpi] S#%u: seq 0x%04x\n", s->id, seq);
           }
           if (seq < s->tst_seq) {
@@ -373,8 +505,11 @@ bool stream_sig_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
                 s->tst_seq, seq);
             return false;
           } else if (seq > s->tst_seq) {
-            printf("[usbdpi] Iso stream #%u dropped %u packet(s)\n", s->id,
-                   seq - s->tst_seq);
+            if (verbose(ctx)) {
+              printf("[usbdpi] Iso stream #%u dropped %u packet(s)\n", s->id,
+                     seq - s->tst_seq);
+            }
+            s->stats.dropped += seq - s->tst_seq;
           }
           // Next sequence number expected
           s->tst_seq = seq + 1U;
@@ -410,7 +545,7 @@ bool stream_sig_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
 // Service streaming data (usbdev_stream_test)
 // TODO: this function should probably be split into multiple functions now...
 void streams_service(usbdpi_ctx_t *ctx) {
-  if (verbose) {
+  if (verbose(ctx)) {
     //    printf("[usbdpi] streams_service hostSt %u in %u out %u\n",
     //    ctx->hostSt,
     //           ctx->stream_in, ctx->stream_out);
@@ -429,10 +564,13 @@ void streams_service(usbdpi_ctx_t *ctx) {
       // Decide whether we have enough time within this frame to attempt
       // another transmission
       uint32_t next_frame = ctx->frame_start + FRAME_INTERVAL;
+      int id = -1;
       if ((next_frame - ctx->tick_bits) > min_time_left) {
-        unsigned id = out_stream_next(ctx);
+        id = out_stream_next(ctx);
+      }
+      if (id >= 0) {
         usbdpi_stream_t *s = &ctx->stream[id];
-        if (verbose) {
+        if (verbose(ctx)) {
           printf("[usbdpi] OUT considering #%u received %p send %u\n", id,
                  s->received, s->send ? 1 : 0);
         }
@@ -443,6 +581,7 @@ void streams_service(usbdpi_ctx_t *ctx) {
           // Start by trying to transmit a data packet that we've received, if
           // any
           if (s->received) {
+            s->out_frame = ctx->frame;
             if (ctx->sending) {
               transfer_release(ctx, ctx->sending);
               ctx->sending = NULL;
@@ -481,6 +620,10 @@ void streams_service(usbdpi_ctx_t *ctx) {
             transfer_release(ctx, tr);
           }
         }
+      } else if ((next_frame - ctx->tick_bits) > min_time_left &&
+                 in_stream_pending(ctx)) {
+        // Nothing to send in this frame, but there is still data to collect
+        ctx->hostSt = HS_STREAMIN;
       } else {
         // Wait until the next bus frame
         ctx->hostSt = HS_NEXTFRAME;
@@ -508,7 +651,7 @@ void streams_service(usbdpi_ctx_t *ctx) {
           // no break
         case USB_TRANSFER_TYPE_INTERRUPT:
           if (ctx->bus_state == (bulk ? kUsbBulkOutAck : kUsbInterruptOutAck)) {
-            if (verbose) {
+            if (verbose(ctx)) {
               printf("[usbdpi] OUT - response is PID 0x%02x from device (%s)\n",
                      ctx->lastrxpid, decode_pid(ctx->lastrxpid));
             }
@@ -516,6 +659,7 @@ void streams_service(usbdpi_ctx_t *ctx) {
             switch (ctx->lastrxpid) {
               case USB_PID_ACK: {
                 accepted = true;
+                s->out_nak = false;
               } break;
 
               // We may receive a NAK from the device if it is unable to receive
@@ -523,13 +667,17 @@ void streams_service(usbdpi_ctx_t *ctx) {
               case USB_PID_NAK:
                 // Rewind the LFSR in preparation for trying again
                 s->dpi_lfsr = s->dpi_rewind_lfsr;
+                s->out_nak = true;
+                s->stats.out_naks++;
                 // TODO: we should have counting code here to kill the test if
                 // transmission is rejected too many times; at present, however,
                 // we will try too rapidly and would give up too soon.
-                printf(
-                    "[usbdpi] frame 0x%x tick_bits 0x%x NAK received "
-                    "from device\n",
-                    ctx->frame, ctx->tick_bits);
+                if (verbose(ctx)) {
+                  printf(
+                      "[usbdpi] frame 0x%x tick_bits 0x%x NAK received "
+                      "from device\n",
+                      ctx->frame, ctx->tick_bits);
+                }
                 ctx->hostSt = HS_STREAMIN;
                 break;
 
@@ -562,6 +710,9 @@ void streams_service(usbdpi_ctx_t *ctx) {
         usbdpi_stream_t *s = &ctx->stream[ctx->stream_out];
         usbdpi_transfer_t *rx = s->received;
         assert(rx);
+        stream_data_accepted(ctx, s);
+        s->stats.out_pkts++;
+        s->stats.out_bytes += transfer_length(rx) - 3U;
         s->received = rx->next;
         transfer_release(ctx, rx);
         // No data toggling for Isochronous
@@ -586,14 +737,19 @@ void streams_service(usbdpi_ctx_t *ctx) {
       //        time interval, and then the bus transmission speed
       //        determines the maximum delay
       uint32_t next_frame = ctx->frame_start + FRAME_INTERVAL;
+      int id = -1;
       if ((next_frame - ctx->tick_bits) > min_time_left) {
-        unsigned id = in_stream_next(ctx);
+        id = in_stream_next(ctx);
+      }
+      if (id >= 0) {
         usbdpi_stream_t *s = &ctx->stream[id];
-        if (verbose) {
+        if (verbose(ctx)) {
           printf("[usbdpi] IN considering #%u retrieve %u\n", id,
                  s->retrieve ? 1 : 0);
         }
         if (s->retrieve) {
+          s->in_frame = ctx->frame;
+
           // Ensure that a buffer is available for constructing a transfer
           usbdpi_transfer_t *tr = ctx->sending;
           if (!tr) {
@@ -632,6 +788,10 @@ void streams_service(usbdpi_ctx_t *ctx) {
           }
           ctx->hostSt = HS_STREAMOUT;
         }
+      } else if ((next_frame - ctx->tick_bits) > min_time_left &&
+                 out_stream_pending(ctx)) {
+        // Nothing to collect in this frame, but there is still data to send
+        ctx->hostSt = HS_STREAMOUT;
       } else {
         // Wait until the next bus frame
         ctx->hostSt = HS_NEXTFRAME;
@@ -673,10 +833,13 @@ void streams_service(usbdpi_ctx_t *ctx) {
         switch (ctx->lastrxpid) {
           case USB_PID_DATA0:
           case USB_PID_DATA1: {
+            s->in_nak = false;
             // Steal the received packet; it belongs to the stream
             usbdpi_transfer_t *rx = ctx->recving;
             assert(rx);
             ctx->recving = NULL;
+            // Length of the data field, for the summary statistics
+            const unsigned rx_bytes = transfer_length(rx) - 3U;
 
             // Decide whether we want to ACK or NAK this packet
             bool accept;
@@ -714,9 +877,12 @@ void streams_service(usbdpi_ctx_t *ctx) {
               }
 
               if (!accept) {
-                printf("[usbdpi] Requesting resend of data\n");
+                if (verbose(ctx)) {
+                  printf("[usbdpi] Requesting resend of data\n");
+                }
                 usb_monitor_log(ctx->mon,
                                 "[usbdpi] Requesting resend of data\n");
+                s->stats.retries++;
               }
             }
 
@@ -747,6 +913,12 @@ void streams_service(usbdpi_ctx_t *ctx) {
                   accept = false;
                 }
               }
+
+              if (accept) {
+                stream_data_accepted(ctx, s);
+                s->stats.in_pkts++;
+                s->stats.in_bytes += rx_bytes;
+              }
             }
 
             // Not yet handled this packet?
@@ -789,7 +961,9 @@ void streams_service(usbdpi_ctx_t *ctx) {
               printf("[usbdpi] NAK response from Iso stream");
               ctx->hostSt = HS_ERROR;
             } else {
-              // No data available
+              // No data available; give the other streams a chance first
+              s->in_nak = true;
+              s->stats.in_naks++;
               ctx->hostSt = HS_STREAMOUT;
             }
             break;
@@ -818,3 +992,30 @@ void streams_service(usbdpi_ctx_t *ctx) {
       break;
   }
 }
+
+// Report the summary statistics and throughput of each stream
+void streams_report(const usbdpi_ctx_t *ctx) {
+  for (unsigned id = 0U; id < ctx->nstreams; id++) {
+    const usbdpi_stream_t *s = &ctx->stream[id];
+    // Throughput over the interval between the first and last data packets;
+    // a USB bit interval is 1/12us at Full Speed
+    uint32_t bits = s->stats.last_bits - s->stats.first_bits;
+    double in_kBps = 0.0, out_kBps = 0.0;
+    if (bits) {
+      in_kBps = (double)s->stats.in_bytes * 12000.0 / bits;
+      out_kBps = (double)s->stats.out_bytes * 12000.0 / bits;
+    }
+    printf(
+        "[usbdpi] %c%u: IN %u pkts %llu bytes (%u NAK %u retried %u dropped "
+        "%u mismatched) OUT %u pkts %llu bytes (%u NAK)\n",
+        xfr_sym[s->xfr_type], s->id, s->stats.in_pkts,
+        (unsigned long long)s->stats.in_bytes, s->stats.in_naks,
+        s->stats.retries, s->stats.dropped, s->stats.mismatches,
+        s->stats.out_pkts, (unsigned long long)s->stats.out_bytes,
+        s->stats.out_naks);
+    printf(
+        "[usbdpi] %c%u: tick_bits 0x%x to 0x%x, IN %.1f kB/s OUT %.1f kB/s\n",
+        xfr_sym[s->xfr_type], s->id, s->stats.first_bits, s->stats.last_bits,
+        in_kBps, out_kBps);
+  }
+}
@@ -83,6 +83,55 @@ typedef struct usbdpi_stream {
    * Linked-list of received transfers
    */
   usbdpi_transfer_t *received;
+  /**
+   * Bus frames in which the last IN and OUT transactions were scheduled; the
+   * periodic (Isochronous and Interrupt) streams get at most one of each per
+   * frame
+   */
+  uint16_t in_frame;
+  uint16_t out_frame;
+  /**
+   * The last IN/OUT transaction was NAKed by the device; other Bulk streams
+   * take priority until the device has had a chance to become ready
+   */
+  bool in_nak;
+  bool out_nak;
+  /**
+   * Summary statistics, reported at the end of the simulation
+   */
+  struct {
+    /**
+     * Data packets accepted from/by the device, and the bytes in their data
+     * fields, including any stream signatures
+     */
+    uint32_t in_pkts;
+    uint32_t out_pkts;
+    uint64_t in_bytes;
+    uint64_t out_bytes;
+    /**
+     * NAK handshakes received from the device
+     */
+    uint32_t in_naks;
+    uint32_t out_naks;
+    /**
+     * IN packets that we rejected to exercise retrying
+     */
+    uint32_t retries;
+    /**
+     * Isochronous IN packets that were dropped by the device
+     */
+    uint32_t dropped;
+    /**
+     * Received bytes that did not match the expected LFSR output
+     */
+    uint32_t mismatches;
+    /**
+     * Times (in USB bit intervals) of the first and last data packets that
+     * were accepted in either direction
+     */
+    uint32_t first_bits;
+    uint32_t last_bits;
+  } stats;
 } usbdpi_stream_t;
 
 /**
@@ -108,4 +157,11 @@ bool streams_init(usbdpi_ctx_t *ctx, unsigned nstreams,
  */
 void streams_service(usbdpi_ctx_t *ctx);
 
+/**
+ * Report the summary statistics and throughput of each stream
+ *
+ * @param  ctx       USBDPI context state
+ */
+void streams_report(const usbdpi_ctx_t *ctx);
+
 #endif  // OPENTITAN_HW_DV_DPI_USBDPI_USBDPI_STREAM_H_
@@ -7,9 +7,11 @@
 #include <cassert>
 #include <cstring>
 #include <fcntl.h>
+#include <fstream>
 #include <iostream>
 #include <libelf.h>
 #include <sstream>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <vector>
@@ -52,16 +54,30 @@ class ElfFile {
       throw ElfError(path, elf_errmsg(-1));
     }
 
-    if (elf_kind(ptr_) != ELF_K_ELF) {
-      elf_end(ptr_);
-      close(fd_);
-      throw ElfError(path, "not an ELF file.");
+    CheckKind();
+  }
+
+  // Parse an ELF file that has already been loaded (or mapped) into memory at
+  // image. The image must outlive this object.
+  ElfFile(const std::string &path, char *image, size_t size)
+      : path_(path), fd_(-1) {
+    (void)elf_errno();
+    if (elf_version(EV_CURRENT) == EV_NONE) {
+      throw std::runtime_error(elf_errmsg(-1));
+    }
+
+    ptr_ = elf_memory(image, size);
+    if (!ptr_) {
+      throw ElfError(path, elf_errmsg(-1));
     }
+
+    CheckKind();
   }
 
   ~ElfFile() {
     elf_end(ptr_);
-    close(fd_);
+    if (fd_ >= 0)
+      close(fd_);
   }
 
   size_t GetPhdrNum() {
@@ -82,9 +98,83 @@ class ElfFile {
   std::string path_;
   int fd_;
   Elf *ptr_;
+
+ private:
+  void CheckKind() {
+    if (elf_kind(ptr_) != ELF_K_ELF) {
+      elf_end(ptr_);
+      if (fd_ >= 0)
+        close(fd_);
+      throw ElfError(path_, "not an ELF file.");
+    }
+  }
 };
+
+// Header at the start of a memory snapshot file (see SaveMemSnapshot). The
+// version should be bumped whenever the layout changes.
+const char kSnapshotMagic[8] = {'O', 'T', 'M', 'E', 'M', 'S', 'N', 'P'};
+const uint32_t kSnapshotVersion = 1;
+
+void WriteU32(std::ostream &os, uint32_t value) {
+  os.write(reinterpret_cast<const char *>(&value), sizeof value);
+}
+
+uint32_t ReadU32(std::istream &is, const std::string &path) {
+  uint32_t value;
+  if (!is.read(reinterpret_cast<char *>(&value), sizeof value)) {
+    throw std::runtime_error("Truncated memory snapshot at `" + path + "'.");
+  }
+  return value;
+}
 }  // namespace
 
+// A private mapping of a whole file. The mapping is copy-on-write, so libelf
+// can safely use it in place, but nothing is ever written back to the file.
+class MappedFile {
+ public:
+  MappedFile(const std::string &path) : data_(nullptr), size_(0) {
+    int fd = open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      throw ElfError(path, "could not open file.");
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw ElfError(path, "could not stat file.");
+    }
+    size_ = st.st_size;
+
+    if (size_ > 0) {
+      void *ptr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                       0);
+      if (ptr == MAP_FAILED) {
+        close(fd);
+        throw ElfError(path, "could not map file.");
+      }
+      data_ = static_cast<char *>(ptr);
+    }
+
+    // The mapping stays valid after the file descriptor is closed
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_)
+      munmap(data_, size_);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  char *GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+
+ private:
+  char *data_;
+  size_t size_;
+};
+
 // Convert a string to a MemImageType, throwing a std::runtime_error
 // if it's not a known name.
 static MemImageType GetMemImageTypeByName(const std::string &name) {
@@ -289,6 +379,28 @@ void StagedMem::AddSegment(uint32_t offset, std::vector<uint8_t> &&seg) {
   segs_.Emplace(offset, seg_top, std::move(seg), MergeSegments);
 }
 
+void StagedMem::AddSegmentView(uint32_t offset, const uint8_t *data,
+                               size_t len) {
+  if (!len)
+    return;
+
+  uint32_t seg_top = offset + len - 1;
+  assert(seg_top >= offset);
+
+  // If the new view overlaps anything that's already staged, it needs merging
+  // (and later data has to win). Fall back to an owned copy in that case.
+  if (segs_.FindOverlap(offset, seg_top) ||
+      seg_views_.FindOverlap(offset, seg_top)) {
+    AddSegment(offset, std::vector<uint8_t>(data, data + len));
+    return;
+  }
+
+  min_addr_ = std::min(min_addr_, offset);
+  max_addr_ = std::max(max_addr_, seg_top);
+  SegView view = {.data = data, .len = len};
+  seg_views_.EmplaceDisjoint(offset, seg_top, std::move(view));
+}
+
 std::vector<uint8_t> StagedMem::GetFlat() const {
   // Since max_addr_ and min_addr_ are inclusive, the size to allocate
   // is 1+(max-min). We cast to size_t to make sure the +1 doesn't
@@ -296,6 +408,20 @@ std::vector<uint8_t> StagedMem::GetFlat() const {
   size_t len = (size_t)1 + (max_addr_ - min_addr_);
   std::vector<uint8_t> ret(len, 0);
 
+  // Views are never overlapped by later data (see AddSegmentView), so they
+  // can be written first.
+  for (const auto &pr : seg_views_) {
+    const AddrRange<uint32_t> &rng = pr.first;
+    const SegView &view = pr.second;
+    assert(view.len == 1 + (rng.hi - rng.lo));
+    assert(min_addr_ <= rng.lo);
+
+    uint32_t off = rng.lo - min_addr_;
+    assert(off + view.len <= ret.size());
+
+    memcpy(&ret[off], view.data, view.len);
+  }
+
   for (const auto &pr : segs_) {
     const AddrRange<uint32_t> &rng = pr.first;
     const std::vector<uint8_t> &seg = pr.second;
@@ -310,6 +436,10 @@ std::vector<uint8_t> StagedMem::GetFlat() const {
   return ret;
 }
 
+DpiMemUtil::DpiMemUtil() {}
+
+DpiMemUtil::~DpiMemUtil() {}
+
 void DpiMemUtil::RegisterMemoryArea(const std::string &name, uint32_t base,
                                     const MemArea *mem_area) {
   assert(mem_area);
@@ -347,6 +477,7 @@ void DpiMemUtil::RegisterMemoryArea(const std::string &name, uint32_t base,
         << " because its address range overlaps an existing area.";
     throw std::runtime_error(oss.str());
   }
+  frozen_addr_to_mem_ = FrozenRangedMap<uint32_t, size_t>(addr_to_mem_);
 
   mem_areas_.push_back(mem_area);
   base_addrs_.push_back(base);
@@ -372,6 +503,83 @@ void DpiMemUtil::PrintMemRegions() const {
   }
 }
 
+void DpiMemUtil::ListMemRegions(std::ostream &os) const {
+  for (const auto &pr : name_to_mem_) {
+    const MemArea &mem = *mem_areas_[pr.second];
+    os << pr.first << " 0x" << std::hex << base_addrs_[pr.second] << " 0x"
+       << mem.GetSizeBytes() << std::dec << "\n";
+  }
+}
+
+size_t DpiMemUtil::GetRegionForRange(uint32_t addr, uint32_t len) const {
+  assert(len > 0);
+
+  const size_t *mem_area_idx = frozen_addr_to_mem_.find(addr);
+  uint32_t top = addr + (len - 1);
+  if (!mem_area_idx || top < addr ||
+      top - base_addrs_[*mem_area_idx] >=
+          mem_areas_[*mem_area_idx]->GetSizeBytes()) {
+    std::ostringstream oss;
+    oss << "No memory region is registered that contains the 0x" << std::hex
+        << len << " bytes at address 0x" << addr << ".";
+    throw std::runtime_error(oss.str());
+  }
+  return *mem_area_idx;
+}
+
+std::vector<uint8_t> DpiMemUtil::ReadAddr(uint32_t addr, uint32_t len) const {
+  if (len == 0) {
+    return {};
+  }
+
+  size_t mem_area_idx = GetRegionForRange(addr, len);
+  const MemArea &mem_area = *mem_areas_[mem_area_idx];
+  uint32_t width = mem_area.GetWidthByte();
+  uint32_t offset = addr - base_addrs_[mem_area_idx];
+  uint32_t first_word = offset / width;
+  uint32_t last_word = (offset + len - 1) / width;
+
+  std::vector<uint8_t> words =
+      mem_area.Read(first_word, last_word - first_word + 1);
+  auto start = words.begin() + offset % width;
+  return std::vector<uint8_t>(start, start + len);
+}
+
+void DpiMemUtil::WriteAddr(uint32_t addr, const uint8_t *data,
+                           uint32_t len) const {
+  if (len == 0) {
+    return;
+  }
+
+  size_t mem_area_idx = GetRegionForRange(addr, len);
+  const MemArea &mem_area = *mem_areas_[mem_area_idx];
+  uint32_t width = mem_area.GetWidthByte();
+  uint32_t offset = addr - base_addrs_[mem_area_idx];
+  uint32_t first_word = offset / width;
+  uint32_t last_word = (offset + len - 1) / width;
+  uint32_t head = offset % width;
+  uint32_t tail = (offset + len) % width;
+
+  if (head == 0 && tail == 0) {
+    mem_area.Write(first_word, data, len);
+    return;
+  }
+
+  // Read the words at either end that are only partly overwritten and merge
+  // the new data into them.
+  std::vector<uint8_t> words((last_word - first_word + 1) * width);
+  if (head) {
+    std::vector<uint8_t> word = mem_area.Read(first_word, 1);
+    memcpy(words.data(), word.data(), width);
+  }
+  if (tail) {
+    std::vector<uint8_t> word = mem_area.Read(last_word, 1);
+    memcpy(&words[words.size() - width], word.data(), width);
+  }
+  memcpy(&words[head], data, len);
+  mem_area.Write(first_word, words);
+}
+
 void DpiMemUtil::LoadFileToNamedMem(bool verbose, const std::string &name,
                                     const std::string &filepath,
                                     MemImageType type) {
@@ -417,9 +625,10 @@ void DpiMemUtil::LoadFileToNamedMem(bool verbose, const std::string &name,
   }
 }
 
-void DpiMemUtil::LoadElfToMemories(bool verbose, const std::string &filepath) {
+void DpiMemUtil::LoadElfToMemories(bool verbose, const std::string &filepath,
+                                   bool map_file) {
   // Load the contents of the ELF file into the staging area
-  StageElf(verbose, filepath);
+  StageElf(verbose, filepath, map_file);
 
   for (const auto &pr : staging_area_) {
     const std::string &mem_name = pr.first;
@@ -429,33 +638,59 @@ void DpiMemUtil::LoadElfToMemories(bool verbose, const std::string &filepath) {
     assert(mem_area_it != name_to_mem_.end());
 
     const MemArea &mem_area = *mem_areas_[mem_area_it->second];
+    uint32_t base_addr = base_addrs_[mem_area_it->second];
+
+    // Write any views first: they are never overlapped by owned segments that
+    // were staged before them (see StagedMem::AddSegmentView).
+    for (const auto &seg_pr : staged_mem.GetSegViews()) {
+      const StagedMem::SegView &view = seg_pr.second;
+      WriteSegment(mem_area, mem_name, base_addr, seg_pr.first.lo, view.data,
+                   view.len);
+    }
 
     for (const auto &seg_pr : staged_mem.GetSegs()) {
-      const AddrRange<uint32_t> &seg_rng = seg_pr.first;
       const std::vector<uint8_t> &seg_data = seg_pr.second;
-
-      assert(seg_rng.lo % mem_area.GetWidthByte() == 0);
-      uint32_t lo_word = seg_rng.lo / mem_area.GetWidthByte();
-
-      try {
-        mem_area.Write(lo_word, seg_data);
-      } catch (const SVScoped::Error &err) {
-        std::ostringstream oss;
-        oss << "No memory found at `" << err.scope_name_
-            << "' (the scope associated with region `" << mem_name
-            << "', used by a segment that starts at LMA 0x" << std::hex
-            << base_addrs_[mem_area_it->second] + seg_rng.lo << ").";
-        throw std::runtime_error(oss.str());
-      }
+      WriteSegment(mem_area, mem_name, base_addr, seg_pr.first.lo,
+                   seg_data.data(), seg_data.size());
     }
   }
 }
 
-void DpiMemUtil::StageElf(bool verbose, const std::string &path) {
-  // Clear out anything that was in the staging area before
-  staging_area_.clear();
+void DpiMemUtil::WriteSegment(const MemArea &mem_area,
+                              const std::string &mem_name, uint32_t base_addr,
+                              uint32_t offset, const uint8_t *data,
+                              size_t len) const {
+  assert(offset % mem_area.GetWidthByte() == 0);
+  uint32_t lo_word = offset / mem_area.GetWidthByte();
 
-  ElfFile elf(path);
+  try {
+    mem_area.Write(lo_word, data, len);
+  } catch (const SVScoped::Error &err) {
+    std::ostringstream oss;
+    oss << "No memory found at `" << err.scope_name_
+        << "' (the scope associated with region `" << mem_name
+        << "', used by a segment that starts at LMA 0x" << std::hex
+        << base_addr + offset << ").";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+void DpiMemUtil::StageElf(bool verbose, const std::string &path,
+                          bool map_file) {
+  // Clear out anything that was in the staging area before, together with any
+  // mapping that it pointed into.
+  staging_area_.clear();
+  mapped_file_.reset();
+
+  std::unique_ptr<ElfFile> elf_ptr;
+  if (map_file) {
+    mapped_file_.reset(new MappedFile(path));
+    elf_ptr.reset(new ElfFile(path, mapped_file_->GetData(),
+                              mapped_file_->GetSize()));
+  } else {
+    elf_ptr.reset(new ElfFile(path));
+  }
+  ElfFile &elf = *elf_ptr;
 
   // Allow subclasses to get at the loaded ELF data if they need it
   OnElfLoaded(elf.ptr_);
@@ -517,6 +752,14 @@ void DpiMemUtil::StageElf(bool verbose, const std::string &path) {
     StagedMem &staged_mem = staging_area_[name];
 
     const char *seg_data = file_data + phdr.p_offset;
+    if (map_file) {
+      // file_data points into mapped_file_, which outlives the staging area
+      staged_mem.AddSegmentView(local_base,
+                                reinterpret_cast<const uint8_t *>(seg_data),
+                                phdr.p_filesz);
+      continue;
+    }
+
     std::vector<uint8_t> vec(phdr.p_filesz, 0);
     memcpy(&vec[0], seg_data, phdr.p_filesz);
 
@@ -524,6 +767,101 @@ void DpiMemUtil::StageElf(bool verbose, const std::string &path) {
   }
 }
 
+void DpiMemUtil::SaveMemSnapshot(const std::string &path) const {
+  std::ofstream os(path, std::ios::binary | std::ios::trunc);
+  if (!os) {
+    throw std::runtime_error("Could not open `" + path + "' for writing.");
+  }
+
+  os.write(kSnapshotMagic, sizeof kSnapshotMagic);
+  WriteU32(os, kSnapshotVersion);
+  WriteU32(os, name_to_mem_.size());
+
+  for (const auto &pr : name_to_mem_) {
+    const MemArea &mem_area = *mem_areas_[pr.second];
+    std::vector<uint8_t> data;
+    try {
+      data = mem_area.ReadPhys();
+    } catch (const SVScoped::Error &err) {
+      std::ostringstream oss;
+      oss << "No memory found at `" << err.scope_name_
+          << "' (the scope associated with region `" << pr.first << "').";
+      throw std::runtime_error(oss.str());
+    }
+
+    WriteU32(os, pr.first.size());
+    os.write(pr.first.data(), pr.first.size());
+    WriteU32(os, mem_area.GetSizeWords());
+    WriteU32(os, mem_area.GetPhysWidthByte());
+    os.write(reinterpret_cast<const char *>(data.data()), data.size());
+  }
+
+  if (!os.flush()) {
+    throw std::runtime_error("Failed to write memory snapshot to `" + path +
+                             "'.");
+  }
+}
+
+void DpiMemUtil::RestoreMemSnapshot(const std::string &path) const {
+  std::ifstream is(path, std::ios::binary);
+  if (!is) {
+    throw std::runtime_error("Could not open memory snapshot at `" + path +
+                             "'.");
+  }
+
+  char magic[sizeof kSnapshotMagic];
+  if (!is.read(magic, sizeof magic) ||
+      memcmp(magic, kSnapshotMagic, sizeof magic) != 0 ||
+      ReadU32(is, path) != kSnapshotVersion) {
+    throw std::runtime_error("`" + path +
+                             "' is not a memory snapshot in a format that we "
+                             "understand.");
+  }
+
+  uint32_t num_mems = ReadU32(is, path);
+  for (uint32_t i = 0; i < num_mems; ++i) {
+    std::string name(ReadU32(is, path), '\0');
+    if (!is.read(&name[0], name.size())) {
+      throw std::runtime_error("Truncated memory snapshot at `" + path + "'.");
+    }
+    uint32_t num_words = ReadU32(is, path);
+    uint32_t phys_width_byte = ReadU32(is, path);
+
+    auto it = name_to_mem_.find(name);
+    if (it == name_to_mem_.end()) {
+      std::ostringstream oss;
+      oss << "Memory snapshot at `" << path << "' contains data for `" << name
+          << "', which is not the name of a known memory region.";
+      throw std::runtime_error(oss.str());
+    }
+
+    const MemArea &mem_area = *mem_areas_[it->second];
+    if (num_words != mem_area.GetSizeWords() ||
+        phys_width_byte != mem_area.GetPhysWidthByte()) {
+      std::ostringstream oss;
+      oss << "Memory snapshot at `" << path << "' has " << num_words
+          << " words of " << phys_width_byte << " bytes for `" << name
+          << "', but the memory has " << mem_area.GetSizeWords()
+          << " words of " << mem_area.GetPhysWidthByte() << " bytes.";
+      throw std::runtime_error(oss.str());
+    }
+
+    std::vector<uint8_t> data((size_t)num_words * phys_width_byte);
+    if (!is.read(reinterpret_cast<char *>(data.data()), data.size())) {
+      throw std::runtime_error("Truncated memory snapshot at `" + path + "'.");
+    }
+
+    try {
+      mem_area.WritePhys(0, data);
+    } catch (const SVScoped::Error &err) {
+      std::ostringstream oss;
+      oss << "No memory found at `" << err.scope_name_
+          << "' (the scope associated with region `" << name << "').";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
 const StagedMem &DpiMemUtil::GetMemoryData(const std::string &mem_name) const {
   auto it = staging_area_.find(mem_name);
   return (it == staging_area_.end()) ? empty_ : it->second;
@@ -533,15 +871,15 @@ size_t DpiMemUtil::GetRegionForSegment(const std::string &path, int seg_idx,
                                        uint32_t lma, uint32_t mem_sz) const {
   assert(mem_sz > 0);
 
-  auto mem_area_it = addr_to_mem_.find(lma);
-  if (mem_area_it == addr_to_mem_.end()) {
+  const size_t *mem_area_idx_ptr = frozen_addr_to_mem_.find(lma);
+  if (!mem_area_idx_ptr) {
     std::ostringstream oss;
     oss << "No memory region is registered that contains the address 0x"
         << std::hex << lma << " (the base address of segment " << seg_idx
         << ").";
     throw ElfError(path, oss.str());
   }
-  size_t mem_area_idx = mem_area_it->second;
+  size_t mem_area_idx = *mem_area_idx_ptr;
 
   const MemArea &mem_area = *mem_areas_[mem_area_idx];
   uint32_t base_addr = base_addrs_[mem_area_idx];
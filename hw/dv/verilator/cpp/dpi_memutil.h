@@ -6,6 +6,7 @@
 
 #include <map>
 #include <memory>
+#include <ostream>
 #include <string>
 #include <svdpi.h>
 #include <vector>
@@ -27,6 +28,14 @@ enum MemImageType {
 // This is represented as an ordered list of disjoint segments (as loaded from
 // an ELF file).
 //
+// Segments are either owned by the StagedMem (added with AddSegment) or are
+// views of data that is owned by something else, such as a memory-mapped ELF
+// file (added with AddSegmentView). A view never overlaps a segment that was
+// added after it: if a new view would overlap an existing segment, its data is
+// copied and it is stored as an owned segment instead. This means writing all
+// the views and then all the owned segments gives the same result as writing
+// the segments in the order they were added.
+//
 // Once it is nonempty, the class maintains the invariant that min_addr_ /
 // max_addr_ is the smallest / largest byte offset with valid data.
 class StagedMem {
@@ -36,33 +45,50 @@ class StagedMem {
   // Add a segment to the tracked memory
   void AddSegment(uint32_t offset, std::vector<uint8_t> &&seg);
 
+  // Add a view of len bytes at data to the tracked memory. The data must stay
+  // valid for as long as the StagedMem is in use.
+  void AddSegmentView(uint32_t offset, const uint8_t *data, size_t len);
+
   // Glob together the tracked segments, interspersing them with
   // zeros, and return as a single flat array.
   std::vector<uint8_t> GetFlat() const;
 
+  struct SegView {
+    const uint8_t *data;
+    size_t len;
+  };
+
   typedef RangedMap<uint32_t, std::vector<uint8_t>> SegMap;
+  typedef RangedMap<uint32_t, SegView> SegViewMap;
 
   std::pair<uint32_t, uint32_t> GetBounds() const {
     return std::make_pair(min_addr_, max_addr_);
   }
   const SegMap &GetSegs() const { return segs_; }
+  const SegViewMap &GetSegViews() const { return seg_views_; }
 
  private:
   uint32_t min_addr_, max_addr_;
   SegMap segs_;
+  SegViewMap seg_views_;
 };
 
+// A read-only, private memory mapping of a file. This is defined in
+// dpi_memutil.cc.
+class MappedFile;
+
 /**
  * Provide various memory loading utilities for verilog simulations
  *
  * These utilities require the corresponding DPI functions:
- * simutil_memload()
  * simutil_set_mem()
+ * simutil_get_mem()
  * to be defined somewhere as SystemVerilog functions.
  */
 class DpiMemUtil {
  public:
-  virtual ~DpiMemUtil() {}
+  DpiMemUtil();
+  virtual ~DpiMemUtil();
 
   /**
    * Register a memory as instantiated by generic ram
@@ -105,6 +131,32 @@ class DpiMemUtil {
    */
   void PrintMemRegions() const;
 
+  /**
+   * Write a list of all registered memory regions to |os|, one per line in
+   * the form "<name> <base> <size in bytes>" (with hex addresses)
+   */
+  void ListMemRegions(std::ostream &os) const;
+
+  /**
+   * Read |len| bytes of memory, starting at the address |addr|
+   *
+   * The addresses are LMAs, as for RegisterMemoryArea(). The range must lie
+   * within a single registered memory, but needn't be aligned to its words.
+   * Reads go through MemArea::Read, so scrambling and integrity bits are
+   * handled by the memory. If no memory contains the range, raises a
+   * std::runtime_error. Scope errors are raised as by MemArea::Read.
+   */
+  std::vector<uint8_t> ReadAddr(uint32_t addr, uint32_t len) const;
+
+  /**
+   * Write |len| bytes from |data| to memory, starting at the address |addr|
+   *
+   * The equivalent of ReadAddr() for writes. If the range doesn't start or
+   * finish on a word boundary, the partial words at the ends are read first
+   * and merged with the new data.
+   */
+  void WriteAddr(uint32_t addr, const uint8_t *data, uint32_t len) const;
+
   /**
    * Load the file at filepath into the named memory. If type is
    * kMemImageUnknown, the file type is determined from the path.
@@ -115,18 +167,48 @@ class DpiMemUtil {
   /**
    * Load an ELF file, placing segments in memories by LMA.
    *
-   * Replaces any data currently in the staging area.
+   * Replaces any data currently in the staging area. If |map_file| is true,
+   * the file is staged with a memory mapping (see StageElf) and each segment
+   * is written straight from the mapping.
    */
-  void LoadElfToMemories(bool verbose, const std::string &filepath);
+  void LoadElfToMemories(bool verbose, const std::string &filepath,
+                         bool map_file = false);
 
   /**
    * Load an ELF file into a staging area in this object, which can then be
    * accessed with GetMemoryData().
    *
+   * By default, the data for each segment is copied into the staging area (as
+   * seen by StagedMem::GetSegs()). If |map_file| is true, the file is mapped
+   * into memory instead and segments are staged as views into the mapping
+   * where possible (see StagedMem::GetSegViews()). The mapping stays valid
+   * until the next call to StageElf. Callers that want to modify staged data
+   * should use the default, owning, mode.
+   *
    * If the load fails, raises a std::exception with information about what
    * happened.
    */
-  void StageElf(bool verbose, const std::string &path);
+  void StageElf(bool verbose, const std::string &path, bool map_file = false);
+
+  /**
+   * Save the raw contents of every registered memory to the file at |path|.
+   *
+   * The snapshot holds the physical bits of each memory (after scrambling and
+   * integrity bits have been applied), so restoring it with
+   * RestoreMemSnapshot() doesn't need to repeat any of that work. On failure,
+   * raises a std::exception with information about what happened.
+   */
+  void SaveMemSnapshot(const std::string &path) const;
+
+  /**
+   * Restore memory contents from a snapshot written by SaveMemSnapshot().
+   *
+   * Every memory in the snapshot must be registered with the same name and
+   * geometry, but registered memories that aren't in the snapshot are left
+   * unchanged. On failure, raises a std::exception with information about
+   * what happened.
+   */
+  void RestoreMemSnapshot(const std::string &path) const;
 
   /**
    * Get the contents of the staging area by memory name
@@ -151,6 +233,8 @@ class DpiMemUtil {
 
   std::map<std::string, size_t> name_to_mem_;
   RangedMap<uint32_t, size_t> addr_to_mem_;
+  // A copy of addr_to_mem_ for lookups, rebuilt when a memory is registered
+  FrozenRangedMap<uint32_t, size_t> frozen_addr_to_mem_;
 
   // Staging area, loaded by StageElf. The map is keyed by names of memories
   // stored in name_to_mem_. We also ensure that every segment in a StagedMem
@@ -159,6 +243,24 @@ class DpiMemUtil {
   std::map<std::string, StagedMem> staging_area_;
   const StagedMem empty_;
 
+  // The mapping of the file most recently staged with map_file set. Views in
+  // staging_area_ point into this.
+  std::unique_ptr<MappedFile> mapped_file_;
+
+  /**
+   * Write len bytes at data to the given offset in mem_area. Converts scope
+   * errors into a std::runtime_error that describes the segment.
+   */
+  void WriteSegment(const MemArea &mem_area, const std::string &mem_name,
+                    uint32_t base_addr, uint32_t offset, const uint8_t *data,
+                    size_t len) const;
+
+  /**
+   * Find the index of the memory area containing the |len| bytes at |addr|
+   * (with |len| > 0). Raises a std::runtime_error if there is none.
+   */
+  size_t GetRegionForRange(uint32_t addr, uint32_t len) const;
+
   /**
    * Find the index of a memory area containing the given segment's addresses.
    * Raises a std::exception if none is found.
@@ -4,11 +4,13 @@
 
 #include "ecc32_mem_area.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <stdexcept>
 
 #include "secded_enc.h"
+#include "vmem_parser.h"
 
 Ecc32MemArea::Ecc32MemArea(const std::string &scope, uint32_t size,
                            uint32_t width_32)
@@ -25,29 +27,64 @@ Ecc32MemArea::Ecc32MemArea(const std::string &scope, uint32_t size,
   assert(phy_width_bits <= SV_MEM_WIDTH_BITS);
 }
 
+uint32_t Ecc32MemArea::GetPhysWidthByte() const {
+  return (39 * (width_byte_ / 4) + 7) / 8;
+}
+
 void Ecc32MemArea::LoadVmem(const std::string &path) const {
-  throw std::runtime_error(
-      "vmem files are not supported for memories with ECC bits");
+  uint32_t phys_width_byte = GetPhysWidthByte();
+  VmemImage image = ParseVmemFile(path, phys_width_byte);
+  CheckVmemFits(path, image, num_words_);
+
+  // A vmem file for this memory either contains just the logical data, or it
+  // contains complete physical words (including integrity bits and, for
+  // subclasses that scramble, already scrambled). We can tell the two apart by
+  // looking for words that are wider than the logical data.
+  bool has_integrity = 4 * image.max_word_digits > 8 * width_byte_;
+
+  for (const VmemSegment &seg : image.segments) {
+    if (has_integrity) {
+      WritePhys(seg.word_offset, seg.data);
+      continue;
+    }
+
+    // The words were parsed with a stride of phys_width_byte, but every value
+    // fits in width_byte_ bytes. Repack them and write them through Write,
+    // which adds integrity bits (and scrambles, if necessary).
+    size_t num_words = seg.data.size() / phys_width_byte;
+    std::vector<uint8_t> logical(num_words * width_byte_);
+    for (size_t i = 0; i < num_words; ++i) {
+      memcpy(&logical[i * width_byte_], &seg.data[i * phys_width_byte],
+             width_byte_);
+    }
+    Write(seg.word_offset, logical);
+  }
 }
 
 Ecc32MemArea::EccWords Ecc32MemArea::ReadWithIntegrity(
     uint32_t word_offset, uint32_t num_words) const {
   assert(word_offset + num_words <= num_words_);
 
-  // See MemArea::Write for an explanation for this buffer.
-  uint8_t minibuf[SV_MEM_WIDTH_BYTES];
-  memset(minibuf, 0, sizeof minibuf);
-  assert(width_byte_ <= sizeof minibuf);
+  // See MemArea::Write for an explanation for the slots in this block.
+  assert(width_byte_ <= SV_MEM_WIDTH_BYTES);
+  MemAreaBlock block(std::min(num_words, MemAreaBlock::kMaxWords));
 
   EccWords ret;
-  ret.reserve(num_words);
+  ret.reserve(num_words * (width_byte_ / 4));
 
-  for (uint32_t i = 0; i < num_words; ++i) {
-    uint32_t src_word = word_offset + i;
-    uint32_t phys_addr = ToPhysAddr(src_word);
+  if (num_words) {
+    PrepareAccess(word_offset, num_words);
+  }
 
-    ReadToMinibuf(minibuf, phys_addr);
-    ReadBufferWithIntegrity(ret, minibuf, src_word);
+  for (uint32_t i = 0; i < num_words; i += MemAreaBlock::kMaxWords) {
+    uint32_t count = std::min(num_words - i, MemAreaBlock::kMaxWords);
+    for (uint32_t j = 0; j < count; ++j) {
+      block.PhysAddr(j) = ToPhysAddr(word_offset + i + j);
+    }
+    ReadToBlock(block.Slots(), block.PhysAddrs(), count);
+    for (uint32_t j = 0; j < count; ++j) {
+      ReadBufferWithIntegrity(ret, block.Slot(j), word_offset + i + j);
+    }
   }
 
   return ret;
@@ -55,143 +92,175 @@ Ecc32MemArea::EccWords Ecc32MemArea::ReadWithIntegrity(
 
 void Ecc32MemArea::WriteWithIntegrity(uint32_t word_offset,
                                       const EccWords &data) const {
-  // See MemArea::Write for an explanation for this buffer.
-  uint8_t minibuf[SV_MEM_WIDTH_BYTES];
-  memset(minibuf, 0, sizeof minibuf);
-  assert(width_byte_ <= sizeof minibuf);
-
   uint32_t width_32 = width_byte_ / 4;
   uint32_t to_write = data.size() / width_32;
 
   assert((data.size() % width_32) == 0);
   assert(word_offset + to_write <= num_words_);
 
-  for (uint32_t i = 0; i < to_write; ++i) {
-    uint32_t dst_word = word_offset + i;
-    uint32_t phys_addr = ToPhysAddr(dst_word);
+  // See MemArea::Write for an explanation for the slots in this block.
+  assert(width_byte_ <= SV_MEM_WIDTH_BYTES);
+  MemAreaBlock block(std::min(to_write, MemAreaBlock::kMaxWords));
 
-    WriteBufferWithIntegrity(minibuf, data, i * width_32, dst_word);
-    WriteFromMinibuf(phys_addr, minibuf, dst_word);
+  if (to_write) {
+    PrepareAccess(word_offset, to_write);
   }
-}
 
-// Zero enough of the buffer to fill it with a word using insert_bits
-static void zero_buffer(uint8_t buf[SV_MEM_WIDTH_BYTES], uint32_t width_byte) {
-  // The insert_bits routine assumes that the buffer will have been zeroed, so
-  // do that here. Note that this buffer has (width_byte / 4) words, each of
-  // which is 39 bits long. Divide this by 8, rounding up.
-  size_t phys_size_bytes = (39 * (width_byte / 4) + 7) / 8;
-  memset(buf, 0, phys_size_bytes);
+  for (uint32_t i = 0; i < to_write; i += MemAreaBlock::kMaxWords) {
+    uint32_t count = std::min(to_write - i, MemAreaBlock::kMaxWords);
+    for (uint32_t j = 0; j < count; ++j) {
+      uint32_t dst_word = word_offset + i + j;
+      block.PhysAddr(j) = ToPhysAddr(dst_word);
+      WriteBufferWithIntegrity(block.Slot(j), data, (i + j) * width_32,
+                               dst_word);
+    }
+    WriteFromBlock(block.PhysAddrs(), block.Slots(), count, word_offset + i);
+  }
 }
 
-// Add bits to buf at bit_idx
-//
-// buf is assumed to be little-endian, so bit_idx 0 will refer to the bottom
-// bit of buf[0] and bit_idx 15 will refer to the top bit of buf[1].
-//
-// This takes the bottom count bits from new_bits (where count <= 8). It
-// assumes that the relevant place in buf is zeroed (simplifying the
-// read-modify-write cycle).
-static void insert_bits(uint8_t *buf, unsigned bit_idx, uint8_t new_bits,
-                        unsigned count) {
-  assert(count <= 8);
-
-  buf += bit_idx / 8;
-  bit_idx = bit_idx % 8;
-
-  while (count) {
-    unsigned space_avail = 8 - bit_idx;
-    unsigned to_take = std::min(space_avail, count);
-
-    uint8_t masked = ((1 << to_take) - 1) & new_bits;
-    uint8_t shifted = masked << bit_idx;
-
-    *buf |= shifted;
-
-    ++buf;
-    bit_idx = 0;
-    count -= to_take;
-    new_bits >>= to_take;
+namespace {
+
+// The most 39-bit codewords in a physical memory word
+const uint32_t kMaxWords32 = SV_MEM_WIDTH_BITS / 39;
+
+// Lookup tables for enc_secded_inv_39_32. Each check bit is the parity of some
+// of the data bits, possibly inverted, so the check bits of a word are those
+// of the zero word XOR'd with the contributions of each of its bytes.
+struct Secded39Tables {
+  uint8_t zero;
+  uint8_t bytes[4][256];
+
+  Secded39Tables() {
+    const uint8_t zero_data[4] = {0};
+    zero = enc_secded_inv_39_32(zero_data);
+    for (int i = 0; i < 4; ++i) {
+      for (int b = 0; b < 256; ++b) {
+        uint8_t data[4] = {0};
+        data[i] = b;
+        bytes[i][b] = enc_secded_inv_39_32(data) ^ zero;
+      }
+    }
   }
+};
+
+const Secded39Tables &GetSecded39Tables() {
+  static const Secded39Tables tables;
+  return tables;
 }
 
-// Add 4 bytes to buf from bytes at bit_idx, plus check bits
-static void insert_word(uint8_t *buf, unsigned bit_idx, const uint8_t *bytes,
-                        uint8_t check_bits) {
-  assert((check_bits >> 7) == 0);
-  for (int i = 0; i < 4; ++i) {
-    insert_bits(buf, bit_idx + 8 * i, bytes[i], 8);
+}  // namespace
+
+void Ecc32MemArea::EncodeWords(const uint32_t *words, size_t num_words,
+                               uint8_t *check_bits) {
+  const Secded39Tables &tables = GetSecded39Tables();
+  for (size_t i = 0; i < num_words; ++i) {
+    uint32_t w = words[i];
+    check_bits[i] = tables.zero ^ tables.bytes[0][w & 0xff] ^
+                    tables.bytes[1][(w >> 8) & 0xff] ^
+                    tables.bytes[2][(w >> 16) & 0xff] ^
+                    tables.bytes[3][w >> 24];
   }
-  insert_bits(buf, bit_idx + 8 * 4, check_bits, 7);
 }
 
-// Extract bits from buf at bit_idx
-static uint8_t extract_bits(const uint8_t *buf, unsigned bit_idx,
-                            unsigned count) {
-  assert(count <= 8);
-
-  uint8_t ret = 0;
-  unsigned out_idx = 0;
-
-  buf += bit_idx / 8;
-  bit_idx = bit_idx % 8;
-
-  while (count) {
-    unsigned bits_avail = 8 - bit_idx;
-    unsigned to_take = std::min(bits_avail, count);
-
-    uint8_t shifted = *buf >> bit_idx;
-    uint8_t masked = shifted & ((1 << to_take) - 1);
-
-    ret |= masked << out_idx;
-
-    ++buf;
-    bit_idx = 0;
-    count -= to_take;
-    out_idx += to_take;
+void Ecc32MemArea::PackWords(uint8_t *buf, const uint32_t *words,
+                             const uint8_t *check_bits, size_t num_words) {
+  // Bits collect at the bottom of acc and are written out a byte at a time.
+  // There are fewer than 8 pending bits before each codeword is added, so
+  // there are never more than 46.
+  uint64_t acc = 0;
+  unsigned acc_bits = 0;
+  for (size_t i = 0; i < num_words; ++i) {
+    assert((check_bits[i] >> 7) == 0);
+    uint64_t codeword = words[i] | (uint64_t)check_bits[i] << 32;
+    acc |= codeword << acc_bits;
+    acc_bits += 39;
+    while (acc_bits >= 8) {
+      *buf++ = acc & 0xff;
+      acc >>= 8;
+      acc_bits -= 8;
+    }
   }
+  if (acc_bits) {
+    *buf = acc & 0xff;
+  }
+}
 
-  return ret;
+void Ecc32MemArea::UnpackWords(const uint8_t *buf, size_t num_words,
+                               uint32_t *words, uint8_t *check_bits) {
+  const uint8_t *end = buf + (39 * num_words + 7) / 8;
+  uint64_t acc = 0;
+  unsigned acc_bits = 0;
+  for (size_t i = 0; i < num_words; ++i) {
+    while (acc_bits < 39 && buf < end) {
+      acc |= (uint64_t)*buf++ << acc_bits;
+      acc_bits += 8;
+    }
+    words[i] = acc & 0xffffffff;
+    check_bits[i] = (acc >> 32) & 0x7f;
+    acc >>= 39;
+    acc_bits -= 39;
+  }
 }
 
 void Ecc32MemArea::WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
-                               const std::vector<uint8_t> &data,
+                               const uint8_t *data, size_t data_len,
                                size_t start_idx, uint32_t dst_word) const {
-  zero_buffer(buf, width_byte_);
-  for (uint32_t i = 0; i < width_byte_ / 4; ++i) {
-    const uint8_t *src_data = &data[start_idx + 4 * i];
-    insert_word(buf, 39 * i, src_data, enc_secded_inv_39_32(src_data));
+  uint32_t width_32 = width_byte_ / 4;
+  assert(width_32 <= kMaxWords32);
+
+  uint32_t words[kMaxWords32] = {0};
+  uint8_t check_bits[kMaxWords32];
+  for (uint32_t i = 0; i < width_32; ++i) {
+    size_t idx = start_idx + 4 * i;
+
+    // If there's a ragged end, zero-extend the last 32-bit word rather than
+    // reading past the end of the data.
+    uint32_t w = 0;
+    for (size_t j = 0; j < 4 && idx + j < data_len; ++j) {
+      w |= (uint32_t)data[idx + j] << 8 * j;
+    }
+    words[i] = w;
   }
+
+  EncodeWords(words, width_32, check_bits);
+  PackWords(buf, words, check_bits, width_32);
 }
 
 void Ecc32MemArea::WriteBufferWithIntegrity(uint8_t buf[SV_MEM_WIDTH_BYTES],
                                             const EccWords &data,
                                             size_t start_idx,
                                             uint32_t dst_word) const {
-  uint8_t src_data[4];
-
-  zero_buffer(buf, width_byte_);
-  for (uint32_t i = 0; i < width_byte_ / 4; ++i) {
-    const EccWord &word = data[start_idx + i];
-    for (uint32_t j = 0; j < 4; ++j) {
-      src_data[j] = (word.second >> 8 * j) & 0xff;
-    }
-    uint8_t check_bits = enc_secded_inv_39_32(src_data);
+  uint32_t width_32 = width_byte_ / 4;
+  assert(width_32 <= kMaxWords32);
 
-    // Invert (and thus corrupt) check bits if needed
-    if (!word.first)
-      check_bits ^= 0x7f;
+  uint32_t words[kMaxWords32] = {0};
+  uint8_t check_bits[kMaxWords32];
+  for (uint32_t i = 0; i < width_32; ++i) {
+    words[i] = data[start_idx + i].second;
+  }
+  EncodeWords(words, width_32, check_bits);
 
-    insert_word(buf, 39 * i, src_data, check_bits);
+  // Invert (and thus corrupt) check bits if needed
+  for (uint32_t i = 0; i < width_32; ++i) {
+    if (!data[start_idx + i].first)
+      check_bits[i] ^= 0x7f;
   }
+
+  PackWords(buf, words, check_bits, width_32);
 }
 
 void Ecc32MemArea::ReadBuffer(std::vector<uint8_t> &data,
                               const uint8_t buf[SV_MEM_WIDTH_BYTES],
                               uint32_t src_word) const {
-  for (uint32_t i = 0; i < width_byte_ / 4; ++i) {
+  uint32_t width_32 = width_byte_ / 4;
+  assert(width_32 <= kMaxWords32);
+
+  uint32_t words[kMaxWords32] = {0};
+  uint8_t check_bits[kMaxWords32];
+  UnpackWords(buf, width_32, words, check_bits);
+  for (uint32_t i = 0; i < width_32; ++i) {
     for (uint32_t j = 0; j < 4; ++j) {
-      data.push_back(extract_bits(buf, 39 * i + 8 * j, 8));
+      data.push_back((words[i] >> 8 * j) & 0xff);
     }
   }
 }
@@ -199,19 +268,15 @@ void Ecc32MemArea::ReadBuffer(std::vector<uint8_t> &data,
 void Ecc32MemArea::ReadBufferWithIntegrity(
     EccWords &data, const uint8_t buf[SV_MEM_WIDTH_BYTES],
     uint32_t src_word) const {
-  for (uint32_t i = 0; i < width_byte_ / 4; ++i) {
-    uint8_t buf32[4];
-    uint32_t w32 = 0;
-    for (uint32_t j = 0; j < 4; ++j) {
-      uint8_t byte = extract_bits(buf, 39 * i + 8 * j, 8);
-      buf32[j] = byte;
-      w32 |= (uint32_t)byte << 8 * j;
-    }
-
-    uint8_t exp_check_bits = enc_secded_inv_39_32(buf32);
-    uint8_t check_bits = extract_bits(buf, 39 * i + 32, 7);
-    bool good = check_bits == exp_check_bits;
-
-    data.push_back(std::make_pair(good, w32));
+  uint32_t width_32 = width_byte_ / 4;
+  assert(width_32 <= kMaxWords32);
+
+  uint32_t words[kMaxWords32] = {0};
+  uint8_t check_bits[kMaxWords32], exp_check_bits[kMaxWords32];
+  UnpackWords(buf, width_32, words, check_bits);
+  EncodeWords(words, width_32, exp_check_bits);
+  for (uint32_t i = 0; i < width_32; ++i) {
+    bool good = check_bits[i] == exp_check_bits[i];
+    data.push_back(std::make_pair(good, words[i]));
   }
 }
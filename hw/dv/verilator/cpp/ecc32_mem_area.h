@@ -22,8 +22,16 @@ class Ecc32MemArea : public MemArea {
    */
   Ecc32MemArea(const std::string &scope, uint32_t size, uint32_t width_32);
 
+  /** Load a vmem file into the memory
+   *
+   * If the file has words wider than the logical memory width, they are
+   * taken to be complete physical words and are written with WritePhys.
+   * Otherwise, integrity bits are computed as for Write.
+   */
   void LoadVmem(const std::string &path) const override;
 
+  uint32_t GetPhysWidthByte() const override;
+
   typedef std::pair<bool, uint32_t> EccWord;
   typedef std::vector<EccWord> EccWords;
 
@@ -53,9 +61,37 @@ class Ecc32MemArea : public MemArea {
    */
   void WriteWithIntegrity(uint32_t word_offset, const EccWords &data) const;
 
+  /** Compute the integrity bits for a batch of 32-bit words
+   *
+   * This gives the same result as calling enc_secded_inv_39_32 on each word,
+   * but uses lookup tables (built from that function) for each byte.
+   *
+   * @param words      The num_words words to encode.
+   *
+   * @param num_words  The number of words.
+   *
+   * @param check_bits Destination for the num_words 7-bit check values.
+   */
+  static void EncodeWords(const uint32_t *words, size_t num_words,
+                          uint8_t *check_bits);
+
+  /** Pack 39-bit codewords, as stored in the physical memory, into buf
+   *
+   * Codeword i consists of words[i] with check_bits[i] above it and goes at
+   * bit 39 * i of buf, which is little-endian. This writes all of the
+   * (39 * num_words + 7) / 8 bytes that hold the codewords, zeroing any bits
+   * above the last one.
+   */
+  static void PackWords(uint8_t *buf, const uint32_t *words,
+                        const uint8_t *check_bits, size_t num_words);
+
+  /** Unpack num_words 39-bit codewords from buf. The inverse of PackWords. */
+  static void UnpackWords(const uint8_t *buf, size_t num_words,
+                          uint32_t *words, uint8_t *check_bits);
+
  protected:
-  void WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
-                   const std::vector<uint8_t> &data, size_t start_idx,
+  void WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES], const uint8_t *data,
+                   size_t data_len, size_t start_idx,
                    uint32_t dst_word) const override;
 
   void ReadBuffer(std::vector<uint8_t> &data,
@@ -9,15 +9,18 @@
 #include <cstring>
 #include <sstream>
 
-#include "sv_scoped.h"
+#include "vmem_parser.h"
 
 // DPI exports, defined in prim_util_memload.svh
 extern "C" {
-void simutil_memload(const char *file);
 int simutil_set_mem(int index, const svBitVecVal *val);
 int simutil_get_mem(int index, svBitVecVal *val);
 }
 
+// Out-of-line definition, needed because std::min takes its arguments by
+// reference
+const uint32_t MemAreaBlock::kMaxWords;
+
 MemArea::MemArea(const std::string &scope, uint32_t num_words,
                  uint32_t width_byte)
     : scope_(scope), num_words_(num_words), width_byte_(width_byte) {
@@ -27,26 +30,36 @@ MemArea::MemArea(const std::string &scope, uint32_t num_words,
 
 void MemArea::Write(uint32_t word_offset,
                     const std::vector<uint8_t> &data) const {
-  // This "mini buffer" is used to transfer each write to SystemVerilog.
-  // `simutil_set_mem` takes a fixed SV_MEM_WIDTH_BITS-bit vector but it will
-  // only use the bits required for the RAM width. As an example, for a 32-bit
-  // wide RAM only elements 3:0 of `minibuf` will be written to memory. Since
-  // the simulator may still read bits from minibuf it does not use, we must
-  // use a fixed allocation of the full bit vector size to avoid an out of
-  // bounds access.
-  uint8_t minibuf[SV_MEM_WIDTH_BYTES];
-  memset(minibuf, 0, sizeof minibuf);
-  assert(width_byte_ <= sizeof minibuf);
-
-  uint32_t data_words = (data.size() + width_byte_ - 1) / width_byte_;
+  Write(word_offset, data.data(), data.size());
+}
+
+void MemArea::Write(uint32_t word_offset, const uint8_t *data,
+                    size_t len) const {
+  uint32_t data_words = (len + width_byte_ - 1) / width_byte_;
   assert(word_offset + data_words <= num_words_);
 
-  for (uint32_t i = 0; i < data_words; ++i) {
-    uint32_t dst_word = word_offset + i;
-    uint32_t phys_addr = ToPhysAddr(dst_word);
+  // Each slot in the block is a "mini buffer" used to transfer a write to
+  // SystemVerilog. `simutil_set_mem` takes a fixed SV_MEM_WIDTH_BITS-bit vector
+  // but it will only use the bits required for the RAM width. As an example,
+  // for a 32-bit wide RAM only elements 3:0 of a slot will be written to
+  // memory. Since the simulator may still read bits from the slot it does not
+  // use, each slot has a fixed allocation of the full bit vector size to avoid
+  // an out of bounds access.
+  assert(width_byte_ <= SV_MEM_WIDTH_BYTES);
+  MemAreaBlock block(std::min(data_words, MemAreaBlock::kMaxWords));
+
+  if (data_words) {
+    PrepareAccess(word_offset, data_words);
+  }
 
-    WriteBuffer(minibuf, data, i * width_byte_, dst_word);
-    WriteFromMinibuf(phys_addr, minibuf, dst_word);
+  for (uint32_t i = 0; i < data_words; i += MemAreaBlock::kMaxWords) {
+    uint32_t count = std::min(data_words - i, MemAreaBlock::kMaxWords);
+    for (uint32_t j = 0; j < count; ++j) {
+      uint32_t dst_word = word_offset + i + j;
+      block.PhysAddr(j) = ToPhysAddr(dst_word);
+      WriteBuffer(block.Slot(j), data, len, (i + j) * width_byte_, dst_word);
+    }
+    WriteFromBlock(block.PhysAddrs(), block.Slots(), count, word_offset + i);
   }
 }
 
@@ -57,35 +70,94 @@ std::vector<uint8_t> MemArea::Read(uint32_t word_offset,
   uint32_t num_bytes = width_byte_ * num_words;
   assert(num_words <= num_bytes);
 
-  // See Write for an explanation for this buffer.
-  uint8_t minibuf[SV_MEM_WIDTH_BYTES];
-  memset(minibuf, 0, sizeof minibuf);
-  assert(width_byte_ <= sizeof minibuf);
+  // See Write for an explanation for the slots in this block.
+  assert(width_byte_ <= SV_MEM_WIDTH_BYTES);
+  MemAreaBlock block(std::min(num_words, MemAreaBlock::kMaxWords));
 
   std::vector<uint8_t> ret;
   ret.reserve(num_bytes);
 
-  for (uint32_t i = 0; i < num_words; ++i) {
-    uint32_t src_word = word_offset + i;
-    uint32_t phys_addr = ToPhysAddr(src_word);
+  if (num_words) {
+    PrepareAccess(word_offset, num_words);
+  }
 
-    ReadToMinibuf(minibuf, phys_addr);
-    ReadBuffer(ret, minibuf, src_word);
+  for (uint32_t i = 0; i < num_words; i += MemAreaBlock::kMaxWords) {
+    uint32_t count = std::min(num_words - i, MemAreaBlock::kMaxWords);
+    for (uint32_t j = 0; j < count; ++j) {
+      block.PhysAddr(j) = ToPhysAddr(word_offset + i + j);
+    }
+    ReadToBlock(block.Slots(), block.PhysAddrs(), count);
+    for (uint32_t j = 0; j < count; ++j) {
+      ReadBuffer(ret, block.Slot(j), word_offset + i + j);
+    }
   }
 
   return ret;
 }
 
 void MemArea::LoadVmem(const std::string &path) const {
-  SVScoped scoped(scope_.c_str());
-  // TODO: Add error handling.
-  simutil_memload(path.c_str());
+  VmemImage image = ParseVmemFile(path, width_byte_);
+  CheckVmemFits(path, image, num_words_);
+  for (const VmemSegment &seg : image.segments) {
+    Write(seg.word_offset, seg.data);
+  }
 }
 
-void MemArea::WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
-                          const std::vector<uint8_t> &data, size_t start_idx,
+std::vector<uint8_t> MemArea::ReadPhys() const {
+  uint32_t phys_width_byte = GetPhysWidthByte();
+  assert(phys_width_byte <= SV_MEM_WIDTH_BYTES);
+
+  std::vector<uint8_t> ret;
+  ret.reserve(num_words_ * phys_width_byte);
+
+  MemAreaBlock block(std::min(num_words_, MemAreaBlock::kMaxWords));
+  for (uint32_t i = 0; i < num_words_; i += MemAreaBlock::kMaxWords) {
+    uint32_t count = std::min(num_words_ - i, MemAreaBlock::kMaxWords);
+    for (uint32_t j = 0; j < count; ++j) {
+      block.PhysAddr(j) = i + j;
+    }
+    ReadToBlock(block.Slots(), block.PhysAddrs(), count);
+    for (uint32_t j = 0; j < count; ++j) {
+      const uint8_t *slot = block.Slot(j);
+      ret.insert(ret.end(), slot, slot + phys_width_byte);
+    }
+  }
+
+  return ret;
+}
+
+void MemArea::WritePhys(uint32_t word_offset,
+                        const std::vector<uint8_t> &data) const {
+  uint32_t phys_width_byte = GetPhysWidthByte();
+  assert(phys_width_byte <= SV_MEM_WIDTH_BYTES);
+
+  size_t num_words = data.size() / phys_width_byte;
+  if (data.size() % phys_width_byte ||
+      (uint64_t)word_offset + num_words > num_words_) {
+    std::ostringstream oss;
+    oss << "Cannot write " << data.size() << " bytes of physical data at word "
+        << word_offset << " of memory at scope `" << scope_.GetName()
+        << "': words are " << phys_width_byte << " bytes and the memory has "
+        << num_words_ << " words.";
+    throw std::runtime_error(oss.str());
+  }
+
+  MemAreaBlock block(std::min((uint32_t)num_words, MemAreaBlock::kMaxWords));
+  for (uint32_t i = 0; i < num_words; i += MemAreaBlock::kMaxWords) {
+    uint32_t count = std::min((uint32_t)num_words - i, MemAreaBlock::kMaxWords);
+    for (uint32_t j = 0; j < count; ++j) {
+      block.PhysAddr(j) = word_offset + i + j;
+      memcpy(block.Slot(j), &data[(size_t)(i + j) * phys_width_byte],
+             phys_width_byte);
+    }
+    WriteFromBlock(block.PhysAddrs(), block.Slots(), count, word_offset + i);
+  }
+}
+
+void MemArea::WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES], const uint8_t *data,
+                          size_t data_len, size_t start_idx,
                           uint32_t dst_word) const {
-  size_t words_left = data.size() - start_idx;
+  size_t words_left = data_len - start_idx;
   size_t to_copy = std::min(words_left, (size_t)width_byte_);
   if (to_copy < width_byte_) {
     memset(buf, 0, SV_MEM_WIDTH_BYTES);
@@ -102,22 +174,38 @@ void MemArea::ReadBuffer(std::vector<uint8_t> &data,
 }
 
 void MemArea::ReadToMinibuf(uint8_t *minibuf, uint32_t phys_addr) const {
-  SVScoped scoped(scope_);
-  if (!simutil_get_mem(phys_addr, (svBitVecVal *)minibuf)) {
-    std::ostringstream oss;
-    oss << "Could not read memory word at physical index 0x" << std::hex
-        << phys_addr << ".";
-    throw std::runtime_error(oss.str());
-  }
+  ReadToBlock(minibuf, &phys_addr, 1);
 }
 
 void MemArea::WriteFromMinibuf(uint32_t phys_addr, const uint8_t *minibuf,
                                uint32_t dst_word) const {
+  WriteFromBlock(&phys_addr, minibuf, 1, dst_word);
+}
+
+void MemArea::ReadToBlock(uint8_t *block, const uint32_t *phys_addrs,
+                          uint32_t count) const {
   SVScoped scoped(scope_);
-  if (!simutil_set_mem(phys_addr, (const svBitVecVal *)minibuf)) {
-    std::ostringstream oss;
-    oss << "Could not set memory at byte offset 0x" << std::hex
-        << dst_word * width_byte_ << ".";
-    throw std::runtime_error(oss.str());
+  for (uint32_t i = 0; i < count; ++i) {
+    uint8_t *minibuf = block + i * SV_MEM_WIDTH_BYTES;
+    if (!simutil_get_mem(phys_addrs[i], (svBitVecVal *)minibuf)) {
+      std::ostringstream oss;
+      oss << "Could not read memory word at physical index 0x" << std::hex
+          << phys_addrs[i] << ".";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
+void MemArea::WriteFromBlock(const uint32_t *phys_addrs, const uint8_t *block,
+                             uint32_t count, uint32_t first_dst_word) const {
+  SVScoped scoped(scope_);
+  for (uint32_t i = 0; i < count; ++i) {
+    const uint8_t *minibuf = block + i * SV_MEM_WIDTH_BYTES;
+    if (!simutil_set_mem(phys_addrs[i], (const svBitVecVal *)minibuf)) {
+      std::ostringstream oss;
+      oss << "Could not set memory at byte offset 0x" << std::hex
+          << (first_dst_word + i) * width_byte_ << ".";
+      throw std::runtime_error(oss.str());
+    }
   }
 }
@@ -5,10 +5,13 @@
 #ifndef OPENTITAN_HW_DV_VERILATOR_CPP_MEM_AREA_H_
 #define OPENTITAN_HW_DV_VERILATOR_CPP_MEM_AREA_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
+#include "sv_scoped.h"
+
 // This is the maximum width of a memory that's supported by the code in
 // prim_util_memload.svh
 #define SV_MEM_WIDTH_BITS 312
@@ -27,8 +30,7 @@ class MemArea {
    *
    * @param scope  The SystemVerilog scope where the instantiated memory can be
    *               found. This needs to support the DPI-C interfaces \c
-   *               simutil_memload and \c simutil_set_mem (used for vmem and
-   *               ELF files, respectively).
+   *               simutil_set_mem and \c simutil_get_mem.
    *
    * @param size   The size of the memory in bytes (must be positive and a
    *               multiple of \p width_byte)
@@ -45,6 +47,10 @@ class MemArea {
    * be set, this throws an SVScoped::Error. If a call to \c simutil_set_mem
    * fails, this throws a \c std::runtime_error.
    *
+   * The data is converted to physical memory words in blocks of up to
+   * MemAreaBlock::kMaxWords words, and each block is then written with a
+   * single switch to the memory's scope.
+   *
    * @param word_offset The offset, in words, of the first word that should be
    *                    written.
    *
@@ -55,6 +61,14 @@ class MemArea {
   virtual void Write(uint32_t word_offset,
                      const std::vector<uint8_t> &data) const;
 
+  /** Write data to this memory area at the given word offset
+   *
+   * This is equivalent to the vector version of Write, but takes a pointer to
+   * \p len bytes of data. This lets callers write from memory that they don't
+   * own (such as a view into a memory-mapped file) without copying it first.
+   */
+  void Write(uint32_t word_offset, const uint8_t *data, size_t len) const;
+
   /** Read data from this memory area, starting at the given offset.
    *
    * This assumes that there are <tt>word_offset + num_words</tt> words in the
@@ -71,17 +85,47 @@ class MemArea {
   virtual std::vector<uint8_t> Read(uint32_t word_offset,
                                     uint32_t num_words) const;
 
-  /** Use \c simutil_memload to load a vmem file into the memory */
+  /** Load a vmem file into the memory
+   *
+   * The file is parsed in C++ (see vmem_parser.h) and its contents are then
+   * written with the same bulk path as Write, rather than going through
+   * $readmemh in the simulator. Throws a \c std::runtime_error if the file
+   * can't be parsed or doesn't fit in the memory.
+   */
   virtual void LoadVmem(const std::string &path) const;
 
-  const std::string &GetScope() const { return scope_; }
+  /** Read the raw contents of the whole physical memory
+   *
+   * This reads every word of the memory by physical index, without any
+   * address mapping, descrambling or integrity checks. Returns a vector with
+   * <tt>GetSizeWords() * GetPhysWidthByte()</tt> elements, which can be
+   * passed back to WritePhys to restore the memory exactly (for example, when
+   * restoring a simulation checkpoint).
+   *
+   * Throws in the same situations as Read.
+   */
+  std::vector<uint8_t> ReadPhys() const;
+
+  /** Write raw physical memory words, starting at the given physical index
+   *
+   * This is the inverse of ReadPhys: no address mapping, scrambling or
+   * integrity bits are applied. The length of \p data must be a multiple of
+   * GetPhysWidthByte() and the words must fit in the memory, otherwise this
+   * throws a \c std::runtime_error.
+   */
+  void WritePhys(uint32_t word_offset, const std::vector<uint8_t> &data) const;
+
+  const std::string &GetScope() const { return scope_.GetName(); }
   uint32_t GetSizeWords() const { return num_words_; }
   uint32_t GetSizeBytes() const { return num_words_ * width_byte_; }
   uint32_t GetWidthByte() const { return width_byte_; }
   uint32_t GetWidth() const { return 8 * width_byte_; }
 
+  /** The number of bytes needed to hold one word of the physical memory */
+  virtual uint32_t GetPhysWidthByte() const { return width_byte_; }
+
  protected:
-  std::string scope_;    ///< Design scope (used for accesses over DPI)
+  SVScopeHandle scope_;  ///< Design scope (used for accesses over DPI)
   uint32_t num_words_;   ///< Size of the memory area in words
   uint32_t width_byte_;  ///< Size of each word in bytes
 
@@ -95,11 +139,12 @@ class MemArea {
    *
    * @param buf       Destination buffer
    * @param data      A large buffer that contains the data to be written
+   * @param data_len  The number of bytes in \p data
    * @param start_idx An offset into \p data for the start of the memory word
    * @param dst_word  Logical address of the location being written
    */
-  virtual void WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
-                           const std::vector<uint8_t> &data, size_t start_idx,
+  virtual void WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES], const uint8_t *data,
+                           size_t data_len, size_t start_idx,
                            uint32_t dst_word) const;
 
   /** Extract the logical memory contents corresponding to the physical
@@ -120,6 +165,19 @@ class MemArea {
                           const uint8_t buf[SV_MEM_WIDTH_BYTES],
                           uint32_t src_word) const;
 
+  /** Prepare for a read or write of a range of words
+   *
+   * This is called once at the start of each (non-empty) read or write, before
+   * any words are converted. Subclasses can use it to refresh any state that
+   * they derive from the simulated design, rather than fetching that state
+   * again for every word. The default implementation does nothing.
+   *
+   * @param word_offset The logical address of the first word to be accessed
+   *
+   * @param num_words   The number of words that will be accessed
+   */
+  virtual void PrepareAccess(uint32_t word_offset, uint32_t num_words) const {}
+
   /** Convert a logical address to physical address
    *
    * Some memories may have a mapping between the address supplied on the
@@ -145,6 +203,54 @@ class MemArea {
    */
   void WriteFromMinibuf(uint32_t phys_addr, const uint8_t *minibuf,
                         uint32_t dst_word) const;
+
+  /** Read a block of memory words into block
+   *
+   * This is the bulk equivalent of ReadToMinibuf. It switches to the memory's
+   * scope once and then reads \p count words, using the physical addresses in
+   * \p phys_addrs. The result for word \c i is written to the minibuf-sized
+   * slot at <tt>block + i * SV_MEM_WIDTH_BYTES</tt>.
+   */
+  void ReadToBlock(uint8_t *block, const uint32_t *phys_addrs,
+                   uint32_t count) const;
+
+  /** Write a block of memory words from block
+   *
+   * This is the bulk equivalent of WriteFromMinibuf. It switches to the
+   * memory's scope once and then writes \p count words from minibuf-sized
+   * slots in \p block to the physical addresses in \p phys_addrs. The logical
+   * addresses of the words are assumed to be contiguous, starting at
+   * \p first_dst_word (these are only used for error messages).
+   */
+  void WriteFromBlock(const uint32_t *phys_addrs, const uint8_t *block,
+                      uint32_t count, uint32_t first_dst_word) const;
+};
+
+/**
+ * Staging storage for block transfers to and from a MemArea.
+ *
+ * This holds up to capacity minibuf-sized slots (see MemArea::Write), together
+ * with the physical address for each slot. The slots start zeroed and are only
+ * ever partially overwritten, so bits above the memory width stay clear.
+ */
+class MemAreaBlock {
+ public:
+  /** The maximum number of words that we stage for a single transfer */
+  static const uint32_t kMaxWords = 1024;
+
+  explicit MemAreaBlock(uint32_t capacity)
+      : phys_addrs_(capacity), bufs_(capacity * SV_MEM_WIDTH_BYTES, 0) {}
+
+  uint8_t *Slot(uint32_t idx) { return &bufs_[idx * SV_MEM_WIDTH_BYTES]; }
+  const uint8_t *Slots() const { return bufs_.data(); }
+  uint8_t *Slots() { return bufs_.data(); }
+
+  uint32_t &PhysAddr(uint32_t idx) { return phys_addrs_[idx]; }
+  const uint32_t *PhysAddrs() const { return phys_addrs_.data(); }
+
+ private:
+  std::vector<uint32_t> phys_addrs_;
+  std::vector<uint8_t> bufs_;
 };
 
 #endif  // OPENTITAN_HW_DV_VERILATOR_CPP_MEM_AREA_H_
@@ -7,7 +7,9 @@
 // Utility class representing disjoint segments of memory
 
 #include <cassert>
+#include <cstddef>
 #include <map>
+#include <vector>
 
 // The type used to represent address ranges. This is essentially a std::pair,
 // but we need a operator< custom for the internal map.
@@ -106,42 +108,55 @@ class RangedMap {
   // the map and val are unchanged and a pointer to the existing entry is
   // returned. Otherwise, returns nullptr.
   const val_t *EmplaceDisjoint(addr_t min_addr, addr_t max_addr, val_t &&val) {
+    const val_t *clash = FindOverlap(min_addr, max_addr);
+    if (clash)
+      return clash;
+
+    rng_t rng = {.lo = min_addr, .hi = max_addr};
+    map_.insert(std::make_pair(rng, std::move(val)));
+    return nullptr;
+  }
+
+  // Find an entry that overlaps with the address range [min_addr, max_addr]
+  // (inclusive). Returns a pointer to the entry if there is one. Otherwise,
+  // returns nullptr.
+  const val_t *FindOverlap(addr_t min_addr, addr_t max_addr) const {
     assert(min_addr <= max_addr);
     rng_t rng = {.lo = min_addr, .hi = max_addr};
 
-    if (!map_.empty()) {
-      // We start by checking for an overlap "from the right". This would be a
-      // region that starts strictly above min_addr, but where it's low address
-      // is still <= max_addr. We can use std::map::upper_bound to find the
-      // first region strictly above min_addr (which returns the end iterator
-      // if there isn't one).
-      auto right_it = map_.upper_bound(rng);
-      if (right_it != map_.end()) {
-        addr_t right_min = right_it->first.lo;
-        if (right_min <= max_addr) {
-          return &right_it->second;
-        }
+    if (map_.empty())
+      return nullptr;
+
+    // We start by checking for an overlap "from the right". This would be a
+    // region that starts strictly above min_addr, but where it's low address
+    // is still <= max_addr. We can use std::map::upper_bound to find the
+    // first region strictly above min_addr (which returns the end iterator
+    // if there isn't one).
+    auto right_it = map_.upper_bound(rng);
+    if (right_it != map_.end()) {
+      addr_t right_min = right_it->first.lo;
+      if (right_min <= max_addr) {
+        return &right_it->second;
       }
+    }
 
-      // We also need to check from the left side. This would be a region that
-      // starts at or before min_addr and extends past it. If right_it is
-      // mem_.begin(), there is no such region (because the lowest addressed
-      // region already starts above min_addr). Otherwise, decrement right_it
-      // to get the highest addressed region that starts at or before min_addr.
-      // Note this still works if right_it is the end iterator: we just pick up
-      // the last region, which we know exists because map_ is not empty.
-      if (right_it != map_.begin()) {
-        auto left_it = std::prev(right_it);
-        addr_t left_max = left_it->first.hi;
-
-        if (min_addr <= left_max) {
-          return &left_it->second;
-        }
+    // We also need to check from the left side. This would be a region that
+    // starts at or before min_addr and extends past it. If right_it is
+    // mem_.begin(), there is no such region (because the lowest addressed
+    // region already starts above min_addr). Otherwise, decrement right_it
+    // to get the highest addressed region that starts at or before min_addr.
+    // Note this still works if right_it is the end iterator: we just pick up
+    // the last region, which we know exists because map_ is not empty.
+    if (right_it != map_.begin()) {
+      auto left_it = std::prev(right_it);
+      addr_t left_max = left_it->first.hi;
+
+      if (min_addr <= left_max) {
+        return &left_it->second;
       }
     }
 
     // Phew, no overlap!
-    map_.insert(std::make_pair(rng, std::move(val)));
     return nullptr;
   }
 
@@ -180,4 +195,52 @@ class RangedMap {
   std::map<rng_t, val_t> map_;
 };
 
+// An immutable copy of a RangedMap, for lookups on hot paths. The ranges are
+// held in sorted arrays, so find() is a binary search over contiguous memory
+// without the pointer chasing of std::map. Build one once the RangedMap has
+// been filled in (and again if it changes).
+template <typename addr_t, typename val_t>
+class FrozenRangedMap {
+ public:
+  FrozenRangedMap() {}
+
+  explicit FrozenRangedMap(const RangedMap<addr_t, val_t> &map) {
+    los_.reserve(map.size());
+    his_.reserve(map.size());
+    vals_.reserve(map.size());
+    for (const auto &pr : map) {
+      los_.push_back(pr.first.lo);
+      his_.push_back(pr.first.hi);
+      vals_.push_back(pr.second);
+    }
+  }
+
+  size_t size() const { return vals_.size(); }
+
+  // Try to find an entry hitting the given address. Returns nullptr if there
+  // is none.
+  const val_t *find(addr_t addr) const {
+    size_t n = los_.size();
+    if (n == 0 || addr < los_[0])
+      return nullptr;
+
+    // Find the last range that starts at or below addr. The search keeps
+    // base pointing at such a range and halves the number of candidates on
+    // each step, with a select rather than a branch.
+    const addr_t *base = los_.data();
+    while (n > 1) {
+      size_t half = n / 2;
+      base = (base[half] <= addr) ? base + half : base;
+      n -= half;
+    }
+
+    size_t idx = base - los_.data();
+    return (addr <= his_[idx]) ? &vals_[idx] : nullptr;
+  }
+
+ private:
+  std::vector<addr_t> los_, his_;
+  std::vector<val_t> vals_;
+};
+
 #endif  // OPENTITAN_HW_DV_VERILATOR_CPP_RANGED_MAP_H_
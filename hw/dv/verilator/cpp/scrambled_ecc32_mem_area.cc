@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -17,34 +18,6 @@
 static const uint32_t kScrMaxNonceWidth = 320;
 static const uint32_t kScrMaxNonceWidthByte = (kScrMaxNonceWidth + 7) / 8;
 
-// Functions to convert from integer address to/from a little-endian vector of
-// bytes, addr_width is given in bits
-static std::vector<uint8_t> AddrIntToBytes(uint32_t addr, uint32_t addr_width) {
-  uint32_t addr_width_bytes = (addr_width + 7) / 8;
-  std::vector<uint8_t> addr_bytes(addr_width_bytes);
-
-  for (uint32_t i = 0; i < addr_width_bytes; ++i) {
-    addr_bytes[i] = addr & 0xff;
-    addr >>= 8;
-  }
-
-  return addr_bytes;
-}
-
-static uint32_t AddrBytesToInt(const std::vector<uint8_t> &addr) {
-  assert(addr.size() <= 4);
-
-  uint32_t addr_out = 0;
-  int cur_shift = 0;
-
-  for (uint8_t byte : addr) {
-    addr_out |= ((uint32_t)byte << cur_shift);
-    cur_shift += 8;
-  }
-
-  return addr_out;
-}
-
 // Converts svBitVecVal (bit[m:n] SV type) into a byte vector
 static std::vector<uint8_t> ByteVecFromSV(svBitVecVal sv_val[],
                                           uint32_t bytes) {
@@ -92,7 +65,7 @@ std::vector<uint8_t> ScrambledEcc32MemArea::GetScrambleKey() const {
 
   if (!simutil_get_scramble_key(key_minibuf)) {
     std::ostringstream oss;
-    oss << "Could not read key at scope " << scr_scope_;
+    oss << "Could not read key at scope " << scr_scope_.GetName();
     throw std::runtime_error(oss.str());
   }
 
@@ -107,7 +80,7 @@ std::vector<uint8_t> ScrambledEcc32MemArea::GetScrambleNonce() const {
 
   if (!simutil_get_scramble_nonce((svBitVecVal *)nonce_minibuf)) {
     std::ostringstream oss;
-    oss << "Could not read nonce at scope " << scr_scope_;
+    oss << "Could not read nonce at scope " << scr_scope_.GetName();
     throw std::runtime_error(oss.str());
   }
 
@@ -121,18 +94,11 @@ ScrambledEcc32MemArea::ScrambledEcc32MemArea(const std::string &scope,
           SVScoped::join_sv_scopes(
               scope, "u_prim_ram_1p_adv.u_mem.gen_generic.u_impl_generic"),
           size, width_32),
-      scr_scope_(scope) {
-  addr_width_ = vbits(size);
-  repeat_keystream_ = repeat_keystream;
-}
-
-uint32_t ScrambledEcc32MemArea::GetPhysWidth() const {
-  return (GetWidthByte() / 4) * 39;
-}
-
-uint32_t ScrambledEcc32MemArea::GetPhysWidthByte() const {
-  return (GetPhysWidth() + 7) / 8;
-}
+      scr_scope_(scope),
+      addr_width_(vbits(size)),
+      repeat_keystream_(repeat_keystream),
+      engine_(39 * width_32, addr_width_, repeat_keystream),
+      table_(nullptr) {}
 
 uint32_t ScrambledEcc32MemArea::GetPrinceReplications() const {
   if (repeat_keystream_) {
@@ -151,36 +117,37 @@ uint32_t ScrambledEcc32MemArea::GetNonceWidthByte() const {
 }
 
 void ScrambledEcc32MemArea::WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
-                                        const std::vector<uint8_t> &data,
+                                        const uint8_t *data, size_t data_len,
                                         size_t start_idx,
                                         uint32_t dst_word) const {
   // Compute integrity
-  Ecc32MemArea::WriteBuffer(buf, data, start_idx, dst_word);
+  Ecc32MemArea::WriteBuffer(buf, data, data_len, start_idx, dst_word);
   ScrambleBuffer(buf, dst_word);
 }
 
-std::vector<uint8_t> ScrambledEcc32MemArea::ReadUnscrambled(
-    const uint8_t buf[SV_MEM_WIDTH_BYTES], uint32_t src_word) const {
-  std::vector<uint8_t> scrambled_data(buf, buf + GetPhysWidthByte());
-  return scramble_decrypt_data(scrambled_data, GetPhysWidth(), 39,
-                               AddrIntToBytes(src_word, addr_width_),
-                               addr_width_, GetScrambleNonce(),
-                               GetScrambleKey(), repeat_keystream_, false);
+void ScrambledEcc32MemArea::ReadUnscrambled(
+    uint8_t dst[SV_MEM_WIDTH_BYTES], const uint8_t buf[SV_MEM_WIDTH_BYTES],
+    uint32_t src_word) const {
+  memset(dst, 0, SV_MEM_WIDTH_BYTES);
+  memcpy(dst, buf, GetPhysWidthByte());
+  ApplyKeystream(dst, src_word);
 }
 
 void ScrambledEcc32MemArea::ReadBuffer(std::vector<uint8_t> &data,
                                        const uint8_t buf[SV_MEM_WIDTH_BYTES],
                                        uint32_t src_word) const {
-  std::vector<uint8_t> unscrambled_data = ReadUnscrambled(buf, src_word);
+  uint8_t unscrambled_data[SV_MEM_WIDTH_BYTES];
+  ReadUnscrambled(unscrambled_data, buf, src_word);
   // Strip integrity to give final result
-  Ecc32MemArea::ReadBuffer(data, &unscrambled_data[0], src_word);
+  Ecc32MemArea::ReadBuffer(data, unscrambled_data, src_word);
 }
 
 void ScrambledEcc32MemArea::ReadBufferWithIntegrity(
     EccWords &data, const uint8_t buf[SV_MEM_WIDTH_BYTES],
     uint32_t src_word) const {
-  std::vector<uint8_t> unscrambled_data = ReadUnscrambled(buf, src_word);
-  Ecc32MemArea::ReadBufferWithIntegrity(data, &unscrambled_data[0], src_word);
+  uint8_t unscrambled_data[SV_MEM_WIDTH_BYTES];
+  ReadUnscrambled(unscrambled_data, buf, src_word);
+  Ecc32MemArea::ReadBufferWithIntegrity(data, unscrambled_data, src_word);
 }
 
 void ScrambledEcc32MemArea::WriteBufferWithIntegrity(
@@ -192,21 +159,61 @@ void ScrambledEcc32MemArea::WriteBufferWithIntegrity(
 
 void ScrambledEcc32MemArea::ScrambleBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
                                            uint32_t dst_word) const {
-  std::vector<uint8_t> scramble_buf(buf, buf + GetPhysWidthByte());
-
-  // Scramble data with integrity
-  scramble_buf = scramble_encrypt_data(
-      scramble_buf, GetPhysWidth(), 39, AddrIntToBytes(dst_word, addr_width_),
-      addr_width_, GetScrambleNonce(), GetScrambleKey(), repeat_keystream_,
-      false);
-
-  // Copy scrambled data to write buffer
-  std::copy(scramble_buf.begin(), scramble_buf.end(), &buf[0]);
+  // Scramble data with integrity in place
+  ApplyKeystream(buf, dst_word);
 }
 
 uint32_t ScrambledEcc32MemArea::ToPhysAddr(uint32_t logical_addr) const {
   // Scramble logical address to get physical address
-  return AddrBytesToInt(scramble_addr(AddrIntToBytes(logical_addr, addr_width_),
-                                      addr_width_, GetScrambleNonce(),
-                                      GetNonceWidth()));
+  if (table_) {
+    return table_->phys_addrs[logical_addr];
+  }
+  return engine_.ScrambleAddr(logical_addr);
+}
+
+void ScrambledEcc32MemArea::ApplyKeystream(uint8_t buf[SV_MEM_WIDTH_BYTES],
+                                           uint32_t addr) const {
+  if (!table_) {
+    engine_.CryptData(buf, addr);
+    return;
+  }
+
+  uint32_t ks_bytes = engine_.GetDataWidthByte();
+  const uint8_t *keystream = &table_->keystreams[addr * ks_bytes];
+  for (uint32_t i = 0; i < ks_bytes; ++i) {
+    buf[i] ^= keystream[i];
+  }
+}
+
+void ScrambledEcc32MemArea::PrepareAccess(uint32_t word_offset,
+                                          uint32_t num_words) const {
+  std::vector<uint8_t> key = GetScrambleKey();
+  std::vector<uint8_t> nonce = GetScrambleNonce();
+
+  std::vector<uint8_t> key_nonce(key);
+  key_nonce.insert(key_nonce.end(), nonce.begin(), nonce.end());
+
+  if (!engine_.HasKeyNonce(key, nonce)) {
+    engine_.SetKeyNonce(key, nonce);
+
+    auto it = table_cache_.find(key_nonce);
+    table_ = (it == table_cache_.end()) ? nullptr : &it->second;
+  }
+
+  if (table_ || num_words < kMinTableWords) {
+    return;
+  }
+
+  // Make space for a new table, dropping an arbitrary old one if necessary.
+  // None of the cached tables is current (otherwise table_ would be set), so
+  // this doesn't invalidate anything we're using.
+  if (table_cache_.size() >= kMaxCachedTables) {
+    table_cache_.erase(table_cache_.begin());
+  }
+
+  KeystreamTable &table = table_cache_[key_nonce];
+  table.phys_addrs.resize(num_words_);
+  table.keystreams.resize(num_words_ * engine_.GetDataWidthByte());
+  engine_.GenTable(0, num_words_, &table.phys_addrs[0], &table.keystreams[0]);
+  table_ = &table;
 }
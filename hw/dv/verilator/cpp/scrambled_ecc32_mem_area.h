@@ -5,9 +5,11 @@
 #ifndef OPENTITAN_HW_DV_VERILATOR_CPP_SCRAMBLED_ECC32_MEM_AREA_H_
 #define OPENTITAN_HW_DV_VERILATOR_CPP_SCRAMBLED_ECC32_MEM_AREA_H_
 
+#include <map>
 #include <vector>
 
 #include "ecc32_mem_area.h"
+#include "scramble_model.h"
 
 /**
  * A memory that implements scrambling over a 32-bit ECC integrity protection
@@ -33,12 +35,13 @@ class ScrambledEcc32MemArea : public Ecc32MemArea {
                         uint32_t width_32, bool repeat_keystream = true);
 
  private:
-  void WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
-                   const std::vector<uint8_t> &data, size_t start_idx,
+  void WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES], const uint8_t *data,
+                   size_t data_len, size_t start_idx,
                    uint32_t dst_word) const override;
 
-  std::vector<uint8_t> ReadUnscrambled(const uint8_t buf[SV_MEM_WIDTH_BYTES],
-                                       uint32_t src_word) const;
+  void ReadUnscrambled(uint8_t dst[SV_MEM_WIDTH_BYTES],
+                       const uint8_t buf[SV_MEM_WIDTH_BYTES],
+                       uint32_t src_word) const;
 
   void ReadBuffer(std::vector<uint8_t> &data,
                   const uint8_t buf[SV_MEM_WIDTH_BYTES],
@@ -56,8 +59,18 @@ class ScrambledEcc32MemArea : public Ecc32MemArea {
 
   uint32_t ToPhysAddr(uint32_t logical_addr) const override;
 
-  uint32_t GetPhysWidth() const;
-  uint32_t GetPhysWidthByte() const;
+  /** Fetch the scrambling key and nonce from the design
+   *
+   * The scrambling engine is only re-initialised if the RTL has been rekeyed
+   * since the last access. If the access covers at least kMinTableWords words
+   * and there is no keystream table for the current key and nonce, this also
+   * builds one for the whole memory (see KeystreamTable).
+   */
+  void PrepareAccess(uint32_t word_offset, uint32_t num_words) const override;
+
+  /** XOR the keystream for the word at logical address addr into buf */
+  void ApplyKeystream(uint8_t buf[SV_MEM_WIDTH_BYTES], uint32_t addr) const;
+
   uint32_t GetPrinceReplications() const;
   uint32_t GetNonceWidth() const;
   uint32_t GetNonceWidthByte() const;
@@ -65,9 +78,33 @@ class ScrambledEcc32MemArea : public Ecc32MemArea {
   std::vector<uint8_t> GetScrambleKey() const;
   std::vector<uint8_t> GetScrambleNonce() const;
 
-  std::string scr_scope_;
+  SVScopeHandle scr_scope_;
   uint32_t addr_width_;
   bool repeat_keystream_;
+
+  // Scrambling engine, keyed with the key and nonce that were seen by the most
+  // recent call to PrepareAccess.
+  mutable ScrambleEngine engine_;
+
+  // Physical addresses and keystreams for every word in the memory, computed
+  // in parallel for a given key and nonce.
+  struct KeystreamTable {
+    std::vector<uint32_t> phys_addrs;
+    std::vector<uint8_t> keystreams;
+  };
+
+  // The minimum number of words in an access that causes us to build a
+  // KeystreamTable, and the maximum number of tables that we keep around.
+  static const uint32_t kMinTableWords = 256;
+  static const size_t kMaxCachedTables = 4;
+
+  // Keystream tables, keyed by the scrambling key followed by the nonce. These
+  // are kept across rekeys, so reloading memory after a reset that restores a
+  // previous key doesn't repeat the crypto.
+  mutable std::map<std::vector<uint8_t>, KeystreamTable> table_cache_;
+
+  // The table for the current key and nonce, or null if there isn't one yet.
+  mutable const KeystreamTable *table_;
 };
 
 #endif  // OPENTITAN_HW_DV_VERILATOR_CPP_SCRAMBLED_ECC32_MEM_AREA_H_
@@ -7,27 +7,26 @@
 #include <cassert>
 #include <sstream>
 
-// Set scope by name, returning the old scope. If the name doesn't describe a
-// valid scope, throw an SVScoped::Error.
-static svScope SetAbsScope(const std::string &name) {
+// Look up a scope by absolute name. If the name doesn't describe a valid
+// scope, throw an SVScoped::Error.
+static svScope GetAbsScope(const std::string &name) {
   svScope new_scope = svGetScopeFromName(name.c_str());
   if (!new_scope)
     throw SVScoped::Error(name);
-  return svSetScope(new_scope);
+  return new_scope;
 }
 
 // Resolve name to a scope, using the rules described in the comment above the
-// class in sv_scoped.h, and then set it. Returns the old scope.
-static svScope SetRelScope(const std::string &name) {
+// class in sv_scoped.h.
+static svScope GetRelScope(const std::string &name) {
   // Absolute (or empty) names resolve to themselves
   if (name[0] != '.') {
-    return SetAbsScope(name);
+    return GetAbsScope(name);
   }
 
   svScope prev_scope = svGetScope();
 
-  // Special case: If name is ".", it means to use the current scope. Rather
-  // than changing scope, we can just return where we are going to stay.
+  // Special case: If name is ".", it means to use the current scope.
   if (name == ".")
     return prev_scope;
 
@@ -82,10 +81,14 @@ static svScope SetRelScope(const std::string &name) {
     scope_name.append(name, first_not_dot - 1, std::string::npos);
   }
 
-  return SetAbsScope(scope_name);
+  return GetAbsScope(scope_name);
 }
 
-SVScoped::SVScoped(const std::string &name) : prev_scope_(SetRelScope(name)) {}
+SVScoped::SVScoped(const std::string &name)
+    : prev_scope_(svSetScope(GetRelScope(name))) {}
+
+SVScoped::SVScoped(const SVScopeHandle &handle)
+    : prev_scope_(svSetScope(handle.Get())) {}
 
 SVScoped::Error::Error(const std::string &scope_name)
     : scope_name_(scope_name) {
@@ -102,3 +105,17 @@ std::string SVScoped::join_sv_scopes(const std::string &a,
   // (inserting a "." between the two)
   return (a.back() == '.') ? a + b : a + "." + b;
 }
+
+SVScopeHandle::SVScopeHandle(const std::string &name)
+    : name_(name), base_(nullptr), scope_(nullptr) {}
+
+svScope SVScopeHandle::Get() const {
+  // A relative name depends on the current scope, so it can only reuse the
+  // cached result if it is resolved from the same place as last time.
+  svScope base = name_[0] == '.' ? svGetScope() : nullptr;
+  if (!scope_ || base != base_) {
+    scope_ = GetRelScope(name_);
+    base_ = base;
+  }
+  return scope_;
+}
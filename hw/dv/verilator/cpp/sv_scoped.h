@@ -28,10 +28,17 @@
  * the scope with name "qux".
  *
  * This guard restores the previous scope at destruction.
+ *
+ * Resolving a name means a string lookup in the simulator. Code that switches
+ * to the same scope repeatedly (such as backdoor memory accesses) should hold
+ * an SVScopeHandle and use the constructor that takes it instead.
  */
+class SVScopeHandle;
+
 class SVScoped {
  public:
   SVScoped(const std::string &name);
+  SVScoped(const SVScopeHandle &handle);
   ~SVScoped() { svSetScope(prev_scope_); }
 
   class Error : public std::exception {
@@ -52,4 +59,28 @@ class SVScoped {
   svScope prev_scope_;
 };
 
+/**
+ * A SystemVerilog scope name together with the scope it resolves to
+ *
+ * The name follows the rules described above SVScoped. It is resolved the
+ * first time it is needed and the result is reused after that. A relative
+ * name is resolved again if it is used from a different current scope.
+ */
+class SVScopeHandle {
+ public:
+  explicit SVScopeHandle(const std::string &name);
+
+  /** Return the resolved scope, throwing an SVScoped::Error if there is none */
+  svScope Get() const;
+
+  const std::string &GetName() const { return name_; }
+
+ private:
+  std::string name_;
+  // The current scope when scope_ was resolved (only used if name_ is
+  // relative) and the resolved scope itself.
+  mutable svScope base_;
+  mutable svScope scope_;
+};
+
 #endif  // OPENTITAN_HW_DV_VERILATOR_CPP_SV_SCOPED_H_
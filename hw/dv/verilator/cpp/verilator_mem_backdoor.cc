@@ -0,0 +1,210 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "verilator_mem_backdoor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <sstream>
+
+#include "tcp_server.h"
+
+static uint32_t GetLE32(const uint8_t *buf) {
+  return (uint32_t)buf[0] | (uint32_t)buf[1] << 8 | (uint32_t)buf[2] << 16 |
+         (uint32_t)buf[3] << 24;
+}
+
+// A response with the given status and payload
+static std::vector<uint8_t> MakeResponse(uint8_t status, const uint8_t *payload,
+                                         uint32_t len) {
+  std::vector<uint8_t> resp(VerilatorMemBackdoor::kRespHeaderSize + len);
+  resp[0] = status;
+  for (int i = 0; i < 4; ++i) {
+    resp[1 + i] = (len >> 8 * i) & 0xff;
+  }
+  if (len) {
+    std::copy(payload, payload + len,
+              resp.begin() + VerilatorMemBackdoor::kRespHeaderSize);
+  }
+  return resp;
+}
+
+static std::vector<uint8_t> MakeError(const std::string &msg) {
+  return MakeResponse(1, reinterpret_cast<const uint8_t *>(msg.data()),
+                      msg.size());
+}
+
+// Print a usage message to stdout
+static void PrintHelp() {
+  std::cout << "Simulation memory backdoor:\n\n"
+               "--mem-backdoor-port=PORT\n"
+               "  Serve memory read and write requests on TCP port PORT\n\n"
+               "--mem-backdoor-interval=N\n"
+               "  Handle requests every N cycles (default 1000)\n\n"
+               "-h|--help\n"
+               "  Show help\n\n";
+}
+
+VerilatorMemBackdoor::VerilatorMemBackdoor(DpiMemUtil *mem_util)
+    : mem_util_(mem_util), server_(nullptr), interval_(1000) {
+  assert(mem_util);
+}
+
+VerilatorMemBackdoor::~VerilatorMemBackdoor() { PostExec(); }
+
+bool VerilatorMemBackdoor::ParseCLIArguments(int argc, char **argv,
+                                             bool &exit_app) {
+  const struct option long_options[] = {
+      {"mem-backdoor-port", required_argument, nullptr, 'p'},
+      {"mem-backdoor-interval", required_argument, nullptr, 'i'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  int port = 0;
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, "-:h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+      case 1:
+        break;
+      case 'p':
+        port = atoi(optarg);
+        if (port <= 0 || port > 65535) {
+          std::cerr << "ERROR: Invalid --mem-backdoor-port: " << optarg << "."
+                    << std::endl;
+          return false;
+        }
+        break;
+      case 'i':
+        interval_ = strtoul(optarg, nullptr, 0);
+        if (interval_ == 0) {
+          std::cerr << "ERROR: --mem-backdoor-interval must be at least 1."
+                    << std::endl;
+          return false;
+        }
+        break;
+      case 'h':
+        PrintHelp();
+        return true;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  if (port && !server_) {
+    server_ = tcp_server_create_buffered("mem_backdoor", port, 1024 * 1024);
+    if (!server_) {
+      std::cerr << "ERROR: Could not start the memory backdoor on port "
+                << port << "." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<uint8_t> VerilatorMemBackdoor::HandleRequest(uint8_t op,
+                                                         uint32_t addr,
+                                                         uint32_t len,
+                                                         const uint8_t *data) {
+  try {
+    switch (op) {
+      case kOpRead: {
+        std::vector<uint8_t> bytes = mem_util_->ReadAddr(addr, len);
+        return MakeResponse(0, bytes.data(), bytes.size());
+      }
+      case kOpWrite:
+        mem_util_->WriteAddr(addr, data, len);
+        return MakeResponse(0, nullptr, 0);
+      case kOpList: {
+        std::ostringstream oss;
+        mem_util_->ListMemRegions(oss);
+        std::string list = oss.str();
+        return MakeResponse(0, reinterpret_cast<const uint8_t *>(list.data()),
+                            list.size());
+      }
+      default: {
+        std::ostringstream oss;
+        oss << "Unknown memory backdoor op " << (int)op << ".";
+        return MakeError(oss.str());
+      }
+    }
+  } catch (const std::exception &err) {
+    return MakeError(err.what());
+  }
+}
+
+void VerilatorMemBackdoor::OnClock(unsigned long sim_time) {
+  if (!server_) {
+    return;
+  }
+
+  char chunk[4096];
+  size_t got;
+  while ((got = tcp_server_read_buf(server_, chunk, sizeof(chunk))) > 0) {
+    rx_.insert(rx_.end(), chunk, chunk + got);
+  }
+
+  size_t pos = 0;
+  while (rx_.size() - pos >= kReqHeaderSize) {
+    const uint8_t *hdr = &rx_[pos];
+    uint8_t op = hdr[0];
+    uint32_t addr = GetLE32(hdr + 1);
+    uint32_t len = GetLE32(hdr + 5);
+
+    if (len > kMaxLen && op != kOpList) {
+      // A write this big can't be skipped safely, so give up on the client.
+      std::ostringstream oss;
+      oss << "Request length 0x" << std::hex << len << " is larger than the "
+          << "maximum of 0x" << kMaxLen << ".";
+      std::vector<uint8_t> resp = MakeError(oss.str());
+      tcp_server_write_buf(server_, reinterpret_cast<const char *>(resp.data()),
+                           resp.size());
+      tcp_server_client_close(server_);
+      rx_.clear();
+      return;
+    }
+
+    size_t data_len = op == kOpWrite ? len : 0;
+    if (rx_.size() - pos < kReqHeaderSize + data_len) {
+      break;
+    }
+
+    std::vector<uint8_t> resp =
+        HandleRequest(op, addr, len, hdr + kReqHeaderSize);
+    tcp_server_write_buf(server_, reinterpret_cast<const char *>(resp.data()),
+                         resp.size());
+    pos += kReqHeaderSize + data_len;
+  }
+  rx_.erase(rx_.begin(), rx_.begin() + pos);
+}
+
+unsigned long VerilatorMemBackdoor::GetNextWakeCycle(unsigned long cycle) {
+  return server_ ? cycle + interval_ : kNeverWake;
+}
+
+void VerilatorMemBackdoor::PostExec() {
+  if (server_) {
+    tcp_server_close(server_);
+    server_ = nullptr;
+  }
+}
@@ -0,0 +1,81 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_DV_VERILATOR_CPP_VERILATOR_MEM_BACKDOOR_H_
+#define OPENTITAN_HW_DV_VERILATOR_CPP_VERILATOR_MEM_BACKDOOR_H_
+
+//
+// A SimCtrlExtension that lets host tools read and write the memories
+// registered with a DpiMemUtil over a TCP socket while the simulation runs.
+//
+// The service is enabled with --mem-backdoor-port=PORT. Every
+// --mem-backdoor-interval=N cycles (default 1000), between clock edges, it
+// handles all of the complete requests that have arrived. Requests and
+// responses are binary, with all fields little-endian:
+//
+//   Request:  1 byte op, 4 byte address, 4 byte length, then for writes
+//             <length> bytes of data
+//   Response: 1 byte status (0 for success), 4 byte length, then <length>
+//             bytes of payload
+//
+// The ops are:
+//
+//   kOpRead (1):  Read <length> bytes at <address>. The payload is the data.
+//   kOpWrite (2): Write the data to <address>. There is no payload.
+//   kOpList (3):  List the registered memories. The payload is the text from
+//                 DpiMemUtil::ListMemRegions(). The address and length are
+//                 ignored.
+//
+// Addresses are LMAs, as given to DpiMemUtil::RegisterMemoryArea(), and a
+// request must not cross from one memory into another. Accesses go through
+// MemArea::Read and MemArea::Write, so scrambled and ECC memories see the
+// same data as with --meminit. If a request fails, the status is nonzero and
+// the payload is an error message.
+//
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dpi_memutil.h"
+#include "sim_ctrl_extension.h"
+
+struct tcp_server_ctx;
+
+class VerilatorMemBackdoor : public SimCtrlExtension {
+ public:
+  enum Op : uint8_t { kOpRead = 1, kOpWrite = 2, kOpList = 3 };
+
+  // Size of a request header (and of a response header)
+  static const size_t kReqHeaderSize = 9;
+  static const size_t kRespHeaderSize = 5;
+
+  // The largest read or write that a single request can make
+  static const uint32_t kMaxLen = 64 * 1024 * 1024;
+
+  // Wraps mem_util, which must outlive this object (but does not take
+  // ownership)
+  explicit VerilatorMemBackdoor(DpiMemUtil *mem_util);
+  ~VerilatorMemBackdoor();
+
+  // Declared in SimCtrlExtension
+  bool ParseCLIArguments(int argc, char **argv, bool &exit_app) override;
+  void OnClock(unsigned long sim_time) override;
+  unsigned long GetNextWakeCycle(unsigned long cycle) override;
+  void PostExec() override;
+
+ private:
+  // Handle one complete request, where data holds the len bytes to write for
+  // kOpWrite. Returns the response.
+  std::vector<uint8_t> HandleRequest(uint8_t op, uint32_t addr, uint32_t len,
+                                     const uint8_t *data);
+
+  DpiMemUtil *mem_util_;
+  struct tcp_server_ctx *server_;
+  unsigned long interval_;
+
+  // Bytes received that don't yet make up a complete request
+  std::vector<uint8_t> rx_;
+};
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_CPP_VERILATOR_MEM_BACKDOOR_H_
@@ -182,7 +182,9 @@ bool VerilatorMemUtil::ParseCLIArguments(int argc, char **argv,
                                       arg.type);
       } else {
         assert(arg.type == kMemImageElf);
-        mem_util_->LoadElfToMemories(verbose, arg.filepath);
+        // We only write the staged data to memories, so there's no need to
+        // copy it out of the ELF file.
+        mem_util_->LoadElfToMemories(verbose, arg.filepath, /*map_file=*/true);
       }
     } catch (const std::exception &err) {
       std::cerr << "ERROR: " << err.what() << std::endl;
@@ -192,3 +194,38 @@ bool VerilatorMemUtil::ParseCLIArguments(int argc, char **argv,
 
   return true;
 }
+
+// Memory contents for a checkpoint are stored next to the checkpoint itself.
+static std::string MemSnapshotPath(const std::string &checkpoint_path) {
+  return checkpoint_path + ".mem";
+}
+
+bool VerilatorMemUtil::SaveCheckpoint(const std::string &path) {
+  try {
+    mem_util_->SaveMemSnapshot(MemSnapshotPath(path));
+  } catch (const std::exception &err) {
+    std::cerr << "ERROR: " << err.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool VerilatorMemUtil::RestoreCheckpoint(const std::string &path) {
+  try {
+    mem_util_->RestoreMemSnapshot(MemSnapshotPath(path));
+  } catch (const std::exception &err) {
+    std::cerr << "ERROR: " << err.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool VerilatorMemUtil::PrepareBatchTest(const std::string &image) {
+  try {
+    mem_util_->LoadElfToMemories(false, image, /*map_file=*/true);
+  } catch (const std::exception &err) {
+    std::cerr << "ERROR: " << err.what() << std::endl;
+    return false;
+  }
+  return true;
+}
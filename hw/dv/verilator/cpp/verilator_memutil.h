@@ -22,6 +22,14 @@ class VerilatorMemUtil : public SimCtrlExtension {
 
   // Declared in SimCtrlExtension
   bool ParseCLIArguments(int argc, char **argv, bool &exit_app) override;
+  bool SaveCheckpoint(const std::string &path) override;
+  bool RestoreCheckpoint(const std::string &path) override;
+  bool PrepareBatchTest(const std::string &image) override;
+
+  // All memory loading happens before the simulation starts
+  unsigned long GetNextWakeCycle(unsigned long cycle) override {
+    return kNeverWake;
+  }
 
   // Get underlying DpiMemUtil object
   DpiMemUtil *GetUnderlying() { return mem_util_; }
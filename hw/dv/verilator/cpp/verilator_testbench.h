@@ -0,0 +1,325 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Copyright IAIK.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_DV_VERILATOR_CPP_VERILATOR_TESTBENCH_H_
+#define OPENTITAN_HW_DV_VERILATOR_CPP_VERILATOR_TESTBENCH_H_
+
+// A minimal header-only harness for Verilated modules with a clk_i / rst_ni
+// pair, for small benches (such as the ALMA leakage flows) that drive the
+// model directly rather than through VerilatorSimCtrl.
+//
+// Tracing is chosen at compile time. It is compiled in when TESTBENCH_TRACE
+// is 1, which defaults to the VM_TRACE setting from Verilator (or to 1 if
+// that isn't defined). Build with -DTESTBENCH_TRACE=0 to remove all tracing
+// code from tick(), in which case opentrace() does nothing. As in
+// verilated_toplevel.h, define VM_TRACE_FMT_FST (and Verilate with
+// --trace-fst) to write FST rather than VCD.
+//
+// run_testbench() runs a bench once, or forks many independent runs with
+// different seeds across the host's cores (see below).
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "verilated.h"
+
+#ifndef TESTBENCH_TRACE
+#ifdef VM_TRACE
+#define TESTBENCH_TRACE VM_TRACE
+#else
+#define TESTBENCH_TRACE 1
+#endif
+#endif
+
+#if TESTBENCH_TRACE
+#ifdef VM_TRACE_FMT_FST
+#include "verilated_fst_c.h"
+#define TESTBENCH_TRACE_CLASS VerilatedFstC
+#define TESTBENCH_TRACE_EXT ".fst"
+#else
+#include "verilated_vcd_c.h"
+#define TESTBENCH_TRACE_CLASS VerilatedVcdC
+#define TESTBENCH_TRACE_EXT ".vcd"
+#endif
+#else
+#define TESTBENCH_TRACE_EXT ".vcd"
+#endif
+
+template <class Module>
+struct Testbench {
+  unsigned long m_tickcount;
+  Module m_core;
+#if TESTBENCH_TRACE
+  TESTBENCH_TRACE_CLASS *m_trace = NULL;
+#endif
+
+  // Source of random stimulus for run_throughput() and stimulus(). Seeded
+  // with a fixed value so that runs are repeatable.
+  std::mt19937_64 m_rng;
+
+  // Whether stimulus() returns random values rather than the fixed ones
+  bool m_random_stimulus;
+
+  Testbench() : m_tickcount(0ul), m_rng(1), m_random_stimulus(false) {
+#if TESTBENCH_TRACE
+    Verilated::traceEverOn(true);
+#endif
+  }
+
+  ~Testbench() { closetrace(); }
+
+  void opentrace(const char *name) {
+#if TESTBENCH_TRACE
+    if (!m_trace) {
+      m_trace = new TESTBENCH_TRACE_CLASS;
+      m_core.trace(m_trace, 99);
+      m_trace->open(name);
+    }
+#endif
+  }
+
+  void closetrace() {
+#if TESTBENCH_TRACE
+    if (m_trace) {
+      m_trace->close();
+      delete m_trace;
+      m_trace = NULL;
+    }
+#endif
+  }
+
+  void reset() {
+    m_core.rst_ni = 0;
+    this->tick();
+    this->tick();
+    m_core.rst_ni = 1;
+  }
+
+  void tick() {
+    // Falling edge
+    m_core.clk_i = 0;
+    m_core.eval();
+#if TESTBENCH_TRACE
+    if (m_trace)
+      m_trace->dump(20 * m_tickcount);
+#endif
+
+    // Rising edge
+    m_core.clk_i = 1;
+    m_core.eval();
+#if TESTBENCH_TRACE
+    if (m_trace)
+      m_trace->dump(20 * m_tickcount + 10);
+#endif
+
+    // Falling edge settle eval
+    m_core.clk_i = 0;
+    m_core.eval();
+
+    // The trace is flushed when it is closed, rather than after every cycle.
+    m_tickcount++;
+  }
+
+  bool done() { return Verilated::gotFinish(); }
+
+  uint64_t random() { return m_rng(); }
+
+  /**
+   * The value to drive onto an input of the given width in bits
+   *
+   * This is fixed unless m_random_stimulus is set, in which case it is drawn
+   * from random() and truncated to the width, since Verilator expects the
+   * bits above the width of a port to be zero.
+   */
+  template <typename T>
+  T stimulus(T fixed, unsigned bits) {
+    if (!m_random_stimulus) {
+      return fixed;
+    }
+    uint64_t value = random();
+    if (bits < 64) {
+      value &= (uint64_t(1) << bits) - 1;
+    }
+    return static_cast<T>(value);
+  }
+
+  /**
+   * Run num_vectors test vectors back to back, as fast as possible
+   *
+   * run_vector(*this, i) is called for each vector. It should drive random
+   * inputs (for example from random()) and tick() until the vector is done.
+   * At the end, this prints the number of cycles and the cycles per second of
+   * wall-clock time, which is also returned. Whether each cycle is traced
+   * depends on whether opentrace() was called.
+   */
+  template <typename RunVector>
+  double run_throughput(unsigned long num_vectors, RunVector run_vector) {
+    unsigned long start_tick = m_tickcount;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < num_vectors && !done(); ++i) {
+      run_vector(*this, i);
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    unsigned long cycles = m_tickcount - start_tick;
+    double cycles_per_s =
+        elapsed.count() > 0 ? cycles / elapsed.count() : 0.0;
+    std::cout << num_vectors << " vectors, " << cycles << " cycles in "
+              << elapsed.count() << " s (" << cycles_per_s << " cycles/s)"
+              << std::endl;
+    return cycles_per_s;
+  }
+};
+
+/**
+ * Run a bench once, or many times in parallel
+ *
+ * run(tb) drives a fresh Testbench<Module> through one run, taking its data
+ * from tb.stimulus(). The runs are set up by plusargs:
+ *
+ *   +runs=N  Fork N independent runs, at most +jobs=J (default: the number of
+ *            online CPUs) at a time, each with its own model and trace.
+ *   +seed=S  Seed run i with S + i (default 1) and drive random stimulus.
+ *
+ * Without +runs, there is a single run in this process, traced to
+ * <trace_base>.vcd (or .fst), and the stimulus is only random if +seed is
+ * given. With +runs, run i is traced to <trace_base>_<i>.vcd and always has
+ * random stimulus. Once all runs have finished, the seed, trace, number of
+ * cycles and exit status of each are written to <trace_base>_runs.csv, so
+ * that the traces can be handed to the analysis independently.
+ *
+ * Returns 0 if all runs succeeded, for use as the exit status of main().
+ */
+template <class Module, typename Run>
+int run_testbench(const std::string &trace_base, Run run) {
+  // name includes the "=", and a match also includes the leading "+"
+  auto plusarg = [](const char *name, unsigned long dflt, bool *given) {
+    std::string match = Verilated::commandArgsPlusMatch(name);
+    if (given) {
+      *given = !match.empty();
+    }
+    return match.empty()
+               ? dflt
+               : strtoul(match.c_str() + strlen(name) + 1, nullptr, 0);
+  };
+
+  bool parallel = false, seeded = false;
+  unsigned long runs = plusarg("runs=", 1, &parallel);
+  unsigned long seed = plusarg("seed=", 1, &seeded);
+  long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned long jobs = plusarg("jobs=", num_cpus > 0 ? num_cpus : 1, nullptr);
+  if (jobs == 0) {
+    jobs = 1;
+  }
+
+  // One run, which returns the number of cycles
+  auto run_one = [&](const std::string &trace, uint64_t run_seed,
+                     bool random_stimulus) {
+    Testbench<Module> tb;
+    tb.m_rng.seed(run_seed);
+    tb.m_random_stimulus = random_stimulus;
+    tb.opentrace(trace.c_str());
+    run(tb);
+    tb.closetrace();
+    return tb.m_tickcount;
+  };
+
+  if (!parallel) {
+    run_one(trace_base + TESTBENCH_TRACE_EXT, seed, seeded);
+    return 0;
+  }
+
+  struct RunInfo {
+    std::string trace;
+    unsigned long cycles;
+    std::string status;
+  };
+  std::vector<RunInfo> infos(runs);
+  std::map<pid_t, unsigned long> active;
+
+  // The children each report their cycle count through a small file next to
+  // their trace, which is removed once it has been read.
+  unsigned long next = 0;
+  while (next < runs || !active.empty()) {
+    if (next < runs && active.size() < jobs) {
+      RunInfo &info = infos[next];
+      info.trace =
+          trace_base + "_" + std::to_string(next) + TESTBENCH_TRACE_EXT;
+      info.cycles = 0;
+
+      std::cout.flush();
+      fflush(stdout);
+      pid_t pid = fork();
+      if (pid == 0) {
+        unsigned long cycles = run_one(info.trace, seed + next, true);
+        std::ofstream(info.trace + ".cycles") << cycles << "\n";
+        std::cout.flush();
+        _exit(0);
+      }
+      if (pid < 0) {
+        perror("fork");
+        info.status = "fork failed";
+      } else {
+        active[pid] = next;
+      }
+      ++next;
+      continue;
+    }
+
+    int wstatus;
+    pid_t pid = waitpid(-1, &wstatus, 0);
+    if (pid < 0) {
+      perror("waitpid");
+      break;
+    }
+    auto it = active.find(pid);
+    if (it == active.end()) {
+      continue;
+    }
+    RunInfo &info = infos[it->second];
+    active.erase(it);
+
+    if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) {
+      info.status = "ok";
+    } else if (WIFSIGNALED(wstatus)) {
+      info.status = "signal " + std::to_string(WTERMSIG(wstatus));
+    } else {
+      info.status = "exit " + std::to_string(WEXITSTATUS(wstatus));
+    }
+    std::string cycles_path = info.trace + ".cycles";
+    std::ifstream(cycles_path) >> info.cycles;
+    remove(cycles_path.c_str());
+  }
+
+  unsigned long num_failed = 0;
+  std::string csv_path = trace_base + "_runs.csv";
+  std::ofstream csv(csv_path);
+  csv << "run,seed,trace,cycles,status\n";
+  for (unsigned long i = 0; i < runs; ++i) {
+    const RunInfo &info = infos[i];
+    csv << i << "," << seed + i << "," << info.trace << "," << info.cycles
+        << "," << (info.status.empty() ? "not run" : info.status) << "\n";
+    num_failed += info.status != "ok";
+  }
+  csv.close();
+
+  std::cout << runs - num_failed << " of " << runs << " runs succeeded, see "
+            << csv_path << std::endl;
+  return num_failed ? 1 : 0;
+}
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_CPP_VERILATOR_TESTBENCH_H_
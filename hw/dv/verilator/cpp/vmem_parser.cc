@@ -0,0 +1,307 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "vmem_parser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// Files smaller than this are parsed on a single thread, and no thread gets
+// less than this much text to parse.
+const size_t kMinChunkBytes = 1 << 20;
+
+// A run of words parsed from a chunk. If has_addr is false, the run continues
+// from wherever the previous chunk left off.
+struct ChunkRun {
+  bool has_addr;
+  uint32_t addr;
+  uint32_t num_words;
+  std::vector<uint8_t> data;
+};
+
+struct ChunkResult {
+  std::vector<ChunkRun> runs;
+  uint32_t max_word_digits = 0;
+  // The number of lines in the chunk
+  size_t num_lines = 0;
+  // True if the chunk ended inside a block comment. In that case, the rest of
+  // the results are not valid.
+  bool open_comment = false;
+  // If error is nonempty, it describes a syntax error on error_line (counting
+  // from zero at the start of the chunk).
+  std::string error;
+  size_t error_line = 0;
+};
+
+int HexDigitValue(char c) {
+  if ('0' <= c && c <= '9')
+    return c - '0';
+  if ('a' <= c && c <= 'f')
+    return c - 'a' + 10;
+  if ('A' <= c && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+         c == '\v';
+}
+
+// Parse the text in [begin, end)
+ChunkResult ParseChunk(const char *begin, const char *end,
+                       uint32_t word_bytes) {
+  ChunkResult res;
+  const char *p = begin;
+
+  auto fail = [&](const std::string &msg) {
+    res.error = msg;
+    res.error_line = res.num_lines;
+    return res;
+  };
+
+  while (p < end) {
+    char c = *p;
+
+    if (IsSpace(c)) {
+      res.num_lines += (c == '\n');
+      ++p;
+      continue;
+    }
+
+    if (c == '/' && p + 1 < end && p[1] == '/') {
+      p = std::find(p, end, '\n');
+      continue;
+    }
+
+    if (c == '/' && p + 1 < end && p[1] == '*') {
+      const char *close = nullptr;
+      for (const char *q = p + 2; q + 1 < end; ++q) {
+        if (q[0] == '*' && q[1] == '/') {
+          close = q;
+          break;
+        }
+      }
+      if (!close) {
+        res.open_comment = true;
+        return res;
+      }
+      res.num_lines += std::count(p, close, '\n');
+      p = close + 2;
+      continue;
+    }
+
+    bool is_addr = (c == '@');
+    const char *tok = is_addr ? p + 1 : p;
+    const char *tok_end = tok;
+    while (tok_end < end && HexDigitValue(*tok_end) >= 0) {
+      ++tok_end;
+    }
+    if (tok_end == tok) {
+      std::ostringstream oss;
+      oss << "unexpected character `" << *tok << "'.";
+      return fail(oss.str());
+    }
+    if (tok_end < end && !IsSpace(*tok_end) && *tok_end != '/') {
+      std::ostringstream oss;
+      oss << "unexpected character `" << *tok_end << "' in "
+          << (is_addr ? "address" : "data word") << ".";
+      return fail(oss.str());
+    }
+
+    // Skip leading zeros when looking at the width of the value
+    const char *sig = tok;
+    while (sig + 1 < tok_end && *sig == '0') {
+      ++sig;
+    }
+    size_t sig_digits = tok_end - sig;
+
+    if (is_addr) {
+      if (sig_digits > 8) {
+        return fail("address doesn't fit in 32 bits.");
+      }
+      uint32_t addr = 0;
+      for (const char *q = sig; q < tok_end; ++q) {
+        addr = (addr << 4) | HexDigitValue(*q);
+      }
+      res.runs.push_back({true, addr, 0, {}});
+    } else {
+      // Each pair of hex digits is a byte, with the least significant pair at
+      // the end of the token.
+      int msd = HexDigitValue(*sig);
+      size_t value_bits = 4 * (sig_digits - 1) + (msd >= 8   ? 4
+                                                   : msd >= 4 ? 3
+                                                   : msd >= 2 ? 2
+                                                              : 1);
+      if (value_bits > 8 * word_bytes) {
+        std::ostringstream oss;
+        oss << "data word is wider than the " << 8 * word_bytes
+            << "-bit words of the memory.";
+        return fail(oss.str());
+      }
+
+      if (res.runs.empty()) {
+        res.runs.push_back({false, 0, 0, {}});
+      }
+      ChunkRun &run = res.runs.back();
+      size_t base = run.data.size();
+      run.data.resize(base + word_bytes, 0);
+      size_t idx = 0;
+      for (const char *q = tok_end; q > sig; ++idx) {
+        int lo = HexDigitValue(*--q);
+        int hi = (q > sig) ? HexDigitValue(*--q) : 0;
+        run.data[base + idx] = (hi << 4) | lo;
+      }
+      ++run.num_words;
+
+      res.max_word_digits =
+          std::max(res.max_word_digits, (uint32_t)(tok_end - tok));
+    }
+
+    p = tok_end;
+  }
+
+  return res;
+}
+
+// Split [text, text + len) into up to num_chunks pieces, breaking after
+// newlines so that no token is split. Returns the start of each piece, followed
+// by the end of the text.
+std::vector<const char *> SplitChunks(const char *text, size_t len,
+                                      unsigned num_chunks) {
+  std::vector<const char *> bounds = {text};
+  const char *end = text + len;
+  for (unsigned i = 1; i < num_chunks; ++i) {
+    const char *guess = text + (len * i) / num_chunks;
+    if (guess <= bounds.back())
+      continue;
+    const char *nl = std::find(guess, end, '\n');
+    if (nl == end)
+      break;
+    bounds.push_back(nl + 1);
+  }
+  bounds.push_back(end);
+  return bounds;
+}
+
+unsigned PickNumThreads(size_t len) {
+  unsigned hw_threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t by_size = std::max((size_t)1, len / kMinChunkBytes);
+  return (unsigned)std::min((size_t)hw_threads, by_size);
+}
+}  // namespace
+
+VmemImage ParseVmem(const std::string &name, const char *text, size_t len,
+                    uint32_t word_bytes, unsigned num_threads) {
+  if (!num_threads) {
+    num_threads = PickNumThreads(len);
+  }
+
+  std::vector<const char *> bounds = SplitChunks(text, len, num_threads);
+  size_t num_chunks = bounds.size() - 1;
+  std::vector<ChunkResult> results(num_chunks);
+
+  if (num_chunks == 1) {
+    results[0] = ParseChunk(bounds[0], bounds[1], word_bytes);
+  } else {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_chunks; ++i) {
+      threads.emplace_back([&, i]() {
+        results[i] = ParseChunk(bounds[i], bounds[i + 1], word_bytes);
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+
+    // A block comment that spans chunks confuses the parallel parse: the chunk
+    // after it will have been parsed as if it wasn't in a comment. Such
+    // comments are rare in vmem files, so just parse everything again in order.
+    for (const ChunkResult &res : results) {
+      if (res.open_comment) {
+        results.assign(1, ParseChunk(text, text + len, word_bytes));
+        num_chunks = 1;
+        break;
+      }
+    }
+  }
+
+  VmemImage image = {word_bytes, 0, {}};
+  size_t line_base = 0;
+  uint32_t addr = 0;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    ChunkResult &res = results[i];
+    if (!res.error.empty() || res.open_comment) {
+      std::ostringstream oss;
+      oss << "Failed to parse vmem file `" << name << "' at line "
+          << line_base + res.error_line + 1 << ": "
+          << (res.open_comment ? "unterminated block comment." : res.error);
+      throw std::runtime_error(oss.str());
+    }
+
+    image.max_word_digits =
+        std::max(image.max_word_digits, res.max_word_digits);
+
+    for (ChunkRun &run : res.runs) {
+      if (run.has_addr) {
+        addr = run.addr;
+      }
+      if (!run.num_words) {
+        continue;
+      }
+      if ((uint64_t)addr + run.num_words > ((uint64_t)1 << 32)) {
+        std::ostringstream oss;
+        oss << "Failed to parse vmem file `" << name
+            << "': data runs past the end of the 32-bit address space.";
+        throw std::runtime_error(oss.str());
+      }
+
+      VmemSegment *prev =
+          image.segments.empty() ? nullptr : &image.segments.back();
+      if (prev && prev->word_offset + prev->data.size() / word_bytes == addr) {
+        prev->data.insert(prev->data.end(), run.data.begin(), run.data.end());
+      } else {
+        image.segments.push_back({addr, std::move(run.data)});
+      }
+      addr += run.num_words;
+    }
+
+    line_base += res.num_lines;
+  }
+
+  return image;
+}
+
+VmemImage ParseVmemFile(const std::string &path, uint32_t word_bytes,
+                        unsigned num_threads) {
+  std::ifstream is(path, std::ios::binary);
+  if (!is) {
+    throw std::runtime_error("Could not open vmem file at `" + path + "'.");
+  }
+  std::ostringstream contents;
+  contents << is.rdbuf();
+  std::string text = contents.str();
+
+  return ParseVmem(path, text.data(), text.size(), word_bytes, num_threads);
+}
+
+void CheckVmemFits(const std::string &path, const VmemImage &image,
+                   uint32_t num_words) {
+  for (const VmemSegment &seg : image.segments) {
+    uint64_t seg_end =
+        (uint64_t)seg.word_offset + seg.data.size() / image.word_bytes;
+    if (seg_end > num_words) {
+      std::ostringstream oss;
+      oss << "Vmem file `" << path << "' has data for words up to 0x"
+          << std::hex << seg_end - 1 << ", but the memory only has 0x"
+          << num_words << " words.";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
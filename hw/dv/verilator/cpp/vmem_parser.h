@@ -0,0 +1,63 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_VERILATOR_CPP_VMEM_PARSER_H_
+#define OPENTITAN_HW_DV_VERILATOR_CPP_VMEM_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A run of consecutive words from a vmem file. The data holds the words in
+// order, each stored as a little-endian number in VmemImage::word_bytes bytes.
+struct VmemSegment {
+  uint32_t word_offset;
+  std::vector<uint8_t> data;
+};
+
+// The parsed contents of a vmem file.
+//
+// Segments are sorted by the order in which they appear in the file (which is
+// normally, but not necessarily, address order). Adjacent runs of words are
+// merged into a single segment.
+struct VmemImage {
+  uint32_t word_bytes;
+  // The number of hex digits in the widest word in the file. This is used to
+  // guess whether a file for a memory with integrity bits includes them.
+  uint32_t max_word_digits;
+  std::vector<VmemSegment> segments;
+};
+
+/**
+ * Parse a vmem file in the format accepted by $readmemh.
+ *
+ * Each word in the file is parsed into word_bytes bytes. Addresses (given with
+ * @ADDR) are in words. Both // line comments and block comments are supported.
+ * Large files are split into chunks of lines that are parsed by up to
+ * num_threads threads (0 means pick a number based on the file size and the
+ * number of CPUs).
+ *
+ * If the file can't be read, has a syntax error or contains a word that
+ * doesn't fit in word_bytes bytes, throws a std::runtime_error saying what
+ * went wrong.
+ */
+VmemImage ParseVmemFile(const std::string &path, uint32_t word_bytes,
+                        unsigned num_threads = 0);
+
+/**
+ * Parse len bytes of vmem text. This is like ParseVmemFile, but takes the text
+ * directly. The name is only used in error messages.
+ */
+VmemImage ParseVmem(const std::string &name, const char *text, size_t len,
+                    uint32_t word_bytes, unsigned num_threads = 0);
+
+/**
+ * Check that every segment of image fits in a memory of num_words words,
+ * throwing a std::runtime_error that mentions path if not.
+ */
+void CheckVmemFits(const std::string &path, const VmemImage &image,
+                   uint32_t num_words);
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_CPP_VMEM_PARSER_H_
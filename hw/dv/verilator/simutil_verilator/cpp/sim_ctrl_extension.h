@@ -5,6 +5,19 @@
 #ifndef OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_SIM_CTRL_EXTENSION_H_
 #define OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_SIM_CTRL_EXTENSION_H_
 
+#include <string>
+
+/**
+ * A hook into the VerilatorSimCtrl simulation loop
+ *
+ * All of the methods are called from the thread that calls
+ * VerilatorSimCtrl::Exec, and never while the model is being evaluated, even
+ * if it was Verilated with --threads. They can therefore access the model and
+ * call exported DPI functions without locking. DPI imports are different:
+ * with --threads they can be called from any of Verilator's threads, so state
+ * that they share with an extension must be handed over safely (as tcp_server
+ * does for its buffers).
+ */
 class SimCtrlExtension {
  public:
   virtual ~SimCtrlExtension() = default;
@@ -29,6 +42,58 @@ class SimCtrlExtension {
     return true;
   }
 
+  /**
+   * Save extension state for a checkpoint
+   *
+   * Called by the simulation controller when it saves a checkpoint (see the
+   * --checkpoint-save option). The controller itself writes the Verilated
+   * model state to |path|, so an extension that needs to store state should
+   * write it to a file of its own, named by adding a suffix to |path|.
+   *
+   * @param path Path of the checkpoint file that is being written
+   * @return Return code, true == success
+   */
+  virtual bool SaveCheckpoint(const std::string &path) { return true; }
+
+  /**
+   * Restore extension state from a checkpoint
+   *
+   * Called by the simulation controller when it restores a checkpoint (see the
+   * --checkpoint-restore option). This happens while parsing command line
+   * arguments, before ParseCLIArguments() is called for any extension, so
+   * anything loaded because of command line arguments will be applied on top
+   * of the restored state.
+   *
+   * @param path Path of the checkpoint file that was passed to SaveCheckpoint()
+   * @return Return code, true == success
+   */
+  virtual bool RestoreCheckpoint(const std::string &path) { return true; }
+
+  /**
+   * Prepare for the next test in batch mode
+   *
+   * When the simulation controller runs a batch of tests (see the --batch
+   * option), this is called before each test with the image for that test.
+   * The design is reset after this returns, so extensions can use it to load
+   * memories or clear state left over from the previous test.
+   *
+   * @param image Path of the image for the test
+   * @return Return code, true == success. If any extension fails, the test is
+   *         marked as failed and not run.
+   */
+  virtual bool PrepareBatchTest(const std::string &image) { return true; }
+
+  /**
+   * Called at the end of each test in batch mode
+   *
+   * This is called with the same image as the matching PrepareBatchTest(),
+   * after the test has finished (or failed to load).
+   *
+   * @param image Path of the image for the test
+   * @param passed True if the test passed
+   */
+  virtual void FinishBatchTest(const std::string &image, bool passed) {}
+
   /**
    * Function to be called prior to executing the simulation
    */
@@ -36,9 +101,31 @@ class SimCtrlExtension {
 
   /**
    * Function to be called every clock cycle
+   *
+   * This is called on the rising edge of the clock. By default, this happens
+   * on every cycle. Extensions that only need to act occasionally can override
+   * GetNextWakeCycle() to be called less often.
    */
   virtual void OnClock(unsigned long sim_time) {}
 
+  /**
+   * Get the cycle of the next call to OnClock()
+   *
+   * This is called after each call to OnClock() and is passed the cycle (not
+   * the simulation time) of that call. The result must be greater than
+   * |cycle|. Return kNeverWake if the extension doesn't need OnClock() to be
+   * called again. The first call to OnClock() happens on the first cycle of
+   * the simulation.
+   *
+   * @param cycle The cycle of the call to OnClock() that just finished
+   * @return The cycle of the next call
+   */
+  virtual unsigned long GetNextWakeCycle(unsigned long cycle) {
+    return cycle + 1;
+  }
+
+  static const unsigned long kNeverWake = ~0UL;
+
   /**
    * Function to be called after executing the simulation
    */
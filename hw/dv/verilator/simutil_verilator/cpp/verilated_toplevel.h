@@ -9,6 +9,7 @@
 #error "TOPLEVEL_NAME must be set to the name of the toplevel."
 #endif
 
+#include <string>
 #include <verilated.h>
 
 #define STR(s) #s
@@ -43,6 +44,16 @@
 #endif
 #endif
 
+// VM_SAVABLE must be set by the user (as 1) when calling Verilator with
+// --savable. This enables saving and restoring checkpoints of the model state.
+#ifndef VM_SAVABLE
+#define VM_SAVABLE 0
+#endif
+
+#if VM_SAVABLE == 1
+#include "verilated_save.h"
+#endif
+
 #if VM_TRACE == 1
 /**
  * "Base" for all tracers in Verilator with common functionality
@@ -67,6 +78,10 @@ class VerilatedTracer {
 
   void dump(vluint64_t timeui) { impl_->dump(timeui); }
 
+  void dumpvars(int level, const std::string &hier) {
+    impl_->dumpvars(level, hier);
+  }
+
   operator VM_TRACE_CLASS_NAME *() const {
     assert(impl_);
     return impl_;
@@ -87,6 +102,7 @@ class VerilatedTracer {
   void open(const char *filename){};
   void close(){};
   void dump(vluint64_t timeui) {}
+  void dumpvars(int level, const std::string &hier) {}
 };
 #endif  // VM_TRACE == 1
 
@@ -122,6 +138,10 @@ class VerilatedToplevel {
   virtual void final() = 0;
   virtual const char *name() const = 0;
   virtual void trace(VerilatedTracer &tfp, int levels, int options) = 0;
+#if VM_SAVABLE == 1
+  virtual void save(VerilatedSave &os) = 0;
+  virtual void restore(VerilatedRestore &os) = 0;
+#endif
 
   /**
    * Get the Verilator-generated device under test
@@ -150,6 +170,14 @@ class TOPLEVEL_NAME : public VERILATED_TOPLEVEL_NAME, public VerilatedToplevel {
     assert(0 && "Tracing not enabled.");
 #endif
   }
+#if VM_SAVABLE == 1
+  void save(VerilatedSave &os) {
+    os << *static_cast<VERILATED_TOPLEVEL_NAME *>(this);
+  }
+  void restore(VerilatedRestore &os) {
+    os >> *static_cast<VERILATED_TOPLEVEL_NAME *>(this);
+  }
+#endif
 };
 
 #endif  // OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_VERILATED_TOPLEVEL_H_
@@ -4,12 +4,22 @@
 
 #include "verilator_sim_ctrl.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <fstream>
 #include <getopt.h>
+#include <iomanip>
 #include <iostream>
 #include <signal.h>
+#include <string>
+#include <sys/resource.h>
 #include <sys/stat.h>
+#include <typeinfo>
 #include <verilated.h>
 
+#include "dpi_profile.h"
+
 // This is defined by Verilator and passed through the command line
 #ifndef VM_TRACE
 #define VM_TRACE 0
@@ -111,9 +121,22 @@ bool VerilatorSimCtrl::ParseCommandArgs(int argc, char **argv, bool &exit_app) {
   const struct option long_options[] = {
       {"term-after-cycles", required_argument, nullptr, 'c'},
       {"trace", optional_argument, nullptr, 't'},
+      {"trace-start", required_argument, nullptr, 'A'},
+      {"trace-stop", required_argument, nullptr, 'O'},
+      {"trace-scope", required_argument, nullptr, 'P'},
+      {"trace-flight-recorder", required_argument, nullptr, 'F'},
+      {"checkpoint-save", required_argument, nullptr, 'S'},
+      {"checkpoint-cycle", required_argument, nullptr, 'N'},
+      {"checkpoint-restore", required_argument, nullptr, 'R'},
+      {"profile", required_argument, nullptr, 'p'},
+      {"batch", required_argument, nullptr, 'B'},
+      {"uart-backdoor", no_argument, nullptr, 'U'},
       {"help", no_argument, nullptr, 'h'},
       {nullptr, no_argument, nullptr, 0}};
 
+  bool trace_options_used = false;
+  bool uart_backdoor = false;
+
   while (1) {
     int c = getopt_long(argc, argv, "-:c:th", long_options, nullptr);
     if (c == -1) {
@@ -139,12 +162,65 @@ bool VerilatorSimCtrl::ParseCommandArgs(int argc, char **argv, bool &exit_app) {
         }
         TraceOn();
         break;
+      case 'A':
+        if (!read_ul_arg(&trace_start_cycle_, "trace-start", optarg)) {
+          exit_app = true;
+          return false;
+        }
+        trace_start_set_ = true;
+        trace_options_used = true;
+        break;
+      case 'O':
+        if (!read_ul_arg(&trace_stop_cycle_, "trace-stop", optarg)) {
+          exit_app = true;
+          return false;
+        }
+        trace_options_used = true;
+        break;
+      case 'P':
+        trace_scopes_.push_back(optarg);
+        trace_options_used = true;
+        break;
+      case 'F':
+        if (!read_ul_arg(&flight_recorder_cycles_, "trace-flight-recorder",
+                         optarg)) {
+          exit_app = true;
+          return false;
+        }
+        trace_options_used = true;
+        break;
       case 'c':
         if (!read_ul_arg(&term_after_cycles_, "term-after-cycles", optarg)) {
           exit_app = true;
           return false;
         }
         break;
+      case 'S':
+        checkpoint_save_path_.assign(optarg);
+        break;
+      case 'N':
+        if (!read_ul_arg(&checkpoint_cycle_, "checkpoint-cycle", optarg)) {
+          exit_app = true;
+          return false;
+        }
+        checkpoint_cycle_set_ = true;
+        break;
+      case 'R':
+        checkpoint_restore_path_.assign(optarg);
+        break;
+      case 'p':
+        profile_path_.assign(optarg);
+        dpi_profile_set_enabled(true);
+        break;
+      case 'B':
+        if (!ReadBatchFile(optarg)) {
+          exit_app = true;
+          return false;
+        }
+        break;
+      case 'U':
+        uart_backdoor = true;
+        break;
       case 'h':
         PrintHelp();
         exit_app = true;
@@ -160,12 +236,50 @@ bool VerilatorSimCtrl::ParseCommandArgs(int argc, char **argv, bool &exit_app) {
     }
   }
 
-  // Pass args to verilator
-  Verilated::commandArgs(argc, argv);
+  if (trace_options_used && !tracing_possible_) {
+    std::cerr << "ERROR: Tracing has not been enabled at compile time."
+              << std::endl;
+    exit_app = true;
+    return false;
+  }
+  if (trace_start_set_ && trace_stop_cycle_ &&
+      trace_stop_cycle_ <= trace_start_cycle_) {
+    std::cerr << "ERROR: --trace-stop must be after --trace-start."
+              << std::endl;
+    exit_app = true;
+    return false;
+  }
+  // A flight recorder with no explicit window traces from the start.
+  if (flight_recorder_cycles_ && !trace_start_set_) {
+    TraceOn();
+  }
+
+  // Pass args to verilator, turning --uart-backdoor into the plusarg that
+  // uartdpi looks for. In batch mode, also ask the testbench to $stop when
+  // software reports a failure, so that RunBatch can record it.
+  std::vector<const char *> verilator_args(argv, argv + argc);
+  if (uart_backdoor) {
+    verilator_args.push_back("+UARTDPI_BACKDOOR");
+  }
+  if (!batch_images_.empty()) {
+    verilator_args.push_back("+STOP_ON_SW_TEST_FAIL");
+  }
+  Verilated::commandArgs(static_cast<int>(verilator_args.size()),
+                         verilator_args.data());
+
+  // Restore any checkpoint before extensions parse their arguments, so that
+  // memory images given on the command line are loaded on top of it.
+  if (!exit_app && !checkpoint_restore_path_.empty() && !RestoreCheckpoint()) {
+    exit_app = true;
+    return false;
+  }
 
   // Parse arguments for all registered extensions
-  for (auto it = extension_array_.begin(); it != extension_array_.end(); ++it) {
-    if (!(*it)->ParseCLIArguments(argc, argv, exit_app)) {
+  for (size_t i = 0; i < extension_array_.size(); ++i) {
+    auto start = std::chrono::steady_clock::now();
+    bool parsed = extension_array_[i]->ParseCLIArguments(argc, argv, exit_app);
+    extension_clock_[i].setup_time += std::chrono::steady_clock::now() - start;
+    if (!parsed) {
       exit_app = true;
       return false;
       if (exit_app) {
@@ -197,11 +311,20 @@ void VerilatorSimCtrl::RunSimulation() {
   }
   // Print simulation speed info
   PrintStatistics();
+  if (!profile_path_.empty() && !WriteProfile()) {
+    simulation_success_ = false;
+  }
   // Print helper message for tracing
   if (TracingEverEnabled()) {
     std::cout << std::endl
-              << "You can view the simulation traces by calling" << std::endl
-              << "$ gtkwave " << GetTraceFileName() << std::endl;
+              << "You can view the simulation traces by calling" << std::endl;
+    int trace_size_byte;
+    std::string older_segment =
+        GetTraceSegmentFileName(flight_recorder_segment_ ^ 1);
+    if (flight_recorder_cycles_ && FileSize(older_segment, trace_size_byte)) {
+      std::cout << "$ gtkwave " << older_segment << std::endl;
+    }
+    std::cout << "$ gtkwave " << GetTraceFileName() << std::endl;
   }
 }
 
@@ -224,6 +347,9 @@ void VerilatorSimCtrl::RequestStop(bool simulation_success) {
 
 void VerilatorSimCtrl::RegisterExtension(SimCtrlExtension *ext) {
   extension_array_.push_back(ext);
+  extension_clock_.push_back({/*next_wake_cycle=*/0, /*num_calls=*/0,
+                              std::chrono::steady_clock::duration::zero(),
+                              std::chrono::steady_clock::duration::zero()});
 }
 
 VerilatorSimCtrl::VerilatorSimCtrl()
@@ -238,12 +364,54 @@ VerilatorSimCtrl::VerilatorSimCtrl()
       tracing_enabled_changed_(false),
       tracing_ever_enabled_(false),
       tracing_possible_(VM_TRACE),
+      trace_start_set_(false),
+      trace_start_cycle_(0),
+      trace_stop_cycle_(0),
+      flight_recorder_cycles_(0),
+      flight_recorder_segment_(0),
+      flight_recorder_segment_start_(0),
       initial_reset_delay_cycles_(2),
       reset_duration_cycles_(2),
       request_stop_(false),
       simulation_success_(true),
       tracer_(VerilatedTracer()),
-      term_after_cycles_(0) {
+      term_after_cycles_(0),
+      checkpoint_cycle_set_(false),
+      checkpoint_cycle_(0),
+      eval_time_(std::chrono::steady_clock::duration::zero()),
+      trace_time_(std::chrono::steady_clock::duration::zero()),
+      batch_abort_(false),
+      checkpoint_pending_(false),
+      checkpoint_save_cycle_(0),
+      trace_start_pending_(false),
+      trace_stop_pending_(false) {
+}
+
+bool VerilatorSimCtrl::ReadBatchFile(const std::string &path) {
+  std::ifstream is(path);
+  if (!is) {
+    std::cerr << "ERROR: Could not open batch file `" << path << "'."
+              << std::endl;
+    return false;
+  }
+
+  // One image per line. Blank lines and lines starting with # are ignored.
+  std::string line;
+  while (std::getline(is, line)) {
+    size_t first = line.find_first_not_of(" \t");
+    if (first == std::string::npos || line[first] == '#') {
+      continue;
+    }
+    size_t last = line.find_last_not_of(" \t\r");
+    batch_images_.push_back(line.substr(first, last - first + 1));
+  }
+
+  if (batch_images_.empty()) {
+    std::cerr << "ERROR: Batch file `" << path << "' lists no images."
+              << std::endl;
+    return false;
+  }
+  return true;
 }
 
 void VerilatorSimCtrl::RegisterSignalHandler() {
@@ -262,6 +430,7 @@ void VerilatorSimCtrl::SignalHandler(int sig) {
 
   switch (sig) {
     case SIGINT:
+      simctrl.batch_abort_ = true;
       simctrl.RequestStop(true);
       break;
     case SIGUSR1:
@@ -279,10 +448,41 @@ void VerilatorSimCtrl::PrintHelp() const {
   if (tracing_possible_) {
     std::cout << "-t|--trace\n"
                  "   --trace=FILE\n"
-                 "  Write a trace file from the start\n\n";
+                 "  Write a trace file from the start\n\n"
+                 "--trace-start=N\n"
+                 "  Start tracing at cycle N\n\n"
+                 "--trace-stop=N\n"
+                 "  Stop tracing at cycle N\n\n"
+                 "--trace-scope=SCOPE\n"
+                 "  Only trace signals in SCOPE (a hierarchical name such as\n"
+                 "  TOP.chip_sim_tb.u_dut) and below. Can be given more than\n"
+                 "  once.\n\n"
+                 "--trace-flight-recorder=N\n"
+                 "  Only keep (at least) the last N cycles of the trace, split\n"
+                 "  across two files that are overwritten in turn\n\n";
   }
   std::cout << "-c|--term-after-cycles=N\n"
                "  Terminate simulation after N cycles. 0 means no timeout.\n\n"
+               "--checkpoint-save=FILE\n"
+               "  Save a checkpoint to FILE (and files named FILE.*) once the\n"
+               "  simulation reaches the checkpoint cycle\n\n"
+               "--checkpoint-cycle=N\n"
+               "  Save the checkpoint at cycle N. Defaults to the cycle where\n"
+               "  reset is released.\n\n"
+               "--checkpoint-restore=FILE\n"
+               "  Start the simulation from the checkpoint saved in FILE\n\n"
+               "--batch=FILE\n"
+               "  Run one test for each image listed in FILE (one path per\n"
+               "  line), resetting the design between tests. The cycle limit\n"
+               "  from --term-after-cycles applies to each test.\n\n"
+               "--profile=FILE\n"
+               "  Write a JSON report to FILE that breaks down where the\n"
+               "  simulation spent its time, how long the extensions took to\n"
+               "  set up (including loading memories) and the peak RSS\n\n"
+               "--uart-backdoor\n"
+               "  Move characters between the UART FIFOs and the host directly\n"
+               "  instead of serializing them at the simulated baud rate, in\n"
+               "  testbenches that support it\n\n"
                "-h|--help\n"
                "  Show help\n\n"
                "All arguments are passed to the design and can be used "
@@ -326,18 +526,144 @@ void VerilatorSimCtrl::PrintStatistics() const {
   if (tracing_enabled_ && FileSize(GetTraceFileName(), trace_size_byte)) {
     std::cout << "Trace file size:  " << trace_size_byte << " B" << std::endl;
   }
+
+  if (!extension_array_.empty()) {
+    std::cout << "Extension time:" << std::endl;
+  }
+  for (size_t i = 0; i < extension_array_.size(); ++i) {
+    const ExtensionClockState &state = extension_clock_[i];
+    std::cout << "  " << GetExtensionName(i) << ": " << state.num_calls
+              << " calls, "
+              << std::chrono::duration<double>(state.time).count() << " s"
+              << std::endl;
+  }
+}
+
+std::string VerilatorSimCtrl::GetExtensionName(size_t idx) const {
+  const char *mangled = typeid(*extension_array_[idx]).name();
+  int status;
+  char *demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+  std::string name(status == 0 ? demangled : mangled);
+  free(demangled);
+  return name;
+}
+
+// Write a JSON object member for a call count and time
+static void WriteProfileEntry(std::ostream &os, const std::string &name,
+                              unsigned long num_calls, double time_s,
+                              bool last) {
+  os << "    \"" << name << "\": {\"calls\": " << num_calls
+     << ", \"time_s\": " << time_s << "}" << (last ? "\n" : ",\n");
+}
+
+bool VerilatorSimCtrl::WriteProfile() const {
+  std::ofstream os(profile_path_);
+  if (!os) {
+    std::cerr << "ERROR: Could not open profile report at `" << profile_path_
+              << "' for writing." << std::endl;
+    return false;
+  }
+
+  double wallclock_s =
+      std::chrono::duration<double>(time_end_ - time_begin_).count();
+  os << std::setprecision(9) << "{\n"
+     << "  \"toplevel\": \"" << GetName() << "\",\n"
+     << "  \"cycles\": " << time_ / 2 << ",\n"
+     << "  \"wallclock_s\": " << wallclock_s << ",\n"
+     << "  \"cycles_per_s\": "
+     << (wallclock_s > 0 ? time_ / 2 / wallclock_s : 0) << ",\n"
+     << "  \"eval_s\": " << std::chrono::duration<double>(eval_time_).count()
+     << ",\n"
+     << "  \"trace_s\": "
+     << std::chrono::duration<double>(trace_time_).count() << ",\n";
+
+  // Setup covers ParseCLIArguments for each extension, which is where the
+  // memory images are loaded.
+  std::chrono::steady_clock::duration setup_time =
+      std::chrono::steady_clock::duration::zero();
+  for (const ExtensionClockState &state : extension_clock_) {
+    setup_time += state.setup_time;
+  }
+  struct rusage usage;
+  long max_rss_kb = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+  os << "  \"setup_s\": " << std::chrono::duration<double>(setup_time).count()
+     << ",\n"
+     << "  \"max_rss_kb\": " << max_rss_kb << ",\n";
+
+  os << "  \"extension_setup\": {\n";
+  for (size_t i = 0; i < extension_array_.size(); ++i) {
+    os << "    \"" << GetExtensionName(i) << "\": "
+       << std::chrono::duration<double>(extension_clock_[i].setup_time).count()
+       << (i + 1 == extension_array_.size() ? "\n" : ",\n");
+  }
+  os << "  },\n";
+
+  os << "  \"extensions\": {\n";
+  for (size_t i = 0; i < extension_array_.size(); ++i) {
+    const ExtensionClockState &state = extension_clock_[i];
+    WriteProfileEntry(os, GetExtensionName(i), state.num_calls,
+                      std::chrono::duration<double>(state.time).count(),
+                      i + 1 == extension_array_.size());
+  }
+  os << "  },\n";
+
+  os << "  \"dpi\": {\n";
+  for (const dpi_profile_counter *counter = dpi_profile_first(); counter;
+       counter = counter->next) {
+    WriteProfileEntry(os, counter->name, counter->num_calls,
+                      counter->time_ns / 1e9, counter->next == nullptr);
+  }
+  os << "  }\n"
+     << "}\n";
+
+  if (!os.flush()) {
+    std::cerr << "ERROR: Failed to write profile report to `" << profile_path_
+              << "'." << std::endl;
+    return false;
+  }
+  std::cout << "Profiling report written to " << profile_path_ << std::endl;
+  return true;
 }
 
 std::string VerilatorSimCtrl::GetTraceFileName() const {
+  if (flight_recorder_cycles_) {
+    return GetTraceSegmentFileName(flight_recorder_segment_);
+  }
   return trace_file_path_;
 }
 
+std::string VerilatorSimCtrl::GetTraceSegmentFileName(
+    unsigned int segment) const {
+  std::string index = "." + std::to_string(segment);
+  size_t dot = trace_file_path_.rfind('.');
+  size_t slash = trace_file_path_.rfind('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return trace_file_path_ + index;
+  }
+  return trace_file_path_.substr(0, dot) + index +
+         trace_file_path_.substr(dot);
+}
+
+void VerilatorSimCtrl::RotateTraceSegment() {
+  if (time_ - flight_recorder_segment_start_ < 2 * flight_recorder_cycles_) {
+    return;
+  }
+  tracer_.close();
+  flight_recorder_segment_ ^= 1;
+  tracer_.open(GetTraceFileName().c_str());
+  flight_recorder_segment_start_ = time_;
+}
+
 void VerilatorSimCtrl::Run() {
   assert(top_ && "Use SetTop() first.");
 
   // We always need to enable this as tracing can be enabled at runtime
   if (tracing_possible_) {
     Verilated::traceEverOn(true);
+    // Scope filters must be set up before the trace file is opened
+    for (const std::string &scope : trace_scopes_) {
+      tracer_.dumpvars(0, scope);
+    }
     top_->trace(tracer_, 99, 0);
   }
 
@@ -351,56 +677,235 @@ void VerilatorSimCtrl::Run() {
   UnsetReset();
   Trace();
 
-  unsigned long start_reset_cycle_ = initial_reset_delay_cycles_;
-  unsigned long end_reset_cycle_ = start_reset_cycle_ + reset_duration_cycles_;
+  unsigned long end_reset_cycle =
+      initial_reset_delay_cycles_ + reset_duration_cycles_;
+  checkpoint_save_cycle_ =
+      checkpoint_cycle_set_ ? checkpoint_cycle_ : end_reset_cycle;
+  checkpoint_pending_ = !checkpoint_save_path_.empty();
+  trace_start_pending_ = trace_start_set_;
+  trace_stop_pending_ = trace_stop_cycle_ != 0;
+
+  if (batch_images_.empty()) {
+    RunTest(initial_reset_delay_cycles_, term_after_cycles_, false);
+  } else {
+    RunBatch();
+  }
+
+  top_->final();
+  time_end_ = std::chrono::steady_clock::now();
+
+  if (TracingEverEnabled()) {
+    tracer_.close();
+  }
+}
+
+VerilatorSimCtrl::TestEnd VerilatorSimCtrl::RunTest(
+    unsigned long start_reset_cycle, unsigned long timeout_cycle,
+    bool ignore_stop_in_reset) {
+  unsigned long end_reset_cycle = start_reset_cycle + reset_duration_cycles_;
+
+  // The next cycles where something other than toggling the clock needs to
+  // happen. Between them, the loop below just evaluates the model.
+  unsigned long next_control_cycle = 0;
+  unsigned long next_extension_cycle = 0;
 
   while (1) {
     unsigned long cycle_ = time_ / 2;
 
-    if (cycle_ == start_reset_cycle_) {
-      SetReset();
-    } else if (cycle_ == end_reset_cycle_) {
-      UnsetReset();
+    if (cycle_ >= next_control_cycle) {
+      if (cycle_ == start_reset_cycle) {
+        SetReset();
+      } else if (cycle_ == end_reset_cycle) {
+        UnsetReset();
+      }
+
+      if (trace_start_pending_ && cycle_ >= trace_start_cycle_) {
+        TraceOn();
+        trace_start_pending_ = false;
+      }
+      if (trace_stop_pending_ && cycle_ >= trace_stop_cycle_) {
+        TraceOff();
+        trace_stop_pending_ = false;
+      }
+
+      next_control_cycle = SimCtrlExtension::kNeverWake;
+      for (unsigned long control_cycle : {start_reset_cycle, end_reset_cycle}) {
+        if (control_cycle > cycle_) {
+          next_control_cycle = std::min(next_control_cycle, control_cycle);
+        }
+      }
+      if (trace_start_pending_) {
+        next_control_cycle = std::min(next_control_cycle, trace_start_cycle_);
+      }
+      if (trace_stop_pending_) {
+        next_control_cycle = std::min(next_control_cycle, trace_stop_cycle_);
+      }
     }
 
     *sig_clk_ = !*sig_clk_;
 
-    // Call all extension on-clock methods
-    if (*sig_clk_) {
-      for (auto it = extension_array_.begin(); it != extension_array_.end();
-           ++it) {
-        (*it)->OnClock(time_);
-      }
+    // Call the on-clock methods of any extensions that are due
+    if (*sig_clk_ && cycle_ >= next_extension_cycle) {
+      next_extension_cycle = ClockExtensions(cycle_);
+    }
+
+    if (profile_path_.empty()) {
+      top_->eval();
+      time_++;
+      Trace();
+    } else {
+      auto eval_start = std::chrono::steady_clock::now();
+      top_->eval();
+      auto trace_start = std::chrono::steady_clock::now();
+      time_++;
+      Trace();
+      eval_time_ += trace_start - eval_start;
+      trace_time_ += std::chrono::steady_clock::now() - trace_start;
     }
 
-    top_->eval();
-    time_++;
+    // Save at the end of the cycle before checkpoint_save_cycle_, so that the
+    // checkpoint looks like the state at the top of this loop on that cycle.
+    if (checkpoint_pending_ && time_ >= 2 * checkpoint_save_cycle_) {
+      checkpoint_pending_ = false;
+      if (!SaveCheckpoint()) {
+        RequestStop(false);
+      }
+    }
 
-    Trace();
+    // A design that is being reset for the next test in a batch might still
+    // signal the end of the previous test, so ignore that until reset has been
+    // released.
+    if (ignore_stop_in_reset && cycle_ < end_reset_cycle) {
+      if (!batch_abort_) {
+        request_stop_ = false;
+        simulation_success_ = true;
+        Verilated::gotFinish(false);
+      }
+      continue;
+    }
 
     if (request_stop_) {
       std::cout << "Received stop request, shutting down simulation."
                 << std::endl;
-      break;
+      return kTestEndStopRequest;
     }
     if (Verilated::gotFinish()) {
       std::cout << "Received $finish() from Verilog, shutting down simulation."
                 << std::endl;
-      break;
+      return kTestEndFinish;
     }
-    if (term_after_cycles_ && (time_ / 2 >= term_after_cycles_)) {
+    if (timeout_cycle && (time_ / 2 >= timeout_cycle)) {
       std::cout << "Simulation timeout of " << term_after_cycles_
                 << " cycles reached, shutting down simulation." << std::endl;
-      break;
+      return kTestEndTimeout;
     }
   }
+}
 
-  top_->final();
-  time_end_ = std::chrono::steady_clock::now();
+void VerilatorSimCtrl::RunBatch() {
+  struct BatchResult {
+    std::string image;
+    bool passed;
+    const char *reason;
+    unsigned long cycles;
+  };
+  std::vector<BatchResult> results;
+  bool all_passed = true;
+
+  for (size_t i = 0; i < batch_images_.size() && !batch_abort_; ++i) {
+    const std::string &image = batch_images_[i];
+    std::cout << std::endl
+              << "Batch test " << i + 1 << " of " << batch_images_.size()
+              << ": " << image << std::endl;
 
-  if (TracingEverEnabled()) {
-    tracer_.close();
+    bool prepared = true;
+    for (auto it = extension_array_.begin(); it != extension_array_.end();
+         ++it) {
+      prepared &= (*it)->PrepareBatchTest(image);
+    }
+    if (!prepared) {
+      results.push_back({image, false, "load failed", 0});
+      all_passed = false;
+      for (auto it = extension_array_.begin(); it != extension_array_.end();
+           ++it) {
+        (*it)->FinishBatchTest(image, false);
+      }
+      continue;
+    }
+
+    // The first test has the usual initial reset delay, which lets the design
+    // come out of power-on. Later tests are reset straight away.
+    unsigned long start_cycle = time_ / 2;
+    unsigned long start_reset_cycle =
+        (i == 0) ? initial_reset_delay_cycles_ : start_cycle;
+    unsigned long timeout_cycle =
+        term_after_cycles_ ? start_cycle + term_after_cycles_ : 0;
+
+    request_stop_ = false;
+    simulation_success_ = true;
+    Verilated::gotFinish(false);
+
+    TestEnd end = RunTest(start_reset_cycle, timeout_cycle, i != 0);
+
+    BatchResult result = {image, false, "", time_ / 2 - start_cycle};
+    switch (end) {
+      case kTestEndFinish:
+        result.passed = simulation_success_;
+        result.reason = result.passed ? "finished" : "failed";
+        break;
+      case kTestEndStopRequest:
+        result.reason = batch_abort_ ? "interrupted" : "failed";
+        result.passed = simulation_success_ && !batch_abort_;
+        break;
+      case kTestEndTimeout:
+        result.reason = "timeout";
+        break;
+    }
+    all_passed &= result.passed;
+    results.push_back(result);
+
+    for (auto it = extension_array_.begin(); it != extension_array_.end();
+         ++it) {
+      (*it)->FinishBatchTest(image, result.passed);
+    }
+  }
+
+  std::cout << std::endl
+            << "Batch results" << std::endl
+            << "=============" << std::endl;
+  size_t num_passed = 0;
+  for (const BatchResult &result : results) {
+    num_passed += result.passed;
+    std::cout << (result.passed ? "PASS" : "FAIL") << "  " << result.image
+              << " (" << result.reason << ", " << result.cycles << " cycles)"
+              << std::endl;
   }
+  std::cout << num_passed << " of " << batch_images_.size()
+            << " tests passed." << std::endl;
+
+  simulation_success_ = all_passed && results.size() == batch_images_.size();
+}
+
+unsigned long VerilatorSimCtrl::ClockExtensions(unsigned long cycle) {
+  unsigned long next_wake_cycle = SimCtrlExtension::kNeverWake;
+  for (size_t i = 0; i < extension_array_.size(); ++i) {
+    ExtensionClockState &state = extension_clock_[i];
+    if (cycle >= state.next_wake_cycle) {
+      if (profile_path_.empty()) {
+        extension_array_[i]->OnClock(time_);
+      } else {
+        auto start = std::chrono::steady_clock::now();
+        extension_array_[i]->OnClock(time_);
+        state.time += std::chrono::steady_clock::now() - start;
+      }
+      ++state.num_calls;
+
+      state.next_wake_cycle = extension_array_[i]->GetNextWakeCycle(cycle);
+      assert(state.next_wake_cycle > cycle);
+    }
+    next_wake_cycle = std::min(next_wake_cycle, state.next_wake_cycle);
+  }
+  return next_wake_cycle;
 }
 
 std::string VerilatorSimCtrl::GetName() const {
@@ -462,9 +967,81 @@ void VerilatorSimCtrl::Trace() {
 
   if (!tracer_.isOpen()) {
     tracer_.open(GetTraceFileName().c_str());
-    std::cout << "Writing simulation traces to " << GetTraceFileName()
-              << std::endl;
+    flight_recorder_segment_start_ = time_;
+    std::cout << "Writing simulation traces to " << GetTraceFileName();
+    if (flight_recorder_cycles_) {
+      std::cout << " and "
+                << GetTraceSegmentFileName(flight_recorder_segment_ ^ 1)
+                << " (keeping the last " << flight_recorder_cycles_
+                << " cycles)";
+    }
+    std::cout << std::endl;
+  } else if (flight_recorder_cycles_) {
+    RotateTraceSegment();
   }
 
   tracer_.dump(GetTime());
 }
+
+bool VerilatorSimCtrl::SaveCheckpoint() {
+#if VM_SAVABLE == 1
+  VerilatedSave os;
+  os.open(checkpoint_save_path_.c_str());
+  if (!os.isOpen()) {
+    std::cerr << "ERROR: Could not open checkpoint file `"
+              << checkpoint_save_path_ << "' for writing." << std::endl;
+    return false;
+  }
+  vluint64_t time = time_;
+  os << time;
+  top_->save(os);
+  os.close();
+#endif
+
+  for (auto it = extension_array_.begin(); it != extension_array_.end(); ++it) {
+    if (!(*it)->SaveCheckpoint(checkpoint_save_path_)) {
+      return false;
+    }
+  }
+
+  std::cout << "Saved checkpoint to " << checkpoint_save_path_ << " at cycle "
+            << time_ / 2;
+  if (!VM_SAVABLE) {
+    std::cout << " (model state not saved: build with --savable and "
+                 "VM_SAVABLE=1 to include it)";
+  }
+  std::cout << "." << std::endl;
+  return true;
+}
+
+bool VerilatorSimCtrl::RestoreCheckpoint() {
+  assert(top_ && "Use SetTop() first.");
+
+#if VM_SAVABLE == 1
+  VerilatedRestore os;
+  os.open(checkpoint_restore_path_.c_str());
+  if (!os.isOpen()) {
+    std::cerr << "ERROR: Could not open checkpoint file `"
+              << checkpoint_restore_path_ << "'." << std::endl;
+    return false;
+  }
+  vluint64_t time;
+  os >> time;
+  top_->restore(os);
+  os.close();
+  time_ = time;
+#endif
+
+  for (auto it = extension_array_.begin(); it != extension_array_.end(); ++it) {
+    if (!(*it)->RestoreCheckpoint(checkpoint_restore_path_)) {
+      return false;
+    }
+  }
+
+  std::cout << "Restored checkpoint from " << checkpoint_restore_path_;
+  if (VM_SAVABLE) {
+    std::cout << " at cycle " << time_ / 2;
+  }
+  std::cout << "." << std::endl;
+  return true;
+}
@@ -116,6 +116,18 @@ class VerilatorSimCtrl {
    */
   void RegisterExtension(SimCtrlExtension *ext);
 
+  /**
+   * Add a test to the batch
+   *
+   * This has the same effect as listing image in a file passed with --batch
+   * and can be used by extensions that build a batch of their own. It must be
+   * called before the simulation starts (for example, from
+   * SimCtrlExtension::ParseCLIArguments()).
+   */
+  void AddBatchImage(const std::string &image) {
+    batch_images_.push_back(image);
+  }
+
   /**
    * Get the current time in ticks
    */
@@ -132,6 +144,13 @@ class VerilatorSimCtrl {
   bool tracing_enabled_changed_;
   bool tracing_ever_enabled_;
   bool tracing_possible_;
+  bool trace_start_set_;
+  unsigned long trace_start_cycle_;
+  unsigned long trace_stop_cycle_;
+  std::vector<std::string> trace_scopes_;
+  unsigned long flight_recorder_cycles_;
+  unsigned int flight_recorder_segment_;
+  unsigned long flight_recorder_segment_start_;
   unsigned int initial_reset_delay_cycles_;
   unsigned int reset_duration_cycles_;
   volatile unsigned int request_stop_;
@@ -140,8 +159,46 @@ class VerilatorSimCtrl {
   std::chrono::steady_clock::time_point time_end_;
   VerilatedTracer tracer_;
   unsigned long term_after_cycles_;
+  std::string checkpoint_save_path_;
+  std::string checkpoint_restore_path_;
+  bool checkpoint_cycle_set_;
+  unsigned long checkpoint_cycle_;
   std::vector<SimCtrlExtension *> extension_array_;
 
+  // Scheduling and profiling state for the extension with the same index in
+  // extension_array_
+  struct ExtensionClockState {
+    unsigned long next_wake_cycle;
+    unsigned long num_calls;
+    std::chrono::steady_clock::duration time;
+    // Time spent in ParseCLIArguments, which includes loading memory images
+    std::chrono::steady_clock::duration setup_time;
+  };
+  std::vector<ExtensionClockState> extension_clock_;
+
+  // Profiling state (see --profile). The eval, trace and extension clock
+  // times are only measured when profile_path_ is set.
+  std::string profile_path_;
+  std::chrono::steady_clock::duration eval_time_;
+  std::chrono::steady_clock::duration trace_time_;
+
+  // Batch mode state (see --batch)
+  std::vector<std::string> batch_images_;
+  volatile bool batch_abort_;
+
+  // Events that happen at most once per simulation, even in batch mode
+  bool checkpoint_pending_;
+  unsigned long checkpoint_save_cycle_;
+  bool trace_start_pending_;
+  bool trace_stop_pending_;
+
+  // The reasons that RunTest() can return
+  enum TestEnd {
+    kTestEndStopRequest,
+    kTestEndFinish,
+    kTestEndTimeout,
+  };
+
   /**
    * Default constructor
    *
@@ -205,11 +262,58 @@ class VerilatorSimCtrl {
    */
   void PrintStatistics() const;
 
+  /**
+   * Get a printable name for the extension with the given index
+   *
+   * This is the (demangled) name of the extension's class.
+   */
+  std::string GetExtensionName(size_t idx) const;
+
+  /**
+   * Write a JSON profiling report to profile_path_
+   *
+   * The report breaks the wallclock time of the simulation down into time
+   * spent evaluating the model, writing traces, in extension OnClock() calls
+   * and in each DPI module. Time in DPI modules is also counted as part of
+   * the evaluation time.
+   *
+   * @return Return code, true == success
+   */
+  bool WriteProfile() const;
+
   /**
    * Get the file name of the trace file
+   *
+   * In flight recorder mode, this is the name of the trace segment that is
+   * currently being written.
    */
   std::string GetTraceFileName() const;
 
+  /**
+   * Get the file name of a flight recorder trace segment
+   *
+   * This inserts the segment index before the extension of trace_file_path_,
+   * so sim.fst becomes sim.0.fst or sim.1.fst.
+   */
+  std::string GetTraceSegmentFileName(unsigned int segment) const;
+
+  /**
+   * Start the next flight recorder trace segment if the current one is full
+   *
+   * The flight recorder alternates between two trace files, each holding up to
+   * flight_recorder_cycles_ cycles. Once the current file is full, the older
+   * file is overwritten. Between them, the two files always hold at least the
+   * last flight_recorder_cycles_ cycles of the simulation.
+   */
+  void RotateTraceSegment();
+
+  /**
+   * Call OnClock() for each extension that is due to wake at cycle
+   *
+   * @return The earliest cycle at which an extension will next need to wake
+   */
+  unsigned long ClockExtensions(unsigned long cycle);
+
   /**
    * Run the main loop of the simulation
    *
@@ -217,6 +321,34 @@ class VerilatorSimCtrl {
    */
   void Run();
 
+  /**
+   * Run the simulation for a single test
+   *
+   * This asserts reset at start_reset_cycle and keeps going until a stop is
+   * requested, the design calls $finish or the simulation reaches
+   * timeout_cycle (where zero means no timeout). If ignore_stop_in_reset is
+   * true, the first two conditions are ignored until reset has been released.
+   *
+   * @return Why the test ended
+   */
+  TestEnd RunTest(unsigned long start_reset_cycle, unsigned long timeout_cycle,
+                  bool ignore_stop_in_reset);
+
+  /**
+   * Run a test for each image in batch_images_ and print a summary
+   *
+   * Before each test, every extension's PrepareBatchTest() is called with the
+   * image. The simulation is successful if every test passed.
+   */
+  void RunBatch();
+
+  /**
+   * Read the list of images for batch mode from the file at path
+   *
+   * @return Return code, true == success
+   */
+  bool ReadBatchFile(const std::string &path);
+
   /**
    * Get a name for this simulation
    *
@@ -248,6 +380,31 @@ class VerilatorSimCtrl {
    * Perform tracing in Verilator if required
    */
   void Trace();
+
+  /**
+   * Save a checkpoint to checkpoint_save_path_
+   *
+   * If the model was built with VM_SAVABLE, this writes the Verilated model
+   * state and the current time to the checkpoint file. It then asks each
+   * registered extension to save its own state (see
+   * SimCtrlExtension::SaveCheckpoint()).
+   *
+   * @return Return code, true == success
+   */
+  bool SaveCheckpoint();
+
+  /**
+   * Restore a checkpoint from checkpoint_restore_path_
+   *
+   * This is the inverse of SaveCheckpoint() and must be called before the
+   * simulation starts. Note that state held on the C side of DPI models (such
+   * as sockets opened by their initial blocks) isn't part of the model state,
+   * so a checkpoint should only be restored into a design whose DPI models
+   * don't depend on it.
+   *
+   * @return Return code, true == success
+   */
+  bool RestoreCheckpoint();
 };
 
 #endif  // OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_VERILATOR_SIM_CTRL_H_
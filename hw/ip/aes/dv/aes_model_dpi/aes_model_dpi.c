@@ -13,6 +13,119 @@
 #include "crypto.h"
 #include "svdpi.h"
 
+// Key schedule of the last key used by c_dpi_aes_crypt_block() and
+// c_dpi_aes_crypt_message(). The scoreboards tend to use the same key for many
+// blocks and messages in a row, so this saves expanding it on every call.
+static aes_key_sched_t key_sched_cache;
+static int key_sched_cache_valid = 0;
+
+/**
+ * Get the key schedule for a key, expanding the key only if it differs from
+ * the one used last time.
+ *
+ * @return Pointer to the key schedule, NULL in case of an error
+ */
+static const aes_key_sched_t *aes_key_sched_get(const unsigned char *key,
+                                                const int key_len) {
+  if (!key_sched_cache_valid || key_sched_cache.key_len != key_len ||
+      memcmp(key_sched_cache.key, key, key_len)) {
+    key_sched_cache_valid =
+        !aes_key_sched_init(&key_sched_cache, key, key_len);
+    if (!key_sched_cache_valid) {
+      return NULL;
+    }
+  }
+  return &key_sched_cache;
+}
+
+// Convert the one-hot encoded key_len_i to a length in bytes.
+static int aes_key_len_get(const svBitVecVal *key_len_i) {
+  if ((*key_len_i & key_len_mask) == 0x1) {
+    return 16;
+  } else if ((*key_len_i & key_len_mask) == 0x2) {
+    return 24;
+  } else {  // 0x4
+    return 32;
+  }
+}
+
+// Same as aes_data_get() and aes_data_put() but using a caller-owned buffer.
+static void aes_block_get(const svBitVecVal *data_i, unsigned char *data) {
+  for (int i = 0; i < 4; i++) {
+    svBitVecVal value = data_i[i];
+    for (int j = 0; j < 4; j++) {
+      data[i + j * 4] = (unsigned char)(value >> (8 * j));
+    }
+  }
+}
+
+static void aes_block_put(svBitVecVal *data_o, const unsigned char *data) {
+  for (int i = 0; i < 4; i++) {
+    svBitVecVal value = 0;
+    for (int j = 0; j < 4; j++) {
+      value |= (svBitVecVal)((data[i + 4 * j]) << (8 * j));
+    }
+    data_o[i] = value;
+  }
+}
+
+// Same as aes_key_get() but using a caller-owned buffer of 32 bytes.
+static void aes_key_buf_get(const svBitVecVal *key_i, unsigned char *key) {
+  for (int i = 0; i < 8; i++) {
+    svBitVecVal value = key_i[i];
+    key[4 * i + 0] = (unsigned char)(value >> 0);
+    key[4 * i + 1] = (unsigned char)(value >> 8);
+    key[4 * i + 2] = (unsigned char)(value >> 16);
+    key[4 * i + 3] = (unsigned char)(value >> 24);
+  }
+}
+
+// iv_i is a 1D array of words (4x32bit), but we need 16 bytes.
+static void aes_iv_words_get(const svBitVecVal *iv_i, unsigned char *iv) {
+  for (int i = 0; i < 4; ++i) {
+    svBitVecVal value = iv_i[i];
+    iv[4 * i + 0] = (unsigned char)(value >> 0);
+    iv[4 * i + 1] = (unsigned char)(value >> 8);
+    iv[4 * i + 2] = (unsigned char)(value >> 16);
+    iv[4 * i + 3] = (unsigned char)(value >> 24);
+  }
+}
+
+static void aes_iv_words_put(svBitVecVal *iv_o, const unsigned char *iv) {
+  for (int i = 0; i < 4; ++i) {
+    iv_o[i] = (svBitVecVal)iv[4 * i + 0] | ((svBitVecVal)iv[4 * i + 1] << 8) |
+              ((svBitVecVal)iv[4 * i + 2] << 16) |
+              ((svBitVecVal)iv[4 * i + 3] << 24);
+  }
+}
+
+/**
+ * Get a pointer to the canonical representation of an unpacked byte array, if
+ * the simulator provides one. stride is set to the number of bytes per
+ * element (1 or 4).
+ *
+ * @return Pointer to the array data, NULL if the array has to be accessed
+ *         element by element.
+ */
+static unsigned char *aes_byte_array_ptr(const svOpenArrayHandle arr,
+                                         int *stride) {
+  unsigned char *ptr = (unsigned char *)svGetArrayPtr(arr);
+  int num_elems = svSize(arr, 1);
+  if (!ptr || svLeft(arr, 1) != 0) {
+    return NULL;
+  }
+
+  int size = svSizeOfArray(arr);
+  if (size == num_elems) {
+    *stride = 1;
+  } else if (size == num_elems * (int)sizeof(svBitVecVal)) {
+    *stride = sizeof(svBitVecVal);
+  } else {
+    return NULL;
+  }
+  return ptr;
+}
+
 void c_dpi_aes_crypt_block(const unsigned char impl_i, const unsigned char op_i,
                            const svBitVecVal *mode_i, const svBitVecVal *iv_i,
                            const svBitVecVal *key_len_i,
@@ -27,78 +140,29 @@ void c_dpi_aes_crypt_block(const unsigned char impl_i, const unsigned char op_i,
     return;
   }
 
-  // key_len_i is one-hot encoded.
-  int key_len;
-  if ((*key_len_i & key_len_mask) == 0x1) {
-    key_len = 16;
-  } else if ((*key_len_i & key_len_mask) == 0x2) {
-    key_len = 24;
-  } else {  // 0x4
-    key_len = 32;
-  }
+  const int key_len = aes_key_len_get(key_len_i);
 
   // get input data from simulator
-  unsigned char *key = aes_key_get(key_i);
-  unsigned char *ref_in = aes_data_get(data_i);
+  unsigned char key[32];
+  unsigned char ref_in[16];
+  unsigned char ref_out[16];
+  aes_key_buf_get(key_i, key);
+  aes_block_get(data_i, ref_in);
 
   // Modes other than ECB require an IV from the simulator.
-  unsigned char *iv;
+  unsigned char iv[16];
   if (mode != kCryptoAesEcb) {
-    iv = aes_data_get(iv_i);
+    aes_block_get(iv_i, iv);
   } else {
-    iv = (unsigned char *)calloc(16, sizeof(unsigned char));
-    assert(iv);
+    memset(iv, 0, 16);
   }
 
-  // allocate memory
-  unsigned char *ref_out = (unsigned char *)malloc(16 * sizeof(unsigned char));
-  assert(ref_out);
-
   if (impl == 0) {
-    // The C model does ECB only. We "emulate" other modes here.
-    unsigned char data_in[16];
-    unsigned char data_out[16];
-
-    if (mode == kCryptoAesCbc) {
-      if (!op) {
-        // data_in = ref_in XOR iv (or previous data_out)
-        for (int i = 0; i < 16; ++i) {
-          data_in[i] = ref_in[i] ^ iv[i];
-        }
-        aes_encrypt_block(data_in, key, key_len, ref_out);
-      } else {
-        aes_decrypt_block(ref_in, key, key_len, data_out);
-        // ref_out = data_out XOR iv (or previous data_out)
-        for (int i = 0; i < 16; ++i) {
-          ref_out[i] = data_out[i] ^ iv[i];
-        }
-      }
-    } else if (mode == kCryptoAesCfb || mode == kCryptoAesOfb) {
-      // data_in = iv
-      for (int i = 0; i < 16; ++i) {
-        data_in[i] = iv[i];
-      }
-      aes_encrypt_block(data_in, key, key_len, data_out);
-      // ref_out = data_out XOR ref_in
-      for (int i = 0; i < 16; ++i) {
-        ref_out[i] = data_out[i] ^ ref_in[i];
-      }
-    } else if (mode == kCryptoAesCtr) {
-      // data_in = counter value
-      for (int i = 0; i < 16; ++i) {
-        data_in[i] = iv[i];
-      }
-      aes_encrypt_block(data_in, key, key_len, data_out);
-      for (int i = 0; i < 16; ++i) {
-        ref_out[i] = data_out[i] ^ ref_in[i];
-      }
-    } else {  // ECB
-      if (!op) {
-        aes_encrypt_block(ref_in, key, key_len, ref_out);
-      } else {
-        aes_decrypt_block(ref_in, key, key_len, ref_out);
-      }
+    const aes_key_sched_t *sched = aes_key_sched_get(key, key_len);
+    if (!sched) {
+      return;
     }
+    aes_crypt_message(sched, op, mode, iv, ref_in, ref_out, 16);
   } else {  // OpenSSL/BoringSSL
     if (!op) {
       crypto_encrypt(ref_out, iv, ref_in, 16, key, key_len, mode);
@@ -107,17 +171,66 @@ void c_dpi_aes_crypt_block(const unsigned char impl_i, const unsigned char op_i,
     }
   }
 
-  // write output data back to simulator, free ref_out
-  aes_data_put(data_o, ref_out);
-
-  // free memory
-  free(iv);
-  free(key);
-  free(ref_in);
+  // write output data back to simulator
+  aes_block_put(data_o, ref_out);
 
   return;
 }
 
+/**
+ * Perform encryption/decryption of an entire message held in an unpacked SV
+ * byte array. iv is updated to the IV for the next block if the C model is
+ * used.
+ */
+static void aes_crypt_unpacked(const aes_key_sched_t *sched,
+                               const unsigned char impl, const unsigned char op,
+                               const crypto_mode_t mode, unsigned char *iv,
+                               const svOpenArrayHandle data_i,
+                               svOpenArrayHandle data_o) {
+  // Get message length.
+  int data_len = svSize(data_i, 1);
+  if (data_len % 16) {
+    printf(
+        "ERROR: Message length must be a multiple of 16 bytes (the block "
+        "size).\n");
+    return;
+  }
+  if (svSize(data_o, 1) < data_len) {
+    printf("ERROR: Output array is shorter than the message.\n");
+    return;
+  }
+
+  // Get input data from simulator.
+  unsigned char *ref_in = aes_data_unpacked_get(data_i);
+  if (!data_len) {
+    free(ref_in);
+    return;
+  }
+
+  // Allocate output buffer.
+  unsigned char *ref_out =
+      (unsigned char *)calloc(svSize(data_o, 1), sizeof(unsigned char));
+  assert(ref_out);
+
+  if (impl == 0) {
+    aes_crypt_message(sched, op, mode, iv, ref_in, ref_out, data_len);
+  } else {  // OpenSSL/BoringSSL
+    if (!op) {
+      crypto_encrypt(ref_out, iv, ref_in, data_len, sched->key, sched->key_len,
+                     mode);
+    } else {
+      crypto_decrypt(ref_out, iv, ref_in, data_len, sched->key, sched->key_len,
+                     mode);
+    }
+  }
+
+  // Write output data back to simulator, free ref_out.
+  aes_data_unpacked_put(data_o, ref_out);
+
+  // Free memory.
+  free(ref_in);
+}
+
 void c_dpi_aes_crypt_message(unsigned char impl_i, unsigned char op_i,
                              const svBitVecVal *mode_i, const svBitVecVal *iv_i,
                              const svBitVecVal *key_len_i,
@@ -134,84 +247,77 @@ void c_dpi_aes_crypt_message(unsigned char impl_i, unsigned char op_i,
     return;
   }
 
-  // key_len_i is one-hot encoded.
-  int key_len;
-  if ((*key_len_i & key_len_mask) == 0x1) {
-    key_len = 16;
-  } else if ((*key_len_i & key_len_mask) == 0x2) {
-    key_len = 24;
-  } else {  // 0x4
-    key_len = 32;
-  }
+  const int key_len = aes_key_len_get(key_len_i);
 
-  if (impl == 0) {
-    // The C model is currently not supported.
-    printf(
-        "ERROR: c_dpi_aes_crypt_message() currently supports OpenSSL/BoringSSL "
-        "only\n");
+  // Get key from simulator.
+  unsigned char key[32];
+  aes_key_buf_get(key_i, key);
+  const aes_key_sched_t *sched = aes_key_sched_get(key, key_len);
+  if (!sched) {
     return;
   }
 
-  // Get key from simulator.
-  unsigned char *key = aes_key_get(key_i);
-
   // Modes other than ECB require an IV from the simulator.
-  unsigned char *iv = (unsigned char *)malloc(16 * sizeof(unsigned char));
-  assert(iv);
+  unsigned char iv[16];
   if (mode != kCryptoAesEcb) {
-    // iv_i is a 1D array of words (4x32bit), but we need 16 bytes.
-    svBitVecVal value;
-    for (int i = 0; i < 4; ++i) {
-      value = iv_i[i];
-      iv[4 * i + 0] = (unsigned char)(value >> 0);
-      iv[4 * i + 1] = (unsigned char)(value >> 8);
-      iv[4 * i + 2] = (unsigned char)(value >> 16);
-      iv[4 * i + 3] = (unsigned char)(value >> 24);
-    }
+    aes_iv_words_get(iv_i, iv);
   } else {
     memset(iv, 0, 16);
   }
 
-  // Get message length.
-  int data_len = svSize(data_i, 1);
+  aes_crypt_unpacked(sched, impl, op, mode, iv, data_i, data_o);
+}
 
-  // Get input data from simulator.
-  unsigned char *ref_in = aes_data_unpacked_get(data_i);
+void *c_dpi_aes_ctx_new(const svBitVecVal *key_len_i,
+                        const svBitVecVal *key_i) {
+  unsigned char key[32];
+  aes_key_buf_get(key_i, key);
 
-  // Allocate output buffer.
-  unsigned char *ref_out =
-      (unsigned char *)malloc(data_len * sizeof(unsigned char));
-  assert(ref_out);
+  aes_key_sched_t *ctx = (aes_key_sched_t *)malloc(sizeof(aes_key_sched_t));
+  assert(ctx);
+  if (aes_key_sched_init(ctx, key, aes_key_len_get(key_len_i))) {
+    free(ctx);
+    return NULL;
+  }
+  return ctx;
+}
 
-  // OpenSSL/BoringSSL
-  if ((int)data_len % 16) {
-    printf(
-        "ERROR: Message length must be a multiple of 16 bytes (the block "
-        "size).\n");
+void c_dpi_aes_ctx_crypt_message(void *ctx_i, unsigned char impl_i,
+                                 unsigned char op_i, const svBitVecVal *mode_i,
+                                 const svBitVecVal *iv_i, svBitVecVal *iv_o,
+                                 const svOpenArrayHandle data_i,
+                                 svOpenArrayHandle data_o) {
+  const aes_key_sched_t *ctx = (const aes_key_sched_t *)ctx_i;
+  if (!ctx) {
+    printf("ERROR: c_dpi_aes_ctx_crypt_message() called without a context\n");
     return;
   }
 
-  if (impl == 0) {
-    // The C model is currently not supported.
+  // Mask out unused bits as their value is undetermined.
+  const unsigned char impl = impl_i & impl_mask;
+  const unsigned char op = op_i & op_mask;
+  const crypto_mode_t mode = (crypto_mode_t)(*mode_i & mode_mask);
+  if (mode == kCryptoAesNone) {
     printf(
-        "ERROR: c_dpi_aes_crypt_message() currently supports OpenSSL/BoringSSL "
-        "only\n");
-  } else {  // OpenSSL/BoringSSL
-    if (!op) {
-      crypto_encrypt(ref_out, iv, ref_in, data_len, key, key_len, mode);
-    } else {
-      crypto_decrypt(ref_out, iv, ref_in, data_len, key, key_len, mode);
-    }
+        "ERROR: Mode kCryptoAesNone not supported by "
+        "c_dpi_aes_ctx_crypt_message");
+    return;
   }
 
-  // Write output data back to simulator, free ref_out.
-  aes_data_unpacked_put(data_o, ref_out);
+  unsigned char iv[16];
+  if (mode != kCryptoAesEcb) {
+    aes_iv_words_get(iv_i, iv);
+  } else {
+    memset(iv, 0, 16);
+  }
 
-  // Free memory.
-  free(iv);
-  free(key);
+  aes_crypt_unpacked(ctx, impl, op, mode, iv, data_i, data_o);
+
+  aes_iv_words_put(iv_o, iv);
 }
 
+void c_dpi_aes_ctx_free(void *ctx_i) { free(ctx_i); }
+
 void c_dpi_aes_sub_bytes(const unsigned char op_i, const svBitVecVal *data_i,
                          svBitVecVal *data_o) {
   // get input data from simulator
@@ -344,18 +450,29 @@ void aes_data_put(svBitVecVal *data_o, unsigned char *data) {
 
 unsigned char *aes_data_unpacked_get(const svOpenArrayHandle data_i) {
   unsigned char *data;
+  unsigned char *ptr;
   int len;
+  int stride;
   svBitVecVal value;
 
   // alloc data buffer
   len = svSize(data_i, 1);
-  data = (unsigned char *)malloc(len * sizeof(unsigned char));
+  data = (unsigned char *)malloc((len ? len : 1) * sizeof(unsigned char));
   assert(data);
 
-  // get data from simulator
-  for (int i = 0; i < len; i++) {
-    svGetBitArrElem1VecVal(&value, data_i, i);
-    data[i] = (unsigned char)value;
+  // get data from simulator, in one go if possible
+  ptr = aes_byte_array_ptr(data_i, &stride);
+  if (ptr && stride == 1) {
+    memcpy(data, ptr, len);
+  } else if (ptr) {
+    for (int i = 0; i < len; i++) {
+      data[i] = (unsigned char)((const svBitVecVal *)ptr)[i];
+    }
+  } else {
+    for (int i = 0; i < len; i++) {
+      svGetBitArrElem1VecVal(&value, data_i, i);
+      data[i] = (unsigned char)value;
+    }
   }
 
   return data;
@@ -363,16 +480,27 @@ unsigned char *aes_data_unpacked_get(const svOpenArrayHandle data_i) {
 
 void aes_data_unpacked_put(const svOpenArrayHandle data_o,
                            unsigned char *data) {
+  unsigned char *ptr;
   int len;
+  int stride;
   svBitVecVal value;
 
   // get size of data buffer
   len = svSize(data_o, 1);
 
-  // write output data to simulation
-  for (int i = 0; i < len; i++) {
-    value = (svBitVecVal)data[i];
-    svPutBitArrElem1VecVal(data_o, &value, i);
+  // write output data to simulation, in one go if possible
+  ptr = aes_byte_array_ptr(data_o, &stride);
+  if (ptr && stride == 1) {
+    memcpy(ptr, data, len);
+  } else if (ptr) {
+    for (int i = 0; i < len; i++) {
+      ((svBitVecVal *)ptr)[i] = (svBitVecVal)data[i];
+    }
+  } else {
+    for (int i = 0; i < len; i++) {
+      value = (svBitVecVal)data[i];
+      svPutBitArrElem1VecVal(data_o, &value, i);
+    }
   }
 
   // free data
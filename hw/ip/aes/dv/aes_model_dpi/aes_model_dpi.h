@@ -41,7 +41,10 @@ void c_dpi_aes_crypt_block(const unsigned char impl_i, const unsigned char op_i,
                            svBitVecVal *data_o);
 
 /**
- * Perform encryption/decryption of an entire message using OpenSSL/BoringSSL.
+ * Perform encryption/decryption of an entire message.
+ *
+ * The C model keeps the expanded key schedule of the last key used between
+ * calls, so this is cheap to call repeatedly with the same key.
  *
  * @param  impl_i    Select reference impl.: 0 = C model, 1 = OpenSSL/BoringSSL
  * @param  op_i      Operation: 0 = encrypt, 1 = decrypt
@@ -62,6 +65,48 @@ void c_dpi_aes_crypt_message(unsigned char impl_i, unsigned char op_i,
                              const svOpenArrayHandle data_i,
                              svOpenArrayHandle data_o);
 
+/**
+ * Create a context holding the expanded key schedule for a key.
+ *
+ * The context must be freed with c_dpi_aes_ctx_free().
+ *
+ * @param  key_len_i Key length: 3'b001 = 128b, 3'b010 = 192b, 3'b100 = 256b
+ * @param  key_i     Full input key, 1D array of words (2D packed array in SV)
+ * @return Pointer to the context, NULL in case of an error
+ */
+void *c_dpi_aes_ctx_new(const svBitVecVal *key_len_i, const svBitVecVal *key_i);
+
+/**
+ * Perform encryption/decryption of an entire message using the key of a
+ * context created with c_dpi_aes_ctx_new().
+ *
+ * @param  ctx_i     Context
+ * @param  impl_i    Select reference impl.: 0 = C model, 1 = OpenSSL/BoringSSL
+ * @param  op_i      Operation: 0 = encrypt, 1 = decrypt
+ * @param  mode_i    Cipher mode: 6'b00_0001 = ECB, 6'00_b0010 = CBC,
+ *                                6'b00_0100 = CFB, 6'b00_1000 = OFB,
+ *                                6'b01_0000 = CTR, 6'b10_0000 = NONE
+ * @param  iv_i      Initialization vector: 1D array of words (2D packed array
+ *                   in SV)
+ * @param  iv_o      IV for the block following the message when using the C
+ *                   model, equal to iv_i otherwise. This allows a message to
+ *                   be processed in several calls.
+ * @param  data_i    Input data, 1D byte array (open array in SV)
+ * @param  data_o    Output data, 1D byte array (open array in SV)
+ */
+void c_dpi_aes_ctx_crypt_message(void *ctx_i, unsigned char impl_i,
+                                 unsigned char op_i, const svBitVecVal *mode_i,
+                                 const svBitVecVal *iv_i, svBitVecVal *iv_o,
+                                 const svOpenArrayHandle data_i,
+                                 svOpenArrayHandle data_o);
+
+/**
+ * Free a context created with c_dpi_aes_ctx_new().
+ *
+ * @param  ctx_i Context
+ */
+void c_dpi_aes_ctx_free(void *ctx_i);
+
 /**
  * Perform sub bytes operation for forward/inverse cipher operation.
  *
@@ -7,6 +7,7 @@
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 int aes_encrypt_block(const unsigned char *plain_text, const unsigned char *key,
                       const int key_len, unsigned char *cipher_text) {
@@ -121,6 +122,212 @@ int aes_decrypt_block(const unsigned char *cipher_text,
   return 0;
 }
 
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(AES_MODEL_NO_AESNI)
+#define AES_MODEL_HAVE_AESNI
+#include <wmmintrin.h>
+
+// The round keys of the key schedule are in the byte order used by the AES-NI
+// instructions, and the decryption round keys are already those of the
+// Equivalent Inverse Cipher.
+__attribute__((target("aes,sse2"))) static void aes_aesni_encrypt_block(
+    const aes_key_sched_t *sched, const unsigned char *in, unsigned char *out) {
+  __m128i state = _mm_loadu_si128((const __m128i *)in);
+  state = _mm_xor_si128(
+      state, _mm_loadu_si128((const __m128i *)sched->enc_round_keys[0]));
+  for (int j = 1; j < sched->num_rounds; j++) {
+    state = _mm_aesenc_si128(
+        state, _mm_loadu_si128((const __m128i *)sched->enc_round_keys[j]));
+  }
+  state = _mm_aesenclast_si128(
+      state, _mm_loadu_si128(
+                 (const __m128i *)sched->enc_round_keys[sched->num_rounds]));
+  _mm_storeu_si128((__m128i *)out, state);
+}
+
+__attribute__((target("aes,sse2"))) static void aes_aesni_decrypt_block(
+    const aes_key_sched_t *sched, const unsigned char *in, unsigned char *out) {
+  __m128i state = _mm_loadu_si128((const __m128i *)in);
+  state = _mm_xor_si128(
+      state, _mm_loadu_si128((const __m128i *)sched->dec_round_keys[0]));
+  for (int j = 1; j < sched->num_rounds; j++) {
+    state = _mm_aesdec_si128(
+        state, _mm_loadu_si128((const __m128i *)sched->dec_round_keys[j]));
+  }
+  state = _mm_aesdeclast_si128(
+      state, _mm_loadu_si128(
+                 (const __m128i *)sched->dec_round_keys[sched->num_rounds]));
+  _mm_storeu_si128((__m128i *)out, state);
+}
+#endif
+
+int aes_key_sched_init(aes_key_sched_t *sched, const unsigned char *key,
+                       const int key_len) {
+  int num_rounds = aes_get_num_rounds(key_len);
+  if (num_rounds < 0) {
+    printf("ERROR: aes_get_num_rounds() failed\n");
+    return -EINVAL;
+  }
+
+  unsigned char rcon;
+  unsigned char round_key[16];
+  unsigned char full_key[32];
+
+  sched->key_len = key_len;
+  sched->num_rounds = num_rounds;
+  memset(sched->key, 0, sizeof(sched->key));
+  memcpy(sched->key, key, key_len);
+
+  // forward round keys - same sequence as in aes_encrypt_block()
+  memcpy(full_key, key, key_len);
+  memcpy(round_key, full_key, 16);
+  memcpy(sched->enc_round_keys[0], round_key, 16);
+  rcon = 0;
+  for (int j = 0; j < num_rounds; j++) {
+    aes_key_expand(round_key, full_key, key_len, &rcon, j);
+    memcpy(sched->enc_round_keys[j + 1], round_key, 16);
+  }
+
+  // inverse round keys - same sequence as in aes_decrypt_block()
+  memcpy(sched->dec_round_keys[0], round_key, 16);
+  rcon = 0;
+  for (int j = 0; j < num_rounds; j++) {
+    aes_inv_key_expand(round_key, full_key, key_len, &rcon, j);
+    if (j < (num_rounds - 1)) {
+      aes_inv_mix_columns(round_key);
+    }
+    memcpy(sched->dec_round_keys[j + 1], round_key, 16);
+  }
+
+  sched->use_aesni = 0;
+#ifdef AES_MODEL_HAVE_AESNI
+  __builtin_cpu_init();
+  sched->use_aesni = __builtin_cpu_supports("aes") != 0;
+#endif
+
+  return 0;
+}
+
+void aes_encrypt_block_sched(const aes_key_sched_t *sched,
+                             const unsigned char *plain_text,
+                             unsigned char *cipher_text) {
+#ifdef AES_MODEL_HAVE_AESNI
+  if (sched->use_aesni) {
+    aes_aesni_encrypt_block(sched, plain_text, cipher_text);
+    return;
+  }
+#endif
+
+  unsigned char state[16];
+  memcpy(state, plain_text, 16);
+
+  aes_add_round_key(state, sched->enc_round_keys[0]);
+  for (int j = 0; j < sched->num_rounds; j++) {
+    aes_sub_bytes(state);
+    aes_shift_rows(state);
+    if (j < (sched->num_rounds - 1)) {
+      aes_mix_columns(state);
+    }
+    aes_add_round_key(state, sched->enc_round_keys[j + 1]);
+  }
+
+  memcpy(cipher_text, state, 16);
+}
+
+void aes_decrypt_block_sched(const aes_key_sched_t *sched,
+                             const unsigned char *cipher_text,
+                             unsigned char *plain_text) {
+#ifdef AES_MODEL_HAVE_AESNI
+  if (sched->use_aesni) {
+    aes_aesni_decrypt_block(sched, cipher_text, plain_text);
+    return;
+  }
+#endif
+
+  unsigned char state[16];
+  memcpy(state, cipher_text, 16);
+
+  // decrypt - using Equivalent Inverse Cipher
+  aes_add_round_key(state, sched->dec_round_keys[0]);
+  for (int j = 0; j < sched->num_rounds; j++) {
+    aes_inv_sub_bytes(state);
+    aes_inv_shift_rows(state);
+    if (j < (sched->num_rounds - 1)) {
+      aes_inv_mix_columns(state);
+    }
+    aes_add_round_key(state, sched->dec_round_keys[j + 1]);
+  }
+
+  memcpy(plain_text, state, 16);
+}
+
+// Increment a 128-bit big-endian counter, as done for CTR mode
+static void aes_ctr_inc(unsigned char *ctr) {
+  for (int i = 15; i >= 0; i--) {
+    if (++ctr[i]) {
+      break;
+    }
+  }
+}
+
+int aes_crypt_message(const aes_key_sched_t *sched, const int op,
+                      const crypto_mode_t mode, unsigned char *iv,
+                      const unsigned char *input, unsigned char *output,
+                      const int len) {
+  if (len % 16) {
+    printf("ERROR: len = %i is not a multiple of 16\n", len);
+    return -EINVAL;
+  }
+
+  unsigned char data_in[16];
+  unsigned char data_out[16];
+
+  for (int b = 0; b < len; b += 16) {
+    // Keep a copy of the input block as input and output may be the same.
+    memcpy(data_in, &input[b], 16);
+
+    if (mode == kCryptoAesEcb) {
+      if (!op) {
+        aes_encrypt_block_sched(sched, data_in, &output[b]);
+      } else {
+        aes_decrypt_block_sched(sched, data_in, &output[b]);
+      }
+    } else if (mode == kCryptoAesCbc) {
+      if (!op) {
+        for (int i = 0; i < 16; i++) {
+          data_out[i] = data_in[i] ^ iv[i];
+        }
+        aes_encrypt_block_sched(sched, data_out, iv);
+        memcpy(&output[b], iv, 16);
+      } else {
+        aes_decrypt_block_sched(sched, data_in, data_out);
+        for (int i = 0; i < 16; i++) {
+          output[b + i] = data_out[i] ^ iv[i];
+        }
+        memcpy(iv, data_in, 16);
+      }
+    } else if (mode == kCryptoAesCfb || mode == kCryptoAesOfb ||
+               mode == kCryptoAesCtr) {
+      // All three modes only use the forward cipher, on the IV.
+      aes_encrypt_block_sched(sched, iv, data_out);
+      for (int i = 0; i < 16; i++) {
+        output[b + i] = data_out[i] ^ data_in[i];
+      }
+      if (mode == kCryptoAesCfb) {
+        memcpy(iv, op ? data_in : &output[b], 16);
+      } else if (mode == kCryptoAesOfb) {
+        memcpy(iv, data_out, 16);
+      } else {
+        aes_ctr_inc(iv);
+      }
+    } else {
+      printf("ERROR: mode = %i not supported\n", mode);
+      return -EINVAL;
+    }
+  }
+
+  return 0;
+}
+
 void aes_print_block(const unsigned char *data, const int num_bytes) {
   for (int i = 0; i < num_bytes; i++) {
     if ((i > 0) && (i % 8 == 0)) {
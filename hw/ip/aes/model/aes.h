@@ -5,6 +5,24 @@
 #ifndef OPENTITAN_HW_IP_AES_MODEL_AES_H_
 #define OPENTITAN_HW_IP_AES_MODEL_AES_H_
 
+#include "crypto.h"
+
+/**
+ * Expanded key schedule
+ *
+ * Holds the round keys for both the forward and the (Equivalent) Inverse
+ * Cipher so that several blocks can be processed without expanding the key
+ * again for every block.
+ */
+typedef struct aes_key_sched {
+  int key_len;
+  int num_rounds;
+  unsigned char key[32];
+  unsigned char enc_round_keys[15][16];
+  unsigned char dec_round_keys[15][16];
+  int use_aesni;
+} aes_key_sched_t;
+
 /**
  * Encrypt one data block (16 Bytes) in ECB mode.
  *
@@ -30,6 +48,63 @@ int aes_decrypt_block(const unsigned char *cipher_text,
                       const unsigned char *key, const int key_len,
                       unsigned char *plain_text);
 
+/**
+ * Expand a key into a key schedule.
+ *
+ * If the host supports the AES-NI instructions, the schedule is set up to use
+ * them for the block operations, unless the model is compiled with
+ * AES_MODEL_NO_AESNI defined.
+ *
+ * @param  sched   Key schedule to initialize
+ * @param  key     Initial encryption key
+ * @param  key_len Key length in bytes (16, 24, 32)
+ * @return 0 on success, -ERRNO otherwise
+ */
+int aes_key_sched_init(aes_key_sched_t *sched, const unsigned char *key,
+                       const int key_len);
+
+/**
+ * Encrypt one data block (16 Bytes) in ECB mode using a key schedule.
+ *
+ * @param  sched       Key schedule, @see aes_key_sched_init
+ * @param  plain_text  Input block to encrypt
+ * @param  cipher_text Encrypted output block, may be equal to plain_text
+ */
+void aes_encrypt_block_sched(const aes_key_sched_t *sched,
+                             const unsigned char *plain_text,
+                             unsigned char *cipher_text);
+
+/**
+ * Decrypt one data block (16 Bytes) in ECB mode using a key schedule.
+ *
+ * @param  sched       Key schedule, @see aes_key_sched_init
+ * @param  cipher_text Encrypted input block
+ * @param  plain_text  Decrypted output block, may be equal to cipher_text
+ */
+void aes_decrypt_block_sched(const aes_key_sched_t *sched,
+                             const unsigned char *cipher_text,
+                             unsigned char *plain_text);
+
+/**
+ * Encrypt/decrypt a message of one or more blocks using a key schedule.
+ *
+ * The IV is updated as the hardware would update it, so a message can be
+ * processed in several calls.
+ *
+ * @param  sched   Key schedule, @see aes_key_sched_init
+ * @param  op      Operation: 0 = encrypt, 1 = decrypt
+ * @param  mode    AES cipher mode (ECB, CBC, CFB, OFB or CTR)
+ * @param  iv      16-byte initialization vector, not used for ECB
+ * @param  input   Input data, must be a multiple of 16 bytes
+ * @param  output  Output data, may be equal to input
+ * @param  len     Length of the input data in bytes, must be a multiple of 16
+ * @return 0 on success, -ERRNO otherwise
+ */
+int aes_crypt_message(const aes_key_sched_t *sched, const int op,
+                      const crypto_mode_t mode, unsigned char *iv,
+                      const unsigned char *input, unsigned char *output,
+                      const int len);
+
 /**
  * Print block of data in readable format to stdout
  *
@@ -8,18 +8,17 @@
 #include "Vcircuit.h"
 #include "testbench.h"
 
-int main(int argc, char **argv) {
-  Verilated::commandArgs(argc, argv);
-  Testbench<Vcircuit> tb;
-  tb.opentrace("tmp.vcd");
-
+// One run of the bench, see run_testbench() for the plusargs that select
+// how many runs there are and whether their data is random.
+static void run(Testbench<Vcircuit> &tb) {
   tb.reset();
 
   // Data signals - we don't really care about the data fed to the module.
-  // The whole tracing is really just about control signals.
-  tb.m_core.data_i = 0x12;
-  tb.m_core.mask_i = 0x34;
-  tb.m_core.prd_i = 0x56789AB;
+  // The whole tracing is really just about control signals. For randomized
+  // runs, prd_i has the 28 bits of the DOM S-Box.
+  tb.m_core.data_i = tb.stimulus(0x12, 8);
+  tb.m_core.mask_i = tb.stimulus(0x34, 8);
+  tb.m_core.prd_i = tb.stimulus(0x56789AB, 28);
 
   // Control signals
   tb.m_core.op_i = 0;  // encrypt
@@ -34,6 +33,9 @@ int main(int argc, char **argv) {
     tb.tick();
   }
   tb.tick();
+}
 
-  tb.closetrace();
+int main(int argc, char **argv) {
+  Verilated::commandArgs(argc, argv);
+  return run_testbench<Vcircuit>("tmp", run);
 }
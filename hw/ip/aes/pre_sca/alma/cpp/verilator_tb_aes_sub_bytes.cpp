@@ -8,19 +8,17 @@
 #include "Vcircuit.h"
 #include "testbench.h"
 
-int main(int argc, char **argv) {
-  Verilated::commandArgs(argc, argv);
-  Testbench<Vcircuit> tb;
-  tb.opentrace("tmp.vcd");
-
+// One run of the bench, see run_testbench() for the plusargs that select
+// how many runs there are and whether their data is random.
+static void run(Testbench<Vcircuit> &tb) {
   tb.reset();
 
   // Data signals - we don't really care about the data fed to the module.
   // The whole tracing is really just about control signals.
   for (int i = 0; i < 4; ++i) {
-    tb.m_core.data_i[i] = i;
-    tb.m_core.mask_i[i] = 4 + i;
-    tb.m_core.prd_i[i] = 8 + i;
+    tb.m_core.data_i[i] = tb.stimulus(i, 32);
+    tb.m_core.mask_i[i] = tb.stimulus(4 + i, 32);
+    tb.m_core.prd_i[i] = tb.stimulus(8 + i, 32);
   }
 
   // Control signals
@@ -36,6 +34,9 @@ int main(int argc, char **argv) {
     tb.tick();
   }
   tb.tick();
+}
 
-  tb.closetrace();
+int main(int argc, char **argv) {
+  Verilated::commandArgs(argc, argv);
+  return run_testbench<Vcircuit>("tmp", run);
 }
@@ -6,7 +6,9 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "hash_stream.h"
 #include "hmac.h"
 #include "hmac_wrap.h"
 #include "sha.h"
@@ -198,3 +200,76 @@ extern void c_dpi_HMAC_SHA512(const svOpenArrayHandle key, uint64_t key_len,
 
   free(key_arr);
 }
+
+extern void *c_dpi_hash_stream_new(int alg, int hmac_en,
+                                   const svOpenArrayHandle key,
+                                   uint64_t key_len) {
+  uint8_t *key_arr = NULL;
+  if (hmac_en && key_len > 0u) {
+    key_arr = collect_bytes(key, key_len);
+    assert(key_arr);
+  }
+
+  hash_stream_t *ctx = (hash_stream_t *)malloc(sizeof(hash_stream_t));
+  assert(ctx);
+  if (hash_stream_init(ctx, (hash_stream_alg_t)alg, hmac_en, key_arr,
+                       key_len)) {
+    printf("ERROR: c_dpi_hash_stream_new: Unknown algorithm %d\n", alg);
+    free(ctx);
+    ctx = NULL;
+  }
+
+  free(key_arr);
+  return ctx;
+}
+
+extern void *c_dpi_hash_stream_copy(void *ctx) {
+  assert(ctx);
+  hash_stream_t *copy = (hash_stream_t *)malloc(sizeof(hash_stream_t));
+  assert(copy);
+  memcpy(copy, ctx, sizeof(hash_stream_t));
+  return copy;
+}
+
+extern void c_dpi_hash_stream_free(void *ctx) { free(ctx); }
+
+extern void c_dpi_hash_stream_update(void *ctx, const svOpenArrayHandle msg,
+                                     uint64_t len) {
+  assert(ctx);
+  if (len > 0u) {
+    uint8_t *arr = collect_bytes(msg, len);
+    assert(arr);
+    hash_stream_update((hash_stream_t *)ctx, arr, len);
+    free(arr);
+  }
+}
+
+extern void c_dpi_hash_stream_digest(void *ctx, uint32_t digest[16]) {
+  assert(ctx);
+  // As with c_dpi_SHA512_hash() etc., the digest bytes are copied into the
+  // words as they are. Any words past the end of the digest are zero.
+  memset(digest, 0, 16 * sizeof(uint32_t));
+  hash_stream_digest((const hash_stream_t *)ctx, (uint8_t *)digest);
+}
+
+extern int c_dpi_hash_stream_save(void *ctx, uint64_t digest[8],
+                                  uint64_t *msg_len_bits) {
+  assert(ctx);
+  if (hash_stream_save((const hash_stream_t *)ctx, digest, msg_len_bits)) {
+    printf("ERROR: c_dpi_hash_stream_save: Not at a block boundary\n");
+    return -1;
+  }
+  return 0;
+}
+
+extern int c_dpi_hash_stream_restore(void *ctx, const uint64_t digest[8],
+                                     uint64_t msg_len_bits) {
+  assert(ctx);
+  if (hash_stream_restore((hash_stream_t *)ctx, digest, msg_len_bits)) {
+    printf("ERROR: c_dpi_hash_stream_restore: Message length %llu is not a "
+           "whole number of blocks\n",
+           (unsigned long long)msg_len_bits);
+    return -1;
+  }
+  return 0;
+}
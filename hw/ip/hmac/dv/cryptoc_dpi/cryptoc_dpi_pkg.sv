@@ -54,6 +54,41 @@ package cryptoc_dpi_pkg;
                                                          input longint unsigned msg_len,
                                                          output int unsigned hmac[16]);
 
+  // Streaming SHA-2 / HMAC contexts (see hash_stream.h), which use the SHA extensions where the
+  // host has them. alg is 0 for SHA2-256, 1 for SHA2-384 and 2 for SHA2-512. The digest is returned
+  // in the same form as by c_dpi_SHA512_hash, with any words past the end of a shorter digest set
+  // to zero. A digest can be read at any point without ending the stream.
+  //
+  // c_dpi_hash_stream_save and c_dpi_hash_stream_restore read and write the context in the form
+  // that the HMAC block saves it (one intermediate digest word per entry and the message length in
+  // bits, not counting the key block in HMAC mode). As in hardware, this only works at a block
+  // boundary. Both return 0 on success.
+  import "DPI-C" context function chandle c_dpi_hash_stream_new(input int alg,
+                                                                input bit hmac_en,
+                                                                input bit[7:0] key[],
+                                                                input longint unsigned key_len);
+
+  import "DPI-C" context function chandle c_dpi_hash_stream_copy(input chandle ctx);
+
+  import "DPI-C" context function void c_dpi_hash_stream_free(input chandle ctx);
+
+  import "DPI-C" context function void c_dpi_hash_stream_update(input chandle ctx,
+                                                                input bit[7:0] msg[],
+                                                                input longint unsigned len);
+
+  import "DPI-C" context function void c_dpi_hash_stream_digest(input chandle ctx,
+                                                                output int unsigned digest[16]);
+
+  import "DPI-C" context function int c_dpi_hash_stream_save(
+                                                   input chandle ctx,
+                                                   output longint unsigned digest[8],
+                                                   output longint unsigned msg_len_bits);
+
+  import "DPI-C" context function int c_dpi_hash_stream_restore(
+                                                   input chandle ctx,
+                                                   input longint unsigned digest[8],
+                                                   input longint unsigned msg_len_bits);
+
   // sv wrapper functions
   function automatic void sv_dpi_get_sha_digest(input bit[7:0] msg[],
                                                 output int unsigned hash[8]);
@@ -115,4 +150,19 @@ package cryptoc_dpi_pkg;
     c_dpi_HMAC_SHA512(ckey, ckey.size(), msg, msg.size(), hmac);
   endfunction
 
+  function automatic chandle sv_dpi_hash_stream_new(input int       alg,
+                                                     input bit       hmac_en,
+                                                     input bit[31:0] key[]);
+    bit [7:0] ckey[];
+    int ckey_size_bytes = $bits(key) / 8;
+    ckey = new[ckey_size_bytes];
+    {>>{ckey}} = key;
+    return c_dpi_hash_stream_new(alg, hmac_en, ckey, ckey.size());
+  endfunction
+
+  function automatic void sv_dpi_hash_stream_update(input chandle  ctx,
+                                                    input bit[7:0] msg[]);
+    c_dpi_hash_stream_update(ctx, msg, msg.size());
+  endfunction
+
 endpackage
@@ -0,0 +1,448 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "hash_stream.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(HASH_STREAM_NO_ACCEL)
+#define HASH_STREAM_SHANI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+static const uint32_t kSha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static const uint64_t kSha512K[80] = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f,
+    0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019,
+    0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+    0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+    0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+    0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+    0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275,
+    0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f,
+    0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+    0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc,
+    0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+    0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+    0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+    0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+    0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99,
+    0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+    0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc,
+    0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915,
+    0xc67178f2e372532b, 0xca273eceea26619c, 0xd186b8c721c0c207,
+    0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+    0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+    0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+    0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+
+static const uint32_t kSha256Init[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                        0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                        0x1f83d9ab, 0x5be0cd19};
+
+static const uint64_t kSha384Init[8] = {
+    0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17,
+    0x152fecd8f70e5939, 0x67332667ffc00b31, 0x8eb44a8768581511,
+    0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4};
+
+static const uint64_t kSha512Init[8] = {
+    0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b,
+    0xa54ff53a5f1d36f1, 0x510e527fade682d1, 0x9b05688c2b3e6c1f,
+    0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+
+static inline uint32_t ror32(uint32_t x, int n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+static inline uint64_t ror64(uint64_t x, int n) {
+  return (x >> n) | (x << (64 - n));
+}
+
+static inline uint32_t load_be32(const uint8_t *p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint64_t load_be64(const uint8_t *p) {
+  return ((uint64_t)load_be32(p) << 32) | load_be32(p + 4);
+}
+
+static inline void store_be32(uint8_t *p, uint32_t x) {
+  p[0] = (uint8_t)(x >> 24);
+  p[1] = (uint8_t)(x >> 16);
+  p[2] = (uint8_t)(x >> 8);
+  p[3] = (uint8_t)x;
+}
+
+static inline void store_be64(uint8_t *p, uint64_t x) {
+  store_be32(p, (uint32_t)(x >> 32));
+  store_be32(p + 4, (uint32_t)x);
+}
+
+static void sha256_blocks_portable(uint32_t h[8], const uint8_t *data,
+                                   size_t num_blocks) {
+  for (; num_blocks; num_blocks--, data += 64) {
+    uint32_t w[64];
+    for (int t = 0; t < 16; t++)
+      w[t] = load_be32(data + 4 * t);
+    for (int t = 16; t < 64; t++) {
+      uint32_t s0 = ror32(w[t - 15], 7) ^ ror32(w[t - 15], 18) ^
+                    (w[t - 15] >> 3);
+      uint32_t s1 = ror32(w[t - 2], 17) ^ ror32(w[t - 2], 19) ^
+                    (w[t - 2] >> 10);
+      w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5],
+             g = h[6], hh = h[7];
+    for (int t = 0; t < 64; t++) {
+      uint32_t s1 = ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25);
+      uint32_t ch = (e & f) ^ (~e & g);
+      uint32_t t1 = hh + s1 + ch + kSha256K[t] + w[t];
+      uint32_t s0 = ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22);
+      uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+      hh = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + s0 + maj;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += hh;
+  }
+}
+
+static void sha512_blocks(uint64_t h[8], const uint8_t *data,
+                          size_t num_blocks) {
+  for (; num_blocks; num_blocks--, data += 128) {
+    uint64_t w[80];
+    for (int t = 0; t < 16; t++)
+      w[t] = load_be64(data + 8 * t);
+    for (int t = 16; t < 80; t++) {
+      uint64_t s0 = ror64(w[t - 15], 1) ^ ror64(w[t - 15], 8) ^
+                    (w[t - 15] >> 7);
+      uint64_t s1 = ror64(w[t - 2], 19) ^ ror64(w[t - 2], 61) ^
+                    (w[t - 2] >> 6);
+      w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+
+    uint64_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5],
+             g = h[6], hh = h[7];
+    for (int t = 0; t < 80; t++) {
+      uint64_t s1 = ror64(e, 14) ^ ror64(e, 18) ^ ror64(e, 41);
+      uint64_t ch = (e & f) ^ (~e & g);
+      uint64_t t1 = hh + s1 + ch + kSha512K[t] + w[t];
+      uint64_t s0 = ror64(a, 28) ^ ror64(a, 34) ^ ror64(a, 39);
+      uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
+      hh = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + s0 + maj;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += hh;
+  }
+}
+
+#ifdef HASH_STREAM_SHANI
+// SHA2-256 with the SHA-NI instructions, which do two rounds at a time on a
+// state split into ABEF and CDGH halves.
+__attribute__((target("sha,sse4.1"))) static void sha256_blocks_shani(
+    uint32_t h[8], const uint8_t *data, size_t num_blocks) {
+  const __m128i bswap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&h[0]),
+                                  0xb1);  // CDAB
+  __m128i state1 = _mm_shuffle_epi32(
+      _mm_loadu_si128((const __m128i *)&h[4]), 0x1b);  // EFGH
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);    // ABEF
+  state1 = _mm_blend_epi16(state1, tmp, 0xf0);         // CDGH
+
+  for (; num_blocks; num_blocks--, data += 64) {
+    const __m128i abef = state0, cdgh = state1;
+    __m128i w[4];
+
+#pragma GCC unroll 16
+    for (int i = 0; i < 16; i++) {
+      if (i < 4) {
+        w[i] = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *)(data + 16 * i)), bswap);
+      } else {
+        // W[4i..4i+3] from the previous 16 words
+        const __m128i w1 = w[(i + 1) % 4], w2 = w[(i + 2) % 4],
+                      w3 = w[(i + 3) % 4];
+        __m128i x = _mm_sha256msg1_epu32(w[i % 4], w1);
+        x = _mm_add_epi32(x, _mm_alignr_epi8(w3, w2, 4));
+        w[i % 4] = _mm_sha256msg2_epu32(x, w3);
+      }
+      __m128i msg = _mm_add_epi32(
+          w[i % 4], _mm_loadu_si128((const __m128i *)&kSha256K[4 * i]));
+      state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+      state0 = _mm_sha256rnds2_epu32(state0, state1,
+                                     _mm_shuffle_epi32(msg, 0x0e));
+    }
+
+    state0 = _mm_add_epi32(state0, abef);
+    state1 = _mm_add_epi32(state1, cdgh);
+  }
+
+  tmp = _mm_shuffle_epi32(state0, 0x1b);        // FEBA
+  state1 = _mm_shuffle_epi32(state1, 0xb1);     // DCHG
+  state0 = _mm_blend_epi16(tmp, state1, 0xf0);  // DCBA
+  state1 = _mm_alignr_epi8(state1, tmp, 8);     // HGFE
+  _mm_storeu_si128((__m128i *)&h[0], state0);
+  _mm_storeu_si128((__m128i *)&h[4], state1);
+}
+
+static int host_has_shani(void) {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1))
+    return 0;
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    return 0;
+  return (ebx & bit_SHA) != 0;
+}
+#endif  // HASH_STREAM_SHANI
+
+// -1 until the first call to sha256_blocks() or hash_stream_use_accel()
+static int use_shani = -1;
+
+int hash_stream_use_accel(int enable) {
+#ifdef HASH_STREAM_SHANI
+  use_shani = enable && host_has_shani();
+#else
+  (void)enable;
+  use_shani = 0;
+#endif
+  return use_shani;
+}
+
+static void sha256_blocks(uint32_t h[8], const uint8_t *data,
+                          size_t num_blocks) {
+  if (use_shani < 0)
+    hash_stream_use_accel(1);
+#ifdef HASH_STREAM_SHANI
+  if (use_shani) {
+    sha256_blocks_shani(h, data, num_blocks);
+    return;
+  }
+#endif
+  sha256_blocks_portable(h, data, num_blocks);
+}
+
+size_t hash_stream_block_size(hash_stream_alg_t alg) {
+  switch (alg) {
+    case kHashStreamSha256:
+      return 64;
+    case kHashStreamSha384:
+    case kHashStreamSha512:
+      return 128;
+    default:
+      return 0;
+  }
+}
+
+size_t hash_stream_digest_size(hash_stream_alg_t alg) {
+  switch (alg) {
+    case kHashStreamSha256:
+      return 32;
+    case kHashStreamSha384:
+      return 48;
+    case kHashStreamSha512:
+      return 64;
+    default:
+      return 0;
+  }
+}
+
+static void compress(hash_stream_t *s, const uint8_t *data,
+                     size_t num_blocks) {
+  if (s->alg == kHashStreamSha256) {
+    sha256_blocks(s->state.h32, data, num_blocks);
+  } else {
+    sha512_blocks(s->state.h64, data, num_blocks);
+  }
+}
+
+// Reset s to the initial state of its hash function
+static void reset_state(hash_stream_t *s) {
+  switch (s->alg) {
+    case kHashStreamSha256:
+      memcpy(s->state.h32, kSha256Init, sizeof(kSha256Init));
+      break;
+    case kHashStreamSha384:
+      memcpy(s->state.h64, kSha384Init, sizeof(kSha384Init));
+      break;
+    default:
+      memcpy(s->state.h64, kSha512Init, sizeof(kSha512Init));
+      break;
+  }
+  s->count = 0;
+}
+
+void hash_stream_update(hash_stream_t *s, const uint8_t *data, size_t len) {
+  const size_t block_size = hash_stream_block_size(s->alg);
+  size_t used = (size_t)(s->count % block_size);
+  s->count += len;
+
+  if (used) {
+    size_t n = block_size - used;
+    if (len < n) {
+      memcpy(s->buf + used, data, len);
+      return;
+    }
+    memcpy(s->buf + used, data, n);
+    compress(s, s->buf, 1);
+    data += n;
+    len -= n;
+  }
+
+  if (len >= block_size) {
+    compress(s, data, len / block_size);
+    data += len - len % block_size;
+    len %= block_size;
+  }
+  memcpy(s->buf, data, len);
+}
+
+// Pad and finish a copy of a plain hash and write its digest
+static void finish_hash(hash_stream_t *s, uint8_t *digest) {
+  const size_t block_size = hash_stream_block_size(s->alg);
+  // The length field is 64 bits for SHA2-256 and 128 bits for SHA2-384/512 (but
+  // the top half is always zero here).
+  const size_t len_size = block_size / 8;
+  const uint64_t bit_len = s->count * 8;
+
+  size_t used = (size_t)(s->count % block_size);
+  s->buf[used++] = 0x80;
+  if (used > block_size - len_size) {
+    memset(s->buf + used, 0, block_size - used);
+    compress(s, s->buf, 1);
+    used = 0;
+  }
+  memset(s->buf + used, 0, block_size - 8 - used);
+  store_be64(s->buf + block_size - 8, bit_len);
+  compress(s, s->buf, 1);
+
+  const size_t digest_size = hash_stream_digest_size(s->alg);
+  if (s->alg == kHashStreamSha256) {
+    for (size_t i = 0; i < digest_size / 4; i++)
+      store_be32(digest + 4 * i, s->state.h32[i]);
+  } else {
+    for (size_t i = 0; i < digest_size / 8; i++)
+      store_be64(digest + 8 * i, s->state.h64[i]);
+  }
+}
+
+int hash_stream_init(hash_stream_t *s, hash_stream_alg_t alg, int hmac,
+                     const uint8_t *key, size_t key_len) {
+  const size_t block_size = hash_stream_block_size(alg);
+  if (!block_size)
+    return -1;
+
+  memset(s, 0, sizeof(*s));
+  s->alg = alg;
+  s->hmac = hmac != 0;
+  reset_state(s);
+  if (!s->hmac)
+    return 0;
+
+  uint8_t ipad[HASH_STREAM_MAX_BLOCK_SIZE] = {0};
+  if (key_len > block_size) {
+    hash_stream_update(s, key, key_len);
+    finish_hash(s, ipad);
+    reset_state(s);
+  } else if (key_len) {
+    memcpy(ipad, key, key_len);
+  }
+  for (size_t i = 0; i < block_size; i++) {
+    s->opad[i] = ipad[i] ^ 0x5c;
+    ipad[i] ^= 0x36;
+  }
+  hash_stream_update(s, ipad, block_size);
+  return 0;
+}
+
+void hash_stream_digest(const hash_stream_t *s, uint8_t *digest) {
+  hash_stream_t tmp = *s;
+  if (!s->hmac) {
+    finish_hash(&tmp, digest);
+    return;
+  }
+
+  uint8_t inner[HASH_STREAM_MAX_DIGEST_SIZE];
+  finish_hash(&tmp, inner);
+  reset_state(&tmp);
+  hash_stream_update(&tmp, s->opad, hash_stream_block_size(s->alg));
+  hash_stream_update(&tmp, inner, hash_stream_digest_size(s->alg));
+  finish_hash(&tmp, digest);
+}
+
+int hash_stream_save(const hash_stream_t *s, uint64_t digest[8],
+                     uint64_t *msg_len_bits) {
+  const size_t block_size = hash_stream_block_size(s->alg);
+  if (s->count % block_size)
+    return -1;
+
+  for (int i = 0; i < 8; i++) {
+    digest[i] =
+        (s->alg == kHashStreamSha256) ? s->state.h32[i] : s->state.h64[i];
+  }
+  *msg_len_bits = (s->count - (s->hmac ? block_size : 0)) * 8;
+  return 0;
+}
+
+int hash_stream_restore(hash_stream_t *s, const uint64_t digest[8],
+                        uint64_t msg_len_bits) {
+  const size_t block_size = hash_stream_block_size(s->alg);
+  if (msg_len_bits % (8 * block_size))
+    return -1;
+
+  for (int i = 0; i < 8; i++) {
+    if (s->alg == kHashStreamSha256) {
+      s->state.h32[i] = (uint32_t)digest[i];
+    } else {
+      s->state.h64[i] = digest[i];
+    }
+  }
+  s->count = msg_len_bits / 8 + (s->hmac ? block_size : 0);
+  return 0;
+}
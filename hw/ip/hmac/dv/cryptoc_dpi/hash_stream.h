@@ -0,0 +1,136 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_IP_HMAC_DV_CRYPTOC_DPI_HASH_STREAM_H_
+#define OPENTITAN_HW_IP_HMAC_DV_CRYPTOC_DPI_HASH_STREAM_H_
+
+/*
+ * Streaming SHA-2 and HMAC contexts for the HMAC testbench.
+ *
+ * These give the same results as the cryptoc functions in this directory, but
+ * process whole blocks at a time and can use the x86 SHA extensions for
+ * SHA2-256. A context can also be saved and restored in the same form as the
+ * HMAC block's context (the intermediate digest and the message length), so a
+ * model can follow the hardware through a hash_stop / hash_continue sequence
+ * without hashing the message again from the start.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum hash_stream_alg {
+  kHashStreamSha256 = 0,
+  kHashStreamSha384 = 1,
+  kHashStreamSha512 = 2,
+} hash_stream_alg_t;
+
+#define HASH_STREAM_MAX_BLOCK_SIZE 128
+#define HASH_STREAM_MAX_DIGEST_SIZE 64
+
+typedef struct hash_stream {
+  hash_stream_alg_t alg;
+  int hmac;
+
+  // The intermediate digest. SHA2-256 uses the first 8 32-bit words and
+  // SHA2-384/512 use the 64-bit words.
+  union {
+    uint32_t h32[8];
+    uint64_t h64[8];
+  } state;
+
+  // The number of bytes absorbed so far (including the inner key block for
+  // HMAC) and the partial block that hasn't been compressed yet.
+  uint64_t count;
+  uint8_t buf[HASH_STREAM_MAX_BLOCK_SIZE];
+
+  // For HMAC, the key XORed with the outer pad
+  uint8_t opad[HASH_STREAM_MAX_BLOCK_SIZE];
+} hash_stream_t;
+
+/**
+ * Return the block size of alg in bytes (or 0 if alg is not valid).
+ */
+size_t hash_stream_block_size(hash_stream_alg_t alg);
+
+/**
+ * Return the digest size of alg in bytes (or 0 if alg is not valid).
+ */
+size_t hash_stream_digest_size(hash_stream_alg_t alg);
+
+/**
+ * Start a new SHA-2 or (if hmac is nonzero) HMAC computation.
+ *
+ * As with the cryptoc HMAC functions, a key longer than a block is hashed
+ * first. key is ignored unless hmac is set.
+ *
+ * @param s       Context to initialize
+ * @param alg     Hash function
+ * @param hmac    If nonzero, compute an HMAC with the given key
+ * @param key     HMAC key
+ * @param key_len Length of key in bytes
+ * @return 0 on success, -1 if alg is not valid
+ */
+int hash_stream_init(hash_stream_t *s, hash_stream_alg_t alg, int hmac,
+                     const uint8_t *key, size_t key_len);
+
+/**
+ * Add len bytes of message to the computation.
+ */
+void hash_stream_update(hash_stream_t *s, const uint8_t *data, size_t len);
+
+/**
+ * Write the digest (or HMAC) of the message so far to digest, which must have
+ * space for hash_stream_digest_size() bytes. This doesn't change s, so more
+ * message can be added afterwards.
+ */
+void hash_stream_digest(const hash_stream_t *s, uint8_t *digest);
+
+/**
+ * Read out the context in the form that the HMAC block saves it: the
+ * intermediate digest and the message length in bits. In HMAC mode, the message
+ * length doesn't include the inner key block.
+ *
+ * As in hardware, this is only possible at a block boundary.
+ *
+ * @param s            Context to read
+ * @param digest       Output: the intermediate digest, with one 64-bit entry
+ *                     per word (SHA2-256 only uses the bottom halves)
+ * @param msg_len_bits Output: the message length so far, in bits
+ * @return 0 on success, -1 if s is not at a block boundary
+ */
+int hash_stream_save(const hash_stream_t *s, uint64_t digest[8],
+                     uint64_t *msg_len_bits);
+
+/**
+ * Restore a context that was read out with hash_stream_save() (or from the
+ * hardware). The hash function, mode and key are those that s was initialized
+ * with, just like the CFG and KEY registers stay as they are on a restore.
+ *
+ * @param s            Context to update
+ * @param digest       The intermediate digest
+ * @param msg_len_bits The message length so far in bits, which must be a whole
+ *                     number of blocks
+ * @return 0 on success, -1 if msg_len_bits is not a whole number of blocks
+ */
+int hash_stream_restore(hash_stream_t *s, const uint64_t digest[8],
+                        uint64_t msg_len_bits);
+
+/**
+ * Choose whether to use the SHA extensions (where the host has them). They are
+ * used by default unless HASH_STREAM_NO_ACCEL was defined at build time.
+ *
+ * @param enable Nonzero to use the SHA extensions if possible
+ * @return Nonzero if the SHA extensions will be used
+ */
+int hash_stream_use_accel(int enable);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // OPENTITAN_HW_IP_HMAC_DV_CRYPTOC_DPI_HASH_STREAM_H_
@@ -0,0 +1,144 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "hash_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hmac_wrap.h"
+#include "sha256.h"
+#include "sha384.h"
+#include "sha512.h"
+
+namespace hash_stream_test {
+namespace {
+
+constexpr size_t kNumMsgs = 100;
+constexpr size_t kMaxKeyLen = 300;
+constexpr size_t kMaxMsgLen = 1000;
+
+// The digest from cryptoc
+std::vector<uint8_t> CryptocDigest(hash_stream_alg_t alg, bool hmac,
+                                   const std::vector<uint8_t> &key,
+                                   const uint8_t *msg, size_t msg_len) {
+  std::vector<uint8_t> digest(hash_stream_digest_size(alg));
+  switch (alg) {
+    case kHashStreamSha256:
+      hmac ? HMAC_SHA256(key.data(), key.size(), msg, msg_len, digest.data())
+           : SHA256_hash(msg, msg_len, digest.data());
+      break;
+    case kHashStreamSha384:
+      hmac ? HMAC_SHA384(key.data(), key.size(), msg, msg_len, digest.data())
+           : SHA384_hash(msg, msg_len, digest.data());
+      break;
+    default:
+      hmac ? HMAC_SHA512(key.data(), key.size(), msg, msg_len, digest.data())
+           : SHA512_hash(msg, msg_len, digest.data());
+      break;
+  }
+  return digest;
+}
+
+// Parameters: hash function, HMAC mode and whether to use the SHA extensions
+class HashStreamTest
+    : public testing::TestWithParam<std::tuple<hash_stream_alg_t, bool, bool>> {
+ protected:
+  void SetUp() override {
+    std::tie(alg_, hmac_, accel_) = GetParam();
+    if (hash_stream_use_accel(accel_) != accel_) {
+      GTEST_SKIP() << "SHA extensions not available on this host";
+    }
+  }
+
+  void TearDown() override { hash_stream_use_accel(1); }
+
+  std::vector<uint8_t> RandomBytes(size_t len) {
+    std::vector<uint8_t> bytes(len);
+    for (uint8_t &byte : bytes) {
+      byte = rng_();
+    }
+    return bytes;
+  }
+
+  std::vector<uint8_t> Digest(const hash_stream_t &s) {
+    std::vector<uint8_t> digest(hash_stream_digest_size(alg_));
+    hash_stream_digest(&s, digest.data());
+    return digest;
+  }
+
+  hash_stream_alg_t alg_;
+  bool hmac_;
+  bool accel_;
+  std::mt19937 rng_{1};
+};
+
+// Feed each message in random chunks, comparing the digest of every prefix
+// with cryptoc and saving and restoring the context at each block boundary.
+TEST_P(HashStreamTest, MatchesCryptoc) {
+  const size_t block_size = hash_stream_block_size(alg_);
+  for (size_t i = 0; i < kNumMsgs; ++i) {
+    std::vector<uint8_t> key = RandomBytes(hmac_ ? rng_() % kMaxKeyLen : 0);
+    std::vector<uint8_t> msg = RandomBytes(rng_() % kMaxMsgLen);
+
+    hash_stream_t s;
+    ASSERT_EQ(hash_stream_init(&s, alg_, hmac_, key.data(), key.size()), 0);
+    size_t pos = 0;
+    while (true) {
+      EXPECT_EQ(Digest(s), CryptocDigest(alg_, hmac_, key, msg.data(), pos))
+          << "after " << pos << " of " << msg.size() << " bytes";
+
+      uint64_t saved[8], msg_len_bits;
+      if (pos % block_size == 0) {
+        ASSERT_EQ(hash_stream_save(&s, saved, &msg_len_bits), 0)
+            << "at " << pos << " bytes";
+        EXPECT_EQ(msg_len_bits, 8 * pos);
+        hash_stream_t restored;
+        ASSERT_EQ(
+            hash_stream_init(&restored, alg_, hmac_, key.data(), key.size()),
+            0);
+        ASSERT_EQ(hash_stream_restore(&restored, saved, msg_len_bits), 0);
+        EXPECT_EQ(std::memcmp(&restored.state, &s.state, sizeof(s.state)), 0)
+            << "at " << pos << " bytes";
+        EXPECT_EQ(restored.count, s.count);
+      } else {
+        EXPECT_EQ(hash_stream_save(&s, saved, &msg_len_bits), -1)
+            << "at " << pos << " bytes";
+      }
+
+      if (pos == msg.size()) {
+        break;
+      }
+
+      // Feed a random chunk, sometimes ending exactly on a block boundary
+      size_t chunk = rng_() % (3 * block_size) + 1;
+      if (rng_() % 4 == 0) {
+        chunk = block_size - pos % block_size;
+      }
+      chunk = std::min(chunk, msg.size() - pos);
+      hash_stream_update(&s, msg.data() + pos, chunk);
+      pos += chunk;
+    }
+  }
+}
+
+TEST_P(HashStreamTest, RestoreRejectsPartialBlock) {
+  hash_stream_t s;
+  ASSERT_EQ(hash_stream_init(&s, alg_, hmac_, nullptr, 0), 0);
+  uint64_t digest[8] = {0};
+  EXPECT_EQ(hash_stream_restore(&s, digest, 8), -1);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllModes, HashStreamTest,
+    testing::Combine(testing::Values(kHashStreamSha256, kHashStreamSha384,
+                                     kHashStreamSha512),
+                     testing::Bool(), testing::Bool()));
+
+}  // namespace
+}  // namespace hash_stream_test
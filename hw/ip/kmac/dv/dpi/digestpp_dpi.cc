@@ -6,24 +6,120 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <list>
+#include <vector>
 
 #include "svdpi.h"
 #include "vendor/kerukuro_digestpp/algorithm/kmac.hpp"
 #include "vendor/kerukuro_digestpp/algorithm/sha3.hpp"
 #include "vendor/kerukuro_digestpp/algorithm/shake.hpp"
 
+/**
+ * The state of a streaming hash computation (see c_dpi_digestpp_new).
+ */
+class DigestppStream {
+ public:
+  virtual ~DigestppStream() {}
+
+  /**
+   * Absorb len bytes of message data.
+   */
+  virtual void Absorb(const uint8_t *data, size_t len) = 0;
+
+  /**
+   * Produce len bytes of output. For an XOF, this continues from where the
+   * last call stopped. For a fixed-length hash, this gives the digest of
+   * everything absorbed so far and doesn't change the state.
+   */
+  virtual void Squeeze(uint8_t *out, size_t len) = 0;
+};
+
+// A DigestppStream for a fixed-length hash
+template <typename Hasher>
+class DigestppHashStream : public DigestppStream {
+ public:
+  explicit DigestppHashStream(const Hasher &hasher) : hasher_(hasher) {}
+
+  void Absorb(const uint8_t *data, size_t len) override {
+    hasher_.absorb(data, len);
+  }
+
+  void Squeeze(uint8_t *out, size_t len) override { hasher_.digest(out, len); }
+
+ private:
+  Hasher hasher_;
+};
+
+// A DigestppStream for an extendable-output function
+template <typename Hasher>
+class DigestppXofStream : public DigestppStream {
+ public:
+  explicit DigestppXofStream(const Hasher &hasher) : hasher_(hasher) {}
+
+  void Absorb(const uint8_t *data, size_t len) override {
+    hasher_.absorb(data, len);
+  }
+
+  void Squeeze(uint8_t *out, size_t len) override { hasher_.squeeze(out, len); }
+
+ private:
+  Hasher hasher_;
+};
+
 extern "C" {
 
 //////////////////////
 // HELPER FUNCTIONS //
 //////////////////////
 
+/**
+ * Get a pointer to the elements of an open array of bytes, if the simulator
+ * lays them out in a way that we understand. Returns NULL otherwise. On
+ * success, *stride is the number of bytes between elements: 1 if each element
+ * is stored as a byte or sizeof(svBitVecVal) if it is stored in canonical
+ * form.
+ */
+static uint8_t *get_byte_array_ptr(const svOpenArrayHandle arr,
+                                   uint64_t array_len, size_t *stride) {
+  uint8_t *ptr = (uint8_t *)svGetArrayPtr(arr);
+  uint64_t num_elems = svSize(arr, 1);
+  if (!ptr || svLeft(arr, 1) != 0 || array_len > num_elems) {
+    return NULL;
+  }
+
+  uint64_t size = svSizeOfArray(arr);
+  if (size == num_elems) {
+    *stride = 1;
+  } else if (size == num_elems * sizeof(svBitVecVal)) {
+    *stride = sizeof(svBitVecVal);
+  } else {
+    return NULL;
+  }
+  return ptr;
+}
+
 /**
  * Generic function to load an unsized array from SV memory into C memory.
+ *
+ * Where possible, this reads the array in place rather than making a DPI call
+ * for each element.
  */
 static void load_arr_from_simulator(const svOpenArrayHandle arr,
                                     uint8_t *array_out, uint64_t array_len) {
+  size_t stride;
+  const uint8_t *ptr = get_byte_array_ptr(arr, array_len, &stride);
+  if (ptr && stride == 1) {
+    memcpy(array_out, ptr, array_len);
+    return;
+  }
+  if (ptr) {
+    for (uint64_t i = 0; i < array_len; i++) {
+      array_out[i] = (uint8_t)((const svBitVecVal *)ptr)[i];
+    }
+    return;
+  }
+
   for (uint64_t i = 0; i < array_len; i++) {
     svBitVecVal val;
     svGetBitArrElem1VecVal(&val, arr, i);
@@ -38,6 +134,19 @@ static void write_array_to_simulator(const svOpenArrayHandle arr,
                                      uint8_t *data) {
   uint64_t arr_len = svSize(arr, 1);
 
+  size_t stride;
+  uint8_t *ptr = get_byte_array_ptr(arr, arr_len, &stride);
+  if (ptr && stride == 1) {
+    memcpy(ptr, data, arr_len);
+    return;
+  }
+  if (ptr) {
+    for (uint64_t i = 0; i < arr_len; ++i) {
+      ((svBitVecVal *)ptr)[i] = (svBitVecVal)data[i];
+    }
+    return;
+  }
+
   for (uint64_t i = 0; i < arr_len; ++i) {
     svBitVecVal data_val = (svBitVecVal)data[i];
     svPutBitArrElem1VecVal(arr, &data_val, i);
@@ -358,4 +467,178 @@ extern void c_dpi_kmac256_xof(const svOpenArrayHandle msg, uint64_t msg_len,
   // Return the digest array to SV code
   write_array_to_simulator(digest, digest_arr);
 }
+
+///////////////
+// STREAMING //
+///////////////
+
+// Modes for c_dpi_digestpp_new. These match digestpp_mode_e in
+// digestpp_dpi_pkg.sv.
+enum {
+  kDigestppSha3 = 0,
+  kDigestppShake = 1,
+  kDigestppCshake = 2,
+  kDigestppKmac = 3,
+  kDigestppKmacXof = 4
+};
+
+static DigestppStream *make_stream(int mode, int strength,
+                                   const char *function_name,
+                                   const char *customization_str,
+                                   const uint8_t *key, uint64_t key_len,
+                                   uint64_t output_len) {
+  switch (mode) {
+    case kDigestppSha3:
+      return new DigestppHashStream<digestpp::sha3>(
+          digestpp::sha3(strength));
+
+    case kDigestppShake:
+      if (strength == 128) {
+        return new DigestppXofStream<digestpp::shake128>(
+            digestpp::shake128());
+      }
+      if (strength == 256) {
+        return new DigestppXofStream<digestpp::shake256>(
+            digestpp::shake256());
+      }
+      break;
+
+    case kDigestppCshake:
+      if (strength == 128) {
+        digestpp::cshake128 shake;
+        shake.set_function_name(function_name, strlen(function_name));
+        shake.set_customization(customization_str, strlen(customization_str));
+        return new DigestppXofStream<digestpp::cshake128>(shake);
+      }
+      if (strength == 256) {
+        digestpp::cshake256 shake;
+        shake.set_function_name(function_name, strlen(function_name));
+        shake.set_customization(customization_str, strlen(customization_str));
+        return new DigestppXofStream<digestpp::cshake256>(shake);
+      }
+      break;
+
+    case kDigestppKmac:
+      if (strength == 128) {
+        digestpp::kmac128 kmac(output_len * 8);
+        kmac.set_customization(customization_str, strlen(customization_str));
+        kmac.set_key(key, key_len);
+        return new DigestppHashStream<digestpp::kmac128>(kmac);
+      }
+      if (strength == 256) {
+        digestpp::kmac256 kmac(output_len * 8);
+        kmac.set_customization(customization_str, strlen(customization_str));
+        kmac.set_key(key, key_len);
+        return new DigestppHashStream<digestpp::kmac256>(kmac);
+      }
+      break;
+
+    case kDigestppKmacXof:
+      if (strength == 128) {
+        digestpp::kmac128_xof kmac;
+        kmac.set_customization(customization_str, strlen(customization_str));
+        kmac.set_key(key, key_len);
+        return new DigestppXofStream<digestpp::kmac128_xof>(kmac);
+      }
+      if (strength == 256) {
+        digestpp::kmac256_xof kmac;
+        kmac.set_customization(customization_str, strlen(customization_str));
+        kmac.set_key(key, key_len);
+        return new DigestppXofStream<digestpp::kmac256_xof>(kmac);
+      }
+      break;
+
+    default:
+      fprintf(stderr, "ERROR: Unknown digestpp mode %d.\n", mode);
+      return NULL;
+  }
+
+  fprintf(stderr, "ERROR: Invalid strength %d for digestpp mode %d.\n",
+          strength, mode);
+  return NULL;
+}
+
+/**
+ * Start a streaming hash computation.
+ *
+ * The hash computation is selected by mode and strength: 224, 256, 384 or 512
+ * for SHA3 and 128 or 256 for the others. function_name is only used for
+ * cSHAKE; customization_str for cSHAKE and KMAC; key for KMAC; and output_len
+ * (in bytes) for fixed-length KMAC.
+ *
+ * Returns a handle to pass to c_dpi_digestpp_absorb and
+ * c_dpi_digestpp_squeeze, which must eventually be freed with
+ * c_dpi_digestpp_free. Returns NULL (after printing a message) on failure.
+ */
+extern void *c_dpi_digestpp_new(int mode, int strength,
+                                const char *function_name,
+                                const char *customization_str,
+                                const svOpenArrayHandle key, uint64_t key_len,
+                                uint64_t output_len) {
+  std::vector<uint8_t> key_arr(key_len);
+  if (key_len) {
+    load_arr_from_simulator(key, key_arr.data(), key_len);
+  }
+
+  try {
+    return make_stream(mode, strength, function_name, customization_str,
+                       key_arr.data(), key_len, output_len);
+  } catch (const std::exception &err) {
+    fprintf(stderr, "ERROR: Failed to set up digestpp hash: %s\n", err.what());
+    return NULL;
+  }
+}
+
+/**
+ * Absorb the first len bytes of data into the hash computation for handle.
+ */
+extern void c_dpi_digestpp_absorb(void *handle, const svOpenArrayHandle data,
+                                  uint64_t len) {
+  DigestppStream *stream = (DigestppStream *)handle;
+  if (!stream || !len) {
+    return;
+  }
+
+  size_t stride;
+  const uint8_t *ptr = get_byte_array_ptr(data, len, &stride);
+  if (ptr && stride == 1) {
+    stream->Absorb(ptr, len);
+    return;
+  }
+
+  std::vector<uint8_t> buf(len);
+  load_arr_from_simulator(data, buf.data(), len);
+  stream->Absorb(buf.data(), len);
+}
+
+/**
+ * Fill digest with output from the hash computation for handle.
+ *
+ * For an XOF, this squeezes the next svSize(digest) bytes of output. For
+ * fixed-length hashes, this writes the digest of the message absorbed so far
+ * (and further data can still be absorbed afterwards).
+ */
+extern void c_dpi_digestpp_squeeze(void *handle, svOpenArrayHandle digest) {
+  DigestppStream *stream = (DigestppStream *)handle;
+  if (!stream) {
+    return;
+  }
+
+  std::vector<uint8_t> buf(svSize(digest, 1));
+  try {
+    stream->Squeeze(buf.data(), buf.size());
+  } catch (const std::exception &err) {
+    fprintf(stderr, "ERROR: Failed to squeeze digestpp hash: %s\n",
+            err.what());
+    return;
+  }
+  write_array_to_simulator(digest, buf.data());
+}
+
+/**
+ * Free a handle returned by c_dpi_digestpp_new.
+ */
+extern void c_dpi_digestpp_free(void *handle) {
+  delete (DigestppStream *)handle;
+}
 }
@@ -10,6 +10,15 @@ package digestpp_dpi_pkg;
 
   // parameters
 
+  // Modes for the streaming API (digestpp_new). These match the enum in digestpp_dpi.cc.
+  typedef enum int {
+    DigestppSha3    = 0,
+    DigestppShake   = 1,
+    DigestppCshake  = 2,
+    DigestppKmac    = 3,
+    DigestppKmacXof = 4
+  } digestpp_mode_e;
+
   // DPI-C imports
   import "DPI-C" context function void c_dpi_sha3_224(
     input bit[7:0]          msg[],
@@ -107,4 +116,33 @@ package digestpp_dpi_pkg;
     output bit[7:0]         digest[]
   );
 
+  // Streaming API. Rather than hashing a whole message in one call, create a handle with
+  // c_dpi_digestpp_new, feed it message data with c_dpi_digestpp_absorb (in as many chunks as is
+  // convenient) and read the output with c_dpi_digestpp_squeeze. Free the handle with
+  // c_dpi_digestpp_free when done. See digestpp_dpi.cc for the meaning of each argument.
+  import "DPI-C" context function chandle c_dpi_digestpp_new(
+    input int               mode,
+    input int               strength,
+    input string            function_name,
+    input string            customization_str,
+    input bit[7:0]          key[],
+    input longint unsigned  key_len,
+    input longint unsigned  output_len
+  );
+
+  import "DPI-C" context function void c_dpi_digestpp_absorb(
+    input chandle           handle,
+    input bit[7:0]          data[],
+    input longint unsigned  len
+  );
+
+  import "DPI-C" context function void c_dpi_digestpp_squeeze(
+    input chandle           handle,
+    output bit[7:0]         digest[]
+  );
+
+  import "DPI-C" context function void c_dpi_digestpp_free(
+    input chandle           handle
+  );
+
 endpackage
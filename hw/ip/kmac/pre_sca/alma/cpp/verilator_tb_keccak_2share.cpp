@@ -8,23 +8,22 @@
 #include "Vcircuit.h"
 #include "testbench.h"
 
-int main(int argc, char **argv) {
-  Verilated::commandArgs(argc, argv);
-  Testbench<Vcircuit> tb;
-  tb.opentrace("tmp.vcd");
-
+// One run of the bench, see run_testbench() for the plusargs that select
+// how many runs there are and whether their data is random.
+static void run(Testbench<Vcircuit> &tb) {
   tb.reset();
 
   // Data signals - we don't really care about the data fed to the module.
   // The whole tracing is really just about control signals.
-  tb.m_core.rand_i = 0x0123456789ABCDEF;
+  // With WIDTH = 50, randomized runs drive the 25 bits of rand_i.
+  tb.m_core.rand_i = tb.stimulus(0x0123456789ABCDEF, 25);
   tb.m_core.rand_aux_i = 0x0;
   // With WIDTH = 50, we should drive 100 = 3 * 32 + 4 bits. Driving more bits
   // sometimes leads to encoding issues in the VCD.
-  tb.m_core.s_i[0] = 0x01234567;
-  tb.m_core.s_i[1] = 0x89ABCDEF;
-  tb.m_core.s_i[2] = 0x01234567;
-  tb.m_core.s_i[3] = 0xF;
+  tb.m_core.s_i[0] = tb.stimulus(0x01234567, 32);
+  tb.m_core.s_i[1] = tb.stimulus(0x89ABCDEF, 32);
+  tb.m_core.s_i[2] = tb.stimulus(0x01234567, 32);
+  tb.m_core.s_i[3] = tb.stimulus(0xF, 4);
 
   // Control signals
   tb.m_core.rnd_i = 0;  // Round, just defines which round constant is added
@@ -58,6 +57,9 @@ int main(int argc, char **argv) {
   tb.m_core.phase_sel_i = 0xA;
   tb.m_core.cycle_i = 0x3;
   tb.tick();
+}
 
-  tb.closetrace();
+int main(int argc, char **argv) {
+  Verilated::commandArgs(argc, argv);
+  return run_testbench<Vcircuit>("tmp", run);
 }
@@ -6,7 +6,9 @@
 
 #include <cassert>
 #include <cstring>
+#include <fstream>
 #include <gelf.h>
+#include <iomanip>
 #include <iostream>
 #include <libelf.h>
 #include <limits>
@@ -34,6 +36,39 @@ const StagedMem::SegMap &OtbnMemUtil::GetSegs(bool is_imem) const {
   return GetMemoryData(is_imem ? "imem" : "dmem").GetSegs();
 }
 
+void OtbnMemUtil::LoadLoopWarps(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    std::ostringstream oss;
+    oss << "Cannot open loop warp file `" << path << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  std::string line;
+  for (int line_no = 1; std::getline(file, line); ++line_no) {
+    // Allow blank lines and comments starting with '#'
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos || line[start] == '#')
+      continue;
+
+    std::istringstream iss(line);
+    unsigned long addr, from_cnt, to_cnt;
+    iss >> std::setbase(0) >> addr >> from_cnt >> to_cnt;
+    if (!iss || addr > std::numeric_limits<uint32_t>::max() ||
+        from_cnt > std::numeric_limits<uint32_t>::max() ||
+        to_cnt > std::numeric_limits<uint32_t>::max() || from_cnt > to_cnt) {
+      std::ostringstream oss;
+      oss << path << ":" << line_no << ": Invalid loop warp: `" << line
+          << "'.";
+      throw std::runtime_error(oss.str());
+    }
+
+    auto key = std::make_pair((uint32_t)addr, (uint32_t)from_cnt);
+    extra_loop_warp_[key] = to_cnt;
+    loop_warp_.insert(std::make_pair(key, (uint32_t)to_cnt));
+  }
+}
+
 uint32_t OtbnMemUtil::GetLoopWarp(uint32_t addr, uint32_t from_cnt) const {
   auto key = std::make_pair(addr, from_cnt);
   auto it = loop_warp_.find(key);
@@ -45,6 +80,7 @@ void OtbnMemUtil::OnElfLoaded(Elf *elf_file) {
 
   expected_end_addr_ = -1;
   loop_warp_.clear();
+  imem_symbols_.clear();
 
   // Look through the symbol table of elf_file for an expected end
   // address and any loop warping symbols.
@@ -68,9 +104,28 @@ void OtbnMemUtil::OnElfLoaded(Elf *elf_file) {
         continue;
 
       OnSymbol(sym_name, sym.st_value);
+
+      // Collect the names of functions in executable sections. OTBN
+      // assembly code often doesn't give its functions a type, so include
+      // any global label with no type as well.
+      int sym_type = GELF_ST_TYPE(sym.st_info);
+      bool is_func =
+          sym_type == STT_FUNC ||
+          (sym_type == STT_NOTYPE && GELF_ST_BIND(sym.st_info) == STB_GLOBAL);
+      bool in_section =
+          sym.st_shndx != SHN_UNDEF && sym.st_shndx < SHN_LORESERVE;
+      Elf_Scn *sym_scn =
+          in_section ? elf_getscn(elf_file, sym.st_shndx) : nullptr;
+      Elf32_Shdr *sym_shdr = sym_scn ? elf32_getshdr(sym_scn) : nullptr;
+      if (is_func && sym_shdr && (sym_shdr->sh_flags & SHF_EXECINSTR)) {
+        imem_symbols_.emplace(sym.st_value, sym_name);
+      }
     }
     break;
   }
+
+  // Add any warps from LoadLoopWarps that the ELF file didn't override
+  loop_warp_.insert(extra_loop_warp_.begin(), extra_loop_warp_.end());
 }
 
 void OtbnMemUtil::OnSymbol(const std::string &name, uint32_t value) {
@@ -273,6 +328,138 @@ extern "C" svBit OtbnMemUtilGetSegData(
   return sv_1;
 }
 
+extern "C" svBit OtbnMemUtilGetSegWords(
+    OtbnMemUtil *mem_util, svBit is_imem, int seg_idx,
+    /* output bit [31:0] data[] */ svOpenArrayHandle data) {
+  assert(mem_util);
+
+  const StagedMem::SegMap &segs = mem_util->GetSegs(is_imem);
+  if ((seg_idx < 0) || ((unsigned)seg_idx >= segs.size())) {
+    std::cerr << "Invalid segment index: " << seg_idx << ". "
+              << (is_imem ? 'I' : 'D') << "MEM has " << segs.size()
+              << " segments.\n";
+    return sv_0;
+  }
+
+  auto it = std::next(segs.begin(), seg_idx);
+  const std::vector<uint8_t> &seg_data = it->second;
+
+  // Round up to whole 32-bit words, as in OtbnMemUtilGetSegInfo.
+  size_t size_words = (seg_data.size() + 3) / 4;
+  if ((size_t)svSize(data, 1) != size_words) {
+    std::cerr << "Array for segment " << seg_idx << " has " << svSize(data, 1)
+              << " elements, but the segment has " << size_words
+              << " words.\n";
+    return sv_0;
+  }
+
+  std::vector<uint32_t> words(size_words, 0);
+  memcpy(words.data(), seg_data.data(), seg_data.size());
+  put_sv_u32_array(data, words.data(), words.size());
+  return sv_1;
+}
+
+// Checks that num_words 32-bit words at the 32-bit word offset word_off form a
+// run of whole words of mem_area. On success, writes the offset of the run in
+// words of mem_area to mem_word_off and returns true. Otherwise, prints a
+// message to stderr and returns false.
+static bool GetMemWordOffset(const MemArea &mem_area, int word_off,
+                             size_t num_words, uint32_t *mem_word_off) {
+  uint32_t width_32 = mem_area.GetWidthByte() / 4;
+  uint32_t size_32 = mem_area.GetSizeWords() * width_32;
+
+  if ((word_off < 0) || ((uint32_t)word_off > size_32) ||
+      (num_words > size_32 - (uint32_t)word_off)) {
+    std::cerr << "Cannot access " << num_words << " words at word offset "
+              << word_off << " in " << mem_area.GetScope() << ", which has "
+              << size_32 << " words.\n";
+    return false;
+  }
+  if ((word_off % width_32) || (num_words % width_32)) {
+    std::cerr << "Cannot access " << num_words << " words at word offset "
+              << word_off << " in " << mem_area.GetScope()
+              << ": accesses must be in whole " << 32 * width_32
+              << "-bit memory words.\n";
+    return false;
+  }
+
+  *mem_word_off = word_off / width_32;
+  return true;
+}
+
+extern "C" svBit OtbnMemUtilWriteWords(
+    OtbnMemUtil *mem_util, svBit is_imem, int word_off,
+    /* input bit [31:0] data[] */ const svOpenArrayHandle data) {
+  assert(mem_util);
+
+  const MemArea &mem_area = mem_util->GetMemArea(is_imem);
+  size_t num_words = svSize(data, 1);
+  uint32_t mem_word_off;
+  if (!GetMemWordOffset(mem_area, word_off, num_words, &mem_word_off)) {
+    return sv_0;
+  }
+
+  std::vector<uint32_t> words(num_words);
+  get_sv_u32_array(words.data(), data, num_words);
+
+  // MemArea::Write takes the data as little-endian bytes, computes the
+  // integrity bits and scrambles each memory word.
+  std::vector<uint8_t> bytes(4 * num_words);
+  for (size_t i = 0; i < num_words; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      bytes[4 * i + j] = (uint8_t)(words[i] >> (8 * j));
+    }
+  }
+
+  try {
+    mem_area.Write(mem_word_off, bytes);
+    return sv_1;
+  } catch (const std::exception &err) {
+    std::cerr << "Failed to write to " << mem_area.GetScope() << ": "
+              << err.what() << "\n";
+    return sv_0;
+  }
+}
+
+extern "C" svBit OtbnMemUtilReadWords(
+    OtbnMemUtil *mem_util, svBit is_imem, int word_off,
+    /* output bit [31:0] data[] */ svOpenArrayHandle data,
+    /* output bit valid[] */ svOpenArrayHandle valid) {
+  assert(mem_util);
+
+  const ScrambledEcc32MemArea &mem_area = mem_util->GetMemArea(is_imem);
+  size_t num_words = svSize(data, 1);
+  if ((size_t)svSize(valid, 1) != num_words) {
+    std::cerr << "Data and validity arrays have different sizes ("
+              << num_words << " and " << svSize(valid, 1) << ").\n";
+    return sv_0;
+  }
+  uint32_t mem_word_off;
+  if (!GetMemWordOffset(mem_area, word_off, num_words, &mem_word_off)) {
+    return sv_0;
+  }
+
+  Ecc32MemArea::EccWords ecc_words;
+  try {
+    ecc_words = mem_area.ReadWithIntegrity(
+        mem_word_off, num_words / (mem_area.GetWidthByte() / 4));
+  } catch (const std::exception &err) {
+    std::cerr << "Failed to read from " << mem_area.GetScope() << ": "
+              << err.what() << "\n";
+    return sv_0;
+  }
+  assert(ecc_words.size() == num_words);
+
+  std::vector<uint32_t> words(num_words);
+  int valid_low = svLow(valid, 1);
+  for (size_t i = 0; i < num_words; ++i) {
+    words[i] = ecc_words[i].second;
+    svPutBitArrElem1(valid, ecc_words[i].first ? sv_1 : sv_0, valid_low + i);
+  }
+  put_sv_u32_array(data, words.data(), num_words);
+  return sv_1;
+}
+
 int OtbnMemUtilGetExpEndAddr(OtbnMemUtil *mem_util) {
   assert(mem_util);
   return mem_util->GetExpEndAddr();
@@ -5,6 +5,7 @@
 #define OPENTITAN_HW_IP_OTBN_DV_MEMUTIL_OTBN_MEMUTIL_H_
 
 #include <map>
+#include <string>
 #include <svdpi.h>
 #include <vector>
 
@@ -43,6 +44,22 @@ class OtbnMemUtil : public DpiMemUtil {
   // Read-only access to the table of loop warps
   const LoopWarps &GetLoopWarps() const { return loop_warp_; }
 
+  // Read extra loop warps from a text file with a warp on each line, written
+  // as "ADDR FROM TO" (numbers in C syntax, so hex needs a 0x prefix). These
+  // are added to the warps from the symbols of any ELF file that is loaded.
+  // Where both define a warp at the same address and count, the ELF file
+  // wins.
+  //
+  // If something goes wrong, throws a std::exception.
+  void LoadLoopWarps(const std::string &path);
+
+  // The function symbols in IMEM from the last ELF file loaded, keyed by
+  // address. This includes global labels with no type, which is how most OTBN
+  // assembly code marks its functions.
+  const std::map<uint32_t, std::string> &GetImemSymbols() const {
+    return imem_symbols_;
+  }
+
  private:
   void OnElfLoaded(Elf *elf_file) override;
 
@@ -55,6 +72,8 @@ class OtbnMemUtil : public DpiMemUtil {
   ScrambledEcc32MemArea imem_, dmem_;
   int expected_end_addr_;
   LoopWarps loop_warp_;
+  LoopWarps extra_loop_warp_;
+  std::map<uint32_t, std::string> imem_symbols_;
 };
 
 // DPI-accessible wrappers
@@ -91,6 +110,36 @@ svBit OtbnMemUtilGetSegInfo(OtbnMemUtil *mem_util, svBit is_imem, int seg_idx,
 svBit OtbnMemUtilGetSegData(OtbnMemUtil *mem_util, svBit is_imem, int word_off,
                             /* output bit[31:0] */ svBitVecVal *data_value);
 
+// Gets the data of a segment currently staged in imem/dmem, as 32-bit words.
+// This is equivalent to calling OtbnMemUtilGetSegData for each word of the
+// segment, but transfers the whole segment with one call. data must have as
+// many elements as the segment size returned by OtbnMemUtilGetSegInfo. Returns
+// 1'b1 on success. Prints a message to stderr and returns 1'b0 on failure.
+svBit OtbnMemUtilGetSegWords(OtbnMemUtil *mem_util, svBit is_imem, int seg_idx,
+                             /* output bit [31:0] data[] */
+                             svOpenArrayHandle data);
+
+// Writes 32-bit words to imem/dmem with the backdoor, starting at the 32-bit
+// word offset word_off. The integrity bits of the words are computed and the
+// memory's current scrambling key and nonce are applied on the C++ side, so a
+// whole region of memory is written with one call. For dmem, word_off and the
+// size of data must be multiples of 8 (a 256-bit memory word). Returns 1'b1 on
+// success. Prints a message to stderr and returns 1'b0 on failure.
+svBit OtbnMemUtilWriteWords(OtbnMemUtil *mem_util, svBit is_imem, int word_off,
+                            /* input bit [31:0] data[] */
+                            const svOpenArrayHandle data);
+
+// Reads 32-bit words from imem/dmem with the backdoor, starting at the 32-bit
+// word offset word_off. This is the inverse of OtbnMemUtilWriteWords: the
+// words are descrambled and valid[i] is set if the integrity bits for data[i]
+// are correct. data and valid must have the same size and have the same
+// alignment requirements as for OtbnMemUtilWriteWords. Returns 1'b1 on
+// success. Prints a message to stderr and returns 1'b0 on failure.
+svBit OtbnMemUtilReadWords(OtbnMemUtil *mem_util, svBit is_imem, int word_off,
+                           /* output bit [31:0] data[] */
+                           svOpenArrayHandle data,
+                           /* output bit valid[] */ svOpenArrayHandle valid);
+
 // Get an "expected end address". This is a belt-and-braces check, where the
 // producer of the ELF file knows what address they expect to finish at (either
 // an ECALL or a known-bad faulting instruction). They can put this as a magic
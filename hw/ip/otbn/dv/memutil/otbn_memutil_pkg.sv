@@ -24,6 +24,18 @@ package otbn_memutil_pkg;
   import "DPI-C" function bit OtbnMemUtilGetSegData(chandle mem_util, bit is_imem, int word_off,
                                                     output bit [31:0] data_value);
 
+  import "DPI-C" function bit OtbnMemUtilGetSegWords(chandle mem_util, bit is_imem, int seg_idx,
+                                                     output bit [31:0] data[]);
+
+  import "DPI-C" context function bit OtbnMemUtilWriteWords(chandle mem_util, bit is_imem,
+                                                            int word_off,
+                                                            input bit [31:0] data[]);
+
+  import "DPI-C" context function bit OtbnMemUtilReadWords(chandle mem_util, bit is_imem,
+                                                           int word_off,
+                                                           output bit [31:0] data[],
+                                                           output bit valid[]);
+
   import "DPI-C" function int OtbnMemUtilGetExpEndAddr(chandle mem_util);
 
   import "DPI-C" function bit OtbnMemUtilGetLoopWarp(chandle           mem_util,
@@ -4,6 +4,10 @@
 #ifndef OPENTITAN_HW_IP_OTBN_DV_MEMUTIL_SV_UTILS_H_
 #define OPENTITAN_HW_IP_OTBN_DV_MEMUTIL_SV_UTILS_H_
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <svdpi.h>
 
 // Utility function that packs a uint8_t into a SystemVerilog bit vector that
@@ -34,4 +38,37 @@ inline uint32_t get_sv_u32(const svBitVecVal *src) {
   return ret;
 }
 
+// Utility function that copies num_words uint32_t values into an open array
+// that represents a "bit [31:0] dst[]" with num_words elements. If the
+// simulator lays the array out like a C array, this is a single copy.
+inline void put_sv_u32_array(svOpenArrayHandle dst, const uint32_t *src,
+                             size_t num_words) {
+  assert((size_t)svSize(dst, 1) == num_words);
+  void *ptr = svGetArrayPtr(dst);
+  if (ptr) {
+    memcpy(ptr, src, num_words * sizeof(uint32_t));
+    return;
+  }
+  int low = svLow(dst, 1);
+  for (size_t i = 0; i < num_words; ++i) {
+    *(svBitVecVal *)svGetArrElemPtr1(dst, low + i) = src[i];
+  }
+}
+
+// Utility function that copies num_words elements from an open array that
+// represents a "bit [31:0] src[]" into dst. The inverse of put_sv_u32_array.
+inline void get_sv_u32_array(uint32_t *dst, const svOpenArrayHandle src,
+                             size_t num_words) {
+  assert((size_t)svSize(src, 1) == num_words);
+  const void *ptr = svGetArrayPtr(src);
+  if (ptr) {
+    memcpy(dst, ptr, num_words * sizeof(uint32_t));
+    return;
+  }
+  int low = svLow(src, 1);
+  for (size_t i = 0; i < num_words; ++i) {
+    dst[i] = *(const svBitVecVal *)svGetArrElemPtr1(src, low + i);
+  }
+}
+
 #endif  // OPENTITAN_HW_IP_OTBN_DV_MEMUTIL_SV_UTILS_H_
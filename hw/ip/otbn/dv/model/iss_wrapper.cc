@@ -34,17 +34,20 @@ typedef std::unique_ptr<char, CStrDeleter> c_str_ptr;
 struct TmpDir {
   std::string path;
 
-  TmpDir() : path(TmpDir::make_tmp_dir()) {}
+  TmpDir() : path(TmpDir::make_tmp_dir(TmpDir::default_base())) {}
+  explicit TmpDir(const std::string &base) : path(TmpDir::make_tmp_dir(base)) {}
   ~TmpDir() { cleanup(); }
 
  private:
-  // A wrapper around mkdtemp that respects TMPDIR
-  static std::string make_tmp_dir() {
+  // The directory to create temporary directories in. This respects TMPDIR.
+  static std::string default_base() {
     const char *tmpdir = getenv("TMPDIR");
-    if (!tmpdir)
-      tmpdir = "/tmp";
+    return tmpdir ? tmpdir : "/tmp";
+  }
 
-    std::string tmp_template(tmpdir);
+  // A wrapper around mkdtemp
+  static std::string make_tmp_dir(const std::string &base) {
+    std::string tmp_template(base);
     tmp_template += "/otbn_XXXXXX";
 
     if (!mkdtemp(&tmp_template.at(0))) {
@@ -190,7 +193,17 @@ static std::string find_repo_top() {
 
 // Find the otbn Python model. On failure, throw a std::runtime_error with a
 // description of what went wrong.
-static std::string find_otbn_model() {
+//
+// If OTBN_ISS is set, it names an alternative ISS executable that speaks the
+// same protocol as stepped.py, and is run in place of the Python model. Its
+// behaviour can be compared with the Python model by setting OTBN_ISS_LOG and
+// replaying the log with otbnsim/iss_conformance.py.
+static std::string find_otbn_model(bool *is_python) {
+  const char *from_env = getenv("OTBN_ISS");
+  *is_python = !(from_env && *from_env);
+  if (!*is_python)
+    return std::string(from_env);
+
   std::string path = find_repo_top() + "/hw/ip/otbn/dv/otbnsim/stepped.py";
   c_str_ptr abs_path(realpath(path.c_str(), NULL));
   if (!abs_path) {
@@ -235,25 +248,40 @@ static void read_ext_reg(const std::string &reg_name,
   }
 }
 
-// A specialized version of read_ext_reg that updates a boolean flag
-// (assuming that the ISS will always signal the register as having
-// value 0 or 1). Prints a message to stderr and returns false on
-// error.
-static bool read_ext_flag(const std::string &reg_name,
-                          const std::vector<std::string> &lines, bool *dest) {
+// Bits in the mask of written registers in a step record from step_bin
+static const uint8_t kStepStatus = 1 << 0;
+static const uint8_t kStepInsnCnt = 1 << 1;
+static const uint8_t kStepErrBits = 1 << 2;
+static const uint8_t kStepStopPc = 1 << 3;
+static const uint8_t kStepRndReq = 1 << 4;
+static const uint8_t kStepWipeStart = 1 << 5;
+
+// Read a little-endian 16-bit or 32-bit value from buf
+static uint32_t read_le_16(const uint8_t *buf) {
+  return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8);
+}
+static uint32_t read_le_32(const uint8_t *buf) {
+  return read_le_16(buf) | (read_le_16(buf + 2) << 16);
+}
+
+// Update a boolean flag from a step record, if it was written (assuming that
+// the ISS will always signal the register as having value 0 or 1). Prints a
+// message to stderr and returns false on error.
+static bool read_flag(const std::string &reg_name, bool written, uint8_t value,
+                      bool *dest) {
   assert(dest);
 
-  uint32_t dest32 = *dest ? 1 : 0;
-  read_ext_reg(reg_name, lines, &dest32);
+  if (!written)
+    return true;
 
-  if (dest32 > 1) {
+  if (value > 1) {
     std::cerr << "ERROR: Unexpected update to " << reg_name << " with value 0x"
-              << std::hex << dest32 << std::dec
+              << std::hex << (unsigned)value << std::dec
               << " when we expected a boolean flag.";
     return false;
   }
 
-  *dest = dest32 != 0;
+  *dest = value != 0;
   return true;
 }
 
@@ -266,8 +294,26 @@ void MirroredRegs::reset() {
   wipe_start = false;
 }
 
-ISSWrapper::ISSWrapper() : tmpdir(new TmpDir()) {
-  std::string model_path(find_otbn_model());
+// Make a temporary directory on a memory-backed filesystem, if there is one.
+// Returns null if not.
+static std::unique_ptr<TmpDir> make_shm_dir() {
+  const char *shm_base = "/dev/shm";
+  struct stat statbuf;
+  if (stat(shm_base, &statbuf) != 0 || !S_ISDIR(statbuf.st_mode) ||
+      access(shm_base, W_OK) != 0)
+    return nullptr;
+
+  try {
+    return std::unique_ptr<TmpDir>(new TmpDir(shm_base));
+  } catch (const std::runtime_error &err) {
+    return nullptr;
+  }
+}
+
+ISSWrapper::ISSWrapper()
+    : pending_commands_(0), tmpdir(new TmpDir()), shmdir(make_shm_dir()) {
+  bool is_python;
+  std::string model_path(find_otbn_model(&is_python));
 
   // We want two pipes: one for writing to the child process, and the other for
   // reading from it. We set the O_CLOEXEC flag so that the child process will
@@ -315,8 +361,15 @@ ISSWrapper::ISSWrapper() : tmpdir(new TmpDir()) {
       abort();
     }
     // Finally, exec the ISS
-    execl("/usr/bin/env", "/usr/bin/env", "python3", "-u", model_path.c_str(),
-          NULL);
+    if (is_python) {
+      execl("/usr/bin/env", "/usr/bin/env", "python3", "-u", model_path.c_str(),
+            NULL);
+    } else {
+      execl(model_path.c_str(), model_path.c_str(), NULL);
+    }
+    std::cerr << "Failed to run ISS at " << model_path << ": "
+              << strerror(errno) << "\n";
+    abort();
   }
 
   // We are the parent process and pid is the PID of the child. Close the pipe
@@ -335,6 +388,19 @@ ISSWrapper::ISSWrapper() : tmpdir(new TmpDir()) {
   // valid). Add an assertion to make sure nothing weird happens.
   assert(child_write_file);
   assert(child_read_file);
+
+  // If requested, keep a copy of every command that we send
+  command_log_file = nullptr;
+  const char *log_path = getenv("OTBN_ISS_LOG");
+  if (log_path && *log_path) {
+    command_log_file = fopen(log_path, "w");
+    if (!command_log_file) {
+      std::ostringstream oss;
+      oss << "Failed to open ISS command log at " << log_path << ": "
+          << strerror(errno);
+      throw std::runtime_error(oss.str());
+    }
+  }
 }
 
 ISSWrapper::~ISSWrapper() {
@@ -349,6 +415,49 @@ ISSWrapper::~ISSWrapper() {
   // Close the child file handles.
   fclose(child_write_file);
   fclose(child_read_file);
+
+  if (command_log_file)
+    fclose(command_log_file);
+}
+
+// Idle ISS processes, waiting to be reused by ISSWrapper::acquire(). Starting
+// the ISS means starting Python and importing the simulator, which takes much
+// longer than resetting one that's already running.
+static std::vector<std::unique_ptr<ISSWrapper>> iss_pool;
+
+static size_t iss_pool_size() {
+  const char *from_env = getenv("OTBN_ISS_POOL_SIZE");
+  if (!from_env)
+    return 4;
+  int size = atoi(from_env);
+  return size > 0 ? size : 0;
+}
+
+std::unique_ptr<ISSWrapper> ISSWrapper::acquire() {
+  if (iss_pool.empty())
+    return std::unique_ptr<ISSWrapper>(new ISSWrapper());
+
+  std::unique_ptr<ISSWrapper> iss(std::move(iss_pool.back()));
+  iss_pool.pop_back();
+  return iss;
+}
+
+void ISSWrapper::release(std::unique_ptr<ISSWrapper> iss) {
+  if (!iss || iss_pool.size() >= iss_pool_size())
+    return;
+
+  // Reset the ISS and wait for it to respond. This clears all its state
+  // (including loop warps and memory contents) and also checks that the
+  // process is still alive. If the child has died or got stuck in some error
+  // state, just drop it: acquire() will start a new one when needed.
+  try {
+    iss->reset(false);
+    iss->sync_commands();
+  } catch (const std::runtime_error &err) {
+    return;
+  }
+
+  iss_pool.push_back(std::move(iss));
 }
 
 void ISSWrapper::load_d(const std::string &path) {
@@ -368,12 +477,10 @@ void ISSWrapper::add_loop_warp(uint32_t addr, uint32_t from_cnt,
   std::ostringstream oss;
   oss << "add_loop_warp 0x" << std::hex << addr << std::dec << " " << from_cnt
       << " " << to_cnt << "\n";
-  run_command(oss.str(), nullptr);
+  send_command(oss.str());
 }
 
-void ISSWrapper::clear_loop_warps() {
-  run_command("clear_loop_warps\n", nullptr);
-}
+void ISSWrapper::clear_loop_warps() { send_command("clear_loop_warps\n"); }
 
 void ISSWrapper::dump_d(const std::string &path) const {
   std::ostringstream oss;
@@ -402,34 +509,30 @@ void ISSWrapper::start_operation(command_t command) {
       assert(0);
   }
 
-  run_command(cmd_stream.str(), nullptr);
+  send_command(cmd_stream.str());
 }
 
-void ISSWrapper::otp_key_cdc_done() {
-  run_command("otp_key_cdc_done\n", nullptr);
-}
+void ISSWrapper::otp_key_cdc_done() { send_command("otp_key_cdc_done\n"); }
 
-void ISSWrapper::edn_rnd_cdc_done() {
-  run_command("edn_rnd_cdc_done\n", nullptr);
-}
+void ISSWrapper::edn_rnd_cdc_done() { send_command("edn_rnd_cdc_done\n"); }
 
 void ISSWrapper::edn_urnd_cdc_done() {
-  run_command("edn_urnd_cdc_done\n", nullptr);
+  send_command("edn_urnd_cdc_done\n");
 }
 
-void ISSWrapper::edn_flush() { run_command("edn_flush\n", nullptr); }
+void ISSWrapper::edn_flush() { send_command("edn_flush\n"); }
 
 void ISSWrapper::edn_rnd_step(uint32_t edn_rnd_data, bool fips_err) {
   std::ostringstream oss;
   oss << "edn_rnd_step " << std::hex << "0x" << edn_rnd_data;
   oss << " " << fips_err << "\n";
-  run_command(oss.str(), nullptr);
+  send_command(oss.str());
 }
 
 void ISSWrapper::edn_urnd_step(uint32_t edn_urnd_data) {
   std::ostringstream oss;
   oss << "edn_urnd_step " << std::hex << "0x" << edn_urnd_data << "\n";
-  run_command(oss.str(), nullptr);
+  send_command(oss.str());
 }
 
 void ISSWrapper::set_keymgr_value(const std::array<uint32_t, 12> &key0_arr,
@@ -447,13 +550,57 @@ void ISSWrapper::set_keymgr_value(const std::array<uint32_t, 12> &key0_arr,
   }
   oss << " " << valid << "\n";
 
-  run_command(oss.str(), nullptr);
+  send_command(oss.str());
 }
 
-int ISSWrapper::step(bool gen_trace) {
+int ISSWrapper::step(bool gen_trace, uint32_t max_steps,
+                     uint32_t *steps_taken) {
+  assert(0 < max_steps && max_steps <= 0xffff);
+
+  std::ostringstream oss;
+  oss << "step_bin " << max_steps << " " << gen_trace << "\n";
+  std::string cmd = oss.str();
+
+  // Send the command and read the binary step record that comes back (see
+  // STEP_RECORD in stepped.py for the layout).
+  sync_commands();
+  write_command(cmd);
+  fflush(child_write_file);
+
+  uint8_t rec[28];
+  read_child_bytes(cmd, rec, sizeof rec);
+
+  uint32_t steps = read_le_16(&rec[0]);
+  uint8_t written = rec[2];
+  uint32_t trace_len = read_le_32(&rec[24]);
+
   std::vector<std::string> lines;
+  if (trace_len) {
+    std::string trace(trace_len, '\0');
+    read_child_bytes(cmd, &trace[0], trace_len);
+
+    // Split the trace into lines, dropping the newline at the end of each
+    size_t pos = 0;
+    while (pos < trace.size()) {
+      size_t end = trace.find('\n', pos);
+      if (end == std::string::npos)
+        end = trace.size();
+      lines.push_back(trace.substr(pos, end - pos));
+      pos = end + 1;
+    }
+  }
+
+  // The record is followed by the usual terminator line
+  if (!read_child_response(nullptr)) {
+    std::ostringstream err;
+    err << "Failed to run command '" << cmd.substr(0, cmd.size() - 1)
+        << "': EOF from ISS.";
+    throw std::runtime_error(err.str());
+  }
+
+  if (steps_taken)
+    *steps_taken = steps;
 
-  run_command("step\n", &lines);
   if (gen_trace && lines.size()) {
     if (!OtbnTraceChecker::get().OnIssTrace(lines)) {
       return -1;
@@ -463,7 +610,8 @@ int ISSWrapper::step(bool gen_trace) {
   // Try to read STATUS, which is written when execution ends. Execution has
   // finished if status_ is either 0 (IDLE) or 0xff (LOCKED)
   bool was_stopped = mirrored_.stopped();
-  read_ext_reg("STATUS", lines, &mirrored_.status);
+  if (written & kStepStatus)
+    mirrored_.status = read_le_32(&rec[4]);
   bool is_stopped = mirrored_.stopped();
   bool done = is_stopped && !was_stopped;
 
@@ -471,36 +619,37 @@ int ISSWrapper::step(bool gen_trace) {
   // flags. Some of these flags only get updated around the end of an operation
   // but the precise timing is slightly fiddly, so it's easiest to just allow
   // updates whenever they arrive.
-  read_ext_reg("INSN_CNT", lines, &mirrored_.insn_cnt);
-  read_ext_reg("ERR_BITS", lines, &mirrored_.err_bits);
-  read_ext_reg("STOP_PC", lines, &mirrored_.stop_pc);
-
-  if (!read_ext_flag("RND_REQ", lines, &mirrored_.rnd_req))
+  if (written & kStepInsnCnt)
+    mirrored_.insn_cnt = read_le_32(&rec[8]);
+  if (written & kStepErrBits)
+    mirrored_.err_bits = read_le_32(&rec[12]);
+  if (written & kStepStopPc)
+    mirrored_.stop_pc = read_le_32(&rec[16]);
+
+  if (!read_flag("RND_REQ", written & kStepRndReq, rec[20],
+                 &mirrored_.rnd_req))
     return -1;
-  if (!read_ext_flag("WIPE_START", lines, &mirrored_.wipe_start))
+  if (!read_flag("WIPE_START", written & kStepWipeStart, rec[21],
+                 &mirrored_.wipe_start))
     return -1;
 
   return done ? 1 : 0;
 }
 
-void ISSWrapper::invalidate_imem() {
-  run_command("invalidate_imem\n", nullptr);
-}
+void ISSWrapper::invalidate_imem() { send_command("invalidate_imem\n"); }
 
-void ISSWrapper::invalidate_dmem() {
-  run_command("invalidate_dmem\n", nullptr);
-}
+void ISSWrapper::invalidate_dmem() { send_command("invalidate_dmem\n"); }
 
 void ISSWrapper::set_software_errs_fatal(bool new_val) {
   std::ostringstream oss;
 
   oss << "set_software_errs_fatal " << new_val << "\n";
 
-  run_command(oss.str(), nullptr);
+  send_command(oss.str());
 }
 
 void ISSWrapper::initial_secure_wipe() {
-  run_command("initial_secure_wipe\n", nullptr);
+  send_command("initial_secure_wipe\n");
 }
 
 uint32_t ISSWrapper::step_crc(const std::array<uint8_t, 6> &item,
@@ -523,7 +672,7 @@ void ISSWrapper::reset(bool gen_trace) {
   if (gen_trace)
     OtbnTraceChecker::get().Flush();
 
-  run_command("reset\n", nullptr);
+  send_command("reset\n");
 
   // Reset all mirrored registers.
   mirrored_.reset();
@@ -533,93 +682,46 @@ void ISSWrapper::send_err_escalation(uint32_t err_val, bool lock_immediately) {
   std::ostringstream oss;
   oss << "send_err_escalation " << std::hex << "0x" << err_val << " "
       << lock_immediately << "\n";
-  run_command(oss.str(), nullptr);
+  send_command(oss.str());
 }
 
 void ISSWrapper::set_rma_req(uint8_t rma_req) {
   std::ostringstream oss;
   oss << "set_rma_req " << std::hex << "0x" << (int)rma_req << "\n";
-  run_command(oss.str(), nullptr);
+  send_command(oss.str());
 }
 
 void ISSWrapper::get_regs(std::array<uint32_t, 32> *gprs,
                           std::array<u256_t, 32> *wdrs) {
   assert(gprs && wdrs);
 
-  std::vector<std::string> lines;
-  run_command("print_regs\n", &lines);
-
-  // A record of which registers we've seen (to check we see each
-  // register exactly once). GPR i sets bit i. WDR i sets bit 32 + i.
-  uint64_t seen_mask = 0;
-
-  // Lines look like
-  //
-  //  x3  = 0x12345678
-  //  w10 = 0x0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef
-
-  std::regex re("\\s*([wx][0-9]{1,2})\\s*=\\s*0x([0-9a-f]+)");
-  std::smatch match;
-
-  for (const std::string &line : lines) {
-    if (line == "PRINT_REGS")
-      continue;
-
-    if (!std::regex_match(line, match, re)) {
-      std::ostringstream oss;
-      oss << "Invalid line in ISS print_register output (`" << line << "').";
-      throw std::runtime_error(oss.str());
-    }
-
-    assert(match.size() == 3);
+  static const std::string cmd("print_regs_bin\n");
 
-    std::string reg_name = match[1].str();
-    std::string str_value = match[2].str();
-
-    assert(reg_name.size() <= 3);
-    assert(reg_name[0] == 'w' || reg_name[0] == 'x');
-    bool is_wide = reg_name[0] == 'w';
-    int reg_idx = atoi(reg_name.c_str() + 1);
-
-    assert(reg_idx >= 0);
-    if (reg_idx >= 32) {
-      std::ostringstream oss;
-      oss << "Invalid register name in ISS output (`" << reg_name
-          << "'). Line was `" << line << "'.";
-      throw std::runtime_error(oss.str());
-    }
+  // Send the command and read the binary register record that comes back (see
+  // REGS_RECORD_SIZE in stepped.py for the layout): the GPRs as 32-bit words,
+  // then the WDRs as 256-bit words, all little-endian.
+  sync_commands();
+  write_command(cmd);
+  fflush(child_write_file);
 
-    unsigned idx_seen = reg_idx + (is_wide ? 32 : 0);
-    if ((seen_mask >> idx_seen) & 1) {
-      std::ostringstream oss;
-      oss << "Duplicate lines writing register " << reg_name << ".";
-      throw std::runtime_error(oss.str());
-    }
+  uint8_t rec[32 * 4 + 32 * 32];
+  read_child_bytes(cmd, rec, sizeof rec);
 
-    unsigned num_u32s = is_wide ? 8 : 1;
-    unsigned expected_value_len = 8 * num_u32s;
-    if (str_value.size() != expected_value_len) {
-      std::ostringstream oss;
-      oss << "Value for register " << reg_name << " has " << str_value.size()
-          << " hex characters, but we expected " << expected_value_len << ".";
-      throw std::runtime_error(oss.str());
-    }
-
-    uint32_t *dst = is_wide ? &(*wdrs)[reg_idx].words[7] : &(*gprs)[reg_idx];
-    for (unsigned i = 0; i < num_u32s; ++i) {
-      *dst = read_hex_32(&str_value[8 * i]);
-      --dst;
+  for (int i = 0; i < 32; ++i) {
+    (*gprs)[i] = read_le_32(&rec[4 * i]);
+  }
+  for (int i = 0; i < 32; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      (*wdrs)[i].words[j] = read_le_32(&rec[32 * 4 + 32 * i + 4 * j]);
     }
-
-    seen_mask |= ((uint64_t)1 << idx_seen);
   }
 
-  // Check that we've seen all the registers
-  if (~seen_mask) {
-    std::ostringstream oss;
-    oss << "Some registers were missing from print_register output. Mask: 0x"
-        << std::hex << seen_mask << ".";
-    throw std::runtime_error(oss.str());
+  // The record is followed by the usual terminator line
+  if (!read_child_response(nullptr)) {
+    std::ostringstream err;
+    err << "Failed to run command '" << cmd.substr(0, cmd.size() - 1)
+        << "': EOF from ISS.";
+    throw std::runtime_error(err.str());
   }
 }
 
@@ -660,10 +762,39 @@ std::vector<uint32_t> ISSWrapper::get_call_stack() {
   return call_stack;
 }
 
+std::vector<uint32_t> ISSWrapper::get_dmem_dirty() {
+  std::vector<std::string> lines;
+  run_command("print_dmem_dirty\n", &lines);
+
+  std::regex re("\\s*0x([0-9a-f]{8})");
+  std::smatch match;
+  std::vector<uint32_t> offsets;
+
+  for (const std::string &line : lines) {
+    if (line == "PRINT_DMEM_DIRTY")
+      continue;
+
+    if (!std::regex_match(line, match, re)) {
+      std::ostringstream oss;
+      oss << "Invalid line in ISS print_dmem_dirty output (`" << line << "').";
+      throw std::runtime_error(oss.str());
+    }
+
+    std::string str_value = match[1];
+    offsets.push_back(read_hex_32(str_value.c_str()));
+  }
+
+  return offsets;
+}
+
 std::string ISSWrapper::make_tmp_path(const std::string &relative) const {
   return tmpdir->path + "/" + relative;
 }
 
+std::string ISSWrapper::make_shm_path(const std::string &relative) const {
+  return (shmdir ? shmdir->path : tmpdir->path) + "/" + relative;
+}
+
 bool ISSWrapper::read_child_response(std::vector<std::string> *dst) const {
   char buf[256];
   bool continuation = false;
@@ -713,12 +844,59 @@ bool ISSWrapper::read_child_response(std::vector<std::string> *dst) const {
   }
 }
 
+void ISSWrapper::read_child_bytes(const std::string &cmd, void *dst,
+                                  size_t len) const {
+  if (fread(dst, 1, len, child_read_file) != len) {
+    std::ostringstream oss;
+    std::string cmd_line = cmd.substr(0, cmd.size() - 1);
+    oss << "Failed to run command '" << cmd_line << "': EOF from ISS.";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+void ISSWrapper::write_command(const std::string &cmd) const {
+  fputs(cmd.c_str(), child_write_file);
+  if (command_log_file)
+    fputs(cmd.c_str(), command_log_file);
+}
+
+void ISSWrapper::sync_commands() const {
+  if (!pending_commands_)
+    return;
+
+  fflush(child_write_file);
+  for (; pending_commands_; --pending_commands_) {
+    if (!read_child_response(nullptr)) {
+      // We don't know which command failed, but the ISS will have printed a
+      // Python backtrace and the last command sent is a good hint.
+      pending_commands_ = 0;
+      std::ostringstream oss;
+      std::string cmd_line =
+          last_pending_command_.substr(0, last_pending_command_.size() - 1);
+      oss << "Failed to run command '" << cmd_line
+          << "' (or an earlier one): EOF from ISS.";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
+void ISSWrapper::send_command(const std::string &cmd) const {
+  assert(cmd.size() > 0);
+  assert(cmd.back() == '\n');
+
+  // This is buffered in child_write_file until we next need a response.
+  write_command(cmd);
+  ++pending_commands_;
+  last_pending_command_ = cmd;
+}
+
 void ISSWrapper::run_command(const std::string &cmd,
                              std::vector<std::string> *dst) const {
   assert(cmd.size() > 0);
   assert(cmd.back() == '\n');
 
-  fputs(cmd.c_str(), child_write_file);
+  sync_commands();
+  write_command(cmd);
   fflush(child_write_file);
   if (!read_child_response(dst)) {
     std::ostringstream oss;
@@ -57,6 +57,19 @@ struct ISSWrapper {
   ISSWrapper();
   ~ISSWrapper();
 
+  // Get an ISS wrapper, reusing an idle ISS process from the pool if there is
+  // one and starting a new one otherwise. A reused process has been reset, so
+  // it looks just like a new one. Throws a std::runtime_error if a new process
+  // can't be started.
+  static std::unique_ptr<ISSWrapper> acquire();
+
+  // Return an ISS wrapper to the pool so that a later call to acquire() can
+  // reuse its process instead of starting another. The ISS is reset first. If
+  // that fails or the pool is already full, the wrapper (and its process) is
+  // destroyed instead. The pool keeps at most OTBN_ISS_POOL_SIZE processes
+  // (default 4); setting it to 0 disables reuse.
+  static void release(std::unique_ptr<ISSWrapper> iss);
+
   // Load new contents of DMEM / IMEM
   void load_d(const std::string &path);
   void load_i(const std::string &path);
@@ -112,7 +125,14 @@ struct ISSWrapper {
   // Updates mirrored versions of STATUS and INSN_CNT registers. If execution
   // finishes (so we return 1), also updates mirrored versions of ERR_BITS and
   // the final PC (see get_stop_pc()).
-  int step(bool gen_trace);
+  //
+  // If max_steps is more than 1, the ISS keeps stepping until a step generates
+  // some trace output (which includes any change to a mirrored register), up
+  // to max_steps steps. If steps_taken is not null, it is set to the number of
+  // steps taken. This is only correct if the caller wouldn't have sent the ISS
+  // anything (such as EDN data) in the steps that got skipped.
+  int step(bool gen_trace, uint32_t max_steps = 1,
+           uint32_t *steps_taken = nullptr);
 
   // Mark all of IMEM as invalid so that any fetch causes an integrity error.
   void invalidate_imem();
@@ -149,17 +169,44 @@ struct ISSWrapper {
   // Read the contents of the call stack
   std::vector<uint32_t> get_call_stack();
 
+  // Get the byte offsets of the 256-bit DMEM words that the ISS has written
+  // (or invalidated) since DMEM was last loaded with load_d.
+  std::vector<uint32_t> get_dmem_dirty();
+
   // Resolve a path relative to the convenience temporary directory.
   // relative should be a relative path (it is just appended to the
   // path of the temporary directory).
   std::string make_tmp_path(const std::string &relative) const;
 
+  // Like make_tmp_path, but for files that are used to pass memory contents
+  // to and from the ISS. These are put on a memory-backed filesystem (such as
+  // /dev/shm) if there is one, so that exchanging them doesn't touch the disk.
+  std::string make_shm_path(const std::string &relative) const;
+
  private:
   // Read line by line from the child process until we get ".\n".
   // Return true if we got the ".\n" terminator, false if EOF. If dst
   // is not null, append to it each line that was read.
   bool read_child_response(std::vector<std::string> *dst) const;
 
+  // Read exactly len bytes from the child process into dst. If we get to EOF
+  // first, raise a runtime_error that mentions cmd.
+  void read_child_bytes(const std::string &cmd, void *dst, size_t len) const;
+
+  // Write a command to the child (without flushing), also copying it to the
+  // command log if there is one.
+  void write_command(const std::string &cmd) const;
+
+  // Read (and discard) the responses to any commands that were sent with
+  // send_command. If one of them has failed, raise a runtime_error.
+  void sync_commands() const;
+
+  // Send a command to the child without waiting for its response, which will
+  // be collected by the next call to sync_commands. This is used for commands
+  // that don't print anything interesting: sending them all without waiting
+  // saves a round trip to the child process for each of them.
+  void send_command(const std::string &cmd) const;
+
   // Send a command to the child and wait for its response. If no
   // response, raise a runtime_error.
   void run_command(const std::string &cmd, std::vector<std::string> *dst) const;
@@ -168,9 +215,21 @@ struct ISSWrapper {
   FILE *child_write_file;
   FILE *child_read_file;
 
+  // If OTBN_ISS_LOG is set, a copy of every command sent to the child
+  FILE *command_log_file;
+
+  // The number of commands sent with send_command whose responses haven't
+  // been read yet, and the last of those commands (for error messages).
+  mutable unsigned pending_commands_;
+  mutable std::string last_pending_command_;
+
   // A temporary directory for communicating with the child process
   std::unique_ptr<TmpDir> tmpdir;
 
+  // A temporary directory on a memory-backed filesystem, for memory contents.
+  // Null if there isn't such a filesystem.
+  std::unique_ptr<TmpDir> shmdir;
+
   // Mirrored copies of registers
   MirroredRegs mirrored_;
 };
@@ -6,11 +6,16 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
-#include <fstream>
+#include <fcntl.h>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "iss_wrapper.h"
 #include "otbn_model_dpi.h"
@@ -19,7 +24,7 @@
 #include "sv_utils.h"
 
 extern "C" {
-int otbn_rf_peek(int index, svBitVecVal *val);
+int otbn_rf_peek_all(svBitVecVal *vals);
 int otbn_stack_element_peek(int index, svBitVecVal *val);
 }
 
@@ -40,112 +45,148 @@ int otbn_stack_element_peek(int index, svBitVecVal *val);
 #define STATUS_BUSY_SEC_WIPE_INT 0x04
 #define STATUS_LOCKED 0xFF
 
-// Read (the start of) the contents of a file at path as a vector of bytes.
-// Expects num_bytes bytes of data. On failure, throws a std::runtime_error.
-static Ecc32MemArea::EccWords read_words_from_file(const std::string &path,
-                                                   size_t num_words) {
-  std::filebuf fb;
-  if (!fb.open(path.c_str(), std::ios::in | std::ios::binary)) {
-    std::ostringstream oss;
-    oss << "Cannot open the file '" << path << "'.";
-    throw std::runtime_error(oss.str());
-  }
-
-  Ecc32MemArea::EccWords ret;
-  ret.reserve(num_words);
-
-  char minibuf[5];
-  for (size_t i = 0; i < num_words; ++i) {
-    std::streamsize chars_in = fb.sgetn(minibuf, 5);
-    if (chars_in != 5) {
+// A file holding the contents of a memory, in the format used by the load_d,
+// load_i and dump_d ISS commands: for each 32-bit word, a validity byte
+// (either 0 or 1) followed by the word itself in little-endian order. The file
+// is mapped into memory, so it can be read or written in place.
+class MemImageFile {
+ public:
+  static const size_t kBytesPerWord = 5;
+
+  // Map the file at path. If create is true, the file is created (or
+  // truncated) with room for num_words words. Otherwise, it must already
+  // contain at least num_words words. On failure, throws a std::runtime_error.
+  MemImageFile(const std::string &path, size_t num_words, bool create)
+      : path_(path), len_(num_words * kBytesPerWord), addr_(nullptr) {
+    int fd = create ? open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600)
+                    : open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
       std::ostringstream oss;
-      oss << "Cannot read word " << i << " from " << path
-          << " (expected 5 bytes, but actually got " << chars_in << ").";
+      oss << "Cannot open the file '" << path << "'.";
       throw std::runtime_error(oss.str());
     }
 
-    // The layout should be a validity byte (either 0 or 1), followed
-    // by 4 bytes with a little-endian 32-bit word.
-    uint8_t vld_byte = minibuf[0];
-    if (vld_byte > 2) {
+    struct stat statbuf;
+    bool sized = create ? ftruncate(fd, len_) == 0
+                        : (fstat(fd, &statbuf) == 0 &&
+                           (size_t)statbuf.st_size >= len_);
+    if (!sized) {
+      close(fd);
       std::ostringstream oss;
-      oss << "Word " << i << " at " << path
-          << " had a validity byte with value " << (int)vld_byte
-          << "; not 0 or 1.";
+      oss << "Cannot " << (create ? "resize" : "read") << " " << num_words
+          << " words " << (create ? "for" : "from") << " " << path << ".";
       throw std::runtime_error(oss.str());
     }
-    bool valid = vld_byte == 1;
 
-    uint32_t word = 0;
-    for (int j = 0; j < 4; ++j) {
-      word |= (uint32_t)(uint8_t)minibuf[j + 1] << 8 * j;
+    if (len_) {
+      int prot = create ? PROT_READ | PROT_WRITE : PROT_READ;
+      addr_ = mmap(nullptr, len_, prot, MAP_SHARED, fd, 0);
     }
+    close(fd);
+    if (addr_ == MAP_FAILED) {
+      std::ostringstream oss;
+      oss << "Cannot map the file '" << path << "': " << strerror(errno);
+      throw std::runtime_error(oss.str());
+    }
+  }
 
-    ret.push_back(std::make_pair(valid, word));
+  ~MemImageFile() {
+    if (addr_ && len_)
+      munmap(addr_, len_);
   }
 
-  return ret;
-}
+  MemImageFile(const MemImageFile &) = delete;
+  MemImageFile &operator=(const MemImageFile &) = delete;
 
-// Write some words to a new file at path. On failure, throws a
-// std::runtime_error.
-static void write_words_to_file(const std::string &path,
-                                const Ecc32MemArea::EccWords &words) {
-  std::filebuf fb;
-  if (!fb.open(path.c_str(), std::ios::out | std::ios::binary)) {
-    std::ostringstream oss;
-    oss << "Cannot open the file '" << path << "'.";
-    throw std::runtime_error(oss.str());
+  const uint8_t *data() const { return static_cast<const uint8_t *>(addr_); }
+  size_t size() const { return len_; }
+
+  // Fill the file with words, which must have num_words entries. The file
+  // must have been created with create = true.
+  void Write(const Ecc32MemArea::EccWords &words) {
+    assert(words.size() * kBytesPerWord == len_);
+    Encode(words, static_cast<uint8_t *>(addr_));
   }
 
-  for (const Ecc32MemArea::EccWord &word : words) {
-    uint8_t bytes[5];
+  // Read the words in the file. On failure, throws a std::runtime_error.
+  Ecc32MemArea::EccWords Read() const {
+    size_t num_words = len_ / kBytesPerWord;
+    Ecc32MemArea::EccWords ret;
+    ret.reserve(num_words);
+
+    const uint8_t *src = data();
+    for (size_t i = 0; i < num_words; ++i, src += kBytesPerWord) {
+      uint8_t vld_byte = src[0];
+      if (vld_byte > 2) {
+        std::ostringstream oss;
+        oss << "Word " << i << " at " << path_
+            << " had a validity byte with value " << (int)vld_byte
+            << "; not 0 or 1.";
+        throw std::runtime_error(oss.str());
+      }
+      bool valid = vld_byte == 1;
 
-    bool valid = word.first;
-    uint32_t w32 = word.second;
+      uint32_t word = 0;
+      for (int j = 0; j < 4; ++j) {
+        word |= (uint32_t)src[j + 1] << 8 * j;
+      }
 
-    bytes[0] = valid ? 1 : 0;
-    for (int j = 0; j < 4; ++j) {
-      bytes[j + 1] = (w32 >> (8 * j)) & 0xff;
+      ret.push_back(std::make_pair(valid, word));
     }
+    return ret;
+  }
 
-    std::streamsize chars_out =
-        fb.sputn(reinterpret_cast<const char *>(&bytes), 5);
-    if (chars_out != 5) {
-      std::ostringstream oss;
-      oss << "Failed to write to " << path << ".";
-      throw std::runtime_error(oss.str());
+  // Encode words in the file format at dst, which must have room for
+  // words.size() * kBytesPerWord bytes. Invalid words are written as zero,
+  // which matches what the ISS does.
+  static void Encode(const Ecc32MemArea::EccWords &words, uint8_t *dst) {
+    for (const Ecc32MemArea::EccWord &word : words) {
+      bool valid = word.first;
+      uint32_t w32 = valid ? word.second : 0;
+
+      dst[0] = valid ? 1 : 0;
+      for (int j = 0; j < 4; ++j) {
+        dst[j + 1] = (w32 >> (8 * j)) & 0xff;
+      }
+      dst += kBytesPerWord;
     }
   }
-}
+
+ private:
+  std::string path_;
+  size_t len_;
+  void *addr_;
+};
 
 template <typename T>
-static std::array<T, 32> get_rtl_regs(const std::string &reg_scope) {
+static std::array<T, 32> get_rtl_regs(const SVScopeHandle &reg_scope) {
   std::array<T, 32> ret;
   static_assert(sizeof(T) <= 256 / 8, "Can only copy 256 bits");
 
   SVScoped scoped(reg_scope);
 
-  // otbn_rf_peek passes data as a packed array of svBitVecVal words (for a
-  // "bit [255:0]" argument). Allocate 256 bits (= 32 bytes) as
-  // 32/sizeof(svBitVecVal) words on the stack.
-  svBitVecVal buf[256 / 8 / sizeof(svBitVecVal)];
+  // otbn_rf_peek_all passes data as a packed array of svBitVecVal words (for a
+  // "bit [32*256-1:0]" argument), with register i in bits [256*i +: 256].
+  // Allocate 32 * 256 bits (= 1024 bytes) as 1024/sizeof(svBitVecVal) words.
+  static const size_t kWordsPerReg = 256 / 8 / sizeof(svBitVecVal);
+  svBitVecVal buf[32 * kWordsPerReg];
+
+  if (!otbn_rf_peek_all(buf)) {
+    std::ostringstream oss;
+    oss << "Failed to peek into RTL to get values of registers at scope `"
+        << reg_scope.GetName() << "'.";
+    throw std::runtime_error(oss.str());
+  }
 
   for (int i = 0; i < 32; ++i) {
-    if (!otbn_rf_peek(i, buf)) {
-      std::ostringstream oss;
-      oss << "Failed to peek into RTL to get value of register " << i
-          << " at scope `" << reg_scope << "'.";
-      throw std::runtime_error(oss.str());
-    }
-    memcpy(&ret[i], buf, sizeof(T));
+    memcpy(&ret[i], &buf[i * kWordsPerReg], sizeof(T));
   }
 
   return ret;
 }
 
 template <typename T>
-static std::vector<T> get_stack(const std::string &stack_scope) {
+static std::vector<T> get_stack(const SVScopeHandle &stack_scope) {
   std::vector<T> ret;
   static_assert(sizeof(T) <= 256 / 8, "Can only copy 256 bits");
 
@@ -170,7 +211,7 @@ static std::vector<T> get_stack(const std::string &stack_scope) {
     if (peek_result == 2) {
       std::ostringstream oss;
       oss << "Failed to peek into RTL to get value of stack element " << i
-          << " at scope `" << stack_scope << "'.";
+          << " at scope `" << stack_scope.GetName() << "'.";
       throw std::runtime_error(oss.str());
     }
 
@@ -191,11 +232,26 @@ static std::vector<T> get_stack(const std::string &stack_scope) {
 
 OtbnModel::OtbnModel(const std::string &mem_scope,
                      const std::string &design_scope)
-    : mem_util_(mem_scope), design_scope_(design_scope) {
+    : mem_util_(mem_scope),
+      design_scope_(design_scope),
+      base_rf_scope_(
+          design_scope +
+          ".u_otbn_rf_base.gen_rf_base_ff.u_otbn_rf_base_inner.u_snooper"),
+      bignum_rf_scope_(design_scope +
+                       ".u_otbn_rf_bignum.gen_rf_bignum_ff."
+                       "u_otbn_rf_bignum_inner.u_snooper"),
+      call_stack_scope_(design_scope + ".u_otbn_rf_base.u_call_stack_snooper"),
+      dmem_sweep_interval_(16) {
   assert(mem_scope.size() && design_scope.size());
+
+  const char *interval_str = getenv("OTBN_DMEM_SWEEP_INTERVAL");
+  if (interval_str) {
+    int interval = atoi(interval_str);
+    dmem_sweep_interval_ = interval > 0 ? interval : 1;
+  }
 }
 
-OtbnModel::~OtbnModel() {}
+OtbnModel::~OtbnModel() { ISSWrapper::release(std::move(iss_)); }
 
 int OtbnModel::take_loop_warps(const OtbnMemUtil &memutil) {
   ISSWrapper *iss = ensure_wrapper();
@@ -239,18 +295,27 @@ int OtbnModel::start_operation(command_t command) {
         cmd_desc = "execute";
         iss_command = ISSWrapper::Execute;
 
-        std::string dfname(iss->make_tmp_path("dmem"));
-        std::string ifname(iss->make_tmp_path("imem"));
+        std::string dfname(iss->make_shm_path("dmem"));
+        std::string ifname(iss->make_shm_path("imem"));
 
-        write_words_to_file(dfname, get_sim_memory(false));
-        write_words_to_file(ifname, get_sim_memory(true));
+        Ecc32MemArea::EccWords dmem_words = get_sim_memory(false);
+        Ecc32MemArea::EccWords imem_words = get_sim_memory(true);
+        MemImageFile(dfname, dmem_words.size(), true).Write(dmem_words);
+        MemImageFile(ifname, imem_words.size(), true).Write(imem_words);
 
         iss->load_d(dfname);
         iss->load_i(ifname);
+
+        // The ISS now has the same DMEM as the RTL, so forget any RTL writes
+        // from earlier operations.
+        std::vector<uint32_t> old_writes;
+        OtbnTraceChecker::get().TakeRtlDmemWrites(&old_writes);
+        dmem_tracked_ = true;
       } break;
 
       case DmemWipe:
         cmd_desc = "DMEM wipe";
+        dmem_tracked_ = false;
         iss_command = ISSWrapper::DmemWipe;
         break;
 
@@ -502,12 +567,12 @@ int OtbnModel::load_dmem() {
 
   const MemArea &dmem = mem_util_.GetMemArea(false);
 
-  std::string dfname(iss->make_tmp_path("dmem_out"));
+  std::string dfname(iss->make_shm_path("dmem_out"));
   try {
     // Read DMEM from the ISS
     iss->dump_d(dfname);
     set_sim_memory(false,
-                   read_words_from_file(dfname, dmem.GetSizeBytes() / 4));
+                   MemImageFile(dfname, dmem.GetSizeBytes() / 4, false).Read());
   } catch (const std::exception &err) {
     std::cerr << "Error when loading dmem from ISS: " << err.what() << "\n";
     return -1;
@@ -611,6 +676,7 @@ int OtbnModel::reset(svBitVecVal *status /* bit [7:0] */,
     std::cerr << "Error when resetting ISS: " << err.what() << "\n";
     return -1;
   }
+  dmem_tracked_ = false;
 
   set_sv_u8(status, iss->get_mirrored().status);
   set_sv_u32(insn_cnt, iss->get_mirrored().insn_cnt);
@@ -661,7 +727,7 @@ bool OtbnModel::is_at_start_of_wipe() const {
 ISSWrapper *OtbnModel::ensure_wrapper() {
   if (!iss_) {
     try {
-      iss_.reset(new ISSWrapper());
+      iss_ = ISSWrapper::acquire();
     } catch (const std::runtime_error &err) {
       std::cerr << "Error when constructing ISS wrapper: " << err.what()
                 << "\n";
@@ -686,16 +752,51 @@ bool OtbnModel::check_dmem(ISSWrapper &iss) const {
   const MemArea &dmem = mem_util_.GetMemArea(false);
   uint32_t dmem_bytes = dmem.GetSizeBytes();
 
-  std::string dfname(iss.make_tmp_path("dmem_out"));
+  std::string dfname(iss.make_shm_path("dmem_out"));
 
   iss.dump_d(dfname);
-  Ecc32MemArea::EccWords iss_words =
-      read_words_from_file(dfname, dmem_bytes / 4);
-  assert(iss_words.size() == dmem_bytes / 4);
+  MemImageFile iss_image(dfname, dmem_bytes / 4, false);
+
+  // Reading the RTL's memory is slow (it goes through DPI calls into the
+  // simulated memory), so only look at the words that might have changed since the ISS
+  // loaded DMEM from the RTL. Those are the words written by either side: the
+  // ISS tells us which words it wrote and the RTL trace shows the others. We
+  // can't trust that if there was no RTL trace or the operation failed (where
+  // the two might disagree about an aborted write), so do a full check in
+  // those cases, as well as every so often to catch anything else.
+  std::vector<uint32_t> rtl_writes;
+  bool rtl_traced = OtbnTraceChecker::get().TakeRtlDmemWrites(&rtl_writes);
+  bool sweep = !dmem_tracked_ || !rtl_traced ||
+               iss.get_mirrored().err_bits != 0 ||
+               ++dmem_checks_since_sweep_ >= dmem_sweep_interval_;
+
+  if (!sweep) {
+    std::vector<uint32_t> offsets = iss.get_dmem_dirty();
+    offsets.insert(offsets.end(), rtl_writes.begin(), rtl_writes.end());
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+    if (dmem_words_match(offsets, iss_image.data()))
+      return true;
+  }
+
+  // If there's a mismatch, fall through to the full comparison below, which
+  // reports it.
+  dmem_checks_since_sweep_ = 0;
 
   Ecc32MemArea::EccWords rtl_words = get_sim_memory(false);
   assert(rtl_words.size() == dmem_bytes / 4);
 
+  // In the common case, the two memories match exactly. Check that by
+  // comparing the ISS's image in place with the same encoding of the RTL's
+  // memory, and only decode the ISS's image if they differ.
+  std::vector<uint8_t> rtl_image(iss_image.size());
+  MemImageFile::Encode(rtl_words, rtl_image.data());
+  if (memcmp(rtl_image.data(), iss_image.data(), rtl_image.size()) == 0)
+    return true;
+
+  Ecc32MemArea::EccWords iss_words = iss_image.Read();
+  assert(iss_words.size() == dmem_bytes / 4);
+
   std::ios old_state(nullptr);
   old_state.copyfmt(std::cerr);
 
@@ -748,16 +849,48 @@ bool OtbnModel::check_dmem(ISSWrapper &iss) const {
   return bad_count == 0;
 }
 
-bool OtbnModel::check_regs(ISSWrapper &iss) const {
-  std::string base_scope =
-      design_scope_ +
-      ".u_otbn_rf_base.gen_rf_base_ff.u_otbn_rf_base_inner.u_snooper";
-  std::string wide_scope =
-      design_scope_ +
-      ".u_otbn_rf_bignum.gen_rf_bignum_ff.u_otbn_rf_bignum_inner.u_snooper";
+bool OtbnModel::dmem_words_match(const std::vector<uint32_t> &offsets,
+                                 const uint8_t *iss_image) const {
+  auto &dmem = mem_util_.GetMemArea(false);
+  uint32_t dmem_words = dmem.GetSizeWords();
+
+  // Read runs of adjacent 256-bit words together, to make fewer calls into
+  // the memory model.
+  size_t i = 0;
+  while (i < offsets.size()) {
+    size_t j = i + 1;
+    while (j < offsets.size() && offsets[j] == offsets[j - 1] + 32)
+      ++j;
+
+    // The offsets are in bytes. The memory area counts in 256-bit words, but
+    // the ISS image has an entry for each 32-bit word.
+    uint32_t word_offset = offsets[i] / 32;
+    uint32_t num_words = j - i;
+    if (word_offset + num_words > dmem_words) {
+      std::ostringstream oss;
+      oss << "DMEM write at offset 0x" << std::hex << offsets[j - 1]
+          << " is beyond the end of DMEM.";
+      throw std::runtime_error(oss.str());
+    }
+
+    Ecc32MemArea::EccWords rtl_words =
+        dmem.ReadWithIntegrity(word_offset, num_words);
+    std::vector<uint8_t> rtl_image(rtl_words.size() *
+                                   MemImageFile::kBytesPerWord);
+    MemImageFile::Encode(rtl_words, rtl_image.data());
+    if (memcmp(rtl_image.data(),
+               iss_image + (offsets[i] / 4) * MemImageFile::kBytesPerWord,
+               rtl_image.size()) != 0)
+      return false;
+
+    i = j;
+  }
+  return true;
+}
 
-  auto rtl_gprs = get_rtl_regs<uint32_t>(base_scope);
-  auto rtl_wdrs = get_rtl_regs<ISSWrapper::u256_t>(wide_scope);
+bool OtbnModel::check_regs(ISSWrapper &iss) const {
+  auto rtl_gprs = get_rtl_regs<uint32_t>(base_rf_scope_);
+  auto rtl_wdrs = get_rtl_regs<ISSWrapper::u256_t>(bignum_rf_scope_);
 
   std::array<uint32_t, 32> iss_gprs;
   std::array<ISSWrapper::u256_t, 32> iss_wdrs;
@@ -808,10 +941,7 @@ bool OtbnModel::check_regs(ISSWrapper &iss) const {
 }
 
 bool OtbnModel::check_call_stack(ISSWrapper &iss) const {
-  std::string call_stack_snooper_scope =
-      design_scope_ + ".u_otbn_rf_base.u_call_stack_snooper";
-
-  auto rtl_call_stack = get_stack<uint32_t>(call_stack_snooper_scope);
+  auto rtl_call_stack = get_stack<uint32_t>(call_stack_scope_);
 
   auto iss_call_stack = iss.get_call_stack();
 
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "otbn_memutil.h"
+#include "sv_scoped.h"
 
 struct ISSWrapper;
 
@@ -145,8 +146,17 @@ class OtbnModel {
   // Grab contents of dmem from the model and compare them with the RTL. Prints
   // messages to stderr on failure or mismatch. Returns true on success; false
   // on mismatch. Throws a std::runtime_error on failure.
+  //
+  // Usually, this only compares the DMEM words that the ISS or the RTL wrote
+  // during the operation (see dmem_tracked_), with a full comparison every
+  // dmem_sweep_interval_ checks.
   bool check_dmem(ISSWrapper &iss) const;
 
+  // Compare the given 256-bit DMEM words (as sorted byte offsets) of the RTL
+  // with the ISS's image of DMEM. Returns true if they all match exactly.
+  bool dmem_words_match(const std::vector<uint32_t> &offsets,
+                        const uint8_t *iss_image) const;
+
   // Compare contents of ISS registers with those from the design. Prints
   // messages to stderr on failure or mismatch. Returns true on success; false
   // on mismatch. Throws a std::runtime_error on failure.
@@ -161,12 +171,32 @@ class OtbnModel {
   // simulation, but might not actually want to spawn the ISS. To handle that
   // in a non-racy way, the most convenient thing is to spawn the ISS the first
   // time it's actually needed. Use ensure_wrapper() to create as needed.
+  //
+  // Wrappers come from (and go back to) a pool shared by all the models in
+  // the simulator process, so that a new model can reuse an ISS that has
+  // already started up. See ISSWrapper::acquire() and ISSWrapper::release().
   std::unique_ptr<ISSWrapper> iss_;
 
   OtbnMemUtil mem_util_;
   std::string design_scope_;
 
+  // Scopes of the register file and call stack snoopers in the design,
+  // resolved once rather than on every check.
+  SVScopeHandle base_rf_scope_;
+  SVScopeHandle bignum_rf_scope_;
+  SVScopeHandle call_stack_scope_;
+
   bool stack_check_enabled_ = true;
+
+  // True if the ISS loaded DMEM from the RTL at the start of the current
+  // operation. In that case, the two memories can only have diverged in words
+  // written since then, which the ISS and the RTL trace both record.
+  bool dmem_tracked_ = false;
+
+  // Do a full DMEM comparison every this many checks (set with the
+  // OTBN_DMEM_SWEEP_INTERVAL environment variable; 1 means always).
+  unsigned dmem_sweep_interval_;
+  mutable unsigned dmem_checks_since_sweep_ = 0;
 };
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_MODEL_H_
@@ -15,6 +15,7 @@ interface otbn_rf_snooper_if #(
 );
 
   export "DPI-C" function otbn_rf_peek;
+  export "DPI-C" function otbn_rf_peek_all;
 
   // Number of data bits per integrity code
   localparam int IntgGranule = IntegrityEnabled ? 32 : Width;
@@ -43,5 +44,23 @@ interface otbn_rf_snooper_if #(
     return 1;
   endfunction
 
+  // Read every register at once (register i is at bits [256*i +: 256] of vals). This is much
+  // cheaper than calling otbn_rf_peek for each register in turn.
+  function automatic int otbn_rf_peek_all(output bit [32*256-1:0] vals);
+    bit [255:0] val;
+
+    // Function only works for register files with 32 registers of 256 data bits or fewer
+    if (DataWidth > 256 || Depth != 32) begin
+      return 0;
+    end
+
+    for (int i = 0; i < Depth; ++i) begin
+      void'(otbn_rf_peek(i, val));
+      vals[i * 256 +: 256] = val;
+    end
+
+    return 1;
+  endfunction
+
 endinterface
 `endif // SYNTHESIS
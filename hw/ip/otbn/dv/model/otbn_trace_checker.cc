@@ -5,6 +5,7 @@
 #include "otbn_trace_checker.h"
 
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -21,11 +22,34 @@ OtbnTraceChecker::OtbnTraceChecker()
       iss_pending_(false),
       done_(true),
       seen_err_(false),
-      last_data_vld_(false) {
+      last_data_vld_(false),
+      rtl_traced_(false),
+      max_lag_(0),
+      unchecked_(0),
+      failed_(false),
+      stopping_(false) {
   OtbnTraceSource::get().AddListener(this);
+
+  const char *lag_str = getenv("OTBN_TRACE_CHECK_LAG");
+  if (lag_str) {
+    int lag = atoi(lag_str);
+    max_lag_ = lag > 0 ? lag : 0;
+  }
+  if (max_lag_) {
+    checker_ = std::thread(&OtbnTraceChecker::CheckQueuedTraces, this);
+  }
 }
 
 OtbnTraceChecker::~OtbnTraceChecker() {
+  if (checker_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      stopping_ = true;
+    }
+    queue_cond_.notify_all();
+    checker_.join();
+  }
+
   if (!done_) {
     std::cerr
         << ("WARNING: Destroying OtbnTraceChecker object with an "
@@ -40,19 +64,35 @@ OtbnTraceChecker &OtbnTraceChecker::get() {
   return *trace_checker;
 }
 
-void OtbnTraceChecker::AcceptTraceString(const std::string &trace,
+void OtbnTraceChecker::AcceptTraceRecord(const OtbnTraceRecord &record,
                                          unsigned int cycle_count) {
+  rtl_traced_ = true;
+  for (size_t i = 0; i < record.size(); ++i) {
+    const OtbnTraceItem &item = record.item(i);
+    if (item.kind == OtbnTraceItem::Mem && item.is_write)
+      rtl_dmem_writes_.push_back(item.addr & ~31u);
+  }
+
+  if (max_lag_) {
+    QueueTrace(&record, nullptr);
+  } else {
+    CheckRtlRecord(record);
+  }
+}
+
+bool OtbnTraceChecker::OnIssTrace(const std::vector<std::string> &lines) {
+  return max_lag_ ? QueueTrace(nullptr, &lines) : CheckIssTrace(lines);
+}
+
+void OtbnTraceChecker::CheckRtlRecord(const OtbnTraceRecord &record) {
   assert(!(rtl_pending_ && iss_pending_));
 
   if (seen_err_)
     return;
 
   done_ = false;
-  OtbnTraceEntry trace_entry;
-  if (!trace_entry.from_rtl_trace(trace)) {
-    seen_err_ = true;
-    return;
-  }
+  OtbnTraceEntry &trace_entry = rtl_new_entry_;
+  trace_entry.from_rtl_record(record);
   if (trace_entry.trace_type() == OtbnTraceEntry::Invalid) {
     std::cerr << "ERROR: Invalid RTL trace entry with invalid header:\n";
     trace_entry.print("  ", std::cerr);
@@ -118,7 +158,7 @@ void OtbnTraceChecker::AcceptTraceString(const std::string &trace,
       // This is the first partial entry. Set the rtl_started_ flag and save
       // trace_entry.
       rtl_started_ = true;
-      rtl_entry_ = trace_entry;
+      rtl_entry_.swap(trace_entry);
     }
     return;
   }
@@ -146,21 +186,21 @@ void OtbnTraceChecker::AcceptTraceString(const std::string &trace,
 
   rtl_pending_ = true;
   rtl_started_ = false;
-  rtl_entry_ = trace_entry;
+  rtl_entry_.swap(trace_entry);
 
   if (!MatchPair()) {
     seen_err_ = true;
   }
 }
 
-bool OtbnTraceChecker::OnIssTrace(const std::vector<std::string> &lines) {
+bool OtbnTraceChecker::CheckIssTrace(const std::vector<std::string> &lines) {
   assert(!(rtl_pending_ && iss_pending_));
 
   if (seen_err_) {
     return false;
   }
 
-  OtbnIssTraceEntry trace_entry;
+  OtbnIssTraceEntry &trace_entry = iss_new_entry_;
   if (!trace_entry.from_iss_trace(lines)) {
     // Error parsing ISS trace. This has already printed a message to stderr.
     // Just return false to pass the error code along.
@@ -192,7 +232,7 @@ bool OtbnTraceChecker::OnIssTrace(const std::vector<std::string> &lines) {
   }
 
   iss_started_ = true;
-  iss_entry_ = trace_entry;
+  iss_entry_.swap(trace_entry);
 
   // Set the pending flag if we've got the end of an event (either E or V).
   if (iss_entry_.is_final()) {
@@ -202,7 +242,77 @@ bool OtbnTraceChecker::OnIssTrace(const std::vector<std::string> &lines) {
   return MatchPair();
 }
 
+bool OtbnTraceChecker::QueueTrace(const OtbnTraceRecord *record,
+                                  const std::vector<std::string> *lines) {
+  assert(max_lag_);
+
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  queue_cond_.wait(lock, [this] { return unchecked_ < max_lag_; });
+  if (failed_) {
+    // There's no point comparing anything else
+    return false;
+  }
+
+  if (spare_.empty()) {
+    queue_.emplace_back();
+  } else {
+    queue_.push_back(std::move(spare_.back()));
+    spare_.pop_back();
+  }
+  QueuedTrace &trace = queue_.back();
+  trace.from_rtl = record != nullptr;
+  if (record) {
+    trace.rtl_record = *record;
+  } else {
+    trace.iss_lines.assign(lines->begin(), lines->end());
+  }
+  ++unchecked_;
+
+  lock.unlock();
+  queue_cond_.notify_all();
+  return true;
+}
+
+bool OtbnTraceChecker::WaitForChecks() {
+  if (!max_lag_)
+    return true;
+
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  queue_cond_.wait(lock, [this] { return unchecked_ == 0; });
+  return !failed_;
+}
+
+void OtbnTraceChecker::CheckQueuedTraces() {
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  for (;;) {
+    queue_cond_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // Stopping, and everything has been checked
+      break;
+    }
+
+    QueuedTrace trace = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+
+    bool good;
+    if (trace.from_rtl) {
+      CheckRtlRecord(trace.rtl_record);
+      good = !seen_err_;
+    } else {
+      good = CheckIssTrace(trace.iss_lines);
+    }
+
+    lock.lock();
+    failed_ |= !good;
+    spare_.push_back(std::move(trace));
+    --unchecked_;
+    queue_cond_.notify_all();
+  }
+}
+
 void OtbnTraceChecker::Flush() {
+  WaitForChecks();
   rtl_pending_ = false;
   rtl_started_ = false;
   iss_pending_ = false;
@@ -211,9 +321,10 @@ void OtbnTraceChecker::Flush() {
 }
 
 bool OtbnTraceChecker::Finish() {
+  bool checks_ok = WaitForChecks();
   assert(!(rtl_pending_ && iss_pending_));
   done_ = true;
-  if (seen_err_) {
+  if (seen_err_ || !checks_ok) {
     return false;
   }
   if (iss_pending_) {
@@ -235,7 +346,16 @@ bool OtbnTraceChecker::Finish() {
   return true;
 }
 
+bool OtbnTraceChecker::TakeRtlDmemWrites(std::vector<uint32_t> *offsets) {
+  bool traced = rtl_traced_;
+  offsets->swap(rtl_dmem_writes_);
+  rtl_dmem_writes_.clear();
+  rtl_traced_ = false;
+  return traced;
+}
+
 const OtbnIssTraceEntry::IssData *OtbnTraceChecker::PopIssData() {
+  WaitForChecks();
   if (!last_data_vld_)
     return nullptr;
 
@@ -243,7 +363,10 @@ const OtbnIssTraceEntry::IssData *OtbnTraceChecker::PopIssData() {
   return &last_data_;
 }
 
-void OtbnTraceChecker::set_no_sec_wipe_chk() { no_sec_wipe_data_chk_ = true; }
+void OtbnTraceChecker::set_no_sec_wipe_chk() {
+  WaitForChecks();
+  no_sec_wipe_data_chk_ = true;
+}
 
 bool OtbnTraceChecker::MatchPair() {
   if (!(rtl_pending_ && iss_pending_)) {
@@ -34,9 +34,21 @@
 //
 // To catch these cases, the ISS simulation must call the Finish() method when
 // it is done (which checks there are no outstanding events missing).
-
+//
+// If the OTBN_TRACE_CHECK_LAG environment variable is set to a positive number
+// N, trace entries are compared on a separate thread and the simulation only
+// waits for it once N entries are queued. A mismatch is then reported by a
+// later call to OnIssTrace (at most N entries late) or by Finish. The other
+// API functions wait for the queue to empty, so they behave as if everything
+// had been compared synchronously.
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <iosfwd>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "otbn_trace_entry.h"
@@ -52,7 +64,7 @@ class OtbnTraceChecker : public OtbnTraceListener {
 
   // Take a trace entry from the wrapped RTL. Any mismatch error is stored
   // until the next call to an API function that can respond with the error.
-  void AcceptTraceString(const std::string &trace,
+  void AcceptTraceRecord(const OtbnTraceRecord &record,
                          unsigned int cycle_count) override;
 
   // Take a trace entry from the wrapped ISS.
@@ -80,7 +92,41 @@ class OtbnTraceChecker : public OtbnTraceListener {
   // secure wipe entry.
   void set_no_sec_wipe_chk();
 
+  // Take the byte offsets of the 256-bit DMEM words that the RTL has traced
+  // writes to since the last call, clearing the list. Returns false if there
+  // has been no RTL trace at all since the last call, in which case the list
+  // says nothing about what the RTL might have written.
+  bool TakeRtlDmemWrites(std::vector<uint32_t> *offsets);
+
  private:
+  // Trace from the RTL or the ISS that is waiting to be compared by the
+  // checker thread
+  struct QueuedTrace {
+    bool from_rtl;
+    OtbnTraceRecord rtl_record;
+    std::vector<std::string> iss_lines;
+  };
+
+  // Compare a trace entry from the RTL or the ISS. These do the work of
+  // AcceptTraceRecord and OnIssTrace, either directly or on the checker
+  // thread. CheckIssTrace returns false on a mismatch.
+  void CheckRtlRecord(const OtbnTraceRecord &record);
+  bool CheckIssTrace(const std::vector<std::string> &lines);
+
+  // Queue some trace for the checker thread, waiting if there are already
+  // max_lag_ entries that haven't been checked. Returns false if the checker
+  // thread has seen a mismatch.
+  bool QueueTrace(const OtbnTraceRecord *record,
+                  const std::vector<std::string> *lines);
+
+  // Wait until the checker thread has compared everything queued. Returns
+  // false if it has seen a mismatch. Does nothing if there is no checker
+  // thread.
+  bool WaitForChecks();
+
+  // Body of the checker thread
+  void CheckQueuedTraces();
+
   // If rtl_pending_ and iss_pending_ are not both true, return true
   // immediately with no other change. Otherwise, compare the two pending trace
   // entries. If they match, clear them both and return true. If not, print a
@@ -95,6 +141,12 @@ class OtbnTraceChecker : public OtbnTraceListener {
   bool iss_pending_;
   OtbnIssTraceEntry iss_entry_;
 
+  // Entries that incoming trace is parsed into. They are swapped with
+  // rtl_entry_ and iss_entry_ rather than copied, so that the storage of all
+  // four entries is reused and checking an instruction doesn't allocate.
+  OtbnTraceEntry rtl_new_entry_;
+  OtbnIssTraceEntry iss_new_entry_;
+
   bool done_;
   bool seen_err_;
 
@@ -103,6 +155,28 @@ class OtbnTraceChecker : public OtbnTraceListener {
   bool last_data_vld_;
   OtbnIssTraceEntry::IssData last_data_;
   bool no_sec_wipe_data_chk_;
+
+  // DMEM writes seen in RTL trace entries (see TakeRtlDmemWrites)
+  bool rtl_traced_;
+  std::vector<uint32_t> rtl_dmem_writes_;
+
+  // The number of trace entries that may be waiting for the checker thread,
+  // or zero if there is no checker thread.
+  size_t max_lag_;
+
+  // The checker thread's queue, protected by queue_mutex_. unchecked_ counts
+  // the entries in queue_ plus any that the thread is comparing. Once it's
+  // done with an entry, the thread moves it to spare_ so that its storage
+  // can be reused. failed_ is set when the thread has seen a mismatch.
+  std::deque<QueuedTrace> queue_;
+  std::vector<QueuedTrace> spare_;
+  size_t unchecked_;
+  bool failed_;
+  bool stopping_;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cond_;
+
+  std::thread checker_;
 };
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_TRACE_CHECKER_H_
@@ -4,56 +4,256 @@
 
 #include "otbn_trace_entry.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
-#include <regex>
+#include <iterator>
 #include <sstream>
 
+// Order body lines by location
+static bool LocLess(const OtbnTraceBodyLine &a, const OtbnTraceBodyLine &b) {
+  return a.get_loc() < b.get_loc();
+}
+
+// Return the value of a hex digit, 16 for an unknown digit ('x') or -1 if c
+// isn't a digit.
+static int HexDigitVal(char c) {
+  if ('0' <= c && c <= '9')
+    return c - '0';
+  if ('a' <= c && c <= 'f')
+    return c - 'a' + 10;
+  if (c == 'x')
+    return 16;
+  return -1;
+}
+
+// The string format of a flag group, with '_' where the C, M, L and Z flags go
+static const char kFlagsTemplate[] = "{C: _, M: _, L: _, Z: _}";
+static const int kFlagsPos[] = {4, 10, 16, 22};
+
 bool OtbnTraceBodyLine::fill_from_string(const std::string &src,
                                          const std::string &line) {
-  // A valid line matches the following regex
-  std::regex re("(.) ([^:]+): (.+)");
-  std::smatch match;
-
-  if (!std::regex_match(line, match, re)) {
+  // A valid line matches the regex "(.) ([^:]+): (.+)"
+  size_t colon = line.find(':', 2);
+  if (line.size() < 2 || line[1] != ' ' || colon == std::string::npos ||
+      colon == 2 || line.size() < colon + 3 || line[colon + 1] != ' ' ||
+      line.find('\n') != std::string::npos) {
     std::cerr << "OTBN trace body line from " << src
               << " does not have expected format. Saw: `" << line << "'.\n";
     return false;
   }
 
-  assert(match.size() == 4);
+  type_ = line[0];
+  loc_.assign(line, 2, colon - 2);
+  set_value(line.substr(colon + 2));
+  return true;
+}
+
+void OtbnTraceBodyLine::fill_from_item(const OtbnTraceItem &item) {
+  type_ = item.LineType();
+  loc_ = item.Location();
+
+  int num_words;
+  switch (item.kind) {
+    case OtbnTraceItem::BaseReg:
+      num_words = 1;
+      break;
+    case OtbnTraceItem::WideReg:
+    case OtbnTraceItem::Ispr:
+      num_words = OtbnTraceValue::kNumWords;
+      break;
+    case OtbnTraceItem::Flags: {
+      const OtbnTraceWord &f = item.data.words[0];
+      uint32_t digits = 0, unknown = 0;
+      for (int i = 0; i < 4; ++i) {
+        bool a = (f.aval >> i) & 1, b = (f.bval >> i) & 1;
+        if (b && !a) {
+          // A Z flag doesn't have a digit, so the value is kept as text
+          set_value(item.Value());
+          return;
+        }
+        digits |= (uint32_t)(a && !b) << (4 * i);
+        unknown |= (b ? 0xfu : 0u) << (4 * i);
+      }
+      kind_ = Flags;
+      num_words_ = 1;
+      digits_[0] = digits;
+      unknown_[0] = unknown;
+      return;
+    }
+    default:
+      set_value(item.Value());
+      return;
+  }
+
+  for (int i = 0; i < num_words; ++i) {
+    const OtbnTraceWord &w = item.data.words[i];
+    // Nibbles that are all X are unknown digits. Any other X or Z bits don't
+    // have a digit, so the value is kept as text.
+    uint32_t x_nibbles = 0;
+    for (int j = 0; j < 32; j += 4) {
+      uint32_t b = (w.bval >> j) & 0xf;
+      if (b == 0)
+        continue;
+      if (b != 0xf || ((w.aval >> j) & 0xf) != 0xf) {
+        set_value(item.Value());
+        return;
+      }
+      x_nibbles |= 0xfu << j;
+    }
+    digits_[i] = w.aval & ~x_nibbles;
+    unknown_[i] = x_nibbles;
+  }
+  kind_ = Hex;
+  num_words_ = num_words;
+}
+
+void OtbnTraceBodyLine::set_value(const std::string &value) {
+  if (set_hex_value(value) || set_flags_value(value))
+    return;
+
+  kind_ = Text;
+  text_ = value;
+}
+
+bool OtbnTraceBodyLine::set_hex_value(const std::string &value) {
+  // Expect "0x" followed by 1 to kNumWords groups of 8 digits, most
+  // significant first and separated by '_'.
+  size_t len = value.size();
+  if (len < 10 || (len - 1) % 9 || value[0] != '0' || value[1] != 'x')
+    return false;
+
+  int num_words = (len - 1) / 9;
+  if (num_words > OtbnTraceValue::kNumWords)
+    return false;
+
+  for (int i = 0; i < num_words; ++i) {
+    size_t start = 2 + 9 * (num_words - 1 - i);
+    if (i && value[start + 8] != '_')
+      return false;
+
+    uint32_t digits = 0, unknown = 0;
+    for (size_t j = start; j < start + 8; ++j) {
+      int v = HexDigitVal(value[j]);
+      if (v < 0)
+        return false;
+      digits <<= 4;
+      unknown <<= 4;
+      if (v == 16)
+        unknown |= 0xf;
+      else
+        digits |= v;
+    }
+    digits_[i] = digits;
+    unknown_[i] = unknown;
+  }
 
-  raw_ = line;
-  type_ = match[1].str()[0];
-  loc_ = match[2].str();
-  value_ = match[3].str();
+  kind_ = Hex;
+  num_words_ = num_words;
   return true;
 }
 
-bool OtbnTraceBodyLine::operator==(const OtbnTraceBodyLine &other) const {
-  // If the raw lines are identical, the two objects are identical and no
-  // further checks are required.
-  if (raw_ == other.raw_) {
-    return true;
+bool OtbnTraceBodyLine::set_flags_value(const std::string &value) {
+  if (value.size() != sizeof(kFlagsTemplate) - 1)
+    return false;
+
+  uint32_t digits = 0, unknown = 0;
+  int flag = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    if (kFlagsTemplate[i] != '_') {
+      if (value[i] != kFlagsTemplate[i])
+        return false;
+      continue;
+    }
+    switch (value[i]) {
+      case '0':
+        break;
+      case '1':
+        digits |= 1u << (4 * flag);
+        break;
+      case 'x':
+        unknown |= 0xfu << (4 * flag);
+        break;
+      default:
+        return false;
+    }
+    ++flag;
   }
 
-  // If the raw lines are not identical, the two objects can be identical if one
-  // of them contains unknown values.
+  kind_ = Flags;
+  num_words_ = 1;
+  digits_[0] = digits;
+  unknown_[0] = unknown;
+  return true;
+}
+
+std::string OtbnTraceBodyLine::value_string() const {
+  static const char hex_digits[] = "0123456789abcdef";
+  switch (kind_) {
+    case Hex: {
+      std::string ret("0x");
+      for (int i = num_words_ - 1; i >= 0; --i) {
+        for (int j = 28; j >= 0; j -= 4) {
+          bool unknown = (unknown_[i] >> j) & 0xf;
+          ret.push_back(unknown ? 'x' : hex_digits[(digits_[i] >> j) & 0xf]);
+        }
+        if (i)
+          ret.push_back('_');
+      }
+      return ret;
+    }
+    case Flags: {
+      std::string ret(kFlagsTemplate);
+      for (int i = 0; i < 4; ++i) {
+        bool unknown = (unknown_[0] >> (4 * i)) & 0xf;
+        ret[kFlagsPos[i]] =
+            unknown ? 'x' : hex_digits[(digits_[0] >> (4 * i)) & 0xf];
+      }
+      return ret;
+    }
+    case Text:
+      break;
+  }
+  return text_;
+}
 
-  // Type and location have to be identical, though.
+std::string OtbnTraceBodyLine::get_string() const {
+  return std::string(1, type_) + " " + loc_ + ": " + value_string();
+}
+
+bool OtbnTraceBodyLine::operator==(const OtbnTraceBodyLine &other) const {
+  // Type and location have to be identical.
   if (type_ != other.type_ || loc_ != other.loc_) {
     return false;
   }
 
-  // The values have to be of identical length.
-  if (value_.size() != other.value_.size()) {
+  // If both values are stored as digits, compare them as integers, ignoring
+  // any digit that is unknown in either value.
+  if (kind_ != Text && other.kind_ != Text) {
+    if (kind_ != other.kind_ || num_words_ != other.num_words_) {
+      return false;
+    }
+    for (int i = 0; i < num_words_; ++i) {
+      uint32_t known = ~(unknown_[i] | other.unknown_[i]);
+      if ((digits_[i] ^ other.digits_[i]) & known) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Otherwise, compare the values as strings. They have to be of identical
+  // length.
+  std::string value = value_string();
+  std::string other_value = other.value_string();
+  if (value.size() != other_value.size()) {
     return false;
   }
 
   // Compare values digit by digit and treat `x` as unknown value, which is
   // identical to any other value.
-  std::string::const_iterator other_it = other.value_.begin();
-  for (std::string::const_iterator it = value_.begin(); it != value_.end();
+  std::string::const_iterator other_it = other_value.begin();
+  for (std::string::const_iterator it = value.begin(); it != value.end();
        it++) {
     if (*it != *other_it && !(*it == 'x' || *other_it == 'x')) {
       return false;
@@ -63,29 +263,28 @@ bool OtbnTraceBodyLine::operator==(const OtbnTraceBodyLine &other) const {
   return true;
 }
 
-bool OtbnTraceEntry::from_rtl_trace(const std::string &trace) {
-  size_t eol = trace.find('\n');
-  hdr_ = trace.substr(0, eol);
+void OtbnTraceEntry::from_rtl_record(const OtbnTraceRecord &record) {
+  record.HeaderString(&hdr_);
   trace_type_ = hdr_to_trace_type(hdr_);
+  writes_.clear();
 
-  while (eol != std::string::npos) {
-    size_t bol = eol + 1;
-    eol = trace.find('\n', bol);
-    size_t line_len =
-        (eol == std::string::npos) ? std::string::npos : eol - bol;
-    std::string line = trace.substr(bol, line_len);
+  OtbnTraceBodyLine line;
+  for (size_t i = 0; i < record.size(); ++i) {
+    const OtbnTraceItem &item = record.item(i);
 
     // We're only interested in register writes
-    if (!(line.size() > 0 && line[0] == '>'))
+    if (item.kind == OtbnTraceItem::Mem || !item.is_write)
       continue;
 
-    OtbnTraceBodyLine parsed_line;
-    if (!parsed_line.fill_from_string("RTL", line)) {
-      return false;
-    }
-    writes_[parsed_line.get_loc()].push_back(parsed_line);
+    line.fill_from_item(item);
+    add_write(line);
   }
-  return true;
+}
+
+void OtbnTraceEntry::swap(OtbnTraceEntry &other) {
+  std::swap(trace_type_, other.trace_type_);
+  hdr_.swap(other.hdr_);
+  writes_.swap(other.writes_);
 }
 
 bool OtbnTraceEntry::compare_rtl_iss_entries(const OtbnTraceEntry &other,
@@ -98,26 +297,31 @@ bool OtbnTraceEntry::compare_rtl_iss_entries(const OtbnTraceEntry &other,
     return false;
   }
 
-  for (const auto &rtlptr : writes_) {
-    auto isskey = other.writes_.find(rtlptr.first);
-    if (isskey == other.writes_.end()) {
+  for (line_iter_t rtl_it = writes_.begin(); rtl_it != writes_.end();) {
+    line_iter_t rtl_end = loc_end(rtl_it, writes_.end());
+    line_iter_t iss_it = std::lower_bound(
+        other.writes_.begin(), other.writes_.end(), *rtl_it, LocLess);
+    if (iss_it == other.writes_.end() ||
+        iss_it->get_loc() != rtl_it->get_loc()) {
       std::ostringstream oss;
-      oss << "RTL had a write to `" << rtlptr.first
+      oss << "RTL had a write to `" << rtl_it->get_loc()
           << "', but the ISS doesn't have a write to that location.";
       *err_desc = oss.str();
       return false;
     }
-    // compare rtlptr.second and isskey.second
-    if (!check_entries_compatible(trace_type_, rtlptr.first, rtlptr.second,
-                                  isskey->second, no_sec_wipe_data_chk,
-                                  err_desc))
+    line_iter_t iss_end = loc_end(iss_it, other.writes_.end());
+    if (!check_entries_compatible(trace_type_, rtl_it->get_loc(), rtl_it,
+                                  rtl_end, iss_it, iss_end,
+                                  no_sec_wipe_data_chk, err_desc))
       return false;
+    rtl_it = rtl_end;
   }
 
-  if (writes_.size() != other.writes_.size()) {
+  size_t rtl_locs = num_locs(), iss_locs = other.num_locs();
+  if (rtl_locs != iss_locs) {
     std::ostringstream oss;
-    oss << "RTL wrote to " << writes_.size() << " locations; the ISS wrote to "
-        << other.writes_.size() << ".";
+    oss << "RTL wrote to " << rtl_locs << " locations; the ISS wrote to "
+        << iss_locs << ".";
     *err_desc = oss.str();
     return false;
   }
@@ -127,30 +331,26 @@ bool OtbnTraceEntry::compare_rtl_iss_entries(const OtbnTraceEntry &other,
 
 void OtbnTraceEntry::print(const std::string &indent, std::ostream &os) const {
   os << indent << hdr_ << "\n";
-  for (const auto &pr : writes_) {
-    for (const auto &line : pr.second) {
-      os << indent << line.get_string() << "\n";
-    }
+  for (const auto &line : writes_) {
+    os << indent << line.get_string() << "\n";
   }
 }
 
 void OtbnTraceEntry::take_writes(const OtbnTraceEntry &other,
                                  bool other_first) {
-  for (const auto &pr : other.writes_) {
-    std::vector<OtbnTraceBodyLine> &so_far = writes_[pr.first];
-    if (other_first) {
-      // If other_first is true, we should prepend the writes from other. We do
-      // so by creating a temporary vector (with a copy of the writes from
-      // other) and then appending any writes we had before.
-      std::vector<OtbnTraceBodyLine> tmp(pr.second);
-      tmp.insert(tmp.end(), so_far.begin(), so_far.end());
-      writes_[pr.first] = tmp;
-    } else {
-      // If other_first is false, we should append the writes from other. We
-      // can do that with just a call to insert.
-      so_far.insert(so_far.end(), pr.second.begin(), pr.second.end());
-    }
+  // Both lists of writes are sorted by location, so merge them. Where the two
+  // entries write to the same location, std::merge puts the writes from its
+  // first range first.
+  merged_writes_.clear();
+  if (other_first) {
+    std::merge(other.writes_.begin(), other.writes_.end(), writes_.begin(),
+               writes_.end(), std::back_inserter(merged_writes_), LocLess);
+  } else {
+    std::merge(writes_.begin(), writes_.end(), other.writes_.begin(),
+               other.writes_.end(), std::back_inserter(merged_writes_),
+               LocLess);
   }
+  writes_.swap(merged_writes_);
 }
 
 bool OtbnTraceEntry::is_compatible(const OtbnTraceEntry &prev) const {
@@ -222,11 +422,10 @@ bool OtbnTraceEntry::is_final() const {
 }
 
 bool OtbnTraceEntry::check_entries_compatible(
-    trace_type_t type, const std::string &key,
-    const std::vector<OtbnTraceBodyLine> &rtl_lines,
-    const std::vector<OtbnTraceBodyLine> &iss_lines, bool no_sec_wipe_data_chk,
-    std::string *err_desc) {
-  assert(rtl_lines.size() && iss_lines.size());
+    trace_type_t type, const std::string &key, line_iter_t rtl_begin,
+    line_iter_t rtl_end, line_iter_t iss_begin, line_iter_t iss_end,
+    bool no_sec_wipe_data_chk, std::string *err_desc) {
+  assert(rtl_begin != rtl_end && iss_begin != iss_end);
   assert(type == WipeComplete || type == Exec);
   assert(err_desc);
 
@@ -235,9 +434,10 @@ bool OtbnTraceEntry::check_entries_compatible(
     // the key. We will also check that they are different, but
     // debugging is probably easier if the error message comments that
     // there aren't two lines *to* be different.
-    if (rtl_lines.size() < 2) {
+    size_t num_rtl_lines = rtl_end - rtl_begin;
+    if (num_rtl_lines < 2) {
       std::ostringstream oss;
-      oss << "There are " << rtl_lines.size() << " RTL lines for key `" << key
+      oss << "There are " << num_rtl_lines << " RTL lines for key `" << key
           << "'; we expected at least 2.";
       *err_desc = oss.str();
       return false;
@@ -247,8 +447,8 @@ bool OtbnTraceEntry::check_entries_compatible(
     // different values. This checks that we don't (e.g.) just write
     // zero to the key many times.
     bool seen_change = false;
-    for (size_t i = 1; i < rtl_lines.size(); i++) {
-      if (!(rtl_lines[i] == rtl_lines[0])) {
+    for (line_iter_t it = rtl_begin + 1; it != rtl_end; ++it) {
+      if (!(*it == *rtl_begin)) {
         seen_change = true;
         break;
       }
@@ -262,7 +462,7 @@ bool OtbnTraceEntry::check_entries_compatible(
     }
   }
 
-  if (!(rtl_lines.back() == iss_lines.back())) {
+  if (!(*(rtl_end - 1) == *(iss_end - 1))) {
     std::ostringstream oss;
     oss << "Final values of ISS and RTL don't match for key `" << key << "'.";
     *err_desc = oss.str();
@@ -272,6 +472,27 @@ bool OtbnTraceEntry::check_entries_compatible(
   return true;
 }
 
+OtbnTraceEntry::line_iter_t OtbnTraceEntry::loc_end(line_iter_t it,
+                                                    line_iter_t end) {
+  line_iter_t ret = it;
+  while (ret != end && ret->get_loc() == it->get_loc())
+    ++ret;
+  return ret;
+}
+
+size_t OtbnTraceEntry::num_locs() const {
+  size_t count = 0;
+  for (line_iter_t it = writes_.begin(); it != writes_.end();
+       it = loc_end(it, writes_.end()))
+    ++count;
+  return count;
+}
+
+void OtbnTraceEntry::add_write(const OtbnTraceBodyLine &line) {
+  writes_.insert(
+      std::upper_bound(writes_.begin(), writes_.end(), line, LocLess), line);
+}
+
 OtbnTraceEntry::trace_type_t OtbnTraceEntry::hdr_to_trace_type(
     const std::string &hdr) {
   if (hdr.empty()) {
@@ -294,14 +515,39 @@ OtbnTraceEntry::trace_type_t OtbnTraceEntry::hdr_to_trace_type(
   }
 }
 
+// Parse a "special" ISS line of the form "# @0xADDR: MNEMONIC", where ADDR is
+// 8 lower-case hex digits, into data. Returns false if line isn't of that form.
+static bool parse_special_line(const std::string &line,
+                               OtbnIssTraceEntry::IssData *data) {
+  const size_t addr_pos = 5, mnemonic_pos = addr_pos + 8 + 2;
+  if (line.size() < mnemonic_pos || line.compare(0, addr_pos, "# @0x") ||
+      line.compare(addr_pos + 8, 2, ": ") ||
+      line.find('\n') != std::string::npos)
+    return false;
+
+  uint32_t addr = 0;
+  for (size_t i = addr_pos; i < addr_pos + 8; ++i) {
+    int v = HexDigitVal(line[i]);
+    if (v < 0 || v > 15)
+      return false;
+    addr = (addr << 4) | v;
+  }
+
+  data->insn_addr = addr;
+  data->mnemonic.assign(line, mnemonic_pos, std::string::npos);
+  return true;
+}
+
 bool OtbnIssTraceEntry::from_iss_trace(const std::vector<std::string> &lines) {
   // Read FSM. state 0 = read header; state 1 = read mnemonic (for E
   // lines); state 2 = read writes
   int state = 0;
 
-  std::regex re("# @0x([0-9a-f]{8}): (.*)");
-  std::smatch match;
+  writes_.clear();
+  data_.insn_addr = 0;
+  data_.mnemonic.clear();
 
+  OtbnTraceBodyLine parsed_line;
   for (const std::string &line : lines) {
     switch (state) {
       case 0:
@@ -318,15 +564,11 @@ bool OtbnIssTraceEntry::from_iss_trace(const std::vector<std::string> &lines) {
         //
         // where ADDR is an 8-digit instruction address (in hex) and mnemonic
         // is the string mnemonic.
-        if (!std::regex_match(line, match, re)) {
+        if (!parse_special_line(line, &data_)) {
           std::cerr << "Bad 'special' line for ISS trace with header `" << hdr_
                     << "': `" << line << "'.\n";
           return false;
         }
-        assert(match.size() == 3);
-        data_.insn_addr =
-            (uint32_t)strtoul(match[1].str().c_str(), nullptr, 16);
-        data_.mnemonic = match[2].str();
         state = 2;
         break;
 
@@ -336,11 +578,10 @@ bool OtbnIssTraceEntry::from_iss_trace(const std::vector<std::string> &lines) {
         // external register changes, not tracked by the RTL core simulation)
         bool is_bang = (line.size() > 0 && line[0] == '!');
         if (!is_bang) {
-          OtbnTraceBodyLine parsed_line;
           if (!parsed_line.fill_from_string("ISS", line)) {
             return false;
           }
-          writes_[parsed_line.get_loc()].push_back(parsed_line);
+          add_write(parsed_line);
         }
         break;
       }
@@ -357,3 +598,9 @@ bool OtbnIssTraceEntry::from_iss_trace(const std::vector<std::string> &lines) {
 
   return true;
 }
+
+void OtbnIssTraceEntry::swap(OtbnIssTraceEntry &other) {
+  OtbnTraceEntry::swap(other);
+  std::swap(data_.insn_addr, other.data_.insn_addr);
+  data_.mnemonic.swap(other.data_.mnemonic);
+}
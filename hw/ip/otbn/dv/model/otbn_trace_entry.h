@@ -5,10 +5,11 @@
 #define OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_TRACE_ENTRY_H_
 
 #include <cstdint>
-#include <map>
 #include <string>
 #include <vector>
 
+#include "otbn_trace_record.h"
+
 // This models a body line in an OTBN trace entry (type '<', '>', 'R' or 'W').
 // Each of these lines is of the format
 //
@@ -17,6 +18,11 @@
 // and we parse them accordingly here. The point is that we want to merge
 // successive writes to the same location and thus need to unpack things enough
 // to see them.
+//
+// Hex values (like 0x0000002a or 0x00000000_..._0000002a) and flag group
+// values (like {C: 1, M: 0, L: 0, Z: 0}) are stored as packed digits, so
+// comparing two lines compares integers and filling in a line doesn't allocate.
+// Any other value is kept as text.
 class OtbnTraceBodyLine {
  public:
   // Parse a line into this object, based on the format above. On success,
@@ -24,19 +30,48 @@ class OtbnTraceBodyLine {
   // say where the line came from) and return false.
   bool fill_from_string(const std::string &src, const std::string &line);
 
+  // Fill this object from an access in an RTL trace record
+  void fill_from_item(const OtbnTraceItem &item);
+
+  // Two lines are equal if they have the same type and location and their
+  // values match digit by digit, where an unknown ('x') digit matches any
+  // digit.
   bool operator==(const OtbnTraceBodyLine &other) const;
 
   // Return the location that is being read or written
   const std::string &get_loc() const { return loc_; }
 
-  // Return the original string format for the entry
-  const std::string &get_string() const { return raw_; }
+  // Return the line in the string format
+  std::string get_string() const;
 
  private:
-  std::string raw_;
+  enum value_kind_t {
+    // "0x" then num_words_ groups of 8 hex digits, separated by '_'
+    Hex,
+    // A flag group, with the C, M, L and Z flags in digits 0 to 3
+    Flags,
+    // Anything else, in text_
+    Text,
+  };
+
+  // Set the value from its string format
+  void set_value(const std::string &value);
+  bool set_hex_value(const std::string &value);
+  bool set_flags_value(const std::string &value);
+
+  // Return the value in the string format
+  std::string value_string() const;
+
   char type_;
   std::string loc_;
-  std::string value_;
+
+  value_kind_t kind_;
+  int num_words_;
+  // The digits of a Hex or Flags value, 8 to a word, least significant first.
+  // An unknown digit has its nibble set in unknown_ and zero in digits_.
+  uint32_t digits_[OtbnTraceValue::kNumWords];
+  uint32_t unknown_[OtbnTraceValue::kNumWords];
+  std::string text_;
 };
 
 class OtbnTraceEntry {
@@ -52,9 +87,12 @@ class OtbnTraceEntry {
 
   virtual ~OtbnTraceEntry(){};
 
-  // Parse a trace entry from the RTL into this object. On an error, print a
-  // message to stderr and return false.
-  bool from_rtl_trace(const std::string &trace);
+  // Fill this object from a trace record from the RTL, replacing its contents
+  void from_rtl_record(const OtbnTraceRecord &record);
+
+  // Exchange contents with other. Entries keep their storage when they are
+  // refilled, so swapping lets a caller hold on to an entry without copying.
+  void swap(OtbnTraceEntry &other);
 
   bool compare_rtl_iss_entries(const OtbnTraceEntry &other,
                                bool no_sec_wipe_data_chk,
@@ -77,24 +115,46 @@ class OtbnTraceEntry {
   bool is_final() const;
 
  protected:
-  static bool check_entries_compatible(
-      trace_type_t type, const std::string &key,
-      const std::vector<OtbnTraceBodyLine> &rtl_lines,
-      const std::vector<OtbnTraceBodyLine> &iss_lines,
-      bool no_sec_wipe_data_chk, std::string *err_desc);
+  typedef std::vector<OtbnTraceBodyLine>::const_iterator line_iter_t;
+
+  static bool check_entries_compatible(trace_type_t type,
+                                       const std::string &key,
+                                       line_iter_t rtl_begin,
+                                       line_iter_t rtl_end,
+                                       line_iter_t iss_begin,
+                                       line_iter_t iss_end,
+                                       bool no_sec_wipe_data_chk,
+                                       std::string *err_desc);
 
   static trace_type_t hdr_to_trace_type(const std::string &hdr);
 
+  // Return the end of the run of writes (ending at or before end) to the
+  // location of *it
+  static line_iter_t loc_end(line_iter_t it, line_iter_t end);
+
+  // Count the distinct locations written
+  size_t num_locs() const;
+
+  // Add a write to writes_ after any other writes to its location
+  void add_write(const OtbnTraceBodyLine &line);
+
   trace_type_t trace_type_;
   std::string hdr_;
-  // The register writes for this trace entry, keyed by destination
-  std::map<std::string, std::vector<OtbnTraceBodyLine>> writes_;
+  // The register writes for this trace entry, sorted by destination. Writes to
+  // the same destination are in the order they happened.
+  std::vector<OtbnTraceBodyLine> writes_;
+  // Scratch space for take_writes
+  std::vector<OtbnTraceBodyLine> merged_writes_;
 };
 
 class OtbnIssTraceEntry : public OtbnTraceEntry {
  public:
+  // Fill this object from the lines of an ISS trace entry, replacing its
+  // contents
   bool from_iss_trace(const std::vector<std::string> &lines);
 
+  void swap(OtbnIssTraceEntry &other);
+
   // Fields that are populated from the "special" line for ISS entries
   struct IssData {
     uint32_t insn_addr;
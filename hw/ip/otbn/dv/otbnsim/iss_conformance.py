@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Check an alternative OTBN ISS against the Python model
+
+The RTL co-simulation drives the ISS through the command protocol described
+in stepped.py. An alternative ISS (such as a native implementation) can be
+used instead by setting the OTBN_ISS environment variable to its path. To
+check that it behaves like the Python model, record the commands from a run
+(of either ISS) by setting OTBN_ISS_LOG=<path> and OTBN_MODEL_KEEP_TMP=1 (so
+that the files named by load_d and load_i commands are kept). Then run:
+
+    iss_conformance.py <log> <iss> [<log> ...]
+
+This replays each log against both stepped.py and <iss>, comparing their
+responses command by command. It stops at the first difference and prints the
+command and both responses.
+
+'''
+
+import argparse
+import os
+import subprocess
+import sys
+from typing import BinaryIO, List, Optional, Tuple
+
+from stepped import REGS_RECORD_SIZE, STEP_RECORD
+
+_STEPPED = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                        'stepped.py')
+
+
+class ISS:
+    '''A running ISS, driven through its stdin and stdout'''
+    def __init__(self, argv: List[str]) -> None:
+        self.argv = argv
+        self.proc = subprocess.Popen(argv,
+                                     stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE)
+        assert self.proc.stdin is not None
+        assert self.proc.stdout is not None
+        self.stdin = self.proc.stdin  # type: BinaryIO
+        self.stdout = self.proc.stdout  # type: BinaryIO
+
+    def _read_exact(self, length: int) -> Optional[bytes]:
+        data = self.stdout.read(length)
+        return data if len(data) == length else None
+
+    def run(self, cmd: str) -> Optional[bytes]:
+        '''Send a command and return its response, or None on EOF
+
+        The response is the raw output of the command (including any binary
+        step or register record), up to but not including the terminating '.'
+        line.
+
+        '''
+        self.stdin.write(cmd.encode('utf-8') + b'\n')
+        self.stdin.flush()
+
+        resp = b''
+        if cmd.split()[0] == 'step_bin':
+            rec = self._read_exact(STEP_RECORD.size)
+            if rec is None:
+                return None
+            trace_len = STEP_RECORD.unpack(rec)[-1]
+            trace = self._read_exact(trace_len)
+            if trace is None:
+                return None
+            resp = rec + trace
+        elif cmd.split()[0] == 'print_regs_bin':
+            rec = self._read_exact(REGS_RECORD_SIZE)
+            if rec is None:
+                return None
+            resp = rec
+
+        while True:
+            line = self.stdout.readline()
+            if not line:
+                return None
+            if line == b'.\n':
+                return resp
+            resp += line
+
+    def close(self) -> None:
+        self.proc.kill()
+        self.proc.wait()
+
+
+def describe(cmd: str, resp: Optional[bytes]) -> str:
+    '''Describe the response to a command for an error message'''
+    if resp is None:
+        return '<EOF>'
+    if cmd.split()[0] == 'print_regs_bin':
+        return 'registers ' + resp.hex()
+    if cmd.split()[0] != 'step_bin':
+        return repr(resp.decode('utf-8', errors='replace'))
+
+    fields = STEP_RECORD.unpack(resp[:STEP_RECORD.size])
+    trace = resp[STEP_RECORD.size:].decode('utf-8', errors='replace')
+    return 'record {} trace {!r}'.format(fields, trace)
+
+
+def check_log(log_path: str, iss_argv: List[str]) -> Tuple[int, bool]:
+    '''Replay a command log against both ISSes
+
+    Returns the number of commands run and whether the responses all matched.
+
+    '''
+    with open(log_path) as log:
+        cmds = [line.strip() for line in log if line.strip()]
+
+    ref = ISS([sys.executable, '-u', _STEPPED])
+    dut = ISS(iss_argv)
+    try:
+        for idx, cmd in enumerate(cmds):
+            ref_resp = ref.run(cmd)
+            dut_resp = dut.run(cmd)
+            if ref_resp != dut_resp:
+                print('{}: Mismatch on command {} ({!r}):\n'
+                      '  Python model: {}\n'
+                      '  {}: {}'
+                      .format(log_path, idx, cmd, describe(cmd, ref_resp),
+                              iss_argv[0], describe(cmd, dut_resp)))
+                return (idx + 1, False)
+            if ref_resp is None:
+                # Both ISSes stopped at the same point. This isn't a difference
+                # in behaviour, but we can't run anything else.
+                print('{}: Both ISSes exited on command {} ({!r}).'
+                      .format(log_path, idx, cmd))
+                return (idx + 1, False)
+    finally:
+        ref.close()
+        dut.close()
+
+    return (len(cmds), True)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser()
+    parser.add_argument('log', help='Command log (from OTBN_ISS_LOG)')
+    parser.add_argument('iss', help='ISS executable to check')
+    parser.add_argument('logs', nargs='*', help='More command logs')
+    args = parser.parse_args()
+
+    all_ok = True
+    for log_path in [args.log] + args.logs:
+        num_cmds, ok = check_log(log_path, [args.iss])
+        if ok:
+            print('{}: {} commands matched.'.format(log_path, num_cmds))
+        all_ok &= ok
+
+    return 0 if all_ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
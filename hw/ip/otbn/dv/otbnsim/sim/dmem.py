@@ -3,7 +3,7 @@
 # SPDX-License-Identifier: Apache-2.0
 
 import struct
-from typing import Dict, List, Sequence, Optional
+from typing import Dict, List, Sequence, Optional, Set
 
 from shared.mem_layout import get_memory_layout
 
@@ -66,6 +66,11 @@ class Dmem:
         self.trace = []  # type: List[TraceDmemStore]
         self.pending = {}  # type: Dict[int, int]
 
+        # The indices of the 256-bit words that have been written (or
+        # invalidated) since DMEM was last loaded. The RTL co-simulation uses
+        # this to check only the parts of DMEM that might have changed.
+        self.dirty = set()  # type: Set[int]
+
     def _load_5byte_le_words(self, data: bytes) -> None:
         '''Replace the start of memory with data
 
@@ -129,6 +134,7 @@ class Dmem:
             self._load_5byte_le_words(data)
         else:
             self._load_4byte_le_words(data)
+        self.dirty = set()
 
     def dump_le_words(self) -> bytes:
         '''Return the contents of memory as bytes.
@@ -137,18 +143,22 @@ class Dmem:
         words are themselves packed little-endian into 256-bit words.
 
         '''
-        ret = b''
+        # Fill in a preallocated buffer, rather than appending to a bytes
+        # object (which copies everything so far for each word).
+        ret = bytearray(5 * len(self.data))
         for idx, u32 in enumerate(self.data):
             # If there's a pending store, apply it. This matches the RTL, where
             # we only observe the memory after that store has landed.
             u32 = self.pending.get(idx, u32)
 
-            if u32 is None:
-                ret += struct.pack('<BI', 0, 0)
-            else:
-                ret += struct.pack('<BI', 1, u32)
+            if u32 is not None:
+                struct.pack_into('<BI', ret, 5 * idx, 1, u32)
+
+        return bytes(ret)
 
-        return ret
+    def dirty_words(self) -> List[int]:
+        '''Return the sorted indices of 256-bit words changed since loading'''
+        return sorted(self.dirty)
 
     def is_valid_256b_addr(self, addr: int) -> bool:
         '''Return true if this is a valid address for a BN.LID/BN.SID'''
@@ -230,6 +240,7 @@ class Dmem:
 
     def _commit_trace_entry(self, item: TraceDmemStore) -> None:
         '''Apply a trace entry to self.pending'''
+        self.dirty.add(item.addr // 32)
         if item.is_wide:
             assert 0 <= item.value < (1 << 256)
             mask = (1 << 32) - 1
@@ -257,3 +268,4 @@ class Dmem:
 
     def empty_dmem(self) -> None:
         self.data = [None] * len(self.data)
+        self.dirty = set(range(len(self.data) // 8))
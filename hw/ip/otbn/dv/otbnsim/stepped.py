@@ -17,6 +17,12 @@ prefixed with "0x" if they are hexadecimal.
     step                    Run one instruction. Print trace information to
                             stdout.
 
+    step_bin <max> <trace>  Run up to <max> instructions, stopping after the
+                            first one that generates any trace output. Write a
+                            binary step record to stdout (see STEP_RECORD),
+                            followed by the trace for the last step if <trace>
+                            is 1.
+
     load_elf <path>         Load the ELF file at <path>, replacing current
                             contents of DMEM and IMEM.
 
@@ -39,6 +45,13 @@ prefixed with "0x" if they are hexadecimal.
 
     print_regs              Write the hex contents of all registers to stdout
 
+    print_regs_bin          Write the contents of all registers to stdout as a
+                            binary record (see REGS_RECORD_SIZE)
+
+    print_dmem_dirty        Write the byte offsets of the 256-bit DMEM words
+                            that have changed since the last load_d, one per
+                            line in hex.
+
     edn_rnd_step            Send 32b RND Data to the model.
 
     edn_rnd_cdc_done        Finish the RND data write process by signalling RTL
@@ -73,13 +86,41 @@ prefixed with "0x" if they are hexadecimal.
 '''
 
 import binascii
+import struct
 import sys
-from typing import List, Optional
+from typing import Dict, List, Optional, Tuple
 
 from sim.decode import decode_file
 from sim.load_elf import load_elf
+from sim.ext_regs import TraceExtRegChange
 from sim.sim import OTBNSim
 
+# The binary record written by step_bin. All fields are little-endian:
+#
+#   u16  Number of steps taken
+#   u8   Mask of which registers below were written (in the order they
+#        appear, starting at bit 0)
+#   u8   Reserved (zero)
+#   u32  STATUS
+#   u32  INSN_CNT
+#   u32  ERR_BITS
+#   u32  STOP_PC
+#   u8   RND_REQ
+#   u8   WIPE_START
+#   u16  Reserved (zero)
+#   u32  Length of the trace text that follows the record
+#
+# The trace text is the same as the output of the step command, and is
+# followed by the usual '.' line.
+STEP_RECORD = struct.Struct('<HBBIIIIBBHI')
+STEP_RECORD_REGS = ['STATUS', 'INSN_CNT', 'ERR_BITS', 'STOP_PC',
+                    'RND_REQ', 'WIPE_START']
+
+# The binary record written by print_regs_bin: the 32 GPRs as little-endian
+# u32s, followed by the 32 WDRs, each as 32 little-endian bytes. It is
+# followed by the usual '.' line.
+REGS_RECORD_SIZE = 32 * 4 + 32 * 32
+
 
 def read_word(arg_name: str, word_data: str, bits: int) -> int:
     '''Try to read an unsigned word of the specified bit length'''
@@ -132,10 +173,13 @@ def on_start_operation(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     return None
 
 
-def on_step(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
-    '''Step one instruction'''
-    check_arg_count('step', 0, args)
+def step_once(sim: OTBNSim) -> Tuple[List[str], Dict[str, int]]:
+    '''Step one instruction
+
+    Returns the lines of trace output and the new values of any external
+    registers that changed.
 
+    '''
     pc = sim.state.pc
     assert 0 == pc & 3
 
@@ -160,10 +204,13 @@ def on_step(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
         hdr = None
 
     rtl_changes = []
+    ext_regs = {}
     for c in changes:
         rt = c.rtl_trace()
         if rt is not None:
             rtl_changes.append(rt)
+        if isinstance(c, TraceExtRegChange):
+            ext_regs[c.name] = c.erc.new_value
 
     # This is a bit of a hack. Very occasionally, we'll see traced changes when
     # there's not actually an instruction in flight. For example, this happens
@@ -174,10 +221,58 @@ def on_step(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     if hdr is None and rtl_changes:
         hdr = 'STALL'
 
-    if hdr is not None:
-        print(hdr)
-        for rt in rtl_changes:
-            print(rt)
+    if hdr is None:
+        return ([], ext_regs)
+
+    return ([hdr] + rtl_changes, ext_regs)
+
+
+def on_step(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Step one instruction'''
+    check_arg_count('step', 0, args)
+
+    lines, _ = step_once(sim)
+    for line in lines:
+        print(line)
+
+    return None
+
+
+def on_step_bin(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Step until something happens, writing a binary step record'''
+    check_arg_count('step_bin', 2, args)
+
+    max_steps = read_word('max', args[0], 16)
+    want_trace = read_word('trace', args[1], 1) != 0
+    if max_steps == 0:
+        raise ValueError('step_bin needs to take at least one step.')
+
+    # Only the last step can have trace output, since we stop after it. Any
+    # external register changes always come with some trace output, so
+    # ext_regs also only gets updated on the last step.
+    steps = 0
+    lines = []  # type: List[str]
+    ext_regs = {}  # type: Dict[str, int]
+    while steps < max_steps and not lines:
+        lines, ext_regs = step_once(sim)
+        steps += 1
+
+    mask = 0
+    values = []
+    for idx, name in enumerate(STEP_RECORD_REGS):
+        value = ext_regs.get(name)
+        if value is not None:
+            mask |= 1 << idx
+        values.append(value or 0)
+
+    trace = ''.join(line + '\n' for line in lines) if want_trace else ''
+    trace_bytes = trace.encode('utf-8')
+    record = STEP_RECORD.pack(steps, mask, 0, *values, 0, len(trace_bytes))
+
+    # Make sure anything printed so far comes first
+    sys.stdout.flush()
+    sys.stdout.buffer.write(record + trace_bytes)
+    sys.stdout.buffer.flush()
 
     return None
 
@@ -279,6 +374,24 @@ def on_print_regs(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     return None
 
 
+def on_print_regs_bin(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Write registers to stdout as a binary record'''
+    check_arg_count('print_regs_bin', 0, args)
+
+    gprs = sim.state.gprs.peek_unsigned_values()
+    wdrs = sim.state.wdrs.peek_unsigned_values()
+    record = (struct.pack('<32I', *gprs) +
+              b''.join(value.to_bytes(32, 'little') for value in wdrs))
+    assert len(record) == REGS_RECORD_SIZE
+
+    # Make sure anything printed so far comes first
+    sys.stdout.flush()
+    sys.stdout.buffer.write(record)
+    sys.stdout.buffer.flush()
+
+    return None
+
+
 def on_print_call_stack(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     '''Print call stack to stdout. First element is the bottom of the stack'''
     check_arg_count('print_call_stack', 0, args)
@@ -290,6 +403,17 @@ def on_print_call_stack(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     return None
 
 
+def on_print_dmem_dirty(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Print the offsets of DMEM words that changed since the last load_d'''
+    check_arg_count('print_dmem_dirty', 0, args)
+
+    print('PRINT_DMEM_DIRTY')
+    for idx in sim.state.dmem.dirty_words():
+        print('0x{:08x}'.format(32 * idx))
+
+    return None
+
+
 def on_reset(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     check_arg_count('reset', 0, args)
     return OTBNSim()
@@ -407,6 +531,7 @@ _HANDLERS = {
     'start_operation': on_start_operation,
     'otp_key_cdc_done': on_otp_cdc_done,
     'step': on_step,
+    'step_bin': on_step_bin,
     'load_elf': on_load_elf,
     'add_loop_warp': on_add_loop_warp,
     'clear_loop_warps': on_clear_loop_warps,
@@ -414,7 +539,9 @@ _HANDLERS = {
     'load_i': on_load_i,
     'dump_d': on_dump_d,
     'print_regs': on_print_regs,
+    'print_regs_bin': on_print_regs_bin,
     'print_call_stack': on_print_call_stack,
+    'print_dmem_dirty': on_print_dmem_dirty,
     'reset': on_reset,
     'edn_rnd_step': on_edn_rnd_step,
     'edn_urnd_step': on_edn_urnd_step,
@@ -5,8 +5,7 @@
 #include "log_trace_listener.h"
 
 #include <cassert>
-#include <iomanip>
-#include <ios>
+#include <cstdio>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -18,14 +17,65 @@ LogTraceListener::LogTraceListener(const std::string &log_filename)
     oss << "Could not open log file: " << log_filename;
     throw std::runtime_error(oss.str());
   }
+
+  pending_.reserve(kChunkSize);
+  writer_ = std::thread(&LogTraceListener::WriteChunks, this);
+}
+
+LogTraceListener::~LogTraceListener() {
+  HandOffPending();
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stopping_ = true;
+  }
+  queue_cond_.notify_all();
+  writer_.join();
+}
+
+void LogTraceListener::HandOffPending() {
+  if (pending_.empty()) {
+    return;
+  }
+
+  std::string chunk;
+  chunk.reserve(kChunkSize);
+  chunk.swap(pending_);
+
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  queue_cond_.wait(lock, [this] { return queue_.size() < kMaxQueuedChunks; });
+  queue_.push_back(std::move(chunk));
+  lock.unlock();
+  queue_cond_.notify_all();
 }
 
-void LogTraceListener::AcceptTraceString(const std::string &trace,
+void LogTraceListener::WriteChunks() {
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  for (;;) {
+    queue_cond_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // Stopping, and everything has been written
+      break;
+    }
+
+    std::string chunk = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    queue_cond_.notify_all();
+
+    trace_log.write(chunk.data(), chunk.size());
+
+    lock.lock();
+  }
+
+  trace_log.flush();
+}
+
+void LogTraceListener::AcceptTraceRecord(const OtbnTraceRecord &record,
                                          unsigned int cycle_count) {
   assert(trace_log.is_open());
 
   // Split the trace up into a vector of strings, one per line
-  auto trace_lines = SplitTraceLines(trace);
+  auto trace_lines = SplitTraceLines(record.ToString());
 
   // Write out the lines from the trace
   bool first_line = true;
@@ -39,29 +89,37 @@ void LogTraceListener::AcceptTraceString(const std::string &trace,
         // Output the beginning of the first line adding a cycle count. A
         // special '!' line, only giving the cycle count, is output if the first
         // line isn't an 'E' or 'S' line.
-        std::ios old_state(nullptr);
-        old_state.copyfmt(trace_log);
-        trace_log << (is_e_or_s_line ? line[0] : '!') << " " << std::setw(9)
-                  << std::setfill('0') << cycle_count;
-        trace_log.copyfmt(old_state);
+        char prefix[16];
+        snprintf(prefix, sizeof(prefix), "%c %09u",
+                 is_e_or_s_line ? line[0] : '!', cycle_count);
+        pending_ += prefix;
 
         if (is_e_or_s_line) {
           // If this is an expected 'E' or 'S' line write the rest of it out
-          trace_log << line.substr(1) << "\n";
+          pending_.append(line, 1, std::string::npos);
+          pending_ += '\n';
         } else {
           // Otherwise leave the '!' line on it's own and dump this line out
           // indented.
-          trace_log << "\n    " << line << "\n";
+          pending_ += "\n    ";
+          pending_ += line;
+          pending_ += '\n';
         }
       } else {
-        trace_log << "ERR: Bad line at " << cycle_count
-                  << " line should be more than 1 character: " << line << "\n";
+        pending_ += "ERR: Bad line at " + std::to_string(cycle_count) +
+                    " line should be more than 1 character: " + line + "\n";
       }
 
       first_line = false;
     } else {
       // All lines other than the first are indented.
-      trace_log << "    " << line << "\n";
+      pending_ += "    ";
+      pending_ += line;
+      pending_ += '\n';
     }
   }
+
+  if (pending_.size() >= kChunkSize) {
+    HandOffPending();
+  }
 }
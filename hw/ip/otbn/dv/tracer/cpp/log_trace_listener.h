@@ -5,8 +5,12 @@
 #ifndef OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_LOG_TRACE_LISTENER_H_
 #define OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_LOG_TRACE_LISTENER_H_
 
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "otbn_trace_listener.h"
 
@@ -22,18 +26,47 @@
  * If an 'E' or 'S' line isn't seen as the first line it prints a special '!'
  * line that gives the cycle count and dumps the rest of the trace indented by
  * four spaces.
+ *
+ * Formatted output is collected in large chunks which are written to the file
+ * by a background thread, so that the simulation doesn't wait for the file
+ * system. Everything is written out by the time the listener is destroyed.
  */
 class LogTraceListener : public OtbnTraceListener {
  private:
+  // Hand text to the writer thread once this much has been formatted
+  static const size_t kChunkSize = 1 << 20;
+  // Stall the simulation if the writer thread falls this many chunks behind,
+  // to bound memory use
+  static const size_t kMaxQueuedChunks = 16;
+
   std::ofstream trace_log;
 
+  // Text formatted since the last chunk was handed to the writer thread
+  std::string pending_;
+
+  // Chunks waiting to be written and the writer's stop request, protected by
+  // queue_mutex_
+  std::deque<std::string> queue_;
+  bool stopping_ = false;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cond_;
+
+  std::thread writer_;
+
+  // Queue the contents of pending_ for writing
+  void HandOffPending();
+
+  // Body of the writer thread
+  void WriteChunks();
+
  public:
   /**
    * Constructor that takes a log filename to write trace output to. It throws
    * std::runtime_error if the file cannot be opened.
    */
   LogTraceListener(const std::string &log_filename);
-  void AcceptTraceString(const std::string &trace,
+  ~LogTraceListener();
+  void AcceptTraceRecord(const OtbnTraceRecord &record,
                          unsigned int cycle_count) override;
 };
 
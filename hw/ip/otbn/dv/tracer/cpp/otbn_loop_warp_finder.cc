@@ -0,0 +1,245 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "otbn_loop_warp_finder.h"
+
+#include <cassert>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+// ISPR indices (from otbn_pkg::ispr_e) whose reads make an iteration depend on
+// state that isn't in the trace.
+static const uint8_t kIsprRnd = 1;
+static const uint8_t kIsprUrnd = 4;
+
+// True if a and b are the same write
+static bool SameWrite(const OtbnTraceItem &a, const OtbnTraceItem &b) {
+  if (a.kind != b.kind || a.index != b.index || a.addr != b.addr)
+    return false;
+
+  for (int i = 0; i < OtbnTraceValue::kNumWords; ++i) {
+    if (a.data.words[i].aval != b.data.words[i].aval ||
+        a.data.words[i].bval != b.data.words[i].bval)
+      return false;
+    if (a.kind == OtbnTraceItem::Mem &&
+        (a.mask.words[i].aval != b.mask.words[i].aval ||
+         a.mask.words[i].bval != b.mask.words[i].bval))
+      return false;
+  }
+  return true;
+}
+
+static bool SameWrites(const std::vector<OtbnTraceItem> &a,
+                       const std::vector<OtbnTraceItem> &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (!SameWrite(a[i], b[i]))
+      return false;
+  }
+  return true;
+}
+
+OtbnLoopWarpFinder::OtbnLoopWarpFinder(
+    const std::map<uint32_t, std::string> *symbols)
+    : symbols_(symbols) {
+  assert(symbols);
+}
+
+void OtbnLoopWarpFinder::AcceptTraceRecord(const OtbnTraceRecord &record,
+                                           unsigned int cycle_count) {
+  if (record.insn == OtbnTraceRecord::NoInsn) {
+    // A secure wipe means the operation has finished (possibly with an
+    // error), so forget any loops that didn't complete.
+    if (record.wipe != OtbnTraceRecord::NoWipe)
+      stack_.clear();
+    return;
+  }
+
+  ++total_cycles_;
+
+  // Add this cycle's writes to the current iteration of every loop that is
+  // running.
+  for (ActiveLoop &loop : stack_) {
+    ++loop.cycles;
+    ++loop.iter_cycles;
+    for (size_t i = 0; i < record.size(); ++i) {
+      const OtbnTraceItem &item = record.item(i);
+      bool uses_x1 = item.kind == OtbnTraceItem::BaseReg && item.index == 1;
+      bool reads_rnd = item.kind == OtbnTraceItem::Ispr && !item.is_write &&
+                       (item.index == kIsprRnd || item.index == kIsprUrnd);
+      if (uses_x1 || reads_rnd)
+        loop.clean = false;
+      if (item.is_write)
+        loop.writes.push_back(item);
+    }
+  }
+
+  if (record.insn != OtbnTraceRecord::InsnExecute)
+    return;
+
+  // Is this a LOOP or LOOPI instruction? These have the BignumBaseMisc
+  // opcode with funct3 of 0 or 1.
+  uint32_t insn = record.insn_data;
+  if ((insn & 0x7f) == 0x7b && ((insn >> 12) & 6) == 0) {
+    uint32_t iterations = 0;
+    if (insn & (1 << 12)) {
+      // LOOPI: the iteration count is split between bits [19:15] and [11:7].
+      iterations = (((insn >> 15) & 0x1f) << 5) | ((insn >> 7) & 0x1f);
+    } else {
+      // LOOP: the iteration count is in the GPR that it reads.
+      for (size_t i = 0; i < record.size(); ++i) {
+        const OtbnTraceItem &item = record.item(i);
+        if (item.kind == OtbnTraceItem::BaseReg && !item.is_write) {
+          iterations = item.data.words[0].aval;
+          break;
+        }
+      }
+    }
+
+    uint32_t bodysize = insn >> 20;
+
+    ActiveLoop loop;
+    loop.end_addr = record.insn_addr + 4 * bodysize;
+    loop.iterations = iterations;
+    loop.iter = 0;
+    loop.cycles = 0;
+    loop.iter_cycles = 0;
+    loop.clean = true;
+    loop.prev_clean = false;
+    loop.fixed_at = -1;
+    loop.broken = false;
+    loop.cycles_after_fixed = 0;
+    stack_.push_back(loop);
+    return;
+  }
+
+  if (!stack_.empty() && record.insn_addr == stack_.back().end_addr)
+    EndIteration();
+}
+
+void OtbnLoopWarpFinder::EndIteration() {
+  assert(!stack_.empty());
+  ActiveLoop &loop = stack_.back();
+
+  bool is_fixed_point = loop.clean && loop.prev_clean &&
+                        SameWrites(loop.writes, loop.prev_writes);
+
+  if (loop.fixed_at >= 0) {
+    // Every iteration after a fixed point should be a fixed point too.
+    if (!is_fixed_point)
+      loop.broken = true;
+    loop.cycles_after_fixed += loop.iter_cycles;
+  } else if (is_fixed_point) {
+    loop.fixed_at = loop.iter;
+  }
+
+  loop.prev_writes.swap(loop.writes);
+  loop.writes.clear();
+  loop.prev_clean = loop.clean;
+  loop.clean = true;
+  loop.iter_cycles = 0;
+  ++loop.iter;
+
+  if (loop.iter < loop.iterations)
+    return;
+
+  // This was the last iteration
+  LoopStats &stats = loops_[loop.end_addr];
+  int64_t fixed_at = loop.broken ? -1 : loop.fixed_at;
+  if (stats.runs == 0) {
+    stats.first_iterations = loop.iterations;
+    stats.first_fixed_at = fixed_at;
+  } else if (stats.first_iterations != loop.iterations ||
+             stats.first_fixed_at != fixed_at) {
+    stats.consistent = false;
+  }
+  ++stats.runs;
+  stats.iterations += loop.iterations;
+  stats.cycles += loop.cycles;
+  if (fixed_at >= 0)
+    stats.cycles_after_fixed += loop.cycles_after_fixed;
+
+  stack_.pop_back();
+}
+
+bool OtbnLoopWarpFinder::ShouldWarp(const LoopStats &stats) {
+  return stats.consistent && stats.first_fixed_at >= 0 &&
+         stats.first_fixed_at + 1 < stats.first_iterations;
+}
+
+std::string OtbnLoopWarpFinder::SymbolicAddr(uint32_t addr) const {
+  auto it = symbols_->upper_bound(addr);
+  if (it == symbols_->begin())
+    return "";
+
+  --it;
+  std::ostringstream oss;
+  oss << it->second << "+0x" << std::hex << (addr - it->first);
+  return oss.str();
+}
+
+void OtbnLoopWarpFinder::WriteReport(std::ostream &os) const {
+  std::ios old_state(nullptr);
+  old_state.copyfmt(os);
+
+  os << "OTBN loop warp report\n"
+     << "=====================\n\n"
+     << "Loops by end address:\n"
+     << "     Address    Runs   Iterations       Cycles  Result\n";
+
+  uint64_t saved_cycles = 0;
+  for (const auto &pr : loops_) {
+    const LoopStats &stats = pr.second;
+    os << "  0x" << std::hex << std::setw(8) << std::setfill('0') << pr.first
+       << std::dec << std::setfill(' ') << std::setw(8) << stats.runs
+       << std::setw(13) << stats.iterations << std::setw(13) << stats.cycles
+       << "  ";
+
+    if (ShouldWarp(stats)) {
+      os << "warp iteration " << stats.first_fixed_at << " to "
+         << stats.first_iterations - 1 << " (saves "
+         << stats.cycles_after_fixed << " cycles)";
+      saved_cycles += stats.cycles_after_fixed;
+    } else if (!stats.consistent) {
+      os << "not warped: runs differ in iterations or fixed point";
+    } else if (stats.first_fixed_at < 0) {
+      os << "not warped: no fixed point";
+    } else {
+      os << "not warped: fixed point is in the last iteration";
+    }
+
+    std::string sym = SymbolicAddr(pr.first);
+    if (!sym.empty())
+      os << "  [" << sym << "]";
+    os << "\n";
+  }
+
+  os << "\nTraced instruction cycles: " << total_cycles_ << "\n"
+     << "Cycles saved by the proposed warps: " << saved_cycles;
+  if (total_cycles_) {
+    os << " (" << std::fixed << std::setprecision(1)
+       << 100.0 * saved_cycles / total_cycles_ << "%)";
+  }
+  os << "\n";
+
+  os.copyfmt(old_state);
+}
+
+void OtbnLoopWarpFinder::WriteWarps(std::ostream &os) const {
+  std::ios old_state(nullptr);
+  old_state.copyfmt(os);
+
+  for (const auto &pr : loops_) {
+    const LoopStats &stats = pr.second;
+    if (!ShouldWarp(stats))
+      continue;
+    os << "0x" << std::hex << std::setw(8) << std::setfill('0') << pr.first
+       << std::dec << " " << stats.first_fixed_at << " "
+       << stats.first_iterations - 1 << "\n";
+  }
+
+  os.copyfmt(old_state);
+}
@@ -0,0 +1,113 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_LOOP_WARP_FINDER_H_
+#define OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_LOOP_WARP_FINDER_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "otbn_trace_listener.h"
+
+/**
+ * An OtbnTraceListener that looks for hardware loops which could be warped
+ * without changing the result of a program.
+ *
+ * It follows LOOP and LOOPI instructions in the trace and records the writes
+ * (to registers, flags, ISPRs and DMEM) in each iteration of each loop. If two
+ * consecutive iterations make exactly the same writes, the second didn't
+ * change anything, so the loop has reached a fixed point and all the
+ * iterations after it will do the same. Skipping them with a loop warp leaves
+ * the final state unchanged (apart from the instruction count). This only
+ * holds if the iterations didn't use anything outside the traced state, so an
+ * iteration that reads RND or URND or that uses the call stack (x1) never
+ * counts.
+ *
+ * A loop is only proposed for warping if every time it ran it had the same
+ * iteration count and reached a fixed point at the same iteration, because a
+ * loop warp applies to every run of the loop.
+ */
+class OtbnLoopWarpFinder : public OtbnTraceListener {
+ public:
+  /**
+   * Constructor. symbols maps the start addresses of functions in IMEM to
+   * their names, and is used to make the report easier to read. It may be
+   * filled in after the listener is created.
+   */
+  OtbnLoopWarpFinder(const std::map<uint32_t, std::string> *symbols);
+
+  void AcceptTraceRecord(const OtbnTraceRecord &record,
+                         unsigned int cycle_count) override;
+
+  /**
+   * Write a report of the loops seen, whether each could be warped and how
+   * many cycles each proposed warp would save.
+   */
+  void WriteReport(std::ostream &os) const;
+
+  /**
+   * Write the proposed warps, one per line as "ADDR FROM TO" (in the format
+   * read by OtbnMemUtil::LoadLoopWarps).
+   */
+  void WriteWarps(std::ostream &os) const;
+
+ private:
+  // A loop that is currently running
+  struct ActiveLoop {
+    uint32_t end_addr;
+    uint32_t iterations;
+    uint32_t iter;
+    uint64_t cycles, iter_cycles;
+
+    // The writes in the current and previous iterations, and whether each
+    // iteration only depended on traced state.
+    std::vector<OtbnTraceItem> writes, prev_writes;
+    bool clean, prev_clean;
+
+    // The first iteration that was a fixed point, or -1 if there wasn't one.
+    // If a later iteration turns out not to be a fixed point after all (which
+    // would mean that the loop depends on something we can't see), broken is
+    // set.
+    int64_t fixed_at;
+    bool broken;
+
+    // Cycles spent in iterations after the fixed point
+    uint64_t cycles_after_fixed;
+  };
+
+  // Everything seen of the loop ending at some address
+  struct LoopStats {
+    uint64_t runs = 0;
+    uint64_t iterations = 0;
+    uint64_t cycles = 0;
+
+    // The iteration count and fixed point of the first run, and whether all
+    // runs matched them.
+    uint32_t first_iterations = 0;
+    int64_t first_fixed_at = -1;
+    bool consistent = true;
+
+    // Cycles that would have been skipped by a warp at the fixed point
+    uint64_t cycles_after_fixed = 0;
+  };
+
+  // Handle the end of an iteration of the innermost loop
+  void EndIteration();
+
+  // True if the loop should be warped
+  static bool ShouldWarp(const LoopStats &stats);
+
+  // A name for addr, using the function symbols
+  std::string SymbolicAddr(uint32_t addr) const;
+
+  const std::map<uint32_t, std::string> *symbols_;
+  std::vector<ActiveLoop> stack_;
+  std::map<uint32_t, LoopStats> loops_;
+  uint64_t total_cycles_ = 0;
+};
+
+#endif  // OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_LOOP_WARP_FINDER_H_
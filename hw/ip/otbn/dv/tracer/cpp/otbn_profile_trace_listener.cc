@@ -0,0 +1,249 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "otbn_profile_trace_listener.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+
+// The number of rows to show in each table of the report
+static const size_t kReportRows = 20;
+
+// Names for the major opcodes (bits [6:0] of an instruction). These match
+// insn_opcode_e in otbn_pkg.sv.
+static const char *OpcodeClass(uint32_t insn) {
+  switch (insn & 0x7f) {
+    case 0x03:
+      return "base load";
+    case 0x0f:
+      return "base mem misc";
+    case 0x13:
+      return "base op-imm";
+    case 0x23:
+      return "base store";
+    case 0x33:
+      return "base op";
+    case 0x37:
+      return "base lui";
+    case 0x63:
+      return "base branch";
+    case 0x67:
+      return "base jalr";
+    case 0x6f:
+      return "base jal";
+    case 0x73:
+      return "base system";
+    case 0x0b:
+      return "bignum misc";
+    case 0x2b:
+      return "bignum arith";
+    case 0x3b:
+      return "bignum mulqacc";
+    case 0x7b:
+      return "bignum base misc";
+    default:
+      return "unknown";
+  }
+}
+
+// Format part as a percentage of total
+static std::string Percent(uint64_t part, uint64_t total) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1)
+      << (total ? 100.0 * part / total : 0.0) << "%";
+  return oss.str();
+}
+
+OtbnProfileTraceListener::OtbnProfileTraceListener(
+    const std::map<uint32_t, std::string> *symbols)
+    : symbols_(symbols) {
+  assert(symbols);
+}
+
+void OtbnProfileTraceListener::AcceptTraceRecord(const OtbnTraceRecord &record,
+                                                 unsigned int cycle_count) {
+  if (record.insn == OtbnTraceRecord::NoInsn) {
+    if (record.wipe != OtbnTraceRecord::NoWipe) {
+      // A secure wipe clears the call stack, ready for the next operation.
+      ++wipe_cycles_;
+      call_stack_.clear();
+    } else {
+      ++other_cycles_;
+    }
+    return;
+  }
+
+  uint32_t pc = record.insn_addr;
+  PcStats &stats = pc_stats_[pc];
+  ++stats.cycles;
+
+  stack_key_.assign(call_stack_.begin(), call_stack_.end());
+  stack_key_.push_back(pc);
+  ++stack_cycles_[stack_key_];
+
+  for (size_t i = 0; i < record.size(); ++i) {
+    const OtbnTraceItem &item = record.item(i);
+    if (item.kind != OtbnTraceItem::BaseReg || item.index != 1)
+      continue;
+    if (item.is_write) {
+      insn_writes_x1_ = true;
+      x1_write_data_ = item.data.words[0].aval;
+    } else {
+      insn_reads_x1_ = true;
+    }
+  }
+
+  if (record.insn == OtbnTraceRecord::InsnStall) {
+    ++stats.stalls;
+    return;
+  }
+
+  ++stats.count;
+  ++insn_mix_[record.insn == OtbnTraceRecord::InsnFetchErr
+                  ? "fetch error"
+                  : OpcodeClass(record.insn_data)];
+
+  // The instruction has completed, so apply its effect on the call stack. If
+  // it both reads and writes x1, the read happens first.
+  if (insn_reads_x1_ && !call_stack_.empty())
+    call_stack_.pop_back();
+  if (insn_writes_x1_)
+    call_stack_.push_back(x1_write_data_);
+  insn_reads_x1_ = false;
+  insn_writes_x1_ = false;
+}
+
+void OtbnProfileTraceListener::RecordLoopWarp(uint32_t addr) {
+  ++loop_warps_[addr];
+}
+
+std::string OtbnProfileTraceListener::FunctionName(uint32_t addr) const {
+  auto it = symbols_->upper_bound(addr);
+  if (it == symbols_->begin()) {
+    std::ostringstream oss;
+    oss << "0x" << std::hex << std::setw(8) << std::setfill('0') << addr;
+    return oss.str();
+  }
+  return std::prev(it)->second;
+}
+
+std::string OtbnProfileTraceListener::SymbolicAddr(uint32_t addr) const {
+  auto it = symbols_->upper_bound(addr);
+  if (it == symbols_->begin())
+    return "";
+
+  --it;
+  std::ostringstream oss;
+  oss << it->second << "+0x" << std::hex << (addr - it->first);
+  return oss.str();
+}
+
+void OtbnProfileTraceListener::WriteReport(std::ostream &os) const {
+  std::ios old_state(nullptr);
+  old_state.copyfmt(os);
+
+  uint64_t insn_cycles = 0, stall_cycles = 0, insn_count = 0;
+  std::map<std::string, PcStats> fn_stats;
+  for (const auto &pr : pc_stats_) {
+    insn_cycles += pr.second.cycles;
+    stall_cycles += pr.second.stalls;
+    insn_count += pr.second.count;
+
+    PcStats &fn = fn_stats[FunctionName(pr.first)];
+    fn.cycles += pr.second.cycles;
+    fn.stalls += pr.second.stalls;
+    fn.count += pr.second.count;
+  }
+  uint64_t total_cycles = insn_cycles + wipe_cycles_ + other_cycles_;
+
+  os << "OTBN profile\n"
+     << "============\n\n"
+     << "Traced cycles:       " << total_cycles << "\n"
+     << "  Instructions:      " << insn_cycles << " (of which " << stall_cycles
+     << " stalled)\n"
+     << "  Secure wipe:       " << wipe_cycles_ << "\n"
+     << "  Other:             " << other_cycles_ << "\n"
+     << "Instructions run:    " << insn_count << "\n\n";
+
+  // Sort functions and PCs by the number of cycles they took, most first
+  std::vector<std::pair<std::string, PcStats>> fns(fn_stats.begin(),
+                                                   fn_stats.end());
+  std::stable_sort(fns.begin(), fns.end(),
+                   [](const std::pair<std::string, PcStats> &a,
+                      const std::pair<std::string, PcStats> &b) {
+                     return a.second.cycles > b.second.cycles;
+                   });
+  std::vector<std::pair<uint32_t, PcStats>> pcs(pc_stats_.begin(),
+                                                pc_stats_.end());
+  std::stable_sort(pcs.begin(), pcs.end(),
+                   [](const std::pair<uint32_t, PcStats> &a,
+                      const std::pair<uint32_t, PcStats> &b) {
+                     return a.second.cycles > b.second.cycles;
+                   });
+
+  os << "Functions by cycles:\n"
+     << "      Cycles       %     Stalls      Insns  Function\n";
+  for (size_t i = 0; i < std::min(fns.size(), kReportRows); ++i) {
+    const PcStats &s = fns[i].second;
+    os << std::setw(12) << s.cycles << std::setw(8)
+       << Percent(s.cycles, insn_cycles) << std::setw(11) << s.stalls
+       << std::setw(11) << s.count << "  " << fns[i].first << "\n";
+  }
+
+  os << "\nInstructions by cycles:\n"
+     << "          PC      Cycles     Stalls      Count  Location\n";
+  for (size_t i = 0; i < std::min(pcs.size(), kReportRows); ++i) {
+    const PcStats &s = pcs[i].second;
+    os << "  0x" << std::hex << std::setw(8) << std::setfill('0')
+       << pcs[i].first << std::dec << std::setfill(' ') << std::setw(12)
+       << s.cycles << std::setw(11) << s.stalls << std::setw(11) << s.count
+       << "  " << SymbolicAddr(pcs[i].first) << "\n";
+  }
+
+  os << "\nInstruction mix:\n";
+  for (const auto &pr : insn_mix_) {
+    os << "  " << std::left << std::setw(18) << pr.first << std::right
+       << std::setw(12) << pr.second << std::setw(8)
+       << Percent(pr.second, insn_count) << "\n";
+  }
+
+  if (!loop_warps_.empty()) {
+    os << "\nLoop warps:\n";
+    for (const auto &pr : loop_warps_) {
+      os << "  0x" << std::hex << std::setw(8) << std::setfill('0') << pr.first
+         << std::dec << std::setfill(' ') << std::setw(8) << pr.second
+         << " hits  " << SymbolicAddr(pr.first) << "\n";
+    }
+  }
+
+  os.copyfmt(old_state);
+}
+
+void OtbnProfileTraceListener::WriteFoldedStacks(std::ostream &os) const {
+  // Several call stacks and PCs may give the same list of function names, so
+  // merge them before writing anything out.
+  std::map<std::string, uint64_t> folded;
+  for (const auto &pr : stack_cycles_) {
+    const std::vector<uint32_t> &key = pr.first;
+    assert(!key.empty());
+
+    // Each return address on the stack points just after the call, in the
+    // calling function. The last entry is the current PC.
+    std::string frames;
+    for (size_t i = 0; i + 1 < key.size(); ++i) {
+      frames += FunctionName(key[i] - 4);
+      frames += ';';
+    }
+    frames += FunctionName(key.back());
+    folded[frames] += pr.second;
+  }
+
+  for (const auto &pr : folded) {
+    os << pr.first << " " << pr.second << "\n";
+  }
+}
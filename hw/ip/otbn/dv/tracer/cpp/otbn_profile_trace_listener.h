@@ -0,0 +1,96 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_PROFILE_TRACE_LISTENER_H_
+#define OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_PROFILE_TRACE_LISTENER_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "otbn_trace_listener.h"
+
+/**
+ * An OtbnTraceListener that counts where OTBN spends its cycles.
+ *
+ * Every cycle with an 'S' or 'E' record is charged to the instruction at its
+ * PC, and to the function containing that PC (found from a table of function
+ * symbols). The listener also counts the instruction mix by major opcode and
+ * any loop warps reported with RecordLoopWarp().
+ *
+ * The listener follows the call stack in the same way as the hardware does:
+ * writing x1 pushes to the stack and reading x1 pops from it. This gives a
+ * stack of return addresses (as get_call_stack would show), from which it
+ * builds a flamegraph-compatible folded stack for each cycle.
+ */
+class OtbnProfileTraceListener : public OtbnTraceListener {
+ public:
+  /**
+   * Constructor. symbols maps the start addresses of functions in IMEM to
+   * their names. It is read when the report is written, so it may be filled in
+   * (by loading an ELF file) after the listener is created.
+   */
+  OtbnProfileTraceListener(const std::map<uint32_t, std::string> *symbols);
+
+  void AcceptTraceRecord(const OtbnTraceRecord &record,
+                         unsigned int cycle_count) override;
+
+  /**
+   * Note that a loop warp was applied to the loop whose body ends at addr.
+   */
+  void RecordLoopWarp(uint32_t addr);
+
+  /**
+   * Write a human-readable report of the hottest functions and instructions,
+   * the instruction mix and any loop warps.
+   */
+  void WriteReport(std::ostream &os) const;
+
+  /**
+   * Write the cycle counts as folded stacks, one per line, in the format
+   * expected by flamegraph.pl: frames separated by ';', then a space and a
+   * cycle count.
+   */
+  void WriteFoldedStacks(std::ostream &os) const;
+
+ private:
+  struct PcStats {
+    uint64_t cycles = 0;
+    uint64_t stalls = 0;
+    uint64_t count = 0;
+  };
+
+  // The name of the function containing addr, or a hex address if there isn't
+  // a symbol below it.
+  std::string FunctionName(uint32_t addr) const;
+
+  // The name of the function containing addr, followed by the offset into it
+  std::string SymbolicAddr(uint32_t addr) const;
+
+  const std::map<uint32_t, std::string> *symbols_;
+
+  std::map<uint32_t, PcStats> pc_stats_;
+  std::map<std::string, uint64_t> insn_mix_;
+  std::map<uint32_t, uint64_t> loop_warps_;
+  uint64_t wipe_cycles_ = 0;
+  uint64_t other_cycles_ = 0;
+
+  // The call stack (of return addresses) as it was at the start of the current
+  // instruction, and whether the current instruction has read or written x1 so
+  // far. An instruction can take several cycles, so we only update the stack
+  // when it completes.
+  std::vector<uint32_t> call_stack_;
+  bool insn_reads_x1_ = false;
+  bool insn_writes_x1_ = false;
+  uint32_t x1_write_data_ = 0;
+
+  // Cycles spent at each PC with each call stack. The key is the stack
+  // followed by the PC. stack_key_ is a buffer for building keys.
+  std::map<std::vector<uint32_t>, uint64_t> stack_cycles_;
+  std::vector<uint32_t> stack_key_;
+};
+
+#endif  // OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_PROFILE_TRACE_LISTENER_H_
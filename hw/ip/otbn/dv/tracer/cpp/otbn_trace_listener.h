@@ -9,10 +9,12 @@
 #include <string>
 #include <vector>
 
+#include "otbn_trace_record.h"
+
 /**
- * Base class for anything that wants to examine trace output from OTBN. The
- * simulation that hosts the tracer is responsible for setting up listeners and
- * routing the DPI `accept_otbn_trace_string` calls to them.
+ * Base class for anything that wants to examine trace output from OTBN.
+ * Listeners register with OtbnTraceSource, which passes them a record for each
+ * cycle in which the tracer saw something.
  */
 class OtbnTraceListener {
  public:
@@ -38,10 +40,13 @@ class OtbnTraceListener {
   /**
    * Called to process an OTBN trace output, called a maximum of once per cycle
    *
-   * @param trace Trace output from OTBN
+   * The record is only valid until the call returns. A listener that wants the
+   * trace in the string format should call record.ToString().
+   *
+   * @param record Trace output from OTBN
    * @param cycle_count The cycle count associated with the trace output
    */
-  virtual void AcceptTraceString(const std::string &trace,
+  virtual void AcceptTraceRecord(const OtbnTraceRecord &record,
                                  unsigned int cycle_count) = 0;
   virtual ~OtbnTraceListener() {}
 };
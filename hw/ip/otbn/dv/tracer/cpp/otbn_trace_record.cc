@@ -0,0 +1,214 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "otbn_trace_record.h"
+
+#include <cassert>
+#include <cstdio>
+
+// Format a nibble of a 4-state value as a hex digit, matching what %x does in
+// SystemVerilog: 'x' or 'z' if all the bits are X or Z, 'X' or 'Z' if only
+// some are.
+static char HexDigit(uint32_t aval, uint32_t bval) {
+  if (!bval)
+    return "0123456789abcdef"[aval];
+
+  uint32_t x_bits = aval & bval;
+  uint32_t z_bits = ~aval & bval & 0xf;
+  if (bval == 0xf) {
+    if (x_bits == 0xf)
+      return 'x';
+    if (z_bits == 0xf)
+      return 'z';
+    return 'X';
+  }
+  return x_bits ? 'X' : 'Z';
+}
+
+// Append a 32-bit 4-state word as 8 hex digits
+static void AppendHexWord(const OtbnTraceWord &word, std::string *out) {
+  for (int i = 28; i >= 0; i -= 4) {
+    out->push_back(HexDigit((word.aval >> i) & 0xf, (word.bval >> i) & 0xf));
+  }
+}
+
+// Format a 32-bit 4-state word like 0x%08x
+static std::string Hex32Str(const OtbnTraceWord &word) {
+  std::string ret("0x");
+  AppendHexWord(word, &ret);
+  return ret;
+}
+
+// Format a WLEN-bit value as hex, split into 32-bit chunks separated by '_'
+// (like otbn_wlen_data_str used to in otbn_tracer.sv)
+static std::string WlenStr(const OtbnTraceValue &value) {
+  std::string ret("0x");
+  ret.reserve(2 + 9 * OtbnTraceValue::kNumWords);
+  for (int i = OtbnTraceValue::kNumWords - 1; i >= 0; --i) {
+    AppendHexWord(value.words[i], &ret);
+    if (i)
+      ret.push_back('_');
+  }
+  return ret;
+}
+
+// Format bit i of a 4-state word like a 1-bit %d in SystemVerilog
+static char BitChar(const OtbnTraceWord &word, int i) {
+  bool a = (word.aval >> i) & 1, b = (word.bval >> i) & 1;
+  return b ? (a ? 'x' : 'z') : (a ? '1' : '0');
+}
+
+// True if all bits of value are known and equal to the bits of the 32-bit
+// chunk mask (of WLEN / 32) selected by chunk.
+static bool IsChunkMask(const OtbnTraceValue &value, int chunk) {
+  for (int i = 0; i < OtbnTraceValue::kNumWords; ++i) {
+    uint32_t expected = (chunk < 0 || chunk == i) ? 0xffffffff : 0;
+    if (value.words[i].bval || value.words[i].aval != expected)
+      return false;
+  }
+  return true;
+}
+
+char OtbnTraceItem::LineType() const {
+  if (kind == Mem)
+    return is_write ? 'W' : 'R';
+  return is_write ? '>' : '<';
+}
+
+std::string OtbnTraceItem::Location() const {
+  static const char *const ispr_names[] = {"MOD", "RND", "ACC", "FLAGS",
+                                           "URND"};
+  char buf[16];
+  switch (kind) {
+    case BaseReg:
+      snprintf(buf, sizeof(buf), "x%02d", index);
+      return buf;
+    case WideReg:
+      snprintf(buf, sizeof(buf), "w%02d", index);
+      return buf;
+    case Ispr:
+      return index < sizeof(ispr_names) / sizeof(ispr_names[0])
+                 ? ispr_names[index]
+                 : "UNKNOWN_ISPR";
+    case Flags:
+      snprintf(buf, sizeof(buf), "FLAGS%d", index);
+      return buf;
+    case Mem: {
+      // For a 32-bit write, the location is the address of the word written
+      uint32_t wr_addr = addr;
+      for (int i = 0; is_write && i < OtbnTraceValue::kNumWords; ++i) {
+        if (!IsChunkMask(mask, -1) && IsChunkMask(mask, i))
+          wr_addr = addr + 4 * i;
+      }
+      snprintf(buf, sizeof(buf), "[0x%08x]", wr_addr);
+      return buf;
+    }
+  }
+  assert(0);
+  return "";
+}
+
+std::string OtbnTraceItem::Value() const {
+  switch (kind) {
+    case BaseReg:
+      return Hex32Str(data.words[0]);
+    case WideReg:
+    case Ispr:
+      return WlenStr(data);
+    case Flags: {
+      const OtbnTraceWord &f = data.words[0];
+      std::string ret("{C: _, M: _, L: _, Z: _}");
+      ret[4] = BitChar(f, 0);
+      ret[10] = BitChar(f, 1);
+      ret[16] = BitChar(f, 2);
+      ret[22] = BitChar(f, 3);
+      return ret;
+    }
+    case Mem:
+      if (!is_write || IsChunkMask(mask, -1))
+        return WlenStr(data);
+
+      // A write of a single 32-bit chunk only shows that chunk. Any other
+      // mask is unexpected, so flag it with ERR.
+      for (int i = 0; i < OtbnTraceValue::kNumWords; ++i) {
+        if (IsChunkMask(mask, i))
+          return Hex32Str(data.words[i]);
+      }
+      return "Mask ERR Mask: " + WlenStr(mask) + " Data: " + WlenStr(data);
+  }
+  assert(0);
+  return "";
+}
+
+OtbnTraceItem &OtbnTraceRecord::AddItem() {
+  if (num_items_ == items_.size())
+    items_.emplace_back();
+  return items_[num_items_++];
+}
+
+void OtbnTraceRecord::Clear() {
+  insn = NoInsn;
+  wipe = NoWipe;
+  num_items_ = 0;
+}
+
+std::string OtbnTraceRecord::HeaderString() const {
+  std::string ret;
+  HeaderString(&ret);
+  return ret;
+}
+
+void OtbnTraceRecord::HeaderString(std::string *out) const {
+  char buf[40];
+  switch (insn) {
+    case InsnFetchErr:
+      snprintf(buf, sizeof(buf), "E PC: 0x%08x, insn: ??", insn_addr);
+      out->assign(buf);
+      return;
+    case InsnStall:
+    case InsnExecute:
+      snprintf(buf, sizeof(buf), "%c PC: 0x%08x, insn: 0x%08x",
+               insn == InsnStall ? 'S' : 'E', insn_addr, insn_data);
+      out->assign(buf);
+      return;
+    case NoInsn:
+      break;
+  }
+
+  switch (wipe) {
+    case WipeInProgress:
+      out->assign("U ");
+      return;
+    case WipeComplete:
+      out->assign("V ");
+      return;
+    case NoWipe:
+      break;
+  }
+
+  out->assign("Z ");
+}
+
+std::string OtbnTraceRecord::ToString() const {
+  if (empty())
+    return "";
+
+  std::string ret = HeaderString() + "\n";
+
+  // If there's an instruction header and a wipe header, the wipe header comes
+  // second.
+  if (insn != NoInsn && wipe != NoWipe)
+    ret += (wipe == WipeComplete) ? "V \n" : "U \n";
+
+  for (size_t i = 0; i < num_items_; ++i) {
+    const OtbnTraceItem &item = items_[i];
+    ret += item.LineType();
+    ret += ' ';
+    ret += item.Location();
+    ret += ": ";
+    ret += item.Value();
+    ret += '\n';
+  }
+  return ret;
+}
@@ -0,0 +1,143 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_TRACE_RECORD_H_
+#define OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_TRACE_RECORD_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * One 32-bit chunk of a 4-state value, with the same layout as svdpi's
+ * svLogicVecVal. A bit is 0 or 1 if its bval bit is zero. Otherwise it is Z if
+ * its aval bit is zero and X if its aval bit is one.
+ */
+struct OtbnTraceWord {
+  uint32_t aval;
+  uint32_t bval;
+};
+
+/**
+ * A 4-state value of up to WLEN (256) bits, least significant chunk first.
+ */
+struct OtbnTraceValue {
+  static const int kNumWords = 8;
+  OtbnTraceWord words[kNumWords];
+};
+
+/**
+ * A single register or memory access in a trace record, corresponding to one
+ * body line in the string format (see `hw/ip/otbn/dv/tracer/README.md`).
+ */
+struct OtbnTraceItem {
+  // The values of this enum must match the Trace*Item parameters in
+  // otbn_tracer.sv.
+  enum kind_t : uint8_t {
+    BaseReg = 0,  // index is the register; data is 32 bits
+    WideReg = 1,  // index is the register
+    Ispr = 2,     // index is the ISPR (an otbn_pkg::ispr_e)
+    Flags = 3,    // index is the flag group; data is an otbn_pkg::flags_t
+    Mem = 4,      // addr is the byte address; mask is set for writes
+  };
+
+  kind_t kind;
+  bool is_write;
+  uint8_t index;
+  uint32_t addr;
+  OtbnTraceValue data;
+  OtbnTraceValue mask;
+
+  /** The line type for this access in the string format ('<', '>', 'R' or
+   * 'W') */
+  char LineType() const;
+
+  /** The location being accessed, formatted as in the string format */
+  std::string Location() const;
+
+  /** The value being read or written, formatted as in the string format */
+  std::string Value() const;
+};
+
+/**
+ * Everything that the tracer saw in one cycle.
+ *
+ * The tracer fills in a record through DPI calls, rather than building a
+ * string in SystemVerilog, so that listeners can look at the fields they need
+ * without parsing anything. ToString() gives the string format for listeners
+ * that want it.
+ */
+class OtbnTraceRecord {
+ public:
+  // The values of these enums must match the Trace* parameters in
+  // otbn_tracer.sv.
+  enum insn_t : uint8_t {
+    NoInsn = 0,
+    InsnStall = 1,
+    InsnExecute = 2,
+    InsnFetchErr = 3,  // An execute line where the instruction bits are bad
+  };
+
+  enum wipe_t : uint8_t {
+    NoWipe = 0,
+    WipeInProgress = 1,
+    WipeComplete = 2,
+  };
+
+  insn_t insn = NoInsn;
+  uint32_t insn_addr = 0;
+  uint32_t insn_data = 0;
+  wipe_t wipe = NoWipe;
+
+  /**
+   * Add an item to the end of the record, returning a reference to it. The
+   * item's contents are undefined, so the caller must fill in all its fields.
+   */
+  OtbnTraceItem &AddItem();
+
+  /**
+   * Make the record empty. The storage for its items is kept, so that filling
+   * in a record each cycle doesn't allocate.
+   */
+  void Clear();
+
+  /** True if the tracer saw nothing, so there's nothing to report */
+  bool empty() const { return insn == NoInsn && wipe == NoWipe && !num_items_; }
+
+  /**
+   * The number of accesses in the record. They are in the order of their lines
+   * in ToString().
+   */
+  size_t size() const { return num_items_; }
+
+  /** The ith access in the record */
+  const OtbnTraceItem &item(size_t i) const { return items_[i]; }
+
+  /**
+   * The first header line in the string format (which gives the type of the
+   * record), without a trailing newline.
+   */
+  std::string HeaderString() const;
+
+  /**
+   * As HeaderString(), but writing the line to *out. This reuses the storage
+   * that *out already has, so a caller that keeps a string around doesn't
+   * allocate for every record.
+   */
+  void HeaderString(std::string *out) const;
+
+  /**
+   * Format the whole record in the string format described in
+   * `hw/ip/otbn/dv/tracer/README.md`, with a newline at the end of each line.
+   */
+  std::string ToString() const;
+
+ private:
+  // A pool of items, of which the first num_items_ are in use. Items beyond
+  // that are left allocated for reuse by later records.
+  std::vector<OtbnTraceItem> items_;
+  size_t num_items_ = 0;
+};
+
+#endif  // OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_TRACE_RECORD_H_
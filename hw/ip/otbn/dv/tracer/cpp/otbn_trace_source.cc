@@ -6,7 +6,9 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <memory>
+#include <svdpi.h>
 
 static std::unique_ptr<OtbnTraceSource> trace_source;
 
@@ -27,15 +29,49 @@ void OtbnTraceSource::RemoveListener(const OtbnTraceListener *listener) {
   listeners_.erase(it);
 }
 
-void OtbnTraceSource::Broadcast(const std::string &trace,
+void OtbnTraceSource::Broadcast(const OtbnTraceRecord &record,
                                 unsigned cycle_count) {
   for (OtbnTraceListener *listener : listeners_) {
-    listener->AcceptTraceString(trace, cycle_count);
+    listener->AcceptTraceRecord(record, cycle_count);
   }
 }
 
-extern "C" void accept_otbn_trace_string(const char *trace,
-                                         unsigned int cycle_count) {
-  assert(trace != nullptr);
-  OtbnTraceSource::get().Broadcast(trace, cycle_count);
+// Copy a WLEN-bit 4-state value from SystemVerilog
+static void get_trace_value(const svLogicVecVal *src, OtbnTraceValue *dst) {
+  static_assert(sizeof(OtbnTraceWord) == sizeof(svLogicVecVal),
+                "OtbnTraceWord should have the layout of svLogicVecVal");
+  memcpy(dst->words, src, sizeof(dst->words));
+}
+
+extern "C" void otbn_trace_item(unsigned char kind, svBit is_write,
+                                unsigned int index_or_addr,
+                                const svLogicVecVal *data /* [255:0] */,
+                                const svLogicVecVal *mask /* [255:0] */) {
+  assert(kind <= OtbnTraceItem::Mem);
+  OtbnTraceItem &item = OtbnTraceSource::get().pending().AddItem();
+  item.kind = static_cast<OtbnTraceItem::kind_t>(kind);
+  item.is_write = is_write;
+  // index_or_addr is the address for a memory access and the index otherwise
+  item.index = index_or_addr;
+  item.addr = index_or_addr;
+  get_trace_value(data, &item.data);
+  get_trace_value(mask, &item.mask);
+}
+
+extern "C" void otbn_trace_end(unsigned char insn, unsigned int insn_addr,
+                               unsigned int insn_data, unsigned char wipe,
+                               unsigned int cycle_count) {
+  assert(insn <= OtbnTraceRecord::InsnFetchErr);
+  assert(wipe <= OtbnTraceRecord::WipeComplete);
+
+  OtbnTraceSource &source = OtbnTraceSource::get();
+  OtbnTraceRecord &record = source.pending();
+  record.insn = static_cast<OtbnTraceRecord::insn_t>(insn);
+  record.insn_addr = insn_addr;
+  record.insn_data = insn_data;
+  record.wipe = static_cast<OtbnTraceRecord::wipe_t>(wipe);
+
+  if (!record.empty())
+    source.Broadcast(record, cycle_count);
+  record.Clear();
 }
@@ -13,9 +13,11 @@
 // This is a singleton class, which will be constructed on the first call to
 // get() or the first trace data that comes back from the simulation.
 //
-// The object is in charge of taking trace data from the simulation (which is
-// sent by calling the accept_otbn_trace_string DPI function) and passing it
-// out to registered listeners.
+// The object is in charge of taking trace data from the simulation and passing
+// it out to registered listeners. The simulation describes each cycle with
+// calls to the otbn_trace_item DPI function (one per register or memory
+// access), followed by a call to otbn_trace_end. These fill in a record that
+// is reused from cycle to cycle.
 
 class OtbnTraceSource {
  public:
@@ -28,11 +30,15 @@ class OtbnTraceSource {
   // Remove a listener from the source
   void RemoveListener(const OtbnTraceListener *listener);
 
-  // Send a trace string to all listeners
-  void Broadcast(const std::string &trace, unsigned cycle_count);
+  // Send a trace record to all listeners
+  void Broadcast(const OtbnTraceRecord &record, unsigned cycle_count);
+
+  // The record being filled in for the current cycle
+  OtbnTraceRecord &pending() { return pending_; }
 
  private:
   std::vector<OtbnTraceListener *> listeners_;
+  OtbnTraceRecord pending_;
 };
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_TRACE_SOURCE_H_
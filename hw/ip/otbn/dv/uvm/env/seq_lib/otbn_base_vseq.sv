@@ -261,21 +261,24 @@ class otbn_base_vseq extends cip_base_vseq #(
 
       // What offset and size (in 32 bit words) is this segment?
       bit [31:0] seg_off, seg_size;
+      bit [31:0] seg_data[];
       if (!OtbnMemUtilGetSegInfo(cfg.mem_util, for_imem, seg_idx, seg_off, seg_size)) begin
         `uvm_fatal(`gfn, $sformatf("Failed to get segment info for segment %0d.", seg_idx))
       end
 
+      // Fetch the whole segment with a single DPI call.
+      seg_data = new[seg_size];
+      if (!OtbnMemUtilGetSegWords(cfg.mem_util, for_imem, seg_idx, seg_data)) begin
+        `uvm_fatal(`gfn, $sformatf("Failed to get data for segment %0d.", seg_idx))
+      end
+
       // Add each word.
-      for (bit [31:0] i = 0; i < seg_size; i++) begin
-        bit [31:0] word_off, data;
+      foreach (seg_data[i]) begin
+        bit [31:0] word_off;
         otbn_loaded_word entry;
 
         word_off = seg_off + i;
 
-        if (!OtbnMemUtilGetSegData(cfg.mem_util, for_imem, word_off, data)) begin
-          `uvm_fatal(`gfn, $sformatf("Failed to get segment data at word offset %0d.", word_off))
-        end
-
         // Since we know that the segment data lies in IMEM or DMEM and that this fits in the
         // address space, we know that the top two bits of the word address are zero.
         `DV_CHECK_FATAL(word_off[31:30] == 2'b00)
@@ -286,7 +289,7 @@ class otbn_base_vseq extends cip_base_vseq #(
 
         entry.for_imem = for_imem;
         entry.offset   = word_off[21:0];
-        entry.data     = data;
+        entry.data     = seg_data[i];
         entries.push_back(entry);
       end
     end
@@ -818,51 +821,31 @@ class otbn_base_vseq extends cip_base_vseq #(
 
   // Task to build a random image in imem
   virtual task imem_init();
-    bit   [ 31:0] rnd_data;
-    logic [127:0] key;
-    logic [ 63:0] nonce;
-    bit   [ 38:0] integ_data;
-
-    key   = cfg.get_imem_key();
-    nonce = cfg.get_imem_nonce();
+    bit [31:0] rnd_data[];
 
     // Randomize the memory contents.
     //
     // We can't just use the mem_bkdr_util randomize_mem function because that doesn't obey the
     // scrambling key. This wouldn't be a problem (the memory is supposed to be random!), except
-    // that we also need to pick ECC values that match.
-    for (int i = 0; i <= ImemSizeByte / 4; i++) begin
-      `DV_CHECK_STD_RANDOMIZE_FATAL(rnd_data)
-      integ_data = prim_secded_pkg::prim_secded_inv_39_32_enc(rnd_data);
-      cfg.write_imem_word(i, integ_data, key, nonce);
+    // that we also need to pick ECC values that match. OtbnMemUtil computes the integrity bits and
+    // scrambles the words with the memory's current key and nonce, so we can write the whole
+    // memory with a single DPI call.
+    rnd_data = new[ImemSizeByte / 4];
+    foreach (rnd_data[i]) rnd_data[i] = $urandom();
+    if (!OtbnMemUtilWriteWords(cfg.mem_util, 1'b1, 0, rnd_data)) begin
+      `uvm_fatal(`gfn, "Failed to write random data to IMEM")
     end
   endtask
 
   // Task to build a random image in dmem
   virtual task dmem_init();
-    bit   [ 31:0] rnd_data;
-    logic [127:0] key;
-    logic [ 63:0] nonce;
-    bit   [ 38:0] integ_data;
-    bit   [ 38:0] final_data_arr[8];
-    bit   [311:0] final_data;
-
-    key   = cfg.get_dmem_key();
-    nonce = cfg.get_dmem_nonce();
+    bit [31:0] rnd_data[];
 
-    // Randomize the memory contents.
-    //
-    // We can't just use the mem_bkdr_util randomize_mem function because that doesn't obey the
-    // scrambling key. This wouldn't be a problem (the memory is supposed to be random!), except
-    // that we also need to pick ECC values that match.
-    for (int i = 0; i <= DmemSizeByte / 4; i++) begin
-      for (int j = 0; j < 8; j++) begin
-        `DV_CHECK_STD_RANDOMIZE_FATAL(rnd_data)
-        integ_data = prim_secded_pkg::prim_secded_inv_39_32_enc(rnd_data);
-        final_data_arr[j] = integ_data;
-      end
-      final_data = {>>{final_data_arr}};
-      cfg.write_dmem_word(i, final_data, key, nonce);
+    // Randomize the memory contents, as for IMEM in imem_init.
+    rnd_data = new[DmemSizeByte / 4];
+    foreach (rnd_data[i]) rnd_data[i] = $urandom();
+    if (!OtbnMemUtilWriteWords(cfg.mem_util, 1'b0, 0, rnd_data)) begin
+      `uvm_fatal(`gfn, "Failed to write random data to DMEM")
     end
   endtask
 
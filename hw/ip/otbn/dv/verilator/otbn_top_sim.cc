@@ -2,18 +2,25 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <getopt.h>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <svdpi.h>
+#include <vector>
 
 #include "Votbn_top_sim__Syms.h"
 #include "log_trace_listener.h"
+#include "otbn_loop_warp_finder.h"
 #include "otbn_memutil.h"
 #include "otbn_model.h"
+#include "otbn_profile_trace_listener.h"
 #include "otbn_trace_checker.h"
 #include "otbn_trace_source.h"
 #include "sv_scoped.h"
@@ -30,14 +37,35 @@ extern svBit otbn_err_get();
 extern int otbn_core_get_stop_pc();
 }
 
+static OtbnMemUtil otbn_memutil("TOP.otbn_top_sim");
+
+// The profiling listener, if one has been set up by OtbnTraceUtil. This is
+// used by OtbnTopApplyLoopWarp to count loop warps.
+static OtbnProfileTraceListener *profile_trace_listener;
+
 /**
  * SimCtrlExtension that adds a '--otbn-trace-file' command line option. If set
  * it sets up a LogTraceListener that will dump out the trace to the given log
- * file
+ * file.
+ *
+ * It also adds a '--otbn-profile-file' option. If set it sets up an
+ * OtbnProfileTraceListener and writes its report to the given file at the end
+ * of simulation, with folded stacks for flamegraph.pl in the same file name
+ * with '.folded' appended.
+ *
+ * Finally, it adds options for loop warps. '--otbn-loop-warp-report' sets up
+ * an OtbnLoopWarpFinder and writes its report to the given file, with the
+ * proposed warps in the same file name with '.warps' appended.
+ * '--otbn-loop-warps' reads extra loop warps (such as those proposals) from a
+ * file.
  */
 class OtbnTraceUtil : public SimCtrlExtension {
  private:
   std::unique_ptr<LogTraceListener> log_trace_listener_;
+  std::unique_ptr<OtbnProfileTraceListener> profile_trace_listener_;
+  std::string profile_filename_;
+  std::unique_ptr<OtbnLoopWarpFinder> loop_warp_finder_;
+  std::string loop_warp_report_filename_;
 
   bool SetupTraceLog(const std::string &log_filename) {
     try {
@@ -53,16 +81,96 @@ class OtbnTraceUtil : public SimCtrlExtension {
     return false;
   }
 
+  bool SetupProfile(const std::string &profile_filename) {
+    // Check we'll be able to write the report before running anything
+    if (!std::ofstream(profile_filename)) {
+      std::cerr << "ERROR: Could not open profile file: " << profile_filename
+                << std::endl;
+      return false;
+    }
+
+    profile_filename_ = profile_filename;
+    profile_trace_listener_.reset(
+        new OtbnProfileTraceListener(&otbn_memutil.GetImemSymbols()));
+    OtbnTraceSource::get().AddListener(profile_trace_listener_.get());
+    profile_trace_listener = profile_trace_listener_.get();
+    return true;
+  }
+
+  bool SetupLoopWarpFinder(const std::string &report_filename) {
+    if (!std::ofstream(report_filename)) {
+      std::cerr << "ERROR: Could not open loop warp report file: "
+                << report_filename << std::endl;
+      return false;
+    }
+
+    loop_warp_report_filename_ = report_filename;
+    loop_warp_finder_.reset(
+        new OtbnLoopWarpFinder(&otbn_memutil.GetImemSymbols()));
+    OtbnTraceSource::get().AddListener(loop_warp_finder_.get());
+    return true;
+  }
+
+  bool LoadLoopWarps(const std::string &filename) {
+    try {
+      otbn_memutil.LoadLoopWarps(filename);
+      return true;
+    } catch (const std::exception &err) {
+      std::cerr << "ERROR: Failed to load loop warps: " << err.what()
+                << std::endl;
+      return false;
+    }
+  }
+
+  void WriteLoopWarpReport() {
+    std::ofstream report(loop_warp_report_filename_);
+    loop_warp_finder_->WriteReport(report);
+
+    std::ofstream warps(loop_warp_report_filename_ + ".warps");
+    loop_warp_finder_->WriteWarps(warps);
+
+    if (!report || !warps) {
+      std::cerr << "ERROR: Failed to write loop warp report to "
+                << loop_warp_report_filename_ << std::endl;
+    }
+  }
+
+  void WriteProfile() {
+    std::ofstream report(profile_filename_);
+    profile_trace_listener_->WriteReport(report);
+
+    std::ofstream folded(profile_filename_ + ".folded");
+    profile_trace_listener_->WriteFoldedStacks(folded);
+
+    if (!report || !folded) {
+      std::cerr << "ERROR: Failed to write profile to " << profile_filename_
+                << std::endl;
+    }
+  }
+
   void PrintHelp() {
     std::cout << "Trace log utilities:\n\n"
                  "--otbn-trace-file=FILE\n"
-                 "  Write OTBN trace log to FILE\n\n";
+                 "  Write OTBN trace log to FILE\n\n"
+                 "--otbn-profile-file=FILE\n"
+                 "  Write a profile of OTBN cycles to FILE, and folded stacks\n"
+                 "  (for flamegraph.pl) to FILE.folded\n\n"
+                 "--otbn-loop-warp-report=FILE\n"
+                 "  Look for loops that can be warped without changing the\n"
+                 "  result. Write a report to FILE and the proposed warps to\n"
+                 "  FILE.warps\n\n"
+                 "--otbn-loop-warps=FILE\n"
+                 "  Apply the loop warps in FILE (one 'ADDR FROM TO' per\n"
+                 "  line) as well as any from the ELF file\n\n";
   }
 
  public:
   virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app) {
     const struct option long_options[] = {
         {"otbn-trace-file", required_argument, nullptr, 'l'},
+        {"otbn-profile-file", required_argument, nullptr, 'p'},
+        {"otbn-loop-warp-report", required_argument, nullptr, 'r'},
+        {"otbn-loop-warps", required_argument, nullptr, 'w'},
         {"help", no_argument, nullptr, 'h'},
         {nullptr, no_argument, nullptr, 0}};
 
@@ -80,7 +188,21 @@ class OtbnTraceUtil : public SimCtrlExtension {
         case 1:
           break;
         case 'l':
-          return SetupTraceLog(optarg);
+          if (!SetupTraceLog(optarg))
+            return false;
+          break;
+        case 'p':
+          if (!SetupProfile(optarg))
+            return false;
+          break;
+        case 'r':
+          if (!SetupLoopWarpFinder(optarg))
+            return false;
+          break;
+        case 'w':
+          if (!LoadLoopWarps(optarg))
+            return false;
+          break;
         case 'h':
           PrintHelp();
           break;
@@ -93,15 +215,327 @@ class OtbnTraceUtil : public SimCtrlExtension {
   ~OtbnTraceUtil() {
     if (log_trace_listener_)
       OtbnTraceSource::get().RemoveListener(log_trace_listener_.get());
+    if (profile_trace_listener_) {
+      WriteProfile();
+      OtbnTraceSource::get().RemoveListener(profile_trace_listener_.get());
+      profile_trace_listener = nullptr;
+    }
+    if (loop_warp_finder_) {
+      WriteLoopWarpReport();
+      OtbnTraceSource::get().RemoveListener(loop_warp_finder_.get());
+    }
+  }
+};
+
+/**
+ * SimCtrlExtension that adds a benchmark mode, for tracking the performance of
+ * OTBN programs over time.
+ *
+ * The '--otbn-benchmark' option names a file that lists OTBN programs, one per
+ * line, as an ELF file optionally followed by a DMEM image (in any format that
+ * OtbnMemUtil can load) to load over the ELF's DMEM contents. Each program is
+ * run the number of times given by '--otbn-benchmark-reps' (default 1) as a
+ * batch of tests (see VerilatorSimCtrl::AddBatchImage), so the Verilated model
+ * and the ISS are reset between runs rather than restarted.
+ *
+ * At the end of the simulation, a report is written to the file given by
+ * '--otbn-benchmark-report' (or to stdout if there isn't one). It has one entry
+ * for each program, giving the OTBN cycles per run, instructions retired (which
+ * match INSN_CNT), the fraction of cycles that were stalls, and the host time
+ * and simulation speed. The report is CSV if the file name ends in '.csv' and
+ * JSON otherwise.
+ */
+class OtbnBenchmark : public SimCtrlExtension, public OtbnTraceListener {
+ private:
+  struct App {
+    std::string elf;
+    std::string dmem;
+
+    unsigned runs = 0;
+    unsigned failures = 0;
+    uint64_t min_cycles = 0, max_cycles = 0;
+    uint64_t insns = 0;
+    uint64_t cycles = 0, stalls = 0, sim_cycles = 0;
+    double host_s = 0;
+  };
+
+  std::vector<App> apps_;
+  unsigned reps_ = 1;
+  std::string report_path_;
+
+  // The app whose run is in progress (an index into apps_, advanced by each
+  // PrepareBatchTest), and what has happened in that run so far.
+  size_t next_run_ = 0;
+  App *current_ = nullptr;
+  uint64_t run_cycles_ = 0, run_stalls_ = 0, run_insns_ = 0;
+  unsigned long run_start_time_ = 0;
+  std::chrono::steady_clock::time_point run_start_;
+
+  bool ReadBenchmarkFile(const std::string &path) {
+    std::ifstream is(path);
+    if (!is) {
+      std::cerr << "ERROR: Could not open benchmark file: " << path
+                << std::endl;
+      return false;
+    }
+
+    // Blank lines and lines starting with # are ignored.
+    std::string line;
+    unsigned line_no = 0;
+    while (std::getline(is, line)) {
+      ++line_no;
+      std::istringstream iss(line);
+      App app;
+      if (!(iss >> app.elf) || app.elf[0] == '#')
+        continue;
+      iss >> app.dmem;
+
+      std::string extra;
+      if (iss >> extra) {
+        std::cerr << "ERROR: " << path << ":" << line_no
+                  << ": expected an ELF file and an optional DMEM image."
+                  << std::endl;
+        return false;
+      }
+      apps_.push_back(app);
+    }
+
+    if (apps_.empty()) {
+      std::cerr << "ERROR: Benchmark file " << path << " lists no programs."
+                << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  void PrintHelp() {
+    std::cout << "OTBN benchmark mode:\n\n"
+                 "--otbn-benchmark=FILE\n"
+                 "  Run each program listed in FILE (one 'ELF [DMEM_IMAGE]'\n"
+                 "  per line) and report on its performance\n\n"
+                 "--otbn-benchmark-reps=N\n"
+                 "  Run each program N times (default 1)\n\n"
+                 "--otbn-benchmark-report=FILE\n"
+                 "  Write the benchmark report to FILE (as CSV if FILE ends\n"
+                 "  in .csv and as JSON otherwise) instead of stdout\n\n";
+  }
+
+  static bool IsCsvPath(const std::string &path) {
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+  }
+
+  // Format a string as a JSON string literal. Paths are the only strings we
+  // write, so we only need to worry about quotes and backslashes.
+  static std::string JsonString(const std::string &str) {
+    std::string ret("\"");
+    for (char c : str) {
+      if (c == '"' || c == '\\')
+        ret += '\\';
+      ret += c;
+    }
+    return ret + "\"";
+  }
+
+  void WriteReport(std::ostream &os, bool csv) const {
+    os << std::fixed << std::setprecision(4);
+    if (csv) {
+      os << "elf,dmem,runs,failures,min_cycles,max_cycles,insn_cnt,"
+            "stall_ratio,host_s_per_run,sim_cycles_per_s\n";
+    } else {
+      os << "[\n";
+    }
+
+    for (size_t i = 0; i < apps_.size(); ++i) {
+      const App &app = apps_[i];
+      double stall_ratio = app.cycles ? (double)app.stalls / app.cycles : 0;
+      double host_s_per_run = app.runs ? app.host_s / app.runs : 0;
+      double sim_speed = app.host_s > 0 ? app.sim_cycles / app.host_s : 0;
+
+      if (csv) {
+        os << app.elf << "," << app.dmem << "," << app.runs << ","
+           << app.failures << "," << app.min_cycles << "," << app.max_cycles
+           << "," << app.insns << "," << stall_ratio << "," << host_s_per_run
+           << "," << sim_speed << "\n";
+        continue;
+      }
+
+      os << "  {\n"
+         << "    \"elf\": " << JsonString(app.elf) << ",\n"
+         << "    \"dmem\": " << JsonString(app.dmem) << ",\n"
+         << "    \"runs\": " << app.runs << ",\n"
+         << "    \"failures\": " << app.failures << ",\n"
+         << "    \"min_cycles\": " << app.min_cycles << ",\n"
+         << "    \"max_cycles\": " << app.max_cycles << ",\n"
+         << "    \"insn_cnt\": " << app.insns << ",\n"
+         << "    \"stall_ratio\": " << stall_ratio << ",\n"
+         << "    \"host_s_per_run\": " << host_s_per_run << ",\n"
+         << "    \"sim_cycles_per_s\": " << sim_speed << "\n"
+         << "  }" << (i + 1 < apps_.size() ? "," : "") << "\n";
+    }
+
+    if (!csv)
+      os << "]\n";
+  }
+
+ public:
+  ~OtbnBenchmark() {
+    if (!apps_.empty())
+      OtbnTraceSource::get().RemoveListener(this);
+  }
+
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+    const struct option long_options[] = {
+        {"otbn-benchmark", required_argument, nullptr, 'b'},
+        {"otbn-benchmark-reps", required_argument, nullptr, 'n'},
+        {"otbn-benchmark-report", required_argument, nullptr, 'o'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, no_argument, nullptr, 0}};
+
+    // Reset the command parsing index in-case other utils have already parsed
+    // some arguments
+    optind = 1;
+    while (1) {
+      int c = getopt_long(argc, argv, "-h", long_options, nullptr);
+      if (c == -1) {
+        break;
+      }
+
+      switch (c) {
+        case 0:
+        case 1:
+          break;
+        case 'b':
+          if (!ReadBenchmarkFile(optarg))
+            return false;
+          break;
+        case 'n': {
+          int reps = atoi(optarg);
+          if (reps <= 0) {
+            std::cerr << "ERROR: Invalid benchmark repetition count: "
+                      << optarg << std::endl;
+            return false;
+          }
+          reps_ = reps;
+          break;
+        }
+        case 'o':
+          report_path_ = optarg;
+          break;
+        case 'h':
+          PrintHelp();
+          break;
+      }
+    }
+
+    // Queue up a test for each run of each app. The order of runs matches
+    // apps_, which is how PrepareBatchTest knows which app is next.
+    if (!apps_.empty()) {
+      for (const App &app : apps_) {
+        for (unsigned rep = 0; rep < reps_; ++rep) {
+          VerilatorSimCtrl::GetInstance().AddBatchImage(app.elf);
+        }
+      }
+      OtbnTraceSource::get().AddListener(this);
+    }
+
+    return true;
+  }
+
+  bool PrepareBatchTest(const std::string &image) override {
+    if (apps_.empty())
+      return true;
+
+    assert(next_run_ < apps_.size() * reps_);
+    current_ = &apps_[next_run_ / reps_];
+    ++next_run_;
+    assert(current_->elf == image);
+
+    run_cycles_ = 0;
+    run_stalls_ = 0;
+    run_insns_ = 0;
+    run_start_time_ = VerilatorSimCtrl::GetInstance().GetTime();
+    run_start_ = std::chrono::steady_clock::now();
+
+    // The ELF file has already been loaded by VerilatorMemUtil (which was
+    // registered first). Load any DMEM image over the top of it.
+    if (current_->dmem.empty())
+      return true;
+    try {
+      otbn_memutil.LoadFileToNamedMem(false, "dmem", current_->dmem,
+                                      kMemImageUnknown);
+    } catch (const std::exception &err) {
+      std::cerr << "ERROR: Failed to load DMEM image: " << err.what()
+                << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  void FinishBatchTest(const std::string &image, bool passed) override {
+    if (!current_)
+      return;
+
+    App &app = *current_;
+    current_ = nullptr;
+
+    if (app.runs == 0 || run_cycles_ < app.min_cycles)
+      app.min_cycles = run_cycles_;
+    if (app.runs == 0 || run_cycles_ > app.max_cycles)
+      app.max_cycles = run_cycles_;
+    ++app.runs;
+    app.failures += !passed;
+    app.insns = run_insns_;
+    app.cycles += run_cycles_;
+    app.stalls += run_stalls_;
+    app.sim_cycles +=
+        (VerilatorSimCtrl::GetInstance().GetTime() - run_start_time_) / 2;
+    app.host_s += std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - run_start_)
+                      .count();
+  }
+
+  void AcceptTraceRecord(const OtbnTraceRecord &record,
+                         unsigned int cycle_count) override {
+    if (record.insn == OtbnTraceRecord::NoInsn)
+      return;
+
+    ++run_cycles_;
+    if (record.insn == OtbnTraceRecord::InsnStall)
+      ++run_stalls_;
+    else if (record.insn == OtbnTraceRecord::InsnExecute)
+      ++run_insns_;
+  }
+
+  void PostExec() override {
+    if (apps_.empty())
+      return;
+
+    bool csv = IsCsvPath(report_path_);
+    if (report_path_.empty()) {
+      std::cout << std::endl
+                << "OTBN benchmark results" << std::endl
+                << "======================" << std::endl;
+      WriteReport(std::cout, csv);
+      return;
+    }
+
+    std::ofstream os(report_path_);
+    WriteReport(os, csv);
+    if (!os.flush()) {
+      std::cerr << "ERROR: Failed to write benchmark report to "
+                << report_path_ << std::endl;
+      return;
+    }
+    std::cout << "Benchmark report written to " << report_path_ << std::endl;
   }
 };
 
 static otbn_top_sim *verilator_top;
-static OtbnMemUtil otbn_memutil("TOP.otbn_top_sim");
 
 int main(int argc, char **argv) {
   VerilatorMemUtil memutil(&otbn_memutil);
   OtbnTraceUtil traceutil;
+  OtbnBenchmark benchmark;
 
   otbn_top_sim top;
   // Make the otbn_top_sim object visible to OtbnTopApplyLoopWarp.
@@ -115,6 +549,7 @@ int main(int argc, char **argv) {
                  VerilatorSimCtrlFlags::ResetPolarityNegative);
   simctrl.RegisterExtension(&memutil);
   simctrl.RegisterExtension(&traceutil);
+  simctrl.RegisterExtension(&benchmark);
 
   std::cout << "Simulation of OTBN" << std::endl
             << "==================" << std::endl
@@ -277,6 +712,9 @@ extern "C" void OtbnTopApplyLoopWarp() {
 
     uint32_t new_cnt = otbn_memutil.GetLoopWarp(insn_addr, old_cnt);
     if (old_cnt != new_cnt) {
+      if (profile_trace_listener)
+        profile_trace_listener->RecordLoopWarp(insn_addr);
+
       // Convert from new_cnt back to the "iters" format by subtracting from
       // the total, but bottom out at 1 (the last iteration).
       uint32_t new_iters = (new_cnt < total) ? (total - new_cnt) : 1;
@@ -0,0 +1,217 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Reference models of the PRNG primitives, for checking long streams of their
+// output in one DPI call:
+//
+// - prim_trivium, in both its Trivium and Bivium variants. The model follows
+//   the state update and key stream functions in prim_trivium_pkg, and
+//   produces 64 key stream bits at a time with word-wide operations.
+//
+// - prim_lfsr, for the GAL_XOR and FIB_XNOR types. The model produces the
+//   sequence of values of the LFSR state register, before any of the output
+//   permutations. It does not model the restore of the default seed after a
+//   lockup.
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <svdpi.h>
+
+namespace {
+
+typedef unsigned __int128 uint128_t;
+
+static const unsigned kTriviumStateWidth = 288;
+static const unsigned kBiviumStateWidth = 177;
+
+// Lengths of the shift registers that make up the state. Register A holds
+// state[92:0], B holds state[176:93] and C (Trivium only) holds
+// state[287:177]. In each register, the bit with the lowest index is the one
+// that is fed back into.
+static const unsigned kRegALen = 93;
+static const unsigned kRegBLen = 84;
+static const unsigned kRegCLen = 111;
+
+// A shift register of up to 128 bits, stored in reverse, so that bit m of
+// `bits` holds bit `len - 1 - m` of the register. With that order, the values
+// that a tap takes over the next 64 updates are next to each other.
+struct ShiftReg {
+  unsigned len;
+  uint128_t bits;
+
+  // Bit j of the result is the value of register bit p after j updates, for
+  // j in [0, 64). This needs p >= 63, so that the tap only sees bits that are
+  // in the register now.
+  uint64_t tap(unsigned p) const {
+    assert(p >= 63 && p < len);
+    return (uint64_t)(bits >> (len - 1 - p));
+  }
+
+  // Do num_steps <= 64 updates, where bit j of feedback is the bit that is
+  // shifted in by update j.
+  void shift_in(uint64_t feedback, unsigned num_steps) {
+    assert(num_steps > 0 && num_steps <= 64);
+    uint64_t mask = num_steps == 64 ? ~(uint64_t)0
+                                    : (((uint64_t)1 << num_steps) - 1);
+    bits = (bits >> num_steps) | ((uint128_t)(feedback & mask)
+                                  << (len - num_steps));
+    bits &= ((uint128_t)1 << len) - 1;
+  }
+
+  bool get(unsigned i) const { return (bits >> (len - 1 - i)) & 1; }
+  void set(unsigned i, bool value) {
+    uint128_t bit = (uint128_t)1 << (len - 1 - i);
+    bits = value ? (bits | bit) : (bits & ~bit);
+  }
+};
+
+class TriviumState {
+ public:
+  // state holds the bits of the state, least significant word first.
+  TriviumState(bool bivium, const svBitVecVal *state);
+
+  unsigned width() const {
+    return bivium_ ? kBiviumStateWidth : kTriviumStateWidth;
+  }
+
+  void get_state(svBitVecVal *state) const;
+
+  // Do num_steps <= 64 updates of the state, returning the key stream bits
+  // that are generated, the first one in bit 0.
+  uint64_t step(unsigned num_steps);
+
+ private:
+  ShiftReg &reg_for_bit(unsigned *i);
+  const ShiftReg &reg_for_bit(unsigned *i) const {
+    return const_cast<TriviumState *>(this)->reg_for_bit(i);
+  }
+
+  bool bivium_;
+  ShiftReg a_, b_, c_;
+};
+
+TriviumState::TriviumState(bool bivium, const svBitVecVal *state)
+    : bivium_(bivium),
+      a_{kRegALen, 0},
+      b_{kRegBLen, 0},
+      c_{bivium ? 0 : kRegCLen, 0} {
+  for (unsigned i = 0; i < width(); ++i) {
+    unsigned j = i;
+    reg_for_bit(&j).set(j, (state[i / 32] >> (i % 32)) & 1);
+  }
+}
+
+ShiftReg &TriviumState::reg_for_bit(unsigned *i) {
+  if (*i < kRegALen) {
+    return a_;
+  }
+  *i -= kRegALen;
+  if (*i < kRegBLen) {
+    return b_;
+  }
+  *i -= kRegBLen;
+  assert(!bivium_ && *i < kRegCLen);
+  return c_;
+}
+
+void TriviumState::get_state(svBitVecVal *state) const {
+  std::fill(state, state + (width() + 31) / 32, 0);
+  for (unsigned i = 0; i < width(); ++i) {
+    unsigned j = i;
+    if (reg_for_bit(&j).get(j)) {
+      state[i / 32] |= (svBitVecVal)1 << (i % 32);
+    }
+  }
+}
+
+uint64_t TriviumState::step(unsigned num_steps) {
+  // The taps are those of prim_trivium_pkg, with indices relative to the
+  // start of each register: state[65] is a_.tap(65), state[161] is
+  // b_.tap(161 - 93) and state[242] is c_.tap(242 - 177), and so on.
+  uint64_t t1 = a_.tap(65) ^ a_.tap(92);
+  uint64_t t2 = b_.tap(68) ^ b_.tap(83);
+  uint64_t feedback_b = b_.tap(77) ^ t1 ^ (a_.tap(90) & a_.tap(91));
+  if (bivium_) {
+    uint64_t feedback_a = a_.tap(68) ^ t2 ^ (b_.tap(81) & b_.tap(82));
+    a_.shift_in(feedback_a, num_steps);
+    b_.shift_in(feedback_b, num_steps);
+    return t1 ^ t2;
+  }
+
+  uint64_t t3 = c_.tap(65) ^ c_.tap(110);
+  uint64_t feedback_a = a_.tap(68) ^ t3 ^ (c_.tap(108) & c_.tap(109));
+  uint64_t feedback_c = c_.tap(86) ^ t2 ^ (b_.tap(81) & b_.tap(82));
+  a_.shift_in(feedback_a, num_steps);
+  b_.shift_in(feedback_b, num_steps);
+  c_.shift_in(feedback_c, num_steps);
+  return t1 ^ t2 ^ t3;
+}
+
+// Reads a 64-bit packed array that is passed as two svBitVecVal words.
+static uint64_t read64(const svBitVecVal *w) {
+  return ((uint64_t)w[1] << 32) | w[0];
+}
+
+static void write64(svBitVecVal *w, uint64_t value) {
+  w[1] = value >> 32;
+  w[0] = (uint32_t)value;
+}
+
+}  // namespace
+
+extern "C" {
+
+TriviumState *c_dpi_trivium_mk(unsigned char bivium,
+                               const svBitVecVal *state) {
+  return new TriviumState(bivium != 0, state);
+}
+
+void c_dpi_trivium_free(TriviumState *ts) { delete ts; }
+
+void c_dpi_trivium_get_state(const TriviumState *ts, svBitVecVal *state) {
+  assert(ts);
+  ts->get_state(state);
+}
+
+void c_dpi_trivium_skip(TriviumState *ts, uint64_t num_steps) {
+  assert(ts);
+  for (; num_steps >= 64; num_steps -= 64) {
+    ts->step(64);
+  }
+  if (num_steps != 0) {
+    ts->step((unsigned)num_steps);
+  }
+}
+
+void c_dpi_trivium_gen(TriviumState *ts, svOpenArrayHandle out) {
+  assert(ts);
+  int len = svSize(out, 1);
+  int low = svLow(out, 1);
+  for (int i = 0; i < len; ++i) {
+    write64((svBitVecVal *)svGetArrElemPtr1(out, low + i), ts->step(64));
+  }
+}
+
+void c_dpi_lfsr_gen(unsigned char fib_xnor, unsigned width,
+                    const svBitVecVal *coeffs, const svBitVecVal *seed,
+                    svOpenArrayHandle out) {
+  assert(width >= 2 && width <= 64);
+  uint64_t mask = width == 64 ? ~(uint64_t)0 : (((uint64_t)1 << width) - 1);
+  uint64_t coeffs64 = read64(coeffs) & mask;
+  uint64_t state = read64(seed) & mask;
+
+  int len = svSize(out, 1);
+  int low = svLow(out, 1);
+  for (int i = 0; i < len; ++i) {
+    if (fib_xnor) {
+      uint64_t feedback = !__builtin_parityll(state & coeffs64);
+      state = ((state << 1) | feedback) & mask;
+    } else {
+      state = (state >> 1) ^ ((state & 1) ? coeffs64 : 0);
+    }
+    write64((svBitVecVal *)svGetArrElemPtr1(out, low + i), state);
+  }
+}
+}
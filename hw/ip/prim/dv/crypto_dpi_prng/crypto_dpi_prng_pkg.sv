@@ -0,0 +1,59 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Reference models of prim_trivium and prim_lfsr that produce whole streams of output per call, so
+// that a scoreboard can check a PRNG transcript without a DPI call for every update.
+package crypto_dpi_prng_pkg;
+  import prim_trivium_pkg::*;
+
+  localparam int unsigned LfsrMaxWidth = 64;
+
+  // DPI-C imports
+
+  // Create a Trivium (bivium = 0) or Bivium (bivium = 1) model with the given state. For Bivium,
+  // only the bottom BiviumStateWidth bits of state are used.
+  import "DPI-C" function chandle c_dpi_trivium_mk(bit                           bivium,
+                                                   bit [TriviumStateWidth-1:0]   state);
+  import "DPI-C" function void c_dpi_trivium_free(chandle h);
+  import "DPI-C" function void c_dpi_trivium_get_state(chandle                            h,
+                                                       output bit [TriviumStateWidth-1:0] state);
+  // Update the state num_steps times, discarding the key stream.
+  import "DPI-C" function void c_dpi_trivium_skip(chandle h, longint unsigned num_steps);
+  // Fill out with the next 64 * out.size() bits of the key stream. Bit i of the first element is
+  // the key stream bit of the i-th update, as in key_o of prim_trivium, so that for an
+  // OutputWidth of 64 each element is one value of key_o.
+  import "DPI-C" function void c_dpi_trivium_gen(chandle h, output bit [63:0] out[]);
+
+  // Fill out with the values that the state of a prim_lfsr of type "GAL_XOR" (fib_xnor = 0) or
+  // "FIB_XNOR" (fib_xnor = 1) and the given width and coefficients takes in the out.size()
+  // updates that follow seed. The restore of the default seed after a lockup is not modeled.
+  import "DPI-C" function void c_dpi_lfsr_gen(bit                      fib_xnor,
+                                              int unsigned             width,
+                                              bit [LfsrMaxWidth-1:0]   coeffs,
+                                              bit [LfsrMaxWidth-1:0]   seed,
+                                              output bit [63:0]        out[]);
+
+  // Create a model seeded with a key and IV, the way prim_trivium with SeedTypeKeyIv does it. The
+  // primitive updates its state NumInitUpdates times with OutputWidth bits each after seeding,
+  // which is 4 * StateWidth bits rounded up to a multiple of OutputWidth.
+  function automatic chandle sv_dpi_trivium_mk_key_iv(bit                  bivium,
+                                                      bit [KeyIvWidth-1:0] key,
+                                                      bit [KeyIvWidth-1:0] iv,
+                                                      int unsigned         output_width);
+    bit [TriviumStateWidth-1:0] state;
+    int unsigned state_width = bivium ? BiviumStateWidth : TriviumStateWidth;
+    int unsigned num_init_updates = (4 * state_width + output_width - 1) / output_width;
+    chandle h;
+
+    if (bivium) begin
+      state = TriviumStateWidth'(bivium_seed_key_iv(key, iv));
+    end else begin
+      state = trivium_seed_key_iv(key, iv);
+    end
+    h = c_dpi_trivium_mk(bivium, state);
+    c_dpi_trivium_skip(h, longint'(num_init_updates) * output_width);
+    return h;
+  endfunction
+
+endpackage
@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "ascon_opt64.h"
 #include "svdpi.h"
 #include "vendor/ascon_ascon-c/ascon128/crypto_aead.h"
 #include "vendor/ascon_ascon-c/ascon128/round.h"
@@ -129,6 +130,126 @@ void c_dpi_aead_decrypt(svOpenArrayHandle ct, unsigned int ct_len,
   return;
 }
 
+// Check the arrays for a batch of num_msgs messages, where data_len holds
+// the lengths of the messages in data_i and out_extra is the number of bytes
+// that each output message has in addition. Returns the total data length, or
+// -1 if anything is the wrong size.
+static long ascon_batch_check(const char *fn, ascon_variant_t variant,
+                              svOpenArrayHandle data_i,
+                              const unsigned int *data_len, int num_msgs,
+                              svOpenArrayHandle data_o, long out_extra,
+                              svOpenArrayHandle ad, const unsigned int *ad_len,
+                              svOpenArrayHandle nonce, svOpenArrayHandle key) {
+  if (variant != kAsconVariant128 && variant != kAsconVariant128a) {
+    printf("ERROR: %s: Unknown variant %d\n", fn, (int)variant);
+    return -1;
+  }
+
+  long total_data = 0, total_ad = 0;
+  for (int i = 0; i < num_msgs; i++) {
+    if ((long)data_len[i] + out_extra < 0) {
+      printf("ERROR: %s: Message %d is shorter than its tag\n", fn, i);
+      return -1;
+    }
+    total_data += data_len[i];
+    total_ad += ad_len[i];
+  }
+
+  const int key_size = svSize(key, 1);
+  if (svSize(data_i, 1) < total_data ||
+      svSize(data_o, 1) < total_data + num_msgs * out_extra ||
+      svSize(ad, 1) < total_ad ||
+      svSize(nonce, 1) < num_msgs * ASCON_OPT64_NONCE_BYTES ||
+      (key_size != ASCON_OPT64_KEY_BYTES &&
+       key_size < num_msgs * ASCON_OPT64_KEY_BYTES)) {
+    printf("ERROR: %s: Arrays are too small for %d messages\n", fn, num_msgs);
+    return -1;
+  }
+  return total_data;
+}
+
+int c_dpi_aead_encrypt_batch(int variant, svOpenArrayHandle ct,
+                             svOpenArrayHandle msg, svOpenArrayHandle msg_len,
+                             svOpenArrayHandle ad, svOpenArrayHandle ad_len,
+                             svOpenArrayHandle nonce, svOpenArrayHandle key) {
+  const int num_msgs = svSize(msg_len, 1);
+  const unsigned int *m_len = (const unsigned int *)svGetArrayPtr(msg_len);
+  const unsigned int *a_len = (const unsigned int *)svGetArrayPtr(ad_len);
+  if (svSize(ad_len, 1) != num_msgs) {
+    printf("ERROR: c_dpi_aead_encrypt_batch: %d message lengths but %d "
+           "associated data lengths\n",
+           num_msgs, svSize(ad_len, 1));
+    return -1;
+  }
+  if (ascon_batch_check("c_dpi_aead_encrypt_batch", (ascon_variant_t)variant,
+                        msg, m_len, num_msgs, ct, ASCON_OPT64_TAG_BYTES, ad,
+                        a_len, nonce, key) < 0) {
+    return -1;
+  }
+
+  uint8_t *c = (uint8_t *)svGetArrayPtr(ct);
+  const uint8_t *m = (const uint8_t *)svGetArrayPtr(msg);
+  const uint8_t *a = (const uint8_t *)svGetArrayPtr(ad);
+  const uint8_t *npub = (const uint8_t *)svGetArrayPtr(nonce);
+  const uint8_t *k = (const uint8_t *)svGetArrayPtr(key);
+  const int key_stride =
+      svSize(key, 1) == ASCON_OPT64_KEY_BYTES ? 0 : ASCON_OPT64_KEY_BYTES;
+
+  for (int i = 0; i < num_msgs; i++) {
+    ascon_opt64_encrypt((ascon_variant_t)variant, c, m, m_len[i], a, a_len[i],
+                        npub, k);
+    c += m_len[i] + ASCON_OPT64_TAG_BYTES;
+    m += m_len[i];
+    a += a_len[i];
+    npub += ASCON_OPT64_NONCE_BYTES;
+    k += key_stride;
+  }
+  return 0;
+}
+
+int c_dpi_aead_decrypt_batch(int variant, svOpenArrayHandle ct,
+                             svOpenArrayHandle ct_len, svOpenArrayHandle msg,
+                             svOpenArrayHandle ad, svOpenArrayHandle ad_len,
+                             svOpenArrayHandle nonce, svOpenArrayHandle key,
+                             svOpenArrayHandle tag_ok) {
+  const int num_msgs = svSize(ct_len, 1);
+  const unsigned int *c_len = (const unsigned int *)svGetArrayPtr(ct_len);
+  const unsigned int *a_len = (const unsigned int *)svGetArrayPtr(ad_len);
+  if (svSize(ad_len, 1) != num_msgs || svSize(tag_ok, 1) < num_msgs) {
+    printf("ERROR: c_dpi_aead_decrypt_batch: Expected %d associated data "
+           "lengths and tag results\n",
+           num_msgs);
+    return -1;
+  }
+  if (ascon_batch_check("c_dpi_aead_decrypt_batch", (ascon_variant_t)variant,
+                        ct, c_len, num_msgs, msg, -ASCON_OPT64_TAG_BYTES, ad,
+                        a_len, nonce, key) < 0) {
+    return -1;
+  }
+
+  const uint8_t *c = (const uint8_t *)svGetArrayPtr(ct);
+  uint8_t *m = (uint8_t *)svGetArrayPtr(msg);
+  const uint8_t *a = (const uint8_t *)svGetArrayPtr(ad);
+  const uint8_t *npub = (const uint8_t *)svGetArrayPtr(nonce);
+  const uint8_t *k = (const uint8_t *)svGetArrayPtr(key);
+  uint8_t *ok = (uint8_t *)svGetArrayPtr(tag_ok);
+  const int key_stride =
+      svSize(key, 1) == ASCON_OPT64_KEY_BYTES ? 0 : ASCON_OPT64_KEY_BYTES;
+
+  int num_bad = 0;
+  for (int i = 0; i < num_msgs; i++) {
+    ok[i] = ascon_opt64_decrypt((ascon_variant_t)variant, m, c, c_len[i], a,
+                                a_len[i], npub, k) == 0;
+    num_bad += !ok[i];
+    c += c_len[i];
+    m += c_len[i] - ASCON_OPT64_TAG_BYTES;
+    a += a_len[i];
+    npub += ASCON_OPT64_NONCE_BYTES;
+    k += key_stride;
+  }
+  return num_bad;
+}
+
 void c_dpi_ascon_round(const svBitVecVal *data_i, svBit *round_i,
                        svBitVecVal *data_o) {
   uint8_t round;
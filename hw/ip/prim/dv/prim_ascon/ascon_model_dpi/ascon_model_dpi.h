@@ -44,6 +44,54 @@ void c_dpi_aead_decrypt(svOpenArrayHandle ct, unsigned int ct_len,
                         unsigned int ad_len, svOpenArrayHandle nonce,
                         svOpenArrayHandle key);
 
+/**
+ * Encrypt a batch of messages with the optimized model in ascon_opt64.h.
+ *
+ * The messages, associated data and ciphertexts are each concatenated into one
+ * array. Each message gets its own 16 byte nonce. The key array holds either
+ * one 16 byte key for the whole batch or one key per message.
+ *
+ * @param variant Which cipher to use (an ascon_variant_t: 0 for Ascon-128, 1
+ *                for Ascon-128a)
+ * @param ct      Output: ciphertext + tag for each message in turn (each
+ *                message length + 16 bytes)
+ * @param msg     Input: Plaintexts
+ * @param msg_len Input: Length of each plaintext in bytes (this also gives
+ *                the number of messages)
+ * @param ad      Input: Associated data
+ * @param ad_len  Input: Length of the associated data for each message
+ * @param nonce   Input: 16 byte nonce for each message
+ * @param key     Input: 16 byte key (for all messages) or keys (one each)
+ * @return 0 on success, -1 if the arguments were invalid
+ */
+int c_dpi_aead_encrypt_batch(int variant, svOpenArrayHandle ct,
+                             svOpenArrayHandle msg, svOpenArrayHandle msg_len,
+                             svOpenArrayHandle ad, svOpenArrayHandle ad_len,
+                             svOpenArrayHandle nonce, svOpenArrayHandle key);
+
+/**
+ * Decrypt a batch of messages with the optimized model in ascon_opt64.h. The
+ * array layout matches c_dpi_aead_encrypt_batch().
+ *
+ * @param variant Which cipher to use (as for c_dpi_aead_encrypt_batch())
+ * @param ct      Input: ciphertext + tag for each message in turn
+ * @param ct_len  Input: Length of each ciphertext + tag in bytes (this also
+ *                gives the number of messages)
+ * @param msg     Output: Plaintexts
+ * @param ad      Input: Associated data
+ * @param ad_len  Input: Length of the associated data for each message
+ * @param nonce   Input: 16 byte nonce for each message
+ * @param key     Input: 16 byte key (for all messages) or keys (one each)
+ * @param tag_ok  Output: 1 for each message whose tag matched, 0 otherwise
+ * @return The number of messages whose tag didn't match, or -1 if the
+ *         arguments were invalid
+ */
+int c_dpi_aead_decrypt_batch(int variant, svOpenArrayHandle ct,
+                             svOpenArrayHandle ct_len, svOpenArrayHandle msg,
+                             svOpenArrayHandle ad, svOpenArrayHandle ad_len,
+                             svOpenArrayHandle nonce, svOpenArrayHandle key,
+                             svOpenArrayHandle tag_ok);
+
 /**
  * Perform one ascon round.
  *
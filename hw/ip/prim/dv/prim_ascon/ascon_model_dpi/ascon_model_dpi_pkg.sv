@@ -32,4 +32,31 @@ package ascon_model_dpi_pkg;
     input byte unsigned key[]
   );
 
+  // Batched versions of c_dpi_aead_encrypt and c_dpi_aead_decrypt, using an optimized model. The
+  // messages (and their associated data and ciphertexts) are concatenated, with one nonce per
+  // message and either one shared key or one key per message. variant is 0 for Ascon-128 and 1 for
+  // Ascon-128a. See ascon_model_dpi.h for details.
+  import "DPI-C" function int c_dpi_aead_encrypt_batch(
+    input  int           variant,
+    output byte unsigned ct[],
+    input  byte unsigned msg[],
+    input  int unsigned  msg_len[],
+    input  byte unsigned ad[],
+    input  int unsigned  ad_len[],
+    input  byte unsigned nonce[],
+    input  byte unsigned key[]
+  );
+
+  import "DPI-C" function int c_dpi_aead_decrypt_batch(
+    input  int           variant,
+    input  byte unsigned ct[],
+    input  int unsigned  ct_len[],
+    output byte unsigned msg[],
+    input  byte unsigned ad[],
+    input  int unsigned  ad_len[],
+    input  byte unsigned nonce[],
+    input  byte unsigned key[],
+    output byte unsigned tag_ok[]
+  );
+
 endpackage
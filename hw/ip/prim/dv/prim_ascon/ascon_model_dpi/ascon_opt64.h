@@ -0,0 +1,286 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_IP_PRIM_DV_PRIM_ASCON_ASCON_MODEL_DPI_ASCON_OPT64_H_
+#define OPENTITAN_HW_IP_PRIM_DV_PRIM_ASCON_ASCON_MODEL_DPI_ASCON_OPT64_H_
+
+/*
+ * Ascon-128 and Ascon-128a AEAD for 64-bit hosts, following the approach of
+ * the opt64 implementations in ascon-c.
+ *
+ * The vendored ref implementations build every state word a byte at a time
+ * and have P6, P8 and P12 as separate functions, which means that each
+ * variant needs its own copy of aead.c (and the two can't be linked into one
+ * library). Here, words are loaded and stored with a single byte swap, the
+ * permutations share one loop over the round constants and the rate is a
+ * parameter, so one function handles both variants.
+ *
+ * The results are identical to crypto_aead_encrypt() and
+ * crypto_aead_decrypt() from vendor/ascon_ascon-c (ascon_opt64_test.cc checks
+ * this).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "vendor/ascon_ascon-c/ascon128/ascon.h"
+
+#define ASCON_OPT64_KEY_BYTES 16
+#define ASCON_OPT64_NONCE_BYTES 16
+#define ASCON_OPT64_TAG_BYTES 16
+
+typedef enum ascon_variant {
+  kAsconVariant128 = 0,
+  kAsconVariant128a = 1,
+} ascon_variant_t;
+
+static inline uint64_t ascon_opt64_ror(uint64_t x, int n) {
+  return x >> n | x << (-n & 63);
+}
+
+/**
+ * Convert between host order and the big-endian byte order of Ascon words.
+ */
+static inline uint64_t ascon_opt64_swap(uint64_t x) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return x;
+#elif defined(__GNUC__)
+  return __builtin_bswap64(x);
+#else
+  x = ((x & 0x00ff00ff00ff00ffull) << 8) | ((x >> 8) & 0x00ff00ff00ff00ffull);
+  x = ((x & 0x0000ffff0000ffffull) << 16) |
+      ((x >> 16) & 0x0000ffff0000ffffull);
+  return (x << 32) | (x >> 32);
+#endif
+}
+
+/**
+ * Load n (at most 8) bytes into the most significant end of a word.
+ */
+static inline uint64_t ascon_opt64_load(const uint8_t *bytes, size_t n) {
+  uint64_t x = 0;
+  memcpy(&x, bytes, n);
+  return ascon_opt64_swap(x);
+}
+
+/**
+ * Store the n (at most 8) most significant bytes of a word.
+ */
+static inline void ascon_opt64_store(uint8_t *bytes, uint64_t x, size_t n) {
+  x = ascon_opt64_swap(x);
+  memcpy(bytes, &x, n);
+}
+
+/**
+ * Clear the n (at most 7) most significant bytes of a word.
+ */
+static inline uint64_t ascon_opt64_clear(uint64_t x, size_t n) {
+  return n ? x & (~(uint64_t)0 >> (8 * n)) : x;
+}
+
+/**
+ * The padding word for a final block of n (at most 7) bytes.
+ */
+static inline uint64_t ascon_opt64_pad(size_t n) {
+  return (uint64_t)0x80 << (56 - 8 * n);
+}
+
+static inline void ascon_opt64_round(ascon_state_t *s, uint8_t c) {
+  uint64_t x0 = s->x[0], x1 = s->x[1], x2 = s->x[2] ^ c, x3 = s->x[3],
+           x4 = s->x[4];
+
+  // substitution layer (bitsliced 5-bit S-box)
+  x0 ^= x4;
+  x4 ^= x3;
+  x2 ^= x1;
+  const uint64_t t0 = x0 ^ (~x1 & x2);
+  const uint64_t t1 = x1 ^ (~x2 & x3);
+  const uint64_t t2 = x2 ^ (~x3 & x4);
+  const uint64_t t3 = x3 ^ (~x4 & x0);
+  const uint64_t t4 = x4 ^ (~x0 & x1);
+  x0 = t0 ^ t4;
+  x1 = t1 ^ t0;
+  x2 = ~t2;
+  x3 = t3 ^ t2;
+  x4 = t4;
+
+  // linear diffusion layer
+  s->x[0] = x0 ^ ascon_opt64_ror(x0, 19) ^ ascon_opt64_ror(x0, 28);
+  s->x[1] = x1 ^ ascon_opt64_ror(x1, 61) ^ ascon_opt64_ror(x1, 39);
+  s->x[2] = x2 ^ ascon_opt64_ror(x2, 1) ^ ascon_opt64_ror(x2, 6);
+  s->x[3] = x3 ^ ascon_opt64_ror(x3, 10) ^ ascon_opt64_ror(x3, 17);
+  s->x[4] = x4 ^ ascon_opt64_ror(x4, 7) ^ ascon_opt64_ror(x4, 41);
+}
+
+/**
+ * The last num_rounds rounds of the 12 round permutation (so P12, P8 or P6).
+ */
+static inline void ascon_opt64_permute(ascon_state_t *s, int num_rounds) {
+  for (int i = 12 - num_rounds; i < 12; i++)
+    ascon_opt64_round(s, (uint8_t)(((0xf - i) << 4) | i));
+}
+
+static inline size_t ascon_opt64_rate(ascon_variant_t variant) {
+  return variant == kAsconVariant128a ? 16 : 8;
+}
+
+static inline int ascon_opt64_pb_rounds(ascon_variant_t variant) {
+  return variant == kAsconVariant128a ? 8 : 6;
+}
+
+/**
+ * Initialize the state and absorb the associated data.
+ */
+static inline void ascon_opt64_start(ascon_state_t *s, ascon_variant_t variant,
+                                     const uint8_t *ad, size_t ad_len,
+                                     const uint8_t *npub, const uint8_t *k) {
+  const size_t rate = ascon_opt64_rate(variant);
+  const int pb_rounds = ascon_opt64_pb_rounds(variant);
+  const uint64_t k0 = ascon_opt64_load(k, 8);
+  const uint64_t k1 = ascon_opt64_load(k + 8, 8);
+
+  // The IV gives the key size and rate in bits, then the two round counts,
+  // with a byte for each starting from the top.
+  s->x[0] = ((uint64_t)(ASCON_OPT64_KEY_BYTES * 8) << 56) |
+            ((uint64_t)(rate * 8) << 48) | ((uint64_t)12 << 40) |
+            ((uint64_t)pb_rounds << 32);
+  s->x[1] = k0;
+  s->x[2] = k1;
+  s->x[3] = ascon_opt64_load(npub, 8);
+  s->x[4] = ascon_opt64_load(npub + 8, 8);
+  ascon_opt64_permute(s, 12);
+  s->x[3] ^= k0;
+  s->x[4] ^= k1;
+
+  if (ad_len) {
+    for (; ad_len >= rate; ad += rate, ad_len -= rate) {
+      s->x[0] ^= ascon_opt64_load(ad, 8);
+      if (rate == 16)
+        s->x[1] ^= ascon_opt64_load(ad + 8, 8);
+      ascon_opt64_permute(s, pb_rounds);
+    }
+    int i = 0;
+    if (ad_len >= 8) {
+      s->x[0] ^= ascon_opt64_load(ad, 8);
+      ad += 8;
+      ad_len -= 8;
+      i = 1;
+    }
+    s->x[i] ^= ascon_opt64_load(ad, ad_len) ^ ascon_opt64_pad(ad_len);
+    ascon_opt64_permute(s, pb_rounds);
+  }
+
+  // domain separation
+  s->x[4] ^= 1;
+}
+
+/**
+ * Run the finalization and return the tag in the last two words of the state.
+ */
+static inline void ascon_opt64_finish(ascon_state_t *s, ascon_variant_t variant,
+                                      const uint8_t *k) {
+  const size_t w = ascon_opt64_rate(variant) / 8;
+  const uint64_t k0 = ascon_opt64_load(k, 8);
+  const uint64_t k1 = ascon_opt64_load(k + 8, 8);
+  s->x[w] ^= k0;
+  s->x[w + 1] ^= k1;
+  ascon_opt64_permute(s, 12);
+  s->x[3] ^= k0;
+  s->x[4] ^= k1;
+}
+
+/**
+ * Equivalent of crypto_aead_encrypt(): c gets msg_len bytes of ciphertext
+ * followed by a 16 byte tag.
+ */
+static inline void ascon_opt64_encrypt(ascon_variant_t variant, uint8_t *c,
+                                       const uint8_t *m, size_t msg_len,
+                                       const uint8_t *ad, size_t ad_len,
+                                       const uint8_t *npub, const uint8_t *k) {
+  const size_t rate = ascon_opt64_rate(variant);
+  const int pb_rounds = ascon_opt64_pb_rounds(variant);
+  ascon_state_t s;
+  ascon_opt64_start(&s, variant, ad, ad_len, npub, k);
+
+  for (; msg_len >= rate; m += rate, c += rate, msg_len -= rate) {
+    s.x[0] ^= ascon_opt64_load(m, 8);
+    ascon_opt64_store(c, s.x[0], 8);
+    if (rate == 16) {
+      s.x[1] ^= ascon_opt64_load(m + 8, 8);
+      ascon_opt64_store(c + 8, s.x[1], 8);
+    }
+    ascon_opt64_permute(&s, pb_rounds);
+  }
+  int i = 0;
+  if (msg_len >= 8) {
+    s.x[0] ^= ascon_opt64_load(m, 8);
+    ascon_opt64_store(c, s.x[0], 8);
+    m += 8;
+    c += 8;
+    msg_len -= 8;
+    i = 1;
+  }
+  s.x[i] ^= ascon_opt64_load(m, msg_len);
+  ascon_opt64_store(c, s.x[i], msg_len);
+  s.x[i] ^= ascon_opt64_pad(msg_len);
+  c += msg_len;
+
+  ascon_opt64_finish(&s, variant, k);
+  ascon_opt64_store(c, s.x[3], 8);
+  ascon_opt64_store(c + 8, s.x[4], 8);
+}
+
+/**
+ * Equivalent of crypto_aead_decrypt(): c holds ct_len bytes of ciphertext and
+ * tag, and m gets ct_len - 16 bytes of plaintext. Returns 0 if the tag
+ * matched, -1 otherwise. (The plaintext is written in either case.)
+ */
+static inline int ascon_opt64_decrypt(ascon_variant_t variant, uint8_t *m,
+                                      const uint8_t *c, size_t ct_len,
+                                      const uint8_t *ad, size_t ad_len,
+                                      const uint8_t *npub, const uint8_t *k) {
+  if (ct_len < ASCON_OPT64_TAG_BYTES)
+    return -1;
+
+  const size_t rate = ascon_opt64_rate(variant);
+  const int pb_rounds = ascon_opt64_pb_rounds(variant);
+  ascon_state_t s;
+  ascon_opt64_start(&s, variant, ad, ad_len, npub, k);
+
+  size_t len = ct_len - ASCON_OPT64_TAG_BYTES;
+  for (; len >= rate; m += rate, c += rate, len -= rate) {
+    const uint64_t c0 = ascon_opt64_load(c, 8);
+    ascon_opt64_store(m, s.x[0] ^ c0, 8);
+    s.x[0] = c0;
+    if (rate == 16) {
+      const uint64_t c1 = ascon_opt64_load(c + 8, 8);
+      ascon_opt64_store(m + 8, s.x[1] ^ c1, 8);
+      s.x[1] = c1;
+    }
+    ascon_opt64_permute(&s, pb_rounds);
+  }
+  int i = 0;
+  if (len >= 8) {
+    const uint64_t c0 = ascon_opt64_load(c, 8);
+    ascon_opt64_store(m, s.x[0] ^ c0, 8);
+    s.x[0] = c0;
+    m += 8;
+    c += 8;
+    len -= 8;
+    i = 1;
+  }
+  const uint64_t ci = ascon_opt64_load(c, len);
+  ascon_opt64_store(m, s.x[i] ^ ci, len);
+  s.x[i] = ascon_opt64_clear(s.x[i], len) | ci;
+  s.x[i] ^= ascon_opt64_pad(len);
+  c += len;
+
+  ascon_opt64_finish(&s, variant, k);
+  const uint64_t diff = (s.x[3] ^ ascon_opt64_load(c, 8)) |
+                        (s.x[4] ^ ascon_opt64_load(c + 8, 8));
+  return diff ? -1 : 0;
+}
+
+#endif  // OPENTITAN_HW_IP_PRIM_DV_PRIM_ASCON_ASCON_MODEL_DPI_ASCON_OPT64_H_
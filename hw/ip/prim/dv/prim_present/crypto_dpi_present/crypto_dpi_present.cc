@@ -8,6 +8,7 @@
 //   [1] Bognadov et al, PRESENT: An Ultra-Lightweight Block Cipher. LNCS 4727:
 //       450–466. doi:10.1007/978-3-540-74735-2_31.
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <svdpi.h>
@@ -50,6 +51,16 @@ class PresentState {
   // round and with is_last_round set, then count down.
   uint64_t dec_round(uint64_t input, unsigned round, bool is_last_round) const;
 
+  // Encrypt or decrypt up to kBatchSize blocks in place with num_rounds
+  // rounds. This gives the same result as calling enc_round for rounds 1 to
+  // num_rounds on each block (or dec_round from num_rounds down to 1), but
+  // works on all of the blocks at once with a bitsliced implementation.
+  static const unsigned kBatchSize = 64;
+  void encrypt_batch(uint64_t *data, unsigned num_blocks,
+                     unsigned num_rounds) const;
+  void decrypt_batch(uint64_t *data, unsigned num_blocks,
+                     unsigned num_rounds) const;
+
  private:
   static key128_t next_round_key(const key128_t &k, unsigned key_size,
                                  unsigned round_count);
@@ -59,6 +70,19 @@ class PresentState {
   static uint64_t sbox_layer(bool inverse, uint64_t data);
   static uint64_t perm_layer(bool inverse, uint64_t data);
 
+  // Bitsliced versions of the layers above, where slices[b] holds bit b of
+  // each block.
+  static void add_round_key_sliced(uint64_t *slices, uint64_t k64);
+  static void sbox_layer_sliced(bool inverse, uint64_t *slices);
+  static void perm_layer_sliced(bool inverse, uint64_t *slices);
+
+  // Transpose a 64x64 bit matrix in place, converting between blocks and
+  // slices.
+  static void transpose(uint64_t *a);
+
+  // The 64-bit round key used by add_round_key for key_schedule[idx]
+  uint64_t round_key64(unsigned idx) const;
+
   unsigned key_size;
   std::vector<key128_t> key_schedule;
 };
@@ -206,6 +230,156 @@ uint64_t PresentState::perm_layer(bool inverse, uint64_t data) {
   return ret;
 }
 
+uint64_t PresentState::round_key64(unsigned idx) const {
+  return add_round_key(0, key_schedule[idx], key_size);
+}
+
+void PresentState::add_round_key_sliced(uint64_t *slices, uint64_t k64) {
+  for (int b = 0; b < 64; ++b) {
+    slices[b] ^= (uint64_t)0 - ((k64 >> b) & 1);
+  }
+}
+
+void PresentState::sbox_layer_sliced(bool inverse, uint64_t *slices) {
+  for (int n = 0; n < 64; n += 4) {
+    const uint64_t *x = &slices[n];
+
+    // m[i] is the product of the bits x[j] where bit j of i is set. The
+    // product of all four bits doesn't appear in either S-box.
+    uint64_t m[15];
+    m[0] = ~(uint64_t)0;
+    m[1] = x[0];
+    m[2] = x[1];
+    m[3] = x[0] & x[1];
+    m[4] = x[2];
+    m[5] = x[0] & x[2];
+    m[6] = x[1] & x[2];
+    m[7] = m[3] & x[2];
+    m[8] = x[3];
+    m[9] = x[0] & x[3];
+    m[10] = x[1] & x[3];
+    m[11] = m[3] & x[3];
+    m[12] = x[2] & x[3];
+    m[13] = m[5] & x[3];
+    m[14] = m[6] & x[3];
+
+    // The algebraic normal form of each output bit of sbox4 or sbox4_inv
+    uint64_t y[4];
+    if (!inverse) {
+      y[0] = m[1] ^ m[4] ^ m[6] ^ m[8];
+      y[1] = m[2] ^ m[7] ^ m[8] ^ m[10] ^ m[11] ^ m[12] ^ m[13];
+      y[2] = m[0] ^ m[3] ^ m[4] ^ m[8] ^ m[9] ^ m[10] ^ m[11] ^ m[13];
+      y[3] = m[0] ^ m[1] ^ m[2] ^ m[6] ^ m[7] ^ m[8] ^ m[11] ^ m[13];
+    } else {
+      y[0] = m[0] ^ m[1] ^ m[4] ^ m[10];
+      y[1] = m[1] ^ m[2] ^ m[5] ^ m[7] ^ m[8] ^ m[10] ^ m[11] ^ m[12] ^ m[13];
+      y[2] = m[0] ^ m[3] ^ m[5] ^ m[6] ^ m[7] ^ m[8] ^ m[9] ^ m[10] ^ m[11] ^
+             m[13];
+      y[3] = m[1] ^ m[2] ^ m[3] ^ m[4] ^ m[7] ^ m[8] ^ m[13];
+    }
+    for (int i = 0; i < 4; ++i) {
+      slices[n + i] = y[i];
+    }
+  }
+}
+
+void PresentState::perm_layer_sliced(bool inverse, uint64_t *slices) {
+  uint64_t out[64];
+  for (int i = 0; i < 64; ++i) {
+    out[inverse ? bit_perm_inv[i] : bit_perm[i]] = slices[i];
+  }
+  for (int i = 0; i < 64; ++i) {
+    slices[i] = out[i];
+  }
+}
+
+void PresentState::transpose(uint64_t *a) {
+  uint64_t mask = 0x00000000ffffffff;
+  for (unsigned j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+    for (unsigned k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+      uint64_t t = ((a[k] >> j) ^ a[k | j]) & mask;
+      a[k] ^= t << j;
+      a[k | j] ^= t;
+    }
+  }
+}
+
+void PresentState::encrypt_batch(uint64_t *data, unsigned num_blocks,
+                                 unsigned num_rounds) const {
+  assert(num_blocks <= kBatchSize);
+  assert(1 <= num_rounds && num_rounds < key_schedule.size());
+
+  uint64_t slices[64] = {0};
+  std::copy(data, data + num_blocks, slices);
+  transpose(slices);
+
+  for (unsigned round = 1; round <= num_rounds; ++round) {
+    add_round_key_sliced(slices, round_key64(round - 1));
+    sbox_layer_sliced(false, slices);
+    perm_layer_sliced(false, slices);
+  }
+  add_round_key_sliced(slices, round_key64(num_rounds));
+
+  transpose(slices);
+  std::copy(slices, slices + num_blocks, data);
+}
+
+void PresentState::decrypt_batch(uint64_t *data, unsigned num_blocks,
+                                 unsigned num_rounds) const {
+  assert(num_blocks <= kBatchSize);
+  assert(1 <= num_rounds && num_rounds < key_schedule.size());
+
+  uint64_t slices[64] = {0};
+  std::copy(data, data + num_blocks, slices);
+  transpose(slices);
+
+  add_round_key_sliced(slices, round_key64(num_rounds));
+  for (unsigned round = num_rounds; round >= 1; --round) {
+    perm_layer_sliced(true, slices);
+    sbox_layer_sliced(true, slices);
+    add_round_key_sliced(slices, round_key64(round - 1));
+  }
+
+  transpose(slices);
+  std::copy(slices, slices + num_blocks, data);
+}
+
+// Encrypt or decrypt each element of src into dst, a batch at a time. Each
+// element is a 64-bit packed array, so is represented by two svBitVecVal
+// words.
+static void present_crypt_array(const PresentState *ps, bool decrypt,
+                                unsigned num_rounds,
+                                const svOpenArrayHandle src,
+                                svOpenArrayHandle dst) {
+  assert(ps);
+  int len = svSize(src, 1);
+  assert(svSize(dst, 1) == len);
+
+  int low_src = svLow(src, 1), low_dst = svLow(dst, 1);
+  uint64_t blocks[PresentState::kBatchSize];
+  for (int base = 0; base < len; base += PresentState::kBatchSize) {
+    unsigned num_blocks =
+        std::min<int>(len - base, (int)PresentState::kBatchSize);
+    for (unsigned i = 0; i < num_blocks; ++i) {
+      const svBitVecVal *w =
+          (const svBitVecVal *)svGetArrElemPtr1(src, low_src + base + i);
+      blocks[i] = ((uint64_t)w[1] << 32) | w[0];
+    }
+
+    if (decrypt) {
+      ps->decrypt_batch(blocks, num_blocks, num_rounds);
+    } else {
+      ps->encrypt_batch(blocks, num_blocks, num_rounds);
+    }
+
+    for (unsigned i = 0; i < num_blocks; ++i) {
+      svBitVecVal *w = (svBitVecVal *)svGetArrElemPtr1(dst, low_dst + base + i);
+      w[1] = blocks[i] >> 32;
+      w[0] = (uint32_t)blocks[i];
+    }
+  }
+}
+
 extern "C" {
 
 PresentState *c_dpi_present_mk(unsigned key_size, const svBitVecVal *key) {
@@ -254,4 +428,16 @@ void c_dpi_present_dec_round(const PresentState *ps, unsigned round,
   dst[1] = out64 >> 32;
   dst[0] = (uint32_t)out64;
 }
+
+void c_dpi_present_encrypt_batch(const PresentState *ps, unsigned num_rounds,
+                                 const svOpenArrayHandle src,
+                                 svOpenArrayHandle dst) {
+  present_crypt_array(ps, false, num_rounds, src, dst);
+}
+
+void c_dpi_present_decrypt_batch(const PresentState *ps, unsigned num_rounds,
+                                 const svOpenArrayHandle src,
+                                 svOpenArrayHandle dst) {
+  present_crypt_array(ps, true, num_rounds, src, dst);
+}
 }
@@ -24,6 +24,18 @@ package crypto_dpi_present_pkg;
                                                        bit [DataWidth-1:0]        in,
                                                        output bit [DataWidth-1:0] out);
 
+  // Batched encryption and decryption. These run all num_rounds rounds on every element of in,
+  // writing the results to out (which must be the same size). This is much faster per block than
+  // calling c_dpi_present_enc_round or c_dpi_present_dec_round for each round of each block.
+  import "DPI-C" function void c_dpi_present_encrypt_batch(chandle                    h,
+                                                           int unsigned               num_rounds,
+                                                           bit [DataWidth-1:0]        in[],
+                                                           output bit [DataWidth-1:0] out[]);
+  import "DPI-C" function void c_dpi_present_decrypt_batch(chandle                    h,
+                                                           int unsigned               num_rounds,
+                                                           bit [DataWidth-1:0]        in[],
+                                                           output bit [DataWidth-1:0] out[]);
+
   // This function encrypts the input plaintext with the PRESENT encryption algorithm.
   //
   // This produces a list of all intermediate values produced after each round of the algorithm,
@@ -76,4 +88,35 @@ package crypto_dpi_present_pkg;
 
   endfunction
 
+  // These functions encrypt or decrypt many blocks with the same key in one go.
+  function automatic void sv_dpi_present_encrypt_batch(
+    input bit [DataWidth-1:0]   plaintext[],
+    input bit [MaxKeyWidth-1:0] key,
+    input int unsigned          key_size,
+    input int unsigned          num_rounds,
+    output bit [DataWidth-1:0]  ciphertext[]
+  );
+
+    chandle h = c_dpi_present_mk(key_size, key);
+    ciphertext = new[plaintext.size()];
+    c_dpi_present_encrypt_batch(h, num_rounds, plaintext, ciphertext);
+    c_dpi_present_free(h);
+
+  endfunction
+
+  function automatic void sv_dpi_present_decrypt_batch(
+    input bit [DataWidth-1:0]   ciphertext[],
+    input bit [MaxKeyWidth-1:0] key,
+    input int unsigned          key_size,
+    input int unsigned          num_rounds,
+    output bit [DataWidth-1:0]  plaintext[]
+  );
+
+    chandle h = c_dpi_present_mk(key_size, key);
+    plaintext = new[ciphertext.size()];
+    c_dpi_present_decrypt_batch(h, num_rounds, ciphertext, plaintext);
+    c_dpi_present_free(h);
+
+  endfunction
+
 endpackage
@@ -10,6 +10,7 @@ extern "C" {
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "prince_bitslice.h"
 #include "prince_ref.h"
 #include "svdpi.h"
 
@@ -28,6 +29,67 @@ extern uint64_t c_dpi_prince_decrypt(const uint64_t ciphertext,
                                old_key_schedule);
 }
 
+static const prince_bitslice_t *get_prince_bitslice(void) {
+  static prince_bitslice_t bs;
+  static int initialized = 0;
+  if (!initialized) {
+    prince_bitslice_init(&bs);
+    initialized = 1;
+  }
+  return &bs;
+}
+
+// Encrypt or decrypt every element of data_i into data_o, up to
+// PRINCE_BITSLICE_BLOCKS blocks at a time.
+static void prince_enc_dec_array(const svOpenArrayHandle data_i,
+                                 svOpenArrayHandle data_o, uint64_t key0,
+                                 uint64_t key1, int decrypt,
+                                 int num_half_rounds, int old_key_schedule) {
+  const int len = svSize(data_i, 1);
+  if (svSize(data_o, 1) != len) {
+    printf("ERROR: PRINCE input and output arrays differ in size (%d vs %d)\n",
+           len, svSize(data_o, 1));
+    return;
+  }
+
+  const int low_i = svLow(data_i, 1);
+  const int low_o = svLow(data_o, 1);
+  uint64_t blocks[PRINCE_BITSLICE_BLOCKS];
+  for (int base = 0; base < len; base += PRINCE_BITSLICE_BLOCKS) {
+    int num_blocks = len - base;
+    if (num_blocks > PRINCE_BITSLICE_BLOCKS)
+      num_blocks = PRINCE_BITSLICE_BLOCKS;
+
+    for (int i = 0; i < num_blocks; i++)
+      blocks[i] = *(const uint64_t *)svGetArrElemPtr1(data_i, low_i + base + i);
+
+    prince_enc_dec_uint64_bitslice(get_prince_bitslice(), blocks, blocks,
+                                   num_blocks, key0, key1, decrypt,
+                                   num_half_rounds, old_key_schedule);
+
+    for (int i = 0; i < num_blocks; i++)
+      *(uint64_t *)svGetArrElemPtr1(data_o, low_o + base + i) = blocks[i];
+  }
+}
+
+extern void c_dpi_prince_encrypt_batch(const svOpenArrayHandle plaintext,
+                                       svOpenArrayHandle ciphertext,
+                                       uint64_t key0, uint64_t key1,
+                                       int num_half_rounds,
+                                       int old_key_schedule) {
+  prince_enc_dec_array(plaintext, ciphertext, key0, key1, 0, num_half_rounds,
+                       old_key_schedule);
+}
+
+extern void c_dpi_prince_decrypt_batch(const svOpenArrayHandle ciphertext,
+                                       svOpenArrayHandle plaintext,
+                                       uint64_t key0, uint64_t key1,
+                                       int num_half_rounds,
+                                       int old_key_schedule) {
+  prince_enc_dec_array(ciphertext, plaintext, key0, key1, 1, num_half_rounds,
+                       old_key_schedule);
+}
+
 #ifdef _cplusplus
 }
 #endif
@@ -27,6 +27,26 @@ package crypto_dpi_prince_pkg;
     input int unsigned      new_key_schedule
   );
 
+  // Batched versions of the above, which encrypt or decrypt every element of an array with the
+  // same key. These are much faster per block than calling c_dpi_prince_encrypt in a loop.
+  import "DPI-C" context function void c_dpi_prince_encrypt_batch(
+    input  longint unsigned data[],
+    output longint unsigned data_out[],
+    input  longint unsigned key0,
+    input  longint unsigned key1,
+    input  int unsigned     num_half_rounds,
+    input  int unsigned     old_key_schedule
+  );
+
+  import "DPI-C" context function void c_dpi_prince_decrypt_batch(
+    input  longint unsigned data[],
+    output longint unsigned data_out[],
+    input  longint unsigned key0,
+    input  longint unsigned key1,
+    input  int unsigned     num_half_rounds,
+    input  int unsigned     old_key_schedule
+  );
+
   //////////////////////////////////////////////////////
   // SV wrapper functions to be used by the testbench //
   //////////////////////////////////////////////////////
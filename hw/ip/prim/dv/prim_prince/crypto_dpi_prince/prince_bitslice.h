@@ -0,0 +1,219 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_IP_PRIM_DV_PRIM_PRINCE_CRYPTO_DPI_PRINCE_PRINCE_BITSLICE_H_
+#define OPENTITAN_HW_IP_PRIM_DV_PRIM_PRINCE_CRYPTO_DPI_PRINCE_PRINCE_BITSLICE_H_
+
+/*
+ * Bitsliced implementation of the PRINCE block cipher, encrypting or
+ * decrypting up to 64 independent blocks with the same key at once.
+ *
+ * The blocks are transposed so that word b of the state holds bit b of every
+ * block. The S layers are then evaluated with logic operations on whole words
+ * and the linear layers become XORs of words. The linear layers are derived
+ * from the functions in prince_ref.h when the context is initialized.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "prince_ref.h"
+
+#define PRINCE_BITSLICE_BLOCKS 64
+
+typedef struct prince_bitslice {
+  // For each output bit of the M, M' and M^-1 layers, the three input bits
+  // that are XORed to give it. (Each output bit of M' is the XOR of three
+  // input bits and M and M^-1 only add a permutation.)
+  uint8_t m[64][3];
+  uint8_t m_prime[64][3];
+  uint8_t m_inv[64][3];
+} prince_bitslice_t;
+
+static inline void prince_bitslice_linear_terms(uint64_t (*layer)(uint64_t),
+                                                uint8_t terms[64][3]) {
+  unsigned int num_terms[64] = {0};
+  for (unsigned int i = 0; i < 64; i++) {
+    const uint64_t col = layer((uint64_t)1 << i);
+    for (unsigned int o = 0; o < 64; o++) {
+      if ((col >> o) & 1) {
+        assert(num_terms[o] < 3);
+        terms[o][num_terms[o]++] = i;
+      }
+    }
+  }
+  for (unsigned int o = 0; o < 64; o++)
+    assert(num_terms[o] == 3);
+}
+
+static inline uint64_t prince_bitslice_m(uint64_t x) {
+  return prince_m_layer(x);
+}
+
+static inline uint64_t prince_bitslice_m_prime(uint64_t x) {
+  return prince_m_prime_layer(x);
+}
+
+static inline uint64_t prince_bitslice_m_inv(uint64_t x) {
+  return prince_m_inv_layer(x);
+}
+
+/**
+ * Initialize a bitslicing context. This only depends on the cipher, not on
+ * the key, so a context can be set up once and shared.
+ */
+static inline void prince_bitslice_init(prince_bitslice_t *bs) {
+  prince_bitslice_linear_terms(prince_bitslice_m, bs->m);
+  prince_bitslice_linear_terms(prince_bitslice_m_prime, bs->m_prime);
+  prince_bitslice_linear_terms(prince_bitslice_m_inv, bs->m_inv);
+}
+
+/**
+ * Transpose a 64x64 bit matrix in place: afterwards, bit j of a[i] is what
+ * was bit i of a[j].
+ */
+static inline void prince_bitslice_transpose(uint64_t a[64]) {
+  uint64_t mask = 0x00000000FFFFFFFF;
+  for (unsigned int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+    for (unsigned int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+      const uint64_t t = ((a[k] >> j) ^ a[k | j]) & mask;
+      a[k] ^= t << j;
+      a[k | j] ^= t;
+    }
+  }
+}
+
+/**
+ * XOR a constant onto every block of the state.
+ */
+static inline void prince_bitslice_add_const(uint64_t s[64], uint64_t k) {
+  for (unsigned int b = 0; b < 64; b++)
+    s[b] ^= (uint64_t)0 - ((k >> b) & 1);
+}
+
+/**
+ * Compute the products of the four bits of a nibble. Bit i of the index gives
+ * whether x[i] is included, and m[0] is all ones. (The product of all four
+ * bits doesn't appear in either S-box.)
+ */
+static inline void prince_bitslice_products(const uint64_t x[4],
+                                            uint64_t m[15]) {
+  m[0] = ~(uint64_t)0;
+  m[1] = x[0];
+  m[2] = x[1];
+  m[3] = x[0] & x[1];
+  m[4] = x[2];
+  m[5] = x[0] & x[2];
+  m[6] = x[1] & x[2];
+  m[7] = m[3] & x[2];
+  m[8] = x[3];
+  m[9] = x[0] & x[3];
+  m[10] = x[1] & x[3];
+  m[11] = m[3] & x[3];
+  m[12] = x[2] & x[3];
+  m[13] = m[5] & x[3];
+  m[14] = m[6] & x[3];
+}
+
+/**
+ * The S step, using the algebraic normal form of prince_sbox().
+ */
+static inline void prince_bitslice_s_layer(uint64_t s[64]) {
+  for (unsigned int n = 0; n < 64; n += 4) {
+    uint64_t m[15];
+    prince_bitslice_products(&s[n], m);
+    s[n + 0] = m[0] ^ m[3] ^ m[4] ^ m[6] ^ m[7] ^ m[8] ^ m[9] ^ m[12];
+    s[n + 1] = m[0] ^ m[5] ^ m[6] ^ m[7] ^ m[10] ^ m[14];
+    s[n + 2] = m[1] ^ m[3] ^ m[8] ^ m[9] ^ m[10] ^ m[11] ^ m[14];
+    s[n + 3] = m[0] ^ m[2] ^ m[6] ^ m[7] ^ m[8] ^ m[11] ^ m[12] ^ m[13];
+  }
+}
+
+/**
+ * The S^-1 step, using the algebraic normal form of prince_sbox_inv().
+ */
+static inline void prince_bitslice_s_inv_layer(uint64_t s[64]) {
+  for (unsigned int n = 0; n < 64; n += 4) {
+    uint64_t m[15];
+    prince_bitslice_products(&s[n], m);
+    s[n + 0] = m[0] ^ m[3] ^ m[6] ^ m[8] ^ m[11] ^ m[12] ^ m[13];
+    s[n + 1] = m[0] ^ m[5] ^ m[6] ^ m[7] ^ m[10] ^ m[12];
+    s[n + 2] = m[1] ^ m[3] ^ m[4] ^ m[5] ^ m[6] ^ m[7] ^ m[10] ^ m[11];
+    s[n + 3] =
+        m[0] ^ m[1] ^ m[2] ^ m[3] ^ m[5] ^ m[6] ^ m[7] ^ m[12] ^ m[13] ^ m[14];
+  }
+}
+
+/**
+ * Apply one of the linear layers, given its terms.
+ */
+static inline void prince_bitslice_linear(const uint8_t terms[64][3],
+                                          uint64_t s[64]) {
+  uint64_t out[64];
+  for (unsigned int o = 0; o < 64; o++)
+    out[o] = s[terms[o][0]] ^ s[terms[o][1]] ^ s[terms[o][2]];
+  for (unsigned int o = 0; o < 64; o++)
+    s[o] = out[o];
+}
+
+/**
+ * Bitsliced version of prince_core().
+ */
+static inline void prince_bitslice_core(const prince_bitslice_t *bs,
+                                        uint64_t s[64], const uint64_t k0_new,
+                                        const uint64_t k1,
+                                        int num_half_rounds) {
+  prince_bitslice_add_const(s, k1 ^ prince_round_constant(0));
+  for (int round = 1; round <= num_half_rounds; round++) {
+    prince_bitslice_s_layer(s);
+    prince_bitslice_linear(bs->m, s);
+    prince_bitslice_add_const(s, ((round % 2 == 1) ? k0_new : k1) ^
+                                     prince_round_constant(round));
+  }
+  prince_bitslice_s_layer(s);
+  prince_bitslice_linear(bs->m_prime, s);
+  prince_bitslice_s_inv_layer(s);
+  for (int round = 1; round <= num_half_rounds; round++) {
+    const unsigned int constant_idx = 10 - num_half_rounds + round;
+    prince_bitslice_add_const(
+        s, (((num_half_rounds + round + 1) % 2 == 1) ? k0_new : k1) ^
+               prince_round_constant(constant_idx));
+    prince_bitslice_linear(bs->m_inv, s);
+    prince_bitslice_s_inv_layer(s);
+  }
+  prince_bitslice_add_const(s, k1 ^ prince_round_constant(11));
+}
+
+/**
+ * Bitsliced version of prince_enc_dec_uint64(), for num_blocks (at most
+ * PRINCE_BITSLICE_BLOCKS) blocks with the same key and parameters. input and
+ * output may be the same array.
+ */
+static inline void prince_enc_dec_uint64_bitslice(
+    const prince_bitslice_t *bs, const uint64_t *input, uint64_t *output,
+    unsigned int num_blocks, const uint64_t enc_k0, const uint64_t enc_k1,
+    int decrypt, int num_half_rounds, int old_key_schedule) {
+  const uint64_t prince_alpha = 0xc0ac29b7c97c50dd;
+  const uint64_t k1 = enc_k1 ^ (decrypt ? prince_alpha : 0);
+  const uint64_t k0_new =
+      (old_key_schedule) ? k1 : enc_k0 ^ (decrypt ? prince_alpha : 0);
+  const uint64_t enc_k0_prime = prince_k0_to_k0_prime(enc_k0);
+  const uint64_t k0 = decrypt ? enc_k0_prime : enc_k0;
+  const uint64_t k0_prime = decrypt ? enc_k0 : enc_k0_prime;
+
+  uint64_t s[64];
+  for (unsigned int i = 0; i < 64; i++)
+    s[i] = (i < num_blocks) ? input[i] : 0;
+  prince_bitslice_transpose(s);
+
+  prince_bitslice_add_const(s, k0);
+  prince_bitslice_core(bs, s, k0_new, k1, num_half_rounds);
+  prince_bitslice_add_const(s, k0_prime);
+
+  prince_bitslice_transpose(s);
+  for (unsigned int i = 0; i < num_blocks; i++)
+    output[i] = s[i];
+}
+
+#endif  // OPENTITAN_HW_IP_PRIM_DV_PRIM_PRINCE_CRYPTO_DPI_PRINCE_PRINCE_BITSLICE_H_
@@ -9,8 +9,10 @@
 #include <functional>
 #include <iostream>
 #include <stdint.h>
+#include <thread>
 #include <vector>
 
+#include "prince_bitslice.h"
 #include "prince_ref.h"
 
 uint8_t PRESENT_SBOX4[] = {0xc, 0x5, 0x6, 0xb, 0x9, 0x0, 0xa, 0xd,
@@ -364,3 +366,298 @@ std::vector<uint8_t> scramble_decrypt_data(
     return xor_vectors(data_in, keystream);
   }
 }
+
+namespace {
+// Lookup tables for PRINCE, derived from the reference implementation in
+// prince_ref.h. The S and M layers work nibble-wise and the M, M' and M^-1
+// layers are linear, so a layer applied to a 64-bit state is the XOR of the
+// layer applied to each byte of the state in place.
+struct PrinceTables {
+  // M(S(x)) for x = v << (8 * i)
+  uint64_t sm[8][256];
+  // M'(S(x)) for x = v << (8 * i)
+  uint64_t smp[8][256];
+  // M^-1(x) for x = v << (8 * i)
+  uint64_t m_inv[8][256];
+  // S^-1 applied to both nibbles of a byte
+  uint8_t s_inv[256];
+  // Round constants
+  uint64_t rc[12];
+
+  PrinceTables() {
+    for (uint32_t v = 0; v < 256; ++v) {
+      uint64_t s_byte = prince_s_layer(v) & 0xff;
+      s_inv[v] = prince_s_inv_layer(v) & 0xff;
+      for (uint32_t i = 0; i < 8; ++i) {
+        sm[i][v] = prince_m_layer(s_byte << (8 * i));
+        smp[i][v] = prince_m_prime_layer(s_byte << (8 * i));
+        m_inv[i][v] = prince_m_inv_layer((uint64_t)v << (8 * i));
+      }
+    }
+    for (uint32_t i = 0; i < 12; ++i) {
+      rc[i] = prince_round_constant(i);
+    }
+  }
+
+  static uint64_t Apply(const uint64_t table[8][256], uint64_t x) {
+    uint64_t out = 0;
+    for (uint32_t i = 0; i < 8; ++i) {
+      out ^= table[i][(x >> (8 * i)) & 0xff];
+    }
+    return out;
+  }
+
+  uint64_t ApplySInv(uint64_t x) const {
+    uint64_t out = 0;
+    for (uint32_t i = 0; i < 8; ++i) {
+      out |= (uint64_t)s_inv[(x >> (8 * i)) & 0xff] << (8 * i);
+    }
+    return out;
+  }
+};
+
+const PrinceTables &GetPrinceTables() {
+  static const PrinceTables tables;
+  return tables;
+}
+
+// PRINCE encryption with the new key schedule. This matches
+// prince_enc_dec_uint64(input, k0, k1, 0, num_half_rounds, 0).
+uint64_t fast_prince_enc(uint64_t input, uint64_t k0, uint64_t k0_prime,
+                         uint64_t k1, uint32_t num_half_rounds) {
+  const PrinceTables &t = GetPrinceTables();
+
+  uint64_t state = input ^ k0 ^ k1 ^ t.rc[0];
+  for (uint32_t round = 1; round <= num_half_rounds; ++round) {
+    state = PrinceTables::Apply(t.sm, state) ^ ((round % 2) ? k0 : k1) ^
+            t.rc[round];
+  }
+
+  state = t.ApplySInv(PrinceTables::Apply(t.smp, state));
+
+  for (uint32_t round = 1; round <= num_half_rounds; ++round) {
+    uint32_t constant_idx = 10 - num_half_rounds + round;
+    state ^= (((num_half_rounds + round + 1) % 2) ? k0 : k1) ^
+             t.rc[constant_idx];
+    state = t.ApplySInv(PrinceTables::Apply(t.m_inv, state));
+  }
+
+  return state ^ k1 ^ t.rc[11] ^ k0_prime;
+}
+
+const prince_bitslice_t &GetPrinceBitslice() {
+  static const prince_bitslice_t bs = [] {
+    prince_bitslice_t init;
+    prince_bitslice_init(&init);
+    return init;
+  }();
+  return bs;
+}
+
+// Read count (<= 64) bits from a little-endian byte vector, starting at
+// bit_pos.
+uint64_t read_vector_bits(const std::vector<uint8_t> &vec, uint32_t bit_pos,
+                          uint32_t count) {
+  assert(count <= 64);
+
+  uint64_t bits = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    bits |= (uint64_t)read_vector_bit(vec, bit_pos + i) << i;
+  }
+  return bits;
+}
+
+uint64_t bytes_to_uint64_le(const uint8_t *bytes) {
+  uint64_t out = 0;
+  for (int i = 7; i >= 0; --i) {
+    out = (out << 8) | bytes[i];
+  }
+  return out;
+}
+}  // namespace
+
+ScrambleEngine::ScrambleEngine(uint32_t data_width, uint32_t addr_width,
+                               bool repeat_keystream)
+    : data_width_(data_width), addr_width_(addr_width), valid_(false) {
+  assert(0 < data_width && data_width <= kMaxDataWidth);
+  assert(0 < addr_width && addr_width < 32);
+
+  uint32_t num_blocks = (data_width + kPrinceWidth - 1) / kPrinceWidth;
+  num_princes_ = repeat_keystream ? 1 : num_blocks;
+  num_repetitions_ = repeat_keystream ? num_blocks : 1;
+
+  // The flip layer reverses the bottom addr_width bits. The (non-inverted)
+  // perm layer then puts even bits in the lower half and odd bits in the upper
+  // half, leaving a final odd bit in place.
+  uint32_t half = addr_width / 2;
+  uint8_t perm_src[32];
+  for (uint32_t i = 0; i < half; ++i) {
+    perm_src[i] = i * 2;
+    perm_src[i + half] = i * 2 + 1;
+  }
+  if (addr_width % 2) {
+    perm_src[addr_width - 1] = addr_width - 1;
+  }
+  for (uint32_t i = 0; i < addr_width; ++i) {
+    addr_perm_[i] = addr_width - 1 - perm_src[i];
+  }
+}
+
+void ScrambleEngine::SetKeyNonce(const std::vector<uint8_t> &key,
+                                 const std::vector<uint8_t> &nonce) {
+  assert(key.size() == kPrinceWidthByte * 2);
+  assert(nonce.size() == GetNonceWidthByte());
+
+  key_ = key;
+  nonce_ = nonce;
+
+  // The reference model byte-reverses the key before passing it to PRINCE,
+  // which takes K0 from the first 8 bytes and K1 from the next 8.
+  k0_ = bytes_to_uint64_le(&key[kPrinceWidthByte]);
+  k1_ = bytes_to_uint64_le(&key[0]);
+  k0_prime_ = prince_k0_to_k0_prime(k0_);
+
+  uint32_t nonce_bits_per_prince = kPrinceWidth - addr_width_;
+  for (uint32_t i = 0; i < num_princes_; ++i) {
+    iv_nonce_[i] = read_vector_bits(nonce, i * nonce_bits_per_prince,
+                                    nonce_bits_per_prince)
+                   << addr_width_;
+  }
+
+  addr_key_ = read_vector_bits(nonce, GetNonceWidth() - addr_width_,
+                               addr_width_);
+  valid_ = true;
+}
+
+uint32_t ScrambleEngine::ScrambleAddr(uint32_t addr) const {
+  assert(valid_);
+
+  uint32_t mask = (1u << addr_width_) - 1;
+  uint32_t full_nibbles = addr_width_ / 4;
+  uint32_t state = addr & mask;
+
+  for (uint32_t round = 0; round < kNumAddrSubstPermRounds; ++round) {
+    state ^= addr_key_;
+
+    // Nibbles above full_nibbles are passed through unchanged
+    uint32_t subst = state;
+    for (uint32_t i = 0; i < full_nibbles; ++i) {
+      subst &= ~(0xfu << (4 * i));
+      subst |= (uint32_t)PRESENT_SBOX4[(state >> (4 * i)) & 0xf] << (4 * i);
+    }
+
+    state = 0;
+    for (uint32_t i = 0; i < addr_width_; ++i) {
+      state |= ((subst >> addr_perm_[i]) & 1) << i;
+    }
+  }
+
+  return (state ^ addr_key_) & mask;
+}
+
+void ScrambleEngine::GenKeystream(uint32_t addr, uint8_t *keystream) const {
+  assert(valid_);
+
+  uint64_t addr_bits = addr & ((1u << addr_width_) - 1);
+  uint64_t blocks[kMaxDataWidth / kPrinceWidth];
+  for (uint32_t i = 0; i < num_princes_; ++i) {
+    blocks[i] = fast_prince_enc(iv_nonce_[i] | addr_bits, k0_, k0_prime_, k1_,
+                                kNumPrinceHalfRounds);
+  }
+  PackKeystream(blocks, 1, keystream);
+}
+
+void ScrambleEngine::GenKeystreams(uint32_t first_addr, uint32_t num_addrs,
+                                   uint8_t *keystreams) const {
+  assert(valid_);
+
+  const prince_bitslice_t &bs = GetPrinceBitslice();
+  uint32_t addr_mask = (1u << addr_width_) - 1;
+  uint32_t ks_bytes = GetDataWidthByte();
+
+  // blocks[i * kBatch + j] is the output of PRINCE instance i for word j of
+  // the batch.
+  const uint32_t kBatch = PRINCE_BITSLICE_BLOCKS;
+  uint64_t blocks[kMaxDataWidth / kPrinceWidth * PRINCE_BITSLICE_BLOCKS];
+
+  for (uint32_t base = 0; base < num_addrs; base += kBatch) {
+    uint32_t batch = std::min(kBatch, num_addrs - base);
+    for (uint32_t i = 0; i < num_princes_; ++i) {
+      uint64_t *out = &blocks[i * kBatch];
+      for (uint32_t j = 0; j < batch; ++j) {
+        out[j] = iv_nonce_[i] | ((first_addr + base + j) & addr_mask);
+      }
+      prince_enc_dec_uint64_bitslice(&bs, out, out, batch, k0_, k1_, 0,
+                                     kNumPrinceHalfRounds, 0);
+    }
+    for (uint32_t j = 0; j < batch; ++j) {
+      PackKeystream(&blocks[j], kBatch, keystreams + (base + j) * ks_bytes);
+    }
+  }
+}
+
+void ScrambleEngine::PackKeystream(const uint64_t *blocks, uint32_t stride,
+                                   uint8_t *keystream) const {
+  uint32_t keystream_bytes = GetDataWidthByte();
+  uint32_t pos = 0;
+
+  for (uint32_t i = 0; i < num_princes_ && pos < keystream_bytes; ++i) {
+    uint64_t block = blocks[i * stride];
+    for (uint32_t k = 0; k < num_repetitions_ && pos < keystream_bytes; ++k) {
+      for (uint32_t j = 0; j < kPrinceWidthByte && pos < keystream_bytes;
+           ++j) {
+        keystream[pos++] = (block >> (8 * j)) & 0xff;
+      }
+    }
+  }
+
+  if (data_width_ % 8) {
+    keystream[keystream_bytes - 1] &= (1 << (data_width_ % 8)) - 1;
+  }
+}
+
+void ScrambleEngine::CryptData(uint8_t *data, uint32_t addr) const {
+  uint8_t keystream[kMaxDataWidthByte];
+  GenKeystream(addr, keystream);
+  for (uint32_t i = 0; i < GetDataWidthByte(); ++i) {
+    data[i] ^= keystream[i];
+  }
+}
+
+void ScrambleEngine::GenTable(uint32_t first_addr, uint32_t num_addrs,
+                              uint32_t *phys_addrs, uint8_t *keystreams,
+                              uint32_t num_threads) const {
+  assert(valid_);
+
+  // Don't bother spawning a thread for fewer than this many words
+  const uint32_t kMinWordsPerThread = 1024;
+
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min(
+      num_threads, std::max(1u, num_addrs / kMinWordsPerThread));
+
+  uint32_t ks_bytes = GetDataWidthByte();
+  auto gen_chunk = [=](uint32_t start, uint32_t end) {
+    for (uint32_t i = start; i < end; ++i) {
+      phys_addrs[i] = ScrambleAddr(first_addr + i);
+    }
+    if (start < end) {
+      GenKeystreams(first_addr + start, end - start,
+                    keystreams + start * ks_bytes);
+    }
+  };
+
+  // Split the range into equal chunks, running the last one on this thread.
+  uint32_t chunk = (num_addrs + num_threads - 1) / num_threads;
+  std::vector<std::thread> workers;
+  for (uint32_t t = 0; t + 1 < num_threads; ++t) {
+    workers.emplace_back(gen_chunk, t * chunk, (t + 1) * chunk);
+  }
+  gen_chunk((num_threads - 1) * chunk, num_addrs);
+
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+}
@@ -76,4 +76,114 @@ std::vector<uint8_t> scramble_encrypt_data(
     uint32_t addr_width, const std::vector<uint8_t> &nonce,
     const std::vector<uint8_t> &key, bool repeat_keystream, bool use_sp_layer);
 
+/**
+ * A fast, allocation-free model of memory scrambling for a fixed memory
+ * configuration.
+ *
+ * This computes the same results as scramble_addr, scramble_encrypt_data and
+ * scramble_decrypt_data (with use_sp_layer false, which matches the hardware),
+ * but works on fixed-width integers and buffers supplied by the caller. PRINCE
+ * rounds are evaluated with precomputed tables that combine the S-box and
+ * linear layers (or, for ranges of words, with a bitsliced implementation),
+ * and the key and nonce are unpacked once in SetKeyNonce rather than on every
+ * call.
+ */
+class ScrambleEngine {
+ public:
+  /** The maximum data width (in bits) supported by the engine */
+  static const uint32_t kMaxDataWidth = 320;
+  static const uint32_t kMaxDataWidthByte = kMaxDataWidth / 8;
+
+  /** Constructor
+   *
+   * @param data_width       Width of data in bits (at most kMaxDataWidth)
+   * @param addr_width       Width of the address in bits (less than 32)
+   * @param repeat_keystream Repeat the keystream of one single PRINCE instance
+   *                         if set to true. Otherwise multiple PRINCE
+   *                         instances are used.
+   */
+  ScrambleEngine(uint32_t data_width, uint32_t addr_width,
+                 bool repeat_keystream);
+
+  /** Set the scrambling key and nonce
+   *
+   * @param key   Byte vector of scrambling key (2 * kPrinceWidthByte bytes)
+   * @param nonce Byte vector of scrambling nonce (GetNonceWidthByte() bytes)
+   */
+  void SetKeyNonce(const std::vector<uint8_t> &key,
+                   const std::vector<uint8_t> &nonce);
+
+  /** Return true if SetKeyNonce has been called with this key and nonce */
+  bool HasKeyNonce(const std::vector<uint8_t> &key,
+                   const std::vector<uint8_t> &nonce) const {
+    return valid_ && key == key_ && nonce == nonce_;
+  }
+
+  /** Scramble a logical address to give the physical address */
+  uint32_t ScrambleAddr(uint32_t addr) const;
+
+  /** Generate the keystream for the word at the given logical address
+   *
+   * Writes GetDataWidthByte() bytes to \p keystream, with unused bits at the
+   * top of the final byte cleared.
+   */
+  void GenKeystream(uint32_t addr, uint8_t *keystream) const;
+
+  /** Generate the keystreams for a range of words
+   *
+   * This gives the same result as calling GenKeystream for each address from
+   * \p first_addr to \p first_addr + \p num_addrs - 1, writing
+   * GetDataWidthByte() bytes per word to \p keystreams. It runs PRINCE on
+   * many words at once with the bitsliced implementation in
+   * prince_bitslice.h, so is much faster per word.
+   */
+  void GenKeystreams(uint32_t first_addr, uint32_t num_addrs,
+                     uint8_t *keystreams) const;
+
+  /** Encrypt or decrypt the word at \p data in place
+   *
+   * Without the S&P layer, encryption and decryption both XOR the data with
+   * the keystream for \p addr. \p data must hold GetDataWidthByte() bytes.
+   */
+  void CryptData(uint8_t *data, uint32_t addr) const;
+
+  /** Precompute physical addresses and keystreams for a range of words
+   *
+   * For each i < num_addrs, this writes ScrambleAddr(first_addr + i) to
+   * phys_addrs[i] and the keystream for the word to the GetDataWidthByte()
+   * bytes at keystreams + i * GetDataWidthByte(). Words are independent, so
+   * the range is split between up to num_threads worker threads (if
+   * num_threads is zero, this picks a number based on the host).
+   */
+  void GenTable(uint32_t first_addr, uint32_t num_addrs, uint32_t *phys_addrs,
+                uint8_t *keystreams, uint32_t num_threads = 0) const;
+
+  uint32_t GetDataWidthByte() const { return (data_width_ + 7) / 8; }
+  uint32_t GetNonceWidth() const { return num_princes_ * kPrinceWidth; }
+  uint32_t GetNonceWidthByte() const { return num_princes_ * kPrinceWidthByte; }
+
+ private:
+  // Write the keystream for a word, given the PRINCE outputs for it at
+  // blocks[0], blocks[stride], ...
+  void PackKeystream(const uint64_t *blocks, uint32_t stride,
+                     uint8_t *keystream) const;
+
+  uint32_t data_width_;
+  uint32_t addr_width_;
+  uint32_t num_princes_;
+  uint32_t num_repetitions_;
+
+  bool valid_;
+  std::vector<uint8_t> key_, nonce_;
+
+  // Unpacked key material for PRINCE
+  uint64_t k0_, k0_prime_, k1_;
+  // Top bits of the PRINCE input for each instance, taken from the nonce
+  uint64_t iv_nonce_[kMaxDataWidth / kPrinceWidth];
+  // Key used for the address substitution/permutation network
+  uint32_t addr_key_;
+  // Source bit index for each output bit of the address flip/perm layer
+  uint8_t addr_perm_[32];
+};
+
 #endif  // OPENTITAN_HW_IP_PRIM_DV_PRIM_RAM_SCR_CPP_SCRAMBLE_MODEL_H_
@@ -0,0 +1,157 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "scramble_model.h"
+
+namespace scramble_model_test {
+namespace {
+
+struct Config {
+  uint32_t data_width;
+  uint32_t addr_width;
+  bool repeat_keystream;
+};
+
+// Configurations matching the scrambled memories in Earl Grey and OTBN
+const Config kConfigs[] = {
+    // ram_main
+    {39, 15, true},
+    // rom
+    {39, 13, true},
+    // otbn imem
+    {39, 12, true},
+    // otbn dmem
+    {312, 7, false},
+};
+
+constexpr uint32_t kNumWords = 2000;
+
+std::vector<uint8_t> AddrToBytes(uint32_t addr, uint32_t addr_width) {
+  std::vector<uint8_t> bytes((addr_width + 7) / 8);
+  for (uint8_t &byte : bytes) {
+    byte = addr & 0xff;
+    addr >>= 8;
+  }
+  return bytes;
+}
+
+uint32_t BytesToAddr(const std::vector<uint8_t> &bytes) {
+  uint32_t addr = 0;
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    addr |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+  }
+  return addr;
+}
+
+// Checks ScrambleEngine against the reference functions in scramble_model.h
+class ScrambleEngineTest : public testing::TestWithParam<Config> {
+ protected:
+  ScrambleEngineTest()
+      : engine_(GetParam().data_width, GetParam().addr_width,
+                GetParam().repeat_keystream),
+        key_(2 * kPrinceWidthByte),
+        nonce_(engine_.GetNonceWidthByte()) {
+    for (uint8_t &byte : key_) {
+      byte = rng_();
+    }
+    for (uint8_t &byte : nonce_) {
+      byte = rng_();
+    }
+    engine_.SetKeyNonce(key_, nonce_);
+  }
+
+  std::vector<uint8_t> RandomWord() {
+    std::vector<uint8_t> word(engine_.GetDataWidthByte());
+    for (uint8_t &byte : word) {
+      byte = rng_();
+    }
+    if (GetParam().data_width % 8) {
+      word.back() &= (1 << (GetParam().data_width % 8)) - 1;
+    }
+    return word;
+  }
+
+  uint32_t RefScrambleAddr(uint32_t addr) {
+    return BytesToAddr(scramble_addr(AddrToBytes(addr, GetParam().addr_width),
+                                     GetParam().addr_width, nonce_,
+                                     engine_.GetNonceWidth()));
+  }
+
+  std::vector<uint8_t> RefEncrypt(const std::vector<uint8_t> &data,
+                                  uint32_t addr) {
+    const Config &cfg = GetParam();
+    return scramble_encrypt_data(data, cfg.data_width, 39,
+                                 AddrToBytes(addr, cfg.addr_width),
+                                 cfg.addr_width, nonce_, key_,
+                                 cfg.repeat_keystream, false);
+  }
+
+  std::vector<uint8_t> RefDecrypt(const std::vector<uint8_t> &data,
+                                  uint32_t addr) {
+    const Config &cfg = GetParam();
+    return scramble_decrypt_data(data, cfg.data_width, 39,
+                                 AddrToBytes(addr, cfg.addr_width),
+                                 cfg.addr_width, nonce_, key_,
+                                 cfg.repeat_keystream, false);
+  }
+
+  uint32_t AddrMask() const { return (1u << GetParam().addr_width) - 1; }
+
+  std::mt19937 rng_{1};
+  ScrambleEngine engine_;
+  std::vector<uint8_t> key_;
+  std::vector<uint8_t> nonce_;
+};
+
+TEST_P(ScrambleEngineTest, ScrambleAddr) {
+  for (uint32_t i = 0; i < kNumWords; ++i) {
+    uint32_t addr = i & AddrMask();
+    EXPECT_EQ(engine_.ScrambleAddr(addr), RefScrambleAddr(addr))
+        << "addr " << addr;
+  }
+}
+
+TEST_P(ScrambleEngineTest, CryptData) {
+  for (uint32_t i = 0; i < kNumWords; ++i) {
+    uint32_t addr = i & AddrMask();
+    std::vector<uint8_t> word = RandomWord();
+    std::vector<uint8_t> enc(word);
+    engine_.CryptData(enc.data(), addr);
+    EXPECT_EQ(enc, RefEncrypt(word, addr)) << "addr " << addr;
+    EXPECT_EQ(RefDecrypt(enc, addr), word) << "addr " << addr;
+  }
+}
+
+TEST_P(ScrambleEngineTest, GenTable) {
+  const uint32_t data_bytes = engine_.GetDataWidthByte();
+  const uint32_t num_addrs = std::min(kNumWords, AddrMask() + 1);
+  for (uint32_t num_threads : {1u, 4u}) {
+    std::vector<uint32_t> phys_addrs(num_addrs);
+    std::vector<uint8_t> keystreams(num_addrs * data_bytes);
+    engine_.GenTable(0, num_addrs, phys_addrs.data(), keystreams.data(),
+                     num_threads);
+    for (uint32_t addr = 0; addr < num_addrs; ++addr) {
+      std::vector<uint8_t> word = RandomWord();
+      std::vector<uint8_t> enc(word);
+      for (uint32_t j = 0; j < data_bytes; ++j) {
+        enc[j] ^= keystreams[addr * data_bytes + j];
+      }
+      EXPECT_EQ(phys_addrs[addr], RefScrambleAddr(addr))
+          << "addr " << addr << ", " << num_threads << " threads";
+      EXPECT_EQ(enc, RefEncrypt(word, addr))
+          << "addr " << addr << ", " << num_threads << " threads";
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Memories, ScrambleEngineTest,
+                         testing::ValuesIn(kConfigs));
+
+}  // namespace
+}  // namespace scramble_model_test
@@ -339,36 +339,114 @@ module rom_ctrl
 
   logic         checker_alert;
 
+`ifdef ROM_CTRL_SIM_DIGEST
+  // Digests precomputed by the Verilator testbench. These are deliberately left undriven here:
+  // chip_sim_tb.sv assigns them hierarchically (see the shortcut in gen_fsm_scramble_enabled).
+  logic         sim_digest_en;
+  logic [255:0] sim_digest, sim_exp_digest;
+`endif
+
   if (!SecDisableScrambling) begin : gen_fsm_scramble_enabled
 
+    logic         fsm_rst_n;
+    logic [255:0] fsm_digest_d;
+    logic         fsm_digest_de;
+    logic [31:0]  fsm_exp_digest_word_d;
+    logic         fsm_exp_digest_de;
+    logic [2:0]   fsm_exp_digest_idx;
+    pwrmgr_data_t fsm_pwrmgr_data;
+    keymgr_data_t fsm_keymgr_data;
+    logic         fsm_kmac_rom_vld, fsm_kmac_rom_last;
+    mubi4_t       fsm_rom_select_bus;
+    logic         fsm_rom_req;
+    logic         fsm_alert;
+
     rom_ctrl_fsm #(
       .RomDepth (RomSizeWords),
       .TopCount (8)
     ) u_checker_fsm (
       .clk_i,
-      .rst_ni,
+      .rst_ni               (fsm_rst_n),
       .digest_i             (digest_q),
       .exp_digest_i         (exp_digest_q),
-      .digest_o             (digest_d),
-      .digest_vld_o         (digest_de),
-      .exp_digest_o         (exp_digest_word_d),
-      .exp_digest_vld_o     (exp_digest_de),
-      .exp_digest_idx_o     (exp_digest_idx),
-      .pwrmgr_data_o        (pwrmgr_data_o),
-      .keymgr_data_o        (keymgr_data_o),
+      .digest_o             (fsm_digest_d),
+      .digest_vld_o         (fsm_digest_de),
+      .exp_digest_o         (fsm_exp_digest_word_d),
+      .exp_digest_vld_o     (fsm_exp_digest_de),
+      .exp_digest_idx_o     (fsm_exp_digest_idx),
+      .pwrmgr_data_o        (fsm_pwrmgr_data),
+      .keymgr_data_o        (fsm_keymgr_data),
       .kmac_rom_rdy_i       (kmac_rom_rdy),
-      .kmac_rom_vld_o       (kmac_rom_vld),
-      .kmac_rom_last_o      (kmac_rom_last),
+      .kmac_rom_vld_o       (fsm_kmac_rom_vld),
+      .kmac_rom_last_o      (fsm_kmac_rom_last),
       .kmac_done_i          (kmac_done),
       .kmac_digest_i        (kmac_digest),
       .kmac_err_i           (kmac_err),
-      .rom_select_bus_o     (rom_select_bus),
+      .rom_select_bus_o     (fsm_rom_select_bus),
       .rom_addr_o           (checker_rom_index),
-      .rom_req_o            (checker_rom_req),
+      .rom_req_o            (fsm_rom_req),
       .rom_data_i           (checker_rom_rdata[31:0]),
-      .alert_o              (checker_alert)
+      .alert_o              (fsm_alert)
     );
 
+`ifdef ROM_CTRL_SIM_DIGEST
+`ifdef SYNTHESIS
+    // The digest shortcut below must never be synthesized
+    illegal_preprocessor_branch_taken u_illegal_preprocessor_branch_taken();
+`endif
+    // When sim_digest_en is set, the checker FSM is held in reset and the digests computed by the
+    // testbench are loaded into the DIGEST and EXP_DIGEST registers instead, one EXP_DIGEST word
+    // per cycle. The check then completes as if the FSM had read the whole ROM through KMAC.
+    logic [3:0] sim_count_q;
+    logic       sim_done;
+
+    assign sim_done = sim_count_q == 4'd8;
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        sim_count_q <= '0;
+      end else if (sim_digest_en && !sim_done) begin
+        sim_count_q <= sim_count_q + 4'd1;
+      end
+    end
+
+    mubi4_t     sim_done_mubi, sim_good_mubi;
+    assign sim_done_mubi = prim_mubi_pkg::mubi4_bool_to_mubi(sim_done);
+    assign sim_good_mubi = prim_mubi_pkg::mubi4_bool_to_mubi(sim_done &&
+                                                             sim_digest == sim_exp_digest);
+
+    assign fsm_rst_n         = rst_ni & ~sim_digest_en;
+    assign digest_d          = sim_digest_en ? sim_digest : fsm_digest_d;
+    assign digest_de         = sim_digest_en ? sim_count_q == 4'd0 : fsm_digest_de;
+    assign exp_digest_word_d = sim_digest_en ? sim_exp_digest[32*sim_count_q[2:0] +: 32] :
+                                               fsm_exp_digest_word_d;
+    assign exp_digest_de     = sim_digest_en ? !sim_done : fsm_exp_digest_de;
+    assign exp_digest_idx    = sim_digest_en ? sim_count_q[2:0] : fsm_exp_digest_idx;
+    assign pwrmgr_data_o     = sim_digest_en ? '{done: sim_done_mubi, good: sim_good_mubi} :
+                                               fsm_pwrmgr_data;
+    assign keymgr_data_o     = sim_digest_en ? '{data: digest_q, valid: sim_done} :
+                                               fsm_keymgr_data;
+    assign kmac_rom_vld      = sim_digest_en ? 1'b0 : fsm_kmac_rom_vld;
+    assign kmac_rom_last     = sim_digest_en ? 1'b0 : fsm_kmac_rom_last;
+    assign rom_select_bus    = sim_digest_en ? sim_done_mubi : fsm_rom_select_bus;
+    assign checker_rom_req   = sim_digest_en ? 1'b0 : fsm_rom_req;
+    assign checker_alert     = sim_digest_en ? 1'b0 : fsm_alert;
+`else
+    assign fsm_rst_n         = rst_ni;
+    assign digest_d          = fsm_digest_d;
+    assign digest_de         = fsm_digest_de;
+    assign exp_digest_word_d = fsm_exp_digest_word_d;
+    assign exp_digest_de     = fsm_exp_digest_de;
+    assign exp_digest_idx    = fsm_exp_digest_idx;
+    assign pwrmgr_data_o     = fsm_pwrmgr_data;
+    assign keymgr_data_o     = fsm_keymgr_data;
+    assign kmac_rom_vld      = fsm_kmac_rom_vld;
+    assign kmac_rom_last     = fsm_kmac_rom_last;
+    assign rom_select_bus    = fsm_rom_select_bus;
+    assign checker_rom_req   = fsm_rom_req;
+    assign checker_alert     = fsm_alert;
+`endif
+
   end : gen_fsm_scramble_enabled
   else begin : gen_fsm_scramble_disabled
 
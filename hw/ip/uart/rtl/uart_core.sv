@@ -57,8 +57,9 @@ module uart_core (
   logic           tx_fifo_wready, tx_uart_idle;
   logic           tx_out;
   logic           tx_out_q;
-  logic   [7:0]   rx_fifo_data;
+  logic   [7:0]   rx_fifo_data, rx_fifo_wdata;
   logic           rx_valid, rx_fifo_wvalid, rx_fifo_rvalid;
+  logic           tx_fifo_rready_int, rx_fifo_wvalid_int;
   logic           rx_fifo_wready, rx_uart_idle;
   logic           rx_sync;
   logic           rx_in;
@@ -176,7 +177,7 @@ module uart_core (
   // TX Logic //
   //////////////
 
-  assign tx_fifo_rready = tx_uart_idle & tx_fifo_rvalid & tx_enable;
+  assign tx_fifo_rready_int = tx_uart_idle & tx_fifo_rvalid & tx_enable;
 
   prim_fifo_sync #(
     .Width   (8),
@@ -277,7 +278,22 @@ module uart_core (
     .rx_parity_err  (event_rx_parity_err)
   );
 
-  assign rx_fifo_wvalid = rx_valid & ~event_rx_frame_err & ~event_rx_parity_err;
+  assign rx_fifo_wvalid_int = rx_valid & ~event_rx_frame_err & ~event_rx_parity_err;
+
+  // Interception point for a simulation console that exchanges characters with the FIFOs directly
+  // instead of over the serial lines. The TX FIFO read strobe and the RX FIFO write port are left
+  // for the testbench to drive only if `SYNTHESIS is NOT defined AND `UART_SIM_BACKDOOR is defined.
+  // This define is used only for verilator as verilator does not support forces.
+`ifdef UART_SIM_BACKDOOR
+`ifdef SYNTHESIS
+  // Induce a compilation error by instantiating a non-existent module.
+  illegal_preprocessor_branch_taken u_illegal_preprocessor_branch_taken();
+`endif
+`else
+  assign tx_fifo_rready = tx_fifo_rready_int;
+  assign rx_fifo_wvalid = rx_fifo_wvalid_int;
+  assign rx_fifo_wdata  = rx_fifo_data;
+`endif
 
   prim_fifo_sync #(
     .Width   (8),
@@ -289,7 +305,7 @@ module uart_core (
     .clr_i   (uart_fifo_rxrst),
     .wvalid_i(rx_fifo_wvalid),
     .wready_o(rx_fifo_wready),
-    .wdata_i (rx_fifo_data),
+    .wdata_i (rx_fifo_wdata),
     .depth_o (rx_fifo_depth),
     .full_o (),
     .rvalid_o(rx_fifo_rvalid),
@@ -2,15 +2,177 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
-#include <algorithm>
+#include <getopt.h>
 #include <iostream>
 #include <string>
+#include <svdpi.h>
 #include <vector>
 
+#include "algorithm/shake.hpp"
+#include "ibex_pcount_sampler.h"
+#include "scramble_model.h"
 #include "verilated_toplevel.h"
+#include "verilator_mem_backdoor.h"
 #include "verilator_memutil.h"
 #include "verilator_sim_ctrl.h"
 
+// In batch mode, erase the flash before each test so that it can't see data
+// written by the previous test.
+class FlashEraser : public SimCtrlExtension {
+ public:
+  explicit FlashEraser(std::vector<const MemArea *> banks) : banks_(banks) {}
+
+  bool PrepareBatchTest(const std::string &image) override {
+    EraseAll();
+    return true;
+  }
+
+  unsigned long GetNextWakeCycle(unsigned long cycle) override {
+    return kNeverWake;
+  }
+
+  void EraseAll() const {
+    for (const MemArea *bank : banks_) {
+      std::vector<uint8_t> all_ones(bank->GetSizeBytes(), 0xffu);
+      bank->Write(/*word_offset=*/0, all_ones);
+    }
+  }
+
+ private:
+  std::vector<const MemArea *> banks_;
+};
+
+// With --rom-digest-shortcut, compute the digests that rom_ctrl would check
+// from the loaded ROM image, so that the testbench can load them into rom_ctrl
+// instead of letting it read the whole ROM through KMAC at every reset. This
+// needs a model built with ROM_CTRL_SIM_DIGEST (see chip_sim.core).
+class RomDigestShortcut;
+static const RomDigestShortcut *rom_digest_shortcut = nullptr;
+
+class RomDigestShortcut : public SimCtrlExtension {
+ public:
+  explicit RomDigestShortcut(const MemArea *rom) : rom_(rom), enabled_(false) {
+    rom_digest_shortcut = this;
+  }
+
+  ~RomDigestShortcut() { rom_digest_shortcut = nullptr; }
+
+  bool ParseCLIArguments(int argc, char **argv, bool &exit_app) override {
+    const struct option long_options[] = {
+        {"rom-digest-shortcut", no_argument, nullptr, 'r'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, no_argument, nullptr, 0}};
+
+    // Reset the command parsing index in-case other utils have already parsed
+    // some arguments
+    optind = 1;
+    while (1) {
+      int c = getopt_long(argc, argv, "-:h", long_options, nullptr);
+      if (c == -1) {
+        break;
+      }
+
+      // Disable error reporting by getopt
+      opterr = 0;
+
+      switch (c) {
+        case 'r':
+          enabled_ = true;
+          break;
+        case 'h':
+          std::cout << "ROM digest shortcut:\n\n"
+                       "--rom-digest-shortcut\n"
+                       "  Skip rom_ctrl's check of the ROM at reset, loading "
+                       "digests computed\n"
+                       "  by the simulator instead (needs a model built with "
+                       "ROM_CTRL_SIM_DIGEST)\n\n";
+          return true;
+        default:;
+          // Ignore unrecognized options since they might be consumed by
+          // other utils
+      }
+    }
+    return true;
+  }
+
+  unsigned long GetNextWakeCycle(unsigned long cycle) override {
+    return kNeverWake;
+  }
+
+  // Called (through DPI) as rom_ctrl goes into reset. Returns false if the
+  // shortcut is disabled. Otherwise, fills digest with the cSHAKE256 digest of
+  // all but the top 8 words of the ROM and exp_digest with the expected digest
+  // stored in those top words, in the order that rom_ctrl's checker reads them
+  // (see scramble_image.py, which computes the same digest).
+  bool GetDigests(const svBitVecVal *nonce, svBitVecVal *digest,
+                  svBitVecVal *exp_digest) const {
+    if (!enabled_) {
+      return false;
+    }
+
+    // Physical ROM words are 39 bits wide (32 bits of scrambled data and 7
+    // of ECC), read here as 5 bytes each. rom_ctrl sends exactly those 5
+    // bytes of each word to KMAC.
+    const uint32_t word_bytes = rom_->GetPhysWidthByte();
+    const uint32_t num_words = rom_->GetSizeWords();
+    uint32_t addr_width = 0;
+    while ((1u << addr_width) < num_words) {
+      ++addr_width;
+    }
+    std::vector<uint8_t> phys = rom_->ReadPhys();
+    std::vector<uint8_t> nonce_bytes(
+        reinterpret_cast<const uint8_t *>(nonce),
+        reinterpret_cast<const uint8_t *>(nonce) + kPrinceWidthByte);
+
+    // The checker reads the ROM in logical address order, so find the physical
+    // word for each logical address.
+    auto phys_word = [&](uint32_t log_addr) {
+      std::vector<uint8_t> addr = {uint8_t(log_addr), uint8_t(log_addr >> 8),
+                                   uint8_t(log_addr >> 16),
+                                   uint8_t(log_addr >> 24)};
+      addr.resize((addr_width + 7) / 8);
+      addr = scramble_addr(addr, addr_width, nonce_bytes, kPrinceWidth);
+      uint32_t phys_addr = 0;
+      for (size_t i = 0; i < addr.size(); ++i) {
+        phys_addr |= uint32_t(addr[i]) << (8 * i);
+      }
+      return &phys[phys_addr * word_bytes];
+    };
+
+    digestpp::cshake256 hasher;
+    hasher.set_customization("ROM_CTRL");
+    for (uint32_t i = 0; i < num_words - kTopCount; ++i) {
+      hasher.absorb(phys_word(i), word_bytes);
+    }
+    uint8_t out[4 * kTopCount];
+    hasher.squeeze(out, sizeof(out));
+
+    for (uint32_t i = 0; i < kTopCount; ++i) {
+      const uint8_t *top = phys_word(num_words - kTopCount + i);
+      digest[i] = out[4 * i] | (out[4 * i + 1] << 8) | (out[4 * i + 2] << 16) |
+                  (uint32_t(out[4 * i + 3]) << 24);
+      exp_digest[i] =
+          top[0] | (top[1] << 8) | (top[2] << 16) | (uint32_t(top[3]) << 24);
+    }
+    return true;
+  }
+
+ private:
+  // The number of 32-bit words in each digest (and at the top of the ROM)
+  static const uint32_t kTopCount = 8;
+
+  const MemArea *rom_;
+  bool enabled_;
+};
+
+// DPI import, called by chip_sim_tb.sv
+extern "C" svBit rom_ctrl_sim_get_digests(const svBitVecVal *nonce,
+                                          svBitVecVal *digest,
+                                          svBitVecVal *exp_digest) {
+  return rom_digest_shortcut &&
+         rom_digest_shortcut->GetDigests(nonce, digest, exp_digest);
+}
+
 int main(int argc, char **argv) {
   chip_sim_tb top;
   VerilatorMemUtil memutil;
@@ -42,10 +204,8 @@ int main(int argc, char **argv) {
           "gen_generic.u_impl_generic",
       0x80000 / 8, 8);
   // Start with the flash region erased. Future loads can overwrite.
-  std::vector<uint8_t> all_ones(flash0.GetSizeBytes());
-  std::fill(all_ones.begin(), all_ones.end(), 0xffu);
-  flash0.Write(/*word_offset=*/0, all_ones);
-  flash1.Write(/*word_offset=*/0, all_ones);
+  FlashEraser flash_eraser({&flash0, &flash1});
+  flash_eraser.EraseAll();
 
   MemArea otp(top_scope + ".u_otp_ctrl.u_otp.gen_generic.u_impl_generic." +
                   ram1p_adv_scope,
@@ -56,8 +216,27 @@ int main(int argc, char **argv) {
   memutil.RegisterMemoryArea("flash0", 0x20000000u, &flash0);
   memutil.RegisterMemoryArea("flash1", 0x20080000u, &flash1);
   memutil.RegisterMemoryArea("otp", 0x40000000u /* (bogus LMA) */, &otp);
+  // The eraser must be registered first, so that it runs before memutil loads
+  // the next test in batch mode.
+  simctrl.RegisterExtension(&flash_eraser);
   simctrl.RegisterExtension(&memutil);
 
+  // Only listens for requests if --mem-backdoor-port is given
+  VerilatorMemBackdoor mem_backdoor(memutil.GetUnderlying());
+  simctrl.RegisterExtension(&mem_backdoor);
+
+  // Only samples anything if one of its --pcount-* options is given
+  IbexPcountSampler pcount_sampler("TOP.chip_sim_tb");
+  simctrl.RegisterExtension(&pcount_sampler);
+
+  // Only used if --rom-digest-shortcut is given. This reads the raw 39-bit
+  // words of the ROM, rather than the 32-bit data seen through the rom area.
+  MemArea rom_phys(top_scope + (".u_rom_ctrl.gen_rom_scramble_enabled.u_rom."
+                                "u_rom.u_prim_rom.gen_generic.u_impl_generic"),
+                   0x8000 / 4, 5);
+  RomDigestShortcut rom_digest_shortcut(&rom_phys);
+  simctrl.RegisterExtension(&rom_digest_shortcut);
+
   // The initial reset delay must be long enough such that pwr/rst/clkmgr will
   // release clocks to the entire design.  This allows for synchronous resets
   // to appropriately propagate.
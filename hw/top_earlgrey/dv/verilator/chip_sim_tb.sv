@@ -13,8 +13,12 @@ module chip_sim_tb (
   logic cio_uart_rx_p2d, cio_uart_tx_d2p, cio_uart_tx_en_d2p;
 
   logic cio_spi_device_sck_p2d, cio_spi_device_csb_p2d;
-  logic cio_spi_device_sdi_p2d;
-  logic cio_spi_device_sdo_d2p, cio_spi_device_sdo_en_d2p;
+  logic [3:0] cio_spi_device_sd_p2d, cio_spi_device_sd_d2p, cio_spi_device_sd_en_d2p;
+  logic [3:0] spi_host_sd, spi_host_sd_en;
+
+  logic cio_spi_host0_sck_d2p, cio_spi_host0_csb_d2p;
+  logic [3:0] cio_spi_host0_sd_p2d, cio_spi_host0_sd_d2p, cio_spi_host0_sd_en_d2p;
+  logic [3:0] spi_flash_sd, spi_flash_sd_en;
 
   logic cio_usbdev_sense_p2d;
   logic cio_usbdev_se0_d2p;
@@ -44,9 +48,16 @@ module chip_sim_tb (
     // communication with SPI
     .cio_spi_device_sck_p2d_i(cio_spi_device_sck_p2d),
     .cio_spi_device_csb_p2d_i(cio_spi_device_csb_p2d),
-    .cio_spi_device_sdi_p2d_i(cio_spi_device_sdi_p2d),
-    .cio_spi_device_sdo_d2p_o(cio_spi_device_sdo_d2p),
-    .cio_spi_device_sdo_en_d2p_o(cio_spi_device_sdo_en_d2p),
+    .cio_spi_device_sd_p2d_i(cio_spi_device_sd_p2d),
+    .cio_spi_device_sd_d2p_o(cio_spi_device_sd_d2p),
+    .cio_spi_device_sd_en_d2p_o(cio_spi_device_sd_en_d2p),
+
+    // communication with SPI host 0
+    .cio_spi_host0_sck_d2p_o(cio_spi_host0_sck_d2p),
+    .cio_spi_host0_csb_d2p_o(cio_spi_host0_csb_d2p),
+    .cio_spi_host0_sd_p2d_i(cio_spi_host0_sd_p2d),
+    .cio_spi_host0_sd_d2p_o(cio_spi_host0_sd_d2p),
+    .cio_spi_host0_sd_en_d2p_o(cio_spi_host0_sd_en_d2p),
 
     // communication with USB
     .cio_usbdev_sense_p2d_i(cio_usbdev_sense_p2d),
@@ -78,13 +89,20 @@ module chip_sim_tb (
     .gpio_pull_sel(cio_gpio_pull_select)
   );
 
+`ifdef UART_SIM_BACKDOOR
+  localparam bit UartSimBackdoor = 1'b1;
+`else
+  localparam bit UartSimBackdoor = 1'b0;
+`endif
+
   // UART DPI
   // The baud rate set to match FPGA implementation; the frequency is "artificial". Both baud rate
   // frequency must match the settings used in the on-chip software at
   // `sw/device/lib/arch/device_sim_verilator.c`.
   uartdpi #(
     .BAUD('d7_200),
-    .FREQ('d500_000)
+    .FREQ('d500_000),
+    .BACKDOOR(UartSimBackdoor)
   ) u_uart (
     .clk_i  (clk_i),
     .rst_ni (rst_ni),
@@ -93,6 +111,63 @@ module chip_sim_tb (
     .rx_i   (cio_uart_tx_d2p)
   );
 
+`ifdef UART_SIM_BACKDOOR
+  `define UART0_CORE u_dut.top_earlgrey.u_uart0.uart_core
+
+  // Fast console: with the `UARTDPI_BACKDOOR` plusarg (the --uart-backdoor option of the simulation
+  // controller), characters are moved between u_uart and the FIFOs of uart0 directly. The TX FIFO
+  // is drained as soon as it has data and the RX FIFO is written as soon as it has space, so the
+  // baud rate doesn't limit the console. The serializer still runs on the characters that software
+  // sends, so the TX status bits and interrupts behave much as usual.
+  logic       uart_backdoor_rx_valid_q;
+  logic [7:0] uart_backdoor_rx_data_q;
+  logic       uart_backdoor_tx_rready, uart_backdoor_rx_wvalid;
+
+  assign uart_backdoor_tx_rready = `UART0_CORE.tx_fifo_rvalid & `UART0_CORE.tx_enable;
+  assign uart_backdoor_rx_wvalid = uart_backdoor_rx_valid_q & `UART0_CORE.rx_enable &
+                                   `UART0_CORE.rx_fifo_wready;
+
+  assign `UART0_CORE.tx_fifo_rready = u_uart.backdoor ? uart_backdoor_tx_rready :
+                                                        `UART0_CORE.tx_fifo_rready_int;
+  assign `UART0_CORE.rx_fifo_wvalid = u_uart.backdoor ? uart_backdoor_rx_wvalid :
+                                                        `UART0_CORE.rx_fifo_wvalid_int;
+  assign `UART0_CORE.rx_fifo_wdata  = u_uart.backdoor ? uart_backdoor_rx_data_q :
+                                                        `UART0_CORE.rx_fifo_data;
+
+  always_ff @(posedge `UART0_CORE.clk_i or negedge `UART0_CORE.rst_ni) begin
+    if (!`UART0_CORE.rst_ni) begin
+      uart_backdoor_rx_valid_q <= 1'b0;
+      uart_backdoor_rx_data_q  <= '0;
+    end else if (u_uart.backdoor) begin
+      if (uart_backdoor_tx_rready) begin
+        u_uart.backdoor_write(`UART0_CORE.tx_fifo_data);
+      end
+      // Fetch the next character from the host once the last one is in the RX FIFO.
+      if (!uart_backdoor_rx_valid_q || uart_backdoor_rx_wvalid) begin
+        uart_backdoor_rx_valid_q <= 1'b0;
+        if (u_uart.backdoor_can_read()) begin
+          uart_backdoor_rx_valid_q <= 1'b1;
+          uart_backdoor_rx_data_q  <= u_uart.backdoor_read();
+        end
+      end
+    end
+  end
+
+  // The define leaves the FIFO ports of every UART undriven; the other UARTs keep their usual
+  // connections.
+  `define UART_CONNECT_FIFOS(core)                       \
+    assign core.tx_fifo_rready = core.tx_fifo_rready_int; \
+    assign core.rx_fifo_wvalid = core.rx_fifo_wvalid_int; \
+    assign core.rx_fifo_wdata  = core.rx_fifo_data;
+
+  `UART_CONNECT_FIFOS(u_dut.top_earlgrey.u_uart1.uart_core)
+  `UART_CONNECT_FIFOS(u_dut.top_earlgrey.u_uart2.uart_core)
+  `UART_CONNECT_FIFOS(u_dut.top_earlgrey.u_uart3.uart_core)
+
+  `undef UART_CONNECT_FIFOS
+  `undef UART0_CORE
+`endif
+
 `ifdef DMIDirectTAP
   // OpenOCD direct DMI TAP
   bind rv_dm dmidpi u_dmidpi (
@@ -134,11 +209,34 @@ module chip_sim_tb (
     .rst_ni (rst_ni),
     .spi_device_sck_o     (cio_spi_device_sck_p2d),
     .spi_device_csb_o     (cio_spi_device_csb_p2d),
-    .spi_device_sdi_o     (cio_spi_device_sdi_p2d),
-    .spi_device_sdo_i     (cio_spi_device_sdo_d2p),
-    .spi_device_sdo_en_i  (cio_spi_device_sdo_en_d2p)
+    .spi_device_sd_o      (spi_host_sd),
+    .spi_device_sd_en_o   (spi_host_sd_en),
+    .spi_device_sd_i      (cio_spi_device_sd_d2p),
+    .spi_device_sd_en_i   (cio_spi_device_sd_en_d2p)
+  );
+
+  // Each data lane reads back whatever is driving it: the host if it has the lane, otherwise the
+  // device.
+  for (genvar i = 0; i < 4; i++) begin : gen_spi_sd
+    assign cio_spi_device_sd_p2d[i] = spi_host_sd_en[i] ? spi_host_sd[i] : cio_spi_device_sd_d2p[i];
+  end
+
+  // SPI flash on SPI host 0
+  spidpi_flash u_spi_flash (
+    .clk_i   (clk_i),
+    .rst_ni  (rst_ni),
+    .sck_i   (cio_spi_host0_sck_d2p),
+    .csb_i   (cio_spi_host0_csb_d2p),
+    .sd_i    (cio_spi_host0_sd_d2p),
+    .sd_o    (spi_flash_sd),
+    .sd_en_o (spi_flash_sd_en)
   );
 
+  for (genvar i = 0; i < 4; i++) begin : gen_spi_host0_sd
+    assign cio_spi_host0_sd_p2d[i] = spi_flash_sd_en[i] ? spi_flash_sd[i] :
+                                                          cio_spi_host0_sd_d2p[i];
+  end
+
   // USB DPI
   usbdpi u_usbdpi (
     .clk_i           (clk_i),
@@ -203,10 +301,74 @@ module chip_sim_tb (
       $display("Verilator sim termination requested");
       $display("Your simulation wrote to 0x%h", u_sw_test_status_if.sw_test_status_addr);
       dv_test_status_pkg::dv_test_status(u_sw_test_status_if.sw_test_passed);
+      // In batch mode, also report a failed test to the simulation controller
+      // (which counts $stop as a failure) so that it can record the result.
+      if (!u_sw_test_status_if.sw_test_passed &&
+          $test$plusargs("STOP_ON_SW_TEST_FAIL")) begin
+        $stop;
+      end
       $finish;
     end
   end
 
+`ifdef ROM_CTRL_SIM_DIGEST
+  // ROM digest shortcut (see RomDigestShortcut in chip_sim_tb.cc). As rom_ctrl goes into reset,
+  // ask the simulation for the digests of the ROM that is loaded. If it has computed them (which
+  // it only does with --rom-digest-shortcut), rom_ctrl loads them instead of reading the whole
+  // ROM through KMAC.
+  `define ROM_CTRL u_dut.top_earlgrey.u_rom_ctrl
+
+  import "DPI-C" function bit rom_ctrl_sim_get_digests(input bit [63:0] nonce,
+                                                       output bit [255:0] digest,
+                                                       output bit [255:0] exp_digest);
+
+  bit         rom_ctrl_rst_nq = 1'b1;
+  bit         rom_digest_en = 1'b0;
+  bit [255:0] rom_digest, rom_exp_digest;
+
+  always_ff @(posedge clk_i) begin
+    rom_ctrl_rst_nq <= `ROM_CTRL.rst_ni;
+    if (rom_ctrl_rst_nq && !`ROM_CTRL.rst_ni) begin
+      automatic bit [255:0] digest, exp_digest;
+      automatic bit en;
+      en = rom_ctrl_sim_get_digests(`ROM_CTRL.gen_rom_scramble_enabled.u_rom.scr_nonce,
+                                    digest, exp_digest);
+      rom_digest_en  <= en;
+      rom_digest     <= digest;
+      rom_exp_digest <= exp_digest;
+    end
+  end
+
+  assign `ROM_CTRL.sim_digest_en  = rom_digest_en;
+  assign `ROM_CTRL.sim_digest     = rom_digest;
+  assign `ROM_CTRL.sim_exp_digest = rom_exp_digest;
+
+  `undef ROM_CTRL
+`endif
+
+  // Performance counter and PC access for IbexPcountSampler (see ibex_pcount_sampler.h). These
+  // follow the DPI functions that the Ibex pcount utilities expect.
+  `define IBEX_CS_REGISTERS `RV_CORE_IBEX.u_core.u_ibex_core.cs_registers_i
+
+  export "DPI-C" function mhpmcounter_num;
+
+  function automatic int unsigned mhpmcounter_num();
+    return `IBEX_CS_REGISTERS.MHPMCounterNum;
+  endfunction
+
+  export "DPI-C" function mhpmcounter_get;
+
+  function automatic longint unsigned mhpmcounter_get(int index);
+    return `IBEX_CS_REGISTERS.mhpmcounter[index];
+  endfunction
+
+  export "DPI-C" function ibex_pc_get;
+
+  function automatic int unsigned ibex_pc_get();
+    return `IBEX_CS_REGISTERS.pc_id_i;
+  endfunction
+
+  `undef IBEX_CS_REGISTERS
   `undef RV_CORE_IBEX
   `undef SIM_SRAM_IF
 
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Benchmark the simulation speed of the Earl Grey Verilator model.
+
+This runs a fixed set of workloads on chip_sim_tb through their
+*_sim_verilator Bazel test targets, each with --profile so that
+VerilatorSimCtrl writes a JSON report. From each report it takes the speed
+(cycles/s), the time to parse the arguments of the extensions (which is
+where the memory images are loaded) and the peak RSS of the simulator. For
+example:
+
+    ./hw/top_earlgrey/dv/verilator/sim_speed_bench.py \\
+        --baseline build/sim_speed_bench/baseline.json --update-baseline
+
+writes a baseline, and later runs with the same --baseline compare against
+it, exiting with a nonzero status if a workload got slower (or bigger) than
+the baseline by more than --tolerance. Baselines depend on the host, so
+they should be taken on the machine that runs the comparison.
+"""
+
+import argparse
+import json
+import logging as log
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+REPO_TOP = Path(__file__).resolve().parents[4]
+
+# The workloads, as the names of Bazel test targets. These are picked to
+# stress different parts of the simulation infrastructure: the ROM boot (the
+# real ROM, which verifies and jumps to a signed flash image) spends its time
+# in the flash and OTP models, the crypto tests in OTBN and KMAC, the UART
+# test in the UART DPI and the USB test in the USB DPI.
+WORKLOADS = {
+    'rom_boot':
+    '//sw/device/silicon_creator/rom/e2e:rom_e2e_smoke_sim_verilator',
+    'otbn': '//sw/device/tests:otbn_smoketest_sim_verilator',
+    'kmac': '//sw/device/tests:kmac_smoketest_sim_verilator',
+    'uart': '//sw/device/tests:uart_smoketest_sim_verilator',
+    'usb': '//sw/device/tests:usbdev_stream_test_sim_verilator',
+}
+
+# The metrics taken from each profile, and whether a bigger value is better
+METRICS = {
+    'cycles_per_s': True,
+    'setup_s': False,
+    'max_rss_kb': False,
+}
+
+
+def run_workload(target: str, profile: Path, jobs: int) -> dict:
+    cmd = [
+        'bazel', 'test', target, '--test_output=errors',
+        '--cache_test_results=no',
+        '--sandbox_writable_path={}'.format(profile.parent),
+        '--test_arg=--verilator-args=--profile={}'.format(profile)
+    ]
+    if jobs:
+        cmd.append('--jobs={}'.format(jobs))
+    log.info('Running %s', ' '.join(cmd))
+    subprocess.run(cmd, check=True, cwd=str(REPO_TOP))
+    with open(str(profile)) as f:
+        report = json.load(f)
+    return {name: report[name] for name in METRICS}
+
+
+def compare(results: dict, baseline: dict, tolerance: float) -> list:
+    """Return a message for each metric that regressed past the tolerance"""
+    regressions = []
+    for workload, metrics in results.items():
+        base = baseline.get(workload)
+        if base is None:
+            log.warning('No baseline for %s.', workload)
+            continue
+        for name, bigger_is_better in METRICS.items():
+            old, new = base.get(name), metrics[name]
+            if not old:
+                continue
+            change = (new - old) / old
+            if bigger_is_better:
+                change = -change
+            if change > tolerance:
+                regressions.append('{}: {} went from {:g} to {:g}'.format(
+                    workload, name, old, new))
+    return regressions
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--workloads',
+                        nargs='+',
+                        choices=sorted(WORKLOADS),
+                        default=sorted(WORKLOADS),
+                        help='Workloads to run (default: all of them)')
+    parser.add_argument('--baseline',
+                        type=Path,
+                        help='JSON file with the results to compare against')
+    parser.add_argument('--update-baseline',
+                        action='store_true',
+                        help='Write the results to --baseline instead')
+    parser.add_argument('--tolerance',
+                        type=float,
+                        default=0.1,
+                        help='Allowed regression, as a fraction of the '
+                        'baseline (default: 0.1)')
+    parser.add_argument('--repeat',
+                        type=int,
+                        default=1,
+                        help='Runs for each workload (the best is kept)')
+    parser.add_argument('--jobs',
+                        type=int,
+                        default=0,
+                        help='Passed to bazel as --jobs')
+    parser.add_argument('-v', '--verbose', action='store_true')
+    args = parser.parse_args()
+
+    log.basicConfig(format='%(levelname)s: %(message)s',
+                    level=log.INFO if args.verbose else log.WARNING)
+
+    if args.update_baseline and args.baseline is None:
+        log.error('--update-baseline needs --baseline.')
+        return 1
+
+    results = {}
+    with tempfile.TemporaryDirectory(prefix='sim_speed_bench.') as tmp:
+        for workload in args.workloads:
+            runs = []
+            for i in range(args.repeat):
+                profile = Path(tmp) / '{}.{}.json'.format(workload, i)
+                runs.append(run_workload(WORKLOADS[workload], profile,
+                                         args.jobs))
+            results[workload] = {
+                name: (max if bigger_is_better else min)(r[name]
+                                                         for r in runs)
+                for name, bigger_is_better in METRICS.items()
+            }
+
+    print('{:<10} {:>14} {:>10} {:>12}'.format('workload', 'cycles/s',
+                                               'setup (s)', 'max RSS (kB)'))
+    for workload, metrics in results.items():
+        print('{:<10} {:>14.0f} {:>10.3f} {:>12}'.format(
+            workload, metrics['cycles_per_s'], metrics['setup_s'],
+            metrics['max_rss_kb']))
+
+    if args.baseline is None:
+        return 0
+
+    if args.update_baseline:
+        baseline = {}
+        if args.baseline.exists():
+            with open(str(args.baseline)) as f:
+                baseline = json.load(f)
+        baseline.update(results)
+        args.baseline.parent.mkdir(parents=True, exist_ok=True)
+        with open(str(args.baseline), 'w') as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+            f.write('\n')
+        print('Baseline written to {}'.format(args.baseline))
+        return 0
+
+    with open(str(args.baseline)) as f:
+        baseline = json.load(f)
+    regressions = compare(results, baseline, args.tolerance)
+    for msg in regressions:
+        print('REGRESSION: ' + msg)
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Measure how the speed of the Earl Grey Verilator model scales with threads.
+
+For each thread count, this builds the model with FuseSoC (passing
+--threads N to Verilator) into its own build directory, then boots the given
+ROM, flash and OTP images for a fixed number of cycles and reads the speed
+that VerilatorSimCtrl reports at the end. For example:
+
+    ./hw/top_earlgrey/dv/verilator/thread_scaling.py \\
+        --rom bazel-bin/sw/device/lib/testing/test_rom/test_rom_sim_verilator.scr.39.vmem \\
+        --flash bazel-bin/sw/device/tests/uart_smoketest_prog_sim_verilator.64.scr.vmem \\
+        --otp bazel-bin/hw/ip/otp_ctrl/data/img_rma.vmem \\
+        --threads 1 2 4 8
+
+Use --skip-build to rerun the measurements against models built before.
+"""
+
+import argparse
+import logging as log
+import os
+import re
+import subprocess
+import sys
+from pathlib import Path
+
+REPO_TOP = Path(__file__).resolve().parents[4]
+CORE = 'lowrisc:dv:chip_verilator_sim'
+SPEED_RE = re.compile(r'^Simulation speed: ([0-9.e+]+) cycles/s', re.M)
+
+
+def build(build_dir: Path, threads: int, jobs: int) -> None:
+    cmd = [
+        sys.executable,
+        str(REPO_TOP / 'util' / 'fusesoc_build.py'),
+        '--cores-root={}'.format(REPO_TOP), 'run', '--flag=fileset_top',
+        '--target=sim', '--setup', '--build',
+        '--build-root={}'.format(build_dir), CORE,
+        '--verilator_options=--threads {}'.format(threads),
+        '--make_options=-j {}'.format(jobs)
+    ]
+    log.info('Building with %d threads in %s', threads, build_dir)
+    subprocess.run(cmd, check=True, cwd=str(REPO_TOP))
+
+
+def measure(binary: Path, args: argparse.Namespace) -> float:
+    cmd = [
+        str(binary), '--meminit=rom,{}'.format(args.rom),
+        '--meminit=flash,{}'.format(args.flash),
+        '--meminit=otp,{}'.format(args.otp),
+        '--term-after-cycles={}'.format(args.cycles)
+    ]
+    log.info('Running %s', ' '.join(cmd))
+    proc = subprocess.run(cmd,
+                          stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT,
+                          universal_newlines=True,
+                          cwd=str(binary.parent))
+    match = SPEED_RE.search(proc.stdout)
+    if not match:
+        raise RuntimeError('No simulation speed in the output of {}:\n{}'
+                           .format(binary, proc.stdout))
+    return float(match.group(1))
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--rom', required=True, help='ROM image (vmem)')
+    parser.add_argument('--flash', required=True, help='Flash image (vmem)')
+    parser.add_argument('--otp', required=True, help='OTP image (vmem)')
+    parser.add_argument('--threads',
+                        type=int,
+                        nargs='+',
+                        default=[1, 2, 4, 8],
+                        help='Thread counts to measure (default: 1 2 4 8)')
+    parser.add_argument('--cycles',
+                        type=int,
+                        default=2000000,
+                        help='Cycles to simulate for each measurement')
+    parser.add_argument('--repeat',
+                        type=int,
+                        default=1,
+                        help='Runs for each thread count (the best is kept)')
+    parser.add_argument('--build-root',
+                        type=Path,
+                        default=REPO_TOP / 'build' / 'thread_scaling',
+                        help='Where to put the models')
+    parser.add_argument('--jobs',
+                        type=int,
+                        default=os.cpu_count() or 1,
+                        help='Parallel jobs for compiling each model')
+    parser.add_argument('--skip-build',
+                        action='store_true',
+                        help='Use the models from a previous run')
+    parser.add_argument('-v', '--verbose', action='store_true')
+    args = parser.parse_args()
+
+    log.basicConfig(format='%(levelname)s: %(message)s',
+                    level=log.INFO if args.verbose else log.WARNING)
+
+    for path in [args.rom, args.flash, args.otp]:
+        if not os.path.exists(path):
+            log.error('Image %s does not exist.', path)
+            return 1
+    args.rom, args.flash, args.otp = (os.path.abspath(p)
+                                      for p in [args.rom, args.flash, args.otp])
+
+    results = []
+    for threads in args.threads:
+        build_dir = args.build_root / 'threads-{}'.format(threads)
+        if not args.skip_build:
+            build(build_dir, threads, args.jobs)
+        binary = build_dir / 'sim-verilator' / 'Vchip_sim_tb'
+        if not binary.exists():
+            log.error('No model at %s.', binary)
+            return 1
+        speed = max(measure(binary, args) for _ in range(args.repeat))
+        results.append((threads, speed))
+
+    base = results[0][1]
+    print('{:>8} {:>14} {:>8}'.format('threads', 'cycles/s', 'speedup'))
+    for threads, speed in results:
+        print('{:>8} {:>14.0f} {:>8.2f}'.format(threads, speed, speed / base))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -16,6 +16,7 @@ module chip_englishbreakfast_verilator (
   logic cio_spi_device_sck_p2d, cio_spi_device_csb_p2d;
   logic cio_spi_device_sdi_p2d;
   logic cio_spi_device_sdo_d2p, cio_spi_device_sdo_en_d2p;
+  logic [3:0] spi_host_sd, spi_host_sd_en;
 
   logic cio_usbdev_sense_p2d;
   logic cio_usbdev_se0_d2p;
@@ -291,11 +292,18 @@ module chip_englishbreakfast_verilator (
     .rst_ni (rst_ni),
     .spi_device_sck_o     (cio_spi_device_sck_p2d),
     .spi_device_csb_o     (cio_spi_device_csb_p2d),
-    .spi_device_sdi_o     (cio_spi_device_sdi_p2d),
-    .spi_device_sdo_i     (cio_spi_device_sdo_d2p),
-    .spi_device_sdo_en_i  (cio_spi_device_sdo_en_d2p)
+    .spi_device_sd_o      (spi_host_sd),
+    .spi_device_sd_en_o   (spi_host_sd_en),
+    .spi_device_sd_i      ({2'b0, cio_spi_device_sdo_d2p, 1'b0}),
+    .spi_device_sd_en_i   ({2'b0, cio_spi_device_sdo_en_d2p, 1'b0})
   );
 
+  // Only single-lane SPI is connected here: the host drives lane 0 (SDI)
+  assign cio_spi_device_sdi_p2d = spi_host_sd[0];
+
+  logic unused_spi_host_sd;
+  assign unused_spi_host_sd = ^{spi_host_sd[3:1], spi_host_sd_en};
+
   // USB DPI
   usbdpi u_usbdpi (
     .clk_i           (clk_i),
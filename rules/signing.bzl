@@ -450,6 +450,43 @@ def _post_signing_attach(ctx, opentitantool, pre, ecdsa_sig, rsa_sig, spx_sig):
     )
     return signed
 
+def _batch_signing_directives(script, jobs):
+    """Merge the per-image ECDSA signing directives into batch directives.
+
+    The directives signing with the same key are replaced by a single
+    `ecdsa-sign-batch` directive, which keeps `jobs` sign requests in flight
+    on the HSM.  The signature files keep the names of the per-image flow.
+
+    Args:
+        script: list; The per-image signing directives.
+        jobs: int; The number of concurrent HSM sessions.
+    Returns:
+        list: The signing directives.
+    """
+    batches = {}
+    result = []
+    for directive in script:
+        if directive.command != "ecdsa-sign":
+            result.append(directive)
+            continue
+        if directive.label not in batches:
+            batches[directive.label] = []
+        batches[directive.label].append(directive.input)
+    for label, inputs in batches.items():
+        result.append(struct(
+            command = "ecdsa-sign-batch",
+            id = None,
+            label = label,
+            format = "Sha256Hash",
+            little_endian = True,
+            jobs = jobs,
+            output_dir = ".",
+            extension = "ecdsa_sig",
+            cache_dir = None,
+            inputs = inputs,
+        ))
+    return result
+
 def _offline_presigning_artifacts(ctx):
     tc = ctx.toolchains[LOCALTOOLS_TOOLCHAIN]
     ecdsa_key = key_from_dict(ctx.attr.ecdsa_key, "ecdsa_key")
@@ -474,6 +511,9 @@ def _offline_presigning_artifacts(ctx):
         if artifacts.spxmsg:
             digests.append(artifacts.spxmsg)
 
+    if ctx.attr.batch_sign_jobs:
+        script = _batch_signing_directives(script, ctx.attr.batch_sign_jobs)
+
     default_files = digests
     if script:
         script_file = ctx.actions.declare_file("{}.json".format(ctx.attr.name))
@@ -506,6 +546,10 @@ offline_presigning_artifacts = rule(
             allow_files = True,
             doc = "SPX public key to validate this image",
         ),
+        "batch_sign_jobs": attr.int(
+            default = 0,
+            doc = "If non-zero, emit one ecdsa-sign-batch directive per key using this many concurrent HSM sessions instead of one ecdsa-sign directive per image",
+        ),
     },
     toolchains = [LOCALTOOLS_TOOLCHAIN],
 )
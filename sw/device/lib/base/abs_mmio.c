@@ -4,6 +4,73 @@
 
 #include "sw/device/lib/base/abs_mmio.h"
 
+#include "sw/device/lib/base/hardened.h"
+
+void abs_mmio_write32_bulk(uint32_t addr, const uint32_t *src,
+                           size_t num_words) {
+  size_t i = 0;
+  for (; i + 4 <= num_words; i += 4) {
+    abs_mmio_write32(addr, src[i]);
+    abs_mmio_write32(addr + 4, src[i + 1]);
+    abs_mmio_write32(addr + 8, src[i + 2]);
+    abs_mmio_write32(addr + 12, src[i + 3]);
+    addr += 16;
+  }
+  for (; i < num_words; ++i) {
+    abs_mmio_write32(addr, src[i]);
+    addr += 4;
+  }
+}
+
+void abs_mmio_read32_bulk(uint32_t addr, uint32_t *dest, size_t num_words) {
+  size_t i = 0;
+  for (; i + 4 <= num_words; i += 4) {
+    dest[i] = abs_mmio_read32(addr);
+    dest[i + 1] = abs_mmio_read32(addr + 4);
+    dest[i + 2] = abs_mmio_read32(addr + 8);
+    dest[i + 3] = abs_mmio_read32(addr + 12);
+    addr += 16;
+  }
+  for (; i < num_words; ++i) {
+    dest[i] = abs_mmio_read32(addr);
+    addr += 4;
+  }
+}
+
+size_t abs_mmio_write32_bulk_hardened(uint32_t addr, const uint32_t *src,
+                                      size_t num_words) {
+  size_t i = 0;
+  for (; launder32(i) + 4 <= num_words; i += 4) {
+    abs_mmio_write32(addr, src[i]);
+    abs_mmio_write32(addr + 4, src[i + 1]);
+    abs_mmio_write32(addr + 8, src[i + 2]);
+    abs_mmio_write32(addr + 12, src[i + 3]);
+    addr += 16;
+  }
+  for (; launder32(i) < num_words; ++i) {
+    abs_mmio_write32(addr, src[i]);
+    addr += 4;
+  }
+  return i;
+}
+
+size_t abs_mmio_read32_bulk_hardened(uint32_t addr, uint32_t *dest,
+                                     size_t num_words) {
+  size_t i = 0;
+  for (; launder32(i) + 4 <= num_words; i += 4) {
+    dest[i] = abs_mmio_read32(addr);
+    dest[i + 1] = abs_mmio_read32(addr + 4);
+    dest[i + 2] = abs_mmio_read32(addr + 8);
+    dest[i + 3] = abs_mmio_read32(addr + 12);
+    addr += 16;
+  }
+  for (; launder32(i) < num_words; ++i) {
+    dest[i] = abs_mmio_read32(addr);
+    addr += 4;
+  }
+  return i;
+}
+
 // `extern` declarations to give the inline functions in the corresponding
 // header a link location.
 extern uint8_t abs_mmio_read8(uint32_t addr);
@@ -106,6 +106,57 @@ extern void abs_mmio_write32_shadowed(uint32_t addr, uint32_t value);
 
 #endif  // OT_PLATFORM_RV32
 
+/**
+ * Writes `num_words` words from `src` to consecutive MMIO words starting at
+ * `addr`.
+ *
+ * The copy is unrolled to cut the per-word loop overhead of large transfers,
+ * such as loading an accelerator memory.
+ *
+ * @param addr the address of the first word to write to.
+ * @param src the words to write.
+ * @param num_words the number of words to write.
+ */
+void abs_mmio_write32_bulk(uint32_t addr, const uint32_t *src,
+                           size_t num_words);
+
+/**
+ * Reads `num_words` consecutive MMIO words starting at `addr` into `dest`.
+ *
+ * @param addr the address of the first word to read from.
+ * @param[out] dest the buffer to read into.
+ * @param num_words the number of words to read.
+ */
+void abs_mmio_read32_bulk(uint32_t addr, uint32_t *dest, size_t num_words);
+
+/**
+ * Hardened variant of `abs_mmio_write32_bulk()`.
+ *
+ * The loop counter is laundered so the compiler cannot shorten the copy, and
+ * the number of words actually copied is returned for the caller to check
+ * with `HARDENED_CHECK_EQ()`.
+ *
+ * @param addr the address of the first word to write to.
+ * @param src the words to write.
+ * @param num_words the number of words to write.
+ * @return the number of words written.
+ */
+OT_WARN_UNUSED_RESULT
+size_t abs_mmio_write32_bulk_hardened(uint32_t addr, const uint32_t *src,
+                                      size_t num_words);
+
+/**
+ * Hardened variant of `abs_mmio_read32_bulk()`.
+ *
+ * @param addr the address of the first word to read from.
+ * @param[out] dest the buffer to read into.
+ * @param num_words the number of words to read.
+ * @return the number of words read.
+ */
+OT_WARN_UNUSED_RESULT
+size_t abs_mmio_read32_bulk_hardened(uint32_t addr, uint32_t *dest,
+                                     size_t num_words);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,111 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/abs_mmio.h"
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ottf_test_config.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+#include "otbn_regs.h"  // Generated.
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  // Number of words copied per run; 1 KiB, a typical OTBN operand set.
+  kNumWords = 256,
+  kNumRuns = 10,
+  kDmemAddr = TOP_EARLGREY_OTBN_BASE_ADDR + OTBN_DMEM_REG_OFFSET,
+};
+
+static uint32_t src[kNumWords];
+static uint32_t dest[kNumWords];
+
+static void write_words(uint32_t addr, const uint32_t *buf, size_t num_words) {
+  for (size_t i = 0; i < num_words; ++i) {
+    abs_mmio_write32(addr + i * sizeof(uint32_t), buf[i]);
+  }
+}
+
+static void write_bulk(uint32_t addr, const uint32_t *buf, size_t num_words) {
+  abs_mmio_write32_bulk(addr, buf, num_words);
+}
+
+static void write_bulk_hardened(uint32_t addr, const uint32_t *buf,
+                                size_t num_words) {
+  CHECK(abs_mmio_write32_bulk_hardened(addr, buf, num_words) == num_words);
+}
+
+static void read_words(uint32_t addr, uint32_t *buf, size_t num_words) {
+  for (size_t i = 0; i < num_words; ++i) {
+    buf[i] = abs_mmio_read32(addr + i * sizeof(uint32_t));
+  }
+}
+
+static void read_bulk(uint32_t addr, uint32_t *buf, size_t num_words) {
+  abs_mmio_read32_bulk(addr, buf, num_words);
+}
+
+static void read_bulk_hardened(uint32_t addr, uint32_t *buf,
+                               size_t num_words) {
+  CHECK(abs_mmio_read32_bulk_hardened(addr, buf, num_words) == num_words);
+}
+
+typedef struct perf_test {
+  const char *label;
+  void (*write)(uint32_t, const uint32_t *, size_t);
+  void (*read)(uint32_t, uint32_t *, size_t);
+} perf_test_t;
+
+static const perf_test_t kPerfTests[] = {
+    {"word loop", write_words, read_words},
+    {"bulk", write_bulk, read_bulk},
+    {"bulk hardened", write_bulk_hardened, read_bulk_hardened},
+};
+
+// Logs the throughput of a copy of `kNumWords` words in thousandths of a word
+// per cycle, since the log functions do not format fractions.
+static void log_throughput(const char *label, const char *op,
+                           uint64_t num_cycles) {
+  CHECK(num_cycles > 0 && num_cycles <= UINT32_MAX);
+  LOG_INFO("%s %s: %d cycles, %d words per 1000 cycles", label, op,
+           (uint32_t)num_cycles, (uint32_t)(kNumWords * 1000 / num_cycles));
+}
+
+bool test_main(void) {
+  for (size_t i = 0; i < kNumWords; ++i) {
+    src[i] = 0x9e3779b9 * (uint32_t)(i + 1);
+  }
+
+  for (size_t t = 0; t < ARRAYSIZE(kPerfTests); ++t) {
+    const perf_test_t *test = &kPerfTests[t];
+    uint64_t write_cycles = 0;
+    uint64_t read_cycles = 0;
+    for (size_t run = 0; run < kNumRuns; ++run) {
+      uint64_t start = ibex_mcycle_read();
+      test->write(kDmemAddr, src, kNumWords);
+      uint64_t mid = ibex_mcycle_read();
+      test->read(kDmemAddr, dest, kNumWords);
+      uint64_t end = ibex_mcycle_read();
+      write_cycles += mid - start;
+      read_cycles += end - mid;
+
+      for (size_t i = 0; i < kNumWords; ++i) {
+        CHECK(dest[i] == src[i], "%s: mismatch at word %d", test->label,
+              (uint32_t)i);
+        dest[i] = 0;
+      }
+    }
+    log_throughput(test->label, "DMEM write", write_cycles / kNumRuns);
+    log_throughput(test->label, "DMEM read", read_cycles / kNumRuns);
+  }
+  return true;
+}
@@ -15,8 +15,18 @@
 
 OTTF_DEFINE_TEST_CONFIG();
 
+// Computes the CRC32 of a buffer one byte at a time, as a reference.
+static uint32_t crc32_bytewise(const uint8_t *buf, size_t len) {
+  uint32_t ctx;
+  crc32_init(&ctx);
+  for (size_t i = 0; i < len; ++i) {
+    crc32_add8(&ctx, buf[i]);
+  }
+  return crc32_finish(&ctx);
+}
+
 bool test_main(void) {
-  uint8_t buf[4096];
+  uint8_t buf[4096 + sizeof(uint32_t)];
   for (size_t i = 0; i < ARRAYSIZE(buf); ++i) {
     buf[i] = i & UINT8_MAX;
   }
@@ -24,7 +34,7 @@ bool test_main(void) {
   const size_t kNumRepetitions = 10;
   for (size_t i = 0; i < kNumRepetitions; ++i) {
     const uint64_t start_cycles = ibex_mcycle_read();
-    const uint32_t checksum = crc32(buf, sizeof(buf));
+    const uint32_t checksum = crc32(buf, 4096);
     const uint64_t end_cycles = ibex_mcycle_read();
     const uint64_t num_cycles = end_cycles - start_cycles;
 
@@ -39,5 +49,31 @@ bool test_main(void) {
       return false;
     }
   }
+
+  // Smaller and misaligned buffers, which spend more of their time outside
+  // the unrolled loop, checked against the byte-at-a-time result.
+  const size_t kLengths[] = {16, 61, 256, 1024};
+  for (size_t offset = 0; offset < 2; ++offset) {
+    for (size_t i = 0; i < ARRAYSIZE(kLengths); ++i) {
+      const uint8_t *data = &buf[offset];
+      const size_t len = kLengths[i];
+
+      const uint64_t start_cycles = ibex_mcycle_read();
+      const uint32_t checksum = crc32(data, len);
+      const uint64_t end_cycles = ibex_mcycle_read();
+      const uint64_t num_cycles = end_cycles - start_cycles;
+
+      CHECK(num_cycles <= UINT32_MAX);
+      LOG_INFO("CRC32 of %d bytes at offset %d computed in %d cycles.",
+               (uint32_t)len, (uint32_t)offset, (uint32_t)num_cycles);
+
+      const uint32_t expected_checksum = crc32_bytewise(data, len);
+      if (checksum != expected_checksum) {
+        LOG_ERROR("Checksum did not match. Expected %x, but got %x.",
+                  expected_checksum, checksum);
+        return false;
+      }
+    }
+  }
   return true;
 }
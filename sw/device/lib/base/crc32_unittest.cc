@@ -4,8 +4,10 @@
 
 #include "sw/device/lib/base/crc32.h"
 
+#include <algorithm>
 #include <cstring>
 #include <stdint.h>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -66,6 +68,48 @@ TEST_F(CrcTest, Misaligned) {
   EXPECT_EQ(crc32_finish(&ctx), kExpCrc);
 }
 
+// Bit-serial IEEE 802.3 CRC-32, as a reference for long inputs.
+uint32_t RefCrc32(const uint8_t *buf, size_t len) {
+  uint32_t crc = UINT32_MAX;
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= buf[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+    }
+  }
+  return crc ^ UINT32_MAX;
+}
+
+TEST_F(CrcTest, AllOffsetsAndLengths) {
+  std::vector<uint8_t> buf(256);
+  for (size_t i = 0; i < buf.size(); ++i) {
+    buf[i] = static_cast<uint8_t>(i * 37 + 11);
+  }
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t len = 0; len + offset <= 80; ++len) {
+      EXPECT_EQ(crc32(&buf[offset], len), RefCrc32(&buf[offset], len))
+          << "offset=" << offset << " len=" << len;
+    }
+  }
+}
+
+TEST_F(CrcTest, Long) {
+  // Matches crc32_perftest.
+  std::vector<uint8_t> buf(4096);
+  for (size_t i = 0; i < buf.size(); ++i) {
+    buf[i] = i & UINT8_MAX;
+  }
+  EXPECT_EQ(crc32(buf.data(), buf.size()), 0xa2912082);
+
+  // Split into uneven chunks.
+  uint32_t ctx;
+  crc32_init(&ctx);
+  for (size_t i = 0, chunk = 1; i < buf.size(); i += chunk, chunk += 3) {
+    crc32_add(&ctx, &buf[i], std::min(chunk, buf.size() - i));
+  }
+  EXPECT_EQ(crc32_finish(&ctx), 0xa2912082);
+}
+
 TEST_P(CrcTest, Crc32Add8) {
   uint32_t ctx;
   crc32_init(&ctx);
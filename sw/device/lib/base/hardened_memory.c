@@ -10,6 +10,45 @@
 
 // NOTE: The three hardened_mem* functions have similar contents, but the parts
 // that are shared between them are commented only in `memcpy()`.
+
+/**
+ * Copies the word at `byte_idx` for `hardened_memcpy()`, or copies between
+ * decoys if `byte_idx` is past the end of the buffers.
+ */
+static OT_ALWAYS_INLINE void memcpy_word(uintptr_t dest_addr,
+                                         uintptr_t src_addr,
+                                         uintptr_t decoy_addr,
+                                         size_t decoys_len, size_t byte_idx,
+                                         size_t byte_len) {
+  // Prevent the compiler from reordering the loop; this ensures a
+  // happens-before among indices consistent with `order`.
+  barrierw(byte_idx);
+
+  // Compute putative offsets into `src`, `dest`, and `decoys`. Some of these
+  // may go off the end of `src` and `dest`, but they will not be cast to
+  // pointers in that case. (Note that casting out-of-range addresses to
+  // pointers is UB.)
+  uintptr_t srcp = src_addr + byte_idx;
+  uintptr_t destp = dest_addr + byte_idx;
+  uintptr_t decoy1 = decoy_addr + (byte_idx % decoys_len);
+  uintptr_t decoy2 = decoy_addr + ((byte_idx + decoys_len / 2) % decoys_len);
+
+  // Branchlessly select whether to do a "real" copy or a decoy copy,
+  // depending on whether we've gone off the end of the array or not.
+  //
+  // Pretty much everything needs to be laundered: we need to launder
+  // `byte_idx` for obvious reasons, and we need to launder the result of the
+  // select, so that the compiler cannot delete the resulting loads and
+  // stores. This is similar to having used `volatile uint32_t *`.
+  void *src = (void *)launderw(
+      ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), srcp, decoy1));
+  void *dest = (void *)launderw(
+      ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), destp, decoy2));
+
+  // Perform the copy, without performing a typed dereference operation.
+  write_32(read_32(src), dest);
+}
+
 void hardened_memcpy(uint32_t *restrict dest, const uint32_t *restrict src,
                      size_t word_len) {
   random_order_t order;
@@ -36,52 +75,52 @@ void hardened_memcpy(uint32_t *restrict dest, const uint32_t *restrict src,
 
   // We need to launder `count`, so that the SW.LOOP-COMPLETION check is not
   // deleted by the compiler.
+  //
+  // The length of a random order is a multiple of four, so each iteration
+  // handles two of its indices, which halves the loop overhead.
   size_t byte_len = word_len * sizeof(uint32_t);
-  for (; launderw(count) < expected_count; count = launderw(count) + 1) {
-    // The order values themselves are in units of words, but we need `byte_idx`
-    // to be in units of bytes.
+  for (; launderw(count) < expected_count; count = launderw(count) + 2) {
+    // The order values themselves are in units of words, but we need
+    // `byte_idx` to be in units of bytes.
     //
     // The value obtained from `advance()` is laundered, to prevent
     // implementation details from leaking across procedures.
     size_t byte_idx = launderw(random_order_advance(&order)) * sizeof(uint32_t);
+    memcpy_word(dest_addr, src_addr, decoy_addr, sizeof(decoys), byte_idx,
+                byte_len);
 
-    // Prevent the compiler from reordering the loop; this ensures a
-    // happens-before among indices consistent with `order`.
-    barrierw(byte_idx);
-
-    // Compute putative offsets into `src`, `dest`, and `decoys`. Some of these
-    // may go off the end of `src` and `dest`, but they will not be cast to
-    // pointers in that case. (Note that casting out-of-range addresses to
-    // pointers is UB.)
-    uintptr_t srcp = src_addr + byte_idx;
-    uintptr_t destp = dest_addr + byte_idx;
-    uintptr_t decoy1 = decoy_addr + (byte_idx % sizeof(decoys));
-    uintptr_t decoy2 =
-        decoy_addr + ((byte_idx + sizeof(decoys) / 2) % sizeof(decoys));
-
-    // Branchlessly select whether to do a "real" copy or a decoy copy,
-    // depending on whether we've gone off the end of the array or not.
-    //
-    // Pretty much everything needs to be laundered: we need to launder
-    // `byte_idx` for obvious reasons, and we need to launder the result of the
-    // select, so that the compiler cannot delete the resulting loads and
-    // stores. This is similar to having used `volatile uint32_t *`.
-    void *src = (void *)launderw(
-        ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), srcp, decoy1));
-    void *dest = (void *)launderw(
-        ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), destp, decoy2));
-
-    // Perform the copy, without performing a typed dereference operation.
-    write_32(read_32(src), dest);
+    byte_idx = launderw(random_order_advance(&order)) * sizeof(uint32_t);
+    memcpy_word(dest_addr, src_addr, decoy_addr, sizeof(decoys), byte_idx,
+                byte_len);
   }
 
   HARDENED_CHECK_EQ(count, expected_count);
 }
 
-// The source of randomness for shred, which may be replaced at link-time.
+// The default source of randomness for shred. See the header.
 OT_WEAK
 uint32_t hardened_memshred_random_word(void) { return 0xcaffe17e; }
 
+/**
+ * Writes a random word to the word at `byte_idx` for `hardened_memshred()`,
+ * or to a decoy if `byte_idx` is past the end of the buffer.
+ */
+static OT_ALWAYS_INLINE void memshred_word(uintptr_t data_addr,
+                                           uintptr_t decoy_addr,
+                                           size_t decoys_len, size_t byte_idx,
+                                           size_t byte_len) {
+  barrierw(byte_idx);
+
+  uintptr_t datap = data_addr + byte_idx;
+  uintptr_t decoy = decoy_addr + (byte_idx % decoys_len);
+
+  void *data = (void *)launderw(
+      ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), datap, decoy));
+
+  // Write a freshly-generated random word to `*data`.
+  write_32(hardened_memshred_random_word(), data);
+}
+
 void hardened_memshred(uint32_t *dest, size_t word_len) {
   random_order_t order;
   random_order_init(&order, word_len);
@@ -95,23 +134,54 @@ void hardened_memshred(uint32_t *dest, size_t word_len) {
   uintptr_t decoy_addr = (uintptr_t)&decoys;
 
   size_t byte_len = word_len * sizeof(uint32_t);
-  for (; count < expected_count; count = launderw(count) + 1) {
+  for (; launderw(count) < expected_count; count = launderw(count) + 2) {
     size_t byte_idx = launderw(random_order_advance(&order)) * sizeof(uint32_t);
-    barrierw(byte_idx);
+    memshred_word(data_addr, decoy_addr, sizeof(decoys), byte_idx, byte_len);
 
-    uintptr_t datap = data_addr + byte_idx;
-    uintptr_t decoy = decoy_addr + (byte_idx % sizeof(decoys));
-
-    void *data = (void *)launderw(
-        ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), datap, decoy));
-
-    // Write a freshly-generated random word to `*data`.
-    write_32(hardened_memshred_random_word(), data);
+    byte_idx = launderw(random_order_advance(&order)) * sizeof(uint32_t);
+    memshred_word(data_addr, decoy_addr, sizeof(decoys), byte_idx, byte_len);
   }
 
   HARDENED_CHECK_EQ(count, expected_count);
 }
 
+/**
+ * Compares the words at `byte_idx` for `hardened_memeq()`, or two decoys if
+ * `byte_idx` is past the end of the buffers, accumulating into `zeros` and
+ * `ones`.
+ */
+static OT_ALWAYS_INLINE void memeq_word(uintptr_t lhs_addr, uintptr_t rhs_addr,
+                                        uintptr_t decoy_addr,
+                                        size_t decoys_len, size_t byte_idx,
+                                        size_t byte_len, uint32_t *zeros,
+                                        uint32_t *ones) {
+  barrierw(byte_idx);
+
+  uintptr_t ap = lhs_addr + byte_idx;
+  uintptr_t bp = rhs_addr + byte_idx;
+  uintptr_t decoy1 = decoy_addr + (byte_idx % decoys_len);
+  uintptr_t decoy2 = decoy_addr + ((byte_idx + decoys_len / 2) % decoys_len);
+
+  void *av = (void *)launderw(
+      ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), ap, decoy1));
+  void *bv = (void *)launderw(
+      ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), bp, decoy2));
+
+  uint32_t a = read_32(av);
+  uint32_t b = read_32(bv);
+
+  // Launder one of the operands, so that the compiler cannot cache the result
+  // of the xor for use in the next operation.
+  //
+  // We launder `zeroes` so that compiler cannot learn that `zeroes` has
+  // strictly more bits set at the end of the loop.
+  *zeros = launder32(*zeros) | (launder32(a) ^ b);
+
+  // Same as above. The compiler can cache the value of `a[offset]`, but it
+  // has no chance to strength-reduce this operation.
+  *ones = launder32(*ones) & (launder32(a) ^ ~b);
+}
+
 hardened_bool_t hardened_memeq(const uint32_t *lhs, const uint32_t *rhs,
                                size_t word_len) {
   random_order_t order;
@@ -138,34 +208,14 @@ hardened_bool_t hardened_memeq(const uint32_t *lhs, const uint32_t *rhs,
   // The loop is almost token-for-token the one above, but the copy is
   // replaced with something else.
   size_t byte_len = word_len * sizeof(uint32_t);
-  for (; count < expected_count; count = launderw(count) + 1) {
+  for (; launderw(count) < expected_count; count = launderw(count) + 2) {
     size_t byte_idx = launderw(random_order_advance(&order)) * sizeof(uint32_t);
-    barrierw(byte_idx);
-
-    uintptr_t ap = lhs_addr + byte_idx;
-    uintptr_t bp = rhs_addr + byte_idx;
-    uintptr_t decoy1 = decoy_addr + (byte_idx % sizeof(decoys));
-    uintptr_t decoy2 =
-        decoy_addr + ((byte_idx + sizeof(decoys) / 2) % sizeof(decoys));
-
-    void *av = (void *)launderw(
-        ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), ap, decoy1));
-    void *bv = (void *)launderw(
-        ct_cmovw(ct_sltuw(launderw(byte_idx), byte_len), bp, decoy2));
-
-    uint32_t a = read_32(av);
-    uint32_t b = read_32(bv);
-
-    // Launder one of the operands, so that the compiler cannot cache the result
-    // of the xor for use in the next operation.
-    //
-    // We launder `zeroes` so that compiler cannot learn that `zeroes` has
-    // strictly more bits set at the end of the loop.
-    zeros = launder32(zeros) | (launder32(a) ^ b);
+    memeq_word(lhs_addr, rhs_addr, decoy_addr, sizeof(decoys), byte_idx,
+               byte_len, &zeros, &ones);
 
-    // Same as above. The compiler can cache the value of `a[offset]`, but it
-    // has no chance to strength-reduce this operation.
-    ones = launder32(ones) & (launder32(a) ^ ~b);
+    byte_idx = launderw(random_order_advance(&order)) * sizeof(uint32_t);
+    memeq_word(lhs_addr, rhs_addr, decoy_addr, sizeof(decoys), byte_idx,
+               byte_len, &zeros, &ones);
   }
 
   HARDENED_CHECK_EQ(count, expected_count);
@@ -59,6 +59,18 @@ void hardened_memcpy(uint32_t *OT_RESTRICT dest,
  */
 void hardened_memshred(uint32_t *dest, size_t word_len);
 
+/**
+ * Returns the random word that `hardened_memshred()` writes to each word.
+ *
+ * The default definition returns a fixed value and is weak, since
+ * `sw/device/lib/base` cannot read the entropy sources itself. Drivers that
+ * have access to entropy, such as the silicon_creator `rnd` driver, replace it
+ * at link time.
+ *
+ * @return A random word.
+ */
+uint32_t hardened_memshred_random_word(void);
+
 /**
  * Compare two potentially-overlapping 32-bit aligned regions of memory for
  * equality.
@@ -0,0 +1,75 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/hardened_memory.h"
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ottf_test_config.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  kMaxWords = 128,
+  kNumRepetitions = 4,
+};
+
+typedef enum hardened_func {
+  kHardenedFuncMemcpy,
+  kHardenedFuncMemeq,
+  kHardenedFuncMemshred,
+} hardened_func_t;
+
+static uint32_t buf1[kMaxWords];
+static uint32_t buf2[kMaxWords];
+
+// Returns the smallest number of cycles that `func` took on `len` words.
+static uint32_t measure(hardened_func_t func, size_t len) {
+  uint64_t best = UINT64_MAX;
+  for (size_t i = 0; i < kNumRepetitions; ++i) {
+    const uint64_t start_cycles = ibex_mcycle_read();
+    switch (func) {
+      case kHardenedFuncMemcpy:
+        hardened_memcpy(buf1, buf2, len);
+        break;
+      case kHardenedFuncMemeq:
+        CHECK(hardened_memeq(buf1, buf2, len) == kHardenedBoolTrue);
+        break;
+      case kHardenedFuncMemshred:
+        hardened_memshred(buf1, len);
+        break;
+    }
+    const uint64_t num_cycles = ibex_mcycle_read() - start_cycles;
+    if (num_cycles < best) {
+      best = num_cycles;
+    }
+  }
+  CHECK(best <= UINT32_MAX);
+  return (uint32_t)best;
+}
+
+bool test_main(void) {
+  for (size_t i = 0; i < kMaxWords; ++i) {
+    buf2[i] = 0x9e3779b9 * (i + 1);
+  }
+
+  // Key and digest sizes, in words, and a few larger buffers.
+  const size_t kLengths[] = {4, 8, 12, 16, 24, 32, 64, 128};
+  for (size_t i = 0; i < ARRAYSIZE(kLengths); ++i) {
+    const size_t len = kLengths[i];
+    uint32_t memcpy_cycles = measure(kHardenedFuncMemcpy, len);
+    // `buf1` now equals `buf2`.
+    uint32_t memeq_cycles = measure(kHardenedFuncMemeq, len);
+    uint32_t memshred_cycles = measure(kHardenedFuncMemshred, len);
+    LOG_INFO("%3d words: memcpy %6d, memeq %6d, memshred %6d cycles",
+             (uint32_t)len, memcpy_cycles, memeq_cycles, memshred_cycles);
+  }
+  return true;
+}
@@ -4,10 +4,12 @@
 
 #include "sw/device/lib/base/hardened_memory.h"
 
+#include <numeric>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "sw/device/lib/base/random_order.h"
 
 // NOTE: This test does not verify hardening measures; it only checks that the
 // "normal" contract of the functions is upheld.
@@ -33,7 +35,21 @@ constexpr uint32_t kRandomWord = 0xdeadbeef;
 
 // Override whatever the default randomness source is so we can verify it
 // actually gets used.
-extern "C" size_t hardened_memshred_random_word() { return kRandomWord; }
+extern "C" uint32_t hardened_memshred_random_word() { return kRandomWord; }
+
+TEST(HardenedMemory, MemcpyVaryingLengths) {
+  for (size_t len = 0; len <= 33; ++len) {
+    SCOPED_TRACE(testing::Message() << "len=" << len);
+    std::vector<uint32_t> xs(len + 1);
+    std::iota(xs.begin(), xs.end(), 1);
+    std::vector<uint32_t> ys(len + 1, 0);
+
+    hardened_memcpy(ys.data(), xs.data(), len);
+    std::vector<uint32_t> expected(xs.begin(), xs.begin() + len);
+    expected.push_back(0);
+    EXPECT_EQ(ys, expected);
+  }
+}
 
 TEST(HardenedMemory, MemShred) {
   std::vector<uint32_t> xs = {1, 2, 3, 4, 5, 6, 7, 8};
@@ -42,6 +58,18 @@ TEST(HardenedMemory, MemShred) {
   EXPECT_THAT(xs, Each(kRandomWord));
 }
 
+TEST(HardenedMemory, MemShredVaryingLengths) {
+  for (size_t len = 0; len <= 33; ++len) {
+    SCOPED_TRACE(testing::Message() << "len=" << len);
+    std::vector<uint32_t> xs(len + 1, 1);
+    hardened_memshred(xs.data(), len);
+
+    std::vector<uint32_t> expected(len, kRandomWord);
+    expected.push_back(1);
+    EXPECT_EQ(xs, expected);
+  }
+}
+
 TEST(HardenedMemory, MemEq) {
   std::vector<uint32_t> xs = {1, 2, 3, 4, 5, 6, 7, 8};
   std::vector<uint32_t> ys = xs;
@@ -53,5 +81,54 @@ TEST(HardenedMemory, MemEq) {
             kHardenedBoolFalse);
 }
 
+TEST(HardenedMemory, MemEqVaryingLengths) {
+  for (size_t len = 0; len <= 33; ++len) {
+    SCOPED_TRACE(testing::Message() << "len=" << len);
+    std::vector<uint32_t> xs(len + 1);
+    std::iota(xs.begin(), xs.end(), 1);
+    std::vector<uint32_t> ys = xs;
+    // Past the end, so not compared.
+    ++ys[len];
+    EXPECT_EQ(hardened_memeq(xs.data(), ys.data(), len), kHardenedBoolTrue);
+
+    for (size_t i = 0; i < len; ++i) {
+      std::vector<uint32_t> zs = xs;
+      zs[i] ^= 1u << (i % 32);
+      EXPECT_EQ(hardened_memeq(xs.data(), zs.data(), len), kHardenedBoolFalse)
+          << "i=" << i;
+    }
+  }
+}
+
+TEST(RandomOrder, VisitsEveryIndexOnce) {
+  for (size_t len = 0; len <= 70; ++len) {
+    SCOPED_TRACE(testing::Message() << "len=" << len);
+    random_order_t order;
+    random_order_init(&order, len);
+
+    size_t order_len = random_order_len(&order);
+    EXPECT_GT(order_len, len);
+    EXPECT_EQ(order_len % 4, 0);
+
+    std::vector<int> visits(order_len, 0);
+    for (size_t i = 0; i < order_len; ++i) {
+      size_t idx = random_order_advance(&order);
+      ASSERT_LT(idx, order_len);
+      ++visits[idx];
+    }
+    EXPECT_THAT(visits, Each(1));
+  }
+}
+
+// Digests and keys usually have power-of-two lengths, so the walk must not
+// shrink to exactly `n` for them, or they would get no decoy iterations.
+TEST(RandomOrder, PowersOfTwoGetDecoys) {
+  for (size_t len = 4; len <= 1024; len *= 2) {
+    random_order_t order;
+    random_order_init(&order, len);
+    EXPECT_EQ(random_order_len(&order), len * 2) << "len=" << len;
+  }
+}
+
 }  // namespace
 }  // namespace hardened_memory_unittest
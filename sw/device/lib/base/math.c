@@ -11,29 +11,106 @@
  */
 extern size_t ceil_div(size_t a, size_t b);
 
+/**
+ * Divides the 64-bit value `(u1 << 32) | u0` by `v` with 32-bit operations.
+ *
+ * This is Knuth's Algorithm D for a two-digit divisor in base 2^16, following
+ * `divlu` in Hacker's Delight (2nd ed., figure 9-3). The divisor is shifted
+ * so that its top bit is set, which guarantees that each estimated quotient
+ * digit is at most two too large.
+ *
+ * Requires `u1 < v`, so that the quotient fits in 32 bits.
+ *
+ * @param u1 The high word of the dividend.
+ * @param u0 The low word of the dividend.
+ * @param v The divisor.
+ * @param[out] rem_out The remainder.
+ * @return The quotient.
+ */
+static uint32_t udiv64_by_32(uint32_t u1, uint32_t u0, uint32_t v,
+                             uint32_t *rem_out) {
+  const uint32_t kBase = 1u << 16;
+
+  // Normalize the divisor and shift the dividend along with it.
+  uint32_t shift = (uint32_t)__builtin_clz(v);
+  v <<= shift;
+  uint32_t vn1 = v >> 16;
+  uint32_t vn0 = v & 0xffff;
+  uint32_t un32 = u1 << shift;
+  if (shift != 0) {
+    un32 |= u0 >> (32 - shift);
+  }
+  uint32_t un10 = u0 << shift;
+  uint32_t un1 = un10 >> 16;
+  uint32_t un0 = un10 & 0xffff;
+
+  // Estimate the high quotient digit from the top digits and correct it.
+  uint32_t q1 = un32 / vn1;
+  uint32_t rhat = un32 - q1 * vn1;
+  while (q1 >= kBase || q1 * vn0 > kBase * rhat + un1) {
+    --q1;
+    rhat += vn1;
+    if (rhat >= kBase) {
+      break;
+    }
+  }
+
+  // Same for the low quotient digit, using the partial remainder.
+  uint32_t un21 = un32 * kBase + un1 - q1 * v;
+  uint32_t q0 = un21 / vn1;
+  rhat = un21 - q0 * vn1;
+  while (q0 >= kBase || q0 * vn0 > kBase * rhat + un0) {
+    --q0;
+    rhat += vn1;
+    if (rhat >= kBase) {
+      break;
+    }
+  }
+
+  *rem_out = (un21 * kBase + un0 - q0 * v) >> shift;
+  return q1 * kBase + q0;
+}
+
 uint64_t udiv64_slow(uint64_t a, uint64_t b, uint64_t *rem_out) {
-  uint64_t quot = 0, rem = 0;
-
-  // Schoolbook long division in base 2. See
-  // https://en.wikipedia.org/wiki/Long_division to recall precisely how this
-  // works. This algorithm is a bit different from the elementary school base-10
-  // version, since we can use shifts instead of multiplication.
-  //
-  // If `b` is zero, `quot == -1` and `rem == a`. This should not be relied
-  // upon.
-  size_t bits = sizeof(uint64_t) * 8;
-  for (size_t i = 0; i < bits; ++i) {
-    rem <<= 1;
-    quot <<= 1;
-    rem |= (a >> (bits - i - 1)) & 1;
-
-    // We need to keep bringing down zeros until `rem`, the running total, is
-    // large enough that we can subtract off `b`; this tells us the value we
-    // would have had to multiply `a` by to produce this current step in the
-    // division.
+  uint64_t quot, rem;
+  uint32_t b_hi = (uint32_t)(b >> 32);
+
+  if (b_hi == 0) {
+    uint32_t b_lo = (uint32_t)b;
+    if (b_lo == 0) {
+      // Division by zero is undefined; return what the old bit-serial
+      // implementation did rather than trapping.
+      quot = UINT64_MAX;
+      rem = a;
+    } else {
+      // Long division with 32-bit digits: the high word is a plain 32-bit
+      // division, and its remainder is carried into the low word.
+      uint32_t a_hi = (uint32_t)(a >> 32);
+      uint32_t q_hi = a_hi / b_lo;
+      uint32_t r_hi = a_hi - q_hi * b_lo;
+      uint32_t r;
+      uint32_t q_lo = udiv64_by_32(r_hi, (uint32_t)a, b_lo, &r);
+      quot = ((uint64_t)q_hi << 32) | q_lo;
+      rem = r;
+    }
+  } else {
+    // The quotient fits in 32 bits. Divide `a / 2` by the top 32 bits of the
+    // normalized divisor to get an estimate that is at most one too large
+    // after undoing the shifts (Hacker's Delight, figure 9-5), then correct
+    // it using the remainder.
+    uint32_t shift = (uint32_t)__builtin_clz(b_hi);
+    uint32_t v1 = (uint32_t)((b << shift) >> 32);
+    uint64_t u = a >> 1;
+    uint32_t unused;
+    uint32_t q1 = udiv64_by_32((uint32_t)(u >> 32), (uint32_t)u, v1, &unused);
+    quot = ((uint64_t)q1 << shift) >> 31;
+    if (quot != 0) {
+      --quot;
+    }
+    rem = a - quot * b;
     if (rem >= b) {
+      ++quot;
       rem -= b;
-      quot |= 1;
     }
   }
 
@@ -42,3 +119,43 @@ uint64_t udiv64_slow(uint64_t a, uint64_t b, uint64_t *rem_out) {
   }
   return quot;
 }
+
+/**
+ * Computes the high 64 bits of the 128-bit product `a * b`.
+ */
+static uint64_t umul64_hi(uint64_t a, uint64_t b) {
+  uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+  uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+  uint64_t lo_lo = a_lo * b_lo;
+  uint64_t hi_lo = a_hi * b_lo;
+  uint64_t lo_hi = a_lo * b_hi;
+  uint64_t hi_hi = a_hi * b_hi;
+  // Cannot overflow: (2^32 - 1)^2 + 2 * (2^32 - 1) < 2^64.
+  uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+  return hi_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+udiv64_reciprocal_t udiv64_reciprocal_init(uint64_t b) {
+  return (udiv64_reciprocal_t){
+      .divisor = b,
+      .multiplier = udiv64_slow(UINT64_MAX, b, NULL),
+  };
+}
+
+uint64_t udiv64_reciprocal(uint64_t a, const udiv64_reciprocal_t *reciprocal,
+                           uint64_t *rem_out) {
+  // With m = floor((2^64 - 1) / b), we have 2^64 - b <= m * b < 2^64, so
+  // a * m / 2^64 is less than a / b but by less than a / 2^64 < 1. The
+  // estimate is therefore exact or one too small.
+  uint64_t quot = umul64_hi(a, reciprocal->multiplier);
+  uint64_t rem = a - quot * reciprocal->divisor;
+  if (rem >= reciprocal->divisor) {
+    ++quot;
+    rem -= reciprocal->divisor;
+  }
+
+  if (rem_out != NULL) {
+    *rem_out = rem;
+  }
+  return quot;
+}
@@ -19,11 +19,14 @@ extern "C" {
  */
 
 /**
- * Computes the 64-bit quotient `a / b` by way of schoolbook long division.
+ * Computes the 64-bit quotient `a / b`.
  *
- * This function is intentionally very slow: 64-bit divisions should not be
- * a frequent occurence, and faster algorithms result in unreasonable code-size
- * expenditure.
+ * RV32 has no 64-bit divide instruction, so this is built from 32-bit `divu`
+ * steps: a divisor that fits in 32 bits takes two long-division steps with
+ * 32-bit digits (Knuth's Algorithm D with a normalized divisor), and a wider
+ * divisor, whose quotient always fits in 32 bits, takes a single step that is
+ * then corrected by at most one. This is much faster than bit-serial long
+ * division while staying small.
  *
  * Performing division with the / operator in C code that runs on a 32-bit
  * device can emit a polyfill like `__udivdi3`; normally, this would
@@ -37,7 +40,7 @@ extern "C" {
  * as a side-product.
  *
  * If `b == 0`, this function produces undefined behavior (in practice, a
- * garbage result or a loop without forward progress).
+ * garbage result).
  *
  * @param a The dividend.
  * @param b The divisor.
@@ -47,6 +50,53 @@ extern "C" {
 OT_WARN_UNUSED_RESULT
 uint64_t udiv64_slow(uint64_t a, uint64_t b, uint64_t *rem_out);
 
+/**
+ * A precomputed reciprocal for repeated division by the same divisor.
+ *
+ * See `udiv64_reciprocal_init()`.
+ */
+typedef struct udiv64_reciprocal {
+  /**
+   * The divisor.
+   */
+  uint64_t divisor;
+  /**
+   * `(2^64 - 1) / divisor`, rounded down.
+   */
+  uint64_t multiplier;
+} udiv64_reciprocal_t;
+
+/**
+ * Precomputes the reciprocal of `b`.
+ *
+ * This costs one `udiv64_slow()`; afterwards, each `udiv64_reciprocal()` by
+ * `b` only needs a few 32-bit multiplications. This is worthwhile for
+ * divisors that are constant at runtime, such as clock frequencies used to
+ * convert cycle counts to time.
+ *
+ * If `b == 0`, this function produces undefined behavior.
+ *
+ * @param b The divisor.
+ * @return The reciprocal of `b`.
+ */
+OT_WARN_UNUSED_RESULT
+udiv64_reciprocal_t udiv64_reciprocal_init(uint64_t b);
+
+/**
+ * Computes the 64-bit quotient `a / b` using a precomputed reciprocal of `b`.
+ *
+ * The result is exact: the quotient estimated from the reciprocal is at most
+ * one too small, and is corrected using the remainder.
+ *
+ * @param a The dividend.
+ * @param reciprocal The reciprocal of the divisor `b`.
+ * @param[out] rem_out An optional out-parameter for the remainder.
+ * @return The quotient.
+ */
+OT_WARN_UNUSED_RESULT
+uint64_t udiv64_reciprocal(uint64_t a, const udiv64_reciprocal_t *reciprocal,
+                           uint64_t *rem_out);
+
 /**
  * Computes ceil(a / b) in an overflow-safe way.
  *
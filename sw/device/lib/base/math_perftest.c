@@ -0,0 +1,98 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/math.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ottf_test_config.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  kNumInputs = 64,
+};
+
+// Bit-serial long division, as `udiv64_slow` used to be, as a reference.
+static uint64_t udiv64_bitwise(uint64_t a, uint64_t b, uint64_t *rem_out) {
+  uint64_t quot = 0, rem = 0;
+  for (size_t i = 0; i < 64; ++i) {
+    rem = (rem << 1) | ((a >> (63 - i)) & 1);
+    quot <<= 1;
+    if (rem >= b) {
+      rem -= b;
+      quot |= 1;
+    }
+  }
+  *rem_out = rem;
+  return quot;
+}
+
+// A small xorshift generator for reproducible inputs.
+static uint64_t next_input(uint64_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+// Divisors covering the cases handled differently by `udiv64_slow`: the
+// typical clock frequency and time-unit divisors, a full 32-bit divisor and
+// two divisors wider than 32 bits.
+static const uint64_t kDivisors[] = {
+    1000, 1000000, 24000000, 100000000, 0xfedcba98, 0x123456789, 0xfedcba9876,
+};
+
+static uint64_t dividends[kNumInputs];
+
+bool test_main(void) {
+  uint64_t state = 0x0123456789abcdef;
+  for (size_t i = 0; i < kNumInputs; ++i) {
+    dividends[i] = next_input(&state);
+  }
+
+  for (size_t d = 0; d < ARRAYSIZE(kDivisors); ++d) {
+    const uint64_t b = kDivisors[d];
+    uint64_t quots[kNumInputs];
+    uint64_t rems[kNumInputs];
+
+    uint64_t start_cycles = ibex_mcycle_read();
+    for (size_t i = 0; i < kNumInputs; ++i) {
+      quots[i] = udiv64_bitwise(dividends[i], b, &rems[i]);
+    }
+    const uint32_t bitwise_cycles =
+        (uint32_t)(ibex_mcycle_read() - start_cycles);
+
+    bool ok = true;
+    start_cycles = ibex_mcycle_read();
+    for (size_t i = 0; i < kNumInputs; ++i) {
+      uint64_t rem;
+      ok &= udiv64_slow(dividends[i], b, &rem) == quots[i] && rem == rems[i];
+    }
+    const uint32_t udiv_cycles = (uint32_t)(ibex_mcycle_read() - start_cycles);
+
+    start_cycles = ibex_mcycle_read();
+    udiv64_reciprocal_t reciprocal = udiv64_reciprocal_init(b);
+    for (size_t i = 0; i < kNumInputs; ++i) {
+      uint64_t rem;
+      ok &= udiv64_reciprocal(dividends[i], &reciprocal, &rem) == quots[i] &&
+            rem == rems[i];
+    }
+    const uint32_t recip_cycles = (uint32_t)(ibex_mcycle_read() - start_cycles);
+
+    LOG_INFO(
+        "Divisor 0x%08x%08x: %d divisions in %d cycles (bit-serial), "
+        "%d cycles (udiv64_slow), %d cycles (reciprocal, including setup).",
+        (uint32_t)(b >> 32), (uint32_t)b, kNumInputs, bitwise_cycles,
+        udiv_cycles, recip_cycles);
+    CHECK(ok, "Division results did not match the bit-serial reference.");
+  }
+  return true;
+}
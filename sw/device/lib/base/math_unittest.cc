@@ -30,6 +30,13 @@ TEST_P(UDivTest, UDiv64) {
   EXPECT_EQ(rem, GetParam().r);
 }
 
+TEST_P(UDivTest, UDiv64Reciprocal) {
+  udiv64_reciprocal_t reciprocal = udiv64_reciprocal_init(GetParam().b);
+  uint64_t rem;
+  EXPECT_EQ(udiv64_reciprocal(GetParam().a, &reciprocal, &rem), GetParam().q);
+  EXPECT_EQ(rem, GetParam().r);
+}
+
 // Simple python snippet for generating vectors:
 //
 // import random
@@ -186,6 +193,18 @@ constexpr DivVector kDivVectors[] = {
   {4572339959429543082ull, 3727623342ull, 1226609971ull, 0},
   {12435319632655456416ull, 3368334101ull, 3691830816ull, 0},
   {16449272219650625118ull, 3921581046ull, 4194551133ull, 0},
+
+  // Edge cases for the quotient estimates.
+  {0ull, 1ull, 0ull, 0ull},
+  {18446744073709551615ull, 1ull, 18446744073709551615ull, 0ull},
+  {18446744073709551615ull, 18446744073709551615ull, 1ull, 0ull},
+  {18446744073709551614ull, 18446744073709551615ull, 0ull, 18446744073709551614ull},
+  {18446744073709551615ull, 4294967295ull, 4294967297ull, 0ull},
+  {18446744073709551615ull, 4294967296ull, 4294967295ull, 4294967295ull},
+  {18446744073709551615ull, 4294967297ull, 4294967295ull, 0ull},
+  {18446744073709551615ull, 9223372036854775808ull, 1ull, 9223372036854775807ull},
+  {9223372036854775808ull, 2147483648ull, 4294967296ull, 0ull},
+  {12345678901234567890ull, 24000000ull, 514403287551ull, 10567890ull},
 };
 // clang-format on
 
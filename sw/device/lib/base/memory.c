@@ -58,6 +58,79 @@ static uint32_t repeat_byte_to_u32(uint8_t byte) {
   return word << 24 | word << 16 | word << 8 | word;
 }
 
+/**
+ * Find the zero bytes of a word.
+ *
+ * The result is nonzero in exactly the bytes that are zero in `word`, so the
+ * first and last of them can be found with `__builtin_ctz()` and
+ * `__builtin_clz()`. With the Zbb extension, this is a single `orc.b`.
+ *
+ * @param word The word to search.
+ * @return A mask of the zero bytes of `word`.
+ */
+static uint32_t zero_bytes_of(uint32_t word) {
+#if defined(OT_PLATFORM_RV32) && defined(__riscv_zbb)
+  uint32_t nonzero_bytes;
+  asm("orc.b %0, %1" : "=r"(nonzero_bytes) : "r"(word));
+  return ~nonzero_bytes;
+#else
+  // Adding 0x7f to the low seven bits of a byte carries into its top bit if
+  // any of them are set, so the top bit ends up clear only for zero bytes.
+  const uint32_t kLow7 = 0x7f7f7f7f;
+  return ~(((word & kLow7) + kLow7) | word | kLow7);
+#endif
+}
+
+/**
+ * Copy words to an aligned destination from a source that is not aligned.
+ *
+ * The source is read one aligned word at a time, and each destination word is
+ * merged from the top of one source word and the bottom of the next, so there
+ * are no byte accesses in the loop. Only words that lie entirely within
+ * `src8[0:len]` are read.
+ *
+ * @param dest8 The destination buffer.
+ * @param src8 The source buffer.
+ * @param i The offset to start at, where `&dest8[i]` is word-aligned and
+ * `&src8[i]` is not.
+ * @param len The length in bytes of both buffers.
+ * @return The offset of the first byte that was not copied.
+ */
+static size_t memcpy_shifted(unsigned char *restrict dest8,
+                             const unsigned char *restrict src8, size_t i,
+                             size_t len) {
+  const size_t src_ahead = OT_UNSIGNED(misalignment32_of((uintptr_t)&src8[i]));
+  if (i < src_ahead) {
+    // The aligned word containing `src8[i]` starts before the buffer, so copy
+    // one word of bytes first (which keeps the destination aligned).
+    if (len - i < sizeof(uint32_t)) {
+      return i;
+    }
+    for (size_t end = i + sizeof(uint32_t); i < end; ++i) {
+      dest8[i] = src8[i];
+    }
+  }
+
+  // Each iteration reads the source word after `prev`, which ends at
+  // `src8[i - src_ahead + 7]`.
+  if (i - src_ahead + 2 * sizeof(uint32_t) > len) {
+    return i;
+  }
+  const unsigned char *src_word = &src8[i - src_ahead];
+  const unsigned int right = 8 * (unsigned int)src_ahead;
+  const unsigned int left = 32 - right;
+  static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+                "memcpy assumes that the system is little endian.");
+  uint32_t prev = read_32(src_word);
+  for (; i - src_ahead + 2 * sizeof(uint32_t) <= len; i += sizeof(uint32_t)) {
+    src_word += sizeof(uint32_t);
+    uint32_t next = read_32(src_word);
+    write_32(prev >> right | next << left, &dest8[i]);
+    prev = next;
+  }
+  return i;
+}
+
 void *OT_PREFIX_IF_NOT_RV32(memcpy)(void *restrict dest,
                                     const void *restrict src, size_t len) {
   if (dest == NULL || src == NULL) {
@@ -65,15 +138,28 @@ void *OT_PREFIX_IF_NOT_RV32(memcpy)(void *restrict dest,
   }
   unsigned char *dest8 = (unsigned char *)dest;
   const unsigned char *src8 = (const unsigned char *)src;
-  size_t body_offset, tail_offset;
-  compute_alignment(dest, src, len, &body_offset, &tail_offset);
   size_t i = 0;
-  for (; i < body_offset; ++i) {
-    dest8[i] = src8[i];
-  }
-  for (; i < tail_offset; i += sizeof(uint32_t)) {
-    uint32_t word = read_32(&src8[i]);
-    write_32(word, &dest8[i]);
+  if (len >= 2 * sizeof(uint32_t)) {
+    for (; misalignment32_of((uintptr_t)&dest8[i]) != 0; ++i) {
+      dest8[i] = src8[i];
+    }
+    if (misalignment32_of((uintptr_t)&src8[i]) == 0) {
+      for (; len - i >= 4 * sizeof(uint32_t); i += 4 * sizeof(uint32_t)) {
+        uint32_t word0 = read_32(&src8[i]);
+        uint32_t word1 = read_32(&src8[i + 4]);
+        uint32_t word2 = read_32(&src8[i + 8]);
+        uint32_t word3 = read_32(&src8[i + 12]);
+        write_32(word0, &dest8[i]);
+        write_32(word1, &dest8[i + 4]);
+        write_32(word2, &dest8[i + 8]);
+        write_32(word3, &dest8[i + 12]);
+      }
+      for (; len - i >= sizeof(uint32_t); i += sizeof(uint32_t)) {
+        write_32(read_32(&src8[i]), &dest8[i]);
+      }
+    } else {
+      i = memcpy_shifted(dest8, src8, i, len);
+    }
   }
   for (; i < len; ++i) {
     dest8[i] = src8[i];
@@ -92,6 +178,12 @@ void *OT_PREFIX_IF_NOT_RV32(memset)(void *dest, int value, size_t len) {
     dest8[i] = value8;
   }
   const uint32_t value32 = repeat_byte_to_u32(value8);
+  for (; tail_offset - i >= 4 * sizeof(uint32_t); i += 4 * sizeof(uint32_t)) {
+    write_32(value32, &dest8[i]);
+    write_32(value32, &dest8[i + 4]);
+    write_32(value32, &dest8[i + 8]);
+    write_32(value32, &dest8[i + 12]);
+  }
   for (; i < tail_offset; i += sizeof(uint32_t)) {
     write_32(value32, &dest8[i]);
   }
@@ -107,43 +199,106 @@ enum {
   kMemCmpGt = 42,
 };
 
-int OT_PREFIX_IF_NOT_RV32(memcmp)(const void *lhs, const void *rhs,
-                                  size_t len) {
-  const unsigned char *lhs8 = (const unsigned char *)lhs;
-  const unsigned char *rhs8 = (const unsigned char *)rhs;
-  size_t body_offset, tail_offset;
-  compute_alignment(lhs, rhs, len, &body_offset, &tail_offset);
-  size_t i = 0;
-  for (; i < body_offset; ++i) {
+static int memcmp_bytes(const unsigned char *lhs8, const unsigned char *rhs8,
+                        size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
     if (lhs8[i] < rhs8[i]) {
       return kMemCmpLt;
     } else if (lhs8[i] > rhs8[i]) {
       return kMemCmpGt;
     }
   }
-  for (; i < tail_offset; i += sizeof(uint32_t)) {
-#if OT_BUILD_FOR_STATIC_ANALYZER
-    assert(&lhs8[i] != NULL);
-    assert(&rhs8[i] != NULL);
-#endif
-    uint32_t word_left = __builtin_bswap32(read_32(&lhs8[i]));
-    uint32_t word_right = __builtin_bswap32(read_32(&rhs8[i]));
-    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
-                  "memcmp assumes that the system is little endian.");
-    if (word_left < word_right) {
-      return kMemCmpLt;
-    } else if (word_left > word_right) {
-      return kMemCmpGt;
+  return kMemCmpEq;
+}
+
+/**
+ * Compare two words that differ, as `memcmp()` would compare their bytes.
+ */
+static int memcmp_words(uint32_t lhs, uint32_t rhs) {
+  // On a little endian system, the first byte that differs is the lowest one.
+  static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+                "memcmp assumes that the system is little endian.");
+  const unsigned int shift = (unsigned int)__builtin_ctz(lhs ^ rhs) & ~7u;
+  return ((lhs >> shift) & UINT8_MAX) < ((rhs >> shift) & UINT8_MAX)
+             ? kMemCmpLt
+             : kMemCmpGt;
+}
+
+/**
+ * Skip the equal words of an aligned buffer and one that is not aligned.
+ *
+ * This reads `rhs8` in the same way as `memcpy_shifted()`.
+ *
+ * @param lhs8 The first buffer.
+ * @param rhs8 The second buffer.
+ * @param i The offset to start at, where `&lhs8[i]` is word-aligned and
+ * `&rhs8[i]` is not.
+ * @param len The length in bytes of both buffers.
+ * @return The offset of the first word that differs, or of the first byte
+ * that was not compared.
+ */
+static size_t memcmp_shifted(const unsigned char *lhs8,
+                             const unsigned char *rhs8, size_t i, size_t len) {
+  const size_t rhs_ahead = OT_UNSIGNED(misalignment32_of((uintptr_t)&rhs8[i]));
+  if (i < rhs_ahead) {
+    // The aligned word containing `rhs8[i]` starts before the buffer, so
+    // compare one word of bytes first, as `memcpy_shifted()` does.
+    if (len - i < sizeof(uint32_t) ||
+        memcmp_bytes(lhs8, rhs8, i, i + sizeof(uint32_t)) != kMemCmpEq) {
+      return i;
     }
+    i += sizeof(uint32_t);
   }
-  for (; i < len; ++i) {
-    if (lhs8[i] < rhs8[i]) {
-      return kMemCmpLt;
-    } else if (lhs8[i] > rhs8[i]) {
-      return kMemCmpGt;
+
+  if (i - rhs_ahead + 2 * sizeof(uint32_t) > len) {
+    return i;
+  }
+  const unsigned char *rhs_word = &rhs8[i - rhs_ahead];
+  const unsigned int right = 8 * (unsigned int)rhs_ahead;
+  const unsigned int left = 32 - right;
+  uint32_t prev = read_32(rhs_word);
+  for (; i - rhs_ahead + 2 * sizeof(uint32_t) <= len; i += sizeof(uint32_t)) {
+    rhs_word += sizeof(uint32_t);
+    uint32_t next = read_32(rhs_word);
+    if (read_32(&lhs8[i]) != (prev >> right | next << left)) {
+      break;
     }
+    prev = next;
   }
-  return kMemCmpEq;
+  return i;
+}
+
+int OT_PREFIX_IF_NOT_RV32(memcmp)(const void *lhs, const void *rhs,
+                                  size_t len) {
+  const unsigned char *lhs8 = (const unsigned char *)lhs;
+  const unsigned char *rhs8 = (const unsigned char *)rhs;
+  size_t i = 0;
+  if (len >= 2 * sizeof(uint32_t)) {
+    const size_t lhs_ahead = OT_UNSIGNED(misalignment32_of((uintptr_t)lhs));
+    const size_t head = (4 - lhs_ahead) & 0x3;
+    int result = memcmp_bytes(lhs8, rhs8, 0, head);
+    if (result != kMemCmpEq) {
+      return result;
+    }
+    i = head;
+    if (misalignment32_of((uintptr_t)&rhs8[i]) == 0) {
+      for (; len - i >= sizeof(uint32_t); i += sizeof(uint32_t)) {
+#if OT_BUILD_FOR_STATIC_ANALYZER
+        assert(&lhs8[i] != NULL);
+        assert(&rhs8[i] != NULL);
+#endif
+        uint32_t word_left = read_32(&lhs8[i]);
+        uint32_t word_right = read_32(&rhs8[i]);
+        if (word_left != word_right) {
+          return memcmp_words(word_left, word_right);
+        }
+      }
+    } else {
+      // The bytes of a word that differs are compared one by one below.
+      i = memcmp_shifted(lhs8, rhs8, i, len);
+    }
+  }
+  return memcmp_bytes(lhs8, rhs8, i, len);
 }
 
 int memrcmp(const void *lhs, const void *rhs, size_t len) {
@@ -201,21 +356,11 @@ void *OT_PREFIX_IF_NOT_RV32(memchr)(const void *ptr, int value, size_t len) {
   }
   const uint32_t value32 = repeat_byte_to_u32(value8);
   for (; i < tail_offset; i += sizeof(uint32_t)) {
-    uint32_t word = read_32(&ptr8[i]);
-    uint32_t bits_eq = ~(word ^ value32);
+    uint32_t matches = zero_bytes_of(read_32(&ptr8[i]) ^ value32);
     static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
                   "memchr assumes that the system is little endian.");
-    if ((bits_eq & UINT8_MAX) == UINT8_MAX) {
-      return (void *)&ptr8[i];
-    }
-    if (((bits_eq >> 8) & UINT8_MAX) == UINT8_MAX) {
-      return (void *)&ptr8[i + 1];
-    }
-    if (((bits_eq >> 16) & UINT8_MAX) == UINT8_MAX) {
-      return (void *)&ptr8[i + 2];
-    }
-    if (((bits_eq >> 24) & UINT8_MAX) == UINT8_MAX) {
-      return (void *)&ptr8[i + 3];
+    if (matches != 0) {
+      return (void *)&ptr8[i + (size_t)__builtin_ctz(matches) / 8];
     }
   }
   for (; i < len; ++i) {
@@ -243,21 +388,11 @@ void *OT_PREFIX_IF_NOT_RV32(memrchr)(const void *ptr, int value, size_t len) {
   const uint32_t value32 = repeat_byte_to_u32(value8);
   for (; end > body_offset; end -= sizeof(uint32_t)) {
     const size_t i = end - sizeof(uint32_t);
-    uint32_t word = read_32(&ptr8[i]);
-    uint32_t bits_eq = ~(word ^ value32);
+    uint32_t matches = zero_bytes_of(read_32(&ptr8[i]) ^ value32);
     static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
                   "memrchr assumes that the system is little endian.");
-    if (((bits_eq >> 24) & UINT8_MAX) == UINT8_MAX) {
-      return (void *)&ptr8[i + 3];
-    }
-    if (((bits_eq >> 16) & UINT8_MAX) == UINT8_MAX) {
-      return (void *)&ptr8[i + 2];
-    }
-    if (((bits_eq >> 8) & UINT8_MAX) == UINT8_MAX) {
-      return (void *)&ptr8[i + 1];
-    }
-    if ((bits_eq & UINT8_MAX) == UINT8_MAX) {
-      return (void *)&ptr8[i];
+    if (matches != 0) {
+      return (void *)&ptr8[i + (size_t)(31 - __builtin_clz(matches)) / 8];
     }
   }
   for (; end > 0; --end) {
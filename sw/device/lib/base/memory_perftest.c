@@ -32,6 +32,13 @@ typedef struct perf_test {
   // measured.
   void (*func)(uint8_t *buf1, uint8_t *buf2, size_t num_runs);
 
+  // The number of bytes to pass to `func`, and the offsets into each buffer
+  // that it sees, which select the alignment of the buffers. The length plus
+  // either offset must not exceed `kBufLen`.
+  size_t len;
+  size_t buf1_offset;
+  size_t buf2_offset;
+
   // The expected number of CPU cycles that `func` will take to run.
   size_t expected_max_num_cycles;
 } perf_test_t;
@@ -42,6 +49,9 @@ static inline uint64_t perf_test_run(const perf_test_t *test, uint8_t *buf1,
   CHECK(test->setup_buf1 != NULL);
   CHECK(test->setup_buf2 != NULL);
   CHECK(test->func != NULL);
+  CHECK(test->len > 0);
+  CHECK(test->len + test->buf1_offset <= kBufLen);
+  CHECK(test->len + test->buf2_offset <= kBufLen);
 
   uint64_t total_clock_cycles = 0;
   for (size_t i = 0; i < num_runs; ++i) {
@@ -49,7 +59,7 @@ static inline uint64_t perf_test_run(const perf_test_t *test, uint8_t *buf1,
     test->setup_buf2(buf2, kBufLen);
 
     uint64_t start_cycles = ibex_mcycle_read();
-    test->func(buf1, buf2, kBufLen);
+    test->func(buf1 + test->buf1_offset, buf2 + test->buf2_offset, test->len);
     uint64_t end_cycles = ibex_mcycle_read();
 
     // Even if the 64-bit cycle counter overflowed while running the test, the
@@ -148,6 +158,7 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_deterministic_values,
         .setup_buf2 = &fill_buf_deterministic_values,
         .func = &test_memcpy,
+        .len = kBufLen,
         .expected_max_num_cycles = 33270,
     },
     {
@@ -155,6 +166,7 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_deterministic_values,
         .setup_buf2 = &fill_buf_zeroes,
         .func = &test_memcpy,
+        .len = kBufLen,
         .expected_max_num_cycles = 33270,
     },
     {
@@ -162,6 +174,7 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_zeroes,
         .setup_buf2 = &fill_buf_deterministic_values,
         .func = &test_memset,
+        .len = kBufLen,
         .expected_max_num_cycles = 23200,
     },
     {
@@ -169,6 +182,7 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_zeroes,
         .setup_buf2 = &fill_buf_zeroes,
         .func = &test_memset,
+        .len = kBufLen,
         .expected_max_num_cycles = 23200,
     },
     {
@@ -176,6 +190,7 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_zeroes_then_one,
         .setup_buf2 = &fill_buf_zeroes,
         .func = &test_memcmp,
+        .len = kBufLen,
         .expected_max_num_cycles = 110740,
     },
     {
@@ -183,6 +198,7 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_zeroes,
         .setup_buf2 = &fill_buf_zeroes,
         .func = &test_memcmp,
+        .len = kBufLen,
         .expected_max_num_cycles = 110740,
     },
     {
@@ -190,6 +206,7 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_zeroes,
         .setup_buf2 = &fill_buf_one_then_zeroes,
         .func = &test_memrcmp,
+        .len = kBufLen,
         .expected_max_num_cycles = 50740,
     },
     {
@@ -197,6 +214,7 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_zeroes,
         .setup_buf2 = &fill_buf_zeroes,
         .func = &test_memrcmp,
+        .len = kBufLen,
         .expected_max_num_cycles = 50850,
     },
     {
@@ -204,6 +222,7 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_deterministic_values,
         .setup_buf2 = &fill_buf_zeroes,
         .func = &test_memchr,
+        .len = kBufLen,
         .expected_max_num_cycles = 7250,
     },
     {
@@ -211,12 +230,14 @@ static const perf_test_t kPerfTests[] = {
         .setup_buf1 = &fill_buf_deterministic_values,
         .setup_buf2 = &fill_buf_deterministic_values,
         .func = &test_memrchr,
+        .len = kBufLen,
         .expected_max_num_cycles = 23850,
     },
 };
 
-static uint8_t buf1[kBufLen];
-static uint8_t buf2[kBufLen];
+// Word-aligned, so that the offsets in `kPerfTests` give the alignments.
+static uint8_t buf1[kBufLen] __attribute__((aligned(sizeof(uint32_t))));
+static uint8_t buf2[kBufLen] __attribute__((aligned(sizeof(uint32_t))));
 
 bool test_main(void) {
   bool all_expectations_match = true;
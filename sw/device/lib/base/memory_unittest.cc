@@ -193,6 +193,33 @@ TEST_P(MemCpyTest, VaryDestAlignment) {
   }
 }
 
+TEST_P(MemCpyTest, VaryByteAlignment) {
+  auto memcpy_func = GetParam();
+
+  static constexpr size_t kMaxLen = 40;
+  std::vector<uint8_t> src(kMaxLen + 4);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i + 1);
+  }
+
+  for (size_t src_offset = 0; src_offset < 4; ++src_offset) {
+    for (size_t dest_offset = 0; dest_offset < 4; ++dest_offset) {
+      for (size_t len = 0; len <= kMaxLen; ++len) {
+        SCOPED_TRACE(testing::Message()
+                     << "src_offset=" << src_offset
+                     << " dest_offset=" << dest_offset << " len=" << len);
+
+        std::vector<uint8_t> dest(kMaxLen + 8, 0xaa);
+        memcpy_func(&dest[dest_offset], &src[src_offset], len);
+
+        std::vector<uint8_t> expected(kMaxLen + 8, 0xaa);
+        std::copy_n(&src[src_offset], len, &expected[dest_offset]);
+        EXPECT_EQ(dest, expected);
+      }
+    }
+  }
+}
+
 TEST_P(MemCmpTest, NullParam) {
   auto memcmp_func = GetParam();
 
@@ -217,6 +244,30 @@ TEST_P(MemCmpTest, ZeroesVaryingOffsetsAndLengths) {
   }
 }
 
+TEST_P(MemCmpTest, DifferenceAtEachByte) {
+  auto memcmp_func = GetParam();
+
+  static constexpr size_t kMaxLen = 24;
+  for (size_t lhs_offset = 0; lhs_offset < 4; ++lhs_offset) {
+    for (size_t rhs_offset = 0; rhs_offset < 4; ++rhs_offset) {
+      for (size_t len = 1; len <= kMaxLen; ++len) {
+        for (size_t diff = 0; diff < len; ++diff) {
+          SCOPED_TRACE(testing::Message()
+                       << "lhs_offset=" << lhs_offset << " rhs_offset="
+                       << rhs_offset << " len=" << len << " diff=" << diff);
+
+          // With a single byte that differs, `memcmp()` and `memrcmp()` agree.
+          std::vector<uint8_t> lhs(kMaxLen + 4, 0x80);
+          std::vector<uint8_t> rhs(kMaxLen + 4, 0x80);
+          lhs[lhs_offset + diff] = 0x7f;
+          EXPECT_LT(memcmp_func(&lhs[lhs_offset], &rhs[rhs_offset], len), 0);
+          EXPECT_GT(memcmp_func(&rhs[rhs_offset], &lhs[lhs_offset], len), 0);
+        }
+      }
+    }
+  }
+}
+
 TEST_P(MemSetTest, Null) {
   auto memset_func = GetParam();
 
@@ -329,6 +380,28 @@ TEST_P(MemChrTest, VaryingLengths) {
   }
 }
 
+TEST_P(MemChrTest, VaryingAlignments) {
+  auto memchr_func = GetParam();
+
+  static constexpr size_t kMaxLen = 24;
+  for (size_t offset = 0; offset < 4; ++offset) {
+    for (size_t len = 1; len <= kMaxLen; ++len) {
+      for (size_t pos = 0; pos < len; ++pos) {
+        SCOPED_TRACE(testing::Message() << "offset=" << offset
+                                        << " len=" << len << " pos=" << pos);
+
+        // Surround each buffer with the value, which must not be found.
+        std::vector<uint8_t> vec(kMaxLen + 8, 0x80);
+        uint8_t *data = &vec[offset + 1];
+        std::fill_n(data, len, 0x81);
+        data[pos] = 0x80;
+        EXPECT_EQ(memchr_func(data, 0x80, len), data + pos);
+        EXPECT_EQ(memchr_func(data, 0x7f, len), nullptr);
+      }
+    }
+  }
+}
+
 TEST_P(MemChrTest, RepeatedBytes) {
   auto memchr_func = GetParam();
 
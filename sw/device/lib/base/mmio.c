@@ -64,6 +64,24 @@ static void mmio_region_memcpy32(mmio_region_t base, uint32_t offset,
     len -= realignment;
   }
 
+  // If main memory is word-aligned too, whole words can be moved directly,
+  // four at a time, without staging them through `memcpy`.
+  if (misalignment32_of((uintptr_t)buf) == 0) {
+    for (; len >= 4 * sizeof(uint32_t); len -= 4 * sizeof(uint32_t)) {
+      for (size_t i = 0; i < 4; ++i) {
+        ptrdiff_t word_offset = OT_SIGNED(offset + i * sizeof(uint32_t));
+        uint8_t *word = buf + i * sizeof(uint32_t);
+        if (from_mmio) {
+          write_32(mmio_region_read32(base, word_offset), word);
+        } else {
+          mmio_region_write32(base, word_offset, read_32(word));
+        }
+      }
+      offset += 4 * sizeof(uint32_t);
+      buf += 4 * sizeof(uint32_t);
+    }
+  }
+
   // Now, we just do full word I/O until we run out of stuff to act on.
   while (len > 0) {
     // At the end, we may not have a full word to copy, but it's otherwise
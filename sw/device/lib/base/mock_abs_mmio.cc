@@ -29,5 +29,33 @@ void abs_mmio_write32(uint32_t addr, uint32_t value) {
 void abs_mmio_write32_shadowed(uint32_t addr, uint32_t value) {
   MockAbsMmio::Instance().Write32Shadowed(addr, value);
 }
+
+// The bulk accessors are expressed in terms of the single-word mocks, so tests
+// can set expectations on the individual words.
+void abs_mmio_write32_bulk(uint32_t addr, const uint32_t *src,
+                           size_t num_words) {
+  for (size_t i = 0; i < num_words; ++i) {
+    abs_mmio_write32(addr + static_cast<uint32_t>(i * sizeof(uint32_t)),
+                     src[i]);
+  }
+}
+
+void abs_mmio_read32_bulk(uint32_t addr, uint32_t *dest, size_t num_words) {
+  for (size_t i = 0; i < num_words; ++i) {
+    dest[i] = abs_mmio_read32(addr + static_cast<uint32_t>(i * sizeof(uint32_t)));
+  }
+}
+
+size_t abs_mmio_write32_bulk_hardened(uint32_t addr, const uint32_t *src,
+                                      size_t num_words) {
+  abs_mmio_write32_bulk(addr, src, num_words);
+  return num_words;
+}
+
+size_t abs_mmio_read32_bulk_hardened(uint32_t addr, uint32_t *dest,
+                                     size_t num_words) {
+  abs_mmio_read32_bulk(addr, dest, num_words);
+  return num_words;
+}
 }  // extern "C"
 }  // namespace rom_test
@@ -5,15 +5,35 @@
 #include "sw/device/lib/base/random_order.h"
 
 #include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/macros.h"
 
-// TODO: The current implementation is just a skeleton, and currently just
-// traverses from 0 to `min_len * 2`.
+enum {
+  /**
+   * The smallest length of a traversal order.
+   */
+  kRandomOrderMinLen = 4,
+};
+
+OT_WEAK
+uint32_t random_order_random_word(void) { return 0x5ca1ab1e; }
 
 void random_order_init(random_order_t *ctx, size_t min_len) {
-  ctx->state = 0;
-  ctx->max = min_len * 2;
+  // The smallest power of two that is greater than `min_len`.
+  size_t max =
+      (size_t)1 << (32 - bitfield_count_leading_zeroes32((uint32_t)min_len));
+  if (max < kRandomOrderMinLen) {
+    max = kRandomOrderMinLen;
+  }
+
+  // Any odd stride generates all of the integers modulo a power of two.
+  uint32_t seed = random_order_random_word();
+  ctx->max = max;
+  ctx->state = seed & (max - 1);
+  ctx->step = ((seed >> 16) | 1) & (max - 1);
 }
 
-size_t random_order_len(const random_order_t *ctx) { return ctx->max; }
+// `extern` declarations to give the inline functions in the corresponding
+// header a link location.
 
-size_t random_order_advance(random_order_t *ctx) { return ctx->state++; }
+extern size_t random_order_len(const random_order_t *ctx);
+extern size_t random_order_advance(random_order_t *ctx);
@@ -6,6 +6,7 @@
 #define OPENTITAN_SW_DEVICE_LIB_BASE_RANDOM_ORDER_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,9 +32,16 @@ extern "C" {
  * Users must be mindful of these constraints when using `random_order_t`.
  * These caveats are intended to allow for implementation flexibility, such as
  * intentionally adding decoys to the sequence.
+ *
+ * The current implementation walks `0..m`, where `m` is the smallest power of
+ * two (and at least 4) that is greater than `n`, from a random start with a
+ * random odd stride, modulo `m`. This visits every value exactly once, and
+ * `m` is always a multiple of 4, so callers can unroll their loops. Each step
+ * is a single add and mask, so the order costs little more than a counter.
  */
 typedef struct random_order {
   size_t state;
+  size_t step;
   size_t max;
 } random_order_t;
 
@@ -62,7 +70,7 @@ void random_order_init(random_order_t *ctx, size_t min_len);
  * @param ctx The context to query.
  * @return The length of the sequence.
  */
-size_t random_order_len(const random_order_t *ctx);
+inline size_t random_order_len(const random_order_t *ctx) { return ctx->max; }
 
 /**
  * Returns the next element in the sequence represented by `ctx`.
@@ -73,7 +81,22 @@ size_t random_order_len(const random_order_t *ctx);
  * @param ctx The context to advance.
  * @return The next value in the sequence.
  */
-size_t random_order_advance(random_order_t *ctx);
+inline size_t random_order_advance(random_order_t *ctx) {
+  size_t value = ctx->state;
+  ctx->state = (ctx->state + ctx->step) & (ctx->max - 1);
+  return value;
+}
+
+/**
+ * Returns a random word for seeding `random_order_init()`.
+ *
+ * `sw/device/lib/base` cannot read the entropy sources itself, so the default
+ * definition returns a fixed value and is weak. Drivers that have access to
+ * entropy, such as the silicon_creator `rnd` driver, replace it at link time.
+ *
+ * @return A random word.
+ */
+uint32_t random_order_random_word(void);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -24,6 +24,11 @@ enum {
   kAesKeyWordLen128 = 128 / (sizeof(uint32_t) * 8),
   kAesKeyWordLen192 = 192 / (sizeof(uint32_t) * 8),
   kAesKeyWordLen256 = 256 / (sizeof(uint32_t) * 8),
+
+  /**
+   * Number of input blocks kept queued by `aes_update_blocks`.
+   */
+  kAesBlocksQueued = 2,
 };
 
 /**
@@ -277,6 +282,50 @@ status_t aes_update(aes_block_t *dest, const aes_block_t *src) {
   return OTCRYPTO_OK;
 }
 
+status_t aes_update_blocks(aes_block_t *dest, const aes_block_t *src,
+                           size_t num_blocks) {
+  size_t queued =
+      num_blocks < kAesBlocksQueued ? num_blocks : (size_t)kAesBlocksQueued;
+
+  // Fill the pipeline.
+  size_t i = 0;
+  for (; launder32(i) < queued; ++i) {
+    HARDENED_TRY(aes_update(/*dest=*/NULL, &src[i]));
+  }
+  HARDENED_CHECK_EQ(i, queued);
+
+  // Read each output as soon as it is ready and replace its input with the
+  // next one. When `dest` and `src` are the same buffer, `dest[i - queued]`
+  // has already been read as input.
+  for (; launder32(i) < num_blocks; ++i) {
+    HARDENED_TRY(aes_update(&dest[i - queued], &src[i]));
+  }
+  HARDENED_CHECK_EQ(i, num_blocks);
+
+  // Drain the pipeline.
+  for (i = num_blocks - queued; launder32(i) < num_blocks; ++i) {
+    HARDENED_TRY(aes_update(&dest[i], /*src=*/NULL));
+  }
+  HARDENED_CHECK_EQ(i, num_blocks);
+
+  return OTCRYPTO_OK;
+}
+
+status_t aes_update_semiblocks(uint32_t *first, uint32_t *second) {
+  HARDENED_TRY(spin_until(AES_STATUS_INPUT_READY_BIT));
+  abs_mmio_write32(kBase + AES_DATA_IN_0_REG_OFFSET, first[0]);
+  abs_mmio_write32(kBase + AES_DATA_IN_1_REG_OFFSET, first[1]);
+  abs_mmio_write32(kBase + AES_DATA_IN_2_REG_OFFSET, second[0]);
+  abs_mmio_write32(kBase + AES_DATA_IN_3_REG_OFFSET, second[1]);
+
+  HARDENED_TRY(spin_until(AES_STATUS_OUTPUT_VALID_BIT));
+  first[0] = abs_mmio_read32(kBase + AES_DATA_OUT_0_REG_OFFSET);
+  first[1] = abs_mmio_read32(kBase + AES_DATA_OUT_1_REG_OFFSET);
+  second[0] = abs_mmio_read32(kBase + AES_DATA_OUT_2_REG_OFFSET);
+  second[1] = abs_mmio_read32(kBase + AES_DATA_OUT_3_REG_OFFSET);
+  return OTCRYPTO_OK;
+}
+
 status_t aes_end(aes_block_t *iv) {
   uint32_t ctrl_reg = AES_CTRL_SHADOWED_REG_RESVAL;
   ctrl_reg = bitfield_bit32_write(ctrl_reg,
@@ -140,6 +140,45 @@ status_t aes_decrypt_begin(const aes_key_t key, const aes_block_t *iv);
 OT_WARN_UNUSED_RESULT
 status_t aes_update(aes_block_t *dest, const aes_block_t *src);
 
+/**
+ * Advances the AES state by several blocks.
+ *
+ * Equivalent to feeding `src[0..num_blocks-1]` through `aes_update` and
+ * collecting `dest[0..num_blocks-1]`, starting and ending with no blocks in
+ * flight. Two input blocks are kept queued in the hardware, so that AES starts
+ * the next block as soon as the output of the current one is read.
+ *
+ * `dest` may be the same buffer as `src`, but the two must not otherwise
+ * overlap.
+ *
+ * @param[out] dest The output blocks.
+ * @param src The input blocks.
+ * @param num_blocks Number of blocks in `src` and `dest`.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t aes_update_blocks(aes_block_t *dest, const aes_block_t *src,
+                           size_t num_blocks);
+
+/**
+ * Runs a block made of two semiblocks through AES, in place.
+ *
+ * The input block is the two words of `first` followed by the two words of
+ * `second`, and the output block is written back the same way. This is one
+ * full round trip through the hardware, so no other block may be in flight.
+ *
+ * This serves modes such as AES-KWP, where each block depends on the output
+ * of the one before and its two halves live in different buffers: the halves
+ * go straight between memory and the AES registers, with no copy into an
+ * `aes_block_t` and back.
+ *
+ * @param[in,out] first First semiblock (two words).
+ * @param[in,out] second Second semiblock (two words).
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t aes_update_semiblocks(uint32_t *first, uint32_t *second);
+
 /**
  * Completes an AES session by clearing control settings and key material.
  *
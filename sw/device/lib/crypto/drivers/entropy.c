@@ -19,6 +19,19 @@
 // Module ID for status codes.
 #define MODULE_ID MAKE_MODULE_ID('d', 'e', 'n')
 
+/**
+ * Number of `entropy_complex_check()` calls that may be served from the result
+ * of the last full check before the configuration is read back again.
+ *
+ * The entropy_src threshold registers are not shadowed, so the full check must
+ * still run periodically even if no block of the complex reports an alert.
+ * Defining `ENTROPY_COMPLEX_CHECK_INTERVAL=0` makes every call run the full
+ * check.
+ */
+#ifndef ENTROPY_COMPLEX_CHECK_INTERVAL
+#define ENTROPY_COMPLEX_CHECK_INTERVAL 32
+#endif
+
 const entropy_seed_material_t kEntropyEmptySeed = {
     .len = 0,
     .data = {0},
@@ -34,7 +47,62 @@ enum {
    * CSRNG genbits buffer size in uint32_t words.
    */
   kEntropyCsrngBitsBufferNumWords = 4,
+
+  /**
+   * Size of the SW CSRNG output pool in uint32_t words.
+   *
+   * Must be a multiple of `kEntropyCsrngBitsBufferNumWords`.
+   */
+  kEntropyCsrngPoolNumWords = 32,
 };
+static_assert(kEntropyCsrngPoolNumWords % kEntropyCsrngBitsBufferNumWords == 0,
+              "kEntropyCsrngPoolNumWords must be a multiple of 128 bits.");
+
+/**
+ * Buffered SW CSRNG output served by `entropy_csrng_pool_get()`.
+ *
+ * The first `len` words of `data` are unused output from a single generate
+ * command with FIPS-compatible entropy; the rest is zero.
+ */
+static struct {
+  uint32_t data[kEntropyCsrngPoolNumWords];
+  size_t len;
+} csrng_pool;
+
+/**
+ * Zeroizes and empties the SW CSRNG output pool.
+ *
+ * Called before every command that changes the SW CSRNG state other than a
+ * generate command, so that the pool never serves output from before an
+ * instantiate, reseed, update or uninstantiate.
+ */
+static void csrng_pool_clear(void) {
+  memset(csrng_pool.data, 0, sizeof(csrng_pool.data));
+  csrng_pool.len = 0;
+}
+
+/**
+ * Result of the last full entropy complex check.
+ *
+ * `token` is `kHardenedBoolTrue` and `token_inv` its complement only while the
+ * result of a passing full check may be reused, so that a single fault cannot
+ * make an unchecked configuration look verified. `calls_left` is the number of
+ * calls to `entropy_complex_check()` that may still be served from it.
+ */
+static struct {
+  hardened_bool_t token;
+  uint32_t token_inv;
+  uint32_t calls_left;
+} complex_check_cache;
+
+/**
+ * Drops the cached result of the last full entropy complex check.
+ */
+static void complex_check_cache_clear(void) {
+  complex_check_cache.token = kHardenedBoolFalse;
+  complex_check_cache.token_inv = 0;
+  complex_check_cache.calls_left = 0;
+}
 
 /**
  * Supported CSRNG application commands.
@@ -827,8 +895,33 @@ static status_t edn_check(const edn_config_t *config) {
   return OTCRYPTO_RECOV_ERR;
 }
 
+/**
+ * Checks that no block of the entropy complex has raised a recoverable alert.
+ *
+ * Recoverable alerts flag, among others, failed health tests, invalid
+ * multi-bit register values and bad commands. Their status bits are sticky, so
+ * once one is set, every `entropy_complex_check()` runs the full check.
+ *
+ * @return `kHardenedBoolTrue` if none of the status registers has a bit set.
+ */
+OT_WARN_UNUSED_RESULT
+static hardened_bool_t complex_recov_alerts_clear(void) {
+  uint32_t sts = abs_mmio_read32(kBaseEntropySrc +
+                                 ENTROPY_SRC_RECOV_ALERT_STS_REG_OFFSET);
+  sts |= abs_mmio_read32(kBaseCsrng + CSRNG_RECOV_ALERT_STS_REG_OFFSET);
+  sts |= abs_mmio_read32(kBaseEdn0 + EDN_RECOV_ALERT_STS_REG_OFFSET);
+  sts |= abs_mmio_read32(kBaseEdn1 + EDN_RECOV_ALERT_STS_REG_OFFSET);
+  if (launder32(sts) == 0) {
+    HARDENED_CHECK_EQ(sts, 0);
+    return kHardenedBoolTrue;
+  }
+  return kHardenedBoolFalse;
+}
+
 status_t entropy_complex_init(void) {
+  complex_check_cache_clear();
   entropy_complex_stop_all();
+  csrng_pool_clear();
 
   const entropy_complex_config_t *config =
       &kEntropyComplexConfigs[kEntropyComplexConfigIdContinuous];
@@ -843,6 +936,19 @@ status_t entropy_complex_init(void) {
 }
 
 status_t entropy_complex_check(void) {
+  // Reuse the result of the last full check if it is still fresh and no block
+  // has raised an alert since.
+  if (launder32(complex_check_cache.token) == kHardenedBoolTrue &&
+      complex_check_cache.calls_left > 0 &&
+      launder32(complex_recov_alerts_clear()) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(complex_check_cache.token, kHardenedBoolTrue);
+    HARDENED_CHECK_EQ(complex_check_cache.token_inv,
+                      ~(uint32_t)kHardenedBoolTrue);
+    complex_check_cache.calls_left--;
+    return OTCRYPTO_OK;
+  }
+  complex_check_cache_clear();
+
   const entropy_complex_config_t *config =
       &kEntropyComplexConfigs[kEntropyComplexConfigIdContinuous];
   if (launder32(config->id) != kEntropyComplexConfigIdContinuous) {
@@ -852,12 +958,20 @@ status_t entropy_complex_check(void) {
   HARDENED_TRY(entropy_src_check(&config->entropy_src));
   HARDENED_TRY(csrng_check());
   HARDENED_TRY(edn_check(&config->edn0));
-  return edn_check(&config->edn1);
+  HARDENED_TRY(edn_check(&config->edn1));
+
+  complex_check_cache.token = kHardenedBoolTrue;
+  complex_check_cache.token_inv = ~(uint32_t)kHardenedBoolTrue;
+  complex_check_cache.calls_left = ENTROPY_COMPLEX_CHECK_INTERVAL;
+  return OTCRYPTO_OK;
 }
 
+void entropy_complex_check_invalidate(void) { complex_check_cache_clear(); }
+
 status_t entropy_csrng_instantiate(
     hardened_bool_t disable_trng_input,
     const entropy_seed_material_t *seed_material) {
+  csrng_pool_clear();
   return csrng_send_app_cmd(kBaseCsrng,
                             (entropy_csrng_cmd_t){
                                 .id = kEntropyDrbgOpInstantiate,
@@ -870,6 +984,7 @@ status_t entropy_csrng_instantiate(
 
 status_t entropy_csrng_reseed(hardened_bool_t disable_trng_input,
                               const entropy_seed_material_t *seed_material) {
+  csrng_pool_clear();
   return csrng_send_app_cmd(kBaseCsrng,
                             (entropy_csrng_cmd_t){
                                 .id = kEntropyDrbgOpReseed,
@@ -881,6 +996,7 @@ status_t entropy_csrng_reseed(hardened_bool_t disable_trng_input,
 }
 
 status_t entropy_csrng_update(const entropy_seed_material_t *seed_material) {
+  csrng_pool_clear();
   return csrng_send_app_cmd(kBaseCsrng,
                             (entropy_csrng_cmd_t){
                                 .id = kEntropyDrbgOpUpdate,
@@ -949,7 +1065,37 @@ status_t entropy_csrng_generate(const entropy_seed_material_t *seed_material,
   return entropy_csrng_generate_data_get(buf, len, fips_check);
 }
 
+status_t entropy_csrng_pool_get(uint32_t *buf, size_t len) {
+  // Large requests gain nothing from the pool; serve them directly.
+  if (len > kEntropyCsrngPoolNumWords) {
+    return entropy_csrng_generate(&kEntropyEmptySeed, buf, len,
+                                  /*fips_check=*/kHardenedBoolTrue);
+  }
+
+  // Refill the pool with a single generate command if it cannot serve the
+  // whole request. Any leftover words are discarded.
+  if (len > csrng_pool.len) {
+    csrng_pool_clear();
+    status_t res = entropy_csrng_generate(&kEntropyEmptySeed, csrng_pool.data,
+                                          kEntropyCsrngPoolNumWords,
+                                          /*fips_check=*/kHardenedBoolTrue);
+    if (!status_ok(res)) {
+      csrng_pool_clear();
+      return res;
+    }
+    csrng_pool.len = kEntropyCsrngPoolNumWords;
+  }
+
+  // Serve the request from the end of the pool and zeroize the words used, so
+  // that each word is returned at most once.
+  csrng_pool.len -= len;
+  memcpy(buf, &csrng_pool.data[csrng_pool.len], len * sizeof(uint32_t));
+  memset(&csrng_pool.data[csrng_pool.len], 0, len * sizeof(uint32_t));
+  return OTCRYPTO_OK;
+}
+
 status_t entropy_csrng_uninstantiate(void) {
+  csrng_pool_clear();
   return csrng_send_app_cmd(kBaseCsrng,
                             (entropy_csrng_cmd_t){
                                 .id = kEntropyDrbgOpUninstantiate,
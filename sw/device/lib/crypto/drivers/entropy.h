@@ -107,11 +107,25 @@ status_t entropy_complex_init(void);
  * to note that passing the check does not by itself guarantee FIPS-compatible
  * entropy from CSRNG.
  *
+ * Reading back the whole configuration is slow, so after a passing check the
+ * result is reused for the next `ENTROPY_COMPLEX_CHECK_INTERVAL` calls, as long
+ * as no block of the complex has raised a recoverable alert. Code that
+ * reconfigures the complex without `entropy_complex_init()` must call
+ * `entropy_complex_check_invalidate()` afterwards.
+ *
  * @return Operation status in `status_t` format.
  */
 OT_WARN_UNUSED_RESULT
 status_t entropy_complex_check(void);
 
+/**
+ * Drops the cached result of the last `entropy_complex_check()`.
+ *
+ * The next call to `entropy_complex_check()` reads back the whole
+ * configuration again.
+ */
+void entropy_complex_check_invalidate(void);
+
 /**
  * Instantiate the SW CSRNG with a new seed value.
  *
@@ -205,6 +219,27 @@ status_t entropy_csrng_generate(const entropy_seed_material_t *seed_material,
                                 uint32_t *buf, size_t len,
                                 hardened_bool_t fips_check);
 
+/**
+ * Read SW CSRNG output through a software-side pool.
+ *
+ * Small requests are served from output buffered by an earlier, larger
+ * generate command, so that they do not each pay for a command handshake.
+ * The pool is refilled with a single generate command without additional input
+ * when it runs out. Requests larger than the pool are passed directly to
+ * `entropy_csrng_generate()`.
+ *
+ * The pool only holds output with FIPS-compatible entropy; this function
+ * returns an error otherwise. It is zeroized by every instantiate, reseed,
+ * update and uninstantiate command, so that it never serves output from
+ * before one of them.
+ *
+ * @param[out] buf A buffer to fill with random words.
+ * @param len The number of words to read into `buf`.
+ * @return Operation status in `status_t` format.
+ */
+OT_WARN_UNUSED_RESULT
+status_t entropy_csrng_pool_get(uint32_t *buf, size_t len);
+
 /**
  * Uninstantiate the SW CSRNG.
  *
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "sw/device/lib/crypto/drivers/entropy.h"
 
+#include "sw/device/lib/base/abs_mmio.h"
 #include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/base/status.h"
 #include "sw/device/lib/crypto/drivers/entropy_kat.h"
@@ -12,6 +13,7 @@
 #include "sw/device/lib/testing/test_framework/ottf_main.h"
 #include "sw/device/tests/otbn_randomness_impl.h"
 
+#include "edn_regs.h"  // Generated
 #include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
 
 #define MODULE_ID MAKE_MODULE_ID('e', 'n', 't')
@@ -33,10 +35,33 @@ static status_t entropy_complex_init_test(void) {
   return OK_STATUS();
 }
 
+static status_t entropy_complex_check_cache_test(void) {
+  TRY(entropy_complex_init());
+
+  // The second check is served from the result of the first one.
+  TRY(entropy_complex_check());
+  TRY(entropy_complex_check());
+
+  // Disable EDN1 behind the driver's back. Once the cached result is dropped,
+  // the check has to read back the configuration again and catch it.
+  abs_mmio_write32(TOP_EARLGREY_EDN1_BASE_ADDR + EDN_CTRL_REG_OFFSET,
+                   EDN_CTRL_REG_RESVAL);
+  entropy_complex_check_invalidate();
+  TRY_CHECK(!status_ok(entropy_complex_check()));
+
+  // A failed check is not cached either.
+  TRY_CHECK(!status_ok(entropy_complex_check()));
+
+  TRY(entropy_complex_init());
+  TRY(entropy_complex_check());
+  return OK_STATUS();
+}
+
 bool test_main(void) {
   status_t result = OK_STATUS();
 
   EXECUTE_TEST(result, entropy_complex_init_test);
+  EXECUTE_TEST(result, entropy_complex_check_cache_test);
   EXECUTE_TEST(result, entropy_csrng_kat);
   return status_ok(result);
 }
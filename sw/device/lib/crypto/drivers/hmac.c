@@ -7,6 +7,7 @@
 #include "sw/device/lib/base/abs_mmio.h"
 #include "sw/device/lib/base/bitfield.h"
 #include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/hardened_memory.h"
 #include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/crypto/impl/status.h"
 
@@ -67,8 +68,25 @@ OT_ASSERT_ENUM_VALUE(HMAC_DIGEST_15_REG_OFFSET, HMAC_DIGEST_14_REG_OFFSET + 4);
 enum {
   /* The beginning of the address space of HMAC. */
   kHmacBaseAddr = TOP_EARLGREY_HMAC_BASE_ADDR,
+  /* The number of words in MSG_FIFO; must match `MsgFifoDepth` in hmac.sv. */
+  kHmacMsgFifoDepthWords = 32,
 };
 
+/**
+ * Whether HMAC HWIP was left stopped, but not cleared, by `hmac_update()`.
+ *
+ * In that case it may still hold the context of the stream that was updated
+ * last; see `context_resume()`.
+ */
+static hardened_bool_t hw_retained = kHardenedBoolFalse;
+
+/**
+ * Digest length of the batch started by `hmac_hash_batch_start()`, in words.
+ *
+ * Zero while no batch is in progress.
+ */
+static size_t batch_digest_wordlen = 0;
+
 /**
  * Wait until HMAC becomes idle.
  *
@@ -112,6 +130,8 @@ static status_t hmac_idle_wait(void) {
  * values with 1s.
  */
 static void hmac_hwip_clear(void) {
+  hw_retained = kHardenedBoolFalse;
+
   // Do not clear the config yet, we just need to deassert sha_en, see #23014.
   uint32_t cfg_reg = abs_mmio_read32(kHmacBaseAddr + HMAC_CFG_REG_OFFSET);
   cfg_reg = bitfield_bit32_write(cfg_reg, HMAC_CFG_SHA_EN_BIT, false);
@@ -210,6 +230,57 @@ static void context_restore(hmac_ctx_t *ctx) {
   abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
 }
 
+/**
+ * Check whether HMAC HWIP still holds the context in `ctx`.
+ *
+ * This is the case if the last driver call was an `hmac_update()` of the same
+ * stream. The `ctx` object may be a copy at a different address, so this
+ * compares the configuration, message length and digest registers with `ctx`
+ * instead. The KEY registers cannot be read back, but for HMAC the digest
+ * after the first block depends on the key.
+ *
+ * @param ctx Context to look for.
+ * @return `kHardenedBoolTrue` if HMAC HWIP holds `ctx`.
+ */
+static hardened_bool_t context_resident(const hmac_ctx_t *ctx) {
+  if (launder32(hw_retained) != kHardenedBoolTrue || !ctx->hw_started) {
+    return kHardenedBoolFalse;
+  }
+  uint32_t cfg_reg =
+      bitfield_bit32_write(ctx->cfg_reg, HMAC_CFG_SHA_EN_BIT, true);
+  if (abs_mmio_read32(kHmacBaseAddr + HMAC_CFG_REG_OFFSET) != cfg_reg ||
+      abs_mmio_read32(kHmacBaseAddr + HMAC_MSG_LENGTH_LOWER_REG_OFFSET) !=
+          ctx->lower ||
+      abs_mmio_read32(kHmacBaseAddr + HMAC_MSG_LENGTH_UPPER_REG_OFFSET) !=
+          ctx->upper) {
+    return kHardenedBoolFalse;
+  }
+  uint32_t digest[kHmacMaxDigestWords];
+  digest_read(digest, kHmacMaxDigestWords);
+  return hardened_memeq(digest, ctx->H, kHmacMaxDigestWords);
+}
+
+/**
+ * Resume the operation in `ctx` on HMAC HWIP.
+ *
+ * If HMAC HWIP still holds the context (see `context_resident()`), this only
+ * issues `continue`. Otherwise it clears HMAC HWIP and restores the context
+ * with `context_restore()`.
+ *
+ * @param ctx Context to resume.
+ */
+static void context_resume(hmac_ctx_t *ctx) {
+  if (launder32(context_resident(ctx)) == kHardenedBoolTrue) {
+    uint32_t cmd_reg = bitfield_bit32_write(HMAC_CMD_REG_RESVAL,
+                                            HMAC_CMD_HASH_CONTINUE_BIT, 1);
+    abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
+    hw_retained = kHardenedBoolFalse;
+    return;
+  }
+  hmac_hwip_clear();
+  context_restore(ctx);
+}
+
 /**
  * Save the context from HMAC HWIP into `ctx` object.
  *
@@ -228,15 +299,31 @@ static void context_save(hmac_ctx_t *ctx) {
       abs_mmio_read32(kHmacBaseAddr + HMAC_MSG_LENGTH_UPPER_REG_OFFSET);
 }
 
+/**
+ * Return the number of words that can be written to `MSG_FIFO` without
+ * back-pressure.
+ *
+ * @return Number of free words in `MSG_FIFO`.
+ */
+static size_t msg_fifo_free_words(void) {
+  uint32_t status_reg = abs_mmio_read32(kHmacBaseAddr + HMAC_STATUS_REG_OFFSET);
+  size_t depth =
+      bitfield_field32_read(status_reg, HMAC_STATUS_FIFO_DEPTH_FIELD);
+  return depth < kHmacMsgFifoDepthWords ? kHmacMsgFifoDepthWords - depth : 0;
+}
+
 /**
  * Write given byte array into the `MSG_FIFO`. This function should only be
  * called when HMAC HWIP is already running and expecting further message bytes.
  *
+ * Writes to a full `MSG_FIFO` back-pressure the interconnect until HMAC HWIP
+ * has consumed a word, so full words are written in bursts that fit in the
+ * free space of the FIFO instead.
+ *
  * @param message The incoming message buffer to be fed into HMAC_FIFO.
  * @param message_len The length of `message` in bytes.
  */
 static void msg_fifo_write(const uint8_t *message, size_t message_len) {
-  // TODO(#23191): Should we handle backpressure here?
   // Begin by writing a one byte at a time until the data is aligned.
   size_t i = 0;
   for (; misalignment32_of((uintptr_t)(&message[i])) > 0 && i < message_len;
@@ -244,10 +331,18 @@ static void msg_fifo_write(const uint8_t *message, size_t message_len) {
     abs_mmio_write8(kHmacBaseAddr + HMAC_MSG_FIFO_REG_OFFSET, message[i]);
   }
 
-  // Write one word at a time as long as there is a full word available.
-  for (; i + sizeof(uint32_t) <= message_len; i += sizeof(uint32_t)) {
-    uint32_t next_word = read_32(&message[i]);
-    abs_mmio_write32(kHmacBaseAddr + HMAC_MSG_FIFO_REG_OFFSET, next_word);
+  // Write one word at a time as long as there is a full word available, as
+  // many as fit in the FIFO at a time.
+  while (i + sizeof(uint32_t) <= message_len) {
+    size_t burst = msg_fifo_free_words();
+    size_t words_left = (message_len - i) / sizeof(uint32_t);
+    if (burst > words_left) {
+      burst = words_left;
+    }
+    for (; burst > 0; burst--, i += sizeof(uint32_t)) {
+      uint32_t next_word = read_32(&message[i]);
+      abs_mmio_write32(kHmacBaseAddr + HMAC_MSG_FIFO_REG_OFFSET, next_word);
+    }
   }
 
   // For the last few bytes, we need to write one byte at a time again.
@@ -384,12 +479,9 @@ status_t hmac_update(hmac_ctx_t *ctx, const uint8_t *data, size_t len) {
   // handle the current partial block and the incoming message bytes.
   size_t leftover_len = (ctx->partial_block_len + len) % ctx->msg_block_bytelen;
 
-  // The previous caller should have left it clean, but it doesn't hurt to
-  // clear again.
-  hmac_hwip_clear();
-  // Retore context will restore the context and also hit start or continue
-  // button as necessary.
-  context_restore(ctx);
+  // Resume the operation, restoring the context unless HMAC HWIP still holds
+  // it from the previous update of this stream.
+  context_resume(ctx);
 
   // Write `partial_block` to MSG_FIFO
   msg_fifo_write(ctx->partial_block, ctx->partial_block_len);
@@ -414,8 +506,10 @@ status_t hmac_update(hmac_ctx_t *ctx, const uint8_t *data, size_t len) {
   memcpy(ctx->partial_block, data + len - leftover_len, leftover_len);
   ctx->partial_block_len = leftover_len;
 
-  // Clean up HMAC HWIP so it can be reused by other driver calls.
-  hmac_hwip_clear();
+  // Leave HMAC HWIP stopped with the context in it, so that the next update
+  // or final call of this stream can skip restoring it. Any other driver call
+  // checks or clears it first.
+  hw_retained = kHardenedBoolTrue;
   return OTCRYPTO_OK;
 }
 
@@ -429,13 +523,9 @@ status_t hmac_final(hmac_ctx_t *ctx, uint32_t *digest, size_t digest_wordlen) {
     return OTCRYPTO_BAD_ARGS;
   }
 
-  // The previous caller should have left it clean, but it doesn't hurt to
-  // clear again.
-  hmac_hwip_clear();
-
-  // Retore context will restore the context and also hit start or continue
-  // button as necessary.
-  context_restore(ctx);
+  // Resume the operation, restoring the context unless HMAC HWIP still holds
+  // it from the last update of this stream.
+  context_resume(ctx);
 
   // Feed the final leftover bytes to HMAC HWIP.
   msg_fifo_write(ctx->partial_block, ctx->partial_block_len);
@@ -522,3 +612,56 @@ status_t hmac(const hmac_mode_t hmac_mode, const uint32_t *key,
   // TODO(#23191): Destroy sensitive values in the ctx object.
   return OTCRYPTO_OK;
 }
+
+status_t hmac_hash_batch_start(const hmac_mode_t hmac_mode) {
+  if (hmac_mode != kHmacModeSha256 && hmac_mode != kHmacModeSha384 &&
+      hmac_mode != kHmacModeSha512) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  hmac_hwip_clear();
+
+  uint32_t cfg_reg;
+  size_t derived_msg_block_bytelen;
+  size_t derived_digest_wordlen;
+  HARDENED_TRY(cfg_derive(hmac_mode, &cfg_reg, &derived_msg_block_bytelen,
+                          &derived_digest_wordlen));
+
+  // There is no key or context to write first, so `sha_en` can be set
+  // straight away.
+  cfg_reg = bitfield_bit32_write(cfg_reg, HMAC_CFG_SHA_EN_BIT, true);
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CFG_REG_OFFSET, cfg_reg);
+
+  batch_digest_wordlen = derived_digest_wordlen;
+  return OTCRYPTO_OK;
+}
+
+status_t hmac_hash_batch_next(const uint8_t *data, size_t len,
+                              uint32_t *digest, size_t digest_wordlen) {
+  if (data == NULL && len > 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  if (batch_digest_wordlen == 0 || digest_wordlen != batch_digest_wordlen) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  uint32_t cmd_reg =
+      bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_START_BIT, 1);
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
+
+  msg_fifo_write(data, len);
+
+  cmd_reg =
+      bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_PROCESS_BIT, 1);
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
+
+  HARDENED_TRY(hmac_idle_wait());
+
+  digest_read(digest, digest_wordlen);
+  return OTCRYPTO_OK;
+}
+
+void hmac_hash_batch_end(void) {
+  batch_digest_wordlen = 0;
+  hmac_hwip_clear();
+}
@@ -139,8 +139,13 @@ status_t hmac_init(hmac_ctx_t *ctx, const hmac_mode_t hmac_mode,
  * MSG_FIFO in internal block granularity. When all blocks are processed, HWIP
  * is stopped and the state of HWIP is saved to `ctx`. The leftover message
  * bytes that are not sufficient to be a block are stored in `ctx-partial_block`
- * to be used in future `hmac_update` or `hmac_final` calls. Finally, the state
- * of HWIP is cleared.
+ * to be used in future `hmac_update` or `hmac_final` calls.
+ *
+ * The state of HWIP is left stopped but not cleared, so that when the next
+ * driver call is `hmac_update` or `hmac_final` of the same stream, it only has
+ * to issue `continue` instead of restoring the context. It is detected by
+ * comparing the HWIP context registers with `ctx`. Any other driver call
+ * clears the state of HWIP first.
 
  * If the available message bytes are smaller than a single internal block,
  * `ctx->partial_block` is appended with the incoming bytes and no HWIP
@@ -213,6 +218,45 @@ status_t hmac(const hmac_mode_t hmac_mode, const uint32_t *key,
               size_t key_wordlen, const uint8_t *data, size_t len,
               uint32_t *digest, size_t digest_wordlen);
 
+/**
+ * Configure HMAC HWIP for a batch of one-shot SHA-2 hashes.
+ *
+ * `hmac_hash_batch_next()` then hashes one message at a time with the same
+ * configuration, and `hmac_hash_batch_end()` clears HMAC HWIP again. This
+ * skips the clear and CFG writes that `hmac()` does for every message, which
+ * dominate for short messages.
+ *
+ * Only the SHA-2 modes are supported. No other HMAC driver call may be made
+ * until the batch has ended.
+ *
+ * @param hmac_mode Specifies the mode among SHA2-256/384/512.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t hmac_hash_batch_start(const hmac_mode_t hmac_mode);
+
+/**
+ * Hash one message of a batch started by `hmac_hash_batch_start()`.
+ *
+ * `digest_wordlen` must match the mode of the batch.
+ *
+ * @param data Message to hash.
+ * @param len Length of the message in bytes.
+ * @param[out] digest The digest value to be returned.
+ * @param digest_wordlen The length of the digest in words.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t hmac_hash_batch_next(const uint8_t *data, size_t len,
+                              uint32_t *digest, size_t digest_wordlen);
+
+/**
+ * End a batch started by `hmac_hash_batch_start()` and clear HMAC HWIP.
+ *
+ * This must be called even if hashing a message of the batch failed.
+ */
+void hmac_hash_batch_end(void);
+
 #ifdef __cplusplus
 }
 #endif
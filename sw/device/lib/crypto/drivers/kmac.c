@@ -65,6 +65,9 @@ enum {
   kKmacStateShare0Addr = kKmacBaseAddr + KMAC_STATE_REG_OFFSET,
   kKmacStateShare1Addr =
       kKmacBaseAddr + KMAC_STATE_REG_OFFSET + kKmacStateShareSize,
+  kKmacMsgFifoAddr = kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET,
+  kKmacMsgFifoWordsPerEntry =
+      KMAC_PARAM_NUM_BYTES_MSG_FIFO_ENTRY / sizeof(uint32_t),
 };
 
 // "KMAC" string in little endian
@@ -325,6 +328,25 @@ status_t kmac_hwip_default_configure(void) {
   return OTCRYPTO_OK;
 }
 
+/**
+ * Read the status register and check it for errors.
+ *
+ * @param[out] status_reg Value of the status register.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t status_read(uint32_t *status_reg) {
+  uint32_t reg = abs_mmio_read32(kKmacBaseAddr + KMAC_STATUS_REG_OFFSET);
+  if (bitfield_bit32_read(reg, KMAC_STATUS_ALERT_FATAL_FAULT_BIT)) {
+    return OTCRYPTO_FATAL_ERR;
+  }
+  if (bitfield_bit32_read(reg, KMAC_STATUS_ALERT_RECOV_CTRL_UPDATE_ERR_BIT)) {
+    return OTCRYPTO_RECOV_ERR;
+  }
+  *status_reg = reg;
+  return OTCRYPTO_OK;
+}
+
 /**
  * Wait until given status bit is set.
  *
@@ -341,19 +363,104 @@ static status_t wait_status_bit(uint32_t bit_position, bool bit_value) {
   }
 
   while (true) {
-    uint32_t reg = abs_mmio_read32(kKmacBaseAddr + KMAC_STATUS_REG_OFFSET);
-    if (bitfield_bit32_read(reg, KMAC_STATUS_ALERT_FATAL_FAULT_BIT)) {
-      return OTCRYPTO_FATAL_ERR;
-    }
-    if (bitfield_bit32_read(reg, KMAC_STATUS_ALERT_RECOV_CTRL_UPDATE_ERR_BIT)) {
-      return OTCRYPTO_RECOV_ERR;
-    }
+    uint32_t reg;
+    HARDENED_TRY(status_read(&reg));
     if (bitfield_bit32_read(reg, bit_position) == bit_value) {
       return OTCRYPTO_OK;
     }
   }
 }
 
+/**
+ * Get the number of words that can be written to `MSG_FIFO` without
+ * back-pressure.
+ *
+ * @param[out] free_words Number of free words in `MSG_FIFO`.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t msg_fifo_free_words(size_t *free_words) {
+  uint32_t reg;
+  HARDENED_TRY(status_read(&reg));
+  size_t depth = bitfield_field32_read(reg, KMAC_STATUS_FIFO_DEPTH_FIELD);
+  *free_words = 0;
+  if (depth < KMAC_PARAM_NUM_ENTRIES_MSG_FIFO) {
+    *free_words =
+        (KMAC_PARAM_NUM_ENTRIES_MSG_FIFO - depth) * kKmacMsgFifoWordsPerEntry;
+  }
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Write given byte array into `MSG_FIFO`.
+ *
+ * KMAC must already be in the absorb state. Full words are written in bursts
+ * that fit in the free space of the FIFO, so that the status register is read
+ * once per burst rather than once per word.
+ *
+ * If `message` is not word-aligned, the bytes before its first aligned word
+ * are carried as a partial word and shifted together with each aligned word
+ * loaded from `message`, so the message is still written one word at a time.
+ * Only the last `message_len % 4` bytes are written one byte at a time.
+ *
+ * @param message Input message string.
+ * @param message_len Message length in bytes.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t msg_fifo_write(const uint8_t *message, size_t message_len) {
+  // Collect the bytes up to the first aligned word of the message.
+  uint32_t carry = 0;
+  size_t carry_bits = 0;
+  size_t i = 0;
+  for (; misalignment32_of((uintptr_t)(&message[i])) > 0 && i < message_len;
+       i++) {
+    carry |= (uint32_t)message[i] << carry_bits;
+    carry_bits += 8;
+  }
+
+  // Write one word for each aligned word of the message, as many as fit in
+  // the FIFO at a time. The top bytes of each aligned word are carried over
+  // to the next one.
+  while (i + sizeof(uint32_t) <= message_len) {
+    size_t burst;
+    HARDENED_TRY(msg_fifo_free_words(&burst));
+    size_t words_left = (message_len - i) / sizeof(uint32_t);
+    if (burst > words_left) {
+      burst = words_left;
+    }
+    for (; burst > 0; burst--, i += sizeof(uint32_t)) {
+      uint32_t next_word = read_32(&message[i]);
+      if (carry_bits > 0) {
+        uint32_t shifted = carry | (next_word << carry_bits);
+        carry = next_word >> (32 - carry_bits);
+        next_word = shifted;
+      }
+      abs_mmio_write32(kKmacMsgFifoAddr, next_word);
+    }
+  }
+
+  // Add the last few bytes to the carried word, writing it if it fills up.
+  for (; i < message_len; i++) {
+    carry |= (uint32_t)message[i] << carry_bits;
+    carry_bits += 8;
+    if (carry_bits == 32) {
+      HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
+      abs_mmio_write32(kKmacMsgFifoAddr, carry);
+      carry = 0;
+      carry_bits = 0;
+    }
+  }
+
+  // Write what is left of the carried word one byte at a time.
+  for (; carry_bits > 0; carry_bits -= 8, carry >>= 8) {
+    HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
+    abs_mmio_write8(kKmacMsgFifoAddr, (uint8_t)carry);
+  }
+
+  return OTCRYPTO_OK;
+}
+
 /**
  * Encode a given integer as byte array and return its size along with it.
  *
@@ -620,26 +727,7 @@ static status_t kmac_process_msg_blocks(kmac_operation_t operation,
   abs_mmio_write32(kKmacBaseAddr + KMAC_CMD_REG_OFFSET, cmd_reg);
   HARDENED_TRY(wait_status_bit(KMAC_STATUS_SHA3_ABSORB_BIT, 1));
 
-  // Begin by writing a one byte at a time until the data is aligned.
-  size_t i = 0;
-  for (; misalignment32_of((uintptr_t)(&message[i])) > 0 && i < message_len;
-       i++) {
-    HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
-    abs_mmio_write8(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET, message[i]);
-  }
-
-  // Write one word at a time as long as there is a full word available.
-  for (; i + sizeof(uint32_t) <= message_len; i += sizeof(uint32_t)) {
-    HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
-    uint32_t next_word = read_32(&message[i]);
-    abs_mmio_write32(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET, next_word);
-  }
-
-  // For the last few bytes, we need to write one byte at a time again.
-  for (; i < message_len; i++) {
-    HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
-    abs_mmio_write8(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET, message[i]);
-  }
+  HARDENED_TRY(msg_fifo_write(message, message_len));
 
   // If operation=KMAC, then we need to write `right_encode(digest->len)`
   if (operation == kKmacOperationKMAC) {
@@ -657,7 +745,7 @@ static status_t kmac_process_msg_blocks(kmac_operation_t operation,
     uint8_t bytes_written;
     HARDENED_TRY(little_endian_encode(digest_len_bits, buf, &bytes_written));
     buf[bytes_written] = bytes_written;
-    uint8_t *fifo_dst = (uint8_t *)(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET);
+    uint8_t *fifo_dst = (uint8_t *)kKmacMsgFifoAddr;
     memcpy(fifo_dst, buf, bytes_written + 1);
   }
 
@@ -765,6 +853,48 @@ status_t kmac_sha3_512(const uint8_t *message, size_t message_len,
                                  digest, digest_len_words);
 }
 
+/**
+ * Digest length of the batch started by `kmac_sha3_batch_start()`, in words.
+ *
+ * Zero while no batch is in progress.
+ */
+static size_t sha3_batch_digest_words = 0;
+
+status_t kmac_sha3_batch_start(size_t digest_len_words) {
+  kmac_security_str_t security_str;
+  switch (digest_len_words) {
+    case kSha3_224DigestWords:
+      security_str = kKmacSecurityStrength224;
+      break;
+    case kSha3_256DigestWords:
+      security_str = kKmacSecurityStrength256;
+      break;
+    case kSha3_384DigestWords:
+      security_str = kKmacSecurityStrength384;
+      break;
+    case kSha3_512DigestWords:
+      security_str = kKmacSecurityStrength512;
+      break;
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_TRY(kmac_init(kKmacOperationSHA3, security_str,
+                         /*hw_backed=*/kHardenedBoolFalse));
+  sha3_batch_digest_words = digest_len_words;
+  return OTCRYPTO_OK;
+}
+
+status_t kmac_sha3_batch_next(const uint8_t *message, size_t message_len,
+                              uint32_t *digest) {
+  if (sha3_batch_digest_words == 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  return kmac_process_msg_blocks(kKmacOperationSHA3, message, message_len,
+                                 digest, sha3_batch_digest_words);
+}
+
+void kmac_sha3_batch_end(void) { sha3_batch_digest_words = 0; }
+
 status_t kmac_shake_128(const uint8_t *message, size_t message_len,
                         uint32_t *digest, size_t digest_len) {
   HARDENED_TRY(kmac_init(kKmacOperationSHAKE, kKmacSecurityStrength128,
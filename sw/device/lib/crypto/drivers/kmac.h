@@ -151,6 +151,41 @@ OT_WARN_UNUSED_RESULT
 status_t kmac_sha3_512(const uint8_t *message, size_t message_len,
                        uint32_t *digest);
 
+/**
+ * Configure KMAC for a batch of one-shot SHA-3 hashes.
+ *
+ * `kmac_sha3_batch_next()` then hashes one message at a time with the same
+ * configuration, without rewriting the (shadowed) CFG register for each one,
+ * until `kmac_sha3_batch_end()`. No other KMAC driver call may be made until
+ * the batch has ended.
+ *
+ * @param digest_len_words Digest length in words, which selects the SHA-3
+ * variant (224, 256, 384 or 512 bits).
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+status_t kmac_sha3_batch_start(size_t digest_len_words);
+
+/**
+ * Hash one message of a batch started by `kmac_sha3_batch_start()`.
+ *
+ * The caller must ensure that `digest` has space for the digest length given
+ * to `kmac_sha3_batch_start()`.
+ *
+ * @param message The input message.
+ * @param message_len The input message length in bytes.
+ * @param[out] digest Output buffer for the result.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+status_t kmac_sha3_batch_next(const uint8_t *message, size_t message_len,
+                              uint32_t *digest);
+
+/**
+ * End a batch started by `kmac_sha3_batch_start()`.
+ */
+void kmac_sha3_batch_end(void);
+
 /**
  * Compute SHAKE-128 in one-shot.
  *
@@ -63,6 +63,72 @@ typedef enum otbn_status {
   kOtbnStatusLocked = 0xFF,
 } otbn_status_t;
 
+/**
+ * The application whose IMEM image is in OTBN, if any.
+ *
+ * `otbn_load_app()` uses this to skip rewriting IMEM when the same
+ * application is loaded again. `load_checksum` is the value of LOAD_CHECKSUM
+ * after the last write by this driver, so a write to IMEM or DMEM by anything
+ * else since then shows up as a mismatch. `dmem_loaded` is set while DMEM
+ * still holds what the application left there, i.e. until the next wipe.
+ * `dmem_wiped` is set from the time a DMEM wipe is issued until DMEM is next
+ * written or OTBN next runs, so that loading an application straight after a
+ * wipe does not wipe DMEM a second time.
+ */
+static struct {
+  hardened_bool_t valid;
+  hardened_bool_t dmem_loaded;
+  hardened_bool_t dmem_wiped;
+  const uint32_t *imem_start;
+  const uint32_t *imem_end;
+  uint32_t load_checksum;
+} resident_app = {
+    .valid = kHardenedBoolFalse,
+    .dmem_loaded = kHardenedBoolFalse,
+    .dmem_wiped = kHardenedBoolFalse,
+};
+
+/**
+ * Set while a secure wipe started by `otbn_dmem_sec_wipe_start()` has not yet
+ * been waited for.
+ */
+static hardened_bool_t sec_wipe_pending = kHardenedBoolFalse;
+
+/**
+ * Records that the memories were last written by this driver.
+ */
+static void resident_app_snapshot(void) {
+  resident_app.load_checksum =
+      abs_mmio_read32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET);
+  resident_app.dmem_wiped = kHardenedBoolFalse;
+}
+
+/**
+ * Forgets the resident application, so that the next load rewrites IMEM.
+ */
+static void resident_app_invalidate(void) {
+  resident_app.valid = kHardenedBoolFalse;
+  resident_app.dmem_loaded = kHardenedBoolFalse;
+  resident_app.dmem_wiped = kHardenedBoolFalse;
+}
+
+/**
+ * Waits for the secure wipe started by `otbn_dmem_sec_wipe_start()`, if any.
+ *
+ * Errors from the wipe are reported here, i.e. to the next user of OTBN.
+ *
+ * @return Result of the operation.
+ */
+static status_t sec_wipe_wait(void) {
+  // Anything but a clean "false" waits, which is always safe.
+  if (launder32(sec_wipe_pending) == kHardenedBoolFalse) {
+    return OTCRYPTO_OK;
+  }
+  sec_wipe_pending = kHardenedBoolFalse;
+  HARDENED_TRY(otbn_busy_wait_for_done());
+  return OTCRYPTO_OK;
+}
+
 /**
  * Ensures that a memory access fits within the given memory size.
  *
@@ -93,12 +159,15 @@ static status_t check_offset_len(uint32_t offset_bytes, size_t num_words,
 /**
  * Ensures OTBN is idle.
  *
- * If OTBN is busy or locked, this function will return
- * `OTCRYPTO_ASYNC_INCOMPLETE`; otherwise it will return `OTCRYPTO_OK`.
+ * A pending secure wipe is waited for first. If OTBN is then busy or locked,
+ * this function will return `OTCRYPTO_ASYNC_INCOMPLETE`; otherwise it will
+ * return `OTCRYPTO_OK`.
  *
  * @return Result of the operation.
  */
 static status_t otbn_assert_idle(void) {
+  HARDENED_TRY(sec_wipe_wait());
+
   uint32_t status = launder32(~(uint32_t)kOtbnStatusIdle);
   status_t res = (status_t){
       .value = (int32_t)launder32((uint32_t)OTCRYPTO_OK.value ^ status)};
@@ -125,28 +194,26 @@ static void otbn_write(uint32_t dest_addr, const uint32_t *src,
   // TODO: replace 0 with a random index like the silicon_creator driver
   // (requires an interface to Ibex's RND valid bit and data register).
   size_t i = ((uint64_t)0 * (uint64_t)num_words) >> 32;
-  enum { kStep = 1 };
-  size_t iter_cnt = 0;
-  for (; launder32(iter_cnt) < num_words; ++iter_cnt) {
-    abs_mmio_write32(dest_addr + i * sizeof(uint32_t), src[i]);
-    i += kStep;
-    if (launder32(i) >= num_words) {
-      i -= num_words;
-    }
-    HARDENED_CHECK_LT(i, num_words);
-  }
-  HARDENED_CHECK_EQ(iter_cnt, num_words);
+  HARDENED_CHECK_LE(i, num_words);
+  // Copy the words from the start index to the end, then wrap around.
+  size_t copied = abs_mmio_write32_bulk_hardened(
+      dest_addr + i * sizeof(uint32_t), src + i, num_words - i);
+  copied += abs_mmio_write32_bulk_hardened(dest_addr, src, i);
+  HARDENED_CHECK_EQ(copied, num_words);
+  resident_app_snapshot();
 }
 
 status_t otbn_dmem_write(size_t num_words, const uint32_t *src,
                          otbn_addr_t dest) {
   HARDENED_TRY(check_offset_len(dest, num_words, kOtbnDMemSizeBytes));
+  HARDENED_TRY(sec_wipe_wait());
   otbn_write(kBase + OTBN_DMEM_REG_OFFSET + dest, src, num_words);
   return OTCRYPTO_OK;
 }
 
 status_t otbn_dmem_set(size_t num_words, const uint32_t src, otbn_addr_t dest) {
   HARDENED_TRY(check_offset_len(dest, num_words, kOtbnDMemSizeBytes));
+  HARDENED_TRY(sec_wipe_wait());
 
   // No need to randomize here, since all the values are the same.
   size_t i = 0;
@@ -156,18 +223,17 @@ status_t otbn_dmem_set(size_t num_words, const uint32_t src, otbn_addr_t dest) {
     HARDENED_CHECK_LT(i, num_words);
   }
   HARDENED_CHECK_EQ(i, num_words);
+  resident_app_snapshot();
   return OTCRYPTO_OK;
 }
 
 status_t otbn_dmem_read(size_t num_words, otbn_addr_t src, uint32_t *dest) {
   HARDENED_TRY(check_offset_len(src, num_words, kOtbnDMemSizeBytes));
+  HARDENED_TRY(sec_wipe_wait());
 
-  size_t i = 0;
-  for (; launder32(i) < num_words; ++i) {
-    dest[i] = abs_mmio_read32(kBase + OTBN_DMEM_REG_OFFSET + src +
-                              i * sizeof(uint32_t));
-  }
-  HARDENED_CHECK_EQ(i, num_words);
+  size_t copied = abs_mmio_read32_bulk_hardened(
+      kBase + OTBN_DMEM_REG_OFFSET + src, dest, num_words);
+  HARDENED_CHECK_EQ(copied, num_words);
 
   return OTCRYPTO_OK;
 }
@@ -180,6 +246,7 @@ status_t otbn_execute(void) {
   // Ensure OTBN is idle before attempting to run a command.
   HARDENED_TRY(otbn_assert_idle());
 
+  resident_app.dmem_wiped = kHardenedBoolFalse;
   abs_mmio_write32(kBase + OTBN_CMD_REG_OFFSET, kOtbnCmdExecute);
   return OTCRYPTO_OK;
 }
@@ -206,6 +273,9 @@ status_t otbn_busy_wait_for_done(void) {
     return res;
   }
 
+  // OTBN may have wiped its memories on the error.
+  resident_app_invalidate();
+
   // If OTBN is idle (not locked), then return a recoverable error.
   if (launder32(status) == kOtbnStatusIdle) {
     HARDENED_CHECK_EQ(status, kOtbnStatusIdle);
@@ -217,6 +287,14 @@ status_t otbn_busy_wait_for_done(void) {
   return OTCRYPTO_FATAL_ERR;
 }
 
+status_t otbn_done_check(void) {
+  uint32_t status = abs_mmio_read32(kBase + OTBN_STATUS_REG_OFFSET);
+  if (status == kOtbnStatusIdle || status == kOtbnStatusLocked) {
+    return OTCRYPTO_OK;
+  }
+  return OTCRYPTO_ASYNC_INCOMPLETE;
+}
+
 uint32_t otbn_err_bits_get(void) {
   return abs_mmio_read32(kBase + OTBN_ERR_BITS_REG_OFFSET);
 }
@@ -226,6 +304,7 @@ uint32_t otbn_instruction_count_get(void) {
 }
 
 status_t otbn_imem_sec_wipe(void) {
+  resident_app_invalidate();
   HARDENED_TRY(entropy_complex_check());
   HARDENED_TRY(otbn_assert_idle());
   abs_mmio_write32(kBase + OTBN_CMD_REG_OFFSET, kOtbnCmdSecWipeImem);
@@ -233,11 +312,19 @@ status_t otbn_imem_sec_wipe(void) {
   return OTCRYPTO_OK;
 }
 
-status_t otbn_dmem_sec_wipe(void) {
+status_t otbn_dmem_sec_wipe_start(void) {
+  resident_app.dmem_loaded = kHardenedBoolFalse;
   HARDENED_TRY(entropy_complex_check());
   HARDENED_TRY(otbn_assert_idle());
   abs_mmio_write32(kBase + OTBN_CMD_REG_OFFSET, kOtbnCmdSecWipeDmem);
-  HARDENED_TRY(otbn_busy_wait_for_done());
+  sec_wipe_pending = kHardenedBoolTrue;
+  resident_app.dmem_wiped = kHardenedBoolTrue;
+  return OTCRYPTO_OK;
+}
+
+status_t otbn_dmem_sec_wipe(void) {
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
+  HARDENED_TRY(sec_wipe_wait());
   return OTCRYPTO_OK;
 }
 
@@ -286,18 +373,94 @@ static status_t check_app_address_ranges(const otbn_app_t *app) {
   return OTCRYPTO_OK;
 }
 
+/**
+ * Writes the `.data` section of `app` to DMEM.
+ *
+ * @param app the OTBN application to write the data of
+ * @return Result of the operation.
+ */
+static status_t write_app_data(const otbn_app_t *app) {
+  const size_t data_num_words =
+      (size_t)(app->dmem_data_end - app->dmem_data_start);
+  otbn_addr_t data_offset = app->dmem_data_start_addr;
+  HARDENED_TRY(
+      check_offset_len(data_offset, data_num_words, kOtbnDMemSizeBytes));
+  uint32_t data_start_addr = kBase + OTBN_DMEM_REG_OFFSET + data_offset;
+  size_t copied = abs_mmio_write32_bulk_hardened(
+      data_start_addr, app->dmem_data_start, data_num_words);
+  HARDENED_CHECK_EQ(copied, data_num_words);
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Checks whether `app` is the resident application and IMEM is untouched
+ * since it was loaded.
+ *
+ * @param app the OTBN application to look for
+ * @return `kHardenedBoolTrue` if `app` is resident.
+ */
+static hardened_bool_t app_is_resident(const otbn_app_t *app) {
+  uint32_t load_checksum =
+      abs_mmio_read32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET);
+  if (launder32(resident_app.valid) != kHardenedBoolTrue ||
+      launderw((uintptr_t)resident_app.imem_start) !=
+          (uintptr_t)app->imem_start ||
+      launderw((uintptr_t)resident_app.imem_end) != (uintptr_t)app->imem_end ||
+      launder32(load_checksum) != resident_app.load_checksum) {
+    return kHardenedBoolFalse;
+  }
+  HARDENED_CHECK_EQ(resident_app.valid, kHardenedBoolTrue);
+  HARDENED_CHECK_EQ(resident_app.imem_start, app->imem_start);
+  HARDENED_CHECK_EQ(resident_app.imem_end, app->imem_end);
+  HARDENED_CHECK_EQ(load_checksum, resident_app.load_checksum);
+  return kHardenedBoolTrue;
+}
+
+/**
+ * Checks whether DMEM has been wiped and left untouched since.
+ *
+ * @return `kHardenedBoolTrue` if DMEM needs no further wipe.
+ */
+static hardened_bool_t dmem_is_wiped(void) {
+  uint32_t load_checksum =
+      abs_mmio_read32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET);
+  if (launder32(resident_app.dmem_wiped) != kHardenedBoolTrue ||
+      launder32(load_checksum) != resident_app.load_checksum) {
+    return kHardenedBoolFalse;
+  }
+  HARDENED_CHECK_EQ(resident_app.dmem_wiped, kHardenedBoolTrue);
+  HARDENED_CHECK_EQ(load_checksum, resident_app.load_checksum);
+  return kHardenedBoolTrue;
+}
+
 status_t otbn_load_app(const otbn_app_t app) {
   HARDENED_TRY(check_app_address_ranges(&app));
 
-  // Ensure OTBN is idle.
+  // Ensure OTBN is idle. This also completes the wipe that usually ends the
+  // previous operation, in which case DMEM need not be wiped again.
   HARDENED_TRY(otbn_assert_idle());
+  hardened_bool_t dmem_wiped = dmem_is_wiped();
+
+  // If the program is already in IMEM, only DMEM needs to be reset. It is
+  // still wiped so that nothing from the previous run is left in it.
+  if (launder32(app_is_resident(&app)) == kHardenedBoolTrue) {
+    if (launder32(dmem_wiped) != kHardenedBoolTrue) {
+      HARDENED_TRY(otbn_dmem_sec_wipe());
+    }
+    HARDENED_TRY(write_app_data(&app));
+    resident_app_snapshot();
+    resident_app.dmem_loaded = kHardenedBoolTrue;
+    return OTCRYPTO_OK;
+  }
 
   const size_t imem_num_words = (size_t)(app.imem_end - app.imem_start);
   const size_t data_num_words =
       (size_t)(app.dmem_data_end - app.dmem_data_start);
 
   HARDENED_TRY(otbn_imem_sec_wipe());
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  if (launder32(dmem_wiped) != kHardenedBoolTrue) {
+    HARDENED_TRY(otbn_dmem_sec_wipe());
+  }
 
   // Reset the LOAD_CHECKSUM register.
   abs_mmio_write32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET, 0);
@@ -312,25 +475,12 @@ status_t otbn_load_app(const otbn_app_t app) {
   HARDENED_TRY(
       check_offset_len(imem_offset, imem_num_words, kOtbnIMemSizeBytes));
   uint32_t imem_start_addr = kBase + OTBN_IMEM_REG_OFFSET + imem_offset;
-  uint32_t i = 0;
-  for (; launder32(i) < imem_num_words; i++) {
-    HARDENED_CHECK_LT(i, imem_num_words);
-    abs_mmio_write32(imem_start_addr + i * sizeof(uint32_t), app.imem_start[i]);
-  }
-  HARDENED_CHECK_EQ(i, imem_num_words);
+  size_t copied = abs_mmio_write32_bulk_hardened(
+      imem_start_addr, app.imem_start, imem_num_words);
+  HARDENED_CHECK_EQ(copied, imem_num_words);
 
   // Write the data portion to DMEM.
-  otbn_addr_t data_offset = app.dmem_data_start_addr;
-  HARDENED_TRY(
-      check_offset_len(data_offset, data_num_words, kOtbnDMemSizeBytes));
-  uint32_t data_start_addr = kBase + OTBN_DMEM_REG_OFFSET + data_offset;
-  i = 0;
-  for (; launder32(i) < data_num_words; i++) {
-    HARDENED_CHECK_LT(i, data_num_words);
-    abs_mmio_write32(data_start_addr + i * sizeof(uint32_t),
-                     app.dmem_data_start[i]);
-  }
-  HARDENED_CHECK_EQ(i, data_num_words);
+  HARDENED_TRY(write_app_data(&app));
 
   // Ensure that the checksum matches expectations.
   uint32_t checksum = abs_mmio_read32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET);
@@ -339,5 +489,22 @@ status_t otbn_load_app(const otbn_app_t app) {
   }
   HARDENED_CHECK_EQ(checksum, app.checksum);
 
+  resident_app.imem_start = app.imem_start;
+  resident_app.imem_end = app.imem_end;
+  resident_app.load_checksum = checksum;
+  resident_app.dmem_wiped = kHardenedBoolFalse;
+  resident_app.valid = kHardenedBoolTrue;
+  resident_app.dmem_loaded = kHardenedBoolTrue;
   return OTCRYPTO_OK;
 }
+
+status_t otbn_resume_app(const otbn_app_t app) {
+  HARDENED_TRY(otbn_assert_idle());
+
+  if (launder32(app_is_resident(&app)) == kHardenedBoolTrue &&
+      launder32(resident_app.dmem_loaded) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(resident_app.dmem_loaded, kHardenedBoolTrue);
+    return OTCRYPTO_OK;
+  }
+  return otbn_load_app(app);
+}
@@ -195,7 +195,8 @@ typedef struct otbn_app {
  * word-aligned or if the length and offset exceed the DMEM size, this function
  * will return an error.
  *
- * The caller must ensure OTBN is idle before calling this function.
+ * The caller must ensure OTBN is idle before calling this function. A wipe
+ * started by `otbn_dmem_sec_wipe_start()` is waited for first.
  *
  * @param num_words Length of the data in 32-bit words.
  * @param src The main memory location to copy from.
@@ -212,7 +213,8 @@ status_t otbn_dmem_write(size_t num_words, const uint32_t *src,
  * word-aligned or if the length and offset exceed the DMEM size, this function
  * will return an error.
  *
- * The caller must ensure OTBN is idle before calling this function.
+ * The caller must ensure OTBN is idle before calling this function. A wipe
+ * started by `otbn_dmem_sec_wipe_start()` is waited for first.
  *
  * @param num_words Length of the range to set in 32-bit words.
  * @param src The value to set each word in DMEM to.
@@ -228,7 +230,8 @@ status_t otbn_dmem_set(size_t num_words, const uint32_t src, otbn_addr_t dest);
  * or if the length and offset exceed the DMEM size, this function will return
  * an error.
  *
- * The caller must ensure OTBN is idle before calling this function.
+ * The caller must ensure OTBN is idle before calling this function. A wipe
+ * started by `otbn_dmem_sec_wipe_start()` is waited for first.
  *
  * @param num_words Length of the data in 32-bit words.
  * @param src The DMEM location to copy from.
@@ -255,6 +258,18 @@ status_t otbn_execute(void);
  */
 status_t otbn_busy_wait_for_done(void);
 
+/**
+ * Checks whether OTBN has finished running, without blocking.
+ *
+ * Returns `OTCRYPTO_ASYNC_INCOMPLETE` while OTBN is busy (executing or
+ * wiping its memories), and OK once it is idle or locked. Callers should then
+ * use `otbn_busy_wait_for_done()` to check for errors, which returns
+ * immediately at that point.
+ *
+ * @return Result of the operation.
+ */
+status_t otbn_done_check(void);
+
 /**
  * Get the error bits set by the device if the operation failed.
  *
@@ -282,7 +297,8 @@ uint32_t otbn_instruction_count_get(void);
  * Wipe IMEM securely.
  *
  * This function returns an error if called when OTBN is not idle, and blocks
- * until the secure wipe is complete.
+ * until the secure wipe is complete. The next `otbn_load_app()` always
+ * rewrites IMEM.
  *
  * @return Result of the operation.
  */
@@ -298,6 +314,22 @@ status_t otbn_imem_sec_wipe(void);
  */
 status_t otbn_dmem_sec_wipe(void);
 
+/**
+ * Start a secure wipe of DMEM without waiting for it to complete.
+ *
+ * This function returns an error if called when OTBN is not idle. Otherwise
+ * it returns as soon as the wipe has been issued, so that Ibex can get on with
+ * other work (such as post-processing results already read out of DMEM) while
+ * OTBN wipes.
+ *
+ * Every other function in this driver that uses OTBN or its memories first
+ * waits for the wipe to complete, and returns its error if the wipe failed.
+ * `otbn_load_app()` does not wipe DMEM again if nothing has written it since.
+ *
+ * @return Result of the operation.
+ */
+status_t otbn_dmem_sec_wipe_start(void);
+
 /**
  * Sets the software errors are fatal bit in the control register.
  *
@@ -317,6 +349,13 @@ status_t otbn_set_ctrl_software_errs_fatal(bool enable);
  * Load the application image with both instruction and data segments into
  * OTBN.
  *
+ * If `app` is the last application this function loaded, and neither IMEM nor
+ * DMEM has been written by anything but this driver since (as seen by
+ * LOAD_CHECKSUM), IMEM is left as it is: only DMEM is securely wiped and the
+ * data segment rewritten. `otbn_imem_sec_wipe()` and OTBN errors forget the
+ * loaded application, so the next call reloads it in full. DMEM is not wiped
+ * again if it has not been written, nor OTBN run, since the last wipe.
+ *
  * This function will return an error if called when OTBN is not idle.
  *
  * @param ctx The context object.
@@ -325,6 +364,27 @@ status_t otbn_set_ctrl_software_errs_fatal(bool enable);
  */
 status_t otbn_load_app(const otbn_app_t app);
 
+/**
+ * Loads the provided application into OTBN unless DMEM is still set up for it.
+ *
+ * If `app` was loaded by `otbn_load_app()` (or this function) and DMEM has not
+ * been wiped or written by anything but this driver since, both memories are
+ * left as they are, including whatever the application's last run left in
+ * DMEM. Otherwise this is the same as `otbn_load_app()`.
+ *
+ * This lets a caller that runs one application several times in a row, such
+ * as a streaming hash, keep its data in DMEM between runs and only wipe DMEM
+ * at the end. The caller must rewrite every DMEM variable it relies on that
+ * the application modifies, since another user of the same application may
+ * have run it in between.
+ *
+ * This function will return an error if called when OTBN is not idle.
+ *
+ * @param app The application to load into OTBN.
+ * @return The result of the operation.
+ */
+status_t otbn_resume_app(const otbn_app_t app);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,14 @@ enum {
    * Log2 of the number of bytes in an AES block.
    */
   kAesBlockLog2NumBytes = 4,
+  /**
+   * Maximum number of blocks processed in one AES session by GCTR.
+   */
+  kGctrMaxBatchBlocks = 8,
+  /**
+   * Number of blocks kept queued in the AES hardware by GCTR.
+   */
+  kGctrBlocksQueued = 2,
 };
 static_assert(kAesBlockNumBytes == (1 << kAesBlockLog2NumBytes),
               "kAesBlockLog2NumBytes does not match kAesBlockNumBytes");
@@ -71,23 +79,113 @@ static status_t aes_encrypt_block(const aes_key_t key, const aes_block_t *iv,
 }
 
 /**
- * Run GCTR on exactly one block of input.
+ * Absorb one full block of ciphertext into GHASH.
+ *
+ * @param ctx GHASH context, or NULL to skip hashing.
+ * @param block Ciphertext block.
+ */
+static inline void gctr_ghash_block(ghash_context_t *ctx,
+                                    const aes_block_t *block) {
+  if (ctx != NULL) {
+    ghash_block_t partial;
+    ghash_process_full_blocks(ctx, /*partial_len=*/0, &partial,
+                              kAesBlockNumBytes, (const uint8_t *)block->data);
+  }
+}
+
+/**
+ * Run GCTR on consecutive blocks of input, in place.
+ *
+ * The AES hardware increments the whole 128-bit counter block in CTR mode,
+ * but GCTR only increments its last 32 bits (inc32). The two match as long as
+ * the last 32 bits of the counter do not wrap around between the blocks, so
+ * the caller must ensure that they don't; see `gctr_batch_blocks`.
+ *
+ * If `ghash_ctx` is non-NULL, also absorbs the ciphertext blocks into GHASH.
+ * Each block is hashed while the AES hardware is busy with a later block, so
+ * the two run in parallel rather than one after the other. The ciphertext is
+ * the output for encryption and the input for decryption.
  *
  * Updates the IV in-place.
  *
  * @param key The AES key
  * @param iv Initialization vector, 128 bits
- * @param input Input block
- * @param[out] output Output block
+ * @param ghash_ctx GHASH context for the ciphertext, or NULL.
+ * @param is_encrypt Whether the output (true) or input (false) is ciphertext.
+ * @param[in,out] blocks Input blocks, replaced with the output blocks.
+ * @param num_blocks Number of blocks.
  */
 OT_WARN_UNUSED_RESULT
-static status_t gctr_process_block(const aes_key_t key, aes_block_t *iv,
-                                   aes_block_t *input, aes_block_t *output) {
-  HARDENED_TRY(aes_encrypt_block(key, iv, input, output));
-  block_inc32(iv);
+static status_t gctr_process_blocks(const aes_key_t key, aes_block_t *iv,
+                                    ghash_context_t *ghash_ctx,
+                                    hardened_bool_t is_encrypt,
+                                    aes_block_t *blocks, size_t num_blocks) {
+  ghash_context_t *ghash_input = NULL;
+  ghash_context_t *ghash_output = NULL;
+  if (is_encrypt == kHardenedBoolTrue) {
+    ghash_output = ghash_ctx;
+  } else if (is_encrypt == kHardenedBoolFalse) {
+    ghash_input = ghash_ctx;
+  } else {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  HARDENED_TRY(aes_encrypt_begin(key, iv));
+  size_t queued =
+      num_blocks < kGctrBlocksQueued ? num_blocks : (size_t)kGctrBlocksQueued;
+
+  // Fill the pipeline.
+  size_t i = 0;
+  for (; i < queued; ++i) {
+    HARDENED_TRY(aes_update(/*dest=*/NULL, &blocks[i]));
+    gctr_ghash_block(ghash_input, &blocks[i]);
+  }
+
+  // Read each output as soon as it is ready and replace its input with the
+  // next one, then hash a block while AES works on the queued ones.
+  for (; i < num_blocks; ++i) {
+    HARDENED_TRY(aes_update(&blocks[i - queued], &blocks[i]));
+    gctr_ghash_block(ghash_input, &blocks[i]);
+    gctr_ghash_block(ghash_output, &blocks[i - queued]);
+  }
+
+  // Drain the pipeline.
+  for (i = num_blocks - queued; i < num_blocks; ++i) {
+    HARDENED_TRY(aes_update(&blocks[i], /*src=*/NULL));
+    gctr_ghash_block(ghash_output, &blocks[i]);
+  }
+
+  HARDENED_TRY(aes_end(NULL));
+  for (i = 0; i < num_blocks; i++) {
+    block_inc32(iv);
+  }
   return OTCRYPTO_OK;
 }
 
+/**
+ * Get the number of full blocks to process in the next GCTR batch.
+ *
+ * This is at most `kGctrMaxBatchBlocks`, and stops at the last block before
+ * the last 32 bits of the counter wrap around.
+ *
+ * @param iv Current counter block.
+ * @param input_len Number of remaining input bytes (at least one block).
+ * @return Number of blocks for the batch (at least one).
+ */
+static size_t gctr_batch_blocks(const aes_block_t *iv, size_t input_len) {
+  size_t num_blocks = input_len / kAesBlockNumBytes;
+  if (num_blocks > kGctrMaxBatchBlocks) {
+    num_blocks = kGctrMaxBatchBlocks;
+  }
+  // Number of inc32 calls before the counter wraps, or 0 for 2^32.
+  uint32_t ctr = __builtin_bswap32(iv->data[kAesBlockNumWords - 1]);
+  uint32_t until_wrap = 0 - ctr;
+  if (until_wrap != 0 && num_blocks > until_wrap) {
+    num_blocks = until_wrap;
+  }
+  return num_blocks;
+}
+
 /**
  * Implements the GCTR function as specified in SP800-38D, section 6.5.
  *
@@ -108,8 +206,14 @@ static status_t gctr_process_block(const aes_key_t key, aes_block_t *iv,
  * generate more output, and the result should be the same as if all the data
  * was passed in one call.
  *
+ * If `ghash_ctx` is non-NULL, also absorbs the full blocks of ciphertext into
+ * GHASH, interleaved with the AES operations; see `gctr_process_blocks`. A
+ * partial block of ciphertext is left to the caller.
+ *
  * @param key The AES key
  * @param iv Initialization vector, 128 bits
+ * @param ghash_ctx GHASH context for the ciphertext, or NULL.
+ * @param is_encrypt Whether the output (true) or input (false) is ciphertext.
  * @param partial_len Length of partial block data in bytes.
  * @param partial Partial AES block.
  * @param input_len Number of bytes for input and output
@@ -119,7 +223,9 @@ static status_t gctr_process_block(const aes_key_t key, aes_block_t *iv,
  */
 OT_WARN_UNUSED_RESULT
 static status_t aes_gcm_gctr(const aes_key_t key, aes_block_t *iv,
-                             size_t partial_len, aes_block_t *partial,
+                             ghash_context_t *ghash_ctx,
+                             hardened_bool_t is_encrypt, size_t partial_len,
+                             aes_block_t *partial,
                              size_t input_len, const uint8_t *input,
                              size_t *output_len, uint8_t *output) {
   // Key must be intended for CTR mode.
@@ -139,21 +245,25 @@ static status_t aes_gcm_gctr(const aes_key_t key, aes_block_t *iv,
     input_len -= kAesBlockNumBytes - partial_len;
 
     // Process the block.
-    aes_block_t block_out;
-    HARDENED_TRY(gctr_process_block(key, iv, partial, &block_out));
-    memcpy(output, block_out.data, kAesBlockNumBytes);
+    HARDENED_TRY(
+        gctr_process_blocks(key, iv, ghash_ctx, is_encrypt, partial, 1));
+    memcpy(output, partial->data, kAesBlockNumBytes);
     output += kAesBlockNumBytes;
     *output_len = kAesBlockNumBytes;
 
-    // Process any remaining full blocks of input.
+    // Process any remaining full blocks of input, several per AES session.
+    aes_block_t blocks[kGctrMaxBatchBlocks];
     while (input_len >= kAesBlockNumBytes) {
-      memcpy(partial->data, input, kAesBlockNumBytes);
-      HARDENED_TRY(gctr_process_block(key, iv, partial, &block_out));
-      memcpy(output, block_out.data, kAesBlockNumBytes);
-      output += kAesBlockNumBytes;
-      *output_len += kAesBlockNumBytes;
-      input += kAesBlockNumBytes;
-      input_len -= kAesBlockNumBytes;
+      size_t num_blocks = gctr_batch_blocks(iv, input_len);
+      size_t num_bytes = num_blocks * kAesBlockNumBytes;
+      memcpy(blocks, input, num_bytes);
+      HARDENED_TRY(gctr_process_blocks(key, iv, ghash_ctx, is_encrypt, blocks,
+                                       num_blocks));
+      memcpy(output, blocks, num_bytes);
+      output += num_bytes;
+      *output_len += num_bytes;
+      input += num_bytes;
+      input_len -= num_bytes;
     }
 
     // Copy any remaining input into the partial block.
@@ -258,6 +368,7 @@ static status_t aes_gcm_get_tag(aes_gcm_context_t *ctx, size_t tag_len,
   size_t full_tag_len;
   aes_block_t empty = {.data = {0}};
   HARDENED_TRY(aes_gcm_gctr(ctx->key, &ctx->initial_counter_block,
+                            /*ghash_ctx=*/NULL, kHardenedBoolTrue,
                             /*partial_len=*/0, &empty, kAesBlockNumBytes,
                             (unsigned char *)s.data, &full_tag_len,
                             (unsigned char *)full_tag));
@@ -409,30 +520,17 @@ status_t aes_gcm_update_encrypted_data(aes_gcm_context_t *ctx, size_t input_len,
                  (unsigned char *)ctx->partial_ghash_block.data);
   }
 
-  // Process any full blocks of input with GCTR to generate more ciphertext.
+  // Process any full blocks of input with GCTR to generate more ciphertext,
+  // and accumulate the full blocks of ciphertext to the GHASH context while
+  // the AES hardware is busy. The ciphertext is the output for encryption, and
+  // the input for decryption. A partial block of ciphertext stays in
+  // `partial_aes_block` until more data arrives or `aes_gcm_final` hashes it.
   size_t partial_aes_block_len = ctx->input_len % kAesBlockNumBytes;
-  HARDENED_TRY(aes_gcm_gctr(ctx->key, &ctx->gctr_iv, partial_aes_block_len,
+  HARDENED_TRY(aes_gcm_gctr(ctx->key, &ctx->gctr_iv, &ctx->ghash_ctx,
+                            ctx->is_encrypt, partial_aes_block_len,
                             &ctx->partial_aes_block, input_len, input,
                             output_len, output));
 
-  // Accumulate any new ciphertext to the GHASH context. The ciphertext is the
-  // output for encryption, and the input for decryption.
-  if (ctx->is_encrypt == kHardenedBoolTrue) {
-    // Since we only generate ciphertext in full-block increments, no partial
-    // blocks are possible in this case.
-    if (*output_len % kGhashBlockNumBytes != 0) {
-      return OTCRYPTO_RECOV_ERR;
-    }
-    ghash_process_full_blocks(&ctx->ghash_ctx, /*partial_len=*/0,
-                              &ctx->partial_ghash_block, *output_len, output);
-  } else if (ctx->is_encrypt == kHardenedBoolFalse) {
-    size_t partial_ghash_block_len = ctx->input_len % kGhashBlockNumBytes;
-    ghash_process_full_blocks(&ctx->ghash_ctx, partial_ghash_block_len,
-                              &ctx->partial_ghash_block, input_len, input);
-  } else {
-    return OTCRYPTO_BAD_ARGS;
-  }
-
   ctx->input_len += input_len;
   return OTCRYPTO_OK;
 }
@@ -476,9 +574,10 @@ status_t aes_gcm_final(aes_gcm_context_t *ctx, size_t tag_len, uint32_t *tag,
         (unsigned char *)ctx->partial_aes_block.data;
     memset(partial_aes_block_bytes + partial_aes_block_len, 0,
            kAesBlockNumBytes - partial_aes_block_len);
-    aes_block_t block_out;
-    HARDENED_TRY(gctr_process_block(ctx->key, &ctx->gctr_iv,
-                                    &ctx->partial_aes_block, &block_out));
+    aes_block_t block_out = ctx->partial_aes_block;
+    HARDENED_TRY(gctr_process_blocks(ctx->key, &ctx->gctr_iv,
+                                     /*ghash_ctx=*/NULL, kHardenedBoolTrue,
+                                     &block_out, 1));
     memcpy(output, block_out.data, partial_aes_block_len);
     *output_len = partial_aes_block_len;
   }
@@ -492,9 +591,8 @@ status_t aes_gcm_final(aes_gcm_context_t *ctx, size_t tag_len, uint32_t *tag,
   } else if (ctx->is_encrypt == kHardenedBoolFalse) {
     // If a partial block of ciphertext (input for decryption) remains,
     // accumulate it in GHASH.
-    size_t partial_ghash_block_len = ctx->input_len % kGhashBlockNumBytes;
-    ghash_update(&ctx->ghash_ctx, partial_ghash_block_len,
-                 (unsigned char *)ctx->partial_ghash_block.data);
+    ghash_update(&ctx->ghash_ctx, partial_aes_block_len,
+                 (unsigned char *)ctx->partial_aes_block.data);
   } else {
     return OTCRYPTO_BAD_ARGS;
   }
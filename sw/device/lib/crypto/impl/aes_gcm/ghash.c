@@ -10,6 +10,22 @@
 // Module ID for status codes.
 #define MODULE_ID MAKE_MODULE_ID('g', 'h', 'a')
 
+/**
+ * Selects the carry-less multiplication backend for GHASH.
+ *
+ * By default, the backend is used when the target has the Zbc (carry-less
+ * multiply) extension, and the 4-bit table backend is used otherwise. Defining
+ * `OT_GHASH_CLMUL=1` on other targets selects the backend with a portable
+ * constant-time carry-less multiply instead, which is useful for testing.
+ */
+#ifndef OT_GHASH_CLMUL
+#if defined(OT_PLATFORM_RV32) && defined(__riscv_zbc)
+#define OT_GHASH_CLMUL 1
+#else
+#define OT_GHASH_CLMUL 0
+#endif
+#endif
+
 enum {
   /**
    * Log2 of the number of bytes in an AES block.
@@ -26,6 +42,25 @@ enum {
 static_assert(kGhashBlockNumBytes == (1 << kGhashBlockLog2NumBytes),
               "kGhashBlockLog2NumBytes does not match kGhashBlockNumBytes");
 
+/**
+ * Performs a bitwise XOR of two blocks.
+ *
+ * This operation corresponds to addition in the Galois field.
+ *
+ * @param x First operand block
+ * @param y Second operand block
+ * @param[out] out Buffer in which to store output; can be the same as one or
+ * both operands.
+ */
+static inline void block_xor(const ghash_block_t *x, const ghash_block_t *y,
+                             ghash_block_t *out) {
+  for (size_t i = 0; i < kGhashBlockNumWords; ++i) {
+    out->data[i] = x->data[i] ^ y->data[i];
+  }
+}
+
+#if !OT_GHASH_CLMUL
+
 /**
  * Precomputed modular reduction constants for Galois field multiplication.
  *
@@ -49,23 +84,6 @@ static const uint16_t kGFReduceTable[16] = {
     0x0000, 0x201c, 0x4038, 0x6024, 0x8070, 0xa06c, 0xc048, 0xe054,
     0x00e1, 0x20fd, 0x40d9, 0x60c5, 0x8091, 0xa08d, 0xc0a9, 0xe0b5};
 
-/**
- * Performs a bitwise XOR of two blocks.
- *
- * This operation corresponds to addition in the Galois field.
- *
- * @param x First operand block
- * @param y Second operand block
- * @param[out] out Buffer in which to store output; can be the same as one or
- * both operands.
- */
-static inline void block_xor(const ghash_block_t *x, const ghash_block_t *y,
-                             ghash_block_t *out) {
-  for (size_t i = 0; i < kGhashBlockNumWords; ++i) {
-    out->data[i] = x->data[i] ^ y->data[i];
-  }
-}
-
 /**
  * Logical right shift of an AES block.
  *
@@ -165,10 +183,6 @@ void ghash_init_subkey(const uint32_t *hash_subkey, ghash_context_t *ctx) {
   }
 }
 
-void ghash_init(ghash_context_t *ctx) {
-  memset(ctx->state.data, 0, kGhashBlockNumBytes);
-}
-
 /**
  * Multiply the GHASH state by the hash subkey.
  *
@@ -233,6 +247,237 @@ static void galois_mul_state_key(ghash_context_t *ctx) {
   memcpy(ctx->state.data, result.data, kGhashBlockNumBytes);
 }
 
+#else  // OT_GHASH_CLMUL
+
+enum {
+  /**
+   * Number of powers of the hash subkey kept in the context.
+   */
+  kGhashNumKeyPowers = 4,
+  /**
+   * Number of words in an unreduced product of two field elements.
+   */
+  kGhashProductNumWords = 2 * kGhashBlockNumWords,
+};
+static_assert(kGhashNumKeyPowers <= ARRAYSIZE(((ghash_context_t *)0)->tbl),
+              "Key powers do not fit in the GHASH context");
+
+/**
+ * Carry-less product of two 32-bit words.
+ *
+ * Uses `clmul` and `clmulh` from the Zbc extension when the target has it, and
+ * a constant-time shift-and-add loop otherwise.
+ *
+ * @param a First operand.
+ * @param b Second operand.
+ * @param[out] out Buffer for the 64-bit product (2 words, least significant
+ * first).
+ */
+static inline void clmul32(uint32_t a, uint32_t b, uint32_t *out) {
+#if defined(OT_PLATFORM_RV32) && defined(__riscv_zbc)
+  asm("clmul %0, %1, %2" : "=r"(out[0]) : "r"(a), "r"(b));
+  asm("clmulh %0, %1, %2" : "=r"(out[1]) : "r"(a), "r"(b));
+#else
+  uint64_t product = 0;
+  for (size_t i = 0; i < 32; ++i) {
+    uint64_t mask = 0 - (uint64_t)((b >> i) & 1);
+    product ^= ((uint64_t)a << i) & mask;
+  }
+  out[0] = (uint32_t)product;
+  out[1] = (uint32_t)(product >> 32);
+#endif
+}
+
+/**
+ * Carry-less product of two 64-bit values with one Karatsuba step.
+ *
+ * @param a First operand (2 words, least significant first).
+ * @param b Second operand (2 words, least significant first).
+ * @param[out] out Buffer for the 128-bit product (4 words, least significant
+ * first).
+ */
+static inline void clmul64(const uint32_t *a, const uint32_t *b,
+                           uint32_t *out) {
+  uint32_t mid[2];
+  clmul32(a[0], b[0], &out[0]);
+  clmul32(a[1], b[1], &out[2]);
+  clmul32(a[0] ^ a[1], b[0] ^ b[1], mid);
+  mid[0] ^= out[0] ^ out[2];
+  mid[1] ^= out[1] ^ out[3];
+  out[1] ^= mid[0];
+  out[2] ^= mid[1];
+}
+
+/**
+ * Carry-less product of two 128-bit values with one Karatsuba step.
+ *
+ * The product is added (XORed) to `acc` rather than written to it, so that
+ * several products can share one modular reduction.
+ *
+ * @param a First operand (4 words, least significant first).
+ * @param b Second operand (4 words, least significant first).
+ * @param[in,out] acc Accumulator for the 256-bit product
+ * (`kGhashProductNumWords` words, least significant first).
+ */
+static void clmul128_acc(const uint32_t *a, const uint32_t *b, uint32_t *acc) {
+  uint32_t lo[4];
+  uint32_t hi[4];
+  uint32_t mid[4];
+  uint32_t a_sum[2] = {a[0] ^ a[2], a[1] ^ a[3]};
+  uint32_t b_sum[2] = {b[0] ^ b[2], b[1] ^ b[3]};
+  clmul64(&a[0], &b[0], lo);
+  clmul64(&a[2], &b[2], hi);
+  clmul64(a_sum, b_sum, mid);
+  for (size_t i = 0; i < 4; ++i) {
+    mid[i] ^= lo[i] ^ hi[i];
+    acc[i] ^= lo[i];
+    acc[i + 4] ^= hi[i];
+  }
+  for (size_t i = 0; i < 4; ++i) {
+    acc[i + 2] ^= mid[i];
+  }
+}
+
+/**
+ * Convert a block to the integer representation used for carry-less products.
+ *
+ * GCM stores the coefficient of x^0 in the most significant bit of the first
+ * byte, so reading a block as a big-endian 128-bit integer gives the
+ * bit-reflected polynomial. The product of two reflected polynomials is the
+ * reflected product shifted right by one bit, which `galois_reduce` accounts
+ * for.
+ *
+ * @param block Input block.
+ * @param[out] out Buffer for the integer (4 words, least significant first).
+ */
+static inline void block_to_int(const ghash_block_t *block, uint32_t *out) {
+  for (size_t i = 0; i < kGhashBlockNumWords; ++i) {
+    out[i] = __builtin_bswap32(block->data[kGhashBlockNumWords - 1 - i]);
+  }
+}
+
+/**
+ * Convert the integer representation back to a block.
+ *
+ * @param in Integer (4 words, least significant first).
+ * @param[out] block Output block.
+ */
+static inline void int_to_block(const uint32_t *in, ghash_block_t *block) {
+  for (size_t i = 0; i < kGhashBlockNumWords; ++i) {
+    block->data[kGhashBlockNumWords - 1 - i] = __builtin_bswap32(in[i]);
+  }
+}
+
+/**
+ * Reduce a bit-reflected 256-bit carry-less product modulo the GCM modulus.
+ *
+ * Follows the shift-and-fold reduction from Gueron and Kounavis, "Intel
+ * Carry-Less Multiplication Instruction and its Usage for Computing the GCM
+ * Mode" (algorithm 5), with 32-bit words.
+ *
+ * Runs in constant time.
+ *
+ * @param product Unreduced product (`kGhashProductNumWords` words, least
+ * significant first); clobbered.
+ * @param[out] out Buffer for the reduced element (4 words, least significant
+ * first).
+ */
+static void galois_reduce(uint32_t *product, uint32_t *out) {
+  // Shift the product left by one bit to undo the reflection offset.
+  for (size_t i = kGhashProductNumWords - 1; i > 0; --i) {
+    product[i] = (product[i] << 1) | (product[i - 1] >> 31);
+  }
+  product[0] <<= 1;
+
+  // Fold the bits of the low half that the right shifts below would shift
+  // out into its top word.
+  uint32_t *low = &product[0];
+  low[3] ^= (low[0] << 31) ^ (low[0] << 30) ^ (low[0] << 25);
+
+  // Reduce: out = high + low + (low >> 1) + (low >> 2) + (low >> 7).
+  const uint32_t *high = &product[kGhashBlockNumWords];
+  for (size_t i = 0; i < kGhashBlockNumWords; ++i) {
+    uint32_t next = i + 1 < kGhashBlockNumWords ? low[i + 1] : 0;
+    out[i] = high[i] ^ low[i] ^ (low[i] >> 1) ^ (next << 31) ^ (low[i] >> 2) ^
+             (next << 30) ^ (low[i] >> 7) ^ (next << 25);
+  }
+}
+
+/**
+ * Multiply two field elements in the integer representation.
+ *
+ * @param a First operand (4 words, least significant first).
+ * @param b Second operand (4 words, least significant first).
+ * @param[out] out Buffer for the product (4 words, least significant first).
+ */
+static void galois_mul(const uint32_t *a, const uint32_t *b, uint32_t *out) {
+  uint32_t product[kGhashProductNumWords] = {0};
+  clmul128_acc(a, b, product);
+  galois_reduce(product, out);
+}
+
+void ghash_init_subkey(const uint32_t *hash_subkey, ghash_context_t *ctx) {
+  // Store H, H^2, H^3 and H^4 in the integer representation, so that four
+  // blocks can be multiplied and then reduced together.
+  memset(ctx->tbl, 0, sizeof(ctx->tbl));
+  ghash_block_t h;
+  memcpy(h.data, hash_subkey, kGhashBlockNumBytes);
+  block_to_int(&h, ctx->tbl[0].data);
+  for (size_t i = 1; i < kGhashNumKeyPowers; ++i) {
+    galois_mul(ctx->tbl[i - 1].data, ctx->tbl[0].data, ctx->tbl[i].data);
+  }
+}
+
+/**
+ * Multiply the GHASH state by the hash subkey.
+ *
+ * See NIST SP800-38D, section 6.3.
+ *
+ * This operation corresponds to multiplication in the Galois field with order
+ * 2^128, modulo the polynomial x^128 +  x^8 + x^2 + x + 1
+ *
+ * @param ctx GHASH context, updated in place.
+ */
+static void galois_mul_state_key(ghash_context_t *ctx) {
+  uint32_t state[kGhashBlockNumWords];
+  block_to_int(&ctx->state, state);
+  galois_mul(state, ctx->tbl[0].data, state);
+  int_to_block(state, &ctx->state);
+}
+
+/**
+ * Four-block update function for GHASH.
+ *
+ * Computes (S + X1) * H^4 + X2 * H^3 + X3 * H^2 + X4 * H with a single modular
+ * reduction, which is equal to processing the blocks one by one.
+ *
+ * @param ctx GHASH context.
+ * @param input Input data (`kGhashNumKeyPowers` blocks).
+ */
+static void ghash_process_4_blocks(ghash_context_t *ctx,
+                                   const uint8_t *input) {
+  uint32_t product[kGhashProductNumWords] = {0};
+  for (size_t i = 0; i < kGhashNumKeyPowers; ++i) {
+    ghash_block_t block;
+    memcpy(block.data, input + i * kGhashBlockNumBytes, kGhashBlockNumBytes);
+    if (i == 0) {
+      block_xor(&ctx->state, &block, &block);
+    }
+    uint32_t x[kGhashBlockNumWords];
+    block_to_int(&block, x);
+    clmul128_acc(x, ctx->tbl[kGhashNumKeyPowers - 1 - i].data, product);
+  }
+  uint32_t state[kGhashBlockNumWords];
+  galois_reduce(product, state);
+  int_to_block(state, &ctx->state);
+}
+
+#endif  // OT_GHASH_CLMUL
+
+void ghash_init(ghash_context_t *ctx) {
+  memset(ctx->state.data, 0, kGhashBlockNumBytes);
+}
+
 /**
  * Single-block update function for GHASH.
  *
@@ -264,6 +509,15 @@ void ghash_process_full_blocks(ghash_context_t *ctx, size_t partial_len,
     // Process the block.
     ghash_process_block(ctx, partial);
 
+#if OT_GHASH_CLMUL
+    // Process four blocks at a time with a single reduction.
+    while (input_len >= kGhashNumKeyPowers * kGhashBlockNumBytes) {
+      ghash_process_4_blocks(ctx, input);
+      input += kGhashNumKeyPowers * kGhashBlockNumBytes;
+      input_len -= kGhashNumKeyPowers * kGhashBlockNumBytes;
+    }
+#endif
+
     // Process any remaining full blocks of input.
     while (input_len >= kGhashBlockNumBytes) {
       memcpy(partial->data, input, kGhashBlockNumBytes);
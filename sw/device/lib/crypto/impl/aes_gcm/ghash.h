@@ -32,7 +32,12 @@ typedef struct ghash_block {
 
 typedef struct ghash_context {
   /**
-   * Precomputed product table for the hash subkey.
+   * Precomputed data for the hash subkey.
+   *
+   * With the 4-bit table backend, this is the product table of the hash
+   * subkey. With the carry-less multiplication backend (`OT_GHASH_CLMUL`), the
+   * first four entries hold the powers H, H^2, H^3 and H^4 of the hash subkey
+   * and the rest is unused.
    */
   ghash_block_t tbl[16];
   /**
@@ -214,6 +214,57 @@ TEST(Ghash, ContextReset) {
   EXPECT_THAT(result, testing::ElementsAreArray(exp_result));
 }
 
+TEST(Ghash, McGrawViegaTestCase3) {
+  // GHASH computation from test case 3 of:
+  // https://csrc.nist.rip/groups/ST/toolkit/BCM/documents/proposedmodes/gcm/gcm-spec.pdf
+  //
+  // The input is more than four blocks long, so the carry-less multiplication
+  // backend processes some of it with aggregated reduction.
+  //
+  // H: b83b533708bf535d0aa6e52980d53b78
+  // A: (empty)
+  // C:
+  // 42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985
+  // GHASH(H,A,C): 7f1b32b81b820d02614f8895ac1d4eac
+  std::array<uint32_t, 4> H = {
+      0x37533bb8,
+      0x5d53bf08,
+      0x29e5a60a,
+      0x783bd580,
+  };
+  std::array<uint32_t, 16> C = {
+      0xc21e8342, 0x24747721, 0xb721724b, 0x9cd4d084, 0x2f21aae3, 0xe0a4022c,
+      0x237ec135, 0x2ea1ac29, 0xb214d521, 0x1c936654, 0x5a6a8f7d, 0x05aa84ac,
+      0x390ba31b, 0x97ac0a6a, 0x91e0583d, 0x85593f47,
+  };
+  std::array<uint32_t, 4> exp_result = {
+      0xb8321b7f,
+      0x020d821b,
+      0x95884f61,
+      0xac4e1dac,
+  };
+
+  // Encode bitlengths of A and C as big-endian 64-bit integers.
+  std::array<uint64_t, 2> bitlengths = {
+      0,
+      C.size() * sizeof(uint32_t) * 8,
+  };
+  bitlengths[1] = __builtin_bswap64(bitlengths[1]);
+
+  // Compute GHASH(H, A, C), with the length block in the same update as C.
+  std::array<uint8_t, sizeof(C) + sizeof(bitlengths)> input;
+  memcpy(input.data(), C.data(), sizeof(C));
+  memcpy(input.data() + sizeof(C), bitlengths.data(), sizeof(bitlengths));
+  ghash_context_t ctx;
+  ghash_init_subkey(H.data(), &ctx);
+  ghash_init(&ctx);
+  ghash_update(&ctx, input.size(), input.data());
+  uint32_t result[kGhashBlockNumWords];
+  ghash_final(&ctx, result);
+
+  EXPECT_THAT(result, testing::ElementsAreArray(exp_result));
+}
+
 TEST(Ghash, McGrawViegaTestCase18) {
   // GHASH computation from test case 18 of:
   // https://csrc.nist.rip/groups/ST/toolkit/BCM/documents/proposedmodes/gcm/gcm-spec.pdf
@@ -50,41 +50,36 @@ status_t aes_kwp_wrap(const aes_key_t kek, const uint32_t *plaintext,
 
   // Construct the first semiblock (A): a fixed 32-bit prefix followed by the
   // byte-length encoded as a big-endian 32-bit integer.
-  aes_block_t block = {
-      .data = {0xa65959a6, __builtin_bswap32(plaintext_len), 0, 0},
-  };
+  uint32_t a[kSemiblockWords] = {0xa65959a6, __builtin_bswap32(plaintext_len)};
 
   // Initialize the output buffer with (A || plaintext || padding).
   size_t plaintext_words = ceil_div(plaintext_len, sizeof(uint32_t));
-  hardened_memcpy(ciphertext, block.data, kSemiblockWords);
+  hardened_memcpy(ciphertext, a, kSemiblockWords);
   hardened_memcpy(ciphertext + kSemiblockWords, plaintext, plaintext_words);
   unsigned char *pad_start =
       ((unsigned char *)ciphertext) + kSemiblockBytes + plaintext_len;
   memset(pad_start, 0, pad_len);
 
+  // Each step depends on A from the step before, so the blocks cannot be
+  // pipelined; each is one round trip through AES, encrypting A || R[i] in
+  // place with R[i] still in the output buffer.
   uint64_t t = 1;
   for (size_t j = 0; j < 6; j++) {
     for (size_t i = 1; i <= plaintext_semiblocks; i++) {
-      // Copy R[i] into the block (A should already be present).
-      hardened_memcpy(block.data + kSemiblockWords,
-                      ciphertext + i * kSemiblockWords, kSemiblockWords);
-      HARDENED_TRY(aes_update(/*dest=*/NULL, &block));
-      HARDENED_TRY(aes_update(&block, /*src=*/NULL));
+      HARDENED_TRY(
+          aes_update_semiblocks(a, ciphertext + i * kSemiblockWords));
 
       // Encode the index and XOR it with the first semiblock, creating A for
       // the next iteration.
-      block.data[0] ^= __builtin_bswap32((uint32_t)(t >> 32));
-      block.data[1] ^= __builtin_bswap32((uint32_t)(t & UINT32_MAX));
+      a[0] ^= __builtin_bswap32((uint32_t)(t >> 32));
+      a[1] ^= __builtin_bswap32((uint32_t)(t & UINT32_MAX));
       t++;
-
-      // Copy the last two words back into R[i].
-      hardened_memcpy(ciphertext + i * kSemiblockWords,
-                      block.data + kSemiblockWords, kSemiblockWords);
     }
   }
+  HARDENED_TRY(aes_end(/*iv=*/NULL));
 
   // Copy A into the first semiblock of the ciphertext.
-  hardened_memcpy(ciphertext, block.data, kSemiblockWords);
+  hardened_memcpy(ciphertext, a, kSemiblockWords);
   return OTCRYPTO_OK;
 }
 
@@ -114,9 +109,7 @@ status_t aes_kwp_unwrap(const aes_key_t kek, const uint32_t *ciphertext,
   //   https://datatracker.ietf.org/doc/html/rfc3394#section-2.2.2
 
   // Set the first semiblock, A.
-  aes_block_t block = {
-      .data = {ciphertext[0], ciphertext[1], 0, 0},
-  };
+  uint32_t a[kSemiblockWords] = {ciphertext[0], ciphertext[1]};
 
   // Initialize the working buffer, R.
   uint32_t r[(ciphertext_semiblocks - 1) * kSemiblockWords];
@@ -126,30 +119,24 @@ status_t aes_kwp_unwrap(const aes_key_t kek, const uint32_t *ciphertext,
   for (size_t j = 0; j < 6; j++) {
     for (size_t i = ciphertext_semiblocks - 1; 1 <= i; i--) {
       // Encode the index and XOR it with the first semiblock (A ^ t).
-      block.data[0] ^= __builtin_bswap32((uint32_t)(t >> 32));
-      block.data[1] ^= __builtin_bswap32((uint32_t)(t & UINT32_MAX));
+      a[0] ^= __builtin_bswap32((uint32_t)(t >> 32));
+      a[1] ^= __builtin_bswap32((uint32_t)(t & UINT32_MAX));
       t--;
 
-      // Copy R[i] into the block (A ^ t should already be present).
-      hardened_memcpy(block.data + kSemiblockWords,
-                      r + (i - 1) * kSemiblockWords, kSemiblockWords);
-      HARDENED_TRY(aes_update(/*dest=*/NULL, &block));
-      HARDENED_TRY(aes_update(&block, /*src=*/NULL));
-
-      // Copy the last two words back into R[i].
-      hardened_memcpy(r + (i - 1) * kSemiblockWords,
-                      block.data + kSemiblockWords, kSemiblockWords);
+      // Decrypt (A ^ t) || R[i] in place.
+      HARDENED_TRY(aes_update_semiblocks(a, r + (i - 1) * kSemiblockWords));
     }
   }
+  HARDENED_TRY(aes_end(/*iv=*/NULL));
 
   // Check that the first 32 bits of A match the AES-KWP fixed prefix.
-  if (block.data[0] != 0xa65959a6) {
+  if (a[0] != 0xa65959a6) {
     *success = kHardenedBoolFalse;
     return OTCRYPTO_OK;
   }
 
   // Decode the next 32 bits of A as the plaintext length.
-  size_t plaintext_len = __builtin_bswap32(block.data[1]);
+  size_t plaintext_len = __builtin_bswap32(a[1]);
   size_t pad_len =
       kSemiblockBytes * (ciphertext_semiblocks - 1) - plaintext_len;
 
@@ -178,6 +178,12 @@ static otcrypto_status_t generate(hardened_bool_t fips_check,
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Serve FIPS requests without additional input from the SW CSRNG output
+  // pool, so that many small requests share one generate command.
+  if (fips_check == kHardenedBoolTrue && additional_input.len == 0) {
+    return entropy_csrng_pool_get(drbg_output.data, drbg_output.len);
+  }
+
   entropy_seed_material_t seed_material;
   seed_material_construct(additional_input, &seed_material);
   HARDENED_TRY(entropy_csrng_generate(&seed_material, drbg_output.data,
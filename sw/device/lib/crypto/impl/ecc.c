@@ -6,6 +6,7 @@
 
 #include "sw/device/lib/crypto/drivers/entropy.h"
 #include "sw/device/lib/crypto/drivers/hmac.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
 #include "sw/device/lib/crypto/impl/ecc/ecdh_p256.h"
 #include "sw/device/lib/crypto/impl/ecc/ecdh_p384.h"
 #include "sw/device/lib/crypto/impl/ecc/ecdsa_p256.h"
@@ -21,6 +22,7 @@ otcrypto_status_t otcrypto_ecdsa_keygen(
     const otcrypto_ecc_curve_t *elliptic_curve,
     otcrypto_blinded_key_t *private_key, otcrypto_unblinded_key_t *public_key) {
   HARDENED_TRY(otcrypto_ecdsa_keygen_async_start(elliptic_curve, private_key));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_ecdsa_keygen_async_finalize(elliptic_curve, private_key,
                                               public_key);
 }
@@ -32,6 +34,7 @@ otcrypto_status_t otcrypto_ecdsa_sign(
     otcrypto_word32_buf_t signature) {
   HARDENED_TRY(otcrypto_ecdsa_sign_async_start(private_key, message_digest,
                                                elliptic_curve));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_ecdsa_sign_async_finalize(elliptic_curve, signature);
 }
 
@@ -43,14 +46,48 @@ otcrypto_status_t otcrypto_ecdsa_verify(
     hardened_bool_t *verification_result) {
   HARDENED_TRY(otcrypto_ecdsa_verify_async_start(public_key, message_digest,
                                                  signature, elliptic_curve));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_ecdsa_verify_async_finalize(elliptic_curve, signature,
                                               verification_result);
 }
 
+otcrypto_status_t otcrypto_ecdsa_verify_batch(
+    const otcrypto_ecdsa_verify_item_t *items, size_t num_items,
+    const otcrypto_ecc_curve_t *elliptic_curve,
+    hardened_bool_t *verification_results) {
+  if (items == NULL || verification_results == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Every item loads the same OTBN app, so after the first one the OTBN
+  // driver keeps IMEM and only resets DMEM.
+  size_t i = 0;
+  for (; launder32(i) < num_items; ++i) {
+    const otcrypto_ecdsa_verify_item_t *item = &items[i];
+    HARDENED_TRY(otcrypto_ecdsa_verify_async_start(
+        item->public_key, item->message_digest, item->signature,
+        elliptic_curve));
+    HARDENED_TRY(otbn_busy_wait_for_done());
+    status_t result = otcrypto_ecdsa_verify_async_finalize(
+        elliptic_curve, item->signature, &verification_results[i]);
+    // OTBN rejects invalid signatures and keys with a bad-arguments error;
+    // for a batch, that is just a failed verification of this item.
+    if (status_err(result) == kInvalidArgument) {
+      verification_results[i] = kHardenedBoolFalse;
+      continue;
+    }
+    HARDENED_TRY(result);
+  }
+  HARDENED_CHECK_EQ(i, num_items);
+
+  return OTCRYPTO_OK;
+}
+
 otcrypto_status_t otcrypto_ecdh_keygen(
     const otcrypto_ecc_curve_t *elliptic_curve,
     otcrypto_blinded_key_t *private_key, otcrypto_unblinded_key_t *public_key) {
   HARDENED_TRY(otcrypto_ecdh_keygen_async_start(elliptic_curve, private_key));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_ecdh_keygen_async_finalize(elliptic_curve, private_key,
                                              public_key);
 }
@@ -61,6 +98,7 @@ otcrypto_status_t otcrypto_ecdh(const otcrypto_blinded_key_t *private_key,
                                 otcrypto_blinded_key_t *shared_secret) {
   HARDENED_TRY(
       otcrypto_ecdh_async_start(private_key, public_key, elliptic_curve));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_ecdh_async_finalize(elliptic_curve, shared_secret);
 }
 
@@ -424,6 +462,9 @@ otcrypto_status_t otcrypto_ecdsa_keygen_async_finalize(
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
+
   // Check the key modes.
   if (launder32(private_key->config.key_mode) != kOtcryptoKeyModeEcdsa ||
       launder32(public_key->key_mode) != kOtcryptoKeyModeEcdsa) {
@@ -630,6 +671,9 @@ otcrypto_status_t otcrypto_ecdsa_sign_async_finalize(
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
+
   // Select the correct signing operation and finalize it.
   switch (launder32(elliptic_curve->curve_type)) {
     case kOtcryptoEccCurveTypeNistP256:
@@ -789,6 +833,9 @@ otcrypto_status_t otcrypto_ecdsa_verify_async_finalize(
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
+
   // Select the correct verification operation and finalize it.
   switch (launder32(elliptic_curve->curve_type)) {
     case kOtcryptoEccCurveTypeNistP256:
@@ -972,6 +1019,9 @@ otcrypto_status_t otcrypto_ecdh_keygen_async_finalize(
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
+
   // Check the key modes.
   if (launder32(public_key->key_mode) != kOtcryptoKeyModeEcdh ||
       launder32(private_key->config.key_mode) != kOtcryptoKeyModeEcdh) {
@@ -1221,6 +1271,9 @@ otcrypto_status_t otcrypto_ecdh_async_finalize(
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
+
   // Select the correct ECDH operation and finalize it.
   switch (launder32(elliptic_curve->curve_type)) {
     case kOtcryptoEccCurveTypeNistP256:
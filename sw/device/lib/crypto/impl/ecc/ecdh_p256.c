@@ -82,8 +82,8 @@ status_t ecdh_p256_keypair_finalize(p256_masked_scalar_t *private_key,
   HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEcdhX, public_key->x));
   HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEcdhY, public_key->y));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -129,8 +129,8 @@ status_t ecdh_p256_shared_key_finalize(ecdh_p256_shared_key_t *shared_key) {
   HARDENED_TRY(
       otbn_dmem_read(kP256CoordWords, kOtbnVarEcdhY, shared_key->share1));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -155,8 +155,8 @@ status_t ecdh_p256_sideload_keypair_finalize(p256_point_t *public_key) {
   HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEcdhX, public_key->x));
   HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEcdhY, public_key->y));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
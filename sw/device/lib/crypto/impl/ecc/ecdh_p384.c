@@ -7,7 +7,6 @@
 #include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/base/hardened_memory.h"
 #include "sw/device/lib/crypto/drivers/otbn.h"
-#include "sw/device/lib/crypto/impl/ecc/p384_curve_point_valid.h"
 
 #include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
 
@@ -81,18 +80,14 @@ status_t ecdh_p384_keypair_finalize(p384_masked_scalar_t *private_key,
   HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEcdhX, public_key->x));
   HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEcdhY, public_key->y));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
 
 status_t ecdh_p384_shared_key_start(const p384_masked_scalar_t *private_key,
                                     const p384_point_t *public_key) {
-  // Check if public key is valid
-  HARDENED_TRY(p384_curve_point_validate_start(public_key));
-  HARDENED_TRY(p384_curve_point_validate_finalize());
-
   // Load the ECDH/P-384 app. Fails if OTBN is non-idle.
   HARDENED_TRY(otbn_load_app(kOtbnAppEcdh));
 
@@ -124,8 +119,8 @@ status_t ecdh_p384_shared_key_finalize(ecdh_p384_shared_key_t *shared_key) {
   HARDENED_TRY(
       otbn_dmem_read(kP384CoordWords, kOtbnVarEcdhY, shared_key->share1));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -150,17 +145,13 @@ status_t ecdh_p384_sideload_keypair_finalize(p384_point_t *public_key) {
   HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEcdhX, public_key->x));
   HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEcdhY, public_key->y));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
 
 status_t ecdh_p384_sideload_shared_key_start(const p384_point_t *public_key) {
-  // Check if public key is valid
-  HARDENED_TRY(p384_curve_point_validate_start(public_key));
-  HARDENED_TRY(p384_curve_point_validate_finalize());
-
   // Load the ECDH/P-384 app. Fails if OTBN is non-idle.
   HARDENED_TRY(otbn_load_app(kOtbnAppEcdh));
 
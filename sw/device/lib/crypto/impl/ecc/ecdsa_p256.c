@@ -105,8 +105,8 @@ status_t ecdsa_p256_keygen_finalize(p256_masked_scalar_t *private_key,
   HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEcdsaX, public_key->x));
   HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEcdsaY, public_key->y));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -119,8 +119,8 @@ status_t ecdsa_p256_sideload_keygen_finalize(p256_point_t *public_key) {
   HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEcdsaX, public_key->x));
   HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEcdsaY, public_key->y));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -196,8 +196,8 @@ status_t ecdsa_p256_sign_finalize(ecdsa_p256_signature_t *result) {
   // Read signature S out of OTBN dmem.
   HARDENED_TRY(otbn_dmem_read(kP256ScalarWords, kOtbnVarEcdsaS, result->s));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -251,8 +251,8 @@ status_t ecdsa_p256_verify_finalize(const ecdsa_p256_signature_t *signature,
 
   *result = hardened_memeq(x_r, signature->r, kP256ScalarWords);
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
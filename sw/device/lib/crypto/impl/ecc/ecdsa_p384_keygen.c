@@ -91,8 +91,8 @@ status_t ecdsa_p384_keygen_finalize(p384_masked_scalar_t *private_key,
   HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEcdsaX, public_key->x));
   HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEcdsaY, public_key->y));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -105,8 +105,8 @@ status_t ecdsa_p384_sideload_keygen_finalize(p384_point_t *public_key) {
   HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEcdsaX, public_key->x));
   HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEcdsaY, public_key->y));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -98,8 +98,8 @@ status_t ecdsa_p384_sign_finalize(ecdsa_p384_signature_t *result) {
   // Read signature S out of OTBN dmem.
   HARDENED_TRY(otbn_dmem_read(kP384ScalarWords, kOtbnVarEcdsaS, result->s));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -161,6 +161,102 @@ otcrypto_status_t otcrypto_hash(otcrypto_const_byte_buf_t input_message,
   return OTCRYPTO_OK;
 }
 
+/**
+ * Hashes the messages of a batch with SHA-2, keeping HMAC configured.
+ *
+ * @param hmac_mode SHA-2 mode of the batch.
+ * @param items Messages and digests of the batch.
+ * @param num_items Number of elements in `items`.
+ * @return Result of the hash operations.
+ */
+static status_t hash_batch_sha2(hmac_mode_t hmac_mode,
+                                const otcrypto_hash_batch_item_t *items,
+                                size_t num_items) {
+  HARDENED_TRY(hmac_hash_batch_start(hmac_mode));
+  for (size_t i = 0; i < num_items; i++) {
+    status_t res =
+        hmac_hash_batch_next(items[i].message, items[i].message_len,
+                             items[i].digest.data, items[i].digest.len);
+    if (!status_ok(res)) {
+      hmac_hash_batch_end();
+      return res;
+    }
+  }
+  hmac_hash_batch_end();
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Hashes the messages of a batch with SHA-3, keeping KMAC configured.
+ *
+ * @param digest_len Digest length of the batch in words.
+ * @param items Messages and digests of the batch.
+ * @param num_items Number of elements in `items`.
+ * @return Result of the hash operations.
+ */
+static status_t hash_batch_sha3(size_t digest_len,
+                                const otcrypto_hash_batch_item_t *items,
+                                size_t num_items) {
+  HARDENED_TRY(kmac_sha3_batch_start(digest_len));
+  for (size_t i = 0; i < num_items; i++) {
+    status_t res = kmac_sha3_batch_next(items[i].message, items[i].message_len,
+                                        items[i].digest.data);
+    if (!status_ok(res)) {
+      kmac_sha3_batch_end();
+      return res;
+    }
+  }
+  kmac_sha3_batch_end();
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_hash_batch(const otcrypto_hash_batch_item_t *items,
+                                      size_t num_items) {
+  if (items == NULL && num_items != 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  if (num_items == 0) {
+    return OTCRYPTO_OK;
+  }
+
+  // Check every item before hashing any of them.
+  otcrypto_hash_mode_t mode = items[0].digest.mode;
+  for (size_t i = 0; i < num_items; i++) {
+    const otcrypto_hash_batch_item_t *item = &items[i];
+    if (item->message == NULL && item->message_len != 0) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    if (item->digest.data == NULL || item->digest.mode != mode) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    HARDENED_TRY(check_digest_len(item->digest));
+  }
+
+  switch (mode) {
+    case kOtcryptoHashModeSha3_224:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha3_256:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha3_384:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha3_512:
+      return hash_batch_sha3(items[0].digest.len, items, num_items);
+    case kOtcryptoHashModeSha256:
+      return hash_batch_sha2(kHmacModeSha256, items, num_items);
+    case kOtcryptoHashModeSha384:
+      return hash_batch_sha2(kHmacModeSha384, items, num_items);
+    case kOtcryptoHashModeSha512:
+      return hash_batch_sha2(kHmacModeSha512, items, num_items);
+    default:
+      // Invalid hash mode.
+      return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Should be unreachable.
+  HARDENED_TRAP();
+  return OTCRYPTO_FATAL_ERR;
+}
+
 otcrypto_status_t otcrypto_xof_shake(otcrypto_const_byte_buf_t input_message,
                                      otcrypto_hash_digest_t digest) {
   switch (digest.mode) {
@@ -265,6 +361,95 @@ otcrypto_status_t otcrypto_hash_update(
   return OTCRYPTO_OK;
 }
 
+/**
+ * Checks whether an earlier item of the batch updates the same context.
+ *
+ * @param items Updates of the batch.
+ * @param index Index of the item to check.
+ * @return True if `items[index]` is the first update of its context.
+ */
+static bool update_is_first_of_ctx(const otcrypto_hash_update_item_t *items,
+                                   size_t index) {
+  for (size_t i = 0; i < index; i++) {
+    if (items[i].ctx == items[index].ctx) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Runs the updates of one context in a batch, merging adjacent messages.
+ *
+ * @param items Updates of the batch.
+ * @param first Index of the first update of the context.
+ * @param num_items Number of elements in `items`.
+ * @return Result of the hash update operations.
+ */
+static status_t update_batch_ctx(const otcrypto_hash_update_item_t *items,
+                                 size_t first, size_t num_items) {
+  otcrypto_hash_context_t *ctx = items[first].ctx;
+  // Message data that is not hashed yet, and the index of the first update it
+  // belongs to.
+  const uint8_t *pending_data = NULL;
+  size_t pending_len = 0;
+  size_t pending_first = first;
+  for (size_t i = first; i <= num_items; i++) {
+    if (i < num_items) {
+      if (items[i].ctx != ctx) {
+        continue;
+      }
+      const otcrypto_const_byte_buf_t *msg = &items[i].input_message;
+      if (msg->data == NULL && msg->len != 0) {
+        return OTCRYPTO_BAD_ARGS;
+      }
+      if (pending_len == 0) {
+        pending_data = msg->data;
+        pending_len = msg->len;
+        continue;
+      }
+      if (msg->len == 0 || msg->data == pending_data + pending_len) {
+        pending_len += msg->len;
+        continue;
+      }
+    }
+
+    // Hash the pending data and run the callbacks of its updates.
+    otcrypto_const_byte_buf_t pending = {
+        .data = pending_data,
+        .len = pending_len,
+    };
+    HARDENED_TRY(otcrypto_hash_update(ctx, pending));
+    for (size_t j = pending_first; j < i; j++) {
+      if (items[j].ctx == ctx && items[j].done != NULL) {
+        items[j].done(items[j].done_arg);
+      }
+    }
+    if (i < num_items) {
+      pending_data = items[i].input_message.data;
+      pending_len = items[i].input_message.len;
+      pending_first = i;
+    }
+  }
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_hash_update_batch(
+    const otcrypto_hash_update_item_t *items, size_t num_items) {
+  if (items == NULL && num_items != 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  for (size_t i = 0; i < num_items; i++) {
+    if (items[i].ctx == NULL) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    if (update_is_first_of_ctx(items, i)) {
+      HARDENED_TRY(update_batch_ctx(items, i, num_items));
+    }
+  }
+  return OTCRYPTO_OK;
+}
+
 otcrypto_status_t otcrypto_hash_final(otcrypto_hash_context_t *const ctx,
                                       otcrypto_hash_digest_t digest) {
   if (ctx == NULL || digest.data == NULL) {
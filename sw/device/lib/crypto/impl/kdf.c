@@ -138,40 +138,45 @@ otcrypto_status_t otcrypto_kdf_hmac_ctr(
   HARDENED_TRY(check_zero_byte(kdf_label));
   HARDENED_TRY(check_zero_byte(kdf_context));
 
-  // Setup
-  uint8_t zero = 0x00;
-  HARDENED_CHECK_LE(required_byte_len, UINT32_MAX / 8);
-  uint32_t required_bit_len = __builtin_bswap32(required_byte_len * 8);
-
-  // Repeatedly call HMAC to generate the derived key based on input data:
+  // Build the HMAC input for each iteration in one buffer:
   // [i]_2 || Label || 0x00 || Context || [L]_2
   // (see NIST SP 800-108r1, section 4.1)
   // [i]_2 is the binary representation of the counter value
   // [L]_2 is the binary representation of the required bit length
   // The counter value is updated within the loop
+  HARDENED_CHECK_LE(required_byte_len, UINT32_MAX / 8);
+  uint32_t required_bit_len = __builtin_bswap32(required_byte_len * 8);
+  size_t label_offset = sizeof(uint32_t);
+  size_t context_offset = label_offset + kdf_label.len + 1;
+  size_t bit_len_offset = context_offset + kdf_context.len;
+  uint8_t message_data[bit_len_offset + sizeof(required_bit_len)];
+  if (kdf_label.len > 0) {
+    memcpy(message_data + label_offset, kdf_label.data, kdf_label.len);
+  }
+  message_data[context_offset - 1] = 0x00;
+  if (kdf_context.len > 0) {
+    memcpy(message_data + context_offset, kdf_context.data, kdf_context.len);
+  }
+  memcpy(message_data + bit_len_offset, &required_bit_len,
+         sizeof(required_bit_len));
+  otcrypto_const_byte_buf_t message = {
+      .data = message_data,
+      .len = sizeof(message_data),
+  };
+
+  // Key HMAC once, and start each iteration from a copy of the keyed context.
+  otcrypto_hmac_context_t keyed_ctx;
+  HARDENED_TRY(otcrypto_hmac_init(&keyed_ctx, &key_derivation_key));
 
   uint32_t keying_material_len =
       required_word_len + digest_word_len - required_word_len % digest_word_len;
   uint32_t keying_material_data[keying_material_len];
 
   for (uint32_t i = 0; i < num_iterations; i++) {
-    otcrypto_hmac_context_t ctx;
-    HARDENED_TRY(otcrypto_hmac_init(&ctx, &key_derivation_key));
     uint32_t counter_be = __builtin_bswap32(i + 1);
-    HARDENED_TRY(otcrypto_hmac_update(
-        &ctx, (otcrypto_const_byte_buf_t){
-                  .data = (const unsigned char *const)&counter_be,
-                  .len = sizeof(counter_be)}));
-    HARDENED_TRY(otcrypto_hmac_update(&ctx, kdf_label));
-    HARDENED_TRY(otcrypto_hmac_update(
-        &ctx,
-        (otcrypto_const_byte_buf_t){.data = (const unsigned char *const)&zero,
-                                    .len = sizeof(zero)}));
-    HARDENED_TRY(otcrypto_hmac_update(&ctx, kdf_context));
-    HARDENED_TRY(otcrypto_hmac_update(
-        &ctx, (otcrypto_const_byte_buf_t){
-                  .data = (const unsigned char *const)&required_bit_len,
-                  .len = sizeof(required_bit_len)}));
+    memcpy(message_data, &counter_be, sizeof(counter_be));
+    otcrypto_hmac_context_t ctx = keyed_ctx;
+    HARDENED_TRY(otcrypto_hmac_update(&ctx, message));
     uint32_t *tag_dest = keying_material_data + i * digest_word_len;
     HARDENED_TRY(otcrypto_hmac_final(
         &ctx,
@@ -179,7 +184,7 @@ otcrypto_status_t otcrypto_kdf_hmac_ctr(
   }
 
   // Generate a mask (all-zero for now, since HMAC is unhardened anyway).
-  uint32_t mask[digest_word_len];
+  uint32_t mask[keying_material_len];
   memset(mask, 0, sizeof(mask));
 
   // Construct a blinded key.
@@ -499,30 +504,35 @@ otcrypto_status_t otcrypto_kdf_hkdf_extract(const otcrypto_blinded_key_t ikm,
   return OTCRYPTO_OK;
 }
 
-otcrypto_status_t otcrypto_kdf_hkdf_expand(const otcrypto_blinded_key_t prk,
-                                           otcrypto_const_byte_buf_t info,
-                                           otcrypto_blinded_key_t *okm) {
-  if (okm == NULL || okm->keyblob == NULL || prk.keyblob == NULL) {
+/**
+ * Derive one HKDF output key from an HMAC context keyed with the PRK.
+ *
+ * Checks the output key configuration, then runs the "expand" step of HKDF
+ * (see RFC 5869, section 2.3). Each HMAC invocation starts from a copy of
+ * `keyed_ctx`, so the PRK is only processed once.
+ *
+ * @param keyed_ctx HMAC context initialized with the PRK and no message.
+ * @param digest_words Length of the hash digest in 32-bit words.
+ * @param info Context-specific string (optional).
+ * @param[out] okm Blinded output key material.
+ * @return OK or error.
+ */
+static status_t hkdf_expand_keyed(const otcrypto_hmac_context_t *keyed_ctx,
+                                  size_t digest_words,
+                                  otcrypto_const_byte_buf_t info,
+                                  otcrypto_blinded_key_t *okm) {
+  if (okm == NULL || okm->keyblob == NULL) {
     return OTCRYPTO_BAD_ARGS;
   }
   if (info.data == NULL && info.len != 0) {
     return OTCRYPTO_BAD_ARGS;
   }
 
-  if (launder32(okm->config.security_level) != kOtcryptoKeySecurityLevelLow ||
-      launder32(prk.config.security_level) != kOtcryptoKeySecurityLevelLow) {
+  if (launder32(okm->config.security_level) != kOtcryptoKeySecurityLevelLow) {
     // The underlying HMAC implementation is not currently hardened.
     return OTCRYPTO_NOT_IMPLEMENTED;
   }
 
-  // Infer the digest size.
-  size_t digest_words = 0;
-  HARDENED_TRY(
-      digest_num_words_from_key_mode(prk.config.key_mode, &digest_words));
-
-  // Check the PRK configuration.
-  HARDENED_TRY(hkdf_check_prk(digest_words, &prk));
-
   // Ensure that the derived key is a symmetric key masked with XOR and is not
   // supposed to be hardware-backed.
   HARDENED_TRY(keyblob_ensure_xor_masked(okm->config));
@@ -544,41 +554,40 @@ otcrypto_status_t otcrypto_kdf_hkdf_expand(const otcrypto_blinded_key_t prk,
   }
   HARDENED_CHECK_LE(num_iterations, 255);
 
-  // Create a buffer that holds `info` and a one-byte counter.
-  uint8_t info_and_counter_data[info.len + 1];
-  memcpy(info_and_counter_data, info.data, info.len);
-  info_and_counter_data[info.len] = 0x00;
-  otcrypto_const_byte_buf_t info_and_counter = {
-      .data = info_and_counter_data,
-      .len = sizeof(info_and_counter_data),
-  };
+  // Create a buffer that holds T(i-1), `info` and a one-byte counter, so that
+  // each HMAC invocation takes a single message (see RFC 5869, section 2.3).
+  // The first invocation skips T(0), which is empty.
+  size_t digest_bytelen = digest_words * sizeof(uint32_t);
+  uint8_t message_data[digest_bytelen + info.len + 1];
+  if (info.len > 0) {
+    memcpy(message_data + digest_bytelen, info.data, info.len);
+  }
 
-  // Repeatedly call HMAC to generate the derived key (see RFC 5869, section
-  // 2.3):
-  uint32_t okm_data[okm_wordlen];
-  uint32_t *t_data = okm_data;
-  for (uint8_t i = 0; i < num_iterations; i++) {
-    info_and_counter_data[info.len] = i + 1;
-    otcrypto_hmac_context_t ctx;
-    HARDENED_TRY(otcrypto_hmac_init(&ctx, &prk));
+  // Repeatedly call HMAC to generate the derived key. The buffer holds whole
+  // digests, so the last one may extend past the key length.
+  uint32_t okm_data[num_iterations * digest_words];
+  for (size_t i = 0; i < num_iterations; i++) {
+    size_t message_offset = digest_bytelen;
     if (launder32(i) != 0) {
-      otcrypto_const_byte_buf_t t_bytes = {
-          .data = (unsigned char *)t_data,
-          .len = digest_words * sizeof(uint32_t),
-      };
-      HARDENED_TRY(otcrypto_hmac_update(&ctx, t_bytes));
-      t_data += digest_words;
+      memcpy(message_data, &okm_data[(i - 1) * digest_words], digest_bytelen);
+      message_offset = 0;
     }
-    HARDENED_TRY(otcrypto_hmac_update(&ctx, info_and_counter));
+    message_data[sizeof(message_data) - 1] = (uint8_t)(i + 1);
+    otcrypto_const_byte_buf_t message = {
+        .data = message_data + message_offset,
+        .len = sizeof(message_data) - message_offset,
+    };
+    otcrypto_hmac_context_t ctx = *keyed_ctx;
+    HARDENED_TRY(otcrypto_hmac_update(&ctx, message));
     otcrypto_word32_buf_t t_words = {
-        .data = t_data,
+        .data = &okm_data[i * digest_words],
         .len = digest_words,
     };
     HARDENED_TRY(otcrypto_hmac_final(&ctx, t_words));
   }
 
   // Generate a mask (all-zero for now, since HMAC is unhardened anyway).
-  uint32_t mask[digest_words];
+  uint32_t mask[ARRAYSIZE(okm_data)];
   memset(mask, 0, sizeof(mask));
 
   // Construct a blinded key.
@@ -587,3 +596,66 @@ otcrypto_status_t otcrypto_kdf_hkdf_expand(const otcrypto_blinded_key_t prk,
   okm->checksum = integrity_blinded_checksum(okm);
   return OTCRYPTO_OK;
 }
+
+/**
+ * Check an HKDF pseudo-random key and key HMAC with it.
+ *
+ * @param prk Pseudo-random key from HKDF-extract.
+ * @param[out] digest_words Length of the hash digest in 32-bit words.
+ * @param[out] keyed_ctx HMAC context initialized with the PRK.
+ * @return OK or error.
+ */
+static status_t hkdf_expand_init(const otcrypto_blinded_key_t *prk,
+                                 size_t *digest_words,
+                                 otcrypto_hmac_context_t *keyed_ctx) {
+  if (prk->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  if (launder32(prk->config.security_level) != kOtcryptoKeySecurityLevelLow) {
+    // The underlying HMAC implementation is not currently hardened.
+    return OTCRYPTO_NOT_IMPLEMENTED;
+  }
+
+  // Infer the digest size.
+  HARDENED_TRY(
+      digest_num_words_from_key_mode(prk->config.key_mode, digest_words));
+
+  // Check the PRK configuration.
+  HARDENED_TRY(hkdf_check_prk(*digest_words, prk));
+
+  return otcrypto_hmac_init(keyed_ctx, prk);
+}
+
+otcrypto_status_t otcrypto_kdf_hkdf_expand(const otcrypto_blinded_key_t prk,
+                                           otcrypto_const_byte_buf_t info,
+                                           otcrypto_blinded_key_t *okm) {
+  if (okm == NULL || okm->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  size_t digest_words = 0;
+  otcrypto_hmac_context_t keyed_ctx;
+  HARDENED_TRY(hkdf_expand_init(&prk, &digest_words, &keyed_ctx));
+  return hkdf_expand_keyed(&keyed_ctx, digest_words, info, okm);
+}
+
+otcrypto_status_t otcrypto_kdf_hkdf_expand_batch(
+    const otcrypto_blinded_key_t prk, const otcrypto_const_byte_buf_t *infos,
+    size_t count, otcrypto_blinded_key_t *okms) {
+  if (count != 0 && (infos == NULL || okms == NULL)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  size_t digest_words = 0;
+  otcrypto_hmac_context_t keyed_ctx;
+  HARDENED_TRY(hkdf_expand_init(&prk, &digest_words, &keyed_ctx));
+
+  size_t i = 0;
+  for (; launder32(i) < count; i++) {
+    HARDENED_TRY(
+        hkdf_expand_keyed(&keyed_ctx, digest_words, infos[i], &okms[i]));
+  }
+  HARDENED_CHECK_EQ(i, count);
+  return OTCRYPTO_OK;
+}
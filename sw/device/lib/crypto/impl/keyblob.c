@@ -184,16 +184,17 @@ status_t keyblob_from_key_and_mask(const uint32_t *key, const uint32_t *mask,
   // Check that the key is masked with XOR.
   HARDENED_TRY(keyblob_ensure_xor_masked(config));
 
-  // share0 = key ^ mask, share1 = mask
+  // Write the shares straight into the keyblob; share0 = key ^ mask and
+  // share1 = mask. Only masked values are ever stored.
   size_t key_words = keyblob_share_num_words(config);
-  uint32_t share0[key_words];
+  uint32_t *share0 = keyblob;
+  uint32_t *share1 = &keyblob[key_words];
   size_t i = 0;
   for (; launder32(i) < key_words; i++) {
     share0[i] = key[i] ^ mask[i];
+    share1[i] = mask[i];
   }
   HARDENED_CHECK_EQ(i, key_words);
-
-  keyblob_from_shares(share0, mask, config, keyblob);
   return OTCRYPTO_OK;
 }
 
@@ -205,14 +206,16 @@ status_t keyblob_remask(otcrypto_blinded_key_t *key, const uint32_t *mask) {
   HARDENED_TRY(check_keyblob_length(key));
 
   size_t key_share_words = keyblob_share_num_words(key->config);
-  size_t keyblob_words = keyblob_num_words(key->config);
+  uint32_t *share0 = key->keyblob;
+  uint32_t *share1 = &key->keyblob[key_share_words];
 
-  // Construct a new keyblob by re-masking.
+  // Re-mask both shares in place in a single pass.
   size_t i = 0;
-  for (; launder32(i) < keyblob_words; i++) {
-    key->keyblob[i] ^= mask[i % key_share_words];
+  for (; launder32(i) < key_share_words; i++) {
+    share0[i] ^= mask[i];
+    share1[i] ^= mask[i];
   }
-  HARDENED_CHECK_EQ(i, keyblob_words);
+  HARDENED_CHECK_EQ(i, key_share_words);
 
   // Update the key checksum.
   key->checksum = integrity_blinded_checksum(key);
@@ -232,8 +235,10 @@ status_t keyblob_key_unmask(const otcrypto_blinded_key_t *key,
   uint32_t *share1;
   HARDENED_TRY(keyblob_to_shares(key, &share0, &share1));
 
-  for (size_t i = 0; i < unmasked_key_len; i++) {
+  size_t i = 0;
+  for (; launder32(i) < unmasked_key_len; i++) {
     unmasked_key[i] = share0[i] ^ share1[i];
   }
+  HARDENED_CHECK_EQ(i, unmasked_key_len);
   return OTCRYPTO_OK;
 }
@@ -139,6 +139,9 @@ status_t keyblob_ensure_xor_masked(const otcrypto_key_config_t config);
  * keys are likely to be masked with arithmetic rather than boolean (XOR)
  * schemes, and this function cannot be used for them.
  *
+ * The shares are written directly into `keyblob`, so `keyblob` must not
+ * overlap `key` or `mask`.
+ *
  * @param key Plaintext key.
  * @param mask Blinding value.
  * @param config Key configuration.
@@ -175,6 +178,11 @@ status_t keyblob_remask(otcrypto_blinded_key_t *key, const uint32_t *mask);
  * by `key->config`. `unmasked_key_len` is the length of the unmasked key in
  * words.
  *
+ * The shares are combined word by word straight into `unmasked_key`, so
+ * callers should pass the buffer that the driver consumes (e.g. the first
+ * words of a padded HMAC key block) rather than unmasking into a temporary
+ * buffer and copying it.
+ *
  * @param key The input blinded key.
  * @param unmasked_key_len The length of `unmasked_key` in words.
  * @param[out] unmasked_key The computed unmasked key.
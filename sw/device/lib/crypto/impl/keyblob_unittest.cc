@@ -394,5 +394,47 @@ TEST(Keyblob, RemaskWithZero) {
   }
 }
 
+TEST(Keyblob, UnmaskOddBytes) {
+  std::array<uint32_t, 8> test_key = {0x01234567, 0x89abcdef, 0x00010203,
+                                      0x04050607, 0x08090a0b, 0x0c0d0e0f,
+                                      0x10111213, 0x00151617};
+  std::array<uint32_t, 8> test_mask = {0x18191a1b, 0x1c1d1e1f, 0x20212223,
+                                       0x24252627, 0x28292a2b, 0x2c2d2e2f,
+                                       0x30313233, 0x34353637};
+
+  // Test assumption; key and mask are the correct size.
+  ASSERT_EQ(test_key.size(), keyblob_share_num_words(kConfigOddBytes));
+  ASSERT_EQ(test_mask.size(), keyblob_share_num_words(kConfigOddBytes));
+
+  // Convert key/mask to keyblob array.
+  size_t keyblob_words = keyblob_num_words(kConfigOddBytes);
+  uint32_t keyblob[keyblob_words] = {0};
+  EXPECT_OK(keyblob_from_key_and_mask(test_key.data(), test_mask.data(),
+                                      kConfigOddBytes, keyblob));
+
+  // Construct blinded key.
+  otcrypto_blinded_key_t key = {
+      .config = kConfigOddBytes,
+      .keyblob_length = sizeof(keyblob),
+      .keyblob = keyblob,
+      .checksum = 0,
+  };
+
+  // Unmask into a larger buffer, as a driver with a padded key block would,
+  // and check that only the key words are written.
+  std::array<uint32_t, 10> unmasked_key;
+  unmasked_key.fill(0xffffffff);
+  EXPECT_OK(keyblob_key_unmask(&key, test_key.size(), unmasked_key.data()));
+  for (size_t i = 0; i < test_key.size(); i++) {
+    EXPECT_EQ(unmasked_key[i], test_key[i]);
+  }
+  EXPECT_EQ(unmasked_key[8], 0xffffffff);
+  EXPECT_EQ(unmasked_key[9], 0xffffffff);
+
+  // A length that does not match the key configuration is rejected.
+  EXPECT_NOT_OK(
+      keyblob_key_unmask(&key, test_key.size() - 1, unmasked_key.data()));
+}
+
 }  // namespace
 }  // namespace keyblob_unittest
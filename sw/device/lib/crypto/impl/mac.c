@@ -137,8 +137,6 @@ static status_t hmac_key_process(const otcrypto_blinded_key_t *key,
 
   // HMAC HWIP does not support masking, so we need to unmask the key.
   size_t unmasked_key_len = keyblob_share_num_words(key->config);
-  uint32_t unmasked_key[unmasked_key_len];
-  HARDENED_TRY(keyblob_key_unmask(key, unmasked_key_len, unmasked_key));
 
   // Pre-populate with 0s, in order to pad keys smaller than the internal
   // block size, according to FIPS 198-1, Section 4.
@@ -146,6 +144,8 @@ static status_t hmac_key_process(const otcrypto_blinded_key_t *key,
   // If the key is larger than the internal block size, we need to hash it
   // according to FIPS 198-1, Section 4, Step 2.
   if (key->config.key_length > block_size * sizeof(uint32_t)) {
+    uint32_t unmasked_key[unmasked_key_len];
+    HARDENED_TRY(keyblob_key_unmask(key, unmasked_key_len, unmasked_key));
     otcrypto_hash_digest_t key_digest = {
         .mode = hash_mode,
         .data = processed_key,
@@ -157,7 +157,8 @@ static status_t hmac_key_process(const otcrypto_blinded_key_t *key,
     };
     HARDENED_TRY(otcrypto_hash(msg_buf, key_digest));
   } else {
-    hardened_memcpy(processed_key, unmasked_key, unmasked_key_len);
+    // The key fits in one block, so unmask it directly into place.
+    HARDENED_TRY(keyblob_key_unmask(key, unmasked_key_len, processed_key));
     // If the key size isn't a multiple of the word size, zero the last few
     // bytes.
     size_t offset = key->config.key_length % sizeof(uint32_t);
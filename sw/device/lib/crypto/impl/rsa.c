@@ -6,6 +6,7 @@
 
 #include "sw/device/lib/base/hardened_memory.h"
 #include "sw/device/lib/crypto/drivers/entropy.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
 #include "sw/device/lib/crypto/impl/integrity.h"
 #include "sw/device/lib/crypto/impl/rsa/rsa_encryption.h"
 #include "sw/device/lib/crypto/impl/rsa/rsa_keygen.h"
@@ -42,6 +43,7 @@ otcrypto_status_t otcrypto_rsa_keygen(otcrypto_rsa_size_t size,
                                       otcrypto_unblinded_key_t *public_key,
                                       otcrypto_blinded_key_t *private_key) {
   HARDENED_TRY(otcrypto_rsa_keygen_async_start(size));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_rsa_keygen_async_finalize(public_key, private_key);
 }
 
@@ -256,6 +258,7 @@ otcrypto_status_t otcrypto_rsa_keypair_from_cofactor(
     otcrypto_unblinded_key_t *public_key, otcrypto_blinded_key_t *private_key) {
   HARDENED_TRY(otcrypto_rsa_keypair_from_cofactor_async_start(
       size, modulus, e, cofactor_share0, cofactor_share1));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   HARDENED_TRY(otcrypto_rsa_keypair_from_cofactor_async_finalize(public_key,
                                                                  private_key));
 
@@ -295,6 +298,7 @@ otcrypto_status_t otcrypto_rsa_sign(const otcrypto_blinded_key_t *private_key,
                                     otcrypto_word32_buf_t signature) {
   HARDENED_TRY(
       otcrypto_rsa_sign_async_start(private_key, message_digest, padding_mode));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_rsa_sign_async_finalize(signature);
 }
 
@@ -304,6 +308,7 @@ otcrypto_status_t otcrypto_rsa_verify(
     otcrypto_rsa_padding_t padding_mode, otcrypto_const_word32_buf_t signature,
     hardened_bool_t *verification_result) {
   HARDENED_TRY(otcrypto_rsa_verify_async_start(public_key, signature));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_rsa_verify_async_finalize(message_digest, padding_mode,
                                             verification_result);
 }
@@ -314,6 +319,7 @@ otcrypto_status_t otcrypto_rsa_encrypt(
     otcrypto_const_byte_buf_t label, otcrypto_word32_buf_t ciphertext) {
   HARDENED_TRY(
       otcrypto_rsa_encrypt_async_start(public_key, hash_mode, message, label));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_rsa_encrypt_async_finalize(ciphertext);
 }
 
@@ -323,6 +329,7 @@ otcrypto_status_t otcrypto_rsa_decrypt(
     otcrypto_const_word32_buf_t ciphertext, otcrypto_const_byte_buf_t label,
     otcrypto_byte_buf_t plaintext, size_t *plaintext_bytelen) {
   HARDENED_TRY(otcrypto_rsa_decrypt_async_start(private_key, ciphertext));
+  HARDENED_TRY(otbn_busy_wait_for_done());
   return otcrypto_rsa_decrypt_async_finalize(hash_mode, label, plaintext,
                                              plaintext_bytelen);
 }
@@ -437,6 +444,9 @@ otcrypto_status_t otcrypto_rsa_keygen_async_finalize(
       private_key->keyblob == NULL) {
     return OTCRYPTO_BAD_ARGS;
   }
+
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
   // Infer the RSA size from the public key modulus.
   otcrypto_rsa_size_t size;
   HARDENED_TRY(rsa_size_from_public_key(public_key, &size));
@@ -540,6 +550,9 @@ otcrypto_status_t otcrypto_rsa_keypair_from_cofactor_async_finalize(
       private_key->keyblob == NULL) {
     return OTCRYPTO_BAD_ARGS;
   }
+
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
   // Infer the RSA size from the public key modulus.
   otcrypto_rsa_size_t size;
   HARDENED_TRY(rsa_size_from_public_key(public_key, &size));
@@ -675,6 +688,9 @@ otcrypto_status_t otcrypto_rsa_sign_async_finalize(
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
+
   // Determine the size based on the signature buffer length.
   switch (signature.len) {
     case kRsa2048NumWords:
@@ -759,6 +775,9 @@ otcrypto_status_t otcrypto_rsa_verify_async_finalize(
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
+
   // Initialize verification result to false by default.
   *verification_result = kHardenedBoolFalse;
 
@@ -844,6 +863,9 @@ otcrypto_status_t otcrypto_rsa_encrypt_async_finalize(
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
+
   switch (launder32(ciphertext.len)) {
     case kRsa2048NumWords: {
       HARDENED_CHECK_EQ(ciphertext.len * sizeof(uint32_t),
@@ -957,6 +979,9 @@ otcrypto_status_t otcrypto_rsa_decrypt_async_finalize(
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Return without blocking if OTBN is still running.
+  HARDENED_TRY(otbn_done_check());
+
   // Call the unified `finalize()` operation, which will infer the RSA size
   // from OTBN.
   HARDENED_TRY(rsa_decrypt_finalize(hash_mode, label.data, label.len,
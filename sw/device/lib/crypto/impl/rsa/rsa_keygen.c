@@ -98,8 +98,8 @@ static status_t keygen_finalize(uint32_t exp_mode, size_t num_words,
   // Read the private exponent (d) from OTBN dmem.
   HARDENED_TRY(otbn_dmem_read(num_words, kOtbnVarRsaD, d));
 
-  // Wipe DMEM.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  HARDENED_TRY(otbn_dmem_sec_wipe_start());
 
   return OTCRYPTO_OK;
 }
@@ -18,6 +18,11 @@ OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, mode);   // Application mode.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, n);      // Public modulus n.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, d);      // Private exponent d.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, inout);  // Input/output buffer.
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, dp);     // CRT exponent dp.
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, dq);     // CRT exponent dq.
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, crt_p);  // Prime factor p.
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, crt_q);  // Prime factor q.
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, crt_qinv);  // CRT coefficient.
 
 static const otbn_addr_t kOtbnVarRsaMode =
     OTBN_ADDR_T_INIT(run_rsa_modexp, mode);
@@ -25,6 +30,14 @@ static const otbn_addr_t kOtbnVarRsaN = OTBN_ADDR_T_INIT(run_rsa_modexp, n);
 static const otbn_addr_t kOtbnVarRsaD = OTBN_ADDR_T_INIT(run_rsa_modexp, d);
 static const otbn_addr_t kOtbnVarRsaInOut =
     OTBN_ADDR_T_INIT(run_rsa_modexp, inout);
+static const otbn_addr_t kOtbnVarRsaDp = OTBN_ADDR_T_INIT(run_rsa_modexp, dp);
+static const otbn_addr_t kOtbnVarRsaDq = OTBN_ADDR_T_INIT(run_rsa_modexp, dq);
+static const otbn_addr_t kOtbnVarRsaP =
+    OTBN_ADDR_T_INIT(run_rsa_modexp, crt_p);
+static const otbn_addr_t kOtbnVarRsaQ =
+    OTBN_ADDR_T_INIT(run_rsa_modexp, crt_q);
+static const otbn_addr_t kOtbnVarRsaQinv =
+    OTBN_ADDR_T_INIT(run_rsa_modexp, crt_qinv);
 
 // Declare mode constants.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_2048_MODEXP);
@@ -33,6 +46,9 @@ OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_3072_MODEXP);
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_3072_MODEXP_F4);
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_4096_MODEXP);
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_4096_MODEXP_F4);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_2048_MODEXP_CRT);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_3072_MODEXP_CRT);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_4096_MODEXP_CRT);
 static const uint32_t kMode2048Modexp =
     OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_2048_MODEXP);
 static const uint32_t kMode2048ModexpF4 =
@@ -45,6 +61,12 @@ static const uint32_t kMode4096Modexp =
     OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_4096_MODEXP);
 static const uint32_t kMode4096ModexpF4 =
     OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_4096_MODEXP_F4);
+static const uint32_t kMode2048ModexpCrt =
+    OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_2048_MODEXP_CRT);
+static const uint32_t kMode3072ModexpCrt =
+    OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_3072_MODEXP_CRT);
+static const uint32_t kMode4096ModexpCrt =
+    OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_4096_MODEXP_CRT);
 
 enum {
   /**
@@ -65,11 +87,14 @@ status_t rsa_modexp_wait(size_t *num_words) {
   HARDENED_TRY(otbn_dmem_read(1, kOtbnVarRsaMode, &mode));
 
   *num_words = 0;
-  if (mode == kMode2048Modexp || mode == kMode2048ModexpF4) {
+  if (mode == kMode2048Modexp || mode == kMode2048ModexpF4 ||
+      mode == kMode2048ModexpCrt) {
     *num_words = kRsa2048NumWords;
-  } else if (mode == kMode3072Modexp || mode == kMode3072ModexpF4) {
+  } else if (mode == kMode3072Modexp || mode == kMode3072ModexpF4 ||
+             mode == kMode3072ModexpCrt) {
     *num_words = kRsa3072NumWords;
-  } else if (mode == kMode4096Modexp || mode == kMode4096ModexpF4) {
+  } else if (mode == kMode4096Modexp || mode == kMode4096ModexpF4 ||
+             mode == kMode4096ModexpCrt) {
     *num_words = kRsa4096NumWords;
   } else {
     // Unrecognized mode.
@@ -102,8 +127,58 @@ static status_t rsa_modexp_finalize(const size_t num_words, uint32_t *result) {
   // Read the result.
   HARDENED_TRY(otbn_dmem_read(num_words, kOtbnVarRsaInOut, result));
 
-  // Wipe DMEM.
-  return otbn_dmem_sec_wipe();
+  // Start wiping DMEM; the next user of OTBN waits for it to finish.
+  return otbn_dmem_sec_wipe_start();
+}
+
+/**
+ * Starts a modular exponentiation with a private key in CRT form.
+ *
+ * The base and modulus have `num_words` words; all CRT components have
+ * `num_words / 2` words.
+ *
+ * @param mode OTBN application mode.
+ * @param num_words Number of words for the modulus.
+ * @param base Exponentiation base.
+ * @param n Modulus.
+ * @param p First prime factor of n.
+ * @param q Second prime factor of n.
+ * @param dp CRT exponent d mod (p-1).
+ * @param dq CRT exponent d mod (q-1).
+ * @param qinv CRT coefficient q^-1 mod p.
+ * @return Status of the operation (OK or error).
+ */
+static status_t rsa_modexp_crt_start(const uint32_t mode,
+                                     const size_t num_words,
+                                     const uint32_t *base, const uint32_t *n,
+                                     const uint32_t *p, const uint32_t *q,
+                                     const uint32_t *dp, const uint32_t *dq,
+                                     const uint32_t *qinv) {
+  // The OTBN routine relies on both primes being exactly half the size of the
+  // modulus.
+  size_t num_cofactor_words = num_words / 2;
+  if (p[num_cofactor_words - 1] >> 31 != 1 ||
+      q[num_cofactor_words - 1] >> 31 != 1) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Load the OTBN app. Fails if OTBN is not idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppRsaModexp));
+
+  // Set mode.
+  HARDENED_TRY(otbn_dmem_write(1, &mode, kOtbnVarRsaMode));
+
+  // Set the base, the modulus n and the CRT components.
+  HARDENED_TRY(otbn_dmem_write(num_words, base, kOtbnVarRsaInOut));
+  HARDENED_TRY(otbn_dmem_write(num_words, n, kOtbnVarRsaN));
+  HARDENED_TRY(otbn_dmem_write(num_cofactor_words, p, kOtbnVarRsaP));
+  HARDENED_TRY(otbn_dmem_write(num_cofactor_words, q, kOtbnVarRsaQ));
+  HARDENED_TRY(otbn_dmem_write(num_cofactor_words, dp, kOtbnVarRsaDp));
+  HARDENED_TRY(otbn_dmem_write(num_cofactor_words, dq, kOtbnVarRsaDq));
+  HARDENED_TRY(otbn_dmem_write(num_cofactor_words, qinv, kOtbnVarRsaQinv));
+
+  // Start OTBN.
+  return otbn_execute();
 }
 
 status_t rsa_modexp_consttime_2048_start(const rsa_2048_int_t *base,
@@ -152,6 +227,14 @@ status_t rsa_modexp_vartime_2048_start(const rsa_2048_int_t *base,
   return otbn_execute();
 }
 
+status_t rsa_modexp_crt_2048_start(
+    const rsa_2048_int_t *base, const rsa_2048_crt_private_key_t *key) {
+  return rsa_modexp_crt_start(kMode2048ModexpCrt, kRsa2048NumWords,
+                              base->data, key->n.data, key->p.data,
+                              key->q.data, key->dp.data, key->dq.data,
+                              key->qinv.data);
+}
+
 status_t rsa_modexp_2048_finalize(rsa_2048_int_t *result) {
   return rsa_modexp_finalize(kRsa2048NumWords, result->data);
 }
@@ -202,6 +285,14 @@ status_t rsa_modexp_vartime_3072_start(const rsa_3072_int_t *base,
   return otbn_execute();
 }
 
+status_t rsa_modexp_crt_3072_start(
+    const rsa_3072_int_t *base, const rsa_3072_crt_private_key_t *key) {
+  return rsa_modexp_crt_start(kMode3072ModexpCrt, kRsa3072NumWords,
+                              base->data, key->n.data, key->p.data,
+                              key->q.data, key->dp.data, key->dq.data,
+                              key->qinv.data);
+}
+
 status_t rsa_modexp_3072_finalize(rsa_3072_int_t *result) {
   return rsa_modexp_finalize(kRsa3072NumWords, result->data);
 }
@@ -252,6 +343,14 @@ status_t rsa_modexp_vartime_4096_start(const rsa_4096_int_t *base,
   return otbn_execute();
 }
 
+status_t rsa_modexp_crt_4096_start(
+    const rsa_4096_int_t *base, const rsa_4096_crt_private_key_t *key) {
+  return rsa_modexp_crt_start(kMode4096ModexpCrt, kRsa4096NumWords,
+                              base->data, key->n.data, key->p.data,
+                              key->q.data, key->dp.data, key->dq.data,
+                              key->qinv.data);
+}
+
 status_t rsa_modexp_4096_finalize(rsa_4096_int_t *result) {
   return rsa_modexp_finalize(kRsa4096NumWords, result->data);
 }
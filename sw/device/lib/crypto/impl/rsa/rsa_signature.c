@@ -159,6 +159,20 @@ status_t rsa_signature_generate_2048_start(
                                          &private_key->n);
 }
 
+status_t rsa_signature_generate_crt_2048_start(
+    const rsa_2048_crt_private_key_t *private_key,
+    const otcrypto_hash_digest_t message_digest,
+    const rsa_signature_padding_t padding_mode) {
+  // Encode the message.
+  rsa_2048_int_t encoded_message;
+  HARDENED_TRY(message_encode(message_digest, padding_mode,
+                              ARRAYSIZE(encoded_message.data),
+                              encoded_message.data));
+
+  // Start computing (encoded_message ^ d) mod n from the CRT components.
+  return rsa_modexp_crt_2048_start(&encoded_message, private_key);
+}
+
 status_t rsa_signature_generate_2048_finalize(rsa_2048_int_t *signature) {
   return rsa_modexp_2048_finalize(signature);
 }
@@ -227,6 +241,20 @@ status_t rsa_signature_generate_3072_start(
                                          &private_key->n);
 }
 
+status_t rsa_signature_generate_crt_3072_start(
+    const rsa_3072_crt_private_key_t *private_key,
+    const otcrypto_hash_digest_t message_digest,
+    const rsa_signature_padding_t padding_mode) {
+  // Encode the message.
+  rsa_3072_int_t encoded_message;
+  HARDENED_TRY(message_encode(message_digest, padding_mode,
+                              ARRAYSIZE(encoded_message.data),
+                              encoded_message.data));
+
+  // Start computing (encoded_message ^ d) mod n from the CRT components.
+  return rsa_modexp_crt_3072_start(&encoded_message, private_key);
+}
+
 status_t rsa_signature_generate_3072_finalize(rsa_3072_int_t *signature) {
   return rsa_modexp_3072_finalize(signature);
 }
@@ -253,6 +281,20 @@ status_t rsa_signature_generate_4096_start(
                                          &private_key->n);
 }
 
+status_t rsa_signature_generate_crt_4096_start(
+    const rsa_4096_crt_private_key_t *private_key,
+    const otcrypto_hash_digest_t message_digest,
+    const rsa_signature_padding_t padding_mode) {
+  // Encode the message.
+  rsa_4096_int_t encoded_message;
+  HARDENED_TRY(message_encode(message_digest, padding_mode,
+                              ARRAYSIZE(encoded_message.data),
+                              encoded_message.data));
+
+  // Start computing (encoded_message ^ d) mod n from the CRT components.
+  return rsa_modexp_crt_4096_start(&encoded_message, private_key);
+}
+
 status_t rsa_signature_generate_4096_finalize(rsa_4096_int_t *signature) {
   return rsa_modexp_4096_finalize(signature);
 }
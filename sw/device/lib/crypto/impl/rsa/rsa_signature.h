@@ -58,10 +58,31 @@ status_t rsa_signature_generate_2048_start(
     const otcrypto_hash_digest_t message_digest,
     const rsa_signature_padding_t padding_mode);
 
+/**
+ * Starts generating an RSA-2048 signature from a CRT-form key.
+ *
+ * Same as `rsa_signature_generate_2048_start`, but uses the faster CRT
+ * exponentiation; the result is verified against the public exponent before
+ * it is released. The key exponent must be F4=65537.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @param private_key RSA private key in CRT form.
+ * @param message_digest Message digest to sign.
+ * @param padding_mode Signature padding mode.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t rsa_signature_generate_crt_2048_start(
+    const rsa_2048_crt_private_key_t *private_key,
+    const otcrypto_hash_digest_t message_digest,
+    const rsa_signature_padding_t padding_mode);
+
 /**
  * Waits for an RSA-2048 signature generation to complete.
  *
- * Should be invoked only after `rsa_2048_sign_start`. Blocks until OTBN is
+ * Should be invoked only after `rsa_2048_sign_start` or
+ * `rsa_signature_generate_crt_2048_start`. Blocks until OTBN is
  * done processing.
  *
  * @param[out] signature Generated signature.
@@ -124,10 +145,31 @@ status_t rsa_signature_generate_3072_start(
     const otcrypto_hash_digest_t message_digest,
     const rsa_signature_padding_t padding_mode);
 
+/**
+ * Starts generating an RSA-3072 signature from a CRT-form key.
+ *
+ * Same as `rsa_signature_generate_3072_start`, but uses the faster CRT
+ * exponentiation; the result is verified against the public exponent before
+ * it is released. The key exponent must be F4=65537.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @param private_key RSA private key in CRT form.
+ * @param message_digest Message digest to sign.
+ * @param padding_mode Signature padding mode.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t rsa_signature_generate_crt_3072_start(
+    const rsa_3072_crt_private_key_t *private_key,
+    const otcrypto_hash_digest_t message_digest,
+    const rsa_signature_padding_t padding_mode);
+
 /**
  * Waits for an RSA-3072 signature generation to complete.
  *
- * Should be invoked only after `rsa_3072_sign_start`. Blocks until OTBN is
+ * Should be invoked only after `rsa_3072_sign_start` or
+ * `rsa_signature_generate_crt_3072_start`. Blocks until OTBN is
  * done processing.
  *
  * @param[out] signature Generated signature.
@@ -167,10 +209,31 @@ status_t rsa_signature_generate_4096_start(
     const otcrypto_hash_digest_t message_digest,
     const rsa_signature_padding_t padding_mode);
 
+/**
+ * Starts generating an RSA-4096 signature from a CRT-form key.
+ *
+ * Same as `rsa_signature_generate_4096_start`, but uses the faster CRT
+ * exponentiation; the result is verified against the public exponent before
+ * it is released. The key exponent must be F4=65537.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @param private_key RSA private key in CRT form.
+ * @param message_digest Message digest to sign.
+ * @param padding_mode Signature padding mode.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t rsa_signature_generate_crt_4096_start(
+    const rsa_4096_crt_private_key_t *private_key,
+    const otcrypto_hash_digest_t message_digest,
+    const rsa_signature_padding_t padding_mode);
+
 /**
  * Waits for an RSA-4096 signature generation to complete.
  *
- * Should be invoked only after `rsa_4096_sign_start`. Blocks until OTBN is
+ * Should be invoked only after `rsa_4096_sign_start` or
+ * `rsa_signature_generate_crt_4096_start`. Blocks until OTBN is
  * done processing.
  *
  * @param[out] signature Generated signature.
@@ -184,8 +184,9 @@ static status_t process_padding(sha256_otbn_ctx_t *ctx,
 static status_t process_message(sha256_state_t *state, const uint8_t *msg,
                                 size_t msg_len,
                                 hardened_bool_t padding_needed) {
-  // Load the SHA-256 app. Fails if OTBN is non-idle.
-  HARDENED_TRY(otbn_load_app(kOtbnAppSha256));
+  // Load the SHA-256 app, unless DMEM is still set up from the previous
+  // update. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_resume_app(kOtbnAppSha256));
 
   // Check the message length. SHA-256 messages must be less than 2^64 bits
   // long in total.
@@ -200,11 +201,10 @@ static status_t process_message(sha256_state_t *state, const uint8_t *msg,
   sha256_state_t new_state;
   new_state.total_len = state->total_len + msg_bits;
 
-  // Set the initial state if at least one block has been received before now.
-  if (state->total_len >= kSha256MessageBlockBytes) {
-    HARDENED_TRY(
-        otbn_dmem_write(kSha256StateWords, state->H, kOtbnVarSha256State));
-  }
+  // Set the initial state. This is needed even before the first block, since
+  // DMEM may hold the state of another hash computation.
+  HARDENED_TRY(
+      otbn_dmem_write(kSha256StateWords, state->H, kOtbnVarSha256State));
 
   // Start computing the first block for the hash computation by simply copying
   // the partial block. We won't use the partial block directly to avoid
@@ -247,8 +247,11 @@ static status_t process_message(sha256_state_t *state, const uint8_t *msg,
   HARDENED_TRY(
       otbn_dmem_read(kSha256StateWords, kOtbnVarSha256State, new_state.H));
 
-  // Clear OTBN's memory.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Clear OTBN's memory once the message is complete. Until then, DMEM is
+  // left set up for the next update; loading any other app wipes it.
+  if (padding_needed == kHardenedBoolTrue) {
+    HARDENED_TRY(otbn_dmem_sec_wipe_start());
+  }
 
   // At this point, no more errors are possible; it is safe to update the
   // context object.
@@ -112,6 +112,10 @@ void sha256_init(sha256_state_t *state);
  *
  * Incorporates the new message data into the hash context.
  *
+ * OTBN's DMEM is not wiped after an update, so that the next update can
+ * skip reloading the OTBN app; the message data left in it is wiped by the
+ * final call, or when any other OTBN app is loaded.
+ *
  * Returns OTCRYPTO_ASYNC_INCOMPLETE if OTBN is busy.
  *
  * @param state Hash context object; updated in-place.
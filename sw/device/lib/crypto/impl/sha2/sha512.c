@@ -245,8 +245,9 @@ static status_t process_padding(sha512_otbn_ctx_t *ctx,
 static status_t process_message(sha512_state_t *state, const uint8_t *msg,
                                 size_t msg_len,
                                 hardened_bool_t padding_needed) {
-  // Load the SHA-512 app. Fails if OTBN is non-idle.
-  HARDENED_TRY(otbn_load_app(kOtbnAppSha512));
+  // Load the SHA-512 app, unless DMEM is still set up from the previous
+  // update. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_resume_app(kOtbnAppSha512));
 
   // Calculate the new value of state->total_len. Do NOT update the state yet
   // (because if we get an OTBN error, it would become out of sync).
@@ -312,8 +313,11 @@ static status_t process_message(sha512_state_t *state, const uint8_t *msg,
     state_read_addr += kOtbnWideWordNumBytes;
   }
 
-  // Clear OTBN's memory.
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  // Clear OTBN's memory once the message is complete. Until then, DMEM is
+  // left set up for the next update; loading any other app wipes it.
+  if (padding_needed == kHardenedBoolTrue) {
+    HARDENED_TRY(otbn_dmem_sec_wipe_start());
+  }
 
   // At this point, no more errors are possible; it is safe to update the
   // context object.
@@ -90,6 +90,10 @@ otcrypto_status_t otcrypto_drbg_manual_reseed(
  * multiple of 4, some output from the hardware will be discarded. This detail
  * may be important for known-answer tests.
  *
+ * Requests with empty additional input are served from a pool of output
+ * buffered by an earlier generate command. Instantiate, reseed and
+ * uninstantiate operations clear the pool.
+ *
  * @param additional_input Pointer to the additional data.
  * @param[out] drbg_output Pointer to the generated pseudo random bits.
  * @return Result of the DRBG generate operation.
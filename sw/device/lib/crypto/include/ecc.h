@@ -12,6 +12,16 @@
  * @brief Elliptic curve operations for OpenTitan cryptography library.
  *
  * Includes ECDSA, ECDH, Ed25519, and X25519.
+ *
+ * The `_async_start` functions start an operation on OTBN and return without
+ * waiting for it. The matching `_async_finalize` function returns
+ * `OTCRYPTO_ASYNC_INCOMPLETE` without blocking while OTBN is still running, so
+ * the caller can do other work and poll it until it returns something else.
+ * To sleep instead of polling, enable the OTBN `done` interrupt and call the
+ * `_async_finalize` function after it fires. OTBN also raises `done` at the
+ * end of the secure wipes that `_async_finalize` runs, so the interrupt should
+ * be disabled again before finalizing. The blocking functions wait for OTBN
+ * before finalizing.
  */
 
 #ifdef __cplusplus
@@ -165,6 +175,45 @@ otcrypto_status_t otcrypto_ecdsa_verify(
     const otcrypto_ecc_curve_t *elliptic_curve,
     hardened_bool_t *verification_result);
 
+/**
+ * A signature to check with `otcrypto_ecdsa_verify_batch()`.
+ */
+typedef struct otcrypto_ecdsa_verify_item {
+  // Pointer to the unblinded public key (Q) struct.
+  const otcrypto_unblinded_key_t *public_key;
+  // Message digest to be verified (pre-hashed).
+  otcrypto_hash_digest_t message_digest;
+  // Signature to be verified.
+  otcrypto_const_word32_buf_t signature;
+} otcrypto_ecdsa_verify_item_t;
+
+/**
+ * Performs ECDSA digital signature verification of several signatures on the
+ * same curve.
+ *
+ * This is equivalent to calling `otcrypto_ecdsa_verify()` on each item, but
+ * the OTBN application is only loaded in full for the first one; the others
+ * reuse it and only reset DMEM. This makes checking a certificate chain
+ * cheaper than separate calls.
+ *
+ * An item whose signature or public key fails the basic validity checks on
+ * OTBN (for example, a zero `r`) gets a `kHardenedBoolFalse` result, like an
+ * item whose signature doesn't match. Any other error stops the batch and is
+ * returned, leaving the results of the remaining items unspecified.
+ *
+ * @param items Pointer to the signatures to verify.
+ * @param num_items Number of elements in `items`.
+ * @param elliptic_curve Pointer to the elliptic curve to be used.
+ * @param[out] verification_results Result of the verification of each item,
+ * with `num_items` elements (Pass/Fail).
+ * @return Result of the ECDSA verification operations.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_ecdsa_verify_batch(
+    const otcrypto_ecdsa_verify_item_t *items, size_t num_items,
+    const otcrypto_ecc_curve_t *elliptic_curve,
+    hardened_bool_t *verification_results);
+
 /**
  * Performs the key generation for ECDH key agreement.
  *
@@ -69,6 +69,39 @@ typedef struct otcrypto_hash_context {
 otcrypto_status_t otcrypto_hash(otcrypto_const_byte_buf_t input_message,
                                 otcrypto_hash_digest_t digest);
 
+/**
+ * A message to hash with `otcrypto_hash_batch()`.
+ */
+typedef struct otcrypto_hash_batch_item {
+  // Input message to be hashed. Unlike `otcrypto_const_byte_buf_t`, this can
+  // be assigned, so that a table of items can be filled in a loop.
+  const uint8_t *message;
+  // Length of `message` in bytes.
+  size_t message_len;
+  // Output digest, with `mode` and `len` set as for #otcrypto_hash.
+  otcrypto_hash_digest_t digest;
+} otcrypto_hash_batch_item_t;
+
+/**
+ * Hashes several messages with the same fixed-length hash function.
+ *
+ * This is equivalent to calling #otcrypto_hash on each item in turn, but the
+ * hardware is configured once for the whole batch rather than for every
+ * message, which saves most of the cost of hashing short messages (such as
+ * the leaves of a Merkle tree).
+ *
+ * All digests must have the same `mode`. Every item is checked before any is
+ * hashed, so an invalid item fails the batch without hashing anything. If
+ * hashing a message fails, the batch stops and returns the error; the
+ * digests of the remaining items are not written.
+ *
+ * @param items Pointer to the messages to hash.
+ * @param num_items Number of elements in `items`.
+ * @return Result of the hash operations.
+ */
+otcrypto_status_t otcrypto_hash_batch(const otcrypto_hash_batch_item_t *items,
+                                      size_t num_items);
+
 /**
  * Performs the SHAKE extendable output function (XOF) on input data.
  *
@@ -145,6 +178,50 @@ otcrypto_status_t otcrypto_hash_init(otcrypto_hash_context_t *const ctx,
 otcrypto_status_t otcrypto_hash_update(otcrypto_hash_context_t *const ctx,
                                        otcrypto_const_byte_buf_t input_message);
 
+/**
+ * Callback for one update of `otcrypto_hash_update_batch()`.
+ *
+ * @param arg The `done_arg` of the update.
+ */
+typedef void (*otcrypto_hash_update_done_t)(void *arg);
+
+/**
+ * An update to run with `otcrypto_hash_update_batch()`.
+ */
+typedef struct otcrypto_hash_update_item {
+  // Hash context of the stream to update.
+  otcrypto_hash_context_t *ctx;
+  // Input message to be hashed.
+  otcrypto_const_byte_buf_t input_message;
+  // Called once `input_message` has been hashed (may be NULL).
+  otcrypto_hash_update_done_t done;
+  // Argument for `done`.
+  void *done_arg;
+} otcrypto_hash_update_item_t;
+
+/**
+ * Performs the UPDATE operations for several hash streams.
+ *
+ * This is equivalent to calling #otcrypto_hash_update on each item, except
+ * that the updates of different contexts may run in a different order: the
+ * updates of each context run in the order of `items`, but all of them run
+ * before the updates of the next context, and consecutive updates of a
+ * context whose messages are adjacent in memory are merged into one. This
+ * way each context is swapped into the HMAC block only once per call, no
+ * matter how the updates of independent streams are interleaved in `items`.
+ *
+ * The `done` callback of an item runs as soon as its message has been hashed,
+ * before the updates of other contexts. If an update fails, the batch stops
+ * and returns the error; the remaining callbacks are not called, and the
+ * contexts of the remaining items are left as they are.
+ *
+ * @param items Pointer to the updates to run.
+ * @param num_items Number of elements in `items`.
+ * @return Result of the hash update operations.
+ */
+otcrypto_status_t otcrypto_hash_update_batch(
+    const otcrypto_hash_update_item_t *items, size_t num_items);
+
 /**
  * Performs the FINAL operation for a cryptographic hash function.
  *
@@ -183,6 +183,27 @@ otcrypto_status_t otcrypto_kdf_hkdf_expand(const otcrypto_blinded_key_t prk,
                                            otcrypto_const_byte_buf_t info,
                                            otcrypto_blinded_key_t *okm);
 
+/**
+ * Performs the "expand" step of HKDF for several outputs from the same PRK.
+ *
+ * Equivalent to calling `otcrypto_kdf_hkdf_expand` with `prk` for each pair of
+ * `infos[i]` and `okms[i]`, but processes the PRK only once. This is useful
+ * for deriving many labeled keys from one secret, e.g. at boot.
+ *
+ * Each `okms[i]` must be allocated and partially populated as for
+ * `otcrypto_kdf_hkdf_expand`. If an error is returned, the outputs before the
+ * failing one may already have been written.
+ *
+ * @param prk Pseudo-random key from HKDF-extract.
+ * @param infos Context-specific strings (`count` entries, each optional).
+ * @param count Number of keys to derive.
+ * @param[out] okms Blinded output key material (`count` entries).
+ * @return Result of the key derivation operation.
+ */
+otcrypto_status_t otcrypto_kdf_hkdf_expand_batch(
+    const otcrypto_blinded_key_t prk, const otcrypto_const_byte_buf_t *infos,
+    size_t count, otcrypto_blinded_key_t *okms);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -10,6 +10,16 @@
 /**
  * @file
  * @brief RSA signature operations for the OpenTitan cryptography library.
+ *
+ * The `_async_start` functions start an operation on OTBN and return without
+ * waiting for it. The matching `_async_finalize` function returns
+ * `OTCRYPTO_ASYNC_INCOMPLETE` without blocking while OTBN is still running, so
+ * the caller can do other work and poll it until it returns something else.
+ * To sleep instead of polling, enable the OTBN `done` interrupt and call the
+ * `_async_finalize` function after it fires. OTBN also raises `done` at the
+ * end of the secure wipes that `_async_finalize` runs, so the interrupt should
+ * be disabled again before finalizing. The blocking functions wait for OTBN
+ * before finalizing.
  */
 
 #ifdef __cplusplus
@@ -22,12 +22,34 @@ static uint16_t round_up_divide(uint32_t a, uint32_t b) {
   return (uint16_t)result;
 }
 
-static void spin_while_status_bit(const dif_i2c_t *i2c, uint32_t bit,
-                                  bool set) {
-  uint32_t reg = 0;
+/**
+ * Waits until the FMT FIFO has room for at least one entry.
+ *
+ * @return The number of free FMT FIFO entries.
+ */
+static uint32_t wait_fmt_fifo_space(const dif_i2c_t *i2c) {
+  uint32_t level;
+  do {
+    uint32_t reg =
+        mmio_region_read32(i2c->base_addr, I2C_HOST_FIFO_STATUS_REG_OFFSET);
+    level = bitfield_field32_read(reg, I2C_HOST_FIFO_STATUS_FMTLVL_FIELD);
+  } while (level >= I2C_PARAM_FIFO_DEPTH);
+  return I2C_PARAM_FIFO_DEPTH - level;
+}
+
+/**
+ * Waits until the RX FIFO holds at least one byte.
+ *
+ * @return The number of bytes in the RX FIFO.
+ */
+static uint32_t wait_rx_fifo_level(const dif_i2c_t *i2c) {
+  uint32_t level;
   do {
-    reg = mmio_region_read32(i2c->base_addr, I2C_STATUS_REG_OFFSET);
-  } while (bitfield_bit32_read(reg, bit) == set);
+    uint32_t reg =
+        mmio_region_read32(i2c->base_addr, I2C_HOST_FIFO_STATUS_REG_OFFSET);
+    level = bitfield_field32_read(reg, I2C_HOST_FIFO_STATUS_RXLVL_FIELD);
+  } while (level == 0);
+  return level;
 }
 
 /**
@@ -669,8 +691,13 @@ dif_result_t dif_i2c_read_bytes(const dif_i2c_t *i2c, size_t size,
     return kDifBadArg;
   }
 
+  // Only poll the FIFO level once the bytes seen by the last poll are used up.
+  uint32_t level = 0;
   while (size--) {
-    spin_while_status_bit(i2c, I2C_STATUS_RXEMPTY_BIT, /*set*/ true);
+    if (level == 0) {
+      level = wait_rx_fifo_level(i2c);
+    }
+    --level;
     uint32_t values = mmio_region_read32(i2c->base_addr, I2C_RDATA_REG_OFFSET);
     *(buffer++) = (uint8_t)bitfield_field32_read(values, I2C_RDATA_RDATA_FIELD);
   }
@@ -711,11 +738,16 @@ dif_result_t dif_i2c_write_bytes_raw(const dif_i2c_t *i2c, size_t size,
   uint32_t fmt_byte = 0;
   DIF_RETURN_IF_ERROR(parse_flags(flags, &fmt_byte));
 
+  // Only poll the FIFO level once the space seen by the last poll is used up.
+  uint32_t space = 0;
   for (size_t i = 0; i < size; ++i) {
+    if (space == 0) {
+      space = wait_fmt_fifo_space(i2c);
+    }
+    --space;
     uint32_t reg =
         bitfield_field32_write(fmt_byte, I2C_FDATA_FBYTE_FIELD, bytes[i]);
     mmio_region_write32(i2c->base_addr, I2C_FDATA_REG_OFFSET, reg);
-    spin_while_status_bit(i2c, I2C_STATUS_FMTFULL_BIT, /*set*/ true);
   }
 
   return kDifOk;
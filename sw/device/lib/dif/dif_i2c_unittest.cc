@@ -965,6 +965,27 @@ TEST_F(FifoTest, Read) {
   EXPECT_EQ(val, 0xcd);
 }
 
+// Checks that the RX FIFO level is only polled again once the bytes seen by
+// the previous poll have been read.
+TEST_F(FifoTest, ReadBytes) {
+  uint8_t buf[3];
+
+  EXPECT_READ32(I2C_HOST_FIFO_STATUS_REG_OFFSET,
+                {{I2C_HOST_FIFO_STATUS_RXLVL_OFFSET, 2}});
+  EXPECT_READ32(I2C_RDATA_REG_OFFSET, 0xab);
+  EXPECT_READ32(I2C_RDATA_REG_OFFSET, 0xcd);
+  EXPECT_READ32(I2C_HOST_FIFO_STATUS_REG_OFFSET,
+                {{I2C_HOST_FIFO_STATUS_RXLVL_OFFSET, 0}});
+  EXPECT_READ32(I2C_HOST_FIFO_STATUS_REG_OFFSET,
+                {{I2C_HOST_FIFO_STATUS_RXLVL_OFFSET, 1}});
+  EXPECT_READ32(I2C_RDATA_REG_OFFSET, 0xef);
+
+  EXPECT_DIF_OK(dif_i2c_read_bytes(&i2c_, sizeof(buf), buf));
+  EXPECT_EQ(buf[0], 0xab);
+  EXPECT_EQ(buf[1], 0xcd);
+  EXPECT_EQ(buf[2], 0xef);
+}
+
 TEST_F(FifoTest, ReadNullArgs) {
   uint8_t val;
   EXPECT_DIF_BADARG(dif_i2c_read_byte(nullptr, &val));
@@ -1047,6 +1068,35 @@ TEST_F(FifoTest, WriteRaw) {
                                        }));
 }
 
+// Checks that the FMT FIFO level is only polled again once the space seen by
+// the previous poll has been used up.
+TEST_F(FifoTest, WriteBytesRaw) {
+  const uint8_t bytes[] = {0x11, 0x22, 0x33};
+
+  EXPECT_READ32(I2C_HOST_FIFO_STATUS_REG_OFFSET,
+                {{I2C_HOST_FIFO_STATUS_FMTLVL_OFFSET, I2C_PARAM_FIFO_DEPTH - 2}});
+  EXPECT_WRITE32(I2C_FDATA_REG_OFFSET, {
+                                           {I2C_FDATA_FBYTE_OFFSET, 0x11},
+                                           {I2C_FDATA_STOP_BIT, 0x1},
+                                       });
+  EXPECT_WRITE32(I2C_FDATA_REG_OFFSET, {
+                                           {I2C_FDATA_FBYTE_OFFSET, 0x22},
+                                           {I2C_FDATA_STOP_BIT, 0x1},
+                                       });
+  EXPECT_READ32(I2C_HOST_FIFO_STATUS_REG_OFFSET,
+                {{I2C_HOST_FIFO_STATUS_FMTLVL_OFFSET, I2C_PARAM_FIFO_DEPTH}});
+  EXPECT_READ32(I2C_HOST_FIFO_STATUS_REG_OFFSET,
+                {{I2C_HOST_FIFO_STATUS_FMTLVL_OFFSET, 0}});
+  EXPECT_WRITE32(I2C_FDATA_REG_OFFSET, {
+                                           {I2C_FDATA_FBYTE_OFFSET, 0x33},
+                                           {I2C_FDATA_STOP_BIT, 0x1},
+                                       });
+  EXPECT_DIF_OK(dif_i2c_write_bytes_raw(&i2c_, sizeof(bytes), bytes,
+                                        {
+                                            .stop = true,
+                                        }));
+}
+
 TEST_F(FifoTest, WriteRawBadArgs) {
   EXPECT_DIF_BADARG(dif_i2c_write_byte_raw(nullptr, 0xff, {}));
   EXPECT_DIF_BADARG(dif_i2c_write_byte_raw(&i2c_, 0xff,
@@ -609,6 +609,19 @@ static void msg_fifo_write(const dif_kmac_t *kmac, const unsigned char *data,
   for (; len != 0 && ((uintptr_t)data) % sizeof(uint32_t); --len) {
     mmio_region_write8(kmac->base_addr, KMAC_MSG_FIFO_REG_OFFSET, *data++);
   }
+  // Write four words per iteration while possible, so that the FIFO sees
+  // back-to-back writes rather than a loop branch after every word.
+  for (; len >= 4 * sizeof(uint32_t); len -= 4 * sizeof(uint32_t)) {
+    mmio_region_write32(kmac->base_addr, KMAC_MSG_FIFO_REG_OFFSET,
+                        read_32(data));
+    mmio_region_write32(kmac->base_addr, KMAC_MSG_FIFO_REG_OFFSET,
+                        read_32(data + sizeof(uint32_t)));
+    mmio_region_write32(kmac->base_addr, KMAC_MSG_FIFO_REG_OFFSET,
+                        read_32(data + 2 * sizeof(uint32_t)));
+    mmio_region_write32(kmac->base_addr, KMAC_MSG_FIFO_REG_OFFSET,
+                        read_32(data + 3 * sizeof(uint32_t)));
+    data += 4 * sizeof(uint32_t);
+  }
   for (; len >= sizeof(uint32_t); len -= sizeof(uint32_t)) {
     mmio_region_write32(kmac->base_addr, KMAC_MSG_FIFO_REG_OFFSET,
                         read_32(data));
@@ -670,6 +683,53 @@ dif_result_t dif_kmac_absorb(const dif_kmac_t *kmac,
   return kDifOk;
 }
 
+dif_result_t dif_kmac_absorb_buffers(
+    const dif_kmac_t *kmac, dif_kmac_operation_state_t *operation_state,
+    const dif_kmac_buffer_t *buffers, size_t count) {
+  if (kmac == NULL || operation_state == NULL ||
+      (buffers == NULL && count != 0)) {
+    return kDifBadArg;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (buffers[i].data == NULL && buffers[i].len != 0) {
+      return kDifBadArg;
+    }
+  }
+
+  // Check that an operation has been started.
+  if (operation_state->r == 0) {
+    return kDifError;
+  }
+
+  if (!is_state_absorb(kmac)) {
+    return kDifError;
+  }
+
+  // The free space in the message FIFO, in bytes, that is left from the last
+  // time its depth was read. The hardware only ever makes more space, so this
+  // is safe to use up before reading the depth again.
+  size_t free_len = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const unsigned char *data = (const unsigned char *)buffers[i].data;
+    size_t len = buffers[i].len;
+    while (len > 0) {
+      if (free_len == 0) {
+        dif_kmac_status_t status;
+        DIF_RETURN_IF_ERROR(dif_kmac_get_status(kmac, &status));
+        free_len = (KMAC_PARAM_NUM_ENTRIES_MSG_FIFO - status.fifo_depth) *
+                   KMAC_PARAM_NUM_BYTES_MSG_FIFO_ENTRY;
+      }
+      size_t write_len = (len < free_len) ? len : free_len;
+      msg_fifo_write(kmac, data, write_len);
+      data += write_len;
+      len -= write_len;
+      free_len -= write_len;
+    }
+  }
+
+  return kDifOk;
+}
+
 dif_result_t dif_kmac_squeeze(const dif_kmac_t *kmac,
                               dif_kmac_operation_state_t *operation_state,
                               uint32_t *out, size_t len, size_t *processed,
@@ -45,7 +45,7 @@ extern "C" {
  * The following sequence of operations is required to execute an operation:
  *
  * - `dif_kmac_{sha3,shake,cshake,kmac}_start()`
- * - `dif_kmac_absorb()`
+ * - `dif_kmac_absorb()` or `dif_kmac_absorb_buffers()`
  * - `dif_kmac_squeeze()`
  * - `dif_kmac_end()`
  *
@@ -652,6 +652,42 @@ dif_result_t dif_kmac_absorb(const dif_kmac_t *kmac,
                              dif_kmac_operation_state_t *operation_state,
                              const void *msg, size_t len, size_t *processed);
 
+/**
+ * A piece of a message, for `dif_kmac_absorb_buffers()`.
+ */
+typedef struct dif_kmac_buffer {
+  /**
+   * Pointer to the data.
+   */
+  const void *data;
+  /**
+   * Number of bytes of data.
+   */
+  size_t len;
+} dif_kmac_buffer_t;
+
+/**
+ * Absorb a message that is split across several buffers.
+ *
+ * This is equivalent to calling `dif_kmac_absorb()` on each buffer in turn
+ * with a NULL `processed`, but checks the state of the hardware only once, and
+ * reads the message FIFO depth only when the space it reported last time has
+ * been used up, rather than once per buffer.
+ *
+ * Byte swapping in big-endian mode works as for `dif_kmac_absorb()`, for each
+ * buffer separately.
+ *
+ * @param kmac A KMAC handle.
+ * @param operation_state A KMAC operation state context.
+ * @param buffers The buffers to absorb, in order.
+ * @param count The number of buffers.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_kmac_absorb_buffers(
+    const dif_kmac_t *kmac, dif_kmac_operation_state_t *operation_state,
+    const dif_kmac_buffer_t *buffers, size_t count);
+
 /**
  * Squeeze bytes into the output buffer provided.
  *
@@ -595,6 +595,88 @@ TEST_F(AbsorbalignmentMessage, Success) {
   }
 }
 
+class AbsorbBuffersTest : public KmacTest {
+ protected:
+  AbsorbBuffersTest() { op_state_.r = GetRateWords(256); }
+};
+
+TEST_F(AbsorbBuffersTest, Success) {
+  // Test assumption: the whole message fits in the FIFO.
+  static_assert(2 * kMsg.size() <= KMAC_PARAM_NUM_ENTRIES_MSG_FIFO *
+                                       KMAC_PARAM_NUM_BYTES_MSG_FIFO_ENTRY,
+                "Message must fit in the KMAC message FIFO.");
+
+  alignas(uint32_t) uint8_t buffer[2 * kMsg.size() + 1];
+  std::copy(kMsg.begin(), kMsg.end(), &buffer[0]);
+  std::copy(kMsg.begin(), kMsg.end(), &buffer[kMsg.size() + 1]);
+  dif_kmac_buffer_t buffers[] = {
+      {.data = &buffer[0], .len = kMsg.size()},
+      {.data = &buffer[kMsg.size()], .len = 0},
+      {.data = &buffer[kMsg.size() + 1], .len = kMsg.size()},
+  };
+
+  // One read for the absorb bit, and a single FIFO depth read for all of the
+  // buffers.
+  EXPECT_READ32(KMAC_STATUS_REG_OFFSET, 1 << KMAC_STATUS_SHA3_ABSORB_BIT);
+  EXPECT_READ32(KMAC_STATUS_REG_OFFSET, 1 << KMAC_STATUS_SHA3_ABSORB_BIT);
+  ExpectMessageInt32(&buffer[0], kMsg.size());
+  ExpectMessageInt32(&buffer[kMsg.size() + 1], kMsg.size());
+
+  EXPECT_DIF_OK(dif_kmac_absorb_buffers(&kmac_, &op_state_, buffers,
+                                        ARRAYSIZE(buffers)));
+}
+
+TEST_F(AbsorbBuffersTest, FifoFillsUp) {
+  alignas(uint32_t) uint8_t buffer[12];
+  std::copy(kMsg.begin(), kMsg.begin() + sizeof(buffer), &buffer[0]);
+  dif_kmac_buffer_t buffers[] = {
+      {.data = &buffer[0], .len = 4},
+      {.data = &buffer[4], .len = 8},
+  };
+
+  EXPECT_READ32(KMAC_STATUS_REG_OFFSET, 1 << KMAC_STATUS_SHA3_ABSORB_BIT);
+  // Only one entry is free, which takes the first buffer and half of the
+  // second.
+  EXPECT_READ32(KMAC_STATUS_REG_OFFSET,
+                {{KMAC_STATUS_SHA3_ABSORB_BIT, true},
+                 {KMAC_STATUS_FIFO_DEPTH_OFFSET,
+                  KMAC_PARAM_NUM_ENTRIES_MSG_FIFO - 1}});
+  ExpectMessageInt32(&buffer[0], 4);
+  ExpectMessageInt32(&buffer[4], 4);
+  EXPECT_READ32(KMAC_STATUS_REG_OFFSET, 1 << KMAC_STATUS_SHA3_ABSORB_BIT);
+  ExpectMessageInt32(&buffer[8], 4);
+
+  EXPECT_DIF_OK(dif_kmac_absorb_buffers(&kmac_, &op_state_, buffers,
+                                        ARRAYSIZE(buffers)));
+}
+
+TEST_F(AbsorbBuffersTest, NotAbsorbing) {
+  dif_kmac_buffer_t buffers[] = {{.data = kMsg.data(), .len = kMsg.size()}};
+
+  EXPECT_READ32(KMAC_STATUS_REG_OFFSET, 1 << KMAC_STATUS_SHA3_IDLE_BIT);
+  EXPECT_EQ(dif_kmac_absorb_buffers(&kmac_, &op_state_, buffers,
+                                    ARRAYSIZE(buffers)),
+            kDifError);
+
+  op_state_.r = 0;
+  EXPECT_EQ(dif_kmac_absorb_buffers(&kmac_, &op_state_, buffers,
+                                    ARRAYSIZE(buffers)),
+            kDifError);
+}
+
+TEST_F(AbsorbBuffersTest, BadArg) {
+  dif_kmac_buffer_t buffers[] = {{.data = kMsg.data(), .len = kMsg.size()}};
+  EXPECT_DIF_BADARG(dif_kmac_absorb_buffers(nullptr, &op_state_, buffers,
+                                            ARRAYSIZE(buffers)));
+  EXPECT_DIF_BADARG(
+      dif_kmac_absorb_buffers(&kmac_, nullptr, buffers, ARRAYSIZE(buffers)));
+  EXPECT_DIF_BADARG(dif_kmac_absorb_buffers(&kmac_, &op_state_, nullptr, 1));
+
+  buffers[0].data = nullptr;
+  EXPECT_DIF_BADARG(dif_kmac_absorb_buffers(&kmac_, &op_state_, buffers,
+                                            ARRAYSIZE(buffers)));
+}
+
 class ConfigLock : public KmacTest {};
 
 TEST_F(ConfigLock, Locked) {
@@ -132,38 +132,69 @@ static void wait_ready(const dif_spi_host_t *spi_host) {
   } while (!ready);
 }
 
-static void wait_tx_fifo(const dif_spi_host_t *spi_host) {
+/**
+ * Waits for space in the transmit FIFO.
+ *
+ * @return The number of free transmit FIFO entries, which is at least one.
+ */
+static uint32_t wait_tx_fifo(const dif_spi_host_t *spi_host) {
   uint32_t txqd;
   do {
     uint32_t reg =
         mmio_region_read32(spi_host->base_addr, SPI_HOST_STATUS_REG_OFFSET);
     txqd = bitfield_field32_read(reg, SPI_HOST_STATUS_TXQD_FIELD);
-  } while (txqd == SPI_HOST_PARAM_TX_DEPTH);
+  } while (txqd >= SPI_HOST_PARAM_TX_DEPTH);
+  return SPI_HOST_PARAM_TX_DEPTH - txqd;
 }
 
-static void wait_rx_fifo(const dif_spi_host_t *spi_host) {
+/**
+ * Waits for data in the receive FIFO.
+ *
+ * @return The number of words in the receive FIFO, which is at least one.
+ */
+static uint32_t wait_rx_fifo(const dif_spi_host_t *spi_host) {
   uint32_t rxqd;
   do {
     uint32_t reg =
         mmio_region_read32(spi_host->base_addr, SPI_HOST_STATUS_REG_OFFSET);
     rxqd = bitfield_field32_read(reg, SPI_HOST_STATUS_RXQD_FIELD);
   } while (rxqd == 0);
+  return rxqd;
 }
 
+// The FIFO accessors below take the number of entries known to be free (for
+// writes) or filled (for reads), so the STATUS register is only polled when
+// that count runs out rather than before every access.
+
 static inline void tx_fifo_write8(const dif_spi_host_t *spi_host,
-                                  uintptr_t srcaddr) {
+                                  uintptr_t srcaddr, uint32_t *space) {
   uint8_t *src = (uint8_t *)srcaddr;
-  wait_tx_fifo(spi_host);
+  if (*space == 0) {
+    *space = wait_tx_fifo(spi_host);
+  }
+  *space -= 1;
   mmio_region_write8(spi_host->base_addr, SPI_HOST_TXDATA_REG_OFFSET, *src);
 }
 
 static inline void tx_fifo_write32(const dif_spi_host_t *spi_host,
-                                   uintptr_t srcaddr) {
-  wait_tx_fifo(spi_host);
+                                   uintptr_t srcaddr, uint32_t *space) {
+  if (*space == 0) {
+    *space = wait_tx_fifo(spi_host);
+  }
+  *space -= 1;
   uint32_t val = read_32((const void *)srcaddr);
   mmio_region_write32(spi_host->base_addr, SPI_HOST_TXDATA_REG_OFFSET, val);
 }
 
+static inline uint32_t rx_fifo_read32(const dif_spi_host_t *spi_host,
+                                      uint32_t *level) {
+  if (*level == 0) {
+    *level = wait_rx_fifo(spi_host);
+  }
+  *level -= 1;
+  return mmio_region_read32(spi_host->base_addr, SPI_HOST_RXDATA_REG_OFFSET);
+}
+
 dif_result_t dif_spi_host_fifo_write(const dif_spi_host_t *spi_host,
                                      const void *src, uint16_t len) {
   uintptr_t ptr = (uintptr_t)src;
@@ -171,23 +202,25 @@ dif_result_t dif_spi_host_fifo_write(const dif_spi_host_t *spi_host,
     return kDifBadArg;
   }
 
+  uint32_t space = 0;
+
   // If the pointer starts mis-aligned, write until we are aligned.
   while (misalignment32_of(ptr) && len > 0) {
-    tx_fifo_write8(spi_host, ptr);
+    tx_fifo_write8(spi_host, ptr, &space);
     ptr += 1;
     len -= 1;
   }
 
   // Write complete 32-bit words to the fifo.
   while (len > 3) {
-    tx_fifo_write32(spi_host, ptr);
+    tx_fifo_write32(spi_host, ptr, &space);
     ptr += 4;
     len -= 4;
   }
 
   // Clean up any leftover bytes.
   while (len > 0) {
-    tx_fifo_write8(spi_host, ptr);
+    tx_fifo_write8(spi_host, ptr, &space);
     ptr += 1;
     len -= 1;
   }
@@ -241,14 +274,13 @@ dif_result_t dif_spi_host_fifo_read(const dif_spi_host_t *spi_host, void *dst,
   // We always have to read from the RXFIFO as a 32-bit word.  We use a
   // two-word queue to handle destination and length mis-alignments.
   queue_t queue = {0};
+  uint32_t level = 0;
 
   // If the buffer is misaligned, write a byte at a time until we reach
   // alignment.
   while (misalignment32_of(ptr) && len > 0) {
     if (queue.length < 1) {
-      wait_rx_fifo(spi_host);
-      enqueue_word(&queue, mmio_region_read32(spi_host->base_addr,
-                                              SPI_HOST_RXDATA_REG_OFFSET));
+      enqueue_word(&queue, rx_fifo_read32(spi_host, &level));
     }
     uint8_t *p = (uint8_t *)ptr;
     *p = dequeue_byte(&queue);
@@ -257,13 +289,17 @@ dif_result_t dif_spi_host_fifo_read(const dif_spi_host_t *spi_host, void *dst,
   }
 
   // While we can write complete words to memory, operate on 4 bytes at a time.
+  // If the queue is empty (i.e. the buffer was aligned to begin with), the
+  // words go straight from the FIFO to memory.
   while (len > 3) {
-    if (queue.length < 4) {
-      wait_rx_fifo(spi_host);
-      enqueue_word(&queue, mmio_region_read32(spi_host->base_addr,
-                                              SPI_HOST_RXDATA_REG_OFFSET));
+    if (queue.length == 0) {
+      write_32(rx_fifo_read32(spi_host, &level), (void *)ptr);
+    } else {
+      if (queue.length < 4) {
+        enqueue_word(&queue, rx_fifo_read32(spi_host, &level));
+      }
+      write_32(dequeue_word(&queue), (void *)ptr);
     }
-    write_32(dequeue_word(&queue), (void *)ptr);
     ptr += 4;
     len -= 4;
   }
@@ -271,9 +307,7 @@ dif_result_t dif_spi_host_fifo_read(const dif_spi_host_t *spi_host, void *dst,
   // Finish up any left over buffer a byte at a time.
   while (len > 0) {
     if (queue.length < 1) {
-      wait_rx_fifo(spi_host);
-      enqueue_word(&queue, mmio_region_read32(spi_host->base_addr,
-                                              SPI_HOST_RXDATA_REG_OFFSET));
+      enqueue_word(&queue, rx_fifo_read32(spi_host, &level));
     }
     uint8_t *p = (uint8_t *)ptr;
     *p = dequeue_byte(&queue);
@@ -338,6 +372,14 @@ static void issue_dummy(const dif_spi_host_t *spi_host,
   }
 }
 
+enum {
+  /**
+   * The maximum number of bytes a single command can transfer, as limited by
+   * the width of `COMMAND.LEN`.
+   */
+  kMaxCommandLength = SPI_HOST_COMMAND_LEN_MASK + 1,
+};
+
 static dif_result_t issue_data_phase(const dif_spi_host_t *spi_host,
                                      dif_spi_host_segment_t *segment,
                                      bool last_segment) {
@@ -370,6 +412,111 @@ static dif_result_t issue_data_phase(const dif_spi_host_t *spi_host,
   return kDifOk;
 }
 
+/**
+ * Reads the data received by a segment, if any, from the receive FIFO.
+ */
+static void drain_segment(const dif_spi_host_t *spi_host,
+                          dif_spi_host_segment_t *segment) {
+  switch (segment->type) {
+    case kDifSpiHostSegmentTypeRx:
+      spi_host_fifo_read_alias(spi_host, segment->rx.buf,
+                               (uint16_t)segment->rx.length);
+      break;
+    case kDifSpiHostSegmentTypeBidirectional:
+      spi_host_fifo_read_alias(spi_host, segment->bidir.rxbuf,
+                               (uint16_t)segment->bidir.length);
+      break;
+    default:
+        /* do nothing */;
+  }
+}
+
+/**
+ * Issues a data segment that is too long for a single command as a series of
+ * commands, keeping chip select asserted between them.
+ *
+ * Received data is read back as the segment proceeds, since the receive FIFO
+ * cannot hold it all.  For receive-only segments the next command is queued
+ * before the data of the current one is read, so the bus is kept busy while
+ * the FIFO is being drained.
+ */
+static void issue_long_data_phase(const dif_spi_host_t *spi_host,
+                                  dif_spi_host_segment_t *segment,
+                                  bool last_segment) {
+  size_t length;
+  dif_spi_host_width_t width;
+  dif_spi_host_direction_t direction;
+  const uint8_t *txbuf = NULL;
+  uint8_t *rxbuf = NULL;
+  switch (segment->type) {
+    case kDifSpiHostSegmentTypeTx:
+      length = segment->tx.length;
+      width = segment->tx.width;
+      direction = kDifSpiHostDirectionTx;
+      txbuf = segment->tx.buf;
+      break;
+    case kDifSpiHostSegmentTypeBidirectional:
+      length = segment->bidir.length;
+      width = segment->bidir.width;
+      direction = kDifSpiHostDirectionBidirectional;
+      txbuf = segment->bidir.txbuf;
+      rxbuf = segment->bidir.rxbuf;
+      break;
+    default:
+      length = segment->rx.length;
+      width = segment->rx.width;
+      direction = kDifSpiHostDirectionRx;
+      rxbuf = segment->rx.buf;
+      break;
+  }
+
+  // Number of bytes issued by the previous command and not yet read back.
+  uint16_t pending = 0;
+  for (size_t offset = 0; offset < length;) {
+    uint16_t chunk = length - offset < kMaxCommandLength
+                         ? (uint16_t)(length - offset)
+                         : kMaxCommandLength;
+    if (offset > 0) {
+      wait_ready(spi_host);
+    }
+    write_command_reg(spi_host, chunk, width, direction,
+                      last_segment && offset + chunk == length);
+    if (txbuf != NULL) {
+      spi_host_fifo_write_alias(spi_host, txbuf + offset, chunk);
+    }
+    if (rxbuf != NULL && txbuf != NULL) {
+      // Bidirectional: the transmit data of the next command would not fit
+      // behind the stalled remainder of this one, so read it back now.
+      spi_host_fifo_read_alias(spi_host, rxbuf + offset, chunk);
+    } else if (rxbuf != NULL) {
+      if (pending > 0) {
+        spi_host_fifo_read_alias(spi_host, rxbuf + offset - pending, pending);
+      }
+      pending = chunk;
+    }
+    offset += chunk;
+  }
+  if (pending > 0) {
+    spi_host_fifo_read_alias(spi_host, rxbuf + length - pending, pending);
+  }
+}
+
+/**
+ * Returns the length of a data segment, or zero for other segment types.
+ */
+static size_t data_phase_length(const dif_spi_host_segment_t *segment) {
+  switch (segment->type) {
+    case kDifSpiHostSegmentTypeTx:
+      return segment->tx.length;
+    case kDifSpiHostSegmentTypeRx:
+      return segment->rx.length;
+    case kDifSpiHostSegmentTypeBidirectional:
+      return segment->bidir.length;
+    default:
+      return 0;
+  }
+}
+
 dif_result_t dif_spi_host_transaction(const dif_spi_host_t *spi_host,
                                       uint32_t csid,
                                       dif_spi_host_segment_t *segments,
@@ -377,6 +524,9 @@ dif_result_t dif_spi_host_transaction(const dif_spi_host_t *spi_host,
   // Write to chip select ID.
   mmio_region_write32(spi_host->base_addr, SPI_HOST_CSID_REG_OFFSET, csid);
 
+  // Segments before this index have had their received data read back.
+  size_t drained = 0;
+
   // For each segment, write the segment information to the
   // COMMAND register and transmit FIFO.
   for (size_t i = 0; i < length; ++i) {
@@ -396,6 +546,17 @@ dif_result_t dif_spi_host_transaction(const dif_spi_host_t *spi_host,
       case kDifSpiHostSegmentTypeTx:
       case kDifSpiHostSegmentTypeRx:
       case kDifSpiHostSegmentTypeBidirectional: {
+        if (data_phase_length(segment) > kMaxCommandLength) {
+          if (segment->type != kDifSpiHostSegmentTypeTx) {
+            // Received data must be read back in order.
+            for (; drained < i; ++drained) {
+              drain_segment(spi_host, &segments[drained]);
+            }
+            drained = i + 1;
+          }
+          issue_long_data_phase(spi_host, segment, last_segment);
+          break;
+        }
         dif_result_t error = issue_data_phase(spi_host, segment, last_segment);
         if (error != kDifOk) {
           return error;
@@ -408,20 +569,8 @@ dif_result_t dif_spi_host_transaction(const dif_spi_host_t *spi_host,
   }
 
   // For each segment which receives data, read from the receive FIFO.
-  for (size_t i = 0; i < length; ++i) {
-    dif_spi_host_segment_t *segment = &segments[i];
-    switch (segment->type) {
-      case kDifSpiHostSegmentTypeRx:
-        spi_host_fifo_read_alias(spi_host, segment->rx.buf,
-                                 (uint16_t)segment->rx.length);
-        break;
-      case kDifSpiHostSegmentTypeBidirectional:
-        spi_host_fifo_read_alias(spi_host, segment->bidir.rxbuf,
-                                 (uint16_t)segment->bidir.length);
-        break;
-      default:
-          /* do nothing */;
-    }
+  for (; drained < length; ++drained) {
+    drain_segment(spi_host, &segments[drained]);
   }
   return kDifOk;
 }
@@ -200,6 +200,9 @@ dif_result_t dif_spi_host_fifo_read(const dif_spi_host_t *spi_host, void *dst,
 /**
  * Begins a SPI Host transaction.
  *
+ * Data segments longer than a single command can carry (512 bytes) are issued
+ * as several commands with chip select held asserted in between.
+ *
  * @param spi_host A SPI Host handle.
  * @param csid The chip-select ID of the SPI target.
  * @param segments The SPI segments to send in this transaction.
@@ -441,6 +441,85 @@ TEST_F(TransactionTest, MultiSegmentTxRx) {
       dif_spi_host_transaction(&spi_host_, 0, segment, ARRAYSIZE(segment)));
 }
 
+// Checks that a receive segment longer than a single command is split into
+// several commands, reading back each one after the next has been queued.
+TEST_F(TransactionTest, LongReceive) {
+  uint8_t rxbuf[1200];
+  dif_spi_host_segment segment;
+  segment.type = kDifSpiHostSegmentTypeRx;
+  segment.rx.width = kDifSpiHostWidthQuad;
+  segment.rx.buf = rxbuf;
+  segment.rx.length = sizeof(rxbuf);
+
+  EXPECT_WRITE32(SPI_HOST_CSID_REG_OFFSET, 0);
+  EXPECT_READY(true);
+  EXPECT_COMMAND_REG(/*length=*/512, /*width=*/kDifSpiHostWidthQuad,
+                     /*direction=*/kDifSpiHostDirectionRx, /*last=*/false);
+  EXPECT_READY(true);
+  EXPECT_COMMAND_REG(/*length=*/512, /*width=*/kDifSpiHostWidthQuad,
+                     /*direction=*/kDifSpiHostDirectionRx, /*last=*/false);
+  EXPECT_CALL(fifo_, read(&spi_host_, &rxbuf[0], 512));
+  EXPECT_READY(true);
+  EXPECT_COMMAND_REG(/*length=*/176, /*width=*/kDifSpiHostWidthQuad,
+                     /*direction=*/kDifSpiHostDirectionRx, /*last=*/true);
+  EXPECT_CALL(fifo_, read(&spi_host_, &rxbuf[512], 512));
+  EXPECT_CALL(fifo_, read(&spi_host_, &rxbuf[1024], 176));
+
+  EXPECT_DIF_OK(dif_spi_host_transaction(&spi_host_, 0, &segment, 1));
+}
+
+// Checks that the data of earlier segments is read back before a long receive
+// segment, and that a long transmit segment keeps chip select asserted.
+TEST_F(TransactionTest, LongTransmitThenReceive) {
+  uint8_t txbuf[600];
+  uint8_t rxbuf[1024];
+  dif_spi_host_segment segment[3];
+  uint8_t bidir_rxbuf[4];
+  uint8_t bidir_txbuf[4];
+
+  segment[0].type = kDifSpiHostSegmentTypeBidirectional;
+  segment[0].bidir.width = kDifSpiHostWidthStandard;
+  segment[0].bidir.txbuf = bidir_txbuf;
+  segment[0].bidir.rxbuf = bidir_rxbuf;
+  segment[0].bidir.length = sizeof(bidir_txbuf);
+  segment[1].type = kDifSpiHostSegmentTypeTx;
+  segment[1].tx.width = kDifSpiHostWidthStandard;
+  segment[1].tx.buf = txbuf;
+  segment[1].tx.length = sizeof(txbuf);
+  segment[2].type = kDifSpiHostSegmentTypeRx;
+  segment[2].rx.width = kDifSpiHostWidthStandard;
+  segment[2].rx.buf = rxbuf;
+  segment[2].rx.length = sizeof(rxbuf);
+
+  EXPECT_WRITE32(SPI_HOST_CSID_REG_OFFSET, 0);
+  EXPECT_READY(true);
+  EXPECT_COMMAND_REG(/*length=*/sizeof(bidir_txbuf),
+                     /*width=*/kDifSpiHostWidthStandard,
+                     /*direction=*/kDifSpiHostDirectionBidirectional,
+                     /*last=*/false);
+  EXPECT_CALL(fifo_, write(&spi_host_, bidir_txbuf, sizeof(bidir_txbuf)));
+  EXPECT_READY(true);
+  EXPECT_COMMAND_REG(/*length=*/512, /*width=*/kDifSpiHostWidthStandard,
+                     /*direction=*/kDifSpiHostDirectionTx, /*last=*/false);
+  EXPECT_CALL(fifo_, write(&spi_host_, &txbuf[0], 512));
+  EXPECT_READY(true);
+  EXPECT_COMMAND_REG(/*length=*/88, /*width=*/kDifSpiHostWidthStandard,
+                     /*direction=*/kDifSpiHostDirectionTx, /*last=*/false);
+  EXPECT_CALL(fifo_, write(&spi_host_, &txbuf[512], 88));
+  EXPECT_READY(true);
+  EXPECT_CALL(fifo_, read(&spi_host_, bidir_rxbuf, sizeof(bidir_rxbuf)));
+  EXPECT_COMMAND_REG(/*length=*/512, /*width=*/kDifSpiHostWidthStandard,
+                     /*direction=*/kDifSpiHostDirectionRx, /*last=*/false);
+  EXPECT_READY(true);
+  EXPECT_COMMAND_REG(/*length=*/512, /*width=*/kDifSpiHostWidthStandard,
+                     /*direction=*/kDifSpiHostDirectionRx, /*last=*/true);
+  EXPECT_CALL(fifo_, read(&spi_host_, &rxbuf[0], 512));
+  EXPECT_CALL(fifo_, read(&spi_host_, &rxbuf[512], 512));
+
+  EXPECT_DIF_OK(
+      dif_spi_host_transaction(&spi_host_, 0, segment, ARRAYSIZE(segment)));
+}
+
 class FifoTest : public SpiHostTest {};
 
 // Checks that arguments are validated.
@@ -463,12 +542,26 @@ TEST_F(FifoTest, AlignedWrite) {
 
   EXPECT_TXQD(0);
   EXPECT_WRITE32(SPI_HOST_TXDATA_REG_OFFSET, 1);
-  EXPECT_TXQD(0);
   EXPECT_WRITE32(SPI_HOST_TXDATA_REG_OFFSET, 2);
 
   EXPECT_DIF_OK(dif_spi_host_fifo_write(&spi_host_, buffer, sizeof(buffer)));
 }
 
+// Checks that the transmit FIFO level is polled again once the free space
+// seen by the previous poll has been used up.
+TEST_F(FifoTest, WriteWaitsForSpace) {
+  uint32_t buffer[] = {1, 2, 3};
+
+  EXPECT_TXQD(SPI_HOST_PARAM_TX_DEPTH - 2);
+  EXPECT_WRITE32(SPI_HOST_TXDATA_REG_OFFSET, 1);
+  EXPECT_WRITE32(SPI_HOST_TXDATA_REG_OFFSET, 2);
+  EXPECT_TXQD(SPI_HOST_PARAM_TX_DEPTH);
+  EXPECT_TXQD(SPI_HOST_PARAM_TX_DEPTH - 1);
+  EXPECT_WRITE32(SPI_HOST_TXDATA_REG_OFFSET, 3);
+
+  EXPECT_DIF_OK(dif_spi_host_fifo_write(&spi_host_, buffer, sizeof(buffer)));
+}
+
 template <size_t count, size_t align>
 struct Aligned {
   alignas(align) uint8_t value[count];
@@ -485,17 +578,13 @@ TEST_F(FifoTest, MisalignedWrite) {
   // Because of the misalignment, expect three byte writes.
   EXPECT_TXQD(0);
   EXPECT_WRITE8(SPI_HOST_TXDATA_REG_OFFSET, 1);
-  EXPECT_TXQD(0);
   EXPECT_WRITE8(SPI_HOST_TXDATA_REG_OFFSET, 2);
-  EXPECT_TXQD(0);
   EXPECT_WRITE8(SPI_HOST_TXDATA_REG_OFFSET, 3);
 
   // Then a word write when we reach alignment.
-  EXPECT_TXQD(0);
   EXPECT_WRITE32(SPI_HOST_TXDATA_REG_OFFSET, 0x07060504);
 
   // Then a byte write to finish the buffer.
-  EXPECT_TXQD(0);
   EXPECT_WRITE8(SPI_HOST_TXDATA_REG_OFFSET, 8);
 
   EXPECT_DIF_OK(dif_spi_host_fifo_write(&spi_host_, buffer.get() + 1, 8));
@@ -508,13 +597,28 @@ TEST_F(FifoTest, AlignedRead) {
 
   EXPECT_RXQD(2);
   EXPECT_READ32(SPI_HOST_RXDATA_REG_OFFSET, 1);
-  EXPECT_RXQD(1);
   EXPECT_READ32(SPI_HOST_RXDATA_REG_OFFSET, 2);
 
   EXPECT_DIF_OK(dif_spi_host_fifo_read(&spi_host_, buffer, sizeof(buffer)));
   EXPECT_THAT(buffer, ElementsAre(1, 2));
 }
 
+// Checks that the receive FIFO level is polled again once the words seen by
+// the previous poll have been read.
+TEST_F(FifoTest, ReadWaitsForData) {
+  uint32_t buffer[3];
+
+  EXPECT_RXQD(2);
+  EXPECT_READ32(SPI_HOST_RXDATA_REG_OFFSET, 1);
+  EXPECT_READ32(SPI_HOST_RXDATA_REG_OFFSET, 2);
+  EXPECT_RXQD(0);
+  EXPECT_RXQD(1);
+  EXPECT_READ32(SPI_HOST_RXDATA_REG_OFFSET, 3);
+
+  EXPECT_DIF_OK(dif_spi_host_fifo_read(&spi_host_, buffer, sizeof(buffer)));
+  EXPECT_THAT(buffer, ElementsAre(1, 2, 3));
+}
+
 // Checks that a misaligned destination buffer receives the contents of the
 // recieve FIFO.
 TEST_F(FifoTest, MisalignedRead) {
@@ -524,7 +628,6 @@ TEST_F(FifoTest, MisalignedRead) {
 
   EXPECT_RXQD(2);
   EXPECT_READ32(SPI_HOST_RXDATA_REG_OFFSET, 0x04030201);
-  EXPECT_RXQD(1);
   EXPECT_READ32(SPI_HOST_RXDATA_REG_OFFSET, 0x08070605);
 
   EXPECT_DIF_OK(dif_spi_host_fifo_read(&spi_host_, buffer.get() + 1, 8));
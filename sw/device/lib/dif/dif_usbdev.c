@@ -473,6 +473,53 @@ dif_result_t dif_usbdev_buffer_return(const dif_usbdev_t *usbdev,
   }
 }
 
+dif_result_t dif_usbdev_buffer_span_get(const dif_usbdev_t *usbdev,
+                                        const dif_usbdev_buffer_t *buffer,
+                                        dif_usbdev_buffer_span_t *span) {
+  if (usbdev == NULL || buffer == NULL || span == NULL ||
+      (buffer->type != kDifUsbdevBufferTypeRead &&
+       buffer->type != kDifUsbdevBufferTypeWrite)) {
+    return kDifBadArg;
+  }
+
+  *span = (dif_usbdev_buffer_span_t){
+      .region = usbdev->base_addr,
+      .offset = get_buffer_addr(buffer->id, buffer->offset),
+      .len = buffer->remaining_bytes,
+  };
+  return kDifOk;
+}
+
+dif_result_t dif_usbdev_buffer_span_commit(
+    const dif_usbdev_t *usbdev, dif_usbdev_buffer_pool_t *buffer_pool,
+    dif_usbdev_buffer_t *buffer, size_t len) {
+  if (usbdev == NULL || buffer_pool == NULL || buffer == NULL ||
+      (buffer->type != kDifUsbdevBufferTypeRead &&
+       buffer->type != kDifUsbdevBufferTypeWrite) ||
+      len > buffer->remaining_bytes) {
+    return kDifBadArg;
+  }
+
+  // Update buffer state
+  buffer->offset += len;
+  buffer->remaining_bytes -= len;
+
+  // Write buffers, and read buffers with remaining bytes, stay with the client.
+  if (buffer->type == kDifUsbdevBufferTypeWrite ||
+      buffer->remaining_bytes > 0) {
+    return kDifOk;
+  }
+
+  // Return the buffer to the free buffer pool
+  if (!buffer_pool_add(buffer_pool, buffer->id)) {
+    return kDifError;
+  }
+
+  // Mark the buffer as stale
+  buffer->type = kDifUsbdevBufferTypeStale;
+  return kDifOk;
+}
+
 dif_result_t dif_usbdev_buffer_read(const dif_usbdev_t *usbdev,
                                     dif_usbdev_buffer_pool_t *buffer_pool,
                                     dif_usbdev_buffer_t *buffer, uint8_t *dst,
@@ -482,36 +529,23 @@ dif_result_t dif_usbdev_buffer_read(const dif_usbdev_t *usbdev,
     return kDifBadArg;
   }
 
+  dif_usbdev_buffer_span_t span;
+  DIF_RETURN_IF_ERROR(dif_usbdev_buffer_span_get(usbdev, buffer, &span));
+
   // bytes_to_copy is the minimum of remaining_bytes and dst_len
-  size_t bytes_to_copy = buffer->remaining_bytes;
+  size_t bytes_to_copy = span.len;
   if (bytes_to_copy > dst_len) {
     bytes_to_copy = dst_len;
   }
   // Copy from buffer to dst
-  const uint32_t buffer_addr = get_buffer_addr(buffer->id, buffer->offset);
-  mmio_region_memcpy_from_mmio32(usbdev->base_addr, buffer_addr, dst,
-                                 bytes_to_copy);
-  // Update buffer state
-  buffer->offset += bytes_to_copy;
-  buffer->remaining_bytes -= bytes_to_copy;
+  mmio_region_memcpy_from_mmio32(span.region, span.offset, dst, bytes_to_copy);
 
   if (bytes_written != NULL) {
     *bytes_written = bytes_to_copy;
   }
 
-  // Check if there are any remaining bytes
-  if (buffer->remaining_bytes > 0) {
-    return kDifOk;
-  }
-
-  // Return the buffer to the free buffer pool
-  if (!buffer_pool_add(buffer_pool, buffer->id)) {
-    return kDifError;
-  }
-
-  // Mark the buffer as stale
-  buffer->type = kDifUsbdevBufferTypeStale;
-  return kDifOk;
+  return dif_usbdev_buffer_span_commit(usbdev, buffer_pool, buffer,
+                                       bytes_to_copy);
 }
 
 dif_result_t dif_usbdev_buffer_write(const dif_usbdev_t *usbdev,
@@ -523,16 +557,17 @@ dif_result_t dif_usbdev_buffer_write(const dif_usbdev_t *usbdev,
     return kDifBadArg;
   }
 
+  dif_usbdev_buffer_span_t span;
+  DIF_RETURN_IF_ERROR(dif_usbdev_buffer_span_get(usbdev, buffer, &span));
+
   // bytes_to_copy is the minimum of remaining_bytes and src_len.
-  size_t bytes_to_copy = buffer->remaining_bytes;
+  size_t bytes_to_copy = span.len;
   if (bytes_to_copy > src_len) {
     bytes_to_copy = src_len;
   }
 
   // Write bytes to the buffer
-  uint32_t buffer_addr = get_buffer_addr(buffer->id, buffer->offset);
-  mmio_region_memcpy_to_mmio32(usbdev->base_addr, buffer_addr, src,
-                               bytes_to_copy);
+  mmio_region_memcpy_to_mmio32(span.region, span.offset, src, bytes_to_copy);
 
   buffer->offset += bytes_to_copy;
   buffer->remaining_bytes -= bytes_to_copy;
@@ -480,6 +480,76 @@ dif_result_t dif_usbdev_buffer_write(const dif_usbdev_t *usbdev,
                                      const uint8_t *src, size_t src_len,
                                      size_t *bytes_written);
 
+/**
+ * A view of the unread or unwritten part of a USB device buffer.
+ *
+ * The view describes where the payload lives in the packet buffer memory of the
+ * USB device, so that clients can produce or consume it in place using word
+ * accesses (e.g. `mmio_region_read32`/`mmio_region_write32`) instead of
+ * staging it in a separate buffer.
+ */
+typedef struct dif_usbdev_buffer_span {
+  /**
+   * Region that holds the packet buffer memory.
+   */
+  mmio_region_t region;
+  /**
+   * Byte offset into `region` of the next byte to read or write. This is word
+   * aligned unless the buffer was previously advanced by a number of bytes that
+   * is not a multiple of the word size.
+   */
+  uint32_t offset;
+  /**
+   * For read buffers: remaining number of bytes to read.
+   * For write buffers: remaining number of bytes that can be written.
+   */
+  size_t len;
+} dif_usbdev_buffer_span_t;
+
+/**
+ * Get a view of the payload memory of a buffer.
+ *
+ * This provides zero-copy access to a buffer obtained from `dif_usbdev_recv` or
+ * `dif_usbdev_buffer_request`. After accessing the payload memory directly,
+ * clients must call `dif_usbdev_buffer_span_commit` with the number of bytes
+ * consumed or produced.
+ *
+ * See also: `dif_usbdev_buffer_span_commit`.
+ *
+ * @param usbdev A USB device.
+ * @param buffer A buffer provided by `dif_usbdev_recv` or
+ *               `dif_usbdev_buffer_request`.
+ * @param[out] span View of the payload memory of the buffer.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_usbdev_buffer_span_get(const dif_usbdev_t *usbdev,
+                                        const dif_usbdev_buffer_t *buffer,
+                                        dif_usbdev_buffer_span_t *span);
+
+/**
+ * Commit bytes read from or written to a buffer through a span.
+ *
+ * Advances the buffer past `len` bytes. For read buffers, the buffer is
+ * returned to the free buffer pool once the entire packet payload has been
+ * consumed, as with `dif_usbdev_buffer_read`. For write buffers, the committed
+ * bytes become part of the packet that is queued by `dif_usbdev_send`.
+ *
+ * See also: `dif_usbdev_buffer_span_get`.
+ *
+ * @param usbdev A USB device.
+ * @param buffer_pool A USB device buffer pool.
+ * @param buffer A buffer provided by `dif_usbdev_recv` or
+ *               `dif_usbdev_buffer_request`.
+ * @param len Number of bytes consumed or produced; must not exceed the length
+ *            of the span.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_usbdev_buffer_span_commit(
+    const dif_usbdev_t *usbdev, dif_usbdev_buffer_pool_t *buffer_pool,
+    dif_usbdev_buffer_t *buffer, size_t len);
+
 /**
  * Mark a packet ready for transmission from an endpoint.
  *
@@ -32,6 +32,7 @@ TEST_F(UsbdevTest, NullArgsTest) {
   bool bool_arg, bool_arg2;
   dif_usbdev_rx_packet_info_t packet_info;
   dif_usbdev_buffer_t buffer;
+  dif_usbdev_buffer_span_t span;
   uint8_t uint8_arg, uint8_arg2;
   size_t size_arg;
   dif_usbdev_endpoint_id_t endpoint_id;
@@ -88,6 +89,15 @@ TEST_F(UsbdevTest, NullArgsTest) {
                                             /*src_len=*/1, &size_arg));
   EXPECT_DIF_BADARG(dif_usbdev_buffer_write(&usbdev_, &buffer, nullptr,
                                             /*src_len=*/1, &size_arg));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_span_get(nullptr, &buffer, &span));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_span_get(&usbdev_, nullptr, &span));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_span_get(&usbdev_, &buffer, nullptr));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_span_commit(nullptr, &buffer_pool,
+                                                  &buffer, /*len=*/0));
+  EXPECT_DIF_BADARG(
+      dif_usbdev_buffer_span_commit(&usbdev_, nullptr, &buffer, /*len=*/0));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_span_commit(&usbdev_, &buffer_pool,
+                                                  nullptr, /*len=*/0));
   EXPECT_DIF_BADARG(dif_usbdev_buffer_write(&usbdev_, &buffer, &uint8_arg,
                                             /*src_len=*/1, nullptr));
   EXPECT_DIF_BADARG(dif_usbdev_send(nullptr, /*endpoint=*/0, &buffer));
@@ -820,6 +830,91 @@ TEST_F(UsbdevTest, InPacket) {
       dif_usbdev_clear_tx_status(&usbdev_, &buffer_pool, /*endpoint=*/5));
 }
 
+TEST_F(UsbdevTest, BufferSpan) {
+  dif_usbdev_buffer_pool_t buffer_pool;
+  dif_usbdev_config_t phy_config = {
+      .have_differential_receiver = kDifToggleEnabled,
+      .use_tx_d_se0 = kDifToggleDisabled,
+      .single_bit_eop = kDifToggleDisabled,
+      .pin_flip = kDifToggleDisabled,
+      .clock_sync_signals = kDifToggleEnabled,
+  };
+  EXPECT_WRITE32(USBDEV_PHY_CONFIG_REG_OFFSET,
+                 {
+                     {USBDEV_PHY_CONFIG_USE_DIFF_RCVR_BIT, 1},
+                     {USBDEV_PHY_CONFIG_TX_USE_D_SE0_BIT, 0},
+                     {USBDEV_PHY_CONFIG_EOP_SINGLE_BIT_BIT, 0},
+                     {USBDEV_PHY_CONFIG_PINFLIP_BIT, 0},
+                     {USBDEV_PHY_CONFIG_USB_REF_DISABLE_BIT, 0},
+                 });
+  EXPECT_DIF_OK(dif_usbdev_configure(&usbdev_, &buffer_pool, phy_config));
+
+  // Produce the payload of an outgoing packet in place.
+  dif_usbdev_buffer_t buffer;
+  EXPECT_DIF_OK(dif_usbdev_buffer_request(&usbdev_, &buffer_pool, &buffer));
+  const uint32_t buffer_addr = USBDEV_BUFFER_REG_OFFSET + buffer.id * 64;
+  dif_usbdev_buffer_span_t span;
+  EXPECT_DIF_OK(dif_usbdev_buffer_span_get(&usbdev_, &buffer, &span));
+  EXPECT_EQ(span.offset, buffer_addr);
+  EXPECT_EQ(span.len, 64);
+
+  EXPECT_WRITE32(buffer_addr, 0x03020100);
+  EXPECT_WRITE32(buffer_addr + 4, 0x07060504);
+  mmio_region_write32(span.region, span.offset, 0x03020100);
+  mmio_region_write32(span.region, span.offset + 4, 0x07060504);
+  EXPECT_DIF_OK(
+      dif_usbdev_buffer_span_commit(&usbdev_, &buffer_pool, &buffer, 8));
+  EXPECT_EQ(buffer.type, kDifUsbdevBufferTypeWrite);
+
+  EXPECT_DIF_OK(dif_usbdev_buffer_span_get(&usbdev_, &buffer, &span));
+  EXPECT_EQ(span.offset, buffer_addr + 8);
+  EXPECT_EQ(span.len, 56);
+  // Can't commit more than the span holds.
+  EXPECT_DIF_BADARG(
+      dif_usbdev_buffer_span_commit(&usbdev_, &buffer_pool, &buffer, 57));
+
+  // Only the committed bytes are sent.
+  EXPECT_WRITE32(USBDEV_CONFIGIN_1_REG_OFFSET,
+                 {
+                     {USBDEV_CONFIGIN_1_BUFFER_1_OFFSET, buffer.id},
+                     {USBDEV_CONFIGIN_1_SIZE_1_OFFSET, 8},
+                 });
+  EXPECT_WRITE32(USBDEV_CONFIGIN_1_REG_OFFSET,
+                 {
+                     {USBDEV_CONFIGIN_1_BUFFER_1_OFFSET, buffer.id},
+                     {USBDEV_CONFIGIN_1_SIZE_1_OFFSET, 8},
+                     {USBDEV_CONFIGIN_1_RDY_1_BIT, 1},
+                 });
+  EXPECT_DIF_OK(dif_usbdev_send(&usbdev_, /*endpoint=*/1, &buffer));
+  // Can't access a stale buffer.
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_span_get(&usbdev_, &buffer, &span));
+  EXPECT_DIF_BADARG(
+      dif_usbdev_buffer_span_commit(&usbdev_, &buffer_pool, &buffer, 0));
+
+  // Consume the payload of an incoming packet in place; the buffer returns to
+  // the pool once the whole payload has been committed.
+  int top = buffer_pool.top;
+  dif_usbdev_buffer_t rx_buffer = {
+      .id = buffer.id,
+      .offset = 0,
+      .remaining_bytes = 8,
+      .type = kDifUsbdevBufferTypeRead,
+  };
+  EXPECT_DIF_OK(dif_usbdev_buffer_span_get(&usbdev_, &rx_buffer, &span));
+  EXPECT_EQ(span.offset, buffer_addr);
+  EXPECT_EQ(span.len, 8);
+  EXPECT_READ32(buffer_addr, 0x03020100);
+  EXPECT_EQ(mmio_region_read32(span.region, span.offset), 0x03020100);
+  EXPECT_DIF_OK(
+      dif_usbdev_buffer_span_commit(&usbdev_, &buffer_pool, &rx_buffer, 4));
+  EXPECT_EQ(rx_buffer.type, kDifUsbdevBufferTypeRead);
+  EXPECT_EQ(buffer_pool.top, top);
+  EXPECT_DIF_OK(
+      dif_usbdev_buffer_span_commit(&usbdev_, &buffer_pool, &rx_buffer, 4));
+  EXPECT_EQ(rx_buffer.type, kDifUsbdevBufferTypeStale);
+  EXPECT_EQ(buffer_pool.top, top + 1);
+}
+
 TEST_F(UsbdevTest, DeviceAddresses) {
   uint8_t address = 101;
   EXPECT_READ32(USBDEV_USBCTRL_REG_OFFSET,
@@ -20,6 +20,46 @@
 static_assert(sizeof(log_fields_t) == 20,
               "log_fields_t must always be 20 bytes.");
 
+/**
+ * The current log mode.
+ */
+static log_mode_t log_mode;
+
+void base_log_set_mode(log_mode_t mode) { log_mode = mode; }
+
+/**
+ * Writes `log` and the `nargs` values in `args` to stdout as a binary record,
+ * as described in `log.h`.
+ *
+ * The record is written with a single call to the sink.
+ *
+ * @param log the log data to log.
+ * @param args format parameters matching the format string.
+ */
+static void log_binary(const log_fields_t *log, va_list args) {
+  enum {
+    kHeaderSize = 6,
+    kMaxArgs = 31,
+  };
+  uint8_t record[kHeaderSize + kMaxArgs * sizeof(uint32_t)];
+  uint32_t id = (uint32_t)(uintptr_t)log;
+  uint32_t nargs = log->nargs < kMaxArgs ? log->nargs : kMaxArgs;
+
+  record[0] = kLogBinaryMarker;
+  for (size_t i = 0; i < sizeof(id); ++i) {
+    record[1 + i] = (uint8_t)(id >> (i * 8));
+  }
+  record[5] = (uint8_t)nargs;
+  uint8_t *next = &record[kHeaderSize];
+  for (uint32_t i = 0; i < nargs; ++i) {
+    uint32_t arg = va_arg(args, uint32_t);
+    for (size_t j = 0; j < sizeof(arg); ++j) {
+      *next++ = (uint8_t)(arg >> (j * 8));
+    }
+  }
+  base_printf("%!s", (size_t)(next - record), (const char *)record);
+}
+
 /**
  * Converts a severity to a static string.
  */
@@ -45,6 +85,14 @@ static const char *stringify_severity(log_severity_t severity) {
  * @param ... format parameters matching the format string.
  */
 void base_log_internal_core(const log_fields_t *log, ...) {
+  if (log_mode == kLogModeBinary) {
+    va_list args;
+    va_start(args, log);
+    log_binary(log, args);
+    va_end(args);
+    return;
+  }
+
   size_t file_name_len =
       (size_t)(((const char *)memchr(log->file_name, '\0', PTRDIFF_MAX)) -
                log->file_name);
@@ -36,6 +36,10 @@
  * in print.h. DV testbenches may use an alternative, more efficient mechanism.
  *
  * In DV mode, some format specifiers may be unsupported, such as %s.
+ *
+ * On other devices, logs can also be written to `stdout` in a compact binary
+ * form instead of as text (see `base_log_set_mode()`), leaving the formatting
+ * to the host.
  */
 
 /**
@@ -87,6 +91,50 @@ typedef struct log_fields {
   const char *format;
 } log_fields_t;
 
+/**
+ * The ways in which `base_log_internal_core()` can write logs to `stdout`.
+ */
+typedef enum log_mode {
+  /**
+   * Logs are formatted on the device and written as lines of text.
+   */
+  kLogModeText = 0,
+  /**
+   * Logs are written as binary records, which hold the address of their
+   * `log_fields_t` and the raw arguments, and must be decoded on the host
+   * with the ELF file of the program, for example with
+   * util/device_sw_utils/decode_binary_logs.py.
+   *
+   * Each record is:
+   * - `kLogBinaryMarker` (one byte),
+   * - the address of the `log_fields_t` (four bytes, little-endian),
+   * - the number of arguments, `nargs` (one byte), and
+   * - each argument, as a 32-bit little-endian word.
+   *
+   * The marker can't occur in ASCII or UTF-8 text, so records can be mixed
+   * with other output to `stdout`. Arguments that are pointers, such as those
+   * of %s, can only be decoded if they point into the ELF file.
+   */
+  kLogModeBinary,
+} log_mode_t;
+
+enum {
+  /**
+   * The first byte of each binary log record.
+   */
+  kLogBinaryMarker = 0xfe,
+};
+
+/**
+ * Sets how logs are written to `stdout`.
+ *
+ * This has no effect on DV testbenches, which always use their own
+ * mechanism. The default is `kLogModeText`.
+ *
+ * @param mode the new log mode.
+ */
+void base_log_set_mode(log_mode_t mode);
+
 // Internal functions exposed only for access by macros. Their
 // real doxygen can be found in log.c.
 /**
@@ -65,12 +65,95 @@ static buffer_sink_t base_stdout = {
 };
 
 void base_set_stdout(buffer_sink_t out) {
+  // Don't lose what is still buffered for the old stdout.
+  base_flush();
   if (out.sink == NULL) {
     out.sink = &base_dev_null;
   }
   base_stdout = out;
 }
 
+static size_t buffered_sink_threshold(const base_buffered_sink_t *buffered) {
+  if (buffered->threshold == 0 || buffered->threshold > buffered->size) {
+    return buffered->size;
+  }
+  return buffered->threshold;
+}
+
+size_t base_buffered_sink_flush(base_buffered_sink_t *buffered) {
+  size_t len = buffered->len;
+  buffered->len = 0;
+  if (len == 0) {
+    return 0;
+  }
+  if (buffered->out.sink == NULL) {
+    return len;
+  }
+  return buffered->out.sink(buffered->out.data, buffered->buf, len);
+}
+
+static size_t buffered_sink_write(void *data, const char *buf, size_t len) {
+  base_buffered_sink_t *buffered = (base_buffered_sink_t *)data;
+  size_t threshold = buffered_sink_threshold(buffered);
+  size_t lost = 0;
+  size_t written = 0;
+  while (written < len) {
+    const char *chunk = buf + written;
+    size_t chunk_len = len - written;
+
+    // Nothing is waiting to go out before this, so pass it on as it is.
+    if (buffered->len == 0 && chunk_len >= threshold) {
+      size_t sent = buffered->out.sink == NULL
+                        ? chunk_len
+                        : buffered->out.sink(buffered->out.data, chunk,
+                                             chunk_len);
+      lost += chunk_len - sent;
+      break;
+    }
+
+    size_t space = buffered->size - buffered->len;
+    if (chunk_len > space) {
+      chunk_len = space;
+    }
+
+    // Stop after the last newline in the chunk, so that the line is passed
+    // on as soon as it is complete.
+    bool flush = false;
+    if (buffered->flush_on_newline) {
+      for (size_t i = chunk_len; i > 0; --i) {
+        if (chunk[i - 1] == '\n') {
+          chunk_len = i;
+          flush = true;
+          break;
+        }
+      }
+    }
+
+    memcpy(buffered->buf + buffered->len, chunk, chunk_len);
+    buffered->len += chunk_len;
+    written += chunk_len;
+
+    if (flush || buffered->len >= threshold) {
+      size_t pending = buffered->len;
+      lost += pending - base_buffered_sink_flush(buffered);
+    }
+  }
+  return lost < len ? len - lost : 0;
+}
+
+buffer_sink_t base_buffered_sink(base_buffered_sink_t *buffered) {
+  return (buffer_sink_t){
+      .data = buffered,
+      .sink = &buffered_sink_write,
+  };
+}
+
+void base_flush(void) {
+  if (base_stdout.sink == &buffered_sink_write) {
+    base_buffered_sink_flush((base_buffered_sink_t *)base_stdout.data);
+  }
+}
+
 static const size_t kSpiDeviceReadBufferSizeBytes =
     SPI_DEVICE_PARAM_SRAM_READ_BUFFER_DEPTH * sizeof(uint32_t);
 static const size_t kSpiDeviceFrameHeaderSizeBytes = 12;
@@ -135,6 +218,10 @@ static size_t spi_device_send_frame(void *data, const char *buf, size_t len) {
   uint8_t frame_header_bytes[kSpiDeviceFrameHeaderSizeBytes];
 
   static uint32_t next_write_address = 0;
+  // The free space in the buffer, as of the last time the read address was
+  // checked, less what has been written since. The host only ever frees more
+  // space, so the read address only needs checking when this isn't enough.
+  static uint32_t available_buffer_size = 0;
 
   if (frame_size_bytes >= kSpiDeviceReadBufferSizeBytes) {
     return 0;
@@ -153,8 +240,8 @@ static size_t spi_device_send_frame(void *data, const char *buf, size_t len) {
     frame_header_bytes[i + 8] = (len >> (i * 8)) & 0xff;
   }
 
-  uint32_t available_buffer_size = 0;
-  do {
+  while ((frame_size_bytes + kSpiDeviceBufferPreservedSizeBytes) >
+         available_buffer_size) {
     uint32_t last_read_address = 0;
     if (dif_spi_device_get_last_read_address(spi_device, &last_read_address) !=
         kDifOk) {
@@ -182,8 +269,7 @@ static size_t spi_device_send_frame(void *data, const char *buf, size_t len) {
           next_read_address +
           (kSpiDeviceReadBufferSizeBytes - next_write_address) - 1;
     }
-  } while ((frame_size_bytes + kSpiDeviceBufferPreservedSizeBytes) >
-           available_buffer_size);
+  }
 
   // Send aligned data.
   size_t data_write_address =
@@ -219,6 +305,7 @@ static size_t spi_device_send_frame(void *data, const char *buf, size_t len) {
 
   next_write_address =
       (next_write_address + frame_size_bytes) % kSpiDeviceReadBufferSizeBytes;
+  available_buffer_size -= frame_size_bytes;
   spi_device_frame_num++;
 
   return len;
@@ -246,10 +333,24 @@ sink_func_ptr get_spi_device_sink(void) { return &base_dev_spi_device; }
 
 static size_t base_dev_uart(void *data, const char *buf, size_t len) {
   const dif_uart_t *uart = (const dif_uart_t *)data;
-  for (size_t i = 0; i < len; ++i) {
-    if (dif_uart_byte_send_polled(uart, (uint8_t)buf[i]) != kDifOk) {
-      return i;
-    }
+  if (len == 0) {
+    return 0;
+  }
+
+  // Keep the TX FIFO topped up rather than waiting for the UART to go idle
+  // after every byte, as `dif_uart_byte_send_polled()` does. Only the last
+  // byte is sent with it, so that everything has gone out on return.
+  size_t sent = 0;
+  while (sent < len - 1) {
+    size_t fifo_written = 0;
+    if (dif_uart_bytes_send(uart, (const uint8_t *)buf + sent, len - 1 - sent,
+                            &fifo_written) != kDifOk) {
+      return sent;
+    }
+    sent += fifo_written;
+  }
+  if (dif_uart_byte_send_polled(uart, (uint8_t)buf[sent]) != kDifOk) {
+    return sent;
   }
   return len;
 }
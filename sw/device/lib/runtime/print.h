@@ -6,6 +6,7 @@
 #define OPENTITAN_SW_DEVICE_LIB_RUNTIME_PRINT_H_
 
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 #include "sw/device/lib/dif/dif_spi_device.h"
@@ -48,6 +49,85 @@ typedef struct buffer_sink {
   sink_func_ptr sink;
 } buffer_sink_t;
 
+/**
+ * A buffered sink, which collects the bytes written to it and passes them on
+ * to another sink in large pieces.
+ *
+ * `base_vfprintf()` writes each run of literal text and each formatted value
+ * separately, so without buffering a single `LOG_INFO()` line turns into many
+ * small writes to the hardware. A buffered sink turns those into one write
+ * per line (or fewer), which matters for sinks with a high per-write cost,
+ * such as the SPI device console, which sends a frame for each write.
+ *
+ * The buffered bytes are passed on when:
+ * - a '\n' is written and `flush_on_newline` is set,
+ * - at least `threshold` bytes have been buffered, or
+ * - `base_buffered_sink_flush()` (or `base_flush()`, for stdout) is called.
+ *
+ * A write that would fill an empty buffer past `threshold` is passed on
+ * directly, without being copied into the buffer first.
+ *
+ * The buffer is provided by the user, and the struct should be initialized
+ * with `len` set to zero.
+ */
+typedef struct base_buffered_sink {
+  /**
+   * The sink that buffered bytes are passed on to.
+   */
+  buffer_sink_t out;
+  /**
+   * Storage for the buffered bytes.
+   */
+  char *buf;
+  /**
+   * The size of `buf`, in bytes.
+   */
+  size_t size;
+  /**
+   * The number of bytes in `buf` that have not been passed on yet.
+   */
+  size_t len;
+  /**
+   * The number of buffered bytes at which they are passed on. Zero, or a
+   * value greater than `size`, means `size`.
+   */
+  size_t threshold;
+  /**
+   * Whether to pass on the buffered bytes at the end of every line.
+   */
+  bool flush_on_newline;
+} base_buffered_sink_t;
+
+/**
+ * Returns a sink that writes to `buffered`.
+ *
+ * `buffered` must outlive the returned sink.
+ *
+ * @param buffered the buffered sink to write to.
+ * @return a sink for use with `base_fprintf()` or `base_set_stdout()`.
+ */
+buffer_sink_t base_buffered_sink(base_buffered_sink_t *buffered);
+
+/**
+ * Passes all of the bytes buffered in `buffered` on to its sink.
+ *
+ * If the sink does not take all of them, the rest are dropped, so that the
+ * buffer is always empty afterwards.
+ *
+ * @param buffered the buffered sink to flush.
+ * @return the number of bytes that the sink took.
+ */
+size_t base_buffered_sink_flush(base_buffered_sink_t *buffered);
+
+/**
+ * Flushes stdout, if it is a buffered sink (see `base_buffered_sink()`).
+ *
+ * This should be called before anything that depends on all of the output so
+ * far having been written, such as waiting for input, reporting the test
+ * status or resetting the chip.
+ */
+void base_flush(void);
+
 /**
  * Returns a function pointer to the spi device sink function.
  */
@@ -10,6 +10,7 @@ extern "C" {
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_format.h"
 #include "gmock/gmock.h"
@@ -22,10 +23,20 @@ extern "C" {
 extern "C" dif_result_t dif_uart_byte_send_polled(const dif_uart *, uint8_t) {
   return kDifOk;
 }
+extern "C" dif_result_t dif_uart_bytes_send(const dif_uart *, const uint8_t *,
+                                           size_t bytes_requested,
+                                           size_t *bytes_written) {
+  if (bytes_written != nullptr) {
+    *bytes_written = bytes_requested;
+  }
+  return kDifOk;
+}
 
 namespace base {
 namespace {
 
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
 using ::testing::StartsWith;
 
 // A test fixture for automatiocally capturing stdout.
@@ -398,5 +409,118 @@ TEST(SnprintfTest, PartialWrite) {
   EXPECT_EQ(buf, "2 + 8 == 10, als");
 }
 
+// A test fixture for a buffered sink, which records each write that reaches
+// the underlying sink.
+class BufferedSinkTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    buffered_ = {
+        .out =
+            {
+                .data = static_cast<void *>(&writes_),
+                .sink =
+                    +[](void *data, const char *buf, size_t len) {
+                      auto *writes =
+                          static_cast<std::vector<std::string> *>(data);
+                      writes->emplace_back(buf, len);
+                      return len;
+                    },
+            },
+        .buf = storage_,
+        .size = sizeof(storage_),
+        .len = 0,
+        .threshold = 0,
+        .flush_on_newline = true,
+    };
+  }
+
+  // Don't leave stdout pointing at this fixture.
+  void TearDown() override { base_set_stdout({}); }
+
+  char storage_[32];
+  base_buffered_sink_t buffered_;
+  std::vector<std::string> writes_;
+};
+
+TEST_F(BufferedSinkTest, OneWritePerLine) {
+  buffer_sink_t out = base_buffered_sink(&buffered_);
+  EXPECT_EQ(base_fprintf(out, "%d + %d == %d\n", 2, 8, 2 + 8), 12);
+  EXPECT_EQ(base_fprintf(out, "0x%x\n", 10), 4);
+  EXPECT_THAT(writes_, ElementsAre("2 + 8 == 10\n", "0xa\n"));
+}
+
+TEST_F(BufferedSinkTest, PartialLineWaitsForFlush) {
+  buffer_sink_t out = base_buffered_sink(&buffered_);
+  base_fprintf(out, "a%cb\nc", '-');
+  EXPECT_THAT(writes_, ElementsAre("a-b\n"));
+  base_fprintf(out, "%d", 42);
+  EXPECT_THAT(writes_, ElementsAre("a-b\n"));
+  EXPECT_EQ(base_buffered_sink_flush(&buffered_), 3);
+  EXPECT_THAT(writes_, ElementsAre("a-b\n", "c42"));
+  EXPECT_EQ(base_buffered_sink_flush(&buffered_), 0);
+  EXPECT_EQ(writes_.size(), 2);
+}
+
+TEST_F(BufferedSinkTest, PacksLines) {
+  buffered_.flush_on_newline = false;
+  buffer_sink_t out = base_buffered_sink(&buffered_);
+  base_fprintf(out, "one\n");
+  base_fprintf(out, "two\n");
+  EXPECT_THAT(writes_, IsEmpty());
+  base_buffered_sink_flush(&buffered_);
+  EXPECT_THAT(writes_, ElementsAre("one\ntwo\n"));
+}
+
+TEST_F(BufferedSinkTest, Threshold) {
+  buffered_.flush_on_newline = false;
+  buffered_.threshold = 8;
+  buffer_sink_t out = base_buffered_sink(&buffered_);
+  base_fprintf(out, "%s", "0123");
+  EXPECT_THAT(writes_, IsEmpty());
+  base_fprintf(out, "%s", "4567abc");
+  EXPECT_THAT(writes_, ElementsAre("01234567abc"));
+}
+
+TEST_F(BufferedSinkTest, FullBuffer) {
+  buffered_.flush_on_newline = false;
+  buffer_sink_t out = base_buffered_sink(&buffered_);
+  std::string text(40, 'x');
+  base_fprintf(out, "-");
+  EXPECT_EQ(base_fprintf(out, "%!s", text.size(), text.data()), text.size());
+  base_buffered_sink_flush(&buffered_);
+  EXPECT_THAT(writes_,
+              ElementsAre("-" + text.substr(0, 31), text.substr(31)));
+}
+
+TEST_F(BufferedSinkTest, LargeWritesPassThrough) {
+  buffer_sink_t out = base_buffered_sink(&buffered_);
+  std::string text(sizeof(storage_), 'y');
+  base_fprintf(out, "%!s", text.size(), text.data());
+  EXPECT_THAT(writes_, ElementsAre(text));
+}
+
+TEST_F(BufferedSinkTest, ShortWrite) {
+  buffered_.out.sink = +[](void *data, const char *buf, size_t len) {
+    return len / 2;
+  };
+  buffer_sink_t out = base_buffered_sink(&buffered_);
+  EXPECT_EQ(base_fprintf(out, "abcd\n"), 2);
+  EXPECT_EQ(buffered_.len, 0);
+}
+
+TEST_F(BufferedSinkTest, Stdout) {
+  base_set_stdout(base_buffered_sink(&buffered_));
+  base_printf("Hello, ");
+  base_printf("%s", "World!");
+  EXPECT_THAT(writes_, IsEmpty());
+  base_flush();
+  EXPECT_THAT(writes_, ElementsAre("Hello, World!"));
+
+  // Replacing stdout flushes it.
+  base_printf("Bye");
+  base_set_stdout({});
+  EXPECT_THAT(writes_, ElementsAre("Hello, World!", "Bye"));
+}
+
 }  // namespace
 }  // namespace base
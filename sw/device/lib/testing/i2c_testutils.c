@@ -25,6 +25,11 @@
 enum {
   kI2cWrite = 0,
   kI2cRead = 1,
+  // The largest read a single FMT FIFO entry can request; encoded as 0.
+  kI2cMaxReadChunk = 256,
+  // FIFO levels at which the threshold interrupts of a transfer fire.
+  kI2cTransferFmtThreshold = I2C_PARAM_FIFO_DEPTH / 2,
+  kI2cTransferRxThreshold = I2C_PARAM_FIFO_DEPTH / 2,
 };
 
 // Default flags for i2c operations.
@@ -443,3 +448,174 @@ status_t i2c_testutils_wait_transaction_finish(const dif_i2c_t *i2c) {
   } while (!status.fmt_fifo_empty);
   return OK_STATUS(0);
 }
+
+/**
+ * Computes the FMT FIFO entry at `index` of a transfer.
+ */
+static void transfer_fmt_entry(const i2c_testutils_transfer_t *xfer,
+                               size_t index, uint8_t *byte,
+                               dif_i2c_fmt_flags_t *flags) {
+  *flags = kDefaultFlags;
+  if (xfer->tx_len > 0) {
+    if (index == 0) {
+      flags->start = true;
+      *byte = (uint8_t)(xfer->addr << 1) | (uint8_t)kI2cWrite;
+      return;
+    }
+    if (index <= xfer->tx_len) {
+      flags->stop = index == xfer->tx_len && xfer->rx_len == 0;
+      *byte = xfer->tx_data[index - 1];
+      return;
+    }
+    index -= xfer->tx_len + 1;
+  }
+  if (index == 0) {
+    flags->start = true;
+    *byte = (uint8_t)(xfer->addr << 1) | (uint8_t)kI2cRead;
+    return;
+  }
+  size_t offset = (index - 1) * kI2cMaxReadChunk;
+  size_t chunk = xfer->rx_len - offset;
+  flags->read = true;
+  if (chunk > kI2cMaxReadChunk) {
+    chunk = kI2cMaxReadChunk;
+    flags->read_cont = true;
+  } else {
+    flags->stop = true;
+  }
+  // A count of 256 is encoded as 0.
+  *byte = (uint8_t)chunk;
+}
+
+status_t i2c_testutils_transfer_start(const dif_i2c_t *i2c,
+                                      i2c_testutils_transfer_t *xfer,
+                                      bool irq_driven) {
+  TRY_CHECK(i2c != NULL && xfer != NULL);
+  TRY_CHECK(xfer->tx_len > 0 || xfer->rx_len > 0);
+  TRY_CHECK(xfer->tx_len == 0 || xfer->tx_data != NULL);
+  TRY_CHECK(xfer->rx_len == 0 || xfer->rx_data != NULL);
+
+  xfer->fmt_total = 0;
+  if (xfer->tx_len > 0) {
+    xfer->fmt_total += 1 + xfer->tx_len;
+  }
+  if (xfer->rx_len > 0) {
+    xfer->fmt_total +=
+        1 + (xfer->rx_len + kI2cMaxReadChunk - 1) / kI2cMaxReadChunk;
+  }
+  xfer->fmt_queued = 0;
+  xfer->rx_received = 0;
+  xfer->halted = false;
+  xfer->done = false;
+
+  dif_i2c_controller_halt_events_t halt_events = {0};
+  TRY(dif_i2c_get_controller_halt_events(i2c, &halt_events));
+  TRY(dif_i2c_clear_controller_halt_events(i2c, halt_events));
+  TRY(dif_i2c_irq_acknowledge(i2c, kDifI2cIrqCmdComplete));
+
+  TRY(i2c_testutils_transfer_service(i2c, xfer));
+
+  if (irq_driven) {
+    TRY(dif_i2c_set_host_watermarks(i2c, kI2cTransferRxThreshold,
+                                    kI2cTransferFmtThreshold));
+    TRY(dif_i2c_irq_set_enabled(
+        i2c, kDifI2cIrqFmtThreshold,
+        dif_bool_to_toggle(xfer->fmt_queued < xfer->fmt_total)));
+    TRY(dif_i2c_irq_set_enabled(i2c, kDifI2cIrqRxThreshold,
+                                dif_bool_to_toggle(xfer->rx_len > 0)));
+    TRY(dif_i2c_irq_set_enabled(i2c, kDifI2cIrqCmdComplete,
+                                kDifToggleEnabled));
+    TRY(dif_i2c_irq_set_enabled(i2c, kDifI2cIrqControllerHalt,
+                                kDifToggleEnabled));
+  }
+  return OK_STATUS();
+}
+
+status_t i2c_testutils_transfer_service(const dif_i2c_t *i2c,
+                                        i2c_testutils_transfer_t *xfer) {
+  TRY_CHECK(i2c != NULL && xfer != NULL);
+  if (xfer->done) {
+    return OK_STATUS(true);
+  }
+
+  bool controller_halted;
+  TRY(dif_i2c_irq_is_pending(i2c, kDifI2cIrqControllerHalt,
+                             &controller_halted));
+  if (controller_halted) {
+    // Flush what is left of the transfer and release the bus, as
+    // `i2c_testutils_issue_read()` does after a NAK.
+    dif_i2c_controller_halt_events_t halt_events = {0};
+    TRY(dif_i2c_get_controller_halt_events(i2c, &halt_events));
+    TRY(dif_i2c_reset_fmt_fifo(i2c));
+    TRY(dif_i2c_reset_rx_fifo(i2c));
+    TRY(dif_i2c_clear_controller_halt_events(i2c, halt_events));
+    TRY(dif_i2c_host_set_enabled(i2c, kDifToggleDisabled));
+    TRY(dif_i2c_host_set_enabled(i2c, kDifToggleEnabled));
+    xfer->halted = true;
+    xfer->done = true;
+    return OK_STATUS(true);
+  }
+
+  // A single level read tells how much can be queued and read back without
+  // polling again.
+  dif_i2c_level_t fmt_level, rx_level;
+  TRY(dif_i2c_get_fifo_levels(i2c, &fmt_level, &rx_level, NULL, NULL));
+
+  for (uint32_t space = I2C_PARAM_FIFO_DEPTH - fmt_level;
+       space > 0 && xfer->fmt_queued < xfer->fmt_total; --space) {
+    uint8_t byte;
+    dif_i2c_fmt_flags_t flags;
+    transfer_fmt_entry(xfer, xfer->fmt_queued, &byte, &flags);
+    TRY(dif_i2c_write_byte_raw(i2c, byte, flags));
+    ++xfer->fmt_queued;
+  }
+
+  for (; rx_level > 0 && xfer->rx_received < xfer->rx_len; --rx_level) {
+    TRY(dif_i2c_read_byte(i2c, &xfer->rx_data[xfer->rx_received]));
+    ++xfer->rx_received;
+  }
+
+  if (xfer->fmt_queued == xfer->fmt_total &&
+      xfer->rx_received == xfer->rx_len) {
+    dif_i2c_status_t status;
+    TRY(dif_i2c_get_status(i2c, &status));
+    xfer->done = status.fmt_fifo_empty && status.host_idle;
+  }
+  return OK_STATUS(xfer->done);
+}
+
+status_t i2c_testutils_transfer_isr(const dif_i2c_t *i2c,
+                                    i2c_testutils_transfer_t *xfer) {
+  TRY(dif_i2c_irq_acknowledge(i2c, kDifI2cIrqCmdComplete));
+  TRY(i2c_testutils_transfer_service(i2c, xfer));
+
+  // The threshold and halt interrupts are status interrupts: they stay
+  // asserted for as long as their condition holds, so they are disabled once
+  // there is nothing left for them to signal.
+  if (xfer->done || xfer->fmt_queued == xfer->fmt_total) {
+    TRY(dif_i2c_irq_set_enabled(i2c, kDifI2cIrqFmtThreshold,
+                                kDifToggleDisabled));
+  }
+  if (xfer->done) {
+    TRY(dif_i2c_irq_set_enabled(i2c, kDifI2cIrqRxThreshold,
+                                kDifToggleDisabled));
+    TRY(dif_i2c_irq_set_enabled(i2c, kDifI2cIrqCmdComplete,
+                                kDifToggleDisabled));
+    TRY(dif_i2c_irq_set_enabled(i2c, kDifI2cIrqControllerHalt,
+                                kDifToggleDisabled));
+  }
+  return OK_STATUS();
+}
+
+status_t i2c_testutils_transfer(const dif_i2c_t *i2c,
+                                i2c_testutils_transfer_t *xfer,
+                                size_t timeout) {
+  ibex_timeout_t timer = ibex_timeout_init(timeout);
+  TRY(i2c_testutils_transfer_start(i2c, xfer, /*irq_driven=*/false));
+  while (!TRY(i2c_testutils_transfer_service(i2c, xfer))) {
+    if (ibex_timeout_check(&timer)) {
+      return DEADLINE_EXCEEDED();
+    }
+  }
+  return OK_STATUS(xfer->halted);
+}
@@ -5,6 +5,8 @@
 #ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_I2C_TESTUTILS_H_
 #define OPENTITAN_SW_DEVICE_LIB_TESTING_I2C_TESTUTILS_H_
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "sw/device/lib/base/status.h"
@@ -253,4 +255,113 @@ status_t i2c_testutils_wait_host_idle(const dif_i2c_t *i2c);
  * where `halted` is 1 if the controller was halted and 0 if fmt_fifo was empty.
  */
 status_t i2c_testutils_wait_transaction_finish(const dif_i2c_t *i2c);
+
+/**
+ * A host transfer: an optional write followed by an optional read from the
+ * same device, joined by a repeated start.
+ *
+ * The caller fills in the public fields; the remaining fields are progress
+ * state owned by the `i2c_testutils_transfer_*()` functions.
+ */
+typedef struct i2c_testutils_transfer {
+  /**
+   * The device address.
+   */
+  uint8_t addr;
+  /**
+   * Bytes to write to the device; may be NULL if `tx_len` is zero.
+   */
+  const uint8_t *tx_data;
+  size_t tx_len;
+  /**
+   * Buffer for the bytes read from the device; may be NULL if `rx_len` is
+   * zero.
+   */
+  uint8_t *rx_data;
+  size_t rx_len;
+  /**
+   * Number of FMT FIFO entries the transfer consists of, and already queued.
+   */
+  size_t fmt_total;
+  size_t fmt_queued;
+  /**
+   * Number of bytes already read back into `rx_data`.
+   */
+  size_t rx_received;
+  /**
+   * Whether the controller halted, e.g. because the device NAKed.
+   */
+  volatile bool halted;
+  /**
+   * Whether the transfer has finished, successfully or not.
+   */
+  volatile bool done;
+} i2c_testutils_transfer_t;
+
+/**
+ * Starts a host transfer, filling the FMT FIFO with as much of the transfer as
+ * fits.
+ *
+ * The start, address, data, restart and stop entries are all prepared up
+ * front, so the FIFO is refilled in bursts rather than entry by entry.
+ *
+ * If `irq_driven` is set, the FMT threshold, RX threshold, command complete
+ * and controller halt interrupts are enabled; the caller must then call
+ * `i2c_testutils_transfer_isr()` from its I2C interrupt handler until `done`
+ * is set. Otherwise the caller should call `i2c_testutils_transfer_service()`
+ * until it returns true.
+ *
+ * @param i2c An I2C DIF handle.
+ * @param xfer The transfer to start.
+ * @param irq_driven Whether the transfer is to be driven by interrupts.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_testutils_transfer_start(const dif_i2c_t *i2c,
+                                      i2c_testutils_transfer_t *xfer,
+                                      bool irq_driven);
+
+/**
+ * Makes progress on a started transfer without blocking.
+ *
+ * Refills the FMT FIFO, reads back received bytes and detects the end of the
+ * transfer. If the controller halted, the FIFOs are flushed and the halt is
+ * cleared so the bus can be used again.
+ *
+ * @param i2c An I2C DIF handle.
+ * @param xfer The transfer.
+ * @return `kOk(done)` where `done` is true once the transfer has finished.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_testutils_transfer_service(const dif_i2c_t *i2c,
+                                        i2c_testutils_transfer_t *xfer);
+
+/**
+ * Services an interrupt-driven transfer from the I2C interrupt handler.
+ *
+ * Acknowledges the command complete interrupt and disables the threshold
+ * interrupts once they are no longer needed, as they would otherwise stay
+ * asserted.
+ *
+ * @param i2c An I2C DIF handle.
+ * @param xfer The transfer.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_testutils_transfer_isr(const dif_i2c_t *i2c,
+                                    i2c_testutils_transfer_t *xfer);
+
+/**
+ * Performs a host transfer by polling, returning once it has finished.
+ *
+ * @param i2c An I2C DIF handle.
+ * @param xfer The transfer to perform.
+ * @param timeout Timeout in microseconds.
+ * @return `kOk(halted)` where `halted` is true if the controller halted,
+ * e.g. because the device NAKed, or an error.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_testutils_transfer(const dif_i2c_t *i2c,
+                                i2c_testutils_transfer_t *xfer, size_t timeout);
+
 #endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_I2C_TESTUTILS_H_
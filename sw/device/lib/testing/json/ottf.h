@@ -16,6 +16,12 @@ extern "C" {
     field(crc, uint32_t)
 UJSON_SERDE_STRUCT(OttfCrc, ottf_crc_t, STRUCT_OTTF_CRC);
 
+// The formats that can be selected with `ujson_ottf_set_format()`.
+#define ENUM_OTTF_FORMAT(_, value) \
+    value(_, Json) \
+    value(_, Binary)
+UJSON_SERDE_ENUM(OttfFormat, ottf_format_t, ENUM_OTTF_FORMAT);
+
 #undef MODULE_ID
 
 // clang-format on
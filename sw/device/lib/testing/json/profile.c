@@ -0,0 +1,47 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#define UJSON_SERDE_IMPL 1
+#include "sw/device/lib/testing/json/profile.h"
+
+#include "sw/device/lib/base/math.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/test_framework/ujson_ottf.h"
+
+#define MODULE_ID MAKE_MODULE_ID('j', 's', 'f')
+
+static uint32_t mean32(uint64_t total, uint32_t count) {
+  return (uint32_t)udiv64_slow(total, count, NULL);
+}
+
+status_t profile_dump(ujson_t *uj) {
+  size_t num_regions = profile_region_count();
+  for (size_t i = 0; i < num_regions; ++i) {
+    const profile_region_stats_t *stats = profile_region_get(i);
+    profile_region_t resp = {
+        .index = (uint32_t)i,
+        .num_regions = (uint32_t)num_regions,
+        .depth = stats->depth,
+        .count = stats->count,
+    };
+    size_t len = 0;
+    while (stats->name[len] != '\0' && len < sizeof(resp.name) - 1) {
+      ++len;
+    }
+    memcpy(resp.name, stats->name, len);
+    if (stats->count != 0) {
+      resp.cycles_min = stats->cycles_min;
+      resp.cycles_max = stats->cycles_max;
+      resp.cycles_mean = udiv64_slow(stats->cycles_total, stats->count, NULL);
+      resp.instret_mean = mean32(stats->instret_total, stats->count);
+      resp.lsu_wait_mean = mean32(stats->lsu_wait_total, stats->count);
+      resp.ifetch_wait_mean = mean32(stats->ifetch_wait_total, stats->count);
+      resp.loads_mean = mean32(stats->loads_total, stats->count);
+      resp.stores_mean = mean32(stats->stores_total, stats->count);
+    }
+    TRY(RESP_OK(ujson_serialize_profile_region_t, uj, &resp));
+  }
+  return OK_STATUS();
+}
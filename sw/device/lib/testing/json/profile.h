@@ -0,0 +1,56 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_JSON_PROFILE_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_JSON_PROFILE_H_
+
+#include "sw/device/lib/ujson/ujson_derive.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+// clang-format off
+
+#define MODULE_ID MAKE_MODULE_ID('j', 'p', 'f')
+
+#define STRUCT_PROFILE_REGION(field, string) \
+    field(index, uint32_t) \
+    field(num_regions, uint32_t) \
+    string(name, 48) \
+    field(depth, uint32_t) \
+    field(count, uint32_t) \
+    field(cycles_min, uint64_t) \
+    field(cycles_max, uint64_t) \
+    field(cycles_mean, uint64_t) \
+    field(instret_mean, uint32_t) \
+    field(lsu_wait_mean, uint32_t) \
+    field(ifetch_wait_mean, uint32_t) \
+    field(loads_mean, uint32_t) \
+    field(stores_mean, uint32_t)
+UJSON_SERDE_STRUCT(ProfileRegion, profile_region_t, STRUCT_PROFILE_REGION);
+
+#ifndef RUST_PREPROCESSOR_EMIT
+
+/**
+ * Send the statistics of all the regions profiled with
+ * `profile_region_begin()` and `profile_region_end()`.
+ *
+ * Each region is sent as a `profile_region_t` response, in the order in which
+ * the regions were first begun; every response carries the total number of
+ * regions, so that the host knows how many to read. Nothing is sent if no
+ * region was profiled.
+ *
+ * @param uj A ujson IO context.
+ * @return The result of the operation.
+ */
+status_t profile_dump(ujson_t *uj);
+
+#endif
+
+#undef MODULE_ID
+
+// clang-format on
+#ifdef __cplusplus
+}
+#endif
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_JSON_PROFILE_H_
@@ -194,3 +194,68 @@ status_t otp_ctrl_testutils_dai_write64(const dif_otp_ctrl_t *otp,
   }
   return OK_STATUS();
 }
+
+enum {
+  /**
+   * Number of words read at once through the software config window.
+   */
+  kOtpSwCfgChunkWords = 16,
+};
+
+status_t otp_ctrl_testutils_sw_cfg_program32(const dif_otp_ctrl_t *otp,
+                                             dif_otp_ctrl_partition_t partition,
+                                             uint32_t start_address,
+                                             const uint32_t *buffer,
+                                             size_t len) {
+  uint32_t current[kOtpSwCfgChunkWords];
+  TRY(otp_ctrl_testutils_wait_for_dai(otp));
+  for (size_t i = 0; i < len; i += kOtpSwCfgChunkWords) {
+    size_t count = len - i;
+    if (count > kOtpSwCfgChunkWords) {
+      count = kOtpSwCfgChunkWords;
+    }
+    uint32_t chunk_address = start_address + i * sizeof(uint32_t);
+    TRY(dif_otp_ctrl_read_blocking(otp, partition, chunk_address, current,
+                                   count));
+    for (size_t j = 0; j < count; ++j) {
+      uint32_t addr = chunk_address + j * sizeof(uint32_t);
+      if (current[j] == buffer[i + j]) {
+        continue;
+      }
+      if (current[j] != 0) {
+        LOG_ERROR("OTP partition: %d addr[0x%x] got: 0x%08x, expected: 0x%08x",
+                  partition, addr, current[j], buffer[i + j]);
+        return INTERNAL();
+      }
+      TRY(dif_otp_ctrl_dai_program32(otp, partition, addr, buffer[i + j]));
+      TRY(otp_ctrl_testutils_wait_for_dai(otp));
+      TRY(otp_ctrl_dai_write_error_check(otp));
+    }
+  }
+  return OK_STATUS();
+}
+
+status_t otp_ctrl_testutils_sw_cfg_check32(const dif_otp_ctrl_t *otp,
+                                           dif_otp_ctrl_partition_t partition,
+                                           uint32_t start_address,
+                                           const uint32_t *buffer, size_t len) {
+  uint32_t current[kOtpSwCfgChunkWords];
+  for (size_t i = 0; i < len; i += kOtpSwCfgChunkWords) {
+    size_t count = len - i;
+    if (count > kOtpSwCfgChunkWords) {
+      count = kOtpSwCfgChunkWords;
+    }
+    uint32_t chunk_address = start_address + i * sizeof(uint32_t);
+    TRY(dif_otp_ctrl_read_blocking(otp, partition, chunk_address, current,
+                                   count));
+    for (size_t j = 0; j < count; ++j) {
+      if (current[j] != buffer[i + j]) {
+        uint32_t addr = chunk_address + j * sizeof(uint32_t);
+        LOG_ERROR("OTP partition: %d addr[0x%x] got: 0x%08x, expected: 0x%08x",
+                  partition, addr, current[j], buffer[i + j]);
+        return INTERNAL();
+      }
+    }
+  }
+  return OK_STATUS();
+}
@@ -158,4 +158,52 @@ status_t otp_ctrl_testutils_dai_write64(const dif_otp_ctrl_t *otp,
                                         uint32_t start_address,
                                         const uint64_t *buffer, size_t len);
 
+/**
+ * Programs `len` number of 32bit words from buffer into the software
+ * `partition` starting at `start_address`, without verifying them.
+ *
+ * This is a faster alternative to `otp_ctrl_testutils_dai_write32()` for
+ * programming large images into the partitions that are readable through the
+ * software config window (such as `kDifOtpCtrlPartitionCreatorSwCfg` and
+ * `kDifOtpCtrlPartitionOwnerSwCfg`). The current contents are read in bulk
+ * through the window instead of with a DAI read per word, words that already
+ * hold the expected value are skipped, and every other word costs a single
+ * DAI program command. Check the programmed image with
+ * `otp_ctrl_testutils_sw_cfg_check32()` once all of it has been written.
+ *
+ * @param otp otp_ctrl instance.
+ * @param partition OTP software partition.
+ * @param start_address Address relative to the start of the `partition`. Must
+ * be a 32bit aligned address.
+ * @param buffer The buffer containing the data to be written into OTP.
+ * @param len The number of 32bit words to write into otp.
+ * @return OK_STATUS on success, INTERNAL if a target word already holds a
+ * different non-zero value.
+ */
+OT_WARN_UNUSED_RESULT
+status_t otp_ctrl_testutils_sw_cfg_program32(const dif_otp_ctrl_t *otp,
+                                             dif_otp_ctrl_partition_t partition,
+                                             uint32_t start_address,
+                                             const uint32_t *buffer,
+                                             size_t len);
+
+/**
+ * Checks that `len` number of 32bit words of the software `partition` starting
+ * at `start_address` match `buffer`, reading them through the software config
+ * window.
+ *
+ * @param otp otp_ctrl instance.
+ * @param partition OTP software partition.
+ * @param start_address Address relative to the start of the `partition`. Must
+ * be a 32bit aligned address.
+ * @param buffer The expected contents.
+ * @param len The number of 32bit words to check.
+ * @return OK_STATUS if all words match, INTERNAL otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+status_t otp_ctrl_testutils_sw_cfg_check32(const dif_otp_ctrl_t *otp,
+                                           dif_otp_ctrl_partition_t partition,
+                                           uint32_t start_address,
+                                           const uint32_t *buffer, size_t len);
+
 #endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_OTP_CTRL_TESTUTILS_H_
@@ -4,6 +4,9 @@
 
 #include "sw/device/lib/testing/profile.h"
 
+#include "sw/device/lib/arch/device.h"
+#include "sw/device/lib/base/csr.h"
+#include "sw/device/lib/base/math.h"
 #include "sw/device/lib/runtime/ibex.h"
 #include "sw/device/lib/testing/test_framework/check.h"
 
@@ -18,7 +21,127 @@ uint32_t profile_end(uint64_t t_start) {
 
 uint32_t profile_end_and_print(uint64_t t_start, char *name) {
   uint32_t cycles = profile_end(t_start);
-  uint32_t time_ms = cycles / 100000;
-  LOG_INFO("%s took %u cycles or %u ms @ 100 MHz.", name, cycles, time_ms);
+  uint32_t time_us =
+      (uint32_t)udiv64_slow((uint64_t)cycles * 1000000, kClockFreqCpuHz, NULL);
+  LOG_INFO("%s took %u cycles or %u us.", name, cycles, time_us);
   return cycles;
 }
+
+enum {
+  /**
+   * The `mcountinhibit` bits of `mcycle`, `minstret` and `mhpmcounter3` to
+   * `mhpmcounter6`.
+   */
+  kProfileCounterMask = 0x7d,
+};
+
+/**
+ * A running region: its index in `regions` and the counters at its start.
+ */
+typedef struct profile_frame {
+  size_t index;
+  profile_counters_t start;
+} profile_frame_t;
+
+static profile_region_stats_t regions[kProfileMaxRegions];
+static size_t region_count;
+static profile_frame_t stack[kProfileMaxDepth];
+static size_t depth;
+
+void profile_init(void) {
+  CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, kProfileCounterMask);
+  region_count = 0;
+  depth = 0;
+}
+
+void profile_counters_read(profile_counters_t *counters) {
+  counters->cycles = ibex_mcycle_read();
+  CSR_READ(CSR_REG_MINSTRET, &counters->instret);
+  CSR_READ(CSR_REG_MHPMCOUNTER3, &counters->lsu_wait);
+  CSR_READ(CSR_REG_MHPMCOUNTER4, &counters->ifetch_wait);
+  CSR_READ(CSR_REG_MHPMCOUNTER5, &counters->loads);
+  CSR_READ(CSR_REG_MHPMCOUNTER6, &counters->stores);
+}
+
+static bool name_eq(const char *a, const char *b) {
+  if (a == b) {
+    return true;
+  }
+  while (*a != '\0' && *a == *b) {
+    ++a;
+    ++b;
+  }
+  return *a == *b;
+}
+
+void profile_region_begin(const char *name) {
+  CHECK(depth < kProfileMaxDepth, "Profiled regions nested too deep");
+  size_t index = 0;
+  while (index < region_count && !name_eq(regions[index].name, name)) {
+    ++index;
+  }
+  if (index == region_count) {
+    CHECK(region_count < kProfileMaxRegions, "Too many profiled regions");
+    regions[index] = (profile_region_stats_t){
+        .name = name,
+        .depth = (uint32_t)depth,
+        .cycles_min = UINT64_MAX,
+    };
+    ++region_count;
+  }
+  profile_frame_t *frame = &stack[depth++];
+  frame->index = index;
+  // Read the counters last so that the bookkeeping above isn't counted.
+  profile_counters_read(&frame->start);
+}
+
+void profile_region_end(const char *name) {
+  // Read the counters first so that the bookkeeping below isn't counted.
+  profile_counters_t end;
+  profile_counters_read(&end);
+
+  CHECK(depth > 0, "No profiled region to end");
+  profile_frame_t *frame = &stack[--depth];
+  profile_region_stats_t *region = &regions[frame->index];
+  CHECK(name_eq(region->name, name), "Ended region %s inside %s", name,
+        region->name);
+
+  uint64_t cycles = end.cycles - frame->start.cycles;
+  ++region->count;
+  if (cycles < region->cycles_min) {
+    region->cycles_min = cycles;
+  }
+  if (cycles > region->cycles_max) {
+    region->cycles_max = cycles;
+  }
+  region->cycles_total += cycles;
+  region->instret_total += end.instret - frame->start.instret;
+  region->lsu_wait_total += end.lsu_wait - frame->start.lsu_wait;
+  region->ifetch_wait_total += end.ifetch_wait - frame->start.ifetch_wait;
+  region->loads_total += end.loads - frame->start.loads;
+  region->stores_total += end.stores - frame->start.stores;
+}
+
+size_t profile_region_count(void) { return region_count; }
+
+const profile_region_stats_t *profile_region_get(size_t index) {
+  CHECK(index < region_count);
+  return &regions[index];
+}
+
+void profile_print(void) {
+  for (size_t i = 0; i < region_count; ++i) {
+    const profile_region_stats_t *region = &regions[i];
+    if (region->count == 0) {
+      continue;
+    }
+    uint32_t mean = (uint32_t)udiv64_slow(region->cycles_total,
+                                          region->count, NULL);
+    uint32_t instret = (uint32_t)udiv64_slow(region->instret_total,
+                                             region->count, NULL);
+    LOG_INFO("%s (depth %u): %u runs, cycles min %u max %u mean %u, instret %u",
+             region->name, region->depth, region->count,
+             (uint32_t)region->cycles_min, (uint32_t)region->cycles_max, mean,
+             instret);
+  }
+}
@@ -5,6 +5,7 @@
 #ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_PROFILE_H_
 #define OPENTITAN_SW_DEVICE_LIB_TESTING_PROFILE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -50,6 +51,154 @@ uint32_t profile_end(uint64_t t_start);
  */
 uint32_t profile_end_and_print(uint64_t t_start, char *name);
 
+enum {
+  /**
+   * Maximum number of distinct regions that can be profiled.
+   */
+  kProfileMaxRegions = 32,
+  /**
+   * Maximum nesting depth of profiled regions.
+   */
+  kProfileMaxDepth = 8,
+};
+
+/**
+ * A snapshot of the Ibex performance counters.
+ *
+ * The event counters are the low 32 bits of `minstret` and of the hardwired
+ * Ibex `mhpmcounter3` to `mhpmcounter6`. Earl Grey only implements the first
+ * two of those (`MHPMCounterNum` is 2), so `loads` and `stores` read as zero
+ * there; they are kept so that the same code works on Ibex configurations
+ * with more counters.
+ */
+typedef struct profile_counters {
+  /**
+   * Cycles (`mcycle`).
+   */
+  uint64_t cycles;
+  /**
+   * Instructions retired (`minstret`).
+   */
+  uint32_t instret;
+  /**
+   * Cycles spent waiting for data memory (`mhpmcounter3`).
+   */
+  uint32_t lsu_wait;
+  /**
+   * Cycles spent waiting for instruction fetches (`mhpmcounter4`).
+   */
+  uint32_t ifetch_wait;
+  /**
+   * Loads (`mhpmcounter5`).
+   */
+  uint32_t loads;
+  /**
+   * Stores (`mhpmcounter6`).
+   */
+  uint32_t stores;
+} profile_counters_t;
+
+/**
+ * The statistics gathered for a profiled region.
+ *
+ * Nested regions are inclusive: the counts of a region include those of the
+ * regions run inside it.
+ */
+typedef struct profile_region_stats {
+  /**
+   * Name of the region, as passed to `profile_region_begin()`.
+   */
+  const char *name;
+  /**
+   * Nesting depth of the region the first time it was entered (0 for a
+   * region that isn't inside any other).
+   */
+  uint32_t depth;
+  /**
+   * Number of times the region was run.
+   */
+  uint32_t count;
+  /**
+   * Shortest and longest runs of the region, in cycles.
+   */
+  uint64_t cycles_min;
+  uint64_t cycles_max;
+  /**
+   * Totals over all runs of the region, from which the means are taken.
+   */
+  uint64_t cycles_total;
+  uint64_t instret_total;
+  uint64_t lsu_wait_total;
+  uint64_t ifetch_wait_total;
+  uint64_t loads_total;
+  uint64_t stores_total;
+} profile_region_stats_t;
+
+/**
+ * Enable the Ibex performance counters and forget all profiled regions.
+ *
+ * Call this once before the first `profile_region_begin()`.
+ */
+void profile_init(void);
+
+/**
+ * Read the Ibex performance counters.
+ *
+ * @param[out] counters The current values of the counters.
+ */
+void profile_counters_read(profile_counters_t *counters);
+
+/**
+ * Start a run of a named profiled region.
+ *
+ * Basic usage:
+ *   profile_region_begin("aes_encrypt");
+ *   // Do some stuff, possibly beginning and ending other regions.
+ *   profile_region_end("aes_encrypt");
+ *
+ * Runs of the same region are aggregated in a static table that can be read
+ * with `profile_region_get()` and dumped with `profile_print()` or, over
+ * ujson, with `profile_dump()` (see sw/device/lib/testing/json/profile.h).
+ *
+ * A region is identified by its name, which should be a string literal. At
+ * most `kProfileMaxRegions` different regions can be profiled, nested at
+ * most `kProfileMaxDepth` deep.
+ *
+ * @param name Name of the region.
+ */
+void profile_region_begin(const char *name);
+
+/**
+ * End the innermost running profiled region.
+ *
+ * Regions must be ended in the reverse order of the one in which they were
+ * begun.
+ *
+ * @param name Name of the region, which must be that of the innermost
+ * running region.
+ */
+void profile_region_end(const char *name);
+
+/**
+ * @return The number of regions profiled so far.
+ */
+size_t profile_region_count(void);
+
+/**
+ * Get the statistics of a profiled region.
+ *
+ * Regions are numbered in the order in which they were first begun.
+ *
+ * @param index Index of the region, less than `profile_region_count()`.
+ * @return The statistics of the region.
+ */
+const profile_region_stats_t *profile_region_get(size_t index);
+
+/**
+ * Log the statistics of all the profiled regions, one line each.
+ */
+void profile_print(void);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -89,6 +89,84 @@ uint32_t rand_testutils_gen32_range(uint32_t min, uint32_t max) {
   return result;
 }
 
+/**
+ * State of a xoshiro128++ generator.
+ *
+ * See https://prng.di.unimi.it/xoshiro128plusplus.c.
+ */
+typedef struct xoshiro128 {
+  uint32_t s[4];
+} xoshiro128_t;
+
+static inline uint32_t rotl32(uint32_t x, uint32_t k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+static inline uint32_t xoshiro128_next(xoshiro128_t *state) {
+  uint32_t *s = state->s;
+  uint32_t result = rotl32(s[0] + s[3], 7) + s[0];
+  uint32_t t = s[1] << 9;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl32(s[3], 11);
+  return result;
+}
+
+static void xoshiro128_seed(xoshiro128_t *state) {
+  uint32_t nonzero = 0;
+  for (size_t i = 0; i < ARRAYSIZE(state->s); ++i) {
+    CHECK_STATUS_OK(rv_core_ibex_testutils_get_rnd_data(
+        rand_testutils_rng_ctx.rv_core_ibex,
+        rand_testutils_rng_ctx.entropy_fetch_timeout_usec, &state->s[i]));
+    nonzero |= state->s[i];
+  }
+  // The all-zero state is a fixed point of the generator.
+  if (nonzero == 0) {
+    state->s[0] = 1;
+  }
+}
+
+void rand_testutils_fill(uint32_t *buf, size_t len) {
+  xoshiro128_t state;
+  xoshiro128_seed(&state);
+  for (size_t i = 0; i < len; ++i) {
+    buf[i] = xoshiro128_next(&state);
+  }
+}
+
+void rand_testutils_fill_range(uint32_t *buf, size_t len, uint32_t min,
+                               uint32_t max) {
+  CHECK(max >= min);
+  uint32_t range = max - min;
+  xoshiro128_t state;
+  xoshiro128_seed(&state);
+  if (range == UINT32_MAX) {
+    for (size_t i = 0; i < len; ++i) {
+      buf[i] = xoshiro128_next(&state);
+    }
+    return;
+  }
+
+  // Lemire's multiply-shift reduction: the high word of `x * span` is
+  // uniform in [0, span) once products whose low word falls below
+  // `2^32 mod span` are rejected. The threshold is only computed when it might
+  // matter, which keeps the division off the common path.
+  uint32_t span = range + 1;
+  for (size_t i = 0; i < len; ++i) {
+    uint64_t product = (uint64_t)xoshiro128_next(&state) * span;
+    if ((uint32_t)product < span) {
+      uint32_t threshold = (0u - span) % span;
+      while ((uint32_t)product < threshold) {
+        product = (uint64_t)xoshiro128_next(&state) * span;
+      }
+    }
+    buf[i] = min + (uint32_t)(product >> 32);
+  }
+}
+
 void rand_testutils_shuffle(void *array, size_t size, size_t length) {
   if (length <= 1) {
     return;
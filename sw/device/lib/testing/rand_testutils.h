@@ -5,6 +5,7 @@
 #ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_RAND_TESTUTILS_H_
 #define OPENTITAN_SW_DEVICE_LIB_TESTING_RAND_TESTUTILS_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "sw/device/lib/testing/rv_core_ibex_testutils.h"
@@ -100,6 +101,37 @@ uint32_t rand_testutils_gen32(void);
  */
 uint32_t rand_testutils_gen32_range(uint32_t min, uint32_t max);
 
+/**
+ * Fills a buffer with random words.
+ *
+ * Intended for tests that need large amounts of random input. A fresh
+ * xoshiro128++ generator is seeded with 128 bits fetched from the hardware
+ * (regardless of the context's reseed frequency), and then produces the
+ * requested words in software. This costs a few cycles per word, which is far
+ * cheaper than `rand_testutils_gen32()` per word when the PRNG is disabled.
+ * The output is statistically random but not cryptographically secure.
+ *
+ * @param buf The buffer to fill.
+ * @param len The number of words to write to `buf`.
+ */
+void rand_testutils_fill(uint32_t *buf, size_t len);
+
+/**
+ * Fills a buffer with random words within a given range.
+ *
+ * Like `rand_testutils_fill()`, but each word is uniformly distributed within
+ * the supplied range, inclusive of the range limits. The range reduction is
+ * unbiased: the rare outputs that would skew the distribution are rejected and
+ * replaced.
+ *
+ * @param buf The buffer to fill.
+ * @param len The number of words to write to `buf`.
+ * @param min The lower limit of the range.
+ * @param max The upper limit of the range.
+ */
+void rand_testutils_fill_range(uint32_t *buf, size_t len, uint32_t min,
+                               uint32_t max);
+
 /** Shuffles an arbitrary array of elements.
  *
  * The shuffling occurs in-place. The reseeding of the LFSR is temporarily
@@ -4,6 +4,7 @@
 
 #include "sw/device/lib/testing/randomness_quality.h"
 
+#include "sw/device/lib/base/bitfield.h"
 #include "sw/device/lib/base/status.h"
 #include "sw/device/lib/testing/test_framework/check.h"
 
@@ -26,42 +27,135 @@ enum {
    */
   kMonobitOnePercentThresholdNumerator = 66349,
   kMonobitOnePercentThresholdDenominator = 10000,
+  /**
+   * Bound on |#zeroes - #ones| beyond which the monobit test fails for any
+   * supported bit length; checking it first keeps the arithmetic in range.
+   */
+  kMonobitMaxDifference = 1 << 24,
+  /**
+   * Thresholds for the runs test (alpha=0.05 and alpha=0.01).
+   *
+   * Based on NIST SP 800-22, section 2.3. The test passes if
+   * erfc(|V - 2n*p*(1-p)| / (2*sqrt(2n)*p*(1-p))) >= alpha, i.e. if the
+   * argument to erfc is at most z, where erfc(z) = alpha. These are the values
+   * of 2 * sqrt(2) * z, scaled by 2^16.
+   */
+  kRunsFivePercentThreshold = 256896,
+  kRunsOnePercentThreshold = 337619,
+  /**
+   * Bound on |V - 2n*p*(1-p)| beyond which the runs test fails for any
+   * supported bit length; checking it first keeps the arithmetic in range.
+   */
+  kRunsMaxDifference = 1 << 18,
+  /**
+   * Minimum number of bits for the runs test, from NIST SP 800-22.
+   */
+  kRunsMinBits = 100,
 };
 
 /**
- * Get the square of the difference of two numbers.
+ * Get the absolute difference of two numbers.
  *
  * @param a First operand.
  * @param b Second operand.
- * @return Result, (a - b)^2
+ * @return Result, |a - b|
  */
-static uint64_t diff_squared(uint64_t a, uint64_t b) {
+static uint64_t abs_diff(uint64_t a, uint64_t b) {
   if (a <= b) {
-    return (b - a) * (b - a);
+    return b - a;
   }
-  return (a - b) * (a - b);
+  return a - b;
 }
 
-status_t randomness_quality_monobit_test(
-    uint8_t *data, size_t len, randomness_quality_significance_t significance) {
-  // Guard against overflow in the bit-count.
-  TRY_CHECK(len <= UINT32_MAX);
+/**
+ * Integer square root, rounded down.
+ *
+ * @param x Operand.
+ * @return Result, floor(sqrt(x)).
+ */
+static uint64_t isqrt(uint64_t x) {
+  uint64_t root = 0;
+  uint64_t bit = 1ull << 62;
+  while (bit > x) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (x >= root + bit) {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+void randomness_quality_stats_init(randomness_quality_stats_t *stats,
+                                   buffer_sink_t raw_sink) {
+  stats->num_bits = 0;
+  stats->num_ones = 0;
+  stats->num_transitions = 0;
+  stats->last_bit = 0;
+  stats->raw_sink = raw_sink;
+}
 
-  // Count the number of zeroes and the number of ones in the data.
-  uint32_t num_ones = 0;
-  uint32_t num_zeroes = 0;
+/**
+ * Adds the bits of one value to running statistics.
+ *
+ * @param stats Statistics to update.
+ * @param value Random data, consumed least-significant bit first.
+ * @param width Number of bits in `value`; 8 or 32.
+ */
+static inline void stats_consume(randomness_quality_stats_t *stats,
+                                 uint32_t value, uint32_t width) {
+  // Adjacent bits within the value differ wherever `value ^ (value >> 1)` is
+  // set, ignoring its top bit; the first bit is compared with the previous
+  // value's last bit.
+  uint32_t mask = width == 32 ? UINT32_MAX : (1u << width) - 1;
+  uint32_t transitions = (value ^ (value >> 1)) & (mask >> 1);
+  stats->num_ones += (uint32_t)bitfield_popcount32(value);
+  stats->num_transitions += (uint32_t)bitfield_popcount32(transitions);
+  if (stats->num_bits != 0) {
+    stats->num_transitions += (value ^ stats->last_bit) & 1;
+  }
+  stats->last_bit = (value >> (width - 1)) & 1;
+  stats->num_bits += width;
+}
+
+void randomness_quality_stats_update(randomness_quality_stats_t *stats,
+                                     const uint8_t *data, size_t len) {
+  if (stats->raw_sink.sink != NULL) {
+    stats->raw_sink.sink(stats->raw_sink.data, (const char *)data, len);
+  }
   for (size_t i = 0; i < len; i++) {
-    uint8_t byte = data[i];
-    for (size_t j = 0; j < 8; j++) {
-      num_ones += byte & 1;
-      num_zeroes += (byte ^ 1) & 1;
-      byte >>= 1;
-    }
+    stats_consume(stats, data[i], 8);
+  }
+}
+
+void randomness_quality_stats_update_words(randomness_quality_stats_t *stats,
+                                           const uint32_t *data, size_t len) {
+  if (stats->raw_sink.sink != NULL) {
+    stats->raw_sink.sink(stats->raw_sink.data, (const char *)data,
+                         len * sizeof(uint32_t));
+  }
+  for (size_t i = 0; i < len; i++) {
+    stats_consume(stats, data[i], 32);
   }
+}
+
+status_t randomness_quality_monobit_check(
+    const randomness_quality_stats_t *stats,
+    randomness_quality_significance_t significance) {
+  // Guard against overflow in the test arithmetic.
+  TRY_CHECK(stats->num_bits <= UINT32_MAX);
 
   // Numerical result of the test is (#zeroes - #ones)^2 / bitlen.
-  uint64_t numerator = diff_squared(num_ones, num_zeroes);
-  uint64_t denominator = len * 8;
+  uint64_t num_zeroes = stats->num_bits - stats->num_ones;
+  uint64_t difference = abs_diff(stats->num_ones, num_zeroes);
+  TRY_CHECK(difference < kMonobitMaxDifference);
+  uint64_t numerator = difference * difference;
+  uint64_t denominator = stats->num_bits;
 
   // Retrieve the threshold values.
   uint64_t threshold_numerator = 0;
@@ -88,3 +182,70 @@ status_t randomness_quality_monobit_test(
 
   return OK_STATUS();
 }
+
+status_t randomness_quality_monobit_test(
+    uint8_t *data, size_t len, randomness_quality_significance_t significance) {
+  randomness_quality_stats_t stats;
+  randomness_quality_stats_init(&stats, (buffer_sink_t){0});
+  randomness_quality_stats_update(&stats, data, len);
+  return randomness_quality_monobit_check(&stats, significance);
+}
+
+status_t randomness_quality_runs_check(
+    const randomness_quality_stats_t *stats,
+    randomness_quality_significance_t significance) {
+  // The test is only meaningful with enough data; the upper limit guards
+  // against overflow in the test arithmetic.
+  TRY_CHECK(stats->num_bits >= kRunsMinBits);
+  TRY_CHECK(stats->num_bits <= UINT32_MAX);
+
+  uint64_t threshold = 0;
+  switch (significance) {
+    case kRandomnessQualitySignificanceFivePercent:
+      threshold = kRunsFivePercentThreshold;
+      break;
+    case kRandomnessQualitySignificanceOnePercent:
+      threshold = kRunsOnePercentThreshold;
+      break;
+    default:
+      return INVALID_ARGUMENT();
+  }
+
+  uint64_t n = stats->num_bits;
+  uint64_t ones = stats->num_ones;
+  uint64_t runs = stats->num_transitions + 1;
+
+  // sqrt(n), scaled by 2^8.
+  uint64_t sqrt_n = isqrt(n << 16);
+
+  // Prerequisite: |ones/n - 1/2| < 2/sqrt(n), otherwise the sequence fails
+  // without the runs needing to be considered.
+  uint64_t bias = abs_diff(2 * ones, n);
+  TRY_CHECK(bias * sqrt_n < (n << 10));
+
+  // With p = ones/n, the expected number of runs is 2n*p*(1-p) = 2m, where
+  // m = ones * (n - ones) / n = q + r/n.
+  uint64_t product = ones * (n - ones);
+  uint64_t q = product / n;
+  uint64_t r = product % n;
+
+  // |V - 2m|, scaled by 2^8.
+  TRY_CHECK(abs_diff(runs, 2 * q) < kRunsMaxDifference);
+  uint64_t deviation = abs_diff(runs << 8, (q << 9) + ((r << 9) / n));
+
+  // Pass if |V - 2m| / (2 * sqrt(2n) * m / n) <= z, i.e.
+  // |V - 2m| * sqrt(n) <= 2 * sqrt(2) * z * m; both sides are scaled by 2^16.
+  uint64_t lhs = deviation * sqrt_n;
+  uint64_t rhs = q * threshold + (r * threshold) / n;
+  TRY_CHECK(lhs <= rhs);
+
+  return OK_STATUS();
+}
+
+status_t randomness_quality_runs_test(
+    uint8_t *data, size_t len, randomness_quality_significance_t significance) {
+  randomness_quality_stats_t stats;
+  randomness_quality_stats_init(&stats, (buffer_sink_t){0});
+  randomness_quality_stats_update(&stats, data, len);
+  return randomness_quality_runs_check(&stats, significance);
+}
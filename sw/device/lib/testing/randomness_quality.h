@@ -5,9 +5,11 @@
 #ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_RANDOMNESS_QUALITY_H_
 #define OPENTITAN_SW_DEVICE_LIB_TESTING_RANDOMNESS_QUALITY_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "sw/device/lib/base/status.h"
+#include "sw/device/lib/runtime/print.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +48,120 @@ typedef enum randomness_quality_significance {
 status_t randomness_quality_monobit_test(
     uint8_t *data, size_t len, randomness_quality_significance_t significance);
 
+/**
+ * Running statistics over a stream of random data.
+ *
+ * The statistical tests below only need a few counters, so data may be fed in
+ * piecemeal with `randomness_quality_stats_update*()` and never needs to be
+ * buffered in full; this allows for sample sizes far larger than the available
+ * memory. Bits are consumed least-significant first within each byte, and
+ * words are treated as four little-endian bytes, so the two update functions
+ * may be mixed freely.
+ */
+typedef struct randomness_quality_stats {
+  /**
+   * Number of bits consumed so far.
+   */
+  uint64_t num_bits;
+  /**
+   * Number of one bits consumed so far.
+   */
+  uint64_t num_ones;
+  /**
+   * Number of adjacent bit pairs that differ; the number of runs is one more
+   * than this.
+   */
+  uint64_t num_transitions;
+  /**
+   * Value of the most recently consumed bit.
+   */
+  uint32_t last_bit;
+  /**
+   * Optional sink to which the raw samples are forwarded as they are consumed.
+   *
+   * When `raw_sink.sink` is non-NULL, every byte passed to the update
+   * functions is also written, unmodified, to this sink. This allows a host to
+   * capture much larger sample sets for offline analysis (for example with the
+   * NIST SP 800-90B tools) than could be held on the device.
+   */
+  buffer_sink_t raw_sink;
+} randomness_quality_stats_t;
+
+/**
+ * Initializes running statistics.
+ *
+ * @param stats Statistics to initialize.
+ * @param raw_sink Sink for the raw samples, or a sink with a NULL `sink`
+ * function if they should not be forwarded.
+ */
+void randomness_quality_stats_init(randomness_quality_stats_t *stats,
+                                   buffer_sink_t raw_sink);
+
+/**
+ * Adds bytes of random data to running statistics.
+ *
+ * @param stats Statistics to update.
+ * @param data Random data.
+ * @param len Length of data, in bytes.
+ */
+void randomness_quality_stats_update(randomness_quality_stats_t *stats,
+                                     const uint8_t *data, size_t len);
+
+/**
+ * Adds words of random data to running statistics.
+ *
+ * This is the faster way to feed data, since it processes a whole word with
+ * each population count.
+ *
+ * @param stats Statistics to update.
+ * @param data Random data.
+ * @param len Length of data, in words.
+ */
+void randomness_quality_stats_update_words(randomness_quality_stats_t *stats,
+                                           const uint32_t *data, size_t len);
+
+/**
+ * Monobit test over running statistics.
+ *
+ * Equivalent to `randomness_quality_monobit_test()` on all of the data that
+ * has been consumed by `stats`.
+ *
+ * @param stats Running statistics.
+ * @param significance Test statistical significance setting.
+ * @return OK if the test passes, a failure code otherwise.
+ */
+status_t randomness_quality_monobit_check(
+    const randomness_quality_stats_t *stats,
+    randomness_quality_significance_t significance);
+
+/**
+ * Runs test from section 2.3 of NIST SP 800-22.
+ *
+ * This test counts the number of uninterrupted runs of identical bits and
+ * expects it to be close to the number for a random sequence with the same
+ * proportion of ones. The test fails outright if that proportion is too far
+ * from one half (i.e. the monobit test would fail), and requires at least 100
+ * bits of data.
+ *
+ * @param stats Running statistics.
+ * @param significance Test statistical significance setting.
+ * @return OK if the test passes, a failure code otherwise.
+ */
+status_t randomness_quality_runs_check(
+    const randomness_quality_stats_t *stats,
+    randomness_quality_significance_t significance);
+
+/**
+ * Runs test over a buffer of data; see `randomness_quality_runs_check()`.
+ *
+ * @param data Random data to check.
+ * @param len Length of data.
+ * @param significance Test statistical significance setting.
+ * @return OK if the test passes, a failure code otherwise.
+ */
+status_t randomness_quality_runs_test(
+    uint8_t *data, size_t len, randomness_quality_significance_t significance);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
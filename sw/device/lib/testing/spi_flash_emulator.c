@@ -24,8 +24,45 @@ enum {
   kJedecContCodeCount = 12,
   // A density of 24 corresponds to 16MiB (1<<24 bytes).
   kJedecDensity = 24,
+  // Size of a page of the backend EEPROM.
+  kPageSize = 256,
+  // Size of the spi_device mailbox, which serves as the read cache.
+  kCacheSize = 1024,
+  kCachePages = kCacheSize / kPageSize,
 };
 
+/**
+ * A write-back cache of one mailbox-sized window of the backend EEPROM.
+ *
+ * The window is mapped as the spi_device mailbox, so passthrough reads of it
+ * are served from the mailbox buffer instead of the backend EEPROM.  Page
+ * programs to the window are applied to the cached copy and the upstream host
+ * is released as soon as the mailbox is updated; the backend EEPROM is only
+ * programmed when the window moves or another command needs the backend to be
+ * up to date.
+ */
+typedef struct cache {
+  /**
+   * Whether `data` holds a copy of the window at `address`.
+   */
+  bool valid;
+  /**
+   * The address of the cached window, aligned to `kCacheSize`.
+   */
+  uint32_t address;
+  /**
+   * Whether the window is addressed with 4-byte addresses.
+   */
+  bool addr_4b;
+  /**
+   * Bitmap of the pages which have not been written to the backend yet.
+   */
+  uint32_t dirty;
+  alignas(uint32_t) uint8_t data[kCacheSize];
+} cache_t;
+
+static cache_t cache;
+
 typedef struct bfpt {
   uint32_t data[9];
 } bfpt_t;
@@ -116,6 +153,86 @@ static status_t prepare_jedec_id(dif_spi_device_handle_t *spid) {
   return OK_STATUS();
 }
 
+/**
+ * Writes the dirty pages of the cache back to the backend EEPROM.
+ */
+static status_t cache_flush(dif_spi_host_t *spih) {
+  for (uint32_t i = 0; i < kCachePages; ++i) {
+    if ((cache.dirty >> i) & 1) {
+      // Programming the merged page is equivalent to programming the
+      // individual uploads, since programming can only clear bits.
+      uint8_t opcode = cache.addr_4b ? kSpiDeviceFlashOpPageProgram4b
+                                     : kSpiDeviceFlashOpPageProgram;
+      TRY(spi_flash_testutils_program_op(
+          spih, opcode, &cache.data[i * kPageSize], kPageSize,
+          cache.address + i * kPageSize, cache.addr_4b,
+          kTransactionWidthMode111));
+    }
+  }
+  cache.dirty = 0;
+  return OK_STATUS();
+}
+
+/**
+ * Writes back and then drops the cached window, so that passthrough reads go
+ * to the backend EEPROM again.
+ */
+static status_t cache_invalidate(dif_spi_host_t *spih,
+                                 dif_spi_device_handle_t *spid) {
+  TRY(cache_flush(spih));
+  if (cache.valid) {
+    TRY(dif_spi_device_disable_mailbox(spid));
+    cache.valid = false;
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Makes the window containing `address` the cached window.
+ */
+static status_t cache_fill(dif_spi_host_t *spih, dif_spi_device_handle_t *spid,
+                           uint32_t address, bool addr_4b) {
+  address &= ~(uint32_t)(kCacheSize - 1);
+  if (cache.valid && cache.address == address && cache.addr_4b == addr_4b) {
+    return OK_STATUS();
+  }
+  TRY(cache_invalidate(spih, spid));
+  uint8_t opcode =
+      addr_4b ? kSpiDeviceFlashOpRead4b : kSpiDeviceFlashOpReadNormal;
+  TRY(spi_flash_testutils_read_op(spih, opcode, cache.data, sizeof(cache.data),
+                                  address, addr_4b, /*width=*/1, /*dummy=*/0));
+  TRY(dif_spi_device_write_flash_buffer(spid,
+                                        kDifSpiDeviceFlashBufferTypeMailbox, 0,
+                                        sizeof(cache.data), cache.data));
+  TRY(dif_spi_device_enable_mailbox(spid, address));
+  cache.address = address;
+  cache.addr_4b = addr_4b;
+  cache.valid = true;
+  return OK_STATUS();
+}
+
+/**
+ * Applies a page program to the cache and makes the result visible to
+ * passthrough reads.
+ */
+static status_t cache_program(dif_spi_host_t *spih,
+                              dif_spi_device_handle_t *spid,
+                              const upload_info_t *info, bool addr_4b) {
+  TRY(cache_fill(spih, spid, info->address, addr_4b));
+  // Like the EEPROM, wrap around to the start of the page rather than
+  // crossing into the next one.
+  uint32_t page = (info->address % kCacheSize) / kPageSize;
+  uint8_t *data = &cache.data[page * kPageSize];
+  for (uint32_t i = 0; i < info->data_len; ++i) {
+    data[(info->address + i) % kPageSize] &= info->data[i];
+  }
+  cache.dirty |= 1u << page;
+  TRY(dif_spi_device_write_flash_buffer(
+      spid, kDifSpiDeviceFlashBufferTypeMailbox, page * kPageSize, kPageSize,
+      data));
+  return OK_STATUS();
+}
+
 status_t spi_flash_emulator(dif_spi_host_t *spih,
                             dif_spi_device_handle_t *spid) {
   // TODO: add a mode that uses spi_device address translation.
@@ -125,6 +242,15 @@ status_t spi_flash_emulator(dif_spi_host_t *spih,
   uint8_t quad_enable = (uint8_t)TRY(read_and_prepare_sfdp(spih, spid));
   LOG_INFO("Setting the EEPROM's QE bit via mechanism %d", quad_enable);
   TRY(spi_flash_testutils_quad_enable(spih, quad_enable, /*enabled=*/true));
+  TRY(dif_spi_device_set_passthrough_intercept_config(
+      spid, (dif_spi_device_passthrough_intercept_config_t){
+                .status = true,
+                .jedec_id = true,
+                .sfdp = true,
+                .mailbox = true,
+            }));
+  cache.valid = false;
+  cache.dirty = 0;
   TRY(dif_spi_device_set_passthrough_mode(spid, kDifToggleEnabled));
   LOG_INFO("Starting spi_flash_emulator.");
 
@@ -134,6 +260,12 @@ status_t spi_flash_emulator(dif_spi_host_t *spih,
     TRY(spi_device_testutils_wait_for_upload(spid, &info));
 
     TRY(dif_spi_device_set_passthrough_mode(spid, kDifToggleDisabled));
+    // Page programs are absorbed by the cache; every other command expects
+    // the backend EEPROM to hold the programmed data.
+    if (info.opcode != kSpiDeviceFlashOpPageProgram &&
+        info.opcode != kSpiDeviceFlashOpPageProgram4b) {
+      TRY(cache_invalidate(spih, spid));
+    }
     switch (info.opcode) {
       case kSpiDeviceFlashOpChipErase:
         TRY(spi_flash_testutils_erase_chip(spih));
@@ -150,8 +282,7 @@ status_t spi_flash_emulator(dif_spi_host_t *spih,
                                          info.address, info.addr_4b));
         break;
       case kSpiDeviceFlashOpPageProgram:
-        TRY(spi_flash_testutils_program_page(spih, info.data, info.data_len,
-                                             info.address, info.addr_4b));
+        TRY(cache_program(spih, spid, &info, info.addr_4b));
         break;
       case kSpiDeviceFlashOpSectorErase4b:
         TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpSectorErase4b,
@@ -166,10 +297,7 @@ status_t spi_flash_emulator(dif_spi_host_t *spih,
                                          info.address, /*addr_is_4b=*/true));
         break;
       case kSpiDeviceFlashOpPageProgram4b:
-        TRY(spi_flash_testutils_program_op(
-            spih, kSpiDeviceFlashOpPageProgram4b, info.data, info.data_len,
-            info.address,
-            /*addr_is_4b=*/true, kTransactionWidthMode111));
+        TRY(cache_program(spih, spid, &info, /*addr_4b=*/true));
         break;
       case kSpiDeviceFlashOpReset:
         running = false;
@@ -274,7 +274,6 @@ status_t spi_flash_testutils_read_op(dif_spi_host_t *spih, uint8_t opcode,
                                      uint8_t width, uint8_t dummy) {
   TRY_CHECK(spih != NULL);
   TRY_CHECK(payload != NULL);
-  TRY_CHECK(length <= 256);  // Length must be less than a page size.
   TRY_CHECK(width == 1 || width == 2 || width == 4);
 
   dif_spi_host_addr_mode_t addr_mode =
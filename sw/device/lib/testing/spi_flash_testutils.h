@@ -304,8 +304,9 @@ status_t spi_flash_testutils_program_page_quad(
  * @param spih A SPI host handle.
  * @param opcode The desired read opcode.
  * @param[out] payload A pointer to the buffer to receive data from the device.
- * @param length Number of bytes in the buffer. Must be less than or equal to
- *               256 bytes.
+ * @param length Number of bytes in the buffer. Reads longer than a single
+ *               SPI host command are split by the DIF without deasserting
+ *               chip select.
  * @param address The start address where the read should begin.
  * @param addr_is_4b True if `address` is 4 bytes long, else 3 bytes.
  * @param width The width of the read (1, 2 or 4 bits).
@@ -11,10 +11,20 @@
 // NOTE: the macro names below do NOT, and cannot, conform to the style
 // guide, since they are specific to FreeRTOS.
 
+#include <stdint.h>
+
 // Debugging
-#define configGENERATE_RUN_TIME_STATS 0
 #define configUSE_APPLICATION_TASK_TAG 0
-#define configUSE_TRACE_FACILITY 0
+#define configUSE_TRACE_FACILITY 1  // for uxTaskGetSystemState()
+
+// Run-time stats, counted in units of `1 << OTTF_RUN_TIME_COUNTER_SHIFT`
+// mcycles so that the 32-bit counters last for hours (see freertos_port.c).
+#define configGENERATE_RUN_TIME_STATS 1
+#define configUSE_STATS_FORMATTING_FUNCTIONS 0
+#define OTTF_RUN_TIME_COUNTER_SHIFT 8
+uint32_t ottf_run_time_counter_read(void);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() ottf_run_time_counter_read()
 
 // Hooks
 #define configUSE_IDLE_HOOK 0
@@ -37,6 +47,12 @@
 
 // Scheduler
 #define configIDLE_SHOULD_YIELD 0
+// There is no periodic tick without preemption, so the idle task just sleeps
+// in `wfi` until an interrupt may have readied a task (see freertos_port.c).
+#define configUSE_TICKLESS_IDLE 1
+void vPortSuppressTicksAndSleep(uint32_t xExpectedIdleTime);
+#define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) \
+  vPortSuppressTicksAndSleep(xExpectedIdleTime)
 #define configMAX_PRIORITIES 5
 #define configTICK_RATE_HZ ((TickType_t)10)  // 100ms tick rate
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
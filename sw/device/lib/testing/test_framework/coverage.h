@@ -11,6 +11,9 @@
  * This function must be called at the end of a test. Note that this profile
  * data is raw and must be indexed before it can be used to generate coverage
  * reports.
+ *
+ * The buffer is sent compressed with PackBits; see
+ * util/coverage/device_profile_data.py for the host side.
  */
 void coverage_send_buffer(void);
 
@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "external/llvm_compiler_rt/lib/profile/InstrProfiling.h"
@@ -23,11 +24,84 @@ int __llvm_profile_runtime;
  */
 static char buf[0x8000] = {0};
 
+enum {
+  /**
+   * Number of compressed bytes sent per line.
+   */
+  kLineBytes = 64,
+  /**
+   * Longest literal or run of a PackBits packet.
+   */
+  kPackBitsMaxLength = 128,
+};
+
+/**
+ * Compressed bytes that are waiting to be sent.
+ */
+static uint8_t line[kLineBytes];
+static size_t line_len;
+
 /**
- * Sends the given buffer as a hex string over UART.
+ * Sends the buffered compressed bytes as a line of hex.
  *
- * Lines are limited to 80 characters. Longer buffers will be broken to multiple
- * lines.
+ * This uses `base_printf()` rather than `LOG_INFO()`: the lines don't need a
+ * log prefix, and their arguments point to RAM, which can't be decoded in
+ * binary log mode.
+ */
+static void line_flush(void) {
+  if (line_len > 0) {
+    base_printf("%!y\r\n", line_len, line);
+    line_len = 0;
+  }
+}
+
+static void line_put(uint8_t byte) {
+  line[line_len++] = byte;
+  if (line_len == kLineBytes) {
+    line_flush();
+  }
+}
+
+/**
+ * Sends `data` compressed with PackBits.
+ *
+ * Each packet starts with a header byte `n`: if `n < 128`, the next `n + 1`
+ * bytes are literals; if `n > 128`, the next byte is repeated `257 - n` times.
+ * The profile data is mostly zeroed counters, so this typically sends a
+ * fraction of its size, and the packets are sent as soon as they are encoded
+ * instead of after the whole buffer.
+ */
+static void send_packbits(const uint8_t *data, size_t len) {
+  size_t i = 0;
+  while (i < len) {
+    size_t run = 1;
+    while (i + run < len && run < kPackBitsMaxLength &&
+           data[i + run] == data[i]) {
+      ++run;
+    }
+    if (run >= 3) {
+      line_put((uint8_t)(257 - run));
+      line_put(data[i]);
+      i += run;
+      continue;
+    }
+    // Collect literals up to the start of the next run of three.
+    size_t start = i;
+    while (i < len && i - start < kPackBitsMaxLength &&
+           !(i + 2 < len && data[i] == data[i + 1] &&
+             data[i] == data[i + 2])) {
+      ++i;
+    }
+    line_put((uint8_t)(i - start - 1));
+    for (size_t j = start; j < i; ++j) {
+      line_put(data[j]);
+    }
+  }
+  line_flush();
+}
+
+/**
+ * Sends the profile buffer compressed with PackBits, as lines of hex.
  */
 void coverage_send_buffer(void) {
   // It looks like we don't have a way to read the profile buffer incrementally.
@@ -43,25 +117,9 @@ void coverage_send_buffer(void) {
     __llvm_profile_write_buffer(buf);
     // Send the buffer along with its length and CRC32.
     uint32_t checksum = crc32(buf, buf_size);
-    LOG_INFO("LLVM profile data (length: %u bytes, CRC32: 0x%08x):",
+    LOG_INFO("LLVM profile data (PackBits, length: %u bytes, CRC32: 0x%08x):",
              (uint32_t)buf_size, checksum);
-    enum {
-      kBytesPerLine = 40,
-      // Print one less byte in the first line to account for "0x".
-      kBytesFirstLine = kBytesPerLine - 1,
-    };
-    size_t bytes_this_line =
-        buf_size < kBytesFirstLine ? buf_size : kBytesFirstLine;
-    char *read_ptr = (char *)buf + buf_size - bytes_this_line;
-    LOG_INFO("0x%!x", bytes_this_line, read_ptr);
-    buf_size -= bytes_this_line;
-    while (buf_size > 0) {
-      size_t bytes_this_line =
-          buf_size < kBytesPerLine ? buf_size : kBytesPerLine;
-      read_ptr -= bytes_this_line;
-      LOG_INFO("%!x", bytes_this_line, read_ptr);
-      buf_size -= bytes_this_line;
-    }
+    send_packbits((const uint8_t *)buf, buf_size);
   }
   // Send `EOT` so that `cat` can exit. Note that this requires enabling
   // `icanon` using `stty`.
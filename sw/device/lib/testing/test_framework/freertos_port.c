@@ -4,6 +4,8 @@
 
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/dif/dif_rv_timer.h"
+#include "sw/device/lib/runtime/hart.h"
+#include "sw/device/lib/runtime/ibex.h"
 #include "sw/device/lib/runtime/irq.h"
 #include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/testing/test_framework/FreeRTOSConfig.h"
@@ -85,6 +87,36 @@ void vPortSetupTimerInterrupt(void) {
 
 #endif  // configUSE_PREEMPTION
 
+// ----------------------------------------------------------------------------
+// Run-time Stats
+//
+// FreeRTOS keeps the counters in 32 bits, which `mcycle` overflows in well
+// under a minute at full speed. Dropping the low bits trades resolution for
+// range.
+// ----------------------------------------------------------------------------
+uint32_t ottf_run_time_counter_read(void) {
+  return (uint32_t)(ibex_mcycle_read() >> OTTF_RUN_TIME_COUNTER_SHIFT);
+}
+
+// ----------------------------------------------------------------------------
+// Idle
+//
+// The idle task only runs when no OTTF task is ready, and all OTTF tasks run
+// above the idle priority, so there is nothing to do until an interrupt
+// unblocks one of them. The scheduler is suspended here, so a task readied by
+// an ISR goes to the pending ready list, which
+// `eTaskConfirmSleepModeStatus()` checks with interrupts disabled. `wfi`
+// still wakes on a pending interrupt while they are disabled, and the ISR
+// runs as soon as they are enabled again.
+// ----------------------------------------------------------------------------
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime) {
+  irq_global_ctrl(false);
+  if (eTaskConfirmSleepModeStatus() != eAbortSleep) {
+    wait_for_interrupt();
+  }
+  irq_global_ctrl(true);
+}
+
 // ----------------------------------------------------------------------------
 // Scheduler Setup
 // ----------------------------------------------------------------------------
@@ -36,10 +36,20 @@ enum {
   kSpiDeviceRxCommitWait = 63,  // clock cycles
   /**
    * Flow control parameters.
+   *
+   * The watermarks are levels of the RX ring and FIFO together.
    */
-  kFlowControlLowWatermark = 4,   // bytes
-  kFlowControlHighWatermark = 8,  // bytes
+  kFlowControlLowWatermark = 128,   // bytes
+  kFlowControlHighWatermark = 224,  // bytes
   kFlowControlRxWatermark = kDifUartWatermarkByte8,
+  /**
+   * Size of the RX ring used with flow control (a power of two).
+   */
+  kRxRingSize = 256,  // bytes
+  /**
+   * Size of the buffer for stdout.
+   */
+  kStdoutBufferSize = 512,  // bytes
   /**
    * HART PLIC Target.
    */
@@ -54,13 +64,62 @@ static dif_uart_t ottf_console_uart;
 static sink_func_ptr sink;
 // Function pointer to a function that retrieves a single character.
 static status_t (*getc)(void *);
+// Function pointer to a function that retrieves the available characters.
+static status_t (*getbuf)(void *, char *, size_t);
+// Whether `ottf_console_init()` has been deferred until the console is used.
+static bool init_deferred;
 
 // The `flow_control_state` and `flow_control_irqs` variables are shared between
 // the interrupt service handler and user code.
 static volatile ottf_console_flow_control_t flow_control_state;
 static volatile uint32_t flow_control_irqs;
 
+// With flow control, the RX watermark interrupt moves what the UART receives
+// into this ring, so that the RX FIFO doesn't overflow while the test is busy
+// and the host doesn't have to be paused every few bytes. The ring is only
+// filled from the ISR or with the UART interrupts disabled, and only emptied
+// by `uart_getc` and `uart_getbuf`. The indices are free-running.
+static uint8_t rx_ring[kRxRingSize];
+static volatile uint32_t rx_ring_head;
+static volatile uint32_t rx_ring_tail;
+
+// Stdout is buffered, so that the many small writes that make up a line of
+// output reach the console in one piece. On the SPI device, which sends a
+// frame for every write, lines are also packed together into larger frames.
+static char stdout_buf[kStdoutBufferSize];
+static base_buffered_sink_t stdout_buffered;
+
+static void buffer_stdout(buffer_sink_t out, bool flush_on_newline) {
+  stdout_buffered = (base_buffered_sink_t){
+      .out = out,
+      .buf = stdout_buf,
+      .size = sizeof(stdout_buf),
+      .flush_on_newline = flush_on_newline,
+  };
+  base_set_stdout(base_buffered_sink(&stdout_buffered));
+}
+
+// Initializes the console if that was deferred and hasn't happened yet.
+static void console_init_if_deferred(void) {
+  if (init_deferred) {
+    ottf_console_init();
+  }
+}
+
+// The stdout sink until the console is initialized. Once it is, stdout has
+// been replaced, and the rest of the output is passed on to it.
+static size_t deferred_stdout_sink(void *data, const char *buf, size_t len) {
+  if (init_deferred) {
+    // Anything printed while the console is being initialized is dropped,
+    // rather than coming back here.
+    base_set_stdout((buffer_sink_t){.data = NULL, .sink = NULL});
+    ottf_console_init();
+  }
+  return base_printf("%!s", len, buf);
+}
+
 void *ottf_console_get(void) {
+  console_init_if_deferred();
   switch (kOttfTestConfig.console.type) {
     case kOttfConsoleSpiDevice:
       return &ottf_console_spi_device;
@@ -69,14 +128,96 @@ void *ottf_console_get(void) {
   }
 }
 
+// Moves the contents of the RX FIFO into the RX ring, as far as it fits.
+static void rx_ring_fill(const dif_uart_t *uart) {
+  uint32_t head = rx_ring_head;
+  uint32_t space = kRxRingSize - (head - rx_ring_tail);
+  while (space > 0) {
+    uint32_t pos = head % kRxRingSize;
+    size_t len = kRxRingSize - pos < space ? kRxRingSize - pos : space;
+    size_t received = 0;
+    CHECK_DIF_OK(dif_uart_bytes_receive(uart, len, &rx_ring[pos], &received));
+    head += (uint32_t)received;
+    space -= (uint32_t)received;
+    if (received < len) {
+      break;
+    }
+  }
+  rx_ring_head = head;
+}
+
+// Waits until the RX ring has something in it, and returns how much.
+static size_t rx_ring_wait(const dif_uart_t *uart) {
+  // The RX watermark interrupt doesn't fire for the last few bytes of a
+  // transfer, so also check the FIFO.
+  while (rx_ring_head == rx_ring_tail) {
+    dif_uart_irq_enable_snapshot_t snapshot;
+    CHECK_DIF_OK(dif_uart_irq_disable_all(uart, &snapshot));
+    rx_ring_fill(uart);
+    CHECK_DIF_OK(dif_uart_irq_restore_all(uart, &snapshot));
+  }
+  return rx_ring_head - rx_ring_tail;
+}
+
 static status_t uart_getc(void *io) {
   const dif_uart_t *uart = (const dif_uart_t *)io;
   uint8_t byte;
-  TRY(dif_uart_byte_receive_polled(uart, &byte));
+  if (flow_control_state == kOttfConsoleFlowControlNone) {
+    TRY(dif_uart_byte_receive_polled(uart, &byte));
+  } else {
+    rx_ring_wait(uart);
+    byte = rx_ring[rx_ring_tail % kRxRingSize];
+    rx_ring_tail += 1;
+  }
   TRY(ottf_console_flow_control(uart, kOttfConsoleFlowControlAuto));
   return OK_STATUS(byte);
 }
 
+static status_t uart_getbuf(void *io, char *buf, size_t len) {
+  const dif_uart_t *uart = (const dif_uart_t *)io;
+  size_t received = 0;
+  if (flow_control_state == kOttfConsoleFlowControlNone) {
+    // Wait for the first character, then take whatever else is in the FIFO.
+    TRY(dif_uart_byte_receive_polled(uart, (uint8_t *)buf));
+    TRY(dif_uart_bytes_receive(uart, len - 1, (uint8_t *)buf + 1, &received));
+    received += 1;
+  } else {
+    size_t available = rx_ring_wait(uart);
+    uint32_t tail = rx_ring_tail;
+    while (received < len && received < available) {
+      uint32_t pos = tail % kRxRingSize;
+      size_t n = kRxRingSize - pos;
+      if (n > len - received) {
+        n = len - received;
+      }
+      if (n > available - received) {
+        n = available - received;
+      }
+      memcpy(buf + received, &rx_ring[pos], n);
+      received += n;
+      tail += (uint32_t)n;
+    }
+    rx_ring_tail = tail;
+  }
+  TRY(ottf_console_flow_control(uart, kOttfConsoleFlowControlAuto));
+  return OK_STATUS(received);
+}
+
+// The last upload received by `spi_device_getc` and `spi_device_getbuf`, and
+// how much of it has been read.
+static upload_info_t spi_device_upload;
+static size_t spi_device_upload_index;
+
+static void spi_device_wait_for_data(dif_spi_device_handle_t *spi_device) {
+  if (spi_device_upload_index == spi_device_upload.data_len) {
+    memset(&spi_device_upload, 0, sizeof(upload_info_t));
+    CHECK_STATUS_OK(
+        spi_device_testutils_wait_for_upload(spi_device, &spi_device_upload));
+    spi_device_upload_index = 0;
+    CHECK_DIF_OK(dif_spi_device_set_flash_status_registers(spi_device, 0x00));
+  }
+}
+
 /*
  * The user of this function needs to be aware of the following:
  * 1. The exact amount of data expected to be sent from the host side must be
@@ -85,17 +226,19 @@ static status_t uart_getc(void *io) {
  * available. Failure to do so may result in an SPI transaction timeout.
  */
 static status_t spi_device_getc(void *io) {
-  static size_t index = 0;
-  static upload_info_t info = {0};
-  dif_spi_device_handle_t *spi_device = (dif_spi_device_handle_t *)io;
-  if (index == info.data_len) {
-    memset(&info, 0, sizeof(upload_info_t));
-    CHECK_STATUS_OK(spi_device_testutils_wait_for_upload(spi_device, &info));
-    index = 0;
-    CHECK_DIF_OK(dif_spi_device_set_flash_status_registers(spi_device, 0x00));
-  }
+  spi_device_wait_for_data((dif_spi_device_handle_t *)io);
+  return OK_STATUS(spi_device_upload.data[spi_device_upload_index++]);
+}
 
-  return OK_STATUS(info.data[index++]);
+static status_t spi_device_getbuf(void *io, char *buf, size_t len) {
+  spi_device_wait_for_data((dif_spi_device_handle_t *)io);
+  size_t available = spi_device_upload.data_len - spi_device_upload_index;
+  if (len > available) {
+    len = available;
+  }
+  memcpy(buf, &spi_device_upload.data[spi_device_upload_index], len);
+  spi_device_upload_index += len;
+  return OK_STATUS(len);
 }
 
 static void spi_device_wait_for_sync(dif_spi_device_handle_t *spi_device) {
@@ -121,6 +264,7 @@ static void spi_device_wait_for_sync(dif_spi_device_handle_t *spi_device) {
 }
 
 void ottf_console_init(void) {
+  init_deferred = false;
   // Initialize/Configure the console device.
   uintptr_t base_addr = kOttfTestConfig.console.base_addr;
   switch (kOttfTestConfig.console.type) {
@@ -135,11 +279,13 @@ void ottf_console_init(void) {
       ottf_console_configure_uart(base_addr);
       sink = get_uart_sink();
       getc = uart_getc;
+      getbuf = uart_getbuf;
       break;
     case (kOttfConsoleSpiDevice):
       ottf_console_configure_spi_device(base_addr);
       sink = get_spi_device_sink();
       getc = spi_device_getc;
+      getbuf = spi_device_getbuf;
       break;
     default:
       CHECK(false, "unsupported OTTF console interface.");
@@ -147,6 +293,11 @@ void ottf_console_init(void) {
   }
 }
 
+void ottf_console_init_deferred(void) {
+  init_deferred = true;
+  base_set_stdout((buffer_sink_t){.data = NULL, .sink = deferred_stdout_sink});
+}
+
 void ottf_console_configure_uart(uintptr_t base_addr) {
   CHECK_DIF_OK(
       dif_uart_init(mmio_region_from_addr(base_addr), &ottf_console_uart));
@@ -163,6 +314,9 @@ void ottf_console_configure_uart(uintptr_t base_addr) {
                               .rx_enable = kDifToggleEnabled,
                           }));
   base_uart_stdout(&ottf_console_uart);
+  buffer_stdout(
+      (buffer_sink_t){.data = &ottf_console_uart, .sink = get_uart_sink()},
+      /*flush_on_newline=*/true);
 
   // Initialize/Configure console flow control (if requested).
   if (kOttfTestConfig.enable_uart_flow_control) {
@@ -253,6 +407,12 @@ void ottf_console_configure_spi_device(uintptr_t base_addr) {
   }
   spi_device_wait_for_sync(&ottf_console_spi_device);
   base_spi_device_stdout(&ottf_console_spi_device);
+  // The host polls for frames, so there is no need to send each line in its
+  // own frame; output is flushed when the buffer fills up, and by the OTTF
+  // before the test status is reported and before waiting for the host.
+  buffer_stdout((buffer_sink_t){.data = &ottf_console_spi_device,
+                                .sink = get_spi_device_sink()},
+                /*flush_on_newline=*/false);
 }
 
 static uint32_t get_flow_control_watermark_plic_id(void) {
@@ -308,6 +468,7 @@ static status_t manage_flow_control(const dif_uart_t *uart,
   if (ctrl == kOttfConsoleFlowControlAuto) {
     uint32_t avail;
     TRY(dif_uart_rx_bytes_available(uart, &avail));
+    avail += rx_ring_head - rx_ring_tail;
     if (avail < kFlowControlLowWatermark &&
         flow_control_state != kOttfConsoleFlowControlResume) {
       // Enable RX watermark interrupt when RX FIFO level is below the
@@ -338,6 +499,7 @@ bool ottf_console_flow_control_isr(uint32_t *exc_info) {
   bool rx;
   CHECK_DIF_OK(dif_uart_irq_is_pending(uart, kDifUartIrqRxWatermark, &rx));
   if (rx) {
+    rx_ring_fill(uart);
     manage_flow_control(uart, kOttfConsoleFlowControlAuto);
     CHECK_DIF_OK(dif_uart_irq_acknowledge(uart, kDifUartIrqRxWatermark));
     return true;
@@ -367,6 +529,7 @@ size_t ottf_console_spi_device_read(size_t buf_size, uint8_t *const buf) {
   size_t received_data_len = 0;
   upload_info_t info;
   memset(&info, 0, sizeof(upload_info_t));
+  base_flush();
   while (!spi_tx_last_data_chunk(&info)) {
     CHECK_STATUS_OK(
         spi_device_testutils_wait_for_upload(&ottf_console_spi_device, &info));
@@ -387,6 +550,9 @@ size_t ottf_console_spi_device_read(size_t buf_size, uint8_t *const buf) {
 }
 
 status_t ottf_console_putbuf(void *io, const char *buf, size_t len) {
+  // This bypasses stdout, so flush it first to keep the output in order.
+  base_flush();
+  console_init_if_deferred();
   size_t written_len = sink(io, buf, len);
   if (len != written_len) {
     return DATA_LOSS((int32_t)(len - written_len));
@@ -394,4 +560,14 @@ status_t ottf_console_putbuf(void *io, const char *buf, size_t len) {
   return OK_STATUS((int32_t)len);
 }
 
-status_t ottf_console_getc(void *io) { return getc(io); }
+status_t ottf_console_getc(void *io) {
+  base_flush();
+  console_init_if_deferred();
+  return getc(io);
+}
+
+status_t ottf_console_getbuf(void *io, char *buf, size_t len) {
+  base_flush();
+  console_init_if_deferred();
+  return getbuf(io, buf, len);
+}
@@ -40,6 +40,16 @@ void *ottf_console_get(void);
  */
 void ottf_console_init(void);
 
+/**
+ * Defers the initialization of the OTTF console device until it is first used.
+ *
+ * Until then, stdout is connected to a sink that initializes the console with
+ * `ottf_console_init()` when the first byte is written to it. Reading from the
+ * console, or getting its handle, initializes it too. Tests that never print
+ * anything before they finish don't pay for configuring the console device.
+ */
+void ottf_console_init_deferred(void);
+
 /**
  * Configures the given UART to be used by the OTTF console.
  *
@@ -67,10 +77,11 @@ status_t ottf_console_flow_control(const dif_uart_t *uart,
 /**
  * Enable flow control for the OTTF console.
  *
- * Enables flow control on the UART associated with the OTTF console. Flow
- * control is managed by enabling the RX watermark IRQ and sending a `Pause`
- * (aka XOFF) when the RX FIFO depth reaches 16 bytes.  A `Resume` (aka XON) is
- * sent when the RX FIFO has been drained to 4 bytes.
+ * Enables flow control on the UART associated with the OTTF console. The RX
+ * watermark IRQ moves received data from the RX FIFO into a 256-byte ring,
+ * which the console then reads from. A `Pause` (aka XOFF) is sent when the
+ * ring and FIFO hold 224 bytes, and a `Resume` (aka XON) when they have been
+ * drained to 128 bytes.
  *
  * This function configures UART interrupts at the PLIC and enables interrupts
  * at the CPU.
@@ -126,4 +137,17 @@ status_t ottf_console_putbuf(void *io, const char *buf, size_t len);
  */
 status_t ottf_console_getc(void *io);
 
+/**
+ * Get the available characters from the OTTF console.
+ *
+ * Waits for at least one character, then returns as many of the characters
+ * already received (up to `len`) as can be read without waiting again.
+ *
+ * @param io An IO context.
+ * @param[out] buf The buffer to write the characters into.
+ * @param len The length of the buffer.
+ * @return The number of characters read or an error.
+ */
+status_t ottf_console_getbuf(void *io, char *buf, size_t len);
+
 #endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_CONSOLE_H_
@@ -4,6 +4,8 @@
 
 #include "sw/device/lib/testing/test_framework/ottf_isrs.h"
 
+#include <stddef.h>
+
 #include "sw/device/lib/base/csr.h"
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/dif/dif_rv_plic.h"
@@ -97,6 +99,8 @@ void ottf_generic_fault_print(uint32_t *exc_info, const char *reason,
   }
   LOG_ERROR("FAULT: %s. MCAUSE=%08x MEPC=%08x MTVAL=%08x", reason, mcause, mepc,
             mtval);
+  // The callers stop here, so don't leave any of this in the stdout buffer.
+  base_flush();
 }
 
 static void generic_fault_handler(uint32_t *exc_info) {
@@ -183,8 +187,17 @@ void ottf_software_isr(uint32_t *exc_info) {
   abort();
 }
 
+OT_WEAK
+bool ottf_pc_sampler_isr(uint32_t *exc_info) { return false; }
+
+OT_WEAK
+bool ottf_timing_isr(uint32_t *exc_info) { return false; }
+
 OT_WEAK
 void ottf_timer_isr(uint32_t *exc_info) {
+  if (ottf_timing_isr(exc_info) || ottf_pc_sampler_isr(exc_info)) {
+    return;
+  }
   ottf_generic_fault_print(exc_info, "Timer IRQ", ibex_mcause_read());
   abort();
 }
@@ -192,25 +205,82 @@ void ottf_timer_isr(uint32_t *exc_info) {
 OT_WEAK
 bool ottf_console_flow_control_isr(uint32_t *exc_info) { return false; }
 
+enum {
+  kOttfExternalIrqCount = kTopEarlgreyPlicIrqIdLast + 1,
+};
+
+typedef struct external_isr_entry {
+  ottf_external_isr_handler_t handler;
+  void *ctx;
+} external_isr_entry_t;
+
+static external_isr_entry_t external_isr_table[kOttfExternalIrqCount];
+static ottf_external_isr_stats_t external_isr_stats[kOttfExternalIrqCount];
+static bool external_isr_stats_enabled;
+
+void ottf_external_isr_register(dif_rv_plic_irq_id_t irq_id,
+                                ottf_external_isr_handler_t handler,
+                                void *ctx) {
+  CHECK(irq_id > kTopEarlgreyPlicIrqIdNone && irq_id < kOttfExternalIrqCount,
+        "Invalid PLIC IRQ ID: %d", irq_id);
+  external_isr_table[irq_id] = (external_isr_entry_t){
+      .handler = handler,
+      .ctx = ctx,
+  };
+}
+
+void ottf_external_isr_stats_enable(bool enabled) {
+  if (enabled) {
+    for (size_t i = 0; i < kOttfExternalIrqCount; ++i) {
+      external_isr_stats[i] = (ottf_external_isr_stats_t){0};
+    }
+  }
+  external_isr_stats_enabled = enabled;
+}
+
+ottf_external_isr_stats_t ottf_external_isr_stats_get(
+    dif_rv_plic_irq_id_t irq_id) {
+  CHECK(irq_id < kOttfExternalIrqCount, "Invalid PLIC IRQ ID: %d", irq_id);
+  return external_isr_stats[irq_id];
+}
+
 OT_WEAK
 void ottf_external_isr(uint32_t *exc_info) {
   const uint32_t kPlicTarget = kTopEarlgreyPlicTargetIbex0;
+  uint64_t entry_cycles = external_isr_stats_enabled ? ibex_mcycle_read() : 0;
   dif_rv_plic_irq_id_t plic_irq_id;
   CHECK_DIF_OK(dif_rv_plic_irq_claim(&ottf_plic, kPlicTarget, &plic_irq_id));
 
-  top_earlgrey_plic_peripheral_t peripheral = (top_earlgrey_plic_peripheral_t)
-      top_earlgrey_plic_interrupt_for_peripheral[plic_irq_id];
+  // Keep servicing until the PLIC has nothing more pending for this target.
+  while (plic_irq_id != kTopEarlgreyPlicIrqIdNone) {
+    const external_isr_entry_t *entry = &external_isr_table[plic_irq_id];
+    if (entry->handler != NULL) {
+      if (external_isr_stats_enabled) {
+        uint32_t latency = (uint32_t)(ibex_mcycle_read() - entry_cycles);
+        ottf_external_isr_stats_t *stats = &external_isr_stats[plic_irq_id];
+        stats->count += 1;
+        stats->total_cycles += latency;
+        if (latency > stats->max_cycles) {
+          stats->max_cycles = latency;
+        }
+      }
+      entry->handler(entry->ctx, plic_irq_id);
+    } else {
+      top_earlgrey_plic_peripheral_t peripheral =
+          (top_earlgrey_plic_peripheral_t)
+              top_earlgrey_plic_interrupt_for_peripheral[plic_irq_id];
+      if (peripheral != kTopEarlgreyPlicPeripheralUart0 ||
+          !ottf_console_flow_control_isr(exc_info)) {
+        ottf_generic_fault_print(exc_info, "External IRQ", ibex_mcause_read());
+        abort();
+      }
+    }
 
-  if (peripheral == kTopEarlgreyPlicPeripheralUart0 &&
-      ottf_console_flow_control_isr(exc_info)) {
     // Complete the IRQ at PLIC.
     CHECK_DIF_OK(
         dif_rv_plic_irq_complete(&ottf_plic, kPlicTarget, plic_irq_id));
-    return;
+    CHECK_DIF_OK(dif_rv_plic_irq_claim(&ottf_plic, kPlicTarget, &plic_irq_id));
   }
-
-  ottf_generic_fault_print(exc_info, "External IRQ", ibex_mcause_read());
-  abort();
 }
 
 static void generic_internal_irq_handler(uint32_t *exc_info) {
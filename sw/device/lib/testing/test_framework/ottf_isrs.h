@@ -4,6 +4,7 @@
 
 #ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_ISRS_H_
 #define OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_ISRS_H_
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "sw/device/lib/dif/dif_rv_plic.h"
@@ -137,6 +138,72 @@ void ottf_timer_isr(uint32_t *exc_info);
  */
 void ottf_external_isr(uint32_t *exc_info);
 
+/**
+ * Handler for a single external (PLIC) interrupt source.
+ *
+ * Called by the default implementation of `ottf_external_isr` after the IRQ
+ * has been claimed; the IRQ is completed once the handler returns.
+ *
+ * @param ctx The context pointer given at registration.
+ * @param irq_id The PLIC IRQ ID being serviced.
+ */
+typedef void (*ottf_external_isr_handler_t)(void *ctx,
+                                            dif_rv_plic_irq_id_t irq_id);
+
+/**
+ * Registers a handler for a PLIC IRQ ID with the default `ottf_external_isr`.
+ *
+ * The default `ottf_external_isr` claims and dispatches IRQs until none are
+ * pending, so a burst of interrupts from several peripherals is handled
+ * without leaving and re-entering the trap handler.
+ *
+ * @param irq_id The PLIC IRQ ID to handle.
+ * @param handler The handler, or NULL to unregister.
+ * @param ctx A pointer passed to the handler.
+ */
+void ottf_external_isr_register(dif_rv_plic_irq_id_t irq_id,
+                                ottf_external_isr_handler_t handler,
+                                void *ctx);
+
+/**
+ * Interrupt latency statistics for a PLIC IRQ ID.
+ *
+ * The latency is measured in cycles from the entry into the default
+ * `ottf_external_isr` to the call of the registered handler.
+ */
+typedef struct ottf_external_isr_stats {
+  /**
+   * Number of times the handler was called while statistics were enabled.
+   */
+  uint32_t count;
+  /**
+   * Largest observed latency.
+   */
+  uint32_t max_cycles;
+  /**
+   * Sum of the observed latencies.
+   */
+  uint64_t total_cycles;
+} ottf_external_isr_stats_t;
+
+/**
+ * Enables or disables latency statistics collection for registered handlers.
+ *
+ * Enabling the collection resets the statistics of all IRQ IDs.
+ *
+ * @param enabled Whether to collect statistics.
+ */
+void ottf_external_isr_stats_enable(bool enabled);
+
+/**
+ * Returns the latency statistics for a PLIC IRQ ID.
+ *
+ * @param irq_id The PLIC IRQ ID.
+ * @return The statistics collected since they were last enabled.
+ */
+ottf_external_isr_stats_t ottf_external_isr_stats_get(
+    dif_rv_plic_irq_id_t irq_id);
+
 /**
  * OTTF external NMI internal IRQ handler.
  *
@@ -12,6 +12,7 @@
 #include "external/freertos/include/task.h"
 #include "sw/device/lib/arch/device.h"
 #include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/math.h"
 #include "sw/device/lib/base/mmio.h"
 #include "sw/device/lib/dif/dif_base.h"
 #include "sw/device/lib/dif/dif_rstmgr.h"
@@ -33,6 +34,25 @@
 
 #define MODULE_ID MAKE_MODULE_ID('o', 't', 'm')
 
+/**
+ * The fast-start profile, enabled with
+ * `--//sw/device/lib/testing/test_framework:fast_start`, trims the work done
+ * before and after `test_main()` for short simulation and FPGA regression
+ * runs:
+ * - The console is initialized the first time it is used, rather than before
+ *   the test starts. Tests that ask for UART flow control, which has to be
+ *   ready before the host sends anything, or that may clobber the console
+ *   still get it up front.
+ * - The "Running" and "Finished" banners are not printed.
+ * - The start of the test is only reported through the test status word.
+ *
+ * The scheduler is only ever started for tests that enable concurrency, and
+ * the lines that report the result of the test are always printed.
+ */
+#ifndef OTTF_FAST_START
+#define OTTF_FAST_START 0
+#endif
+
 // Check layout of test configuration struct since OTTF ISR asm code requires a
 // specific layout.
 OT_ASSERT_MEMBER_OFFSET(ottf_test_config_t, enable_concurrency, 0);
@@ -80,6 +100,49 @@ char *ottf_task_get_self_name(void) {
   return pcTaskGetName(/*xTaskToQuery=*/NULL);
 }
 
+size_t ottf_task_stats_get(ottf_task_stats_t *stats, size_t len,
+                           uint64_t *total_cycles) {
+  // `TaskStatus_t` is too big for the stack of most tasks, and the heap
+  // can't free, so the snapshot goes in `.bss`.
+  static TaskStatus_t task_status[kOttfTaskStatsMaxTasks];
+  uint32_t total_run_time;
+  size_t count = uxTaskGetSystemState(task_status, kOttfTaskStatsMaxTasks,
+                                      &total_run_time);
+  if (count > len) {
+    return 0;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    stats[i] = (ottf_task_stats_t){
+        .name = task_status[i].pcTaskName,
+        .cycles = (uint64_t)task_status[i].ulRunTimeCounter
+                  << OTTF_RUN_TIME_COUNTER_SHIFT,
+    };
+  }
+  if (total_cycles != NULL) {
+    *total_cycles = (uint64_t)total_run_time << OTTF_RUN_TIME_COUNTER_SHIFT;
+  }
+  return count;
+}
+
+void ottf_task_stats_print(void) {
+  ottf_task_stats_t stats[kOttfTaskStatsMaxTasks];
+  uint64_t total_cycles;
+  size_t count =
+      ottf_task_stats_get(stats, kOttfTaskStatsMaxTasks, &total_cycles);
+  if (count == 0) {
+    LOG_WARNING("Too many tasks for ottf_task_stats_print()");
+    return;
+  }
+  // Per mille, so that the shares of short tasks don't round to zero.
+  uint64_t total = total_cycles == 0 ? 1 : total_cycles;
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t share =
+        (uint32_t)udiv64_slow(stats[i].cycles * 1000, total, NULL);
+    LOG_INFO("Task %s: %u.%u%% (%u kcycles)", stats[i].name, share / 10,
+             share % 10, (uint32_t)udiv64_slow(stats[i].cycles, 1000, NULL));
+  }
+}
+
 /* Array holding the report statuses.
  *
  * This is a weak symbol which means that the test can override it to change its
@@ -107,7 +170,7 @@ static void report_test_status(bool result) {
     if (kOttfTestConfig.console.test_may_clobber) {
       ottf_console_init();
     }
-    if (!kOttfTestConfig.silence_console_prints) {
+    if (!OTTF_FAST_START && !kOttfTestConfig.silence_console_prints) {
       LOG_INFO("Finished %s", kOttfTestConfig.file);
     }
   }
@@ -137,19 +200,43 @@ static void report_test_status(bool result) {
   test_status_set(result ? kTestStatusPassed : kTestStatusFailed);
 }
 
+// The PC sampler is only linked into the tests that ask for it; these stand
+// in for it in the others.
+OT_WEAK
+void ottf_pc_sampler_start(uint32_t sample_hz) {
+  LOG_WARNING("PC sampler requested but not linked in");
+}
+
+OT_WEAK
+void ottf_pc_sampler_stop(void) {}
+
+OT_WEAK
+void ottf_pc_sampler_dump(void) {}
+
 // A wrapper function is required to enable `test_main()` and test teardown
 // logic to be invoked as a FreeRTOS task. This wrapper can be used by tests
 // that are run on bare-metal.
 static void test_wrapper(void *task_parameters) {
   // Invoke test hooks that can be overridden by closed-source code.
   bool result = manufacturer_pre_test_hook();
+  if (kOttfTestConfig.pc_sampler_hz != 0) {
+    ottf_pc_sampler_start(kOttfTestConfig.pc_sampler_hz);
+  }
   result = result && test_main();
+  if (kOttfTestConfig.pc_sampler_hz != 0) {
+    ottf_pc_sampler_stop();
+    ottf_pc_sampler_dump();
+  }
   result = result && manufacturer_post_test_hook();
   report_test_status(result);
 }
 
 void _ottf_main(void) {
-  test_status_set(kTestStatusInTest);
+  if (OTTF_FAST_START) {
+    test_status_write(kTestStatusInTest);
+  } else {
+    test_status_set(kTestStatusInTest);
+  }
 
   // Clear reset reason register.
   dif_rstmgr_t rstmgr;
@@ -161,10 +248,18 @@ void _ottf_main(void) {
 
   // Initialize the console to enable logging for non-DV simulation platforms.
   if (kDeviceType != kDeviceSimDV) {
-    ottf_console_init();
-    if (!kOttfTestConfig.silence_console_prints) {
+    if (OTTF_FAST_START && !kOttfTestConfig.enable_uart_flow_control &&
+        !kOttfTestConfig.console.test_may_clobber) {
+      ottf_console_init_deferred();
+    } else {
+      ottf_console_init();
+    }
+    if (!OTTF_FAST_START && !kOttfTestConfig.silence_console_prints) {
       LOG_INFO("Running %s", kOttfTestConfig.file);
     }
+    if (kOttfTestConfig.binary_log) {
+      base_log_set_mode(kLogModeBinary);
+    }
   }
 
   // Initialize a global random number generator testutil context to provide
@@ -6,6 +6,8 @@
 #define OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_MAIN_H_
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "sw/device/lib/base/status.h"
 #include "sw/device/lib/dif/dif_uart.h"
@@ -106,6 +108,53 @@ void ottf_task_delete_self(void);
  */
 char *ottf_task_get_self_name(void);
 
+enum {
+  /**
+   * The most tasks, including the FreeRTOS idle task, that
+   * `ottf_task_stats_get()` reports.
+   */
+  kOttfTaskStatsMaxTasks = 16,
+};
+
+/**
+ * The CPU time of a FreeRTOS task.
+ */
+typedef struct ottf_task_stats {
+  /**
+   * The name of the task.
+   */
+  const char *name;
+  /**
+   * The cycles the task ran for since the scheduler started, rounded down to
+   * a multiple of `1 << OTTF_RUN_TIME_COUNTER_SHIFT`.
+   */
+  uint64_t cycles;
+} ottf_task_stats_t;
+
+/**
+ * Get the CPU time of each FreeRTOS task.
+ *
+ * The cycles of a task are counted from when it is switched in to when it is
+ * switched out, so they include the ISRs that ran in the meantime. Time spent
+ * in the idle task is the time the CPU was idle.
+ *
+ * See the FreeRTOS `uxTaskGetSystemState` documentation for more details:
+ * https://www.freertos.org/uxTaskGetSystemState.html.
+ *
+ * @param[out] stats The stats of up to `len` tasks.
+ * @param len The number of elements of `stats`.
+ * @param[out] total_cycles The cycles since the scheduler started; may be NULL.
+ * @return The number of tasks written to `stats`, or 0 if there were more than
+ * `len` or `kOttfTaskStatsMaxTasks`.
+ */
+size_t ottf_task_stats_get(ottf_task_stats_t *stats, size_t len,
+                           uint64_t *total_cycles);
+
+/**
+ * Log the share of the CPU time of each FreeRTOS task.
+ */
+void ottf_task_stats_print(void);
+
 /**
  * Execute a test function, profile the execution and log the test result.
  * Update the result value if there is a failure code.
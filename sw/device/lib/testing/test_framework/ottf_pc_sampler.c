@@ -0,0 +1,115 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/test_framework/ottf_pc_sampler.h"
+
+#include "sw/device/lib/arch/device.h"
+#include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/dif/dif_rv_timer.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/runtime/print.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+
+enum {
+  kHart = kTopEarlgreyPlicTargetIbex0,
+  kComparator = 0,
+  /**
+   * The RV Timer counts at this rate, and interrupts every `interval` ticks.
+   */
+  kTickHz = 1000000,
+};
+
+extern const char _text_start[], _text_end[];
+
+static dif_rv_timer_t timer;
+static bool running;
+static uintptr_t text_start;
+static uint32_t bucket_shift;
+static uint32_t samples;
+static uint32_t dropped;
+static uint16_t histogram[kOttfPcSamplerBuckets];
+
+void ottf_pc_sampler_start(uint32_t sample_hz) {
+  CHECK(sample_hz > 0 && sample_hz <= kTickHz);
+
+  text_start = (uintptr_t)_text_start;
+  size_t text_size = (uintptr_t)_text_end - text_start;
+  bucket_shift = 2;
+  while ((text_size >> bucket_shift) >= kOttfPcSamplerBuckets) {
+    ++bucket_shift;
+  }
+  samples = 0;
+  dropped = 0;
+  for (size_t i = 0; i < kOttfPcSamplerBuckets; ++i) {
+    histogram[i] = 0;
+  }
+
+  CHECK_DIF_OK(dif_rv_timer_init(
+      mmio_region_from_addr(TOP_EARLGREY_RV_TIMER_BASE_ADDR), &timer));
+  CHECK_DIF_OK(dif_rv_timer_reset(&timer));
+  dif_rv_timer_tick_params_t tick_params;
+  CHECK_DIF_OK(dif_rv_timer_approximate_tick_params(kClockFreqPeripheralHz,
+                                                    kTickHz, &tick_params));
+  CHECK_DIF_OK(dif_rv_timer_set_tick_params(&timer, kHart, tick_params));
+  CHECK_DIF_OK(dif_rv_timer_irq_set_enabled(
+      &timer, kDifRvTimerIrqTimerExpiredHart0Timer0, kDifToggleEnabled));
+  CHECK_DIF_OK(
+      dif_rv_timer_arm(&timer, kHart, kComparator, kTickHz / sample_hz));
+
+  running = true;
+  irq_timer_ctrl(true);
+  irq_global_ctrl(true);
+  CHECK_DIF_OK(
+      dif_rv_timer_counter_set_enabled(&timer, kHart, kDifToggleEnabled));
+}
+
+void ottf_pc_sampler_stop(void) {
+  if (!running) {
+    return;
+  }
+  CHECK_DIF_OK(
+      dif_rv_timer_counter_set_enabled(&timer, kHart, kDifToggleDisabled));
+  CHECK_DIF_OK(dif_rv_timer_irq_set_enabled(
+      &timer, kDifRvTimerIrqTimerExpiredHart0Timer0, kDifToggleDisabled));
+  CHECK_DIF_OK(dif_rv_timer_irq_acknowledge(
+      &timer, kDifRvTimerIrqTimerExpiredHart0Timer0));
+  running = false;
+}
+
+void ottf_pc_sampler_dump(void) {
+  base_printf("PC_SAMPLER: start=0x%08x shift=%u samples=%u dropped=%u\r\n",
+              text_start, bucket_shift, samples, dropped);
+  for (size_t i = 0; i < kOttfPcSamplerBuckets; ++i) {
+    if (histogram[i] != 0) {
+      base_printf("PC_SAMPLE: 0x%08x %u\r\n", text_start + (i << bucket_shift),
+                  histogram[i]);
+    }
+  }
+  base_printf("PC_SAMPLER: end\r\n");
+}
+
+bool ottf_pc_sampler_isr(uint32_t *exc_info) {
+  if (!running) {
+    return false;
+  }
+  uintptr_t offset = ibex_mepc_read() - text_start;
+  size_t bucket = offset >> bucket_shift;
+  ++samples;
+  if (bucket < kOttfPcSamplerBuckets) {
+    if (histogram[bucket] != UINT16_MAX) {
+      ++histogram[bucket];
+    }
+  } else {
+    ++dropped;
+  }
+  // Restart the interval from zero, which also drops the counter below the
+  // comparator so that the interrupt can be cleared.
+  CHECK_DIF_OK(dif_rv_timer_counter_write(&timer, kHart, 0));
+  CHECK_DIF_OK(dif_rv_timer_irq_acknowledge(
+      &timer, kDifRvTimerIrqTimerExpiredHart0Timer0));
+  return true;
+}
@@ -0,0 +1,74 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_PC_SAMPLER_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_PC_SAMPLER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * A statistical profiler for OTTF tests.
+ *
+ * The sampler programs the RV Timer to interrupt the test at a fixed
+ * frequency, and the timer ISR adds the interrupted PC (`mepc`) to a
+ * histogram of the `.text` section held in RAM. At the end of the test the
+ * non-empty buckets are printed to the console, one line each, and can be
+ * symbolized on the host with util/device_sw_utils/symbolize_pc_samples.py.
+ *
+ * To use it, add `//sw/device/lib/testing/test_framework:ottf_pc_sampler` to
+ * the dependencies of the test and set `.pc_sampler_hz` in its OTTF test
+ * config. The OTTF then starts the sampler before `test_main()` and dumps
+ * the histogram after it returns. Tests that don't link the sampler in only
+ * pay for a few weak no-op functions.
+ *
+ * The sampler owns the RV Timer while it is running, so it can't be used by
+ * tests that use the timer themselves or that override `ottf_timer_isr()`.
+ */
+
+enum {
+  /**
+   * Number of buckets of the histogram. The bucket size is the smallest
+   * power of two (of at least 4 bytes) that makes them cover `.text`.
+   */
+  kOttfPcSamplerBuckets = 2048,
+};
+
+/**
+ * Start sampling the PC.
+ *
+ * This resets the histogram, and enables the timer interrupt and the global
+ * interrupt enable.
+ *
+ * @param sample_hz Frequency at which to sample the PC.
+ */
+void ottf_pc_sampler_start(uint32_t sample_hz);
+
+/**
+ * Stop sampling the PC.
+ */
+void ottf_pc_sampler_stop(void);
+
+/**
+ * Print the histogram to the console.
+ *
+ * This writes a `PC_SAMPLER:` header line with the start address of `.text`,
+ * the log2 of the bucket size and the number of samples taken and dropped
+ * (because they were outside `.text`), then a `PC_SAMPLE:` line with the
+ * start address and count of each non-empty bucket, then `PC_SAMPLER: end`.
+ */
+void ottf_pc_sampler_dump(void);
+
+/**
+ * Record a sample from the timer interrupt.
+ *
+ * `ottf_isrs.c` provides a weak definition of this symbol that returns
+ * false, which the sampler overrides when it is linked in.
+ *
+ * @param exc_info The OTTF execution info passed to all ISRs.
+ * @return True if the interrupt was a sampler tick and was handled.
+ */
+bool ottf_pc_sampler_isr(uint32_t *exc_info);
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_PC_SAMPLER_H_
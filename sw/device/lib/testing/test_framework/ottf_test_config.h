@@ -84,6 +84,27 @@ typedef struct ottf_test_config {
    */
   bool silence_console_prints;
 
+  /**
+   * Indicates that the test's logs should be written to the console as binary
+   * records rather than as text (see `kLogModeBinary` in
+   * sw/device/lib/runtime/log.h), to cut the time spent formatting and
+   * sending them. The console output must then be decoded on the host, for
+   * example with util/device_sw_utils/decode_binary_logs.py.
+   *
+   * The lines that report the test status are always written as text, so
+   * that the test harness can find them.
+   */
+  bool binary_log;
+
+  /**
+   * If nonzero, the PC is sampled at this frequency (in Hz) while
+   * `test_main()` runs, and the resulting histogram is printed when it
+   * returns. The test must depend on
+   * `//sw/device/lib/testing/test_framework:ottf_pc_sampler`; see
+   * sw/device/lib/testing/test_framework/ottf_pc_sampler.h.
+   */
+  uint32_t pc_sampler_hz;
+
   /**
    * Name of the file in which `kOttfTestConfig` is defined. Most of the time,
    * this will be the file that defines `test_main()`.
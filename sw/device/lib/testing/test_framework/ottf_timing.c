@@ -0,0 +1,207 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/test_framework/ottf_timing.h"
+
+#include <stddef.h>
+
+#include "sw/device/lib/arch/device.h"
+#include "sw/device/lib/base/math.h"
+#include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/dif/dif_rv_timer.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+
+enum {
+  kHart = kTopEarlgreyPlicTargetIbex0,
+  kComparator = 0,
+  kNsPerSecond = 1000000000,
+};
+
+static dif_rv_timer_t timer;
+static bool running;
+static uint64_t tick_hz;
+static udiv64_reciprocal_t tick_hz_reciprocal;
+static udiv64_reciprocal_t ns_per_second_reciprocal;
+// Scheduled deadlines, earliest first. This is only changed with the timer
+// interrupt disabled, or from the timer ISR itself.
+static ottf_timing_deadline_t *deadlines;
+
+void ottf_timing_init(void) {
+  if (running) {
+    return;
+  }
+
+  // Count every cycle of the peripheral clock, which gives the best
+  // resolution the timer can offer.
+  tick_hz = kClockFreqPeripheralHz;
+  tick_hz_reciprocal = udiv64_reciprocal_init(tick_hz);
+  ns_per_second_reciprocal = udiv64_reciprocal_init(kNsPerSecond);
+  deadlines = NULL;
+
+  CHECK_DIF_OK(dif_rv_timer_init(
+      mmio_region_from_addr(TOP_EARLGREY_RV_TIMER_BASE_ADDR), &timer));
+  CHECK_DIF_OK(dif_rv_timer_reset(&timer));
+  dif_rv_timer_tick_params_t tick_params;
+  CHECK_DIF_OK(
+      dif_rv_timer_approximate_tick_params(tick_hz, tick_hz, &tick_params));
+  CHECK_DIF_OK(dif_rv_timer_set_tick_params(&timer, kHart, tick_params));
+  CHECK_DIF_OK(dif_rv_timer_arm(&timer, kHart, kComparator, UINT64_MAX));
+  CHECK_DIF_OK(dif_rv_timer_irq_set_enabled(
+      &timer, kDifRvTimerIrqTimerExpiredHart0Timer0, kDifToggleEnabled));
+
+  running = true;
+  irq_timer_ctrl(true);
+  CHECK_DIF_OK(
+      dif_rv_timer_counter_set_enabled(&timer, kHart, kDifToggleEnabled));
+}
+
+uint64_t ottf_timing_ticks(void) {
+  ottf_timing_init();
+  uint64_t ticks;
+  CHECK_DIF_OK(dif_rv_timer_counter_read(&timer, kHart, &ticks));
+  return ticks;
+}
+
+uint64_t ottf_timing_tick_hz(void) {
+  ottf_timing_init();
+  return tick_hz;
+}
+
+uint64_t ottf_timing_ticks_to_ns(uint64_t ticks) {
+  ottf_timing_init();
+  // Split the conversion at whole seconds so that the products can't
+  // overflow.
+  uint64_t rem;
+  uint64_t seconds = udiv64_reciprocal(ticks, &tick_hz_reciprocal, &rem);
+  return seconds * kNsPerSecond +
+         udiv64_reciprocal(rem * kNsPerSecond, &tick_hz_reciprocal, NULL);
+}
+
+uint64_t ottf_timing_ns_to_ticks(uint64_t ns) {
+  ottf_timing_init();
+  uint64_t rem;
+  uint64_t seconds = udiv64_reciprocal(ns, &ns_per_second_reciprocal, &rem);
+  return seconds * tick_hz +
+         udiv64_reciprocal(rem * tick_hz + kNsPerSecond - 1,
+                           &ns_per_second_reciprocal, NULL);
+}
+
+uint64_t ottf_timing_now_ns(void) {
+  return ottf_timing_ticks_to_ns(ottf_timing_ticks());
+}
+
+/**
+ * Point the comparator at the earliest deadline.
+ *
+ * If that deadline has already passed, the interrupt fires again as soon as
+ * it is acknowledged (or enabled).
+ */
+static void arm_earliest(void) {
+  uint64_t threshold = deadlines != NULL ? deadlines->ticks : UINT64_MAX;
+  CHECK_DIF_OK(dif_rv_timer_arm(&timer, kHart, kComparator, threshold));
+}
+
+/**
+ * Remove a deadline from the list, returning true if it was in it.
+ */
+static bool unlink_deadline(ottf_timing_deadline_t *deadline) {
+  if (!deadline->scheduled) {
+    return false;
+  }
+  ottf_timing_deadline_t **link = &deadlines;
+  while (*link != deadline) {
+    link = &(*link)->next;
+  }
+  *link = deadline->next;
+  deadline->next = NULL;
+  deadline->scheduled = false;
+  return true;
+}
+
+void ottf_timing_schedule_ns(ottf_timing_deadline_t *deadline,
+                             uint64_t delay_ns, ottf_timing_callback_t callback,
+                             void *ctx) {
+  uint64_t delay_ticks = ottf_timing_ns_to_ticks(delay_ns);
+
+  irq_timer_ctrl(false);
+  if (deadline->scheduled) {
+    unlink_deadline(deadline);
+  } else {
+    deadline->next = NULL;
+  }
+
+  uint64_t now = ottf_timing_ticks();
+  deadline->ticks =
+      delay_ticks > UINT64_MAX - now ? UINT64_MAX : now + delay_ticks;
+  deadline->callback = callback;
+  deadline->ctx = ctx;
+  deadline->scheduled = true;
+
+  ottf_timing_deadline_t **link = &deadlines;
+  while (*link != NULL && (*link)->ticks <= deadline->ticks) {
+    link = &(*link)->next;
+  }
+  deadline->next = *link;
+  *link = deadline;
+
+  arm_earliest();
+  irq_timer_ctrl(true);
+}
+
+bool ottf_timing_cancel(ottf_timing_deadline_t *deadline) {
+  irq_timer_ctrl(false);
+  bool was_scheduled = unlink_deadline(deadline);
+  if (was_scheduled && running) {
+    arm_earliest();
+  }
+  irq_timer_ctrl(true);
+  return was_scheduled;
+}
+
+void ottf_timing_set_flag(void *ctx) { *(volatile bool *)ctx = true; }
+
+void ottf_timing_sleep_ns(uint64_t delay_ns) {
+  volatile bool done = false;
+  ottf_timing_deadline_t wake = {0};
+  ottf_timing_schedule_ns(&wake, delay_ns, ottf_timing_set_flag,
+                          (void *)&done);
+  ATOMIC_WAIT_FOR_INTERRUPT(done);
+}
+
+ottf_timing_timeout_t ottf_timing_timeout_init(uint64_t timeout_ns) {
+  uint64_t timeout_ticks = ottf_timing_ns_to_ticks(timeout_ns);
+  uint64_t now = ottf_timing_ticks();
+  return (ottf_timing_timeout_t){
+      .expiry_ticks =
+          timeout_ticks > UINT64_MAX - now ? UINT64_MAX : now + timeout_ticks,
+  };
+}
+
+bool ottf_timing_timeout_expired(const ottf_timing_timeout_t *timeout) {
+  return ottf_timing_ticks() >= timeout->expiry_ticks;
+}
+
+bool ottf_timing_isr(uint32_t *exc_info) {
+  if (!running) {
+    return false;
+  }
+
+  uint64_t now = ottf_timing_ticks();
+  while (deadlines != NULL && deadlines->ticks <= now) {
+    ottf_timing_deadline_t *deadline = deadlines;
+    deadlines = deadline->next;
+    deadline->next = NULL;
+    deadline->scheduled = false;
+    deadline->callback(deadline->ctx);
+    now = ottf_timing_ticks();
+  }
+
+  // Move the comparator past the current time before acknowledging, or the
+  // interrupt would be raised again straight away.
+  arm_earliest();
+  CHECK_DIF_OK(dif_rv_timer_irq_acknowledge(
+      &timer, kDifRvTimerIrqTimerExpiredHart0Timer0));
+  return true;
+}
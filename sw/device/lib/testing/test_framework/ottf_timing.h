@@ -0,0 +1,229 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_TIMING_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_TIMING_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/runtime/hart.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+
+/**
+ * A timing service for OTTF tests.
+ *
+ * The service runs the RV Timer at the full peripheral clock rate and uses
+ * it as a 64-bit monotonic clock, which is converted to nanoseconds using the
+ * clock frequency of the device the test is running on. On top of it, tests
+ * can schedule callbacks to run from the timer ISR at a deadline, sleep with
+ * `wfi` instead of spinning, and bound polling loops by time.
+ *
+ * The service starts the first time any of its functions is called, and then
+ * keeps the timer interrupt enabled. To use it, add
+ * `//sw/device/lib/testing/test_framework:ottf_timing` to the dependencies
+ * of the test.
+ *
+ * The service owns the RV Timer, so it can't be used together with the PC
+ * sampler, by tests that program the timer themselves or by tests that
+ * override `ottf_timer_isr()`.
+ */
+
+/**
+ * A callback for a deadline, called from the timer ISR.
+ *
+ * @param ctx The context given when the deadline was scheduled.
+ */
+typedef void (*ottf_timing_callback_t)(void *ctx);
+
+/**
+ * A deadline, which is owned by the caller and must stay alive while it is
+ * scheduled.
+ *
+ * The fields are private to the service. A deadline must be zero-initialized
+ * before it is first scheduled.
+ */
+typedef struct ottf_timing_deadline {
+  uint64_t ticks;
+  ottf_timing_callback_t callback;
+  void *ctx;
+  struct ottf_timing_deadline *next;
+  bool scheduled;
+} ottf_timing_deadline_t;
+
+/**
+ * A timeout for a polling loop.
+ */
+typedef struct ottf_timing_timeout {
+  /**
+   * The timer value at which the timeout expires.
+   */
+  uint64_t expiry_ticks;
+} ottf_timing_timeout_t;
+
+/**
+ * Start the service, if it isn't running yet.
+ *
+ * This programs the RV Timer and enables the timer interrupt. It does not
+ * enable the global interrupt enable, which the sleeping waits below do
+ * themselves.
+ */
+void ottf_timing_init(void);
+
+/**
+ * Read the timer.
+ *
+ * @return The number of timer ticks since the service started.
+ */
+uint64_t ottf_timing_ticks(void);
+
+/**
+ * @return The frequency of the timer ticks in Hz.
+ */
+uint64_t ottf_timing_tick_hz(void);
+
+/**
+ * Convert a number of timer ticks to nanoseconds, rounding down.
+ */
+uint64_t ottf_timing_ticks_to_ns(uint64_t ticks);
+
+/**
+ * Convert a number of nanoseconds to timer ticks, rounding up.
+ */
+uint64_t ottf_timing_ns_to_ticks(uint64_t ns);
+
+/**
+ * @return The number of nanoseconds since the service started.
+ */
+uint64_t ottf_timing_now_ns(void);
+
+/**
+ * Schedule a callback.
+ *
+ * The callback is called from the timer ISR once `delay_ns` nanoseconds have
+ * passed. Deadlines that expire at the same tick run in the order in which
+ * they were scheduled. A deadline that is already scheduled is moved. It is
+ * safe to call this from a callback or from another ISR.
+ *
+ * @param deadline The deadline to schedule.
+ * @param delay_ns The delay from now, in nanoseconds.
+ * @param callback The function to call.
+ * @param ctx The argument to pass to `callback`.
+ */
+void ottf_timing_schedule_ns(ottf_timing_deadline_t *deadline,
+                             uint64_t delay_ns, ottf_timing_callback_t callback,
+                             void *ctx);
+
+/**
+ * Cancel a deadline.
+ *
+ * @param deadline The deadline to cancel.
+ * @return True if the deadline was scheduled, or false if it had already run
+ * (or had never been scheduled).
+ */
+bool ottf_timing_cancel(ottf_timing_deadline_t *deadline);
+
+/**
+ * A callback that sets the `volatile bool` pointed to by `ctx` to true.
+ */
+void ottf_timing_set_flag(void *ctx);
+
+/**
+ * Sleep for the given time.
+ *
+ * This waits for interrupts with `wfi` until the time has passed, and
+ * leaves the global interrupt enable set.
+ *
+ * @param delay_ns The time to sleep for, in nanoseconds.
+ */
+void ottf_timing_sleep_ns(uint64_t delay_ns);
+
+/**
+ * Start a timeout.
+ *
+ * @param timeout_ns The duration of the timeout, in nanoseconds.
+ * @return The timeout.
+ */
+OT_WARN_UNUSED_RESULT
+ottf_timing_timeout_t ottf_timing_timeout_init(uint64_t timeout_ns);
+
+/**
+ * Check whether a timeout has expired.
+ *
+ * @param timeout The timeout.
+ * @return True if the timeout has expired.
+ */
+OT_WARN_UNUSED_RESULT
+bool ottf_timing_timeout_expired(const ottf_timing_timeout_t *timeout);
+
+/**
+ * Spin until an expression is true, failing the test if it takes longer than
+ * `timeout_usec` microseconds.
+ *
+ * This is `IBEX_SPIN_FOR` with the timeout measured by the RV Timer rather
+ * than by counting CPU cycles.
+ */
+#define OTTF_TIMING_SPIN_FOR(expr, timeout_usec)                   \
+  do {                                                             \
+    const ottf_timing_timeout_t timeout_ =                         \
+        ottf_timing_timeout_init((uint64_t)(timeout_usec) * 1000); \
+    while (!(expr)) {                                              \
+      CHECK(!ottf_timing_timeout_expired(&timeout_),               \
+            "Timed out after %d usec waiting for " #expr,          \
+            (uint32_t)(timeout_usec));                             \
+    }                                                              \
+  } while (0)
+
+/**
+ * Spin until an expression is true, returning `DEADLINE_EXCEEDED()` from the
+ * calling function if it takes longer than `timeout_usec` microseconds.
+ */
+#define OTTF_TIMING_TRY_SPIN_FOR(expr, timeout_usec)               \
+  do {                                                             \
+    const ottf_timing_timeout_t timeout_ =                         \
+        ottf_timing_timeout_init((uint64_t)(timeout_usec) * 1000); \
+    while (!(expr)) {                                              \
+      if (ottf_timing_timeout_expired(&timeout_)) {                \
+        return DEADLINE_EXCEEDED();                                \
+      }                                                            \
+    }                                                              \
+  } while (0)
+
+/**
+ * Sleep until an expression that is changed by an ISR is true, failing the
+ * test if it takes longer than `timeout_usec` microseconds.
+ *
+ * Unlike the spinning waits, the expression is only checked each time the
+ * hart wakes up from `wfi`, so it must only change in an ISR. This leaves the
+ * global interrupt enable set.
+ */
+#define OTTF_TIMING_WAIT_FOR(expr, timeout_usec)                        \
+  do {                                                                  \
+    volatile bool timed_out_ = false;                                   \
+    ottf_timing_deadline_t timeout_deadline_ = {0};                     \
+    ottf_timing_schedule_ns(&timeout_deadline_,                         \
+                            (uint64_t)(timeout_usec) * 1000,            \
+                            ottf_timing_set_flag, (void *)&timed_out_); \
+    ATOMIC_WAIT_FOR_INTERRUPT((expr) || timed_out_);                    \
+    ottf_timing_cancel(&timeout_deadline_);                             \
+    CHECK((expr) || !timed_out_,                                        \
+          "Timed out after %d usec waiting for " #expr,                 \
+          (uint32_t)(timeout_usec));                                    \
+  } while (0)
+
+/**
+ * Handle a timer interrupt.
+ *
+ * `ottf_isrs.c` provides a weak definition of this symbol that returns
+ * false, which the service overrides when it is linked in.
+ *
+ * @param exc_info The OTTF execution info passed to all ISRs.
+ * @return True if the interrupt was handled.
+ */
+bool ottf_timing_isr(uint32_t *exc_info);
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_TIMING_H_
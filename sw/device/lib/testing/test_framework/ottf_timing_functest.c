@@ -0,0 +1,64 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ottf_timing.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  kSleepNs = 100 * 1000,
+};
+
+static volatile uint32_t fired[4];
+static volatile uint32_t fired_count;
+
+static void record(void *ctx) { fired[fired_count++] = (uintptr_t)ctx; }
+
+bool test_main(void) {
+  uint64_t hz = ottf_timing_tick_hz();
+  CHECK(ottf_timing_ticks_to_ns(hz) == 1000000000);
+  CHECK(ottf_timing_ns_to_ticks(1000000000) == hz);
+  CHECK(ottf_timing_ns_to_ticks(1) == 1);
+
+  uint64_t before = ottf_timing_now_ns();
+  CHECK(ottf_timing_now_ns() >= before);
+
+  // Sleeping should take at least as long as asked, and about as long as the
+  // CPU cycle counter says.
+  uint64_t start_ns = ottf_timing_now_ns();
+  uint64_t start_cycles = ibex_mcycle_read();
+  ottf_timing_sleep_ns(kSleepNs);
+  uint64_t slept_ns = ottf_timing_now_ns() - start_ns;
+  uint64_t slept_cycles = ibex_mcycle_read() - start_cycles;
+  LOG_INFO("Slept for %u ns (%u CPU cycles)", (uint32_t)slept_ns,
+           (uint32_t)slept_cycles);
+  CHECK(slept_ns >= kSleepNs);
+  CHECK(slept_ns < 2 * kSleepNs);
+
+  // Deadlines run in order, whatever the order they were scheduled in.
+  ottf_timing_deadline_t deadlines[4] = {0};
+  ottf_timing_schedule_ns(&deadlines[0], 30000, record, (void *)2);
+  ottf_timing_schedule_ns(&deadlines[1], 10000, record, (void *)0);
+  ottf_timing_schedule_ns(&deadlines[2], 20000, record, (void *)1);
+  ottf_timing_schedule_ns(&deadlines[3], 15000, record, (void *)3);
+  CHECK(ottf_timing_cancel(&deadlines[3]));
+  OTTF_TIMING_WAIT_FOR(fired_count == 3, 1000);
+  for (uint32_t i = 0; i < 3; ++i) {
+    CHECK(fired[i] == i, "Deadline %u ran out of order", i);
+  }
+  CHECK(!ottf_timing_cancel(&deadlines[0]));
+
+  ottf_timing_timeout_t timeout = ottf_timing_timeout_init(20000);
+  CHECK(!ottf_timing_timeout_expired(&timeout));
+  OTTF_TIMING_SPIN_FOR(ottf_timing_timeout_expired(&timeout), 1000);
+
+  return true;
+}
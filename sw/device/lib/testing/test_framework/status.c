@@ -8,13 +8,11 @@
 #include "sw/device/lib/base/mmio.h"
 #include "sw/device/lib/runtime/hart.h"
 #include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/runtime/print.h"
 
-/**
- * Writes the test status to the test status device address.
- *
- * @param test_status current status of the test.
- */
-static void test_status_device_write(test_status_t test_status) {
+void test_status_write(test_status_t test_status) {
+  // Make sure all of the output before the status has reached the console.
+  base_flush();
   if (kDeviceTestStatusAddress != 0) {
     mmio_region_t test_status_device_addr =
         mmio_region_from_addr(kDeviceTestStatusAddress);
@@ -25,20 +23,23 @@ static void test_status_device_write(test_status_t test_status) {
 void test_status_set(test_status_t test_status) {
   switch (test_status) {
     case kTestStatusPassed: {
+      // The test harness looks for these lines, so they are never binary.
+      base_log_set_mode(kLogModeText);
       LOG_INFO("PASS!");
-      test_status_device_write(test_status);
+      test_status_write(test_status);
       abort();
       break;
     }
     case kTestStatusFailed: {
+      base_log_set_mode(kLogModeText);
       LOG_INFO("FAIL!");
-      test_status_device_write(test_status);
+      test_status_write(test_status);
       abort();
       break;
     }
     default: {
       LOG_INFO("test_status_set to 0x%x", test_status);
-      test_status_device_write(test_status);
+      test_status_write(test_status);
       break;
     }
   }
@@ -85,4 +85,15 @@ typedef enum test_status {
  */
 void test_status_set(test_status_t test_status);
 
+/**
+ * Writes `test_status` to #kDeviceTestStatusAddress, without logging it.
+ *
+ * This is for the states that don't end the test, when the test framework
+ * wants to report them as cheaply as possible. Unlike `test_status_set()`, it
+ * always returns.
+ *
+ * @param test_status current status of the test.
+ */
+void test_status_write(test_status_t test_status);
+
 #endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_STATUS_H_
@@ -12,3 +12,33 @@
 ujson_t ujson_ottf_console(void) {
   return ujson_init(ottf_console_get(), ottf_console_getc, ottf_console_putbuf);
 }
+
+ujson_t ujson_ottf_console_buffered(void) {
+  return ujson_init_buffered(ottf_console_get(), ottf_console_getc,
+                             ottf_console_getbuf, ottf_console_putbuf);
+}
+
+status_t ujson_ottf_set_format(ujson_t *uj) {
+  ottf_format_t format;
+  TRY(ujson_deserialize_ottf_format_t(uj, &format));
+  ujson_format_t new_format;
+  switch (format) {
+    case kOttfFormatJson:
+      new_format = kUjsonFormatJson;
+      break;
+    case kOttfFormatBinary:
+      new_format = kUjsonFormatBinary;
+      break;
+    default:
+      return INVALID_ARGUMENT();
+  }
+  RESP_OK_STATUS(uj);
+  uj->format = new_format;
+  return OK_STATUS();
+}
+
+status_t ujson_ottf_binary_header(ujson_t *uj, uint8_t marker, size_t size) {
+  uint32_t size32 = (uint32_t)size;
+  TRY(ujson_putbuf(uj, (const char *)&marker, sizeof(marker)));
+  return ujson_putbuf(uj, (const char *)&size32, sizeof(size32));
+}
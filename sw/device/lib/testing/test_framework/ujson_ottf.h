@@ -33,6 +33,48 @@ extern "C" {
  */
 ujson_t ujson_ottf_console(void);
 
+/**
+ * Initializes and returns a ujson context linked to the OTTF console, which
+ * reads the console in blocks rather than one character at a time.
+ *
+ * The context reads ahead, so it should be the only reader of the console
+ * for as long as it is in use.
+ *
+ * @return An initialized ujson_t context.
+ */
+ujson_t ujson_ottf_console_buffered(void);
+
+/**
+ * Handles a command to change the format of the ujson context.
+ *
+ * Reads an `ottf_format_t` and responds with an OK status in the current
+ * format, after which the context uses the new format.
+ *
+ * @param uj A ujson IO context.
+ * @return OK or an error.
+ */
+status_t ujson_ottf_set_format(ujson_t *uj);
+
+enum {
+  /** The first byte of a binary response with an OK result. */
+  kUjsonOttfBinaryRespOk = 0xfd,
+  /** The first byte of a binary response with an ERR result. */
+  kUjsonOttfBinaryRespErr = 0xfc,
+};
+
+/**
+ * Writes the header of a binary response.
+ *
+ * Should not be used directly.
+ * It is used by other macros such as `RESP_OK`.
+ *
+ * @param uj A ujson IO context.
+ * @param marker `kUjsonOttfBinaryRespOk` or `kUjsonOttfBinaryRespErr`.
+ * @param size The size of the payload of the response.
+ * @return OK or an error.
+ */
+status_t ujson_ottf_binary_header(ujson_t *uj, uint8_t marker, size_t size);
+
 /**
  * Deserialize a ujson message with a CRC.
  * This macro will deserialize the message and then deserialize the CRC and
@@ -67,29 +109,65 @@ ujson_t ujson_ottf_console(void);
  *
  * @param uj_ctx_ A `ujson_t` representing the IO context.
  */
-#define RESP_CRC(uj_ctx_)                         \
-  ({                                              \
-    uint32_t crc = ujson_crc32_finish(uj_ctx_);   \
-    TRY(ujson_putbuf(uj_ctx_, " CRC:", 5));       \
-    TRY(ujson_serialize_uint32_t(uj_ctx_, &crc)); \
-    TRY(ujson_putbuf(uj_ctx_, "\n", 1));          \
-    OK_STATUS();                                  \
+#define RESP_CRC(uj_ctx_)                           \
+  ({                                                \
+    uint32_t crc = ujson_crc32_finish(uj_ctx_);     \
+    if ((uj_ctx_)->format == kUjsonFormatBinary) {  \
+      TRY(ujson_serialize_uint32_t(uj_ctx_, &crc)); \
+    } else {                                        \
+      TRY(ujson_putbuf(uj_ctx_, " CRC:", 5));       \
+      TRY(ujson_serialize_uint32_t(uj_ctx_, &crc)); \
+      TRY(ujson_putbuf(uj_ctx_, "\n", 1));          \
+    }                                               \
+    OK_STATUS();                                    \
+  })
+
+/**
+ * Respond with a binary response.
+ * Should not be used directly.
+ * It is used by other macros such as `RESP_OK`.
+ *
+ * A binary response is the `marker_` byte, the size of the payload (4 bytes,
+ * little-endian), the payload and the CRC32 of the payload (4 bytes,
+ * little-endian).
+ *
+ * @param marker_ `kUjsonOttfBinaryRespOk` or `kUjsonOttfBinaryRespErr`.
+ * @param responder_ A ujson serializer function for `data_`.
+ * @param uj_ctx_ A `ujson_t` representing the IO context.
+ * @param data_ A pointer to the data to send.
+ */
+#define RESP_BINARY(marker_, responder_, uj_ctx_, data_)    \
+  ({                                                       \
+    size_t size = 0;                                       \
+    ujson_t counter = ujson_binary_counter(&size);         \
+    TRY(responder_(&counter, data_));                      \
+    TRY(ujson_ottf_binary_header(uj_ctx_, marker_, size)); \
+    ujson_crc32_reset(uj_ctx_);                            \
+    TRY(responder_(uj_ctx_, data_));                       \
+    RESP_CRC(uj_ctx_);                                     \
+    OK_STATUS();                                           \
   })
 
 /**
  * Respond with an OK result and JSON encoded data.
  *
+ * In the binary format, this sends a binary response instead.
+ *
  * @param responder_ A ujson serializer function for `data_`.
  * @param uj_ctx_ A `ujson_t` representing the IO context.
  * @param data_ A pointer to the data to send.
  */
-#define RESP_OK(responder_, uj_ctx_, data_)    \
-  ({                                           \
-    TRY(ujson_putbuf(uj_ctx_, "RESP_OK:", 8)); \
-    ujson_crc32_reset(uj_ctx_);                \
-    TRY(responder_(uj_ctx_, data_));           \
-    RESP_CRC(uj_ctx_);                         \
-    OK_STATUS();                               \
+#define RESP_OK(responder_, uj_ctx_, data_)                                   \
+  ({                                                                          \
+    if ((uj_ctx_)->format == kUjsonFormatBinary) {                            \
+      RESP_BINARY(kUjsonOttfBinaryRespOk, responder_, uj_ctx_, data_);        \
+    } else {                                                                  \
+      TRY(ujson_putbuf(uj_ctx_, "RESP_OK:", 8));                              \
+      ujson_crc32_reset(uj_ctx_);                                             \
+      TRY(responder_(uj_ctx_, data_));                                        \
+      RESP_CRC(uj_ctx_);                                                      \
+    }                                                                         \
+    OK_STATUS();                                                              \
   })
 
 /**
@@ -108,17 +186,24 @@ ujson_t ujson_ottf_console(void);
 /**
  * Respond with an ERR result and JSON encoded `status_t`.
  *
+ * In the binary format, this sends a binary response instead.
+ *
  * @param uj_ctx_ A `ujson_t` representing the IO context.
  * @param expr_ An expression of type `status_t`.
  */
-#define RESP_ERR(uj_ctx_, expr_)                    \
-  do {                                              \
-    status_t sts = expr_;                           \
-    if (!status_ok(sts)) {                          \
-      TRY(ujson_putbuf(uj_ctx_, "RESP_ERR:", 9));   \
-      TRY(ujson_serialize_status_t(uj_ctx_, &sts)); \
-      RESP_CRC(uj_ctx_);                            \
-    }                                               \
+#define RESP_ERR(uj_ctx_, expr_)                                        \
+  do {                                                                  \
+    status_t sts = expr_;                                               \
+    if (!status_ok(sts)) {                                              \
+      if ((uj_ctx_)->format == kUjsonFormatBinary) {                    \
+        RESP_BINARY(kUjsonOttfBinaryRespErr, ujson_serialize_status_t,  \
+                    uj_ctx_, &sts);                                     \
+      } else {                                                          \
+        TRY(ujson_putbuf(uj_ctx_, "RESP_ERR:", 9));                     \
+        TRY(ujson_serialize_status_t(uj_ctx_, &sts));                   \
+        RESP_CRC(uj_ctx_);                                              \
+      }                                                                 \
+    }                                                                   \
   } while (0)
 
 #ifdef __cplusplus
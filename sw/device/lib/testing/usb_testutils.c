@@ -88,7 +88,8 @@ static bool usb_testutils_transfer_next_part(
   return true;
 }
 
-status_t usb_testutils_poll(usb_testutils_ctx_t *ctx) {
+// Service any events that the usbdev is presently signaling
+static status_t usb_testutils_service(usb_testutils_ctx_t *ctx) {
   uint32_t istate;
 
   // Collect a set of interrupts
@@ -250,6 +251,60 @@ status_t usb_testutils_poll(usb_testutils_ctx_t *ctx) {
   return OK_STATUS();
 }
 
+status_t usb_testutils_poll(usb_testutils_ctx_t *ctx) {
+  if (!ctx->irq_mode) {
+    return usb_testutils_service(ctx);
+  }
+
+  // Nothing to do until the ISR has signaled events
+  if (!ctx->irq_pending) {
+    return OK_STATUS();
+  }
+  dif_usbdev_irq_enable_snapshot_t enables = ctx->irq_enables;
+  ctx->irq_pending = false;
+
+  TRY(usb_testutils_service(ctx));
+
+  // Any events arriving during servicing will raise the interrupt again
+  TRY(dif_usbdev_irq_restore_all(ctx->dev, &enables));
+  return OK_STATUS();
+}
+
+status_t usb_testutils_irq_mode_set(usb_testutils_ctx_t *ctx, bool enable) {
+  TRY_CHECK(ctx != NULL);
+  if (!enable) {
+    TRY(dif_usbdev_irq_disable_all(ctx->dev, NULL));
+    ctx->irq_mode = false;
+    ctx->irq_pending = false;
+    return OK_STATUS();
+  }
+
+  // The interrupts that drive packet transfer and the periodic flushing of IN
+  // endpoints; anything else is collected when these are serviced
+  dif_usbdev_irq_enable_snapshot_t enables =
+      (1u << kDifUsbdevIrqPktReceived) | (1u << kDifUsbdevIrqPktSent) |
+      (1u << kDifUsbdevIrqLinkReset) | (1u << kDifUsbdevIrqFrame);
+  ctx->irq_pending = false;
+  ctx->irq_mode = true;
+  TRY(dif_usbdev_irq_restore_all(ctx->dev, &enables));
+  return OK_STATUS();
+}
+
+status_t usb_testutils_isr(usb_testutils_ctx_t *ctx) {
+  if (ctx->irq_pending) {
+    return OK_STATUS();
+  }
+
+  // Mask everything until the events have been serviced; this is required for
+  // the status-type interrupts, which stay asserted until their cause is
+  // removed
+  dif_usbdev_irq_enable_snapshot_t enables;
+  TRY(dif_usbdev_irq_disable_all(ctx->dev, &enables));
+  ctx->irq_enables = enables;
+  ctx->irq_pending = true;
+  return OK_STATUS();
+}
+
 status_t usb_testutils_transfer_send(usb_testutils_ctx_t *ctx, uint8_t ep,
                                      const uint8_t *data, uint32_t length,
                                      usb_testutils_xfr_flags_t flags) {
@@ -423,6 +478,10 @@ status_t usb_testutils_init(usb_testutils_ctx_t *ctx, bool pinflip,
   ctx->got_frame = false;
   ctx->frame = 0u;
 
+  // Polled operation until usb_testutils_irq_mode_set() is called
+  ctx->irq_mode = false;
+  ctx->irq_pending = false;
+
   TRY(dif_usbdev_init(mmio_region_from_addr(USBDEV_BASE_ADDR), ctx->dev));
 
   dif_usbdev_config_t config = {
@@ -469,6 +528,10 @@ status_t usb_testutils_fin(usb_testutils_ctx_t *ctx) {
     TRY(usb_testutils_endpoint_remove(ctx, ep));
   } while (ep > 0U);
 
+  if (ctx->irq_mode) {
+    TRY(usb_testutils_irq_mode_set(ctx, false));
+  }
+
   // Disconnect from the bus
   TRY(dif_usbdev_interface_enable(ctx->dev, kDifToggleDisabled));
   return OK_STATUS();
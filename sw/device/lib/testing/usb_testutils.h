@@ -140,6 +140,20 @@ struct usb_testutils_ctx {
    * Most recent bus frame number received from host
    */
   uint16_t frame;
+  /**
+   * Are usbdev interrupts enabled, with events signaled by usb_testutils_isr()
+   * rather than discovered by polling?
+   */
+  bool irq_mode;
+  /**
+   * Set by usb_testutils_isr() when events are awaiting service by
+   * usb_testutils_poll(); all usbdev interrupts remain masked meanwhile
+   */
+  volatile bool irq_pending;
+  /**
+   * Interrupt enables to be restored once the pending events are serviced
+   */
+  volatile dif_usbdev_irq_enable_snapshot_t irq_enables;
 
   /**
    * IN endpoints
@@ -349,12 +363,44 @@ status_t usb_testutils_transfer_send(usb_testutils_ctx_t *ctx, uint8_t ep,
 /**
  * Call regularly to poll the usbdev interface
  *
+ * In interrupt mode this returns immediately unless usb_testutils_isr() has
+ * signaled events, so a worker task may instead sleep until then.
+ *
  * @param ctx usb test utils context pointer
  * @return The result of the operation
  */
 OT_WARN_UNUSED_RESULT
 status_t usb_testutils_poll(usb_testutils_ctx_t *ctx);
 
+/**
+ * Select between polled and interrupt-driven operation
+ *
+ * In interrupt mode the usbdev interrupts needed to drive packet transfer are
+ * enabled and the caller must route the usbdev interrupt to
+ * usb_testutils_isr(); packets are still processed, and callbacks invoked, by
+ * usb_testutils_poll().
+ *
+ * @param ctx usb test utils context pointer
+ * @param enable true to select interrupt mode, false to return to polling
+ * @return The result of the operation
+ */
+OT_WARN_UNUSED_RESULT
+status_t usb_testutils_irq_mode_set(usb_testutils_ctx_t *ctx, bool enable);
+
+/**
+ * Interrupt handler for usbdev in interrupt mode
+ *
+ * To be called from the external interrupt handler after the PLIC has been
+ * claimed for a usbdev interrupt. This does not touch the buffer pool or
+ * invoke any callbacks; it masks all usbdev interrupts and signals
+ * usb_testutils_poll(), which unmasks them once it has serviced the events.
+ *
+ * @param ctx usb test utils context pointer
+ * @return The result of the operation
+ */
+OT_WARN_UNUSED_RESULT
+status_t usb_testutils_isr(usb_testutils_ctx_t *ctx);
+
 /**
  * Finalize the usbdev interface
  *
@@ -14,6 +14,7 @@
 
 #include "sw/device/lib/testing/usb_testutils_streams.h"
 
+#include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/runtime/print.h"
 #include "sw/device/lib/testing/test_framework/check.h"
 #include "sw/device/lib/testing/usb_testutils_diags.h"
@@ -27,7 +28,7 @@ static const enum {
   kReadMethodNone = 0u,  // Just discard the data; do not read it from usbdev
   kReadMethodStandard,   // Use standard dif_usbdev_buffer_read() function
   kReadMethodFaster      // Faster implementation
-} read_method = kReadMethodStandard;
+} read_method = USBUTILS_MEM_FASTER ? kReadMethodFaster : kReadMethodStandard;
 
 /**
  * Write method to be employed
@@ -35,13 +36,70 @@ static const enum {
 static const enum {
   kWriteMethodStandard = 1u,  // Use standard dif_usbdev_buffer_write() function
   kWriteMethodFaster          // Faster implementation
-} write_method = kWriteMethodStandard;
+} write_method =
+    USBUTILS_MEM_FASTER ? kWriteMethodFaster : kWriteMethodStandard;
 
 /**
  * Diagnostic logging; expensive
  */
 static bool log_traffic = false;
 
+/**
+ * Four successive outputs of the byte-wide LFSR, packed little-endian, for
+ * each possible LFSR state; this lets the data generation and checking proceed
+ * a word at a time. The byte stream itself is unchanged.
+ */
+static uint32_t lfsr_words[256];
+static bool lfsr_words_valid = false;
+
+// Populate the table of LFSR words
+static void lfsr_words_init(void) {
+  if (!lfsr_words_valid) {
+    for (unsigned idx = 0u; idx < ARRAYSIZE(lfsr_words); idx++) {
+      uint8_t lfsr = (uint8_t)idx;
+      uint32_t word = 0u;
+      for (unsigned shift = 0u; shift < 32u; shift += 8u) {
+        word |= (uint32_t)lfsr << shift;
+        lfsr = LFSR_ADVANCE(lfsr);
+      }
+      lfsr_words[idx] = word;
+    }
+    lfsr_words_valid = true;
+  }
+}
+
+// Return the next four bytes of LFSR output as a word, advancing the LFSR
+static inline uint32_t lfsr_word(uint8_t *lfsr) {
+  uint32_t word = lfsr_words[*lfsr];
+  *lfsr = LFSR_ADVANCE((uint8_t)(word >> 24));
+  return word;
+}
+
+// Return the next `n` (< 4) bytes of LFSR output in the LSBs of a word,
+// advancing the LFSR
+static inline uint32_t lfsr_partial_word(uint8_t *lfsr, unsigned n) {
+  uint32_t word = 0u;
+  for (unsigned shift = 0u; shift < (n << 3); shift += 8u) {
+    word |= (uint32_t)*lfsr << shift;
+    *lfsr = LFSR_ADVANCE(*lfsr);
+  }
+  return word;
+}
+
+// Report the first mismatching byte of a received word; does not return
+static void lfsr_mismatch(const usbdev_stream_t *s, uint32_t expected,
+                          uint32_t actual, uint8_t rxtx_lfsr, uint8_t rx_lfsr) {
+  // Locate the offending byte, keeping the LFSRs in step for the report
+  while (!((expected ^ actual) & 0xffu)) {
+    expected >>= 8;
+    actual >>= 8;
+    rxtx_lfsr = LFSR_ADVANCE(rxtx_lfsr);
+    rx_lfsr = LFSR_ADVANCE(rx_lfsr);
+  }
+  CHECK(false, "S%u: Unexpected received data 0x%02x : (LFSRs 0x%02x 0x%02x)",
+        s->id, actual & 0xffu, rxtx_lfsr, rx_lfsr);
+}
+
 // Determine the length of the next packet in the data stream, _including_
 // any required signature.
 static uint8_t packet_length(const usbdev_stream_t *s, uint32_t bytes_done,
@@ -229,6 +287,45 @@ static bool buffer_sig_check(usb_testutils_streams_ctx_t *ctx,
   return true;
 }
 
+#if USBUTILS_MEM_FASTER
+// Fill a buffer with LFSR-generated data, producing it a word at a time
+// directly into the packet buffer memory rather than staging it locally
+static void buffer_fill_direct(usb_testutils_streams_ctx_t *ctx,
+                               usbdev_stream_t *s, dif_usbdev_buffer_t *buf,
+                               uint8_t num_bytes) {
+  usb_testutils_ctx_t *usbdev = ctx->usbdev;
+  dif_usbdev_buffer_span_t span;
+  CHECK_DIF_OK(dif_usbdev_buffer_span_get(usbdev->dev, buf, &span));
+  CHECK(num_bytes <= span.len);
+  CHECK(!(span.offset & (sizeof(uint32_t) - 1u)));
+
+  if (s->generating) {
+    uint8_t lfsr = s->tx.lfsr;
+
+    // Note: the final word may extend beyond `num_bytes`, but never beyond the
+    // end of the packet buffer since the span starts word-aligned
+    uint32_t offset = span.offset;
+    uint8_t bytes_left = num_bytes;
+    while (bytes_left >= sizeof(uint32_t)) {
+      mmio_region_write32(span.region, (ptrdiff_t)offset, lfsr_word(&lfsr));
+      offset += sizeof(uint32_t);
+      bytes_left -= sizeof(uint32_t);
+    }
+    if (bytes_left > 0u) {
+      mmio_region_write32(span.region, (ptrdiff_t)offset,
+                          lfsr_partial_word(&lfsr, bytes_left));
+    }
+
+    // Update the LFSR for the next packet
+    s->tx.lfsr = lfsr;
+  }
+
+  CHECK_DIF_OK(dif_usbdev_buffer_span_commit(usbdev->dev, usbdev->buffer_pool,
+                                             buf, num_bytes));
+  s->tx.bytes += num_bytes;
+}
+#endif
+
 // Fill a buffer with LFSR-generated data
 static void buffer_fill(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
                         dif_usbdev_buffer_t *buf, uint8_t num_bytes) {
@@ -237,15 +334,28 @@ static void buffer_fill(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
   CHECK(num_bytes <= buf->remaining_bytes);
   CHECK(num_bytes <= sizeof(data));
 
+#if USBUTILS_MEM_FASTER
+  // Traffic logging requires a local copy of the data
+  if (write_method == kWriteMethodFaster && !(s->verbose && log_traffic)) {
+    buffer_fill_direct(ctx, s, buf, num_bytes);
+    return;
+  }
+#endif
+
   if (s->generating) {
     // Emit LFSR-generated byte stream; keep this brief so that we can
     // reduce our latency in responding to USB events (usb_testutils employs
     // polling at present)
     uint8_t lfsr = s->tx.lfsr;
 
-    const uint8_t *edp = &data[num_bytes];
     uint8_t *dp = data;
-    while (dp < edp) {
+    uint8_t bytes_left = num_bytes;
+    while (bytes_left >= sizeof(uint32_t)) {
+      write_32(lfsr_word(&lfsr), dp);
+      dp += sizeof(uint32_t);
+      bytes_left -= sizeof(uint32_t);
+    }
+    while (bytes_left-- > 0u) {
       *dp++ = lfsr;
       lfsr = LFSR_ADVANCE(lfsr);
     }
@@ -262,21 +372,64 @@ static void buffer_fill(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
   }
 
   size_t bytes_written;
-  switch (write_method) {
+  CHECK_DIF_OK(dif_usbdev_buffer_write(ctx->usbdev->dev, buf, data, num_bytes,
+                                       &bytes_written));
+  CHECK(bytes_written == num_bytes);
+  s->tx.bytes += bytes_written;
+}
+
 #if USBUTILS_MEM_FASTER
-    case kWriteMethodFaster:
-      // TODO: integrate faster transfers to/from USB device packet buffer
-      // memory.
-      OT_FALLTHROUGH_INTENDED;
-#endif
-    default:
-      CHECK_DIF_OK(dif_usbdev_buffer_write(ctx->usbdev->dev, buf, data,
-                                           num_bytes, &bytes_written));
-      CHECK(bytes_written == num_bytes);
-      break;
+// Check the contents of a received buffer in place, reading the packet buffer
+// memory a word at a time rather than copying it out first
+static void buffer_check_direct(usb_testutils_streams_ctx_t *ctx,
+                                usbdev_stream_t *s, uint8_t len,
+                                dif_usbdev_buffer_t *buf) {
+  usb_testutils_ctx_t *usbdev = ctx->usbdev;
+  dif_usbdev_buffer_span_t span;
+  CHECK_DIF_OK(dif_usbdev_buffer_span_get(usbdev->dev, buf, &span));
+  CHECK(len == span.len);
+  CHECK(!(span.offset & (sizeof(uint32_t) - 1u)));
+
+  uint8_t rxtx_lfsr = s->rxtx_lfsr;
+  uint8_t rx_lfsr = s->rx_lfsr;
+
+  // Received data should be the XOR of two LFSR-generated PRND streams
+  // - ours on the transmission side, and that of the DPI model
+  uint32_t offset = span.offset;
+  uint8_t bytes_left = len;
+  while (bytes_left > 0u) {
+    uint8_t prev_rxtx = rxtx_lfsr;
+    uint8_t prev_rx = rx_lfsr;
+    uint32_t word = mmio_region_read32(span.region, (ptrdiff_t)offset);
+    uint32_t expected;
+    if (bytes_left >= sizeof(uint32_t)) {
+      expected = lfsr_word(&rxtx_lfsr) ^ lfsr_word(&rx_lfsr);
+      bytes_left -= sizeof(uint32_t);
+    } else {
+      // Ignore any bytes beyond the end of the packet
+      word &= (1u << (bytes_left << 3)) - 1u;
+      expected = lfsr_partial_word(&rxtx_lfsr, bytes_left) ^
+                 lfsr_partial_word(&rx_lfsr, bytes_left);
+      bytes_left = 0u;
+    }
+    if (word != expected) {
+      lfsr_mismatch(s, expected, word, prev_rxtx, prev_rx);
+    }
+    offset += sizeof(uint32_t);
   }
-  s->tx.bytes += bytes_written;
+
+  // Update the LFSRs for the next packet
+  s->rxtx_lfsr = rxtx_lfsr;
+  s->rx_lfsr = rx_lfsr;
+
+  // Update the count of LFSR bytes received
+  s->rx_bytes += len;
+
+  // Consuming the final bytes returns the buffer to the buffer pool
+  CHECK_DIF_OK(dif_usbdev_buffer_span_commit(usbdev->dev, usbdev->buffer_pool,
+                                             buf, len));
 }
+#endif
 
 // Check the contents of a received buffer
 static void buffer_check(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
@@ -290,24 +443,26 @@ static void buffer_check(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
 
     CHECK(len <= sizeof(data));
 
+#if USBUTILS_MEM_FASTER
+    // Isochronous streams carry a signature that must be read out, and
+    // traffic logging requires a local copy of the data
+    if (read_method == kReadMethodFaster &&
+        (s->xfr_type == kUsbTransferTypeBulk ||
+         s->xfr_type == kUsbTransferTypeInterrupt) &&
+        !(s->verbose && log_traffic)) {
+      buffer_check_direct(ctx, s, len, &buf);
+      return;
+    }
+#endif
+
     // Notes: the buffer being read here is USBDEV memory accessed as MMIO, so
     //        only the DIF accesses it directly. when we consume the final bytes
     //        from the read buffer, it is automatically returned to the buffer
     //        pool.
 
     size_t bytes_read;
-    switch (read_method) {
-#if USBUTILS_MEM_FASTER
-      // Faster read performance using custom routine
-      case kReadMethodFaster:
-        // TODO: faster read method not yet integrated, defaulting to standard
-        OT_FALLTHROUGH_INTENDED;
-#endif
-      default:
-        CHECK_DIF_OK(dif_usbdev_buffer_read(usbdev->dev, usbdev->buffer_pool,
-                                            &buf, data, len, &bytes_read));
-        break;
-    }
+    CHECK_DIF_OK(dif_usbdev_buffer_read(usbdev->dev, usbdev->buffer_pool, &buf,
+                                        data, len, &bytes_read));
     CHECK(bytes_read == len);
 
     if (s->verbose && log_traffic) {
@@ -337,11 +492,24 @@ static void buffer_check(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
         uint8_t rxtx_lfsr = s->rxtx_lfsr;
         uint8_t rx_lfsr = s->rx_lfsr;
 
+        // Received data should be the XOR of two LFSR-generated PRND streams
+        // - ours on the transmission side, and that of the DPI model; the
+        // signature is a whole number of words so the data remains aligned
+        static_assert(sizeof(usbdev_stream_sig_t) % sizeof(uint32_t) == 0,
+                      "Stream signature must preserve data alignment");
         const uint8_t *esp = &data[bytes_read];
         const uint8_t *sp = &data[offset];
+        while (esp - sp >= (ptrdiff_t)sizeof(uint32_t)) {
+          uint8_t prev_rxtx = rxtx_lfsr;
+          uint8_t prev_rx = rx_lfsr;
+          uint32_t expected = lfsr_word(&rxtx_lfsr) ^ lfsr_word(&rx_lfsr);
+          uint32_t actual = read_32(sp);
+          if (actual != expected) {
+            lfsr_mismatch(s, expected, actual, prev_rxtx, prev_rx);
+          }
+          sp += sizeof(uint32_t);
+        }
         while (sp < esp) {
-          // Received data should be the XOR of two LFSR-generated PRND streams
-          // - ours on the transmission side, and that of the DPI model
           uint8_t expected = rxtx_lfsr ^ rx_lfsr;
           CHECK(expected == *sp,
                 "S%u: Unexpected received data 0x%02x : (LFSRs 0x%02x 0x%02x)",
@@ -449,10 +617,21 @@ static status_t strm_rx(void *cb_v, dif_usbdev_rx_packet_info_t packet_info,
 
       switch (read_method) {
 #if USBUTILS_MEM_FASTER
-        // Faster read performance using custom routine
-        case kReadMethodFaster:
-          // TODO: faster read method not yet integrated, defaulting to standard
-          OT_FALLTHROUGH_INTENDED;
+        // Faster read performance, whole words straight from packet memory
+        case kReadMethodFaster: {
+          dif_usbdev_buffer_span_t span;
+          TRY(dif_usbdev_buffer_span_get(usbdev->dev, &buf, &span));
+          TRY_CHECK(!(span.offset & (sizeof(uint32_t) - 1u)));
+
+          uint32_t *wp = (uint32_t *)data;
+          for (uint32_t idx = 0u; idx < len; idx += sizeof(uint32_t)) {
+            *wp++ = mmio_region_read32(span.region,
+                                       (ptrdiff_t)(span.offset + idx));
+          }
+          TRY(dif_usbdev_buffer_span_commit(usbdev->dev, usbdev->buffer_pool,
+                                            &buf, len));
+          bytes_read = len;
+        } break;
 #endif
         //  Use the standard interface
         default:
@@ -520,6 +699,9 @@ status_t usb_testutils_stream_init(usb_testutils_streams_ctx_t *ctx, uint8_t id,
   TRY_CHECK(id < USBUTILS_STREAMS_MAX);
   usbdev_stream_t *s = &ctx->streams[id];
 
+  // Prepare for word-at-a-time data generation and checking
+  lfsr_words_init();
+
   // Remember the stream IDentifier and flags
   s->id = id;
   s->flags = flags;
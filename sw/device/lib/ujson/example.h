@@ -63,6 +63,13 @@ UJSON_SERDE_STRUCT(Rect, rect, STRUCT_RECT);
     field(k, int32_t, 3, 5)
 UJSON_SERDE_STRUCT(Matrix, matrix, STRUCT_MATRIX);
 
+// Arrays of bytes are serialized like any other array, but deserialize also
+// accepts them as a string of hex digits, which is much more compact:
+// {"data":[1,35,69,103]} and {"data":"01234567"} are the same `blob`.
+#define STRUCT_BLOB(field, string) \
+    field(data, uint8_t, 4)
+UJSON_SERDE_STRUCT(Blob, blob, STRUCT_BLOB);
+
 /////////////////////////////////////////////////////////////////////////////
 // Automatic generation of enums with serialize/deserialize functions:
 //
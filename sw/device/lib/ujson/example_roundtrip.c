@@ -33,8 +33,9 @@ status_t check_crc32(ujson_t *uj) {
   return OK_STATUS();
 }
 
-status_t roundtrip(const char *name) {
+status_t roundtrip(const char *name, ujson_format_t format) {
   ujson_t uj = ujson_init(NULL, stdio_getc, stdio_putbuf);
+  uj.format = format;
   if (!strcmp(name, "foo")) {
     foo x = {0};
     TRY(ujson_deserialize_foo(&uj, &x));
@@ -56,6 +57,13 @@ status_t roundtrip(const char *name) {
     ujson_crc32_reset(&uj);
     TRY(ujson_serialize_matrix(&uj, &x));
     printf("\n%x", ujson_crc32_finish(&uj));
+  } else if (!strcmp(name, "blob")) {
+    blob x = {0};
+    TRY(ujson_deserialize_blob(&uj, &x));
+    TRY(check_crc32(&uj));
+    ujson_crc32_reset(&uj);
+    TRY(ujson_serialize_blob(&uj, &x));
+    printf("\n%x", ujson_crc32_finish(&uj));
   } else if (!strcmp(name, "direction")) {
     direction x = {0};
     TRY(ujson_deserialize_direction(&uj, &x));
@@ -89,10 +97,14 @@ status_t roundtrip(const char *name) {
 
 int main(int argc, char *argv[]) {
   if (argc < 2) {
-    fprintf(stderr, "%s [struct-name]", argv[0]);
+    fprintf(stderr, "%s [struct-name] [binary]", argv[0]);
     return EXIT_FAILURE;
   }
-  status_t s = roundtrip(argv[1]);
+  ujson_format_t format = kUjsonFormatJson;
+  if (argc > 2 && !strcmp(argv[2], "binary")) {
+    format = kUjsonFormatBinary;
+  }
+  status_t s = roundtrip(argv[1], format);
 
   return status_ok(s) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
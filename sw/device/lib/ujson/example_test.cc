@@ -77,6 +77,67 @@ TEST(Derive, FooDeserializeBogusKey) {
   EXPECT_EQ(status_err(ujson_deserialize_foo(&uj, &foo)), kInvalidArgument);
 }
 
+TEST(Derive, BlobDeserialize) {
+  blob expected = {{0x01, 0x23, 0x45, 0x67}};
+  blob b{};
+  SourceSink ss(R"json({"data":[1,35,69,103]})json");
+  ujson_t uj = ss.UJson();
+  EXPECT_TRUE(status_ok(ujson_deserialize_blob(&uj, &b)));
+  EXPECT_EQ(memcmp(&b, &expected, sizeof(b)), 0);
+
+  b = {};
+  ss.Reset(R"json({"data":"01234567"})json");
+  uj = ss.UJson();
+  EXPECT_TRUE(status_ok(ujson_deserialize_blob(&uj, &b)));
+  EXPECT_EQ(memcmp(&b, &expected, sizeof(b)), 0);
+
+  // The serialized form stays an array.
+  ss.Reset();
+  EXPECT_TRUE(status_ok(ujson_serialize_blob(&uj, &b)));
+  EXPECT_EQ(ss.Sink(), R"json({"data":[1,35,69,103]})json");
+}
+
+TEST(Derive, BinaryRoundtrip) {
+  foo f = {-5, 150000, "Kilroy was here"};
+  matrix m = {{{0, 1, 2, 3, 4}, {5, 6, 7, 8, 9}, {-1, -2, -3, -4, -5}}};
+  direction d = kDirectionWest;
+  blob b = {{0x01, 0x23, 0x45, 0x67}};
+  SourceSink ss;
+  ujson_t uj = ss.UJson();
+  uj.format = kUjsonFormatBinary;
+  EXPECT_TRUE(status_ok(ujson_serialize_foo(&uj, &f)));
+  EXPECT_TRUE(status_ok(ujson_serialize_matrix(&uj, &m)));
+  EXPECT_TRUE(status_ok(ujson_serialize_direction(&uj, &d)));
+  EXPECT_TRUE(status_ok(ujson_serialize_blob(&uj, &b)));
+  // The fields are packed without any padding.
+  EXPECT_EQ(ss.Sink().size(),
+            sizeof(f.foo) + sizeof(f.bar) + sizeof(f.message) + sizeof(m) +
+                sizeof(uint32_t) + sizeof(b));
+  EXPECT_EQ(ss.Sink().substr(0, 8),
+            std::string("\xfb\xff\xff\xff\xf0\x49\x02\x00", 8));
+
+  size_t size = 0;
+  ujson_t counter = ujson_binary_counter(&size);
+  EXPECT_TRUE(status_ok(ujson_serialize_foo(&counter, &f)));
+  EXPECT_EQ(size, sizeof(f.foo) + sizeof(f.bar) + sizeof(f.message));
+
+  foo f2{};
+  matrix m2{};
+  direction d2{};
+  blob b2{};
+  std::string encoded = ss.Sink();
+  ss.Reset(encoded);
+  EXPECT_TRUE(status_ok(ujson_deserialize_foo(&uj, &f2)));
+  EXPECT_TRUE(status_ok(ujson_deserialize_matrix(&uj, &m2)));
+  EXPECT_TRUE(status_ok(ujson_deserialize_direction(&uj, &d2)));
+  EXPECT_TRUE(status_ok(ujson_deserialize_blob(&uj, &b2)));
+  EXPECT_EQ(memcmp(&f, &f2, sizeof(f)), 0);
+  EXPECT_EQ(memcmp(&m, &m2, sizeof(m)), 0);
+  EXPECT_EQ(d, d2);
+  EXPECT_EQ(memcmp(&b, &b2, sizeof(b)), 0);
+  EXPECT_EQ(status_err(ujson_getc(&uj)), kResourceExhausted);
+}
+
 TEST(Derive, RectSerialize) {
   rect r = {{10, 10}, {60, 40}};
   SourceSink ss;
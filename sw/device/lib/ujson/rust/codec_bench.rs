@@ -0,0 +1,108 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+//! Compares the generated binary ujson codec with the serde JSON path used by
+//! the host harnesses.
+
+use anyhow::Result;
+use clap::Parser;
+use opentitanlib::test_utils::status::Status;
+use opentitanlib::test_utils::ujson_binary::UjsonBinary;
+use serde::de::DeserializeOwned;
+use serde::Serialize;
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+mod example {
+    // Bring in the auto-generated sources.
+    include!(env!("example"));
+}
+
+#[derive(Debug, Parser)]
+struct Opts {
+    /// Number of encode/decode round trips per type and codec.
+    #[arg(long, default_value_t = 100000)]
+    iterations: u32,
+}
+
+fn bench_json<T: Serialize + DeserializeOwned>(value: &T, iterations: u32) -> Result<Duration> {
+    let start = Instant::now();
+    for _ in 0..iterations {
+        let s = serde_json::to_string(black_box(value))?;
+        black_box(serde_json::from_str::<T>(&s)?);
+    }
+    Ok(start.elapsed())
+}
+
+fn bench_binary<T: UjsonBinary>(value: &T, iterations: u32) -> Result<Duration> {
+    let mut buf = Vec::with_capacity(T::BINARY_SIZE);
+    let start = Instant::now();
+    for _ in 0..iterations {
+        black_box(value).to_binary(&mut buf);
+        black_box(T::from_binary(&buf)?);
+    }
+    Ok(start.elapsed())
+}
+
+fn bench<T: Serialize + DeserializeOwned + UjsonBinary>(
+    name: &str,
+    value: &T,
+    iterations: u32,
+) -> Result<()> {
+    let json = bench_json(value, iterations)?;
+    let binary = bench_binary(value, iterations)?;
+    let per_iter = |d: Duration| d.as_nanos() as f64 / iterations as f64;
+    println!(
+        "{name:<10} json {:>6} bytes {:>9.1} ns/iter | binary {:>4} bytes {:>9.1} ns/iter | {:.1}x",
+        serde_json::to_string(value)?.len(),
+        per_iter(json),
+        T::BINARY_SIZE,
+        per_iter(binary),
+        json.as_secs_f64() / binary.as_secs_f64(),
+    );
+    Ok(())
+}
+
+fn main() -> Result<()> {
+    let opts = Opts::parse();
+    let n = opts.iterations;
+    bench(
+        "foo",
+        &example::Foo {
+            foo: -5,
+            bar: 10,
+            message: "Hello".into(),
+        },
+        n,
+    )?;
+    bench(
+        "rect",
+        &example::Rect {
+            top_left: example::Coord { x: 10, y: 20 },
+            bottom_right: example::Coord { x: 30, y: 40 },
+        },
+        n,
+    )?;
+    bench(
+        "matrix",
+        &example::Matrix {
+            k: [
+                [0, 1, 2, 3, 4].into(),
+                [100, 200, 300, 400, 500].into(),
+                [-1, -2, -3, -4, -5].into(),
+            ]
+            .into(),
+        },
+        n,
+    )?;
+    bench(
+        "misc",
+        &example::Misc {
+            value: true,
+            status: Status::Ok(0),
+        },
+        n,
+    )?;
+    Ok(())
+}
@@ -5,6 +5,7 @@
 use anyhow::Result;
 use crc::{Crc, CRC_32_ISO_HDLC};
 use opentitanlib::test_utils::status::Status;
+use opentitanlib::test_utils::ujson_binary::UjsonBinary;
 use opentitanlib::with_unknown;
 use std::io::{Read, Write};
 use std::process::{Command, Stdio};
@@ -59,6 +60,42 @@ fn roundtrip(name: &str, data: &str, check_crc: bool) -> Result<String> {
     Ok(msg)
 }
 
+fn roundtrip_binary<T: UjsonBinary>(name: &str, value: &T) -> Result<T> {
+    let mut command = Command::new(std::env::var("ROUNDTRIP_CLIENT")?);
+    command.args([name, "binary"]);
+    let mut child = command
+        .stdin(Stdio::piped())
+        .stdout(Stdio::piped())
+        .stderr(Stdio::inherit())
+        .spawn()?;
+
+    let mut data = Vec::new();
+    value.to_binary(&mut data);
+    assert_eq!(data.len(), T::BINARY_SIZE);
+    let crc32 = Crc::<u32>::new(&CRC_32_ISO_HDLC).checksum(&data);
+    let mut stdin = child.stdin.take().unwrap();
+    eprintln!("sending: {data:02x?}");
+    stdin.write_all(&data)?;
+    stdin.write_all(format!("\n{crc32:x}\n").as_bytes())?;
+
+    let exit_code = child.wait()?;
+    if !exit_code.success() {
+        panic!("{exit_code}");
+    }
+
+    let mut msg = Vec::new();
+    child.stdout.take().unwrap().read_to_end(&mut msg)?;
+    eprintln!("recv: {msg:02x?}");
+    let split = msg
+        .iter()
+        .rposition(|&b| b == b'\n')
+        .expect("Expected a CRC.");
+    let crc32 = u32::from_str_radix(std::str::from_utf8(&msg[split + 1..])?, 16)?;
+    let data = &msg[..split];
+    assert_eq!(crc32, Crc::<u32>::new(&CRC_32_ISO_HDLC).checksum(data));
+    Ok(T::from_binary(data)?)
+}
+
 #[cfg(test)]
 mod test {
     use super::*;
@@ -104,6 +141,21 @@ mod test {
         Ok(())
     }
 
+    #[test]
+    fn test_blob() -> Result<()> {
+        let before = example::Blob {
+            data: [1, 35, 69, 103].into(),
+        };
+        let after = roundtrip("blob", &serde_json::to_string(&before)?, true)?;
+        let after = serde_json::from_str::<example::Blob>(&after)?;
+        assert_eq!(before, after);
+        // The device also accepts byte arrays as hex strings.
+        let after = roundtrip("blob", r#"{"data":"01234567"}"#, true)?;
+        let after = serde_json::from_str::<example::Blob>(&after)?;
+        assert_eq!(before, after);
+        Ok(())
+    }
+
     #[test]
     fn test_direction() -> Result<()> {
         let before = example::Direction::North;
@@ -165,4 +217,66 @@ mod test {
         assert_eq!(before, after);
         Ok(())
     }
+
+    #[test]
+    fn test_binary_foo() -> Result<()> {
+        let before = example::Foo {
+            foo: -5,
+            bar: 10,
+            message: "Hello".into(),
+        };
+        assert_eq!(before, roundtrip_binary("foo", &before)?);
+        Ok(())
+    }
+
+    #[test]
+    fn test_binary_rect() -> Result<()> {
+        let before = example::Rect {
+            top_left: example::Coord { x: 10, y: 20 },
+            bottom_right: example::Coord { x: 30, y: 40 },
+        };
+        assert_eq!(before, roundtrip_binary("rect", &before)?);
+        Ok(())
+    }
+
+    #[test]
+    fn test_binary_matrix() -> Result<()> {
+        let before = example::Matrix {
+            k: [
+                [0, 1, 2, 3, 4].into(),
+                [100, 200, 300, 400, 500].into(),
+                [-1, -2, -3, -4, -5].into(),
+            ]
+            .into(),
+        };
+        assert_eq!(before, roundtrip_binary("matrix", &before)?);
+        Ok(())
+    }
+
+    #[test]
+    fn test_binary_blob() -> Result<()> {
+        let before = example::Blob {
+            data: [1, 35, 69, 103].into(),
+        };
+        assert_eq!(before, roundtrip_binary("blob", &before)?);
+        Ok(())
+    }
+
+    #[test]
+    fn test_binary_direction() -> Result<()> {
+        for before in [example::Direction::West, example::Direction::IntValue(45)] {
+            assert_eq!(before, roundtrip_binary("direction", &before)?);
+        }
+        Ok(())
+    }
+
+    #[test]
+    fn test_binary_misc() -> Result<()> {
+        let before = example::Misc {
+            value: true,
+            status: Status::InvalidArgument("FOO".into(), 5),
+        };
+        assert_eq!(before, roundtrip_binary("misc", &before)?);
+        Ok(())
+    }
 }
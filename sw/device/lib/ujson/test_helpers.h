@@ -5,6 +5,7 @@
 #ifndef OPENTITAN_SW_DEVICE_LIB_UJSON_TEST_HELPERS_H_
 #define OPENTITAN_SW_DEVICE_LIB_UJSON_TEST_HELPERS_H_
 
+#include <algorithm>
 #include <string>
 
 #include "sw/device/lib/base/status.h"
@@ -22,6 +23,13 @@ class SourceSink {
     return ujson_init((void *)this, &SourceSink::getc, &SourceSink::putbuf);
   }
 
+  // Returns a context that reads at most `chunk` characters at a time.
+  ujson_t UJsonBuffered(size_t chunk = kUjsonRxBufferSize) {
+    chunk_ = chunk;
+    return ujson_init_buffered((void *)this, &SourceSink::getc,
+                               &SourceSink::getbuf, &SourceSink::putbuf);
+  }
+
   void Reset() {
     pos_ = 0;
     sink_.clear();
@@ -40,6 +48,16 @@ class SourceSink {
     }
   }
 
+  status_t GetBuf(char *buf, size_t len) {
+    if (pos_ == source_.size()) {
+      return RESOURCE_EXHAUSTED();
+    }
+    len = std::min({len, chunk_, source_.size() - pos_});
+    source_.copy(buf, len, pos_);
+    pos_ += len;
+    return OK_STATUS(len);
+  }
+
   status_t PutBuf(const char *buf, size_t len) {
     sink_.append(buf, len);
     return OK_STATUS();
@@ -50,11 +68,16 @@ class SourceSink {
     return static_cast<SourceSink *>(self)->GetChar();
   }
 
+  static status_t getbuf(void *self, char *buf, size_t len) {
+    return static_cast<SourceSink *>(self)->GetBuf(buf, len);
+  }
+
   static status_t putbuf(void *self, const char *buf, size_t len) {
     return static_cast<SourceSink *>(self)->PutBuf(buf, len);
   }
 
   size_t pos_ = 0;
+  size_t chunk_ = 0;
   std::string source_;
   std::string sink_;
 };
@@ -22,20 +22,78 @@ ujson_t ujson_init(void *context, status_t (*getc)(void *),
   return u;
 }
 
-void ujson_crc32_reset(ujson_t *uj) { crc32_init(&uj->crc32); }
+ujson_t ujson_init_buffered(void *context, status_t (*getc)(void *),
+                            status_t (*getbuf)(void *, char *, size_t),
+                            status_t (*putbuf)(void *, const char *, size_t)) {
+  ujson_t u = UJSON_INIT_BUFFERED(context, getc, getbuf, putbuf);
+  return u;
+}
+
+static status_t count_putbuf(void *io, const char *buf, size_t len) {
+  *(size_t *)io += len;
+  return OK_STATUS();
+}
 
-uint32_t ujson_crc32_finish(ujson_t *uj) { return crc32_finish(&uj->crc32); }
+ujson_t ujson_binary_counter(size_t *size) {
+  ujson_t u = UJSON_INIT(size, NULL, count_putbuf);
+  u.format = kUjsonFormatBinary;
+  return u;
+}
+
+static bool is_binary(const ujson_t *uj) {
+  return uj->format == kUjsonFormatBinary;
+}
+
+// The CRC of the characters read from `rx_buf` is only computed when it is
+// needed, so that it is done a block at a time instead of for every
+// character.
+static void crc32_sync_rx(ujson_t *uj) {
+  if (uj->rx_crc_pos < uj->rx_pos) {
+    crc32_add(&uj->crc32, &uj->rx_buf[uj->rx_crc_pos],
+              uj->rx_pos - uj->rx_crc_pos);
+    uj->rx_crc_pos = uj->rx_pos;
+  }
+}
+
+void ujson_crc32_reset(ujson_t *uj) {
+  uj->rx_crc_pos = uj->rx_pos;
+  crc32_init(&uj->crc32);
+}
+
+uint32_t ujson_crc32_finish(ujson_t *uj) {
+  crc32_sync_rx(uj);
+  return crc32_finish(&uj->crc32);
+}
 
 status_t ujson_putbuf(ujson_t *uj, const char *buf, size_t len) {
+  crc32_sync_rx(uj);
   crc32_add(&uj->crc32, buf, len);
   return uj->putbuf(uj->io_context, buf, len);
 }
 
+static status_t ujson_fill(ujson_t *uj) {
+  crc32_sync_rx(uj);
+  size_t len = (size_t)TRY(
+      uj->getbuf(uj->io_context, uj->rx_buf, sizeof(uj->rx_buf)));
+  if (len == 0 || len > sizeof(uj->rx_buf)) {
+    return INTERNAL();
+  }
+  uj->rx_pos = 0;
+  uj->rx_crc_pos = 0;
+  uj->rx_len = (uint16_t)len;
+  return OK_STATUS();
+}
+
 status_t ujson_getc(ujson_t *uj) {
   int16_t buffer = uj->buffer;
   if (buffer >= 0) {
     uj->buffer = -1;
     return OK_STATUS(buffer);
+  } else if (uj->getbuf != NULL) {
+    if (uj->rx_pos == uj->rx_len) {
+      TRY(ujson_fill(uj));
+    }
+    return OK_STATUS((uint8_t)uj->rx_buf[uj->rx_pos++]);
   } else {
     status_t s = uj->getc(uj->io_context);
     if (!status_err(s)) {
@@ -45,6 +103,35 @@ status_t ujson_getc(ujson_t *uj) {
   }
 }
 
+status_t ujson_get_bytes(ujson_t *uj, void *buf, size_t len) {
+  char *out = (char *)buf;
+  if (len > 0 && uj->buffer >= 0) {
+    *out++ = (char)uj->buffer;
+    uj->buffer = -1;
+    --len;
+  }
+  if (uj->getbuf == NULL) {
+    for (; len > 0; --len) {
+      *out++ = (char)TRY(ujson_getc(uj));
+    }
+    return OK_STATUS();
+  }
+  while (len > 0) {
+    if (uj->rx_pos == uj->rx_len) {
+      TRY(ujson_fill(uj));
+    }
+    size_t n = uj->rx_len - uj->rx_pos;
+    if (n > len) {
+      n = len;
+    }
+    memcpy(out, &uj->rx_buf[uj->rx_pos], n);
+    uj->rx_pos += (uint16_t)n;
+    out += n;
+    len -= n;
+  }
+  return OK_STATUS();
+}
+
 status_t ujson_ungetc(ujson_t *uj, char ch) {
   if (uj->buffer >= 0) {
     return FAILED_PRECONDITION();
@@ -70,8 +157,7 @@ static status_t consume_whitespace(ujson_t *uj) {
   return OK_STATUS(ch);
 }
 
-static status_t consume_hexdigit(ujson_t *uj) {
-  int ch = TRY(ujson_getc(uj));
+static status_t hexdigit_value(int ch) {
   if (ch >= '0' && ch <= '9') {
     return OK_STATUS(ch - '0');
   } else if (ch >= 'A' && ch <= 'F') {
@@ -83,6 +169,10 @@ static status_t consume_hexdigit(ujson_t *uj) {
   }
 }
 
+static status_t consume_hexdigit(ujson_t *uj) {
+  return hexdigit_value(TRY(ujson_getc(uj)));
+}
+
 static status_t consume_hex(ujson_t *uj) {
   int a = TRY(consume_hexdigit(uj));
   int b = TRY(consume_hexdigit(uj));
@@ -156,6 +246,9 @@ status_t ujson_parse_qs(ujson_t *uj, char *str, size_t len) {
 }
 
 status_t ujson_parse_integer(ujson_t *uj, void *result, size_t rsz) {
+  if (is_binary(uj)) {
+    return ujson_get_bytes(uj, result, rsz);
+  }
   char ch = (char)TRY(consume_whitespace(uj));
   bool neg = false;
 
@@ -185,7 +278,29 @@ status_t ujson_parse_integer(ujson_t *uj, void *result, size_t rsz) {
   return OK_STATUS();
 }
 
+status_t ujson_parse_hex_bytes(ujson_t *uj, uint8_t *buf, size_t len) {
+  size_t n = 0;
+  TRY(ujson_consume(uj, '"'));
+  while (true) {
+    int ch = TRY(ujson_getc(uj));
+    if (ch == '"') {
+      break;
+    }
+    int hi = TRY(hexdigit_value(ch));
+    int lo = TRY(consume_hexdigit(uj));
+    if (n < len) {
+      buf[n] = (uint8_t)(hi << 4 | lo);
+    }
+    ++n;
+  }
+  return OK_STATUS(n);
+}
+
 status_t ujson_deserialize_bool(ujson_t *uj, bool *value) {
+  if (is_binary(uj)) {
+    *value = TRY(ujson_getc(uj)) != 0;
+    return OK_STATUS();
+  }
   char got = (char)TRY(consume_whitespace(uj));
   if (got == 't') {
     TRY(ujson_consume(uj, 'r'));
@@ -325,6 +440,9 @@ static status_t ujson_serialize_integer32(ujson_t *uj, uint32_t value,
 }
 
 status_t ujson_serialize_bool(ujson_t *uj, const bool *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, *value ? "\x01" : "\x00", 1);
+  }
   if (*value) {
     TRY(ujson_putbuf(uj, "true", 4));
   } else {
@@ -334,21 +452,36 @@ status_t ujson_serialize_bool(ujson_t *uj, const bool *value) {
 }
 
 status_t ujson_serialize_uint64_t(ujson_t *uj, const uint64_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)value, sizeof(*value));
+  }
   return ujson_serialize_integer64(uj, *value, false);
 }
 status_t ujson_serialize_uint32_t(ujson_t *uj, const uint32_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)value, sizeof(*value));
+  }
   return ujson_serialize_integer32(uj, *value, false);
 }
 
 status_t ujson_serialize_uint16_t(ujson_t *uj, const uint16_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)value, sizeof(*value));
+  }
   return ujson_serialize_integer32(uj, *value, false);
 }
 
 status_t ujson_serialize_uint8_t(ujson_t *uj, const uint8_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)value, sizeof(*value));
+  }
   return ujson_serialize_integer32(uj, *value, false);
 }
 
 status_t ujson_serialize_size_t(ujson_t *uj, const size_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)value, sizeof(*value));
+  }
   if (sizeof(size_t) == sizeof(uint64_t)) {
     return ujson_serialize_integer64(uj, *value, false);
   } else {
@@ -357,22 +490,37 @@ status_t ujson_serialize_size_t(ujson_t *uj, const size_t *value) {
 }
 
 status_t ujson_serialize_int64_t(ujson_t *uj, const int64_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)value, sizeof(*value));
+  }
   return ujson_serialize_integer64(uj, (uint64_t)*value, *value < 0);
 }
 
 status_t ujson_serialize_int32_t(ujson_t *uj, const int32_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)value, sizeof(*value));
+  }
   return ujson_serialize_integer32(uj, (uint32_t)*value, *value < 0);
 }
 
 status_t ujson_serialize_int16_t(ujson_t *uj, const int16_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)value, sizeof(*value));
+  }
   return ujson_serialize_integer32(uj, (uint32_t)*value, *value < 0);
 }
 
 status_t ujson_serialize_int8_t(ujson_t *uj, const int8_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)value, sizeof(*value));
+  }
   return ujson_serialize_integer32(uj, (uint32_t)*value, *value < 0);
 }
 
 status_t ujson_deserialize_status_t(ujson_t *uj, status_t *value) {
+  if (is_binary(uj)) {
+    return ujson_get_bytes(uj, &value->value, sizeof(value->value));
+  }
   private_status_t code;
   uint32_t module_id = 0;
   uint32_t arg = 0;
@@ -396,6 +544,9 @@ status_t ujson_deserialize_status_t(ujson_t *uj, status_t *value) {
 }
 
 status_t ujson_serialize_status_t(ujson_t *uj, const status_t *value) {
+  if (is_binary(uj)) {
+    return ujson_putbuf(uj, (const char *)&value->value, sizeof(value->value));
+  }
   buffer_sink_t out = {
       .data = uj,
       .sink = (size_t(*)(void *, const char *, size_t))ujson_putbuf,
@@ -4,6 +4,7 @@
 
 #ifndef OPENTITAN_SW_DEVICE_LIB_UJSON_UJSON_H_
 #define OPENTITAN_SW_DEVICE_LIB_UJSON_UJSON_H_
+#include <stddef.h>
 #include <stdint.h>
 
 #include "sw/device/lib/base/status.h"
@@ -11,6 +12,34 @@
 extern "C" {
 #endif
 
+enum {
+  /**
+   * The size of the read-ahead buffer of a ujson context.
+   */
+  kUjsonRxBufferSize = 64,
+};
+
+/**
+ * The encoding used by a ujson context.
+ */
+typedef enum ujson_format {
+  /** JSON text. */
+  kUjsonFormatJson = 0,
+  /**
+   * A compact binary encoding of the same values.
+   *
+   * Values are written one after the other, with no keys, separators or
+   * framing: integers, enums and `status_t` as their little-endian bytes,
+   * booleans as one byte, and strings in structs as their whole buffer (of
+   * which only the part before the first nul is meaningful).  Struct fields
+   * are written in declaration order and all the elements of arrays are
+   * written, so both ends must know the types being exchanged.
+   *
+   * `ujson_parse_qs` and `ujson_serialize_string` always use JSON.
+   */
+  kUjsonFormatBinary = 1,
+} ujson_format_t;
+
 /**
  * Input/Output context for ujson.
  */
@@ -21,20 +50,43 @@ typedef struct ujson {
   status_t (*putbuf)(void *, const char *, size_t);
   /** A pointer to an IO function for reading data from the input. */
   status_t (*getc)(void *);
+  /**
+   * An optional pointer to an IO function for reading a block of data from
+   * the input.
+   *
+   * It must wait for at least one byte, and return the number of bytes it
+   * read (at most `len`).  When set, the input is read through `rx_buf`
+   * instead of one character at a time with `getc`.
+   */
+  status_t (*getbuf)(void *, char *, size_t);
   /** An internal single character buffer for ungetting a character. */
   int16_t buffer;
   /** Holds the rolling CRC32 of characters that are sent and received.*/
   uint32_t crc32;
+  /** The encoding of the values that are sent and received. */
+  ujson_format_t format;
+  /** The position of the next character to read from `rx_buf`. */
+  uint16_t rx_pos;
+  /** The number of valid characters in `rx_buf`. */
+  uint16_t rx_len;
+  /** The position of the first character in `rx_buf` not yet in `crc32`. */
+  uint16_t rx_crc_pos;
+  /** The read-ahead buffer used with `getbuf`. */
+  char rx_buf[kUjsonRxBufferSize];
 } ujson_t;
 
 // clang-format off
 #define UJSON_INIT(context_, getc_, putbuf_) \
-  {                                          \
-    .io_context = (void*)(context_),         \
-    .putbuf_ = (putbuf_),                    \
-    .getc = (getc_),                         \
-    .buffer = -1,                            \
-    .crc32 = UINT32_MAX,                     \
+  UJSON_INIT_BUFFERED(context_, getc_, NULL, putbuf_)
+
+#define UJSON_INIT_BUFFERED(context_, getc_, getbuf_, putbuf_) \
+  {                                                            \
+    .io_context = (void*)(context_),                           \
+    .putbuf = (putbuf_),                                       \
+    .getc = (getc_),                                           \
+    .getbuf = (getbuf_),                                       \
+    .buffer = -1,                                              \
+    .crc32 = UINT32_MAX,                                       \
   }
 // clang-format on
 
@@ -49,6 +101,36 @@ typedef struct ujson {
 ujson_t ujson_init(void *context, status_t (*getc)(void *),
                    status_t (*putbuf)(void *, const char *, size_t));
 
+/**
+ * Initializes and returns a ujson context that reads its input in blocks.
+ *
+ * The input is read ahead into a buffer in the context, so nothing else may
+ * read from the same input while the context is in use.
+ *
+ * @param context An IO context for the `getc`, `getbuf` and `putbuf`
+ * functions.
+ * @param getc A function to read a character from the input.
+ * @param getbuf A function to read the available data from the input, up to
+ * the given length, waiting for at least one byte.
+ * @param putbuf A function to write a buffer to the output.
+ * @return An initialized ujson_t context.
+ */
+ujson_t ujson_init_buffered(void *context, status_t (*getc)(void *),
+                            status_t (*getbuf)(void *, char *, size_t),
+                            status_t (*putbuf)(void *, const char *, size_t));
+
+/**
+ * Initializes and returns a ujson context that only counts the bytes written
+ * to it in the binary format.
+ *
+ * This can be used to find the size of a value in the binary format before
+ * sending it, by serializing it twice.
+ *
+ * @param size A counter to increment by the number of bytes written.
+ * @return An initialized ujson_t context.
+ */
+ujson_t ujson_binary_counter(size_t *size);
+
 /**
  * Gets a single character from the input.
  *
@@ -57,6 +139,16 @@ ujson_t ujson_init(void *context, status_t (*getc)(void *),
  */
 status_t ujson_getc(ujson_t *uj);
 
+/**
+ * Gets a number of bytes from the input.
+ *
+ * @param uj A ujson IO context.
+ * @param[out] buf The buffer to write the bytes into.
+ * @param len The number of bytes to get.
+ * @return OK or an error.
+ */
+status_t ujson_get_bytes(ujson_t *uj, void *buf, size_t len);
+
 /**
  * Pushes a single character back to the input.
  *
@@ -147,6 +239,8 @@ status_t ujson_parse_qs(ujson_t *uj, char *str, size_t len);
 /**
  * Parse a JSON integer.
  *
+ * In the binary format, this reads the `rsz` bytes of the integer instead.
+ *
  * @param uj A ujson IO context.
  * @param result: The parsed integer.
  * @param rsz: The size of the integer (in bytes).
@@ -154,6 +248,20 @@ status_t ujson_parse_qs(ujson_t *uj, char *str, size_t len);
  */
 status_t ujson_parse_integer(ujson_t *uj, void *result, size_t rsz);
 
+/**
+ * Parse a JSON quoted string of hexadecimal digits into a byte array.
+ *
+ * The first two digits are the first byte of `buf`, and so on.  If the
+ * string holds fewer than `len` bytes, the rest of `buf` is left untouched;
+ * if it holds more, the extra bytes are consumed and dropped.
+ *
+ * @param uj A ujson IO context.
+ * @param buf A buffer to write the bytes into.
+ * @param len The length of the target buffer.
+ * @return The number of bytes in the string or an error.
+ */
+status_t ujson_parse_hex_bytes(ujson_t *uj, uint8_t *buf, size_t len);
+
 /**
  * The following functions parse integers of specific sizes.
  */
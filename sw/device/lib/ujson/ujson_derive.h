@@ -119,8 +119,34 @@
         if (--nfield) TRY(ujson_putbuf(uj, ",", 1)); \
     }
 
+// In the binary format, arrays of bytes are written in one piece.
+#define ujson_bin_ser_field(name_, type_, ...) { \
+        OT_IIF(OT_NOT(OT_VA_ARGS_COUNT(dummy, ##__VA_ARGS__))) \
+        ( /*then*/ \
+            TRY(ujson_serialize_##type_(uj, &self->name_)); \
+        , /*else*/ \
+            if (sizeof(type_) == 1) { \
+                TRY(ujson_putbuf(uj, (const char*)self->name_, \
+                                 sizeof(self->name_))); \
+            } else { \
+                const type_ *p = (const type_*)self->name_; \
+                size_t n = sizeof(self->name_) / sizeof(type_); \
+                for (size_t i = 0; i < n; ++i) { \
+                    TRY(ujson_serialize_##type_(uj, &p[i])); \
+                } \
+            } \
+        ) /*endif*/ \
+    }
+
+#define ujson_bin_ser_string(name_, size_, ...) \
+    TRY(ujson_putbuf(uj, (const char*)self->name_, sizeof(self->name_)));
+
 #define UJSON_IMPL_SERIALIZE_STRUCT(name_, decl_) \
     status_t ujson_serialize_##name_(ujson_t *uj, const name_ *self) { \
+        if (uj->format == kUjsonFormatBinary) { \
+            decl_(ujson_bin_ser_field, ujson_bin_ser_string) \
+            return OK_STATUS(); \
+        } \
         size_t nfield = decl_(ujson_count, ujson_count); \
         TRY(ujson_putbuf(uj, "{", 1)); \
         decl_(ujson_ser_field, ujson_ser_string) \
@@ -135,6 +161,10 @@
 
 #define UJSON_IMPL_SERIALIZE_ENUM(formal_name_, name_, decl_, ...) \
     status_t ujson_serialize_##name_(ujson_t *uj, const name_ *self) { \
+        if (uj->format == kUjsonFormatBinary) { \
+            const uint32_t value = (uint32_t)(*self); \
+            return ujson_serialize_uint32_t(uj, &value); \
+        } \
         switch(*self) { \
             decl_(formal_name_, ujson_ser_enum) \
             default: { \
@@ -183,9 +213,16 @@
         ( /*then*/ \
             TRY(ujson_deserialize_##type_(uj, &self->name_)); \
         , /*else*/ \
-            type_ *p = (type_*)self->name_; \
-            OT_EVAL(ujson_de_loop(1, \
-                TRY(ujson_deserialize_##type_(uj, p++)), __VA_ARGS__)) \
+            /* Byte arrays may also be given as a string of hex digits. */ \
+            if (sizeof(type_) == 1 && TRY(ujson_consume_maybe(uj, '"'))) { \
+                TRY(ujson_ungetc(uj, '"')); \
+                TRY(ujson_parse_hex_bytes(uj, (uint8_t*)self->name_, \
+                                          sizeof(self->name_))); \
+            } else { \
+                type_ *p = (type_*)self->name_; \
+                OT_EVAL(ujson_de_loop(1, \
+                    TRY(ujson_deserialize_##type_(uj, p++)), __VA_ARGS__)) \
+            } \
         ) /*endif*/ \
     }
 
@@ -201,8 +238,38 @@
         ) /*endif*/ \
     }
 
+#define ujson_bin_de_field(name_, type_, ...) { \
+        OT_IIF(OT_NOT(OT_VA_ARGS_COUNT(dummy, ##__VA_ARGS__))) \
+        ( /*then*/ \
+            TRY(ujson_deserialize_##type_(uj, &self->name_)); \
+        , /*else*/ \
+            if (sizeof(type_) == 1) { \
+                TRY(ujson_get_bytes(uj, self->name_, sizeof(self->name_))); \
+            } else { \
+                type_ *p = (type_*)self->name_; \
+                size_t n = sizeof(self->name_) / sizeof(type_); \
+                for (size_t i = 0; i < n; ++i) { \
+                    TRY(ujson_deserialize_##type_(uj, &p[i])); \
+                } \
+            } \
+        ) /*endif*/ \
+    }
+
+// Strings are nul-terminated even if what was received isn't.
+#define ujson_bin_de_string(name_, size_, ...) { \
+        char *p = (char*)self->name_; \
+        TRY(ujson_get_bytes(uj, p, sizeof(self->name_))); \
+        for (size_t i = size_ - 1; i < sizeof(self->name_); i += size_) { \
+            p[i] = '\0'; \
+        } \
+    }
+
 #define UJSON_IMPL_DESERIALIZE_STRUCT(name_, decl_) \
     status_t ujson_deserialize_##name_(ujson_t *uj, name_ *self) { \
+        if (uj->format == kUjsonFormatBinary) { \
+            decl_(ujson_bin_de_field, ujson_bin_de_string) \
+            return OK_STATUS(); \
+        } \
         size_t nfield = 0; \
         char key[128]; \
         TRY(ujson_consume(uj, '{')); \
@@ -227,6 +294,9 @@
 
 #define UJSON_IMPL_DESERIALIZE_ENUM(formal_name_, name_, decl_, ...) \
     status_t ujson_deserialize_##name_(ujson_t *uj, name_ *self) { \
+        if (uj->format == kUjsonFormatBinary) { \
+            return ujson_deserialize_uint32_t(uj, (uint32_t*)self); \
+        } \
         char value[128]; \
         if (TRY(ujson_consume_maybe(uj, '"'))) { \
             TRY(ujson_ungetc(uj, '"')); \
@@ -60,6 +60,68 @@ use opentitanlib::test_utils::status::status_t;
 #define ujson_struct_string(name_, size_, ...) \
     ujson_struct_field(name_, String, ##__VA_ARGS__)
 
+// Implementations of `opentitanlib::test_utils::ujson_binary::UjsonBinary`,
+// the host side of `kUjsonFormatBinary`.
+#define ujson_bin_size_field(name_, type_, ...) \
+    + <OT_IIF(OT_NOT(OT_VA_ARGS_COUNT(dummy, ##__VA_ARGS__))) \
+    ( /*then*/ \
+        type_ \
+    , /*else*/ \
+        OT_EVAL(ujson_struct_field_array(type_, __VA_ARGS__)) \
+    ) /*endif*/ as opentitanlib::test_utils::ujson_binary::UjsonBinary>::BINARY_SIZE
+
+#define ujson_bin_size_string(name_, size_, ...) + size_
+
+#define ujson_bin_write_field(name_, type_, ...) \
+    opentitanlib::test_utils::ujson_binary::UjsonBinary::write_binary(&self.name_, out);
+
+#define ujson_bin_write_string(name_, size_, ...) \
+    opentitanlib::test_utils::ujson_binary::write_string(&self.name_, size_, out);
+
+#define ujson_bin_read_field(name_, type_, ...) \
+    name_: opentitanlib::test_utils::ujson_binary::UjsonBinary::read_binary(input)?,
+
+#define ujson_bin_read_string(name_, size_, ...) \
+    name_: opentitanlib::test_utils::ujson_binary::read_string(input, size_)?,
+
+#define UJSON_IMPL_BINARY_STRUCT(name_, decl_) \
+    impl opentitanlib::test_utils::ujson_binary::UjsonBinary for name_ { \
+        const BINARY_SIZE: usize = 0 decl_(ujson_bin_size_field, ujson_bin_size_string); \
+        fn write_binary(&self, out: &mut Vec<u8>) { \
+            decl_(ujson_bin_write_field, ujson_bin_write_string) \
+        } \
+        fn read_binary(input: &mut &[u8]) \
+                -> opentitanlib::test_utils::ujson_binary::Result<Self> { \
+            Ok(Self { decl_(ujson_bin_read_field, ujson_bin_read_string) }) \
+        } \
+    }
+
+#define ujson_bin_enum_value(formal_name_, name_, ...) Self::name_,
+
+// The enums are `repr(u32)`, so the discriminant of every variant other than
+// `IntValue` is the first `u32` of the value.
+#define UJSON_IMPL_BINARY_ENUM(formal_name_, name_, decl_) \
+    impl opentitanlib::test_utils::ujson_binary::UjsonBinary for name_ { \
+        const BINARY_SIZE: usize = 4; \
+        fn write_binary(&self, out: &mut Vec<u8>) { \
+            let value = match self { \
+                Self::RUST_ENUM_INTVALUE(v) => *v, \
+                _ => unsafe { *(self as *const Self).cast::<u32>() }, \
+            }; \
+            opentitanlib::test_utils::ujson_binary::UjsonBinary::write_binary(&value, out) \
+        } \
+        fn read_binary(input: &mut &[u8]) \
+                -> opentitanlib::test_utils::ujson_binary::Result<Self> { \
+            let value = <u32 as opentitanlib::test_utils::ujson_binary::UjsonBinary>::read_binary(input)?; \
+            for v in [decl_(formal_name_, ujson_bin_enum_value)] { \
+                if unsafe { *(&v as *const Self).cast::<u32>() } == value { \
+                    return Ok(v); \
+                } \
+            } \
+            Ok(Self::RUST_ENUM_INTVALUE(value)) \
+        } \
+    }
+
 #define UJSON_DECLARE_STRUCT(formal_name_, name_, decl_, ...) \
     OT_IIF(OT_NOT(OT_VA_ARGS_COUNT(dummy, ##__VA_ARGS__))) \
     ( /*then*/ \
@@ -103,9 +165,11 @@ use opentitanlib::test_utils::status::status_t;
 // Combined build-everything macro
 //////////////////////////////////////////////////////////////////////
 #define UJSON_SERDE_STRUCT(formal_name_, name_, decl_, ...) \
+  UJSON_IMPL_BINARY_STRUCT(name_, decl_)                    \
   UJSON_DECLARE_STRUCT(formal_name_, name_, decl_, ##__VA_ARGS__)
 
 #define UJSON_SERDE_ENUM(formal_name_, name_, decl_, ...) \
+  UJSON_IMPL_BINARY_ENUM(formal_name_, name_, decl_)    \
   UJSON_DECLARE_ENUM(formal_name_, name_, decl_, ##__VA_ARGS__)
 
 #define C_ONLY(x) const _ : () = {/* eat a semicolon */}
@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 
 #include "sw/device/lib/base/status.h"
 #include "sw/device/lib/ujson/test_helpers.h"
@@ -28,6 +29,58 @@ TEST(UJson, GetC) {
   EXPECT_EQ(status_err(ujson_getc(&uj)), kResourceExhausted);
 }
 
+TEST(UJson, GetCBuffered) {
+  SourceSink ss("abc123");
+  ujson_t uj = ss.UJsonBuffered(4);
+
+  EXPECT_EQ(ujson_getc(&uj).value, 'a');
+  EXPECT_EQ(ujson_getc(&uj).value, 'b');
+  EXPECT_EQ(ujson_getc(&uj).value, 'c');
+  EXPECT_EQ(status_err(ujson_ungetc(&uj, 'd')), kOk);
+  EXPECT_EQ(ujson_getc(&uj).value, 'd');
+  EXPECT_EQ(ujson_getc(&uj).value, '1');
+  EXPECT_EQ(ujson_getc(&uj).value, '2');
+  EXPECT_EQ(ujson_getc(&uj).value, '3');
+  EXPECT_EQ(status_err(ujson_getc(&uj)), kResourceExhausted);
+}
+
+// Reads `{"key":"value"}, ` records, resetting the CRC and writing output in
+// between, and returns the CRCs taken along the way.
+std::vector<uint32_t> RecordCrcs(ujson_t *uj) {
+  std::vector<uint32_t> crcs;
+  char str[64];
+  while (status_ok(ujson_consume(uj, '{'))) {
+    ujson_crc32_reset(uj);
+    EXPECT_TRUE(status_ok(ujson_parse_qs(uj, str, sizeof(str))));
+    EXPECT_TRUE(status_ok(ujson_putbuf(uj, "ok", 2)));
+    EXPECT_TRUE(status_ok(ujson_consume(uj, ':')));
+    EXPECT_TRUE(status_ok(ujson_parse_qs(uj, str, sizeof(str))));
+    crcs.push_back(ujson_crc32_finish(uj));
+    EXPECT_TRUE(status_ok(ujson_consume(uj, '}')));
+    EXPECT_TRUE(status_ok(ujson_consume(uj, ',')));
+    crcs.push_back(ujson_crc32_finish(uj));
+  }
+  return crcs;
+}
+
+TEST(UJson, Crc32Buffered) {
+  std::string input;
+  for (int i = 0; i < 10; ++i) {
+    input += R"json({"message":"The quick brown fox"}, )json";
+  }
+  SourceSink ss(input);
+  ujson_t uj = ss.UJson();
+  std::vector<uint32_t> expected = RecordCrcs(&uj);
+  EXPECT_EQ(expected.size(), 20);
+
+  // The CRCs must not depend on how the input is read.
+  for (size_t chunk : {1, 7, 16, 64}) {
+    ss.Reset();
+    uj = ss.UJsonBuffered(chunk);
+    EXPECT_EQ(RecordCrcs(&uj), expected) << "chunk=" << chunk;
+  }
+}
+
 TEST(UJson, PutBuf) {
   SourceSink ss;
   ujson_t uj = ss.UJson();
@@ -161,6 +214,98 @@ TEST(UJson, ParseIntegerError) {
   EXPECT_EQ(status_err(s), kNotFound);
 }
 
+TEST(UJson, ParseHexBytes) {
+  SourceSink ss(R"json( "0123456789abcdefABCDEF")json");
+  ujson_t uj = ss.UJsonBuffered();
+  uint8_t buf[12] = {0};
+  status_t s = ujson_parse_hex_bytes(&uj, buf, sizeof(buf));
+  EXPECT_EQ(status_err(s), kOk);
+  EXPECT_EQ(s.value, 11);
+  const uint8_t expected[12] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab,
+                                0xcd, 0xef, 0xab, 0xcd, 0xef, 0x00};
+  EXPECT_EQ(memcmp(buf, expected, sizeof(buf)), 0);
+
+  // Extra bytes are consumed, but not stored.
+  ss.Reset(R"json("a1b2c3" 5)json");
+  uj = ss.UJsonBuffered();
+  s = ujson_parse_hex_bytes(&uj, buf, 2);
+  EXPECT_EQ(s.value, 3);
+  EXPECT_EQ(buf[0], 0xa1);
+  EXPECT_EQ(buf[1], 0xb2);
+  EXPECT_EQ(buf[2], 0x45);
+  uint32_t next;
+  EXPECT_TRUE(status_ok(ujson_deserialize_uint32_t(&uj, &next)));
+  EXPECT_EQ(next, 5);
+
+  // Not a hex digit.
+  ss.Reset(R"json("0g")json");
+  uj = ss.UJsonBuffered();
+  s = ujson_parse_hex_bytes(&uj, buf, sizeof(buf));
+  EXPECT_EQ(status_err(s), kOutOfRange);
+
+  // Odd number of digits.
+  ss.Reset(R"json("012")json");
+  uj = ss.UJsonBuffered();
+  s = ujson_parse_hex_bytes(&uj, buf, sizeof(buf));
+  EXPECT_EQ(status_err(s), kOutOfRange);
+}
+
+TEST(UJson, Binary) {
+  SourceSink ss;
+  ujson_t uj = ss.UJson();
+  uj.format = kUjsonFormatBinary;
+  uint32_t u32 = 0x12345678;
+  int16_t i16 = -2;
+  bool b = true;
+  status_t sts = INVALID_ARGUMENT();
+  EXPECT_TRUE(status_ok(ujson_serialize_uint32_t(&uj, &u32)));
+  EXPECT_TRUE(status_ok(ujson_serialize_int16_t(&uj, &i16)));
+  EXPECT_TRUE(status_ok(ujson_serialize_bool(&uj, &b)));
+  EXPECT_TRUE(status_ok(ujson_serialize_status_t(&uj, &sts)));
+  std::string expected("\x78\x56\x34\x12\xfe\xff\x01", 7);
+  expected.append(reinterpret_cast<const char *>(&sts.value), 4);
+  EXPECT_EQ(ss.Sink(), expected);
+
+  size_t size = 0;
+  ujson_t counter = ujson_binary_counter(&size);
+  EXPECT_TRUE(status_ok(ujson_serialize_uint32_t(&counter, &u32)));
+  EXPECT_TRUE(status_ok(ujson_serialize_bool(&counter, &b)));
+  EXPECT_EQ(size, 5);
+
+  ss.Reset(expected);
+  u32 = 0;
+  i16 = 0;
+  b = false;
+  sts = OK_STATUS();
+  EXPECT_TRUE(status_ok(ujson_deserialize_uint32_t(&uj, &u32)));
+  EXPECT_TRUE(status_ok(ujson_deserialize_int16_t(&uj, &i16)));
+  EXPECT_TRUE(status_ok(ujson_deserialize_bool(&uj, &b)));
+  EXPECT_TRUE(status_ok(ujson_deserialize_status_t(&uj, &sts)));
+  EXPECT_EQ(u32, 0x12345678);
+  EXPECT_EQ(i16, -2);
+  EXPECT_TRUE(b);
+  EXPECT_EQ(status_err(sts), kInvalidArgument);
+  EXPECT_EQ(status_err(ujson_getc(&uj)), kResourceExhausted);
+}
+
+TEST(UJson, GetBytes) {
+  SourceSink ss("0123456789abcdefghijklmnopqrstuvwxyz");
+  for (size_t chunk : {0, 1, 5, 64}) {
+    ss.Reset();
+    ujson_t uj = chunk ? ss.UJsonBuffered(chunk) : ss.UJson();
+    char buf[16] = {0};
+    EXPECT_EQ(ujson_getc(&uj).value, '0');
+    EXPECT_TRUE(status_ok(ujson_ungetc(&uj, '0')));
+    EXPECT_TRUE(status_ok(ujson_get_bytes(&uj, buf, 12)));
+    EXPECT_EQ(std::string(buf), "0123456789ab");
+    EXPECT_TRUE(status_ok(ujson_get_bytes(&uj, buf, 0)));
+    EXPECT_EQ(ujson_getc(&uj).value, 'c');
+    EXPECT_TRUE(status_ok(ujson_get_bytes(&uj, buf, 15)));
+    EXPECT_EQ(std::string(buf), "defghijklmnopqr");
+    EXPECT_EQ(status_err(ujson_get_bytes(&uj, buf, 16)), kResourceExhausted);
+  }
+}
+
 TEST(UJson, SerializeString) {
   SourceSink ss;
   ujson uj = ss.UJson();
@@ -315,8 +315,10 @@ typedef struct active_page_info {
  * Updates the given active page info struct and last valid boot data entry
  * using the given page.
  *
- * This function performs a forward search to find the first empty boot data
- * entry followed by a backward search to find the last valid boot data entry.
+ * This function performs a binary search over the sniffed identifiers to find
+ * the first entry that can be empty, a forward search from there to find the
+ * first empty boot data entry, and a backward search to find the last valid
+ * boot data entry.
  * If the page has an entry that is newer than the one passed in, this function
  * updates `page_info` and `boot_data`. Reads must be enabled for the given page
  * before this function is called, see `boot_data_page_info_get()`.
@@ -332,21 +334,47 @@ OT_WARN_UNUSED_RESULT
 static rom_error_t boot_data_page_info_update_impl(
     const flash_ctrl_info_page_t *page, active_page_info_t *page_info,
     boot_data_t *boot_data) {
-  uint32_t sniff_results[kBootDataEntriesPerPage];
-
   boot_data_t buf;
 
-  // Perform a forward search to find the first empty entry.
+  // Entries are written in order, so every entry before the first empty entry
+  // is non-empty. Perform a binary search using only the sniffed identifiers
+  // to find the first entry that can be empty. Entry 0 is checked first since
+  // pages that are completely erased are common.
+  uint32_t sniff_result;
+  HARDENED_RETURN_IF_ERROR(boot_data_sniff(page, 0, &sniff_result));
+  size_t lo = 0, hi = kBootDataEntriesPerPage;
+  if (sniff_result == kFlashCtrlErasedWord) {
+    hi = 0;
+  } else {
+    lo = 1;
+  }
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    HARDENED_RETURN_IF_ERROR(boot_data_sniff(page, mid, &sniff_result));
+    if (sniff_result == kFlashCtrlErasedWord) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  HARDENED_CHECK_LE(lo, kBootDataEntriesPerPage);
+  const size_t search_index = lo;
+
+  // Perform a forward search starting at the candidate to find the first empty
+  // entry. Entries that were only partially written because of an interrupted
+  // write are sniffed as erased but are not empty and are skipped here. The
+  // candidate itself is already known to be sniffed as erased.
   hardened_bool_t has_empty_entry = kHardenedBoolFalse;
-  size_t i = 0, r = kBootDataEntriesPerPage - 1;
+  size_t i = search_index, r = kBootDataEntriesPerPage - 1 - search_index;
+  sniff_result = kFlashCtrlErasedWord;
   for (; launder32(i) < kBootDataEntriesPerPage &&
          launder32(r) < kBootDataEntriesPerPage;
        ++i, --r) {
-    // Read and cache the identifier to quickly determine if an entry can be
-    // empty or valid.
-    HARDENED_RETURN_IF_ERROR(boot_data_sniff(page, i, &sniff_results[i]));
+    if (i != search_index) {
+      HARDENED_RETURN_IF_ERROR(boot_data_sniff(page, i, &sniff_result));
+    }
     // Check all words of this entry only if it can be empty.
-    if (sniff_results[i] == kFlashCtrlErasedWord) {
+    if (sniff_result == kFlashCtrlErasedWord) {
       HARDENED_RETURN_IF_ERROR(boot_data_entry_read(page, i, &buf));
       has_empty_entry = boot_data_is_empty(&buf);
       if (launder32(has_empty_entry) == kHardenedBoolTrue) {
@@ -368,7 +396,8 @@ static rom_error_t boot_data_page_info_update_impl(
                  launder32(r) < kBootDataEntriesPerPage;
        --i, ++r) {
     // Check the digest only if this entry can be valid.
-    if (sniff_results[i] == kBootDataIdentifier) {
+    HARDENED_RETURN_IF_ERROR(boot_data_sniff(page, i, &sniff_result));
+    if (sniff_result == kBootDataIdentifier) {
       HARDENED_RETURN_IF_ERROR(boot_data_entry_read(page, i, &buf));
       rom_error_t is_valid = boot_data_check(&buf);
       if (launder32(is_valid) == kErrorOk) {
@@ -264,24 +264,38 @@ class BootDataTest : public rom_test::RomTest {
     // #1. Non-erased and bootable provided boot_data.
     // #2. Non-erased and bootable but invalid digest.
     // #3. Entry with sniffed area erased but the rest not.
-    // #4. Fully erased entry.
+    // #4-#15. Fully erased entries.
     return [=](const flash_ctrl_info_page_t *page) {
-      // Expect to sniff each entry, fully reading if it could be erased.
+      // Expect a binary search over the sniffed entries.
       ExpectSniff(page, 0, non_erased_entry_, kErrorOk);
-      ExpectSniff(page, 1, boot_data_raw, kErrorOk);
+      ExpectSniff(page, 8, erased_entry_, kErrorOk);
+      ExpectSniff(page, 4, erased_entry_, kErrorOk);
       ExpectSniff(page, 2, boot_data_raw, kErrorOk);
       ExpectSniff(page, 3, part_erased_entry_, kErrorOk);
+
+      // Expect to fully read the candidate and step forward since it is not
+      // actually empty.
       ExpectRead(page, 3, part_erased_entry_, kErrorOk);
       ExpectSniff(page, 4, erased_entry_, kErrorOk);
       ExpectRead(page, 4, erased_entry_, kErrorOk);
 
-      // Check the last seen bootable entry's digest (mocked as invalid).
+      // Step back over the partially erased entry.
+      ExpectSniff(page, 3, part_erased_entry_, kErrorOk);
+
+      // Check the last bootable entry's digest (mocked as invalid).
+      ExpectSniff(page, 2, boot_data_raw, kErrorOk);
       ExpectRead(page, 2, boot_data_raw, kErrorOk);
       ExpectDigestCompute(boot_data, false);
 
-      // Step back to the previously seen bootable entry (provided `boot_data`).
+      // Step back to the previous bootable entry (provided `boot_data`).
+      ExpectSniff(page, 1, boot_data_raw, kErrorOk);
       ExpectRead(page, 1, boot_data_raw, kErrorOk);
       ExpectDigestCompute(boot_data, valid_digest);
+
+      // Step back over the non-bootable entry if there is no valid entry.
+      if (!valid_digest) {
+        ExpectSniff(page, 0, non_erased_entry_, kErrorOk);
+      }
     };
   }
 
@@ -297,6 +311,32 @@ class BootDataTest : public rom_test::RomTest {
     };
   }
 
+  /**
+   * Provides a lambda function mocking a page with no empty entries whose last
+   * entry is the given `boot_data`.
+   *
+   * @param boot_data Bootable boot data entry at the end of the page.
+   * @return Lambda function for use with `ExpectPageScan`.
+   */
+  auto FullPage(boot_data_t boot_data) {
+    std::array<uint32_t, kBootDataNumWords> boot_data_raw = {};
+    std::memcpy(boot_data_raw.data(), &boot_data, sizeof(boot_data_t));
+
+    return [=](const flash_ctrl_info_page_t *page) {
+      // Expect the binary search to sniff only a few entries.
+      ExpectSniff(page, 0, non_erased_entry_, kErrorOk);
+      ExpectSniff(page, 8, non_erased_entry_, kErrorOk);
+      ExpectSniff(page, 12, non_erased_entry_, kErrorOk);
+      ExpectSniff(page, 14, non_erased_entry_, kErrorOk);
+      ExpectSniff(page, 15, boot_data_raw, kErrorOk);
+
+      // Expect only the last entry to be fully read.
+      ExpectSniff(page, 15, boot_data_raw, kErrorOk);
+      ExpectRead(page, 15, boot_data_raw, kErrorOk);
+      ExpectDigestCompute(boot_data, true);
+    };
+  }
+
   /**
    * Sets an expectation that the device queries for whether the default boot
    * data entry should be loaded when in the `prod` lifecycle state.
@@ -362,6 +402,16 @@ TEST_F(BootDataReadTest, ReadOneEntryTest) {
   EXPECT_EQ(boot_data, kValidEntry0);
 }
 
+TEST_F(BootDataReadTest, ReadFullPageTest) {
+  // Expect both pages to be searched, with the newer entry in a full page.
+  ExpectPageScan(&kFlashCtrlInfoPageBootData0, EntryPage(kValidEntry0));
+  ExpectPageScan(&kFlashCtrlInfoPageBootData1, FullPage(kValidEntry1));
+
+  boot_data_t boot_data = {{0}};
+  EXPECT_EQ(boot_data_read(kLcStateTest, &boot_data), kErrorOk);
+  EXPECT_EQ(boot_data, kValidEntry1);
+}
+
 TEST_F(BootDataReadTest, ReadOneValidTest) {
   // Expect both pages to be searched, but give only a valid entry for one.
   ExpectPageScan(&kFlashCtrlInfoPageBootData0, EntryPage(kValidEntry0));
@@ -7,14 +7,15 @@
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/silicon_creator/lib/drivers/hmac.h"
 
+enum {
+  kDigestRegionOffset = sizeof(hmac_digest_t),
+  kDigestRegionSize = sizeof(boot_log_t) - kDigestRegionOffset,
+};
+static_assert(offsetof(boot_log_t, digest) == 0,
+              "`digest` must be the first field of `boot_log_t`.");
+
 static void boot_log_digest_compute(const boot_log_t *boot_log,
                                     hmac_digest_t *digest) {
-  enum {
-    kDigestRegionOffset = sizeof(boot_log->digest),
-    kDigestRegionSize = sizeof(boot_log_t) - kDigestRegionOffset,
-  };
-  static_assert(offsetof(boot_log_t, digest) == 0,
-                "`digest` must be the first field of `boot_log_t`.");
   hmac_sha256((const char *)boot_log + kDigestRegionOffset, kDigestRegionSize,
               digest);
 }
@@ -23,6 +24,17 @@ void boot_log_digest_update(boot_log_t *boot_log) {
   boot_log_digest_compute(boot_log, &boot_log->digest);
 }
 
+void boot_log_digest_update_start(const boot_log_t *boot_log) {
+  hmac_sha256_init();
+  hmac_sha256_update((const char *)boot_log + kDigestRegionOffset,
+                     kDigestRegionSize);
+  hmac_sha256_process();
+}
+
+void boot_log_digest_update_finish(boot_log_t *boot_log) {
+  hmac_sha256_final(&boot_log->digest);
+}
+
 /*
  * Shares for producing the `error` value in `boot_log_digest_check()`. First 8
  * shares are generated using the `sparse-fsm-encode` script while the last
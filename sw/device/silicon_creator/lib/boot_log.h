@@ -53,8 +53,20 @@ typedef struct boot_log {
   uint32_t primary_bl0_slot;
   /** Whether the RET-RAM was initialized on this boot (hardened_bool_t). */
   uint32_t retention_ram_initialized;
+  /**
+   * Stack high-water mark of the ROM in bytes.
+   *
+   * Only recorded when built with `STACK_UTILIZATION_CHECK`, zero otherwise.
+   */
+  uint32_t rom_stack_used;
+  /**
+   * Stack high-water mark of the ROM_EXT at the BL0 handoff in bytes.
+   *
+   * Only recorded when built with `STACK_UTILIZATION_CHECK`, zero otherwise.
+   */
+  uint32_t rom_ext_stack_used;
   /** Pad to 128 bytes. */
-  uint32_t reserved[8];
+  uint32_t reserved[6];
 } boot_log_t;
 
 OT_ASSERT_MEMBER_OFFSET(boot_log_t, digest, 0);
@@ -72,7 +84,9 @@ OT_ASSERT_MEMBER_OFFSET(boot_log_t, rom_ext_min_sec_ver, 80);
 OT_ASSERT_MEMBER_OFFSET(boot_log_t, bl0_min_sec_ver, 84);
 OT_ASSERT_MEMBER_OFFSET(boot_log_t, primary_bl0_slot, 88);
 OT_ASSERT_MEMBER_OFFSET(boot_log_t, retention_ram_initialized, 92);
-OT_ASSERT_MEMBER_OFFSET(boot_log_t, reserved, 96);
+OT_ASSERT_MEMBER_OFFSET(boot_log_t, rom_stack_used, 96);
+OT_ASSERT_MEMBER_OFFSET(boot_log_t, rom_ext_stack_used, 100);
+OT_ASSERT_MEMBER_OFFSET(boot_log_t, reserved, 104);
 
 enum {
   /**
@@ -92,6 +106,26 @@ enum {
  */
 void boot_log_digest_update(boot_log_t *boot_log);
 
+/**
+ * Starts updating the digest of the boot_log.
+ *
+ * Feeds the boot_log to the HMAC block and starts the final digest
+ * computation without waiting for it. The caller may perform work that does
+ * not use the HMAC block or modify the boot_log before calling
+ * `boot_log_digest_update_finish()`.
+ *
+ * @param boot_log A buffer that holds the boot_log.
+ */
+void boot_log_digest_update_start(const boot_log_t *boot_log);
+
+/**
+ * Waits for the digest started by `boot_log_digest_update_start()` and
+ * updates the digest field of the boot_log.
+ *
+ * @param boot_log A buffer that holds the boot_log.
+ */
+void boot_log_digest_update_finish(boot_log_t *boot_log);
+
 /**
  * Checks whether a boot_log entry is valid.
  *
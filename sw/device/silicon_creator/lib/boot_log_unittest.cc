@@ -99,6 +99,41 @@ TEST_F(BootLogTest, DigestUpdate) {
   EXPECT_EQ(expected_chip_version, boot_log.chip_version);
 }
 
+TEST_F(BootLogTest, DigestUpdateStartFinish) {
+  hmac_digest_t new_digest = {
+      .digest =
+          {
+              0xffffffff,
+              0xeeeeeeee,
+              0xdddddddd,
+              0xcccccccc,
+              0x00000000,
+              0x11111111,
+              0x22222222,
+              0x33333333,
+          },
+  };
+
+  void *expected_digest_region_start =
+      (char *)&boot_log + sizeof(hmac_digest_t);
+  size_t expected_digest_region_len =
+      sizeof(boot_log_t) - sizeof(hmac_digest_t);
+  EXPECT_CALL(hmac_sha256_, sha256_init());
+  EXPECT_CALL(hmac_sha256_, sha256_update(expected_digest_region_start,
+                                          expected_digest_region_len));
+  EXPECT_CALL(hmac_sha256_, sha256_process());
+  boot_log_digest_update_start(&boot_log);
+  // The digest field is only updated once the operation is finished.
+  EXPECT_EQ(expected_digest, boot_log.digest);
+
+  EXPECT_CALL(hmac_sha256_, sha256_final(_))
+      .WillOnce(testing::SetArgPointee<0>(new_digest));
+  boot_log_digest_update_finish(&boot_log);
+
+  EXPECT_EQ(new_digest, boot_log.digest);
+  EXPECT_EQ(kBootLogIdentifier, boot_log.identifier);
+}
+
 TEST_F(BootLogTest, BootLogCheckSuccess) {
   // Have the HMAC function return a matching digest
   hmac_digest_t new_digest = {
@@ -0,0 +1,9 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/silicon_creator/lib/boot_timing.h"
+
+// Extern declarations for the inline functions in the header.
+extern void boot_timing_record(boot_timing_t *boot_timing,
+                               boot_timing_milestone_t milestone);
@@ -0,0 +1,100 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_BOOT_TIMING_H_
+#define OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_BOOT_TIMING_H_
+
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/silicon_creator/lib/drivers/ibex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Boot milestones whose times are recorded in the boot_timing.
+ *
+ * The values index `boot_timing_t.milestones` and are part of the retention
+ * SRAM layout, so they must not be renumbered.
+ */
+typedef enum boot_timing_milestone {
+  /** ROM: entry to `rom_init()`. */
+  kBootTimingRomInit = 0,
+  /** ROM: `rom_init()` done. */
+  kBootTimingRomInitDone = 1,
+  /** ROM: start of the verification of the last ROM_EXT tried. */
+  kBootTimingRomVerify = 2,
+  /** ROM: ROM_EXT digest computed, signature verification starts. */
+  kBootTimingRomDigestDone = 3,
+  /** ROM: ROM_EXT signatures verified. */
+  kBootTimingRomVerifyDone = 4,
+  /** ROM: start of the OTP partition measurement (if enabled). */
+  kBootTimingRomMeasureOtp = 5,
+  /** ROM: OTP partition measurement done (if enabled). */
+  kBootTimingRomMeasureOtpDone = 6,
+  /** ROM: jump to ROM_EXT (or to its immutable section). */
+  kBootTimingRomJump = 7,
+  /** ROM_EXT: entry to `rom_ext_main()`. */
+  kBootTimingRomExtStart = 8,
+  /** ROM_EXT: silicon and creator attestation done. */
+  kBootTimingRomExtAttestationDone = 9,
+  /** ROM_EXT: start of the verification of the last owner slot tried. */
+  kBootTimingRomExtVerify = 10,
+  /** ROM_EXT: owner firmware signature verified. */
+  kBootTimingRomExtVerifyDone = 11,
+  /** ROM_EXT: owner attestation done and DICE certificates flashed. */
+  kBootTimingRomExtCertsDone = 12,
+  /** ROM_EXT: jump to the owner firmware. */
+  kBootTimingRomExtJump = 13,
+  /** ROM: SPX+ signature verified, ECDSA may still be running on OTBN. */
+  kBootTimingRomSpxDone = 14,
+  /** Number of milestones. */
+  kBootTimingMilestoneCount = 15,
+} boot_timing_milestone_t;
+
+/**
+ * The boot_timing records when the boot stages reached their milestones.
+ *
+ * Each milestone holds the low 32 bits of `mcycle` when it was reached, or
+ * zero if it wasn't. Once `rom_main()` starts, the silicon creator stages
+ * don't write `mcycle`, so all the entries of a boot share a time base and
+ * the cost of a step is the difference between two of them (they wrap after
+ * about 42 s at 100 MHz). ROM clears the record on every boot, and the owner
+ * stage can read it back from the retention SRAM.
+ */
+typedef struct boot_timing {
+  /** Identifier (`BTIM`). */
+  uint32_t identifier;
+  /** `mcycle` at each milestone, indexed by `boot_timing_milestone_t`. */
+  uint32_t milestones[kBootTimingMilestoneCount];
+} boot_timing_t;
+OT_ASSERT_MEMBER_OFFSET(boot_timing_t, identifier, 0);
+OT_ASSERT_MEMBER_OFFSET(boot_timing_t, milestones, 4);
+OT_ASSERT_SIZE(boot_timing_t, 64);
+
+enum {
+  /**
+   * Boot timing identifier value (ASCII "BTIM").
+   */
+  kBootTimingIdentifier = 0x4d495442,
+};
+
+/**
+ * Records that a milestone has been reached.
+ *
+ * @param boot_timing A buffer that holds the boot_timing.
+ * @param milestone The milestone.
+ */
+inline void boot_timing_record(boot_timing_t *boot_timing,
+                               boot_timing_milestone_t milestone) {
+  boot_timing->milestones[milestone] = ibex_mcycle32();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_BOOT_TIMING_H_
@@ -112,6 +112,9 @@ static rom_error_t bootstrap_sector_erase(uint32_t addr) {
  * If `byte_count` is not a multiple of flash word size, it's rounded up to next
  * flash word and missing bytes in `data` are set to `0xff`.
  *
+ * This function clears the WIP and WEN bits of the flash status register once
+ * `addr` has been validated, i.e. before the flash write completes.
+ *
  * @param addr Address to write to, must be flash word aligned.
  * @param byte_count Number of bytes to write. Rounded up to next flash word if
  * not a multiple of flash word size. Missing bytes in `data` are set to `0xff`.
@@ -158,6 +161,12 @@ static rom_error_t bootstrap_page_program(uint32_t addr, size_t byte_count,
   }
   size_t rem_word_count = byte_count / sizeof(uint32_t);
 
+  // The payload has already been copied out of the SPI device's buffer, so we
+  // clear WIP and WEN bits before programming to let the host upload the next
+  // page while this one is being written. A programming error still aborts
+  // bootstrap, which the host observes as a timeout on its next command.
+  spi_device_flash_status_clear();
+
   flash_ctrl_data_default_perms_set((flash_ctrl_perms_t){
       .read = kMultiBitBool4False,
       .write = kMultiBitBool4True,
@@ -291,9 +300,14 @@ static rom_error_t bootstrap_handle_program(bootstrap_state_t *state) {
       error = bootstrap_sector_erase(cmd.address);
       break;
     case kSpiDeviceOpcodePageProgram:
+    case kSpiDeviceOpcodeQuadPageProgram:
+      // Note: `bootstrap_page_program()` clears WIP and WEN bits itself. We
+      // must not clear them again below since the host may have already sent
+      // WREN for the next command.
       error = bootstrap_page_program(cmd.address, cmd.payload_byte_count,
                                      cmd.payload);
-      break;
+      HARDENED_RETURN_IF_ERROR(error);
+      return error;
     case kSpiDeviceOpcodeReset:
       // In a normal build, this function inlines to nothing.
       stack_utilization_print();
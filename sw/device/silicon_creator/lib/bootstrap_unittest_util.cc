@@ -141,6 +141,13 @@ spi_device_cmd_t PageProgramCmd(uint32_t address, size_t payload_byte_count) {
   return cmd;
 }
 
+spi_device_cmd_t QuadPageProgramCmd(uint32_t address,
+                                    size_t payload_byte_count) {
+  spi_device_cmd_t cmd = PageProgramCmd(address, payload_byte_count);
+  cmd.opcode = kSpiDeviceOpcodeQuadPageProgram;
+  return cmd;
+}
+
 spi_device_cmd_t ResetCmd() {
   return {
       .opcode = kSpiDeviceOpcodeReset,
@@ -112,6 +112,16 @@ spi_device_cmd_t SectorEraseCmd(uint32_t address);
  */
 spi_device_cmd_t PageProgramCmd(uint32_t address, size_t payload_byte_count);
 
+/**
+ * Returns a struct that represents a QUAD_PAGE_PROGRAM command.
+ *
+ * @param address Address field of the command.
+ * @param payload_byte_count Payload size in bytes.
+ * @return A `spi_device_cmd_t` that represents a QUAD_PAGE_PROGRAM command.
+ */
+spi_device_cmd_t QuadPageProgramCmd(uint32_t address,
+                                    size_t payload_byte_count);
+
 spi_device_cmd_t ResetCmd();
 
 }  // namespace bootstrap_unittest_util
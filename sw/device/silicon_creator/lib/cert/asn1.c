@@ -45,15 +45,28 @@ rom_error_t asn1_push_bytes(asn1_state_t *state, const uint8_t *bytes,
 
 rom_error_t asn1_start_tag(asn1_state_t *state, asn1_tag_t *new_tag,
                            uint8_t id) {
+  return asn1_start_tag_sized(state, new_tag, id, 0);
+}
+
+rom_error_t asn1_start_tag_sized(asn1_state_t *state, asn1_tag_t *new_tag,
+                                 uint8_t id, size_t max_len) {
+  static const uint8_t kZeros[3] = {0};
   new_tag->state = state;
   RETURN_IF_ERROR(asn1_push_byte(state, id));
   new_tag->len_offset = state->offset;
-  // We do not yet known how many bytes we need to encode the length. For now
-  // reserve one byte which is the minimum. This is then fixed in
-  // asn1_finish_tag by moving the data if necessary.
-
-  RETURN_IF_ERROR(asn1_push_byte(state, 0));
-  new_tag->len_size = 1;
+  // Reserve as many bytes as needed to encode `max_len`. If the actual length
+  // needs a different number of bytes, this is fixed in asn1_finish_tag by
+  // moving the data.
+  size_t len_size;
+  if (max_len <= 0x7f) {
+    len_size = 1;
+  } else if (max_len <= 0xff) {
+    len_size = 2;
+  } else {
+    len_size = 3;
+  }
+  RETURN_IF_ERROR(asn1_push_bytes(state, kZeros, len_size));
+  new_tag->len_size = len_size;
   return kErrorOk;
 }
 
@@ -62,8 +75,8 @@ rom_error_t asn1_finish_tag(asn1_tag_t *tag) {
   if (tag->state == NULL) {
     return kErrorAsn1Internal;
   }
-  // Sanity check: asn1_start_tag should have output one byte.
-  if (tag->len_size != 1) {
+  // Sanity check: asn1_start_tag_sized should have output one to three bytes.
+  if (tag->len_size < 1 || tag->len_size > 3) {
     return kErrorAsn1Internal;
   }
   // Compute actually used length.
@@ -87,7 +100,7 @@ rom_error_t asn1_finish_tag(asn1_tag_t *tag) {
   }
   // If the final length uses more bytes than we initially allocated, we
   // need to shift all the tag data backwards.
-  if (tag->len_size != final_len_size) {
+  if (final_len_size > tag->len_size) {
     // Make sure that the data actually fits into the buffer.
     size_t new_buffer_size =
         tag->state->offset + final_len_size - tag->len_size;
@@ -99,6 +112,12 @@ rom_error_t asn1_finish_tag(asn1_tag_t *tag) {
       tag->state->buffer[tag->len_offset + final_len_size + length - 1 - i] =
           tag->state->buffer[tag->len_offset + tag->len_size + length - 1 - i];
     }
+  } else if (final_len_size < tag->len_size) {
+    // If it uses fewer bytes, shift all the tag data forwards.
+    for (size_t i = 0; i < length; i++) {
+      tag->state->buffer[tag->len_offset + final_len_size + i] =
+          tag->state->buffer[tag->len_offset + tag->len_size + i];
+    }
   }
   // Write the length in the buffer.
   if (length <= 0x7f) {
@@ -115,7 +134,7 @@ rom_error_t asn1_finish_tag(asn1_tag_t *tag) {
     return kErrorAsn1Internal;
   }
   // Fix up state offset.
-  tag->state->offset += final_len_size - tag->len_size;
+  tag->state->offset = tag->state->offset - tag->len_size + final_len_size;
   // Hardening: clear out the tag structure to prevent accidental reuse.
   tag->state = NULL;
   tag->len_offset = 0;
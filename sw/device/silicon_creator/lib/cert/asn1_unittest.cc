@@ -436,5 +436,39 @@ TEST(Asn1, TagLengthEncoding) {
   EXPECT_EQ(buf, expected);
 }
 
+// Make sure that the tag encoding is correct regardless of the size hint.
+TEST(Asn1, TagLengthEncodingSized) {
+  const size_t kSizes[] = {0, 0x7f, 0x80, 0xff, 0x100, 0xffff};
+  for (size_t hint : kSizes) {
+    for (size_t size : kSizes) {
+      asn1_state_t state;
+      std::vector<uint8_t> expected, buf;
+      buf.resize(0xfffff);
+      std::vector<uint8_t> tmp(size, 0x5a);
+
+      asn1_tag_t tag;
+      EXPECT_EQ(asn1_start(&state, &buf[0], buf.size()), kErrorOk);
+      EXPECT_EQ(asn1_start_tag(&state, &tag, kAsn1TagNumberSequence),
+                kErrorOk);
+      EXPECT_EQ(asn1_push_bytes(&state, tmp.data(), tmp.size()), kErrorOk);
+      EXPECT_EQ(asn1_finish_tag(&tag), kErrorOk);
+      size_t expected_size;
+      EXPECT_EQ(asn1_finish(&state, &expected_size), kErrorOk);
+      expected.assign(buf.begin(), buf.begin() + expected_size);
+
+      EXPECT_EQ(asn1_start(&state, &buf[0], buf.size()), kErrorOk);
+      EXPECT_EQ(
+          asn1_start_tag_sized(&state, &tag, kAsn1TagNumberSequence, hint),
+          kErrorOk);
+      EXPECT_EQ(asn1_push_bytes(&state, tmp.data(), tmp.size()), kErrorOk);
+      EXPECT_EQ(asn1_finish_tag(&tag), kErrorOk);
+      size_t out_size;
+      EXPECT_EQ(asn1_finish(&state, &out_size), kErrorOk);
+      buf.resize(out_size);
+      EXPECT_EQ(buf, expected) << "hint: " << hint << ", size: " << size;
+    }
+  }
+}
+
 }  // namespace
 }  // namespace asn1_unittest
@@ -103,29 +103,49 @@ const sc_keymgr_ecc_key_t kDiceKeyCdi1 = {
 //     -2 : bstr,                   ; X coordinate, big-endian
 //     -3 : bstr                    ; Y coordinate, big-endian
 // }
+//
+// Only the coordinates vary, and they always have the same length, so the
+// deterministic encoding is fixed apart from the coordinate bytes. It is
+// emitted from these precomputed fragments instead of item by item.
+static_assert(sizeof(((ecdsa_p256_public_key_t *)NULL)->x) == 32 &&
+                  sizeof(((ecdsa_p256_public_key_t *)NULL)->y) == 32,
+              "The COSE_Key template assumes 32-byte coordinates");
+
+// Everything up to the X coordinate bytes.
+static const uint8_t kCoseKeyPrefix[] = {
+    0xa5,              // map(5)
+    0x01, 0x02,        // kCoseKeyKtyLabel : kCoseKeyKtyEc2
+    0x03, 0x26,        // kCoseKeyAlgLabel : kCoseKeyAlgEcdsa256
+    0x20, 0x01,        // kCoseEc2CrvLabel : kCoseEc2CrvP256
+    0x21, 0x58, 0x20,  // kCoseEc2XLabel : bstr(32)
+};
+
+// Between the X and Y coordinate bytes.
+static const uint8_t kCoseKeyYHeader[] = {
+    0x22, 0x58, 0x20,  // kCoseEc2YLabel : bstr(32)
+};
+
+enum {
+  kCoseKeyCoordSize = 32,
+  kCoseKeyXOffset = sizeof(kCoseKeyPrefix),
+  kCoseKeyYOffset =
+      kCoseKeyXOffset + kCoseKeyCoordSize + sizeof(kCoseKeyYHeader),
+  kCoseKeySize = kCoseKeyYOffset + kCoseKeyCoordSize,
+};
+
 rom_error_t dice_uds_tbs_cert_build(cert_key_id_pair_t *key_ids,
                                     ecdsa_p256_public_key_t *uds_pubkey,
                                     uint8_t *tbs_cert, size_t *tbs_cert_size) {
-  struct CborOut kCborOutHandle;
-
-  struct CborOut *pCborOut = &kCborOutHandle;
-
-  HARDENED_RETURN_IF_ERROR(
-      cbor_write_out_init(pCborOut, tbs_cert, *tbs_cert_size));
-  HARDENED_RETURN_IF_ERROR(cbor_map_init(pCborOut, 5));
-  HARDENED_RETURN_IF_ERROR(
-      cbor_write_pair_uint_uint(pCborOut, kCoseKeyKtyLabel, kCoseKeyKtyEc2));
-  HARDENED_RETURN_IF_ERROR(cbor_write_pair_uint_int(pCborOut, kCoseKeyAlgLabel,
-                                                    kCoseKeyAlgEcdsa256));
-  HARDENED_RETURN_IF_ERROR(
-      cbor_write_pair_int_uint(pCborOut, kCoseEc2CrvLabel, kCoseEc2CrvP256));
-  HARDENED_RETURN_IF_ERROR(cbor_write_pair_int_bytes(pCborOut, kCoseEc2XLabel,
-                                                     (uint8_t *)uds_pubkey->x,
-                                                     sizeof(uds_pubkey->x)));
-  HARDENED_RETURN_IF_ERROR(cbor_write_pair_int_bytes(pCborOut, kCoseEc2YLabel,
-                                                     (uint8_t *)uds_pubkey->y,
-                                                     sizeof(uds_pubkey->y)));
-  *tbs_cert_size = CborOutSize(pCborOut);
+  if (*tbs_cert_size < kCoseKeySize) {
+    return kErrorCertInvalidSize;
+  }
+
+  memcpy(tbs_cert, kCoseKeyPrefix, sizeof(kCoseKeyPrefix));
+  memcpy(&tbs_cert[kCoseKeyXOffset], uds_pubkey->x, kCoseKeyCoordSize);
+  memcpy(&tbs_cert[kCoseKeyXOffset + kCoseKeyCoordSize], kCoseKeyYHeader,
+         sizeof(kCoseKeyYHeader));
+  memcpy(&tbs_cert[kCoseKeyYOffset], uds_pubkey->y, kCoseKeyCoordSize);
+  *tbs_cert_size = kCoseKeySize;
 
   return kErrorOk;
 }
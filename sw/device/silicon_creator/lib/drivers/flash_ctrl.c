@@ -173,6 +173,51 @@ static rom_error_t wait_for_done(rom_error_t error) {
   return kErrorOk;
 }
 
+/**
+ * Reads data from the given partition.
+ *
+ * Reads longer than a single transaction can cover are split into
+ * transactions of the maximum size.
+ *
+ * @param addr Full byte address to read from.
+ * @param partition The partition to read from.
+ * @param word_count Number of bus words to read.
+ * @param[out] data Buffer to store the read data.
+ * @param error Error code to return in case of a flash controller error.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t read(uint32_t addr, flash_ctrl_partition_t partition,
+                        uint32_t word_count, void *data, rom_error_t error) {
+  enum {
+    kMaxTransactionWordCount = (FLASH_CTRL_CONTROL_NUM_MASK + 1),
+  };
+
+  while (word_count > 0) {
+    uint32_t transaction_word_count = word_count < kMaxTransactionWordCount
+                                          ? word_count
+                                          : kMaxTransactionWordCount;
+
+    transaction_start((transaction_params_t){
+        .addr = addr,
+        .op_type = FLASH_CTRL_CONTROL_OP_VALUE_READ,
+        .partition = partition,
+        .word_count = transaction_word_count,
+        // Does not apply to read transactions.
+        .erase_type = kFlashCtrlEraseTypePage,
+    });
+
+    fifo_read(transaction_word_count, data);
+    RETURN_IF_ERROR(wait_for_done(error));
+
+    addr += transaction_word_count * sizeof(uint32_t);
+    data = (char *)data + transaction_word_count * sizeof(uint32_t);
+    word_count -= transaction_word_count;
+  }
+
+  return kErrorOk;
+}
+
 /**
  * Writes data to the given partition.
  *
@@ -329,31 +374,15 @@ void flash_ctrl_error_code_get(flash_ctrl_error_code_t *error_code) {
 
 rom_error_t flash_ctrl_data_read(uint32_t addr, uint32_t word_count,
                                  void *data) {
-  transaction_start((transaction_params_t){
-      .addr = addr,
-      .op_type = FLASH_CTRL_CONTROL_OP_VALUE_READ,
-      .partition = kFlashCtrlPartitionData,
-      .word_count = word_count,
-      // Does not apply to read transactions.
-      .erase_type = kFlashCtrlEraseTypePage,
-  });
-  fifo_read(word_count, data);
-  return wait_for_done(kErrorFlashCtrlDataRead);
+  return read(addr, kFlashCtrlPartitionData, word_count, data,
+              kErrorFlashCtrlDataRead);
 }
 
 rom_error_t flash_ctrl_info_read(const flash_ctrl_info_page_t *info_page,
                                  uint32_t offset, uint32_t word_count,
                                  void *data) {
-  transaction_start((transaction_params_t){
-      .addr = info_page->base_addr + offset,
-      .op_type = FLASH_CTRL_CONTROL_OP_VALUE_READ,
-      .partition = kFlashCtrlPartitionInfo0,
-      .word_count = word_count,
-      // Does not apply to read transactions.
-      .erase_type = kFlashCtrlEraseTypePage,
-  });
-  fifo_read(word_count, data);
-  return wait_for_done(kErrorFlashCtrlInfoRead);
+  return read(info_page->base_addr + offset, kFlashCtrlPartitionInfo0,
+              word_count, data, kErrorFlashCtrlInfoRead);
 }
 
 rom_error_t flash_ctrl_data_write(uint32_t addr, uint32_t word_count,
@@ -383,6 +412,51 @@ rom_error_t flash_ctrl_data_erase(uint32_t addr,
   return wait_for_done(kErrorFlashCtrlDataErase);
 }
 
+/**
+ * Checks that `byte_count` bytes of the data partition starting at `addr` read
+ * as erased.
+ *
+ * Reads four words per iteration and folds them into a single AND reduction.
+ * Every word is read regardless of its value, i.e. there is no early exit.
+ *
+ * @param addr Start address, must be page aligned.
+ * @param byte_count Number of bytes to check, must be a multiple of
+ * `kEraseVerifyStride`.
+ * @param error Hardened error value seeded by the caller, `kErrorOk ^
+ * (byte_count - 1)`.
+ * @return Result of the operation.
+ */
+static rom_error_t erase_verify(uint32_t addr, size_t byte_count,
+                                rom_error_t error) {
+  enum {
+    kEraseVerifyStride = 4 * sizeof(uint32_t),
+  };
+  static_assert(FLASH_CTRL_PARAM_BYTES_PER_PAGE % kEraseVerifyStride == 0,
+                "Bytes per page must be a multiple of the unroll stride.");
+
+  const uint32_t base = TOP_EARLGREY_FLASH_CTRL_MEM_BASE_ADDR + addr;
+  uint32_t mask = kFlashCtrlErasedWord;
+  size_t i = 0, r = byte_count - 1;
+  for (; launder32(i) < byte_count && launder32(r) < byte_count;
+       i += kEraseVerifyStride, r -= kEraseVerifyStride) {
+    uint32_t word = abs_mmio_read32(base + i);
+    word &= abs_mmio_read32(base + i + sizeof(uint32_t));
+    word &= abs_mmio_read32(base + i + 2 * sizeof(uint32_t));
+    word &= abs_mmio_read32(base + i + 3 * sizeof(uint32_t));
+    mask &= word;
+    error &= word;
+  }
+  HARDENED_CHECK_EQ(i, byte_count);
+  HARDENED_CHECK_EQ(r, SIZE_MAX);
+
+  if (launder32(mask) == kFlashCtrlErasedWord) {
+    HARDENED_CHECK_EQ(mask, kFlashCtrlErasedWord);
+    return error ^ (byte_count - 1);
+  }
+
+  return kErrorFlashCtrlDataEraseVerify;
+}
+
 rom_error_t flash_ctrl_data_erase_verify(uint32_t addr,
                                          flash_ctrl_erase_type_t erase_type) {
   static_assert(__builtin_popcount(FLASH_CTRL_PARAM_BYTES_PER_BANK) == 1,
@@ -411,24 +485,25 @@ rom_error_t flash_ctrl_data_erase_verify(uint32_t addr,
 
   // Truncate to the closest lower bank/page aligned address.
   addr &= ~byte_count + 1;
-  uint32_t mask = kFlashCtrlErasedWord;
-  size_t i = 0, r = byte_count - 1;
-  for (; launder32(i) < byte_count && launder32(r) < byte_count;
-       i += sizeof(uint32_t), r -= sizeof(uint32_t)) {
-    uint32_t word =
-        abs_mmio_read32(TOP_EARLGREY_FLASH_CTRL_MEM_BASE_ADDR + addr + i);
-    mask &= word;
-    error &= word;
-  }
-  HARDENED_CHECK_EQ(i, byte_count);
-  HARDENED_CHECK_EQ(r, SIZE_MAX);
+  return erase_verify(addr, byte_count, error);
+}
 
-  if (launder32(mask) == kFlashCtrlErasedWord) {
-    HARDENED_CHECK_EQ(mask, kFlashCtrlErasedWord);
-    return error ^ (byte_count - 1);
-  }
+rom_error_t flash_ctrl_data_erase_verify_pages(uint32_t addr,
+                                               uint32_t page_count) {
+  enum {
+    kDataPartitionSize =
+        FLASH_CTRL_PARAM_BYTES_PER_BANK * FLASH_CTRL_PARAM_REG_NUM_BANKS,
+  };
 
-  return kErrorFlashCtrlDataEraseVerify;
+  // Truncate to the closest lower page aligned address.
+  addr &= ~(uint32_t)FLASH_CTRL_PARAM_BYTES_PER_PAGE + 1;
+  if (page_count == 0 || addr >= kDataPartitionSize ||
+      page_count > (kDataPartitionSize - addr) /
+                       FLASH_CTRL_PARAM_BYTES_PER_PAGE) {
+    return kErrorFlashCtrlDataEraseVerify;
+  }
+  size_t byte_count = page_count * FLASH_CTRL_PARAM_BYTES_PER_PAGE;
+  return erase_verify(addr, byte_count, kErrorOk ^ (byte_count - 1));
 }
 
 rom_error_t flash_ctrl_info_erase(const flash_ctrl_info_page_t *info_page,
@@ -291,6 +291,9 @@ void flash_ctrl_error_code_get(flash_ctrl_error_code_t *error_code);
  * address. For example, if 0x13 is supplied, the controller will perform a read
  * at address 0x10.
  *
+ * Reads of more words than a single flash controller transaction can cover are
+ * split into transactions of the maximum size.
+ *
  * @param addr Address to read from.
  * @param word_count Number of bus words to read.
  * @param[out] data Buffer to store the read data. Must be word aligned.
@@ -307,6 +310,8 @@ rom_error_t flash_ctrl_data_read(uint32_t addr, uint32_t word_count,
  * address. For example, if 0x13 is supplied, the controller will start reading
  * at address 0x10.
  *
+ * Reads are split into transactions as in `flash_ctrl_data_read()`.
+ *
  * @param info_page Information page to read from.
  * @param offset Offset from the start of the page.
  * @param word_count Number of bus words to read.
@@ -400,6 +405,21 @@ OT_WARN_UNUSED_RESULT
 rom_error_t flash_ctrl_data_erase_verify(uint32_t addr,
                                          flash_ctrl_erase_type_t erase_type);
 
+/**
+ * Verifies that a run of consecutive data partition pages was erased.
+ *
+ * Equivalent to calling `flash_ctrl_data_erase_verify()` for each page, but
+ * checks the whole run in a single pass.
+ *
+ * @param addr Address that falls within the first page of the run.
+ * @param page_count Number of pages to verify, must be non-zero and must not
+ * extend past the end of the data partition.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t flash_ctrl_data_erase_verify_pages(uint32_t addr,
+                                               uint32_t page_count);
+
 /**
  * Erases an information partition page or bank.
  *
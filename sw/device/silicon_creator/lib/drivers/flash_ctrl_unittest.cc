@@ -418,6 +418,35 @@ TEST_F(TransferTest, ProgAcrossWindows) {
             kErrorOk);
 }
 
+TEST_F(TransferTest, ReadAcrossTransactions) {
+  static const uint32_t kMaxWordCount = FLASH_CTRL_CONTROL_NUM_MASK + 1;
+
+  std::vector<uint32_t> many_words(kMaxWordCount + words_.size());
+  for (uint32_t i = 0; i < many_words.size(); ++i) {
+    many_words[i] = i;
+  }
+  auto iter = many_words.begin();
+
+  // The first transaction reads as many words as it can.
+  ExpectTransferStart(0, 0, 0, FLASH_CTRL_CONTROL_OP_VALUE_READ, 0x100,
+                      kMaxWordCount);
+  ExpectReadData(std::vector<uint32_t>(iter, iter + kMaxWordCount));
+  ExpectWaitForDone(true, false);
+  iter += kMaxWordCount;
+
+  // The second transaction reads the rest.
+  ExpectTransferStart(0, 0, 0, FLASH_CTRL_CONTROL_OP_VALUE_READ,
+                      0x100 + kMaxWordCount * sizeof(uint32_t),
+                      words_.size());
+  ExpectReadData(std::vector<uint32_t>(iter, many_words.end()));
+  ExpectWaitForDone(true, false);
+
+  std::vector<uint32_t> words_out(many_words.size());
+  EXPECT_EQ(flash_ctrl_data_read(0x100, words_out.size(), &words_out.front()),
+            kErrorOk);
+  EXPECT_EQ(words_out, many_words);
+}
+
 TEST_F(TransferTest, TransferInternalError) {
   ExpectTransferStart(0, 0, 0, FLASH_CTRL_CONTROL_OP_VALUE_READ, 0x01234567,
                       words_.size());
@@ -829,6 +858,42 @@ INSTANTIATE_TEST_SUITE_P(
            // large number of expectations.
         ));
 
+TEST_F(FlashCtrlTest, DataEraseVerifyPages) {
+  constexpr uint32_t kAddr = 10 * FLASH_CTRL_PARAM_BYTES_PER_PAGE;
+  for (size_t i = 0; i < 2 * FLASH_CTRL_PARAM_BYTES_PER_PAGE;
+       i += sizeof(uint32_t)) {
+    EXPECT_ABS_READ32(TOP_EARLGREY_FLASH_CTRL_MEM_BASE_ADDR + kAddr + i,
+                      kFlashCtrlErasedWord);
+  }
+
+  EXPECT_EQ(flash_ctrl_data_erase_verify_pages(kAddr + 128, 2), kErrorOk);
+}
+
+TEST_F(FlashCtrlTest, DataEraseVerifyPagesFail) {
+  constexpr uint32_t kAddr = 10 * FLASH_CTRL_PARAM_BYTES_PER_PAGE;
+  size_t i = 0;
+  for (; i < 2 * FLASH_CTRL_PARAM_BYTES_PER_PAGE - sizeof(uint32_t);
+       i += sizeof(uint32_t)) {
+    EXPECT_ABS_READ32(TOP_EARLGREY_FLASH_CTRL_MEM_BASE_ADDR + kAddr + i,
+                      kFlashCtrlErasedWord);
+  }
+  EXPECT_ABS_READ32(TOP_EARLGREY_FLASH_CTRL_MEM_BASE_ADDR + kAddr + i,
+                    0xfffffff0);
+
+  EXPECT_EQ(flash_ctrl_data_erase_verify_pages(kAddr, 2),
+            kErrorFlashCtrlDataEraseVerify);
+}
+
+TEST_F(FlashCtrlTest, DataEraseVerifyPagesBadRange) {
+  constexpr uint32_t kLastPage =
+      FLASH_CTRL_PARAM_BYTES_PER_BANK * FLASH_CTRL_PARAM_REG_NUM_BANKS -
+      FLASH_CTRL_PARAM_BYTES_PER_PAGE;
+  EXPECT_EQ(flash_ctrl_data_erase_verify_pages(0, 0),
+            kErrorFlashCtrlDataEraseVerify);
+  EXPECT_EQ(flash_ctrl_data_erase_verify_pages(kLastPage, 2),
+            kErrorFlashCtrlDataEraseVerify);
+}
+
 class DataRegionProtectTestSuite
     : public testing::TestWithParam<
           std::tuple<size_t, size_t, size_t, bool, bool, bool>> {
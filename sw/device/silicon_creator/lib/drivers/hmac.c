@@ -150,6 +150,7 @@ void hmac_sha256_save(hmac_context_t *ctx) {
   // Momentarily clear the `sha_en` bit, which clears the digest.
   uint32_t cfg =
       abs_mmio_read32(TOP_EARLGREY_HMAC_BASE_ADDR + HMAC_CFG_REG_OFFSET);
+  ctx->cfg = cfg;
   abs_mmio_write32(TOP_EARLGREY_HMAC_BASE_ADDR + HMAC_CFG_REG_OFFSET,
                    bitfield_bit32_write(cfg, HMAC_CFG_SHA_EN_BIT, false));
 
@@ -159,10 +160,8 @@ void hmac_sha256_save(hmac_context_t *ctx) {
 
 void hmac_sha256_restore(const hmac_context_t *ctx) {
   // Clear the `sha_en` bit to ensure the message length registers are
-  // writeable. Leave the rest of the configuration unchanged.
-  uint32_t cfg =
-      abs_mmio_read32(TOP_EARLGREY_HMAC_BASE_ADDR + HMAC_CFG_REG_OFFSET);
-  cfg = bitfield_bit32_write(cfg, HMAC_CFG_SHA_EN_BIT, false);
+  // writeable. Use the saved configuration for the rest.
+  uint32_t cfg = bitfield_bit32_write(ctx->cfg, HMAC_CFG_SHA_EN_BIT, false);
   abs_mmio_write32(TOP_EARLGREY_HMAC_BASE_ADDR + HMAC_CFG_REG_OFFSET, cfg);
 
   // Write the digest registers. Note that endianness does not matter here,
@@ -34,13 +34,15 @@ typedef struct hmac_digest {
 /**
  * Stored SHA256 operation state.
  *
- * Does not store the configuration of the block, so it is important that
- * configuration parameters such as digest endianness match up when the
- * operation is restarted.
+ * Also stores the configuration of the block when the operation was saved,
+ * so that restoring it does not need to read the configuration back from the
+ * block. Configuration parameters such as digest endianness are restored
+ * along with the state.
  */
 typedef struct hmac_context {
   uint32_t msg_len_upper;
   uint32_t msg_len_lower;
+  uint32_t cfg;
   uint32_t digest[kHmacDigestNumWords];
 } hmac_context_t;
 
@@ -153,9 +155,12 @@ void hmac_sha256_save(hmac_context_t *ctx);
 /**
  * Restore an operation's working state.
  *
- * Issues the `continue` command after restoring the state. Call
- * `hmac_sha256_configure()` to set the HMAC configuration before calling this
- * function.
+ * Issues the `continue` command after restoring the state and the
+ * configuration saved with it. Call `hmac_sha256_configure()` once before
+ * calling this function, to clear the interrupts of the block.
+ *
+ * This is called for every tree node of a SPHINCS+ verification, so it only
+ * writes to the block.
  *
  * @param ctx Saved operation state.
  */
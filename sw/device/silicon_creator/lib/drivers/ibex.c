@@ -5,6 +5,8 @@
 #include "sw/device/silicon_creator/lib/drivers/ibex.h"
 
 #include "sw/device/lib/base/abs_mmio.h"
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/csr.h"
 #include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/runtime/hart.h"
 #include "sw/device/silicon_creator/lib/base/sec_mmio.h"
@@ -62,6 +64,23 @@ void ibex_addr_remap_1_set(uint32_t matching_addr, uint32_t remap_addr,
   icache_invalidate();
 }
 
+void ibex_icache_enable(void) {
+  ibex_icache_invalidate();
+  CSR_SET_BITS(CSR_REG_CPUCTRL, 1 << kIbexCpuctrlIcacheEnableBit);
+}
+
+void ibex_icache_disable(void) {
+  CSR_CLEAR_BITS(CSR_REG_CPUCTRL, 1 << kIbexCpuctrlIcacheEnableBit);
+}
+
+void ibex_icache_invalidate(void) {
+  icache_invalidate();
+  uint32_t cpuctrl;
+  do {
+    CSR_READ(CSR_REG_CPUCTRL, &cpuctrl);
+  } while (!bitfield_bit32_read(cpuctrl, kIbexCpuctrlIcScrKeyValidBit));
+}
+
 uint32_t ibex_addr_remap_get(uint32_t index) {
   HARDENED_CHECK_LT(index, 2);
   index *= sizeof(uint32_t);
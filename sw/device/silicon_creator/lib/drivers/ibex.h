@@ -81,6 +81,51 @@ typedef enum ibex_exception_code {
   kIbexExceptionCodeMax = 31,
 } ibex_exception_code_t;
 
+/**
+ * Bits of the Ibex `cpuctrlsts` CSR that control and report on the instruction
+ * cache.
+ */
+enum {
+  kIbexCpuctrlIcacheEnableBit = 0,
+  kIbexCpuctrlIcScrKeyValidBit = 8,
+};
+
+/**
+ * Instruction cache policy for silicon_creator code.
+ *
+ * The ROM enables or disables the instruction cache from the
+ * `CREATOR_SW_CFG_CPUCTRL` OTP item in `rom_init()`, as early as possible,
+ * and the ROM_EXT keeps that setting. Code that changes what is fetched from
+ * an address (e.g. writing to flash that may later be executed in the same
+ * boot, or reprogramming the address translation windows) must call
+ * `ibex_icache_invalidate()` before executing the new code. The cache is
+ * empty out of reset and the address translation functions below invalidate
+ * it, so the ROM doesn't need to do anything else before jumping to the
+ * ROM_EXT. The ROM_EXT invalidates it before jumping to owner code.
+ */
+
+/**
+ * Enable the instruction cache.
+ *
+ * The cache is invalidated first so that nothing fetched before it was last
+ * disabled can be hit.
+ */
+void ibex_icache_enable(void);
+
+/**
+ * Disable the instruction cache.
+ */
+void ibex_icache_disable(void);
+
+/**
+ * Invalidate the instruction cache.
+ *
+ * This also makes the cache request a new scrambling key. It waits until the
+ * key is valid, after which the invalidation is under way and any further
+ * invalidation request will be honoured.
+ */
+void ibex_icache_invalidate(void);
+
 /**
  * The following constants represent the expected number of sec_mmio register
  * writes performed by functions in provided in this module. See
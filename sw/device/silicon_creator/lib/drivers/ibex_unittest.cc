@@ -8,6 +8,7 @@
 
 #include "gtest/gtest.h"
 #include "sw/device/lib/base/mock_abs_mmio.h"
+#include "sw/device/silicon_creator/lib/base/mock_csr.h"
 #include "sw/device/silicon_creator/lib/base/mock_sec_mmio.h"
 #include "sw/device/silicon_creator/testing/rom_test.h"
 
@@ -64,5 +65,31 @@ TEST_F(AddressTranslationTest, Slot1Sucess) {
 
   ibex_addr_remap_1_set(matching_addr, remap_addr, size);
 }
+
+class IcacheTest : public rom_test::RomTest {
+ protected:
+  mock_csr::MockCsr csr_;
+};
+
+TEST_F(IcacheTest, InvalidateWaitsForKey) {
+  EXPECT_CSR_READ(CSR_REG_CPUCTRL, 0x1);
+  EXPECT_CSR_READ(CSR_REG_CPUCTRL, 0x1);
+  EXPECT_CSR_READ(CSR_REG_CPUCTRL, 0x101);
+
+  ibex_icache_invalidate();
+}
+
+TEST_F(IcacheTest, Enable) {
+  EXPECT_CSR_READ(CSR_REG_CPUCTRL, 0x100);
+  EXPECT_CSR_SET_BITS(CSR_REG_CPUCTRL, 0x1);
+
+  ibex_icache_enable();
+}
+
+TEST_F(IcacheTest, Disable) {
+  EXPECT_CSR_CLEAR_BITS(CSR_REG_CPUCTRL, 0x1);
+
+  ibex_icache_disable();
+}
 }  // namespace
 }  // namespace ibex_unittest
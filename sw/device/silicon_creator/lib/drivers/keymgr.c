@@ -158,18 +158,7 @@ static rom_error_t keymgr_is_idle(void) {
   return kErrorKeymgrInternal;
 }
 
-/**
- * Wait for the key manager to finish an operation.
- *
- * Polls the key manager until it is no longer busy. If the operation completed
- * successfully or the key manager was already idle, returns kErrorOk. If
- * there was an error during the operation, reads and clears the error code
- * and returns kErrorKeymgrInternal.
- *
- * @return OK or error.
- */
-OT_WARN_UNUSED_RESULT
-static rom_error_t keymgr_wait_until_done(void) {
+rom_error_t sc_keymgr_wait_until_done(void) {
   // Poll the OP_STATUS register until it is something other than "WIP".
   uint32_t reg;
   uint32_t status;
@@ -203,7 +192,7 @@ static rom_error_t keymgr_wait_until_done(void) {
   return kErrorKeymgrInternal;
 }
 
-rom_error_t sc_keymgr_generate_key(
+rom_error_t sc_keymgr_generate_key_start(
     sc_keymgr_dest_t destination, sc_keymgr_key_type_t key_type,
     sc_keymgr_diversification_t diversification) {
   HARDENED_RETURN_IF_ERROR(keymgr_is_idle());
@@ -239,9 +228,17 @@ rom_error_t sc_keymgr_generate_key(
 
   // Issue the start command.
   abs_mmio_write32(kBase + KEYMGR_START_REG_OFFSET, 1 << KEYMGR_START_EN_BIT);
+  return kErrorOk;
+}
+
+rom_error_t sc_keymgr_generate_key(
+    sc_keymgr_dest_t destination, sc_keymgr_key_type_t key_type,
+    sc_keymgr_diversification_t diversification) {
+  HARDENED_RETURN_IF_ERROR(
+      sc_keymgr_generate_key_start(destination, key_type, diversification));
 
   // Block until keymgr is done.
-  return keymgr_wait_until_done();
+  return sc_keymgr_wait_until_done();
 }
 
 rom_error_t sc_keymgr_sideload_clear(sc_keymgr_dest_t destination) {
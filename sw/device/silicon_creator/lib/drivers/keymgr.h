@@ -248,6 +248,37 @@ rom_error_t sc_keymgr_generate_key(sc_keymgr_dest_t destination,
                                    sc_keymgr_key_type_t key_type,
                                    sc_keymgr_diversification_t diversification);
 
+/**
+ * Start generating a key manager key and sideloading it to the requested block.
+ *
+ * Same as `sc_keymgr_generate_key()`, but returns as soon as the operation is
+ * started so that the caller can do other work in the meantime. The caller
+ * must call `sc_keymgr_wait_until_done()` before using the key or starting
+ * another key manager operation.
+ *
+ * @param destination: Hardware destination for key material.
+ * @param key_type Key type: attestation or sealing.
+ * @param diversification Diversification input for the key derivation.
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sc_keymgr_generate_key_start(
+    sc_keymgr_dest_t destination, sc_keymgr_key_type_t key_type,
+    sc_keymgr_diversification_t diversification);
+
+/**
+ * Wait for the key manager to finish an operation.
+ *
+ * Polls the key manager until it is no longer busy. If the operation completed
+ * successfully or the key manager was already idle, returns kErrorOk. If
+ * there was an error during the operation, reads and clears the error code
+ * and returns kErrorKeymgrInternal.
+ *
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sc_keymgr_wait_until_done(void);
+
 /**
  * Clear the requested sideloaded key slot.
  *
@@ -308,23 +308,44 @@ void kmac_shake256_absorb(const uint8_t *in, size_t inlen) {
   // see the KMAC documentation:
   //   https://docs.opentitan.org/hw/ip/kmac/doc/#fifo-depth-and-empty-status
 
-  // Use byte-wide writes until the input pointer is aligned.
-  // Note: writes to the KMAC message FIFO are not required to be aligned.
+  // Collect the bytes up to the first aligned word of the input.
+  uint32_t carry = 0;
+  size_t carry_bits = 0;
   for (; inlen > 0 && misalignment32_of((uintptr_t)in); --inlen, ++in) {
-    abs_mmio_write8(kBase + KMAC_MSG_FIFO_REG_OFFSET, *in);
+    carry |= (uint32_t)*in << carry_bits;
+    carry_bits += 8;
   }
 
-  // Use word writes for all full words.
+  // Use word writes for all full words. If the input was not aligned, the top
+  // bytes of each aligned word are carried over to the next one.
   for (; inlen >= sizeof(uint32_t);
        inlen -= sizeof(uint32_t), in += sizeof(uint32_t)) {
-    abs_mmio_write32(kBase + KMAC_MSG_FIFO_REG_OFFSET, read_32(in));
+    uint32_t word = read_32(in);
+    if (carry_bits > 0) {
+      uint32_t shifted = carry | (word << carry_bits);
+      carry = word >> (32 - carry_bits);
+      word = shifted;
+    }
+    abs_mmio_write32(kBase + KMAC_MSG_FIFO_REG_OFFSET, word);
   }
 
-  // Use byte-wide writes for anything left over.
+  // Add anything left over to the carried word, writing it if it fills up.
   for (; inlen > 0; --inlen, ++in) {
-    abs_mmio_write8(kBase + KMAC_MSG_FIFO_REG_OFFSET, *in);
+    carry |= (uint32_t)*in << carry_bits;
+    carry_bits += 8;
+    if (carry_bits == 32) {
+      abs_mmio_write32(kBase + KMAC_MSG_FIFO_REG_OFFSET, carry);
+      carry = 0;
+      carry_bits = 0;
+    }
   }
   HARDENED_CHECK_EQ(inlen, 0);
+
+  // Use byte-wide writes for what is left of the carried word.
+  // Note: writes to the KMAC message FIFO are not required to be aligned.
+  for (; carry_bits > 0; carry_bits -= 8, carry >>= 8) {
+    abs_mmio_write8(kBase + KMAC_MSG_FIFO_REG_OFFSET, (uint8_t)carry);
+  }
 }
 
 void kmac_shake256_absorb_words(const uint32_t *in, size_t inlen) {
@@ -338,6 +359,14 @@ void kmac_shake256_absorb_words(const uint32_t *in, size_t inlen) {
   // see the KMAC documentation:
   //   https://docs.opentitan.org/hw/ip/kmac/doc/#fifo-depth-and-empty-status
 
+  // Unroll the writes by four words, which covers the inputs of SPHINCS+
+  // with no remainder.
+  for (; inlen >= 4; inlen -= 4, in += 4) {
+    abs_mmio_write32(kBase + KMAC_MSG_FIFO_REG_OFFSET, in[0]);
+    abs_mmio_write32(kBase + KMAC_MSG_FIFO_REG_OFFSET, in[1]);
+    abs_mmio_write32(kBase + KMAC_MSG_FIFO_REG_OFFSET, in[2]);
+    abs_mmio_write32(kBase + KMAC_MSG_FIFO_REG_OFFSET, in[3]);
+  }
   for (; inlen > 0; --inlen, ++in) {
     abs_mmio_write32(kBase + KMAC_MSG_FIFO_REG_OFFSET, *in);
   }
@@ -351,7 +380,7 @@ void kmac_shake256_squeeze_start(void) {
 
 rom_error_t kmac_shake256_squeeze_end(uint32_t *out, size_t outlen) {
   size_t idx = 0;
-  while (launder32(idx) < outlen) {
+  do {
     // Since we always read in increments of the SHAKE-256 rate, the index at
     // start should always be a multiple of the rate.
     HARDENED_CHECK_EQ(idx % kShake256KeccakRateWords, 0);
@@ -372,19 +401,18 @@ rom_error_t kmac_shake256_squeeze_end(uint32_t *out, size_t outlen) {
       ++idx;
     }
 
-    if (offset == kShake256KeccakRateWords) {
-      // If we read all the remaining words, issue `CMD.RUN` to generate more
-      // state.
+    if (offset == kShake256KeccakRateWords && idx < outlen) {
+      // If we read all the remaining words and still need more output, issue
+      // `CMD.RUN` to generate more state.
       HARDENED_CHECK_EQ(offset, kShake256KeccakRateWords);
       issue_command(KMAC_CMD_CMD_VALUE_RUN);
     }
-  }
+  } while (launder32(idx) < outlen);
   HARDENED_CHECK_EQ(idx, outlen);
 
-  // Poll the status register until in the 'squeeze' state.
-  HARDENED_RETURN_IF_ERROR(poll_state(KMAC_STATUS_SHA3_SQUEEZE_BIT));
-
-  // Issue `CMD.DONE` to finish the operation.
+  // `CMD.RUN` is only issued when more output is needed, so KMAC is still in
+  // the 'squeeze' state polled above. Issue `CMD.DONE` to finish the
+  // operation.
   issue_command(KMAC_CMD_CMD_VALUE_DONE);
 
   return kErrorOk;
@@ -84,8 +84,9 @@ rom_error_t kmac_shake256_start(void);
  *
  * Blocks until the all input is written.
  *
- * For best performance, `in` should be 32b-aligned, although this function
- * does handle unaligned buffers.
+ * `in` does not need to be 32b-aligned: bytes of an unaligned buffer are
+ * shifted into full words, and only the last `inlen % 4` bytes are written
+ * one byte at a time.
  *
  * @param in Input buffer
  * @param inlen Length of input (bytes)
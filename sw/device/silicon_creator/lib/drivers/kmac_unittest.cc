@@ -5,6 +5,7 @@
 #include "sw/device/silicon_creator/lib/drivers/kmac.h"
 
 #include <array>
+#include <cstring>
 
 #include "gtest/gtest.h"
 #include "sw/device/lib/base/mock_abs_mmio.h"
@@ -169,7 +170,17 @@ TEST_F(StartTest, ErrorAfterStart) {
   EXPECT_EQ(kmac_shake256_start(), kErrorKmacInvalidStatus);
 }
 
-class AbsorbTest : public KmacTest {};
+class AbsorbTest : public KmacTest {
+ protected:
+  /**
+   * Reads the four (possibly unaligned) bytes at `bytes` as a word.
+   */
+  static uint32_t WordAt(const unsigned char *bytes) {
+    uint32_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+  }
+};
 
 TEST_F(AbsorbTest, Success) {
   // Test assumption.
@@ -226,12 +237,13 @@ TEST_F(AbsorbTest, UnalignedStart) {
   unsigned char *test_data = (unsigned char *)data_aligned.data() + 1;
   size_t test_data_len = data_aligned.size() * sizeof(uint32_t) - 1;
 
-  // First (unaligned) bytes should use byte-wide writes.
-  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET, test_data[0]);
-  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET, test_data[1]);
-  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET, test_data[2]);
-  // Next (aligned) word of input should use a word-wide write.
-  EXPECT_ABS_WRITE32(base_ + KMAC_MSG_FIFO_REG_OFFSET, data_aligned[1]);
+  // First (unaligned) bytes should be shifted together with the next
+  // (aligned) word of input into a word-wide write.
+  EXPECT_ABS_WRITE32(base_ + KMAC_MSG_FIFO_REG_OFFSET, WordAt(&test_data[0]));
+  // The rest of the aligned word should use byte-wide writes.
+  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET, test_data[4]);
+  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET, test_data[5]);
+  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET, test_data[6]);
 
   kmac_shake256_absorb(test_data, test_data_len);
 }
@@ -247,16 +259,10 @@ TEST_F(AbsorbTest, UnalignedStartAndEnd) {
   unsigned char *test_data = (unsigned char *)data_aligned.data() + 2;
   size_t test_data_len = data_aligned.size() * sizeof(uint32_t) - 4;
 
-  // First (unaligned) bytes should use byte-wide writes.
-  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET, test_data[0]);
-  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET, test_data[1]);
-  // Expect next word of input (now aligned) to use a word-wide write.
-  EXPECT_ABS_WRITE32(base_ + KMAC_MSG_FIFO_REG_OFFSET, data_aligned[1]);
-  // Last two bytes should use byte-wide writes.
-  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET,
-                    test_data[test_data_len - 2]);
-  EXPECT_ABS_WRITE8(base_ + KMAC_MSG_FIFO_REG_OFFSET,
-                    test_data[test_data_len - 1]);
+  // The two unaligned bytes at each end add up to a word, so the whole input
+  // should use word-wide writes.
+  EXPECT_ABS_WRITE32(base_ + KMAC_MSG_FIFO_REG_OFFSET, WordAt(&test_data[0]));
+  EXPECT_ABS_WRITE32(base_ + KMAC_MSG_FIFO_REG_OFFSET, WordAt(&test_data[4]));
 
   kmac_shake256_absorb(test_data, test_data_len);
 }
@@ -274,6 +280,19 @@ TEST_F(AbsorbWordsTest, Success) {
   kmac_shake256_absorb_words(test_data.data(), test_data.size());
 }
 
+TEST_F(AbsorbWordsTest, Unrolled) {
+  std::array<uint32_t, 6> test_data = {0x12345678, 0xabcdef01, 0x02030405,
+                                       0x06070809, 0x0a0b0c0d, 0x0e0f1011};
+
+  // Expect all test data to be written to the FIFO in order, both the words
+  // written four at a time and the remainder.
+  for (uint32_t word : test_data) {
+    EXPECT_ABS_WRITE32(base_ + KMAC_MSG_FIFO_REG_OFFSET, word);
+  }
+
+  kmac_shake256_absorb_words(test_data.data(), test_data.size());
+}
+
 TEST_F(AbsorbWordsTest, EmptyInput) {
   // Nothing should happen.
   kmac_shake256_absorb_words(NULL, 0);
@@ -298,7 +317,6 @@ TEST_F(SqueezeTest, Success) {
   }
 
   // End
-  ExpectPollState(KMAC_STATUS_SHA3_SQUEEZE_BIT, /*err=*/false);
   ExpectCmdWrite(KMAC_CMD_CMD_VALUE_DONE);
 
   uint32_t out[test_data.size()];
@@ -344,7 +362,6 @@ TEST_F(SqueezeTest, StartAndEndNonEmpty) {
   }
 
   // End
-  ExpectPollState(KMAC_STATUS_SHA3_SQUEEZE_BIT, /*err=*/false);
   ExpectCmdWrite(KMAC_CMD_CMD_VALUE_DONE);
 
   uint32_t out[test_data.size()];
@@ -400,7 +417,6 @@ TEST_F(SqueezeTest, LongOutput) {
   }
 
   // End
-  ExpectPollState(KMAC_STATUS_SHA3_SQUEEZE_BIT, /*err=*/false);
   ExpectCmdWrite(KMAC_CMD_CMD_VALUE_DONE);
 
   uint32_t out[test_data.size()];
@@ -51,6 +51,11 @@ rom_error_t flash_ctrl_data_erase_verify(uint32_t addr,
   return MockFlashCtrl::Instance().DataEraseVerify(addr, erase_type);
 }
 
+rom_error_t flash_ctrl_data_erase_verify_pages(uint32_t addr,
+                                               uint32_t page_count) {
+  return MockFlashCtrl::Instance().DataEraseVerifyPages(addr, page_count);
+}
+
 rom_error_t flash_ctrl_info_erase(const flash_ctrl_info_page_t *info_page,
                                   flash_ctrl_erase_type_t erase_type) {
   return MockFlashCtrl::Instance().InfoErase(info_page, erase_type);
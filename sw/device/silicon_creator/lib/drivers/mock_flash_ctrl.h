@@ -30,6 +30,7 @@ class MockFlashCtrl : public global_mock::GlobalMock<MockFlashCtrl> {
   MOCK_METHOD(rom_error_t, DataErase, (uint32_t, flash_ctrl_erase_type_t));
   MOCK_METHOD(rom_error_t, DataEraseVerify,
               (uint32_t, flash_ctrl_erase_type_t));
+  MOCK_METHOD(rom_error_t, DataEraseVerifyPages, (uint32_t, uint32_t));
   MOCK_METHOD(rom_error_t, InfoErase,
               (const flash_ctrl_info_page_t *, flash_ctrl_erase_type_t));
   MOCK_METHOD(void, DataDefaultPermsSet, (flash_ctrl_perms_t));
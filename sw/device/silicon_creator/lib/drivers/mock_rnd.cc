@@ -11,5 +11,13 @@ rom_error_t rnd_health_config_check(lifecycle_state_t lc_state) {
 }
 
 uint32_t rnd_uint32(void) { return MockRnd::Instance().Uint32(); }
+
+// Draws every word from `Uint32()`, so that tests don't need to tell the two
+// functions apart.
+void rnd_fill(uint32_t *buf, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    buf[i] = MockRnd::Instance().Uint32();
+  }
+}
 }
 }  // namespace rom_test
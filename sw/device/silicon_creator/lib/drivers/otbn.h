@@ -256,6 +256,27 @@ rom_error_t sc_otbn_dmem_read(size_t num_words, const sc_otbn_addr_t src,
 OT_WARN_UNUSED_RESULT
 rom_error_t sc_otbn_execute(void);
 
+/**
+ * Start the execution of the application loaded into OTBN without waiting for
+ * it to complete.
+ *
+ * Callers must call `sc_otbn_execute_finish()` before accessing OTBN again.
+ *
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sc_otbn_execute_start(void);
+
+/**
+ * Wait for an execution started with `sc_otbn_execute_start()` to complete.
+ *
+ * This function blocks until OTBN is idle.
+ *
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sc_otbn_execute_finish(void);
+
 /**
  * Blocks until OTBN is idle.
  *
@@ -283,6 +304,18 @@ rom_error_t sc_otbn_busy_wait_for_done(void);
 OT_WARN_UNUSED_RESULT
 uint32_t sc_otbn_instruction_count_get(void);
 
+/**
+ * Read OTBN's load checksum register.
+ *
+ * OTBN accumulates a CRC-32 over every bus write to IMEM and DMEM. Reads do not
+ * affect it, so an unchanged value means that nothing was written to OTBN
+ * memories since it was last read.
+ *
+ * @return The value of the load checksum register.
+ */
+OT_WARN_UNUSED_RESULT
+uint32_t sc_otbn_load_checksum_get(void);
+
 /**
  * Wipe IMEM securely.
  *
@@ -129,6 +129,38 @@ TEST_F(ExecuteTest, ExecuteBlockUntilIdle) {
   EXPECT_EQ(sc_otbn_execute(), kErrorOk);
 }
 
+TEST_F(ExecuteTest, ExecuteStartFinish) {
+  // Read twice for hardening.
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+
+  EXPECT_SEC_WRITE32(base_ + OTBN_CTRL_REG_OFFSET, 0x1);
+
+  EXPECT_ABS_WRITE32(base_ + OTBN_INTR_STATE_REG_OFFSET,
+                     {
+                         {OTBN_INTR_COMMON_DONE_BIT, 1},
+                     });
+  EXPECT_ABS_WRITE32(base_ + OTBN_CMD_REG_OFFSET, kScOtbnCmdExecute);
+
+  EXPECT_EQ(sc_otbn_execute_start(), kErrorOk);
+
+  // `sc_otbn_execute_finish()` only polls for completion.
+  EXPECT_ABS_READ32(base_ + OTBN_INTR_STATE_REG_OFFSET, 0);
+  EXPECT_ABS_READ32(base_ + OTBN_INTR_STATE_REG_OFFSET,
+                    {
+                        {OTBN_INTR_COMMON_DONE_BIT, 1},
+                    });
+  EXPECT_ABS_WRITE32(base_ + OTBN_INTR_STATE_REG_OFFSET,
+                     {
+                         {OTBN_INTR_COMMON_DONE_BIT, 1},
+                     });
+  EXPECT_ABS_READ32(base_ + OTBN_ERR_BITS_REG_OFFSET, err_bits_ok_);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+
+  EXPECT_EQ(sc_otbn_execute_finish(), kErrorOk);
+}
+
 class IsBusyTest : public OtbnTest {};
 
 TEST_F(IsBusyTest, Success) {
@@ -131,11 +131,21 @@ uint64_t otp_dai_read64(otp_partition_t partition, uint32_t relative_address) {
 rom_error_t otp_dai_read(otp_partition_t partition, uint32_t relative_address,
                          uint32_t *data, size_t num_words) {
   HARDENED_CHECK_LT(partition, ARRAYSIZE(kOtpPartitions));
+  HARDENED_CHECK_EQ(relative_address & kOtpPartitions[partition].align_mask, 0);
+  uint32_t addr = kOtpPartitions[partition].start_addr + relative_address;
+  const uint32_t cmd =
+      bitfield_bit32_write(0, OTP_CTRL_DIRECT_ACCESS_CMD_RD_BIT, true);
+  // The DAI is idle again once the data of a read is available, so we only
+  // need to wait for any previous operation once before the first read.
+  wait_for_dai_idle();
   size_t i = 0, r = num_words - 1;
-  uint32_t addr = relative_address;
   for (; launder32(i) < num_words && launder32(r) < num_words; ++i, --r) {
-    data[i] = otp_dai_read32(partition, addr);
+    abs_mmio_write32(kBase + OTP_CTRL_DIRECT_ACCESS_ADDRESS_REG_OFFSET, addr);
+    abs_mmio_write32(kBase + OTP_CTRL_DIRECT_ACCESS_CMD_REG_OFFSET, cmd);
     addr += sizeof(uint32_t);
+    wait_for_dai_idle();
+    data[i] =
+        abs_mmio_read32(kBase + OTP_CTRL_DIRECT_ACCESS_RDATA_0_REG_OFFSET);
   }
   HARDENED_CHECK_EQ(i, num_words);
   HARDENED_CHECK_EQ(r, SIZE_MAX);
@@ -150,6 +150,9 @@ uint64_t otp_dai_read64(otp_partition_t partition, uint32_t address);
  *
  * Note: this should only be used to read 32-bit granule OTP regions.
  *
+ * The DAI status is polled once before the first read and once per word after
+ * issuing its read command.
+ *
  * @param partition The OTP partition to read from.
  * @param relative_address The address to read from, relative to the start of
  *                         the OTP partition.
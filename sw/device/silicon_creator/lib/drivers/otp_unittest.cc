@@ -195,8 +195,8 @@ TEST_F(OtpDaiReadTest, Read64WithIdleWait) {
 
 TEST_P(OtpDaiReadTest, ReadLenN32bitWords) {
   size_t num_words_to_read = GetParam();
+  ExpectDaiIdleCheck(true);
   for (size_t i = 0; i < num_words_to_read; ++i) {
-    ExpectDaiIdleCheck(true);
     EXPECT_ABS_WRITE32(
         base_ + OTP_CTRL_DIRECT_ACCESS_ADDRESS_REG_OFFSET,
         OTP_CTRL_PARAM_OWNER_SW_CFG_OFFSET + i * sizeof(uint32_t));
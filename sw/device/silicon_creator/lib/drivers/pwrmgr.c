@@ -31,19 +31,22 @@ void pwrmgr_cdc_sync(uint32_t n) {
       (uint32_t)kClockFreqCpuHz / (uint32_t)kClockFreqAonHz * 5;
 
   // Ensure the bit is clear before requesting another sync.
-  ibex_mcycle_zero();
+  //
+  // The timeouts are measured from a snapshot rather than by zeroing
+  // `mcycle`, which the boot_timing record uses as its time base.
+  uint32_t start = ibex_mcycle32();
   while (abs_mmio_read32(kBase + PWRMGR_CFG_CDC_SYNC_REG_OFFSET)) {
-    if (ibex_mcycle32() > cpu_cycle_timeout) {
+    if (ibex_mcycle32() - start > cpu_cycle_timeout) {
       // If the sync bit isn't clear, we shouldn't set it again.  Abort.
       return;
     }
   }
   // Perform the sync procedure the requested number of times.
   while (n--) {
-    ibex_mcycle_zero();
+    start = ibex_mcycle32();
     abs_mmio_write32(kBase + PWRMGR_CFG_CDC_SYNC_REG_OFFSET, kSyncConfig);
     while (abs_mmio_read32(kBase + PWRMGR_CFG_CDC_SYNC_REG_OFFSET)) {
-      if (ibex_mcycle32() > cpu_cycle_timeout)
+      if (ibex_mcycle32() - start > cpu_cycle_timeout)
         // If the sync bit isn't clear, we shouldn't set it again.  Abort.
         return;
     }
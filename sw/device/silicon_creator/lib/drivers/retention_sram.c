@@ -33,6 +33,18 @@ void retention_sram_init(void) {
   abs_mmio_write32(kBase + SRAM_CTRL_CTRL_REG_OFFSET, reg);
 }
 
+rom_error_t retention_sram_init_wait(void) {
+  uint32_t status;
+  do {
+    status = abs_mmio_read32(kBase + SRAM_CTRL_STATUS_REG_OFFSET);
+    if (bitfield_bit32_read(status, SRAM_CTRL_STATUS_INIT_ERROR_BIT) ||
+        bitfield_bit32_read(status, SRAM_CTRL_STATUS_ESCALATED_BIT)) {
+      return kErrorRetRamInit;
+    }
+  } while (!bitfield_bit32_read(status, SRAM_CTRL_STATUS_INIT_DONE_BIT));
+  return kErrorOk;
+}
+
 void retention_sram_readback_enable(uint32_t en) {
   abs_mmio_write32(kBase + SRAM_CTRL_READBACK_REG_OFFSET, en);
 }
@@ -9,6 +9,7 @@
 
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/silicon_creator/lib/boot_log.h"
+#include "sw/device/silicon_creator/lib/boot_timing.h"
 #include "sw/device/silicon_creator/lib/boot_svc/boot_svc_msg.h"
 #include "sw/device/silicon_creator/lib/error.h"
 
@@ -16,6 +17,26 @@
 extern "C" {
 #endif
 
+/**
+ * OTBN boot-services app residency record.
+ *
+ * ROM fills this in right before jumping to ROM_EXT so that ROM_EXT can reuse
+ * the app that is still resident in OTBN instead of loading it again. See
+ * `otbn_boot_app_handoff_save()` and `otbn_boot_app_resume()`.
+ */
+typedef struct retention_sram_otbn_app {
+  /**
+   * Identifier of the resident app: the load checksum of its image, as
+   * computed at build time.
+   */
+  uint32_t app_id;
+  /**
+   * Value of the OTBN `LOAD_CHECKSUM` register at handoff.
+   */
+  uint32_t load_checksum;
+} retention_sram_otbn_app_t;
+OT_ASSERT_SIZE(retention_sram_otbn_app_t, 8);
+
 /**
  * Retention SRAM silicon creator area.
  */
@@ -50,10 +71,22 @@ typedef struct retention_sram_creator {
    */
   uint32_t reserved[(2044 - (sizeof(uint32_t)          // reset_reason
                              + sizeof(boot_svc_msg_t)  // boot services message
+                             + sizeof(retention_sram_otbn_app_t)  // otbn_app
+                             + sizeof(boot_timing_t)   // boot_timing
                              + sizeof(boot_log_t)      // boot_log
                              + sizeof(rom_error_t)     // last_shutdown_reason
                              )) /
                     sizeof(uint32_t)];
+  /**
+   * OTBN boot-services app residency record.
+   */
+  retention_sram_otbn_app_t otbn_app;
+  /**
+   * Boot timing area.
+   *
+   * This buffer records when the boot stages reached their milestones.
+   */
+  boot_timing_t boot_timing;
   /**
    * Boot log area.
    *
@@ -72,6 +105,8 @@ typedef struct retention_sram_creator {
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, reset_reasons, 0);
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, boot_svc_msg, 4);
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, reserved, 260);
+OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, otbn_app, 1840);
+OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, boot_timing, 1848);
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, boot_log, 1912);
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, last_shutdown_reason, 2040);
 OT_ASSERT_SIZE(boot_svc_msg_t, 256);
@@ -166,15 +201,29 @@ inline retention_sram_t *retention_sram_get(void) {
 void retention_sram_clear(void);
 
 /**
- * Initialize the retention SRAM with pseudo-random data from the LFSR.
+ * Start initializing the retention SRAM with pseudo-random data from the LFSR.
  *
  * This function does not request a new scrambling key. See
  * `retention_sram_scramble()`.
  *
- * @return Result of the operation.
+ * The initialization runs in the background and accesses to the retention
+ * SRAM stall until it completes. See `retention_sram_init_wait()`.
  */
 void retention_sram_init(void);
 
+/**
+ * Wait for the initialization of the retention SRAM to complete.
+ *
+ * `retention_sram_init()` and `retention_sram_scramble()` only start the
+ * initialization, so that the caller can do other work that doesn't touch the
+ * retention SRAM in the meantime and join it here before the first access.
+ *
+ * @return An error if the initialization failed or the controller has
+ * escalated.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t retention_sram_init_wait(void);
+
 /**
  * Enable or disable the readback feature of the retention SRAM.
  *
@@ -190,9 +239,7 @@ void retention_sram_readback_enable(uint32_t en);
  * will then be initialized to undefined values.
  *
  * The scrambling operation takes time and accesses to retention SRAM
- * will stall until it completes.
- *
- * @return An error if a new key cannot be requested.
+ * will stall until it completes. See `retention_sram_init_wait()`.
  */
 void retention_sram_scramble(void);
 
@@ -43,5 +43,42 @@ TEST_F(InitTest, Ok) {
   retention_sram_init();
 }
 
+class InitWaitTest : public RetentionSramTest {};
+
+TEST_F(InitWaitTest, Ok) {
+  EXPECT_ABS_READ32(base_ + SRAM_CTRL_STATUS_REG_OFFSET, 0);
+  EXPECT_ABS_READ32(base_ + SRAM_CTRL_STATUS_REG_OFFSET,
+                    {
+                        {SRAM_CTRL_STATUS_SCR_KEY_VALID_BIT, 1},
+                    });
+  EXPECT_ABS_READ32(base_ + SRAM_CTRL_STATUS_REG_OFFSET,
+                    {
+                        {SRAM_CTRL_STATUS_SCR_KEY_VALID_BIT, 1},
+                        {SRAM_CTRL_STATUS_INIT_DONE_BIT, 1},
+                    });
+
+  EXPECT_EQ(retention_sram_init_wait(), kErrorOk);
+}
+
+TEST_F(InitWaitTest, InitError) {
+  EXPECT_ABS_READ32(base_ + SRAM_CTRL_STATUS_REG_OFFSET, 0);
+  EXPECT_ABS_READ32(base_ + SRAM_CTRL_STATUS_REG_OFFSET,
+                    {
+                        {SRAM_CTRL_STATUS_INIT_ERROR_BIT, 1},
+                    });
+
+  EXPECT_EQ(retention_sram_init_wait(), kErrorRetRamInit);
+}
+
+TEST_F(InitWaitTest, Escalated) {
+  EXPECT_ABS_READ32(base_ + SRAM_CTRL_STATUS_REG_OFFSET,
+                    {
+                        {SRAM_CTRL_STATUS_ESCALATED_BIT, 1},
+                        {SRAM_CTRL_STATUS_INIT_DONE_BIT, 1},
+                    });
+
+  EXPECT_EQ(retention_sram_init_wait(), kErrorRetRamInit);
+}
+
 }  // namespace
 }  // namespace retention_sram_unittest
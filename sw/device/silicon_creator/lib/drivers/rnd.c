@@ -9,7 +9,9 @@
 #include "sw/device/lib/base/crc32.h"
 #include "sw/device/lib/base/csr.h"
 #include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/hardened_memory.h"
 #include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/random_order.h"
 #include "sw/device/silicon_creator/lib/drivers/otp.h"
 
 #include "entropy_src_regs.h"
@@ -107,15 +109,45 @@ rom_error_t rnd_health_config_check(lifecycle_state_t lc_state) {
 }
 
 uint32_t rnd_uint32(void) {
-  if (kBootStage == kBootStageOwner ||
-      otp_read32(OTP_CTRL_PARAM_CREATOR_SW_CFG_RNG_EN_OFFSET) ==
-          kHardenedBoolTrue) {
-    // When bit-0 is clear an EDN request for new data for RND_DATA is
-    // pending.
-    while (!abs_mmio_read32(kBaseIbex + RV_CORE_IBEX_RND_STATUS_REG_OFFSET)) {
+  uint32_t word;
+  rnd_fill(&word, 1);
+  return word;
+}
+
+void rnd_fill(uint32_t *buf, size_t n) {
+  bool wait = kBootStage == kBootStageOwner ||
+              otp_read32(OTP_CTRL_PARAM_CREATOR_SW_CFG_RNG_EN_OFFSET) ==
+                  kHardenedBoolTrue;
+  for (size_t i = 0; i < n; ++i) {
+    if (wait) {
+      // When bit-0 is clear an EDN request for new data for RND_DATA is
+      // pending.
+      while (
+          !abs_mmio_read32(kBaseIbex + RV_CORE_IBEX_RND_STATUS_REG_OFFSET)) {
+      }
     }
+    uint32_t mcycle;
+    CSR_READ(CSR_REG_MCYCLE, &mcycle);
+    buf[i] =
+        mcycle + abs_mmio_read32(kBaseIbex + RV_CORE_IBEX_RND_DATA_REG_OFFSET);
   }
+}
+
+/**
+ * Returns a random word without waiting for fresh entropy.
+ *
+ * This backs the hardened memory functions, which call it for every traversal
+ * order and every shredded word. They only need values that are hard to
+ * predict, so unlike `rnd_uint32()` this does not wait for RND_DATA to be
+ * refilled.
+ */
+static uint32_t rnd_uint32_nowait(void) {
   uint32_t mcycle;
   CSR_READ(CSR_REG_MCYCLE, &mcycle);
   return mcycle + abs_mmio_read32(kBaseIbex + RV_CORE_IBEX_RND_DATA_REG_OFFSET);
 }
+
+// These replace the weak definitions in `sw/device/lib/base`.
+uint32_t random_order_random_word(void) { return rnd_uint32_nowait(); }
+
+uint32_t hardened_memshred_random_word(void) { return rnd_uint32_nowait(); }
@@ -5,6 +5,9 @@
 #ifndef OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_DRIVERS_RND_H_
 #define OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_DRIVERS_RND_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/silicon_creator/lib/drivers/lifecycle.h"
 #include "sw/device/silicon_creator/lib/error.h"
@@ -38,6 +41,17 @@ rom_error_t rnd_health_config_check(lifecycle_state_t lc_state);
 OT_WARN_UNUSED_RESULT
 uint32_t rnd_uint32(void);
 
+/**
+ * Fills a buffer with random words from the RISC-V Ibex core wrapper.
+ *
+ * Each word is produced like a call to `rnd_uint32()`, but the
+ * CREATOR_SW_CFG_RNG_EN OTP value is only read once for the whole buffer.
+ *
+ * @param[out] buf Buffer to fill.
+ * @param n Number of words to write to `buf`.
+ */
+void rnd_fill(uint32_t *buf, size_t n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -59,6 +59,42 @@ TEST_F(RndTest, GetUint32Disabled) {
   EXPECT_EQ(rnd_uint32(), 978465 + 193475837);
 }
 
+TEST_F(RndTest, FillEnabled) {
+  EXPECT_CALL(otp_, read32(OTP_CTRL_PARAM_CREATOR_SW_CFG_RNG_EN_OFFSET))
+      .WillOnce(Return(kHardenedBoolTrue));
+
+  EXPECT_ABS_READ32(base_rv_ + RV_CORE_IBEX_RND_STATUS_REG_OFFSET,
+                    {{RV_CORE_IBEX_RND_STATUS_RND_DATA_VALID_BIT, true}});
+  EXPECT_CSR_READ(CSR_REG_MCYCLE, 100);
+  EXPECT_ABS_READ32(base_rv_ + RV_CORE_IBEX_RND_DATA_REG_OFFSET, 12345);
+  EXPECT_ABS_READ32(base_rv_ + RV_CORE_IBEX_RND_STATUS_REG_OFFSET,
+                    {{RV_CORE_IBEX_RND_STATUS_RND_DATA_VALID_BIT, false}});
+  EXPECT_ABS_READ32(base_rv_ + RV_CORE_IBEX_RND_STATUS_REG_OFFSET,
+                    {{RV_CORE_IBEX_RND_STATUS_RND_DATA_VALID_BIT, true}});
+  EXPECT_CSR_READ(CSR_REG_MCYCLE, 200);
+  EXPECT_ABS_READ32(base_rv_ + RV_CORE_IBEX_RND_DATA_REG_OFFSET, 67890);
+
+  uint32_t buf[2];
+  rnd_fill(buf, 2);
+  EXPECT_EQ(buf[0], 100 + 12345);
+  EXPECT_EQ(buf[1], 200 + 67890);
+}
+
+TEST_F(RndTest, FillDisabled) {
+  EXPECT_CALL(otp_, read32(OTP_CTRL_PARAM_CREATOR_SW_CFG_RNG_EN_OFFSET))
+      .WillOnce(Return(kHardenedBoolFalse));
+
+  EXPECT_CSR_READ(CSR_REG_MCYCLE, 100);
+  EXPECT_ABS_READ32(base_rv_ + RV_CORE_IBEX_RND_DATA_REG_OFFSET, 12345);
+  EXPECT_CSR_READ(CSR_REG_MCYCLE, 200);
+  EXPECT_ABS_READ32(base_rv_ + RV_CORE_IBEX_RND_DATA_REG_OFFSET, 67890);
+
+  uint32_t buf[2];
+  rnd_fill(buf, 2);
+  EXPECT_EQ(buf[0], 100 + 12345);
+  EXPECT_EQ(buf[1], 200 + 67890);
+}
+
 struct RndtLcStateTestCfg {
   lifecycle_state_t lc_state;
   bool expect_error_ok;
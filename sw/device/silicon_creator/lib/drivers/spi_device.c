@@ -466,6 +466,12 @@ typedef struct cmd_info {
    * area if a larger payload is received.
    */
   bool handled_in_sw;
+  /**
+   * Whether the payload is received on all four lanes.
+   *
+   * Single lane (MOSI) is used if false.
+   */
+  bool quad_payload;
 } cmd_info_t;
 
 /**
@@ -488,6 +494,10 @@ static void cmd_info_set(cmd_info_t cmd_info) {
                                  cmd_info.dummy_cycles - 1);
     reg = bitfield_bit32_write(reg, SPI_DEVICE_CMD_INFO_0_DUMMY_EN_0_BIT, true);
   }
+  if (cmd_info.quad_payload) {
+    reg = bitfield_field32_write(reg, SPI_DEVICE_CMD_INFO_0_PAYLOAD_EN_0_FIELD,
+                                 0xf);
+  }
   reg = bitfield_bit32_write(reg, SPI_DEVICE_CMD_INFO_0_UPLOAD_0_BIT,
                              cmd_info.handled_in_sw);
   reg = bitfield_bit32_write(reg, SPI_DEVICE_CMD_INFO_0_BUSY_0_BIT,
@@ -603,6 +613,15 @@ void spi_device_init(void) {
       .dummy_cycles = 0,
       .handled_in_sw = true,
   });
+  // Configure the QUAD_PAGE_PROGRAM command (CMD_INFO_15).
+  cmd_info_set((cmd_info_t){
+      .reg_offset = SPI_DEVICE_CMD_INFO_15_REG_OFFSET,
+      .op_code = kSpiDeviceOpcodeQuadPageProgram,
+      .address = true,
+      .dummy_cycles = 0,
+      .handled_in_sw = true,
+      .quad_payload = true,
+  });
   // Configure the WRITE_ENABLE and WRITE_DISABLE commands.
   reg = bitfield_field32_write(0, SPI_DEVICE_CMD_INFO_WREN_OPCODE_FIELD,
                                kSpiDeviceOpcodeWriteEnable);
@@ -148,6 +148,14 @@ typedef enum spi_device_opcode {
    * programmed with the payload.
    */
   kSpiDeviceOpcodePageProgram = 0x02,
+  /**
+   * QUAD_PAGE_PROGRAM command.
+   *
+   * Same as PAGE_PROGRAM but the payload is received on all four lanes
+   * (1-1-4). This command should be handled in software the same way as
+   * PAGE_PROGRAM.
+   */
+  kSpiDeviceOpcodeQuadPageProgram = 0x32,
   /**
    * RESET command.
    *
@@ -148,6 +148,18 @@ TEST_F(InitTest, Init) {
           {SPI_DEVICE_CMD_INFO_14_VALID_14_BIT, 1},
       });
 
+  EXPECT_ABS_WRITE32(base_ + SPI_DEVICE_CMD_INFO_15_REG_OFFSET,
+                     {
+                         {SPI_DEVICE_CMD_INFO_15_OPCODE_15_OFFSET,
+                          kSpiDeviceOpcodeQuadPageProgram},
+                         {SPI_DEVICE_CMD_INFO_15_ADDR_MODE_15_OFFSET,
+                          SPI_DEVICE_CMD_INFO_0_ADDR_MODE_0_VALUE_ADDR3B},
+                         {SPI_DEVICE_CMD_INFO_15_PAYLOAD_EN_15_OFFSET, 0xf},
+                         {SPI_DEVICE_CMD_INFO_15_UPLOAD_15_BIT, 1},
+                         {SPI_DEVICE_CMD_INFO_15_BUSY_15_BIT, 1},
+                         {SPI_DEVICE_CMD_INFO_15_VALID_15_BIT, 1},
+                     });
+
   EXPECT_ABS_WRITE32(
       base_ + SPI_DEVICE_CMD_INFO_WREN_REG_OFFSET,
       {
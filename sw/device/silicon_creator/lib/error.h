@@ -54,6 +54,7 @@ enum module_ {
   kModuleRescue =          MODULE_CODE('R', 'S'),
   kModuleCert =            MODULE_CODE('C', 'E'),
   kModuleOwnership =       MODULE_CODE('O', 'W'),
+  kModuleNvCounter =       MODULE_CODE('N', 'C'),
   // clang-format on
 };
 
@@ -193,6 +194,7 @@ enum module_ {
   X(kErrorAsn1BufferExhausted,                ERROR_(7, kModuleAsn1, kResourceExhausted)), \
   \
   X(kErrorRetRamBadVersion,           ERROR_(1, kModuleRetRam, kUnknown)), \
+  X(kErrorRetRamInit,                 ERROR_(2, kModuleRetRam, kInternal)), \
   \
   X(kErrorRescueReboot,               ERROR_(0, kModuleRescue, kInternal)), \
   X(kErrorRescueBadMode,              ERROR_(1, kModuleRescue, kInvalidArgument)), \
@@ -216,6 +218,9 @@ enum module_ {
   X(kErrorOwnershipNoOwner,           ERROR_(11, kModuleOwnership, kInternal)), \
   X(kErrorOwnershipKeyNotFound,       ERROR_(12, kModuleOwnership, kNotFound)), \
   \
+  X(kErrorNvCounterFull,              ERROR_(1, kModuleNvCounter, kResourceExhausted)), \
+  X(kErrorNvCounterWriteCheck,        ERROR_(2, kModuleNvCounter, kInternal)), \
+  \
   /* This comment prevent clang from trying to format the macro. */
 
 // clang-format on
@@ -449,13 +449,41 @@ typedef struct manifest_ext_spx_signature {
 // clang-format on
 
 #if defined(OT_PLATFORM_RV32) || defined(MANIFEST_UNIT_TEST_)
+/**
+ * Checks a manifest extension that is present in the extension table.
+ *
+ * Used by `manifest_check()` so that malformed extensions are rejected before
+ * any key or signature work starts. The getters below still perform their own
+ * hardened checks.
+ */
+#define MANIFEST_EXT_CHECK_(index_, type_, name_, id_, _)            \
+  {                                                                  \
+    const manifest_ext_table_entry_t *entry =                        \
+        &manifest->extensions.entries[index_];                       \
+    if (entry->identifier == id_ && entry->offset != 0) {            \
+      if (entry->offset < CHIP_MANIFEST_SIZE ||                      \
+          entry->offset > manifest->length ||                        \
+          manifest->length - entry->offset < sizeof(type_)) {        \
+        return kErrorManifestBadExtension;                           \
+      }                                                              \
+      const manifest_ext_header_t *header =                          \
+          (const manifest_ext_header_t *)((const char *)manifest +   \
+                                          entry->offset);            \
+      if (header->identifier != id_) {                               \
+        return kErrorManifestBadExtension;                           \
+      }                                                              \
+    }                                                                \
+  }
+
 /**
  * Checks the fields of a manifest.
  *
  * This function performs several basic checks to ensure that
  * - Executable region is non-empty, inside the image, located after the
- * manifest, and word aligned, and
- * - Entry point is inside the executable region and word aligned.
+ * manifest, and word aligned,
+ * - Entry point is inside the executable region and word aligned, and
+ * - Known extensions present in the extension table are inside the image and
+ * their headers carry the expected identifier.
  *
  * @param manfiest A manifest.
  * @return Result of the operation.
@@ -495,6 +523,9 @@ inline rom_error_t manifest_check(const manifest_t *manifest) {
     }
   }
 
+  // Known extensions must be in bounds and match their table entry.
+  MANIFEST_EXTENSIONS(MANIFEST_EXT_CHECK_)
+
   return kErrorOk;
 }
 
@@ -127,5 +127,42 @@ TEST_F(ManifestTest, ExtSpxKeyGet) {
   EXPECT_EQ(&result->header, header);
 }
 
+TEST_F(ManifestTest, ExtensionCheck) {
+  char flash[CHIP_ROM_EXT_RESIZABLE_SIZE_MAX];
+  memset(flash, 0, sizeof(flash));
+  size_t ext_offset = CHIP_ROM_EXT_SIZE_MAX;
+
+  manifest_t *manifest = reinterpret_cast<manifest_t *>(&flash[0]);
+  memcpy(manifest, &manifest_, sizeof(manifest_));
+  manifest->length = ext_offset + sizeof(manifest_ext_spx_key_t);
+
+  manifest_ext_table_entry_t *entry = &manifest->extensions.entries[0];
+  entry->identifier = kManifestExtIdSpxKey;
+  entry->offset = ext_offset;
+
+  manifest_ext_header_t *header =
+      reinterpret_cast<manifest_ext_header_t *>(&flash[ext_offset]);
+  header->identifier = kManifestExtIdSpxKey;
+  EXPECT_EQ(manifest_check(manifest), kErrorOk);
+
+  // Header identifier does not match the table entry.
+  header->identifier = kManifestExtIdSpxSignature;
+  EXPECT_EQ(manifest_check(manifest), kErrorManifestBadExtension);
+  header->identifier = kManifestExtIdSpxKey;
+
+  // Offset inside the manifest.
+  entry->offset = sizeof(manifest_t) - sizeof(uint32_t);
+  EXPECT_EQ(manifest_check(manifest), kErrorManifestBadExtension);
+
+  // Extension does not fit in the image.
+  entry->offset = ext_offset;
+  manifest->length = ext_offset + sizeof(manifest_ext_spx_key_t) - 1;
+  EXPECT_EQ(manifest_check(manifest), kErrorManifestBadExtension);
+
+  // Absent extensions are not checked.
+  entry->offset = 0;
+  EXPECT_EQ(manifest_check(manifest), kErrorOk);
+}
+
 }  // namespace
 }  // namespace manifest_unittest
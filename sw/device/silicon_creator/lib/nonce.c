@@ -4,11 +4,11 @@
 
 #include "sw/device/silicon_creator/lib/nonce.h"
 
+#include "sw/device/lib/base/macros.h"
 #include "sw/device/silicon_creator/lib/drivers/rnd.h"
 
 void nonce_new(nonce_t *nonce) {
-  nonce->value[0] = rnd_uint32();
-  nonce->value[1] = rnd_uint32();
+  rnd_fill(nonce->value, ARRAYSIZE(nonce->value));
 }
 
 extern bool nonce_equal(const nonce_t *a, const nonce_t *b);
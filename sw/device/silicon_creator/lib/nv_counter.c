@@ -0,0 +1,108 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/silicon_creator/lib/nv_counter.h"
+
+#include <stdbool.h>
+
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/macros.h"
+
+#include "flash_ctrl_regs.h"  // Generated.
+
+enum {
+  /**
+   * Size of a flash word, in 32-bit words.
+   */
+  kNvCounterWordSize = FLASH_CTRL_PARAM_BYTES_PER_WORD / sizeof(uint32_t),
+};
+static_assert(kNvCounterWordSize == 2, "Flash words must be 64 bits wide.");
+
+/**
+ * Reads the flash word at `index` in a counter.
+ *
+ * @param counter A counter.
+ * @param index Index of the word.
+ * @param[out] word The contents of the word.
+ * @return The result of the operation.
+ */
+static rom_error_t nv_counter_word_read(const nv_counter_t *counter,
+                                        uint32_t index,
+                                        uint32_t word[kNvCounterWordSize]) {
+  return flash_ctrl_info_read(
+      counter->page, counter->offset + index * FLASH_CTRL_PARAM_BYTES_PER_WORD,
+      kNvCounterWordSize, word);
+}
+
+/**
+ * Checks whether the flash word at `index` in a counter is erased.
+ *
+ * A word that can't be read counts as programmed: with ECC enabled, a word
+ * whose programming was interrupted fails to read.
+ *
+ * @param counter A counter.
+ * @param index Index of the word.
+ * @return `kHardenedBoolTrue` if the word reads back as fully erased.
+ */
+static hardened_bool_t nv_counter_word_is_erased(const nv_counter_t *counter,
+                                                 uint32_t index) {
+  uint32_t word[kNvCounterWordSize];
+  rom_error_t error = nv_counter_word_read(counter, index, word);
+  if (launder32(error) == kErrorOk &&
+      launder32(word[0] & word[1]) == kFlashCtrlErasedWord) {
+    HARDENED_CHECK_EQ(error, kErrorOk);
+    return kHardenedBoolTrue;
+  }
+  return kHardenedBoolFalse;
+}
+
+rom_error_t nv_counter_read(const nv_counter_t *counter, uint32_t *value) {
+  // The programmed words form a prefix of the counter, so search for the first
+  // erased word. The words before `lo` are programmed, and the words from `hi`
+  // on are erased.
+  uint32_t lo = 0;
+  uint32_t hi = counter->word_count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (nv_counter_word_is_erased(counter, mid) == kHardenedBoolTrue) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+
+  // Check the boundary that the search found again, so that a single faulty
+  // read during the search can't change the value.
+  if (lo > 0) {
+    HARDENED_CHECK_EQ(nv_counter_word_is_erased(counter, lo - 1),
+                      kHardenedBoolFalse);
+  }
+  if (lo < counter->word_count) {
+    HARDENED_CHECK_EQ(nv_counter_word_is_erased(counter, lo),
+                      kHardenedBoolTrue);
+  }
+  *value = lo;
+  return kErrorOk;
+}
+
+rom_error_t nv_counter_increment(const nv_counter_t *counter, uint32_t *value) {
+  uint32_t index;
+  RETURN_IF_ERROR(nv_counter_read(counter, &index));
+  if (index >= counter->word_count) {
+    return kErrorNvCounterFull;
+  }
+
+  static const uint32_t kProgrammed[kNvCounterWordSize] = {0, 0};
+  RETURN_IF_ERROR(flash_ctrl_info_write(
+      counter->page, counter->offset + index * FLASH_CTRL_PARAM_BYTES_PER_WORD,
+      kNvCounterWordSize, kProgrammed));
+
+  uint32_t word[kNvCounterWordSize];
+  RETURN_IF_ERROR(nv_counter_word_read(counter, index, word));
+  if ((word[0] | word[1]) != 0) {
+    return kErrorNvCounterWriteCheck;
+  }
+  *value = index + 1;
+  return kErrorOk;
+}
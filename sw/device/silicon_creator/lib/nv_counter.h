@@ -0,0 +1,86 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_NV_COUNTER_H_
+#define OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_NV_COUNTER_H_
+
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/silicon_creator/lib/drivers/flash_ctrl.h"
+#include "sw/device/silicon_creator/lib/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A monotonic counter in a flash info page, in unary (thermometer) code.
+ *
+ * The counter is a run of flash words. A word is erased (all ones) until the
+ * counter is incremented past it, when it is programmed to all zeros, so the
+ * value of the counter is the number of programmed words at the start of the
+ * run. Incrementing programs a single flash word and never erases, and reading
+ * the value takes a binary search over the run rather than a scan of all of
+ * it.
+ *
+ * The counter can count up to the number of words in the run, after which it
+ * has to be reset by erasing its page, which is left to the owner of the page.
+ * The caller must also set up the permissions and configuration of the page
+ * before using the counter. The page may have ECC enabled.
+ */
+typedef struct nv_counter {
+  /**
+   * The info page that holds the counter.
+   */
+  const flash_ctrl_info_page_t *page;
+  /**
+   * Offset of the first word of the counter from the start of the page, in
+   * bytes. Must be a multiple of `FLASH_CTRL_PARAM_BYTES_PER_WORD`.
+   */
+  uint32_t offset;
+  /**
+   * Number of flash words in the counter, which is also its maximum value.
+   */
+  uint32_t word_count;
+} nv_counter_t;
+
+/**
+ * Reads the value of a counter.
+ *
+ * A word that is not fully erased counts as programmed, so that an increment
+ * that was interrupted can't make the counter go backwards. This includes a
+ * word that fails to read, as an interrupted program leaves a word with an
+ * invalid ECC on pages that have ECC enabled.
+ *
+ * The words on either side of the boundary that is found are read again
+ * with hardened checks, so a fault in one read can't change the value.
+ *
+ * @param counter A counter.
+ * @param[out] value The value of the counter.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t nv_counter_read(const nv_counter_t *counter, uint32_t *value);
+
+/**
+ * Increments a counter.
+ *
+ * This programs the first erased word of the counter, and reads it back to
+ * check that it was programmed.
+ *
+ * @param counter A counter.
+ * @param[out] value The new value of the counter.
+ * @return The result of the operation, `kErrorNvCounterFull` if the counter is
+ * at its maximum value, or `kErrorNvCounterWriteCheck` if the word did not
+ * read back as programmed.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t nv_counter_increment(const nv_counter_t *counter, uint32_t *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_NV_COUNTER_H_
@@ -0,0 +1,172 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/silicon_creator/lib/nv_counter.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "sw/device/silicon_creator/lib/drivers/mock_flash_ctrl.h"
+#include "sw/device/silicon_creator/testing/rom_test.h"
+
+#include "flash_ctrl_regs.h"  // Generated.
+
+namespace nv_counter_unittest {
+namespace {
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+constexpr uint32_t kWordCount = 16;
+constexpr uint32_t kOffset = 0x40;
+
+class NvCounterTest : public rom_test::RomTest {
+ protected:
+  NvCounterTest() {
+    ON_CALL(flash_ctrl_, InfoRead(&kFlashCtrlInfoPageBootData0, _, 2, _))
+        .WillByDefault(Invoke(this, &NvCounterTest::Read));
+    ON_CALL(flash_ctrl_, InfoWrite(&kFlashCtrlInfoPageBootData0, _, 2, _))
+        .WillByDefault(Invoke(this, &NvCounterTest::Write));
+  }
+
+  /**
+   * Sets the contents of the counter to `value` programmed words, followed
+   * by erased words.
+   */
+  void SetValue(uint32_t value) {
+    for (uint32_t i = 0; i < kWordCount; ++i) {
+      uint32_t fill = i < value ? 0 : kFlashCtrlErasedWord;
+      words_[i] = {fill, fill};
+    }
+  }
+
+  rom_error_t Read(const flash_ctrl_info_page_t *, uint32_t offset,
+                   uint32_t word_count, void *data) {
+    std::array<uint32_t, 2> word = WordAt(offset);
+    ++reads_;
+    if (offset == kOffset + torn_ * FLASH_CTRL_PARAM_BYTES_PER_WORD) {
+      return kErrorFlashCtrlInfoRead;
+    }
+    if (reads_ == glitched_read_) {
+      word = {kFlashCtrlErasedWord, kFlashCtrlErasedWord};
+    }
+    std::memcpy(data, word.data(), word_count * sizeof(uint32_t));
+    return kErrorOk;
+  }
+
+  rom_error_t Write(const flash_ctrl_info_page_t *, uint32_t offset,
+                    uint32_t word_count, const void *data) {
+    std::array<uint32_t, 2> &word = WordAt(offset);
+    std::array<uint32_t, 2> programmed;
+    std::memcpy(programmed.data(), data, word_count * sizeof(uint32_t));
+    // Programming can only clear bits.
+    word[0] &= programmed[0];
+    word[1] &= programmed[1];
+    ++writes_;
+    return kErrorOk;
+  }
+
+  std::array<uint32_t, 2> &WordAt(uint32_t offset) {
+    EXPECT_EQ((offset - kOffset) % FLASH_CTRL_PARAM_BYTES_PER_WORD, 0);
+    uint32_t index = (offset - kOffset) / FLASH_CTRL_PARAM_BYTES_PER_WORD;
+    EXPECT_LT(index, kWordCount);
+    return words_.at(index);
+  }
+
+  nv_counter_t counter_ = {
+      .page = &kFlashCtrlInfoPageBootData0,
+      .offset = kOffset,
+      .word_count = kWordCount,
+  };
+  std::array<std::array<uint32_t, 2>, kWordCount> words_;
+  // Index of a word that fails to read, as an interrupted program leaves it
+  // with ECC enabled.
+  uint32_t torn_ = kWordCount;
+  // Number of the read (counting from 1) that returns an erased word instead
+  // of the real contents.
+  uint32_t glitched_read_ = 0;
+  uint32_t reads_ = 0;
+  uint32_t writes_ = 0;
+  rom_test::NiceMockFlashCtrl flash_ctrl_;
+};
+
+TEST_F(NvCounterTest, ReadAllValues) {
+  for (uint32_t value = 0; value <= kWordCount; ++value) {
+    SetValue(value);
+    reads_ = 0;
+    uint32_t read_value;
+    EXPECT_EQ(nv_counter_read(&counter_, &read_value), kErrorOk);
+    EXPECT_EQ(read_value, value);
+    // Binary search over 16 words, and the check of the boundary.
+    EXPECT_LE(reads_, 7);
+  }
+}
+
+TEST_F(NvCounterTest, PartiallyProgrammedWordCounts) {
+  SetValue(3);
+  words_[3] = {kFlashCtrlErasedWord, 0x0000ffff};
+
+  uint32_t value;
+  EXPECT_EQ(nv_counter_read(&counter_, &value), kErrorOk);
+  EXPECT_EQ(value, 4);
+}
+
+TEST_F(NvCounterTest, Increment) {
+  SetValue(0);
+  for (uint32_t expected = 1; expected <= kWordCount; ++expected) {
+    writes_ = 0;
+    uint32_t value;
+    EXPECT_EQ(nv_counter_increment(&counter_, &value), kErrorOk);
+    EXPECT_EQ(value, expected);
+    EXPECT_EQ(writes_, 1);
+    EXPECT_EQ(nv_counter_read(&counter_, &value), kErrorOk);
+    EXPECT_EQ(value, expected);
+  }
+
+  uint32_t value;
+  EXPECT_EQ(nv_counter_increment(&counter_, &value), kErrorNvCounterFull);
+}
+
+TEST_F(NvCounterTest, IncrementWriteCheck) {
+  SetValue(5);
+  EXPECT_CALL(flash_ctrl_,
+              InfoWrite(&kFlashCtrlInfoPageBootData0,
+                        kOffset + 5 * FLASH_CTRL_PARAM_BYTES_PER_WORD, 2, _))
+      .WillOnce(Return(kErrorOk));
+
+  uint32_t value;
+  EXPECT_EQ(nv_counter_increment(&counter_, &value), kErrorNvCounterWriteCheck);
+}
+
+TEST_F(NvCounterTest, TornWordCountsAsProgrammed) {
+  for (uint32_t value = 0; value < kWordCount; ++value) {
+    SetValue(value);
+    torn_ = value;
+    uint32_t read_value;
+    EXPECT_EQ(nv_counter_read(&counter_, &read_value), kErrorOk);
+    EXPECT_EQ(read_value, value + 1);
+  }
+}
+
+TEST_F(NvCounterTest, IncrementPastTornWord) {
+  SetValue(3);
+  torn_ = 3;
+  uint32_t value;
+  EXPECT_EQ(nv_counter_increment(&counter_, &value), kErrorOk);
+  EXPECT_EQ(value, 5);
+}
+
+class NvCounterDeathTest : public NvCounterTest {};
+
+TEST_F(NvCounterDeathTest, GlitchedRead) {
+  SetValue(12);
+  // The first read of the search is of word 8, which is programmed.
+  glitched_read_ = 1;
+  uint32_t value;
+  EXPECT_DEATH(OT_DISCARD(nv_counter_read(&counter_, &value)), "");
+}
+
+}  // namespace
+}  // namespace nv_counter_unittest
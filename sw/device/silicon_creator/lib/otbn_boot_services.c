@@ -29,6 +29,7 @@ OTBN_DECLARE_SYMBOL_ADDR(boot, x_r);   // ECDSA verification result.
 OTBN_DECLARE_SYMBOL_ADDR(boot, ok);    // ECDSA verification status.
 OTBN_DECLARE_SYMBOL_ADDR(
     boot, attestation_additional_seed);  // Additional seed for ECDSA keygen.
+OTBN_DECLARE_SYMBOL_ADDR(boot, _checksum);  // Expected load checksum.
 
 static const sc_otbn_app_t kOtbnAppBoot = OTBN_APP_T_INIT(boot);
 static const sc_otbn_addr_t kOtbnVarBootMode = OTBN_ADDR_T_INIT(boot, mode);
@@ -41,6 +42,7 @@ static const sc_otbn_addr_t kOtbnVarBootXr = OTBN_ADDR_T_INIT(boot, x_r);
 static const sc_otbn_addr_t kOtbnVarBootOk = OTBN_ADDR_T_INIT(boot, ok);
 static const sc_otbn_addr_t kOtbnVarBootAttestationAdditionalSeed =
     OTBN_ADDR_T_INIT(boot, attestation_additional_seed);
+static const uint32_t kOtbnBootAppChecksum = OTBN_ADDR_T_INIT(boot, _checksum);
 
 enum {
   /*
@@ -111,13 +113,35 @@ static rom_error_t load_attestation_keygen_seed(uint32_t additional_seed_idx,
 
 rom_error_t otbn_boot_app_load(void) { return sc_otbn_load_app(kOtbnAppBoot); }
 
+void otbn_boot_app_handoff_save(retention_sram_otbn_app_t *handoff) {
+  // The app is identified by the CRC32 of its IMEM and DMEM data images that
+  // is computed at build time, so any change to the app changes the id.
+  handoff->app_id = kOtbnBootAppChecksum;
+  handoff->load_checksum = sc_otbn_load_checksum_get();
+}
+
+rom_error_t otbn_boot_app_resume(const retention_sram_otbn_app_t *handoff) {
+  HARDENED_RETURN_IF_ERROR(sc_otbn_busy_wait_for_done());
+  // A matching checksum means that nothing was written to IMEM or DMEM since
+  // the previous stage recorded the handoff, so the app is still intact.
+  uint32_t load_checksum = sc_otbn_load_checksum_get();
+  if (launder32(handoff->app_id) == kOtbnBootAppChecksum &&
+      launder32(handoff->load_checksum) == load_checksum) {
+    HARDENED_CHECK_EQ(handoff->app_id, kOtbnBootAppChecksum);
+    HARDENED_CHECK_EQ(handoff->load_checksum, load_checksum);
+    return kErrorOk;
+  }
+  return otbn_boot_app_load();
+}
+
 rom_error_t otbn_boot_attestation_keygen(
     uint32_t additional_seed_idx, sc_keymgr_key_type_t key_type,
     sc_keymgr_diversification_t diversification,
     ecdsa_p256_public_key_t *public_key) {
-  // Trigger key manager to sideload the attestation key into OTBN.
-  HARDENED_RETURN_IF_ERROR(
-      sc_keymgr_generate_key_otbn(key_type, diversification));
+  // Trigger key manager to sideload the attestation key into OTBN. The key is
+  // only needed once OTBN runs, so prepare DMEM while key manager is busy.
+  HARDENED_RETURN_IF_ERROR(sc_keymgr_generate_key_start(
+      kScKeymgrDestOtbn, key_type, diversification));
 
   // Write the mode.
   uint32_t mode = kOtbnBootModeAttestationKeygen;
@@ -140,7 +164,9 @@ rom_error_t otbn_boot_attestation_keygen(
       ARRAYSIZE(zero_buf), zero_buf,
       kOtbnVarBootAttestationAdditionalSeed + kAttestationSeedBytes));
 
-  // Run the OTBN program (blocks until OTBN is done).
+  // Wait for the sideloaded key and run the OTBN program (blocks until OTBN is
+  // done).
+  HARDENED_RETURN_IF_ERROR(sc_keymgr_wait_until_done());
   HARDENED_RETURN_IF_ERROR(sc_otbn_execute());
   SEC_MMIO_WRITE_INCREMENT(kScOtbnSecMmioExecute);
 
@@ -192,9 +218,10 @@ rom_error_t otbn_boot_cert_ecc_p256_keygen(sc_keymgr_ecc_key_t key,
 rom_error_t otbn_boot_attestation_key_save(
     uint32_t additional_seed_idx, sc_keymgr_key_type_t key_type,
     sc_keymgr_diversification_t diversification) {
-  // Trigger key manager to sideload the attestation key into OTBN.
-  HARDENED_RETURN_IF_ERROR(
-      sc_keymgr_generate_key_otbn(key_type, diversification));
+  // Trigger key manager to sideload the attestation key into OTBN. The key is
+  // only needed once OTBN runs, so prepare DMEM while key manager is busy.
+  HARDENED_RETURN_IF_ERROR(sc_keymgr_generate_key_start(
+      kScKeymgrDestOtbn, key_type, diversification));
 
   // Write the mode.
   uint32_t mode = kOtbnBootModeAttestationKeySave;
@@ -217,7 +244,9 @@ rom_error_t otbn_boot_attestation_key_save(
   HARDENED_RETURN_IF_ERROR(sc_otbn_dmem_write(
       kAttestationSeedWords, seed, kOtbnVarBootAttestationAdditionalSeed));
 
-  // Run the OTBN program (blocks until OTBN is done).
+  // Wait for the sideloaded key and run the OTBN program (blocks until OTBN is
+  // done).
+  HARDENED_RETURN_IF_ERROR(sc_keymgr_wait_until_done());
   HARDENED_RETURN_IF_ERROR(sc_otbn_execute());
   SEC_MMIO_WRITE_INCREMENT(kScOtbnSecMmioExecute);
 
@@ -273,10 +302,9 @@ rom_error_t otbn_boot_attestation_endorse(const hmac_digest_t *digest,
   return kErrorOk;
 }
 
-rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
-                                const ecdsa_p256_signature_t *sig,
-                                const hmac_digest_t *digest,
-                                uint32_t *recovered_r) {
+rom_error_t otbn_boot_sigverify_start(const ecdsa_p256_public_key_t *key,
+                                      const ecdsa_p256_signature_t *sig,
+                                      const hmac_digest_t *digest) {
   // Write the mode.
   uint32_t mode = kOtbnBootModeSigverify;
   HARDENED_RETURN_IF_ERROR(
@@ -299,8 +327,13 @@ rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
                                               sig->s, kOtbnVarBootS));
 
   // Start the OTBN routine.
-  HARDENED_RETURN_IF_ERROR(sc_otbn_execute());
+  HARDENED_RETURN_IF_ERROR(sc_otbn_execute_start());
   SEC_MMIO_WRITE_INCREMENT(kScOtbnSecMmioExecute);
+  return kErrorOk;
+}
+
+rom_error_t otbn_boot_sigverify_finish(uint32_t *recovered_r) {
+  HARDENED_RETURN_IF_ERROR(sc_otbn_execute_finish());
 
   // Check if the signature passed basic checks.
   uint32_t ok;
@@ -319,3 +352,11 @@ rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
   return sc_otbn_dmem_read(kEcdsaP256SignatureComponentWords, kOtbnVarBootXr,
                            recovered_r);
 }
+
+rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
+                                const ecdsa_p256_signature_t *sig,
+                                const hmac_digest_t *digest,
+                                uint32_t *recovered_r) {
+  HARDENED_RETURN_IF_ERROR(otbn_boot_sigverify_start(key, sig, digest));
+  return otbn_boot_sigverify_finish(recovered_r);
+}
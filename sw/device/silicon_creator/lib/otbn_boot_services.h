@@ -11,6 +11,7 @@
 #include "sw/device/silicon_creator/lib/attestation.h"
 #include "sw/device/silicon_creator/lib/drivers/hmac.h"
 #include "sw/device/silicon_creator/lib/drivers/keymgr.h"
+#include "sw/device/silicon_creator/lib/drivers/retention_sram.h"
 #include "sw/device/silicon_creator/lib/sigverify/ecdsa_p256_key.h"
 #include "sw/device/silicon_creator/lib/sigverify/rsa_key.h"
 
@@ -30,6 +31,31 @@ extern "C" {
 OT_WARN_UNUSED_RESULT
 rom_error_t otbn_boot_app_load(void);
 
+/**
+ * Records that the boot-services app is resident in OTBN.
+ *
+ * Must be called after the last OTBN memory access of the current boot stage,
+ * right before handing over to the next stage. See `otbn_boot_app_resume()`.
+ *
+ * @param[out] handoff Residency record to fill in.
+ */
+void otbn_boot_app_handoff_save(retention_sram_otbn_app_t *handoff);
+
+/**
+ * Makes sure that the boot-services app is loaded, reusing the resident copy
+ * if possible.
+ *
+ * The resident copy is reused only if `handoff` was recorded for the same app
+ * and OTBN's load checksum has not changed since then, i.e. nothing has
+ * written to OTBN memories in between. Otherwise, the app is loaded with
+ * `otbn_boot_app_load()`.
+ *
+ * @param handoff Residency record left by the previous boot stage.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_app_resume(const retention_sram_otbn_app_t *handoff);
+
 /**
  * Generate an attestation public key from a keymgr-derived secret.
  *
@@ -200,6 +226,37 @@ rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
                                 const hmac_digest_t *digest,
                                 uint32_t *recovered_r);
 
+/**
+ * Starts an ECDSA-P256 signature verification on OTBN without waiting for it.
+ *
+ * This allows Ibex to do other work, e.g. SPHINCS+ verification, while OTBN is
+ * busy. Callers must call `otbn_boot_sigverify_finish()` to retrieve the
+ * result before using OTBN again.
+ *
+ * Expects the OTBN boot-services program to already be loaded; see
+ * `otbn_boot_app_load`.
+ *
+ * @param key An ECDSA-P256 public key.
+ * @param sig An ECDSA-P256 signature.
+ * @param digest Message digest to check against.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_sigverify_start(const ecdsa_p256_public_key_t *key,
+                                      const ecdsa_p256_signature_t *sig,
+                                      const hmac_digest_t *digest);
+
+/**
+ * Waits for a verification started with `otbn_boot_sigverify_start()`.
+ *
+ * See `otbn_boot_sigverify()` for the meaning of `recovered_r`.
+ *
+ * @param[out] recovered_r Buffer for the recovered `r` value.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_sigverify_finish(uint32_t *recovered_r);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
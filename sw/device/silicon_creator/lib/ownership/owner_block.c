@@ -19,6 +19,26 @@ enum {
   kFlashBankSize = FLASH_CTRL_PARAM_REG_PAGES_PER_BANK,
 };
 
+/**
+ * Adds a key to the keyring and inserts its ID into the sorted ID table.
+ *
+ * @param keyring The keyring.
+ * @param key The key to add.
+ */
+static void owner_keyring_add(owner_application_keyring_t *keyring,
+                              const owner_application_key_t *key) {
+  size_t n = keyring->length++;
+  keyring->key[n] = key;
+  uint32_t id = key->data.id;
+  size_t i = n;
+  for (; i > 0 && keyring->sorted_id[i - 1] > id; --i) {
+    keyring->sorted_id[i] = keyring->sorted_id[i - 1];
+    keyring->sorted_index[i] = keyring->sorted_index[i - 1];
+  }
+  keyring->sorted_id[i] = id;
+  keyring->sorted_index[i] = (uint8_t)n;
+}
+
 rom_error_t owner_block_parse(const owner_block_t *block,
                               owner_config_t *config,
                               owner_application_keyring_t *keyring) {
@@ -51,8 +71,7 @@ rom_error_t owner_block_parse(const owner_block_t *block,
       case kTlvTagApplicationKey:
         HARDENED_CHECK_EQ(tag, kTlvTagApplicationKey);
         if (keyring->length < ARRAYSIZE(keyring->key)) {
-          keyring->key[keyring->length++] =
-              (const owner_application_key_t *)item;
+          owner_keyring_add(keyring, (const owner_application_key_t *)item);
         }
         break;
       case kTlvTagFlashConfig:
@@ -182,10 +201,26 @@ rom_error_t owner_block_info_apply(const owner_flash_info_config_t *info) {
 rom_error_t owner_keyring_find_key(const owner_application_keyring_t *keyring,
                                    uint32_t key_alg, uint32_t key_id,
                                    size_t *index) {
-  for (size_t i = 0; i < keyring->length; ++i) {
-    if (keyring->key[i]->key_alg == key_alg &&
-        keyring->key[i]->data.id == key_id) {
-      *index = i;
+  // Find the first entry of `sorted_id` that is not less than `key_id`. The
+  // number of iterations only depends on the number of keys.
+  size_t lo = 0;
+  size_t n = keyring->length;
+  while (n > 1) {
+    size_t half = n / 2;
+    lo += keyring->sorted_id[lo + half - 1] < key_id ? half : 0;
+    n -= half;
+  }
+  lo += n == 1 && keyring->sorted_id[lo] < key_id;
+
+  for (size_t i = lo; i < keyring->length && keyring->sorted_id[i] == key_id;
+       ++i) {
+    size_t k = keyring->sorted_index[i];
+    const owner_application_key_t *key = keyring->key[k];
+    if (launder32(key->key_alg) == key_alg &&
+        launder32(key->data.id) == key_id) {
+      HARDENED_CHECK_EQ(key->key_alg, key_alg);
+      HARDENED_CHECK_EQ(key->data.id, key_id);
+      *index = k;
       return kErrorOk;
     }
   }
@@ -36,6 +36,15 @@ typedef struct owner_application_keyring {
   size_t length;
   /** Pointers to the application keys. */
   const owner_application_key_t *key[16];
+  /**
+   * Key IDs of the application keys in ascending order.
+   *
+   * Keys with the same ID keep the order in which they appear in the owner
+   * block.
+   */
+  uint32_t sorted_id[16];
+  /** Index into `key` of the key with the corresponding `sorted_id`. */
+  uint8_t sorted_index[16];
 } owner_application_keyring_t;
 
 /**
@@ -71,6 +80,17 @@ rom_error_t owner_block_flash_apply(const owner_flash_config_t *flash,
  */
 rom_error_t owner_block_info_apply(const owner_flash_info_config_t *info);
 
+/**
+ * Find an application key in the keyring.
+ *
+ * Uses the sorted key ID table built by `owner_block_parse()`.
+ *
+ * @param keyring A keyring filled in by `owner_block_parse()`.
+ * @param key_alg The algorithm of the key.
+ * @param key_id The ID of the key.
+ * @param[out] index The index of the first matching key in `keyring->key`.
+ * @return error code.
+ */
 rom_error_t owner_keyring_find_key(const owner_application_keyring_t *keyring,
                                    uint32_t key_alg, uint32_t key_id,
                                    size_t *index);
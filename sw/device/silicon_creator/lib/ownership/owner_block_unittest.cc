@@ -5,6 +5,7 @@
 #include "sw/device/silicon_creator/lib/ownership/owner_block.h"
 
 #include <stdint.h>
+#include <utility>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -347,6 +348,66 @@ TEST_F(OwnerBlockTest, ParseBlock) {
   EXPECT_EQ(keyring.key[0]->header.tag, kTlvTagApplicationKey);
 }
 
+TEST_F(OwnerBlockTest, KeyringFindKey) {
+  BinaryBlob<owner_block_t> block(basic_owner, sizeof(basic_owner));
+  // Append application keys after the RESQ config, out of order and with a
+  // duplicate ID.
+  uint32_t len =
+      block.Find(kTlvTagRescueConfig).Seek(sizeof(uint32_t)).Read<uint32_t>() -
+      sizeof(tlv_header_t);
+  block.Seek(len);
+  const std::pair<uint32_t, uint32_t> keys[] = {
+      {kOwnershipKeyAlgEcdsaP256, 0x30},
+      {kOwnershipKeyAlgEcdsaP256, 0x10},
+      {kOwnershipKeyAlgSpx, 0x20},
+      {kOwnershipKeyAlgSpx, 0x10},
+  };
+  for (const auto &key : keys) {
+    block.Write(kTlvTagApplicationKey).Write(uint32_t{64}).Write(key.first);
+    block.Seek(offsetof(owner_application_key_t, data) -
+               offsetof(owner_application_key_t, key_domain));
+    block.Write(key.second).Seek(64 - offsetof(owner_application_key_t, data) -
+                                 sizeof(uint32_t));
+  }
+  owner_config_t config;
+  owner_application_keyring_t keyring{};
+  rom_error_t error = owner_block_parse(block.get(), &config, &keyring);
+  EXPECT_EQ(error, kErrorOk);
+  ASSERT_EQ(keyring.length, 5);
+
+  size_t index = 0;
+  EXPECT_EQ(owner_keyring_find_key(&keyring, keyring.key[0]->key_alg,
+                                   keyring.key[0]->data.id, &index),
+            kErrorOk);
+  EXPECT_EQ(index, 0);
+  EXPECT_EQ(owner_keyring_find_key(&keyring, kOwnershipKeyAlgEcdsaP256, 0x30,
+                                   &index),
+            kErrorOk);
+  EXPECT_EQ(index, 1);
+  EXPECT_EQ(owner_keyring_find_key(&keyring, kOwnershipKeyAlgEcdsaP256, 0x10,
+                                   &index),
+            kErrorOk);
+  EXPECT_EQ(index, 2);
+  EXPECT_EQ(
+      owner_keyring_find_key(&keyring, kOwnershipKeyAlgSpx, 0x20, &index),
+      kErrorOk);
+  EXPECT_EQ(index, 3);
+  EXPECT_EQ(
+      owner_keyring_find_key(&keyring, kOwnershipKeyAlgSpx, 0x10, &index),
+      kErrorOk);
+  EXPECT_EQ(index, 4);
+
+  EXPECT_EQ(
+      owner_keyring_find_key(&keyring, kOwnershipKeyAlgSpx, 0x30, &index),
+      kErrorOwnershipKeyNotFound);
+  EXPECT_EQ(owner_keyring_find_key(&keyring, kOwnershipKeyAlgEcdsaP256, 0x40,
+                                   &index),
+            kErrorOwnershipKeyNotFound);
+  EXPECT_EQ(
+      owner_keyring_find_key(&keyring, kOwnershipKeyAlgRsa, 0x10, &index),
+      kErrorOwnershipKeyNotFound);
+}
+
 TEST_F(OwnerBlockTest, ParseBlockBadHeader) {
   BinaryBlob<owner_block_t> block(basic_owner, sizeof(basic_owner));
   // Rewrite the header length to a bad value
@@ -71,6 +71,31 @@ static uint32_t shift_left(sigverify_rsa_buffer_t *a) {
   return msb;
 }
 
+/**
+ * Computes one word of the inner loop of `mont_mul()`.
+ *
+ * Each call adds `x_i * y_j + r_j` to `acc0` and `u_i * n_j` to `acc1`
+ * together with the carries of the previous word. The 32x32-bit products map
+ * to a `mul`/`mulhu` pair on Ibex.
+ *
+ * @param x_i Current digit of `x`.
+ * @param u_i Montgomery quotient digit for `x_i`.
+ * @param y_j j^th digit of `y`.
+ * @param n_j j^th digit of the modulus.
+ * @param r_j j^th digit of the intermediate result.
+ * @param[in,out] acc0 Sum of the first two addends and its carry.
+ * @param[in,out] acc1 Sum of all three addends and its carry.
+ * @return Word to store at index `j - 1` of the intermediate result.
+ */
+OT_WARN_UNUSED_RESULT
+static inline uint32_t mont_mul_word(uint32_t x_i, uint32_t u_i, uint32_t y_j,
+                                     uint32_t n_j, uint32_t r_j,
+                                     uint64_t *acc0, uint64_t *acc1) {
+  *acc0 = (uint64_t)x_i * y_j + r_j + (*acc0 >> 32);
+  *acc1 = (uint64_t)u_i * n_j + (uint32_t)*acc0 + (*acc1 >> 32);
+  return (uint32_t)*acc1;
+}
+
 /**
  * Computes the Montgomery reduction of the product of two integers.
  *
@@ -80,7 +105,9 @@ static uint32_t shift_left(sigverify_rsa_buffer_t *a) {
  * - n is the modulus of the key, and
  * - R is 2^`kSigVerifyRsaNumBits`, e.g. 2^3072 for RSA-3072.
  *
- * See Handbook of Applied Cryptography, Ch. 14, Alg. 14.36.
+ * See Handbook of Applied Cryptography, Ch. 14, Alg. 14.36. Multiplication and
+ * reduction are interleaved word by word (CIOS) and the inner loop is unrolled
+ * four times.
  *
  * @param key An RSA public key.
  * @param x Buffer that holds `x`, little-endian.
@@ -91,7 +118,10 @@ static void mont_mul(const sigverify_rsa_key_t *key,
                      const sigverify_rsa_buffer_t *x,
                      const sigverify_rsa_buffer_t *y,
                      sigverify_rsa_buffer_t *result) {
-  memset(result->data, 0, sizeof(result->data));
+  const uint32_t *n = key->n.data;
+  const uint32_t *yd = y->data;
+  uint32_t *r = result->data;
+  memset(r, 0, sizeof(result->data));
 
   for (size_t i = 0; i < ARRAYSIZE(x->data); ++i) {
     // The loop below reads one word ahead of writes to avoid a separate loop
@@ -102,21 +132,30 @@ static void mont_mul(const sigverify_rsa_key_t *key,
     // and `acc1`. `acc0` and `acc1` can safely store these intermediate values,
     // i.e. without wrapping, because UINT32_MAX^2 + 2*UINT32_MAX is
     // 0xffff_ffff_ffff_ffff.
+    const uint32_t x_i = x->data[i];
 
     // Holds the sum of the first two addends in step 2.2.
-    uint64_t acc0 = (uint64_t)x->data[i] * y->data[0] + result->data[0];
+    uint64_t acc0 = (uint64_t)x_i * yd[0] + r[0];
     const uint32_t u_i = (uint32_t)acc0 * key->n0_inv[0];
     // Holds the sum of the all three addends in step 2.2.
-    uint64_t acc1 = (uint64_t)u_i * key->n.data[0] + (uint32_t)acc0;
+    uint64_t acc1 = (uint64_t)u_i * n[0] + (uint32_t)acc0;
 
     // Process the i^th digit of `x`, i.e. `x[i]`.
-    for (size_t j = 1; j < ARRAYSIZE(result->data); ++j) {
-      acc0 = (uint64_t)x->data[i] * y->data[j] + result->data[j] + (acc0 >> 32);
-      acc1 = (uint64_t)u_i * key->n.data[j] + (uint32_t)acc0 + (acc1 >> 32);
-      result->data[j - 1] = (uint32_t)acc1;
+    size_t j = 1;
+    for (; j + 4 <= ARRAYSIZE(result->data); j += 4) {
+      r[j - 1] = mont_mul_word(x_i, u_i, yd[j], n[j], r[j], &acc0, &acc1);
+      r[j] = mont_mul_word(x_i, u_i, yd[j + 1], n[j + 1], r[j + 1], &acc0,
+                           &acc1);
+      r[j + 1] = mont_mul_word(x_i, u_i, yd[j + 2], n[j + 2], r[j + 2], &acc0,
+                               &acc1);
+      r[j + 2] = mont_mul_word(x_i, u_i, yd[j + 3], n[j + 3], r[j + 3], &acc0,
+                               &acc1);
+    }
+    for (; j < ARRAYSIZE(result->data); ++j) {
+      r[j - 1] = mont_mul_word(x_i, u_i, yd[j], n[j], r[j], &acc0, &acc1);
     }
     acc0 = (acc0 >> 32) + (acc1 >> 32);
-    result->data[ARRAYSIZE(result->data) - 1] = (uint32_t)acc0;
+    r[ARRAYSIZE(result->data) - 1] = (uint32_t)acc0;
 
     // The intermediate result of this algorithm before the check below is
     // bounded by R + n (Eq. (4) in Montgomery Arithmetic from a Software
@@ -133,14 +172,8 @@ static void mont_mul(const sigverify_rsa_key_t *key,
   }
 }
 
-/**
- * Calculates R^2 mod n, where R = 2^kSigVerifyRsaNumBits.
- *
- * @param key An RSA public key.
- * @param[out] result Buffer to write the result to, little-endian.
- */
-static void calc_r_square(const sigverify_rsa_key_t *key,
-                          sigverify_rsa_buffer_t *result) {
+void sigverify_mod_exp_ibex_calc_rr(const sigverify_rsa_key_t *key,
+                                    sigverify_rsa_buffer_t *result) {
   sigverify_rsa_buffer_t buf;
   memset(buf.data, 0, sizeof(result->data));
   // This subtraction sets buf = -n mod R = R - n, which is equivalent to R
@@ -167,9 +200,10 @@ static void calc_r_square(const sigverify_rsa_key_t *key,
   }
 }
 
-rom_error_t sigverify_mod_exp_ibex(const sigverify_rsa_key_t *key,
-                                   const sigverify_rsa_buffer_t *sig,
-                                   sigverify_rsa_buffer_t *result) {
+rom_error_t sigverify_mod_exp_ibex_rr(const sigverify_rsa_key_t *key,
+                                      const sigverify_rsa_buffer_t *rr,
+                                      const sigverify_rsa_buffer_t *sig,
+                                      sigverify_rsa_buffer_t *result) {
   // Reject the signature if it is too large (n <= sig): RFC 8017, section
   // 5.2.2, step 1.
   if (greater_equal_modulus(key, sig)) {
@@ -178,10 +212,8 @@ rom_error_t sigverify_mod_exp_ibex(const sigverify_rsa_key_t *key,
 
   sigverify_rsa_buffer_t buf;
 
-  // result = R^2 mod n
-  calc_r_square(key, result);
   // buf = sig * R mod n
-  mont_mul(key, sig, result, &buf);
+  mont_mul(key, sig, rr, &buf);
   for (size_t i = 0; i < 8; ++i) {
     // result = sig^{2*4^i} * R mod n (sig's exponent: 2, 8, 32, ..., 32768)
     mont_mul(key, &buf, &buf, result);
@@ -200,3 +232,16 @@ rom_error_t sigverify_mod_exp_ibex(const sigverify_rsa_key_t *key,
 
   return kErrorOk;
 }
+
+rom_error_t sigverify_mod_exp_ibex(const sigverify_rsa_key_t *key,
+                                   const sigverify_rsa_buffer_t *sig,
+                                   sigverify_rsa_buffer_t *result) {
+  // Reject the signature before spending time on R^2 mod n.
+  if (greater_equal_modulus(key, sig)) {
+    return kErrorSigverifyLargeRsaSignature;
+  }
+
+  sigverify_rsa_buffer_t rr;
+  sigverify_mod_exp_ibex_calc_rr(key, &rr);
+  return sigverify_mod_exp_ibex_rr(key, &rr, sig, result);
+}
@@ -35,6 +35,37 @@ rom_error_t sigverify_mod_exp_ibex(const sigverify_rsa_key_t *key,
                                    const sigverify_rsa_buffer_t *sig,
                                    sigverify_rsa_buffer_t *result);
 
+/**
+ * Calculates the Montgomery constant R^2 mod n of an RSA public key.
+ *
+ * R is 2^`kSigVerifyRsaNumBits`. Callers that verify several signatures with
+ * the same key can compute this once and pass it to
+ * `sigverify_mod_exp_ibex_rr()`.
+ *
+ * @param key An RSA public key.
+ * @param[out] rr Buffer to write R^2 mod n to, little-endian.
+ */
+void sigverify_mod_exp_ibex_calc_rr(const sigverify_rsa_key_t *key,
+                                    sigverify_rsa_buffer_t *rr);
+
+/**
+ * Computes the modular exponentiation of an RSA signature on Ibex using a
+ * precomputed R^2 mod n.
+ *
+ * Same as `sigverify_mod_exp_ibex()` but skips the calculation of R^2 mod n.
+ *
+ * @param key An RSA public key.
+ * @param rr R^2 mod n for `key`, little-endian.
+ * @param sig Buffer that holds the signature, little-endian.
+ * @param result Buffer to write the result to, little-endian.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sigverify_mod_exp_ibex_rr(const sigverify_rsa_key_t *key,
+                                      const sigverify_rsa_buffer_t *rr,
+                                      const sigverify_rsa_buffer_t *sig,
+                                      sigverify_rsa_buffer_t *result);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -7,8 +7,9 @@
 #include "sw/device/silicon_creator/lib/drivers/uart.h"
 
 #ifdef STACK_UTILIZATION_CHECK
-void stack_utilization_print(void) {
-  extern uint32_t _stack_start[], _stack_end[];
+extern uint32_t _stack_start[], _stack_end[];
+
+uint32_t stack_utilization_get(void) {
   // We configure a No-Access ePMP NA4 region at stack_start as a
   // stack guard.  We cannot access that word, so start the scan
   // after the stack guard.
@@ -19,7 +20,20 @@ void stack_utilization_print(void) {
     free += sizeof(uint32_t);
     sp++;
   }
-  uint32_t used = total - free;
+  return total - free;
+}
+
+void stack_utilization_reset(void) {
+  uintptr_t sp;
+  asm volatile("mv %0, sp" : "=r"(sp));
+  for (uint32_t *p = _stack_start + 1; (uintptr_t)p < sp; ++p) {
+    *p = STACK_UTILIZATION_FREE_PATTERN;
+  }
+}
+
+void stack_utilization_print(void) {
+  uint32_t used = stack_utilization_get();
+  uint32_t total = (uintptr_t)_stack_end - (uintptr_t)_stack_start;
   //                          : K T S
   const uint32_t kPrefix = 0x3a4b5453;
   uart_write_imm(kPrefix);
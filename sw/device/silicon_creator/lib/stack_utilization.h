@@ -12,15 +12,39 @@
 extern "C" {
 #endif  // __cplusplus
 
+#ifdef STACK_UTILIZATION_CHECK
 /**
  * Examine stack utilization.
  */
-#ifdef STACK_UTILIZATION_CHECK
 void stack_utilization_print(void);
+
+/**
+ * Gets the stack high-water mark.
+ *
+ * Scans the stack from its lowest address for the first word that no longer
+ * holds `STACK_UTILIZATION_FREE_PATTERN`.
+ *
+ * @return Number of stack bytes used since the stack was last filled with the
+ * free pattern.
+ */
+uint32_t stack_utilization_get(void);
+
+/**
+ * Refills the unused part of the stack with the free pattern.
+ *
+ * Everything below the current stack pointer is overwritten, so that a later
+ * `stack_utilization_get()` reports the usage of the code that runs after this
+ * call, e.g. the next boot stage.
+ */
+void stack_utilization_reset(void);
 #else
 #define stack_utilization_print() \
   do {                            \
   } while (0)
+#define stack_utilization_get() ((uint32_t)0)
+#define stack_utilization_reset() \
+  do {                            \
+  } while (0)
 #endif
 
 #ifdef __cplusplus
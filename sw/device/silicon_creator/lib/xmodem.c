@@ -21,7 +21,6 @@ enum {
   kXModemAck = 0x06,
   kXModemNak = 0x15,
   kXModemCancel = 0x18,
-  kXModemPoly = 0x1021,
   kXModemSendRetries = 3,
   kXModemMaxErrors = 2,
   kXModemShortTimeout = 100,
@@ -45,19 +44,26 @@ void xmodem_putchar(void *iohandle, uint8_t ch) {
   xmodem_write(iohandle, &ch, sizeof(ch));
 }
 
+/**
+ * CRC-16 lookup table for the XModem polynomial (0x1021), indexed by nibble.
+ *
+ * A nibble table keeps the ROM_EXT footprint small (32 bytes rather than 512
+ * for a byte table) while replacing the 8 shift-and-xor steps per byte with
+ * two table lookups.
+ */
+static const uint16_t kCrc16Table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+};
+
 /**
  * Calculates a CRC-16 using the XModem polynomial.
  */
 static uint16_t crc16(uint16_t crc, const void *buf, size_t len) {
   const uint8_t *p = (const uint8_t *)buf;
   for (size_t i = 0; i < len; ++i, ++p) {
-    crc ^= *p << 8;
-    for (size_t j = 0; j < 8; ++j) {
-      bool msb = (crc & 0x8000) != 0;
-      crc <<= 1;
-      if (msb)
-        crc ^= kXModemPoly;
-    }
+    crc = (uint16_t)(crc << 4) ^ kCrc16Table[(crc >> 12) ^ (*p >> 4)];
+    crc = (uint16_t)(crc << 4) ^ kCrc16Table[(crc >> 12) ^ (*p & 0xf)];
   }
   return crc;
 }
@@ -372,6 +372,16 @@ static status_t personalize_gen_dice_certificates(ujson_t *uj) {
   TRY(perso_tlv_prepare_cert_for_shipping("UDS", true, all_certs,
                                           curr_cert_size, &perso_blob_to_host));
 
+  // The UDS certificate is the only DICE certificate endorsed by the host.
+  // Send it right away so that the host can endorse it while the CDI keys are
+  // being generated, then start over with an empty blob for the rest of the
+  // objects.
+  // DO NOT CHANGE THE BELOW STRING without modifying the host code in
+  // sw/host/provisioning/ft_lib/src/lib.rs
+  LOG_INFO("Exporting UDS TBS certificate ...");
+  RESP_OK(ujson_serialize_perso_blob_t, uj, &perso_blob_to_host);
+  memset(&perso_blob_to_host, 0, sizeof(perso_blob_to_host));
+
   // Generate CDI_0 keys and cert.
   curr_cert_size = kCdi0MaxCertSizeBytes;
   compute_keymgr_owner_int_binding(&certgen_inputs);
@@ -30,12 +30,43 @@ enum {
 static uint32_t
     flash_info_page_buf[FLASH_CTRL_PARAM_BYTES_PER_PAGE / sizeof(uint32_t)];
 
+/**
+ * Returns true if the OTP value `kv` must not be written by `otp_img_write()`.
+ */
+static bool otp_img_skip(const otp_kv_t *kv) {
+  // We purposely skip the provisioning of the flash data region default
+  // configuration as it must be enabled only after the OTP SECRET1
+  // partition has been provisioned. Since OTP SECRET1 provisioning requires
+  // the HW_CFG0 partition to be provisioned to use the CSRNG SW interface,
+  // there is a delicate order of operations in which this field is
+  // provisioned. Therefore we require explicit provisioning of this field
+  // immediately before the transport image is loaded, after all other
+  // provisioning is complete.
+  //
+  // We also skip the provisioning of the ROM bootstrap disablement
+  // configuration. This should only be disabled after all bootstrap
+  // operations in the personalization flow have been completed.
+  //
+  // Additionally, we skip the provisioning of the AST configuration data, as
+  // this should already be written to a flash info page. We will pull the
+  // data directly from there.
+  return kv->offset ==
+             OTP_CTRL_PARAM_CREATOR_SW_CFG_FLASH_DATA_DEFAULT_CFG_OFFSET ||
+         kv->offset == OTP_CTRL_PARAM_OWNER_SW_CFG_ROM_BOOTSTRAP_DIS_OFFSET ||
+         (kv->offset >= kValidAstCfgOtpAddrLow &&
+          kv->offset < kInvalidAstCfgOtpAddrHigh);
+}
+
 /**
  * Writes OTP values to target OTP `partition`.
  *
  * The `kv` array is preferrably generated using the build infrastructure. See
  * individualize_preop.c and its build target for an example.
  *
+ * All 32-bit values are programmed first, with a single DAI command per word
+ * that needs programming, and then verified together through the software
+ * config window once the whole image is written.
+ *
  * @param otp OTP Controller instance.
  * @param partition Target OTP partition.
  * @param kv OTP Array of OTP key values. See `otp_kv_t` documentation for more
@@ -48,35 +79,16 @@ static status_t otp_img_write(const dif_otp_ctrl_t *otp,
                               dif_otp_ctrl_partition_t partition,
                               const otp_kv_t *kv, size_t len) {
   for (size_t i = 0; i < len; ++i) {
-    // We purposely skip the provisioning of the flash data region default
-    // configuration as it must be enabled only after the OTP SECRET1
-    // partition has been provisioned. Since OTP SECRET1 provisioning requires
-    // the HW_CFG0 partition to be provisioned to use the CSRNG SW interface,
-    // there is a delicate order of operations in which this field is
-    // provisioned. Therefore we require explicit provisioning of this field
-    // immediately before the transport image is loaded, after all other
-    // provisioning is complete.
-    //
-    // We also skip the provisioning of the ROM bootstrap disablement
-    // configuration. This should only be disabled after all bootstrap
-    // operations in the personalization flow have been completed.
-    //
-    // Additionally, we skip the provisioning of the AST configuration data, as
-    // this should already be written to a flash info page. We will pull the
-    // data directly from there.
-    if (kv[i].offset ==
-            OTP_CTRL_PARAM_CREATOR_SW_CFG_FLASH_DATA_DEFAULT_CFG_OFFSET ||
-        kv[i].offset == OTP_CTRL_PARAM_OWNER_SW_CFG_ROM_BOOTSTRAP_DIS_OFFSET ||
-        (kv[i].offset >= kValidAstCfgOtpAddrLow &&
-         kv[i].offset < kInvalidAstCfgOtpAddrHigh)) {
+    if (otp_img_skip(&kv[i])) {
       continue;
     }
     uint32_t offset;
     TRY(dif_otp_ctrl_relative_address(partition, kv[i].offset, &offset));
     switch (kv[i].type) {
       case kOptValTypeUint32Buff:
-        TRY(otp_ctrl_testutils_dai_write32(otp, partition, offset,
-                                           kv[i].value32, kv[i].num_values));
+        TRY(otp_ctrl_testutils_sw_cfg_program32(otp, partition, offset,
+                                                kv[i].value32,
+                                                kv[i].num_values));
         break;
       case kOptValTypeUint64Buff:
         TRY(otp_ctrl_testutils_dai_write64(otp, partition, offset,
@@ -88,6 +100,17 @@ static status_t otp_img_write(const dif_otp_ctrl_t *otp,
         return INTERNAL();
     }
   }
+
+  // 64-bit values were already verified as they were written.
+  for (size_t i = 0; i < len; ++i) {
+    if (otp_img_skip(&kv[i]) || kv[i].type != kOptValTypeUint32Buff) {
+      continue;
+    }
+    uint32_t offset;
+    TRY(dif_otp_ctrl_relative_address(partition, kv[i].offset, &offset));
+    TRY(otp_ctrl_testutils_sw_cfg_check32(otp, partition, offset, kv[i].value32,
+                                          kv[i].num_values));
+  }
   return OK_STATUS();
 }
 
@@ -157,23 +180,25 @@ static status_t manuf_individualize_device_ast_cfg(
   // Write AST configuration data to OTP.
   size_t ast_cfg_offset =
       kFlashInfoFieldAstCalibrationData.byte_offset / sizeof(uint32_t);
-  for (size_t i = 0; i < kFlashInfoAstCalibrationDataSizeIn32BitWords; ++i) {
-    uint32_t addr =
-        OTP_CTRL_PARAM_CREATOR_SW_CFG_AST_CFG_OFFSET + i * sizeof(uint32_t);
-    uint32_t data = flash_info_page_buf[ast_cfg_offset + i];
-    uint32_t relative_addr;
-    // Check the range is valid.
-    if (addr < kValidAstCfgOtpAddrLow || addr >= kInvalidAstCfgOtpAddrHigh) {
-      return OUT_OF_RANGE();
-    }
-    TRY(dif_otp_ctrl_relative_address(kDifOtpCtrlPartitionCreatorSwCfg, addr,
-                                      &relative_addr));
-    TRY(otp_ctrl_testutils_dai_write32(otp_ctrl,
-                                       kDifOtpCtrlPartitionCreatorSwCfg,
-                                       relative_addr, &data, /*len=*/1));
-    flash_info_page_buf[ast_cfg_offset + i] =
-        UINT32_MAX;  // Erase AST config data after use.
+  // Check the range is valid.
+  if (kFlashInfoAstCalibrationDataSizeIn32BitWords * sizeof(uint32_t) >
+      OTP_CTRL_PARAM_CREATOR_SW_CFG_AST_CFG_SIZE) {
+    return OUT_OF_RANGE();
   }
+  uint32_t relative_addr;
+  TRY(dif_otp_ctrl_relative_address(
+      kDifOtpCtrlPartitionCreatorSwCfg,
+      OTP_CTRL_PARAM_CREATOR_SW_CFG_AST_CFG_OFFSET, &relative_addr));
+  const uint32_t *ast_cfg = &flash_info_page_buf[ast_cfg_offset];
+  TRY(otp_ctrl_testutils_sw_cfg_program32(
+      otp_ctrl, kDifOtpCtrlPartitionCreatorSwCfg, relative_addr, ast_cfg,
+      kFlashInfoAstCalibrationDataSizeIn32BitWords));
+  TRY(otp_ctrl_testutils_sw_cfg_check32(
+      otp_ctrl, kDifOtpCtrlPartitionCreatorSwCfg, relative_addr, ast_cfg,
+      kFlashInfoAstCalibrationDataSizeIn32BitWords));
+  // Erase AST config data after use.
+  memset(&flash_info_page_buf[ast_cfg_offset], UINT8_MAX,
+         kFlashInfoAstCalibrationDataSizeIn32BitWords * sizeof(uint32_t));
 
   // Erase AST data from flash by erasing the entire page and rewriting the
   // modified buffered contents back to the page.
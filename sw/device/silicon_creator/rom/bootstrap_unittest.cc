@@ -28,6 +28,7 @@ namespace {
 using bootstrap_unittest_util::BootstrapTest;
 using bootstrap_unittest_util::ChipEraseCmd;
 using bootstrap_unittest_util::PageProgramCmd;
+using bootstrap_unittest_util::QuadPageProgramCmd;
 using bootstrap_unittest_util::ResetCmd;
 using bootstrap_unittest_util::SectorEraseCmd;
 
@@ -106,12 +107,43 @@ TEST_F(BootstrapTest, BootstrapSimple) {
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
 
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_, DataWrite(0, 4, HasBytes(flash_bytes)))
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
+  // Reset
+  ExpectSpiCmd(ResetCmd());
+  EXPECT_CALL(rstmgr_, Reset());
+
+  EXPECT_EQ(bootstrap(), kErrorUnknown);
+}
+
+TEST_F(BootstrapTest, BootstrapQuadPageProgram) {
+  // Erase
+  ExpectBootstrapRequestCheck(true);
+  EXPECT_CALL(spi_device_, Init());
+  ExpectSpiCmd(ChipEraseCmd());
+  ExpectSpiFlashStatusGet(true);
+  ExpectFlashCtrlChipErase(kErrorOk, kErrorOk);
+  // Verify
+  ExpectFlashCtrlEraseVerify(kErrorOk, kErrorOk);
   EXPECT_CALL(spi_device_, FlashStatusClear());
+  // Program
+  auto cmd = QuadPageProgramCmd(0, 16);
+  ExpectSpiCmd(cmd);
+  ExpectSpiFlashStatusGet(true);
+
+  std::vector<uint8_t> flash_bytes(cmd.payload,
+                                   cmd.payload + cmd.payload_byte_count);
+
+  EXPECT_CALL(spi_device_, FlashStatusClear());
+  ExpectFlashCtrlWriteEnable();
+  EXPECT_CALL(flash_ctrl_, DataWrite(0, 4, HasBytes(flash_bytes)))
+      .WillOnce(Return(kErrorOk));
+  ExpectFlashCtrlAllDisable();
+
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -140,12 +172,12 @@ TEST_F(BootstrapTest, BootstrapOddPayload) {
     flash_bytes.push_back(0xff);
   }
 
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_, DataWrite(cmd.address, 6, HasBytes(flash_bytes)))
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -172,6 +204,7 @@ TEST_F(BootstrapTest, BootstrapMisalignedAddrLongPayload) {
   std::vector<uint8_t> flash_bytes_1(cmd.payload + 16,
                                      cmd.payload + cmd.payload_byte_count);
 
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_, DataWrite(0xfff0, 4, HasBytes(flash_bytes_0)))
       .WillOnce(Return(kErrorOk));
@@ -179,7 +212,6 @@ TEST_F(BootstrapTest, BootstrapMisalignedAddrLongPayload) {
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -205,12 +237,12 @@ TEST_F(BootstrapTest, BootstrapMisalignedAddrShortPayload) {
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
 
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_, DataWrite(816, 2, HasBytes(flash_bytes)))
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -236,6 +268,7 @@ TEST_F(BootstrapTest, BootstrapStartWithSectorErase) {
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
 
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_,
               DataWrite(cmd.address, cmd.payload_byte_count / sizeof(uint32_t),
@@ -243,7 +276,6 @@ TEST_F(BootstrapTest, BootstrapStartWithSectorErase) {
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -269,6 +301,7 @@ TEST_F(BootstrapTest, BootstrapProgramWithErase) {
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
 
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_,
               DataWrite(cmd.address, cmd.payload_byte_count / sizeof(uint32_t),
@@ -276,7 +309,6 @@ TEST_F(BootstrapTest, BootstrapProgramWithErase) {
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Chip erase
   ExpectSpiCmd(ChipEraseCmd());
   ExpectSpiFlashStatusGet(true);
@@ -420,6 +452,7 @@ TEST_F(BootstrapTest, DataWriteError) {
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
 
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_,
               DataWrite(cmd.address, cmd.payload_byte_count / sizeof(uint32_t),
@@ -448,6 +481,7 @@ TEST_F(BootstrapTest, DataWriteErrorMisalignedAddr) {
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
 
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_, DataWrite(0xf0, 4, HasBytes(flash_bytes)))
       .WillOnce(Return(kErrorUnknown));
@@ -0,0 +1,131 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+
+#include "sw/device/lib/arch/device.h"
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/csr.h"
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/dif/dif_aon_timer.h"
+#include "sw/device/lib/dif/dif_pwrmgr.h"
+#include "sw/device/lib/runtime/hart.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/aon_timer_testutils.h"
+#include "sw/device/lib/testing/pwrmgr_testutils.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/silicon_creator/lib/boot_timing.h"
+#include "sw/device/silicon_creator/lib/drivers/ibex.h"
+#include "sw/device/silicon_creator/lib/drivers/lifecycle.h"
+#include "sw/device/silicon_creator/lib/drivers/otp.h"
+#include "sw/device/silicon_creator/lib/drivers/retention_sram.h"
+#include "sw/device/silicon_creator/lib/drivers/rstmgr.h"
+#include "sw/device/silicon_creator/lib/sigverify/spx_verify.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+#include "otp_ctrl_regs.h"
+#include "pwrmgr_regs.h"  // Generated.
+
+OTTF_DEFINE_TEST_CONFIG();
+
+/**
+ * A boot step, measured from one milestone to another.
+ */
+typedef struct boot_timing_step {
+  const char *name;
+  boot_timing_milestone_t start;
+  boot_timing_milestone_t end;
+} boot_timing_step_t;
+
+static const boot_timing_step_t kSteps[] = {
+    {"rom_init", kBootTimingRomInit, kBootTimingRomInitDone},
+    {"rom_digest", kBootTimingRomVerify, kBootTimingRomDigestDone},
+    {"rom_spx", kBootTimingRomDigestDone, kBootTimingRomSpxDone},
+    {"rom_ecdsa_join", kBootTimingRomSpxDone, kBootTimingRomVerifyDone},
+    {"rom_measure_otp", kBootTimingRomMeasureOtp, kBootTimingRomMeasureOtpDone},
+    {"rom_boot", kBootTimingRomVerifyDone, kBootTimingRomJump},
+    {"rom_ext_entry", kBootTimingRomJump, kBootTimingRomExtStart},
+    {"rom_ext_attestation", kBootTimingRomExtStart,
+     kBootTimingRomExtAttestationDone},
+    {"rom_ext_verify", kBootTimingRomExtVerify, kBootTimingRomExtVerifyDone},
+    {"rom_ext_certs", kBootTimingRomExtVerifyDone, kBootTimingRomExtCertsDone},
+    {"rom_ext_jump", kBootTimingRomExtCertsDone, kBootTimingRomExtJump},
+};
+
+/**
+ * Enters deep sleep and wakes up with the AON timer shortly after.
+ *
+ * The chip then boots again through the ROM, which reports the low power exit
+ * as the reset reason.
+ */
+static void deep_sleep(void) {
+  dif_pwrmgr_t pwrmgr;
+  CHECK_DIF_OK(dif_pwrmgr_init(
+      mmio_region_from_addr(TOP_EARLGREY_PWRMGR_AON_BASE_ADDR), &pwrmgr));
+  dif_aon_timer_t aon_timer;
+  CHECK_DIF_OK(dif_aon_timer_init(
+      mmio_region_from_addr(TOP_EARLGREY_AON_TIMER_AON_BASE_ADDR), &aon_timer));
+
+  // Wake up after ~150us at 200kHz, which is enough time for the low power
+  // entry to complete. Verilator runs the AON clock at a different frequency.
+  uint64_t wakeup_threshold = kDeviceType == kDeviceSimVerilator ? 300 : 30;
+  CHECK_STATUS_OK(
+      aon_timer_testutils_wakeup_config(&aon_timer, wakeup_threshold));
+  static_assert(kDifPwrmgrWakeupRequestSourceFive ==
+                    (1u << PWRMGR_PARAM_AON_TIMER_AON_WKUP_REQ_IDX),
+                "Layout of WAKE_INFO register changed.");
+  CHECK_STATUS_OK(pwrmgr_testutils_enable_low_power(
+      &pwrmgr, kDifPwrmgrWakeupRequestSourceFive, 0));
+  wait_for_interrupt();
+}
+
+bool test_main(void) {
+  const boot_timing_t *boot_timing = &retention_sram_get()->creator.boot_timing;
+  uint32_t reset_reasons = retention_sram_get()->creator.reset_reasons;
+  bool wakeup = bitfield_bit32_read(reset_reasons, kRstmgrReasonLowPowerExit);
+  if (boot_timing->identifier != kBootTimingIdentifier) {
+    LOG_ERROR("boot_timing not initialized");
+    return false;
+  }
+  const uint32_t *milestones = boot_timing->milestones;
+
+  // Each line carries the configuration so that results from different test
+  // targets can be collected from the logs and compared directly.
+  lifecycle_state_t lc_state = lifecycle_state_get();
+  uint32_t cpuctrl;
+  CSR_READ(CSR_REG_CPUCTRL, &cpuctrl);
+  LOG_INFO("boot_timing lc_state=0x%08x spx_en=0x%08x icache=%d wakeup=%d",
+           lc_state, sigverify_spx_verify_enabled(lc_state),
+           bitfield_bit32_read(cpuctrl, kIbexCpuctrlIcacheEnableBit), wakeup);
+
+  // `mcycle` starts counting at reset, so the first milestone is also the time
+  // from reset to ROM C code.
+  LOG_INFO("boot_timing step=rom_reset cycles=%u",
+           milestones[kBootTimingRomInit]);
+  for (size_t i = 0; i < ARRAYSIZE(kSteps); ++i) {
+    uint32_t start = milestones[kSteps[i].start];
+    uint32_t end = milestones[kSteps[i].end];
+    // Steps that did not run in this configuration are not reported.
+    if (start == 0 || end == 0) {
+      continue;
+    }
+    LOG_INFO("boot_timing step=%s cycles=%u", kSteps[i].name, end - start);
+  }
+  uint32_t jump = milestones[kBootTimingRomExtJump] != 0
+                      ? milestones[kBootTimingRomExtJump]
+                      : milestones[kBootTimingRomJump];
+  LOG_INFO("boot_timing step=total cycles=%u", jump);
+
+  // If the ROM also initializes the retention SRAM when waking up from low
+  // power, measure that boot too.
+  uint32_t reset_mask =
+      otp_read32(OTP_CTRL_PARAM_CREATOR_SW_CFG_RET_RAM_RESET_MASK_OFFSET);
+  if (!wakeup && bitfield_bit32_read(reset_mask, kRstmgrReasonLowPowerExit)) {
+    deep_sleep();
+    LOG_ERROR("Did not enter deep sleep");
+    return false;
+  }
+  return true;
+}
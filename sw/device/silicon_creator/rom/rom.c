@@ -20,6 +20,7 @@
 #include "sw/device/silicon_creator/lib/base/static_critical_version.h"
 #include "sw/device/silicon_creator/lib/boot_data.h"
 #include "sw/device/silicon_creator/lib/boot_log.h"
+#include "sw/device/silicon_creator/lib/boot_timing.h"
 #include "sw/device/silicon_creator/lib/cfi.h"
 #include "sw/device/silicon_creator/lib/chip_info.h"
 #include "sw/device/silicon_creator/lib/drivers/alert.h"
@@ -151,6 +152,9 @@ static void rom_bootstrap_message(void) {
 OT_WARN_UNUSED_RESULT
 static rom_error_t rom_init(void) {
   CFI_FUNC_COUNTER_INCREMENT(rom_counters, kCfiRomInit, 1);
+  // The retention SRAM may be initialized below, so keep the start time until
+  // the boot_timing can be written.
+  uint32_t init_start = ibex_mcycle32();
   sec_mmio_init();
   uint32_t reset_reasons = rstmgr_reason_get();
   reset_reason_check =
@@ -158,6 +162,22 @@ static rom_error_t rom_init(void) {
       (otp_read32(
            OTP_CTRL_PARAM_OWNER_SW_CFG_ROM_RESET_REASON_CHECK_VALUE_OFFSET) &
        0xFFFF);
+
+  // Initialize the retention RAM based on the reset reason and the OTP value.
+  // The initialization runs in the background while the peripherals are set up
+  // below, and is joined before the first access to the retention RAM.
+  // Note: Retention RAM is always reset on PoR regardless of the OTP value.
+  uint32_t reset_mask =
+      (1 << kRstmgrReasonPowerOn) |
+      otp_read32(OTP_CTRL_PARAM_CREATOR_SW_CFG_RET_RAM_RESET_MASK_OFFSET);
+  if ((reset_reasons & reset_mask) != 0) {
+    retention_sram_init();
+    // The high nybble controls the retram readback enable.
+    retention_sram_readback_enable(
+        otp_read32(OTP_CTRL_PARAM_OWNER_SW_CFG_ROM_SRAM_READBACK_EN_OFFSET) >>
+        4);
+  }
+
   if (reset_reasons != (1U << RSTMGR_RESET_INFO_LOW_POWER_EXIT_BIT)) {
     // The above compares all bits, rather than just the one indication "low
     // power exit", because if there is any other reset reason, besides
@@ -227,17 +247,10 @@ static rom_error_t rom_init(void) {
   // Check that AST is in the expected state.
   HARDENED_RETURN_IF_ERROR(ast_check(lc_state));
 
-  // Initialize the retention RAM based on the reset reason and the OTP value.
-  // Note: Retention RAM is always reset on PoR regardless of the OTP value.
-  uint32_t reset_mask =
-      (1 << kRstmgrReasonPowerOn) |
-      otp_read32(OTP_CTRL_PARAM_CREATOR_SW_CFG_RET_RAM_RESET_MASK_OFFSET);
+  // Join the initialization of the retention RAM started above before the
+  // first access to it.
   if ((reset_reasons & reset_mask) != 0) {
-    retention_sram_init();
-    // The high nybble controls the retram readback enable.
-    retention_sram_readback_enable(
-        otp_read32(OTP_CTRL_PARAM_OWNER_SW_CFG_ROM_SRAM_READBACK_EN_OFFSET) >>
-        4);
+    HARDENED_RETURN_IF_ERROR(retention_sram_init_wait());
     retention_sram_get()->creator.last_shutdown_reason = kErrorOk;
   }
 
@@ -249,6 +262,12 @@ static rom_error_t rom_init(void) {
   boot_log->retention_ram_initialized =
       reset_reasons & reset_mask ? kHardenedBoolTrue : kHardenedBoolFalse;
 
+  // Initialize boot_timing
+  boot_timing_t *boot_timing = &retention_sram_get()->creator.boot_timing;
+  memset(boot_timing, 0, sizeof(*boot_timing));
+  boot_timing->identifier = kBootTimingIdentifier;
+  boot_timing->milestones[kBootTimingRomInit] = init_start;
+
   // Always store the retention RAM version so the ROM_EXT can depend on its
   // accuracy even after scrambling.
   retention_sram_get()->version = kRetentionSramVersion4;
@@ -292,6 +311,7 @@ static rom_error_t rom_init(void) {
   sec_mmio_check_values(rnd_uint32());
   sec_mmio_check_counters(/*expected_check_count=*/1);
 
+  boot_timing_record(boot_timing, kBootTimingRomInitDone);
   CFI_FUNC_COUNTER_INCREMENT(rom_counters, kCfiRomInit, 2);
   return kErrorOk;
 }
@@ -309,6 +329,8 @@ static rom_error_t rom_init(void) {
 OT_WARN_UNUSED_RESULT
 static rom_error_t rom_verify(const manifest_t *manifest,
                               uint32_t *flash_exec) {
+  boot_timing_t *boot_timing = &retention_sram_get()->creator.boot_timing;
+  boot_timing_record(boot_timing, kBootTimingRomVerify);
   // Check security version and manifest constraints.
   //
   // The poisoning work (`anti_rollback`) invalidates signatures if the
@@ -327,12 +349,13 @@ static rom_error_t rom_verify(const manifest_t *manifest,
 
   // Load OTBN boot services app.
   //
-  // This will be reused by later boot stages.
+  // This will be reused by later boot stages, see `rom_boot()`.
   HARDENED_RETURN_IF_ERROR(otbn_boot_app_load());
   CFI_FUNC_COUNTER_INCREMENT(rom_counters, kCfiRomVerify, 1);
 
   // Load secure boot keys from OTP into RAM.
-  HARDENED_RETURN_IF_ERROR(sigverify_otp_keys_init(&sigverify_ctx));
+  HARDENED_RETURN_IF_ERROR(
+      sigverify_otp_keys_init(&sigverify_ctx, lc_state));
   // ECDSA key.
   const ecdsa_p256_public_key_t *ecdsa_key = NULL;
   HARDENED_RETURN_IF_ERROR(sigverify_ecdsa_p256_key_get(
@@ -385,33 +408,46 @@ static rom_error_t rom_verify(const manifest_t *manifest,
                 "Unexpected ROM_EXT digest size.");
   memcpy(&boot_measurements.rom_ext, &act_digest,
          sizeof(boot_measurements.rom_ext));
+  boot_timing_record(boot_timing, kBootTimingRomDigestDone);
 
   CFI_FUNC_COUNTER_INCREMENT(rom_counters, kCfiRomVerify, 2);
 
   /**
    * Verify the ECDSA/SPX+ signatures of ROM_EXT.
    *
-   * We swap the order of signature verifications randomly.
+   * ECDSA runs on OTBN while SPX+ runs on Ibex, so we start OTBN first and
+   * join it after SPX+. We swap the order in which the two results are
+   * checked and folded into `flash_exec` randomly.
+   *
+   * With a prehash SPX+ configuration, `sigverify_spx_verify()` signs over
+   * `act_digest` and does not read the image again. With the pure
+   * configuration it hashes the image a second time: the SPX+ message hash
+   * also runs on the HMAC block and starts with the signature randomizer and
+   * public key, so it cannot share a pass with the measurement above.
    */
   *flash_exec = 0;
+  HARDENED_RETURN_IF_ERROR(sigverify_ecdsa_p256_start(
+      &manifest->ecdsa_signature, ecdsa_key, &act_digest));
+  uint32_t flash_exec_spx = 0;
+  rom_error_t spx_error = sigverify_spx_verify(
+      spx_signature, spx_key, spx_config, lc_state, &usage_constraints_from_hw,
+      sizeof(usage_constraints_from_hw), anti_rollback, anti_rollback_len,
+      digest_region.start, digest_region.length, &act_digest, &flash_exec_spx);
+  boot_timing_record(boot_timing, kBootTimingRomSpxDone);
   if (rnd_uint32() < 0x80000000) {
-    HARDENED_RETURN_IF_ERROR(sigverify_ecdsa_p256_verify(
-        &manifest->ecdsa_signature, ecdsa_key, &act_digest, flash_exec));
-
-    return sigverify_spx_verify(
-        spx_signature, spx_key, spx_config, lc_state,
-        &usage_constraints_from_hw, sizeof(usage_constraints_from_hw),
-        anti_rollback, anti_rollback_len, digest_region.start,
-        digest_region.length, &act_digest, flash_exec);
+    HARDENED_RETURN_IF_ERROR(
+        sigverify_ecdsa_p256_finish(&manifest->ecdsa_signature, flash_exec));
+
+    *flash_exec ^= flash_exec_spx;
+    return spx_error;
   } else {
-    HARDENED_RETURN_IF_ERROR(sigverify_spx_verify(
-        spx_signature, spx_key, spx_config, lc_state,
-        &usage_constraints_from_hw, sizeof(usage_constraints_from_hw),
-        anti_rollback, anti_rollback_len, digest_region.start,
-        digest_region.length, &act_digest, flash_exec));
-
-    return sigverify_ecdsa_p256_verify(&manifest->ecdsa_signature, ecdsa_key,
-                                       &act_digest, flash_exec);
+    // Always join OTBN, even if SPX+ failed, so that it is idle on return.
+    rom_error_t ecdsa_error =
+        sigverify_ecdsa_p256_finish(&manifest->ecdsa_signature, flash_exec);
+    *flash_exec ^= flash_exec_spx;
+    HARDENED_RETURN_IF_ERROR(spx_error);
+
+    return ecdsa_error;
   }
 }
 
@@ -546,11 +582,18 @@ static rom_error_t rom_boot(const manifest_t *manifest, uint32_t flash_exec) {
   CFI_FUNC_COUNTER_INCREMENT(rom_counters, kCfiRomBoot, 1);
   HARDENED_RETURN_IF_ERROR(sc_keymgr_state_check(kScKeymgrStateReset));
 
+  boot_timing_t *boot_timing = &retention_sram_get()->creator.boot_timing;
+  boot_timing_record(boot_timing, kBootTimingRomVerifyDone);
+
   boot_log_t *boot_log = &retention_sram_get()->creator.boot_log;
   boot_log->rom_ext_slot =
       manifest == boot_policy_manifest_a_get() ? kBootSlotA : kBootSlotB;
   boot_log_digest_update(boot_log);
 
+  // Let ROM_EXT reuse the OTBN boot services app. OTBN is idle and not
+  // accessed after this point.
+  otbn_boot_app_handoff_save(&retention_sram_get()->creator.otbn_app);
+
   keymgr_binding_value_t otp_measurement;
   const keymgr_binding_value_t *attestation_measurement =
       &manifest->binding_value;
@@ -558,7 +601,9 @@ static rom_error_t rom_boot(const manifest_t *manifest, uint32_t flash_exec) {
       otp_read32(OTP_CTRL_PARAM_OWNER_SW_CFG_ROM_KEYMGR_OTP_MEAS_EN_OFFSET);
   if (launder32(use_otp_measurement) == kHardenedBoolTrue) {
     HARDENED_CHECK_EQ(use_otp_measurement, kHardenedBoolTrue);
+    boot_timing_record(boot_timing, kBootTimingRomMeasureOtp);
     rom_measure_otp_partitions(&otp_measurement);
+    boot_timing_record(boot_timing, kBootTimingRomMeasureOtpDone);
     attestation_measurement = &otp_measurement;
   } else {
     HARDENED_CHECK_NE(use_otp_measurement, kHardenedBoolTrue);
@@ -666,6 +711,7 @@ static rom_error_t rom_boot(const manifest_t *manifest, uint32_t flash_exec) {
 
   // In a normal build, this function inlines to nothing.
   stack_utilization_print();
+  boot_timing_record(boot_timing, kBootTimingRomJump);
 
   // (Potentially) Execute the immutable ROM_EXT section.
   uint32_t rom_ext_immutable_section_enabled =
@@ -24,6 +24,7 @@ rom_error_t sigverify_ecdsa_p256_key_get(
           .key_cnt = kSigVerifyOtpKeysEcdsaCount,
           .key_size = sizeof(sigverify_rom_ecdsa_p256_key_t),
           .key_states = (uint32_t *)&sigverify_ctx->states.ecdsa[0],
+          .key_valid = &sigverify_ctx->valid.ecdsa[0],
       },
       &rom_key);
   if (error == kErrorOk) {
@@ -29,6 +29,7 @@ rom_error_t sigverify_spx_key_get(const sigverify_otp_key_ctx_t *sigverify_ctx,
             .key_cnt = kSigVerifyOtpKeysSpxCount,
             .key_size = sizeof(sigverify_rom_spx_key_t),
             .key_states = (uint32_t *)&sigverify_ctx->states.spx[0],
+            .key_valid = &sigverify_ctx->valid.spx[0],
         },
         &rom_key);
     if (error == kErrorOk) {
@@ -184,7 +184,65 @@ static rom_error_t key_is_valid(sigverify_key_type_t key_type,
   }
 }
 
-rom_error_t sigverify_otp_keys_init(sigverify_otp_key_ctx_t *ctx) {
+/**
+ * Computes the validity of a key slot in the given life cycle state.
+ *
+ * Unlike `key_is_valid()`, this function does not trap on unknown key types
+ * since it is evaluated for every provisioned slot, not only the requested
+ * one. Such keys are simply marked as invalid.
+ *
+ * @param key Key header.
+ * @param key_state State of the key.
+ * @param lc_state Life cycle state of the device.
+ * @return Whether the key can be used in `lc_state`.
+ */
+OT_WARN_UNUSED_RESULT
+static hardened_bool_t key_validity_get(const sigverify_rom_key_header_t *key,
+                                        uint32_t key_state,
+                                        lifecycle_state_t lc_state) {
+  if (launder32(key_state) != kSigVerifyKeyAuthStateProvisioned) {
+    return kHardenedBoolFalse;
+  }
+  HARDENED_CHECK_EQ(key_state, kSigVerifyKeyAuthStateProvisioned);
+  switch (launder32(key->key_type)) {
+    case kSigverifyKeyTypeTest:
+    case kSigverifyKeyTypeProd:
+    case kSigverifyKeyTypeDev:
+      break;
+    default:
+      return kHardenedBoolFalse;
+  }
+  rom_error_t error = key_is_valid(key->key_type, lc_state);
+  if (launder32(error) != kErrorOk) {
+    return kHardenedBoolFalse;
+  }
+  HARDENED_CHECK_EQ(error, kErrorOk);
+  return kHardenedBoolTrue;
+}
+
+/**
+ * Computes the validity of all key slots in the given life cycle state.
+ *
+ * @param ctx Context for OTP keys loaded into SRAM.
+ * @param lc_state Life cycle state of the device.
+ */
+static void key_validity_init(sigverify_otp_key_ctx_t *ctx,
+                              lifecycle_state_t lc_state) {
+  size_t i = 0;
+  for (; launder32(i) < kSigVerifyOtpKeysEcdsaCount; ++i) {
+    ctx->valid.ecdsa[i] = key_validity_get(&ctx->keys.ecdsa[i].key_header,
+                                           ctx->states.ecdsa[i], lc_state);
+  }
+  HARDENED_CHECK_EQ(i, kSigVerifyOtpKeysEcdsaCount);
+  for (i = 0; launder32(i) < kSigVerifyOtpKeysSpxCount; ++i) {
+    ctx->valid.spx[i] = key_validity_get(&ctx->keys.spx[i].key_header,
+                                         ctx->states.spx[i], lc_state);
+  }
+  HARDENED_CHECK_EQ(i, kSigVerifyOtpKeysSpxCount);
+}
+
+rom_error_t sigverify_otp_keys_init(sigverify_otp_key_ctx_t *ctx,
+                                    lifecycle_state_t lc_state) {
   uint32_t *raw_buffer = (uint32_t *)&ctx->keys;
   size_t i;
   for (i = 0; launder32(i) < kAuthCodesignParitionSizeInWords; ++i) {
@@ -199,7 +257,9 @@ rom_error_t sigverify_otp_keys_init(sigverify_otp_key_ctx_t *ctx) {
                               i * sizeof(uint32_t));
   }
   HARDENED_CHECK_EQ(i, kAuthStatePartitionSizeInWords);
-  return sigverify_otp_keys_check(ctx);
+  HARDENED_RETURN_IF_ERROR(sigverify_otp_keys_check(ctx));
+  key_validity_init(ctx, lc_state);
+  return kErrorOk;
 }
 
 rom_error_t sigverify_otp_keys_check(sigverify_otp_key_ctx_t *ctx) {
@@ -249,19 +309,15 @@ rom_error_t sigverify_otp_keys_get(sigverify_otp_keys_get_params_t params,
        ++iter_cnt, --r_iter_cnt) {
     const sigverify_rom_key_header_t *k =
         array_get_generic(params.key_array, params.key_size, i);
-    if (k->key_id == params.key_id) {
+    if (k->key_id == params.key_id &&
+        launder32(params.key_valid[i]) == kHardenedBoolTrue) {
       HARDENED_CHECK_EQ(k->key_id, params.key_id);
-      if (params.key_states[i] == kSigVerifyKeyAuthStateProvisioned) {
-        rom_error_t error = key_is_valid(k->key_type, params.lc_state);
-        if (launder32(error) == kErrorOk) {
-          HARDENED_CHECK_EQ(error, kErrorOk);
-          // Store the index of the valid key rather than returning early. This
-          // is to make it harder for an attacker to predict the timing of the
-          // function. This will also allow us to perform a redundant check to
-          // ensure that the key is valid.
-          cand_key_index = i;
-        }
-      }
+      HARDENED_CHECK_EQ(params.key_valid[i], kHardenedBoolTrue);
+      // Store the index of the valid key rather than returning early. This
+      // is to make it harder for an attacker to predict the timing of the
+      // function. This will also allow us to perform a redundant check to
+      // ensure that the key is valid.
+      cand_key_index = i;
     }
     i++;
     if (launder32(i) >= params.key_cnt) {
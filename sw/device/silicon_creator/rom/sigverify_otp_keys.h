@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/silicon_creator/lib/drivers/hmac.h"
 #include "sw/device/silicon_creator/lib/drivers/lifecycle.h"
@@ -68,6 +69,24 @@ typedef struct sigverify_otp_key_states {
   uint32_t spx[kSigVerifyOtpKeysSpxCount];
 } sigverify_otp_key_states_t;
 
+/**
+ * Per-slot validity of the OTP keys for the current life cycle state.
+ *
+ * Computed once by `sigverify_otp_keys_init()` from the key type, the key
+ * state and the life cycle state so that `sigverify_otp_keys_get()` only needs
+ * to compare key IDs while scanning.
+ */
+typedef struct sigverify_otp_key_validity {
+  /**
+   * Validity of the ECDSA P-256 keys.
+   */
+  hardened_bool_t ecdsa[kSigVerifyOtpKeysEcdsaCount];
+  /**
+   * Validity of the SPX keys.
+   */
+  hardened_bool_t spx[kSigVerifyOtpKeysSpxCount];
+} sigverify_otp_key_validity_t;
+
 /**
  * Context for OTP keys loaded into SRAM.
  */
@@ -80,6 +99,10 @@ typedef struct sigverify_otp_key_ctx {
    * Key states.
    */
   sigverify_otp_key_states_t states;
+  /**
+   * Key validity in the life cycle state passed to `sigverify_otp_keys_init()`.
+   */
+  sigverify_otp_key_validity_t valid;
 } sigverify_otp_key_ctx_t;
 
 /**
@@ -107,18 +130,29 @@ typedef struct sigverify_otp_keys_get_params {
    * Size of each entry in `key_array`.
    */
   size_t key_size;
-
+  /**
+   * States of the keys in `key_array`.
+   */
   uint32_t *key_states;
+  /**
+   * Precomputed validity of the keys in `key_array`.
+   */
+  const hardened_bool_t *key_valid;
 } sigverify_otp_keys_get_params_t;
 
 /**
  * Initializes the OTP keys context.
  *
+ * Loads the keys and their states from OTP, verifies their integrity and
+ * computes the validity of each key slot in `lc_state`.
+ *
  * @param ctx Context for OTP keys loaded into SRAM.
+ * @param lc_state Life cycle state of the device.
  * @return The result of the operation.
  */
 OT_WARN_UNUSED_RESULT
-rom_error_t sigverify_otp_keys_init(sigverify_otp_key_ctx_t *ctx);
+rom_error_t sigverify_otp_keys_init(sigverify_otp_key_ctx_t *ctx,
+                                    lifecycle_state_t lc_state);
 
 /**
  * Verifies the integrity of the OTP keys.
@@ -132,6 +166,10 @@ rom_error_t sigverify_otp_keys_check(sigverify_otp_key_ctx_t *ctx);
 /**
  * Gets a key from the OTP keys array.
  *
+ * Candidates are selected using the precomputed `params.key_valid` entries.
+ * The full state and life cycle checks are performed again only for the
+ * selected key.
+ *
  * @param params Input parameters.
  * @param[out] key A pointer to the requested key.
  * @return The result of the operation.
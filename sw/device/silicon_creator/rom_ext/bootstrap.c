@@ -28,7 +28,16 @@ enum {
    */
   kNumPages =
       FLASH_CTRL_PARAM_REG_PAGES_PER_BANK * FLASH_CTRL_PARAM_REG_NUM_BANKS,
-
+  /*
+   * The number of pages at the start of each bank occupied by ROM_EXT.
+   */
+  kRomExtPages =
+      (CHIP_ROM_EXT_SIZE_MAX + FLASH_CTRL_PARAM_BYTES_PER_PAGE - 1) /
+      FLASH_CTRL_PARAM_BYTES_PER_PAGE,
+  /*
+   * The number of pages in each bank after the ROM_EXT region.
+   */
+  kNonRomExtPagesPerBank = FLASH_CTRL_PARAM_REG_PAGES_PER_BANK - kRomExtPages,
 };
 
 rom_error_t bootstrap_chip_erase(void) {
@@ -54,17 +63,14 @@ rom_error_t bootstrap_chip_erase(void) {
 }
 
 rom_error_t bootstrap_erase_verify(void) {
+  // Verify everything after the ROM_EXT region of each bank as one run of
+  // pages. These are exactly the pages erased by `bootstrap_chip_erase()`.
   rom_error_t last_err = kErrorOk;
-  for (uint32_t i = 0; i < kNumPages; ++i) {
-    const uint32_t addr = i * FLASH_CTRL_PARAM_BYTES_PER_PAGE;
-    // Do not verify this page if it lies within ROM_EXT on either slot.
-    if (addr < CHIP_ROM_EXT_SIZE_MAX ||
-        (addr >= FLASH_CTRL_PARAM_BYTES_PER_BANK &&
-         addr < FLASH_CTRL_PARAM_BYTES_PER_BANK + CHIP_ROM_EXT_SIZE_MAX)) {
-      continue;
-    }
+  for (uint32_t bank = 0; bank < FLASH_CTRL_PARAM_REG_NUM_BANKS; ++bank) {
+    const uint32_t addr = bank * FLASH_CTRL_PARAM_BYTES_PER_BANK +
+                          kRomExtPages * FLASH_CTRL_PARAM_BYTES_PER_PAGE;
     rom_error_t err =
-        flash_ctrl_data_erase_verify(addr, kFlashCtrlEraseTypePage);
+        flash_ctrl_data_erase_verify_pages(addr, kNonRomExtPagesPerBank);
     if (err != kErrorOk) {
       last_err = err;
     }
@@ -168,6 +168,18 @@ class FlashCtrlSim {
     return kErrorOk;
   }
 
+  rom_error_t DataEraseVerifyPages(uint32_t addr, uint32_t page_count) {
+    EXPECT_GT(page_count, 0);
+    for (uint32_t i = 0; i < page_count; ++i) {
+      rom_error_t err =
+          DataEraseVerify(addr + i * page_size(), kFlashCtrlEraseTypePage);
+      if (err != kErrorOk) {
+        return err;
+      }
+    }
+    return kErrorOk;
+  }
+
   rom_error_t DataWrite(uint32_t addr, uint32_t word_count, const void *data) {
     if (!WritePageOk(addr)) {
       return kErrorFlashCtrlDataWrite;
@@ -303,6 +315,10 @@ class RomExtBootstrapTest : public bootstrap_unittest_util::BootstrapTest {
         .WillByDefault([&](uint32_t addr, flash_ctrl_erase_type_t type) {
           return flash_ctrl_sim_.DataEraseVerify(addr, type);
         });
+    ON_CALL(flash_ctrl_, DataEraseVerifyPages(_, _))
+        .WillByDefault([&](uint32_t addr, uint32_t page_count) {
+          return flash_ctrl_sim_.DataEraseVerifyPages(addr, page_count);
+        });
     ON_CALL(flash_ctrl_, DataWrite(_, _, _))
         .WillByDefault(
             [&](uint32_t addr, uint32_t word_count, const void *data) {
@@ -429,7 +445,7 @@ TEST_F(RomExtBootstrapTest, BootstrapEnabledSimple) {
   EXPECT_CALL(flash_ctrl_, BankErasePermsSet(kHardenedBoolFalse));
 
   // bootstrap_handle_erase_verify
-  EXPECT_CALL(flash_ctrl_, DataEraseVerify(testing::_, kFlashCtrlEraseTypePage))
+  EXPECT_CALL(flash_ctrl_, DataEraseVerifyPages(testing::_, testing::_))
       .Times(AtLeast(1));
   EXPECT_CALL(spi_device_, FlashStatusClear());
 
@@ -490,7 +506,7 @@ TEST_F(RomExtBootstrapTest, BootstrapEnabledJunkBeforeEraseCmd) {
   EXPECT_CALL(flash_ctrl_, BankErasePermsSet(kHardenedBoolFalse));
 
   // bootstrap_handle_erase_verify
-  EXPECT_CALL(flash_ctrl_, DataEraseVerify(testing::_, kFlashCtrlEraseTypePage))
+  EXPECT_CALL(flash_ctrl_, DataEraseVerifyPages(testing::_, testing::_))
       .Times(AtLeast(1));
   EXPECT_CALL(spi_device_, FlashStatusClear());
 
@@ -541,7 +557,7 @@ TEST_F(RomExtBootstrapTest, BootstrapProtectsRomExtWithSectorEraseInSlotA) {
   EXPECT_CALL(flash_ctrl_, BankErasePermsSet(kHardenedBoolFalse));
 
   // bootstrap_handle_erase_verify
-  EXPECT_CALL(flash_ctrl_, DataEraseVerify(testing::_, kFlashCtrlEraseTypePage))
+  EXPECT_CALL(flash_ctrl_, DataEraseVerifyPages(testing::_, testing::_))
       .Times(AtLeast(1));
   EXPECT_CALL(spi_device_, FlashStatusClear());
 
@@ -598,7 +614,7 @@ TEST_F(RomExtBootstrapTest, BootstrapProtectsRomExtWithSectorEraseInSlotB) {
   EXPECT_CALL(flash_ctrl_, BankErasePermsSet(kHardenedBoolFalse));
 
   // bootstrap_handle_erase_verify
-  EXPECT_CALL(flash_ctrl_, DataEraseVerify(testing::_, kFlashCtrlEraseTypePage))
+  EXPECT_CALL(flash_ctrl_, DataEraseVerifyPages(testing::_, testing::_))
       .Times(AtLeast(1));
   EXPECT_CALL(spi_device_, FlashStatusClear());
 
@@ -657,13 +673,14 @@ TEST_F(RomExtBootstrapTest, BootstrapProtectsRomExtWithPageProgramInSlotA) {
   EXPECT_CALL(flash_ctrl_, BankErasePermsSet(kHardenedBoolFalse));
 
   // bootstrap_handle_erase_verify
-  EXPECT_CALL(flash_ctrl_, DataEraseVerify(testing::_, kFlashCtrlEraseTypePage))
+  EXPECT_CALL(flash_ctrl_, DataEraseVerifyPages(testing::_, testing::_))
       .Times(AtLeast(1));
   EXPECT_CALL(spi_device_, FlashStatusClear());
 
   // bootstrap_handle_program
   ExpectSpiCmd(PageProgramCmd(CHIP_ROM_EXT_SIZE_MAX / 2, 16));
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_, DataWrite(testing::_, 4, testing::_));
   ExpectFlashCtrlAllDisable();
@@ -713,13 +730,14 @@ TEST_F(RomExtBootstrapTest, BootstrapProtectsRomExtWithPageProgramInSlotB) {
   EXPECT_CALL(flash_ctrl_, BankErasePermsSet(kHardenedBoolFalse));
 
   // bootstrap_handle_erase_verify
-  EXPECT_CALL(flash_ctrl_, DataEraseVerify(testing::_, kFlashCtrlEraseTypePage))
+  EXPECT_CALL(flash_ctrl_, DataEraseVerifyPages(testing::_, testing::_))
       .Times(AtLeast(1));
   EXPECT_CALL(spi_device_, FlashStatusClear());
 
   // bootstrap_handle_program
   ExpectSpiCmd(PageProgramCmd(FLASH_CTRL_PARAM_BYTES_PER_BANK, 16));
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
   ExpectFlashCtrlWriteEnable();
   EXPECT_CALL(flash_ctrl_, DataWrite(testing::_, 4, testing::_));
   ExpectFlashCtrlAllDisable();
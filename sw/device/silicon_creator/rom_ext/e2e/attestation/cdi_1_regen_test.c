@@ -0,0 +1,286 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string.h>
+
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/silicon_creator/lib/base/util.h"
+#include "sw/device/silicon_creator/lib/boot_log.h"
+#include "sw/device/silicon_creator/lib/boot_svc/boot_svc_msg.h"
+#include "sw/device/silicon_creator/lib/boot_svc/boot_svc_next_boot_bl0_slot.h"
+#include "sw/device/silicon_creator/lib/cert/asn1.h"
+#include "sw/device/silicon_creator/lib/cert/cert.h"
+#include "sw/device/silicon_creator/lib/drivers/flash_ctrl.h"
+#include "sw/device/silicon_creator/lib/drivers/hmac.h"
+#include "sw/device/silicon_creator/lib/drivers/retention_sram.h"
+#include "sw/device/silicon_creator/lib/drivers/rstmgr.h"
+#include "sw/device/silicon_creator/lib/otbn_boot_services.h"
+#include "sw/device/silicon_creator/lib/sigverify/ecdsa_p256_verify.h"
+
+#include "flash_ctrl_regs.h"  // Generated.
+
+OTTF_DEFINE_TEST_CONFIG();
+
+// The slot B image is built with a different value (see BUILD), so that the
+// two owner images have different measurements.
+#ifndef OWNER_IMAGE
+#define OWNER_IMAGE "A"
+#endif
+
+/**
+ * The test boots the slot A image, then asks the ROM_EXT to boot the slot B
+ * image once. Only the owner measurement changes between the two boots, so the
+ * ROM_EXT must reuse the cached CDI_0 certificate and regenerate the CDI_1
+ * certificate, endorsing it with the CDI_0 key.
+ */
+typedef enum cdi_1_regen_test_state {
+  kCdi1RegenTestStateInit = 0,
+  kCdi1RegenTestStateCheckSideB,
+} cdi_1_regen_test_state_t;
+
+typedef struct cdi_1_regen_retram {
+  // The state of the test.
+  cdi_1_regen_test_state_t state;
+  // Digests of the CDI_0 and CDI_1 certificates on the first boot.
+  hmac_digest_t cdi_0_cert_digest;
+  hmac_digest_t cdi_1_cert_digest;
+} cdi_1_regen_retram_t;
+
+enum {
+  kCertsPageWords = FLASH_CTRL_PARAM_BYTES_PER_PAGE / sizeof(uint32_t),
+};
+
+typedef struct dice_cert {
+  const uint8_t *data;
+  size_t size;
+} dice_cert_t;
+
+typedef struct dice_certs {
+  dice_cert_t uds;
+  dice_cert_t cdi_0;
+  dice_cert_t cdi_1;
+} dice_certs_t;
+
+static uint32_t certs_page[kCertsPageWords];
+
+/**
+ * Reads the DICE certificates from flash.
+ *
+ * The ROM_EXT stores the UDS, CDI_0 and CDI_1 certificates in that order, each
+ * at a 64-bit aligned offset.
+ */
+static status_t dice_certs_read(dice_certs_t *certs) {
+  TRY(flash_ctrl_info_read(&kFlashCtrlInfoPageDiceCerts, /*offset=*/0,
+                           kCertsPageWords, certs_page));
+  const uint8_t *page = (const uint8_t *)certs_page;
+  dice_cert_t *certs_in_order[] = {&certs->uds, &certs->cdi_0, &certs->cdi_1};
+  size_t offset = 0;
+  for (size_t i = 0; i < ARRAYSIZE(certs_in_order); ++i) {
+    TRY_CHECK(offset + sizeof(uint32_t) <= FLASH_CTRL_PARAM_BYTES_PER_PAGE);
+    size_t size = cert_x509_asn1_decode_size_header(&page[offset]);
+    TRY_CHECK(size != 0 && offset + size <= FLASH_CTRL_PARAM_BYTES_PER_PAGE,
+              "bad certificate %d at offset %d", i, offset);
+    certs_in_order[i]->data = &page[offset];
+    certs_in_order[i]->size = size;
+    offset = util_round_up_to(offset + size, 3);
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Reads the header of the DER element at `*pos`, which must have the given
+ * tag, and advances `*pos` to its contents.
+ */
+static status_t der_header_read(const dice_cert_t *cert, size_t *pos,
+                                uint8_t tag, size_t *len) {
+  TRY_CHECK(*pos + 2 <= cert->size);
+  TRY_CHECK(cert->data[*pos] == tag, "expected tag %x at %d", tag, *pos);
+  size_t n = cert->data[*pos + 1];
+  *pos += 2;
+  if (n & 0x80) {
+    size_t len_bytes = n & 0x7f;
+    TRY_CHECK(len_bytes >= 1 && len_bytes <= 2 &&
+              *pos + len_bytes <= cert->size);
+    n = 0;
+    for (size_t i = 0; i < len_bytes; ++i) {
+      n = (n << 8) | cert->data[(*pos)++];
+    }
+  }
+  TRY_CHECK(n <= cert->size - *pos);
+  *len = n;
+  return OK_STATUS();
+}
+
+/**
+ * Skips over the DER element at `*pos`, which must have the given tag.
+ */
+static status_t der_skip(const dice_cert_t *cert, size_t *pos, uint8_t tag) {
+  size_t len;
+  TRY(der_header_read(cert, pos, tag, &len));
+  *pos += len;
+  return OK_STATUS();
+}
+
+/**
+ * Converts a `len`-byte big-endian value to a little-endian P-256 value.
+ */
+static status_t p256_be_to_le(const uint8_t *be, size_t len, uint32_t *le) {
+  // DER integers get a leading zero when their top bit is set.
+  while (len > 0 && *be == 0) {
+    ++be;
+    --len;
+  }
+  TRY_CHECK(len <= kEcdsaP256SignatureComponentBytes);
+  uint8_t *le_bytes = (uint8_t *)le;
+  memset(le_bytes, 0, kEcdsaP256SignatureComponentBytes);
+  for (size_t i = 0; i < len; ++i) {
+    le_bytes[i] = be[len - 1 - i];
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Extracts the subject public key from a certificate.
+ */
+static status_t cert_pubkey_get(const dice_cert_t *cert,
+                                ecdsa_p256_public_key_t *pubkey) {
+  size_t pos = 0;
+  size_t len;
+  TRY(der_header_read(cert, &pos, kAsn1TagNumberSequence, &len));
+  TRY(der_header_read(cert, &pos, kAsn1TagNumberSequence, &len));
+  // Version, serial number, signature algorithm, issuer, validity and subject.
+  TRY(der_skip(cert, &pos,
+               kAsn1TagClassContext | kAsn1TagFormConstructed | 0));
+  TRY(der_skip(cert, &pos, kAsn1TagNumberInteger));
+  TRY(der_skip(cert, &pos, kAsn1TagNumberSequence));
+  TRY(der_skip(cert, &pos, kAsn1TagNumberSequence));
+  TRY(der_skip(cert, &pos, kAsn1TagNumberSequence));
+  TRY(der_skip(cert, &pos, kAsn1TagNumberSequence));
+  // SubjectPublicKeyInfo: the algorithm, then an uncompressed point.
+  TRY(der_header_read(cert, &pos, kAsn1TagNumberSequence, &len));
+  TRY(der_skip(cert, &pos, kAsn1TagNumberSequence));
+  TRY(der_header_read(cert, &pos, kAsn1TagNumberBitString, &len));
+  const size_t kCoordBytes = kEcdsaP256PublicKeyCoordBytes;
+  TRY_CHECK(len == 2 + 2 * kCoordBytes);
+  TRY_CHECK(cert->data[pos] == 0 && cert->data[pos + 1] == 0x04);
+  TRY(p256_be_to_le(&cert->data[pos + 2], kCoordBytes, pubkey->x));
+  TRY(p256_be_to_le(&cert->data[pos + 2 + kCoordBytes], kCoordBytes,
+                    pubkey->y));
+  return OK_STATUS();
+}
+
+/**
+ * Checks the signature on `cert` against `pubkey`.
+ */
+static status_t cert_signature_check(const dice_cert_t *cert,
+                                     const ecdsa_p256_public_key_t *pubkey) {
+  size_t pos = 0;
+  size_t len;
+  TRY(der_header_read(cert, &pos, kAsn1TagNumberSequence, &len));
+  // The signature covers the whole TBS certificate, including its header.
+  size_t tbs_start = pos;
+  TRY(der_skip(cert, &pos, kAsn1TagNumberSequence));
+  hmac_digest_t tbs_digest;
+  hmac_sha256(&cert->data[tbs_start], pos - tbs_start, &tbs_digest);
+
+  TRY(der_skip(cert, &pos, kAsn1TagNumberSequence));
+  TRY(der_header_read(cert, &pos, kAsn1TagNumberBitString, &len));
+  TRY_CHECK(len > 0 && cert->data[pos] == 0);
+  ++pos;
+  TRY(der_header_read(cert, &pos, kAsn1TagNumberSequence, &len));
+  ecdsa_p256_signature_t sig;
+  TRY(der_header_read(cert, &pos, kAsn1TagNumberInteger, &len));
+  TRY(p256_be_to_le(&cert->data[pos], len, sig.r));
+  pos += len;
+  TRY(der_header_read(cert, &pos, kAsn1TagNumberInteger, &len));
+  TRY(p256_be_to_le(&cert->data[pos], len, sig.s));
+
+  uint32_t flash_exec = 0;
+  TRY(sigverify_ecdsa_p256_verify(&sig, pubkey, &tbs_digest, &flash_exec));
+  TRY_CHECK(flash_exec == kSigverifyEcdsaSuccess);
+  return OK_STATUS();
+}
+
+/**
+ * Checks that the CDI_1 certificate is endorsed by the CDI_0 key.
+ */
+static status_t cdi_1_endorsement_check(const dice_certs_t *certs) {
+  ecdsa_p256_public_key_t cdi_0_pubkey;
+  TRY(cert_pubkey_get(&certs->cdi_0, &cdi_0_pubkey));
+  TRY(cert_signature_check(&certs->cdi_1, &cdi_0_pubkey));
+  return OK_STATUS();
+}
+
+static status_t initialize(retention_sram_t *retram,
+                           cdi_1_regen_retram_t *state) {
+  TRY_CHECK(retram->creator.boot_log.bl0_slot == kBootSlotA);
+  dice_certs_t certs;
+  TRY(dice_certs_read(&certs));
+  TRY(cdi_1_endorsement_check(&certs));
+  hmac_sha256(certs.cdi_0.data, certs.cdi_0.size, &state->cdi_0_cert_digest);
+  hmac_sha256(certs.cdi_1.data, certs.cdi_1.size, &state->cdi_1_cert_digest);
+
+  boot_svc_msg_t msg = {0};
+  boot_svc_next_boot_bl0_slot_req_init(
+      /*primary_slot=*/kBootSlotUnspecified,
+      /*next_slot=*/kBootSlotB, &msg.next_boot_bl0_slot_req);
+  retram->creator.boot_svc_msg = msg;
+  state->state = kCdi1RegenTestStateCheckSideB;
+  rstmgr_reset();
+  return INTERNAL();
+}
+
+static status_t check_side_b(retention_sram_t *retram,
+                             cdi_1_regen_retram_t *state) {
+  TRY_CHECK(retram->creator.boot_log.bl0_slot == kBootSlotB);
+  dice_certs_t certs;
+  TRY(dice_certs_read(&certs));
+  hmac_digest_t cdi_0_cert_digest;
+  hmac_digest_t cdi_1_cert_digest;
+  hmac_sha256(certs.cdi_0.data, certs.cdi_0.size, &cdi_0_cert_digest);
+  hmac_sha256(certs.cdi_1.data, certs.cdi_1.size, &cdi_1_cert_digest);
+  TRY_CHECK(memcmp(&cdi_0_cert_digest, &state->cdi_0_cert_digest,
+                   sizeof(cdi_0_cert_digest)) == 0,
+            "CDI_0 certificate was not reused");
+  TRY_CHECK(memcmp(&cdi_1_cert_digest, &state->cdi_1_cert_digest,
+                   sizeof(cdi_1_cert_digest)) != 0,
+            "CDI_1 certificate was not regenerated");
+  TRY(cdi_1_endorsement_check(&certs));
+  return OK_STATUS();
+}
+
+static status_t cdi_1_regen_test(void) {
+  retention_sram_t *retram = retention_sram_get();
+  TRY(boot_log_check(&retram->creator.boot_log));
+  cdi_1_regen_retram_t *state = (cdi_1_regen_retram_t *)&retram->owner;
+  if (bitfield_bit32_read(retram->creator.reset_reasons,
+                          kRstmgrReasonPowerOn)) {
+    memset(&retram->owner, 0, sizeof(retram->owner));
+  }
+  TRY(otbn_boot_app_load());
+
+  LOG_INFO("Owner image %s, test state = %d", OWNER_IMAGE, state->state);
+  switch (state->state) {
+    case kCdi1RegenTestStateInit:
+      return initialize(retram, state);
+    case kCdi1RegenTestStateCheckSideB:
+      return check_side_b(retram, state);
+    default:
+      LOG_ERROR("Unknown state: %d", state->state);
+      return UNKNOWN();
+  }
+}
+
+bool test_main(void) {
+  status_t sts = cdi_1_regen_test();
+  if (status_err(sts)) {
+    LOG_ERROR("cdi_1_regen_test: %r", sts);
+  }
+  return status_ok(sts);
+}
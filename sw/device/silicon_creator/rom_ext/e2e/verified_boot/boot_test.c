@@ -32,7 +32,20 @@ status_t boot_log_print(boot_log_t *boot_log) {
   return OK_STATUS();
 }
 
+void boot_timing_print(const boot_timing_t *boot_timing) {
+  if (boot_timing->identifier != kBootTimingIdentifier) {
+    LOG_INFO("boot_timing not initialized");
+    return;
+  }
+  for (size_t i = 0; i < kBootTimingMilestoneCount; ++i) {
+    if (boot_timing->milestones[i] != 0) {
+      LOG_INFO("boot_timing milestone %u = %u", i, boot_timing->milestones[i]);
+    }
+  }
+}
+
 bool test_main(void) {
+  boot_timing_print(&retention_sram_get()->creator.boot_timing);
   status_t sts = boot_log_print(&retention_sram_get()->creator.boot_log);
   if (status_err(sts)) {
     LOG_ERROR("boot_log_print: %r", sts);
@@ -17,6 +17,7 @@
 #include "sw/device/silicon_creator/lib/base/util.h"
 #include "sw/device/silicon_creator/lib/boot_data.h"
 #include "sw/device/silicon_creator/lib/boot_log.h"
+#include "sw/device/silicon_creator/lib/boot_timing.h"
 #include "sw/device/silicon_creator/lib/boot_svc/boot_svc_empty.h"
 #include "sw/device/silicon_creator/lib/boot_svc/boot_svc_header.h"
 #include "sw/device/silicon_creator/lib/boot_svc/boot_svc_msg.h"
@@ -48,6 +49,7 @@
 #include "sw/device/silicon_creator/lib/sigverify/ecdsa_p256_key.h"
 #include "sw/device/silicon_creator/lib/sigverify/rsa_verify.h"
 #include "sw/device/silicon_creator/lib/sigverify/sigverify.h"
+#include "sw/device/silicon_creator/lib/stack_utilization.h"
 #include "sw/device/silicon_creator/rom_ext/rescue.h"
 #include "sw/device/silicon_creator/rom_ext/rom_ext_boot_policy.h"
 #include "sw/device/silicon_creator/rom_ext/rom_ext_boot_policy_ptrs.h"
@@ -235,6 +237,8 @@ void rom_ext_sram_exec(hardened_bool_t enable) {
 OT_WARN_UNUSED_RESULT
 static rom_error_t rom_ext_verify(const manifest_t *manifest,
                                   const boot_data_t *boot_data) {
+  boot_timing_record(&retention_sram_get()->creator.boot_timing,
+                     kBootTimingRomExtVerify);
   RETURN_IF_ERROR(rom_ext_boot_policy_manifest_check(manifest, boot_data));
   const sigverify_rsa_key_t *key;
   RETURN_IF_ERROR(sigverify_rsa_key_get(
@@ -421,7 +425,15 @@ static rom_error_t rom_ext_attestation_creator(
     memset(&dice_certs_page[dice_certs_page_offset], UINT8_MAX,
            FLASH_CTRL_PARAM_BYTES_PER_PAGE - dice_certs_page_offset);
   } else {
+    HARDENED_CHECK_EQ(cert_valid, kHardenedBoolTrue);
     rom_ext_attestation_increment_cert_offset(cert_size);
+    // The cached CDI_0 cert is reused, but the CDI_1 cert may still need to be
+    // regenerated once the keymgr has advanced past this stage, so save the
+    // CDI_0 private key to endorse it. `dice_cdi_0_cert_build()` does this when
+    // the cert is regenerated.
+    HARDENED_RETURN_IF_ERROR(otbn_boot_attestation_key_save(
+        kDiceKeyCdi0.keygen_seed_idx, kDiceKeyCdi0.type,
+        *kDiceKeyCdi0.keymgr_diversifier));
   }
   return kErrorOk;
 }
@@ -490,6 +502,8 @@ static rom_error_t rom_ext_boot(const manifest_t *manifest) {
         /*word_count=*/FLASH_CTRL_PARAM_BYTES_PER_PAGE / sizeof(uint32_t),
         dice_certs_page));
   }
+  boot_timing_t *boot_timing = &retention_sram_get()->creator.boot_timing;
+  boot_timing_record(boot_timing, kBootTimingRomExtCertsDone);
 
   // Remove write and erase access to the certificate pages before handing over
   // execution to the owner firmware (owner firmware can still read).
@@ -504,26 +518,33 @@ static rom_error_t rom_ext_boot(const manifest_t *manifest) {
   SEC_MMIO_WRITE_INCREMENT(kFlashCtrlSecMmioCreatorInfoPagesLockdown +
                            kOtpSecMmioCreatorSwCfgLockDown);
 
+  // Build the ROM_EXT ePMP layout in an image and apply it in one pass. The
+  // new regions all live in entries 9-15, above the entries configured by the
+  // ROM, so applying the image from the highest entry down keeps the ROM_EXT
+  // code, RAM and MMIO accessible throughout.
+  epmp_state_t epmp_image = epmp_state;
+
   // ePMP region 15 gives read/write access to RAM.
-  rom_ext_epmp_set_napot(15, kRamRegion, kEpmpPermReadWrite);
+  rom_ext_epmp_image_napot(&epmp_image, 15, kRamRegion, kEpmpPermReadWrite);
 
   // Reconfigure the ePMP MMIO region to be NAPOT region 14, thus freeing
   // up an ePMP entry for use elsewhere.
-  rom_ext_epmp_set_napot(14, kMmioRegion, kEpmpPermReadWrite);
+  rom_ext_epmp_image_napot(&epmp_image, 14, kMmioRegion, kEpmpPermReadWrite);
 
   // ePMP region 13 allows RvDM access.
   if (lc_state == kLcStateProd || lc_state == kLcStateProdEnd) {
     // No RvDM access in Prod states, so we can clear the entry.
-    rom_ext_epmp_clear(13);
+    rom_ext_epmp_image_clear(&epmp_image, 13);
   } else {
-    rom_ext_epmp_set_napot(13, kRvDmRegion, kEpmpPermReadWriteExecute);
+    rom_ext_epmp_image_napot(&epmp_image, 13, kRvDmRegion,
+                             kEpmpPermReadWriteExecute);
   }
 
   // ePMP region 12 gives read access to all of flash for both M and U modes.
   // The flash access was in ePMP region 5.  Clear it so it doesn't take
   // priority over 12.
-  rom_ext_epmp_set_napot(12, kFlashRegion, kEpmpPermReadOnly);
-  rom_ext_epmp_clear(5);
+  rom_ext_epmp_image_napot(&epmp_image, 12, kFlashRegion, kEpmpPermReadOnly);
+  rom_ext_epmp_image_clear(&epmp_image, 5);
 
   // Move the ROM_EXT TOR region from entries 3/4/6 to 9/10/11.
   // If the ROM_EXT is located in the virtual window, the ROM will have
@@ -545,16 +566,18 @@ static rom_error_t rom_ext_boot(const manifest_t *manifest) {
     vwindow = (vwindow & ~(size - 1)) << 2;
     size <<= 3;
 
-    rom_ext_epmp_set_napot(
-        11, (epmp_region_t){.start = vwindow, .end = vwindow + size},
+    rom_ext_epmp_image_napot(
+        &epmp_image, 11,
+        (epmp_region_t){.start = vwindow, .end = vwindow + size},
         kEpmpPermReadOnly);
   }
-  rom_ext_epmp_set_tor(rxindex,
-                       (epmp_region_t){.start = start << 2, .end = end << 2},
-                       kEpmpPermReadExecute);
+  rom_ext_epmp_image_tor(&epmp_image, rxindex,
+                         (epmp_region_t){.start = start << 2, .end = end << 2},
+                         kEpmpPermReadExecute);
   for (int8_t i = (int8_t)rxindex - 1; i >= 0; --i) {
-    rom_ext_epmp_clear((uint8_t)i);
+    rom_ext_epmp_image_clear(&epmp_image, (uint8_t)i);
   }
+  rom_ext_epmp_image_apply(&epmp_image);
   HARDENED_RETURN_IF_ERROR(epmp_state_check());
 
   // Configure address translation, compute the epmp regions and the entry
@@ -628,8 +651,12 @@ static rom_error_t rom_ext_boot(const manifest_t *manifest) {
   // to know if it's allowed to used the CSRNG and OTP is locked down.
   sec_mmio_check_values_except_otp(/*rnd_uint32()*/ 0,
                                    TOP_EARLGREY_OTP_CTRL_CORE_BASE_ADDR);
+  // Owner code starts with an empty instruction cache (see ibex.h), whether
+  // or not the ROM_EXT rewrote any of its flash during this boot.
+  ibex_icache_invalidate();
   // Jump to OWNER entry point.
   dbg_printf("entry: 0x%x\r\n", (unsigned int)entry_point);
+  boot_timing_record(boot_timing, kBootTimingRomExtJump);
   ((owner_stage_entry_point *)entry_point)();
 
   return kErrorRomExtBootFailed;
@@ -786,6 +813,8 @@ static rom_error_t rom_ext_try_next_stage(boot_data_t *boot_data) {
     if (error != kErrorOk) {
       continue;
     }
+    boot_timing_record(&retention_sram_get()->creator.boot_timing,
+                       kBootTimingRomExtVerifyDone);
 
     boot_log_t *boot_log = &retention_sram_get()->creator.boot_log;
     if (manifests.ordered[i] == rom_ext_boot_policy_manifest_a_get()) {
@@ -795,6 +824,7 @@ static rom_error_t rom_ext_try_next_stage(boot_data_t *boot_data) {
     } else {
       return kErrorRomExtBootFailed;
     }
+    boot_log->rom_ext_stack_used = stack_utilization_get();
     boot_log_digest_update(boot_log);
 
     // Boot fails if a verified ROM_EXT cannot be booted.
@@ -816,7 +846,8 @@ static rom_error_t rom_ext_try_next_stage(boot_data_t *boot_data) {
   return error;
 }
 
-static rom_error_t rom_ext_start(boot_data_t *boot_data, boot_log_t *boot_log) {
+static rom_error_t rom_ext_start(boot_data_t *boot_data, boot_log_t *boot_log,
+                                 uint32_t rom_stack_used) {
   HARDENED_RETURN_IF_ERROR(rom_ext_init(boot_data));
   const manifest_t *self = rom_ext_manifest();
   dbg_printf("Starting ROM_EXT %u.%u\r\n", self->version_major,
@@ -827,9 +858,14 @@ static rom_error_t rom_ext_start(boot_data_t *boot_data, boot_log_t *boot_log) {
   flash_ctrl_cert_info_page_creator_cfg(&kFlashCtrlInfoPageDiceCerts);
   HARDENED_RETURN_IF_ERROR(rom_ext_buffer_dice_certs_into_ram());
 
-  // Establish our identity.
+  // Establish our identity. Reuse the OTBN boot services app loaded by ROM
+  // unless it was disturbed since.
+  HARDENED_RETURN_IF_ERROR(
+      otbn_boot_app_resume(&retention_sram_get()->creator.otbn_app));
   HARDENED_RETURN_IF_ERROR(rom_ext_attestation_silicon());
   HARDENED_RETURN_IF_ERROR(rom_ext_attestation_creator(self));
+  boot_timing_record(&retention_sram_get()->creator.boot_timing,
+                     kBootTimingRomExtAttestationDone);
 
   // Initialize the boot_log in retention RAM.
   const chip_info_t *rom_chip_info = (const chip_info_t *)_chip_info_start;
@@ -843,6 +879,7 @@ static rom_error_t rom_ext_start(boot_data_t *boot_data, boot_log_t *boot_log) {
   boot_log->rom_ext_min_sec_ver = boot_data->min_security_version_rom_ext;
   boot_log->bl0_min_sec_ver = boot_data->min_security_version_bl0;
   boot_log->primary_bl0_slot = boot_data->primary_bl0_slot;
+  boot_log->rom_stack_used = rom_stack_used;
 
   // Initialize the chip ownership state.
   HARDENED_RETURN_IF_ERROR(ownership_init());
@@ -865,9 +902,13 @@ static rom_error_t rom_ext_start(boot_data_t *boot_data, boot_log_t *boot_log) {
   // Re-sync the boot_log entries that could be changed by boot services.
   boot_log->rom_ext_nonce = boot_data->nonce;
   boot_log->ownership_state = boot_data->ownership_state;
-  boot_log_digest_update(boot_log);
 
-  if (uart_break_detect(kRescueDetectTime) == kHardenedBoolTrue) {
+  // Let the HMAC block digest the boot_log while we wait for a UART break.
+  boot_log_digest_update_start(boot_log);
+  hardened_bool_t rescue = uart_break_detect(kRescueDetectTime);
+  boot_log_digest_update_finish(boot_log);
+
+  if (rescue == kHardenedBoolTrue) {
     dbg_printf("rescue: remember to clear break\r\n");
     uart_enable_receiver();
     error = rescue_protocol();
@@ -878,11 +919,22 @@ static rom_error_t rom_ext_start(boot_data_t *boot_data, boot_log_t *boot_log) {
 }
 
 void rom_ext_main(void) {
+  // A ROM that predates the boot_timing leaves the area uninitialized.
+  boot_timing_t *boot_timing = &retention_sram_get()->creator.boot_timing;
+  if (boot_timing->identifier != kBootTimingIdentifier) {
+    memset(boot_timing, 0, sizeof(*boot_timing));
+    boot_timing->identifier = kBootTimingIdentifier;
+  }
+  boot_timing_record(boot_timing, kBootTimingRomExtStart);
+  // The ROM_EXT reuses the ROM's stack. Record the ROM's high-water mark and
+  // re-arm the free pattern to measure the ROM_EXT's own usage.
+  uint32_t rom_stack_used = stack_utilization_get();
+  stack_utilization_reset();
   rom_ext_check_rom_expectations();
   boot_data_t boot_data;
   boot_log_t *boot_log = &retention_sram_get()->creator.boot_log;
 
-  rom_error_t error = rom_ext_start(&boot_data, boot_log);
+  rom_error_t error = rom_ext_start(&boot_data, boot_log, rom_stack_used);
   if (error == kErrorWriteBootdataThenReboot) {
     HARDENED_CHECK_EQ(error, kErrorWriteBootdataThenReboot);
     error = boot_data_write(&boot_data);
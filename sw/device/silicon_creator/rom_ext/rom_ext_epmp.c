@@ -7,6 +7,7 @@
 #include "sw/device/lib/base/bitfield.h"
 #include "sw/device/lib/base/csr.h"
 #include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/macros.h"
 #include "sw/device/silicon_creator/lib/epmp_state.h"
 
 #include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
@@ -49,12 +50,39 @@ static void rom_ext_epmp_set(uint8_t entry, uint32_t pmpcfg, uint32_t pmpaddr) {
   epmp_state.pmpaddr[entry] = pmpaddr;
 }
 
-void rom_ext_epmp_clear(uint8_t entry) {
-  rom_ext_epmp_set(entry, kEpmpModeOff, 0);
+/**
+ * Writes the configuration of an entry into an ePMP image.
+ *
+ * @param image ePMP image to update.
+ * @param entry The ePMP entry to configure.
+ * @param pmpcfg The 8-bit configuration value of the entry.
+ * @param pmpaddr The address register value of the entry.
+ */
+static void image_set(epmp_state_t *image, uint8_t entry, uint32_t pmpcfg,
+                      uint32_t pmpaddr) {
+  HARDENED_CHECK_LT(entry, kEpmpNumRegions);
+  uint32_t shift = 8 * (entry % 4);
+  uint32_t mask = 0xFFu << shift;
+  uint32_t cfgent = entry / 4;
+  image->pmpcfg[cfgent] =
+      (image->pmpcfg[cfgent] & ~mask) | ((pmpcfg & 0xFFu) << shift);
+  image->pmpaddr[entry] = pmpaddr;
 }
 
-void rom_ext_epmp_set_napot(uint8_t entry, epmp_region_t region,
-                            epmp_perm_t perm) {
+void rom_ext_epmp_image_clear(epmp_state_t *image, uint8_t entry) {
+  image_set(image, entry, kEpmpModeOff, 0);
+}
+
+/**
+ * Computes the configuration of a NAPOT or NA4 region.
+ *
+ * @param region The address region to configure.
+ * @param perm The ePMP permissions for the region.
+ * @param[out] pmpcfg The 8-bit configuration value of the entry.
+ * @param[out] pmpaddr The address register value of the entry.
+ */
+static void napot_encode(epmp_region_t region, epmp_perm_t perm,
+                         uint32_t *pmpcfg, uint32_t *pmpaddr) {
   uint32_t length = region.end - region.start;
   // The length must be 4 or more.
   HARDENED_CHECK_GE(length, 4);
@@ -63,8 +91,68 @@ void rom_ext_epmp_set_napot(uint8_t entry, epmp_region_t region,
   // The start address must be naturally aligned with length.
   HARDENED_CHECK_EQ(region.start & (length - 1), 0);
   epmp_mode_t mode = length == 4 ? kEpmpModeNa4 : kEpmpModeNapot;
-  uint32_t addr = (region.start >> 2) | ((length - 1) >> 3);
-  rom_ext_epmp_set(entry, (uint32_t)mode | (uint32_t)perm, addr);
+  *pmpcfg = (uint32_t)mode | (uint32_t)perm;
+  *pmpaddr = (region.start >> 2) | ((length - 1) >> 3);
+}
+
+void rom_ext_epmp_image_napot(epmp_state_t *image, uint8_t entry,
+                              epmp_region_t region, epmp_perm_t perm) {
+  uint32_t pmpcfg, pmpaddr;
+  napot_encode(region, perm, &pmpcfg, &pmpaddr);
+  image_set(image, entry, pmpcfg, pmpaddr);
+}
+
+void rom_ext_epmp_image_tor(epmp_state_t *image, uint8_t entry,
+                            epmp_region_t region, epmp_perm_t perm) {
+  uint32_t start = region.start >> 2;
+  uint32_t end = ((region.end + 3u) & ~3u) >> 2;
+  image_set(image, entry, kEpmpModeOff, start);
+  image_set(image, entry + 1, (uint32_t)kEpmpModeTor | (uint32_t)perm, end);
+}
+
+void rom_ext_epmp_image_apply(const epmp_state_t *image) {
+  // Entries are written from the highest to the lowest one, one `pmpcfg`
+  // register at a time, so that regions added to high entries take effect
+  // before the lower entries that currently grant the same access are
+  // replaced.
+  CSR_WRITE(CSR_REG_PMPADDR15, image->pmpaddr[15]);
+  CSR_WRITE(CSR_REG_PMPADDR14, image->pmpaddr[14]);
+  CSR_WRITE(CSR_REG_PMPADDR13, image->pmpaddr[13]);
+  CSR_WRITE(CSR_REG_PMPADDR12, image->pmpaddr[12]);
+  CSR_WRITE(CSR_REG_PMPCFG3, image->pmpcfg[3]);
+  CSR_WRITE(CSR_REG_PMPADDR11, image->pmpaddr[11]);
+  CSR_WRITE(CSR_REG_PMPADDR10, image->pmpaddr[10]);
+  CSR_WRITE(CSR_REG_PMPADDR9, image->pmpaddr[9]);
+  CSR_WRITE(CSR_REG_PMPADDR8, image->pmpaddr[8]);
+  CSR_WRITE(CSR_REG_PMPCFG2, image->pmpcfg[2]);
+  CSR_WRITE(CSR_REG_PMPADDR7, image->pmpaddr[7]);
+  CSR_WRITE(CSR_REG_PMPADDR6, image->pmpaddr[6]);
+  CSR_WRITE(CSR_REG_PMPADDR5, image->pmpaddr[5]);
+  CSR_WRITE(CSR_REG_PMPADDR4, image->pmpaddr[4]);
+  CSR_WRITE(CSR_REG_PMPCFG1, image->pmpcfg[1]);
+  CSR_WRITE(CSR_REG_PMPADDR3, image->pmpaddr[3]);
+  CSR_WRITE(CSR_REG_PMPADDR2, image->pmpaddr[2]);
+  CSR_WRITE(CSR_REG_PMPADDR1, image->pmpaddr[1]);
+  CSR_WRITE(CSR_REG_PMPADDR0, image->pmpaddr[0]);
+  CSR_WRITE(CSR_REG_PMPCFG0, image->pmpcfg[0]);
+
+  for (size_t i = 0; i < ARRAYSIZE(epmp_state.pmpcfg); ++i) {
+    epmp_state.pmpcfg[i] = image->pmpcfg[i];
+  }
+  for (size_t i = 0; i < ARRAYSIZE(epmp_state.pmpaddr); ++i) {
+    epmp_state.pmpaddr[i] = image->pmpaddr[i];
+  }
+}
+
+void rom_ext_epmp_clear(uint8_t entry) {
+  rom_ext_epmp_set(entry, kEpmpModeOff, 0);
+}
+
+void rom_ext_epmp_set_napot(uint8_t entry, epmp_region_t region,
+                            epmp_perm_t perm) {
+  uint32_t pmpcfg, pmpaddr;
+  napot_encode(region, perm, &pmpcfg, &pmpaddr);
+  rom_ext_epmp_set(entry, pmpcfg, pmpaddr);
 }
 
 void rom_ext_epmp_set_tor(uint8_t entry, epmp_region_t region,
@@ -76,6 +76,57 @@ void rom_ext_epmp_set_napot(uint8_t entry, epmp_region_t region,
 void rom_ext_epmp_set_tor(uint8_t entry, epmp_region_t region,
                           epmp_perm_t perm);
 
+/**
+ * Clears an entry in an ePMP image.
+ *
+ * Only `image` is modified; see `rom_ext_epmp_image_apply()`.
+ *
+ * @param image ePMP image to update.
+ * @param entry The ePMP entry to clear.
+ */
+void rom_ext_epmp_image_clear(epmp_state_t *image, uint8_t entry);
+
+/**
+ * Configures an entry in an ePMP image for a NAPOT or NA4 region.
+ *
+ * Same requirements as `rom_ext_epmp_set_napot()`, but only `image` is
+ * modified.
+ *
+ * @param image ePMP image to update.
+ * @param entry The ePMP entry to configure.
+ * @param region The address region to configure.
+ * @param perm The ePMP permissions for the region.
+ */
+void rom_ext_epmp_image_napot(epmp_state_t *image, uint8_t entry,
+                              epmp_region_t region, epmp_perm_t perm);
+
+/**
+ * Configures entries in an ePMP image for a TOR region.
+ *
+ * Same as `rom_ext_epmp_set_tor()`, but only `image` is modified.
+ *
+ * @param image ePMP image to update.
+ * @param entry The ePMP entry to configure.
+ * @param region The address region to configure.
+ * @param perm The ePMP permissions for the region.
+ */
+void rom_ext_epmp_image_tor(epmp_state_t *image, uint8_t entry,
+                            epmp_region_t region, epmp_perm_t perm);
+
+/**
+ * Writes the address and configuration registers of an ePMP image to the
+ * hardware and to `epmp_state`.
+ *
+ * Registers are written in a single pass from entry 15 down to entry 0, so
+ * the image must be laid out such that every region needed while the image is
+ * being applied (e.g. the code that is running) is granted by a higher entry
+ * in the new image or by a lower entry in the current configuration. `mseccfg`
+ * is not modified.
+ *
+ * @param image ePMP image to apply.
+ */
+void rom_ext_epmp_image_apply(const epmp_state_t *image);
+
 /**
  * Clear the rule-locking-bypass (RLB) bit.
  *
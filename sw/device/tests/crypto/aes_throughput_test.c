@@ -0,0 +1,267 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/crypto/drivers/entropy.h"
+#include "sw/device/lib/crypto/impl/integrity.h"
+#include "sw/device/lib/crypto/impl/keyblob.h"
+#include "sw/device/lib/crypto/include/aes.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('t', 's', 't')
+
+// Measures the throughput of AES-128 encryption in ECB, CBC, CTR and GCM
+// modes for a few message sizes, and of streaming AES-128-GCM encryption for
+// messages of up to 64 KiB.
+
+enum {
+  kAesBlockBytes = 128 / 8,
+  kAesBlockWords = kAesBlockBytes / sizeof(uint32_t),
+  kAes128KeyBytes = 128 / 8,
+  kGcmIvWords = 96 / 32,
+  kGcmTagWords = 128 / 32,
+  /**
+   * Size of the largest message encrypted.
+   */
+  kMaxMessageBytes = 4096,
+  /**
+   * Size of the largest message encrypted with the streaming GCM API. The
+   * message is passed in chunks of at most `kMaxMessageBytes`.
+   */
+  kMaxStreamingMessageBytes = 64 * 1024,
+};
+
+/**
+ * Message sizes to measure, in bytes.
+ */
+static const size_t kMessageSizes[] = {kAesBlockBytes, 256, 1024,
+                                       kMaxMessageBytes};
+
+/**
+ * Message sizes to measure with the streaming GCM API, in bytes.
+ */
+static const size_t kStreamingMessageSizes[] = {
+    64, 1024, kMaxMessageBytes, 16 * 1024, kMaxStreamingMessageBytes};
+
+static const uint32_t kKey[] = {0x03020100, 0x07060504, 0x0b0a0908,
+                                0x0f0e0d0c};
+static const uint32_t kKeyMask[] = {0x1b81540c, 0x220733c9, 0x8bf85383,
+                                    0x05ab50b4};
+
+static uint8_t plaintext[kMaxMessageBytes];
+static uint32_t ciphertext[kMaxMessageBytes / sizeof(uint32_t)];
+
+/**
+ * Build the configuration of an AES-128 key for the given key mode.
+ *
+ * @param key_mode Key mode.
+ * @return Key configuration.
+ */
+static otcrypto_key_config_t make_key_config(otcrypto_key_mode_t key_mode) {
+  return (otcrypto_key_config_t){
+      .version = kOtcryptoLibVersion1,
+      .key_mode = key_mode,
+      .key_length = kAes128KeyBytes,
+      .hw_backed = kHardenedBoolFalse,
+      .security_level = kOtcryptoKeySecurityLevelLow,
+  };
+}
+
+/**
+ * Log the throughput of one measurement.
+ *
+ * @param name Name of the mode for logs.
+ * @param message_len Length of the message in bytes.
+ * @param cycles Number of cycles the encryption took.
+ */
+static void log_throughput(const char *name, size_t message_len,
+                           uint32_t cycles) {
+  LOG_INFO("%s, %u bytes: %u cycles (%u cycles/byte)", name,
+           (uint32_t)message_len, cycles, cycles / (uint32_t)message_len);
+}
+
+/**
+ * Measure AES encryption in a block cipher mode across all message sizes.
+ *
+ * @param aes_mode Block cipher mode.
+ * @param key_mode Matching key mode.
+ * @param name Name of the mode for logs.
+ * @return OK or error.
+ */
+static status_t aes_throughput_test(otcrypto_aes_mode_t aes_mode,
+                                    otcrypto_key_mode_t key_mode,
+                                    const char *name) {
+  otcrypto_key_config_t config = make_key_config(key_mode);
+  uint32_t keyblob[keyblob_num_words(config)];
+  TRY(keyblob_from_key_and_mask(kKey, kKeyMask, config, keyblob));
+  otcrypto_blinded_key_t key = {
+      .config = config,
+      .keyblob_length = sizeof(keyblob),
+      .keyblob = keyblob,
+  };
+  key.checksum = integrity_blinded_checksum(&key);
+
+  for (size_t i = 0; i < ARRAYSIZE(kMessageSizes); i++) {
+    uint32_t iv_data[kAesBlockWords] = {0};
+    otcrypto_word32_buf_t iv = {
+        .data = iv_data,
+        .len = ARRAYSIZE(iv_data),
+    };
+    otcrypto_const_byte_buf_t input = {
+        .data = plaintext,
+        .len = kMessageSizes[i],
+    };
+    otcrypto_byte_buf_t output = {
+        .data = (unsigned char *)ciphertext,
+        .len = kMessageSizes[i],
+    };
+    uint64_t t_start = profile_start();
+    TRY(otcrypto_aes(&key, iv, aes_mode, kOtcryptoAesOperationEncrypt, input,
+                     kOtcryptoAesPaddingNull, output));
+    log_throughput(name, kMessageSizes[i], profile_end(t_start));
+  }
+  return OK_STATUS();
+}
+
+static status_t aes_ecb_throughput_test(void) {
+  return aes_throughput_test(kOtcryptoAesModeEcb, kOtcryptoKeyModeAesEcb,
+                             "AES-128-ECB");
+}
+
+static status_t aes_cbc_throughput_test(void) {
+  return aes_throughput_test(kOtcryptoAesModeCbc, kOtcryptoKeyModeAesCbc,
+                             "AES-128-CBC");
+}
+
+static status_t aes_ctr_throughput_test(void) {
+  return aes_throughput_test(kOtcryptoAesModeCtr, kOtcryptoKeyModeAesCtr,
+                             "AES-128-CTR");
+}
+
+static status_t aes_gcm_throughput_test(void) {
+  otcrypto_key_config_t config = make_key_config(kOtcryptoKeyModeAesGcm);
+  uint32_t keyblob[keyblob_num_words(config)];
+  TRY(keyblob_from_key_and_mask(kKey, kKeyMask, config, keyblob));
+  otcrypto_blinded_key_t key = {
+      .config = config,
+      .keyblob_length = sizeof(keyblob),
+      .keyblob = keyblob,
+  };
+  key.checksum = integrity_blinded_checksum(&key);
+
+  for (size_t i = 0; i < ARRAYSIZE(kMessageSizes); i++) {
+    uint32_t iv_data[kGcmIvWords] = {0};
+    otcrypto_const_word32_buf_t iv = {
+        .data = iv_data,
+        .len = ARRAYSIZE(iv_data),
+    };
+    otcrypto_const_byte_buf_t input = {
+        .data = plaintext,
+        .len = kMessageSizes[i],
+    };
+    otcrypto_const_byte_buf_t aad = {
+        .data = NULL,
+        .len = 0,
+    };
+    otcrypto_byte_buf_t output = {
+        .data = (unsigned char *)ciphertext,
+        .len = kMessageSizes[i],
+    };
+    uint32_t tag_data[kGcmTagWords];
+    otcrypto_word32_buf_t tag = {
+        .data = tag_data,
+        .len = ARRAYSIZE(tag_data),
+    };
+    uint64_t t_start = profile_start();
+    TRY(otcrypto_aes_gcm_encrypt(&key, input, iv, aad, kOtcryptoAesGcmTagLen128,
+                                 output, tag));
+    log_throughput("AES-128-GCM", kMessageSizes[i], profile_end(t_start));
+  }
+  return OK_STATUS();
+}
+
+static status_t aes_gcm_streaming_throughput_test(void) {
+  otcrypto_key_config_t config = make_key_config(kOtcryptoKeyModeAesGcm);
+  uint32_t keyblob[keyblob_num_words(config)];
+  TRY(keyblob_from_key_and_mask(kKey, kKeyMask, config, keyblob));
+  otcrypto_blinded_key_t key = {
+      .config = config,
+      .keyblob_length = sizeof(keyblob),
+      .keyblob = keyblob,
+  };
+  key.checksum = integrity_blinded_checksum(&key);
+
+  for (size_t i = 0; i < ARRAYSIZE(kStreamingMessageSizes); i++) {
+    uint32_t iv_data[kGcmIvWords] = {0};
+    otcrypto_const_word32_buf_t iv = {
+        .data = iv_data,
+        .len = ARRAYSIZE(iv_data),
+    };
+    uint32_t tag_data[kGcmTagWords];
+    otcrypto_word32_buf_t tag = {
+        .data = tag_data,
+        .len = ARRAYSIZE(tag_data),
+    };
+    otcrypto_aes_gcm_context_t ctx;
+    uint64_t t_start = profile_start();
+    TRY(otcrypto_aes_gcm_encrypt_init(&key, iv, &ctx));
+
+    // Encrypt the message one chunk at a time, overwriting the ciphertext of
+    // the previous chunk. The chunks are a multiple of the block size, so the
+    // output of each chunk is the same size as its input.
+    size_t remaining = kStreamingMessageSizes[i];
+    while (remaining > 0) {
+      size_t chunk_len =
+          remaining < kMaxMessageBytes ? remaining : kMaxMessageBytes;
+      otcrypto_const_byte_buf_t input = {
+          .data = plaintext,
+          .len = chunk_len,
+      };
+      otcrypto_byte_buf_t output = {
+          .data = (unsigned char *)ciphertext,
+          .len = chunk_len,
+      };
+      size_t output_len;
+      TRY(otcrypto_aes_gcm_update_encrypted_data(&ctx, input, output,
+                                                 &output_len));
+      TRY_CHECK(output_len == chunk_len);
+      remaining -= chunk_len;
+    }
+
+    otcrypto_byte_buf_t final_output = {
+        .data = (unsigned char *)ciphertext,
+        .len = kAesBlockBytes,
+    };
+    size_t final_output_len;
+    TRY(otcrypto_aes_gcm_encrypt_final(&ctx, kOtcryptoAesGcmTagLen128,
+                                       final_output, &final_output_len, tag));
+    log_throughput("AES-128-GCM streaming", kStreamingMessageSizes[i],
+                   profile_end(t_start));
+  }
+  return OK_STATUS();
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+// Holds the test result.
+static volatile status_t test_result;
+
+bool test_main(void) {
+  CHECK_STATUS_OK(entropy_complex_init());
+  for (size_t i = 0; i < sizeof(plaintext); i++) {
+    plaintext[i] = (uint8_t)(i * 7 + 1);
+  }
+
+  test_result = OK_STATUS();
+  EXECUTE_TEST(test_result, aes_ecb_throughput_test);
+  EXECUTE_TEST(test_result, aes_cbc_throughput_test);
+  EXECUTE_TEST(test_result, aes_ctr_throughput_test);
+  EXECUTE_TEST(test_result, aes_gcm_throughput_test);
+  EXECUTE_TEST(test_result, aes_gcm_streaming_throughput_test);
+  return status_ok(test_result);
+}
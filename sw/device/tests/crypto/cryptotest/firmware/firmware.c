@@ -33,38 +33,76 @@
 
 OTTF_DEFINE_TEST_CONFIG(.enable_uart_flow_control = true);
 
+/**
+ * Runs a single algorithm command whose vector follows on the console.
+ */
+static status_t dispatch_vector(ujson_t *uj, cryptotest_cmd_t cmd) {
+  switch (cmd) {
+    case kCryptotestCommandAes:
+      RESP_ERR(uj, handle_aes(uj));
+      break;
+    case kCryptotestCommandDrbg:
+      RESP_ERR(uj, handle_drbg(uj));
+      break;
+    case kCryptotestCommandEcdsa:
+      RESP_ERR(uj, handle_ecdsa(uj));
+      break;
+    case kCryptotestCommandEcdh:
+      RESP_ERR(uj, handle_ecdh(uj));
+      break;
+    case kCryptotestCommandHash:
+      RESP_ERR(uj, handle_hash(uj));
+      break;
+    case kCryptotestCommandHmac:
+      RESP_ERR(uj, handle_hmac(uj));
+      break;
+    case kCryptotestCommandKmac:
+      RESP_ERR(uj, handle_kmac(uj));
+      break;
+    case kCryptotestCommandSphincsPlus:
+      RESP_ERR(uj, handle_sphincsplus(uj));
+      break;
+    default:
+      LOG_ERROR("Unrecognized command: %d", cmd);
+      RESP_ERR(uj, INVALID_ARGUMENT());
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Runs `count` vectors of one algorithm back to back.
+ *
+ * The host streams the vectors without waiting for the individual responses;
+ * each vector is parsed as soon as the previous one has been answered, so
+ * the host-side turnaround between vectors is taken off the critical path.
+ * Every vector still produces its own response (or RESP_ERR) in order.
+ */
+static status_t handle_batch(ujson_t *uj) {
+  cryptotest_batch_t batch;
+  TRY(ujson_deserialize_cryptotest_batch_t(uj, &batch));
+  if (batch.command == kCryptotestCommandSetFormat ||
+      batch.command == kCryptotestCommandBatch) {
+    return INVALID_ARGUMENT();
+  }
+  for (uint32_t i = 0; i < batch.count; ++i) {
+    TRY(dispatch_vector(uj, batch.command));
+  }
+  return OK_STATUS();
+}
+
 status_t process_cmd(ujson_t *uj) {
   while (true) {
     cryptotest_cmd_t cmd;
     TRY(ujson_deserialize_cryptotest_cmd_t(uj, &cmd));
     switch (cmd) {
-      case kCryptotestCommandAes:
-        RESP_ERR(uj, handle_aes(uj));
-        break;
-      case kCryptotestCommandDrbg:
-        RESP_ERR(uj, handle_drbg(uj));
-        break;
-      case kCryptotestCommandEcdsa:
-        RESP_ERR(uj, handle_ecdsa(uj));
-        break;
-      case kCryptotestCommandEcdh:
-        RESP_ERR(uj, handle_ecdh(uj));
-        break;
-      case kCryptotestCommandHash:
-        RESP_ERR(uj, handle_hash(uj));
-        break;
-      case kCryptotestCommandHmac:
-        RESP_ERR(uj, handle_hmac(uj));
-        break;
-      case kCryptotestCommandKmac:
-        RESP_ERR(uj, handle_kmac(uj));
+      case kCryptotestCommandSetFormat:
+        RESP_ERR(uj, ujson_ottf_set_format(uj));
         break;
-      case kCryptotestCommandSphincsPlus:
-        RESP_ERR(uj, handle_sphincsplus(uj));
+      case kCryptotestCommandBatch:
+        RESP_ERR(uj, handle_batch(uj));
         break;
       default:
-        LOG_ERROR("Unrecognized command: %d", cmd);
-        RESP_ERR(uj, INVALID_ARGUMENT());
+        TRY(dispatch_vector(uj, cmd));
     }
   }
 
@@ -73,6 +111,6 @@ status_t process_cmd(ujson_t *uj) {
 
 bool test_main(void) {
   CHECK_STATUS_OK(entropy_complex_init());
-  ujson_t uj = ujson_ottf_console();
+  ujson_t uj = ujson_ottf_console_buffered();
   return status_ok(process_cmd(&uj));
 }
@@ -19,9 +19,16 @@ extern "C" {
     value(_, Hash) \
     value(_, Hmac) \
     value(_, Kmac) \
-    value(_, SphincsPlus)
+    value(_, SphincsPlus) \
+    value(_, SetFormat) \
+    value(_, Batch)
 UJSON_SERDE_ENUM(CryptotestCommand, cryptotest_cmd_t, COMMAND);
 
+#define BATCH(field, string) \
+    field(command, cryptotest_cmd_t) \
+    field(count, uint32_t)
+UJSON_SERDE_STRUCT(CryptotestBatch, cryptotest_batch_t, BATCH);
+
 // clang-format on
 
 #ifdef __cplusplus
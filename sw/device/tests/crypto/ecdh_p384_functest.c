@@ -7,6 +7,7 @@
 #include "sw/device/lib/crypto/include/ecc.h"
 #include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/testing/entropy_testutils.h"
+#include "sw/device/lib/testing/profile.h"
 #include "sw/device/lib/testing/test_framework/check.h"
 #include "sw/device/lib/testing/test_framework/ottf_main.h"
 
@@ -111,7 +112,9 @@ status_t key_exchange_test(void) {
   // Compute the shared secret from A's side of the computation (using A's
   // private key and B's public key).
   LOG_INFO("Generating shared secret (A)...");
+  uint64_t t_start = profile_start();
   TRY(otcrypto_ecdh(&private_keyA, &public_keyB, &kCurveP384, &shared_keyA));
+  profile_end_and_print(t_start, "ECDH/P-384 shared secret");
 
   // Compute the shared secret from B's side of the computation (using B's
   // private key and A's public key).
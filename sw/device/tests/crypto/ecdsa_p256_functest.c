@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/crypto/drivers/otbn.h"
 #include "sw/device/lib/crypto/impl/integrity.h"
 #include "sw/device/lib/crypto/impl/keyblob.h"
@@ -89,6 +90,41 @@ status_t sign_then_verify_test(hardened_bool_t *verification_result) {
       (otcrypto_const_word32_buf_t){.data = sig, .len = ARRAYSIZE(sig)},
       &kCurveP256, verification_result));
 
+  // Verify it again in a batch, next to a copy with a corrupted digest and a
+  // copy with a zero `r`, which OTBN rejects as invalid.
+  LOG_INFO("Verifying in a batch...");
+  uint32_t bad_digest_data[kSha256DigestWords];
+  memcpy(bad_digest_data, msg_digest_data, sizeof(bad_digest_data));
+  bad_digest_data[0] ^= 1;
+  otcrypto_hash_digest_t bad_digest = msg_digest;
+  bad_digest.data = bad_digest_data;
+  uint32_t zero_r_sig[kP256SignatureWords];
+  memcpy(zero_r_sig, sig, sizeof(zero_r_sig));
+  memset(zero_r_sig, 0, sizeof(zero_r_sig) / 2);
+  otcrypto_ecdsa_verify_item_t items[] = {
+      {
+          .public_key = &public_key,
+          .message_digest = msg_digest,
+          .signature = {.data = sig, .len = ARRAYSIZE(sig)},
+      },
+      {
+          .public_key = &public_key,
+          .message_digest = bad_digest,
+          .signature = {.data = sig, .len = ARRAYSIZE(sig)},
+      },
+      {
+          .public_key = &public_key,
+          .message_digest = msg_digest,
+          .signature = {.data = zero_r_sig, .len = ARRAYSIZE(zero_r_sig)},
+      },
+  };
+  hardened_bool_t results[ARRAYSIZE(items)];
+  CHECK_STATUS_OK(otcrypto_ecdsa_verify_batch(items, ARRAYSIZE(items),
+                                              &kCurveP256, results));
+  CHECK(results[0] == kHardenedBoolTrue);
+  CHECK(results[1] == kHardenedBoolFalse);
+  CHECK(results[2] == kHardenedBoolFalse);
+
   return OTCRYPTO_OK;
 }
 
@@ -10,6 +10,7 @@
 #include "sw/device/lib/crypto/include/hash.h"
 #include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/testing/entropy_testutils.h"
+#include "sw/device/lib/testing/profile.h"
 #include "sw/device/lib/testing/test_framework/check.h"
 #include "sw/device/lib/testing/test_framework/ottf_main.h"
 
@@ -78,16 +79,20 @@ status_t sign_then_verify_test(hardened_bool_t *verification_result) {
 
   // Generate a signature for the message.
   LOG_INFO("Signing...");
+  uint64_t t_start = profile_start();
   CHECK_STATUS_OK(otcrypto_ecdsa_sign(
       &private_key, msg_digest, &kCurveP384,
       (otcrypto_word32_buf_t){.data = sig, .len = ARRAYSIZE(sig)}));
+  profile_end_and_print(t_start, "ECDSA/P-384 sign");
 
   // Verify the signature.
   LOG_INFO("Verifying...");
+  t_start = profile_start();
   CHECK_STATUS_OK(otcrypto_ecdsa_verify(
       &public_key, msg_digest,
       (otcrypto_const_word32_buf_t){.data = sig, .len = ARRAYSIZE(sig)},
       &kCurveP384, verification_result));
+  profile_end_and_print(t_start, "ECDSA/P-384 verify");
 
   return OTCRYPTO_OK;
 }
@@ -0,0 +1,150 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/crypto/impl/status.h"
+#include "sw/device/lib/crypto/include/hash.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+// Measures the throughput of SHA-256/384/512 on the HMAC block, for one-shot
+// hashing and for streaming the same message in small updates, and checks
+// that both give the same digest.
+
+enum {
+  /**
+   * Size of the largest message hashed.
+   */
+  kMaxMessageBytes = 4096,
+  /**
+   * Size of the updates when streaming a message.
+   */
+  kUpdateBytes = 64,
+};
+
+/**
+ * Message sizes to measure, in bytes.
+ */
+static const size_t kMessageSizes[] = {64, 256, 1024, kMaxMessageBytes};
+
+static uint8_t message[kMaxMessageBytes];
+
+/**
+ * Hash `message_len` bytes of `message` in one call and log the throughput.
+ *
+ * @param name Name of the hash mode for logs.
+ * @param message_len Length of the message in bytes.
+ * @param[out] digest Digest of the message; its mode selects the hash.
+ * @return OK or error.
+ */
+static status_t oneshot_measure(const char *name, size_t message_len,
+                                otcrypto_hash_digest_t digest) {
+  otcrypto_const_byte_buf_t input = {
+      .data = message,
+      .len = message_len,
+  };
+  uint64_t t_start = profile_start();
+  TRY(otcrypto_hash(input, digest));
+  uint32_t cycles = profile_end(t_start);
+  LOG_INFO("%s one-shot, %u bytes: %u cycles (%u cycles/byte)", name,
+           (uint32_t)message_len, cycles, cycles / (uint32_t)message_len);
+  return OK_STATUS();
+}
+
+/**
+ * Hash `message_len` bytes of `message` in `kUpdateBytes`-byte updates and
+ * log the throughput.
+ *
+ * @param mode Hash mode.
+ * @param name Name of the hash mode for logs.
+ * @param message_len Length of the message in bytes.
+ * @param[out] digest Digest of the message.
+ * @return OK or error.
+ */
+static status_t streaming_measure(otcrypto_hash_mode_t mode, const char *name,
+                                  size_t message_len,
+                                  otcrypto_hash_digest_t digest) {
+  otcrypto_hash_context_t ctx;
+  uint64_t t_start = profile_start();
+  TRY(otcrypto_hash_init(&ctx, mode));
+  for (size_t i = 0; i < message_len; i += kUpdateBytes) {
+    otcrypto_const_byte_buf_t input = {
+        .data = &message[i],
+        .len = message_len - i < kUpdateBytes ? message_len - i : kUpdateBytes,
+    };
+    TRY(otcrypto_hash_update(&ctx, input));
+  }
+  TRY(otcrypto_hash_final(&ctx, digest));
+  uint32_t cycles = profile_end(t_start);
+  LOG_INFO("%s %u-byte updates, %u bytes: %u cycles (%u cycles/byte)", name,
+           (uint32_t)kUpdateBytes, (uint32_t)message_len, cycles,
+           cycles / (uint32_t)message_len);
+  return OK_STATUS();
+}
+
+/**
+ * Measure one hash mode across all message sizes.
+ *
+ * @param mode Hash mode.
+ * @param name Name of the hash mode for logs.
+ * @param digest_words Length of the digest in words.
+ * @return OK or error.
+ */
+static status_t hash_throughput_test(otcrypto_hash_mode_t mode,
+                                     const char *name, size_t digest_words) {
+  for (size_t i = 0; i < ARRAYSIZE(kMessageSizes); i++) {
+    uint32_t oneshot_data[kSha512DigestWords];
+    otcrypto_hash_digest_t oneshot = {
+        .data = oneshot_data,
+        .len = digest_words,
+        .mode = mode,
+    };
+    TRY(oneshot_measure(name, kMessageSizes[i], oneshot));
+
+    uint32_t streaming_data[kSha512DigestWords];
+    otcrypto_hash_digest_t streaming = {
+        .data = streaming_data,
+        .len = digest_words,
+        .mode = mode,
+    };
+    TRY(streaming_measure(mode, name, kMessageSizes[i], streaming));
+
+    TRY_CHECK_ARRAYS_EQ(streaming_data, oneshot_data, digest_words);
+  }
+  return OK_STATUS();
+}
+
+static status_t sha256_throughput_test(void) {
+  return hash_throughput_test(kOtcryptoHashModeSha256, "SHA-256",
+                              kSha256DigestWords);
+}
+
+static status_t sha384_throughput_test(void) {
+  return hash_throughput_test(kOtcryptoHashModeSha384, "SHA-384",
+                              kSha384DigestWords);
+}
+
+static status_t sha512_throughput_test(void) {
+  return hash_throughput_test(kOtcryptoHashModeSha512, "SHA-512",
+                              kSha512DigestWords);
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+// Holds the test result.
+static volatile status_t test_result;
+
+bool test_main(void) {
+  for (size_t i = 0; i < sizeof(message); i++) {
+    message[i] = (uint8_t)(i * 7 + 1);
+  }
+
+  test_result = OK_STATUS();
+  EXECUTE_TEST(test_result, sha256_throughput_test);
+  EXECUTE_TEST(test_result, sha384_throughput_test);
+  EXECUTE_TEST(test_result, sha512_throughput_test);
+  return status_ok(test_result);
+}
@@ -183,6 +183,33 @@ static status_t run_test(hkdf_test_vector_t *test) {
   }
   TRY_CHECK_ARRAYS_EQ((unsigned char *)unmasked_okm, (unsigned char *)test->okm,
                       test->okm_bytelen);
+
+  // Run the "expand" stage again through the batch API, deriving the same key
+  // twice, and check both outputs.
+  otcrypto_const_byte_buf_t infos[] = {info, info};
+  uint32_t batch_keyblobs[ARRAYSIZE(infos)][ARRAYSIZE(okm_keyblob)];
+  otcrypto_blinded_key_t batch_okms[] = {
+      {
+          .config = okm_config,
+          .keyblob = batch_keyblobs[0],
+          .keyblob_length = sizeof(okm_keyblob),
+      },
+      {
+          .config = okm_config,
+          .keyblob = batch_keyblobs[1],
+          .keyblob_length = sizeof(okm_keyblob),
+      },
+  };
+  TRY(otcrypto_kdf_hkdf_expand_batch(prk, infos, ARRAYSIZE(infos),
+                                     batch_okms));
+  for (size_t i = 0; i < ARRAYSIZE(batch_okms); i++) {
+    TRY(keyblob_to_shares(&batch_okms[i], &okm_share0, &okm_share1));
+    for (size_t j = 0; j < ARRAYSIZE(unmasked_okm); j++) {
+      unmasked_okm[j] = okm_share0[j] ^ okm_share1[j];
+    }
+    TRY_CHECK_ARRAYS_EQ((unsigned char *)unmasked_okm,
+                        (unsigned char *)test->okm, test->okm_bytelen);
+  }
   return OK_STATUS();
 }
 
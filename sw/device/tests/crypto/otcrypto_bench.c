@@ -0,0 +1,856 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/crypto/drivers/entropy.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
+#include "sw/device/lib/crypto/impl/integrity.h"
+#include "sw/device/lib/crypto/impl/keyblob.h"
+#include "sw/device/lib/crypto/include/aes.h"
+#include "sw/device/lib/crypto/include/drbg.h"
+#include "sw/device/lib/crypto/include/ecc.h"
+#include "sw/device/lib/crypto/include/hash.h"
+#include "sw/device/lib/crypto/include/kdf.h"
+#include "sw/device/lib/crypto/include/mac.h"
+#include "sw/device/lib/crypto/include/rsa.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/runtime/print.h"
+#include "sw/device/lib/testing/json/profile.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ujson_ottf.h"
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('t', 's', 't')
+
+// Benchmarks the `otcrypto_*` primitives.
+//
+// Every measured operation is a profiled region (see
+// sw/device/lib/testing/profile.h). Operations on a message are named
+// "<primitive>/<message bytes>". OTBN operations are named
+// "<primitive>/cold", for runs that start with OTBN IMEM wiped and so load
+// the application in full, and "<primitive>/warm", for runs right after a run
+// of the same application. Each group of primitives is sent over ujson as
+// `profile_region_t` responses once it is done, and the region table is then
+// cleared for the next group; the host derives the throughput from the mean
+// cycle count and the message size in the name. Operations on fixed inputs,
+// such as key wrapping and key derivation, are named after the size of the
+// key they wrap or derive. Batched hashing is measured on
+// `kHashBatchMessages` messages at a time, named "<primitive>_batch/<bytes>"
+// for one `otcrypto_hash_batch()` call and "<primitive>_loop/<bytes>" for the
+// same messages hashed with one `otcrypto_hash()` call each, where <bytes> is
+// the size of each message.
+//
+// Ed25519 and X25519 are not measured, since the library does not implement
+// them yet.
+
+enum {
+  /**
+   * Number of times each operation is run.
+   */
+  kBenchIterations = 4,
+  /**
+   * Size of the largest message processed.
+   */
+  kMaxMessageBytes = 4096,
+  /**
+   * Number of messages hashed by each batched hashing operation.
+   */
+  kHashBatchMessages = 16,
+  /**
+   * Size of the buffer for a region name, as sent in `profile_region_t`.
+   */
+  kRegionNameBytes = 48,
+  kAesBlockBytes = 128 / 8,
+  kAesBlockWords = kAesBlockBytes / sizeof(uint32_t),
+  kGcmIvWords = 96 / 32,
+  kGcmTagWords = 128 / 32,
+  kSha3_256DigestWords = 256 / 32,
+  kSymmetricKeyBytes = 256 / 8,
+  kSymmetricKeyWords = kSymmetricKeyBytes / sizeof(uint32_t),
+  kKdfOutputBytes = 256 / 8,
+  kP256PrivateKeyBytes = 256 / 8,
+  kP256PublicKeyWords = 512 / 32,
+  kP256SignatureWords = 512 / 32,
+  kRsa2048Words = 2048 / 32,
+};
+
+/**
+ * Message sizes to measure, in bytes.
+ */
+static const size_t kMessageSizes[] = {64, 1024, kMaxMessageBytes};
+/**
+ * Sizes of each message of a batch to measure, in bytes.
+ */
+static const size_t kHashBatchMessageSizes[] = {32, 64, 256, 1024};
+
+static const uint32_t kSymmetricKey[kSymmetricKeyWords] = {
+    0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c,
+    0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c,
+};
+static const uint32_t kSymmetricKeyMask[kSymmetricKeyWords] = {
+    0x1b81540c, 0x220733c9, 0x8bf85383, 0x05ab50b4,
+    0x8acdcb7e, 0x15e76440, 0x8459b2ce, 0xdc2110cc,
+};
+
+// RSA-2048 key pair, the same as in rsa_2048_signature_functest.
+static const uint32_t kRsaModulus[kRsa2048Words] = {
+    0x40d984b1, 0x3611356d, 0x9eb2f35c, 0x031a892c, 0x16354662, 0x6a260bad,
+    0xb2b807d6, 0xb7de7ccb, 0x278492e0, 0x41adab06, 0x9e60110f, 0x1414eeff,
+    0x8b80e14e, 0x5eb5ae79, 0x0d98fa5b, 0x58bece1f, 0xcf6bdca8, 0x82f5611f,
+    0x351e3869, 0x075005d6, 0xe813fe23, 0xdd967a37, 0x682d1c41, 0x9fdd2d8c,
+    0x21bdd5fc, 0x4fc459c7, 0x508c9293, 0x1f9ac759, 0x55aacb04, 0x58389f05,
+    0x0d0b00fb, 0x59bb4141, 0x68f9e0bf, 0xc2f1a546, 0x0a71ad19, 0x9c400301,
+    0xa4f8ecb9, 0xcdf39538, 0xaabe9cb0, 0xd9f7b2dc, 0x0e8b292d, 0x8ef6c717,
+    0x720e9520, 0xb0c6a23e, 0xda1e92b1, 0x8b6b4800, 0x2f25082b, 0x7f2d6711,
+    0x426fc94f, 0x9926ba5a, 0x89bd4d2b, 0x977718d5, 0x5a8406be, 0x87d090f3,
+    0x639f9975, 0x5948488b, 0x1d3d9cd7, 0x28c7956b, 0xebb97a3e, 0x1edbf4e2,
+    0x105cc797, 0x924ec514, 0x146810df, 0xb1ab4a49,
+};
+static const uint32_t kRsaPrivateExponent[kRsa2048Words] = {
+    0x0b19915b, 0xa6a935e6, 0x426b2e10, 0xb4ff0629, 0x7322343b, 0x3f28c8d5,
+    0x190757ce, 0x87409d6b, 0xd88e282b, 0x01c13c2a, 0xebb79189, 0x74cbeab9,
+    0x93de5d54, 0xae1bc80a, 0x083a75f2, 0xd574d229, 0xeb46696e, 0x7648cfb6,
+    0xe7ad1b36, 0xbd0e81b2, 0x19c72703, 0xebea5085, 0xf8c7d152, 0x34dcf84d,
+    0xa437187f, 0x41e4f88e, 0xe4e35f9f, 0xcd8bc6f8, 0x7f98e2f2, 0xffdf75ca,
+    0x3698226e, 0x903f2a56, 0xbf21a6dc, 0x97cbf653, 0xe9d80cb3, 0x55dc1685,
+    0xe0ebae21, 0xc8171e18, 0x8e73d26d, 0xbbdbaac1, 0x886e8007, 0x673c9da4,
+    0xe2cb0698, 0xa9f1ba2d, 0xedab4f0a, 0x197e890c, 0x65e7e736, 0x1de28f24,
+    0x57cf5137, 0x631ff441, 0x22539942, 0xcee3fd41, 0xd22b5f8a, 0x995dd87a,
+    0xcaa6815c, 0x08ca0fd3, 0x8f996093, 0x30b7c446, 0xf69b11f7, 0xa298dd00,
+    0xfd4e8120, 0x059df602, 0x25feb268, 0x0f3f749e,
+};
+static const uint32_t kRsaPublicExponent = 65537;
+
+static const otcrypto_ecc_curve_t kCurveP256 = {
+    .curve_type = kOtcryptoEccCurveTypeNistP256,
+    .domain_parameter = NULL,
+};
+
+static const otcrypto_const_byte_buf_t kEmptyBuffer = {
+    .data = NULL,
+    .len = 0,
+};
+
+static uint8_t message[kMaxMessageBytes];
+static uint32_t output[kMaxMessageBytes / sizeof(uint32_t)];
+
+// Names of the regions of the current group, which the region table points
+// to until it is cleared.
+static char region_names[kProfileMaxRegions][kRegionNameBytes];
+static size_t region_names_used;
+
+// ujson context for the results.
+static ujson_t uj;
+
+/**
+ * Start a group of measurements.
+ */
+static void group_begin(void) {
+  profile_init();
+  region_names_used = 0;
+}
+
+/**
+ * Send the results of the current group of measurements.
+ *
+ * @return OK or error.
+ */
+static status_t group_end(void) {
+  profile_print();
+  return profile_dump(&uj);
+}
+
+/**
+ * Get the region name for an operation on a message of the given size.
+ *
+ * @param primitive Name of the primitive.
+ * @param message_len Length of the message in bytes.
+ * @return Region name, valid until the next `group_begin()`.
+ */
+static const char *sized_region_name(const char *primitive,
+                                     size_t message_len) {
+  CHECK(region_names_used < kProfileMaxRegions, "Too many regions");
+  char *name = region_names[region_names_used++];
+  base_snprintf(name, kRegionNameBytes, "%s/%u", primitive,
+                (uint32_t)message_len);
+  return name;
+}
+
+/**
+ * An operation on the first `message_len` bytes of `message`.
+ */
+typedef status_t (*sized_op_t)(size_t message_len);
+
+/**
+ * An operation on fixed inputs.
+ */
+typedef status_t (*fixed_op_t)(void);
+
+/**
+ * Measure an operation on each of the given message sizes.
+ *
+ * @param primitive Name of the primitive.
+ * @param op Operation to measure.
+ * @param sizes Message sizes to measure, in bytes.
+ * @param num_sizes Number of elements in `sizes`.
+ * @return OK or error.
+ */
+static status_t bench_sizes(const char *primitive, sized_op_t op,
+                            const size_t *sizes, size_t num_sizes) {
+  for (size_t i = 0; i < num_sizes; i++) {
+    const char *name = sized_region_name(primitive, sizes[i]);
+    for (size_t j = 0; j < kBenchIterations; j++) {
+      profile_region_begin(name);
+      TRY(op(sizes[i]));
+      profile_region_end(name);
+    }
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Measure an operation on each of the message sizes.
+ *
+ * @param primitive Name of the primitive.
+ * @param op Operation to measure.
+ * @return OK or error.
+ */
+static status_t bench_sized(const char *primitive, sized_op_t op) {
+  return bench_sizes(primitive, op, kMessageSizes, ARRAYSIZE(kMessageSizes));
+}
+
+/**
+ * Measure an operation on fixed inputs.
+ *
+ * @param name Region name.
+ * @param op Operation to measure.
+ * @return OK or error.
+ */
+static status_t bench_fixed(const char *name, fixed_op_t op) {
+  for (size_t i = 0; i < kBenchIterations; i++) {
+    profile_region_begin(name);
+    TRY(op());
+    profile_region_end(name);
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Measure an OTBN operation with the application cold and warm.
+ *
+ * @param cold_name Region name for cold runs.
+ * @param warm_name Region name for warm runs.
+ * @param op Operation to measure.
+ * @return OK or error.
+ */
+static status_t bench_otbn(const char *cold_name, const char *warm_name,
+                           fixed_op_t op) {
+  for (size_t i = 0; i < kBenchIterations; i++) {
+    TRY(otbn_imem_sec_wipe());
+    profile_region_begin(cold_name);
+    TRY(op());
+    profile_region_end(cold_name);
+
+    profile_region_begin(warm_name);
+    TRY(op());
+    profile_region_end(warm_name);
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Build a blinded key from `kSymmetricKey` and `kSymmetricKeyMask`.
+ *
+ * @param key_mode Key mode.
+ * @param key_length Key length in bytes, at most `kSymmetricKeyBytes`.
+ * @param keyblob Buffer for the keyblob, `keyblob_num_words()` long.
+ * @return Blinded key.
+ */
+static otcrypto_blinded_key_t symmetric_key_make(otcrypto_key_mode_t key_mode,
+                                                 size_t key_length,
+                                                 uint32_t *keyblob) {
+  otcrypto_key_config_t config = {
+      .version = kOtcryptoLibVersion1,
+      .key_mode = key_mode,
+      .key_length = key_length,
+      .hw_backed = kHardenedBoolFalse,
+      .exportable = kHardenedBoolFalse,
+      .security_level = kOtcryptoKeySecurityLevelLow,
+  };
+  CHECK_STATUS_OK(keyblob_from_key_and_mask(kSymmetricKey, kSymmetricKeyMask,
+                                            config, keyblob));
+  otcrypto_blinded_key_t key = {
+      .config = config,
+      .keyblob_length = keyblob_num_words(config) * sizeof(uint32_t),
+      .keyblob = keyblob,
+  };
+  key.checksum = integrity_blinded_checksum(&key);
+  return key;
+}
+
+/**
+ * Hash `message_len` bytes of `message` with the given mode.
+ *
+ * @param mode Hash mode.
+ * @param digest_words Length of the digest in words.
+ * @param message_len Length of the message in bytes.
+ * @return OK or error.
+ */
+static status_t hash_op(otcrypto_hash_mode_t mode, size_t digest_words,
+                        size_t message_len) {
+  otcrypto_hash_digest_t digest = {
+      .data = output,
+      .len = digest_words,
+      .mode = mode,
+  };
+  return otcrypto_hash(
+      (otcrypto_const_byte_buf_t){.data = message, .len = message_len},
+      digest);
+}
+
+static status_t sha256_op(size_t message_len) {
+  return hash_op(kOtcryptoHashModeSha256, kSha256DigestWords, message_len);
+}
+
+static status_t sha384_op(size_t message_len) {
+  return hash_op(kOtcryptoHashModeSha384, kSha384DigestWords, message_len);
+}
+
+static status_t sha512_op(size_t message_len) {
+  return hash_op(kOtcryptoHashModeSha512, kSha512DigestWords, message_len);
+}
+
+static status_t sha3_256_op(size_t message_len) {
+  return hash_op(kOtcryptoHashModeSha3_256, kSha3_256DigestWords, message_len);
+}
+
+static status_t hash_bench(void) {
+  group_begin();
+  TRY(bench_sized("sha256", sha256_op));
+  TRY(bench_sized("sha384", sha384_op));
+  TRY(bench_sized("sha512", sha512_op));
+  TRY(bench_sized("sha3_256", sha3_256_op));
+  return group_end();
+}
+
+static otcrypto_hash_batch_item_t hash_batch_items[kHashBatchMessages];
+
+/**
+ * Hash `kHashBatchMessages` messages of `message_len` bytes in one batch.
+ *
+ * The messages are consecutive slices of `message`, wrapping around, and the
+ * digests are written one after the other to `output`.
+ *
+ * @param mode Hash mode.
+ * @param digest_words Length of each digest in words.
+ * @param message_len Length of each message in bytes.
+ * @return OK or error.
+ */
+static status_t hash_batch_op(otcrypto_hash_mode_t mode, size_t digest_words,
+                              size_t message_len) {
+  for (size_t i = 0; i < kHashBatchMessages; i++) {
+    size_t offset = (i * message_len) % (kMaxMessageBytes - message_len + 1);
+    hash_batch_items[i] = (otcrypto_hash_batch_item_t){
+        .message = message + offset,
+        .message_len = message_len,
+        .digest =
+            {
+                .mode = mode,
+                .data = output + i * digest_words,
+                .len = digest_words,
+            },
+    };
+  }
+  return otcrypto_hash_batch(hash_batch_items, kHashBatchMessages);
+}
+
+/**
+ * Hash the messages of `hash_batch_op()` with one `otcrypto_hash()` each.
+ *
+ * @param mode Hash mode.
+ * @param digest_words Length of each digest in words.
+ * @param message_len Length of each message in bytes.
+ * @return OK or error.
+ */
+static status_t hash_loop_op(otcrypto_hash_mode_t mode, size_t digest_words,
+                             size_t message_len) {
+  for (size_t i = 0; i < kHashBatchMessages; i++) {
+    size_t offset = (i * message_len) % (kMaxMessageBytes - message_len + 1);
+    otcrypto_hash_digest_t digest = {
+        .data = output + i * digest_words,
+        .len = digest_words,
+        .mode = mode,
+    };
+    TRY(otcrypto_hash(
+        (otcrypto_const_byte_buf_t){.data = message + offset,
+                                    .len = message_len},
+        digest));
+  }
+  return OK_STATUS();
+}
+
+static status_t sha256_batch_op(size_t message_len) {
+  return hash_batch_op(kOtcryptoHashModeSha256, kSha256DigestWords,
+                       message_len);
+}
+
+static status_t sha256_loop_op(size_t message_len) {
+  return hash_loop_op(kOtcryptoHashModeSha256, kSha256DigestWords,
+                      message_len);
+}
+
+static status_t sha3_256_batch_op(size_t message_len) {
+  return hash_batch_op(kOtcryptoHashModeSha3_256, kSha3_256DigestWords,
+                       message_len);
+}
+
+static status_t sha3_256_loop_op(size_t message_len) {
+  return hash_loop_op(kOtcryptoHashModeSha3_256, kSha3_256DigestWords,
+                      message_len);
+}
+
+static status_t hash_batch_bench(void) {
+  group_begin();
+  TRY(bench_sizes("sha256_batch", sha256_batch_op, kHashBatchMessageSizes,
+                  ARRAYSIZE(kHashBatchMessageSizes)));
+  TRY(bench_sizes("sha256_loop", sha256_loop_op, kHashBatchMessageSizes,
+                  ARRAYSIZE(kHashBatchMessageSizes)));
+  TRY(bench_sizes("sha3_256_batch", sha3_256_batch_op, kHashBatchMessageSizes,
+                  ARRAYSIZE(kHashBatchMessageSizes)));
+  TRY(bench_sizes("sha3_256_loop", sha3_256_loop_op, kHashBatchMessageSizes,
+                  ARRAYSIZE(kHashBatchMessageSizes)));
+  return group_end();
+}
+
+// Keys for the MAC benchmarks.
+static const otcrypto_blinded_key_t *hmac_key;
+static const otcrypto_blinded_key_t *kmac_key;
+
+static status_t hmac_sha256_op(size_t message_len) {
+  otcrypto_word32_buf_t tag = {
+      .data = output,
+      .len = kSha256DigestWords,
+  };
+  return otcrypto_hmac(
+      hmac_key,
+      (otcrypto_const_byte_buf_t){.data = message, .len = message_len}, tag);
+}
+
+static status_t kmac128_op(size_t message_len) {
+  otcrypto_word32_buf_t tag = {
+      .data = output,
+      .len = kSymmetricKeyWords,
+  };
+  return otcrypto_kmac(
+      kmac_key,
+      (otcrypto_const_byte_buf_t){.data = message, .len = message_len},
+      kOtcryptoKmacModeKmac128, kEmptyBuffer, kSymmetricKeyBytes, tag);
+}
+
+static status_t mac_bench(void) {
+  uint32_t hmac_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t hmac = symmetric_key_make(
+      kOtcryptoKeyModeHmacSha256, kSymmetricKeyBytes, hmac_keyblob);
+  hmac_key = &hmac;
+  uint32_t kmac_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t kmac = symmetric_key_make(
+      kOtcryptoKeyModeKmac128, kSymmetricKeyBytes, kmac_keyblob);
+  kmac_key = &kmac;
+
+  group_begin();
+  TRY(bench_sized("hmac_sha256", hmac_sha256_op));
+  TRY(bench_sized("kmac128", kmac128_op));
+  return group_end();
+}
+
+// Keys for the AES benchmarks. The library checks the key mode against the
+// block cipher mode, so `aes_key` is switched to a key of the right mode
+// before each one is measured.
+static const otcrypto_blinded_key_t *aes_key;
+static const otcrypto_blinded_key_t *kwp_key;
+static const otcrypto_blinded_key_t *kwp_key_to_wrap;
+
+/**
+ * Encrypt `message_len` bytes of `message` with AES-256 in the given mode.
+ *
+ * @param mode Block cipher mode.
+ * @param message_len Length of the message in bytes.
+ * @return OK or error.
+ */
+static status_t aes_op(otcrypto_aes_mode_t mode, size_t message_len) {
+  uint32_t iv_data[kAesBlockWords] = {0};
+  otcrypto_word32_buf_t iv = {
+      .data = iv_data,
+      .len = ARRAYSIZE(iv_data),
+  };
+  otcrypto_byte_buf_t ciphertext = {
+      .data = (unsigned char *)output,
+      .len = message_len,
+  };
+  return otcrypto_aes(
+      aes_key, iv, mode, kOtcryptoAesOperationEncrypt,
+      (otcrypto_const_byte_buf_t){.data = message, .len = message_len},
+      kOtcryptoAesPaddingNull, ciphertext);
+}
+
+static status_t aes_ecb_op(size_t message_len) {
+  return aes_op(kOtcryptoAesModeEcb, message_len);
+}
+
+static status_t aes_cbc_op(size_t message_len) {
+  return aes_op(kOtcryptoAesModeCbc, message_len);
+}
+
+static status_t aes_ctr_op(size_t message_len) {
+  return aes_op(kOtcryptoAesModeCtr, message_len);
+}
+
+static status_t aes_gcm_op(size_t message_len) {
+  uint32_t iv_data[kGcmIvWords] = {0};
+  otcrypto_const_word32_buf_t iv = {
+      .data = iv_data,
+      .len = ARRAYSIZE(iv_data),
+  };
+  otcrypto_byte_buf_t ciphertext = {
+      .data = (unsigned char *)output,
+      .len = message_len,
+  };
+  uint32_t tag_data[kGcmTagWords];
+  otcrypto_word32_buf_t tag = {
+      .data = tag_data,
+      .len = ARRAYSIZE(tag_data),
+  };
+  return otcrypto_aes_gcm_encrypt(
+      aes_key,
+      (otcrypto_const_byte_buf_t){.data = message, .len = message_len}, iv,
+      kEmptyBuffer, kOtcryptoAesGcmTagLen128, ciphertext, tag);
+}
+
+static status_t aes_kwp_wrap_op(void) {
+  size_t wrapped_words;
+  TRY(otcrypto_aes_kwp_wrapped_len(kwp_key_to_wrap->config, &wrapped_words));
+  otcrypto_word32_buf_t wrapped_key = {
+      .data = output,
+      .len = wrapped_words,
+  };
+  return otcrypto_aes_kwp_wrap(kwp_key_to_wrap, kwp_key, wrapped_key);
+}
+
+static status_t aes_bench(void) {
+  uint32_t ecb_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t ecb_key = symmetric_key_make(
+      kOtcryptoKeyModeAesEcb, kSymmetricKeyBytes, ecb_keyblob);
+  uint32_t cbc_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t cbc_key = symmetric_key_make(
+      kOtcryptoKeyModeAesCbc, kSymmetricKeyBytes, cbc_keyblob);
+  uint32_t ctr_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t ctr_key = symmetric_key_make(
+      kOtcryptoKeyModeAesCtr, kSymmetricKeyBytes, ctr_keyblob);
+  uint32_t gcm_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t gcm_key = symmetric_key_make(
+      kOtcryptoKeyModeAesGcm, kSymmetricKeyBytes, gcm_keyblob);
+  uint32_t kwp_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t kwp = symmetric_key_make(
+      kOtcryptoKeyModeAesKwp, kSymmetricKeyBytes, kwp_keyblob);
+  kwp_key = &kwp;
+  uint32_t key_to_wrap_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t key_to_wrap = symmetric_key_make(
+      kOtcryptoKeyModeHmacSha256, kSymmetricKeyBytes, key_to_wrap_keyblob);
+  kwp_key_to_wrap = &key_to_wrap;
+
+  group_begin();
+  aes_key = &ecb_key;
+  TRY(bench_sized("aes256_ecb", aes_ecb_op));
+  aes_key = &cbc_key;
+  TRY(bench_sized("aes256_cbc", aes_cbc_op));
+  aes_key = &ctr_key;
+  TRY(bench_sized("aes256_ctr", aes_ctr_op));
+  aes_key = &gcm_key;
+  TRY(bench_sized("aes256_gcm", aes_gcm_op));
+  TRY(bench_fixed("aes256_kwp_wrap/32", aes_kwp_wrap_op));
+  return group_end();
+}
+
+static status_t drbg_generate_op(size_t message_len) {
+  otcrypto_word32_buf_t drbg_output = {
+      .data = output,
+      .len = message_len / sizeof(uint32_t),
+  };
+  return otcrypto_drbg_generate(kEmptyBuffer, drbg_output);
+}
+
+// Keys for the KDF benchmarks.
+static const otcrypto_blinded_key_t *kdf_hmac_key;
+static const otcrypto_blinded_key_t *kdf_kmac_key;
+
+/**
+ * Build a blinded key struct for `kKdfOutputBytes` bytes of keying material.
+ *
+ * @param keyblob Buffer for the keyblob, `2 * kSymmetricKeyWords` long.
+ * @return Blinded key.
+ */
+static otcrypto_blinded_key_t kdf_output_key(uint32_t *keyblob) {
+  return (otcrypto_blinded_key_t){
+      .config =
+          {
+              .version = kOtcryptoLibVersion1,
+              .key_mode = kOtcryptoKeyModeAesCtr,
+              .key_length = kKdfOutputBytes,
+              .hw_backed = kHardenedBoolFalse,
+              .exportable = kHardenedBoolFalse,
+              .security_level = kOtcryptoKeySecurityLevelLow,
+          },
+      .keyblob_length = 2 * kKdfOutputBytes,
+      .keyblob = keyblob,
+  };
+}
+
+static status_t hkdf_op(void) {
+  uint32_t keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t okm = kdf_output_key(keyblob);
+  return otcrypto_kdf_hkdf(*kdf_hmac_key, kEmptyBuffer, kEmptyBuffer, &okm);
+}
+
+static status_t kdf_hmac_ctr_op(void) {
+  uint32_t keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t km = kdf_output_key(keyblob);
+  return otcrypto_kdf_hmac_ctr(*kdf_hmac_key, kEmptyBuffer, kEmptyBuffer,
+                               kKdfOutputBytes, &km);
+}
+
+static status_t kdf_kmac128_op(void) {
+  uint32_t keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t km = kdf_output_key(keyblob);
+  return otcrypto_kdf_kmac(*kdf_kmac_key, kOtcryptoKmacModeKmac128,
+                           kEmptyBuffer, kEmptyBuffer, kKdfOutputBytes, &km);
+}
+
+static status_t drbg_kdf_bench(void) {
+  uint32_t hmac_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t hmac = symmetric_key_make(
+      kOtcryptoKeyModeHmacSha256, kSymmetricKeyBytes, hmac_keyblob);
+  kdf_hmac_key = &hmac;
+  uint32_t kmac_keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t kmac = symmetric_key_make(
+      kOtcryptoKeyModeKdfKmac128, kSymmetricKeyBytes, kmac_keyblob);
+  kdf_kmac_key = &kmac;
+  TRY(otcrypto_drbg_instantiate(kEmptyBuffer));
+
+  group_begin();
+  TRY(bench_sized("drbg_generate", drbg_generate_op));
+  TRY(bench_fixed("hkdf_sha256/32", hkdf_op));
+  TRY(bench_fixed("kdf_hmac_ctr_sha256/32", kdf_hmac_ctr_op));
+  TRY(bench_fixed("kdf_kmac128/32", kdf_kmac128_op));
+  return group_end();
+}
+
+// State for the RSA benchmarks.
+static const otcrypto_blinded_key_t *rsa_private_key;
+static const otcrypto_unblinded_key_t *rsa_public_key;
+static uint32_t rsa_digest_data[kSha256DigestWords];
+static uint32_t rsa_signature[kRsa2048Words];
+
+static const otcrypto_hash_digest_t kRsaDigest = {
+    .data = rsa_digest_data,
+    .len = ARRAYSIZE(rsa_digest_data),
+    .mode = kOtcryptoHashModeSha256,
+};
+
+static status_t rsa_2048_sign_op(void) {
+  return otcrypto_rsa_sign(
+      rsa_private_key, kRsaDigest, kOtcryptoRsaPaddingPkcs,
+      (otcrypto_word32_buf_t){.data = rsa_signature,
+                              .len = ARRAYSIZE(rsa_signature)});
+}
+
+static status_t rsa_2048_verify_op(void) {
+  hardened_bool_t result;
+  TRY(otcrypto_rsa_verify(
+      rsa_public_key, kRsaDigest, kOtcryptoRsaPaddingPkcs,
+      (otcrypto_const_word32_buf_t){.data = rsa_signature,
+                                    .len = ARRAYSIZE(rsa_signature)},
+      &result));
+  TRY_CHECK(result == kHardenedBoolTrue);
+  return OK_STATUS();
+}
+
+static status_t rsa_bench(void) {
+  otcrypto_const_word32_buf_t modulus = {
+      .data = kRsaModulus,
+      .len = ARRAYSIZE(kRsaModulus),
+  };
+  uint32_t d_share1_data[kRsa2048Words] = {0};
+  uint32_t private_keyblob[kOtcryptoRsa2048PrivateKeyblobBytes /
+                           sizeof(uint32_t)];
+  otcrypto_blinded_key_t private_key = {
+      .config =
+          {
+              .version = kOtcryptoLibVersion1,
+              .key_mode = kOtcryptoKeyModeRsaSignPkcs,
+              .key_length = kOtcryptoRsa2048PrivateKeyBytes,
+              .hw_backed = kHardenedBoolFalse,
+              .security_level = kOtcryptoKeySecurityLevelLow,
+          },
+      .keyblob_length = sizeof(private_keyblob),
+      .keyblob = private_keyblob,
+  };
+  TRY(otcrypto_rsa_private_key_from_exponents(
+      kOtcryptoRsaSize2048, modulus, kRsaPublicExponent,
+      (otcrypto_const_word32_buf_t){.data = kRsaPrivateExponent,
+                                    .len = ARRAYSIZE(kRsaPrivateExponent)},
+      (otcrypto_const_word32_buf_t){.data = d_share1_data,
+                                    .len = ARRAYSIZE(d_share1_data)},
+      &private_key));
+  rsa_private_key = &private_key;
+
+  uint32_t public_key_data[ceil_div(kOtcryptoRsa2048PublicKeyBytes,
+                                    sizeof(uint32_t))];
+  otcrypto_unblinded_key_t public_key = {
+      .key_mode = kOtcryptoKeyModeRsaSignPkcs,
+      .key_length = kOtcryptoRsa2048PublicKeyBytes,
+      .key = public_key_data,
+  };
+  TRY(otcrypto_rsa_public_key_construct(kOtcryptoRsaSize2048, modulus,
+                                        kRsaPublicExponent, &public_key));
+  rsa_public_key = &public_key;
+  TRY(sha256_op(sizeof(rsa_digest_data)));
+  memcpy(rsa_digest_data, output, sizeof(rsa_digest_data));
+
+  group_begin();
+  TRY(bench_otbn("rsa2048_sign/cold", "rsa2048_sign/warm", rsa_2048_sign_op));
+  TRY(bench_otbn("rsa2048_verify/cold", "rsa2048_verify/warm",
+                 rsa_2048_verify_op));
+  return group_end();
+}
+
+// State for the ECC benchmarks.
+static otcrypto_blinded_key_t *ecdsa_private_key;
+static otcrypto_unblinded_key_t *ecdsa_public_key;
+static otcrypto_blinded_key_t *ecdh_private_key;
+static otcrypto_unblinded_key_t *ecdh_public_key;
+static uint32_t ecdsa_digest_data[kSha256DigestWords];
+static uint32_t ecdsa_signature[kP256SignatureWords];
+
+static const otcrypto_hash_digest_t kEcdsaDigest = {
+    .data = ecdsa_digest_data,
+    .len = ARRAYSIZE(ecdsa_digest_data),
+    .mode = kOtcryptoHashModeSha256,
+};
+
+static status_t ecdsa_p256_keygen_op(void) {
+  return otcrypto_ecdsa_keygen(&kCurveP256, ecdsa_private_key,
+                               ecdsa_public_key);
+}
+
+static status_t ecdsa_p256_sign_op(void) {
+  return otcrypto_ecdsa_sign(
+      ecdsa_private_key, kEcdsaDigest, &kCurveP256,
+      (otcrypto_word32_buf_t){.data = ecdsa_signature,
+                              .len = ARRAYSIZE(ecdsa_signature)});
+}
+
+static status_t ecdsa_p256_verify_op(void) {
+  hardened_bool_t result;
+  TRY(otcrypto_ecdsa_verify(
+      ecdsa_public_key, kEcdsaDigest,
+      (otcrypto_const_word32_buf_t){.data = ecdsa_signature,
+                                    .len = ARRAYSIZE(ecdsa_signature)},
+      &kCurveP256, &result));
+  TRY_CHECK(result == kHardenedBoolTrue);
+  return OK_STATUS();
+}
+
+static status_t ecdh_p256_keygen_op(void) {
+  return otcrypto_ecdh_keygen(&kCurveP256, ecdh_private_key,
+                              ecdh_public_key);
+}
+
+static status_t ecdh_p256_op(void) {
+  uint32_t keyblob[2 * kSymmetricKeyWords];
+  otcrypto_blinded_key_t shared_secret = kdf_output_key(keyblob);
+  return otcrypto_ecdh(ecdh_private_key, ecdh_public_key, &kCurveP256,
+                       &shared_secret);
+}
+
+static status_t ecc_bench(void) {
+  otcrypto_key_config_t private_key_config = {
+      .version = kOtcryptoLibVersion1,
+      .key_mode = kOtcryptoKeyModeEcdsa,
+      .key_length = kP256PrivateKeyBytes,
+      .hw_backed = kHardenedBoolFalse,
+      .security_level = kOtcryptoKeySecurityLevelLow,
+  };
+  uint32_t ecdsa_keyblob[keyblob_num_words(private_key_config)];
+  otcrypto_blinded_key_t ecdsa_sk = {
+      .config = private_key_config,
+      .keyblob_length = sizeof(ecdsa_keyblob),
+      .keyblob = ecdsa_keyblob,
+  };
+  uint32_t ecdsa_pk[kP256PublicKeyWords];
+  otcrypto_unblinded_key_t ecdsa_pk_key = {
+      .key_mode = kOtcryptoKeyModeEcdsa,
+      .key_length = sizeof(ecdsa_pk),
+      .key = ecdsa_pk,
+  };
+
+  private_key_config.key_mode = kOtcryptoKeyModeEcdh;
+  uint32_t ecdh_keyblob[keyblob_num_words(private_key_config)];
+  otcrypto_blinded_key_t ecdh_sk = {
+      .config = private_key_config,
+      .keyblob_length = sizeof(ecdh_keyblob),
+      .keyblob = ecdh_keyblob,
+  };
+  uint32_t ecdh_pk[kP256PublicKeyWords];
+  otcrypto_unblinded_key_t ecdh_pk_key = {
+      .key_mode = kOtcryptoKeyModeEcdh,
+      .key_length = sizeof(ecdh_pk),
+      .key = ecdh_pk,
+  };
+
+  ecdsa_private_key = &ecdsa_sk;
+  ecdsa_public_key = &ecdsa_pk_key;
+  ecdh_private_key = &ecdh_sk;
+  ecdh_public_key = &ecdh_pk_key;
+
+  TRY(sha256_op(sizeof(ecdsa_digest_data)));
+  memcpy(ecdsa_digest_data, output, sizeof(ecdsa_digest_data));
+
+  group_begin();
+  TRY(bench_otbn("ecdsa_p256_keygen/cold", "ecdsa_p256_keygen/warm",
+                 ecdsa_p256_keygen_op));
+  TRY(bench_otbn("ecdsa_p256_sign/cold", "ecdsa_p256_sign/warm",
+                 ecdsa_p256_sign_op));
+  TRY(bench_otbn("ecdsa_p256_verify/cold", "ecdsa_p256_verify/warm",
+                 ecdsa_p256_verify_op));
+  TRY(bench_otbn("ecdh_p256_keygen/cold", "ecdh_p256_keygen/warm",
+                 ecdh_p256_keygen_op));
+  TRY(bench_otbn("ecdh_p256/cold", "ecdh_p256/warm", ecdh_p256_op));
+  return group_end();
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+// Holds the test result.
+static volatile status_t test_result;
+
+bool test_main(void) {
+  CHECK_STATUS_OK(entropy_complex_init());
+  uj = ujson_ottf_console();
+  for (size_t i = 0; i < sizeof(message); i++) {
+    message[i] = (uint8_t)(i * 7 + 1);
+  }
+
+  test_result = OK_STATUS();
+  EXECUTE_TEST(test_result, hash_bench);
+  EXECUTE_TEST(test_result, hash_batch_bench);
+  EXECUTE_TEST(test_result, mac_bench);
+  EXECUTE_TEST(test_result, aes_bench);
+  EXECUTE_TEST(test_result, drbg_kdf_bench);
+  EXECUTE_TEST(test_result, rsa_bench);
+  EXECUTE_TEST(test_result, ecc_bench);
+  return status_ok(test_result);
+}
@@ -0,0 +1,222 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/crypto/drivers/entropy.h"
+#include "sw/device/lib/crypto/impl/rsa/rsa_datatypes.h"
+#include "sw/device/lib/crypto/impl/rsa/rsa_signature.h"
+#include "sw/device/lib/crypto/include/hash.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+// Module for status messages.
+#define MODULE_ID MAKE_MODULE_ID('t', 's', 't')
+
+// Compares RSA-2048 signing with the full private exponent against signing
+// with the same key in CRT form, and checks that both produce the expected
+// signature.
+//
+// The key and signature are the same as in `rsa_2048_signature_functest`; the
+// CRT components were derived from them out-of-band.
+
+// Test RSA-2048 key pair.
+static const uint32_t kTestModulus[kRsa2048NumWords] = {
+    0x40d984b1, 0x3611356d, 0x9eb2f35c, 0x031a892c, 0x16354662, 0x6a260bad,
+    0xb2b807d6, 0xb7de7ccb, 0x278492e0, 0x41adab06, 0x9e60110f, 0x1414eeff,
+    0x8b80e14e, 0x5eb5ae79, 0x0d98fa5b, 0x58bece1f, 0xcf6bdca8, 0x82f5611f,
+    0x351e3869, 0x075005d6, 0xe813fe23, 0xdd967a37, 0x682d1c41, 0x9fdd2d8c,
+    0x21bdd5fc, 0x4fc459c7, 0x508c9293, 0x1f9ac759, 0x55aacb04, 0x58389f05,
+    0x0d0b00fb, 0x59bb4141, 0x68f9e0bf, 0xc2f1a546, 0x0a71ad19, 0x9c400301,
+    0xa4f8ecb9, 0xcdf39538, 0xaabe9cb0, 0xd9f7b2dc, 0x0e8b292d, 0x8ef6c717,
+    0x720e9520, 0xb0c6a23e, 0xda1e92b1, 0x8b6b4800, 0x2f25082b, 0x7f2d6711,
+    0x426fc94f, 0x9926ba5a, 0x89bd4d2b, 0x977718d5, 0x5a8406be, 0x87d090f3,
+    0x639f9975, 0x5948488b, 0x1d3d9cd7, 0x28c7956b, 0xebb97a3e, 0x1edbf4e2,
+    0x105cc797, 0x924ec514, 0x146810df, 0xb1ab4a49,
+};
+static const uint32_t kTestPrivateExponent[kRsa2048NumWords] = {
+    0x0b19915b, 0xa6a935e6, 0x426b2e10, 0xb4ff0629, 0x7322343b, 0x3f28c8d5,
+    0x190757ce, 0x87409d6b, 0xd88e282b, 0x01c13c2a, 0xebb79189, 0x74cbeab9,
+    0x93de5d54, 0xae1bc80a, 0x083a75f2, 0xd574d229, 0xeb46696e, 0x7648cfb6,
+    0xe7ad1b36, 0xbd0e81b2, 0x19c72703, 0xebea5085, 0xf8c7d152, 0x34dcf84d,
+    0xa437187f, 0x41e4f88e, 0xe4e35f9f, 0xcd8bc6f8, 0x7f98e2f2, 0xffdf75ca,
+    0x3698226e, 0x903f2a56, 0xbf21a6dc, 0x97cbf653, 0xe9d80cb3, 0x55dc1685,
+    0xe0ebae21, 0xc8171e18, 0x8e73d26d, 0xbbdbaac1, 0x886e8007, 0x673c9da4,
+    0xe2cb0698, 0xa9f1ba2d, 0xedab4f0a, 0x197e890c, 0x65e7e736, 0x1de28f24,
+    0x57cf5137, 0x631ff441, 0x22539942, 0xcee3fd41, 0xd22b5f8a, 0x995dd87a,
+    0xcaa6815c, 0x08ca0fd3, 0x8f996093, 0x30b7c446, 0xf69b11f7, 0xa298dd00,
+    0xfd4e8120, 0x059df602, 0x25feb268, 0x0f3f749e,
+};
+
+// CRT form of the test private key.
+static const uint32_t kTestPrimeP[kRsa2048NumWords / 2] = {
+    0xc69864d3, 0x6eca1793, 0xd985ff65, 0xa888cce8, 0xcadcabc5, 0x47d31ff8,
+    0x2eae994a, 0x0ba8594d, 0x956889ed, 0x117f0b01, 0x30ace812, 0x89aa41b9,
+    0x716c8c93, 0xb3e54154, 0x70020ae3, 0x3f3926af, 0x91ae5a18, 0xa058daef,
+    0xd5a8a0ee, 0xff73e9fb, 0xda00591c, 0x69220aec, 0xe9ee684b, 0x12f4ea77,
+    0xea538fb5, 0x0505826e, 0xef416b24, 0x5c65d8d6, 0xce422bd4, 0x3f4f37ed,
+    0xdd6aff12, 0xf6c55808,
+};
+static const uint32_t kTestPrimeQ[kRsa2048NumWords / 2] = {
+    0x69e8cdeb, 0x0aab5698, 0x2adbf5a2, 0xc6f3fed7, 0x9b0f148c, 0x68a4b636,
+    0xc3c8948c, 0x5ee5c048, 0xb20f9f30, 0xaced9c36, 0xe2a0f71f, 0xf57f3401,
+    0x8fb749f8, 0x24f4b1f2, 0x2811dd24, 0x0e45d624, 0x7e4fac27, 0x7049a420,
+    0x4ea4172b, 0x1d4f1d2d, 0x15c1dd03, 0x733ce8c1, 0xe5415c61, 0xa3680f9a,
+    0xa13ff562, 0xd12a0242, 0x3ef684a4, 0x5241db6e, 0x2e68b5f5, 0xaa3e5397,
+    0x45e9606a, 0xb8505888,
+};
+static const uint32_t kTestExponentDp[kRsa2048NumWords / 2] = {
+    0x1294bbf7, 0x8b2919b9, 0x19e6e6bb, 0x5bac57cf, 0x94878d05, 0xdd0297c9,
+    0xc2fa4a31, 0x250dbc5d, 0xa6e04ae3, 0xc4f6deb7, 0x5d21fd5f, 0x6e02cdea,
+    0xb967b151, 0x1324bb70, 0xe7c7e19a, 0x93faa85b, 0xcea179ee, 0xda7b268f,
+    0xb4953e88, 0x5da887cf, 0xf3475b09, 0xf0f59bd2, 0xd783b40b, 0x871df1f6,
+    0x7781156f, 0x2d8a9b67, 0xf1555281, 0xdf14b659, 0x85d12616, 0x28f80092,
+    0x50663f6f, 0xb2191d7f,
+};
+static const uint32_t kTestExponentDq[kRsa2048NumWords / 2] = {
+    0x450b9217, 0x4edd47a6, 0x65eaa581, 0xa489536c, 0x46c6416e, 0xcdcd3461,
+    0x07ba3fc0, 0x95d56f89, 0xcf3c23f1, 0x3a09db7b, 0x841780f5, 0x3ee50c5d,
+    0x6858dd49, 0xf56e4c70, 0x872d1012, 0xe23c883f, 0x24170efd, 0xeb61ae33,
+    0xd05cb6b7, 0x81db8c2f, 0x1cd58c9b, 0xa828fecf, 0x09db577e, 0xcdc21d77,
+    0x9ebfb60c, 0xbacad629, 0x98bc44a7, 0x8498e6dc, 0x399dc28f, 0x95d22e4d,
+    0x7b1d095d, 0xacc9ede5,
+};
+static const uint32_t kTestCoefficientQinv[kRsa2048NumWords / 2] = {
+    0xff019a0f, 0x58ec641a, 0xa8b6a4dc, 0x338e8a6a, 0xb98e701c, 0xe710b453,
+    0xc7b5ee24, 0x4268bb56, 0xf7474ef4, 0x6f88b191, 0x2079740b, 0x24cf5722,
+    0xce523e5d, 0xb5aeb747, 0x00963673, 0x564f2e69, 0x7124e565, 0x73e023aa,
+    0xca525e98, 0x483a1ec4, 0x46f0f3fd, 0x5fc69d0d, 0x55b96618, 0x8612dc35,
+    0x43b77913, 0xc00a23fc, 0xdf0ce49d, 0x28b92fa7, 0xca347165, 0x0b3634a2,
+    0x9c351d76, 0xc33ccc12,
+};
+
+// Message data for testing.
+static const unsigned char kTestMessage[] = "Test message.";
+static const size_t kTestMessageLen = sizeof(kTestMessage) - 1;
+
+// Valid signature of `kTestMessage` from the test private key, using PKCS#1
+// v1.5 padding and SHA-256 as the hash function.
+static const uint32_t kValidSignaturePkcs1v15[kRsa2048NumWords] = {
+    0xab66c6c7, 0x97effc0a, 0x9869cdba, 0x7b6c09fe, 0x2124d28f, 0x793084b3,
+    0x4da24b72, 0x4f6c8659, 0x63e3a27b, 0xbbe8d120, 0x8789190f, 0x1722fe46,
+    0x25573178, 0x3accbdb3, 0x1eb7ca00, 0xe8eb40aa, 0x1d3b21a8, 0x9997925e,
+    0x1793f81d, 0x12728f54, 0x66e40608, 0x4b1057a0, 0xba433eb3, 0x702c73b2,
+    0xa9391740, 0xf838710f, 0xf33cf109, 0x595cee1d, 0x07341be9, 0xcfce52b1,
+    0x5b48ba7a, 0xf70e5a0e, 0xdbb98c42, 0x85fd6979, 0xcdb760fc, 0xd2e09553,
+    0x70bba417, 0x04e52609, 0xc215420e, 0x2407242e, 0x4f19674b, 0x5d996a9d,
+    0xf2fb1d05, 0x88e0fc14, 0xe1a38f0c, 0xd111935d, 0xd23bf5b3, 0xdcd7a882,
+    0x0f242315, 0xd7247d51, 0xc247d6ec, 0xe2492739, 0x3dfb115c, 0x031aea7a,
+    0xcdcb09c0, 0x29318ddb, 0xd0a10dd8, 0x3307018e, 0xe13c5616, 0x98d4db80,
+    0x50692a42, 0x41e94a74, 0x0a6f79eb, 0x1c405c66,
+};
+
+/**
+ * Hashes the test message with SHA-256.
+ *
+ * @param[out] digest Buffer for the digest.
+ * @return OK or error.
+ */
+static status_t hash_test_message(otcrypto_hash_digest_t digest) {
+  otcrypto_const_byte_buf_t msg_buf = {
+      .data = kTestMessage,
+      .len = kTestMessageLen,
+  };
+  return otcrypto_hash(msg_buf, digest);
+}
+
+status_t sign_full_exponent_test(void) {
+  uint32_t msg_digest_data[kSha256DigestWords];
+  otcrypto_hash_digest_t msg_digest = {
+      .data = msg_digest_data,
+      .len = ARRAYSIZE(msg_digest_data),
+      .mode = kOtcryptoHashModeSha256,
+  };
+  TRY(hash_test_message(msg_digest));
+
+  rsa_2048_private_key_t private_key;
+  memcpy(private_key.n.data, kTestModulus, sizeof(kTestModulus));
+  memcpy(private_key.d.data, kTestPrivateExponent,
+         sizeof(kTestPrivateExponent));
+
+  rsa_2048_int_t sig;
+  uint64_t t_start = profile_start();
+  TRY(rsa_signature_generate_2048_start(&private_key, msg_digest,
+                                        kRsaSignaturePaddingPkcs1v15));
+  TRY(rsa_signature_generate_2048_finalize(&sig));
+  profile_end_and_print(t_start, "RSA-2048 signature (full exponent)");
+
+  TRY_CHECK_ARRAYS_EQ(sig.data, kValidSignaturePkcs1v15,
+                      ARRAYSIZE(kValidSignaturePkcs1v15));
+  return OK_STATUS();
+}
+
+status_t sign_crt_test(void) {
+  uint32_t msg_digest_data[kSha256DigestWords];
+  otcrypto_hash_digest_t msg_digest = {
+      .data = msg_digest_data,
+      .len = ARRAYSIZE(msg_digest_data),
+      .mode = kOtcryptoHashModeSha256,
+  };
+  TRY(hash_test_message(msg_digest));
+
+  rsa_2048_crt_private_key_t private_key;
+  memcpy(private_key.n.data, kTestModulus, sizeof(kTestModulus));
+  memcpy(private_key.p.data, kTestPrimeP, sizeof(kTestPrimeP));
+  memcpy(private_key.q.data, kTestPrimeQ, sizeof(kTestPrimeQ));
+  memcpy(private_key.dp.data, kTestExponentDp, sizeof(kTestExponentDp));
+  memcpy(private_key.dq.data, kTestExponentDq, sizeof(kTestExponentDq));
+  memcpy(private_key.qinv.data, kTestCoefficientQinv,
+         sizeof(kTestCoefficientQinv));
+
+  rsa_2048_int_t sig;
+  uint64_t t_start = profile_start();
+  TRY(rsa_signature_generate_crt_2048_start(&private_key, msg_digest,
+                                            kRsaSignaturePaddingPkcs1v15));
+  TRY(rsa_signature_generate_2048_finalize(&sig));
+  profile_end_and_print(t_start, "RSA-2048 signature (CRT)");
+
+  TRY_CHECK_ARRAYS_EQ(sig.data, kValidSignaturePkcs1v15,
+                      ARRAYSIZE(kValidSignaturePkcs1v15));
+  return OK_STATUS();
+}
+
+status_t sign_crt_bad_dp_test(void) {
+  uint32_t msg_digest_data[kSha256DigestWords];
+  otcrypto_hash_digest_t msg_digest = {
+      .data = msg_digest_data,
+      .len = ARRAYSIZE(msg_digest_data),
+      .mode = kOtcryptoHashModeSha256,
+  };
+  TRY(hash_test_message(msg_digest));
+
+  // Corrupt dp to simulate a fault in one half of the computation; the
+  // verify-after-sign check must reject the result.
+  rsa_2048_crt_private_key_t private_key;
+  memcpy(private_key.n.data, kTestModulus, sizeof(kTestModulus));
+  memcpy(private_key.p.data, kTestPrimeP, sizeof(kTestPrimeP));
+  memcpy(private_key.q.data, kTestPrimeQ, sizeof(kTestPrimeQ));
+  memcpy(private_key.dp.data, kTestExponentDp, sizeof(kTestExponentDp));
+  memcpy(private_key.dq.data, kTestExponentDq, sizeof(kTestExponentDq));
+  memcpy(private_key.qinv.data, kTestCoefficientQinv,
+         sizeof(kTestCoefficientQinv));
+  private_key.dp.data[0] ^= 1;
+
+  rsa_2048_int_t sig;
+  TRY(rsa_signature_generate_crt_2048_start(&private_key, msg_digest,
+                                            kRsaSignaturePaddingPkcs1v15));
+  TRY_CHECK(!status_ok(rsa_signature_generate_2048_finalize(&sig)));
+  return OK_STATUS();
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+bool test_main(void) {
+  status_t test_result = OK_STATUS();
+  CHECK_STATUS_OK(entropy_complex_init());
+  EXECUTE_TEST(test_result, sign_full_exponent_test);
+  EXECUTE_TEST(test_result, sign_crt_test);
+  EXECUTE_TEST(test_result, sign_crt_bad_dp_test);
+  return status_ok(test_result);
+}
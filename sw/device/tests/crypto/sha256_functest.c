@@ -167,6 +167,103 @@ static status_t multiple_update_streaming_test(void) {
   return OK_STATUS();
 }
 
+/**
+ * Callback for `batch_update_test`; counts the finished updates.
+ */
+static void count_update(void *arg) { *(size_t *)arg += 1; }
+
+/**
+ * Test the batch update API with two interleaved streams.
+ */
+static status_t batch_update_test(void) {
+  otcrypto_hash_context_t ctx0;
+  otcrypto_hash_context_t ctx1;
+  TRY(otcrypto_hash_init(&ctx0, kOtcryptoHashModeSha256));
+  TRY(otcrypto_hash_init(&ctx1, kOtcryptoHashModeSha256));
+
+  // Split each message in three and interleave the parts of both.
+  size_t done_count = 0;
+  const otcrypto_hash_update_item_t items[] = {
+      {&ctx0, {kTwoBlockMessage, 10}, count_update, &done_count},
+      {&ctx1, {kExactBlockMessage, 1}, count_update, &done_count},
+      {&ctx0, {kTwoBlockMessage + 10, 20}, count_update, &done_count},
+      {&ctx1, {kExactBlockMessage + 1, 62}, count_update, &done_count},
+      {&ctx1, {kExactBlockMessage + 63, 1}, count_update, &done_count},
+      {&ctx0,
+       {kTwoBlockMessage + 30, kTwoBlockMessageLen - 30},
+       count_update,
+       &done_count},
+  };
+  TRY(otcrypto_hash_update_batch(items, ARRAYSIZE(items)));
+  TRY_CHECK(done_count == ARRAYSIZE(items));
+
+  uint32_t act_digest[kHmacSha256DigestWords];
+  otcrypto_hash_digest_t digest_buf = {
+      .data = act_digest,
+      .len = kHmacSha256DigestWords,
+      .mode = kOtcryptoHashModeSha256,
+  };
+  TRY(otcrypto_hash_final(&ctx0, digest_buf));
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)act_digest, kTwoBlockExpDigest,
+                      sizeof(kTwoBlockExpDigest));
+  TRY(otcrypto_hash_final(&ctx1, digest_buf));
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)act_digest, kExactBlockExpDigest,
+                      sizeof(kExactBlockExpDigest));
+  return OK_STATUS();
+}
+
+/**
+ * Test the batch one-shot API, including an empty message.
+ */
+static status_t batch_hash_test(void) {
+  uint32_t act_digests[3][kHmacSha256DigestWords];
+  const otcrypto_hash_batch_item_t items[] = {
+      {
+          .message = kTwoBlockMessage,
+          .message_len = kTwoBlockMessageLen,
+          .digest =
+              {
+                  .mode = kOtcryptoHashModeSha256,
+                  .data = act_digests[0],
+                  .len = kHmacSha256DigestWords,
+              },
+      },
+      {
+          .message = NULL,
+          .message_len = 0,
+          .digest =
+              {
+                  .mode = kOtcryptoHashModeSha256,
+                  .data = act_digests[1],
+                  .len = kHmacSha256DigestWords,
+              },
+      },
+      {
+          .message = kExactBlockMessage,
+          .message_len = kExactBlockMessageLen,
+          .digest =
+              {
+                  .mode = kOtcryptoHashModeSha256,
+                  .data = act_digests[2],
+                  .len = kHmacSha256DigestWords,
+              },
+      },
+  };
+  TRY(otcrypto_hash_batch(items, ARRAYSIZE(items)));
+
+  const uint32_t exp_empty_digest[] = {
+      0x42c4b0e3, 0x141cfc98, 0xc8f4fb9a, 0x24b96f99,
+      0xe441ae27, 0x4c939b64, 0x1b9995a4, 0x55b85278,
+  };
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)act_digests[0], kTwoBlockExpDigest,
+                      sizeof(kTwoBlockExpDigest));
+  TRY_CHECK_ARRAYS_EQ(act_digests[1], exp_empty_digest,
+                      kHmacSha256DigestWords);
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)act_digests[2], kExactBlockExpDigest,
+                      sizeof(kExactBlockExpDigest));
+  return OK_STATUS();
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 
 bool test_main(void) {
@@ -176,5 +273,7 @@ bool test_main(void) {
   EXECUTE_TEST(test_result, empty_test);
   EXECUTE_TEST(test_result, one_update_streaming_test);
   EXECUTE_TEST(test_result, multiple_update_streaming_test);
+  EXECUTE_TEST(test_result, batch_update_test);
+  EXECUTE_TEST(test_result, batch_hash_test);
   return status_ok(test_result);
 }
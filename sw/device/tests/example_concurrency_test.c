@@ -97,6 +97,7 @@ bool test_main(void) {
   // ***************************************************************************
   LOG_INFO("Yielding execution to another task.");
   ottf_task_yield();
+  ottf_task_stats_print();
 
   // ***************************************************************************
   // Return true if the test succeeds. Return false if it should fail.
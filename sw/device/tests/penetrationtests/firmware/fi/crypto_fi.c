@@ -151,10 +151,15 @@ static inline uint32_t aes_spin_until(uint32_t bit) {
   }
 }
 
-status_t handle_crypto_fi_aes(ujson_t *uj) {
-  // Get the test mode.
-  crypto_fi_aes_mode_t uj_data;
-  TRY(ujson_deserialize_crypto_fi_aes_mode_t(uj, &uj_data));
+/**
+ * Runs the AES FI test once.
+ *
+ * @param uj_data Selects the phases during which the trigger is raised.
+ * @param[out] result The ciphertext, alerts and ERR_STATUS.
+ * @return OK or error.
+ */
+static status_t crypto_fi_aes_run(crypto_fi_aes_mode_t uj_data,
+                                  crypto_fi_aes_ciphertext_t *result) {
   // Clear registered alerts in alert handler.
   sca_registered_alerts_t reg_alerts = pentest_get_triggered_alerts();
 
@@ -220,15 +225,56 @@ status_t handle_crypto_fi_aes(ujson_t *uj) {
   dif_rv_core_ibex_error_status_t codes;
   TRY(dif_rv_core_ibex_get_error_status(&rv_core_ibex, &codes));
 
-  // Send the ciphertext and the alerts back to the host.
+  result->err_status = codes;
+  memcpy(result->ciphertext, ciphertext.data, 16);
+  memcpy(result->alerts, reg_alerts.alerts, sizeof(reg_alerts.alerts));
+  return OK_STATUS();
+}
+
+status_t handle_crypto_fi_aes(ujson_t *uj) {
+  // Get the test mode.
+  crypto_fi_aes_mode_t uj_data;
+  TRY(ujson_deserialize_crypto_fi_aes_mode_t(uj, &uj_data));
+
   crypto_fi_aes_ciphertext_t uj_output;
-  uj_output.err_status = codes;
-  memcpy(uj_output.ciphertext, ciphertext.data, 16);
-  memcpy(uj_output.alerts, reg_alerts.alerts, sizeof(reg_alerts.alerts));
+  TRY(crypto_fi_aes_run(uj_data, &uj_output));
+
+  // Send the ciphertext and the alerts back to the host.
   RESP_OK(ujson_serialize_crypto_fi_aes_ciphertext_t, uj, &uj_output);
   return OK_STATUS();
 }
 
+status_t handle_crypto_fi_aes_batch(ujson_t *uj) {
+  // Get the test mode and the number of iterations.
+  crypto_fi_aes_mode_t uj_data;
+  TRY(ujson_deserialize_crypto_fi_aes_mode_t(uj, &uj_data));
+  penetrationtest_num_iterations_t uj_iterations;
+  TRY(ujson_deserialize_penetrationtest_num_iterations_t(uj, &uj_iterations));
+
+  // Fault-free reference run outside of the trigger window.
+  crypto_fi_aes_mode_t no_trigger = {0};
+  crypto_fi_aes_ciphertext_t ref;
+  TRY(crypto_fi_aes_run(no_trigger, &ref));
+
+  penetrationtest_batch_digest_t digest;
+  pentest_batch_digest_init(&digest);
+  for (uint32_t it = 0; it < uj_iterations.num_iterations; it++) {
+    crypto_fi_aes_ciphertext_t uj_output;
+    TRY(crypto_fi_aes_run(uj_data, &uj_output));
+    bool anomaly = memcmp(&uj_output, &ref, sizeof(ref)) != 0;
+    pentest_batch_digest_update(&digest, &uj_output, sizeof(uj_output),
+                                anomaly);
+
+    // Send the full result only for deviant iterations.
+    if (anomaly) {
+      RESP_OK(ujson_serialize_crypto_fi_aes_ciphertext_t, uj, &uj_output);
+    }
+  }
+
+  RESP_OK(ujson_serialize_penetrationtest_batch_digest_t, uj, &digest);
+  return OK_STATUS();
+}
+
 status_t handle_crypto_fi_init(ujson_t *uj) {
   sca_select_trigger_type(kScaTriggerTypeSw);
   sca_init(kScaTriggerSourceAes,
@@ -570,6 +616,8 @@ status_t handle_crypto_fi(ujson_t *uj) {
   switch (cmd) {
     case kCryptoFiSubcommandAes:
       return handle_crypto_fi_aes(uj);
+    case kCryptoFiSubcommandAesBatch:
+      return handle_crypto_fi_aes_batch(uj);
     case kCryptoFiSubcommandInit:
       return handle_crypto_fi_init(uj);
     case kCryptoFiSubcommandKmac:
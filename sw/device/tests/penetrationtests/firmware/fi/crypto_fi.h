@@ -21,6 +21,18 @@
  */
 status_t handle_crypto_fi_aes(ujson_t *uj);
 
+/**
+ * AES FI batch test.
+ *
+ * Runs the AES FI test num_iterations times. The ciphertext, alerts and
+ * ERR_STATUS are only sent for iterations that differ from a reference run
+ * without trigger. A batch digest over all results is sent at the end.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_crypto_fi_aes_batch(ujson_t *uj);
+
 /**
  * Initializes the trigger and configures the device for the Crypto FI test.
  *
@@ -2286,11 +2286,12 @@ status_t handle_ibex_fi_char_unrolled_mem_op_loop(ujson_t *uj) {
   return OK_STATUS();
 }
 
-status_t handle_ibex_fi_char_unrolled_reg_op_loop(ujson_t *uj) {
-  // Clear registered alerts in alert handler.
-  sca_registered_alerts_t reg_alerts = pentest_get_triggered_alerts();
-
-  // FI code target.
+/**
+ * FI code target of the ibex.fi.char.unrolled_reg_op_loop tests.
+ *
+ * @return The value of the loop counter, 10000 if no fault was injected.
+ */
+static uint32_t ibex_fi_unrolled_reg_op_loop(void) {
   uint32_t loop_counter = 0;
   sca_set_trigger_high();
   asm volatile(INITX5);
@@ -2307,6 +2308,15 @@ status_t handle_ibex_fi_char_unrolled_reg_op_loop(ujson_t *uj) {
   asm volatile(ADDI1000);
   asm volatile("mv %0, x5" : "=r"(loop_counter));
   sca_set_trigger_low();
+  return loop_counter;
+}
+
+status_t handle_ibex_fi_char_unrolled_reg_op_loop(ujson_t *uj) {
+  // Clear registered alerts in alert handler.
+  sca_registered_alerts_t reg_alerts = pentest_get_triggered_alerts();
+
+  // FI code target.
+  uint32_t loop_counter = ibex_fi_unrolled_reg_op_loop();
   // Get registered alerts from alert handler.
   reg_alerts = pentest_get_triggered_alerts();
 
@@ -2323,6 +2333,49 @@ status_t handle_ibex_fi_char_unrolled_reg_op_loop(ujson_t *uj) {
   return OK_STATUS();
 }
 
+status_t handle_ibex_fi_char_unrolled_reg_op_loop_batch(ujson_t *uj) {
+  penetrationtest_num_iterations_t uj_data;
+  TRY(ujson_deserialize_penetrationtest_num_iterations_t(uj, &uj_data));
+
+  // ERR_STATUS is sticky, so only changes during the batch are anomalies.
+  dif_rv_core_ibex_error_status_t codes_ref;
+  TRY(dif_rv_core_ibex_get_error_status(&rv_core_ibex, &codes_ref));
+
+  penetrationtest_batch_digest_t digest;
+  pentest_batch_digest_init(&digest);
+  for (uint32_t it = 0; it < uj_data.num_iterations; it++) {
+    // Clear registered alerts in alert handler.
+    sca_registered_alerts_t reg_alerts = pentest_get_triggered_alerts();
+
+    // FI code target.
+    uint32_t loop_counter = ibex_fi_unrolled_reg_op_loop();
+    // Get registered alerts from alert handler.
+    reg_alerts = pentest_get_triggered_alerts();
+
+    // Read ERR_STATUS register.
+    dif_rv_core_ibex_error_status_t codes;
+    TRY(dif_rv_core_ibex_get_error_status(&rv_core_ibex, &codes));
+
+    ibex_fi_loop_counter_t uj_output;
+    uj_output.loop_counter = loop_counter;
+    uj_output.err_status = codes;
+    memcpy(uj_output.alerts, reg_alerts.alerts, sizeof(reg_alerts.alerts));
+    bool anomaly = loop_counter != 10000 || codes != codes_ref ||
+                   (reg_alerts.alerts[0] | reg_alerts.alerts[1] |
+                    reg_alerts.alerts[2]) != 0;
+    pentest_batch_digest_update(&digest, &uj_output, sizeof(uj_output),
+                                anomaly);
+
+    // Send the full result only for deviant iterations.
+    if (anomaly) {
+      RESP_OK(ujson_serialize_ibex_fi_loop_counter_t, uj, &uj_output);
+    }
+  }
+
+  RESP_OK(ujson_serialize_penetrationtest_batch_digest_t, uj, &digest);
+  return OK_STATUS();
+}
+
 status_t handle_ibex_fi_char_unrolled_reg_op_loop_chain(ujson_t *uj) {
   // Clear registered alerts in alert handler.
   sca_registered_alerts_t reg_alerts = pentest_get_triggered_alerts();
@@ -2530,6 +2583,8 @@ status_t handle_ibex_fi(ujson_t *uj) {
       return handle_ibex_fi_char_unrolled_mem_op_loop(uj);
     case kIbexFiSubcommandCharUnrolledRegOpLoop:
       return handle_ibex_fi_char_unrolled_reg_op_loop(uj);
+    case kIbexFiSubcommandCharUnrolledRegOpLoopBatch:
+      return handle_ibex_fi_char_unrolled_reg_op_loop_batch(uj);
     case kIbexFiSubcommandCharUnrolledRegOpLoopChain:
       return handle_ibex_fi_char_unrolled_reg_op_loop_chain(uj);
     case kIbexFiSubcommandInit:
@@ -556,6 +556,19 @@ status_t handle_ibex_fi_char_unrolled_mem_op_loop(ujson_t *uj);
  */
 status_t handle_ibex_fi_char_unrolled_reg_op_loop(ujson_t *uj);
 
+/**
+ * ibex.fi.char.unrolled_reg_op_loop_batch command handler.
+ *
+ * Runs the ibex.fi.char.unrolled_reg_op_loop test num_iterations times. The
+ * full result is only sent for iterations with a wrong loop counter, a changed
+ * ERR_STATUS or a triggered alert. A batch digest over all results is sent at
+ * the end.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_ibex_fi_char_unrolled_reg_op_loop_batch(ujson_t *uj);
+
 /**
  * ibex.fi.char.unrolled_reg_op_loop_chain command handler.
  *
@@ -268,7 +268,15 @@ status_t handle_otbn_fi_char_unrolled_dmem_op_loop(ujson_t *uj) {
   return OK_STATUS();
 }
 
-status_t handle_otbn_fi_char_unrolled_reg_op_loop(ujson_t *uj) {
+/**
+ * Runs the otbn.fi.char.unrolled_reg_op_loop test once.
+ *
+ * @param trigger Whether to raise the trigger around the FI code target.
+ * @param[out] result The loop counter, error registers and alerts.
+ * @return OK or error.
+ */
+static status_t otbn_fi_unrolled_reg_op_loop(bool trigger,
+                                             otbn_fi_loop_counter_t *result) {
   // Clear registered alerts in alert handler.
   sca_registered_alerts_t reg_alerts = pentest_get_triggered_alerts();
 
@@ -284,10 +292,14 @@ status_t handle_otbn_fi_char_unrolled_reg_op_loop(ujson_t *uj) {
   uint32_t loop_counter;
 
   // FI code target.
-  sca_set_trigger_high();
+  if (trigger) {
+    sca_set_trigger_high();
+  }
   otbn_execute();
   otbn_busy_wait_for_done();
-  sca_set_trigger_low();
+  if (trigger) {
+    sca_set_trigger_low();
+  }
   // Get registered alerts from alert handler.
   reg_alerts = pentest_get_triggered_alerts();
 
@@ -305,16 +317,49 @@ status_t handle_otbn_fi_char_unrolled_reg_op_loop(ujson_t *uj) {
   // Clear OTBN memory.
   TRY(clear_otbn());
 
-  // Send loop counter & ERR_STATUS to host.
+  result->loop_counter = loop_counter;
+  result->err_otbn = err_otbn;
+  result->err_ibx = err_ibx;
+  memcpy(result->alerts, reg_alerts.alerts, sizeof(reg_alerts.alerts));
+  return OK_STATUS();
+}
+
+status_t handle_otbn_fi_char_unrolled_reg_op_loop(ujson_t *uj) {
   otbn_fi_loop_counter_t uj_output;
-  uj_output.loop_counter = loop_counter;
-  uj_output.err_otbn = err_otbn;
-  uj_output.err_ibx = err_ibx;
-  memcpy(uj_output.alerts, reg_alerts.alerts, sizeof(reg_alerts.alerts));
+  TRY(otbn_fi_unrolled_reg_op_loop(/*trigger=*/true, &uj_output));
+
+  // Send loop counter & ERR_STATUS to host.
   RESP_OK(ujson_serialize_otbn_fi_loop_counter_t, uj, &uj_output);
   return OK_STATUS();
 }
 
+status_t handle_otbn_fi_char_unrolled_reg_op_loop_batch(ujson_t *uj) {
+  penetrationtest_num_iterations_t uj_data;
+  TRY(ujson_deserialize_penetrationtest_num_iterations_t(uj, &uj_data));
+
+  // Fault-free reference run outside of the trigger window.
+  otbn_fi_loop_counter_t ref;
+  TRY(otbn_fi_unrolled_reg_op_loop(/*trigger=*/false, &ref));
+
+  penetrationtest_batch_digest_t digest;
+  pentest_batch_digest_init(&digest);
+  for (uint32_t it = 0; it < uj_data.num_iterations; it++) {
+    otbn_fi_loop_counter_t uj_output;
+    TRY(otbn_fi_unrolled_reg_op_loop(/*trigger=*/true, &uj_output));
+    bool anomaly = memcmp(&uj_output, &ref, sizeof(ref)) != 0;
+    pentest_batch_digest_update(&digest, &uj_output, sizeof(uj_output),
+                                anomaly);
+
+    // Send the full result only for deviant iterations.
+    if (anomaly) {
+      RESP_OK(ujson_serialize_otbn_fi_loop_counter_t, uj, &uj_output);
+    }
+  }
+
+  RESP_OK(ujson_serialize_penetrationtest_batch_digest_t, uj, &digest);
+  return OK_STATUS();
+}
+
 status_t handle_otbn_fi_init(ujson_t *uj) {
   // Configure the entropy complex for OTBN. Set the reseed interval to max
   // to avoid a non-constant trigger window.
@@ -514,6 +559,8 @@ status_t handle_otbn_fi(ujson_t *uj) {
       return handle_otbn_fi_char_unrolled_dmem_op_loop(uj);
     case kOtbnFiSubcommandCharUnrolledRegOpLoop:
       return handle_otbn_fi_char_unrolled_reg_op_loop(uj);
+    case kOtbnFiSubcommandCharUnrolledRegOpLoopBatch:
+      return handle_otbn_fi_char_unrolled_reg_op_loop_batch(uj);
     case kOtbnFiSubcommandInit:
       return handle_otbn_fi_init(uj);
     case kOtbnFiSubcommandInitKeyMgr:
@@ -75,6 +75,18 @@ status_t handle_otbn_fi_char_unrolled_dmem_op_loop(ujson_t *uj);
  */
 status_t handle_otbn_fi_char_unrolled_reg_op_loop(ujson_t *uj);
 
+/**
+ * otbn.char.unrolled.reg.op.loop.batch command handler.
+ *
+ * Runs the otbn.char.unrolled.reg.op.loop test num_iterations times. The full
+ * result is only sent for iterations that differ from a reference run without
+ * trigger. A batch digest over all results is sent at the end.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_otbn_fi_char_unrolled_reg_op_loop_batch(ujson_t *uj);
+
 /**
  * Initializes the OTBN FI test.
  *
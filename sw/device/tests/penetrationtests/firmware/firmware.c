@@ -107,6 +107,9 @@ status_t process_cmd(ujson_t *uj) {
       case kPenetrationtestCommandTriggerSca:
         RESP_ERR(uj, handle_trigger_sca(uj));
         break;
+      case kPenetrationtestCommandSetFormat:
+        RESP_ERR(uj, ujson_ottf_set_format(uj));
+        break;
       default:
         LOG_ERROR("Unrecognized command: %d", cmd);
         RESP_ERR(uj, INVALID_ARGUMENT());
@@ -118,6 +121,6 @@ status_t process_cmd(ujson_t *uj) {
 
 bool test_main(void) {
   CHECK_STATUS_OK(entropy_complex_init());
-  ujson_t uj = ujson_ottf_console();
+  ujson_t uj = ujson_ottf_console_buffered();
   return status_ok(process_cmd(&uj));
 }
@@ -5,6 +5,7 @@
 #include "sw/device/tests/penetrationtests/firmware/lib/pentest_lib.h"
 
 #include "sw/device/lib/base/csr.h"
+#include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/base/mmio.h"
 #include "sw/device/lib/base/status.h"
 #include "sw/device/lib/crypto/drivers/otbn.h"
@@ -35,6 +36,22 @@ static dif_alert_handler_t alert_handler;
 static dif_lc_ctrl_t lc;
 static dif_rv_timer_t timer;
 
+/**
+ * Trigger calibration state.
+ *
+ * The raw delays are kept in a buffer so that the histogram can be built
+ * relative to the minimum once recording has stopped.
+ */
+static struct {
+  bool enabled;
+  uint32_t num_samples;
+  uint32_t min_cycles;
+  uint32_t max_cycles;
+  uint64_t sum;
+  uint64_t sum_sq;
+  uint32_t samples[kPentestTriggerCalibrationMaxSamples];
+} trigger_calibration;
+
 enum {
   kRvTimerComparator = 0,
   kRvTimerHart = kTopEarlgreyPlicTargetIbex0,
@@ -232,6 +249,93 @@ void pentest_configure_alert_handler(void) {
       &alert_handler, kDifAlertHandlerIrqClassa, kDifToggleEnabled));
 }
 
+enum {
+  /**
+   * FNV-1a 32-bit parameters.
+   */
+  kFnv32OffsetBasis = 0x811c9dc5,
+  kFnv32Prime = 0x01000193,
+};
+
+void pentest_batch_digest_init(penetrationtest_batch_digest_t *digest) {
+  memset(digest, 0, sizeof(*digest));
+  digest->hash = kFnv32OffsetBasis;
+}
+
+void pentest_batch_digest_update(penetrationtest_batch_digest_t *digest,
+                                 const void *result, size_t result_len,
+                                 bool anomaly) {
+  const uint8_t *bytes = (const uint8_t *)result;
+  uint32_t hash = digest->hash;
+  for (size_t i = 0; i < result_len; ++i) {
+    hash = (hash ^ bytes[i]) * kFnv32Prime;
+  }
+  digest->hash = hash;
+
+  if (anomaly) {
+    uint32_t it = digest->num_results;
+    if (it < kPentestBatchMaxIterations) {
+      digest->anomaly_bitmap[it / 32] |= 1u << (it % 32);
+    }
+    digest->num_anomalies++;
+  }
+  digest->num_results++;
+}
+
+void pentest_trigger_calibration_start(void) {
+  memset(&trigger_calibration, 0, sizeof(trigger_calibration));
+  trigger_calibration.min_cycles = UINT32_MAX;
+  trigger_calibration.enabled = true;
+}
+
+/**
+ * Records one trigger-to-start delay.
+ *
+ * @param cycles The delay in mcycle ticks.
+ */
+static void trigger_calibration_record(uint32_t cycles) {
+  if (trigger_calibration.num_samples < kPentestTriggerCalibrationMaxSamples) {
+    trigger_calibration.samples[trigger_calibration.num_samples] = cycles;
+  }
+  trigger_calibration.num_samples++;
+  if (cycles < trigger_calibration.min_cycles) {
+    trigger_calibration.min_cycles = cycles;
+  }
+  if (cycles > trigger_calibration.max_cycles) {
+    trigger_calibration.max_cycles = cycles;
+  }
+  trigger_calibration.sum += cycles;
+  trigger_calibration.sum_sq += (uint64_t)cycles * cycles;
+}
+
+void pentest_trigger_calibration_stop(
+    penetrationtest_trigger_calibration_t *calibration) {
+  trigger_calibration.enabled = false;
+  memset(calibration, 0, sizeof(*calibration));
+  uint32_t n = trigger_calibration.num_samples;
+  if (n == 0) {
+    return;
+  }
+  uint64_t mean = trigger_calibration.sum / n;
+  calibration->num_samples = n;
+  calibration->min_cycles = trigger_calibration.min_cycles;
+  calibration->max_cycles = trigger_calibration.max_cycles;
+  calibration->mean_cycles = (uint32_t)mean;
+  calibration->variance =
+      (uint32_t)(trigger_calibration.sum_sq / n - mean * mean);
+
+  uint32_t num_binned = n < kPentestTriggerCalibrationMaxSamples
+                            ? n
+                            : kPentestTriggerCalibrationMaxSamples;
+  for (uint32_t i = 0; i < num_binned; ++i) {
+    uint32_t bin = trigger_calibration.samples[i] - calibration->min_cycles;
+    if (bin >= PENTEST_TRIGGER_CALIBRATION_HISTOGRAM_BINS) {
+      bin = PENTEST_TRIGGER_CALIBRATION_HISTOGRAM_BINS - 1;
+    }
+    calibration->histogram[bin]++;
+  }
+}
+
 status_t pentest_read_device_id(uint32_t device_id[]) {
   mmio_region_t lc_reg = mmio_region_from_addr(TOP_EARLGREY_LC_CTRL_BASE_ADDR);
   CHECK_DIF_OK(dif_lc_ctrl_init(lc_reg, &lc));
@@ -277,12 +381,24 @@ void pentest_call_and_sleep(sca_callee callee, uint32_t sleep_cycles,
   OT_DISCARD(dif_rv_timer_counter_set_enabled(&timer, kRvTimerHart,
                                               kDifToggleEnabled));
 
+  // When calibrating, the delay is measured from just before raising the
+  // trigger to just after the callee has started the target engine.
+  uint32_t trigger_cycle = 0;
   if (sw_trigger) {
+    if (trigger_calibration.enabled) {
+      CSR_READ(CSR_REG_MCYCLE, &trigger_cycle);
+    }
     sca_set_trigger_high();
   }
 
   callee();
 
+  if (sw_trigger && trigger_calibration.enabled) {
+    uint32_t start_cycle;
+    CSR_READ(CSR_REG_MCYCLE, &start_cycle);
+    trigger_calibration_record(start_cycle - trigger_cycle);
+  }
+
   wait_for_interrupt();
 
   if (otbn) {
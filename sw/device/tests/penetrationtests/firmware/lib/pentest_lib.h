@@ -12,6 +12,18 @@ typedef struct sca_registered_alerts {
   uint32_t alerts[3];
 } sca_registered_alerts_t;
 
+enum {
+  /**
+   * Max number of iterations of a batch whose anomalies can be located in
+   * `penetrationtest_batch_digest_t.anomaly_bitmap`.
+   */
+  kPentestBatchMaxIterations = PENTEST_BATCH_ANOMALY_BITMAP_WORDS * 32,
+  /**
+   * Max number of trigger delays kept for the calibration histogram.
+   */
+  kPentestTriggerCalibrationMaxSamples = 256,
+};
+
 /**
  * Configures the entropy complex for OTBN tests.
  *
@@ -52,6 +64,53 @@ void pentest_configure_alert_handler(void);
  */
 status_t pentest_read_device_id(uint32_t device_id[]);
 
+/**
+ * Resets a batch digest.
+ *
+ * @param digest The digest to reset.
+ */
+void pentest_batch_digest_init(penetrationtest_batch_digest_t *digest);
+
+/**
+ * Folds the result of one batch iteration into a batch digest.
+ *
+ * The result is absorbed into a running 32-bit FNV-1a hash, so that the host
+ * can check a whole batch of fault-free results against a single value. If
+ * `anomaly` is set, the bit of this iteration is also set in the anomaly
+ * bitmap; iterations beyond `kPentestBatchMaxIterations` are only counted.
+ *
+ * @param digest The digest to update.
+ * @param result The result of the iteration.
+ * @param result_len The length of the result in bytes.
+ * @param anomaly Whether the result deviates from the expected result.
+ */
+void pentest_batch_digest_update(penetrationtest_batch_digest_t *digest,
+                                 const void *result, size_t result_len,
+                                 bool anomaly);
+
+/**
+ * Clears the trigger calibration statistics and starts recording.
+ *
+ * While recording, `pentest_call_and_sleep()` measures the number of mcycle
+ * ticks between raising the software trigger and the callee having started
+ * the target engine. Calls without a software trigger are not recorded, as the
+ * hardware trigger is asserted by the engine itself.
+ */
+void pentest_trigger_calibration_start(void);
+
+/**
+ * Stops recording and returns the trigger calibration statistics.
+ *
+ * The histogram holds one bin per cycle, starting at `min_cycles`; the last
+ * bin also counts all larger delays. Only the first
+ * `kPentestTriggerCalibrationMaxSamples` delays are binned, all of them are
+ * included in the other statistics.
+ *
+ * @param[out] calibration The recorded statistics.
+ */
+void pentest_trigger_calibration_stop(
+    penetrationtest_trigger_calibration_t *calibration);
+
 /**
  * Configures CPU for SCA and FI penetration tests.
  *
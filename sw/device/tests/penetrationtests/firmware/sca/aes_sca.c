@@ -28,6 +28,12 @@
  */
 static bool fpga_mode = false;
 
+/**
+ * Return a digest over all ciphertexts of a batch instead of the last
+ * ciphertext.
+ */
+static bool batch_digest_mode = false;
+
 enum {
   kAesKeyLengthMax = 32,
   kAesKeyLength = 16,
@@ -236,21 +242,51 @@ static aes_sca_error_t aes_encrypt(const uint8_t *plaintext,
 }
 
 /**
- * Wait until AES output is valid and then get ciphertext and send it over
- * serial communication.
+ * Wait until AES output is valid and then get the ciphertext.
  *
- * @param only_first_word Send only the first word of the ciphertext.
+ * @param[out] ciphertext The ciphertext.
  */
-static status_t aes_send_ciphertext(bool only_first_word, ujson_t *uj) {
+static status_t aes_read_ciphertext(dif_aes_data_t *ciphertext) {
   bool ready = false;
   do {
     TRY(dif_aes_get_status(&aes, kDifAesStatusOutputValid, &ready));
   } while (!ready);
 
-  dif_aes_data_t ciphertext;
-  if (dif_aes_read_output(&aes, &ciphertext) != kDifOk) {
+  if (dif_aes_read_output(&aes, ciphertext) != kDifOk) {
     return OUT_OF_RANGE();
   }
+  return OK_STATUS();
+}
+
+/**
+ * Folds the ciphertext of the last encryption into the batch digest.
+ *
+ * Does nothing unless the batch digest mode is enabled, so that the timing of
+ * the batch is unchanged by default.
+ *
+ * @param digest The batch digest.
+ */
+static status_t aes_batch_digest_update(
+    penetrationtest_batch_digest_t *digest) {
+  if (!batch_digest_mode) {
+    return OK_STATUS();
+  }
+  dif_aes_data_t ciphertext;
+  TRY(aes_read_ciphertext(&ciphertext));
+  pentest_batch_digest_update(digest, ciphertext.data, kAesTextLength,
+                              /*anomaly=*/false);
+  return OK_STATUS();
+}
+
+/**
+ * Wait until AES output is valid and then get ciphertext and send it over
+ * serial communication.
+ *
+ * @param only_first_word Send only the first word of the ciphertext.
+ */
+static status_t aes_send_ciphertext(bool only_first_word, ujson_t *uj) {
+  dif_aes_data_t ciphertext;
+  TRY(aes_read_ciphertext(&ciphertext));
 
   aes_sca_ciphertext_t uj_output;
   memset(uj_output.ciphertext, 0, AESSCA_CMD_MAX_DATA_BYTES);
@@ -264,6 +300,25 @@ static status_t aes_send_ciphertext(bool only_first_word, ujson_t *uj) {
   return OK_STATUS();
 }
 
+/**
+ * Sends the result of a batch to the host.
+ *
+ * In batch digest mode, this is the digest over all ciphertexts of the batch.
+ * Otherwise, it is the ciphertext of the last encryption.
+ *
+ * @param only_first_word Send only the first word of the ciphertext.
+ * @param digest The batch digest.
+ */
+static status_t aes_send_batch_result(
+    bool only_first_word, const penetrationtest_batch_digest_t *digest,
+    ujson_t *uj) {
+  if (batch_digest_mode) {
+    RESP_OK(ujson_serialize_penetrationtest_batch_digest_t, uj, digest);
+    return OK_STATUS();
+  }
+  return aes_send_ciphertext(only_first_word, uj);
+}
+
 /**
  * Advances data for fvsr-key TVLA - fixed set.
  *
@@ -424,6 +479,8 @@ status_t handle_aes_sca_batch_encrypt(ujson_t *uj) {
     block_ctr = num_encryptions;
   }
 
+  penetrationtest_batch_digest_t digest;
+  pentest_batch_digest_init(&digest);
   if (fpga_mode) {
     sca_set_trigger_high();
   }
@@ -431,13 +488,14 @@ status_t handle_aes_sca_batch_encrypt(ujson_t *uj) {
     if (aes_encrypt(plaintext_random, kAesTextLength) != aesScaOk) {
       return ABORTED();
     }
+    TRY(aes_batch_digest_update(&digest));
     aes_serial_advance_random();
   }
   if (fpga_mode) {
     sca_set_trigger_low();
   }
 
-  TRY(aes_send_ciphertext(true, uj));
+  TRY(aes_send_batch_result(true, &digest, uj));
 
   return OK_STATUS();
 }
@@ -459,6 +517,8 @@ status_t handle_aes_sca_batch_encrypt_random(ujson_t *uj) {
     block_ctr = num_encryptions;
   }
 
+  penetrationtest_batch_digest_t digest;
+  pentest_batch_digest_init(&digest);
   if (fpga_mode) {
     sca_set_trigger_high();
   }
@@ -469,13 +529,22 @@ status_t handle_aes_sca_batch_encrypt_random(ujson_t *uj) {
     if (aes_encrypt(plaintext_random, kAesTextLength) != aesScaOk) {
       return ABORTED();
     }
+    TRY(aes_batch_digest_update(&digest));
     aes_serial_advance_random();
   }
   if (fpga_mode) {
     sca_set_trigger_low();
   }
 
-  TRY(aes_send_ciphertext(true, uj));
+  TRY(aes_send_batch_result(true, &digest, uj));
+
+  return OK_STATUS();
+}
+
+status_t handle_aes_sca_batch_digest_set(ujson_t *uj) {
+  aes_sca_batch_digest_mode_t uj_data;
+  TRY(ujson_deserialize_aes_sca_batch_digest_mode_t(uj, &uj_data));
+  batch_digest_mode = uj_data.batch_digest == 0x01;
 
   return OK_STATUS();
 }
@@ -513,18 +582,21 @@ status_t handle_aes_sca_fvsr_data_batch_encrypt(ujson_t *uj) {
     sample_fixed = sca_next_lfsr(1, kScaLfsrOrder) & 0x1;
   }
 
+  penetrationtest_batch_digest_t digest;
+  pentest_batch_digest_init(&digest);
   if (fpga_mode) {
     sca_set_trigger_high();
   }
   for (uint32_t i = 0; i < num_encryptions; ++i) {
     aes_key_mask_and_config(batch_keys[i], kAesKeyLength);
     aes_encrypt(batch_plaintexts[i], kAesTextLength);
+    TRY(aes_batch_digest_update(&digest));
   }
   if (fpga_mode) {
     sca_set_trigger_low();
   }
 
-  TRY(aes_send_ciphertext(false, uj));
+  TRY(aes_send_batch_result(false, &digest, uj));
 
   return OK_STATUS();
 }
@@ -539,6 +611,8 @@ status_t handle_aes_sca_fvsr_key_batch_encrypt(ujson_t *uj) {
     return OUT_OF_RANGE();
   }
 
+  penetrationtest_batch_digest_t digest;
+  pentest_batch_digest_init(&digest);
   if (fpga_mode) {
     sca_set_trigger_high();
   }
@@ -549,12 +623,13 @@ status_t handle_aes_sca_fvsr_key_batch_encrypt(ujson_t *uj) {
     if (aes_encrypt(batch_plaintexts[i], kAesTextLength) != aesScaOk) {
       return ABORTED();
     }
+    TRY(aes_batch_digest_update(&digest));
   }
   if (fpga_mode) {
     sca_set_trigger_low();
   }
 
-  TRY(aes_send_ciphertext(false, uj));
+  TRY(aes_send_batch_result(false, &digest, uj));
 
   // Start to generate random keys and plaintexts for the next batch when the
   // waves are getting from scope by the host to increase capture rate.
@@ -757,6 +832,8 @@ status_t handle_aes_sca(ujson_t *uj) {
   switch (cmd) {
     case kAesScaSubcommandBatchAlternativeEncrypt:
       return handle_aes_sca_batch_alternative_encrypt(uj);
+    case kAesScaSubcommandBatchDigestSet:
+      return handle_aes_sca_batch_digest_set(uj);
     case kAesScaSubcommandBatchEncrypt:
       return handle_aes_sca_batch_encrypt(uj);
     case kAesScaSubcommandBatchEncryptRandom:
@@ -113,6 +113,22 @@ status_t handle_aes_sca_batch_encrypt(ujson_t *uj);
  */
 status_t handle_aes_sca_batch_encrypt_random(ujson_t *uj);
 
+/**
+ * Batch digest mode command handler.
+ *
+ * Enables or disables the batch digest mode. In this mode, the batch encrypt
+ * commands read back the ciphertext after every encryption and return a
+ * `penetrationtest_batch_digest_t` over all ciphertexts of the batch instead
+ * of the last ciphertext.
+ *
+ *  * The uJSON data contains:
+ *  - batch_digest: 1 to enable, 0 to disable the batch digest mode.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_aes_sca_batch_digest_set(ujson_t *uj);
+
 /**
  * Batch plaintext command handler.
  *
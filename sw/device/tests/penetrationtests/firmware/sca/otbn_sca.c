@@ -37,6 +37,24 @@ static dif_kmac_t kmac;
 
 enum {
   kKeySideloadNumIt = 16,
+  /**
+   * Number of bytes for ECDSA P-256 private keys, message digests, and
+   * signature components.
+   */
+  kEcc256NumBytes = 256 / 8,
+  /**
+   * Number of 32b words for ECDSA P-256 private keys, message digests, and
+   * signature components.
+   */
+  kEcc256NumWords = kEcc256NumBytes / sizeof(uint32_t),
+  /**
+   * Number of words for the P-256 modular inverse input shares (k0, k1).
+   */
+  kEcc256ModInvInputShareNumWords = 320 / 32,
+  /**
+   * Number of words for the P-256 modular inverse output mask (alpha).
+   */
+  kEcc256ModInvAlphaNumWords = 128 / 32,
 };
 
 // Data structs for key sideloading test.
@@ -62,6 +80,69 @@ static const otbn_addr_t kOtbnAppKeySideloadkl =
 static const otbn_addr_t kOtbnAppKeySideloadkh =
     OTBN_ADDR_T_INIT(otbn_key_sideload_sca, k_h);
 
+// Data structs for the P-256 ECDSA signing test. p256_ecdsa_sca has
+// randomization removed.
+OTBN_DECLARE_APP_SYMBOLS(p256_ecdsa_sca);
+OTBN_DECLARE_SYMBOL_ADDR(p256_ecdsa_sca, mode);
+OTBN_DECLARE_SYMBOL_ADDR(p256_ecdsa_sca, msg);
+OTBN_DECLARE_SYMBOL_ADDR(p256_ecdsa_sca, r);
+OTBN_DECLARE_SYMBOL_ADDR(p256_ecdsa_sca, s);
+OTBN_DECLARE_SYMBOL_ADDR(p256_ecdsa_sca, d0);
+OTBN_DECLARE_SYMBOL_ADDR(p256_ecdsa_sca, d1);
+OTBN_DECLARE_SYMBOL_ADDR(p256_ecdsa_sca, k0);
+OTBN_DECLARE_SYMBOL_ADDR(p256_ecdsa_sca, k1);
+static const otbn_app_t kOtbnAppP256Ecdsa = OTBN_APP_T_INIT(p256_ecdsa_sca);
+static const otbn_addr_t kOtbnVarEcdsaMode =
+    OTBN_ADDR_T_INIT(p256_ecdsa_sca, mode);
+static const otbn_addr_t kOtbnVarEcdsaMsg =
+    OTBN_ADDR_T_INIT(p256_ecdsa_sca, msg);
+static const otbn_addr_t kOtbnVarEcdsaR = OTBN_ADDR_T_INIT(p256_ecdsa_sca, r);
+static const otbn_addr_t kOtbnVarEcdsaS = OTBN_ADDR_T_INIT(p256_ecdsa_sca, s);
+static const otbn_addr_t kOtbnVarEcdsaD0 =
+    OTBN_ADDR_T_INIT(p256_ecdsa_sca, d0);
+static const otbn_addr_t kOtbnVarEcdsaD1 =
+    OTBN_ADDR_T_INIT(p256_ecdsa_sca, d1);
+static const otbn_addr_t kOtbnVarEcdsaK0 =
+    OTBN_ADDR_T_INIT(p256_ecdsa_sca, k0);
+static const otbn_addr_t kOtbnVarEcdsaK1 =
+    OTBN_ADDR_T_INIT(p256_ecdsa_sca, k1);
+
+// Data structs for the P-256 modular inverse test.
+OTBN_DECLARE_APP_SYMBOLS(p256_mod_inv_sca);
+OTBN_DECLARE_SYMBOL_ADDR(p256_mod_inv_sca, k0);
+OTBN_DECLARE_SYMBOL_ADDR(p256_mod_inv_sca, k1);
+OTBN_DECLARE_SYMBOL_ADDR(p256_mod_inv_sca, kalpha_inv);
+OTBN_DECLARE_SYMBOL_ADDR(p256_mod_inv_sca, alpha);
+static const otbn_app_t kOtbnAppP256ModInv =
+    OTBN_APP_T_INIT(p256_mod_inv_sca);
+static const otbn_addr_t kOtbnVarModInvK0 =
+    OTBN_ADDR_T_INIT(p256_mod_inv_sca, k0);
+static const otbn_addr_t kOtbnVarModInvK1 =
+    OTBN_ADDR_T_INIT(p256_mod_inv_sca, k1);
+static const otbn_addr_t kOtbnVarModInvKAlphaInv =
+    OTBN_ADDR_T_INIT(p256_mod_inv_sca, kalpha_inv);
+static const otbn_addr_t kOtbnVarModInvAlpha =
+    OTBN_ADDR_T_INIT(p256_mod_inv_sca, alpha);
+
+/**
+ * Runs the currently loaded OTBN app inside the trigger window.
+ *
+ * @returns OK or error.
+ */
+static status_t otbn_run_triggered(void) {
+  TRY(dif_otbn_set_ctrl_software_errs_fatal(&otbn, /*enable=*/false));
+
+  sca_set_trigger_high();
+  // Give the trigger time to rise.
+  asm volatile(NOP30);
+  otbn_execute();
+  otbn_busy_wait_for_done();
+  sca_set_trigger_low();
+  asm volatile(NOP30);
+
+  return OK_STATUS();
+}
+
 /**
  * Clears the OTBN DMEM and IMEM.
  *
@@ -190,6 +271,164 @@ status_t handle_otbn_sca_key_sideload_fvsr(ujson_t *uj) {
   return OK_STATUS();
 }
 
+status_t handle_otbn_sca_key_sideload_fvsr_batch(ujson_t *uj) {
+  penetrationtest_otbn_sca_fixed_seed_batch_t uj_data;
+  TRY(ujson_deserialize_penetrationtest_otbn_sca_fixed_seed_batch_t(uj,
+                                                                    &uj_data));
+
+  TRY(otbn_load_app(kOtbnAppKeySideloadSca));
+
+  dif_keymgr_versioned_key_params_t sideload_params = {
+      .version = 0x0,
+      .dest = kDifKeymgrVersionedKeyDestOtbn,
+  };
+  penetrationtest_otbn_sca_key_t uj_output;
+  memset(&uj_output, 0, sizeof(uj_output));
+
+  bool sample_fixed = true;
+  for (size_t it = 0; it < uj_data.num_traces; it++) {
+    // Generate the FvsR salt outside of the trigger window.
+    memset(sideload_params.salt, 0, sizeof(sideload_params.salt));
+    if (sample_fixed) {
+      sideload_params.salt[0] = uj_data.fixed_seed;
+    } else {
+      sideload_params.salt[0] = prng_rand_uint32();
+    }
+    sample_fixed = prng_rand_uint32() & 0x1;
+
+    TRY(keymgr_testutils_generate_versioned_key(&keymgr, sideload_params));
+
+    // SCA code target.
+    TRY(otbn_run_triggered());
+  }
+
+  // Only the shares and key of the last iteration are sent to the host.
+  if (uj_data.num_traces > 0) {
+    TRY(otbn_dmem_read(1, kOtbnAppKeySideloadks0l, &uj_output.shares[0]));
+    TRY(otbn_dmem_read(1, kOtbnAppKeySideloadks0h, &uj_output.shares[1]));
+    TRY(otbn_dmem_read(1, kOtbnAppKeySideloadks1l, &uj_output.shares[2]));
+    TRY(otbn_dmem_read(1, kOtbnAppKeySideloadks1h, &uj_output.shares[3]));
+    TRY(otbn_dmem_read(1, kOtbnAppKeySideloadkl, &uj_output.keys[0]));
+    TRY(otbn_dmem_read(1, kOtbnAppKeySideloadkh, &uj_output.keys[1]));
+  }
+  RESP_OK(ujson_serialize_penetrationtest_otbn_sca_key_t, uj, &uj_output);
+
+  return OK_STATUS();
+}
+
+status_t handle_otbn_sca_ecc256_ecdsa_sign_fvsr_batch(ujson_t *uj) {
+  penetrationtest_otbn_sca_ecdsa_fvsr_batch_t uj_data;
+  TRY(ujson_deserialize_penetrationtest_otbn_sca_ecdsa_fvsr_batch_t(uj,
+                                                                    &uj_data));
+
+  uint32_t fixed_d[kEcc256NumWords];
+  uint32_t msg[kEcc256NumWords];
+  memcpy(fixed_d, uj_data.fixed_d, kEcc256NumBytes);
+  memcpy(msg, uj_data.msg, kEcc256NumBytes);
+
+  TRY(otbn_load_app(kOtbnAppP256Ecdsa));
+
+  // The second shares of d and k stay zero; the message is fixed for the
+  // whole batch.
+  uint32_t mode = 1;  // mode 1 => sign
+  uint32_t zero[kEcc256NumWords] = {0};
+  TRY(otbn_dmem_write(/*num_words=*/1, &mode, kOtbnVarEcdsaMode));
+  TRY(otbn_dmem_write(kEcc256NumWords, msg, kOtbnVarEcdsaMsg));
+  TRY(otbn_dmem_write(kEcc256NumWords, zero, kOtbnVarEcdsaD1));
+  TRY(otbn_dmem_write(kEcc256NumWords, zero, kOtbnVarEcdsaK1));
+
+  uint32_t d[kEcc256NumWords];
+  uint32_t k[kEcc256NumWords];
+  bool sample_fixed = true;
+  for (size_t it = 0; it < uj_data.num_traces; it++) {
+    // Fixed vs. random private key; the nonce is always random.
+    for (size_t j = 0; j < kEcc256NumWords; ++j) {
+      d[j] = sample_fixed ? fixed_d[j] : prng_rand_uint32();
+    }
+    for (size_t j = 0; j < kEcc256NumWords; ++j) {
+      k[j] = prng_rand_uint32();
+    }
+    sample_fixed = prng_rand_uint32() & 0x1;
+
+    TRY(otbn_dmem_write(kEcc256NumWords, d, kOtbnVarEcdsaD0));
+    TRY(otbn_dmem_write(kEcc256NumWords, k, kOtbnVarEcdsaK0));
+
+    // SCA code target.
+    TRY(otbn_run_triggered());
+  }
+
+  // Only the signature of the last iteration is sent to the host, which can
+  // replay the PRNG to check it.
+  uint32_t r[kEcc256NumWords] = {0};
+  uint32_t sig_s[kEcc256NumWords] = {0};
+  if (uj_data.num_traces > 0) {
+    TRY(otbn_dmem_read(kEcc256NumWords, kOtbnVarEcdsaR, r));
+    TRY(otbn_dmem_read(kEcc256NumWords, kOtbnVarEcdsaS, sig_s));
+  }
+  penetrationtest_otbn_sca_ecdsa_signature_t uj_output;
+  memcpy(uj_output.r, r, kEcc256NumBytes);
+  memcpy(uj_output.s, sig_s, kEcc256NumBytes);
+  RESP_OK(ujson_serialize_penetrationtest_otbn_sca_ecdsa_signature_t, uj,
+          &uj_output);
+
+  return OK_STATUS();
+}
+
+status_t handle_otbn_sca_ecc256_modinv_fvsr_batch(ujson_t *uj) {
+  penetrationtest_otbn_sca_modinv_fvsr_batch_t uj_data;
+  TRY(ujson_deserialize_penetrationtest_otbn_sca_modinv_fvsr_batch_t(
+      uj, &uj_data));
+
+  uint32_t fixed_k[kEcc256ModInvInputShareNumWords];
+  memcpy(fixed_k, uj_data.fixed_k, sizeof(fixed_k));
+
+  TRY(otbn_load_app(kOtbnAppP256ModInv));
+
+  // The second input share stays zero.
+  uint32_t zero[kEcc256ModInvInputShareNumWords] = {0};
+  TRY(otbn_dmem_write(kEcc256ModInvInputShareNumWords, zero,
+                      kOtbnVarModInvK1));
+
+  uint32_t k[kEcc256ModInvInputShareNumWords];
+  bool sample_fixed = true;
+  for (size_t it = 0; it < uj_data.num_traces; it++) {
+    for (size_t j = 0; j < kEcc256ModInvInputShareNumWords; ++j) {
+      k[j] = sample_fixed ? fixed_k[j] : prng_rand_uint32();
+    }
+    sample_fixed = prng_rand_uint32() & 0x1;
+
+    TRY(otbn_dmem_write(kEcc256ModInvInputShareNumWords, k, kOtbnVarModInvK0));
+
+    // SCA code target.
+    TRY(otbn_run_triggered());
+  }
+
+  // Only the result of the last iteration is sent to the host. The output is
+  // masked with alpha, so (k * alpha)^-1 * alpha * k = 1 mod n can be checked.
+  uint32_t kalpha_inv[kEcc256NumWords] = {0};
+  uint32_t alpha[kEcc256ModInvAlphaNumWords] = {0};
+  if (uj_data.num_traces > 0) {
+    TRY(otbn_dmem_read(kEcc256NumWords, kOtbnVarModInvKAlphaInv, kalpha_inv));
+    TRY(otbn_dmem_read(kEcc256ModInvAlphaNumWords, kOtbnVarModInvAlpha,
+                       alpha));
+  }
+  penetrationtest_otbn_sca_modinv_result_t uj_output;
+  memcpy(uj_output.kalpha_inv, kalpha_inv, sizeof(kalpha_inv));
+  memcpy(uj_output.alpha, alpha, sizeof(alpha));
+  RESP_OK(ujson_serialize_penetrationtest_otbn_sca_modinv_result_t, uj,
+          &uj_output);
+
+  return OK_STATUS();
+}
+
+status_t handle_otbn_sca_seed_prng(ujson_t *uj) {
+  penetrationtest_otbn_sca_prng_seed_t uj_data;
+  TRY(ujson_deserialize_penetrationtest_otbn_sca_prng_seed_t(uj, &uj_data));
+  prng_seed(read_32(uj_data.seed));
+
+  return OK_STATUS();
+}
+
 status_t handle_otbn_sca(ujson_t *uj) {
   otbn_sca_subcommand_t cmd;
   TRY(ujson_deserialize_otbn_sca_subcommand_t(uj, &cmd));
@@ -198,8 +437,12 @@ status_t handle_otbn_sca(ujson_t *uj) {
       return handle_otbn_sca_ecc256_ecdsa_keygen_fvsr_key_batch(uj);
     case kOtbnScaSubcommandEcc256EcdsaKeygenFvsrSeedBatch:
       return handle_otbn_sca_ecc256_ecdsa_keygen_fvsr_seed_batch(uj);
+    case kOtbnScaSubcommandEcc256EcdsaSignFvsrBatch:
+      return handle_otbn_sca_ecc256_ecdsa_sign_fvsr_batch(uj);
     case kOtbnScaSubcommandEcc256EnMasks:
       return handle_otbn_sca_ecc256_en_masks(uj);
+    case kOtbnScaSubcommandEcc256ModInvFvsrBatch:
+      return handle_otbn_sca_ecc256_modinv_fvsr_batch(uj);
     case kOtbnScaSubcommandEcc256SetC:
       return handle_otbn_sca_ecc256_set_c(uj);
     case kOtbnScaSubcommandEcc256SetSeed:
@@ -210,6 +453,10 @@ status_t handle_otbn_sca(ujson_t *uj) {
       return handle_otbn_sca_init_keymgr(uj);
     case kOtbnScaSubcommandKeySideloadFvsr:
       return handle_otbn_sca_key_sideload_fvsr(uj);
+    case kOtbnScaSubcommandKeySideloadFvsrBatch:
+      return handle_otbn_sca_key_sideload_fvsr_batch(uj);
+    case kOtbnScaSubcommandSeedPrng:
+      return handle_otbn_sca_seed_prng(uj);
     default:
       LOG_ERROR("Unrecognized OTBN SCA subcommand: %d", cmd);
       return INVALID_ARGUMENT();
@@ -30,6 +30,18 @@ status_t handle_otbn_sca_ecc256_ecdsa_keygen_fvsr_key_batch(ujson_t *uj);
  */
 status_t handle_otbn_sca_ecc256_ecdsa_keygen_fvsr_seed_batch(ujson_t *uj);
 
+/**
+ * Signs a message with P-256 ECDSA in batch mode.
+ *
+ * Num_traces fixed vs random private keys and random nonces are generated
+ * using the SCA PRNG and for each of them the signing operation on OTBN is
+ * started. Only the signature of the last operation is sent to the host.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_otbn_sca_ecc256_ecdsa_sign_fvsr_batch(ujson_t *uj);
+
 /**
  * Enable or disable masking.
  *
@@ -42,6 +54,18 @@ status_t handle_otbn_sca_ecc256_ecdsa_keygen_fvsr_seed_batch(ujson_t *uj);
  */
 status_t handle_otbn_sca_ecc256_en_masks(ujson_t *uj);
 
+/**
+ * Computes the P-256 modular inverse in batch mode.
+ *
+ * Num_traces fixed vs random inputs are generated using the SCA PRNG and for
+ * each of them the modular inversion on OTBN is started. Only the result of
+ * the last operation is sent to the host.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_otbn_sca_ecc256_modinv_fvsr_batch(ujson_t *uj);
+
 /**
  * Set the constant C.
  *
@@ -90,6 +114,28 @@ status_t handle_otbn_sca_init_keymgr(ujson_t *uj);
  */
 status_t handle_otbn_sca_key_sideload_fvsr(ujson_t *uj);
 
+/**
+ * Command handler for the otbn.sca.key_sideload_fvsr_batch test.
+ *
+ * Side-load num_traces fixed vs. random keys from keymanager to OTBN. Only the
+ * shares and key of the last iteration are sent to the host.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_otbn_sca_key_sideload_fvsr_batch(ujson_t *uj);
+
+/**
+ * Seeds the SCA PRNG.
+ *
+ * The PRNG generates the fixed vs. random inputs of the OTBN batch commands.
+ * Only 4-byte seeds are supported.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_otbn_sca_seed_prng(ujson_t *uj);
+
 /**
  * OTBN SCA command handler.
  *
@@ -35,6 +35,30 @@ status_t handle_prng_sca_seed_prng(ujson_t *uj) {
   return OK_STATUS();
 }
 
+/**
+ * Generate batch command handler.
+ *
+ * Draws num_values words from the SCA internal PRNG and only sends the last
+ * one back, which lets the host check that its PRNG model is in sync with the
+ * device without a round-trip per value.
+ * The uJSON data contains:
+ *  - num_values: Number of words to draw.
+ *
+ * @param uj The received uJSON data.
+ */
+status_t handle_prng_sca_generate_batch(ujson_t *uj) {
+  cryptotest_prng_sca_num_values_t uj_data;
+  TRY(ujson_deserialize_cryptotest_prng_sca_num_values_t(uj, &uj_data));
+
+  cryptotest_prng_sca_value_t uj_output = {.value = 0};
+  for (size_t i = 0; i < uj_data.num_values; ++i) {
+    uj_output.value = prng_rand_uint32();
+  }
+  RESP_OK(ujson_serialize_cryptotest_prng_sca_value_t, uj, &uj_output);
+
+  return OK_STATUS();
+}
+
 /**
  * PRNG SCA command handler.
  *
@@ -49,6 +73,9 @@ status_t handle_prng_sca(ujson_t *uj) {
     case kPrngScaSubcommandSeedPrng:
       return handle_prng_sca_seed_prng(uj);
       break;
+    case kPrngScaSubcommandGenerateBatch:
+      return handle_prng_sca_generate_batch(uj);
+      break;
     default:
       LOG_ERROR("Unrecognized PRNG SCA subcommand: %d", cmd);
       return INVALID_ARGUMENT();
@@ -9,6 +9,7 @@
 #include "sw/device/lib/ujson/ujson.h"
 
 status_t handle_prng_sca_seed_prng(ujson_t *uj);
+status_t handle_prng_sca_generate_batch(ujson_t *uj);
 status_t handle_prng_sca(ujson_t *uj);
 
 #endif  // OPENTITAN_SW_DEVICE_TESTS_PENETRATIONTESTS_FIRMWARE_SCA_PRNG_SCA_H_
@@ -10,10 +10,17 @@
 #include "sw/device/lib/testing/test_framework/ujson_ottf.h"
 #include "sw/device/lib/ujson/ujson.h"
 #include "sw/device/sca/lib/sca.h"
+#include "sw/device/tests/penetrationtests/firmware/lib/pentest_lib.h"
+#include "sw/device/tests/penetrationtests/json/pentest_lib_commands.h"
 #include "sw/device/tests/penetrationtests/json/trigger_sca_commands.h"
 
 #include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
 
+// NOP macros.
+#define NOP1 "addi x0, x0, 0\n"
+#define NOP10 NOP1 NOP1 NOP1 NOP1 NOP1 NOP1 NOP1 NOP1 NOP1 NOP1
+#define NOP30 NOP10 NOP10 NOP10
+
 /**
  * Select trigger type command handler.
  *
@@ -32,6 +39,64 @@ status_t handle_trigger_sca_select_source(ujson_t *uj) {
   return OK_STATUS();
 }
 
+/**
+ * Pulse batch command handler.
+ *
+ * Raises and lowers the currently selected trigger num_pulses times around a
+ * fixed NOP window, so that the segmented capture setup can be checked without
+ * a round-trip or a crypto operation per segment.
+ *
+ * The uJSON data contains:
+ *  - num_pulses: Number of trigger pulses.
+ * @param uj The received uJSON data.
+ */
+status_t handle_trigger_sca_pulse_batch(ujson_t *uj) {
+  cryptotest_trigger_sca_num_pulses_t uj_data;
+  TRY(ujson_deserialize_cryptotest_trigger_sca_num_pulses_t(uj, &uj_data));
+
+  for (size_t i = 0; i < uj_data.num_pulses; ++i) {
+    sca_set_trigger_high();
+    asm volatile(NOP30);
+    sca_set_trigger_low();
+    asm volatile(NOP30);
+  }
+
+  return OK_STATUS();
+}
+
+/**
+ * Trigger calibration start command handler.
+ *
+ * Clears the trigger calibration statistics and starts recording the delay
+ * between the software trigger and the start of the target engine for every
+ * subsequent SCA command that uses a software trigger. The host runs the
+ * commands of the primitive of interest and then fetches the statistics with
+ * the CalibrationReport command.
+ *
+ * @param uj The received uJSON data.
+ */
+status_t handle_trigger_sca_calibration_start(ujson_t *uj) {
+  pentest_trigger_calibration_start();
+  return OK_STATUS();
+}
+
+/**
+ * Trigger calibration report command handler.
+ *
+ * Stops recording and sends the distribution of the trigger-to-start delay in
+ * mcycle ticks. The host can use `min_cycles` together with the histogram to
+ * choose a constant trace alignment offset.
+ *
+ * @param uj The received uJSON data.
+ */
+status_t handle_trigger_sca_calibration_report(ujson_t *uj) {
+  penetrationtest_trigger_calibration_t uj_output;
+  pentest_trigger_calibration_stop(&uj_output);
+  RESP_OK(ujson_serialize_penetrationtest_trigger_calibration_t, uj,
+          &uj_output);
+  return OK_STATUS();
+}
+
 status_t handle_trigger_sca(ujson_t *uj) {
   trigger_sca_subcommand_t cmd;
   TRY(ujson_deserialize_trigger_sca_subcommand_t(uj, &cmd));
@@ -39,6 +104,15 @@ status_t handle_trigger_sca(ujson_t *uj) {
     case kTriggerScaSubcommandSelectTriggerSource:
       return handle_trigger_sca_select_source(uj);
       break;
+    case kTriggerScaSubcommandPulseBatch:
+      return handle_trigger_sca_pulse_batch(uj);
+      break;
+    case kTriggerScaSubcommandCalibrationStart:
+      return handle_trigger_sca_calibration_start(uj);
+      break;
+    case kTriggerScaSubcommandCalibrationReport:
+      return handle_trigger_sca_calibration_report(uj);
+      break;
     default:
       LOG_ERROR("Unrecognized TRIGGER SCA subcommand: %d", cmd);
       return INVALID_ARGUMENT();
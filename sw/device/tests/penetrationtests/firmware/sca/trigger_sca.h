@@ -9,6 +9,9 @@
 #include "sw/device/lib/ujson/ujson.h"
 
 status_t handle_trigger_sca_select_source(ujson_t *uj);
+status_t handle_trigger_sca_pulse_batch(ujson_t *uj);
+status_t handle_trigger_sca_calibration_start(ujson_t *uj);
+status_t handle_trigger_sca_calibration_report(ujson_t *uj);
 status_t handle_trigger_sca(ujson_t *uj);
 
 #endif  // OPENTITAN_SW_DEVICE_TESTS_PENETRATIONTESTS_FIRMWARE_SCA_TRIGGER_SCA_H_
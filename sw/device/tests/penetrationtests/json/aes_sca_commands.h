@@ -20,6 +20,7 @@ extern "C" {
 
 #define AESSCA_SUBCOMMAND(_, value) \
     value(_, BatchAlternativeEncrypt) \
+    value(_, BatchDigestSet) \
     value(_, BatchEncrypt) \
     value(_, BatchEncryptRandom) \
     value(_, BatchPlaintextSet) \
@@ -61,6 +62,10 @@ UJSON_SERDE_STRUCT(CryptotestAesScaCiphertext, aes_sca_ciphertext_t, AES_SCA_CIP
 #define AES_SCA_FPGA_MODE(field, string) \
     field(fpga_mode, uint8_t)
 UJSON_SERDE_STRUCT(CryptotestAesScaFpgaMode, aes_sca_fpga_mode_t, AES_SCA_FPGA_MODE);
+
+#define AES_SCA_BATCH_DIGEST_MODE(field, string) \
+    field(batch_digest, uint8_t)
+UJSON_SERDE_STRUCT(CryptotestAesScaBatchDigestMode, aes_sca_batch_digest_mode_t, AES_SCA_BATCH_DIGEST_MODE);
 // clang-format on
 
 #ifdef __cplusplus
@@ -28,7 +28,8 @@ extern "C" {
     value(_, RngFi) \
     value(_, RomFi) \
     value(_, Sha3Sca) \
-    value(_, TriggerSca)
+    value(_, TriggerSca) \
+    value(_, SetFormat)
 UJSON_SERDE_ENUM(PenetrationtestCommand, penetrationtest_cmd_t, COMMAND);
 
 // clang-format on
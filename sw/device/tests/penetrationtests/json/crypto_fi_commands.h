@@ -13,6 +13,7 @@ extern "C" {
 
 #define CRYPTOFI_SUBCOMMAND(_, value) \
     value(_, Aes) \
+    value(_, AesBatch) \
     value(_, Init) \
     value(_, Kmac) \
     value(_, KmacState) \
@@ -43,6 +43,7 @@ extern "C" {
     value(_, CharUncondBranchNop) \
     value(_, CharUnrolledMemOpLoop) \
     value(_, CharUnrolledRegOpLoop) \
+    value(_, CharUnrolledRegOpLoopBatch) \
     value(_, CharUnrolledRegOpLoopChain) \
     value(_, Init) \
     value(_, OtpDataRead) \
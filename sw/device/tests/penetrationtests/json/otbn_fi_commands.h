@@ -16,6 +16,7 @@ extern "C" {
     value(_, CharHardwareRegOpLoop) \
     value(_, CharUnrolledDmemOpLoop) \
     value(_, CharUnrolledRegOpLoop) \
+    value(_, CharUnrolledRegOpLoopBatch) \
     value(_, Init) \
     value(_, InitKeyMgr) \
     value(_, KeySideload)  \
@@ -10,6 +10,9 @@ extern "C" {
 #endif
 
 #define OTBNSCA_CMD_MAX_BATCH_DIGEST_BYTES 40
+#define OTBNSCA_CMD_MAX_ECC256_BYTES 32
+#define OTBNSCA_CMD_MAX_MODINV_ALPHA_BYTES 16
+#define OTBNSCA_CMD_MAX_PRNG_SEED_BYTES 4
 #define OTBNSCA_CMD_MAX_SEED_BYTES 40
 
 // clang-format off
@@ -19,12 +22,16 @@ extern "C" {
 #define OTBNSCA_SUBCOMMAND(_, value) \
     value(_, Ecc256EcdsaKeygenFvsrKeyBatch) \
     value(_, Ecc256EcdsaKeygenFvsrSeedBatch) \
+    value(_, Ecc256EcdsaSignFvsrBatch) \
     value(_, Ecc256EnMasks) \
+    value(_, Ecc256ModInvFvsrBatch) \
     value(_, Ecc256SetC) \
     value(_, Ecc256SetSeed) \
     value(_, Init) \
     value(_, InitKeyMgr) \
-    value(_, KeySideloadFvsr)
+    value(_, KeySideloadFvsr) \
+    value(_, KeySideloadFvsrBatch) \
+    value(_, SeedPrng)
 UJSON_SERDE_ENUM(OtbnScaSubcommand, otbn_sca_subcommand_t, OTBNSCA_SUBCOMMAND);
 
 #define OTBN_SCA_EN_MASKS(field, string) \
@@ -56,6 +63,36 @@ UJSON_SERDE_STRUCT(PenetrationtestOtbnScaKey, penetrationtest_otbn_sca_key_t, OT
     field(fixed_seed, uint32_t)
 UJSON_SERDE_STRUCT(PenetrationtestOtbnScaFixedKey, penetrationtest_otbn_sca_fixed_seed_t, OTBN_SCA_FIXED_SEED);
 
+#define OTBN_SCA_FIXED_SEED_BATCH(field, string) \
+    field(fixed_seed, uint32_t) \
+    field(num_traces, uint32_t)
+UJSON_SERDE_STRUCT(PenetrationtestOtbnScaFixedSeedBatch, penetrationtest_otbn_sca_fixed_seed_batch_t, OTBN_SCA_FIXED_SEED_BATCH);
+
+#define OTBN_SCA_ECDSA_FVSR_BATCH(field, string) \
+    field(fixed_d, uint8_t, OTBNSCA_CMD_MAX_ECC256_BYTES) \
+    field(msg, uint8_t, OTBNSCA_CMD_MAX_ECC256_BYTES) \
+    field(num_traces, uint32_t)
+UJSON_SERDE_STRUCT(PenetrationtestOtbnScaEcdsaFvsrBatch, penetrationtest_otbn_sca_ecdsa_fvsr_batch_t, OTBN_SCA_ECDSA_FVSR_BATCH);
+
+#define OTBN_SCA_ECDSA_SIGNATURE(field, string) \
+    field(r, uint8_t, OTBNSCA_CMD_MAX_ECC256_BYTES) \
+    field(s, uint8_t, OTBNSCA_CMD_MAX_ECC256_BYTES)
+UJSON_SERDE_STRUCT(PenetrationtestOtbnScaEcdsaSignature, penetrationtest_otbn_sca_ecdsa_signature_t, OTBN_SCA_ECDSA_SIGNATURE);
+
+#define OTBN_SCA_MODINV_FVSR_BATCH(field, string) \
+    field(fixed_k, uint8_t, OTBNSCA_CMD_MAX_SEED_BYTES) \
+    field(num_traces, uint32_t)
+UJSON_SERDE_STRUCT(PenetrationtestOtbnScaModinvFvsrBatch, penetrationtest_otbn_sca_modinv_fvsr_batch_t, OTBN_SCA_MODINV_FVSR_BATCH);
+
+#define OTBN_SCA_MODINV_RESULT(field, string) \
+    field(kalpha_inv, uint8_t, OTBNSCA_CMD_MAX_ECC256_BYTES) \
+    field(alpha, uint8_t, OTBNSCA_CMD_MAX_MODINV_ALPHA_BYTES)
+UJSON_SERDE_STRUCT(PenetrationtestOtbnScaModinvResult, penetrationtest_otbn_sca_modinv_result_t, OTBN_SCA_MODINV_RESULT);
+
+#define OTBN_SCA_PRNG_SEED(field, string) \
+    field(seed, uint8_t, OTBNSCA_CMD_MAX_PRNG_SEED_BYTES)
+UJSON_SERDE_STRUCT(PenetrationtestOtbnScaPrngSeed, penetrationtest_otbn_sca_prng_seed_t, OTBN_SCA_PRNG_SEED);
+
 // clang-format on
 
 #ifdef __cplusplus
@@ -9,12 +9,35 @@
 extern "C" {
 #endif
 
+#define PENTEST_BATCH_ANOMALY_BITMAP_WORDS 32
+#define PENTEST_TRIGGER_CALIBRATION_HISTOGRAM_BINS 16
+
 // clang-format off
 
 #define PENETRATIONTEST_DEVICE_ID(field, string) \
     field(device_id, uint32_t, 8)
 UJSON_SERDE_STRUCT(PenetrationtestDeviceId, penetrationtest_device_id_t, PENETRATIONTEST_DEVICE_ID);
 
+#define PENETRATIONTEST_NUM_ITERATIONS(field, string) \
+    field(num_iterations, uint32_t)
+UJSON_SERDE_STRUCT(PenetrationtestNumIterations, penetrationtest_num_iterations_t, PENETRATIONTEST_NUM_ITERATIONS);
+
+#define PENETRATIONTEST_BATCH_DIGEST(field, string) \
+    field(hash, uint32_t) \
+    field(num_results, uint32_t) \
+    field(num_anomalies, uint32_t) \
+    field(anomaly_bitmap, uint32_t, PENTEST_BATCH_ANOMALY_BITMAP_WORDS)
+UJSON_SERDE_STRUCT(PenetrationtestBatchDigest, penetrationtest_batch_digest_t, PENETRATIONTEST_BATCH_DIGEST);
+
+#define PENETRATIONTEST_TRIGGER_CALIBRATION(field, string) \
+    field(num_samples, uint32_t) \
+    field(min_cycles, uint32_t) \
+    field(max_cycles, uint32_t) \
+    field(mean_cycles, uint32_t) \
+    field(variance, uint32_t) \
+    field(histogram, uint32_t, PENTEST_TRIGGER_CALIBRATION_HISTOGRAM_BINS)
+UJSON_SERDE_STRUCT(PenetrationtestTriggerCalibration, penetrationtest_trigger_calibration_t, PENETRATIONTEST_TRIGGER_CALIBRATION);
+
 // clang-format on
 
 #ifdef __cplusplus
@@ -16,7 +16,8 @@ extern "C" {
 // PRNG SCA arguments
 
 #define PRNGSCA_SUBCOMMAND(_, value) \
-    value(_, SeedPrng)
+    value(_, SeedPrng) \
+    value(_, GenerateBatch)
 UJSON_SERDE_ENUM(PrngScaSubcommand, prng_sca_subcommand_t, PRNGSCA_SUBCOMMAND);
 
 #define PRNG_SCA_LFSR(field, string) \
@@ -24,6 +25,14 @@ UJSON_SERDE_ENUM(PrngScaSubcommand, prng_sca_subcommand_t, PRNGSCA_SUBCOMMAND);
     field(seed_length, size_t)
 UJSON_SERDE_STRUCT(CryptotestPrngScaLfsr, cryptotest_prng_sca_lfsr_t, PRNG_SCA_LFSR);
 
+#define PRNG_SCA_NUM_VALUES(field, string) \
+    field(num_values, uint32_t)
+UJSON_SERDE_STRUCT(CryptotestPrngScaNumValues, cryptotest_prng_sca_num_values_t, PRNG_SCA_NUM_VALUES);
+
+#define PRNG_SCA_VALUE(field, string) \
+    field(value, uint32_t)
+UJSON_SERDE_STRUCT(CryptotestPrngScaValue, cryptotest_prng_sca_value_t, PRNG_SCA_VALUE);
+
 // clang-format on
 
 #ifdef __cplusplus
@@ -16,13 +16,20 @@ extern "C" {
 // TRIGGER SCA arguments
 
 #define TRIGGERSCA_SUBCOMMAND(_, value) \
-    value(_, SelectTriggerSource)
+    value(_, SelectTriggerSource) \
+    value(_, PulseBatch) \
+    value(_, CalibrationStart) \
+    value(_, CalibrationReport)
 UJSON_SERDE_ENUM(TriggerScaSubcommand, trigger_sca_subcommand_t, TRIGGERSCA_SUBCOMMAND);
 
 #define TRIGGER_SCA_SOURCE(field, string) \
     field(source, uint8_t)
 UJSON_SERDE_STRUCT(CryptotestTriggerScaSource, cryptotest_trigger_sca_source_t, TRIGGER_SCA_SOURCE);
 
+#define TRIGGER_SCA_NUM_PULSES(field, string) \
+    field(num_pulses, uint32_t)
+UJSON_SERDE_STRUCT(CryptotestTriggerScaNumPulses, cryptotest_trigger_sca_num_pulses_t, TRIGGER_SCA_NUM_PULSES);
+
 // clang-format on
 
 #ifdef __cplusplus
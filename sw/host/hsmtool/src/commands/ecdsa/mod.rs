@@ -15,6 +15,7 @@ pub mod export;
 pub mod generate;
 pub mod import;
 pub mod sign;
+pub mod sign_batch;
 pub mod verify;
 
 #[derive(clap::Subcommand, Debug, Serialize, Deserialize)]
@@ -23,6 +24,7 @@ pub enum Ecdsa {
     Export(export::Export),
     Import(import::Import),
     Sign(sign::Sign),
+    SignBatch(sign_batch::SignBatch),
     Verify(verify::Verify),
 }
 
@@ -39,6 +41,7 @@ impl Dispatch for Ecdsa {
             Ecdsa::Export(x) => x.run(context, hsm, session),
             Ecdsa::Import(x) => x.run(context, hsm, session),
             Ecdsa::Sign(x) => x.run(context, hsm, session),
+            Ecdsa::SignBatch(x) => x.run(context, hsm, session),
             Ecdsa::Verify(x) => x.run(context, hsm, session),
         }
     }
@@ -51,6 +54,7 @@ impl Dispatch for Ecdsa {
             Ecdsa::Export(x) => x.leaf(),
             Ecdsa::Import(x) => x.leaf(),
             Ecdsa::Sign(x) => x.leaf(),
+            Ecdsa::SignBatch(x) => x.leaf(),
             Ecdsa::Verify(x) => x.leaf(),
         }
     }
@@ -3,7 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 use anyhow::Result;
-use cryptoki::object::Attribute;
+use cryptoki::object::{Attribute, ObjectHandle};
 use cryptoki::session::Session;
 use serde::{Deserialize, Serialize};
 use serde_annotate::Annotate;
@@ -47,22 +47,8 @@ impl Dispatch for Sign {
         attrs.push(Attribute::Sign(true));
         let object = helper::find_one_object(session, &attrs)?;
 
-        let mut data = helper::read_file(&self.input)?;
-        if self.little_endian {
-            // OpenTitanTool writes digest files in little-endian byte order,
-            // (same as the hmac peripheral's default output mode).  The ECDSA
-            // implementation performs the signature calculation with the bytes in
-            // big-endian order.
-            data.reverse();
-        }
-        let data = self.format.prepare(KeyType::Ec, &data)?;
-        let mechanism = self.format.mechanism(KeyType::Ec)?;
-        let mut result = session.sign(&mechanism, object, &data)?;
-        if self.little_endian {
-            let half = result.len() / 2;
-            result[..half].reverse();
-            result[half..].reverse();
-        }
+        let data = helper::read_file(&self.input)?;
+        let (data, result) = sign_data(session, object, self.format, self.little_endian, data)?;
         if let Some(output) = &self.output {
             helper::write_file(output, &result)?;
         }
@@ -72,3 +58,31 @@ impl Dispatch for Sign {
         }))
     }
 }
+
+/// Signs `data` with the ECDSA key `object`.
+///
+/// Returns the prepared digest and the signature.
+pub(crate) fn sign_data(
+    session: &Session,
+    object: ObjectHandle,
+    format: SignData,
+    little_endian: bool,
+    mut data: Vec<u8>,
+) -> Result<(Vec<u8>, Vec<u8>)> {
+    if little_endian {
+        // OpenTitanTool writes digest files in little-endian byte order,
+        // (same as the hmac peripheral's default output mode).  The ECDSA
+        // implementation performs the signature calculation with the bytes in
+        // big-endian order.
+        data.reverse();
+    }
+    let data = format.prepare(KeyType::Ec, &data)?;
+    let mechanism = format.mechanism(KeyType::Ec)?;
+    let mut result = session.sign(&mechanism, object, &data)?;
+    if little_endian {
+        let half = result.len() / 2;
+        result[..half].reverse();
+        result[half..].reverse();
+    }
+    Ok((data, result))
+}
@@ -0,0 +1,228 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+use anyhow::{Context, Result};
+use cryptoki::object::{Attribute, AttributeType, ObjectHandle};
+use cryptoki::session::Session;
+use serde::{Deserialize, Serialize};
+use serde_annotate::Annotate;
+use sha2::{Digest, Sha256};
+use std::any::Any;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::time::Instant;
+
+use super::sign::sign_data;
+use crate::commands::Dispatch;
+use crate::error::HsmError;
+use crate::module::Module;
+use crate::util::attribute::KeyType;
+use crate::util::helper;
+use crate::util::signing::SignData;
+
+fn default_jobs() -> usize {
+    4
+}
+
+fn default_extension() -> String {
+    "sig".into()
+}
+
+/// Signs many inputs with one key, keeping several sign requests in flight.
+#[derive(clap::Args, Debug, Serialize, Deserialize)]
+pub struct SignBatch {
+    #[arg(long)]
+    id: Option<String>,
+    #[arg(short, long)]
+    label: Option<String>,
+    #[arg(short, long, value_enum, default_value = "sha256-hash")]
+    format: SignData,
+    /// Reverse the input data and result (for little-endian targets).
+    #[arg(short = 'r', long)]
+    little_endian: bool,
+    /// Number of HSM sessions issuing sign requests concurrently.
+    #[arg(short, long, default_value_t = default_jobs())]
+    #[serde(default = "default_jobs")]
+    jobs: usize,
+    /// Directory receiving one signature per input, named after the input
+    /// file with its extension replaced by `--extension`.
+    #[arg(short, long)]
+    output_dir: PathBuf,
+    #[arg(short, long, default_value_t = default_extension())]
+    #[serde(default = "default_extension")]
+    extension: String,
+    /// Reuse signatures previously made with the same key for the same input.
+    #[arg(long)]
+    #[serde(default)]
+    cache_dir: Option<PathBuf>,
+    #[arg(required = true)]
+    inputs: Vec<PathBuf>,
+}
+
+#[derive(Debug, Serialize, Annotate)]
+pub struct SignBatchEntry {
+    pub input: PathBuf,
+    pub output: PathBuf,
+    // Time from issuing the sign request to receiving the signature.
+    pub latency_us: u64,
+    pub cached: bool,
+}
+
+#[derive(Debug, Serialize, Annotate)]
+pub struct SignBatchResult {
+    pub count: usize,
+    pub cached: usize,
+    pub jobs: usize,
+    pub elapsed_ms: u64,
+    pub signatures_per_second: f64,
+    pub max_latency_us: u64,
+    pub entries: Vec<SignBatchEntry>,
+}
+
+impl SignBatch {
+    fn output_path(&self, input: &Path) -> Result<PathBuf> {
+        let name = input
+            .file_name()
+            .with_context(|| format!("Input {input:?} has no file name"))?;
+        Ok(self
+            .output_dir
+            .join(Path::new(name).with_extension(&self.extension)))
+    }
+
+    /// Returns the cache file for a signature of `data` by the key `key_id`.
+    ///
+    /// The cache is keyed by the key identity, the signing options and the
+    /// input, so that an unchanged image digest is never signed twice.
+    fn cache_path(&self, key_id: &[u8], data: &[u8]) -> Option<PathBuf> {
+        let cache_dir = self.cache_dir.as_ref()?;
+        let mut hasher = Sha256::new();
+        hasher.update((key_id.len() as u64).to_le_bytes());
+        hasher.update(key_id);
+        hasher.update(format!("{:?}/{}", self.format, self.little_endian));
+        hasher.update(data);
+        Some(cache_dir.join(format!("{}.sig", hex::encode(hasher.finalize()))))
+    }
+
+    /// Signs inputs on `session` until none are left.
+    ///
+    /// The workers share the `next` input index, so a slow request on one
+    /// session does not hold back the others. On error, the remaining inputs
+    /// are abandoned by all workers.
+    fn sign_worker(
+        &self,
+        session: &Session,
+        object: ObjectHandle,
+        key_id: &[u8],
+        next: &AtomicUsize,
+        entries: &Mutex<Vec<Option<SignBatchEntry>>>,
+    ) -> Result<()> {
+        let result = (|| -> Result<()> {
+            loop {
+                let i = next.fetch_add(1, Ordering::Relaxed);
+                let Some(input) = self.inputs.get(i) else {
+                    return Ok(());
+                };
+                let data = helper::read_file(input)?;
+                let cache = self.cache_path(key_id, &data);
+                let output = self.output_path(input)?;
+                let start = Instant::now();
+                let cached = cache.as_ref().filter(|c| c.exists());
+                let signature = match cached {
+                    Some(c) => helper::read_file(c)?,
+                    None => sign_data(session, object, self.format, self.little_endian, data)?.1,
+                };
+                let latency = start.elapsed();
+                helper::write_file(&output, &signature)?;
+                if let (Some(c), None) = (&cache, cached) {
+                    helper::write_file(c, &signature)?;
+                }
+                entries.lock().unwrap()[i] = Some(SignBatchEntry {
+                    input: input.clone(),
+                    output,
+                    latency_us: latency.as_micros() as u64,
+                    cached: cached.is_some(),
+                });
+            }
+        })();
+        if result.is_err() {
+            next.store(self.inputs.len(), Ordering::Relaxed);
+        }
+        result
+    }
+}
+
+#[typetag::serde(name = "ecdsa-sign-batch")]
+impl Dispatch for SignBatch {
+    fn run(
+        &self,
+        _context: &dyn Any,
+        hsm: &Module,
+        session: Option<&Session>,
+    ) -> Result<Box<dyn Annotate>> {
+        let session = session.ok_or(HsmError::SessionRequired)?;
+        let token = hsm.token.as_deref().ok_or(HsmError::SessionRequired)?;
+        let mut attrs = helper::search_spec(self.id.as_deref(), self.label.as_deref())?;
+        attrs.push(Attribute::KeyType(KeyType::Ec.try_into()?));
+        attrs.push(Attribute::Sign(true));
+        let object = helper::find_one_object(session, &attrs)?;
+        let mut key_id = Vec::new();
+        for attr in session.get_attributes(object, &[AttributeType::Id, AttributeType::Label])? {
+            match attr {
+                Attribute::Id(v) | Attribute::Label(v) => key_id.extend(v),
+                _ => {}
+            }
+        }
+        std::fs::create_dir_all(&self.output_dir)?;
+        if let Some(cache_dir) = &self.cache_dir {
+            std::fs::create_dir_all(cache_dir)?;
+        }
+
+        // All sessions of an application share its login state, so the
+        // additional sessions can sign without logging in again.
+        let jobs = self.jobs.clamp(1, self.inputs.len().max(1));
+        let slot = hsm.get_token(token)?;
+        let extra_sessions = (1..jobs)
+            .map(|_| hsm.pkcs11.open_rw_session(slot))
+            .collect::<Result<Vec<_>, _>>()?;
+
+        let next = AtomicUsize::new(0);
+        let entries = Mutex::new((0..self.inputs.len()).map(|_| None).collect::<Vec<_>>());
+        let start = Instant::now();
+        std::thread::scope(|s| {
+            let (key_id, next, entries) = (key_id.as_slice(), &next, &entries);
+            let workers = extra_sessions
+                .into_iter()
+                .map(|extra| {
+                    s.spawn(move || self.sign_worker(&extra, object, key_id, next, entries))
+                })
+                .collect::<Vec<_>>();
+            let mut result = self.sign_worker(session, object, key_id, next, entries);
+            for worker in workers {
+                let r = worker.join().expect("sign worker panicked");
+                if result.is_ok() {
+                    result = r;
+                }
+            }
+            result
+        })?;
+        let elapsed = start.elapsed();
+
+        let entries = entries
+            .into_inner()
+            .unwrap()
+            .into_iter()
+            .flatten()
+            .collect::<Vec<_>>();
+        Ok(Box::new(SignBatchResult {
+            count: entries.len(),
+            cached: entries.iter().filter(|e| e.cached).count(),
+            jobs,
+            elapsed_ms: elapsed.as_millis() as u64,
+            signatures_per_second: entries.len() as f64 / elapsed.as_secs_f64(),
+            max_latency_us: entries.iter().map(|e| e.latency_us).max().unwrap_or(0),
+            entries,
+        }))
+    }
+}
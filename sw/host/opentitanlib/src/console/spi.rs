@@ -18,6 +18,9 @@ pub struct SpiConsoleDevice<'a> {
     console_next_frame_number: Cell<u32>,
     rx_buf: RefCell<VecDeque<u8>>,
     next_read_address: Cell<u32>,
+    // The header at `next_read_address`, if it was read along with the data of
+    // the previous frame.
+    next_header: RefCell<Option<Vec<u8>>>,
 }
 
 impl<'a> SpiConsoleDevice<'a> {
@@ -40,6 +43,7 @@ impl<'a> SpiConsoleDevice<'a> {
             rx_buf: RefCell::new(VecDeque::new()),
             console_next_frame_number: Cell::new(0),
             next_read_address: Cell::new(0),
+            next_header: RefCell::new(None),
         })
     }
 
@@ -54,14 +58,21 @@ impl<'a> SpiConsoleDevice<'a> {
         self.flash.program(self.spi, 0, buf)?;
         self.console_next_frame_number.set(0);
         self.next_read_address.set(0);
+        self.next_header.replace(None);
         Ok(0)
     }
 
     fn read_from_spi(&self) -> Result<usize> {
-        // Read the SPI console frame header.
+        // Read the SPI console frame header, unless it came with the previous frame.
         let read_address = self.next_read_address.get();
-        let mut header = vec![0u8; SpiConsoleDevice::SPI_FRAME_HEADER_SIZE];
-        self.read_data(read_address, &mut header)?;
+        let header = match self.next_header.take() {
+            Some(header) => header,
+            None => {
+                let mut header = vec![0u8; SpiConsoleDevice::SPI_FRAME_HEADER_SIZE];
+                self.read_data(read_address, &mut header)?;
+                header
+            }
+        };
 
         let magic_number: u32 = u32::from_le_bytes(header[0..4].try_into().unwrap());
         let frame_number: u32 = u32::from_le_bytes(header[4..8].try_into().unwrap());
@@ -76,13 +87,17 @@ impl<'a> SpiConsoleDevice<'a> {
         }
         self.console_next_frame_number.set(frame_number + 1);
 
-        // Read the SPI console frame data.
+        // Read the SPI console frame data, along with the header of the next frame, which
+        // saves a transaction per frame while the device is streaming. The device allows for
+        // the host reading one header past the last frame it wrote.
         let data_len_bytes_w_pad = (data_len_bytes + 3) & !3;
-        let mut data = vec![0u8; data_len_bytes_w_pad];
+        let mut data = vec![0u8; data_len_bytes_w_pad + SpiConsoleDevice::SPI_FRAME_HEADER_SIZE];
         let data_address: u32 = (read_address
             + u32::try_from(SpiConsoleDevice::SPI_FRAME_HEADER_SIZE).unwrap())
             % SpiConsoleDevice::SPI_FLASH_READ_BUFFER_SIZE;
         self.read_data(data_address, &mut data)?;
+        self.next_header
+            .replace(Some(data[data_len_bytes_w_pad..].to_vec()));
 
         let next_read_address: u32 = (read_address
             + u32::try_from(SpiConsoleDevice::SPI_FRAME_HEADER_SIZE + data_len_bytes_w_pad)
@@ -116,19 +131,24 @@ impl<'a> SpiConsoleDevice<'a> {
 
 impl<'a> ConsoleDevice for SpiConsoleDevice<'a> {
     fn console_read(&self, buf: &mut [u8], _timeout: Duration) -> Result<usize> {
-        // Attempt to refill the internal data queue if it is empty.
-        if self.rx_buf.borrow().is_empty() && self.read_from_spi()? == 0 {
-            return Ok(0);
+        // Attempt to refill the internal data queue if it is empty, taking as many frames as
+        // are ready and fit in the output buffer.
+        if self.rx_buf.borrow().is_empty() {
+            while self.rx_buf.borrow().len() < buf.len() {
+                if self.read_from_spi()? == 0 {
+                    break;
+                }
+            }
         }
 
         // Copy from the internal data queue to the output buffer.
-        let mut i: usize = 0;
-        while !self.rx_buf.borrow().is_empty() && i < buf.len() {
-            buf[i] = self.rx_buf.borrow_mut().pop_front().unwrap();
-            i += 1;
+        let mut rx_buf = self.rx_buf.borrow_mut();
+        let len = std::cmp::min(rx_buf.len(), buf.len());
+        for (dst, src) in buf.iter_mut().zip(rx_buf.drain(..len)) {
+            *dst = src;
         }
 
-        Ok(i)
+        Ok(len)
     }
 
     fn console_write(&self, buf: &[u8]) -> Result<()> {
@@ -0,0 +1,290 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+//! Host side of the ujson binary format (`kUjsonFormatBinary`).
+//!
+//! Values are written one after the other with no keys, separators or
+//! framing: integers, enums and `status_t` as their little-endian bytes,
+//! booleans as one byte and strings as their whole buffer.  Struct fields are
+//! written in declaration order and every element of an array is written, so
+//! each type has a fixed encoded size.  Implementations for the types declared
+//! with `UJSON_SERDE_STRUCT` and `UJSON_SERDE_ENUM` are generated by
+//! `ujson_rust`.
+
+use arrayvec::ArrayVec;
+use thiserror::Error;
+
+use crate::test_utils::status::Status;
+
+#[derive(Debug, Error, PartialEq, Eq)]
+pub enum UjsonBinaryError {
+    #[error("Binary ujson input ended early (needed {needed} bytes, got {remaining})")]
+    Truncated { needed: usize, remaining: usize },
+    #[error("Invalid boolean {0} in binary ujson input")]
+    InvalidBool(u8),
+}
+
+pub type Result<T> = std::result::Result<T, UjsonBinaryError>;
+
+/// A type with a ujson binary encoding.
+pub trait UjsonBinary: Sized {
+    /// The size of the encoding in bytes.
+    const BINARY_SIZE: usize;
+
+    /// Appends the encoding of `self` to `out`.
+    fn write_binary(&self, out: &mut Vec<u8>);
+
+    /// Decodes a value from the start of `input` and advances `input` past it.
+    fn read_binary(input: &mut &[u8]) -> Result<Self>;
+
+    /// Encodes `self` into `out`, which is cleared first.
+    ///
+    /// Reusing `out` across calls avoids allocating per message.
+    fn to_binary(&self, out: &mut Vec<u8>) {
+        out.clear();
+        out.reserve(Self::BINARY_SIZE);
+        self.write_binary(out);
+    }
+
+    /// Decodes a value that fills all of `input`.
+    fn from_binary(mut input: &[u8]) -> Result<Self> {
+        let value = Self::read_binary(&mut input)?;
+        if !input.is_empty() {
+            log::warn!("{} trailing bytes after binary ujson value", input.len());
+        }
+        Ok(value)
+    }
+}
+
+/// Takes the next `n` bytes of `input`.
+pub fn take<'a>(input: &mut &'a [u8], n: usize) -> Result<&'a [u8]> {
+    if input.len() < n {
+        return Err(UjsonBinaryError::Truncated {
+            needed: n,
+            remaining: input.len(),
+        });
+    }
+    let (head, tail) = input.split_at(n);
+    *input = tail;
+    Ok(head)
+}
+
+macro_rules! impl_ujson_binary_int {
+    ($($t:ty),* $(,)?) => {$(
+        impl UjsonBinary for $t {
+            const BINARY_SIZE: usize = std::mem::size_of::<$t>();
+
+            fn write_binary(&self, out: &mut Vec<u8>) {
+                out.extend_from_slice(&self.to_le_bytes());
+            }
+
+            fn read_binary(input: &mut &[u8]) -> Result<Self> {
+                let bytes = take(input, Self::BINARY_SIZE)?;
+                Ok(<$t>::from_le_bytes(bytes.try_into().unwrap()))
+            }
+        }
+    )*};
+}
+
+impl_ujson_binary_int!(u8, u16, u32, u64, i8, i16, i32, i64);
+
+// `size_t` is 32 bits wide on the device.
+impl UjsonBinary for usize {
+    const BINARY_SIZE: usize = 4;
+
+    fn write_binary(&self, out: &mut Vec<u8>) {
+        (*self as u32).write_binary(out);
+    }
+
+    fn read_binary(input: &mut &[u8]) -> Result<Self> {
+        Ok(u32::read_binary(input)? as usize)
+    }
+}
+
+impl UjsonBinary for bool {
+    const BINARY_SIZE: usize = 1;
+
+    fn write_binary(&self, out: &mut Vec<u8>) {
+        out.push(*self as u8);
+    }
+
+    fn read_binary(input: &mut &[u8]) -> Result<Self> {
+        match u8::read_binary(input)? {
+            0 => Ok(false),
+            1 => Ok(true),
+            v => Err(UjsonBinaryError::InvalidBool(v)),
+        }
+    }
+}
+
+// Arrays always occupy all `N` elements; missing elements are written as
+// zeros and decoding always yields `N` elements.
+impl<T: UjsonBinary, const N: usize> UjsonBinary for ArrayVec<T, N> {
+    const BINARY_SIZE: usize = N * T::BINARY_SIZE;
+
+    fn write_binary(&self, out: &mut Vec<u8>) {
+        for item in self {
+            item.write_binary(out);
+        }
+        out.resize(out.len() + (N - self.len()) * T::BINARY_SIZE, 0);
+    }
+
+    fn read_binary(input: &mut &[u8]) -> Result<Self> {
+        let mut result = ArrayVec::new();
+        for _ in 0..N {
+            result.push(T::read_binary(input)?);
+        }
+        Ok(result)
+    }
+}
+
+/// Appends a string as a nul-padded buffer of `size` bytes.
+pub fn write_string(s: &str, size: usize, out: &mut Vec<u8>) {
+    let bytes = &s.as_bytes()[..s.len().min(size)];
+    out.extend_from_slice(bytes);
+    out.resize(out.len() + size - bytes.len(), 0);
+}
+
+/// Decodes a nul-padded string buffer of `size` bytes.
+pub fn read_string(input: &mut &[u8], size: usize) -> Result<String> {
+    let bytes = take(input, size)?;
+    let len = bytes.iter().position(|&b| b == 0).unwrap_or(size);
+    Ok(String::from_utf8_lossy(&bytes[..len]).into_owned())
+}
+
+const STATUS_ERROR_BIT: u32 = 1 << 31;
+
+fn status_module(value: u32) -> String {
+    let module = value >> 16;
+    (0..3)
+        .map(|i| char::from(b'@' + ((module >> (5 * i)) & 0x1f) as u8))
+        .collect()
+}
+
+// `status_t` is sent as its raw 32-bit value; see `sw/device/lib/base/status.h`
+// for the layout of error values.
+impl UjsonBinary for Status {
+    const BINARY_SIZE: usize = 4;
+
+    fn write_binary(&self, out: &mut Vec<u8>) {
+        let (code, module, line) = match self {
+            Status::Ok(v) => return (*v & !STATUS_ERROR_BIT).write_binary(out),
+            Status::Cancelled(m, l) => (1, m, l),
+            Status::Unknown(m, l) => (2, m, l),
+            Status::InvalidArgument(m, l) => (3, m, l),
+            Status::DeadlineExceeded(m, l) => (4, m, l),
+            Status::NotFound(m, l) => (5, m, l),
+            Status::AlreadyExists(m, l) => (6, m, l),
+            Status::PermissionDenied(m, l) => (7, m, l),
+            Status::ResourceExhausted(m, l) => (8, m, l),
+            Status::FailedPrecondition(m, l) => (9, m, l),
+            Status::Aborted(m, l) => (10, m, l),
+            Status::OutOfRange(m, l) => (11, m, l),
+            Status::Unimplemented(m, l) => (12, m, l),
+            Status::Internal(m, l) => (13, m, l),
+            Status::Unavailable(m, l) => (14, m, l),
+            Status::DataLoss(m, l) => (15, m, l),
+            Status::Unauthenticated(m, l) => (16, m, l),
+        };
+        let module = module
+            .bytes()
+            .take(3)
+            .enumerate()
+            .fold(0u32, |acc, (i, c)| {
+                acc | (((c.wrapping_sub(b'@')) as u32 & 0x1f) << (5 * i))
+            });
+        let value = STATUS_ERROR_BIT | module << 16 | (line & 0x7ff) << 5 | code;
+        value.write_binary(out);
+    }
+
+    fn read_binary(input: &mut &[u8]) -> Result<Self> {
+        let value = u32::read_binary(input)?;
+        if value & STATUS_ERROR_BIT == 0 {
+            return Ok(Status::Ok(value));
+        }
+        let m = status_module(value);
+        let l = (value >> 5) & 0x7ff;
+        Ok(match value & 0x1f {
+            1 => Status::Cancelled(m, l),
+            3 => Status::InvalidArgument(m, l),
+            4 => Status::DeadlineExceeded(m, l),
+            5 => Status::NotFound(m, l),
+            6 => Status::AlreadyExists(m, l),
+            7 => Status::PermissionDenied(m, l),
+            8 => Status::ResourceExhausted(m, l),
+            9 => Status::FailedPrecondition(m, l),
+            10 => Status::Aborted(m, l),
+            11 => Status::OutOfRange(m, l),
+            12 => Status::Unimplemented(m, l),
+            13 => Status::Internal(m, l),
+            14 => Status::Unavailable(m, l),
+            15 => Status::DataLoss(m, l),
+            16 => Status::Unauthenticated(m, l),
+            _ => Status::Unknown(m, l),
+        })
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    #[test]
+    fn test_integers() -> Result<()> {
+        let mut out = Vec::new();
+        0x12345678u32.write_binary(&mut out);
+        (-2i16).write_binary(&mut out);
+        7usize.write_binary(&mut out);
+        true.write_binary(&mut out);
+        assert_eq!(out, [0x78, 0x56, 0x34, 0x12, 0xfe, 0xff, 7, 0, 0, 0, 1]);
+
+        let mut input = out.as_slice();
+        assert_eq!(u32::read_binary(&mut input)?, 0x12345678);
+        assert_eq!(i16::read_binary(&mut input)?, -2);
+        assert_eq!(usize::read_binary(&mut input)?, 7);
+        assert!(bool::read_binary(&mut input)?);
+        assert!(input.is_empty());
+        assert_eq!(
+            u8::read_binary(&mut input),
+            Err(UjsonBinaryError::Truncated {
+                needed: 1,
+                remaining: 0
+            })
+        );
+        Ok(())
+    }
+
+    #[test]
+    fn test_arrays_are_padded() -> Result<()> {
+        let value: ArrayVec<u16, 3> = [1u16].into_iter().collect();
+        let mut out = Vec::new();
+        value.to_binary(&mut out);
+        assert_eq!(out, [1, 0, 0, 0, 0, 0]);
+        assert_eq!(ArrayVec::<u16, 3>::from_binary(&out)?.as_slice(), [1, 0, 0]);
+        Ok(())
+    }
+
+    #[test]
+    fn test_string() -> Result<()> {
+        let mut out = Vec::new();
+        write_string("Hello", 8, &mut out);
+        assert_eq!(out, b"Hello\0\0\0");
+        assert_eq!(read_string(&mut out.as_slice(), 8)?, "Hello");
+        Ok(())
+    }
+
+    #[test]
+    fn test_status() -> Result<()> {
+        for status in [
+            Status::Ok(1234),
+            Status::InvalidArgument("FOO".into(), 5),
+            Status::Internal("EXJ".into(), 2047),
+        ] {
+            let mut out = Vec::new();
+            status.to_binary(&mut out);
+            assert_eq!(Status::from_binary(&out)?, status);
+        }
+        Ok(())
+    }
+}
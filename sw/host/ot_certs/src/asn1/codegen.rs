@@ -628,10 +628,10 @@ impl Builder for Codegen<'_> {
         );
         self.tag_idx += 1;
         self.push_str_with_indent(&format!("asn1_tag_t {tag_name};\n"));
-        self.push_str_with_indent(&format!(
-            "RETURN_IF_ERROR(asn1_start_tag(&state, &{tag_name}, {}));\n",
-            tag.codestring()
-        ));
+        // The call that starts the tag is inserted here once the content has been
+        // generated, so that it can pass the maximum content size as a hint.
+        let start_tag_pos = self.output.len();
+        let start_tag_indent = self.indent.repeat(self.indent_lvl);
         self.push_str_with_indent("{\n");
         self.indent_lvl += 1;
         // We do not yet know how many bytes the content will use: remember the current
@@ -641,9 +641,65 @@ impl Builder for Codegen<'_> {
         gen(self)?;
         let max_size = self.max_out_size - old_max_size;
         self.max_out_size += Self::tag_size(max_size);
+        self.output.insert_str(
+            start_tag_pos,
+            &format!(
+                "{start_tag_indent}RETURN_IF_ERROR(asn1_start_tag_sized(&state, &{tag_name}, {}, {max_size}));\n",
+                tag.codestring()
+            ),
+        );
         self.indent_lvl -= 1;
         self.push_str_with_indent("}\n");
         self.push_str_with_indent(&format!("RETURN_IF_ERROR(asn1_finish_tag(&{tag_name}));\n"));
         Ok(())
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use indoc::indoc;
+
+    #[test]
+    fn test_asn1_codegen_tag_size_hint() -> Result<()> {
+        let mut constants = ConstantPool::new();
+        let no_variables = |name: &str| -> Result<VariableInfo> { bail!("no variable {name}") };
+        let (code, max_size) = Codegen::generate(
+            "buf",
+            "buf_size",
+            "  ",
+            0,
+            &mut constants,
+            &no_variables,
+            |builder| {
+                builder.push_tag(Some("outer".into()), &Tag::Sequence, |builder| {
+                    builder.push_tag(Some("inner".into()), &Tag::OctetString, |builder| {
+                        builder.push_byte_array(None, &Value::Literal(vec![0x12; 200]))
+                    })
+                })
+            },
+        )?;
+        // Each tag is started with the maximum size of its content, which is only
+        // known once the content has been generated: 200 bytes for the inner tag,
+        // and those plus the inner identifier and length octets for the outer one.
+        const RESULT: &str = indoc! {r#"
+            asn1_state_t state;
+            RETURN_IF_ERROR(asn1_start(&state, buf, *buf_size));
+            asn1_tag_t tag0_outer;
+            RETURN_IF_ERROR(asn1_start_tag_sized(&state, &tag0_outer, kAsn1TagNumberSequence, 203));
+            {
+              asn1_tag_t tag1_inner;
+              RETURN_IF_ERROR(asn1_start_tag_sized(&state, &tag1_inner, kAsn1TagNumberOctetString, 200));
+              {
+                RETURN_IF_ERROR(asn1_push_bytes(&state, kConstant, sizeof(kConstant)));
+              }
+              RETURN_IF_ERROR(asn1_finish_tag(&tag1_inner));
+            }
+            RETURN_IF_ERROR(asn1_finish_tag(&tag0_outer));
+            RETURN_IF_ERROR(asn1_finish(&state, buf_size));
+        "#};
+        assert_eq!(code, RESULT);
+        assert_eq!(max_size, 206);
+        Ok(())
+    }
+}
@@ -295,43 +295,25 @@ fn process_dev_seeds(seeds: &[u8]) -> Result<()> {
     Ok(())
 }
 
-fn provision_certificates(
-    cert_endorsement_key_wrapper: KeyWrapper,
-    perso_certgen_inputs: &ManufCertgenInputs,
-    timeout: Duration,
-    ca_certificate: PathBuf,
-    spi_console: &SpiConsoleDevice,
-) -> Result<()> {
-    // Send attestation TCB measurements for generating DICE certificates.
-    let _ = UartConsole::wait_for(spi_console, r"Waiting for certificate inputs ...", timeout)?;
-    perso_certgen_inputs.send(spi_console)?;
-
-    // Wait until the device exports the TBS certificates.
-    let _ = UartConsole::wait_for(spi_console, r"Exporting TBS certificates ...", timeout)?;
-    let perso_blob = PersoBlob::recv(spi_console, timeout, true)?;
-
-    // Select the CA endorsement key to use.
-    let key = match cert_endorsement_key_wrapper {
-        KeyWrapper::LocalKey(path) => {
-            log::info!("Using local key for cert endorsement");
-            CertEndorsementKey::LocalKey(SecretKey::<NistP256>::read_pkcs8_der_file(path)?)
-        }
-        KeyWrapper::CkmsKey(key_id) => {
-            log::info!("Using Cloud KMS key for cert endorsement");
-            CertEndorsementKey::CkmsKey(key_id)
-        }
-    };
+// Certificates endorsed by the host for one perso blob exported by the device.
+#[derive(Default)]
+struct EndorsedObjects {
+    // Perso objects that the device will hash, in the order they were exported.
+    hashed_data: Vec<u8>,
+    // Certificates endorsed here, to be checked against the CA certificate.
+    host_endorsed_certs: Vec<Vec<u8>>,
+    num_host_endorsed_certs: usize,
+    endorsed_cert_concat: ArrayVec<u8, 4096>,
+}
 
-    // Extract certificate byte vectors, endorse TBS certs, and ensure they parse with OpenSSL.
-    // During the process, both:
-    //   1. prepare a UJSON payload of endorsed certs to send back to the device,
-    //   2. collect the certs that were endorsed to verify their endorsement signatures with OpenSSL, and
-    //   3. hash all certs to check the integrity of what gets written back to the device.
-    let mut cert_hasher = Sha256::new();
+// Extract certificate byte vectors, endorse TBS certs, and ensure they parse with OpenSSL.
+// During the process, both:
+//   1. prepare a UJSON payload of endorsed certs to send back to the device,
+//   2. collect the certs that were endorsed to verify their endorsement signatures with OpenSSL, and
+//   3. collect all certs to check the integrity of what gets written back to the device.
+fn endorse_perso_blob(perso_blob: &PersoBlob, key: &CertEndorsementKey) -> Result<EndorsedObjects> {
+    let mut endorsed = EndorsedObjects::default();
     let mut start: usize = 0;
-    let mut host_endorsed_certs: Vec<Vec<u8>> = Vec::new();
-    let mut num_host_endorsed_certs = 0;
-    let mut endorsed_cert_concat = ArrayVec::<u8, 4096>::new();
 
     for _ in 0..perso_blob.num_objs {
         log::info!("Processing next object");
@@ -347,7 +329,7 @@ fn provision_certificates(
             ObjType::DevSeed => {
                 let dev_seed_size = header.obj_size - obj_header_size;
                 let seeds = &perso_blob.body[start..start + dev_seed_size];
-                cert_hasher.update(seeds);
+                endorsed.hashed_data.extend_from_slice(seeds);
                 process_dev_seeds(seeds)?;
                 start += dev_seed_size;
                 continue;
@@ -361,19 +343,19 @@ fn provision_certificates(
 
         let cert_bytes = if header.obj_type == ObjType::UnendorsedX509Cert {
             // Endorse the cert and updates its size.
-            let cert_bytes = parse_and_endorse_x509_cert(cert.cert_body.clone(), &key)?;
+            let cert_bytes = parse_and_endorse_x509_cert(cert.cert_body.clone(), key)?;
 
             // Prepare a collection of certs whose endorsements should be checked with OpenSSL.
             // TODO: verify the endorsement of the UDS certificate with OpenSSL. It is currently
             // failing signature verification due to the custom DiceTcbInfo extension being a
             // non-recognizable extension that is marked "critical".
             if cert.cert_name != "UDS" {
-                host_endorsed_certs.push(cert_bytes.clone());
+                endorsed.host_endorsed_certs.push(cert_bytes.clone());
             }
 
             // Prepare the UJSON data payloads that will be sent back to the device.
-            push_endorsed_cert(&cert_bytes, &cert, &mut endorsed_cert_concat)?;
-            num_host_endorsed_certs += 1;
+            push_endorsed_cert(&cert_bytes, &cert, &mut endorsed.endorsed_cert_concat)?;
+            endorsed.num_host_endorsed_certs += 1;
             cert_bytes
         } else {
             cert.cert_body
@@ -381,10 +363,61 @@ fn provision_certificates(
         // Ensure all certs parse with OpenSSL (even those that where endorsed on device).
         log::info!("{} Cert: {}", cert.cert_name, hex::encode(&cert_bytes));
         let _ = parse_certificate(&cert_bytes)?;
-        // Push the cert into the hasher so we can ensure the certs written to the device's flash
-        // info pages match those verified on the host.
-        cert_hasher.update(cert_bytes);
+        // Keep the cert so we can ensure the certs written to the device's flash info pages
+        // match those verified on the host.
+        endorsed.hashed_data.extend_from_slice(&cert_bytes);
     }
+    Ok(endorsed)
+}
+
+fn provision_certificates(
+    cert_endorsement_key_wrapper: KeyWrapper,
+    perso_certgen_inputs: &ManufCertgenInputs,
+    timeout: Duration,
+    ca_certificate: PathBuf,
+    spi_console: &SpiConsoleDevice,
+) -> Result<()> {
+    // Send attestation TCB measurements for generating DICE certificates.
+    let _ = UartConsole::wait_for(spi_console, r"Waiting for certificate inputs ...", timeout)?;
+    perso_certgen_inputs.send(spi_console)?;
+
+    // Select the CA endorsement key to use.
+    let key = match cert_endorsement_key_wrapper {
+        KeyWrapper::LocalKey(path) => {
+            log::info!("Using local key for cert endorsement");
+            CertEndorsementKey::LocalKey(SecretKey::<NistP256>::read_pkcs8_der_file(path)?)
+        }
+        KeyWrapper::CkmsKey(key_id) => {
+            log::info!("Using Cloud KMS key for cert endorsement");
+            CertEndorsementKey::CkmsKey(key_id)
+        }
+    };
+
+    // The device exports the UDS TBS certificate as soon as it is built, then
+    // goes on to generate the CDI keys and the extension objects. Endorse the
+    // UDS certificate in the background while waiting for the rest.
+    let _ = UartConsole::wait_for(spi_console, r"Exporting UDS TBS certificate ...", timeout)?;
+    let uds_blob = PersoBlob::recv(spi_console, timeout, true)?;
+    let (uds, rest) = std::thread::scope(|s| -> Result<_> {
+        let uds = s.spawn(|| endorse_perso_blob(&uds_blob, &key));
+
+        // Wait until the device exports the remaining TBS certificates.
+        let rest = UartConsole::wait_for(spi_console, r"Exporting TBS certificates ...", timeout)
+            .and_then(|_| PersoBlob::recv(spi_console, timeout, true));
+        let uds = uds.join().expect("UDS endorsement panicked")?;
+        Ok((uds, endorse_perso_blob(&rest?, &key)?))
+    })?;
+
+    // Combine the results in the order the device exported them; the device
+    // expects the endorsed UDS certificate to come first.
+    let mut cert_hasher = Sha256::new();
+    let mut host_endorsed_certs = uds.host_endorsed_certs;
+    let mut endorsed_cert_concat = uds.endorsed_cert_concat;
+    cert_hasher.update(&uds.hashed_data);
+    cert_hasher.update(&rest.hashed_data);
+    host_endorsed_certs.extend(rest.host_endorsed_certs);
+    endorsed_cert_concat.try_extend_from_slice(&rest.endorsed_cert_concat)?;
+    let num_host_endorsed_certs = uds.num_host_endorsed_certs + rest.num_host_endorsed_certs;
 
     // Execute extension hook.
     endorsed_cert_concat = ft_ext(endorsed_cert_concat)?;
@@ -332,6 +332,15 @@ static int RunTest(USBDevice *dev, const char *in_port, const char *out_port) {
     }
   }
 
+#if STREAMTEST_LIBUSB
+  // Handle libusb events on a dedicated thread, so that transfers continue to
+  // complete whilst the streams are being serviced.
+  if (!dev->StartEventThread()) {
+    std::cerr << "Failed to start event thread" << std::endl;
+    return 1;
+  }
+#endif
+
   std::cout << "Streaming..." << std::endl;
 
   // Times are in microseconds.
@@ -471,10 +480,16 @@ static int RunTest(USBDevice *dev, const char *in_port, const char *out_port) {
   for (unsigned idx = 0U; idx < nstreams; idx++) {
     streams[idx]->Stop();
   }
+  dev->StopEventThread();
+
+  // Report the throughput and transfer latencies of each stream.
+  for (unsigned idx = 0U; idx < nstreams; idx++) {
+    std::string report = streams[idx]->Report(true);
+    if (!report.empty()) {
+      std::cout << streams[idx]->PrefixID() << std::endl << report;
+    }
+  }
 
-  // TODO: introduce a crude estimate of the performance being achieved,
-  // for profiling the performance of IN and OUT traffic; totals and individual
-  // endpoints?
   double elapsed_secs = elapsed_time / 1e6;
   printf("Test completed in %.2lf seconds (%" PRIu64 "us)\n", elapsed_secs,
          elapsed_time);
@@ -36,6 +36,7 @@ bool USBDevice::Init(uint16_t vendorID, uint16_t productID, uint8_t devAddress,
 
 // Finalize use of the device.
 bool USBDevice::Fin() {
+  StopEventThread();
   (void)Close();
 #if STREAMTEST_LIBUSB
   libusb_exit(ctx_);
@@ -205,8 +206,15 @@ bool USBDevice::Close() {
 
 bool USBDevice::Service() {
 #if STREAMTEST_LIBUSB
-  struct timeval tv = {0};
-  int rc = libusb_handle_events_timeout(ctx_, &tv);
+  int rc;
+  if (EventThreadRunning()) {
+    // Events are being handled on the dedicated thread; just report any
+    // failure that it has encountered.
+    rc = eventThreadError_.load();
+  } else {
+    struct timeval tv = {0};
+    rc = libusb_handle_events_timeout(ctx_, &tv);
+  }
   if (rc < 0) {
     return ErrorUSB("ERROR: Handling events", rc);
   }
@@ -214,6 +222,36 @@ bool USBDevice::Service() {
   return true;
 }
 
+bool USBDevice::StartEventThread() {
+#if STREAMTEST_LIBUSB
+  if (!EventThreadRunning()) {
+    eventThreadStop_ = false;
+    eventThreadError_ = 0;
+    eventThread_ = std::thread([this]() {
+      while (!eventThreadStop_.load()) {
+        // Wake periodically to check for a request to exit.
+        struct timeval tv = {0, kEventThreadTimeout};
+        int rc = libusb_handle_events_timeout_completed(ctx_, &tv, nullptr);
+        if (rc < 0 && rc != LIBUSB_ERROR_INTERRUPTED) {
+          int expected = 0;
+          eventThreadError_.compare_exchange_strong(expected, rc);
+        }
+      }
+    });
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void USBDevice::StopEventThread() {
+  if (EventThreadRunning()) {
+    eventThreadStop_ = true;
+    eventThread_.join();
+  }
+}
+
 bool USBDevice::ReadTestDesc() {
   std::cout << "Reading Test Descriptor" << std::endl;
 
@@ -3,7 +3,9 @@
 // SPDX-License-Identifier: Apache-2.0
 #ifndef OPENTITAN_SW_HOST_TESTS_USBDEV_USBDEV_STREAM_USB_DEVICE_H_
 #define OPENTITAN_SW_HOST_TESTS_USBDEV_USBDEV_STREAM_USB_DEVICE_H_
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 // The 'usbdev_serial' class may be used on platforms where libusb support is
 // not available; libusb is required to exercise Isochronous streams, Interrupt
@@ -122,6 +124,25 @@ class USBDevice {
    * @return true iff the device is still operational.
    */
   bool Service();
+  /**
+   * Start a dedicated thread to handle libusb events. Whilst it is running,
+   * transfer callbacks are invoked on that thread rather than from within
+   * Service(), so the completion of transfers is not delayed by the servicing
+   * of the streams.
+   *
+   * @return true iff the thread is running.
+   */
+  bool StartEventThread();
+  /**
+   * Stop the libusb event handling thread, if it is running.
+   */
+  void StopEventThread();
+  /**
+   * Indicates whether libusb events are being handled by a dedicated thread.
+   *
+   * @return true iff the event handling thread is running.
+   */
+  bool EventThreadRunning() const { return eventThread_.joinable(); }
 
 #if STREAMTEST_LIBUSB
   /**
@@ -340,6 +361,13 @@ class USBDevice {
   // Device path (bus number - ports numbers).
   std::string devPath_;
 
+  // Dedicated libusb event handling thread, if any.
+  std::thread eventThread_;
+  // Request for the event handling thread to exit.
+  std::atomic<bool> eventThreadStop_;
+  // First error encountered by the event handling thread.
+  std::atomic<int> eventThreadError_;
+
   usb_testutils_test_number_t testNumber_;
 
   uint8_t testArg_[4];
@@ -347,6 +375,10 @@ class USBDevice {
   // TODO: We should introduce a timeout on libusb Control Transfers.
   static const unsigned kControlTransferTimeout = 0u;
 
+  // Interval (microseconds) at which the event handling thread checks for a
+  // request to exit.
+  static const unsigned kEventThreadTimeout = 10000u;
+
   // Vendor-Specific Commands.
   static const uint8_t kVendorTestConfig = 0x7cu;
   static const uint8_t kVendorTestStatus = 0x7eu;
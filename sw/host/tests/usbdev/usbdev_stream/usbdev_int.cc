@@ -3,20 +3,30 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "usbdev_int.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <sstream>
 
 #include "usbdev_utils.h"
 
-// Stub callback function supplied to libusb.
-void LIBUSB_CALL USBDevInt::CbStubIN(struct libusb_transfer *xfr) {
-  USBDevInt *self = reinterpret_cast<USBDevInt *>(xfr->user_data);
-  self->CallbackIN(xfr);
+USBDevInt::~USBDevInt() {
+  for (Transfer *t : xfrs_) {
+    dev_->FreeTransfer(t->xfr);
+    delete t;
+  }
 }
 
-void LIBUSB_CALL USBDevInt::CbStubOUT(struct libusb_transfer *xfr) {
-  USBDevInt *self = reinterpret_cast<USBDevInt *>(xfr->user_data);
-  self->CallbackOUT(xfr);
+// Callback function supplied to libusb; this may be invoked on the event
+// handling thread, so just queue the transfer for the stream to process.
+void LIBUSB_CALL USBDevInt::CbStub(struct libusb_transfer *xfr) {
+  Transfer *t = reinterpret_cast<Transfer *>(xfr->user_data);
+  t->completed = time_us();
+  bool queued = t->stream->completed_.Push(t);
+  // The queue has room for every transfer that the stream owns.
+  assert(queued);
+  (void)queued;
 }
 
 bool USBDevInt::Open(unsigned interface) {
@@ -32,19 +42,33 @@ bool USBDevInt::Open(unsigned interface) {
   epOut_ = interface + 1U;
   epIn_ = 0x80U | epOut_;
 
-  // No transfers in progress.
-  xfrIn_ = nullptr;
-
-  xfrOut_ = nullptr;
-
   maxPacketSize_ = USBDevice::kDevDataMaxPacketSize;
 
+  // Allocate the pool of transfers.
+  if (xfrs_.empty()) {
+    for (unsigned idx = 0U; idx < 2U * kNumTransfers; idx++) {
+      Transfer *t = new Transfer();
+      t->stream = this;
+      t->in = (idx < kNumTransfers);
+      t->xfr = dev_->AllocTransfer(0U);
+      if (!t->xfr) {
+        delete t;
+        return false;
+      }
+      xfrs_.push_back(t);
+      (t->in ? freeIn_ : freeOut_).push_back(t);
+    }
+  }
+
   return true;
 }
 
 void USBDevInt::Stop() {
   SetClosing(true);
 
+  // Retrieve any transfers still in flight.
+  Drain(true);
+
   int rc = dev_->ReleaseInterface(interface_);
   if (rc < 0) {
     std::cerr << "" << std::endl;
@@ -57,9 +81,7 @@ void USBDevInt::Pause() {
   if (verbose_) {
     std::cout << PrefixID() << "waiting to close" << std::endl;
   }
-  while (inActive_ || outActive_) {
-    dev_->Service();
-  }
+  Drain(false);
   if (verbose_) {
     std::cout << PrefixID() << " closed" << std::endl;
   }
@@ -80,8 +102,68 @@ bool USBDevInt::Resume() {
   return true;
 }
 
+void USBDevInt::Drain(bool cancel) {
+  if (cancel) {
+    for (Transfer *t : xfrs_) {
+      if (std::find(freeIn_.begin(), freeIn_.end(), t) == freeIn_.end() &&
+          std::find(freeOut_.begin(), freeOut_.end(), t) == freeOut_.end()) {
+        (void)dev_->CancelTransfer(t->xfr);
+      }
+    }
+  }
+  while ((inFlight_ || outFlight_) && dev_->Service()) {
+    if (!ProcessCompletions()) {
+      failed_ = true;
+    }
+  }
+}
+
+void USBDevInt::RecordStats(Stats &stats, const Transfer *t) {
+  if (!stats.transfers) {
+    stats.first = t->completed;
+  }
+  stats.last = t->completed;
+  stats.transfers++;
+  stats.bytes += t->xfr->actual_length;
+
+  uint64_t latency = t->completed - t->submitted;
+  unsigned bucket = 0U;
+  while (bucket < kLatencyBuckets - 1U && latency >= (1U << bucket)) {
+    bucket++;
+  }
+  stats.latency[bucket]++;
+}
+
+std::string USBDevInt::ReportStats(const char *name, const Stats &stats) {
+  std::ostringstream os;
+  os << name << ": " << stats.transfers << " transfer(s), " << stats.bytes
+     << " byte(s)";
+  uint64_t elapsed = stats.last - stats.first;
+  if (elapsed > 0U) {
+    os << ", " << (stats.bytes * 1000000U) / elapsed << " B/s";
+  }
+  os << std::endl << "  latency (us):";
+  for (unsigned bucket = 0U; bucket < kLatencyBuckets; bucket++) {
+    if (stats.latency[bucket]) {
+      if (bucket < kLatencyBuckets - 1U) {
+        os << " <" << (1U << bucket);
+      } else {
+        os << " >=" << (1U << (bucket - 1U));
+      }
+      os << ":" << stats.latency[bucket];
+    }
+  }
+  os << std::endl;
+  return os.str();
+}
+
 // Return a summary report of the stream settings of status.
-std::string USBDevInt::Report(bool status, bool verbose) const { return ""; }
+std::string USBDevInt::Report(bool status, bool verbose) const {
+  if (!status) {
+    return "";
+  }
+  return ReportStats("IN", inStats_) + ReportStats("OUT", outStats_);
+}
 
 void USBDevInt::DumpIntTransfer(struct libusb_transfer *xfr) const {
   const void *buf = reinterpret_cast<void *>(xfr->buffer);
@@ -90,76 +172,79 @@ void USBDevInt::DumpIntTransfer(struct libusb_transfer *xfr) const {
   buffer_dump(stdout, xfr->buffer, xfr->actual_length);
 }
 
+bool USBDevInt::Submit(Transfer *t) {
+  t->submitted = time_us();
+  int rc = dev_->SubmitTransfer(t->xfr);
+  if (rc < 0) {
+    return dev_->ErrorUSB("ERROR: Submitting transfer", rc);
+  }
+  return true;
+}
+
 // Retrieving of IN traffic from device.
 bool USBDevInt::ServiceIN() {
-  // Ensure that we have enough space available for a full packet; the device
-  // software decides upon the length of each packet.
-  uint8_t *space;
-  bool ok = ProvisionSpace(&space, maxPacketSize_);
-  if (ok) {
-    uint32_t to_fetch = maxPacketSize_;
-    if (to_fetch > transfer_bytes_ - bytes_recvd_) {
-      to_fetch = transfer_bytes_ - bytes_recvd_;
+  while (!freeIn_.empty()) {
+    // The device software decides upon the length of each packet, so each
+    // transfer must have space for a full packet; don't request data beyond
+    // the end of the stream.
+    uint32_t outstanding = bytes_recvd_ + inRequested_;
+    if (outstanding >= transfer_bytes_) {
+      break;
     }
-
-    if (!xfrIn_) {
-      xfrIn_ = dev_->AllocTransfer(0U);
-      if (!xfrIn_) {
-        return false;
-      }
+    uint32_t to_fetch = maxPacketSize_;
+    if (to_fetch > transfer_bytes_ - outstanding) {
+      to_fetch = transfer_bytes_ - outstanding;
     }
 
+    Transfer *t = freeIn_.back();
     if (bulk_) {
-      dev_->FillBulkTransfer(xfrIn_, epIn_, space, to_fetch, CbStubIN, this,
+      dev_->FillBulkTransfer(t->xfr, epIn_, t->buf, to_fetch, CbStub, t,
                              kDataTimeout);
     } else {
-      dev_->FillIntTransfer(xfrIn_, epIn_, space, to_fetch, CbStubIN, this,
+      dev_->FillIntTransfer(t->xfr, epIn_, t->buf, to_fetch, CbStub, t,
                             kDataTimeout);
     }
-
-    int rc = dev_->SubmitTransfer(xfrIn_);
-    if (rc < 0) {
-      return dev_->ErrorUSB("ERROR: Submitting IN transfer", rc);
+    if (!Submit(t)) {
+      return false;
     }
-    inActive_ = true;
-  } else {
-    inActive_ = false;
+    freeIn_.pop_back();
+    inRequested_ += to_fetch;
+    inFlight_++;
   }
-
   return true;
 }
 
 // Sending of OUT traffic to device.
 bool USBDevInt::ServiceOUT() {
-  // Do we have any data ready to send?
-  uint8_t *data;
-  uint32_t num_bytes = DataAvailable(&data);
-  if (num_bytes > 0U) {
-    // Supply details of the single OUT packet.
-    if (!xfrOut_) {
-      xfrOut_ = dev_->AllocTransfer(0U);
-      if (!xfrOut_) {
-        // Stream is not operational.
-        return false;
-      }
+  while (!freeOut_.empty()) {
+    // Do we have any data ready to send?
+    uint8_t *data;
+    uint32_t num_bytes = DataAvailable(&data);
+    if (!num_bytes) {
+      // Nothing to propagate at this time.
+      break;
+    }
+    if (num_bytes > kMaxTransferBytes) {
+      num_bytes = kMaxTransferBytes;
     }
 
+    // Take a copy of the data so that the stream buffer space may be reused
+    // immediately; the bytes are counted as sent once the transfer completes.
+    Transfer *t = freeOut_.back();
+    memcpy(t->buf, data, num_bytes);
     if (bulk_) {
-      dev_->FillBulkTransfer(xfrOut_, epOut_, data, num_bytes, CbStubOUT, this,
+      dev_->FillBulkTransfer(t->xfr, epOut_, t->buf, num_bytes, CbStub, t,
                              kDataTimeout);
     } else {
-      dev_->FillIntTransfer(xfrOut_, epOut_, data, num_bytes, CbStubOUT, this,
+      dev_->FillIntTransfer(t->xfr, epOut_, t->buf, num_bytes, CbStub, t,
                             kDataTimeout);
     }
-
-    int rc = dev_->SubmitTransfer(xfrOut_);
-    if (rc < 0) {
-      return dev_->ErrorUSB("ERROR: Submitting OUT transfer", rc);
+    if (!Submit(t)) {
+      return false;
     }
-    outActive_ = true;
-  } else {
-    // Nothing to propagate at this time.
-    outActive_ = false;
+    freeOut_.pop_back();
+    DiscardData(num_bytes);
+    outFlight_++;
   }
   // Stream remains operational, even if it presently has no work on the OUT
   // side.
@@ -170,106 +255,140 @@ bool USBDevInt::Service() {
   if (failed_) {
     return false;
   }
-  // (Re)start IN traffic if not already in progress.
-  if (!inActive_ && !ServiceIN()) {
+  // Process any completed transfers.
+  if (!ProcessCompletions()) {
+    failed_ = true;
     return false;
   }
-  // (Re)start OUT traffic if not already in progress and there is
-  // data available to be transmitted.
-  if (!outActive_ && !ServiceOUT()) {
-    return false;
+  if (CanSchedule()) {
+    // Keep IN traffic flowing.
+    if (!ServiceIN()) {
+      return false;
+    }
+    // Send any data available to be transmitted.
+    if (!ServiceOUT()) {
+      return false;
+    }
   }
   return true;
 }
 
-// Callback function supplied to libusb for IN transfers.
-void USBDevInt::CallbackIN(struct libusb_transfer *xfr) {
+bool USBDevInt::ProcessCompletions() {
+  Transfer *t;
+  while (completed_.Pop(&t)) {
+    if (t->in) {
+      // IN data must be accepted in order, and may have to wait for space.
+      inFlight_--;
+      pendingIn_.push(t);
+    } else if (!CompletedOUT(t)) {
+      return false;
+    }
+  }
+  while (!pendingIn_.empty()) {
+    t = pendingIn_.front();
+    if (t->xfr->status == LIBUSB_TRANSFER_COMPLETED && t->xfr->actual_length &&
+        !ProvisionSpace(nullptr, t->xfr->actual_length)) {
+      // Await the transmission of buffered data.
+      break;
+    }
+    pendingIn_.pop();
+    if (!CompletedIN(t)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// A completed IN transfer.
+bool USBDevInt::CompletedIN(Transfer *t) {
+  struct libusb_transfer *xfr = t->xfr;
+  inRequested_ -= xfr->length;
+  freeIn_.push_back(t);
+
   if (xfr->status != LIBUSB_TRANSFER_COMPLETED) {
+    if (xfr->status == LIBUSB_TRANSFER_CANCELLED && !CanSchedule()) {
+      return true;
+    }
     std::cerr << PrefixID() << " Invalid/unexpected IN transfer status "
               << xfr->status << std::endl;
     std::cerr << "length " << xfr->length << " actual " << xfr->actual_length
               << std::endl;
-    failed_ = true;
-    return;
+    return false;
   }
 
+  RecordStats(inStats_, t);
   if (verbose_) {
-    std::cout << PrefixID() << "CallbackIN xfr " << xfr << std::endl;
+    std::cout << PrefixID() << "CompletedIN xfr " << xfr << std::endl;
     DumpIntTransfer(xfr);
   }
 
-  // Collect and parse signature bytes at the start of the IN stream.
-  uint8_t *dp = xfr->buffer;
   int nrecvd = xfr->actual_length;
+  if (nrecvd <= 0) {
+    return true;
+  }
 
-  // Update the circular buffer with the amount of data that we've received
+  // Transfer the data into the circular buffer; space has already been
+  // checked.
+  uint8_t *dp;
+  bool ok = ProvisionSpace(&dp, nrecvd);
+  assert(ok);
+  memcpy(dp, xfr->buffer, nrecvd);
   CommitData(nrecvd);
 
+  // Collect and parse signature bytes at the start of the IN stream.
   if (!SigReceived()) {
-    if (nrecvd > 0 && !SigReceived()) {
-      uint32_t dropped = SigDetect(&sig_, dp, (uint32_t)nrecvd);
-
-      // Consume stream signature, rather than propagating it to the output
-      // side.
-      if (SigReceived()) {
-        SigProcess(sig_);
-        dropped += sizeof(usbdev_stream_sig_t);
-      }
+    uint32_t dropped = SigDetect(&sig_, dp, (uint32_t)nrecvd);
+
+    // Consume stream signature, rather than propagating it to the output
+    // side.
+    if (SigReceived()) {
+      SigProcess(sig_);
+      dropped += sizeof(usbdev_stream_sig_t);
+    }
 
-      // Skip past any dropped bytes, including the signature, so that if there
-      // are additional bytes we may process them.
-      nrecvd = ((uint32_t)nrecvd > dropped) ? ((uint32_t)nrecvd - dropped) : 0;
-      dp += dropped;
+    // Skip past any dropped bytes, including the signature, so that if there
+    // are additional bytes we may process them.
+    nrecvd = ((uint32_t)nrecvd > dropped) ? ((uint32_t)nrecvd - dropped) : 0;
+    dp += dropped;
 
-      if (dropped) {
-        DiscardData(dropped);
-      }
+    if (dropped) {
+      DiscardData(dropped);
     }
   }
 
-  bool ok = true;
   if (nrecvd > 0) {
     // Check the received LFSR-generated byte(s) and combine them with the
     // output of our host-side LFSR.
     ok = ProcessData(dp, nrecvd);
   }
-
-  if (ok) {
-    if (CanSchedule()) {
-      // Attempt to set up another IN transfer.
-      failed_ = !ServiceIN();
-    } else {
-      inActive_ = false;
-    }
-  } else {
-    failed_ = true;
-  }
+  return ok;
 }
 
-// Callback function supplied to libusb for OUT transfers.
-void USBDevInt::CallbackOUT(struct libusb_transfer *xfr) {
+// A completed OUT transfer.
+bool USBDevInt::CompletedOUT(Transfer *t) {
+  struct libusb_transfer *xfr = t->xfr;
+  outFlight_--;
+  freeOut_.push_back(t);
+
   if (xfr->status != LIBUSB_TRANSFER_COMPLETED) {
+    if (xfr->status == LIBUSB_TRANSFER_CANCELLED && !CanSchedule()) {
+      return true;
+    }
     std::cerr << PrefixID() << " Invalid/unexpected OUT transfer status "
               << xfr->status << std::endl;
     std::cerr << "length " << xfr->length << " actual " << xfr->actual_length
               << std::endl;
-    failed_ = true;
-    return;
+    return false;
   }
 
+  RecordStats(outStats_, t);
   if (verbose_) {
-    std::cout << PrefixID() << "CallbackOUT xfr " << xfr << std::endl;
+    std::cout << PrefixID() << "CompletedOUT xfr " << xfr << std::endl;
     DumpIntTransfer(xfr);
   }
 
   // Note: we're not expecting any truncation on OUT transfers.
   assert(xfr->actual_length == xfr->length);
-  ConsumeData(xfr->actual_length);
-
-  if (CanSchedule()) {
-    // Attempt to set up another OUT transfer.
-    failed_ = !ServiceOUT();
-  } else {
-    outActive_ = false;
-  }
+  bytes_sent_ += xfr->actual_length;
+  return true;
 }
@@ -4,8 +4,11 @@
 #ifndef OPENTITAN_SW_HOST_TESTS_USBDEV_USBDEV_STREAM_USBDEV_INT_H_
 #define OPENTITAN_SW_HOST_TESTS_USBDEV_USBDEV_STREAM_USBDEV_INT_H_
 #include <queue>
+#include <string>
+#include <vector>
 
 #include "usb_device.h"
+#include "usbdev_queue.h"
 #include "usbdev_stream.h"
 
 // Interrupt and Bulk Transfer-based streams to usbdev; as far as the host-
@@ -13,6 +16,12 @@
 //
 // The differences are at the service/delivery level offered by the lower USB
 // layers.
+//
+// Several transfers are kept in flight in each direction so that the device
+// is not left waiting whilst completed transfers are processed. Each transfer
+// has its own buffer, drawn from a small per-stream pool; completed transfers
+// are queued by the libusb callback (which may run on the event handling
+// thread of the USBDevice) and processed, in order, by Service().
 class USBDevInt : public USBDevStream {
  public:
   USBDevInt(USBDevice *dev, bool bulk, unsigned id, uint32_t transfer_bytes,
@@ -21,10 +30,12 @@ class USBDevInt : public USBDevStream {
         dev_(dev),
         bulk_(bulk),
         failed_(false),
-        inActive_(false),
-        outActive_(false),
-        xfrIn_(nullptr),
-        xfrOut_(nullptr) {}
+        inFlight_(0U),
+        outFlight_(0U),
+        inRequested_(0U),
+        inStats_(),
+        outStats_() {}
+  virtual ~USBDevInt();
   /**
    * Open an Interrupt connection to specified device interface.
    *
@@ -68,43 +79,119 @@ class USBDevInt : public USBDevStream {
    */
   void DumpIntTransfer(struct libusb_transfer *xfr) const;
   /**
-   * Retrieving of IN traffic from device.
+   * Number of transfers kept in flight in each direction.
+   */
+  static constexpr unsigned kNumTransfers = 8U;
+  /**
+   * Maximum number of bytes carried by a single OUT transfer.
+   */
+  static constexpr unsigned kMaxTransferBytes = 0x400U;
+  /**
+   * Number of latency histogram buckets; bucket n counts the transfers that
+   * completed in less than 2^n microseconds (and not in an earlier bucket),
+   * and the final bucket counts all slower transfers.
+   */
+  static constexpr unsigned kLatencyBuckets = 16U;
+
+  /**
+   * A libusb transfer and its data buffer.
+   */
+  struct Transfer {
+    // Owning stream.
+    USBDevInt *stream;
+    // libusb transfer descriptor.
+    struct libusb_transfer *xfr;
+    // IN (true) or OUT (false) transfer?
+    bool in;
+    // Times at which the transfer was submitted and completed.
+    uint64_t submitted;
+    uint64_t completed;
+    // Data buffer.
+    uint8_t buf[kMaxTransferBytes];
+  };
+
+  /**
+   * Statistics for one direction of the stream.
+   */
+  struct Stats {
+    // Number of transfers completed.
+    uint64_t transfers;
+    // Number of bytes transferred.
+    uint64_t bytes;
+    // Times of the first and most recent completions.
+    uint64_t first;
+    uint64_t last;
+    // Histogram of transfer latencies.
+    uint32_t latency[kLatencyBuckets];
+  };
+
+  /**
+   * Submit as many IN transfers as we can.
    *
    * @return true iff the stream is still operational.
    */
   bool ServiceIN();
   /**
-   * Sending of OUT traffic to device.
+   * Submit as many OUT transfers as we have data for.
    *
    * @return true iff the stream is still operational.
    */
   bool ServiceOUT();
   /**
-   * Callback function supplied to libusb for IN transfers; transfer has
-   * completed and requires attention.
+   * Submit the given transfer, which has been filled in by the caller.
    *
-   * @param  xfr     The transfer that has completed.
+   * @param  t       The transfer to be submitted.
+   * @return true iff the transfer was submitted.
    */
-  void CallbackIN(struct libusb_transfer *xfr);
+  bool Submit(Transfer *t);
   /**
-   * Callback function supplied to libusb for OUT transfers; transfer has
-   * completed and requires attention.
+   * Process all completed transfers in order.
    *
-   * @param  xfr     The transfer that has completed.
+   * @return true iff the stream is still operational.
    */
-  void CallbackOUT(struct libusb_transfer *xfr);
+  bool ProcessCompletions();
   /**
-   * Stub callback function supplied to libusb for IN transfers.
+   * Process a completed IN transfer.
    *
-   * @param  xfr     The transfer that has completed.
+   * @param  t       The transfer that has completed.
+   * @return true iff the stream is still operational.
+   */
+  bool CompletedIN(Transfer *t);
+  /**
+   * Process a completed OUT transfer.
+   *
+   * @param  t       The transfer that has completed.
+   * @return true iff the stream is still operational.
+   */
+  bool CompletedOUT(Transfer *t);
+  /**
+   * Wait until no transfers remain in flight, optionally cancelling them.
+   *
+   * @param  cancel  Whether to cancel the transfers in flight.
+   */
+  void Drain(bool cancel);
+  /**
+   * Record the completion of a transfer in the given statistics.
+   *
+   * @param  stats   Statistics to be updated.
+   * @param  t       The transfer that has completed.
+   */
+  static void RecordStats(Stats &stats, const Transfer *t);
+  /**
+   * Return a textual summary of the given statistics.
+   *
+   * @param  name    Direction name.
+   * @param  stats   Statistics to be reported.
+   * @return Summary report.
    */
-  static void LIBUSB_CALL CbStubIN(struct libusb_transfer *xfr);
+  static std::string ReportStats(const char *name, const Stats &stats);
   /**
-   * Stub callback function supplied to libusb for OUT transfers.
+   * Callback function supplied to libusb for all transfers; queues the
+   * completed transfer for processing by Service().
    *
    * @param  xfr     The transfer that has completed.
    */
-  static void LIBUSB_CALL CbStubOUT(struct libusb_transfer *xfr);
+  static void LIBUSB_CALL CbStub(struct libusb_transfer *xfr);
 
   // USB device.
   USBDevice *dev_;
@@ -118,17 +205,32 @@ class USBDevInt : public USBDevStream {
   // Has this stream experienced a failure?
   bool failed_;
 
-  // Is an IN transfer in progress?
-  bool inActive_;
+  // Number of IN transfers in flight.
+  unsigned inFlight_;
+
+  // Number of OUT transfers in flight.
+  unsigned outFlight_;
+
+  // Number of bytes requested by the IN transfers in flight.
+  uint32_t inRequested_;
+
+  // Transfers not currently in flight.
+  std::vector<Transfer *> freeIn_;
+  std::vector<Transfer *> freeOut_;
+
+  // All transfers owned by this stream.
+  std::vector<Transfer *> xfrs_;
 
-  // Is an OUT transfer in progress?
-  bool outActive_;
+  // Completed transfers, in order of completion, awaiting processing.
+  SPSCQueue<Transfer *, 2U * kNumTransfers> completed_;
 
-  // Do we currently have an IN transfer?
-  struct libusb_transfer *xfrIn_;
+  // Completed IN transfers whose data could not yet be accepted into the
+  // stream buffer.
+  std::queue<Transfer *> pendingIn_;
 
-  // Do we currently have an OUT transfer?
-  struct libusb_transfer *xfrOut_;
+  // Transfer statistics.
+  Stats inStats_;
+  Stats outStats_;
 
   // Maximum packet size for this stream.
   uint8_t maxPacketSize_;
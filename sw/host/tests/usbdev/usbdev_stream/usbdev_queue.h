@@ -0,0 +1,59 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_SW_HOST_TESTS_USBDEV_USBDEV_STREAM_USBDEV_QUEUE_H_
+#define OPENTITAN_SW_HOST_TESTS_USBDEV_USBDEV_STREAM_USBDEV_QUEUE_H_
+#include <atomic>
+#include <cstdint>
+
+// Lock-free, fixed-capacity queue for a single producer thread and a single
+// consumer thread; used to hand completed libusb transfers from the libusb
+// event handling thread to the stream that owns them.
+template <typename T, uint32_t N>
+class SPSCQueue {
+  static_assert(N && !(N & (N - 1U)), "Queue capacity must be a power of two");
+
+ public:
+  SPSCQueue() : head_(0U), tail_(0U) {}
+  /**
+   * Append an item to the queue; producer thread only.
+   *
+   * @param  item    Item to be appended.
+   * @return true iff there was space for the item.
+   */
+  bool Push(const T &item) {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) >= N) {
+      return false;
+    }
+    items_[tail & (N - 1U)] = item;
+    tail_.store(tail + 1U, std::memory_order_release);
+    return true;
+  }
+  /**
+   * Remove the oldest item from the queue; consumer thread only.
+   *
+   * @param  item    Receives the item.
+   * @return true iff an item was available.
+   */
+  bool Pop(T *item) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *item = items_[head & (N - 1U)];
+    head_.store(head + 1U, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  // Index of the next item to be removed; written only by the consumer.
+  std::atomic<uint32_t> head_;
+  // Index at which the next item shall be stored; written only by the
+  // producer.
+  std::atomic<uint32_t> tail_;
+  // Item storage.
+  T items_[N];
+};
+
+#endif  // OPENTITAN_SW_HOST_TESTS_USBDEV_USBDEV_STREAM_USBDEV_QUEUE_H_
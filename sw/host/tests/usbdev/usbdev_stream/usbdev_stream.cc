@@ -26,6 +26,37 @@
   (((lfsr) << 1) ^         \
    ((((lfsr) >> 1) ^ ((lfsr) >> 2) ^ ((lfsr) >> 3) ^ ((lfsr) >> 7)) & 1u))
 
+namespace {
+// Eight successive outputs of the LFSR for each possible LFSR state, held in
+// stream order, and the state that follows them; this lets the data be
+// generated and checked eight bytes at a time.
+struct LfsrChunks {
+  LfsrChunks() {
+    for (unsigned idx = 0U; idx < 0x100U; idx++) {
+      uint8_t bytes[sizeof(uint64_t)];
+      uint8_t lfsr = (uint8_t)idx;
+      for (unsigned b = 0U; b < sizeof(bytes); b++) {
+        bytes[b] = lfsr;
+        lfsr = (uint8_t)LFSR_ADVANCE(lfsr);
+      }
+      memcpy(&chunks[idx], bytes, sizeof(bytes));
+      next[idx] = lfsr;
+    }
+  }
+  uint64_t chunks[0x100];
+  uint8_t next[0x100];
+};
+
+const LfsrChunks lfsr_chunks;
+
+// Return the next eight bytes of LFSR output, advancing the LFSR.
+inline uint64_t LfsrChunk(uint8_t &lfsr) {
+  uint64_t chunk = lfsr_chunks.chunks[lfsr];
+  lfsr = lfsr_chunks.next[lfsr];
+  return chunk;
+}
+}  // namespace
+
 USBDevStream::USBDevStream(unsigned id, uint32_t transfer_bytes, bool retrieve,
                            bool check, bool send, bool verbose) {
   // Remember Stream IDentifier and flags.
@@ -270,7 +301,12 @@ void USBDevStream::GenerateData(uint8_t *dp, uint32_t len) {
   // Generate a stream of bytes _as if_ we'd received them correctly from
   // the device
   uint8_t next_lfsr = tst_lfsr_;
-  for (unsigned idx = 0U; idx < len; idx++) {
+  unsigned idx = 0U;
+  for (; len - idx >= sizeof(uint64_t); idx += sizeof(uint64_t)) {
+    uint64_t chunk = LfsrChunk(next_lfsr);
+    memcpy(&dp[idx], &chunk, sizeof(chunk));
+  }
+  for (; idx < len; idx++) {
     dp[idx] = next_lfsr;
     next_lfsr = LFSR_ADVANCE(next_lfsr);
   }
@@ -292,9 +328,41 @@ bool USBDevStream::ProcessData(uint8_t *dp, uint32_t len) {
                 << " byte(s)" << std::endl;
     }
 
-    // We can just check and overwrite the input data in-situ.
+    // We can just check and overwrite the input data in-situ, eight bytes at
+    // a time over the whole transfer unless we are reporting each byte.
+    uint32_t idx = 0U;
+    if (!verbose_) {
+      const uint8_t tst_lfsr = tst_lfsr_;
+      const uint8_t dpi_lfsr = dpi_lfsr_;
+      uint64_t mismatch = 0U;
+      for (; len - idx >= sizeof(uint64_t); idx += sizeof(uint64_t)) {
+        uint64_t recvd;
+        memcpy(&recvd, &dp[idx], sizeof(recvd));
+        mismatch |= recvd ^ LfsrChunk(tst_lfsr_);
+
+        // Simply XOR the two LFSR-generated streams together.
+        recvd ^= LfsrChunk(dpi_lfsr_);
+        memcpy(&dp[idx], &recvd, sizeof(recvd));
+      }
+
+      if (retrieve_ && check_ && mismatch) {
+        // Restore the received data and leave the byte-by-byte code below to
+        // report the mismatch(es).
+        tst_lfsr_ = tst_lfsr;
+        dpi_lfsr_ = dpi_lfsr;
+        uint8_t lfsr = dpi_lfsr;
+        for (uint32_t off = 0U; off < idx; off += sizeof(uint64_t)) {
+          uint64_t data;
+          memcpy(&data, &dp[off], sizeof(data));
+          data ^= LfsrChunk(lfsr);
+          memcpy(&dp[off], &data, sizeof(data));
+        }
+        idx = 0U;
+      }
+    }
+
     const uint8_t *sp = dp;
-    for (uint32_t idx = 0U; idx < len; idx++) {
+    for (; idx < len; idx++) {
       uint8_t expected = tst_lfsr_;
       uint8_t recvd = sp[idx];
 
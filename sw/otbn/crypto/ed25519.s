@@ -155,3 +155,875 @@ ext_add:
   bn.mov   w13, w22
 
   ret
+
+/**
+ * Double a point in extended twisted Edwards coordinates.
+ *
+ * Returns (X3, Y3, Z3, T3) = 2 * (X1, Y1, Z1, T1)
+ *
+ * Overwrites the operand with the result.
+ *
+ * This implementation follows the dedicated doubling formula in RFC 8032,
+ * section 5.1.4:
+ *   https://datatracker.ietf.org/doc/html/rfc8032#section-5.1.4
+ *
+ *   A = X1^2
+ *   B = Y1^2
+ *   C = 2*Z1^2
+ *   H = A+B
+ *   E = H-(X1+Y1)^2
+ *   G = A-B
+ *   F = C+G
+ *   X3 = E*F
+ *   Y3 = G*H
+ *   T3 = E*H
+ *   Z3 = F*G
+ *
+ * The input T1 is not used. Doubling costs 4 squarings and 4 multiplications,
+ * compared to 9 multiplications for ext_add.
+ *
+ * This routine runs in constant time.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w31: all-zero
+ * @param[in,out] w10: input X1 (X1 < p), output X3
+ * @param[in,out] w11: input Y1 (Y1 < p), output Y3
+ * @param[in,out] w12: input Z1 (Z1 < p), output Z3
+ * @param[in,out] w13: input T1 (unused), output T3
+ *
+ * clobbered registers: w10 to w13, w17, w18, w20 to w27
+ * clobbered flag groups: FG0
+ */
+.globl ext_double
+ext_double:
+  /* w22 <= X1^2 = A */
+  bn.mov   w22, w10
+  jal      x1, fe_square
+  /* w24 <= w22 = A */
+  bn.mov   w24, w22
+
+  /* w22 <= Y1^2 = B */
+  bn.mov   w22, w11
+  jal      x1, fe_square
+  /* w25 <= w22 = B */
+  bn.mov   w25, w22
+
+  /* w22 <= Z1^2 */
+  bn.mov   w22, w12
+  jal      x1, fe_square
+  /* w26 <= w22 + w22 = C */
+  bn.addm  w26, w22, w22
+
+  /* w22 <= (X1 + Y1)^2 */
+  bn.addm  w22, w10, w11
+  jal      x1, fe_square
+
+  /* w27 <= w24 + w25 = A + B = H */
+  bn.addm  w27, w24, w25
+  /* w25 <= w24 - w25 = A - B = G */
+  bn.subm  w25, w24, w25
+  /* w24 <= w27 - w22 = H - (X1 + Y1)^2 = E */
+  bn.subm  w24, w27, w22
+  /* w26 <= w26 + w25 = C + G = F */
+  bn.addm  w26, w26, w25
+
+  /* w10 <= E * F = X3 */
+  bn.mov   w22, w24
+  bn.mov   w23, w26
+  jal      x1, fe_mul
+  bn.mov   w10, w22
+
+  /* w12 <= F * G = Z3 */
+  bn.mov   w22, w26
+  bn.mov   w23, w25
+  jal      x1, fe_mul
+  bn.mov   w12, w22
+
+  /* w11 <= G * H = Y3 */
+  bn.mov   w22, w25
+  bn.mov   w23, w27
+  jal      x1, fe_mul
+  bn.mov   w11, w22
+
+  /* w13 <= E * H = T3 */
+  bn.mov   w22, w24
+  jal      x1, fe_mul
+  bn.mov   w13, w22
+
+  ret
+
+/**
+ * Add a precomputed affine point to a point in extended coordinates.
+ *
+ * Returns (X3, Y3, Z3, T3) = (X1, Y1, Z1, T1) + (x2, y2, 1, x2*y2)
+ *
+ * Overwrites the first operand (X1, Y1, Z1, T1) with the result. The second
+ * operand is given in the precomputed form (y2+x2, y2-x2, 2*d*x2*y2), which
+ * is how the entries of the fixed-base table are stored. Since Z2 = 1 and the
+ * products with the second operand's constants are precomputed, this is the
+ * formula of ext_add with 7 instead of 9 multiplications:
+ *
+ *   A = (Y1-X1)*(y2-x2)
+ *   B = (Y1+X1)*(y2+x2)
+ *   C = T1*(2*d*x2*y2)
+ *   D = 2*Z1
+ *
+ * followed by the same E, F, G, H and outputs as ext_add.
+ *
+ * This routine runs in constant time.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w31: all-zero
+ * @param[in,out] w10: input X1 (X1 < p), output X3
+ * @param[in,out] w11: input Y1 (Y1 < p), output Y3
+ * @param[in,out] w12: input Z1 (Z1 < p), output Z3
+ * @param[in,out] w13: input T1 (T1 < p), output T3
+ * @param[in]     w14: input (y2 + x2) mod p
+ * @param[in]     w15: input (y2 - x2) mod p
+ * @param[in]     w16: input (2*d*x2*y2) mod p
+ *
+ * clobbered registers: w10 to w13, w18, w20 to w27
+ * clobbered flag groups: FG0
+ */
+.globl ext_madd
+ext_madd:
+  /* w22 <= Y1 - X1 */
+  bn.subm  w22, w11, w10
+  /* w22 <= w22 * (y2 - x2) = A */
+  bn.mov   w23, w15
+  jal      x1, fe_mul
+  /* w24 <= w22 = A */
+  bn.mov   w24, w22
+
+  /* w22 <= Y1 + X1 */
+  bn.addm  w22, w11, w10
+  /* w22 <= w22 * (y2 + x2) = B */
+  bn.mov   w23, w14
+  jal      x1, fe_mul
+  /* w25 <= w22 = B */
+  bn.mov   w25, w22
+
+  /* w22 <= T1 * (2*d*x2*y2) = C */
+  bn.mov   w22, w13
+  bn.mov   w23, w16
+  jal      x1, fe_mul
+  /* w26 <= w22 = C */
+  bn.mov   w26, w22
+
+  /* w27 <= Z1 + Z1 = D */
+  bn.addm  w27, w12, w12
+
+  /* w10 <= (B - A) * (D - C) = X3 */
+  bn.subm  w22, w25, w24
+  bn.subm  w23, w27, w26
+  jal      x1, fe_mul
+  bn.mov   w10, w22
+
+  /* w12 <= (D + C) * (D - C) = Z3 */
+  bn.addm  w22, w27, w26
+  jal      x1, fe_mul
+  bn.mov   w12, w22
+
+  /* w11 <= (D + C) * (B + A) = Y3 */
+  bn.addm  w22, w27, w26
+  bn.addm  w23, w25, w24
+  jal      x1, fe_mul
+  bn.mov   w11, w22
+
+  /* w13 <= (B - A) * (B + A) = T3 */
+  bn.subm  w22, w25, w24
+  jal      x1, fe_mul
+  bn.mov   w13, w22
+
+  ret
+
+/**
+ * Multiply the base point B by a secret scalar.
+ *
+ * Returns (X, Y, Z, T) = [s]B
+ *
+ * This is the scalar multiplication used for signing (R = [r]B) and key
+ * generation (A = [s]B). It uses a fixed 4-bit window: the scalar is
+ * processed from the most significant nibble downwards, and for each nibble
+ * the accumulator is doubled four times and the precomputed multiple
+ * [nibble]B is added from ed25519_base_table with ext_madd. Compared to a
+ * generic double-and-add this needs 64 instead of 256 additions, and each
+ * addition is cheaper because the table entries are affine and precomputed.
+ *
+ * The table entry is selected by reading all 16 entries and keeping the
+ * matching one with bn.sel, so neither the control flow nor the memory access
+ * pattern depends on the scalar.
+ *
+ * The scalar may be any 256-bit value; it does not need to be reduced.
+ *
+ * This routine runs in constant time.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  w28: s, scalar
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w31: all-zero
+ * @param[out] w10: X
+ * @param[out] w11: Y
+ * @param[out] w12: Z
+ * @param[out] w13: T
+ *
+ * clobbered registers: x3, x20 to x22, w1 to w3, w8 to w18, w20 to w28
+ * clobbered flag groups: FG0
+ */
+.globl ext_scmul_base
+ext_scmul_base:
+  /* Initialize the accumulator to the identity (0, 1, 1, 0). */
+  bn.mov   w10, w31
+  bn.addi  w11, w31, 1
+  bn.addi  w12, w31, 1
+  bn.mov   w13, w31
+
+  /* Load the WDR indices for the table lookup. */
+  li       x20, 1
+  li       x21, 2
+  li       x22, 3
+
+  loopi    64, 8
+    /* [w13:w10] <= 16 * [w13:w10] */
+    jal      x1, ext_double
+    jal      x1, ext_double
+    jal      x1, ext_double
+    jal      x1, ext_double
+
+    /* w9 <= w28 >> 252 = next nibble of the scalar */
+    bn.rshi  w9, w31, w28 >> 252
+
+    /* [w16:w14] <= dmem[ed25519_base_table + 96 * w9] */
+    jal      x1, ext_base_table_lookup
+
+    /* [w13:w10] <= [w13:w10] + [w9]B */
+    jal      x1, ext_madd
+
+    /* w28 <= w28 << 4 */
+    bn.rshi  w28, w28, w31 >> 252
+
+  ret
+
+/**
+ * Select an entry of the fixed-base table in constant time.
+ *
+ * Returns the precomputed form of [i]B (see ext_madd) for 0 <= i < 16.
+ *
+ * Every entry is loaded and compared with the index, so the sequence of
+ * instructions and memory accesses is the same for all indices.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w9:  i, table index (i < 16)
+ * @param[in]  x20: constant, x20 = 1
+ * @param[in]  x21: constant, x21 = 2
+ * @param[in]  x22: constant, x22 = 3
+ * @param[in]  w31: all-zero
+ * @param[out] w14: (y + x) mod p for [i]B = (x, y)
+ * @param[out] w15: (y - x) mod p for [i]B = (x, y)
+ * @param[out] w16: (2*d*x*y) mod p for [i]B = (x, y)
+ *
+ * clobbered registers: x3, w1 to w3, w8, w14 to w16
+ * clobbered flag groups: FG0
+ */
+ext_base_table_lookup:
+  la       x3, ed25519_base_table
+  /* w8 <= 0, index of the current entry */
+  bn.mov   w8, w31
+
+  loopi    16, 9
+    /* [w3:w1] <= current table entry */
+    bn.lid   x20, 0(x3)
+    bn.lid   x21, 32(x3)
+    bn.lid   x22, 64(x3)
+    addi     x3, x3, 96
+
+    /* Keep the entry if its index matches.
+       [w16:w14] <= [w3:w1] if w8 = w9 else [w16:w14] */
+    bn.cmp   w8, w9
+    bn.sel   w14, w1, w14, FG0.Z
+    bn.sel   w15, w2, w15, FG0.Z
+    bn.sel   w16, w3, w16, FG0.Z
+
+    /* w8 <= w8 + 1 */
+    bn.addi  w8, w8, 1
+
+  ret
+
+/**
+ * Compute a double-scalar multiplication with the base point.
+ *
+ * Returns (X, Y, Z, T) = [s]B + [k]Q
+ *
+ * This is the core of signature verification, which checks
+ * [s]B = R + [k]A, i.e. whether [s]B + [k](-A) equals R. Instead of two
+ * separate scalar multiplications, both are interleaved with Straus' (a.k.a.
+ * Shamir's) trick, so the doublings are shared: both scalars are processed
+ * two bits at a time, and for each 2-bit window the accumulator is doubled
+ * twice and then [s_i]B (from ed25519_base_table) and [k_i]Q (from a small
+ * table of Q, 2Q and 3Q computed on entry) are added if the digits are
+ * non-zero.
+ *
+ * This routine is NOT constant time and must only be used with public inputs.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  w28: s, first scalar (for B)
+ * @param[in]  w29: k, second scalar (for Q)
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w30: constant, w30 = (2*d) mod p, d = (-121665/121666) mod p
+ * @param[in]  w31: all-zero
+ * @param[in]  w14: X of point Q (X < p)
+ * @param[in]  w15: Y of point Q (Y < p)
+ * @param[in]  w16: Z of point Q (Z < p)
+ * @param[in]  w17: T of point Q (T < p)
+ * @param[out] w10: X
+ * @param[out] w11: Y
+ * @param[out] w12: Z
+ * @param[out] w13: T
+ *
+ * clobbered registers: x2 to x5, x20 to x27, w10 to w18, w20 to w29
+ * clobbered flag groups: FG0
+ */
+.globl ext_double_scmul
+ext_double_scmul:
+  /* Load the WDR indices for loads and stores of points. */
+  li       x20, 14
+  li       x21, 15
+  li       x22, 16
+  li       x23, 17
+  li       x24, 10
+  li       x25, 11
+  li       x26, 12
+  li       x27, 13
+
+  /* dmem[ed25519_dsm_table] <= Q */
+  la       x4, ed25519_dsm_table
+  bn.sid   x20, 0(x4)
+  bn.sid   x21, 32(x4)
+  bn.sid   x22, 64(x4)
+  bn.sid   x23, 96(x4)
+
+  /* dmem[ed25519_dsm_table + 128] <= [w13:w10] <= 2Q */
+  bn.mov   w10, w14
+  bn.mov   w11, w15
+  bn.mov   w12, w16
+  bn.mov   w13, w17
+  jal      x1, ext_double
+  bn.sid   x24, 128(x4)
+  bn.sid   x25, 160(x4)
+  bn.sid   x26, 192(x4)
+  bn.sid   x27, 224(x4)
+
+  /* dmem[ed25519_dsm_table + 256] <= [w13:w10] <= 2Q + Q = 3Q */
+  bn.lid   x20, 0(x4)
+  bn.lid   x21, 32(x4)
+  bn.lid   x22, 64(x4)
+  bn.lid   x23, 96(x4)
+  jal      x1, ext_add
+  bn.sid   x24, 256(x4)
+  bn.sid   x25, 288(x4)
+  bn.sid   x26, 320(x4)
+  bn.sid   x27, 352(x4)
+
+  /* x4 <= ed25519_dsm_table - 128, so that [i]Q is at x4 + 128 * i. */
+  addi     x4, x4, -128
+  la       x5, ed25519_base_table
+
+  /* Initialize the accumulator to the identity (0, 1, 1, 0). */
+  bn.mov   w10, w31
+  bn.addi  w11, w31, 1
+  bn.addi  w12, w31, 1
+  bn.mov   w13, w31
+
+  loopi    128, 36
+    /* [w13:w10] <= 4 * [w13:w10] */
+    jal      x1, ext_double
+    jal      x1, ext_double
+
+    /* x2 <= next two bits of s, w28 <= w28 << 2 */
+    bn.add   w28, w28, w28
+    csrrs    x2, FG0, x0
+    andi     x2, x2, 1
+    bn.add   w28, w28, w28
+    csrrs    x3, FG0, x0
+    andi     x3, x3, 1
+    slli     x2, x2, 1
+    or       x2, x2, x3
+
+    /* Skip the addition of [x2]B if x2 = 0. */
+    beq      x2, x0, ext_double_scmul_no_b
+
+    /* [w16:w14] <= dmem[ed25519_base_table + 96 * x2] */
+    slli     x3, x2, 6
+    slli     x2, x2, 5
+    add      x3, x3, x2
+    add      x3, x3, x5
+    bn.lid   x20, 0(x3)
+    bn.lid   x21, 32(x3)
+    bn.lid   x22, 64(x3)
+
+    /* [w13:w10] <= [w13:w10] + [x2]B */
+    jal      x1, ext_madd
+
+    ext_double_scmul_no_b:
+    /* x2 <= next two bits of k, w29 <= w29 << 2 */
+    bn.add   w29, w29, w29
+    csrrs    x2, FG0, x0
+    andi     x2, x2, 1
+    bn.add   w29, w29, w29
+    csrrs    x3, FG0, x0
+    andi     x3, x3, 1
+    slli     x2, x2, 1
+    or       x2, x2, x3
+
+    /* Skip the addition of [x2]Q if x2 = 0. */
+    beq      x2, x0, ext_double_scmul_no_q
+
+    /* [w17:w14] <= dmem[ed25519_dsm_table + 128 * (x2 - 1)] */
+    slli     x3, x2, 7
+    add      x3, x3, x4
+    bn.lid   x20, 0(x3)
+    bn.lid   x21, 32(x3)
+    bn.lid   x22, 64(x3)
+    bn.lid   x23, 96(x3)
+
+    /* [w13:w10] <= [w13:w10] + [x2]Q */
+    jal      x1, ext_add
+
+    ext_double_scmul_no_q:
+    nop
+
+  ret
+
+.data
+
+/**
+ * Fixed-base table for ext_scmul_base and ext_double_scmul.
+ *
+ * Entry i (0 <= i < 16) holds the affine point [i]B = (x, y) in the
+ * precomputed form expected by ext_madd:
+ *   (y + x) mod p, (y - x) mod p, (2*d*x*y) mod p
+ *
+ * Entry 0 is the identity (0, 1). Each entry is 96 bytes.
+ */
+.balign 32
+.globl ed25519_base_table
+ed25519_base_table:
+  /* 0 * B */
+  .word 0x00000001
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000001
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  /* 1 * B */
+  .word 0xf58c3b85
+  .word 0x2fbc93c6
+  .word 0xfb8c0e19
+  .word 0xcf932dc6
+  .word 0x643d42c2
+  .word 0x270b4898
+  .word 0x33d4ba65
+  .word 0x07cf9d3a
+  .word 0xd740913e
+  .word 0x9d103905
+  .word 0xd140beb3
+  .word 0xfd399f05
+  .word 0x688f8a09
+  .word 0xa5c18434
+  .word 0x98f81267
+  .word 0x44fd2f92
+  .word 0x877aaa68
+  .word 0xabc91205
+  .word 0xccaac49e
+  .word 0x26d9e823
+  .word 0xdd43598c
+  .word 0x5a1b7dcb
+  .word 0x9f0c65a8
+  .word 0x6f117b68
+  /* 2 * B */
+  .word 0x933c71d7
+  .word 0x9224e7fc
+  .word 0x7a0ff5b5
+  .word 0x9f469d96
+  .word 0xe1d60702
+  .word 0x5aa69a65
+  .word 0xa87d2e2e
+  .word 0x590c063f
+  .word 0x42b4d5a8
+  .word 0x8a99a560
+  .word 0x4e60acf6
+  .word 0x8f2b810c
+  .word 0xb16e37aa
+  .word 0xe09e236b
+  .word 0x69c92555
+  .word 0x6bb595a6
+  .word 0xa59b7a5f
+  .word 0x43faa8b3
+  .word 0x5d9acf78
+  .word 0x36c16bdd
+  .word 0x0b3d6a31
+  .word 0x500fa084
+  .word 0x3ea50b73
+  .word 0x701af5b1
+  /* 3 * B */
+  .word 0x4cee9730
+  .word 0xaf25b0a8
+  .word 0xe8864b8a
+  .word 0x025a8430
+  .word 0x9f016732
+  .word 0xc11b5002
+  .word 0x9a80f8f4
+  .word 0x7a164e1b
+  .word 0xa4fcd265
+  .word 0x56611fe8
+  .word 0xe5c1ba7d
+  .word 0x3bd353fd
+  .word 0x214bd6bd
+  .word 0x8131f31a
+  .word 0x555bda62
+  .word 0x2ab91587
+  .word 0x0dd0d889
+  .word 0x14ae933f
+  .word 0x1c35da62
+  .word 0x58942322
+  .word 0x8cf2db4c
+  .word 0xd170e545
+  .word 0x12b9b4c6
+  .word 0x5a2826af
+  /* 4 * B */
+  .word 0x8efc099f
+  .word 0x287351b9
+  .word 0x7dfd2538
+  .word 0x6765c6f4
+  .word 0xfb0a9265
+  .word 0xca348d3d
+  .word 0x21e58727
+  .word 0x680e9103
+  .word 0x056818bf
+  .word 0x95fe050a
+  .word 0x5660faa9
+  .word 0x327e8971
+  .word 0x06a05073
+  .word 0xc3e8e3cd
+  .word 0x7445a49a
+  .word 0x27933f4c
+  .word 0xc476ff09
+  .word 0x5a13fbe9
+  .word 0x7b5cc172
+  .word 0x6e9e3945
+  .word 0x102b4494
+  .word 0x5ddbdcf9
+  .word 0x63553e2b
+  .word 0x7f9d0cbf
+  /* 5 * B */
+  .word 0x08a5bb33
+  .word 0xa212bc44
+  .word 0xc75eed02
+  .word 0x8d5048c3
+  .word 0x5abfec44
+  .word 0xdd1beb0c
+  .word 0x46e206eb
+  .word 0x2945ccf1
+  .word 0xa447d6ba
+  .word 0x7f9182c3
+  .word 0x4b2729b7
+  .word 0xd50014d1
+  .word 0xb864a087
+  .word 0xe33cf11c
+  .word 0xeb1b55f3
+  .word 0x154a7e73
+  .word 0x812a8285
+  .word 0xbcbbdbf1
+  .word 0xd0bdd1fc
+  .word 0x270e0807
+  .word 0x1bbda72d
+  .word 0xb41b670b
+  .word 0x6b3bb69a
+  .word 0x43aabe69
+  /* 6 * B */
+  .word 0x77157131
+  .word 0x3a0ceeeb
+  .word 0x00c8af88
+  .word 0x9b271589
+  .word 0xda59a736
+  .word 0x8065b668
+  .word 0xa2cc38bd
+  .word 0x51e57bb6
+  .word 0x7b7d8ca4
+  .word 0x499806b6
+  .word 0x27d22739
+  .word 0x575be284
+  .word 0x204553b9
+  .word 0xbb085ce7
+  .word 0xae417884
+  .word 0x38b64c41
+  .word 0x02ea4b71
+  .word 0x85ac3267
+  .word 0x41a1bb01
+  .word 0xbe70e003
+  .word 0x083bc144
+  .word 0x53e4a24b
+  .word 0x9f0d61e3
+  .word 0x10b8e91a
+  /* 7 * B */
+  .word 0x944ea3bf
+  .word 0x6b1a5cd0
+  .word 0xb39dc0d2
+  .word 0x7470353a
+  .word 0x28542e49
+  .word 0x71b25282
+  .word 0x283c927e
+  .word 0x461bea69
+  .word 0xaa3221b1
+  .word 0xba6f2c9a
+  .word 0x3bba23a7
+  .word 0x6ca02153
+  .word 0x92192c3a
+  .word 0x9dea764f
+  .word 0x2e5317e0
+  .word 0x1d6edd5d
+  .word 0x01b8b3a2
+  .word 0xf1836dc8
+  .word 0x053ea49a
+  .word 0xb3035f47
+  .word 0x5877adf3
+  .word 0x529c41ba
+  .word 0x6a0f90a7
+  .word 0x7a9fbb1c
+  /* 8 * B */
+  .word 0x04dd3e8f
+  .word 0x59b75966
+  .word 0xe288702c
+  .word 0x6cb30377
+  .word 0x5ed9c323
+  .word 0xb1339c66
+  .word 0x61bce52f
+  .word 0x0915e760
+  .word 0xf39234d9
+  .word 0xe2a75ded
+  .word 0xe1b558f9
+  .word 0x963d7680
+  .word 0x6e3c23fb
+  .word 0x2c2741ac
+  .word 0x320e01c3
+  .word 0x3a9024a1
+  .word 0xc9a2911a
+  .word 0xe7c1f5d9
+  .word 0x8bcca7d7
+  .word 0xb8a37178
+  .word 0x0eb62a32
+  .word 0x63641219
+  .word 0x2ecc4e95
+  .word 0x26907c5c
+  /* 9 * B */
+  .word 0xa6a8632f
+  .word 0x9b2e678a
+  .word 0x51bc46c5
+  .word 0xa6509e6f
+  .word 0xc686f5b5
+  .word 0xceb233c9
+  .word 0x8add7f59
+  .word 0x34b9ed33
+  .word 0x039d8064
+  .word 0xf36e217e
+  .word 0xf520419b
+  .word 0x98a081b6
+  .word 0xe75eb044
+  .word 0x96cbc608
+  .word 0xfadc9c8f
+  .word 0x49c05a51
+  .word 0x9045af1b
+  .word 0x06b4e8bf
+  .word 0xa719d22f
+  .word 0xe2ff83e8
+  .word 0x93d4cf16
+  .word 0xaaf6fc29
+  .word 0x1b008b06
+  .word 0x73c17202
+  /* 10 * B */
+  .word 0xb360748e
+  .word 0xff1d93d2
+  .word 0x1617e057
+  .word 0x45f534d4
+  .word 0x9b554646
+  .word 0x0d550363
+  .word 0xaae591ed
+  .word 0x43ac7628
+  .word 0x227081dd
+  .word 0x75f3558e
+  .word 0x65a9f02f
+  .word 0x04f81836
+  .word 0xf5dc3958
+  .word 0x84739745
+  .word 0x4950b702
+  .word 0x0353832c
+  .word 0x03d0f8d8
+  .word 0xd03d2ae4
+  .word 0xd3f06340
+  .word 0x1d0c1ccb
+  .word 0x6731b509
+  .word 0xff169f0f
+  .word 0x70bf4ce7
+  .word 0x0ec62af4
+  /* 11 * B */
+  .word 0x8a802ade
+  .word 0x2fbf0084
+  .word 0x02302e27
+  .word 0xe5d9fecf
+  .word 0x17703406
+  .word 0x113e8471
+  .word 0x546d8faf
+  .word 0x4275aae2
+  .word 0x49864348
+  .word 0x315f5b02
+  .word 0x77088381
+  .word 0x3ed6b369
+  .word 0x6a8deb95
+  .word 0xa3a07555
+  .word 0x29d5c77f
+  .word 0x18ab5980
+  .word 0xfd6089e9
+  .word 0xd82b2cc5
+  .word 0x3282e4a4
+  .word 0x031eb4a1
+  .word 0xb51a8622
+  .word 0x44311199
+  .word 0xb53df948
+  .word 0x3dc65522
+  /* 12 * B */
+  .word 0xa71e7539
+  .word 0xe2358042
+  .word 0xd834d1a9
+  .word 0x88de3dd7
+  .word 0x701a6f93
+  .word 0x45ecdd2e
+  .word 0x8d3cdd58
+  .word 0x078aafde
+  .word 0xb53d54b9
+  .word 0x856f8375
+  .word 0xccb25b24
+  .word 0x23b2bf90
+  .word 0x56d5dbdd
+  .word 0x884dfb6e
+  .word 0x8a6022ed
+  .word 0x7956ece2
+  .word 0x7f944553
+  .word 0xeea594d8
+  .word 0xa24e180b
+  .word 0xf66cda23
+  .word 0xf4976461
+  .word 0xffcb589a
+  .word 0x1c83d0c6
+  .word 0x37c6a515
+  /* 13 * B */
+  .word 0xa2007f6d
+  .word 0xbf70c222
+  .word 0xb5bcdedb
+  .word 0xbf84b39a
+  .word 0xfb07ba07
+  .word 0x537a0e12
+  .word 0xc346f241
+  .word 0x234fd7ee
+  .word 0x327fbf93
+  .word 0x506f013b
+  .word 0x9b776f6b
+  .word 0xaefcebc9
+  .word 0xaaad5968
+  .word 0x9d12b232
+  .word 0x176024a7
+  .word 0x0267882d
+  .word 0x732ea378
+  .word 0x5360a119
+  .word 0xdf8dd471
+  .word 0x2437e6b1
+  .word 0x91a7e533
+  .word 0xa2ef37f8
+  .word 0xaa097863
+  .word 0x497ba6fd
+  /* 14 * B */
+  .word 0x3f213df2
+  .word 0x26f870ec
+  .word 0x57efa987
+  .word 0x80277fc0
+  .word 0x2881bdd5
+  .word 0x1a474c04
+  .word 0x464d1630
+  .word 0x6eaf60b2
+  .word 0xd4171280
+  .word 0xdfdb8a44
+  .word 0xdb7ca331
+  .word 0xce69b20f
+  .word 0x6eec47a9
+  .word 0x112e56f1
+  .word 0x5b3c80d2
+  .word 0x2df0ea2c
+  .word 0x7a1e1b82
+  .word 0x96a1c587
+  .word 0xa2a9bf54
+  .word 0xf02397ed
+  .word 0x3ecb1baa
+  .word 0x9c1fdf70
+  .word 0xd8ba9c93
+  .word 0x24bf7e3c
+  /* 15 * B */
+  .word 0x13cfeaa0
+  .word 0x24cecc03
+  .word 0x189c246d
+  .word 0x8648c28d
+  .word 0xc1f2d4d0
+  .word 0x2dbdbdfa
+  .word 0xf12de72b
+  .word 0x61e22917
+  .word 0x468ccf0b
+  .word 0x040bcd86
+  .word 0x2a9910d6
+  .word 0xd3829ba4
+  .word 0x07b25192
+  .word 0x75083008
+  .word 0x18d05ebf
+  .word 0x43b5cd42
+  .word 0x9bd0b516
+  .word 0x5d9a762f
+  .word 0x373fdeee
+  .word 0xeb38af4e
+  .word 0x93d64270
+  .word 0x032e5a7d
+  .word 0x0ae4d842
+  .word 0x511d6121
+
+.section .bss
+
+/* Precomputed multiples Q, 2Q, 3Q for ext_double_scmul (extended coordinates,
+   128 bytes each). */
+.balign 32
+ed25519_dsm_table:
+  .zero 384
@@ -11,6 +11,8 @@
 .text
 .globl modexp_65537
 .globl modexp
+.globl modexp_window
+.globl montmul_mul1
 
 /**
  * Conditionally overwrite bigint in dmem
@@ -169,6 +171,208 @@ modexp:
   ret
 
 
+/**
+ * Constant-time bigint modular exponentiation with a fixed window
+ *
+ * Returns: C = modexp(A,E) = A^E mod M
+ *
+ * This is a faster variant of modexp, which processes the exponent w bits at
+ * a time starting from the most significant bit. The powers A^2 to
+ * A^(2^w-1) are precomputed in the Montgomery domain and stored in a table in
+ * dmem. For each window of the exponent, the result is squared w times and
+ * then multiplied with the power of A selected by the window. The selected
+ * power is copied out of the table by reading every entry and keeping the
+ * matching one with bn.sel, so neither the memory access pattern nor the
+ * instruction count depends on the exponent. If the window is zero, the
+ * product is computed anyway (with A) and then discarded.
+ *
+ * For an exponent of n bits, this takes n + n/w + 2^w - 2 Montgomery
+ * multiplications instead of the 2n of modexp, at the cost of (2^w - 1) * N
+ * limbs of additional dmem.
+ *
+ * The squared Montgomery modulus RR and the Montgomery constant m0' have to
+ * be precomputed and provided at the appropriate locations in dmem.
+ *
+ * Flags: The states of both FG0 and FG1 depend on intermediate values and are
+ *        not usable after return.
+ *
+ * The base bignum A is expected in the input buffer, the exponent E in the
+ * exp buffer, the result C is written to the output buffer.
+ * Note, that the content of both, the input buffer and the exp buffer is
+ * modified during execution.
+ *
+ * @param[in]   x2: dptr_c, dmem pointer to buffer for output C
+ * @param[in]   x3: dptr_t, dmem pointer to table buffer of (2^w-2)*N limbs
+ * @param[in]   x4: dptr_s, dmem pointer to buffer of N limbs for the selected
+ *                  table entry, may be the same as dptr_RR
+ * @param[in]   x5: w, window size in bits, 2 or 4
+ * @param[in]  x14: dptr_a, dmem pointer to first limb of input A
+ * @param[in]  x15: dptr_e, dmem pointer to first limb of exponent E
+ * @param[in]  x16: dptr_M, dmem pointer to first limb of modulus M
+ * @param[in]  x17: dptr_m0d, dmem pointer to first limb of m0'
+ * @param[in]  x18: dptr_RR, dmem pointer to first limb of RR
+ * @param[in]  x30: N, number of limbs per bignum
+ * @param[in]  w31: all-zero
+ * @param[out] dmem[dptr_c:dptr_c+N*32] C, A^E mod M
+ *
+ * clobbered registers: x5 to x13, x16 to x31
+ *                      w0 to w3, w20 to w30
+ *                      w4 to w[4+N-1]
+ * clobbered Flag Groups: FG0, FG1
+ */
+modexp_window:
+  /* prepare pointers to temp regs */
+  li         x8, 4
+  li         x9, 3
+  li        x10, 4
+  li        x11, 2
+
+  /* Compute (N-1).
+       x31 <= x30 - 1 = N - 1 */
+  addi      x31, x30, -1
+
+  /* Keep the window size, since montmul clobbers x5.
+       x23 <= w */
+  addi      x23, x5, 0
+
+  /* Compute the number of table entries and the size of a bignum in bytes.
+       x25 <= 2^w - 2
+       x26 <= N * 32 */
+  li        x25, 1
+  sll       x25, x25, x23
+  addi      x25, x25, -2
+  slli      x26, x30, 5
+
+  /* Convert input to montgomery domain.
+       dmem[dptr_a] <= montmul(A,RR) = A*R mod M */
+  addi      x19, x14, 0
+  addi      x20, x18, 0
+  addi      x21, x14, 0
+  jal       x1, montmul
+  loop      x30, 2
+    bn.sid    x8, 0(x21++)
+    addi      x8, x8, 1
+
+  /* Fill the table, storing each entry right after the previous one.
+       dmem[dptr_t+(j-2)*N*32] <= montmul(A^(j-1)*R, A*R) = A^j*R mod M
+       for j = 2 to 2^w-1 */
+  addi      x19, x14, 0
+  addi      x21, x3, 0
+  loop      x25, 7
+    addi      x20, x14, 0
+    addi      x27, x21, 0
+    jal       x1, montmul
+    loop      x30, 2
+      bn.sid    x8, 0(x21++)
+      addi      x8, x8, 1
+    addi      x19, x27, 0
+
+  /* zeroize w2 and reset flags */
+  bn.sub    w2, w2, w2
+
+  /* initialize the output buffer with -M */
+  addi      x12, x16, 0
+  addi      x21, x2, 0
+  loop      x30, 3
+    /* load limb from modulus */
+    bn.lid    x11, 0(x12++)
+
+    /* subtract limb from 0 */
+    bn.subb   w2, w31, w2
+
+    /* store limb in dmem */
+    bn.sid    x11, 0(x21++)
+
+  /* Compute the number of windows. The window size is a power of two, so
+     this shifts right once per halving of w.
+       x24 <= 256 * N / w */
+  slli      x24, x30, 8
+  addi      x27, x23, 0
+_modexp_window_count:
+  srli      x27, x27, 1
+  beq       x27, x0, _modexp_window_count_done
+  srli      x24, x24, 1
+  jal       x0, _modexp_window_count
+_modexp_window_count_done:
+
+  /* prepare pointers to the wide registers used for table selection */
+  li        x28, 21
+  li        x29, 22
+
+  /* iterate over all windows of the exponent */
+  loop      x24, 40
+    /* square w times: out = montmul(out,out) */
+    loop      x23, 8
+      addi      x19, x2, 0
+      addi      x20, x2, 0
+      addi      x21, x2, 0
+      jal       x1, montmul
+      /* Store result in dmem starting at dmem[dptr_c] */
+      loop      x30, 2
+        bn.sid    x8, 0(x21++)
+        addi      x8, x8, 1
+      nop
+
+    /* Shift the next w bits of the exponent into w20, one bit at a time. As
+       in modexp, each pass shifts the exponent left by one bit and the MSB
+       moves to FG0.C.
+         w20 <= E >> (256*N - w)
+         E <= E << w */
+    bn.xor    w20, w20, w20
+    loop      x23, 7
+      bn.add    w2, w31, w31
+      addi      x20, x15, 0
+      loop      x30, 3
+        bn.lid    x11, 0(x20)
+        bn.addc   w2, w2, w2
+        bn.sid    x11, 0(x20++)
+      bn.addc   w20, w20, w20
+
+    /* Select the power of A for the window, limb by limb. Every table entry
+       is read and compared against the window; a window of zero or one
+       selects A itself.
+         dmem[dptr_s] <= w20 < 2 ? A*R : dmem[dptr_t+(w20-2)*N*32] */
+    addi      x19, x14, 0
+    addi      x20, x4, 0
+    addi      x21, x3, 0
+    loop      x30, 11
+      /* w21 <= dmem[dptr_a+i*32] */
+      bn.lid    x28, 0(x19++)
+      addi      x27, x21, 0
+      bn.addi   w23, w31, 1
+      loop      x25, 5
+        /* w22 <= dmem[dptr_t+(j-2)*N*32+i*32] */
+        bn.lid    x29, 0(x27)
+        add       x27, x27, x26
+        /* w21 <= (w20 == j) ? w22 : w21 */
+        bn.addi   w23, w23, 1
+        bn.cmp    w20, w23
+        bn.sel    w21, w22, w21, FG0.Z
+      bn.sid    x28, 0(x20++)
+      addi      x21, x21, 32
+
+    /* multiply: out = montmul(out,sel) */
+    addi      x19, x2, 0
+    addi      x20, x4, 0
+    jal       x1, montmul
+
+    /* Keep the product unless the window is zero.
+         FG0.C <= (w20 != 0) */
+    bn.cmp    w31, w20
+    addi      x21, x2, 0
+    jal       x1, sel_sqr_or_sqrmul
+
+    nop
+
+  /* convert back from montgomery domain */
+  /* out = montmul(out,1) = out/R mod M  */
+  addi      x19, x2, 0
+  addi      x21, x2, 0
+  jal       x1, montmul_mul1
+
+  ret
+
+
 /**
  * Bigint modular exponentiation with fixed exponent of 65537
  *
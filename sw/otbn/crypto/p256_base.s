@@ -1300,6 +1300,13 @@ scalar_mult_int:
  *
  * This routine runs in constant time.
  *
+ * This uses the same ladder as any other point rather than a fixed-base comb
+ * over precomputed multiples of G. To stay constant-time, every comb lookup
+ * would have to select from the whole table with the secret share bits. The
+ * table would also have to stay in DMEM across operations, next to the
+ * callers' variables, and it would have to be reloaded after every DMEM
+ * secure wipe.
+ *
  * @param[in]   dmem[d0]:  first share of scalar d (320 bits)
  * @param[in]   dmem[d1]:  second share of scalar d (320 bits)
  * @param[out]  dmem[x]:   affine x-coordinate (256 bits)
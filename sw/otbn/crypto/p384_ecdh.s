@@ -7,16 +7,12 @@
  *
  * This binary has the following modes of operation:
  * 1. MODE_KEYGEN_RANDOM: generate a random keypair
- * 2. MODE_SHARED_KEYGEN: compute shared key - !!! Attention !!! - before
- *                        shared key computation p384_curve_point_valid
- *                        binary has to be executed to check if the provided
- *                        public key is valid.
+ * 2. MODE_SHARED_KEYGEN: compute shared key
  * 3. MODE_KEYGEN_FROM_SEED: generate keypair from a sideloaded seed
  * 4. MODE_SHARED_KEYGEN_FROM_SEED: compute shared key using sideloaded seed
- *                                  !!! Attention !!! - before shared key
- *                                  computation p384_curve_point_valid
- *                                  binary has to be executed to check if
- *                                  the provided public key is valid.
+ *
+ * The shared key modes validate the provided public key before using it, so
+ * no separate p384_curve_point_valid run is needed.
  */
 
  /**
@@ -110,10 +106,10 @@ keypair_random:
  * shared key is expressed in boolean shares x0, x1 such that the key is (x0 ^
  * x1).
  *
- * This routine runs in constant time.
+ * The public key is checked to be a valid curve point first; an invalid
+ * public key raises a software error and halts execution.
  *
- * !!! Attention !!! - before shared key computation p384_curve_point_valid
- * binary has to be executed to check if the provided public key is valid.
+ * This routine runs in constant time.
  *
  * @param[in]        w31: all-zero
  * @param[in]   dmem[k0]: 1st private key share d0/k0
@@ -127,6 +123,9 @@ keypair_random:
  * clobbered flag groups: FG0
  */
 shared_key:
+  /* Validate the public key (ends the program on failure). */
+  jal       x1, p384_curve_point_valid
+
   /* Generate arithmetically masked shared key d*Q.
      dmem[x] <= (d*Q).x - m mod p
      dmem[y] <= m */
@@ -213,12 +212,13 @@ keypair_from_seed:
  * x1).
  * Returns secret key d in 384-bit shares d0, d1.
  *
- * This routine runs in constant time.
+ * The public key is validated as in shared_key.
  *
- * !!! Attention !!! - before shared key computation p384_curve_point_valid
- * binary has to be executed to check if the provided public key is valid.
+ * This routine runs in constant time.
  *
  * @param[in]        w31: all-zero
+ * @param[in]    dmem[x]: x-coordinate of public key
+ * @param[in]    dmem[y]: y-coordinate of public key
  * @param[out]   dmem[x]: x0, first share of shared key.
  * @param[out]   dmem[y]: x1, second share of shared key.
  *
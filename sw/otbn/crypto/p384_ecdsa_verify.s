@@ -5,10 +5,8 @@
 /**
  * Entrypoint for P-384 ECDSA verifying operations.
  *
- * This binary verifies a signature. - !!! Attention !!! - before
- * signature verification p384_curve_point_valid
- * binary has to be executed to check if the provided
- * public key is valid.
+ * This binary checks that the public key is a valid curve point and then
+ * verifies a signature.
  */
 
 .section .text.start
@@ -40,11 +38,12 @@ start:
  * @param[in]    dmem[y]: y-coordinate of public key
  * @param[out] dmem[x_r]: x1 coordinate to be compared to rs
  *
- * !!! Attention !!! - before signature verification p384_curve_point_valid
- * binary has to be executed to check if the provided public key is valid.
- *
+ * An invalid public key raises a software error and halts execution.
  */
 ecdsa_verify:
+  /* Validate the public key (ends the program on failure). */
+  jal      x1, p384_curve_point_valid
+
   /* Verify the signature (compute x1). */
   jal      x1, p384_verify
 
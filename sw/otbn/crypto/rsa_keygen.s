@@ -8,6 +8,7 @@
 
 /* Exposed for testing purposes only. */
 .globl relprime_f4
+.globl relprime_small_primes
 .globl check_p
 .globl check_q
 .globl modinv_f4
@@ -1017,6 +1018,27 @@ check_p:
   bn.addi  w20, w20, 1
   bn.sid   x20, 0(x16)
 
+  /* Check if p is divisible by any small odd prime. This cheap filter rejects
+     about 79% of candidates before the Montgomery setup and Miller-Rabin.
+       w22 <= 2^256-1 if GCD(p, 3*5*...*191) == 1, otherwise 0 */
+  jal      x1, relprime_small_primes
+
+  /* Restore constants. */
+  li       x20, 20
+  li       x21, 21
+
+  /* FG0.Z <= (w22 == 0) */
+  bn.add   w22, w22, w31
+
+  /* Get the FG0.Z flag into a register.
+       x2 <= (CSRs[FG0] >> 3) & 1 = FG0.Z */
+  csrrs    x2, FG0, x0
+  srli     x2, x2, 3
+  andi     x2, x2, 1
+
+  /* If the flag is set, then p has a small factor and the check failed. */
+  bne      x2, x0, _check_prime_fail
+
   /* Load Montgomery constants for p.
        dmem[mont_m0inv] <= Montgomery constant m0'
        dmem[mont_rr] <= Montgomery constant RR */
@@ -1033,13 +1055,6 @@ check_p:
   li       x2, 256
   add      x15, x14, x2
 
-  /**
-   * TODO: add something like BoringSSL's is_obviously_composite to filter out
-   * numbers that are divisible by the first few hundred primes. This filters
-   * out 80-90% of composites without resorting to the very slow Miller-Rabin
-   * check.
-   */
-
   /* Calculate the number of Miller-Rabin rounds. The number of rounds is
      selected based on the bit-length according to FIPS 186-5, table B.1.
      According to that table, the minimums for an error probability matching
@@ -1353,6 +1368,134 @@ relprime_f4:
 
   ret
 
+/**
+ * Check if a large number is relatively prime to all odd primes below 192.
+ *
+ * Returns all 1s if GCD(x, M) == 1 and 0 otherwise, where M is the product of
+ * the 42 odd primes from 3 to 191 (a 249-bit number).
+ *
+ * This is a cheap filter for prime candidates, similar to BoringSSL's
+ * `bn_odd_number_is_obviously_composite`. About 79% of random odd numbers
+ * share a factor with M, and rejecting them here avoids the Montgomery setup
+ * and at least one modular exponentiation in Miller-Rabin. A prime of the
+ * sizes used for RSA keygen never shares a factor with M.
+ *
+ * The routine first reduces x modulo M one bit at a time, starting from the
+ * most significant bit (r <= (2*r + bit) mod M). Since M < 2^255, `bn.addm`
+ * can do the modular doubling without overflow. It then computes GCD(r, M)
+ * with the constant-time `gcd` routine on a single limb.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  x16: dptr_x, pointer to first limb of x in dmem
+ * @param[in]  x30: plen, number of 256-bit limbs for x
+ * @param[in]  x31: plen-1, constant
+ * @param[in]  w31: all-zero
+ * @param[out] w22: result, all 1s if x is relatively prime to M, otherwise 0
+ *
+ * clobbered registers: MOD, x2, x3, x5, x6, x10, x11, x21 to x25,
+ *                      w20 to w25
+ * clobbered flag groups: FG0, FG1
+ */
+relprime_small_primes:
+  /* Load the product of small primes into the modulus register.
+       w24 <= M
+       MOD <= M */
+  li       x24, 24
+  la       x2, small_primes_product
+  bn.lid   x24, 0(x2)
+  bn.wsrw  MOD, w24
+
+  /* Get a pointer to the last limb of x.
+       x2 <= x16 + ((plen-1) << 5) = x16 + (plen-1)*32 */
+  slli     x3, x31, 5
+  add      x2, x16, x3
+
+  /* Initialize the remainder.
+       w23 <= 0 */
+  bn.mov   w23, w31
+
+  /* Initialize constants for loop. */
+  li       x22, 22
+
+  /* Reduce x modulo M, starting from the most significant limb.
+
+     Loop invariants for iteration i (i=0..plen-1):
+       x2 = dptr_x + (plen-1-i)*32
+       x22 = 22
+       w23 = (x >> (256*(plen-i))) mod M */
+  loop     x30, 7
+    /* Load the next limb.
+         w22 <= x[plen-1-i] */
+    bn.lid   x22, 0(x2)
+
+    /* Shift the bits of the limb into the remainder one at a time. */
+    loopi    256, 4
+      /* w23 <= (2 * w23) mod M */
+      bn.addm  w23, w23, w23
+      /* Shift the limb to get the next bit.
+           w22 <= (w22 << 1) mod 2^256
+           FG0.C <= w22[255] */
+      bn.add   w22, w22, w22
+      /* w25 <= FG0.C */
+      bn.addc  w25, w31, w31
+      /* w23 <= (w23 + w25) mod M */
+      bn.addm  w23, w23, w25
+
+    /* Move to the next lower limb.
+         x2 <= x2 - 32 */
+    addi     x2, x2, -32
+
+  /* Store the remainder and M in the scratchpad as inputs for `gcd`.
+       dmem[tmp_scratchpad] <= w23 = x mod M
+       dmem[tmp_scratchpad + 32] <= w24 = M */
+  la       x10, tmp_scratchpad
+  addi     x11, x10, 32
+  li       x23, 23
+  bn.sid   x23, 0(x10)
+  bn.sid   x24, 0(x11)
+
+  /* Compute the GCD on a single limb, preserving x4 and x30 for the caller.
+       dmem[tmp_scratchpad + 32] <= GCD(x mod M, M) = GCD(x, M) */
+  addi     x6, x4, 0
+  li       x30, 1
+  jal      x1, gcd
+  addi     x30, x31, 1
+  addi     x4, x6, 0
+
+  /* Load the GCD and the constants for the comparison.
+       w23 <= GCD(x, M)
+       w22 <= 1
+       w24 <= 2^256-1 */
+  li       x23, 23
+  bn.lid   x23, 0(x11)
+  bn.addi  w22, w31, 1
+  bn.not   w24, w31
+
+  /* Compare the GCD with 1.
+       FG0.Z <= (GCD(x, M) == 1) */
+  bn.cmp   w23, w22
+
+  /* Select the result.
+       w22 <= FG0.Z ? 2^256-1 : 0 */
+  bn.sel   w22, w24, w31, FG0.Z
+
+  ret
+
+.data
+
+/* Product of the 42 odd primes from 3 to 191 (249 bits). */
+.balign 32
+small_primes_product:
+  .word 0x45339d37
+  .word 0x8af1e241
+  .word 0x72be7b42
+  .word 0xdd02c371
+  .word 0x35683c62
+  .word 0x43976669
+  .word 0xe9e5e90e
+  .word 0x0123bb7f
+
 .section .scratchpad
 
 /* Extra label marking the start of p || q in memory. The `derive_d` function
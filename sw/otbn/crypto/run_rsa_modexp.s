@@ -10,8 +10,13 @@
  * `mode` parameter, the caller indicates the modulus size and selects either:
  *   (a) `modexp` mode: computes a^d mod n for a caller-provided exponent d
  *   (b) `modexp_f4` mode: computes a^65537 mod n
+ *   (c) `modexp_crt` mode: computes a^d mod n for a caller-provided private
+ *       key in CRT form (p, q, dp, dq, qinv)
  *
- * In `modexp_f4` mode, the caller does not need to provide an exponent.
+ * In `modexp_f4` mode, the caller does not need to provide an exponent. In
+ * `modexp_crt` mode, the caller provides the CRT components instead of d; the
+ * result is checked against a^65537 before it is returned, so this mode
+ * requires the public exponent to be 65537.
  *
  * The base `a` and exponent `d` (if provided) should be the same size as the
  * modulus; additional bits will be ignored.
@@ -28,6 +33,9 @@
  * Call the same utility with the same arguments and a higher -m to generate
  * additional value(s) without changing the others or sacrificing mutual HD.
  *
+ * The CRT mode values were added later and picked by hand to keep a minimum
+ * HD of 6 to all of the values above and to each other.
+ *
  * TODO(#17727): in some places the OTBN assembler support for .equ directives
  * is lacking, so they cannot be used in bignum instructions or pseudo-ops such
  * as `li`. If support is added, we could use 32-bit values here instead of
@@ -39,6 +47,9 @@
 .equ MODE_RSA_3072_MODEXP_F4, 0x6d1
 .equ MODE_RSA_4096_MODEXP, 0x70b
 .equ MODE_RSA_4096_MODEXP_F4, 0x0ee
+.equ MODE_RSA_2048_MODEXP_CRT, 0x19d
+.equ MODE_RSA_3072_MODEXP_CRT, 0x237
+.equ MODE_RSA_4096_MODEXP_CRT, 0x5b2
 
 /**
  * Make the mode constants visible to Ibex.
@@ -49,6 +60,9 @@
 .globl MODE_RSA_3072_MODEXP_F4
 .globl MODE_RSA_4096_MODEXP
 .globl MODE_RSA_4096_MODEXP_F4
+.globl MODE_RSA_2048_MODEXP_CRT
+.globl MODE_RSA_3072_MODEXP_CRT
+.globl MODE_RSA_4096_MODEXP_CRT
 
 .section .text.start
 start:
@@ -77,6 +91,15 @@ start:
   addi    x3, x0, MODE_RSA_4096_MODEXP_F4
   beq     x2, x3, rsa_4096_modexp_f4
 
+  addi    x3, x0, MODE_RSA_2048_MODEXP_CRT
+  beq     x2, x3, rsa_2048_modexp_crt
+
+  addi    x3, x0, MODE_RSA_3072_MODEXP_CRT
+  beq     x2, x3, rsa_3072_modexp_crt
+
+  addi    x3, x0, MODE_RSA_4096_MODEXP_CRT
+  beq     x2, x3, rsa_4096_modexp_crt
+
   /* Unsupported mode; fail. */
   unimp
   unimp
@@ -124,6 +147,27 @@ rsa_4096_modexp_f4:
   /* Tail-call modexp_f4. */
   jal     x0, do_modexp_f4
 
+rsa_2048_modexp_crt:
+  /* Set the number of limbs for each prime (1024 / 256 = 4). */
+  li      x30, 4
+
+  /* Tail-call modexp_crt. */
+  jal     x0, do_modexp_crt
+
+rsa_3072_modexp_crt:
+  /* Set the number of limbs for each prime (1536 / 256 = 6). */
+  li      x30, 6
+
+  /* Tail-call modexp_crt. */
+  jal     x0, do_modexp_crt
+
+rsa_4096_modexp_crt:
+  /* Set the number of limbs for each prime (2048 / 256 = 8). */
+  li      x30, 8
+
+  /* Tail-call modexp_crt. */
+  jal     x0, do_modexp_crt
+
 /**
  * Precompute constants and call modular exponentiation.
  *
@@ -145,12 +189,17 @@ do_modexp:
   /* Compute Montgomery constants. */
   jal      x1, modload
 
-  /* Run exponentiation.
+  /* Run exponentiation with a 2-bit window. The CRT buffers are unused in
+     this mode and hold the table, and RR is not needed after the base has
+     been converted, so it holds the selected table entry.
        dmem[work_buf] = dmem[inout]^dmem[d] mod dmem[n] */
   la       x14, inout
   la       x15, d
   la       x2, work_buf
-  jal      x1, modexp
+  la       x3, crt_p
+  la       x4, RR
+  li       x5, 2
+  jal      x1, modexp_window
 
   /* Copy final result to the output buffer. */
   la    x3, work_buf
@@ -196,6 +245,398 @@ do_modexp_f4:
 
   ecall
 
+/**
+ * Compute an RSA signature from a private key in CRT form.
+ *
+ * Computes a^d mod n with two half-size constant-time exponentiations and
+ * recombines the results with Garner's formula:
+ *   s_p = (a mod p)^dp mod p
+ *   s_q = (a mod q)^dq mod q
+ *   h = (qinv * (s_p - s_q)) mod p
+ *   result = s_q + h * q
+ *
+ * A fault injected into either half-size exponentiation yields a result that
+ * leaks the factorization of n. To guard against this, the result is raised to
+ * the public exponent 65537 and compared to the base before it is released;
+ * on a mismatch the program fails with an error and the result is never
+ * written to the output buffer.
+ *
+ * Calls `ecall` when done; should be tail-called by mode-specific routines
+ * after the number of limbs is set. All CRT input buffers are overwritten.
+ *
+ * @param[in]             x30: number of limbs for each prime
+ * @param[in]         dmem[n]: n, modulus (2*x30 limbs)
+ * @param[in]     dmem[crt_p]: p, first prime factor of n (x30 limbs)
+ * @param[in]     dmem[crt_q]: q, second prime factor of n (x30 limbs)
+ * @param[in]        dmem[dp]: dp, d mod (p-1) (x30 limbs)
+ * @param[in]        dmem[dq]: dq, d mod (q-1) (x30 limbs)
+ * @param[in]  dmem[crt_qinv]: qinv, q^-1 mod p (x30 limbs)
+ * @param[in]     dmem[inout]: a, base for exponentiation (2*x30 limbs, a < n)
+ * @param[out]    dmem[inout]: result, a^d mod n
+ */
+do_modexp_crt:
+  /* Compute s_q.
+       dmem[crt_res] <= (a mod q)^dq mod q */
+  la       x15, dq
+  la       x16, crt_q
+  jal      x1, crt_half_modexp
+
+  /* The exponent dq has been consumed, so reuse its buffer for s_q.
+       dmem[dq] <= dmem[crt_res] = s_q */
+  la       x3, crt_res
+  la       x4, dq
+  loop     x30, 2
+    bn.lid   x0, 0(x3++)
+    bn.sid   x0, 0(x4++)
+
+  /* Compute s_p. This is done second so that the Montgomery constants for p
+     are still in place for the recombination.
+       dmem[crt_res] <= (a mod p)^dp mod p */
+  la       x15, dp
+  la       x16, crt_p
+  jal      x1, crt_half_modexp
+
+  /* Recombine the two halves.
+       dmem[work_buf..work_buf+2*x30*32] <= a^d mod n */
+  jal      x1, crt_recombine
+
+  /* Switch to the full modulus size.
+       x30 <= 2 * x30 */
+  add      x30, x30, x30
+
+  /* Save the result, overwriting the (consumed) private exponents.
+       dmem[d] <= dmem[work_buf] */
+  la       x3, work_buf
+  la       x4, d
+  loop     x30, 2
+    bn.lid   x0, 0(x3++)
+    bn.sid   x0, 0(x4++)
+
+  /* Compute Montgomery constants for n. */
+  la       x16, n
+  la       x17, m0d
+  la       x18, RR
+  jal      x1, modload
+
+  /* Raise the result to the public exponent. The buffers for p and q are
+     contiguous, so together they hold a full-size value.
+       dmem[crt_p] <= dmem[work_buf]^65537 mod n */
+  la       x14, work_buf
+  la       x2, crt_p
+  jal      x1, modexp_65537
+
+  /* Compare the re-encrypted result to the original input.
+       w22 <= OR of (dmem[crt_p] ^ dmem[inout]) over all limbs */
+  li       x20, 20
+  li       x21, 21
+  la       x3, crt_p
+  la       x4, inout
+  bn.xor   w22, w22, w22
+  loop     x30, 4
+    bn.lid   x20, 0(x3++)
+    bn.lid   x21, 0(x4++)
+    bn.xor   w20, w20, w21
+    bn.or    w22, w22, w20
+
+  /* Fail if the values do not match.
+       FG0.Z <= (w22 == 0) */
+  bn.cmp   w22, w31
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 8
+  bne      x2, x0, _crt_check_ok
+  unimp
+  unimp
+  unimp
+
+_crt_check_ok:
+  /* Copy final result to the output buffer. */
+  la    x3, d
+  la    x4, inout
+  loop  x30, 2
+    bn.lid x0, 0(x3++)
+    bn.sid x0, 0(x4++)
+
+  ecall
+
+/**
+ * Half-size modular exponentiation for RSA-CRT.
+ *
+ * Reduces the full-size base modulo one of the primes and raises it to the
+ * matching CRT exponent. The base is first reduced to a value below
+ * R = 2^(256*x30) that is congruent to a * R^-1; this only requires
+ * a_hi = floor(a / R) < p, which holds for any a < n because both primes are
+ * below R. One Montgomery multiplication by RR then brings it back to a.
+ *
+ * Leaves the Montgomery constants for the prime in dmem[m0d] and dmem[RR].
+ * Overwrites the rest of the scratchpad, beyond the first x30 limbs of RR.
+ *
+ * @param[in]          x15: dptr_e, pointer to the exponent (destroyed)
+ * @param[in]          x16: dptr_p, pointer to the prime modulus
+ * @param[in]          x30: number of limbs for the prime
+ * @param[in]          w31: all-zero
+ * @param[in]  dmem[inout]: a, base for exponentiation (2*x30 limbs)
+ * @param[out] dmem[crt_res]: result, (a mod p)^e mod p
+ *
+ * clobbered registers: x2 to x13, x16 to x29, x31
+ *                      w0 to w3, w4 to w[4+N-1], w20 to w30
+ * clobbered flag groups: FG0, FG1
+ */
+crt_half_modexp:
+  /* Compute Montgomery constants for the prime. */
+  la       x17, m0d
+  la       x18, RR
+  jal      x1, modload
+
+  /* Prepare pointers to temp regs for montmul. */
+  li       x8, 4
+  li       x9, 3
+  li       x10, 4
+  li       x11, 2
+  addi     x31, x30, -1
+
+  /* Reduce the lower half of the base. The result is at most p.
+       dmem[crt_tmp] <= montmul(a_lo, 1) = a_lo * R^-1 mod p */
+  la       x19, inout
+  la       x21, crt_tmp
+  jal      x1, montmul_mul1
+
+  /* Add the upper half of the base. Both summands are at most p, so the sum
+     is below 2p.
+       dmem[crt_tmp], FG0.C <= dmem[crt_tmp] + a_hi */
+  li       x20, 20
+  li       x21, 21
+  la       x3, inout
+  slli     x4, x30, 5
+  add      x3, x3, x4
+  la       x4, crt_tmp
+  bn.sub   w31, w31, w31
+  loop     x30, 4
+    bn.lid   x20, 0(x3++)
+    bn.lid   x21, 0(x4)
+    bn.addc  w20, w20, w21
+    bn.sid   x20, 0(x4++)
+
+  /* On carry, subtract p; the carry cancels out with the final borrow and
+     the result is below p. Otherwise the sum is already below R.
+       w22 <= FG0.C ? 2^256 - 1 : 0
+       dmem[crt_tmp] <= (dmem[crt_tmp] - (p & w22)) mod R */
+  bn.subb  w22, w31, w31
+  bn.sub   w31, w31, w31
+  la       x4, crt_tmp
+  addi     x5, x16, 0
+  loop     x30, 5
+    bn.lid   x20, 0(x4)
+    bn.lid   x21, 0(x5++)
+    bn.and   w21, w21, w22
+    bn.subb  w20, w20, w21
+    bn.sid   x20, 0(x4++)
+
+  /* Remove the extra factor of R^-1.
+       dmem[crt_tmp] <= montmul(dmem[crt_tmp], RR) = a mod p */
+  la       x19, crt_tmp
+  la       x20, RR
+  jal      x1, crt_montmul_tmp
+
+  /* Run exponentiation with a 2-bit window. RR for the prime only takes up
+     the first x30 limbs of the scratchpad, so the selected table entry and
+     the table go right after it, which may spill over from RR into
+     work_buf.
+       dmem[crt_res] = dmem[crt_tmp]^dmem[x15] mod p */
+  la       x14, crt_tmp
+  la       x2, crt_res
+  la       x4, RR
+  slli     x3, x30, 5
+  add      x4, x4, x3
+  add      x3, x4, x3
+  li       x5, 2
+  jal      x1, modexp_window
+
+  ret
+
+/**
+ * Recombine the two halves of an RSA-CRT exponentiation.
+ *
+ * Computes s_q + h * q with h = (qinv * (s_p - s_q)) mod p. Both primes have
+ * their top bit set, so any value below R = 2^(256*x30) is below 2p and can
+ * be fully reduced with a single conditional subtraction. Keeping h < p
+ * ensures that the result is below n.
+ *
+ * Expects the Montgomery constants for p in dmem[m0d] and dmem[RR].
+ *
+ * @param[in]             x30: number of limbs for each prime
+ * @param[in]             w31: all-zero
+ * @param[in]     dmem[crt_p]: p, first prime factor of n
+ * @param[in]     dmem[crt_q]: q, second prime factor of n
+ * @param[in]  dmem[crt_qinv]: qinv, q^-1 mod p
+ * @param[in]   dmem[crt_res]: s_p, half-size result modulo p
+ * @param[in]        dmem[dq]: s_q, half-size result modulo q
+ * @param[out] dmem[work_buf]: result, s_q + h * q (2*x30 limbs)
+ *
+ * clobbered registers: x2 to x13, x16 to x23, x31
+ *                      w2, w3, w4 to w[4+N-1], w20 to w30
+ * clobbered flag groups: FG0, FG1
+ */
+crt_recombine:
+  /* Prepare pointers to temp regs for montmul. */
+  la       x16, crt_p
+  la       x17, m0d
+  la       x18, RR
+  li       x8, 4
+  li       x9, 3
+  li       x10, 4
+  li       x11, 2
+  addi     x31, x30, -1
+  li       x20, 20
+  li       x21, 21
+
+  /* dmem[crt_tmp] <= s_q mod p */
+  la       x3, dq
+  la       x4, crt_tmp
+  loop     x30, 2
+    bn.lid   x20, 0(x3++)
+    bn.sid   x20, 0(x4++)
+  jal      x1, crt_cond_sub_p
+
+  /* dmem[crt_tmp], FG0.C <= s_p - dmem[crt_tmp] */
+  la       x3, crt_res
+  la       x4, crt_tmp
+  bn.sub   w31, w31, w31
+  loop     x30, 4
+    bn.lid   x20, 0(x3++)
+    bn.lid   x21, 0(x4)
+    bn.subb  w20, w20, w21
+    bn.sid   x20, 0(x4++)
+
+  /* On borrow, add p.
+       w22 <= FG0.C ? 2^256 - 1 : 0
+       dmem[crt_tmp] <= (dmem[crt_tmp] + (p & w22)) mod R = (s_p - s_q) mod p */
+  bn.subb  w22, w31, w31
+  bn.sub   w31, w31, w31
+  la       x4, crt_tmp
+  addi     x5, x16, 0
+  loop     x30, 5
+    bn.lid   x20, 0(x4)
+    bn.lid   x21, 0(x5++)
+    bn.and   w21, w21, w22
+    bn.addc  w20, w20, w21
+    bn.sid   x20, 0(x4++)
+
+  /* dmem[crt_tmp] <= montmul(dmem[crt_tmp], qinv) = h * R^-1 mod p */
+  la       x19, crt_tmp
+  la       x20, crt_qinv
+  jal      x1, crt_montmul_tmp
+
+  /* dmem[crt_tmp] <= montmul(dmem[crt_tmp], RR) = h mod p */
+  la       x19, crt_tmp
+  la       x20, RR
+  jal      x1, crt_montmul_tmp
+
+  /* dmem[crt_tmp] <= h */
+  li       x20, 20
+  li       x21, 21
+  jal      x1, crt_cond_sub_p
+
+  /* dmem[work_buf..work_buf+2*x30*32] <= q * h */
+  la       x10, crt_q
+  la       x11, crt_tmp
+  la       x12, work_buf
+  jal      x1, bignum_mul
+
+  /* Add s_q and propagate the carry through the upper half. Since h < p,
+     the sum is below n and the final carry is zero.
+       dmem[work_buf..work_buf+2*x30*32] <= q * h + s_q */
+  li       x20, 20
+  li       x21, 21
+  la       x3, dq
+  la       x4, work_buf
+  bn.sub   w31, w31, w31
+  loop     x30, 4
+    bn.lid   x20, 0(x4)
+    bn.lid   x21, 0(x3++)
+    bn.addc  w20, w20, w21
+    bn.sid   x20, 0(x4++)
+  loop     x30, 3
+    bn.lid   x20, 0(x4)
+    bn.addc  w20, w20, w31
+    bn.sid   x20, 0(x4++)
+
+  ret
+
+/**
+ * Conditionally subtract p from the CRT temporary buffer.
+ *
+ * Returns dmem[crt_tmp] = x mod p for x < 2p. Runs in constant time.
+ *
+ * @param[in]            x16: dptr_p, dmem pointer to first limb of p
+ * @param[in]            x20: 20, pointer to temp reg
+ * @param[in]            x21: 21, pointer to temp reg
+ * @param[in]            x30: number of limbs
+ * @param[in]            w31: all-zero
+ * @param[in]  dmem[crt_tmp]: x, value to reduce (x < 2p)
+ * @param[out] dmem[crt_tmp]: x mod p
+ *
+ * clobbered registers: x3, x4, x5, w20, w21, w22
+ * clobbered flag groups: FG0
+ */
+crt_cond_sub_p:
+  /* FG0.C <= dmem[crt_tmp] < p */
+  la       x3, crt_tmp
+  addi     x5, x16, 0
+  bn.sub   w31, w31, w31
+  loop     x30, 3
+    bn.lid   x20, 0(x3++)
+    bn.lid   x21, 0(x5++)
+    bn.cmpb  w20, w21
+
+  /* w22 <= FG0.C ? 0 : 2^256 - 1 */
+  bn.subb  w22, w31, w31
+  bn.not   w22, w22
+
+  /* dmem[crt_tmp] <= dmem[crt_tmp] - (p & w22) */
+  bn.sub   w31, w31, w31
+  la       x4, crt_tmp
+  addi     x5, x16, 0
+  loop     x30, 5
+    bn.lid   x20, 0(x4)
+    bn.lid   x21, 0(x5++)
+    bn.and   w21, w21, w22
+    bn.subb  w20, w20, w21
+    bn.sid   x20, 0(x4++)
+
+  ret
+
+/**
+ * Montgomery multiplication into the CRT temporary buffer.
+ *
+ * Returns dmem[crt_tmp] = montmul(A, B) = A * B * R^-1 mod M. The operand A
+ * may be the CRT temporary buffer itself.
+ *
+ * @param[in]  x16: dptr_M, dmem pointer to first limb of modulus M
+ * @param[in]  x17: dptr_m0d, dmem pointer to Montgomery Constant m0'
+ * @param[in]  x19: dptr_a, dmem pointer to first limb of operand A
+ * @param[in]  x20: dptr_b, dmem pointer to first limb of operand B
+ * @param[in]  x30: N, number of limbs
+ * @param[in]  x31: N-1, number of limbs minus one
+ * @param[in]  x9: pointer to temp reg, must be set to 3
+ * @param[in]  x10: pointer to temp reg, must be set to 4
+ * @param[in]  x11: pointer to temp reg, must be set to 2
+ * @param[in]  w31: all-zero
+ * @param[out] dmem[crt_tmp]: result C
+ *
+ * clobbered registers: x5 to x9, x12, x13, x20 to x22
+ *                      w2, w3, w4 to w[4+N-1], w24 to w30
+ * clobbered flag groups: FG0, FG1
+ */
+crt_montmul_tmp:
+  jal      x1, montmul
+  la       x21, crt_tmp
+  loop     x30, 2
+    bn.sid   x8, 0(x21++)
+    addi     x8, x8, 1
+  li       x8, 4
+
+  ret
+
 .bss
 
 /* Operational mode. */
@@ -210,11 +651,21 @@ mode:
 n:
 .zero 512
 
-/* RSA private exponent (d) for signing, up to 4096 bits. */
+/**
+ * RSA private exponent (d) for signing, up to 4096 bits.
+ *
+ * In CRT mode, this buffer instead holds the CRT exponents dp and dq, up to
+ * 2048 bits each.
+ */
 .globl d
+.globl dp
 .balign 32
 d:
-.zero 512
+dp:
+.zero 256
+.globl dq
+dq:
+.zero 256
 
 /**
  * Buffer used for both input and output, up to 4096 bits.
@@ -228,6 +679,39 @@ inout:
 .zero 512
 
 
+/**
+ * RSA-CRT prime factors p and q, up to 2048 bits each.
+ *
+ * The two buffers must stay contiguous; the CRT routine reuses them as one
+ * full-size buffer once the primes are no longer needed.
+ *
+ * In `modexp` mode, the buffers from `crt_p` to `crt_tmp` are unused and hold
+ * the table for `modexp_window` instead, so they must all stay contiguous.
+ */
+.globl crt_p
+.balign 32
+crt_p:
+.zero 256
+.globl crt_q
+crt_q:
+.zero 256
+
+/* RSA-CRT coefficient qinv = q^-1 mod p, up to 2048 bits. */
+.globl crt_qinv
+.balign 32
+crt_qinv:
+.zero 256
+
+/* Half-size working buffer for the CRT routine. */
+.balign 32
+crt_tmp:
+.zero 256
+
+/* Half-size result of each exponentiation in the CRT routine. */
+.balign 32
+crt_res:
+.zero 256
+
 /* Montgomery constant m0'. Filled by `modload`. */
 /* Note: m0' could go in scratchpad if there was space. */
 .balign 32
@@ -236,7 +720,13 @@ m0d:
 
 .section .scratchpad
 
-/* Montgomery constant RR. Filled by `modload`. */
+/**
+ * Montgomery constant RR. Filled by `modload`.
+ *
+ * RR and the working buffer must stay contiguous; in CRT mode, the table for
+ * `modexp_window` runs from the end of the half-size RR into the working
+ * buffer.
+ */
 .balign 32
 RR:
 .zero 512
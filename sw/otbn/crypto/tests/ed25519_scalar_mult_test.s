@@ -0,0 +1,548 @@
+/* Copyright lowRISC contributors (OpenTitan project). */
+/* Licensed under the Apache License, Version 2.0, see LICENSE for details. */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/**
+ * Standalone unit tests for point doubling and scalar multiplication in
+ * extended twisted Edwards coordinates for Ed25519.
+ *
+ * Tests included in this file are intended for quick sanity-checks of
+ * subroutines; they will not cover all edge cases. Expected values were
+ * computed with an affine reference implementation of RFC 8032.
+ *
+ * This test will exit with the number of failures written to the w0 register;
+ * w0=0 means all tests succeeded.
+ */
+
+.section .text.start
+
+main:
+  /* Prepare all-zero register. */
+  bn.xor w31, w31, w31
+
+  /* MOD <= dmem[modulus] = p */
+  li      x2, 2
+  la      x3, modulus
+  bn.lid  x2, 0(x3)
+  bn.wsrw MOD, w2
+
+  /* w19 <= 19 */
+  bn.addi w19, w31, 19
+
+  /* Initialize failure counter to 0. */
+  bn.mov  w0, w31
+
+  /* w30 <= (2*d) mod p. */
+  li      x2, 30
+  la      x3, two_d
+  bn.lid  x2, 0(x3)
+
+  /* Run tests. */
+  jal     x1, run_test_double
+  jal     x1, run_test_scmul_base
+  jal     x1, run_test_double_scmul
+
+  ecall
+
+/**
+ * Check that ext_double(P) = 2P.
+ *
+ * @param[in]     w19: constant, w19 = 19
+ * @param[in]     MOD: p, modulus = 2^255 - 19
+ * @param[in]     w31: all-zero
+ * @param[in,out] w0:  test failure counter
+ *
+ * clobbered registers: x2, x3, w4 to w7, w10 to w18, w20 to w27
+ * clobbered flag groups: FG0
+ */
+run_test_double:
+  /* [w13:w10] <= P */
+  li      x2, 10
+  la      x3, p_x
+  jal     x1, load_point
+
+  /* [w13:w10] <= 2P */
+  jal     x1, ext_double
+
+  /* Compare against the expected point. */
+  la      x3, p2_x
+  jal     x1, check_point
+
+  ret
+
+/**
+ * Check that ext_scmul_base(s) = [s]B.
+ *
+ * @param[in]     w19: constant, w19 = 19
+ * @param[in]     MOD: p, modulus = 2^255 - 19
+ * @param[in]     w31: all-zero
+ * @param[in,out] w0:  test failure counter
+ *
+ * clobbered registers: x2, x3, x20 to x22, w1 to w18, w20 to w28
+ * clobbered flag groups: FG0
+ */
+run_test_scmul_base:
+  /* w28 <= s */
+  li      x2, 28
+  la      x3, scalar_s
+  bn.lid  x2, 0(x3)
+
+  /* [w13:w10] <= [s]B */
+  jal     x1, ext_scmul_base
+
+  /* Compare against the expected point. */
+  la      x3, sb_x
+  jal     x1, check_point
+
+  ret
+
+/**
+ * Check that ext_double_scmul(s, k, Q) = [s]B + [k]Q.
+ *
+ * @param[in]     w19: constant, w19 = 19
+ * @param[in]     MOD: p, modulus = 2^255 - 19
+ * @param[in]     w30: constant, w30 = (2*d) mod p, d = (-121665/121666) mod p
+ * @param[in]     w31: all-zero
+ * @param[in,out] w0:  test failure counter
+ *
+ * clobbered registers: x2 to x5, x20 to x27, w4 to w7, w10 to w18,
+ *                      w20 to w29
+ * clobbered flag groups: FG0
+ */
+run_test_double_scmul:
+  /* w28 <= s */
+  li      x2, 28
+  la      x3, scalar_s
+  bn.lid  x2, 0(x3)
+
+  /* w29 <= k */
+  li      x2, 29
+  la      x3, scalar_k
+  bn.lid  x2, 0(x3)
+
+  /* [w17:w14] <= Q */
+  li      x2, 14
+  la      x3, q_x
+  jal     x1, load_point
+
+  /* [w13:w10] <= [s]B + [k]Q */
+  jal     x1, ext_double_scmul
+
+  /* Compare against the expected point. */
+  la      x3, sbkq_x
+  jal     x1, check_point
+
+  ret
+
+/**
+ * Load a point from four consecutive DMEM words.
+ *
+ * @param[in]  x2: index of the first of four consecutive WDRs
+ * @param[in]  x3: DMEM address of the point (X, Y, Z, T)
+ *
+ * clobbered registers: x2, the four destination WDRs
+ * clobbered flag groups: none
+ */
+load_point:
+  bn.lid  x2++, 0(x3)
+  bn.lid  x2++, 32(x3)
+  bn.lid  x2++, 64(x3)
+  bn.lid  x2++, 96(x3)
+  ret
+
+/**
+ * Compare a result against an expected point.
+ *
+ * Increments the failure counter if the point in w10 to w13 is not
+ * equivalent to the point at the given DMEM address.
+ *
+ * @param[in]     x3: DMEM address of the expected point (X, Y, Z, T)
+ * @param[in]     w19: constant, w19 = 19
+ * @param[in]     MOD: p, modulus = 2^255 - 19
+ * @param[in]     w31: all-zero
+ * @param[in]     w10 to w13: result point
+ * @param[in,out] w0:  test failure counter
+ *
+ * clobbered registers: x2, w4 to w7, w14 to w18, w20 to w23
+ * clobbered flag groups: FG0
+ */
+check_point:
+  /* [w17:w14] <= expected point */
+  li      x2, 14
+  jal     x1, load_point
+
+  /* w4 <= 1 if [w13:w10] equivalent to expected point else 0 */
+  jal     x1, ext_equal
+
+  /* Invert the single-bit result of the check.
+     w4 <= (~w4) & 1 = 0 if w4 else 1 */
+  bn.not  w4, w4
+  bn.addi w5, w31, 1
+  bn.and  w4, w4, w5
+
+  /* Increment failure counter if the test failed.
+     w0 <= w0 + w4 */
+  bn.add  w0, w0, w4
+
+  ret
+
+/**
+ * Check if two points in extended coordinates are equal.
+ *
+ * Returns 1 if (X1, Y1, Z1, T1) is equivalent to (x2, Y2, Z2, T2), otherwise
+ * returns 0.
+ *
+ * As per RFC 8032, returns 1 iff:
+ *   (X1 * Z2 - X2 * Z1) mod p = 0, and
+ *   (Y1 * Z2 - Y2 * Z2) mod p = 0.
+ *
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w10: input X1 (X1 < p)
+ * @param[in]  w11: input Y1 (Y1 < p)
+ * @param[in]  w12: input Z1 (Z1 < p)
+ * @param[in]  w13: input T1 (T1 < p)
+ * @param[in]  w14: input X2 (X2 < p)
+ * @param[in]  w15: input Y2 (Y2 < p)
+ * @param[in]  w16: input Z2 (Z2 < p)
+ * @param[in]  w17: input T2 (T2 < p)
+ * @param[in]  w31: all-zero
+ * @param[out] w4: result, 1 or 0
+ *
+ * clobbered registers: w4 to w7
+ * clobbered flag groups: FG0
+ */
+ext_equal:
+  /* w5 <= 1 */
+  bn.addi  w5, w31, 1
+
+  /* Compute (X1 * Z2). */
+
+  /* w22 <= w10 = X1 */
+  bn.mov   w22, w10
+  /* w23 <= w16 = Z2 */
+  bn.mov   w23, w16
+  /* w22 <= w22 * w23 = X1 * Z2 */
+  jal      x1, fe_mul
+  /* w6 <= w22 <= X1 * Z2 */
+  bn.mov   w6, w22
+
+  /* Compute (X2 * Z1). */
+
+  /* w22 <= w14 = X2 */
+  bn.mov   w22, w14
+  /* w23 <= w12 = Z1 */
+  bn.mov   w23, w12
+  /* w22 <= w22 * w23 = X2 * Z1 */
+  jal      x1, fe_mul
+
+  /* First check. */
+
+  /* w6 <= w6 - w22 <= (X1 * Z2) - (X2 * Z1) */
+  bn.sub  w6, w6, w22
+  /* w7 <= w5 if FG0.Z else w31 = 1 iff first check passed */
+  bn.sel   w7, w5, w31, FG0.Z
+
+  /* Compute (Y1 * Z2). */
+
+  /* w22 <= w11 = Y1 */
+  bn.mov   w22, w11
+  /* w23 <= w16 = Z2 */
+  bn.mov   w23, w16
+  /* w22 <= w22 * w23 = Y1 * Z2 */
+  jal      x1, fe_mul
+  /* w6 <= w22 <= Y1 * Z2 */
+  bn.mov   w6, w22
+
+  /* Compute (Y2 * Z1). */
+
+  /* w22 <= w15 = Y2 */
+  bn.mov   w22, w15
+  /* w23 <= w12 = Z1 */
+  bn.mov   w23, w12
+  /* w22 <= w22 * w23 = Y2 * Z1 */
+  jal      x1, fe_mul
+
+  /* Second check. */
+
+  /* w6 <= w6 - w22 <= (Y1 * Z2) - (Y2 * Z1) */
+  bn.sub  w6, w6, w22
+  /* w4 <= w5 if FG0.Z else w31 = 1 iff second check passed */
+  bn.sel   w4, w5, w31, FG0.Z
+
+  /* w4 <= w4 & w7 = check1 & check2 */
+  bn.and   w4, w4, w7
+  ret
+
+.data
+
+/* Modulus p = 2^255 - 19. */
+.balign 32
+modulus:
+  .word 0xffffffed
+  .word 0xffffffff
+  .word 0xffffffff
+  .word 0xffffffff
+  .word 0xffffffff
+  .word 0xffffffff
+  .word 0xffffffff
+  .word 0x7fffffff
+
+/* Constant (2*d) mod p where d=(-121665/121666) mod p. */
+.balign 32
+two_d:
+  .word 0x26b2f159
+  .word 0xebd69b94
+  .word 0x8283b156
+  .word 0x00e0149a
+  .word 0xeef3d130
+  .word 0x198e80f2
+  .word 0x56dffce7
+  .word 0x2406d9dc
+
+/* Random point P = (X, Y, Z, T) and expected result 2P. */
+
+.balign 32
+p_x:
+  .word 0x28cd21cb
+  .word 0x8df0a71b
+  .word 0xb51c2e31
+  .word 0x872ef54f
+  .word 0xbd423d5d
+  .word 0xf5a96703
+  .word 0x7de67184
+  .word 0x0e98af37
+
+.balign 32
+p_y:
+  .word 0x8d8b5f78
+  .word 0x33354e3d
+  .word 0xcbe9f7d3
+  .word 0x02b2f6a4
+  .word 0x770135d1
+  .word 0x06b92829
+  .word 0x33be5b79
+  .word 0x53d863ae
+
+.balign 32
+p_z:
+  .word 0x00000001
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+
+.balign 32
+p_t:
+  .word 0x53a13277
+  .word 0x289e9e7f
+  .word 0xa7120ec4
+  .word 0x610776d3
+  .word 0x046ee2db
+  .word 0x9dd8ba9d
+  .word 0x92203a18
+  .word 0x11622e0f
+
+.balign 32
+p2_x:
+  .word 0x3edda61a
+  .word 0xb01fe09b
+  .word 0x5efdbf92
+  .word 0x2aa7abd5
+  .word 0xc50ba735
+  .word 0xcbd0bd45
+  .word 0xb80b92d6
+  .word 0x45d6c886
+
+.balign 32
+p2_y:
+  .word 0xcd66b81a
+  .word 0x3174f507
+  .word 0xecd32535
+  .word 0x4ace34ca
+  .word 0xe6642ddd
+  .word 0xb3f92a5d
+  .word 0x5aced3fa
+  .word 0x0b6e75df
+
+.balign 32
+p2_z:
+  .word 0x00000001
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+
+.balign 32
+p2_t:
+  .word 0x279cb038
+  .word 0x88e7465b
+  .word 0x43484aeb
+  .word 0x7ed6f53f
+  .word 0xaad7102c
+  .word 0xcae8f9bd
+  .word 0x1f8c3d15
+  .word 0x3838045e
+
+/* Random point Q, scalars s and k, and expected results [s]B and
+   [s]B + [k]Q. */
+
+.balign 32
+q_x:
+  .word 0x7e190d94
+  .word 0x7cf616a6
+  .word 0x6a541668
+  .word 0x7b02d6e2
+  .word 0xc68495d5
+  .word 0x11809734
+  .word 0xc830ffba
+  .word 0x4f9c4528
+
+.balign 32
+q_y:
+  .word 0x4c0e5941
+  .word 0x8b1a4b45
+  .word 0x6515a19e
+  .word 0x177fef70
+  .word 0xbd4b45d0
+  .word 0x95be5011
+  .word 0x34d4a4b3
+  .word 0x60e717e2
+
+.balign 32
+q_z:
+  .word 0x00000001
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+
+.balign 32
+q_t:
+  .word 0xae3869b7
+  .word 0xa25930b2
+  .word 0x01e3f46e
+  .word 0xf21bd2fc
+  .word 0xcbfd59ba
+  .word 0x4f3a5ea1
+  .word 0xb7f4680b
+  .word 0x4bdd7e71
+
+.balign 32
+sb_x:
+  .word 0x11f4a86d
+  .word 0xfd1bad6e
+  .word 0x5a6f1241
+  .word 0x8b44dc3f
+  .word 0x7ffed6ea
+  .word 0xa3e86041
+  .word 0x08fb8a15
+  .word 0x2cfaf16f
+
+.balign 32
+sb_y:
+  .word 0x20545737
+  .word 0xa61937a8
+  .word 0xf55d278d
+  .word 0xfc3c3257
+  .word 0x06cb7468
+  .word 0x5805127b
+  .word 0x7bd88d07
+  .word 0x09103907
+
+.balign 32
+sb_z:
+  .word 0x00000001
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+
+.balign 32
+sb_t:
+  .word 0xcf280d1a
+  .word 0x8336396b
+  .word 0x273da532
+  .word 0xea894d4c
+  .word 0x5eb515bf
+  .word 0x377799cd
+  .word 0xef0040da
+  .word 0x029d7954
+
+.balign 32
+sbkq_x:
+  .word 0x1e877b59
+  .word 0xb0580095
+  .word 0xd8ddd094
+  .word 0xd62163c4
+  .word 0xdb1b67fe
+  .word 0xc8f249e3
+  .word 0x90f67c6b
+  .word 0x4d74ca79
+
+.balign 32
+sbkq_y:
+  .word 0xbda52581
+  .word 0x8c677ac7
+  .word 0xebac40fe
+  .word 0x8a77d355
+  .word 0xf937ed92
+  .word 0xaa9451e8
+  .word 0x6be8d7ca
+  .word 0x18d1ea60
+
+.balign 32
+sbkq_z:
+  .word 0x00000001
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+  .word 0x00000000
+
+.balign 32
+sbkq_t:
+  .word 0x53c2fe03
+  .word 0x6011688a
+  .word 0x53443679
+  .word 0x9ddee2e4
+  .word 0x25924492
+  .word 0x81610569
+  .word 0xc108b3db
+  .word 0x76914933
+
+.balign 32
+scalar_s:
+  .word 0x4fa2dcaa
+  .word 0xd0c667c5
+  .word 0x6bd0202d
+  .word 0x0591bc54
+  .word 0x8b05ac93
+  .word 0x794cca0e
+  .word 0x9de32fa0
+  .word 0x6cf26c8d
+
+.balign 32
+scalar_k:
+  .word 0x3aad4ea7
+  .word 0x37ecfc67
+  .word 0x19efb4ba
+  .word 0x673566b0
+  .word 0x50e8b822
+  .word 0x356f0ebe
+  .word 0x244ccf4f
+  .word 0x0c68862e
@@ -0,0 +1,216 @@
+/* Copyright lowRISC contributors (OpenTitan project). */
+/* Licensed under the Apache License, Version 2.0, see LICENSE for details. */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/**
+ * Standalone test to check an RSA keygen subroutine.
+ *
+ * Before running Miller-Rabin on a prime candidate, RSA keygen rejects
+ * candidates that share a factor with M, the product of the odd primes from 3
+ * to 191.
+ */
+
+.section .text.start
+
+main:
+  /* Init all-zero register. */
+  bn.xor    w31, w31, w31
+
+  /* w0 <= 0 if prime_test succeeded, 2^256-1 if it failed. */
+  jal       x1, prime_test
+  /* w1 <= 0 if large_factor_test succeeded, 2^256-1 if it failed. */
+  jal       x1, large_factor_test
+  /* w2 <= 0 if small_factor_test succeeded, 2^256-1 if it failed. */
+  jal       x1, small_factor_test
+
+  ecall
+
+prime_test:
+  /* Load the number of limbs for this test. */
+  li        x30, 4
+  li        x31, 3
+
+  /* w22 <= 0 if dmem[prime_input] is NOT relatively prime to M */
+  la        x16, prime_input
+  jal       x1, relprime_small_primes
+
+  /* w23 <= ~w31 = 2^256-1 (failure value) */
+  bn.not    w23, w31
+
+  /* FG0.Z <= (w22 == 0) */
+  bn.add    w22, w22, w31
+
+  /* We expect all 1s in w22, since the input is relatively prime.
+      w0 <= (w22 == 0) ? 2^256-1 (failure) : 0 (success) */
+  bn.sel    w0, w23, w31, FG0.Z
+
+  ret
+
+large_factor_test:
+  /* Load the number of limbs for this test. */
+  li        x30, 4
+  li        x31, 3
+
+  /* w22 <= 0 if dmem[large_factor_input] is NOT relatively prime to M */
+  la        x16, large_factor_input
+  jal       x1, relprime_small_primes
+
+  /* w23 <= ~w31 = 2^256-1 (failure value) */
+  bn.not    w23, w31
+
+  /* FG0.Z <= (w22 == 0) */
+  bn.add    w22, w22, w31
+
+  /* We expect a zero value in w22, since the input is NOT relatively prime.
+      w1 <= (w22 == 0) ? 0 (success) : 2^256-1 (failure) */
+  bn.sel    w1, w31, w23, FG0.Z
+
+  ret
+
+small_factor_test:
+  /* Load the number of limbs for this test. */
+  li        x30, 4
+  li        x31, 3
+
+  /* w22 <= 0 if dmem[small_factor_input] is NOT relatively prime to M */
+  la        x16, small_factor_input
+  jal       x1, relprime_small_primes
+
+  /* w23 <= ~w31 = 2^256-1 (failure value) */
+  bn.not    w23, w31
+
+  /* FG0.Z <= (w22 == 0) */
+  bn.add    w22, w22, w31
+
+  /* We expect a zero value in w22, since the input is NOT relatively prime.
+      w2 <= (w22 == 0) ? 0 (success) : 2^256-1 (failure) */
+  bn.sel    w2, w31, w23, FG0.Z
+
+  ret
+
+.data
+
+/**
+ * A 1024-bit prime.
+ *
+ * Full value for reference =
+ * 0xeba764d1499f2414aa64f077f4f20fdc0692b968aa1683fa8ebba3efeb4fe0516c6529c305db0e0a9e625145a3e9e2c1cf720c2957ad295f7cfbe5b865bdf0c88e71a89bad1b1fcf9a029db0c90aa6b7a5ecc5f1332def076c67411a601bc5dbb544b9e173a68c8774c353a3b69cc5e2862e1bbd39561e5cbce213d7c4bd0adb
+ */
+.balign 32
+prime_input:
+  .word 0xc4bd0adb
+  .word 0xbce213d7
+  .word 0x39561e5c
+  .word 0x862e1bbd
+  .word 0xb69cc5e2
+  .word 0x74c353a3
+  .word 0x73a68c87
+  .word 0xb544b9e1
+  .word 0x601bc5db
+  .word 0x6c67411a
+  .word 0x332def07
+  .word 0xa5ecc5f1
+  .word 0xc90aa6b7
+  .word 0x9a029db0
+  .word 0xad1b1fcf
+  .word 0x8e71a89b
+  .word 0x65bdf0c8
+  .word 0x7cfbe5b8
+  .word 0x57ad295f
+  .word 0xcf720c29
+  .word 0xa3e9e2c1
+  .word 0x9e625145
+  .word 0x05db0e0a
+  .word 0x6c6529c3
+  .word 0xeb4fe051
+  .word 0x8ebba3ef
+  .word 0xaa1683fa
+  .word 0x0692b968
+  .word 0xf4f20fdc
+  .word 0xaa64f077
+  .word 0x499f2414
+  .word 0xeba764d1
+
+/**
+ * A 1024-bit odd value whose only factor below 192 is 191, the largest prime
+ * in M.
+ *
+ * Full value for reference =
+ * 0xcdec93c52eb508a08ba36af35838cdfa2565f67465ce217e990a5ca003685e1c5f0ef0e9ec8ada4d37eb50d0c327f51e4bdb08992353633262b217b2f2b1d2b1fa7d3f6f95425a9c979f140ef9fd227a013fec00db4919f8a52909ed98073bdc9323a04c5ae2273bb830ba8ab3d6b9efce8af1ddabc58bce56c93e23f46a9bb9
+ */
+.balign 32
+large_factor_input:
+  .word 0xf46a9bb9
+  .word 0x56c93e23
+  .word 0xabc58bce
+  .word 0xce8af1dd
+  .word 0xb3d6b9ef
+  .word 0xb830ba8a
+  .word 0x5ae2273b
+  .word 0x9323a04c
+  .word 0x98073bdc
+  .word 0xa52909ed
+  .word 0xdb4919f8
+  .word 0x013fec00
+  .word 0xf9fd227a
+  .word 0x979f140e
+  .word 0x95425a9c
+  .word 0xfa7d3f6f
+  .word 0xf2b1d2b1
+  .word 0x62b217b2
+  .word 0x23536332
+  .word 0x4bdb0899
+  .word 0xc327f51e
+  .word 0x37eb50d0
+  .word 0xec8ada4d
+  .word 0x5f0ef0e9
+  .word 0x03685e1c
+  .word 0x990a5ca0
+  .word 0x65ce217e
+  .word 0x2565f674
+  .word 0x5838cdfa
+  .word 0x8ba36af3
+  .word 0x2eb508a0
+  .word 0xcdec93c5
+
+/**
+ * A 1024-bit odd value whose only factor below 192 is 3, the smallest prime
+ * in M.
+ *
+ * Full value for reference =
+ * 0xf6104f13d14d214a850a019defa922be1f9554757469c07be016c6088abc1195cda98182106880db96c20729bd66b8e2858887d325d732b33bafb7ace9efdce34860b4601a2a85e5dd5ec091b1f8fb6d11213b02b126e8c37fcdf7c1222d7a6963beeb0f285f3ea236de7aa6b6d726aef81c2464e793015f975fc1e3bd3627c1
+ */
+.balign 32
+small_factor_input:
+  .word 0xbd3627c1
+  .word 0x975fc1e3
+  .word 0xe793015f
+  .word 0xf81c2464
+  .word 0xb6d726ae
+  .word 0x36de7aa6
+  .word 0x285f3ea2
+  .word 0x63beeb0f
+  .word 0x222d7a69
+  .word 0x7fcdf7c1
+  .word 0xb126e8c3
+  .word 0x11213b02
+  .word 0xb1f8fb6d
+  .word 0xdd5ec091
+  .word 0x1a2a85e5
+  .word 0x4860b460
+  .word 0xe9efdce3
+  .word 0x3bafb7ac
+  .word 0x25d732b3
+  .word 0x858887d3
+  .word 0xbd66b8e2
+  .word 0x96c20729
+  .word 0x106880db
+  .word 0xcda98182
+  .word 0x8abc1195
+  .word 0xe016c608
+  .word 0x7469c07b
+  .word 0x1f955475
+  .word 0xefa922be
+  .word 0x850a019d
+  .word 0xd14d214a
+  .word 0xf6104f13
@@ -19,11 +19,42 @@ import re
 import sys
 
 
+def unpackbits(data):
+    """Decompress PackBits data, as sent by coverage_llvm.c.
+
+    Args:
+        data: PackBits data.
+    Returns:
+        Decompressed data.
+    Raises:
+        ValueError: If the data ends in the middle of a packet.
+    """
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        header = data[i]
+        i += 1
+        if header < 128:
+            count = header + 1
+            if i + count > len(data):
+                raise ValueError('Truncated PackBits literal.')
+            out += data[i:i + count]
+            i += count
+        elif header > 128:
+            if i >= len(data):
+                raise ValueError('Truncated PackBits run.')
+            out += bytes([data[i]]) * (257 - header)
+            i += 1
+    return bytes(out)
+
+
 def extract_profile_data(device_output):
     """Parse device output to extract LLVM profile data.
 
     This function returns the LLVM profile data as a byte array after
-    verifying its length and checksum.
+    verifying its length and checksum. Both the PackBits-compressed format and
+    the older format that sends the buffer as one reversed hex number are
+    supported.
 
     Args:
         device_output: Device output.
@@ -41,18 +72,30 @@ def extract_profile_data(device_output):
         device_output.maketrans('', '', '\r\n'))
     match = re.search(
         r"""
-            LLVM\ profile\ data\ \(length:\ (?P<len>\d+)\ bytes,\ CRC32:\ (?P<crc>0x[0-9a-f]*)\):
-            (?P<data> 0x [0-9a-f]+)
+            LLVM\ profile\ data\ \(PackBits,\ length:\ (?P<len>\d+)\ bytes,
+            \ CRC32:\ (?P<crc>0x[0-9a-f]*)\):
+            (?P<data> [0-9a-f]*)
             \x04
         """, device_output, re.VERBOSE)
-    if not match:
-        raise ValueError(
-            'Could not detect LLVM profile data in device output.')
+    if match:
+        byte_array = unpackbits(bytes.fromhex(match.group('data')))
+    else:
+        match = re.search(
+            r"""
+                LLVM\ profile\ data\ \(length:\ (?P<len>\d+)\ bytes,
+                \ CRC32:\ (?P<crc>0x[0-9a-f]*)\):
+                (?P<data> 0x [0-9a-f]+)
+                \x04
+            """, device_output, re.VERBOSE)
+        if not match:
+            raise ValueError(
+                'Could not detect LLVM profile data in device output.')
+        byte_array = int(match.group('data'), 0).to_bytes(
+            len(match.group('data')) // 2 - 1,
+            byteorder='little',
+            signed=False)
     exp_length = int(match.group('len'))
     exp_checksum = int(match.group('crc'), 0)
-    byte_array = int(match.group('data'), 0).to_bytes(len(match.group('data')) // 2 - 1,
-                                                      byteorder='little',
-                                                      signed=False)
     # Check length
     act_length = len(byte_array)
     if act_length != exp_length:
@@ -5,7 +5,7 @@
 import unittest
 import zlib
 
-from device_profile_data import extract_profile_data
+from device_profile_data import extract_profile_data, unpackbits
 
 
 class TestExtractProfileData(unittest.TestCase):
@@ -192,5 +192,67 @@ I00034 status.c:28] PASS!\r
         self.assertEqual(zlib.crc32(raw_profile_data), 0x79a3fcf1)
 
 
+    def test_unpackbits(self):
+        self.assertEqual(unpackbits(bytes.fromhex('02616263fd00ff7a')),
+                         b'abc' + bytes(4) + b'zz')
+
+    def test_unpackbits_truncated(self):
+        with self.assertRaisesRegex(ValueError, "Truncated.*literal"):
+            unpackbits(bytes.fromhex('0261'))
+        with self.assertRaisesRegex(ValueError, "Truncated.*run"):
+            unpackbits(bytes.fromhex('fd'))
+
+    def test_packbits_bad_checksum(self):
+        # Checksum is incremented.
+        DEVICE_OUTPUT = """
+I00001 coverage_test.c:37] Collecting coverage data.\r
+I00002 ottf_main.c:100] Finished sw/device/tests/coverage_test.c\r
+I00003 coverage_llvm.c:125] LLVM profile data (PackBits, length: 1184 bytes, CRC32: 0x79a3fcf2):\r
+088152666f72706cff07f200000af200000df200014a02fb000358200010fd0003144c0020fd000001fa0008db41eb50c84b489e18fa000358200010f9000001\r
+f600070b5e9e389b4844e2f9000360200010f9000001f6000b35fced9e3b706bb791264402fd000368200010f9000003f60008f054ff15af3984f618fa000380\r
+200010f9000001f60008f4c72f55dddab05518fa000388200010f9000001f60009ac122275b3b32f435824fb000390200010f9000002f60008d13086a85b7866\r
+2818fa0003a0200010f9000001f60008ea8744750aa13a0318fa0003a8200010f9000001f6000769fc300f8c986f1ef90003b0200010f9000001f6000704d04a\r
+ef3511c9e5f90003b8200010f90000018e007fe608cc0278da7d52cb728420102c7f2887e4b2959f99620137538b606008d1afcf28ea2e48f6824d4ff7bc240a\r
+4f8016a98b8cdee4e7f201af83ce0c8c91e497f045987ea18fc6d41c2aa3b32979a40d06b4f7ee8ad4a3360ad6f3e39d0b087566b3eda01930496e8fd7913249\r
+e69a29a41ba7e76a76397ce0e6343da7952e5a7f02c369d1de60d6dee9708e931768da82d18daba6e004b73415dd4fa44312e3338781cd497b703d50721c1a06\r
+743ce20d9d85debb018452be6097f92f27a6b2ae0bb93428085f427149758eb552f01a9b86a5240c22dc2bd34d53de7ec15a6705b90125485eb36f191f12fe3b\r
+2dc1da0e386ba6ff14658afdf5bcc8d192d4adbe7f1a263487ad8a648111d12aed1f287557e13daed4865227f96d1a9a99ca286e487fcf07ca400eeee790cdbb\r
+33a65dbe83b48b5327ae01b63e9707745cb7a752dd1fbfbdf071cd52d8200eeb1f03e2a9c68c05f60178da6d905d7283300c84871bf5e7a5b7d1085b249a31d8\r
+95056e387d0584008117cffad3ee5ac035fd41936e7f080349e6d8553c11f45e40a8c5041f90494ff473a65867685b8e06d1ff6cd722ac74ba43bea38f85fc31\r
+f7fdf566bc005bb4202b3451803b25913ed96e0edd9d0c0c18d8a35255b3364cc1c37c5a7c7ae74ce7f20d9b30a8719dbf4f8e250bbbac70313df6af75d32159\r
+a77fb6af75b1ef1482d57277839124523ecf5590c3b54921c5347b0e0c6da5c761fb87522e98f68cb3850b09c406b4441b05ec3b4fb2a952d528c2337aaa5239\r
+fb88a0a3a145f54f45bfe34b2dc2b57178d9c635d997d5be8ab29acb3f0194f321fb00\r
+\x04\r
+I00004 status.c:28] PASS!\r
+"""  # noqa: E501
+        with self.assertRaisesRegex(ValueError, "Checksum.*"):
+            extract_profile_data(DEVICE_OUTPUT)
+
+    def test_packbits_good_data(self):
+        DEVICE_OUTPUT = """
+I00001 coverage_test.c:37] Collecting coverage data.\r
+I00002 ottf_main.c:100] Finished sw/device/tests/coverage_test.c\r
+I00003 coverage_llvm.c:125] LLVM profile data (PackBits, length: 1184 bytes, CRC32: 0x79a3fcf1):\r
+088152666f72706cff07f200000af200000df200014a02fb000358200010fd0003144c0020fd000001fa0008db41eb50c84b489e18fa000358200010f9000001\r
+f600070b5e9e389b4844e2f9000360200010f9000001f6000b35fced9e3b706bb791264402fd000368200010f9000003f60008f054ff15af3984f618fa000380\r
+200010f9000001f60008f4c72f55dddab05518fa000388200010f9000001f60009ac122275b3b32f435824fb000390200010f9000002f60008d13086a85b7866\r
+2818fa0003a0200010f9000001f60008ea8744750aa13a0318fa0003a8200010f9000001f6000769fc300f8c986f1ef90003b0200010f9000001f6000704d04a\r
+ef3511c9e5f90003b8200010f90000018e007fe608cc0278da7d52cb728420102c7f2887e4b2959f99620137538b606008d1afcf28ea2e48f6824d4ff7bc240a\r
+4f8016a98b8cdee4e7f201af83ce0c8c91e497f045987ea18fc6d41c2aa3b32979a40d06b4f7ee8ad4a3360ad6f3e39d0b087566b3eda01930496e8fd7913249\r
+e69a29a41ba7e76a76397ce0e6343da7952e5a7f02c369d1de60d6dee9708e931768da82d18daba6e004b73415dd4fa44312e3338781cd497b703d50721c1a06\r
+743ce20d9d85debb018452be6097f92f27a6b2ae0bb93428085f427149758eb552f01a9b86a5240c22dc2bd34d53de7ec15a6705b90125485eb36f191f12fe3b\r
+2dc1da0e386ba6ff14658afdf5bcc8d192d4adbe7f1a263487ad8a648111d12aed1f287557e13daed4865227f96d1a9a99ca286e487fcf07ca400eeee790cdbb\r
+33a65dbe83b48b5327ae01b63e9707745cb7a752dd1fbfbdf071cd52d8200eeb1f03e2a9c68c05f60178da6d905d7283300c84871bf5e7a5b7d1085b249a31d8\r
+95056e387d0584008117cffad3ee5ac035fd41936e7f080349e6d8553c11f45e40a8c5041f90494ff473a65867685b8e06d1ff6cd722ac74ba43bea38f85fc31\r
+f7fdf566bc005bb4202b3451803b25913ed96e0edd9d0c0c18d8a35255b3364cc1c37c5a7c7ae74ce7f20d9b30a8719dbf4f8e250bbbac70313df6af75d32159\r
+a77fb6af75b1ef1482d57277839124523ecf5590c3b54921c5347b0e0c6da5c761fb87522e98f68cb3850b09c406b4441b05ec3b4fb2a952d528c2337aaa5239\r
+fb88a0a3a145f54f45bfe34b2dc2b57178d9c635d997d5be8ab29acb3f0194f321fb00\r
+\x04\r
+I00004 status.c:28] PASS!\r
+"""  # noqa: E501
+        raw_profile_data = extract_profile_data(DEVICE_OUTPUT)
+        self.assertEqual(len(raw_profile_data), 1184)
+        self.assertEqual(zlib.crc32(raw_profile_data), 0x79a3fcf1)
+
 if __name__ == '__main__':
     unittest.main()
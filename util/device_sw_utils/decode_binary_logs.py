@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Decode the binary logs in the console output of a device program.
+
+With `base_log_set_mode(kLogModeBinary)` (see sw/device/lib/runtime/log.h),
+or `.binary_log = true` in the OTTF test config, each LOG line is written to
+the console as a binary record holding the address of its log_fields_t and
+its raw arguments. This reads the console output (from a file, or from stdin
+so that it can be piped from `opentitantool console`), and writes it out
+with every record turned back into the line of text that the device would
+have printed, using the ELF file of the program to find the file name, line
+number and format string of each log. For example:
+
+    opentitantool console ... | \\
+        ./util/device_sw_utils/decode_binary_logs.py --elf-file test.elf
+
+Everything that isn't part of a record is passed through as it is.
+"""
+
+import argparse
+import codecs
+import re
+import struct
+import sys
+
+from elftools.elf import elffile
+
+# Must match kLogBinaryMarker in sw/device/lib/runtime/log.h.
+LOG_BINARY_MARKER = 0xfe
+RECORD_HEADER_SIZE = 6
+LOG_FIELDS_SIZE = 20
+SEVERITIES = 'IWEF'
+
+# Must match the status codes in sw/device/lib/base/status.c.
+STATUS_CODES = [
+    'Ok', 'Cancelled', 'Unknown', 'InvalidArgument', 'DeadlineExceeded',
+    'NotFound', 'AlreadyExists', 'PermissionDenied', 'ResourceExhausted',
+    'FailedPrecondition', 'Aborted', 'OutOfRange', 'Unimplemented',
+    'Internal', 'Unavailable', 'DataLoss', 'Unauthenticated'
+]
+
+# A format specifier, as parsed by base_vfprintf() in
+# sw/device/lib/runtime/print.c.
+SPEC_RE = re.compile(r'%(!?)(\d*)(.?)', re.S)
+
+
+class Image:
+    '''The contents of the loaded sections of an ELF file, by address.'''
+
+    def __init__(self, elf_file):
+        self.sections = []
+        with open(elf_file, 'rb') as f:
+            elf = elffile.ELFFile(f)
+            for section in elf.iter_sections():
+                if section.header['sh_type'] != 'SHT_PROGBITS':
+                    continue
+                if not section.header['sh_flags'] & 0x2:  # SHF_ALLOC
+                    continue
+                self.sections.append(
+                    (section.header['sh_addr'], section.data()))
+
+    def read(self, addr, size):
+        for base, data in self.sections:
+            if base <= addr and addr + size <= base + len(data):
+                return data[addr - base:addr - base + size]
+        return None
+
+    def read_str(self, addr, size=None):
+        for base, data in self.sections:
+            if base <= addr < base + len(data):
+                start = addr - base
+                if size is None:
+                    end = data.find(b'\0', start)
+                    end = len(data) if end == -1 else end
+                else:
+                    end = min(start + size, len(data))
+                return data[start:end].decode('utf-8', errors='replace')
+        return None
+
+
+def sign32(value):
+    return value - (1 << 32) if value & (1 << 31) else value
+
+
+def to_base(value, base, digits):
+    out = ''
+    while True:
+        out = digits[value % base] + out
+        value //= base
+        if value == 0:
+            return out
+
+
+def format_status(value, as_json):
+    if sign32(value) < 0:
+        err = value & 0x1f
+        code = STATUS_CODES[err] if 0 < err < len(STATUS_CODES) else (
+            'ErrorError' if err == 0 else 'Undefined{}'.format(err))
+        arg = (value >> 5) & 0x7ff
+        module_id = (value >> 16) & 0x7fff
+        mod = ''.join(
+            chr(0x40 + ((module_id >> shift) & 0x1f)) for shift in (0, 5, 10))
+        body = '[\"{}\",{}]'.format(mod, arg)
+    else:
+        code = 'Ok'
+        body = str(value)
+    if as_json:
+        return '{{"{}":{}}}'.format(code, body)
+    return '{}:{}'.format(code, body)
+
+
+def format_log(fmt, args, image):
+    '''Format args according to fmt, as base_vfprintf() would'''
+    args = iter(args)
+    out = []
+    pos = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        nonstd, width, spec = m.group(1) == '!', m.group(2), m.group(3)
+        padding = '0' if width.startswith('0') else ' '
+        width = int(width) if width else 0
+        try:
+            if spec == '%':
+                text = '%'
+            elif spec == 'c':
+                text = chr(next(args) & 0xff)
+            elif spec == 's':
+                size = next(args) if nonstd else None
+                addr = next(args)
+                text = image.read_str(addr, size)
+                if text is None:
+                    text = '<string at 0x{:08x}>'.format(addr)
+            elif spec in 'di':
+                text = str(sign32(next(args)))
+            elif spec == 'u':
+                text = str(next(args))
+            elif spec == 'o':
+                text = to_base(next(args), 8, '01234567')
+            elif spec == 'b' and nonstd:
+                text = 'true' if next(args) else 'false'
+            elif spec == 'b':
+                text = to_base(next(args), 2, '01')
+            elif spec == 'p':
+                text = '0x{:08x}'.format(next(args))
+            elif spec in 'xXyY' and nonstd:
+                size, addr = next(args), next(args)
+                data = image.read(addr, size)
+                if data is None:
+                    text = '<bytes at 0x{:08x}>'.format(addr)
+                else:
+                    if spec in 'xX':
+                        data = data[::-1]
+                    text = data.hex()
+                    if spec in 'XY':
+                        text = text.upper()
+            elif spec in 'xh':
+                text = '{:x}'.format(next(args))
+            elif spec in 'XH':
+                text = '{:X}'.format(next(args))
+            elif spec == 'C':
+                value = next(args)
+                text = ''
+                for ch in value.to_bytes(4, 'little'):
+                    text += chr(ch) if 32 <= ch < 127 else '\\x{:02x}'.format(
+                        ch)
+            elif spec == 'r':
+                text = format_status(next(args), nonstd)
+            elif spec == '':
+                text = '%<unexpected nul>'
+            else:
+                text = '%<unknown spec>'
+        except StopIteration:
+            text = '%<missing argument>'
+        out.append(text.rjust(width, padding))
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+class Decoder:
+    '''Turns console output with binary log records into text'''
+
+    def __init__(self, image):
+        self.image = image
+        self.counter = 0
+        self.pending = b''
+        # The text between records can end part of the way through a
+        # character.
+        self.text = codecs.getincrementaldecoder('utf-8')(errors='replace')
+
+    def decode_record(self, log_addr, args):
+        fields = self.image.read(log_addr, LOG_FIELDS_SIZE)
+        if fields is None:
+            return '?{:05d} <unknown log 0x{:08x}>\r\n'.format(
+                self.counter, log_addr)
+        severity, file_addr, line, _, format_addr = struct.unpack(
+            '<IIIII', fields)
+        file_name = self.image.read_str(file_addr) or '?'
+        fmt = self.image.read_str(format_addr) or ''
+        return '{}{:05d} {}:{}] {}\r\n'.format(
+            SEVERITIES[severity] if severity < len(SEVERITIES) else '?',
+            self.counter & 0xffff, file_name.rsplit('/', 1)[-1], line,
+            format_log(fmt, args, self.image))
+
+    def feed(self, data):
+        '''Decode data, returning the text decoded so far'''
+        data = self.pending + data
+        out = []
+        pos = 0
+        while True:
+            marker = data.find(bytes([LOG_BINARY_MARKER]), pos)
+            if marker == -1:
+                out.append(self.text.decode(data[pos:]))
+                self.pending = b''
+                break
+            out.append(self.text.decode(data[pos:marker]))
+            header = data[marker:marker + RECORD_HEADER_SIZE]
+            if len(header) < RECORD_HEADER_SIZE:
+                self.pending = data[marker:]
+                break
+            _, log_addr, nargs = struct.unpack('<BIB', header)
+            end = marker + RECORD_HEADER_SIZE + 4 * nargs
+            if len(data) < end:
+                self.pending = data[marker:]
+                break
+            args = struct.unpack('<{}I'.format(nargs),
+                                 data[marker + RECORD_HEADER_SIZE:end])
+            out.append(self.decode_record(log_addr, args))
+            self.counter += 1
+            pos = end
+        return ''.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--elf-file',
+                        '-e',
+                        required=True,
+                        help='ELF file of the program that wrote the logs')
+    parser.add_argument('--input',
+                        '-i',
+                        type=argparse.FileType('rb'),
+                        default=sys.stdin.buffer,
+                        help='Console output to decode (default: stdin)')
+    args = parser.parse_args()
+
+    decoder = Decoder(Image(args.elf_file))
+    while True:
+        # read1() returns as soon as any data is available, so that the logs
+        # are decoded as they arrive when reading from a pipe.
+        read = getattr(args.input, 'read1', args.input.read)
+        data = read(4096)
+        if not data:
+            break
+        sys.stdout.write(decoder.feed(data))
+        sys.stdout.flush()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Symbolize the PC samples in the console output of an OTTF test.
+
+With `.pc_sampler_hz` set in the OTTF test config (see
+sw/device/lib/testing/test_framework/ottf_pc_sampler.h), the test prints a
+histogram of the PCs it was interrupted at when `test_main()` returns. This
+reads the console output (from a file, or from stdin), attributes each bucket
+of the histogram to the function of the ELF file that contains its start
+address, and prints the functions by the number of samples they got. For
+example:
+
+    ./util/device_sw_utils/symbolize_pc_samples.py --elf-file test.elf \\
+        --input console.log
+
+A bucket can span the end of one function and the start of the next one, so
+with big buckets (see the `shift` in the header line) the samples of small
+functions may be attributed to their neighbours.
+"""
+
+import argparse
+import bisect
+import re
+import sys
+
+from elftools.elf import elffile
+from elftools.elf.sections import SymbolTableSection
+
+HEADER_RE = re.compile(r'PC_SAMPLER: start=0x([0-9a-f]+) shift=(\d+) '
+                       r'samples=(\d+) dropped=(\d+)')
+SAMPLE_RE = re.compile(r'PC_SAMPLE: 0x([0-9a-f]+) (\d+)')
+END_RE = re.compile(r'PC_SAMPLER: end')
+
+
+class Symbols:
+    '''The function symbols of an ELF file, by address.'''
+
+    def __init__(self, elf_file):
+        funcs = []
+        with open(elf_file, 'rb') as f:
+            elf = elffile.ELFFile(f)
+            for section in elf.iter_sections():
+                if not isinstance(section, SymbolTableSection):
+                    continue
+                for sym in section.iter_symbols():
+                    if sym['st_info']['type'] != 'STT_FUNC':
+                        continue
+                    funcs.append((sym['st_value'], sym['st_size'], sym.name))
+        funcs.sort()
+        self.addrs = [addr for addr, _, _ in funcs]
+        self.funcs = funcs
+
+    def lookup(self, addr):
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i < 0:
+            return None
+        start, size, name = self.funcs[i]
+        # Symbols written in assembly often have no size.
+        if size and addr >= start + size:
+            return None
+        return name
+
+
+def parse(lines):
+    '''Return the header and the buckets of the last histogram in lines'''
+    header = None
+    buckets = {}
+    in_histogram = False
+    for line in lines:
+        m = HEADER_RE.search(line)
+        if m:
+            header = {
+                'start': int(m.group(1), 16),
+                'shift': int(m.group(2)),
+                'samples': int(m.group(3)),
+                'dropped': int(m.group(4)),
+            }
+            buckets = {}
+            in_histogram = True
+            continue
+        if not in_histogram:
+            continue
+        m = SAMPLE_RE.search(line)
+        if m:
+            buckets[int(m.group(1), 16)] = int(m.group(2))
+        elif END_RE.search(line):
+            in_histogram = False
+    return header, buckets
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--elf-file',
+                        '-e',
+                        required=True,
+                        help='ELF file of the test that took the samples')
+    parser.add_argument('--input',
+                        '-i',
+                        type=argparse.FileType('r', errors='replace'),
+                        default=sys.stdin,
+                        help='Console output of the test (default: stdin)')
+    parser.add_argument('--top',
+                        type=int,
+                        default=0,
+                        help='Only print the first TOP functions')
+    args = parser.parse_args()
+
+    header, buckets = parse(args.input)
+    if header is None:
+        print('No PC samples in the input.', file=sys.stderr)
+        return 1
+
+    symbols = Symbols(args.elf_file)
+    counts = {}
+    for addr, count in buckets.items():
+        name = symbols.lookup(addr) or '<0x{:08x}>'.format(addr)
+        counts[name] = counts.get(name, 0) + count
+
+    total = max(header['samples'], 1)
+    print('{} samples, {} outside .text, {}-byte buckets'.format(
+        header['samples'], header['dropped'], 1 << header['shift']))
+    ranked = sorted(counts.items(), key=lambda item: (-item[1], item[0]))
+    if args.top:
+        ranked = ranked[:args.top]
+    for name, count in ranked:
+        print('{:>8} {:>6.2f}%  {}'.format(count, 100.0 * count / total, name))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
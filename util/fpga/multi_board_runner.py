@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+r"""Shard cryptotest and penetration test host harnesses across FPGA boards.
+
+Every host harness drives a single board over a single UART. This tool runs
+many harness invocations concurrently, one per board, and collects their
+results into a single report. Each board is served by its own worker that
+takes the next pending shard as soon as its previous one has finished, so one
+board is being bootstrapped while the others are still running vectors.
+
+The configuration is an hjson file listing the boards and the jobs:
+
+{
+  boards: [
+    // `args` are inserted right after the harness binary and select the board.
+    { name: "cw310-0", args: ["--interface=hyper310", "--usb-serial=A"] },
+    { name: "cw310-1", args: ["--interface=hyper310", "--usb-serial=B"] },
+  ],
+  jobs: [
+    {
+      name: "hash_kat",
+      command: ["bazel-bin/sw/host/tests/crypto/hash_kat/harness",
+                "--bootstrap=firmware.bin", "--hash_json"],
+      // Split round-robin into `shards` invocations, appended to `command`.
+      shard_args: ["sha256.json", "sha384.json", "sha512.json"],
+      shards: 2,
+    },
+  ],
+}
+
+Typical usage:
+
+  util/fpga/multi_board_runner.py boards.hjson --log-dir /tmp/logs \
+      --report report.json
+"""
+
+import json
+import queue
+import subprocess
+import threading
+import time
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+from typing import Any, Dict, List, Optional
+
+import hjson
+import typer
+
+
+@dataclass
+class Board:
+    name: str
+    args: List[str] = field(default_factory=list)
+
+
+@dataclass
+class Shard:
+    job: str
+    index: int
+    command: List[str]
+    weight: int
+
+
+@dataclass
+class ShardResult:
+    job: str
+    index: int
+    board: str
+    command: List[str]
+    returncode: int
+    seconds: float
+    log: Optional[str]
+
+
+def make_shards(job: Dict[str, Any]) -> List[Shard]:
+    """Splits a job into shards.
+
+    The `shard_args` are distributed round-robin so that shards of a sorted
+    vector list get a similar mix of short and long files. Empty shards are
+    dropped.
+    """
+    shard_args = job.get("shard_args", [])
+    num_shards = max(1, min(job.get("shards", 1), max(1, len(shard_args))))
+    buckets: List[List[str]] = [[] for _ in range(num_shards)]
+    for i, arg in enumerate(shard_args):
+        buckets[i % num_shards].append(arg)
+    shards = []
+    for index, bucket in enumerate(buckets):
+        if shard_args and not bucket:
+            continue
+        shards.append(
+            Shard(job=job["name"],
+                  index=index,
+                  command=list(job["command"]) + bucket,
+                  weight=len(bucket)))
+    return shards
+
+
+def board_command(board: Board, command: List[str]) -> List[str]:
+    """Inserts the board selection arguments after the harness binary."""
+    return command[:1] + board.args + command[1:]
+
+
+def run_shards(boards: List[Board],
+               shards: List[Shard],
+               log_dir: Optional[Path] = None) -> List[ShardResult]:
+    """Runs all shards with one worker per board.
+
+    The largest shards are handed out first, so that the tail of the run is
+    made of short shards and the boards finish at about the same time.
+    """
+    pending: "queue.Queue[Shard]" = queue.Queue()
+    for shard in sorted(shards, key=lambda s: s.weight, reverse=True):
+        pending.put(shard)
+    results: List[ShardResult] = []
+    lock = threading.Lock()
+
+    def worker(board: Board) -> None:
+        while True:
+            try:
+                shard = pending.get_nowait()
+            except queue.Empty:
+                return
+            command = board_command(board, shard.command)
+            log = None
+            start = time.monotonic()
+            if log_dir is not None:
+                log = str(log_dir / f"{shard.job}.{shard.index}.log")
+                with open(log, "w") as f:
+                    returncode = subprocess.call(command,
+                                                 stdout=f,
+                                                 stderr=subprocess.STDOUT)
+            else:
+                returncode = subprocess.call(command)
+            result = ShardResult(job=shard.job,
+                                 index=shard.index,
+                                 board=board.name,
+                                 command=command,
+                                 returncode=returncode,
+                                 seconds=time.monotonic() - start,
+                                 log=log)
+            with lock:
+                results.append(result)
+                status = "PASSED" if returncode == 0 else "FAILED"
+                print(f"{status} {shard.job}[{shard.index}] on {board.name} "
+                      f"({result.seconds:.1f}s)",
+                      flush=True)
+
+    threads = [
+        threading.Thread(target=worker, args=(board, ), daemon=True)
+        for board in boards
+    ]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    return sorted(results, key=lambda r: (r.job, r.index))
+
+
+def make_report(results: List[ShardResult]) -> Dict[str, Any]:
+    """Aggregates the shard results into a single report."""
+    failed = [r for r in results if r.returncode != 0]
+    per_board: Dict[str, float] = {}
+    for r in results:
+        per_board[r.board] = per_board.get(r.board, 0.0) + r.seconds
+    return {
+        "num_shards": len(results),
+        "num_failed": len(failed),
+        "board_seconds": per_board,
+        "shards": [asdict(r) for r in results],
+    }
+
+
+def main(config: Path,
+         log_dir: Optional[Path] = typer.Option(
+             None, help="Directory for per-shard harness logs."),
+         report: Optional[Path] = typer.Option(
+             None, help="Write the aggregated JSON report to this file.")):
+    """Run the jobs in CONFIG across all boards listed in it."""
+    cfg = hjson.load(config.open())
+    boards = [Board(**b) for b in cfg["boards"]]
+    if not boards:
+        raise typer.BadParameter("No boards configured.")
+    shards = [s for job in cfg["jobs"] for s in make_shards(job)]
+    if log_dir is not None:
+        log_dir.mkdir(parents=True, exist_ok=True)
+
+    summary = make_report(run_shards(boards, shards, log_dir))
+    if report is not None:
+        report.write_text(json.dumps(summary, indent=2))
+    print(f"{summary['num_shards'] - summary['num_failed']} of "
+          f"{summary['num_shards']} shards passed on {len(boards)} boards.")
+    raise typer.Exit(code=1 if summary["num_failed"] else 0)
+
+
+if __name__ == "__main__":
+    typer.run(main)
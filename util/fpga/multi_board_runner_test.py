@@ -0,0 +1,66 @@
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import sys
+import unittest
+
+from multi_board_runner import (Board, Shard, board_command, make_report,
+                                make_shards, run_shards)
+
+
+class TestMakeShards(unittest.TestCase):
+
+    def test_round_robin(self):
+        shards = make_shards({
+            "name": "kat",
+            "command": ["harness", "--json"],
+            "shard_args": ["a", "b", "c", "d", "e"],
+            "shards": 2,
+        })
+        self.assertEqual([s.command for s in shards], [
+            ["harness", "--json", "a", "c", "e"],
+            ["harness", "--json", "b", "d"],
+        ])
+        self.assertEqual([s.weight for s in shards], [3, 2])
+
+    def test_more_shards_than_args(self):
+        shards = make_shards({
+            "name": "kat",
+            "command": ["harness"],
+            "shard_args": ["a", "b"],
+            "shards": 8,
+        })
+        self.assertEqual(len(shards), 2)
+
+    def test_no_shard_args(self):
+        shards = make_shards({"name": "capture", "command": ["harness"]})
+        self.assertEqual(len(shards), 1)
+        self.assertEqual(shards[0].command, ["harness"])
+
+
+class TestRunShards(unittest.TestCase):
+
+    def test_board_args(self):
+        board = Board(name="b0", args=["--usb-serial=X"])
+        self.assertEqual(board_command(board, ["harness", "--json", "a"]),
+                         ["harness", "--usb-serial=X", "--json", "a"])
+
+    def test_all_shards_run_once(self):
+        boards = [Board(name="b0"), Board(name="b1"), Board(name="b2")]
+        shards = [
+            Shard(job="kat",
+                  index=i,
+                  command=[sys.executable, "-c", f"exit({int(i == 3)})"],
+                  weight=i) for i in range(6)
+        ]
+        results = run_shards(boards, shards)
+        self.assertEqual([r.index for r in results], list(range(6)))
+        report = make_report(results)
+        self.assertEqual(report["num_shards"], 6)
+        self.assertEqual(report["num_failed"], 1)
+        self.assertEqual(report["shards"][3]["returncode"], 1)
+
+
+if __name__ == "__main__":
+    unittest.main()